@@ -38,10 +38,17 @@
 #include <time.h>
 #include <string.h>
 
+#if ARAVIS_HAS_DMA_HEAP
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#endif
+
 /* TODO: Add l10n */
 #define _(x) (x)
 
 #define GST_ARAVIS_DEFAULT_N_BUFFERS		50
+#define GST_ARAVIS_AUTO_MIN_BUFFERS		4
+#define GST_ARAVIS_DEFAULT_MAX_BUFFER_MEMORY	(512 * 1024 * 1024)
 #define GST_ARAVIS_BUFFER_TIMEOUT_DEFAULT	2000000
 
 GST_DEBUG_CATEGORY_STATIC (aravis_debug);
@@ -66,7 +73,13 @@ enum
   PROP_PACKET_RESEND,
   PROP_FEATURES,
   PROP_NUM_ARV_BUFFERS,
-  PROP_USB_MODE
+  PROP_USB_MODE,
+  PROP_DMABUF,
+  PROP_TIMESTAMP_SOURCE,
+  PROP_LOW_LATENCY,
+  PROP_CHUNKS,
+  PROP_MAX_BUFFER_MEMORY,
+  PROP_MIN_VALID_RATIO
 };
 
 #define GST_TYPE_ARV_AUTO (gst_arv_auto_get_type())
@@ -89,6 +102,26 @@ gst_arv_auto_get_type (void)
 	return arv_auto_type;
 }
 
+#define GST_TYPE_ARV_TIMESTAMP_SOURCE (gst_arv_timestamp_source_get_type())
+static GType
+gst_arv_timestamp_source_get_type (void)
+{
+	static GType arv_timestamp_source_type = 0;
+
+	static const GEnumValue arv_timestamp_sources[] = {
+		{GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE, "Device timestamp, relative to the first frame", "device"},
+		{GST_ARAVIS_TIMESTAMP_SOURCE_SYSTEM, "Host system time of the frame reception", "system"},
+		{GST_ARAVIS_TIMESTAMP_SOURCE_PTP, "Device timestamp synchronized on the host TAI clock by PTP", "ptp"},
+		{0, NULL, NULL},
+	};
+
+	if (!arv_timestamp_source_type)
+	{
+		arv_timestamp_source_type = g_enum_register_static("GstArvTimestampSource", arv_timestamp_sources);
+	}
+	return arv_timestamp_source_type;
+}
+
 #define GST_TYPE_ARV_USB_MODE (gst_arv_usb_mode_get_type())
 static GType
 gst_arv_usb_mode_get_type (void)
@@ -116,6 +149,86 @@ static GstStaticPadTemplate aravis_src_template = GST_STATIC_PAD_TEMPLATE ("src"
 									   GST_PAD_ALWAYS,
 									   GST_STATIC_CAPS ("ANY"));
 
+/* Compressed payloads, selected by the ImageCompressionMode feature of the SFNC, are output as bitstreams for the
+ * software or hardware decoders of the pipeline, like jpegdec, vajpegdec, nvjpegdec, vah264dec or nvh264dec. */
+
+static const struct {
+	const char *compression_mode;
+	const char *caps_string;
+} gst_aravis_compressed_formats[] = {
+	{ "JPEG",	"image/jpeg" },
+	{ "JPEG2000",	"image/x-j2c" },
+	{ "H264",	"video/x-h264, stream-format=(string)byte-stream, alignment=(string)au" }
+};
+
+static const char *
+gst_aravis_get_compression_mode (const char *structure_name)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (gst_aravis_compressed_formats); i++)
+		if (g_str_has_prefix (gst_aravis_compressed_formats[i].caps_string, structure_name) &&
+		    (gst_aravis_compressed_formats[i].caps_string[strlen (structure_name)] == '\0' ||
+		     gst_aravis_compressed_formats[i].caps_string[strlen (structure_name)] == ','))
+			return gst_aravis_compressed_formats[i].compression_mode;
+
+	return NULL;
+}
+
+static const char *
+gst_aravis_get_compressed_caps_string (const char *compression_mode)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (gst_aravis_compressed_formats); i++)
+		if (g_strcmp0 (gst_aravis_compressed_formats[i].compression_mode, compression_mode) == 0)
+			return gst_aravis_compressed_formats[i].caps_string;
+
+	return NULL;
+}
+
+static void
+gst_aravis_append_compressed_caps (GstAravis *gst_aravis, GstCaps *caps,
+				   int min_width, int max_width, int min_height, int max_height,
+				   gboolean is_frame_rate_available,
+				   int min_frame_rate_numerator, int min_frame_rate_denominator,
+				   int max_frame_rate_numerator, int max_frame_rate_denominator)
+{
+	const char **modes;
+	guint n_modes = 0;
+	unsigned int i;
+
+	if (!arv_camera_is_feature_available (gst_aravis->camera, "ImageCompressionMode", NULL))
+		return;
+
+	modes = arv_camera_dup_available_enumerations_as_strings (gst_aravis->camera, "ImageCompressionMode",
+								  &n_modes, NULL);
+	for (i = 0; modes != NULL && i < n_modes; i++) {
+		const char *caps_string = gst_aravis_get_compressed_caps_string (modes[i]);
+		GstStructure *structure;
+
+		if (caps_string == NULL)
+			continue;
+
+		structure = gst_structure_from_string (caps_string, NULL);
+		gst_structure_set (structure,
+				   "width", GST_TYPE_INT_RANGE, min_width, max_width,
+				   "height", GST_TYPE_INT_RANGE, min_height, max_height,
+				   NULL);
+		if (is_frame_rate_available)
+			gst_structure_set (structure,
+					   "framerate", GST_TYPE_FRACTION_RANGE,
+					   min_frame_rate_numerator, min_frame_rate_denominator,
+					   max_frame_rate_numerator, max_frame_rate_denominator,
+					   NULL);
+		gst_caps_append_structure (caps, structure);
+
+		GST_DEBUG_OBJECT (gst_aravis, "Compressed mode %s available", modes[i]);
+	}
+
+	g_free (modes);
+}
+
 static GstCaps *
 gst_aravis_get_all_camera_caps (GstAravis *gst_aravis, GError **error)
 {
@@ -183,6 +296,29 @@ gst_aravis_get_all_camera_caps (GstAravis *gst_aravis, GError **error)
 
 	g_free (pixel_formats);
 
+	gst_aravis_append_compressed_caps (gst_aravis, caps,
+					   min_width, max_width, min_height, max_height,
+					   is_frame_rate_available,
+					   min_frame_rate_numerator, min_frame_rate_denominator,
+					   max_frame_rate_numerator, max_frame_rate_denominator);
+
+	/* DMABuf memory is preferred, system memory stays available for the elements which can't import it */
+	if (gst_aravis->dmabuf) {
+		GstCaps *dmabuf_caps = gst_caps_new_empty ();
+
+		for (i = 0; i < gst_caps_get_size (caps); i++) {
+			GstStructure *structure = gst_caps_get_structure (caps, i);
+
+			if (gst_structure_has_name (structure, "video/x-raw"))
+				gst_caps_append_structure_full (dmabuf_caps, gst_structure_copy (structure),
+								gst_caps_features_new (GST_CAPS_FEATURE_MEMORY_DMABUF,
+										       NULL));
+		}
+
+		gst_caps_append (dmabuf_caps, caps);
+		caps = dmabuf_caps;
+	}
+
 	return caps;
 }
 
@@ -204,6 +340,139 @@ gst_aravis_get_caps (GstBaseSrc * src, GstCaps * filter)
 	return caps;
 }
 
+/* The successfully received buffers of a stream are moved by its thread to a queue attached to the stream, which
+ * lets create wait for them without holding the object lock. A marker pushed by the unlock vfunc wakes up the
+ * waiting create. */
+
+static int gst_aravis_queue_wakeup;
+
+#define GST_ARAVIS_QUEUE_WAKEUP ((gpointer) &gst_aravis_queue_wakeup)
+
+G_DEFINE_QUARK (gst-aravis-buffer-queue, gst_aravis_buffer_queue)
+
+static void
+gst_aravis_free_queue_item (gpointer data)
+{
+	if (data != GST_ARAVIS_QUEUE_WAKEUP)
+		g_object_unref (data);
+}
+
+/* Incomplete images whose received data is large enough are pushed, flagged as corrupted, instead of losing the whole
+ * exposure */
+
+static gboolean
+gst_aravis_is_salvageable (GstAravis *gst_aravis, ArvBuffer *arv_buffer)
+{
+	ArvBufferStatus status = arv_buffer_get_status (arv_buffer);
+	ArvBufferPayloadType payload_type = arv_buffer_get_payload_type (arv_buffer);
+	gint min_valid_ppm = g_atomic_int_get (&gst_aravis->min_valid_ppm);
+	size_t image_size;
+	int height;
+
+	if (min_valid_ppm >= 1000000 ||
+	    (status != ARV_BUFFER_STATUS_MISSING_PACKETS && status != ARV_BUFFER_STATUS_TIMEOUT) ||
+	    (payload_type != ARV_BUFFER_PAYLOAD_TYPE_IMAGE &&
+	     payload_type != ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK))
+		return FALSE;
+
+	height = arv_buffer_get_image_height (arv_buffer);
+	image_size = (size_t) MAX (height, 0) * arv_buffer_get_image_stride (arv_buffer);
+
+	return image_size > 0 &&
+		(double) arv_buffer_get_valid_size (arv_buffer) * 1000000.0 >= (double) image_size * min_valid_ppm;
+}
+
+static void
+gst_aravis_new_buffer_cb (ArvStream *stream, GstAravis *gst_aravis)
+{
+	GAsyncQueue *queue = g_object_get_qdata (G_OBJECT (stream), gst_aravis_buffer_queue_quark ());
+	ArvBuffer *arv_buffer;
+
+	while ((arv_buffer = arv_stream_try_pop_buffer (stream)) != NULL) {
+		if (arv_buffer_get_status (arv_buffer) == ARV_BUFFER_STATUS_SUCCESS ||
+		    gst_aravis_is_salvageable (gst_aravis, arv_buffer)) {
+			g_async_queue_push (queue, arv_buffer);
+		} else {
+			/* Failed buffers go back to the stream right away, instead of costing a create round */
+			arv_stream_push_buffer (stream, arv_buffer);
+			g_atomic_int_inc ((gint *) &gst_aravis->n_failed_buffers);
+		}
+	}
+}
+
+static void
+gst_aravis_attach_buffer_queue (GstAravis *gst_aravis, ArvStream *stream)
+{
+	g_object_set_qdata_full (G_OBJECT (stream), gst_aravis_buffer_queue_quark (),
+				 g_async_queue_new_full (gst_aravis_free_queue_item),
+				 (GDestroyNotify) g_async_queue_unref);
+	g_signal_connect (stream, "new-buffer", G_CALLBACK (gst_aravis_new_buffer_cb), gst_aravis);
+	arv_stream_set_emit_signals (stream, TRUE);
+}
+
+/* Reports the buffers failed or dropped since the last call in a QoS message */
+
+static void
+gst_aravis_post_qos (GstAravis *gst_aravis)
+{
+	GstMessage *message;
+	guint n_failed_buffers;
+
+	n_failed_buffers = g_atomic_int_get ((gint *) &gst_aravis->n_failed_buffers);
+	if (n_failed_buffers == gst_aravis->n_reported_failed_buffers)
+		return;
+
+	GST_DEBUG_OBJECT (gst_aravis, "%u failed buffers recycled",
+			  n_failed_buffers - gst_aravis->n_reported_failed_buffers);
+	gst_aravis->n_reported_failed_buffers = n_failed_buffers;
+
+	message = gst_message_new_qos (GST_OBJECT (gst_aravis), TRUE,
+				       GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE);
+	gst_message_set_qos_stats (message, GST_FORMAT_BUFFERS, gst_aravis->n_pushed_frames,
+				   n_failed_buffers + gst_aravis->n_dropped_frames);
+	gst_element_post_message (GST_ELEMENT (gst_aravis), message);
+}
+
+static gboolean
+gst_aravis_unlock (GstBaseSrc *src)
+{
+	GstAravis *gst_aravis = GST_ARAVIS (src);
+
+	g_atomic_int_set (&gst_aravis->flushing, TRUE);
+
+	GST_OBJECT_LOCK (gst_aravis);
+	if (gst_aravis->stream != NULL)
+		g_async_queue_push (g_object_get_qdata (G_OBJECT (gst_aravis->stream),
+							gst_aravis_buffer_queue_quark ()),
+				    GST_ARAVIS_QUEUE_WAKEUP);
+	GST_OBJECT_UNLOCK (gst_aravis);
+
+	return TRUE;
+}
+
+static gboolean
+gst_aravis_unlock_stop (GstBaseSrc *src)
+{
+	GstAravis *gst_aravis = GST_ARAVIS (src);
+	GAsyncQueue *queue = NULL;
+
+	g_atomic_int_set (&gst_aravis->flushing, FALSE);
+
+	/* Drop the pending wakeup markers */
+	GST_OBJECT_LOCK (gst_aravis);
+	if (gst_aravis->stream != NULL)
+		queue = g_async_queue_ref (g_object_get_qdata (G_OBJECT (gst_aravis->stream),
+							       gst_aravis_buffer_queue_quark ()));
+	GST_OBJECT_UNLOCK (gst_aravis);
+
+	if (queue != NULL) {
+		g_async_queue_remove (queue, GST_ARAVIS_QUEUE_WAKEUP);
+		g_async_queue_unref (queue);
+	}
+
+	return TRUE;
+}
+
 static gboolean
 gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 {
@@ -217,7 +486,9 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 	const GValue *frame_rate = NULL;
 	const char *caps_string;
 	const char *format_string;
+	const char *compression_mode;
 	unsigned int i;
+	unsigned int n_buffers;
 	ArvStream *orig_stream = NULL;
 	GstCaps *orig_fixed_caps = NULL;
 	gboolean result = FALSE;
@@ -253,7 +524,12 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 		frame_rate = gst_structure_get_value (structure, "framerate");
 	format_string = gst_structure_get_string (structure, "format");
 
-	pixel_format = arv_pixel_format_from_gst_caps (gst_structure_get_name (structure), format_string, bpp, depth);
+	compression_mode = gst_aravis_get_compression_mode (gst_structure_get_name (structure));
+	if (compression_mode != NULL)
+		pixel_format = arv_camera_get_pixel_format (gst_aravis->camera, NULL);
+	else
+		pixel_format = arv_pixel_format_from_gst_caps (gst_structure_get_name (structure), format_string,
+							       bpp, depth);
 
 	if (!pixel_format) {
 		GST_ERROR_OBJECT (src, "did not find matching pixel_format");
@@ -264,7 +540,15 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 
 	orig_stream = g_steal_pointer (&gst_aravis->stream);
 
-	if (!error) arv_camera_set_pixel_format (gst_aravis->camera, pixel_format, &error);
+	gst_aravis->has_video_info = gst_video_info_from_caps (&gst_aravis->video_info, caps);
+	gst_aravis->use_dmabuf_memory = gst_caps_get_features (caps, 0) != NULL &&
+		gst_caps_features_contains (gst_caps_get_features (caps, 0), GST_CAPS_FEATURE_MEMORY_DMABUF);
+
+	if (!error && compression_mode == NULL)
+		arv_camera_set_pixel_format (gst_aravis->camera, pixel_format, &error);
+	if (!error && arv_camera_is_feature_available (gst_aravis->camera, "ImageCompressionMode", NULL))
+		arv_camera_set_string (gst_aravis->camera, "ImageCompressionMode",
+				       compression_mode != NULL ? compression_mode : "Off", &error);
 	if (!error) arv_camera_set_binning (gst_aravis->camera, gst_aravis->h_binning, gst_aravis->v_binning, &error);
 	if (!error) {
                 if (width != current_width || height != current_height)
@@ -344,7 +628,10 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 
 	orig_fixed_caps = g_steal_pointer (&gst_aravis->fixed_caps);
 
-	caps_string = arv_pixel_format_to_gst_caps_string (pixel_format);
+	if (compression_mode != NULL)
+		caps_string = gst_aravis_get_compressed_caps_string (compression_mode);
+	else
+		caps_string = arv_pixel_format_to_gst_caps_string (pixel_format);
 	if (caps_string != NULL) {
 		GstStructure *structure;
 		GstCaps *caps;
@@ -366,12 +653,15 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 		gst_aravis->fixed_caps = NULL;
 
 	if (!error) arv_device_set_features_from_string (arv_camera_get_device (gst_aravis->camera), gst_aravis->features, &error);
+	if (!error) gst_aravis_setup_chunks (gst_aravis, &error);
 
 	if (!error) gst_aravis->payload = arv_camera_get_payload (gst_aravis->camera, &error);
 	if (!error) gst_aravis->stream = arv_camera_create_stream (gst_aravis->camera, NULL, NULL, &error);
 	if (error)
 		goto errored;
 
+	gst_aravis_attach_buffer_queue (gst_aravis, gst_aravis->stream);
+
 	if (ARV_IS_GV_STREAM (gst_aravis->stream)) {
 		if (gst_aravis->packet_resend)
 			g_object_set (gst_aravis->stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_ALWAYS, NULL);
@@ -379,9 +669,28 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 			g_object_set (gst_aravis->stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
 	}
 
-	for (i = 0; i < gst_aravis->num_arv_buffers; i++)
-		arv_stream_push_buffer (gst_aravis->stream,
-					arv_buffer_new (gst_aravis->payload, NULL));
+	n_buffers = gst_aravis->num_arv_buffers;
+	if (n_buffers == 0) {
+		/* The DMABuf buffers are exported to the pipeline, their count stays fixed */
+		if (gst_aravis->use_dmabuf_memory)
+			n_buffers = GST_ARAVIS_DEFAULT_N_BUFFERS;
+		else
+			arv_stream_set_auto_buffers (gst_aravis->stream, gst_aravis->payload,
+						     GST_ARAVIS_AUTO_MIN_BUFFERS, gst_aravis->max_buffer_memory);
+	}
+
+	for (i = 0; i < n_buffers; i++) {
+		ArvBuffer *arv_buffer;
+
+		if (gst_aravis->use_dmabuf_memory) {
+			arv_buffer = arv_buffer_new_dmabuf (gst_aravis->payload, NULL, &error);
+			if (arv_buffer == NULL)
+				goto errored;
+		} else
+			arv_buffer = arv_buffer_new (gst_aravis->payload, NULL);
+
+		arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
+	}
 
 	GST_LOG_OBJECT (gst_aravis, "Start acquisition");
 	arv_camera_start_acquisition (gst_aravis->camera, &error);
@@ -417,6 +726,63 @@ unref:
 	return result;
 }
 
+/* Enables the selected chunks, and resolves their accessors once, the chunk values of each frame being then read in a
+ * single walk of the chunk trailer. Must be called with the object lock held. */
+
+static void
+gst_aravis_setup_chunks (GstAravis *gst_aravis, GError **error)
+{
+	GError *local_error = NULL;
+	char **chunks;
+	guint i;
+
+	g_clear_object (&gst_aravis->chunk_parser);
+	gst_aravis->n_chunks = 0;
+
+	if (gst_aravis->chunks == NULL || gst_aravis->chunks[0] == '\0')
+		return;
+
+	arv_camera_set_chunks (gst_aravis->camera, gst_aravis->chunks, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	gst_aravis->chunk_parser = arv_camera_create_chunk_parser (gst_aravis->camera);
+	if (gst_aravis->chunk_parser == NULL)
+		return;
+
+	chunks = g_strsplit_set (gst_aravis->chunks, " ,:;", -1);
+	for (i = 0; chunks[i] != NULL; i++) {
+		char *name;
+		gint accessor;
+
+		if (chunks[i][0] == '\0')
+			continue;
+
+		if (gst_aravis->n_chunks >= GST_ARAVIS_META_MAX_CHUNKS) {
+			GST_WARNING_OBJECT (gst_aravis, "Too many chunks, '%s' not attached", chunks[i]);
+			continue;
+		}
+
+		name = g_strdup_printf ("Chunk%s", chunks[i]);
+		accessor = arv_chunk_parser_get_accessor (gst_aravis->chunk_parser, name, &local_error);
+		if (accessor < 0) {
+			GST_WARNING_OBJECT (gst_aravis, "Chunk '%s' not attached: %s", name,
+					    local_error != NULL ? local_error->message : "unknown chunk");
+			g_clear_error (&local_error);
+		} else {
+			gst_aravis->chunk_accessors[gst_aravis->n_chunks] = accessor;
+			gst_aravis->chunk_names[gst_aravis->n_chunks] = g_quark_from_string (name);
+			gst_aravis->n_chunks++;
+		}
+		g_free (name);
+	}
+	g_strfreev (chunks);
+
+	GST_DEBUG_OBJECT (gst_aravis, "%u chunk(s) attached to the buffers", gst_aravis->n_chunks);
+}
+
 static gboolean
 gst_aravis_init_camera (GstAravis *gst_aravis, GError **error)
 {
@@ -535,6 +901,102 @@ gst_aravis_get_times (GstBaseSrc * basesrc, GstBuffer * buffer,
 	}
 }
 
+static gboolean
+gst_aravis_decide_allocation (GstBaseSrc *bsrc, GstQuery *query)
+{
+	GstAravis *gst_aravis = GST_ARAVIS (bsrc);
+	gboolean video_meta_supported;
+
+	video_meta_supported = gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+	GST_OBJECT_LOCK (gst_aravis);
+	gst_aravis->video_meta_supported = video_meta_supported;
+	GST_OBJECT_UNLOCK (gst_aravis);
+
+	GST_DEBUG_OBJECT (gst_aravis, "Video meta %ssupported downstream", video_meta_supported ? "" : "not ");
+
+	return GST_BASE_SRC_CLASS (gst_aravis_parent_class)->decide_allocation (bsrc, query);
+}
+
+typedef struct {
+	ArvStream *stream;
+	ArvBuffer *arv_buffer;
+} GstAravisBufferRelease;
+
+G_DEFINE_QUARK (gst-aravis-buffer-release, gst_aravis_buffer_release)
+
+/* Gives the wrapped ArvBuffer back to its stream, once the GstBuffer memory is freed */
+
+static void
+gst_aravis_release_buffer (gpointer data)
+{
+	GstAravisBufferRelease *release = data;
+
+	arv_stream_push_buffer (release->stream, release->arv_buffer);
+	g_object_unref (release->stream);
+	g_free (release);
+}
+
+/* Makes the data written by the stream thread visible to the devices importing the DMA buffer */
+
+static void
+gst_aravis_sync_dmabuf (int fd)
+{
+#if ARAVIS_HAS_DMA_HEAP
+	struct dma_buf_sync sync = { DMA_BUF_SYNC_START | DMA_BUF_SYNC_WRITE };
+
+	ioctl (fd, DMA_BUF_IOCTL_SYNC, &sync);
+	sync.flags = DMA_BUF_SYNC_END | DMA_BUF_SYNC_WRITE;
+	ioctl (fd, DMA_BUF_IOCTL_SYNC, &sync);
+#endif
+}
+
+/* Returns the age of a frame, measured in the clock domain of its timestamp, -1 if unknown */
+
+static gint64
+gst_aravis_get_frame_age (GstAravisTimestampSource timestamp_source, ArvBuffer *arv_buffer)
+{
+	switch (timestamp_source) {
+		case GST_ARAVIS_TIMESTAMP_SOURCE_SYSTEM:
+			return g_get_real_time () * 1000LL - (gint64) arv_buffer_get_system_timestamp (arv_buffer);
+		case GST_ARAVIS_TIMESTAMP_SOURCE_PTP:
+#ifdef CLOCK_TAI
+			{
+				struct timespec now;
+
+				if (clock_gettime (CLOCK_TAI, &now) == 0)
+					return (gint64) now.tv_sec * 1000000000LL + now.tv_nsec -
+						(gint64) arv_buffer_get_timestamp (arv_buffer);
+			}
+#endif
+			return -1;
+		default:
+			return -1;
+	}
+}
+
+/* The frame capture time is converted to the pipeline running time by subtracting the frame age from the current
+ * running time, which keeps the elements fed by several cameras in a common time base. */
+
+static GstClockTime
+gst_aravis_get_capture_running_time (GstAravis *gst_aravis, gint64 age_ns)
+{
+	GstClock *clock;
+	GstClockTime running_time;
+
+	if (age_ns < 0)
+		return GST_CLOCK_TIME_NONE;
+
+	clock = gst_element_get_clock (GST_ELEMENT (gst_aravis));
+	if (clock == NULL)
+		return GST_CLOCK_TIME_NONE;
+
+	running_time = gst_clock_get_time (clock) - gst_element_get_base_time (GST_ELEMENT (gst_aravis));
+	gst_object_unref (clock);
+
+	return running_time > (GstClockTime) age_ns ? running_time - age_ns : 0;
+}
+
 static GstFlowReturn
 gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 {
@@ -546,27 +1008,104 @@ gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 	guint64 timestamp_ns;
 	gboolean base_src_does_timestamp;
 	ArvBuffer *arv_buffer = NULL;
+	GstAravisTimestampSource timestamp_source;
+	gint64 frame_age_ns = -1;
+	double frame_rate;
+	ArvBufferPayloadType payload_type;
+	ArvStream *stream;
+	GAsyncQueue *queue;
+	guint64 buffer_timeout_us;
+	gboolean low_latency;
+	gboolean is_incomplete;
 
 	gst_aravis = GST_ARAVIS (push_src);
 	base_src_does_timestamp = gst_base_src_get_do_timestamp(GST_BASE_SRC(push_src));
 
 	GST_OBJECT_LOCK (gst_aravis);
+	if (gst_aravis->stream == NULL) {
+		GST_OBJECT_UNLOCK (gst_aravis);
+		return GST_FLOW_ERROR;
+	}
+	stream = g_object_ref (gst_aravis->stream);
+	buffer_timeout_us = gst_aravis->buffer_timeout_us;
+	low_latency = gst_aravis->low_latency;
+	GST_OBJECT_UNLOCK (gst_aravis);
+
+	queue = g_object_get_qdata (G_OBJECT (stream), gst_aravis_buffer_queue_quark ());
+
+	/* The stream thread already recycled the failed buffers, the object lock is free during the wait */
+	if (!g_atomic_int_get (&gst_aravis->flushing))
+		arv_buffer = g_async_queue_timeout_pop (queue, buffer_timeout_us);
+
+	if (arv_buffer == GST_ARAVIS_QUEUE_WAKEUP || g_atomic_int_get (&gst_aravis->flushing)) {
+		if (arv_buffer != NULL && arv_buffer != GST_ARAVIS_QUEUE_WAKEUP)
+			arv_stream_push_buffer (stream, arv_buffer);
+		g_object_unref (stream);
+		return GST_FLOW_FLUSHING;
+	}
+
+	if (arv_buffer == NULL) {
+		g_object_unref (stream);
+		return GST_FLOW_ERROR;
+	}
+
+	if (low_latency) {
+		ArvBuffer *newer_buffer;
+
+		while ((newer_buffer = g_async_queue_try_pop (queue)) != NULL) {
+			if (newer_buffer == GST_ARAVIS_QUEUE_WAKEUP) {
+				/* Keep the flush request for the next round */
+				g_async_queue_push (queue, newer_buffer);
+				break;
+			}
+			arv_stream_push_buffer (stream, arv_buffer);
+			arv_buffer = newer_buffer;
+			gst_aravis->n_dropped_frames++;
+			GST_DEBUG_OBJECT (gst_aravis, "Drop stale frame (%" G_GUINT64_FORMAT " dropped)",
+					  gst_aravis->n_dropped_frames);
+		}
+	}
 
-	do {
-		if (arv_buffer) arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
-		arv_buffer = arv_stream_timeout_pop_buffer (gst_aravis->stream, gst_aravis->buffer_timeout_us);
-	} while (arv_buffer != NULL && arv_buffer_get_status (arv_buffer) != ARV_BUFFER_STATUS_SUCCESS);
+	gst_aravis->n_pushed_frames++;
+	gst_aravis_post_qos (gst_aravis);
+
+	GST_OBJECT_LOCK (gst_aravis);
 
-	if (arv_buffer == NULL)
-		goto error;
+	timestamp_source = gst_aravis->timestamp_source;
+	frame_rate = gst_aravis->frame_rate;
+	if (timestamp_source != GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE)
+		frame_age_ns = gst_aravis_get_frame_age (timestamp_source, arv_buffer);
 
 	buffer_data = (char *) arv_buffer_get_data (arv_buffer, &buffer_size);
-	arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
-	arv_row_stride = width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
+	payload_type = arv_buffer_get_payload_type (arv_buffer);
+	if (payload_type == ARV_BUFFER_PAYLOAD_TYPE_JPEG ||
+	    payload_type == ARV_BUFFER_PAYLOAD_TYPE_JPEG2000 ||
+	    payload_type == ARV_BUFFER_PAYLOAD_TYPE_H264) {
+		/* Compressed bitstreams are pushed as received */
+		width = height = 0;
+		arv_row_stride = 0;
+	} else {
+		arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
+		arv_row_stride = width *
+			ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
+	}
 	timestamp_ns = arv_buffer_get_timestamp (arv_buffer);
 
-	/* Gstreamer requires row stride to be a multiple of 4 */
-	if ((arv_row_stride & 0x3) != 0) {
+	/* The data of a salvaged image are only valid in the ranges given by arv_buffer_get_valid_ranges() */
+	is_incomplete = arv_buffer_get_status (arv_buffer) != ARV_BUFFER_STATUS_SUCCESS;
+	if (is_incomplete) {
+		buffer_size = MAX (buffer_size, (size_t) height * arv_buffer_get_image_stride (arv_buffer));
+		GST_LOG_OBJECT (gst_aravis, "Push incomplete frame %" G_GUINT64_FORMAT " (%" G_GSIZE_FORMAT
+				"/%" G_GSIZE_FORMAT " bytes)", arv_buffer_get_frame_id (arv_buffer),
+				arv_buffer_get_valid_size (arv_buffer), buffer_size);
+	}
+
+	/* Gstreamer requires row stride to be a multiple of 4, unless the actual stride is described by a video meta */
+	if ((arv_row_stride & 0x3) != 0 &&
+	    !gst_aravis->use_dmabuf_memory &&
+	    (!gst_aravis->video_meta_supported ||
+	     !gst_aravis->has_video_info ||
+	     GST_VIDEO_INFO_N_PLANES (&gst_aravis->video_info) != 1)) {
 		int gst_row_stride;
 		size_t size;
 		char *data;
@@ -581,12 +1120,54 @@ gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 			memcpy (data + i * gst_row_stride, buffer_data + i * arv_row_stride, arv_row_stride);
 
 		*buffer = gst_buffer_new_wrapped (data, size);
+
+		gst_buffer_add_aravis_meta (*buffer, arv_buffer, gst_aravis->chunk_parser,
+					    gst_aravis->chunk_accessors, gst_aravis->chunk_names, gst_aravis->n_chunks);
+
+		arv_stream_push_buffer (stream, arv_buffer);
 	} else {
-		// FIXME Should arv_stream_push_buffer when the GstBuffer is destroyed
-		*buffer = gst_buffer_new_wrapped_full (0, buffer_data, buffer_size, 0, buffer_size, NULL, NULL);
+		GstAravisBufferRelease *release;
+
+		/* The ArvBuffer stays out of the stream as long as downstream elements use its data */
+		release = g_new (GstAravisBufferRelease, 1);
+		release->stream = g_object_ref (stream);
+		release->arv_buffer = arv_buffer;
+
+		if (gst_aravis->use_dmabuf_memory) {
+			GstMemory *memory;
+			int dmabuf_fd = arv_buffer_get_dmabuf_fd (arv_buffer);
+
+			gst_aravis_sync_dmabuf (dmabuf_fd);
+
+			/* The file descriptor belongs to the ArvBuffer */
+			memory = gst_dmabuf_allocator_alloc_with_flags (gst_aravis->dmabuf_allocator, dmabuf_fd,
+									 buffer_size, GST_FD_MEMORY_FLAG_DONT_CLOSE);
+			gst_mini_object_set_qdata (GST_MINI_OBJECT (memory), gst_aravis_buffer_release_quark (),
+						   release, gst_aravis_release_buffer);
+
+			*buffer = gst_buffer_new ();
+			gst_buffer_append_memory (*buffer, memory);
+		} else
+			*buffer = gst_buffer_new_wrapped_full (0, buffer_data, buffer_size, 0, buffer_size,
+							       release, gst_aravis_release_buffer);
+
+		if ((arv_row_stride & 0x3) != 0 && gst_aravis->has_video_info) {
+			gsize offset[GST_VIDEO_MAX_PLANES] = {0};
+			gint stride[GST_VIDEO_MAX_PLANES] = {arv_row_stride};
+
+			gst_buffer_add_video_meta_full (*buffer, GST_VIDEO_FRAME_FLAG_NONE,
+							GST_VIDEO_INFO_FORMAT (&gst_aravis->video_info),
+							width, height, 1, offset, stride);
+		}
+
+		gst_buffer_add_aravis_meta (*buffer, arv_buffer, gst_aravis->chunk_parser,
+					    gst_aravis->chunk_accessors, gst_aravis->chunk_names, gst_aravis->n_chunks);
 	}
 
-	if (!base_src_does_timestamp) {
+	if (is_incomplete)
+		GST_BUFFER_FLAG_SET (*buffer, GST_BUFFER_FLAG_CORRUPTED);
+
+	if (!base_src_does_timestamp && timestamp_source == GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE) {
 		if (gst_aravis->timestamp_offset == 0) {
 			gst_aravis->timestamp_offset = timestamp_ns;
 			gst_aravis->last_timestamp = timestamp_ns;
@@ -598,14 +1179,18 @@ gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 		gst_aravis->last_timestamp = timestamp_ns;
 	}
 
-	arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
-	return GST_FLOW_OK;
+	g_object_unref (stream);
 
-error:
-	GST_OBJECT_UNLOCK (gst_aravis);
-	return GST_FLOW_ERROR;
+	/* The element clock can't be retrieved with the object lock held */
+	if (!base_src_does_timestamp && timestamp_source != GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE) {
+		GST_BUFFER_PTS (*buffer) = gst_aravis_get_capture_running_time (gst_aravis, frame_age_ns);
+		GST_BUFFER_DURATION (*buffer) = frame_rate > 0.0 ?
+			(GstClockTime) (GST_SECOND / frame_rate) : GST_CLOCK_TIME_NONE;
+	}
+
+	return GST_FLOW_OK;
 }
 
 static GstCaps *
@@ -672,6 +1257,7 @@ gst_aravis_init (GstAravis *gst_aravis)
 	gst_aravis->auto_packet_size = FALSE;
         gst_aravis->packet_resend = TRUE;
 	gst_aravis->num_arv_buffers = GST_ARAVIS_DEFAULT_N_BUFFERS;
+	gst_aravis->max_buffer_memory = GST_ARAVIS_DEFAULT_MAX_BUFFER_MEMORY;
 	gst_aravis->payload = 0;
 	gst_aravis->usb_mode = ARV_UV_USB_MODE_DEFAULT;
 
@@ -683,6 +1269,12 @@ gst_aravis_init (GstAravis *gst_aravis)
 
 	gst_aravis->all_caps = NULL;
 	gst_aravis->fixed_caps = NULL;
+
+	gst_aravis->dmabuf = FALSE;
+	gst_aravis->timestamp_source = GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE;
+	gst_aravis->low_latency = FALSE;
+	gst_aravis->min_valid_ppm = 1000000;
+	gst_aravis->dmabuf_allocator = gst_dmabuf_allocator_new ();
 }
 
 static void
@@ -701,8 +1293,12 @@ gst_aravis_finalize (GObject * object)
 	fixed_caps = g_steal_pointer (&gst_aravis->fixed_caps);
 	g_clear_pointer (&gst_aravis->camera_name, g_free);
 	g_clear_pointer (&gst_aravis->features, g_free);
+	g_clear_pointer (&gst_aravis->chunks, g_free);
+	g_clear_object (&gst_aravis->chunk_parser);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
+	gst_clear_object (&gst_aravis->dmabuf_allocator);
+
 	if (camera != NULL)
 		g_object_unref (camera);
 	if (stream != NULL)
@@ -809,6 +1405,35 @@ gst_aravis_set_property (GObject * object, guint prop_id,
 		case PROP_USB_MODE:
 			gst_aravis->usb_mode = g_value_get_enum (value);
 			break;
+		case PROP_DMABUF:
+			GST_OBJECT_LOCK (gst_aravis);
+			gst_aravis->dmabuf = g_value_get_boolean (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_TIMESTAMP_SOURCE:
+			GST_OBJECT_LOCK (gst_aravis);
+			gst_aravis->timestamp_source = g_value_get_enum (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_LOW_LATENCY:
+			GST_OBJECT_LOCK (gst_aravis);
+			gst_aravis->low_latency = g_value_get_boolean (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_CHUNKS:
+			GST_OBJECT_LOCK (gst_aravis);
+			g_free (gst_aravis->chunks);
+			gst_aravis->chunks = g_value_dup_string (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_MIN_VALID_RATIO:
+			g_atomic_int_set (&gst_aravis->min_valid_ppm, (gint) (g_value_get_double (value) * 1000000.0 + 0.5));
+			break;
+		case PROP_MAX_BUFFER_MEMORY:
+			GST_OBJECT_LOCK (gst_aravis);
+			gst_aravis->max_buffer_memory = g_value_get_uint64 (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -899,6 +1524,24 @@ gst_aravis_get_property (GObject * object, guint prop_id, GValue * value,
 		case PROP_USB_MODE:
 			g_value_set_enum(value, gst_aravis->usb_mode);
 			break;
+		case PROP_DMABUF:
+			g_value_set_boolean (value, gst_aravis->dmabuf);
+			break;
+		case PROP_TIMESTAMP_SOURCE:
+			g_value_set_enum (value, gst_aravis->timestamp_source);
+			break;
+		case PROP_LOW_LATENCY:
+			g_value_set_boolean (value, gst_aravis->low_latency);
+			break;
+		case PROP_CHUNKS:
+			g_value_set_string (value, gst_aravis->chunks);
+			break;
+		case PROP_MAX_BUFFER_MEMORY:
+			g_value_set_uint64 (value, gst_aravis->max_buffer_memory);
+			break;
+		case PROP_MIN_VALID_RATIO:
+			g_value_set_double (value, g_atomic_int_get (&gst_aravis->min_valid_ppm) / 1000000.0);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -932,8 +1575,14 @@ gst_aravis_query (GstBaseSrc *bsrc, GstQuery *query)
 				goto done;
 			}
 
-			/* min latency is the time to capture one frame/field */
-			min_latency = gst_util_gdouble_to_guint64 (src->frame_rate);
+			/* min latency is the time to capture one frame/field, plus the observed time needed for its
+			 * transfer and completion by the stream */
+			min_latency = (GstClockTime) (GST_SECOND / src->frame_rate) +
+				(GstClockTime) (1000.0 *
+						(arv_stream_get_info_double_by_name (src->stream,
+										     "latency_transfer_p99_us") +
+						 arv_stream_get_info_double_by_name (src->stream,
+										     "latency_completion_p99_us")));
 
 			/* max latency is set to NONE because cameras may enter trigger mode
 			   and not deliver images for an unspecified amount of time */
@@ -1099,8 +1748,9 @@ gst_aravis_class_init (GstAravisClass * klass)
 		 PROP_NUM_ARV_BUFFERS,
 		 g_param_spec_int ("num-arv-buffers",
 				   "Number of Buffers allocated",
-				   "Number of video buffers to allocate for video frames",
-				   1, G_MAXINT, GST_ARAVIS_DEFAULT_N_BUFFERS,
+				   "Number of video buffers to allocate for video frames, 0 for an automatic "
+				   "tuning bounded by max-buffer-memory",
+				   0, G_MAXINT, GST_ARAVIS_DEFAULT_N_BUFFERS,
 				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
 	g_object_class_install_property
@@ -1111,6 +1761,62 @@ gst_aravis_class_init (GstAravisClass * klass)
 			       GST_TYPE_ARV_USB_MODE, ARV_UV_USB_MODE_DEFAULT,
 			       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_DMABUF,
+		 g_param_spec_boolean ("dmabuf",
+				       "DMABuf",
+				       "Allocate the stream buffers from the DMA heap and offer DMABuf memory caps",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_TIMESTAMP_SOURCE,
+		 g_param_spec_enum ("timestamp-source",
+				    "Timestamp source",
+				    "Clock domain of the buffer timestamps",
+				    GST_TYPE_ARV_TIMESTAMP_SOURCE, GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_LOW_LATENCY,
+		 g_param_spec_boolean ("low-latency",
+				       "Low latency",
+				       "Drop the stale frames, only the newest received frame is pushed",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_CHUNKS,
+		 g_param_spec_string ("chunks",
+				      "Chunks",
+				      "Comma separated list of chunks to enable, whose values are attached to the buffers "
+				      "in a GstAravisMeta, along with the frame metadata",
+				      NULL,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_MAX_BUFFER_MEMORY,
+		 g_param_spec_uint64 ("max-buffer-memory",
+				      "Maximum buffer memory",
+				      "Upper bound in bytes of the memory used by the stream buffers, when num-arv-buffers is 0",
+				      0, G_MAXUINT64, GST_ARAVIS_DEFAULT_MAX_BUFFER_MEMORY,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_MIN_VALID_RATIO,
+		 g_param_spec_double ("min-valid-ratio",
+				      "Minimum valid ratio",
+				      "Incomplete images with at least this part of their data received are pushed, flagged "
+				      "as corrupted. 1.0 only pushes the complete images",
+				      0.0, 1.0, 1.0,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
         GST_DEBUG_CATEGORY_INIT (aravis_debug, "aravissrc", 0, "Aravis interface");
 
 	gst_element_class_set_details_simple (element_class,
@@ -1126,7 +1832,10 @@ gst_aravis_class_init (GstAravisClass * klass)
 	gstbasesrc_class->fixate = GST_DEBUG_FUNCPTR (gst_aravis_fixate_caps);
 	gstbasesrc_class->start = GST_DEBUG_FUNCPTR (gst_aravis_start);
 	gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_aravis_stop);
+	gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR (gst_aravis_unlock);
+	gstbasesrc_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_aravis_unlock_stop);
 	gstbasesrc_class->query = GST_DEBUG_FUNCPTR (gst_aravis_query);
+	gstbasesrc_class->decide_allocation = GST_DEBUG_FUNCPTR (gst_aravis_decide_allocation);
 
 	gstbasesrc_class->get_times = GST_DEBUG_FUNCPTR (gst_aravis_get_times);
 
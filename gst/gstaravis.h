@@ -25,7 +25,10 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
+#include <gst/video/video.h>
+#include <gst/allocators/gstdmabuf.h>
 #include <arv.h>
+#include <gstaravismeta.h>
 
 G_BEGIN_DECLS
 
@@ -35,6 +38,12 @@ G_BEGIN_DECLS
 #define GST_IS_ARAVIS(obj) 		(G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_ARAVIS))
 #define GST_IS_ARAVIS_CLASS(obj)	(G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ARAVIS))
 
+typedef enum {
+	GST_ARAVIS_TIMESTAMP_SOURCE_DEVICE,
+	GST_ARAVIS_TIMESTAMP_SOURCE_SYSTEM,
+	GST_ARAVIS_TIMESTAMP_SOURCE_PTP
+} GstAravisTimestampSource;
+
 typedef struct _GstAravis GstAravis;
 typedef struct _GstAravisClass GstAravisClass;
 
@@ -56,6 +65,9 @@ struct _GstAravis {
 	gint h_binning;
 	gint v_binning;
 	gint num_arv_buffers;
+	guint64 max_buffer_memory;
+	/* Offer DMABuf memory caps, backed by DMA heap stream buffers */
+	gboolean dmabuf;
 
 	/* GigEVision parameters */
 	int packet_size;
@@ -76,10 +88,42 @@ struct _GstAravis {
 	GstCaps *all_caps;
 	GstCaps *fixed_caps;
 
+	/* Negotiated video format, only valid for video/x-raw caps */
+	gboolean has_video_info;
+	GstVideoInfo video_info;
+	/* Downstream handles GstVideoMeta, thus arbitrary row strides */
+	gboolean video_meta_supported;
+	/* DMABuf memory caps are negotiated */
+	gboolean use_dmabuf_memory;
+	GstAllocator *dmabuf_allocator;
+
+	GstAravisTimestampSource timestamp_source;
 	guint64 timestamp_offset;
 	guint64 last_timestamp;
 
+	/* Only push the newest frame of the stream output queue */
+	gboolean low_latency;
+	guint64 n_dropped_frames;
+
+	/* Incomplete images pushed when at least this part of the data was received, in parts per million, read by
+	 * the stream thread. 1000000 disables them. */
+	gint min_valid_ppm;
+
+	/* Counted by the stream thread, which recycles the failed buffers */
+	guint n_failed_buffers;
+	guint n_reported_failed_buffers;
+	guint64 n_pushed_frames;
+	/* Set by the unlock vfunc, makes create return GST_FLOW_FLUSHING */
+	gint flushing;
+
 	char *features;
+
+	/* Chunks attached to the output buffers in a GstAravisMeta */
+	char *chunks;
+	ArvChunkParser *chunk_parser;
+	guint n_chunks;
+	gint chunk_accessors[GST_ARAVIS_META_MAX_CHUNKS];
+	GQuark chunk_names[GST_ARAVIS_META_MAX_CHUNKS];
 };
 
 struct _GstAravisClass {
@@ -0,0 +1,163 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/*
+ * Frame metadata of the aravissrc output buffers. The meta only holds a copy of the fixed size metadata block and of
+ * the selected chunk values, the pixel data are never copied.
+ */
+
+#include <gstaravismeta.h>
+#include <string.h>
+
+GType
+gst_aravis_meta_api_get_type (void)
+{
+	static gsize type = 0;
+	static const gchar *tags[] = { NULL };
+
+	if (g_once_init_enter (&type)) {
+		GType api_type = gst_meta_api_type_register ("GstAravisMetaAPI", tags);
+
+		g_once_init_leave (&type, api_type);
+	}
+
+	return type;
+}
+
+static gboolean
+gst_aravis_meta_init (GstMeta *meta, gpointer params, GstBuffer *buffer)
+{
+	GstAravisMeta *aravis_meta = (GstAravisMeta *) meta;
+
+	memset (&aravis_meta->metadata, 0, sizeof (aravis_meta->metadata));
+	aravis_meta->n_chunks = 0;
+
+	return TRUE;
+}
+
+/* No tag, the frame metadata stay valid whatever the transformation of the pixel data */
+
+static gboolean
+gst_aravis_meta_transform (GstBuffer *dest, GstMeta *meta, GstBuffer *buffer, GQuark type, gpointer data)
+{
+	GstAravisMeta *aravis_meta = (GstAravisMeta *) meta;
+	GstAravisMeta *dest_meta;
+
+	dest_meta = (GstAravisMeta *) gst_buffer_add_meta (dest, GST_ARAVIS_META_INFO, NULL);
+	if (dest_meta == NULL)
+		return FALSE;
+
+	dest_meta->metadata = aravis_meta->metadata;
+	dest_meta->n_chunks = aravis_meta->n_chunks;
+	memcpy (dest_meta->chunk_names, aravis_meta->chunk_names, sizeof (GQuark) * aravis_meta->n_chunks);
+	memcpy (dest_meta->chunk_values, aravis_meta->chunk_values, sizeof (ArvChunkValue) * aravis_meta->n_chunks);
+
+	return TRUE;
+}
+
+const GstMetaInfo *
+gst_aravis_meta_get_info (void)
+{
+	static const GstMetaInfo *meta_info = NULL;
+
+	if (g_once_init_enter ((GstMetaInfo **) &meta_info)) {
+		const GstMetaInfo *info = gst_meta_register (GST_ARAVIS_META_API_TYPE, "GstAravisMeta",
+							     sizeof (GstAravisMeta),
+							     gst_aravis_meta_init, NULL,
+							     gst_aravis_meta_transform);
+
+		g_once_init_leave ((GstMetaInfo **) &meta_info, (GstMetaInfo *) info);
+	}
+
+	return meta_info;
+}
+
+/**
+ * gst_buffer_add_aravis_meta:
+ * @buffer: a #GstBuffer
+ * @arv_buffer: the #ArvBuffer the data of @buffer come from
+ * @parser: (allow-none): a #ArvChunkParser, %NULL if no chunk is selected
+ * @accessors: (array length=n_chunks): chunk accessors, from arv_chunk_parser_get_accessor()
+ * @chunk_names: (array length=n_chunks): chunk names
+ * @n_chunks: number of chunks, at most #GST_ARAVIS_META_MAX_CHUNKS
+ *
+ * Attaches the metadata block of @arv_buffer to @buffer, and the values of the selected chunks, read in a single
+ * walk of the chunk trailer. The chunks missing from @arv_buffer have an invalid value.
+ *
+ * Returns: (transfer none): the attached #GstAravisMeta.
+ */
+
+GstAravisMeta *
+gst_buffer_add_aravis_meta (GstBuffer *buffer, ArvBuffer *arv_buffer,
+			    ArvChunkParser *parser, const gint *accessors,
+			    const GQuark *chunk_names, guint n_chunks)
+{
+	GstAravisMeta *meta;
+	const ArvBufferMetadata *metadata;
+
+	g_return_val_if_fail (GST_IS_BUFFER (buffer), NULL);
+	g_return_val_if_fail (ARV_IS_BUFFER (arv_buffer), NULL);
+	g_return_val_if_fail (n_chunks <= GST_ARAVIS_META_MAX_CHUNKS, NULL);
+
+	meta = (GstAravisMeta *) gst_buffer_add_meta (buffer, GST_ARAVIS_META_INFO, NULL);
+
+	metadata = arv_buffer_get_metadata (arv_buffer);
+	if (metadata != NULL)
+		meta->metadata = *metadata;
+
+	if (parser != NULL && n_chunks > 0 && arv_buffer_has_chunks (arv_buffer)) {
+		memcpy (meta->chunk_names, chunk_names, sizeof (GQuark) * n_chunks);
+		memset (meta->chunk_values, 0, sizeof (ArvChunkValue) * n_chunks);
+		arv_chunk_parser_parse_buffer (parser, arv_buffer, accessors, n_chunks, meta->chunk_values, NULL);
+		meta->n_chunks = n_chunks;
+	}
+
+	return meta;
+}
+
+/**
+ * gst_aravis_meta_get_chunk_value:
+ * @meta: a #GstAravisMeta
+ * @chunk: a chunk feature name
+ *
+ * Returns: (transfer none): the value of @chunk, %NULL if @chunk was not selected or not found in the frame.
+ */
+
+const ArvChunkValue *
+gst_aravis_meta_get_chunk_value (GstAravisMeta *meta, const char *chunk)
+{
+	GQuark quark;
+	guint i;
+
+	g_return_val_if_fail (meta != NULL, NULL);
+
+	quark = g_quark_try_string (chunk);
+	if (quark == 0)
+		return NULL;
+
+	for (i = 0; i < meta->n_chunks; i++)
+		if (meta->chunk_names[i] == quark)
+			return meta->chunk_values[i].is_valid ? &meta->chunk_values[i] : NULL;
+
+	return NULL;
+}
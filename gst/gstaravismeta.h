@@ -0,0 +1,73 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef GST_ARAVIS_META_H
+#define GST_ARAVIS_META_H
+
+#include <gst/gst.h>
+#include <arv.h>
+
+G_BEGIN_DECLS
+
+#define GST_ARAVIS_META_MAX_CHUNKS	16
+
+#define GST_ARAVIS_META_API_TYPE	(gst_aravis_meta_api_get_type ())
+#define GST_ARAVIS_META_INFO		(gst_aravis_meta_get_info ())
+
+/**
+ * GstAravisMeta:
+ * @meta: parent #GstMeta
+ * @metadata: per-frame metadata block of the #ArvBuffer, with the frame id, the device timestamp and the packet
+ * resend counters
+ * @n_chunks: number of chunk values
+ * @chunk_names: chunk feature names, as quarks
+ * @chunk_values: chunk values, in the order of @chunk_names
+ *
+ * Metadata attached by aravissrc to its output buffers. The structure is registered as "GstAravisMeta", and can be
+ * retrieved by the downstream elements using gst_buffer_get_meta() with the API type registered as
+ * "GstAravisMetaAPI", without linking to the plugin.
+ */
+
+typedef struct {
+	GstMeta meta;
+
+	ArvBufferMetadata metadata;
+
+	guint n_chunks;
+	GQuark chunk_names[GST_ARAVIS_META_MAX_CHUNKS];
+	ArvChunkValue chunk_values[GST_ARAVIS_META_MAX_CHUNKS];
+} GstAravisMeta;
+
+GType			gst_aravis_meta_api_get_type	(void);
+const GstMetaInfo *	gst_aravis_meta_get_info	(void);
+
+#define gst_buffer_get_aravis_meta(b)	((GstAravisMeta *) gst_buffer_get_meta ((b), GST_ARAVIS_META_API_TYPE))
+
+GstAravisMeta *		gst_buffer_add_aravis_meta	(GstBuffer *buffer, ArvBuffer *arv_buffer,
+							 ArvChunkParser *parser, const gint *accessors,
+							 const GQuark *chunk_names, guint n_chunks);
+const ArvChunkValue *	gst_aravis_meta_get_chunk_value	(GstAravisMeta *meta, const char *chunk);
+
+G_END_DECLS
+
+#endif
@@ -1,18 +1,867 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * In-kernel GVSP reception, see aravis-module.h for the user space interface.
+ *
+ * The packets are filtered in the IPv4 pre-routing hook of the initial network namespace. A stream only matches the
+ * packets sent by its device to the address and port of the socket it is bound to, which the caller owns, and the
+ * packets with an invalid UDP checksum are left to the network stack. The hook runs in softirq
+ * context, possibly on several CPUs at the same time, and each stream state is protected by a spinlock. The buffers
+ * are pinned and mapped in kernel space at queue time, and unmapped in process context, during the next ioctl, after
+ * their completion.
+ */
+
+#include <linux/version.h>
 #include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/miscdevice.h>
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/mutex.h>
+#include <linux/rculist.h>
+#include <linux/poll.h>
+#include <linux/wait.h>
+#include <linux/skbuff.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter_ipv4.h>
+#include <linux/ktime.h>
+#include <linux/bitmap.h>
+#include <linux/uaccess.h>
+#include <linux/net.h>
+#include <net/ip.h>
+#include <net/sock.h>
+#include <net/inet_sock.h>
+#include <net/net_namespace.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 12, 0)
+#include <linux/unaligned.h>
+#else
+#include <asm/unaligned.h>
+#endif
+
+#include "aravis-module.h"
+
+MODULE_LICENSE ("GPL");
+MODULE_AUTHOR ("Emmanuel Pacaud <emmanuel.pacaud@free.fr>");
+MODULE_DESCRIPTION ("Aravis in-kernel GigE Vision stream reception");
+
+/* Frames being received at the same time */
+#define ARV_GVSP_MAX_FRAMES		8
+
+#define ARV_GVSP_HEADER_SIZE		8
+#define ARV_GVSP_EXTENDED_HEADER_SIZE	20
+#define ARV_GVSP_IP_UDP_HEADER_SIZE	(20 + 8)
+
+#define ARV_GVSP_CONTENT_TYPE_LEADER	0x01
+#define ARV_GVSP_CONTENT_TYPE_TRAILER	0x02
+#define ARV_GVSP_CONTENT_TYPE_BLOCK	0x03
+
+struct arv_gvsp_buffer {
+	struct list_head link;
+	u64 cookie;
+
+	struct page **pages;
+	unsigned int n_pages;
+	void *vaddr;
+	u8 *data;
+	size_t size;
+
+	/* Frame reception state, when in the frame list */
+	unsigned long *received;
+	unsigned int n_bits;
+	u64 frame_id;
+	bool extended_ids;
+	u32 n_packets;			/* 0 until the trailer is received */
+	u32 n_received;
+	u32 last_packet;
+	u64 received_size;
+	u64 first_packet_time_ns;
+	u64 last_packet_time_ns;
+	u64 last_request_time_ns;
+	enum arv_gvsp_status status;
+	u32 leader_size;
+	u8 leader[ARV_GVSP_LEADER_MAX_SIZE];
+};
+
+struct arv_gvsp_stream {
+	struct list_head link;
+	spinlock_t lock;
+	struct mutex ioctl_mutex;
+	wait_queue_head_t wait;
+
+	bool configured;
+	struct arv_gvsp_config config;
+	struct socket *socket;
+	__be32 destination_address;
+	u16 destination_port;
+	u32 block_size;
+	u32 extended_block_size;
+
+	/* Buffers owned by the module: queued and unused, being filled in arrival order, and completed */
+	struct list_head free_buffers;
+	struct list_head frames;
+	struct list_head done_buffers;
+	unsigned int n_owned;
+	unsigned int n_frames;
+
+	bool has_last_frame_id;
+	u64 last_frame_id;
+	u64 underrun_frame_id;
+
+	struct arv_gvsp_ring *ring;
+	size_t ring_size;
+};
+
+static LIST_HEAD (arv_gvsp_streams);
+static DEFINE_MUTEX (arv_gvsp_streams_mutex);
+
+static void
+arv_gvsp_buffer_free (struct arv_gvsp_buffer *buffer)
+{
+	if (buffer->vaddr != NULL)
+		vunmap (buffer->vaddr);
+	if (buffer->pages != NULL) {
+		unpin_user_pages_dirty_lock (buffer->pages, buffer->n_pages, true);
+		kvfree (buffer->pages);
+	}
+	bitmap_free (buffer->received);
+	kfree (buffer);
+}
+
+/* Called with the stream lock held */
+
+static void
+arv_gvsp_complete (struct arv_gvsp_stream *stream, struct arv_gvsp_buffer *buffer, enum arv_gvsp_status status)
+{
+	struct arv_gvsp_ring *ring = stream->ring;
+	struct arv_gvsp_completion *completion;
+	u32 head = ring->head;
+	u32 n_expected;
+
+	list_move_tail (&buffer->link, &stream->done_buffers);
+	stream->n_owned--;
+
+	/* The queue limit guarantees a free entry, unless user space corrupted the tail */
+	if (head - READ_ONCE (ring->tail) >= ARV_GVSP_RING_SIZE)
+		return;
+
+	n_expected = buffer->n_packets > 0 ? buffer->n_packets : (buffer->n_received > 0 ? buffer->last_packet + 1 : 0);
+
+	completion = &ring->completions[head & ARV_GVSP_RING_MASK];
+	completion->cookie = buffer->cookie;
+	completion->frame_id = buffer->frame_id;
+	completion->first_packet_time_ns = buffer->first_packet_time_ns;
+	completion->last_packet_time_ns = buffer->last_packet_time_ns;
+	completion->received_size = buffer->received_size;
+	completion->status = status;
+	completion->n_packets = n_expected;
+	completion->n_missing_packets = n_expected > buffer->n_received ? n_expected - buffer->n_received : 0;
+	completion->leader_size = buffer->leader_size;
+	memcpy (completion->leader, buffer->leader, buffer->leader_size);
+
+	smp_store_release (&ring->head, head + 1);
+
+	wake_up_interruptible (&stream->wait);
+}
+
+static void
+arv_gvsp_complete_frame (struct arv_gvsp_stream *stream, struct arv_gvsp_buffer *buffer,
+			 enum arv_gvsp_status status)
+{
+	stream->n_frames--;
+	arv_gvsp_complete (stream, buffer, status);
+}
+
+static bool
+arv_gvsp_is_late_frame (struct arv_gvsp_stream *stream, u64 frame_id, bool extended_ids)
+{
+	if (!stream->has_last_frame_id)
+		return false;
+
+	if (extended_ids)
+		return frame_id <= stream->last_frame_id;
+
+	return (s16) ((u16) frame_id - (u16) stream->last_frame_id) <= 0;
+}
+
+/* Returns the buffer receiving frame_id, or NULL if the packet must be ignored. Called with the stream lock held. */
+
+static struct arv_gvsp_buffer *
+arv_gvsp_find_frame (struct arv_gvsp_stream *stream, u64 frame_id, bool extended_ids, u64 time_ns)
+{
+	struct arv_gvsp_buffer *buffer;
+
+	list_for_each_entry (buffer, &stream->frames, link)
+		if (buffer->frame_id == frame_id)
+			return buffer;
+
+	if (arv_gvsp_is_late_frame (stream, frame_id, extended_ids))
+		return NULL;
+
+	if (list_empty (&stream->free_buffers)) {
+		if (stream->underrun_frame_id != frame_id) {
+			stream->ring->statistics.n_underruns++;
+			stream->underrun_frame_id = frame_id;
+		}
+		return NULL;
+	}
+
+	if (stream->n_frames >= ARV_GVSP_MAX_FRAMES)
+		arv_gvsp_complete_frame (stream, list_first_entry (&stream->frames, struct arv_gvsp_buffer, link),
+					 ARV_GVSP_STATUS_MISSING_PACKETS);
+
+	buffer = list_first_entry (&stream->free_buffers, struct arv_gvsp_buffer, link);
+	list_move_tail (&buffer->link, &stream->frames);
+	stream->n_frames++;
+
+	bitmap_zero (buffer->received, buffer->n_bits);
+	buffer->frame_id = frame_id;
+	buffer->extended_ids = extended_ids;
+	buffer->n_packets = 0;
+	buffer->n_received = 0;
+	buffer->last_packet = 0;
+	buffer->received_size = 0;
+	buffer->first_packet_time_ns = time_ns;
+	buffer->last_request_time_ns = time_ns;
+	buffer->status = ARV_GVSP_STATUS_SUCCESS;
+	buffer->leader_size = 0;
+
+	stream->has_last_frame_id = true;
+	stream->last_frame_id = frame_id;
+
+	return buffer;
+}
+
+static void
+arv_gvsp_process_packet (struct arv_gvsp_stream *stream, struct sk_buff *skb, unsigned int offset, unsigned int size)
+{
+	struct arv_gvsp_statistics *statistics = &stream->ring->statistics;
+	struct arv_gvsp_buffer *buffer;
+	u8 header[ARV_GVSP_EXTENDED_HEADER_SIZE];
+	unsigned int header_size;
+	unsigned int data_size;
+	u64 time_ns = ktime_get_ns ();
+	u64 frame_id;
+	u32 packet_id;
+	u16 packet_type;
+	bool extended_ids;
+	int content_type;
+
+	if (size < ARV_GVSP_HEADER_SIZE ||
+	    skb_copy_bits (skb, offset, header, min_t (unsigned int, size, sizeof (header))) < 0) {
+		spin_lock (&stream->lock);
+		statistics->n_error_packets++;
+		spin_unlock (&stream->lock);
+		return;
+	}
+
+	packet_type = get_unaligned_be16 (header);
+	extended_ids = (header[4] & 0x80) != 0;
+	content_type = header[4] & 0x7f;
+
+	if (extended_ids) {
+		header_size = ARV_GVSP_EXTENDED_HEADER_SIZE;
+		frame_id = get_unaligned_be64 (header + 8);
+		packet_id = get_unaligned_be32 (header + 16);
+	} else {
+		header_size = ARV_GVSP_HEADER_SIZE;
+		frame_id = get_unaligned_be16 (header + 2);
+		packet_id = get_unaligned_be32 (header + 4) & 0x00ffffff;
+	}
+
+	spin_lock (&stream->lock);
+
+	statistics->n_received_packets++;
+	statistics->n_transferred_bytes += size;
+
+	/* Error packets, like the answers to invalid resend requests, have the status high bit set */
+	if ((packet_type & 0x8000) != 0 || size < header_size) {
+		statistics->n_error_packets++;
+		goto out;
+	}
+
+	buffer = arv_gvsp_find_frame (stream, frame_id, extended_ids, time_ns);
+	if (buffer == NULL) {
+		statistics->n_ignored_packets++;
+		goto out;
+	}
+
+	if (packet_id >= buffer->n_bits) {
+		buffer->status = ARV_GVSP_STATUS_WRONG_PACKET_ID;
+		statistics->n_error_packets++;
+		goto out;
+	}
+
+	if (test_bit (packet_id, buffer->received)) {
+		statistics->n_duplicated_packets++;
+		goto out;
+	}
+
+	data_size = size - header_size;
+
+	switch (content_type) {
+		case ARV_GVSP_CONTENT_TYPE_LEADER:
+			if (packet_id != 0) {
+				buffer->status = ARV_GVSP_STATUS_WRONG_PACKET_ID;
+				break;
+			}
+			buffer->leader_size = min_t (unsigned int, size, ARV_GVSP_LEADER_MAX_SIZE);
+			if (skb_copy_bits (skb, offset, buffer->leader, buffer->leader_size) < 0)
+				buffer->leader_size = 0;
+			break;
+		case ARV_GVSP_CONTENT_TYPE_TRAILER:
+			buffer->n_packets = packet_id + 1;
+			break;
+		case ARV_GVSP_CONTENT_TYPE_BLOCK:
+			{
+				u32 block_size = extended_ids ? stream->extended_block_size : stream->block_size;
+				u64 block_offset = (u64) (packet_id - 1) * block_size;
+
+				if (packet_id == 0) {
+					buffer->status = ARV_GVSP_STATUS_WRONG_PACKET_ID;
+					break;
+				}
+
+				if (data_size > block_size || block_offset + data_size > buffer->size) {
+					buffer->status = ARV_GVSP_STATUS_SIZE_MISMATCH;
+					break;
+				}
+
+				if (skb_copy_bits (skb, offset + header_size, buffer->data + block_offset, data_size) < 0) {
+					statistics->n_error_packets++;
+					goto out;
+				}
+
+				if (block_offset + data_size > buffer->received_size)
+					buffer->received_size = block_offset + data_size;
+			}
+			break;
+		default:
+			statistics->n_ignored_packets++;
+			goto out;
+	}
+
+	__set_bit (packet_id, buffer->received);
+	buffer->n_received++;
+	if (packet_id > buffer->last_packet)
+		buffer->last_packet = packet_id;
+	buffer->last_packet_time_ns = time_ns;
+
+	if (buffer->status != ARV_GVSP_STATUS_SUCCESS)
+		arv_gvsp_complete_frame (stream, buffer, buffer->status);
+	else if (buffer->n_packets > 0 && buffer->n_received >= buffer->n_packets)
+		arv_gvsp_complete_frame (stream, buffer,
+					 buffer->last_packet < buffer->n_packets ?
+					 ARV_GVSP_STATUS_SUCCESS : ARV_GVSP_STATUS_WRONG_PACKET_ID);
+
+out:
+	spin_unlock (&stream->lock);
+}
+
+static unsigned int
+arv_gvsp_hook (void *priv, struct sk_buff *skb, const struct nf_hook_state *state)
+{
+	struct arv_gvsp_stream *stream;
+	const struct iphdr *iph;
+	const struct udphdr *udph;
+	unsigned int ip_header_size;
+	unsigned int udp_size;
+	u16 destination_port;
+
+	if (!pskb_may_pull (skb, sizeof (struct iphdr)))
+		return NF_ACCEPT;
+
+	iph = ip_hdr (skb);
+	if (iph->protocol != IPPROTO_UDP || ip_is_fragment (iph))
+		return NF_ACCEPT;
+
+	ip_header_size = iph->ihl * 4;
+	if (!pskb_may_pull (skb, ip_header_size + sizeof (struct udphdr)))
+		return NF_ACCEPT;
 
-MODULE_LICENSE("GPL");
-MODULE_AUTHOR("Emmanuel Pacaud <emmanuel.pacaud@free.fr>");
+	iph = ip_hdr (skb);
+	udph = (const struct udphdr *) (skb_network_header (skb) + ip_header_size);
+	destination_port = ntohs (udph->dest);
+	udp_size = ntohs (udph->len);
+	if (udp_size < sizeof (struct udphdr) || ip_header_size + udp_size > skb->len)
+		return NF_ACCEPT;
 
-int
-init_module(void)
+	rcu_read_lock ();
+	list_for_each_entry_rcu (stream, &arv_gvsp_streams, link) {
+		if (stream->destination_port != destination_port ||
+		    stream->destination_address != iph->daddr ||
+		    stream->config.source_address != iph->saddr ||
+		    (stream->config.source_port != 0 && stream->config.source_port != ntohs (udph->source)))
+			continue;
+
+		/* A zero checksum means that the sender did not compute it */
+		if (udph->check != 0 && nf_ip_checksum (skb, state->hook, ip_header_size, IPPROTO_UDP) != 0)
+			break;
+
+		arv_gvsp_process_packet (stream, skb, skb_network_offset (skb) + ip_header_size + sizeof (struct udphdr),
+					 udp_size - sizeof (struct udphdr));
+		rcu_read_unlock ();
+
+		consume_skb (skb);
+		return NF_STOLEN;
+	}
+	rcu_read_unlock ();
+
+	return NF_ACCEPT;
+}
+
+static const struct nf_hook_ops arv_gvsp_hook_ops = {
+	.hook = arv_gvsp_hook,
+	.pf = NFPROTO_IPV4,
+	.hooknum = NF_INET_PRE_ROUTING,
+	.priority = NF_IP_PRI_FIRST,
+};
+
+/* Unpins the completed buffers, in process context */
+
+static void
+arv_gvsp_release_done_buffers (struct arv_gvsp_stream *stream)
 {
-	printk (KERN_ALERT "aravis: loaded\n");
+	struct arv_gvsp_buffer *buffer, *next;
+	LIST_HEAD (done_buffers);
+
+	spin_lock_bh (&stream->lock);
+	list_splice_init (&stream->done_buffers, &done_buffers);
+	spin_unlock_bh (&stream->lock);
+
+	list_for_each_entry_safe (buffer, next, &done_buffers, link) {
+		list_del (&buffer->link);
+		arv_gvsp_buffer_free (buffer);
+	}
+}
+
+/* The stream is bound to an IPv4 UDP socket of the caller, which must be bound to a specific address and port */
+
+static struct socket *
+arv_gvsp_lookup_socket (int fd, __be32 *address, u16 *port)
+{
+	struct socket *socket;
+	struct sock *sk;
+	int error = 0;
+
+	socket = sockfd_lookup (fd, &error);
+	if (socket == NULL)
+		return ERR_PTR (error);
+
+	sk = socket->sk;
+	if (sk == NULL || sk->sk_family != AF_INET || sk->sk_type != SOCK_DGRAM || sk->sk_protocol != IPPROTO_UDP ||
+	    !net_eq (sock_net (sk), &init_net)) {
+		sockfd_put (socket);
+		return ERR_PTR (-EINVAL);
+	}
+
+	lock_sock (sk);
+	*address = inet_sk (sk)->inet_rcv_saddr;
+	*port = inet_sk (sk)->inet_num;
+	release_sock (sk);
+
+	if (*address == 0 || *port == 0) {
+		sockfd_put (socket);
+		return ERR_PTR (-EDESTADDRREQ);
+	}
+
+	return socket;
+}
+
+static long
+arv_gvsp_configure (struct arv_gvsp_stream *stream, void __user *argp)
+{
+	struct arv_gvsp_stream *other;
+	struct arv_gvsp_config config;
+	struct socket *socket;
+	__be32 destination_address;
+	u16 destination_port;
+	long result = 0;
+
+	if (copy_from_user (&config, argp, sizeof (config)))
+		return -EFAULT;
+
+	if (config.version != ARV_GVSP_MODULE_VERSION)
+		return -EPROTO;
+
+	if (config.source_address == 0 ||
+	    config.packet_size <= ARV_GVSP_IP_UDP_HEADER_SIZE + ARV_GVSP_EXTENDED_HEADER_SIZE)
+		return -EINVAL;
+
+	if (stream->configured)
+		return -EBUSY;
+
+	socket = arv_gvsp_lookup_socket (config.socket_fd, &destination_address, &destination_port);
+	if (IS_ERR (socket))
+		return PTR_ERR (socket);
+
+	mutex_lock (&arv_gvsp_streams_mutex);
+
+	list_for_each_entry (other, &arv_gvsp_streams, link) {
+		if (other->destination_port == destination_port &&
+		    other->destination_address == destination_address) {
+			result = -EADDRINUSE;
+			goto out;
+		}
+	}
+
+	stream->config = config;
+	stream->socket = socket;
+	stream->destination_address = destination_address;
+	stream->destination_port = destination_port;
+	stream->block_size = config.packet_size - ARV_GVSP_IP_UDP_HEADER_SIZE - ARV_GVSP_HEADER_SIZE;
+	stream->extended_block_size = config.packet_size - ARV_GVSP_IP_UDP_HEADER_SIZE - ARV_GVSP_EXTENDED_HEADER_SIZE;
+	stream->configured = true;
+
+	list_add_tail_rcu (&stream->link, &arv_gvsp_streams);
+
+out:
+	mutex_unlock (&arv_gvsp_streams_mutex);
+
+	if (result < 0)
+		sockfd_put (socket);
+
+	return result;
+}
+
+static long
+arv_gvsp_queue_buffer (struct arv_gvsp_stream *stream, void __user *argp)
+{
+	struct arv_gvsp_queue_buffer request;
+	struct arv_gvsp_buffer *buffer;
+	unsigned long first_page;
+	unsigned int n_queued;
+	int n_pinned;
+
+	if (copy_from_user (&request, argp, sizeof (request)))
+		return -EFAULT;
+
+	if (!stream->configured)
+		return -EINVAL;
+
+	if (request.size == 0 || request.size > INT_MAX || request.address + request.size < request.address)
+		return -EINVAL;
+
+	arv_gvsp_release_done_buffers (stream);
+
+	spin_lock_bh (&stream->lock);
+	n_queued = stream->n_owned + (stream->ring->head - READ_ONCE (stream->ring->tail));
+	spin_unlock_bh (&stream->lock);
+
+	if (n_queued >= ARV_GVSP_RING_SIZE)
+		return -ENOSPC;
+
+	buffer = kzalloc (sizeof (*buffer), GFP_KERNEL);
+	if (buffer == NULL)
+		return -ENOMEM;
+
+	first_page = request.address & PAGE_MASK;
+	buffer->cookie = request.cookie;
+	buffer->size = request.size;
+	buffer->n_pages = DIV_ROUND_UP (request.address + request.size - first_page, PAGE_SIZE);
+	buffer->n_bits = request.size / stream->extended_block_size + 2;
+
+	buffer->received = bitmap_zalloc (buffer->n_bits, GFP_KERNEL);
+	buffer->pages = kvmalloc_array (buffer->n_pages, sizeof (struct page *), GFP_KERNEL);
+	if (buffer->received == NULL || buffer->pages == NULL) {
+		kvfree (buffer->pages);
+		buffer->pages = NULL;
+		arv_gvsp_buffer_free (buffer);
+		return -ENOMEM;
+	}
+
+	n_pinned = pin_user_pages_fast (first_page, buffer->n_pages, FOLL_WRITE | FOLL_LONGTERM, buffer->pages);
+	if (n_pinned != buffer->n_pages) {
+		if (n_pinned > 0)
+			unpin_user_pages (buffer->pages, n_pinned);
+		kvfree (buffer->pages);
+		buffer->pages = NULL;
+		arv_gvsp_buffer_free (buffer);
+		return n_pinned < 0 ? n_pinned : -EFAULT;
+	}
+
+	buffer->vaddr = vmap (buffer->pages, buffer->n_pages, VM_MAP, PAGE_KERNEL);
+	if (buffer->vaddr == NULL) {
+		arv_gvsp_buffer_free (buffer);
+		return -ENOMEM;
+	}
+	buffer->data = (u8 *) buffer->vaddr + offset_in_page (request.address);
+
+	spin_lock_bh (&stream->lock);
+	list_add_tail (&buffer->link, &stream->free_buffers);
+	stream->n_owned++;
+	spin_unlock_bh (&stream->lock);
 
 	return 0;
 }
 
-void
-cleanup_module(void)
+static void
+arv_gvsp_add_missing_ranges (struct arv_gvsp_buffer *buffer, struct arv_gvsp_check *check)
+{
+	unsigned int end = buffer->n_packets > 0 ? buffer->n_packets : buffer->last_packet + 1;
+	unsigned int first = 0;
+
+	while (check->n_ranges < ARV_GVSP_MAX_MISSING_RANGES) {
+		unsigned int last;
+
+		first = find_next_zero_bit (buffer->received, end, first);
+		if (first >= end)
+			break;
+
+		last = find_next_bit (buffer->received, end, first);
+
+		check->ranges[check->n_ranges].frame_id = buffer->frame_id;
+		check->ranges[check->n_ranges].first_packet = first;
+		check->ranges[check->n_ranges].last_packet = last - 1;
+		check->ranges[check->n_ranges].extended_ids = buffer->extended_ids;
+		check->n_ranges++;
+
+		first = last;
+	}
+}
+
+static long
+arv_gvsp_check (struct arv_gvsp_stream *stream, void __user *argp)
 {
-	printk (KERN_ALERT "aravis: unloaded\n");
+	struct arv_gvsp_buffer *buffer, *next;
+	struct arv_gvsp_check *check;
+	u64 time_ns = ktime_get_ns ();
+	long result = 0;
+
+	check = kzalloc (sizeof (*check), GFP_KERNEL);
+	if (check == NULL)
+		return -ENOMEM;
+
+	if (copy_from_user (check, argp, offsetof (struct arv_gvsp_check, ranges))) {
+		kfree (check);
+		return -EFAULT;
+	}
+
+	check->n_ranges = 0;
+
+	spin_lock_bh (&stream->lock);
+	list_for_each_entry_safe (buffer, next, &stream->frames, link) {
+		if (time_ns - buffer->first_packet_time_ns > (u64) check->frame_retention_us * NSEC_PER_USEC) {
+			arv_gvsp_complete_frame (stream, buffer, ARV_GVSP_STATUS_MISSING_PACKETS);
+		} else if (time_ns - buffer->last_packet_time_ns > (u64) check->packet_timeout_us * NSEC_PER_USEC &&
+			   time_ns - buffer->last_request_time_ns > (u64) check->packet_timeout_us * NSEC_PER_USEC) {
+			arv_gvsp_add_missing_ranges (buffer, check);
+			buffer->last_request_time_ns = time_ns;
+		}
+	}
+	spin_unlock_bh (&stream->lock);
+
+	arv_gvsp_release_done_buffers (stream);
+
+	if (copy_to_user (argp, check, sizeof (*check)))
+		result = -EFAULT;
+
+	kfree (check);
+
+	return result;
+}
+
+static long
+arv_gvsp_flush (struct arv_gvsp_stream *stream)
+{
+	struct arv_gvsp_buffer *buffer, *next;
+
+	spin_lock_bh (&stream->lock);
+	list_for_each_entry_safe (buffer, next, &stream->frames, link)
+		arv_gvsp_complete_frame (stream, buffer, ARV_GVSP_STATUS_ABORTED);
+	list_for_each_entry_safe (buffer, next, &stream->free_buffers, link) {
+		buffer->frame_id = 0;
+		buffer->n_packets = 0;
+		buffer->n_received = 0;
+		buffer->received_size = 0;
+		buffer->leader_size = 0;
+		buffer->first_packet_time_ns = 0;
+		buffer->last_packet_time_ns = 0;
+		arv_gvsp_complete (stream, buffer, ARV_GVSP_STATUS_ABORTED);
+	}
+	stream->has_last_frame_id = false;
+	spin_unlock_bh (&stream->lock);
+
+	arv_gvsp_release_done_buffers (stream);
+
+	return 0;
 }
+
+static long
+arv_gvsp_ioctl (struct file *file, unsigned int command, unsigned long argument)
+{
+	struct arv_gvsp_stream *stream = file->private_data;
+	void __user *argp = (void __user *) argument;
+	long result;
+
+	mutex_lock (&stream->ioctl_mutex);
+
+	switch (command) {
+		case ARV_GVSP_IOC_CONFIGURE:
+			result = arv_gvsp_configure (stream, argp);
+			break;
+		case ARV_GVSP_IOC_QUEUE_BUFFER:
+			result = arv_gvsp_queue_buffer (stream, argp);
+			break;
+		case ARV_GVSP_IOC_CHECK:
+			result = arv_gvsp_check (stream, argp);
+			break;
+		case ARV_GVSP_IOC_FLUSH:
+			result = arv_gvsp_flush (stream);
+			break;
+		default:
+			result = -ENOTTY;
+			break;
+	}
+
+	mutex_unlock (&stream->ioctl_mutex);
+
+	return result;
+}
+
+static __poll_t
+arv_gvsp_poll (struct file *file, struct poll_table_struct *wait)
+{
+	struct arv_gvsp_stream *stream = file->private_data;
+
+	poll_wait (file, &stream->wait, wait);
+
+	if (smp_load_acquire (&stream->ring->head) != READ_ONCE (stream->ring->tail))
+		return EPOLLIN | EPOLLRDNORM;
+
+	return 0;
+}
+
+static int
+arv_gvsp_mmap (struct file *file, struct vm_area_struct *vma)
+{
+	struct arv_gvsp_stream *stream = file->private_data;
+
+	if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start > stream->ring_size)
+		return -EINVAL;
+
+	return remap_vmalloc_range (vma, stream->ring, 0);
+}
+
+static int
+arv_gvsp_open (struct inode *inode, struct file *file)
+{
+	struct arv_gvsp_stream *stream;
+
+	stream = kzalloc (sizeof (*stream), GFP_KERNEL);
+	if (stream == NULL)
+		return -ENOMEM;
+
+	stream->ring_size = PAGE_ALIGN (sizeof (struct arv_gvsp_ring));
+	stream->ring = vmalloc_user (stream->ring_size);
+	if (stream->ring == NULL) {
+		kfree (stream);
+		return -ENOMEM;
+	}
+
+	spin_lock_init (&stream->lock);
+	mutex_init (&stream->ioctl_mutex);
+	init_waitqueue_head (&stream->wait);
+	INIT_LIST_HEAD (&stream->link);
+	INIT_LIST_HEAD (&stream->free_buffers);
+	INIT_LIST_HEAD (&stream->frames);
+	INIT_LIST_HEAD (&stream->done_buffers);
+
+	file->private_data = stream;
+
+	return nonseekable_open (inode, file);
+}
+
+static int
+arv_gvsp_release (struct inode *inode, struct file *file)
+{
+	struct arv_gvsp_stream *stream = file->private_data;
+	struct arv_gvsp_buffer *buffer, *next;
+
+	if (stream->configured) {
+		mutex_lock (&arv_gvsp_streams_mutex);
+		list_del_rcu (&stream->link);
+		mutex_unlock (&arv_gvsp_streams_mutex);
+
+		/* Waits for the hooks still processing packets of this stream */
+		synchronize_net ();
+
+		sockfd_put (stream->socket);
+	}
+
+	list_splice_init (&stream->frames, &stream->done_buffers);
+	list_splice_init (&stream->free_buffers, &stream->done_buffers);
+	list_for_each_entry_safe (buffer, next, &stream->done_buffers, link) {
+		list_del (&buffer->link);
+		arv_gvsp_buffer_free (buffer);
+	}
+
+	vfree (stream->ring);
+	kfree (stream);
+
+	return 0;
+}
+
+static const struct file_operations arv_gvsp_fops = {
+	.owner = THIS_MODULE,
+	.open = arv_gvsp_open,
+	.release = arv_gvsp_release,
+	.unlocked_ioctl = arv_gvsp_ioctl,
+	.compat_ioctl = compat_ptr_ioctl,
+	.poll = arv_gvsp_poll,
+	.mmap = arv_gvsp_mmap,
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 12, 0)
+	.llseek = no_llseek,
+#endif
+};
+
+static struct miscdevice arv_gvsp_device = {
+	.minor = MISC_DYNAMIC_MINOR,
+	.name = ARV_GVSP_MODULE_DEVICE_NAME,
+	.fops = &arv_gvsp_fops,
+	.mode = 0660,
+};
+
+static int __init
+arv_gvsp_init (void)
+{
+	int result;
+
+	result = misc_register (&arv_gvsp_device);
+	if (result < 0)
+		return result;
+
+	result = nf_register_net_hook (&init_net, &arv_gvsp_hook_ops);
+	if (result < 0) {
+		misc_deregister (&arv_gvsp_device);
+		return result;
+	}
+
+	pr_info ("aravis: GVSP reception module loaded\n");
+
+	return 0;
+}
+
+static void __exit
+arv_gvsp_exit (void)
+{
+	nf_unregister_net_hook (&init_net, &arv_gvsp_hook_ops);
+	misc_deregister (&arv_gvsp_device);
+
+	pr_info ("aravis: GVSP reception module unloaded\n");
+}
+
+module_init (arv_gvsp_init);
+module_exit (arv_gvsp_exit);
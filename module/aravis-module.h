@@ -0,0 +1,124 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This header is shared by the aravis kernel module and the user space library. It is dual licensed under the GNU
+ * General Public License version 2 and the GNU Lesser General Public License version 2 or later.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARAVIS_MODULE_H
+#define ARAVIS_MODULE_H
+
+/*
+ * In-kernel GVSP reception.
+ *
+ * Each open file of /dev/aravis-gvsp is a stream. It is configured with a UDP socket of the caller, bound to the
+ * stream address and port, and with the device address. The module then steals, in the IPv4 pre-routing hook, the
+ * packets of the device that this socket would have received, once their UDP checksum is verified, and copies the
+ * data blocks straight to their place in the user buffers queued with ARV_GVSP_IOC_QUEUE_BUFFER. The user buffers
+ * are pinned while they are owned by the module, and the socket is kept open while the stream is configured.
+ *
+ * The device node is only accessible to root, no udev rule is installed for it.
+ *
+ * Completed frames are posted in a ring shared with user space, mapped at offset 0 of the file, and poll() reports
+ * POLLIN when the ring is not empty. Missing packets are tracked by the module, ARV_GVSP_IOC_CHECK returns the
+ * missing packet ranges to be requested to the device, and completes the frames older than the frame retention.
+ */
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define ARV_GVSP_MODULE_DEVICE_NAME	"aravis-gvsp"
+#define ARV_GVSP_MODULE_VERSION		2
+
+/* Number of completion entries, and maximum number of queued buffers */
+#define ARV_GVSP_RING_SIZE		64
+#define ARV_GVSP_RING_MASK		(ARV_GVSP_RING_SIZE - 1)
+
+/* Maximum size of the leader packet copied in the completions, from the GVSP packet status field */
+#define ARV_GVSP_LEADER_MAX_SIZE	1024
+
+#define ARV_GVSP_MAX_MISSING_RANGES	32
+
+enum arv_gvsp_status {
+	ARV_GVSP_STATUS_SUCCESS = 0,
+	ARV_GVSP_STATUS_MISSING_PACKETS,
+	ARV_GVSP_STATUS_SIZE_MISMATCH,
+	ARV_GVSP_STATUS_WRONG_PACKET_ID,
+	ARV_GVSP_STATUS_ABORTED
+};
+
+struct arv_gvsp_config {
+	__u32 version;			/* ARV_GVSP_MODULE_VERSION */
+	__u32 source_address;		/* Device IPv4 address, network order */
+	__u16 source_port;		/* Device UDP port, host order, 0 for any */
+	__u16 reserved;
+	__s32 socket_fd;		/* UDP socket bound to the stream address and port */
+	__u32 packet_size;		/* GevSCPSPacketSize, including the IP and UDP headers */
+};
+
+struct arv_gvsp_queue_buffer {
+	__u64 address;
+	__u64 size;
+	__u64 cookie;			/* Returned in the completion */
+};
+
+struct arv_gvsp_completion {
+	__u64 cookie;
+	__u64 frame_id;
+	__u64 first_packet_time_ns;	/* CLOCK_MONOTONIC */
+	__u64 last_packet_time_ns;
+	__u64 received_size;
+	__u32 status;			/* enum arv_gvsp_status */
+	__u32 n_packets;
+	__u32 n_missing_packets;
+	__u32 leader_size;
+	__u8 leader[ARV_GVSP_LEADER_MAX_SIZE];
+};
+
+struct arv_gvsp_statistics {
+	__u64 n_received_packets;
+	__u64 n_ignored_packets;
+	__u64 n_error_packets;
+	__u64 n_duplicated_packets;
+	__u64 n_underruns;
+	__u64 n_transferred_bytes;
+};
+
+/* Shared ring, written by the module at head, read by user space at tail */
+
+struct arv_gvsp_ring {
+	__u32 head;
+	__u32 tail;
+	__u32 reserved[14];
+	struct arv_gvsp_statistics statistics;
+	struct arv_gvsp_completion completions[ARV_GVSP_RING_SIZE];
+};
+
+struct arv_gvsp_missing_range {
+	__u64 frame_id;
+	__u32 first_packet;
+	__u32 last_packet;
+	__u32 extended_ids;
+	__u32 reserved;
+};
+
+struct arv_gvsp_check {
+	__u32 packet_timeout_us;	/* Missing packets are reported after this delay without progress */
+	__u32 frame_retention_us;	/* Frames older than this are completed */
+	__u32 n_ranges;			/* Out */
+	__u32 reserved;
+	struct arv_gvsp_missing_range ranges[ARV_GVSP_MAX_MISSING_RANGES];
+};
+
+#define ARV_GVSP_IOC_MAGIC		'v'
+
+#define ARV_GVSP_IOC_CONFIGURE		_IOW (ARV_GVSP_IOC_MAGIC, 1, struct arv_gvsp_config)
+#define ARV_GVSP_IOC_QUEUE_BUFFER	_IOW (ARV_GVSP_IOC_MAGIC, 2, struct arv_gvsp_queue_buffer)
+#define ARV_GVSP_IOC_CHECK		_IOWR (ARV_GVSP_IOC_MAGIC, 3, struct arv_gvsp_check)
+/* Completes all the frames as aborted, and gives back the unused buffers as aborted */
+#define ARV_GVSP_IOC_FLUSH		_IO (ARV_GVSP_IOC_MAGIC, 4)
+
+#endif
@@ -27,7 +27,9 @@
 
 #include <arvtypes.h>
 
+#include <arvbandwidthplanner.h>
 #include <arvbuffer.h>
+#include <arvbufferpool.h>
 #include <arvcamera.h>
 #include <arvchunkparser.h>
 #include <arvdebug.h>
@@ -91,6 +93,7 @@
 #include <arvgcswissknife.h>
 #include <arvgcswissknifenode.h>
 #include <arvgcvalueindexednode.h>
+#include <arvgenicamcache.h>
 
 #include <arvgvdevice.h>
 #include <arvgvfakecamera.h>
@@ -100,7 +103,15 @@
 #include <arvinterface.h>
 #include <arvmisc.h>
 #include <arvrealtime.h>
+#include <arvopenmetrics.h>
+#include <arvrecorder.h>
+#include <arvrecording.h>
+#include <arvpixelcorrection.h>
+#include <arvsharedpublisher.h>
+#include <arvsharedstream.h>
 #include <arvstream.h>
+#include <arvstreamgroup.h>
+#include <arvcameragroup.h>
 #include <arvstr.h>
 #include <arvsystem.h>
 
@@ -108,6 +119,7 @@
 #include <arvuvinterface.h>
 #include <arvuvdevice.h>
 #include <arvuvstream.h>
+#include <arvuvbandwidthplanner.h>
 #endif
 
 #include <arvversion.h>
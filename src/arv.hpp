@@ -0,0 +1,549 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/*
+ * Header-only C++17 layer over the aravis C API.
+ *
+ * Objects are reference counted GObject handles, errors are reported as arv::Error exceptions. A frame popped from
+ * a stream is a move-only arv::BufferLease, which pushes the buffer back to its stream on destruction, and gives
+ * access to the image through a non-owning arv::ImageView. Features are resolved once into typed handles, which
+ * avoid the name lookup of the arv_device_get_*_feature_value functions on each access.
+ *
+ * The per-frame path, arv::Stream::pop and arv::StreamConsumer, does not allocate.
+ */
+
+#ifndef ARV_HPP
+#define ARV_HPP
+
+#include <arv.h>
+
+#if !defined (__cplusplus) || ((__cplusplus < 201703L) && (!defined (_MSVC_LANG) || _MSVC_LANG < 201703L))
+#error "arv.hpp requires C++17"
+#endif
+
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace arv {
+
+class Error : public std::runtime_error {
+public:
+	Error (GError *error) :
+		std::runtime_error (error != nullptr ? error->message : "Unknown error"),
+		_domain (error != nullptr ? error->domain : 0),
+		_code (error != nullptr ? error->code : 0)
+	{
+		g_clear_error (&error);
+	}
+
+	Error (const std::string &message) : std::runtime_error (message), _domain (0), _code (0) {}
+
+	GQuark domain () const noexcept { return _domain; }
+	int code () const noexcept { return _code; }
+
+private:
+	GQuark _domain;
+	int _code;
+};
+
+namespace detail {
+
+/* Throws, and frees, a pending error */
+
+inline void
+check (GError *error)
+{
+	if (error != nullptr)
+		throw Error (error);
+}
+
+/* Owning reference to a GObject */
+
+template <typename T>
+class ObjectRef {
+public:
+	ObjectRef () noexcept = default;
+	explicit ObjectRef (T *object, bool take = true) noexcept : _object (object)
+	{
+		if (_object != nullptr && !take)
+			g_object_ref (_object);
+	}
+	ObjectRef (const ObjectRef &other) noexcept : ObjectRef (other._object, false) {}
+	ObjectRef (ObjectRef &&other) noexcept : _object (std::exchange (other._object, nullptr)) {}
+	~ObjectRef () { reset (); }
+
+	ObjectRef &operator= (ObjectRef other) noexcept
+	{
+		std::swap (_object, other._object);
+		return *this;
+	}
+
+	void reset () noexcept
+	{
+		if (_object != nullptr)
+			g_object_unref (std::exchange (_object, nullptr));
+	}
+
+	T *get () const noexcept { return _object; }
+	explicit operator bool () const noexcept { return _object != nullptr; }
+
+private:
+	T *_object = nullptr;
+};
+
+} /* namespace detail */
+
+/* Non-owning view of the pixels of an image, valid as long as the buffer it comes from */
+
+class ImageView {
+public:
+	ImageView () noexcept = default;
+	ImageView (const std::uint8_t *data, std::size_t size, int width, int height, std::size_t stride,
+		   ArvPixelFormat pixel_format) noexcept :
+		_data (data), _size (size), _width (width), _height (height), _stride (stride),
+		_pixel_format (pixel_format) {}
+
+	const std::uint8_t *data () const noexcept { return _data; }
+	std::size_t size () const noexcept { return _size; }
+	bool empty () const noexcept { return _data == nullptr || _size == 0; }
+
+	int width () const noexcept { return _width; }
+	int height () const noexcept { return _height; }
+	std::size_t stride () const noexcept { return _stride; }
+	ArvPixelFormat pixel_format () const noexcept { return _pixel_format; }
+	unsigned bits_per_pixel () const noexcept { return ARV_PIXEL_FORMAT_BIT_PER_PIXEL (_pixel_format); }
+
+	const std::uint8_t *row (int y) const noexcept { return _data + static_cast<std::size_t> (y) * _stride; }
+
+	/* Typed access to a row, e.g. row_as<std::uint16_t> (y) for 16 bit pixel formats */
+	template <typename P>
+	const P *row_as (int y) const noexcept { return reinterpret_cast<const P *> (row (y)); }
+
+private:
+	const std::uint8_t *_data = nullptr;
+	std::size_t _size = 0;
+	int _width = 0;
+	int _height = 0;
+	std::size_t _stride = 0;
+	ArvPixelFormat _pixel_format = 0;
+};
+
+/* Buffer popped from a stream, pushed back to it on destruction */
+
+class BufferLease {
+public:
+	BufferLease () noexcept = default;
+	BufferLease (ArvStream *stream, ArvBuffer *buffer) noexcept :
+		_stream (buffer != nullptr ? stream : nullptr, false), _buffer (buffer) {}
+	BufferLease (const BufferLease &) = delete;
+	BufferLease (BufferLease &&other) noexcept :
+		_stream (std::move (other._stream)),
+		_buffer (std::exchange (other._buffer, nullptr)) {}
+	~BufferLease () { reset (); }
+
+	BufferLease &operator= (const BufferLease &) = delete;
+	BufferLease &operator= (BufferLease &&other) noexcept
+	{
+		if (this != &other) {
+			reset ();
+			_stream = std::move (other._stream);
+			_buffer = std::exchange (other._buffer, nullptr);
+		}
+		return *this;
+	}
+
+	/* Pushes the buffer back to the stream now */
+	void reset () noexcept
+	{
+		if (_buffer != nullptr)
+			arv_stream_push_buffer (_stream.get (), std::exchange (_buffer, nullptr));
+		_stream.reset ();
+	}
+
+	/* Gives up the ownership of the buffer, which is not pushed back to the stream */
+	ArvBuffer *release () noexcept
+	{
+		_stream.reset ();
+		return std::exchange (_buffer, nullptr);
+	}
+
+	ArvBuffer *get () const noexcept { return _buffer; }
+	explicit operator bool () const noexcept { return _buffer != nullptr; }
+
+	ArvBufferStatus status () const noexcept { return arv_buffer_get_status (_buffer); }
+	bool is_complete () const noexcept { return status () == ARV_BUFFER_STATUS_SUCCESS; }
+	std::uint64_t frame_id () const noexcept { return arv_buffer_get_frame_id (_buffer); }
+	std::uint64_t timestamp () const noexcept { return arv_buffer_get_timestamp (_buffer); }
+	std::uint64_t system_timestamp () const noexcept { return arv_buffer_get_system_timestamp (_buffer); }
+
+	ImageView image () const noexcept
+	{
+		std::size_t size = 0;
+		const void *data = arv_buffer_get_data (_buffer, &size);
+
+		return ImageView (static_cast<const std::uint8_t *> (data), size,
+				  arv_buffer_get_image_width (_buffer),
+				  arv_buffer_get_image_height (_buffer),
+				  arv_buffer_get_image_stride (_buffer),
+				  arv_buffer_get_image_pixel_format (_buffer));
+	}
+
+	/* Multipart payloads have no line padding */
+	ImageView part (unsigned part_id) const noexcept
+	{
+		std::size_t size = 0;
+		const void *data = arv_buffer_get_part_data (_buffer, part_id, &size);
+		ArvPixelFormat pixel_format = arv_buffer_get_part_pixel_format (_buffer, part_id);
+		int width = 0, height = 0;
+
+		arv_buffer_get_part_region (_buffer, part_id, nullptr, nullptr, &width, &height);
+
+		return ImageView (static_cast<const std::uint8_t *> (data), size, width, height,
+				  (static_cast<std::size_t> (width) * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (pixel_format) + 7) / 8,
+				  pixel_format);
+	}
+
+private:
+	detail::ObjectRef<ArvStream> _stream;
+	ArvBuffer *_buffer = nullptr;
+};
+
+/* Typed feature handles, resolved once. The device must outlive them. */
+
+class FeatureHandle {
+public:
+	FeatureHandle () noexcept = default;
+
+	ArvGcNode *node () const noexcept { return _node; }
+	explicit operator bool () const noexcept { return _node != nullptr; }
+
+protected:
+	FeatureHandle (ArvDevice *device, const char *name, GType type) : _node (arv_device_get_feature (device, name))
+	{
+		if (_node == nullptr)
+			throw Error (std::string ("Feature '") + name + "' not found");
+		if (!G_TYPE_CHECK_INSTANCE_TYPE (_node, type))
+			throw Error (std::string ("Feature '") + name + "' is not a " + g_type_name (type));
+	}
+
+	ArvGcNode *_node = nullptr;
+};
+
+class IntegerFeature : public FeatureHandle {
+public:
+	IntegerFeature () noexcept = default;
+	IntegerFeature (ArvDevice *device, const char *name) : FeatureHandle (device, name, ARV_TYPE_GC_INTEGER) {}
+
+	std::int64_t get () const
+	{
+		GError *error = nullptr;
+		std::int64_t value = arv_gc_integer_get_value (ARV_GC_INTEGER (_node), &error);
+
+		detail::check (error);
+		return value;
+	}
+
+	void set (std::int64_t value) const
+	{
+		GError *error = nullptr;
+
+		arv_gc_integer_set_value (ARV_GC_INTEGER (_node), value, &error);
+		detail::check (error);
+	}
+};
+
+class FloatFeature : public FeatureHandle {
+public:
+	FloatFeature () noexcept = default;
+	FloatFeature (ArvDevice *device, const char *name) : FeatureHandle (device, name, ARV_TYPE_GC_FLOAT) {}
+
+	double get () const
+	{
+		GError *error = nullptr;
+		double value = arv_gc_float_get_value (ARV_GC_FLOAT (_node), &error);
+
+		detail::check (error);
+		return value;
+	}
+
+	void set (double value) const
+	{
+		GError *error = nullptr;
+
+		arv_gc_float_set_value (ARV_GC_FLOAT (_node), value, &error);
+		detail::check (error);
+	}
+};
+
+class BooleanFeature : public FeatureHandle {
+public:
+	BooleanFeature () noexcept = default;
+	BooleanFeature (ArvDevice *device, const char *name) : FeatureHandle (device, name, ARV_TYPE_GC_BOOLEAN) {}
+
+	bool get () const
+	{
+		GError *error = nullptr;
+		bool value = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (_node), &error);
+
+		detail::check (error);
+		return value;
+	}
+
+	void set (bool value) const
+	{
+		GError *error = nullptr;
+
+		arv_gc_boolean_set_value (ARV_GC_BOOLEAN (_node), value, &error);
+		detail::check (error);
+	}
+};
+
+class EnumerationFeature : public FeatureHandle {
+public:
+	EnumerationFeature () noexcept = default;
+	EnumerationFeature (ArvDevice *device, const char *name) :
+		FeatureHandle (device, name, ARV_TYPE_GC_ENUMERATION) {}
+
+	const char *get () const
+	{
+		GError *error = nullptr;
+		const char *value = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (_node), &error);
+
+		detail::check (error);
+		return value;
+	}
+
+	void set (const char *value) const
+	{
+		GError *error = nullptr;
+
+		arv_gc_enumeration_set_string_value (ARV_GC_ENUMERATION (_node), value, &error);
+		detail::check (error);
+	}
+
+	std::int64_t get_int () const
+	{
+		GError *error = nullptr;
+		std::int64_t value = arv_gc_enumeration_get_int_value (ARV_GC_ENUMERATION (_node), &error);
+
+		detail::check (error);
+		return value;
+	}
+
+	void set_int (std::int64_t value) const
+	{
+		GError *error = nullptr;
+
+		arv_gc_enumeration_set_int_value (ARV_GC_ENUMERATION (_node), value, &error);
+		detail::check (error);
+	}
+};
+
+class CommandFeature : public FeatureHandle {
+public:
+	CommandFeature () noexcept = default;
+	CommandFeature (ArvDevice *device, const char *name) : FeatureHandle (device, name, ARV_TYPE_GC_COMMAND) {}
+
+	void execute () const
+	{
+		GError *error = nullptr;
+
+		arv_gc_command_execute (ARV_GC_COMMAND (_node), &error);
+		detail::check (error);
+	}
+};
+
+class Stream {
+public:
+	Stream () noexcept = default;
+	explicit Stream (ArvStream *stream, bool take = true) noexcept : _stream (stream, take) {}
+
+	ArvStream *get () const noexcept { return _stream.get (); }
+	explicit operator bool () const noexcept { return bool (_stream); }
+
+	/* Allocates and pushes n_buffers buffers of size bytes */
+	void allocate_buffers (unsigned n_buffers, std::size_t size) const
+	{
+		for (unsigned i = 0; i < n_buffers; i++)
+			arv_stream_push_buffer (get (), arv_buffer_new (size, nullptr));
+	}
+
+	/* Waits up to timeout_us for a buffer, the returned lease is empty on timeout */
+	BufferLease pop (std::uint64_t timeout_us) const noexcept
+	{
+		return BufferLease (get (), arv_stream_timeout_pop_buffer (get (), timeout_us));
+	}
+
+	BufferLease try_pop () const noexcept { return BufferLease (get (), arv_stream_try_pop_buffer (get ())); }
+
+	void statistics (std::uint64_t &n_completed_buffers, std::uint64_t &n_failures, std::uint64_t &n_underruns) const
+	{
+		guint64 completed, failures, underruns;
+
+		arv_stream_get_statistics (get (), &completed, &failures, &underruns);
+		n_completed_buffers = completed;
+		n_failures = failures;
+		n_underruns = underruns;
+	}
+
+private:
+	detail::ObjectRef<ArvStream> _stream;
+};
+
+/* Calls a callback from the stream thread for each output buffer. The callback gets the buffer lease, which it may
+ * move away to keep the buffer, otherwise the buffer goes back to the stream when the callback returns.
+ *
+ * The destructor waits for a running callback to return, it must not be called from the callback. The emission of
+ * the stream signals is left enabled, as other handlers may still be connected. */
+
+class StreamConsumer {
+public:
+	using Callback = std::function<void (BufferLease &)>;
+
+	StreamConsumer (const Stream &stream, Callback callback) :
+		_stream (stream), _handler (new Handler {std::move (callback), {}, {}, false})
+	{
+		_handler_id = g_signal_connect_data (_stream.get (), "new-buffer", G_CALLBACK (_new_buffer_cb),
+						     _handler, _handler_destroyed_cb, GConnectFlags (0));
+		arv_stream_set_emit_signals (_stream.get (), TRUE);
+	}
+
+	StreamConsumer (const StreamConsumer &) = delete;
+	StreamConsumer &operator= (const StreamConsumer &) = delete;
+
+	/* The handler data is released by the signal closure, once the signal emissions in progress are over */
+	~StreamConsumer ()
+	{
+		g_signal_handler_disconnect (_stream.get (), _handler_id);
+
+		{
+			std::unique_lock<std::mutex> lock (_handler->mutex);
+
+			_handler->condition.wait (lock, [this] { return _handler->is_destroyed; });
+		}
+
+		delete _handler;
+	}
+
+private:
+	struct Handler {
+		Callback callback;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool is_destroyed;
+	};
+
+	static void _new_buffer_cb (ArvStream *stream, Handler *handler)
+	{
+		BufferLease lease (stream, arv_stream_try_pop_buffer (stream));
+
+		if (lease)
+			handler->callback (lease);
+	}
+
+	static void _handler_destroyed_cb (gpointer data, GClosure *)
+	{
+		Handler *handler = static_cast<Handler *> (data);
+		std::lock_guard<std::mutex> lock (handler->mutex);
+
+		handler->is_destroyed = true;
+		handler->condition.notify_all ();
+	}
+
+	Stream _stream;
+	Handler *_handler;
+	gulong _handler_id = 0;
+};
+
+class Camera {
+public:
+	Camera () noexcept = default;
+	explicit Camera (ArvCamera *camera, bool take = true) noexcept : _camera (camera, take) {}
+
+	/* Opens the first available camera if name is null */
+	static Camera open (const char *name = nullptr)
+	{
+		GError *error = nullptr;
+		ArvCamera *camera = arv_camera_new (name, &error);
+
+		detail::check (error);
+		return Camera (camera);
+	}
+
+	ArvCamera *get () const noexcept { return _camera.get (); }
+	ArvDevice *device () const noexcept { return arv_camera_get_device (get ()); }
+	explicit operator bool () const noexcept { return bool (_camera); }
+
+	Stream create_stream () const
+	{
+		GError *error = nullptr;
+		ArvStream *stream = arv_camera_create_stream (get (), nullptr, nullptr, &error);
+
+		detail::check (error);
+		return Stream (stream);
+	}
+
+	std::size_t payload () const
+	{
+		GError *error = nullptr;
+		std::size_t payload = arv_camera_get_payload (get (), &error);
+
+		detail::check (error);
+		return payload;
+	}
+
+	void start_acquisition () const
+	{
+		GError *error = nullptr;
+
+		arv_camera_start_acquisition (get (), &error);
+		detail::check (error);
+	}
+
+	void stop_acquisition () const
+	{
+		GError *error = nullptr;
+
+		arv_camera_stop_acquisition (get (), &error);
+		detail::check (error);
+	}
+
+	IntegerFeature integer_feature (const char *name) const { return IntegerFeature (device (), name); }
+	FloatFeature float_feature (const char *name) const { return FloatFeature (device (), name); }
+	BooleanFeature boolean_feature (const char *name) const { return BooleanFeature (device (), name); }
+	EnumerationFeature enumeration_feature (const char *name) const { return EnumerationFeature (device (), name); }
+	CommandFeature command_feature (const char *name) const { return CommandFeature (device (), name); }
+
+private:
+	detail::ObjectRef<ArvCamera> _camera;
+};
+
+} /* namespace arv */
+
+#endif
@@ -0,0 +1,495 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvBandwidthPlanner:
+ *
+ * [class@ArvBandwidthPlanner] shares the bandwidth of a network link between a set of GigE Vision cameras, for
+ * example when several cameras are connected to a switch with a single uplink to the host.
+ *
+ * For each camera, the planner reads the payload size, the frame rate and the stream packet size, and computes the
+ * bandwidth needed by the camera on the wire. The link budget is then shared between the cameras, in proportion of
+ * their needs, and the inter-packet delay of each camera (the GevSCPD feature) is set such that its packets are
+ * spread over the frame period at the rate of its share. The packets of the different cameras then interleave in the
+ * switch, instead of colliding in bursts sent at the full speed of the camera links.
+ *
+ * Once [method@ArvBandwidthPlanner.apply] was called, the plan is computed and applied again each time the
+ * payload size, the frame rate or the packet size of one of the cameras is changed through aravis. The change
+ * notifications are emitted from the thread default main context at the time the camera was added, see
+ * [signal@ArvGc::feature-changed].
+ *
+ * The vendor specific bandwidth reservation features are left untouched.
+ */
+
+#include <arvbandwidthplanner.h>
+#include <arvgvdeviceprivate.h>
+#include <arvgvspprivate.h>
+#include <arvdebugprivate.h>
+#include <arvgc.h>
+
+/* Ethernet header, frame check sequence, preamble and inter-frame gap */
+#define ARV_BANDWIDTH_PLANNER_ETHERNET_OVERHEAD		(14 + 4 + 8 + 12)
+
+#define ARV_BANDWIDTH_PLANNER_MAX_LINK_USAGE_DEFAULT	0.9
+#define ARV_BANDWIDTH_PLANNER_CAMERA_LINK_DEFAULT	1000000000ULL
+
+/* Features triggering a new plan when they change */
+static const char *arv_bandwidth_planner_watched_features[] = {
+	"PayloadSize",
+	"AcquisitionFrameRate",
+	"AcquisitionFrameRateAbs",
+	"GevSCPSPacketSize"
+};
+
+#define ARV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES G_N_ELEMENTS (arv_bandwidth_planner_watched_features)
+
+GQuark
+arv_bandwidth_planner_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-bandwidth-planner-error-quark");
+}
+
+typedef struct {
+	ArvCamera *camera;
+	ArvGc *genicam;
+	gulong changed_handler;
+	gboolean is_watched[ARV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES];
+
+	guint packet_size;
+	guint64 bandwidth;
+	gint64 packet_delay_ns;
+} ArvBandwidthPlannerCamera;
+
+typedef struct {
+	GPtrArray *cameras;
+
+	guint64 link_bandwidth;
+	guint64 camera_link_bandwidth;
+	double max_link_usage;
+
+	guint64 required_bandwidth;
+	gboolean is_applied;
+	gboolean is_applying;
+} ArvBandwidthPlannerPrivate;
+
+struct _ArvBandwidthPlanner {
+	GObject	object;
+
+	ArvBandwidthPlannerPrivate *priv;
+};
+
+struct _ArvBandwidthPlannerClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvBandwidthPlanner, arv_bandwidth_planner, G_TYPE_OBJECT,
+			 G_ADD_PRIVATE (ArvBandwidthPlanner))
+
+static void
+_camera_free (gpointer data)
+{
+	ArvBandwidthPlannerCamera *entry = data;
+	guint i;
+
+	g_signal_handler_disconnect (entry->genicam, entry->changed_handler);
+	for (i = 0; i < ARV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES; i++)
+		if (entry->is_watched[i])
+			arv_gc_unwatch_feature (entry->genicam, arv_bandwidth_planner_watched_features[i], NULL);
+
+	g_object_unref (entry->camera);
+	g_free (entry);
+}
+
+static ArvBandwidthPlannerCamera *
+_find_camera (ArvBandwidthPlanner *planner, ArvCamera *camera, guint *index)
+{
+	guint i;
+
+	for (i = 0; i < planner->priv->cameras->len; i++) {
+		ArvBandwidthPlannerCamera *entry = g_ptr_array_index (planner->priv->cameras, i);
+
+		if (entry->camera == camera) {
+			if (index != NULL)
+				*index = i;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+_feature_changed_cb (ArvGc *genicam, const char *feature, ArvBandwidthPlanner *planner)
+{
+	GError *error = NULL;
+
+	if (!planner->priv->is_applied || planner->priv->is_applying)
+		return;
+
+	arv_info_device ("[BandwidthPlanner::feature_changed] %s changed, update the plan", feature);
+
+	if (!arv_bandwidth_planner_apply (planner, &error)) {
+		arv_warning_device ("[BandwidthPlanner::feature_changed] Failed to update the plan: %s",
+				    error->message);
+		g_clear_error (&error);
+	}
+}
+
+/**
+ * arv_bandwidth_planner_new:
+ * @link_bandwidth: bandwidth of the link shared by the cameras, in bits per second
+ *
+ * Creates a planner for the cameras sharing a link of @link_bandwidth. By default, at most 90% of the link is used
+ * by the streams, and the cameras are assumed to be connected at 1 Gbit/s.
+ *
+ * Returns: (transfer full): a new #ArvBandwidthPlanner
+ *
+ * Since: 0.8.24
+ */
+
+ArvBandwidthPlanner *
+arv_bandwidth_planner_new (guint64 link_bandwidth)
+{
+	ArvBandwidthPlanner *planner;
+
+	g_return_val_if_fail (link_bandwidth > 0, NULL);
+
+	planner = g_object_new (ARV_TYPE_BANDWIDTH_PLANNER, NULL);
+	planner->priv->link_bandwidth = link_bandwidth;
+
+	return planner;
+}
+
+/**
+ * arv_bandwidth_planner_set_max_link_usage:
+ * @planner: a #ArvBandwidthPlanner
+ * @max_link_usage: maximum fraction of the link bandwidth used by the streams, in the ]0,1] range
+ *
+ * Sets the part of the link bandwidth the streams are allowed to use. The remaining part is left for the packet
+ * resends, the control traffic and the timing jitter of the cameras.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_bandwidth_planner_set_max_link_usage (ArvBandwidthPlanner *planner, double max_link_usage)
+{
+	g_return_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner));
+	g_return_if_fail (max_link_usage > 0.0 && max_link_usage <= 1.0);
+
+	planner->priv->max_link_usage = max_link_usage;
+}
+
+/**
+ * arv_bandwidth_planner_set_camera_link_bandwidth:
+ * @planner: a #ArvBandwidthPlanner
+ * @camera_link_bandwidth: bandwidth of the camera links, in bits per second
+ *
+ * Sets the speed of the links between the cameras and the switch, which is the rate of the packets sent without
+ * inter-packet delay.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_bandwidth_planner_set_camera_link_bandwidth (ArvBandwidthPlanner *planner, guint64 camera_link_bandwidth)
+{
+	g_return_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner));
+	g_return_if_fail (camera_link_bandwidth > 0);
+
+	planner->priv->camera_link_bandwidth = camera_link_bandwidth;
+}
+
+/**
+ * arv_bandwidth_planner_add_camera:
+ * @planner: a #ArvBandwidthPlanner
+ * @camera: an opened GigE Vision #ArvCamera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Adds @camera to the set of cameras sharing the link. The plan is not applied before the next call to
+ * arv_bandwidth_planner_apply().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_bandwidth_planner_add_camera (ArvBandwidthPlanner *planner, ArvCamera *camera, GError **error)
+{
+	ArvBandwidthPlannerCamera *entry;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner), FALSE);
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+
+	if (!arv_camera_is_gv_device (camera)) {
+		g_set_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED,
+			     "Bandwidth planning is only available for GigE Vision cameras");
+		return FALSE;
+	}
+
+	if (_find_camera (planner, camera, NULL) != NULL)
+		return TRUE;
+
+	entry = g_new0 (ArvBandwidthPlannerCamera, 1);
+	entry->camera = g_object_ref (camera);
+	entry->genicam = arv_device_get_genicam (arv_camera_get_device (camera));
+	entry->changed_handler = g_signal_connect (entry->genicam, "feature-changed",
+						   G_CALLBACK (_feature_changed_cb), planner);
+
+	for (i = 0; i < ARV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES; i++)
+		entry->is_watched[i] = arv_gc_watch_feature (entry->genicam, arv_bandwidth_planner_watched_features[i],
+							     NULL);
+
+	g_ptr_array_add (planner->priv->cameras, entry);
+
+	return TRUE;
+}
+
+/**
+ * arv_bandwidth_planner_remove_camera:
+ * @planner: a #ArvBandwidthPlanner
+ * @camera: a #ArvCamera
+ *
+ * Removes @camera from the set of cameras sharing the link. Its inter-packet delay is left unchanged.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_bandwidth_planner_remove_camera (ArvBandwidthPlanner *planner, ArvCamera *camera)
+{
+	guint index;
+
+	g_return_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner));
+
+	if (_find_camera (planner, camera, &index) != NULL)
+		g_ptr_array_remove_index (planner->priv->cameras, index);
+}
+
+/* Bandwidth used by a camera on the wire, in bits per second, counting the leader and trailer packets, and the
+ * protocol overheads */
+
+static gboolean
+_measure_camera (ArvBandwidthPlannerCamera *entry, GError **error)
+{
+	GError *local_error = NULL;
+	guint64 payload;
+	guint64 n_packets;
+	guint data_size;
+	double frame_rate;
+
+	payload = arv_camera_get_payload (entry->camera, &local_error);
+	if (local_error == NULL)
+		frame_rate = arv_camera_get_frame_rate (entry->camera, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	entry->packet_size = arv_camera_gv_get_packet_size (entry->camera, &local_error);
+	if (local_error != NULL || entry->packet_size <= ARV_GVSP_PACKET_PROTOCOL_OVERHEAD) {
+		arv_debug_device ("[BandwidthPlanner::measure_camera] Packet size not available, assume %d bytes",
+				  ARV_GV_DEVICE_GVSP_PACKET_SIZE_DEFAULT);
+		g_clear_error (&local_error);
+		entry->packet_size = ARV_GV_DEVICE_GVSP_PACKET_SIZE_DEFAULT;
+	}
+
+	data_size = entry->packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+	n_packets = (payload + data_size - 1) / data_size + 2;
+
+	entry->bandwidth = (guint64) (n_packets * (entry->packet_size + ARV_BANDWIDTH_PLANNER_ETHERNET_OVERHEAD) * 8 *
+				      MAX (frame_rate, 0.0));
+
+	return TRUE;
+}
+
+/**
+ * arv_bandwidth_planner_apply:
+ * @planner: a #ArvBandwidthPlanner
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Computes the share of the link bandwidth of each camera, and sets their inter-packet delay accordingly. The cameras
+ * without GevSCPD feature are taken into account, but not configured. If the cameras need more than the link
+ * budget, no setting is changed and an #ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED error is returned.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_bandwidth_planner_apply (ArvBandwidthPlanner *planner, GError **error)
+{
+	ArvBandwidthPlannerPrivate *priv;
+	GError *local_error = NULL;
+	double budget;
+	guint64 required_bandwidth = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner), FALSE);
+
+	priv = planner->priv;
+
+	for (i = 0; i < priv->cameras->len; i++) {
+		ArvBandwidthPlannerCamera *entry = g_ptr_array_index (priv->cameras, i);
+
+		if (!_measure_camera (entry, error))
+			return FALSE;
+
+		required_bandwidth += entry->bandwidth;
+	}
+
+	priv->required_bandwidth = required_bandwidth;
+	priv->is_applied = TRUE;
+
+	budget = (double) priv->link_bandwidth * priv->max_link_usage;
+
+	arv_info_device ("[BandwidthPlanner::apply] %u camera(s), %" G_GUINT64_FORMAT " bit/s for a budget of %.0f bit/s",
+			 priv->cameras->len, required_bandwidth, budget);
+
+	if (required_bandwidth > budget) {
+		g_set_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED,
+			     "The cameras need %" G_GUINT64_FORMAT " bit/s, for a budget of %.0f bit/s",
+			     required_bandwidth, budget);
+		return FALSE;
+	}
+
+	if (required_bandwidth == 0)
+		return TRUE;
+
+	priv->is_applying = TRUE;
+
+	for (i = 0; i < priv->cameras->len; i++) {
+		ArvBandwidthPlannerCamera *entry = g_ptr_array_index (priv->cameras, i);
+		double packet_bits = (entry->packet_size + ARV_BANDWIDTH_PLANNER_ETHERNET_OVERHEAD) * 8.0;
+		double rate;
+		double delay_s;
+
+		/* The budget share is larger than the need, which lets the frames be sent as fast as the link allows */
+		rate = MIN (budget * entry->bandwidth / required_bandwidth, (double) priv->camera_link_bandwidth);
+		delay_s = rate > 0.0 ? packet_bits / rate - packet_bits / priv->camera_link_bandwidth : 0.0;
+		entry->packet_delay_ns = MAX (delay_s * 1e9, 0.0);
+
+		arv_info_device ("[BandwidthPlanner::apply] %s: %" G_GUINT64_FORMAT " bit/s, packet delay %" G_GINT64_FORMAT
+				 " ns", arv_camera_get_device_id (entry->camera, NULL), entry->bandwidth,
+				 entry->packet_delay_ns);
+
+		if (!arv_camera_is_feature_available (entry->camera, "GevSCPD", NULL)) {
+			arv_info_device ("[BandwidthPlanner::apply] No packet delay control");
+			continue;
+		}
+
+		arv_camera_gv_set_packet_delay (entry->camera, entry->packet_delay_ns, &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			priv->is_applying = FALSE;
+			return FALSE;
+		}
+	}
+
+	priv->is_applying = FALSE;
+
+	return TRUE;
+}
+
+/**
+ * arv_bandwidth_planner_get_required_bandwidth:
+ * @planner: a #ArvBandwidthPlanner
+ *
+ * Returns: the total bandwidth needed by the cameras at the last arv_bandwidth_planner_apply() call, in bits per
+ * second.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_bandwidth_planner_get_required_bandwidth (ArvBandwidthPlanner *planner)
+{
+	g_return_val_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner), 0);
+
+	return planner->priv->required_bandwidth;
+}
+
+/**
+ * arv_bandwidth_planner_get_packet_delay:
+ * @planner: a #ArvBandwidthPlanner
+ * @camera: a #ArvCamera
+ *
+ * Returns: the inter-packet delay planned for @camera by the last successful arv_bandwidth_planner_apply() call, in
+ * nanoseconds, -1 if @camera is not planned by @planner.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_bandwidth_planner_get_packet_delay (ArvBandwidthPlanner *planner, ArvCamera *camera)
+{
+	ArvBandwidthPlannerCamera *entry;
+
+	g_return_val_if_fail (ARV_IS_BANDWIDTH_PLANNER (planner), -1);
+
+	entry = _find_camera (planner, camera, NULL);
+
+	return entry != NULL ? entry->packet_delay_ns : -1;
+}
+
+static void
+arv_bandwidth_planner_init (ArvBandwidthPlanner *planner)
+{
+	planner->priv = arv_bandwidth_planner_get_instance_private (planner);
+
+	planner->priv->cameras = g_ptr_array_new_with_free_func (_camera_free);
+	planner->priv->max_link_usage = ARV_BANDWIDTH_PLANNER_MAX_LINK_USAGE_DEFAULT;
+	planner->priv->camera_link_bandwidth = ARV_BANDWIDTH_PLANNER_CAMERA_LINK_DEFAULT;
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvBandwidthPlanner *planner = ARV_BANDWIDTH_PLANNER (object);
+
+	if (planner->priv->cameras != NULL)
+		g_ptr_array_set_size (planner->priv->cameras, 0);
+
+	G_OBJECT_CLASS (arv_bandwidth_planner_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvBandwidthPlanner *planner = ARV_BANDWIDTH_PLANNER (object);
+
+	g_clear_pointer (&planner->priv->cameras, g_ptr_array_unref);
+
+	G_OBJECT_CLASS (arv_bandwidth_planner_parent_class)->finalize (object);
+}
+
+static void
+arv_bandwidth_planner_class_init (ArvBandwidthPlannerClass *planner_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (planner_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,77 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_BANDWIDTH_PLANNER_H
+#define ARV_BANDWIDTH_PLANNER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvcamera.h>
+
+G_BEGIN_DECLS
+
+#define ARV_BANDWIDTH_PLANNER_ERROR arv_bandwidth_planner_error_quark()
+
+ARV_API GQuark		arv_bandwidth_planner_error_quark		(void);
+
+/**
+ * ArvBandwidthPlannerError:
+ * @ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED: the camera type is not supported by the planner
+ * @ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED: the cameras need more than the link budget
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED,
+	ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED
+} ArvBandwidthPlannerError;
+
+#define ARV_TYPE_BANDWIDTH_PLANNER             (arv_bandwidth_planner_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvBandwidthPlanner, arv_bandwidth_planner, ARV, BANDWIDTH_PLANNER, GObject)
+
+ARV_API ArvBandwidthPlanner *	arv_bandwidth_planner_new			(guint64 link_bandwidth);
+
+ARV_API void			arv_bandwidth_planner_set_max_link_usage	(ArvBandwidthPlanner *planner,
+										 double max_link_usage);
+ARV_API void			arv_bandwidth_planner_set_camera_link_bandwidth	(ArvBandwidthPlanner *planner,
+										 guint64 camera_link_bandwidth);
+
+ARV_API gboolean		arv_bandwidth_planner_add_camera		(ArvBandwidthPlanner *planner,
+										 ArvCamera *camera, GError **error);
+ARV_API void			arv_bandwidth_planner_remove_camera		(ArvBandwidthPlanner *planner,
+										 ArvCamera *camera);
+
+ARV_API gboolean		arv_bandwidth_planner_apply			(ArvBandwidthPlanner *planner,
+										 GError **error);
+
+ARV_API guint64			arv_bandwidth_planner_get_required_bandwidth	(ArvBandwidthPlanner *planner);
+ARV_API gint64			arv_bandwidth_planner_get_packet_delay		(ArvBandwidthPlanner *planner,
+										 ArvCamera *camera);
+
+G_END_DECLS
+
+#endif
@@ -32,6 +32,25 @@
  */
 
 #include <arvbufferprivate.h>
+#include <arvfeatures.h>
+#include <arvmiscprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#if ARAVIS_HAS_DMA_HEAP
+#include <linux/dma-heap.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+GQuark
+arv_buffer_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-buffer-error-quark");
+}
 
 gboolean
 arv_buffer_payload_type_has_chunks (ArvBufferPayloadType payload_type)
@@ -93,6 +112,182 @@ arv_buffer_new_full (size_t size, void *preallocated, void *user_data, GDestroyN
 	return buffer;
 }
 
+/**
+ * arv_buffer_new_take_data: (skip)
+ * @size: payload size
+ * @data: (transfer full): memory buffer
+ * @data_destroy_data: data for @data_destroy_func
+ * @data_destroy_func: function used for the release of @data
+ *
+ * Creates a new buffer using a memory space allocated by a specific allocator, @data_destroy_func being called
+ * on buffer destruction.
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_take_data (size_t size, void *data, void *data_destroy_data, GDestroyNotify data_destroy_func)
+{
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (data != NULL, NULL);
+
+	buffer = arv_buffer_new_full (size, data, NULL, NULL);
+	buffer->priv->data_destroy_data = data_destroy_data;
+	buffer->priv->data_destroy_func = data_destroy_func;
+
+	return buffer;
+}
+
+#if ARAVIS_HAS_DMA_HEAP
+
+typedef struct {
+	int fd;
+	void *data;
+	size_t size;
+} ArvBufferDmabuf;
+
+static void
+_dmabuf_free (void *data)
+{
+	ArvBufferDmabuf *dmabuf = data;
+
+	munmap (dmabuf->data, dmabuf->size);
+	close (dmabuf->fd);
+	g_free (dmabuf);
+}
+
+#endif
+
+/**
+ * arv_buffer_new_dmabuf:
+ * @size: payload size
+ * @heap_name: (nullable): name of the DMA heap, %NULL for the "system" heap
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new buffer whose data is allocated from a Linux DMA heap (/dev/dma_heap/@heap_name). The DMA buffer
+ * file descriptor, retrieved using [method@ArvBuffer.get_dmabuf_fd], allows other devices, like video encoders or
+ * GPUs, to import the image data without copy. The file descriptor is closed when the buffer is destroyed.
+ *
+ * Returns: (transfer full): a new [class@ArvBuffer] object, %NULL on error
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_dmabuf (size_t size, const char *heap_name, GError **error)
+{
+#if ARAVIS_HAS_DMA_HEAP
+	struct dma_heap_allocation_data allocation;
+	ArvBufferDmabuf *dmabuf;
+	ArvBuffer *buffer;
+	char *path;
+	void *data;
+	int heap_fd;
+
+	g_return_val_if_fail (size > 0, NULL);
+
+	path = g_build_filename ("/dev/dma_heap", heap_name != NULL ? heap_name : "system", NULL);
+	heap_fd = open (path, O_RDWR | O_CLOEXEC);
+	if (heap_fd < 0) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't open DMA heap %s (%s)", path, g_strerror (errsv));
+		g_free (path);
+		return NULL;
+	}
+
+	memset (&allocation, 0, sizeof (allocation));
+	allocation.len = size;
+	allocation.fd_flags = O_RDWR | O_CLOEXEC;
+
+	if (ioctl (heap_fd, DMA_HEAP_IOCTL_ALLOC, &allocation) < 0) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't allocate %" G_GSIZE_FORMAT " bytes from DMA heap %s (%s)",
+			     size, path, g_strerror (errsv));
+		close (heap_fd);
+		g_free (path);
+		return NULL;
+	}
+
+	close (heap_fd);
+	g_free (path);
+
+	data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, allocation.fd, 0);
+	if (data == MAP_FAILED) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't map DMA buffer (%s)", g_strerror (errsv));
+		close (allocation.fd);
+		return NULL;
+	}
+
+	dmabuf = g_new (ArvBufferDmabuf, 1);
+	dmabuf->fd = allocation.fd;
+	dmabuf->data = data;
+	dmabuf->size = size;
+
+	buffer = arv_buffer_new_take_data (size, data, dmabuf, _dmabuf_free);
+	buffer->priv->dmabuf_fd = allocation.fd;
+	buffer->priv->memory_type = ARV_BUFFER_MEMORY_TYPE_DMABUF;
+	buffer->priv->memory_handle = allocation.fd;
+
+	return buffer;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "DMA heap allocation not supported");
+
+	return NULL;
+#endif
+}
+
+/**
+ * arv_buffer_new_import:
+ * @size: payload size
+ * @data: (transfer none): CPU address of the imported memory
+ * @memory_type: kind of the imported memory
+ * @memory_handle: memory handle, like a RDMA memory key or a DMA buffer file descriptor
+ * @user_data: (transfer none): a pointer to user data associated to this buffer
+ * @user_data_destroy_func: (nullable): an optional user data destroy callback, which can release the imported
+ * memory
+ *
+ * Creates a new buffer using memory owned by another subsystem, like CUDA pinned host memory, a RDMA registered memory
+ * region or a mapped DMA buffer. The memory type and handle are recorded, and can be retrieved by the consumers of
+ * the buffer using [method@ArvBuffer.get_memory_type] and [method@ArvBuffer.get_memory_handle]. The memory is not
+ * released by the buffer, neither is the DMA buffer file descriptor closed.
+ *
+ * The stream threads write the received payloads directly into the buffer data whenever possible. For pinned and DMA
+ * buffer memory, the GigE Vision stream uses the direct receive mode for the buffer, even if the
+ * #ArvGvStream:direct-receive property is not set, which avoids a staging copy of the data blocks.
+ *
+ * Returns: (transfer full): a new [class@ArvBuffer] object
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_import (size_t size, void *data, ArvBufferMemoryType memory_type, guint64 memory_handle,
+		       void *user_data, GDestroyNotify user_data_destroy_func)
+{
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (data != NULL, NULL);
+	g_return_val_if_fail (memory_type <= ARV_BUFFER_MEMORY_TYPE_DMABUF, NULL);
+
+	buffer = arv_buffer_new_full (size, data, user_data, user_data_destroy_func);
+	buffer->priv->memory_type = memory_type;
+	buffer->priv->memory_handle = memory_handle;
+	if (memory_type == ARV_BUFFER_MEMORY_TYPE_DMABUF)
+		buffer->priv->dmabuf_fd = memory_handle;
+
+	return buffer;
+}
+
 /**
  * arv_buffer_new:
  * @size: payload size
@@ -111,56 +306,609 @@ arv_buffer_new_full (size_t size, void *preallocated, void *user_data, GDestroyN
 ArvBuffer *
 arv_buffer_new (size_t size, void *preallocated)
 {
-	return arv_buffer_new_full (size, preallocated, NULL, NULL);
+	return arv_buffer_new_full (size, preallocated, NULL, NULL);
+}
+
+/**
+ * arv_buffer_new_allocate:
+ * @size: payload size
+ *
+ * Creates a new buffer for the storage of the video stream images.
+ * The data space is allocated by this function, and will
+ * be freed when the buffer is destroyed.
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.2.3
+ */
+
+ArvBuffer *
+arv_buffer_new_allocate (size_t size)
+{
+	return arv_buffer_new_full (size, NULL, NULL, NULL);
+}
+
+/**
+ * arv_buffer_new_chunk_only:
+ * @payload_size: size of the device payloads, as returned by arv_camera_get_payload()
+ * @size: size of the end of the payloads kept in the buffer
+ *
+ * Creates a buffer keeping only the last @size bytes of the payloads, where the chunk data are stored. The stream
+ * skips the copy of the image data, and the chunk values are read as usual, with arv_buffer_get_chunk_data() or an
+ * #ArvChunkParser, from a buffer many times smaller than the payload. The image data is not available, and
+ * @payload_size must be the exact payload size, the chunks being located from the end of the buffer.
+ *
+ * Chunk only buffers are supported by the GigE Vision streams, the other streams reporting a size mismatch. When the
+ * device can send the chunks without the image, usually by disabling the `Image` chunk using
+ * arv_camera_set_chunk_state(), regular buffers of the reduced payload size are preferred, since the link bandwidth
+ * is saved too.
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_chunk_only (size_t payload_size, size_t size)
+{
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (size > 0, NULL);
+
+	size = MIN (size, payload_size);
+
+	buffer = arv_buffer_new_full (size, NULL, NULL, NULL);
+	buffer->priv->window_offset = payload_size - size;
+
+	return buffer;
+}
+
+static ArvBuffer *
+_new_view (ArvBuffer *parent, const ArvBufferRegion *region)
+{
+	ArvBuffer *buffer;
+
+	buffer = arv_buffer_new_take_data (region->size, (void *) region->data, g_object_ref (parent), g_object_unref);
+
+	buffer->priv->status = parent->priv->status;
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->received_size = buffer->priv->allocated_size;
+	buffer->priv->frame_id = parent->priv->frame_id;
+	buffer->priv->timestamp_ns = parent->priv->timestamp_ns;
+	buffer->priv->system_timestamp_ns = parent->priv->system_timestamp_ns;
+	buffer->priv->host_timestamp_ns = parent->priv->host_timestamp_ns;
+	buffer->priv->first_packet_time_us = parent->priv->first_packet_time_us;
+	buffer->priv->last_packet_time_us = parent->priv->last_packet_time_us;
+	buffer->priv->output_time_us = parent->priv->output_time_us;
+	buffer->priv->metadata = parent->priv->metadata;
+	buffer->priv->x_offset = region->x;
+	buffer->priv->y_offset = region->y;
+	buffer->priv->width = region->width;
+	buffer->priv->height = region->height;
+	buffer->priv->x_padding = region->stride -
+		(region->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (region->pixel_format) + 7) / 8;
+	buffer->priv->pixel_format = parent->priv->pixel_format;
+	buffer->priv->memory_type = parent->priv->memory_type;
+	buffer->priv->memory_handle = parent->priv->memory_handle;
+
+	return buffer;
+}
+
+/**
+ * arv_buffer_new_view:
+ * @parent: a #ArvBuffer containing an image
+ * @x: region x offset, relative to the parent image
+ * @y: region y offset, relative to the parent image
+ * @width: region width
+ * @height: region height
+ *
+ * Creates a buffer giving access to a region of the @parent image, without copy. The view data points into the
+ * @parent data, and keeps a reference to @parent until it is destroyed. The view rows are separated by the @parent
+ * row stride, returned by arv_buffer_get_image_stride(). The view image region is reported in the sensor
+ * coordinates, and its status, frame id and timestamps are the ones of @parent.
+ *
+ * A view is meant for the processing of a region of an image, for example by a worker thread, and must not be pushed
+ * to a stream. The horizontal offset of the region must start on a byte boundary.
+ *
+ * Returns: (transfer full): a new #ArvBuffer object, %NULL on invalid region.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_view (ArvBuffer *parent, gint x, gint y, gint width, gint height)
+{
+	ArvBufferRegion region;
+
+	if (!arv_buffer_get_region (parent, x, y, width, height, &region))
+		return NULL;
+
+	return _new_view (parent, &region);
+}
+
+/**
+ * arv_buffer_new_region_view:
+ * @parent: a #ArvBuffer containing a multiple region payload
+ * @index: region index, in the region selector order
+ *
+ * Creates a buffer giving access to a region of a multiple region payload, without copy, like arv_buffer_new_view().
+ * The view rows are contiguous, the regions being packed without padding. See arv_buffer_get_region_by_index().
+ *
+ * Returns: (transfer full): a new #ArvBuffer object, %NULL on invalid index.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_new_region_view (ArvBuffer *parent, guint index)
+{
+	ArvBufferRegion region;
+
+	if (!arv_buffer_get_region_by_index (parent, index, &region))
+		return NULL;
+
+	return _new_view (parent, &region);
+}
+
+/**
+ * arv_buffer_get_region:
+ * @buffer: a #ArvBuffer containing an image
+ * @x: region x offset, relative to the buffer image
+ * @y: region y offset, relative to the buffer image
+ * @width: region width
+ * @height: region height
+ * @region: (out caller-allocates): the region description
+ *
+ * Describes a region of the @buffer image, like arv_buffer_new_view(), but without creating a new object. The
+ * description is filled in caller storage, typically on the stack, which makes it a cheap handle for the workers
+ * processing many regions per frame. Unlike a view, it does not keep a reference to @buffer, and is only valid as
+ * long as @buffer is not pushed back to its stream.
+ *
+ * Returns: %TRUE on success, %FALSE on invalid region.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_get_region (ArvBuffer *buffer, gint x, gint y, gint width, gint height, ArvBufferRegion *region)
+{
+	size_t bits_per_pixel;
+	size_t row_size;
+	size_t stride;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (region != NULL, FALSE);
+	g_return_val_if_fail (arv_buffer_payload_type_has_aoi (buffer->priv->payload_type), FALSE);
+	g_return_val_if_fail (x >= 0 && y >= 0 && width > 0 && height > 0, FALSE);
+	g_return_val_if_fail ((guint) x + width <= buffer->priv->width &&
+			      (guint) y + height <= buffer->priv->height, FALSE);
+
+	bits_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format);
+	g_return_val_if_fail ((x * bits_per_pixel) % 8 == 0, FALSE);
+
+	stride = arv_buffer_get_image_stride (buffer);
+	row_size = (width * bits_per_pixel + 7) / 8;
+	g_return_val_if_fail (stride >= row_size, FALSE);
+
+	region->data = buffer->priv->data + y * stride + x * bits_per_pixel / 8;
+	region->size = (height - 1) * stride + row_size;
+	region->stride = stride;
+	region->frame_id = buffer->priv->frame_id;
+	region->timestamp_ns = buffer->priv->timestamp_ns;
+	region->pixel_format = buffer->priv->pixel_format;
+	region->x = buffer->priv->x_offset + x;
+	region->y = buffer->priv->y_offset + y;
+	region->width = width;
+	region->height = height;
+
+	return TRUE;
+}
+
+/* Sets the region table of a multiple region payload, %NULL for a single region image */
+
+void
+arv_buffer_set_regions (ArvBuffer *buffer, GArray *regions)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (buffer->priv->regions == regions)
+		return;
+
+	g_clear_pointer (&buffer->priv->regions, g_array_unref);
+	if (regions != NULL)
+		buffer->priv->regions = g_array_ref (regions);
+}
+
+/**
+ * arv_buffer_get_n_regions:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns the number of regions of a multiple region payload. The region table is built from the region selector
+ * configuration of the camera when the acquisition is started by arv_camera_start_acquisition(), and attached to
+ * the buffers of its streams. The regions are packed one after the other in the payload, in the region selector
+ * order, each one with its own width and height, and without row padding.
+ *
+ * Returns: the number of regions, 0 if @buffer has no region table.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_get_n_regions (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->regions != NULL ? buffer->priv->regions->len : 0;
+}
+
+/**
+ * arv_buffer_get_region_by_index:
+ * @buffer: a #ArvBuffer containing a multiple region payload
+ * @index: region index, in the region selector order
+ * @region: (out caller-allocates): the region description
+ *
+ * Describes a region of a multiple region payload, see arv_buffer_get_n_regions(). Like for arv_buffer_get_region(),
+ * the description points into the @buffer data, and is only valid as long as @buffer is not pushed back to its
+ * stream.
+ *
+ * Returns: %TRUE on success, %FALSE on invalid index, or if the region data was not received.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_get_region_by_index (ArvBuffer *buffer, guint index, ArvBufferRegion *region)
+{
+	ArvBufferRegionInfos *infos;
+	size_t row_size;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (region != NULL, FALSE);
+
+	if (buffer->priv->regions == NULL || index >= buffer->priv->regions->len)
+		return FALSE;
+
+	infos = &g_array_index (buffer->priv->regions, ArvBufferRegionInfos, index);
+	row_size = ((size_t) infos->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format) + 7) / 8;
+
+	if (row_size == 0 || infos->height == 0 ||
+	    infos->offset + row_size * infos->height > buffer->priv->received_size)
+		return FALSE;
+
+	region->data = buffer->priv->data + infos->offset;
+	region->size = row_size * infos->height;
+	region->stride = row_size;
+	region->frame_id = buffer->priv->frame_id;
+	region->timestamp_ns = buffer->priv->timestamp_ns;
+	region->pixel_format = buffer->priv->pixel_format;
+	region->x = infos->x_offset;
+	region->y = infos->y_offset;
+	region->width = infos->width;
+	region->height = infos->height;
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_get_data:
+ * @buffer: a #ArvBuffer
+ * @size: (allow-none): location to store data size, or %NULL
+ *
+ * Buffer data accessor.
+ *
+ * Returns: (array length=size) (element-type guint8): a pointer to the buffer data.
+ *
+ * Since: 0.4.0
+ **/
+
+const void *
+arv_buffer_get_data (ArvBuffer *buffer, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (size != NULL)
+		*size = buffer->priv->received_size;
+
+	return buffer->priv->data;
+}
+
+/**
+ * arv_buffer_dup_data_bytes:
+ * @buffer: a #ArvBuffer
+ *
+ * Wraps the buffer data in a #GBytes, without copy. The #GBytes holds a reference to @buffer, which must not be
+ * pushed back to a stream, or filled again, as long as the #GBytes is alive.
+ *
+ * Returns: (transfer full): a new #GBytes over the received data.
+ *
+ * Since: 0.8.24
+ */
+
+GBytes *
+arv_buffer_dup_data_bytes (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	return g_bytes_new_with_free_func (buffer->priv->data, buffer->priv->received_size,
+					   g_object_unref, g_object_ref (buffer));
+}
+
+/**
+ * arv_buffer_get_data_address:
+ * @buffer: a #ArvBuffer
+ * @size: (out) (optional): location to store data size, or %NULL
+ *
+ * Gives the address of the buffer data as an integer, for the language bindings that can build a view over foreign
+ * memory without copy, like numpy in python. The caller must keep a reference on @buffer as long as the memory is
+ * accessed.
+ *
+ * Returns: the address of the buffer data.
+ *
+ * Since: 0.8.24
+ */
+
+guintptr
+arv_buffer_get_data_address (ArvBuffer *buffer, size_t *size)
+{
+	return (guintptr) arv_buffer_get_data (buffer, size);
+}
+
+/**
+ * arv_buffer_get_dmabuf_fd:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: the DMA buffer file descriptor of the data of a buffer created with [ctor@ArvBuffer.new_dmabuf], -1
+ * otherwise. The file descriptor is owned by @buffer.
+ *
+ * Since: 0.8.24
+ */
+
+int
+arv_buffer_get_dmabuf_fd (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), -1);
+
+	return buffer->priv->dmabuf_fd;
+}
+
+/**
+ * arv_buffer_get_memory_type:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: the kind of memory holding the buffer data.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBufferMemoryType
+arv_buffer_get_memory_type (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), ARV_BUFFER_MEMORY_TYPE_SYSTEM);
+
+	return buffer->priv->memory_type;
+}
+
+/**
+ * arv_buffer_get_memory_handle:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: the memory handle given to arv_buffer_new_import(), the file descriptor for the DMA heap buffers, 0
+ * otherwise.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_buffer_get_memory_handle (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->memory_handle;
+}
+
+typedef struct ARAVIS_PACKED_STRUCTURE {
+	guint32 id;
+	guint32 size;
+} ArvChunkInfos;
+
+void
+arv_buffer_set_n_parts (ArvBuffer *buffer, guint n_parts)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (n_parts > buffer->priv->n_allocated_parts) {
+		buffer->priv->parts = g_renew (ArvBufferPartInfos, buffer->priv->parts, n_parts);
+		buffer->priv->n_allocated_parts = n_parts;
+	}
+
+	if (n_parts > 0)
+		memset (buffer->priv->parts, 0, n_parts * sizeof (ArvBufferPartInfos));
+
+	buffer->priv->n_parts = n_parts;
+}
+
+/* Multipart payloads use the part descriptor array, single image payloads are exposed as a one part buffer */
+
+static const ArvBufferPartInfos *
+_get_part (ArvBuffer *buffer, guint part_id, ArvBufferPartInfos *single_part)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+		g_return_val_if_fail (part_id < buffer->priv->n_parts, NULL);
+
+		return &buffer->priv->parts[part_id];
+	}
+
+	g_return_val_if_fail (part_id == 0 && arv_buffer_payload_type_has_aoi (buffer->priv->payload_type), NULL);
+
+	memset (single_part, 0, sizeof (ArvBufferPartInfos));
+	single_part->size = buffer->priv->received_size;
+	single_part->data_type = ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE;
+	single_part->pixel_format = buffer->priv->pixel_format;
+	single_part->width = buffer->priv->width;
+	single_part->height = buffer->priv->height;
+	single_part->x_offset = buffer->priv->x_offset;
+	single_part->y_offset = buffer->priv->y_offset;
+	single_part->x_padding = buffer->priv->x_padding;
+
+	return single_part;
+}
+
+/**
+ * arv_buffer_get_n_parts:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the number of parts of a multipart payload. Image payloads are considered as having a single part.
+ *
+ * Returns: the number of parts, 0 if the payload is neither multipart nor image data.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_get_n_parts (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART)
+		return buffer->priv->n_parts;
+
+	return arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) ? 1 : 0;
+}
+
+/**
+ * arv_buffer_get_part_data:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index
+ * @size: (allow-none): location to store part data size, or %NULL
+ *
+ * Part data accessor. The returned pointer points into the buffer data, no copy is made.
+ *
+ * Returns: (array length=size) (element-type guint8): a pointer to the part data.
+ *
+ * Since: 0.8.24
+ */
+
+const void *
+arv_buffer_get_part_data (ArvBuffer *buffer, guint part_id, size_t *size)
+{
+	ArvBufferPartInfos single_part;
+	const ArvBufferPartInfos *part;
+
+	if (size != NULL)
+		*size = 0;
+
+	part = _get_part (buffer, part_id, &single_part);
+	if (part == NULL)
+		return NULL;
+
+	if (size != NULL)
+		*size = part->size;
+
+	return buffer->priv->data + part->data_offset;
+}
+
+/**
+ * arv_buffer_get_part_data_type:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index
+ *
+ * Returns: the data type of the part.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBufferPartDataType
+arv_buffer_get_part_data_type (ArvBuffer *buffer, guint part_id)
+{
+	ArvBufferPartInfos single_part;
+	const ArvBufferPartInfos *part;
+
+	part = _get_part (buffer, part_id, &single_part);
+
+	return part != NULL ? part->data_type : ARV_BUFFER_PART_DATA_TYPE_UNKNOWN;
+}
+
+/**
+ * arv_buffer_get_part_component_id:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index
+ *
+ * Gets the identifier of the part source, which allows to differentiate the parts of a multipart payload, for
+ * example the range, intensity and confidence parts of a 3D camera.
+ *
+ * Returns: the part component identifier.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_get_part_component_id (ArvBuffer *buffer, guint part_id)
+{
+	ArvBufferPartInfos single_part;
+	const ArvBufferPartInfos *part;
+
+	part = _get_part (buffer, part_id, &single_part);
+
+	return part != NULL ? part->component_id : 0;
 }
 
 /**
- * arv_buffer_new_allocate:
- * @size: payload size
- *
- * Creates a new buffer for the storage of the video stream images.
- * The data space is allocated by this function, and will
- * be freed when the buffer is destroyed.
+ * arv_buffer_get_part_pixel_format:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index
  *
- * Returns: a new #ArvBuffer object
+ * Returns: the part pixel format.
  *
- * Since: 0.2.3
+ * Since: 0.8.24
  */
 
-ArvBuffer *
-arv_buffer_new_allocate (size_t size)
+ArvPixelFormat
+arv_buffer_get_part_pixel_format (ArvBuffer *buffer, guint part_id)
 {
-	return arv_buffer_new_full (size, NULL, NULL, NULL);
+	ArvBufferPartInfos single_part;
+	const ArvBufferPartInfos *part;
+
+	part = _get_part (buffer, part_id, &single_part);
+
+	return part != NULL ? part->pixel_format : 0;
 }
 
 /**
- * arv_buffer_get_data:
+ * arv_buffer_get_part_region:
  * @buffer: a #ArvBuffer
- * @size: (allow-none): location to store data size, or %NULL
- *
- * Buffer data accessor.
+ * @part_id: part index
+ * @x: (out) (optional): image x offset placeholder
+ * @y: (out) (optional): image y offset placeholder
+ * @width: (out) (optional): image width placholder
+ * @height: (out) (optional): image height placeholder
  *
- * Returns: (array length=size) (element-type guint8): a pointer to the buffer data.
+ * Gets the image region of a part.
  *
- * Since: 0.4.0
- **/
+ * Since: 0.8.24
+ */
 
-const void *
-arv_buffer_get_data (ArvBuffer *buffer, size_t *size)
+void
+arv_buffer_get_part_region (ArvBuffer *buffer, guint part_id, gint *x, gint *y, gint *width, gint *height)
 {
-	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+	ArvBufferPartInfos single_part;
+	const ArvBufferPartInfos *part;
 
-	if (size != NULL)
-		*size = buffer->priv->received_size;
+	part = _get_part (buffer, part_id, &single_part);
+	if (part == NULL)
+		return;
 
-	return buffer->priv->data;
+	if (x != NULL)
+		*x = part->x_offset;
+	if (y != NULL)
+		*y = part->y_offset;
+	if (width != NULL)
+		*width = part->width;
+	if (height != NULL)
+		*height = part->height;
 }
 
-typedef struct ARAVIS_PACKED_STRUCTURE {
-	guint32 id;
-	guint32 size;
-} ArvChunkInfos;
-
 /**
  * arv_buffer_has_chunks:
  * @buffer: a #ArvBuffer
@@ -204,6 +952,22 @@ arv_buffer_get_chunk_data (ArvBuffer *buffer, guint64 chunk_id, size_t *size)
 	g_return_val_if_fail (arv_buffer_has_chunks (buffer), NULL);
 	g_return_val_if_fail (buffer->priv->data != NULL, NULL);
 
+	if (buffer->priv->has_chunk_index) {
+		guint i;
+
+		for (i = 0; i < buffer->priv->chunks->len; i++) {
+			ArvBufferChunk *chunk = &g_array_index (buffer->priv->chunks, ArvBufferChunk, i);
+
+			if (chunk->id == chunk_id) {
+				if (size != NULL)
+					*size = chunk->size;
+				return &buffer->priv->data[chunk->offset];
+			}
+		}
+
+		return NULL;
+	}
+
 	data = buffer->priv->data;
 	offset = buffer->priv->allocated_size - sizeof (ArvChunkInfos);
 	while (offset > 0) {
@@ -240,6 +1004,61 @@ arv_buffer_get_chunk_data (ArvBuffer *buffer, guint64 chunk_id, size_t *size)
 	return NULL;
 }
 
+/* Called by the stream threads on frame completion, while the trailer is still hot in the cache. The chunk index
+ * replaces the trailer walk of arv_buffer_get_chunk_data(), until the buffer is filled again. */
+
+void
+arv_buffer_update_chunk_index (ArvBuffer *buffer)
+{
+	ArvChunkInfos *infos;
+	unsigned char *data;
+	ptrdiff_t offset;
+
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	buffer->priv->has_chunk_index = FALSE;
+
+	if (!arv_buffer_has_chunks (buffer) || buffer->priv->data == NULL)
+		return;
+
+	if (buffer->priv->chunks == NULL)
+		buffer->priv->chunks = g_array_new (FALSE, FALSE, sizeof (ArvBufferChunk));
+	else
+		g_array_set_size (buffer->priv->chunks, 0);
+
+	data = buffer->priv->data;
+	offset = buffer->priv->allocated_size - sizeof (ArvChunkInfos);
+	while (offset > 0) {
+		ArvBufferChunk chunk;
+		guint32 chunk_size;
+
+		infos = (ArvChunkInfos *) &data[offset];
+
+		if (buffer->priv->chunk_endianness == G_BIG_ENDIAN) {
+			chunk.id = GUINT32_FROM_BE (infos->id);
+			chunk_size = GUINT32_FROM_BE (infos->size);
+		} else {
+			chunk.id = GUINT32_FROM_LE (infos->id);
+			chunk_size = GUINT32_FROM_LE (infos->size);
+		}
+
+		/* An invalid size ends the walk, as in arv_buffer_get_chunk_data() */
+		if (offset - (ptrdiff_t) chunk_size < 0)
+			break;
+
+		chunk.offset = offset - chunk_size;
+		chunk.size = chunk_size;
+		g_array_append_val (buffer->priv->chunks, chunk);
+
+		if (chunk_size > 0)
+			offset = offset - chunk_size - sizeof (ArvChunkInfos);
+		else
+			offset = 0;
+	};
+
+	buffer->priv->has_chunk_index = TRUE;
+}
+
 /**
  * arv_buffer_get_user_data:
  * @buffer: a #ArvBuffer
@@ -377,6 +1196,29 @@ arv_buffer_set_system_timestamp (ArvBuffer *buffer, guint64 timestamp_ns)
 	buffer->priv->system_timestamp_ns = timestamp_ns;
 }
 
+/**
+ * arv_buffer_get_host_timestamp:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the camera timestamp of the buffer, converted to the host real time
+ * clock using a model of the device clock offset and drift. Unlike
+ * arv_buffer_get_system_timestamp(), the returned value doesn't depend on the
+ * transfer and reception latency. The model is only available for GigE Vision
+ * devices opened in controller mode, and needs a few seconds to converge.
+ *
+ * Returns: buffer host timestamp, in nanoseconds, or 0 if not available.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_buffer_get_host_timestamp (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->host_timestamp_ns;
+}
+
 
 /**
  * arv_buffer_get_frame_id:
@@ -397,6 +1239,27 @@ arv_buffer_get_frame_id (ArvBuffer *buffer)
 	return buffer->priv->frame_id;
 }
 
+/**
+ * arv_buffer_has_new_geometry:
+ * @buffer: a #ArvBuffer
+ *
+ * Tells if @buffer is the first successfully received image since a change of the width, the height or the pixel
+ * format, for example after a region of interest change by arv_camera_end_reconfiguration(). The first frame of a
+ * stream is not tagged.
+ *
+ * Returns: %TRUE if the geometry of @buffer differs from the one of the previous image.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_has_new_geometry (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	return buffer->priv->has_new_geometry;
+}
+
 /**
  * arv_buffer_set_frame_id:
  * @buffer: a #ArvBuffer
@@ -415,6 +1278,320 @@ arv_buffer_set_frame_id (ArvBuffer *buffer, guint64 frame_id)
 	buffer->priv->frame_id = frame_id;
 }
 
+/**
+ * arv_buffer_get_metadata:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the per-frame metadata block of @buffer, which gathers the timestamps, the reception times and the transport
+ * counters of the frame. The block is part of the buffer, and its retrieval doesn't allocate memory, which makes it
+ * suitable for a quality check of each frame. It is valid until the buffer is pushed back to the stream.
+ *
+ * Returns: (transfer none): the metadata of @buffer.
+ *
+ * Since: 0.8.24
+ */
+
+const ArvBufferMetadata *
+arv_buffer_get_metadata (ArvBuffer *buffer)
+{
+	ArvBufferMetadata *metadata;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	metadata = &buffer->priv->metadata;
+
+	metadata->size = sizeof (ArvBufferMetadata);
+	metadata->status = buffer->priv->status;
+	metadata->frame_id = buffer->priv->frame_id;
+	metadata->timestamp_ns = buffer->priv->timestamp_ns;
+	metadata->system_timestamp_ns = buffer->priv->system_timestamp_ns;
+	metadata->host_timestamp_ns = buffer->priv->host_timestamp_ns;
+	metadata->first_packet_time_us = buffer->priv->first_packet_time_us;
+	metadata->last_packet_time_us = buffer->priv->last_packet_time_us;
+	metadata->output_time_us = buffer->priv->output_time_us;
+
+	return metadata;
+}
+
+/* Resets the transport counters and the valid range map, before the buffer reuse by a stream */
+
+void
+arv_buffer_clear_metadata (ArvBuffer *buffer)
+{
+	memset (&buffer->priv->metadata, 0, sizeof (ArvBufferMetadata));
+	if (buffer->priv->valid_ranges != NULL)
+		g_array_set_size (buffer->priv->valid_ranges, 0);
+	g_clear_pointer (&buffer->priv->regions, g_array_unref);
+}
+
+/* Appends a range to the valid range map, merged with the last one if contiguous. The ranges are added in increasing
+ * offset order. */
+
+void
+arv_buffer_add_valid_range (ArvBuffer *buffer, size_t offset, size_t size)
+{
+	ArvBufferRange range = {offset, size};
+
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (size == 0)
+		return;
+
+	if (buffer->priv->valid_ranges == NULL)
+		buffer->priv->valid_ranges = g_array_sized_new (FALSE, FALSE, sizeof (ArvBufferRange), 16);
+
+	if (buffer->priv->valid_ranges->len > 0) {
+		ArvBufferRange *last = &g_array_index (buffer->priv->valid_ranges, ArvBufferRange,
+						       buffer->priv->valid_ranges->len - 1);
+
+		g_return_if_fail (offset >= last->offset + last->size);
+
+		if (offset == last->offset + last->size) {
+			last->size += size;
+			return;
+		}
+	}
+
+	g_array_append_val (buffer->priv->valid_ranges, range);
+}
+
+/**
+ * arv_buffer_get_valid_ranges:
+ * @buffer: a #ArvBuffer
+ * @n_ranges: (out): the number of ranges
+ *
+ * Gets the map of the valid data of @buffer, as a list of byte ranges of the buffer data, in increasing offset order.
+ *
+ * For a successfully received buffer, the map is a single range covering the received data. For a GigE Vision image
+ * buffer received with an #ARV_BUFFER_STATUS_MISSING_PACKETS or #ARV_BUFFER_STATUS_TIMEOUT status, the map lists
+ * the data actually received, which lets an application salvage a partial frame instead of discarding it. The content
+ * of the buffer outside of these ranges is undefined, and the received size of the buffer extends to the end of the
+ * last range. No map is available for the other incomplete buffers, like the multipart or chunk only ones.
+ *
+ * Returns: (array length=n_ranges) (transfer none) (nullable): the valid ranges of @buffer, %NULL if the valid data
+ * are unknown or if nothing was received.
+ *
+ * Since: 0.8.24
+ */
+
+const ArvBufferRange *
+arv_buffer_get_valid_ranges (ArvBuffer *buffer, guint *n_ranges)
+{
+	if (n_ranges != NULL)
+		*n_ranges = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+	    (buffer->priv->valid_ranges == NULL || buffer->priv->valid_ranges->len == 0))
+		arv_buffer_add_valid_range (buffer, 0, buffer->priv->received_size);
+
+	if (buffer->priv->valid_ranges == NULL || buffer->priv->valid_ranges->len == 0)
+		return NULL;
+
+	if (n_ranges != NULL)
+		*n_ranges = buffer->priv->valid_ranges->len;
+
+	return (const ArvBufferRange *) buffer->priv->valid_ranges->data;
+}
+
+/**
+ * arv_buffer_get_valid_size:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: the total size of the valid ranges of @buffer, see arv_buffer_get_valid_ranges().
+ *
+ * Since: 0.8.24
+ */
+
+size_t
+arv_buffer_get_valid_size (ArvBuffer *buffer)
+{
+	const ArvBufferRange *ranges;
+	size_t size = 0;
+	guint n_ranges;
+	guint i;
+
+	ranges = arv_buffer_get_valid_ranges (buffer, &n_ranges);
+	for (i = 0; i < n_ranges; i++)
+		size += ranges[i].size;
+
+	return size;
+}
+
+/* Reallocates the data of a buffer owning its memory, if smaller than @size. The content is not preserved, the
+ * buffer being about to be filled by a stream. Returns %FALSE if @buffer is still too small. */
+
+gboolean
+arv_buffer_grow (ArvBuffer *buffer, size_t size)
+{
+	if (buffer->priv->allocated_size >= size)
+		return TRUE;
+
+	if (buffer->priv->is_preallocated ||
+	    buffer->priv->data_destroy_func != NULL ||
+	    buffer->priv->window_offset > 0 ||
+	    buffer->priv->batch_frames != NULL ||
+	    buffer->priv->dmabuf_fd >= 0 ||
+	    buffer->priv->memory_type != ARV_BUFFER_MEMORY_TYPE_SYSTEM)
+		return FALSE;
+
+	if (buffer->priv->is_memory_locked)
+		arv_memory_unlock (buffer->priv->data, buffer->priv->allocated_size);
+	buffer->priv->is_memory_locked = FALSE;
+	buffer->priv->is_memory_prepared = FALSE;
+
+	g_free (buffer->priv->data);
+	buffer->priv->data = g_malloc (size);
+	buffer->priv->allocated_size = size;
+
+	return TRUE;
+}
+
+#define ARV_BUFFER_BATCH_FRAME_ALIGNMENT	64
+
+/* Empties a batch buffer, making it one at the first call */
+
+void
+arv_buffer_batch_reset (ArvBuffer *buffer)
+{
+	if (buffer->priv->batch_frames == NULL)
+		buffer->priv->batch_frames = g_array_sized_new (FALSE, FALSE, sizeof (ArvBufferBatchFrame), 16);
+	else
+		g_array_set_size (buffer->priv->batch_frames, 0);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_RAWDATA;
+	buffer->priv->received_size = 0;
+	buffer->priv->n_parts = 0;
+	buffer->priv->has_chunk_index = FALSE;
+}
+
+/* Copies the data of a successfully received frame at the end of a batch buffer, the frame data being aligned on a
+ * cache line. Returns FALSE if there is not enough room left. */
+
+gboolean
+arv_buffer_batch_append (ArvBuffer *buffer, ArvBuffer *frame)
+{
+	ArvBufferBatchFrame entry;
+	size_t offset;
+	size_t size;
+
+	offset = (buffer->priv->received_size + ARV_BUFFER_BATCH_FRAME_ALIGNMENT - 1) &
+		~((size_t) ARV_BUFFER_BATCH_FRAME_ALIGNMENT - 1);
+	size = frame->priv->status == ARV_BUFFER_STATUS_SUCCESS ? frame->priv->received_size : 0;
+
+	if (offset + size > buffer->priv->allocated_size)
+		return FALSE;
+
+	if (size > 0)
+		memcpy (buffer->priv->data + offset, frame->priv->data, size);
+
+	entry.offset = offset;
+	entry.size = size;
+	entry.frame_id = frame->priv->frame_id;
+	entry.timestamp_ns = frame->priv->timestamp_ns;
+	entry.system_timestamp_ns = frame->priv->system_timestamp_ns;
+	entry.status = frame->priv->status;
+	entry.payload_type = frame->priv->payload_type;
+	entry.pixel_format = frame->priv->pixel_format;
+	entry.x = frame->priv->x_offset;
+	entry.y = frame->priv->y_offset;
+	entry.width = frame->priv->width;
+	entry.height = frame->priv->height;
+	entry.x_padding = frame->priv->x_padding;
+
+	if (buffer->priv->batch_frames->len == 0) {
+		buffer->priv->frame_id = frame->priv->frame_id;
+		buffer->priv->timestamp_ns = frame->priv->timestamp_ns;
+		buffer->priv->system_timestamp_ns = frame->priv->system_timestamp_ns;
+		buffer->priv->host_timestamp_ns = frame->priv->host_timestamp_ns;
+		buffer->priv->first_packet_time_us = frame->priv->first_packet_time_us;
+	}
+	buffer->priv->last_packet_time_us = frame->priv->last_packet_time_us;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->received_size = offset + size;
+
+	g_array_append_val (buffer->priv->batch_frames, entry);
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_get_n_batch_frames:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the number of frames packed in @buffer, when it is a batch buffer output by a stream in frame batching mode, see
+ * arv_stream_set_frame_batching().
+ *
+ * Returns: the number of packed frames, 0 if @buffer is not a batch buffer.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_get_n_batch_frames (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->batch_frames != NULL ? buffer->priv->batch_frames->len : 0;
+}
+
+/**
+ * arv_buffer_get_batch_frame:
+ * @buffer: a batch #ArvBuffer
+ * @index: index of the packed frame
+ *
+ * Gets the index entry of a frame packed in @buffer, the frames being in reception order.
+ *
+ * Returns: (transfer none): the frame description, %NULL if @index is out of range.
+ *
+ * Since: 0.8.24
+ */
+
+const ArvBufferBatchFrame *
+arv_buffer_get_batch_frame (ArvBuffer *buffer, guint index)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (index >= arv_buffer_get_n_batch_frames (buffer))
+		return NULL;
+
+	return &g_array_index (buffer->priv->batch_frames, ArvBufferBatchFrame, index);
+}
+
+/**
+ * arv_buffer_get_batch_frame_data:
+ * @buffer: a batch #ArvBuffer
+ * @index: index of the packed frame
+ * @size: (out) (optional): location to store the frame data size
+ *
+ * Gets the data of a frame packed in @buffer.
+ *
+ * Returns: (array length=size) (element-type guint8) (transfer none): the frame data, %NULL if @index is out of range
+ * or if the frame was not successfully received.
+ *
+ * Since: 0.8.24
+ */
+
+const void *
+arv_buffer_get_batch_frame_data (ArvBuffer *buffer, guint index, size_t *size)
+{
+	const ArvBufferBatchFrame *frame;
+
+	if (size != NULL)
+		*size = 0;
+
+	frame = arv_buffer_get_batch_frame (buffer, index);
+	if (frame == NULL || frame->size == 0)
+		return NULL;
+
+	if (size != NULL)
+		*size = frame->size;
+
+	return buffer->priv->data + frame->offset;
+}
+
 /**
  * arv_buffer_get_image_region:
  * @buffer: a #ArvBuffer
@@ -544,6 +1721,29 @@ arv_buffer_get_image_pixel_format (ArvBuffer *buffer)
 	return buffer->priv->pixel_format;
 }
 
+/**
+ * arv_buffer_get_image_stride:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the distance between the starts of two consecutive image rows, which is larger than the row size for the
+ * views created by arv_buffer_new_view(). This function must only be called on buffer containing a
+ * @ARV_BUFFER_PAYLOAD_TYPE_IMAGE payload.
+ *
+ * Returns: image row stride, in bytes.
+ *
+ * Since: 0.8.24
+ */
+
+size_t
+arv_buffer_get_image_stride (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+	g_return_val_if_fail (arv_buffer_payload_type_has_aoi (buffer->priv->payload_type), 0);
+
+	return ((size_t) buffer->priv->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format) + 7) / 8 +
+		buffer->priv->x_padding;
+}
+
 G_DEFINE_TYPE_WITH_CODE (ArvBuffer, arv_buffer, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvBuffer))
 
 static void
@@ -551,6 +1751,7 @@ arv_buffer_init (ArvBuffer *buffer)
 {
 	buffer->priv = arv_buffer_get_instance_private (buffer);
 	buffer->priv->status = ARV_BUFFER_STATUS_CLEARED;
+	buffer->priv->dmabuf_fd = -1;
 }
 
 static void
@@ -558,7 +1759,14 @@ arv_buffer_finalize (GObject *object)
 {
 	ArvBuffer *buffer = ARV_BUFFER (object);
 
-	if (!buffer->priv->is_preallocated) {
+	if (buffer->priv->is_memory_locked)
+		arv_memory_unlock (buffer->priv->data, buffer->priv->allocated_size);
+
+	if (buffer->priv->data_destroy_func != NULL) {
+		buffer->priv->data_destroy_func (buffer->priv->data_destroy_data);
+		buffer->priv->data = NULL;
+		buffer->priv->allocated_size = 0;
+	} else if (!buffer->priv->is_preallocated) {
 		g_free (buffer->priv->data);
 		buffer->priv->data = NULL;
 		buffer->priv->allocated_size = 0;
@@ -567,6 +1775,16 @@ arv_buffer_finalize (GObject *object)
 	if (buffer->priv->user_data && buffer->priv->user_data_destroy_func)
 		buffer->priv->user_data_destroy_func (buffer->priv->user_data);
 
+	g_clear_pointer (&buffer->priv->chunks, g_array_unref);
+	g_clear_pointer (&buffer->priv->parts, g_free);
+	g_clear_pointer (&buffer->priv->statistics, arv_buffer_statistics_free);
+	g_clear_pointer (&buffer->priv->compressed, arv_buffer_compressed_free);
+	if (buffer->priv->tensor_is_owned)
+		g_free (buffer->priv->tensor_data);
+	g_clear_pointer (&buffer->priv->batch_frames, g_array_unref);
+	g_clear_pointer (&buffer->priv->valid_ranges, g_array_unref);
+	g_clear_pointer (&buffer->priv->regions, g_array_unref);
+
 	G_OBJECT_CLASS (arv_buffer_parent_class)->finalize (object);
 }
 
@@ -32,6 +32,25 @@
 
 G_BEGIN_DECLS
 
+#define ARV_BUFFER_ERROR arv_buffer_error_quark()
+
+ARV_API GQuark		arv_buffer_error_quark		(void);
+
+/**
+ * ArvBufferError:
+ * @ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION: the pixel format conversion is not supported
+ * @ARV_BUFFER_ERROR_INVALID_IMAGE: the buffer image can not be converted
+ * @ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD: the buffer payload can not be decoded
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+	ARV_BUFFER_ERROR_INVALID_IMAGE,
+	ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD
+} ArvBufferError;
+
 /**
  * ArvBufferStatus:
  * @ARV_BUFFER_STATUS_UNKNOWN: unknown status
@@ -69,6 +88,7 @@ typedef enum {
  * @ARV_BUFFER_PAYLOAD_TYPE_JPEG2000: JPEG2000 data
  * @ARV_BUFFER_PAYLOAD_TYPE_H264: h264 data
  * @ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE: multizone image
+ * @ARV_BUFFER_PAYLOAD_TYPE_MULTIPART: multipart data, see [method@ArvBuffer.get_n_parts] (Since: 0.8.24)
  * @ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK: image and chunk data
 */
 
@@ -83,16 +103,240 @@ typedef enum {
 	ARV_BUFFER_PAYLOAD_TYPE_JPEG2000 = 		0x0007,
 	ARV_BUFFER_PAYLOAD_TYPE_H264 = 			0x0008,
 	ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE = 	0x0009,
+	ARV_BUFFER_PAYLOAD_TYPE_MULTIPART =		0x000a,
 	ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK = 	0x4001
 } ArvBufferPayloadType;
 
+/**
+ * ArvBufferPartDataType:
+ * @ARV_BUFFER_PART_DATA_TYPE_UNKNOWN: unknown data type
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE: 2D image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_BIPLANAR: 2D image plane of a biplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_TRIPLANAR: 2D image plane of a triplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_QUADPLANAR: 2D image plane of a quadplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE: 3D image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_BIPLANAR: 3D image plane of a biplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_TRIPLANAR: 3D image plane of a triplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_QUADPLANAR: 3D image plane of a quadplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP: confidence map
+ * @ARV_BUFFER_PART_DATA_TYPE_CHUNK_DATA: chunk data
+ * @ARV_BUFFER_PART_DATA_TYPE_JPEG: JPEG data
+ * @ARV_BUFFER_PART_DATA_TYPE_JPEG2000: JPEG2000 data
+ * @ARV_BUFFER_PART_DATA_TYPE_DEVICE_SPECIFIC: device specific data
+ *
+ * Data type of a buffer part, as defined by the GigE Vision multipart payload.
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_PART_DATA_TYPE_UNKNOWN =		-1,
+	ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE =		0x0001,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_BIPLANAR =	0x0002,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_TRIPLANAR =	0x0003,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_QUADPLANAR =	0x0004,
+	ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE =		0x0005,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_BIPLANAR =	0x0006,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_TRIPLANAR =	0x0007,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_QUADPLANAR =	0x0008,
+	ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP =	0x0009,
+	ARV_BUFFER_PART_DATA_TYPE_CHUNK_DATA =		0x000a,
+	ARV_BUFFER_PART_DATA_TYPE_JPEG =		0x000b,
+	ARV_BUFFER_PART_DATA_TYPE_JPEG2000 =		0x000c,
+	ARV_BUFFER_PART_DATA_TYPE_DEVICE_SPECIFIC =	0x8000
+} ArvBufferPartDataType;
+
+/**
+ * ArvBufferMemoryType:
+ * @ARV_BUFFER_MEMORY_TYPE_SYSTEM: pageable system memory
+ * @ARV_BUFFER_MEMORY_TYPE_PINNED: page-locked host memory registered with a device driver, like CUDA pinned memory or
+ * a RDMA memory region
+ * @ARV_BUFFER_MEMORY_TYPE_DMABUF: mapped DMA buffer, the memory handle being its file descriptor
+ *
+ * Kind of the memory holding the buffer data. In all cases, the data must be accessible from the CPU.
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_MEMORY_TYPE_SYSTEM,
+	ARV_BUFFER_MEMORY_TYPE_PINNED,
+	ARV_BUFFER_MEMORY_TYPE_DMABUF
+} ArvBufferMemoryType;
+
+/**
+ * ArvBufferMetadata:
+ * @size: size of the structure, in bytes
+ * @status: buffer status
+ * @n_resent_packets: number of packets of the frame received after a resend request
+ * @n_missing_packets: number of packets of the frame never received
+ * @n_resend_requested_packets: number of packets of the frame for which a resend was requested
+ * @n_kernel_dropped_packets: number of packets dropped by the kernel while the frame was received, including the packets
+ * of the other frames in flight
+ * @frame_id: buffer frame id
+ * @timestamp_ns: device timestamp, in nanoseconds
+ * @system_timestamp_ns: host system timestamp, in nanoseconds
+ * @host_timestamp_ns: device timestamp converted to the host real time clock, in nanoseconds, 0 if not available
+ * @first_packet_time_us: monotonic time of the reception of the first packet, in µs, 0 if unknown
+ * @last_packet_time_us: monotonic time of the reception of the last packet, in µs, 0 if unknown
+ * @output_time_us: monotonic time of the push of the buffer to the output queue, in µs, 0 if unknown
+ *
+ * Fixed layout block of per-frame metadata, filled by the stream thread and returned by
+ * [method@ArvBuffer.get_metadata]. The packet counters are only maintained by the GigE Vision streams, and are 0 for
+ * the other transports. New fields are only appended, @size telling which ones are present.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint32 size;
+	gint32 status;
+	guint32 n_resent_packets;
+	guint32 n_missing_packets;
+	guint32 n_resend_requested_packets;
+	guint32 n_kernel_dropped_packets;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint64 host_timestamp_ns;
+	guint64 first_packet_time_us;
+	guint64 last_packet_time_us;
+	guint64 output_time_us;
+} ArvBufferMetadata;
+
+/**
+ * ArvBufferBatchFrame:
+ * @offset: offset of the frame data in the batch buffer data
+ * @size: size of the frame data, 0 if the frame was not successfully received
+ * @frame_id: frame id
+ * @timestamp_ns: device timestamp, in nanoseconds
+ * @system_timestamp_ns: host system timestamp, in nanoseconds
+ * @status: frame status, as an #ArvBufferStatus
+ * @payload_type: frame payload type, as an #ArvBufferPayloadType
+ * @pixel_format: image pixel format
+ * @x: image x offset
+ * @y: image y offset
+ * @width: image width
+ * @height: image height
+ * @x_padding: bytes between the end of an image row and the start of the next one
+ *
+ * Index entry of a frame packed in a batch buffer, see arv_stream_set_frame_batching().
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint64 offset;
+	guint64 size;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	gint32 status;
+	gint32 payload_type;
+	guint32 pixel_format;
+	guint32 x;
+	guint32 y;
+	guint32 width;
+	guint32 height;
+	guint32 x_padding;
+} ArvBufferBatchFrame;
+
+/**
+ * ArvBufferRange:
+ * @offset: offset of the range in the buffer data
+ * @size: size of the range
+ *
+ * Byte range of the buffer data, see arv_buffer_get_valid_ranges().
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint64 offset;
+	guint64 size;
+} ArvBufferRange;
+
+/**
+ * ArvBufferRegion:
+ * @data: first byte of the region
+ * @size: size of the region data, from its first byte to the end of its last row
+ * @stride: distance between the starts of two consecutive rows, in bytes
+ * @frame_id: frame id of the buffer
+ * @timestamp_ns: device timestamp of the buffer, in nanoseconds
+ * @pixel_format: image pixel format
+ * @x: region x offset, in sensor coordinates
+ * @y: region y offset, in sensor coordinates
+ * @width: region width
+ * @height: region height
+ *
+ * Description of an image region, filled by arv_buffer_get_region() or arv_buffer_get_region_by_index().
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	const void *data;
+	size_t size;
+	size_t stride;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint32 pixel_format;
+	guint32 x;
+	guint32 y;
+	guint32 width;
+	guint32 height;
+} ArvBufferRegion;
+
+/**
+ * ArvBufferTensorFormat:
+ * @width: tensor width
+ * @height: tensor height
+ * @n_channels: number of channels, 1 for the monochrome images only, or 3 for red, green and blue
+ * @mean: mean of each channel, subtracted from the pixel values scaled to [0, 1]
+ * @std: standard deviation of each channel, dividing the centered values
+ *
+ * Planar float tensor format, see arv_buffer_convert_tensor().
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint32 width;
+	guint32 height;
+	guint32 n_channels;
+	float mean[3];
+	float std[3];
+} ArvBufferTensorFormat;
+
+/**
+ * ArvBufferCompression:
+ * @ARV_BUFFER_COMPRESSION_NONE: no compression
+ * @ARV_BUFFER_COMPRESSION_ZSTD: lossless zstd compression, in independent bands of rows
+ *
+ * Lossless compression of the buffer data, see arv_buffer_compress().
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_COMPRESSION_NONE,
+	ARV_BUFFER_COMPRESSION_ZSTD
+} ArvBufferCompression;
+
 #define ARV_TYPE_BUFFER             (arv_buffer_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvBuffer, arv_buffer, ARV, BUFFER, GObject)
 
 ARV_API ArvBuffer *		arv_buffer_new_allocate		(size_t size);
+ARV_API ArvBuffer *		arv_buffer_new_chunk_only	(size_t payload_size, size_t size);
 ARV_API ArvBuffer *		arv_buffer_new			(size_t size, void *preallocated);
 ARV_API ArvBuffer * 		arv_buffer_new_full		(size_t size, void *preallocated,
 								 void *user_data, GDestroyNotify user_data_destroy_func);
+ARV_API ArvBuffer *		arv_buffer_new_dmabuf		(size_t size, const char *heap_name, GError **error);
+ARV_API ArvBuffer *		arv_buffer_new_view		(ArvBuffer *parent, gint x, gint y, gint width, gint height);
+ARV_API ArvBuffer *		arv_buffer_new_region_view	(ArvBuffer *parent, guint index);
+ARV_API ArvBuffer *		arv_buffer_new_import		(size_t size, void *data,
+								 ArvBufferMemoryType memory_type, guint64 memory_handle,
+								 void *user_data, GDestroyNotify user_data_destroy_func);
 
 ARV_API ArvBufferStatus		arv_buffer_get_status		(ArvBuffer *buffer);
 
@@ -103,20 +347,81 @@ ARV_API guint64			arv_buffer_get_timestamp	(ArvBuffer *buffer);
 ARV_API void			arv_buffer_set_timestamp	(ArvBuffer *buffer, guint64 timestamp_ns);
 ARV_API guint64			arv_buffer_get_system_timestamp	(ArvBuffer *buffer);
 ARV_API void			arv_buffer_set_system_timestamp	(ArvBuffer *buffer, guint64 timestamp_ns);
+ARV_API guint64			arv_buffer_get_host_timestamp	(ArvBuffer *buffer);
 ARV_API void			arv_buffer_set_frame_id		(ArvBuffer *buffer, guint64 frame_id);
 ARV_API guint64 		arv_buffer_get_frame_id		(ArvBuffer *buffer);
+ARV_API gboolean		arv_buffer_has_new_geometry	(ArvBuffer *buffer);
+ARV_API const ArvBufferMetadata *	arv_buffer_get_metadata		(ArvBuffer *buffer);
+ARV_API guint				arv_buffer_get_n_batch_frames	(ArvBuffer *buffer);
+ARV_API const ArvBufferBatchFrame *	arv_buffer_get_batch_frame	(ArvBuffer *buffer, guint index);
+ARV_API const void *			arv_buffer_get_batch_frame_data	(ArvBuffer *buffer, guint index, size_t *size);
+ARV_API const ArvBufferRange *	arv_buffer_get_valid_ranges	(ArvBuffer *buffer, guint *n_ranges);
+ARV_API size_t				arv_buffer_get_valid_size	(ArvBuffer *buffer);
 ARV_API const void *		arv_buffer_get_data		(ArvBuffer *buffer, size_t *size);
+ARV_API GBytes *		arv_buffer_dup_data_bytes	(ArvBuffer *buffer);
+ARV_API guintptr		arv_buffer_get_data_address	(ArvBuffer *buffer, size_t *size);
+ARV_API int			arv_buffer_get_dmabuf_fd	(ArvBuffer *buffer);
+ARV_API ArvBufferMemoryType	arv_buffer_get_memory_type	(ArvBuffer *buffer);
+ARV_API guint64			arv_buffer_get_memory_handle	(ArvBuffer *buffer);
 
 ARV_API void			arv_buffer_get_image_region		(ArvBuffer *buffer, gint *x, gint *y, gint *width, gint *height);
+ARV_API gboolean		arv_buffer_get_region			(ArvBuffer *buffer, gint x, gint y, gint width, gint height,
+									 ArvBufferRegion *region);
+ARV_API guint			arv_buffer_get_n_regions		(ArvBuffer *buffer);
+ARV_API gboolean		arv_buffer_get_region_by_index		(ArvBuffer *buffer, guint index,
+									 ArvBufferRegion *region);
 ARV_API gint			arv_buffer_get_image_width		(ArvBuffer *buffer);
 ARV_API gint			arv_buffer_get_image_height		(ArvBuffer *buffer);
 ARV_API gint			arv_buffer_get_image_x			(ArvBuffer *buffer);
 ARV_API gint			arv_buffer_get_image_y			(ArvBuffer *buffer);
 ARV_API ArvPixelFormat		arv_buffer_get_image_pixel_format	(ArvBuffer *buffer);
+ARV_API size_t			arv_buffer_get_image_stride		(ArvBuffer *buffer);
+
+ARV_API guint			arv_buffer_get_n_parts			(ArvBuffer *buffer);
+ARV_API const void *		arv_buffer_get_part_data		(ArvBuffer *buffer, guint part_id, size_t *size);
+ARV_API ArvBufferPartDataType	arv_buffer_get_part_data_type		(ArvBuffer *buffer, guint part_id);
+ARV_API guint			arv_buffer_get_part_component_id	(ArvBuffer *buffer, guint part_id);
+ARV_API ArvPixelFormat		arv_buffer_get_part_pixel_format	(ArvBuffer *buffer, guint part_id);
+ARV_API void			arv_buffer_get_part_region		(ArvBuffer *buffer, guint part_id,
+									 gint *x, gint *y, gint *width, gint *height);
 
 ARV_API gboolean		arv_buffer_has_chunks		(ArvBuffer *buffer);
 ARV_API const void *		arv_buffer_get_chunk_data	(ArvBuffer *buffer, guint64 chunk_id, size_t *size);
 
+ARV_API gboolean		arv_pixel_format_can_convert	(ArvPixelFormat input_format, ArvPixelFormat output_format);
+ARV_API gboolean		arv_buffer_convert		(ArvBuffer *buffer, ArvPixelFormat format,
+								 void *data, size_t stride, GError **error);
+ARV_API gboolean		arv_buffer_convert_part_rows	(ArvBuffer *buffer, guint part_id, ArvPixelFormat format,
+								 void *data, size_t stride, guint first_row, guint n_rows,
+								 GError **error);
+ARV_API gboolean		arv_buffer_convert_tensor	(ArvBuffer *buffer, const ArvBufferTensorFormat *format,
+								 float *data, GError **error);
+ARV_API gboolean		arv_buffer_convert_tensor_rows	(ArvBuffer *buffer, const ArvBufferTensorFormat *format,
+								 float *data, guint first_row, guint n_rows,
+								 GError **error);
+ARV_API void			arv_buffer_set_tensor_data	(ArvBuffer *buffer, float *data, size_t size);
+ARV_API const float *		arv_buffer_get_tensor_data	(ArvBuffer *buffer, size_t *size);
+
+ARV_API size_t			arv_buffer_get_decimated_size	(ArvBuffer *buffer, guint factor, gboolean debayer);
+ARV_API gboolean		arv_buffer_decimate		(ArvBuffer *buffer, ArvBuffer *output, guint factor,
+								 gboolean debayer, GError **error);
+
+ARV_API gboolean		arv_buffer_decode		(ArvBuffer *buffer, ArvBuffer *output, GError **error);
+
+ARV_API gboolean		arv_buffer_compress		(ArvBuffer *buffer, ArvBufferCompression compression,
+								 GError **error);
+ARV_API const void *		arv_buffer_get_compressed_data	(ArvBuffer *buffer, ArvBufferCompression *compression,
+								 size_t *size);
+
+ARV_API gboolean		arv_buffer_has_statistics		(ArvBuffer *buffer);
+ARV_API guint			arv_buffer_get_statistics_n_channels	(ArvBuffer *buffer);
+ARV_API const guint32 *		arv_buffer_get_statistics_histogram	(ArvBuffer *buffer, guint channel, guint *n_bins);
+ARV_API double			arv_buffer_get_statistics_mean		(ArvBuffer *buffer, guint channel);
+ARV_API gboolean		arv_buffer_get_statistics_range		(ArvBuffer *buffer, guint channel,
+									 guint *minimum, guint *maximum);
+ARV_API guint64			arv_buffer_get_statistics_n_saturated	(ArvBuffer *buffer, guint channel);
+ARV_API const double *		arv_buffer_get_statistics_grid_means	(ArvBuffer *buffer, guint *grid_size);
+
 G_END_DECLS
 
 #endif
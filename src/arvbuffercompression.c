@@ -0,0 +1,554 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Lossless compression of the buffer data, for the recording of the images.
+ *
+ * The image is split in bands of rows, compressed in parallel by a shared thread pool into independent zstd frames,
+ * which also allows a parallel decompression. The rows of the 8 and 16 bit pixel formats are first replaced by the
+ * difference between consecutive pixels, which makes the smooth industrial images much more compressible. The
+ * compressed data is kept with the buffer, in a block aligned allocation reused by the following frames.
+ */
+
+#include <arvbuffer.h>
+#include <arvbufferprivate.h>
+#include <arvfeatures.h>
+#include <arvdebugprivate.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if ARAVIS_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+/* Minimal size of the bands, below which the thread synchronization costs more than it gains */
+#define ARV_BUFFER_COMPRESSION_MIN_BAND_SIZE	(256 * 1024)
+#define ARV_BUFFER_COMPRESSION_ALIGNMENT	4096
+#define ARV_BUFFER_COMPRESSION_ZSTD_LEVEL	1
+
+/* Byte range of a band in the uncompressed data. The rows are evenly distributed between the bands, the last one
+ * including the data following the rows, like the chunks. */
+
+static void
+_get_band_extent (const ArvBufferCompressed *compressed, guint band, size_t *offset, size_t *size)
+{
+	size_t end;
+
+	if (compressed->n_rows == 0) {
+		*offset = 0;
+		*size = compressed->uncompressed_size;
+		return;
+	}
+
+	*offset = (size_t) (band * (guint64) compressed->n_rows / compressed->n_bands) * compressed->row_stride;
+	end = band + 1 == compressed->n_bands ?
+		compressed->uncompressed_size :
+		(size_t) ((band + 1) * (guint64) compressed->n_rows / compressed->n_bands) * compressed->row_stride;
+	*size = end - *offset;
+}
+
+static size_t
+_get_band_n_filtered_rows (const ArvBufferCompressed *compressed, guint band)
+{
+	return ((band + 1) * (guint64) compressed->n_rows / compressed->n_bands) -
+		(band * (guint64) compressed->n_rows / compressed->n_bands);
+}
+
+/* Written without loop carried dependency, for the compiler to vectorize it */
+
+static void
+_delta_filter_rows (const void *input, void *output, size_t n_rows, size_t stride, guint bytes_per_pixel)
+{
+	size_t row, i;
+
+	for (row = 0; row < n_rows; row++) {
+		if (bytes_per_pixel == 2) {
+			const guint16 * restrict in = (const guint16 *) ((const guint8 *) input + row * stride);
+			guint16 * restrict out = (guint16 *) ((guint8 *) output + row * stride);
+			size_t n_pixels = stride / 2;
+
+			out[0] = in[0];
+			for (i = 1; i < n_pixels; i++)
+				out[i] = in[i] - in[i - 1];
+		} else {
+			const guint8 * restrict in = (const guint8 *) input + row * stride;
+			guint8 * restrict out = (guint8 *) output + row * stride;
+
+			out[0] = in[0];
+			for (i = 1; i < stride; i++)
+				out[i] = in[i] - in[i - 1];
+		}
+	}
+}
+
+static void
+_delta_unfilter_rows (void *data, size_t n_rows, size_t stride, guint bytes_per_pixel)
+{
+	size_t row, i;
+
+	for (row = 0; row < n_rows; row++) {
+		if (bytes_per_pixel == 2) {
+			guint16 *pixels = (guint16 *) ((guint8 *) data + row * stride);
+
+			for (i = 1; i < stride / 2; i++)
+				pixels[i] += pixels[i - 1];
+		} else {
+			guint8 *pixels = (guint8 *) data + row * stride;
+
+			for (i = 1; i < stride; i++)
+				pixels[i] += pixels[i - 1];
+		}
+	}
+}
+
+#if ARAVIS_HAS_ZSTD
+
+typedef struct {
+	GMutex mutex;
+	GCond cond;
+	guint n_pending_bands;
+} ArvBufferCompressionTask;
+
+typedef struct {
+	const ArvBufferCompressed *compressed;
+	const guint8 *input;
+	guint index;
+
+	/* Band area of the output, compacted once all the bands are done */
+	guint8 *output;
+	size_t output_capacity;
+	size_t output_size;
+
+	ArvBufferCompressionTask *task;
+} ArvBufferCompressionBand;
+
+typedef struct {
+	void *data;
+	size_t size;
+} ArvBufferCompressionScratch;
+
+static void
+_free_scratch (gpointer data)
+{
+	ArvBufferCompressionScratch *scratch = data;
+
+	g_free (scratch->data);
+	g_free (scratch);
+}
+
+static void
+_free_compression_context (gpointer data)
+{
+	ZSTD_freeCCtx (data);
+}
+
+static GPrivate compression_context = G_PRIVATE_INIT (_free_compression_context);
+static GPrivate compression_scratch = G_PRIVATE_INIT (_free_scratch);
+
+static void *
+_get_scratch (size_t size)
+{
+	ArvBufferCompressionScratch *scratch = g_private_get (&compression_scratch);
+
+	if (scratch == NULL) {
+		scratch = g_new0 (ArvBufferCompressionScratch, 1);
+		g_private_set (&compression_scratch, scratch);
+	}
+
+	if (scratch->size < size) {
+		g_free (scratch->data);
+		scratch->data = g_malloc (size);
+		scratch->size = size;
+	}
+
+	return scratch->data;
+}
+
+static void
+_compress_band (ArvBufferCompressionBand *band)
+{
+	const ArvBufferCompressed *compressed = band->compressed;
+	ZSTD_CCtx *context = g_private_get (&compression_context);
+	const guint8 *input;
+	size_t offset, size;
+	size_t result;
+
+	if (context == NULL) {
+		context = ZSTD_createCCtx ();
+		g_private_set (&compression_context, context);
+	}
+
+	_get_band_extent (compressed, band->index, &offset, &size);
+	input = band->input + offset;
+
+	if (compressed->filter == ARV_BUFFER_COMPRESSION_FILTER_DELTA) {
+		guint8 *filtered = _get_scratch (size);
+		size_t filtered_size = _get_band_n_filtered_rows (compressed, band->index) * compressed->row_stride;
+
+		_delta_filter_rows (input, filtered, _get_band_n_filtered_rows (compressed, band->index),
+				    compressed->row_stride, compressed->bytes_per_pixel);
+		memcpy (filtered + filtered_size, input + filtered_size, size - filtered_size);
+		input = filtered;
+	}
+
+	result = ZSTD_compressCCtx (context, band->output, band->output_capacity, input, size,
+				    ARV_BUFFER_COMPRESSION_ZSTD_LEVEL);
+	band->output_size = ZSTD_isError (result) ? 0 : result;
+}
+
+static void
+_band_worker_func (gpointer data, gpointer user_data)
+{
+	ArvBufferCompressionBand *band = data;
+
+	_compress_band (band);
+
+	g_mutex_lock (&band->task->mutex);
+	band->task->n_pending_bands--;
+	if (band->task->n_pending_bands == 0)
+		g_cond_signal (&band->task->cond);
+	g_mutex_unlock (&band->task->mutex);
+}
+
+static GThreadPool *
+_get_band_pool (void)
+{
+	static gsize pool = 0;
+
+	if (g_once_init_enter (&pool)) {
+		GThreadPool *band_pool;
+
+		band_pool = g_thread_pool_new (_band_worker_func, NULL, g_get_num_processors (), FALSE, NULL);
+		g_once_init_leave (&pool, (gsize) band_pool);
+	}
+
+	return (GThreadPool *) pool;
+}
+
+static gboolean
+_ensure_output (ArvBufferCompressed *compressed, size_t size)
+{
+	if (compressed->allocated_size >= size)
+		return TRUE;
+
+#ifdef G_OS_UNIX
+	free (compressed->data);
+	compressed->allocated_size = 0;
+	if (posix_memalign (&compressed->data, ARV_BUFFER_COMPRESSION_ALIGNMENT, size) != 0) {
+		compressed->data = NULL;
+		return FALSE;
+	}
+#else
+	g_free (compressed->data);
+	compressed->data = g_malloc (size);
+#endif
+	compressed->allocated_size = size;
+
+	return TRUE;
+}
+
+#endif
+
+/**
+ * arv_buffer_compress:
+ * @buffer: a successfully received #ArvBuffer
+ * @compression: the compression algorithm
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Compresses the data of @buffer, keeping the result with the buffer, without modifying its data. The compressed data
+ * is written by [class@ArvRecorder] in place of the raw data, and is invalidated when the buffer is pushed back to its
+ * stream. The image is split in bands of rows compressed in parallel, the rows of the 8 and 16 bit pixel formats being
+ * delta filtered first. Multipart payloads are not supported.
+ *
+ * This function is meant to be called from a stream stage, see arv_stream_add_compression_stage().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_compress (ArvBuffer *buffer, ArvBufferCompression compression, GError **error)
+{
+#if ARAVIS_HAS_ZSTD
+	ArvBufferPrivate *priv;
+	ArvBufferCompressed *compressed;
+	ArvBufferCompressionBand bands[ARV_BUFFER_COMPRESSION_MAX_BANDS];
+	ArvBufferCompressionTask task;
+	size_t capacity = 0;
+	size_t bits_per_pixel;
+	guint n_bands;
+	guint i;
+#endif
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (buffer->priv->compressed != NULL)
+		buffer->priv->compressed->is_valid = FALSE;
+
+	if (compression == ARV_BUFFER_COMPRESSION_NONE)
+		return TRUE;
+
+	if (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS || buffer->priv->data == NULL ||
+	    buffer->priv->received_size == 0) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Buffer is not complete (status %d)", buffer->priv->status);
+		return FALSE;
+	}
+
+	if (buffer->priv->n_parts > 0) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+			     "Compression of multipart payloads not supported");
+		return FALSE;
+	}
+
+#if ARAVIS_HAS_ZSTD
+	priv = buffer->priv;
+	if (priv->compressed == NULL)
+		priv->compressed = g_new0 (ArvBufferCompressed, 1);
+	compressed = priv->compressed;
+
+	compressed->compression = compression;
+	compressed->uncompressed_size = priv->received_size;
+	compressed->filter = ARV_BUFFER_COMPRESSION_FILTER_NONE;
+	compressed->bytes_per_pixel = 0;
+	compressed->n_rows = 0;
+	compressed->row_stride = 0;
+
+	if (arv_buffer_payload_type_has_aoi (priv->payload_type) && priv->height > 0) {
+		size_t stride = arv_buffer_get_image_stride (buffer);
+
+		if (stride > 0 && stride * priv->height <= priv->received_size) {
+			compressed->n_rows = priv->height;
+			compressed->row_stride = stride;
+
+			bits_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (priv->pixel_format);
+			if ((bits_per_pixel == 8 || bits_per_pixel == 16) && stride % (bits_per_pixel / 8) == 0 &&
+			    (guintptr) priv->data % (bits_per_pixel / 8) == 0) {
+				compressed->filter = ARV_BUFFER_COMPRESSION_FILTER_DELTA;
+				compressed->bytes_per_pixel = bits_per_pixel / 8;
+			}
+		}
+	}
+
+	n_bands = priv->received_size / ARV_BUFFER_COMPRESSION_MIN_BAND_SIZE;
+	n_bands = MIN (n_bands, g_get_num_processors ());
+	n_bands = MIN (n_bands, ARV_BUFFER_COMPRESSION_MAX_BANDS);
+	n_bands = MIN (n_bands, compressed->n_rows);
+	compressed->n_bands = MAX (n_bands, 1);
+
+	for (i = 0; i < compressed->n_bands; i++) {
+		size_t offset, size;
+
+		_get_band_extent (compressed, i, &offset, &size);
+		bands[i].compressed = compressed;
+		bands[i].input = priv->data;
+		bands[i].index = i;
+		bands[i].output_capacity = ZSTD_compressBound (size);
+		bands[i].output_size = 0;
+		bands[i].task = &task;
+		capacity += bands[i].output_capacity;
+	}
+
+	if (!_ensure_output (compressed, capacity)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Failed to allocate %zu bytes for the compressed data", capacity);
+		return FALSE;
+	}
+
+	capacity = 0;
+	for (i = 0; i < compressed->n_bands; i++) {
+		bands[i].output = (guint8 *) compressed->data + capacity;
+		capacity += bands[i].output_capacity;
+	}
+
+	g_mutex_init (&task.mutex);
+	g_cond_init (&task.cond);
+	task.n_pending_bands = compressed->n_bands - 1;
+
+	for (i = 1; i < compressed->n_bands; i++)
+		g_thread_pool_push (_get_band_pool (), &bands[i], NULL);
+
+	_compress_band (&bands[0]);
+
+	g_mutex_lock (&task.mutex);
+	while (task.n_pending_bands > 0)
+		g_cond_wait (&task.cond, &task.mutex);
+	g_mutex_unlock (&task.mutex);
+
+	g_mutex_clear (&task.mutex);
+	g_cond_clear (&task.cond);
+
+	compressed->size = 0;
+	for (i = 0; i < compressed->n_bands; i++) {
+		if (bands[i].output_size == 0) {
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+				     "Compression of band %u failed", i);
+			return FALSE;
+		}
+
+		memmove ((guint8 *) compressed->data + compressed->size, bands[i].output, bands[i].output_size);
+		compressed->band_sizes[i] = bands[i].output_size;
+		compressed->size += bands[i].output_size;
+	}
+
+	compressed->is_valid = TRUE;
+
+	arv_debug_misc ("[Buffer::compress] Frame %" G_GUINT64_FORMAT " compressed from %zu to %zu bytes in %u bands",
+			priv->frame_id, priv->received_size, compressed->size, compressed->n_bands);
+
+	return TRUE;
+#else
+	g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+		     "zstd compression support not compiled in");
+	return FALSE;
+#endif
+}
+
+/**
+ * arv_buffer_get_compressed_data:
+ * @buffer: a #ArvBuffer
+ * @compression: (out) (optional): the compression algorithm
+ * @size: (out) (optional): size of the compressed data
+ *
+ * Gets the compressed data of @buffer, computed by arv_buffer_compress(). The data is a sequence of independent
+ * compressed frames, one per band of rows.
+ *
+ * Returns: (transfer none): the compressed data, %NULL if the buffer was not compressed.
+ *
+ * Since: 0.8.24
+ */
+
+const void *
+arv_buffer_get_compressed_data (ArvBuffer *buffer, ArvBufferCompression *compression, size_t *size)
+{
+	const ArvBufferCompressed *compressed;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	compressed = buffer->priv->compressed;
+	if (compressed == NULL || !compressed->is_valid) {
+		if (compression != NULL)
+			*compression = ARV_BUFFER_COMPRESSION_NONE;
+		if (size != NULL)
+			*size = 0;
+		return NULL;
+	}
+
+	if (compression != NULL)
+		*compression = compressed->compression;
+	if (size != NULL)
+		*size = compressed->size;
+
+	return compressed->data;
+}
+
+/* Decompresses the bands described by @compressed from @data to @output, which must be uncompressed_size long. The
+ * layout usually comes from a record header, and is fully checked. */
+
+gboolean
+arv_buffer_decompress (const ArvBufferCompressed *compressed, const void *data, size_t size,
+		       void *output, GError **error)
+{
+#if ARAVIS_HAS_ZSTD
+	const guint8 *input = data;
+	guint64 total_size = 0;
+	guint i;
+#endif
+
+	g_return_val_if_fail (compressed != NULL, FALSE);
+
+	if (compressed->compression != ARV_BUFFER_COMPRESSION_ZSTD) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+			     "Unknown compression %u", compressed->compression);
+		return FALSE;
+	}
+
+#if ARAVIS_HAS_ZSTD
+	if (compressed->n_bands < 1 || compressed->n_bands > ARV_BUFFER_COMPRESSION_MAX_BANDS ||
+	    (compressed->n_rows == 0 && compressed->n_bands != 1) ||
+	    compressed->n_bands > MAX (compressed->n_rows, 1) ||
+	    (guint64) compressed->n_rows * compressed->row_stride > compressed->uncompressed_size ||
+	    (compressed->filter == ARV_BUFFER_COMPRESSION_FILTER_DELTA &&
+	     (compressed->bytes_per_pixel < 1 || compressed->bytes_per_pixel > 2 ||
+	      compressed->row_stride % compressed->bytes_per_pixel != 0 ||
+	      (guintptr) output % compressed->bytes_per_pixel != 0)) ||
+	    compressed->filter > ARV_BUFFER_COMPRESSION_FILTER_DELTA) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE, "Invalid compressed layout");
+		return FALSE;
+	}
+
+	for (i = 0; i < compressed->n_bands; i++)
+		total_size += compressed->band_sizes[i];
+	if (total_size > size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE, "Truncated compressed data");
+		return FALSE;
+	}
+
+	for (i = 0; i < compressed->n_bands; i++) {
+		size_t offset, band_size;
+		size_t result;
+
+		_get_band_extent (compressed, i, &offset, &band_size);
+
+		result = ZSTD_decompress ((guint8 *) output + offset, band_size, input, compressed->band_sizes[i]);
+		if (ZSTD_isError (result) || result != band_size) {
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+				     "Decompression of band %u failed", i);
+			return FALSE;
+		}
+
+		if (compressed->filter == ARV_BUFFER_COMPRESSION_FILTER_DELTA)
+			_delta_unfilter_rows ((guint8 *) output + offset, _get_band_n_filtered_rows (compressed, i),
+					      compressed->row_stride, compressed->bytes_per_pixel);
+
+		input += compressed->band_sizes[i];
+	}
+
+	return TRUE;
+#else
+	g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+		     "zstd compression support not compiled in");
+	return FALSE;
+#endif
+}
+
+void
+arv_buffer_compression_clear (ArvBuffer *buffer)
+{
+	if (buffer->priv->compressed != NULL)
+		buffer->priv->compressed->is_valid = FALSE;
+}
+
+void
+arv_buffer_compressed_free (ArvBufferCompressed *compressed)
+{
+	if (compressed == NULL)
+		return;
+
+#ifdef G_OS_UNIX
+	free (compressed->data);
+#else
+	g_free (compressed->data);
+#endif
+	g_free (compressed);
+}
@@ -0,0 +1,1603 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Pixel format conversion of the buffer images.
+ *
+ * Monochrome and Bayer pixel layouts (8 bit, 16 bit containers, GigE Vision 10/12 bit packed and PFNC 10/12 bit
+ * "p" packed) are first unpacked row by row to 16 bit values, then either stored to a new monochrome or Bayer
+ * layout, or demosaiced using a bilinear interpolation. The 12 bit unpacking, which is the most common packed
+ * layout, has AVX2 and NEON kernels, the AVX2 one being selected at runtime. The other kernels are plain loops on
+ * contiguous rows, left to the compiler auto-vectorization.
+ *
+ * The conversion only reads the buffer, and writes each output row once. The rows of an image can thus be
+ * converted in parallel by several threads, using arv_buffer_convert_part_rows() on disjoint row ranges.
+ *
+ * The conversion to the planar float tensors of the inference engines fuses the unpacking, a full precision
+ * demosaic, an area resize and the normalization, in a single pass over the input rows.
+ *
+ * The decimation averages blocks of pixels, for the previews of the full resolution images.
+ */
+
+#include <arvbuffer.h>
+#include <arvbufferprivate.h>
+#include <string.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define ARV_BUFFER_CONVERT_HAS_AVX2 1
+#include <immintrin.h>
+#else
+#define ARV_BUFFER_CONVERT_HAS_AVX2 0
+#endif
+
+#if defined (__ARM_NEON)
+#define ARV_BUFFER_CONVERT_HAS_NEON 1
+#include <arm_neon.h>
+#else
+#define ARV_BUFFER_CONVERT_HAS_NEON 0
+#endif
+
+typedef enum {
+	ARV_BUFFER_CONVERT_LAYOUT_8,
+	ARV_BUFFER_CONVERT_LAYOUT_16,
+	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,
+	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,
+	ARV_BUFFER_CONVERT_LAYOUT_10P,
+	ARV_BUFFER_CONVERT_LAYOUT_12P,
+	ARV_BUFFER_CONVERT_LAYOUT_RGB_8,
+	ARV_BUFFER_CONVERT_LAYOUT_BGR_8,
+	ARV_BUFFER_CONVERT_LAYOUT_RGBA_8,
+	ARV_BUFFER_CONVERT_LAYOUT_BGRA_8,
+	ARV_BUFFER_CONVERT_LAYOUT_UYVY,
+	ARV_BUFFER_CONVERT_LAYOUT_YUYV
+} ArvBufferConvertLayout;
+
+/* Color filter of the raw layouts */
+
+typedef enum {
+	ARV_BUFFER_CONVERT_FILTER_NONE,
+	ARV_BUFFER_CONVERT_FILTER_MONO,
+	ARV_BUFFER_CONVERT_FILTER_BAYER_GR,
+	ARV_BUFFER_CONVERT_FILTER_BAYER_RG,
+	ARV_BUFFER_CONVERT_FILTER_BAYER_GB,
+	ARV_BUFFER_CONVERT_FILTER_BAYER_BG
+} ArvBufferConvertFilter;
+
+typedef struct {
+	ArvPixelFormat pixel_format;
+	ArvBufferConvertLayout layout;
+	ArvBufferConvertFilter filter;
+	/* Number of significant bits of the raw layouts */
+	guint n_bits;
+} ArvBufferConvertFormat;
+
+static const ArvBufferConvertFormat arv_buffer_convert_formats[] = {
+	{ARV_PIXEL_FORMAT_MONO_8,		ARV_BUFFER_CONVERT_LAYOUT_8,		ARV_BUFFER_CONVERT_FILTER_MONO, 8},
+	{ARV_PIXEL_FORMAT_MONO_10,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_MONO, 10},
+	{ARV_PIXEL_FORMAT_MONO_12,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_MONO, 12},
+	{ARV_PIXEL_FORMAT_MONO_14,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_MONO, 14},
+	{ARV_PIXEL_FORMAT_MONO_16,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_MONO, 16},
+	{ARV_PIXEL_FORMAT_MONO_10_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,	ARV_BUFFER_CONVERT_FILTER_MONO, 10},
+	{ARV_PIXEL_FORMAT_MONO_12_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,	ARV_BUFFER_CONVERT_FILTER_MONO, 12},
+	{ARV_PIXEL_FORMAT_MONO_10P,		ARV_BUFFER_CONVERT_LAYOUT_10P,		ARV_BUFFER_CONVERT_FILTER_MONO, 10},
+	{ARV_PIXEL_FORMAT_MONO_12P,		ARV_BUFFER_CONVERT_LAYOUT_12P,		ARV_BUFFER_CONVERT_FILTER_MONO, 12},
+
+	{ARV_PIXEL_FORMAT_BAYER_GR_8,		ARV_BUFFER_CONVERT_LAYOUT_8,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 8},
+	{ARV_PIXEL_FORMAT_BAYER_RG_8,		ARV_BUFFER_CONVERT_LAYOUT_8,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 8},
+	{ARV_PIXEL_FORMAT_BAYER_GB_8,		ARV_BUFFER_CONVERT_LAYOUT_8,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 8},
+	{ARV_PIXEL_FORMAT_BAYER_BG_8,		ARV_BUFFER_CONVERT_LAYOUT_8,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 8},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 12},
+	{ARV_PIXEL_FORMAT_BAYER_GR_16,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 16},
+	{ARV_PIXEL_FORMAT_BAYER_RG_16,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 16},
+	{ARV_PIXEL_FORMAT_BAYER_GB_16,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 16},
+	{ARV_PIXEL_FORMAT_BAYER_BG_16,		ARV_BUFFER_CONVERT_LAYOUT_16,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 16},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_10_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_12_PACKED,	ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 12},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10P,		ARV_BUFFER_CONVERT_LAYOUT_10P,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10P,		ARV_BUFFER_CONVERT_LAYOUT_10P,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10P,		ARV_BUFFER_CONVERT_LAYOUT_10P,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10P,		ARV_BUFFER_CONVERT_LAYOUT_10P,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12P,		ARV_BUFFER_CONVERT_LAYOUT_12P,		ARV_BUFFER_CONVERT_FILTER_BAYER_GR, 12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12P,		ARV_BUFFER_CONVERT_LAYOUT_12P,		ARV_BUFFER_CONVERT_FILTER_BAYER_RG, 12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12P,		ARV_BUFFER_CONVERT_LAYOUT_12P,		ARV_BUFFER_CONVERT_FILTER_BAYER_GB, 12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12P,		ARV_BUFFER_CONVERT_LAYOUT_12P,		ARV_BUFFER_CONVERT_FILTER_BAYER_BG, 12},
+
+	{ARV_PIXEL_FORMAT_RGB_8_PACKED,		ARV_BUFFER_CONVERT_LAYOUT_RGB_8,	ARV_BUFFER_CONVERT_FILTER_NONE, 8},
+	{ARV_PIXEL_FORMAT_BGR_8_PACKED,		ARV_BUFFER_CONVERT_LAYOUT_BGR_8,	ARV_BUFFER_CONVERT_FILTER_NONE, 8},
+	{ARV_PIXEL_FORMAT_RGBA_8_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_RGBA_8,	ARV_BUFFER_CONVERT_FILTER_NONE, 8},
+	{ARV_PIXEL_FORMAT_BGRA_8_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_BGRA_8,	ARV_BUFFER_CONVERT_FILTER_NONE, 8},
+	{ARV_PIXEL_FORMAT_YUV_422_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_UYVY,		ARV_BUFFER_CONVERT_FILTER_NONE, 8},
+	{ARV_PIXEL_FORMAT_YUV_422_YUYV_PACKED,	ARV_BUFFER_CONVERT_LAYOUT_YUYV,		ARV_BUFFER_CONVERT_FILTER_NONE, 8}
+};
+
+static const ArvBufferConvertFormat *
+_find_format (ArvPixelFormat pixel_format)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_buffer_convert_formats); i++)
+		if (arv_buffer_convert_formats[i].pixel_format == pixel_format)
+			return &arv_buffer_convert_formats[i];
+
+	return NULL;
+}
+
+static gboolean
+_is_raw (const ArvBufferConvertFormat *format)
+{
+	return format->filter != ARV_BUFFER_CONVERT_FILTER_NONE;
+}
+
+static gboolean
+_is_rgb (const ArvBufferConvertFormat *format)
+{
+	return format->layout == ARV_BUFFER_CONVERT_LAYOUT_RGB_8 ||
+		format->layout == ARV_BUFFER_CONVERT_LAYOUT_BGR_8 ||
+		format->layout == ARV_BUFFER_CONVERT_LAYOUT_RGBA_8 ||
+		format->layout == ARV_BUFFER_CONVERT_LAYOUT_BGRA_8;
+}
+
+/* Only unpacked layouts are written */
+
+static gboolean
+_is_supported (const ArvBufferConvertFormat *input, const ArvBufferConvertFormat *output)
+{
+	if (input == NULL || output == NULL)
+		return FALSE;
+
+	if (_is_rgb (output))
+		return TRUE;
+
+	return _is_raw (input) &&
+		input->filter == output->filter &&
+		(output->layout == ARV_BUFFER_CONVERT_LAYOUT_8 || output->layout == ARV_BUFFER_CONVERT_LAYOUT_16);
+}
+
+/* Raw row unpacking, to 16 bit values of n_bits significant bits */
+
+static void
+_unpack_8 (const guint8 *src, guint width, guint16 *dst)
+{
+	guint i;
+
+	for (i = 0; i < width; i++)
+		dst[i] = src[i];
+}
+
+static void
+_unpack_16 (const guint8 *src, guint width, guint16 *dst)
+{
+	guint i;
+
+	for (i = 0; i < width; i++)
+		dst[i] = src[2 * i] | (src[2 * i + 1] << 8);
+}
+
+/* GigE Vision 10 bit packed: 2 pixels in 3 bytes, the low bits of both pixels in the middle byte */
+
+static void
+_unpack_10_packed (const guint8 *src, guint width, guint16 *dst)
+{
+	guint i;
+
+	for (i = 0; i + 1 < width; i += 2, src += 3) {
+		dst[i] = (src[0] << 2) | (src[1] & 0x03);
+		dst[i + 1] = (src[2] << 2) | ((src[1] >> 4) & 0x03);
+	}
+}
+
+/* PFNC 10 bit "p": 4 pixels in 5 bytes, least significant bits first */
+
+static void
+_unpack_10p (const guint8 *src, guint width, guint16 *dst)
+{
+	guint i;
+
+	for (i = 0; i + 3 < width; i += 4, src += 5) {
+		dst[i] = src[0] | ((src[1] & 0x03) << 8);
+		dst[i + 1] = (src[1] >> 2) | ((src[2] & 0x0f) << 6);
+		dst[i + 2] = (src[2] >> 4) | ((src[3] & 0x3f) << 4);
+		dst[i + 3] = (src[3] >> 6) | (src[4] << 2);
+	}
+}
+
+/*
+ * 12 bit layouts store 2 pixels in 3 bytes b0, b1 and b2:
+ *
+ * GigE Vision 12 bit packed: p0 = b0 << 4 | (b1 & 0xf), p1 = b2 << 4 | b1 >> 4
+ * PFNC 12 bit "p":           p0 = b0 | (b1 & 0xf) << 8, p1 = b1 >> 4 | b2 << 4
+ *
+ * Once the bytes of a pixel pair are arranged in a 32 bit word v ([b1 b0 b1 b2] for GigE Vision, [b0 b1 b1 b2] for
+ * PFNC, least significant byte first), the two pixels are (v & mask_a) | ((v >> 4) & mask_b), in the little endian
+ * 16 bit order.
+ */
+
+#define ARV_BUFFER_CONVERT_12_PACKED_MASK_A	0x0000000f
+#define ARV_BUFFER_CONVERT_12_PACKED_MASK_B	0x0fff0ff0
+#define ARV_BUFFER_CONVERT_12P_MASK_A		0x00000fff
+#define ARV_BUFFER_CONVERT_12P_MASK_B		0x0fff0000
+
+#if ARV_BUFFER_CONVERT_HAS_AVX2
+
+static gboolean
+_cpu_has_avx2 (void)
+{
+	static gsize has_avx2 = 0;
+
+	if (g_once_init_enter (&has_avx2)) {
+		__builtin_cpu_init ();
+		g_once_init_leave (&has_avx2, __builtin_cpu_supports ("avx2") ? 2 : 1);
+	}
+
+	return has_avx2 == 2;
+}
+
+/* 8 pixel pairs per iteration, each 128 bit lane handling 12 input bytes. The 16 byte loads read 4 bytes past the
+ * last used one, hence the 2 extra pairs required at the end of the row. Returns the number of unpacked pairs. */
+
+__attribute__ ((target ("avx2")))
+static guint
+_unpack_12_avx2 (const guint8 *src, guint n_pairs, guint16 *dst, gboolean is_pfnc)
+{
+	const __m256i shuffle = is_pfnc ?
+		_mm256_setr_epi8 (0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+				  0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11) :
+		_mm256_setr_epi8 (1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11,
+				  1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11);
+	const __m256i mask_a = _mm256_set1_epi32 (is_pfnc ?
+						  ARV_BUFFER_CONVERT_12P_MASK_A :
+						  ARV_BUFFER_CONVERT_12_PACKED_MASK_A);
+	const __m256i mask_b = _mm256_set1_epi32 (is_pfnc ?
+						  ARV_BUFFER_CONVERT_12P_MASK_B :
+						  ARV_BUFFER_CONVERT_12_PACKED_MASK_B);
+	guint i;
+
+	for (i = 0; i + 10 <= n_pairs; i += 8) {
+		__m128i low = _mm_loadu_si128 ((const __m128i *) (src + 3 * i));
+		__m128i high = _mm_loadu_si128 ((const __m128i *) (src + 3 * i + 12));
+		__m256i v;
+
+		v = _mm256_inserti128_si256 (_mm256_castsi128_si256 (low), high, 1);
+		v = _mm256_shuffle_epi8 (v, shuffle);
+		v = _mm256_or_si256 (_mm256_and_si256 (v, mask_a),
+				     _mm256_and_si256 (_mm256_srli_epi32 (v, 4), mask_b));
+		_mm256_storeu_si256 ((__m256i *) (dst + 2 * i), v);
+	}
+
+	return i;
+}
+
+#endif
+
+#if ARV_BUFFER_CONVERT_HAS_NEON
+
+static guint
+_unpack_12_neon (const guint8 *src, guint n_pairs, guint16 *dst, gboolean is_pfnc)
+{
+	const uint16x8_t low_nibble = vdupq_n_u16 (0x0f);
+	guint i;
+
+	for (i = 0; i + 8 <= n_pairs; i += 8) {
+		uint8x8x3_t bytes = vld3_u8 (src + 3 * i);
+		uint16x8_t b0 = vmovl_u8 (bytes.val[0]);
+		uint16x8_t b1 = vmovl_u8 (bytes.val[1]);
+		uint16x8_t b2 = vmovl_u8 (bytes.val[2]);
+		uint16x8x2_t pixels;
+
+		if (is_pfnc) {
+			pixels.val[0] = vorrq_u16 (b0, vshlq_n_u16 (vandq_u16 (b1, low_nibble), 8));
+			pixels.val[1] = vorrq_u16 (vshrq_n_u16 (b1, 4), vshlq_n_u16 (b2, 4));
+		} else {
+			pixels.val[0] = vorrq_u16 (vshlq_n_u16 (b0, 4), vandq_u16 (b1, low_nibble));
+			pixels.val[1] = vorrq_u16 (vshlq_n_u16 (b2, 4), vshrq_n_u16 (b1, 4));
+		}
+
+		vst2q_u16 (dst + 2 * i, pixels);
+	}
+
+	return i;
+}
+
+#endif
+
+static void
+_unpack_12 (const guint8 *src, guint width, guint16 *dst, gboolean is_pfnc)
+{
+	guint32 mask_a = is_pfnc ? ARV_BUFFER_CONVERT_12P_MASK_A : ARV_BUFFER_CONVERT_12_PACKED_MASK_A;
+	guint32 mask_b = is_pfnc ? ARV_BUFFER_CONVERT_12P_MASK_B : ARV_BUFFER_CONVERT_12_PACKED_MASK_B;
+	guint n_pairs = width / 2;
+	guint i = 0;
+
+#if ARV_BUFFER_CONVERT_HAS_AVX2
+	if (_cpu_has_avx2 ())
+		i = _unpack_12_avx2 (src, n_pairs, dst, is_pfnc);
+#elif ARV_BUFFER_CONVERT_HAS_NEON
+	i = _unpack_12_neon (src, n_pairs, dst, is_pfnc);
+#endif
+
+	for (; i < n_pairs; i++) {
+		const guint8 *bytes = src + 3 * i;
+		guint32 v;
+
+		v = (is_pfnc ? bytes[0] : bytes[1]) |
+			((is_pfnc ? bytes[1] : bytes[0]) << 8) |
+			(bytes[1] << 16) |
+			((guint32) bytes[2] << 24);
+		v = (v & mask_a) | ((v >> 4) & mask_b);
+
+		dst[2 * i] = v & 0xffff;
+		dst[2 * i + 1] = v >> 16;
+	}
+}
+
+static void
+_unpack_row (const ArvBufferConvertFormat *format, const guint8 *src, guint width, guint16 *dst)
+{
+	switch (format->layout) {
+		case ARV_BUFFER_CONVERT_LAYOUT_8:
+			_unpack_8 (src, width, dst);
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_16:
+			_unpack_16 (src, width, dst);
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_10_PACKED:
+			_unpack_10_packed (src, width, dst);
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_12_PACKED:
+			_unpack_12 (src, width, dst, FALSE);
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_10P:
+			_unpack_10p (src, width, dst);
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_12P:
+			_unpack_12 (src, width, dst, TRUE);
+			break;
+		default:
+			g_assert_not_reached ();
+	}
+}
+
+/* Raw row reduced to 8 bits, without an intermediate unpacking for the 8 bit layouts */
+
+static const guint8 *
+_get_row_8 (const ArvBufferConvertFormat *format, const guint8 *src, guint width, guint16 *unpacked, guint8 *dst)
+{
+	guint shift = format->n_bits - 8;
+	guint i;
+
+	if (format->layout == ARV_BUFFER_CONVERT_LAYOUT_8)
+		return src;
+
+	_unpack_row (format, src, width, unpacked);
+	for (i = 0; i < width; i++)
+		dst[i] = unpacked[i] >> shift;
+
+	return dst;
+}
+
+static void
+_store_raw_row (const ArvBufferConvertFormat *input, const ArvBufferConvertFormat *output,
+		const guint8 *src, guint width, guint16 *unpacked, guint8 *dst)
+{
+	guint i;
+
+	if (output->layout == ARV_BUFFER_CONVERT_LAYOUT_8) {
+		const guint8 *row = _get_row_8 (input, src, width, unpacked, dst);
+
+		if (row != dst)
+			memcpy (dst, row, width);
+		return;
+	}
+
+	if (output->n_bits == input->n_bits && G_BYTE_ORDER == G_LITTLE_ENDIAN) {
+		/* Direct unpacking to the output row */
+		_unpack_row (input, src, width, (guint16 *) dst);
+		return;
+	}
+
+	_unpack_row (input, src, width, unpacked);
+
+	if (output->n_bits >= input->n_bits) {
+		guint shift = output->n_bits - input->n_bits;
+
+		for (i = 0; i < width; i++)
+			unpacked[i] <<= shift;
+	} else {
+		guint shift = input->n_bits - output->n_bits;
+
+		for (i = 0; i < width; i++)
+			unpacked[i] >>= shift;
+	}
+
+	for (i = 0; i < width; i++) {
+		dst[2 * i] = unpacked[i] & 0xff;
+		dst[2 * i + 1] = unpacked[i] >> 8;
+	}
+}
+
+/* RGB outputs */
+
+typedef struct {
+	guint n_channels;
+	guint red;
+	guint green;
+	guint blue;
+} ArvBufferConvertChannels;
+
+static void
+_get_channels (const ArvBufferConvertFormat *format, ArvBufferConvertChannels *channels)
+{
+	gboolean is_bgr = format->layout == ARV_BUFFER_CONVERT_LAYOUT_BGR_8 ||
+		format->layout == ARV_BUFFER_CONVERT_LAYOUT_BGRA_8;
+
+	channels->n_channels = (format->layout == ARV_BUFFER_CONVERT_LAYOUT_RGBA_8 ||
+				format->layout == ARV_BUFFER_CONVERT_LAYOUT_BGRA_8) ? 4 : 3;
+	channels->red = is_bgr ? 2 : 0;
+	channels->green = 1;
+	channels->blue = is_bgr ? 0 : 2;
+}
+
+static void
+_mono_to_rgb_row (const guint8 *src, guint width, const ArvBufferConvertChannels *channels, guint8 *dst)
+{
+	guint i;
+
+	for (i = 0; i < width; i++, dst += channels->n_channels) {
+		dst[0] = dst[1] = dst[2] = src[i];
+		if (channels->n_channels == 4)
+			dst[3] = 0xff;
+	}
+}
+
+static void
+_rgb_to_rgb_row (const ArvBufferConvertFormat *input, const guint8 *src, guint width,
+		 const ArvBufferConvertChannels *channels, guint8 *dst)
+{
+	ArvBufferConvertChannels input_channels;
+	guint i;
+
+	_get_channels (input, &input_channels);
+
+	for (i = 0; i < width; i++, src += input_channels.n_channels, dst += channels->n_channels) {
+		dst[channels->red] = src[input_channels.red];
+		dst[channels->green] = src[input_channels.green];
+		dst[channels->blue] = src[input_channels.blue];
+		if (channels->n_channels == 4)
+			dst[3] = input_channels.n_channels == 4 ? src[3] : 0xff;
+	}
+}
+
+/* ITU-R BT.601, limited range */
+
+static inline guint8
+_clamp_8 (int value)
+{
+	return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static void
+_yuv422_to_rgb_row (const ArvBufferConvertFormat *input, const guint8 *src, guint width,
+		    const ArvBufferConvertChannels *channels, guint8 *dst)
+{
+	gboolean is_uyvy = input->layout == ARV_BUFFER_CONVERT_LAYOUT_UYVY;
+	guint i;
+
+	for (i = 0; i + 1 < width; i += 2, src += 4) {
+		int y0 = (is_uyvy ? src[1] : src[0]) - 16;
+		int y1 = (is_uyvy ? src[3] : src[2]) - 16;
+		int u = (is_uyvy ? src[0] : src[1]) - 128;
+		int v = (is_uyvy ? src[2] : src[3]) - 128;
+		int red = 409 * v + 128;
+		int green = -100 * u - 208 * v + 128;
+		int blue = 516 * u + 128;
+
+		dst[channels->red] = _clamp_8 ((298 * y0 + red) >> 8);
+		dst[channels->green] = _clamp_8 ((298 * y0 + green) >> 8);
+		dst[channels->blue] = _clamp_8 ((298 * y0 + blue) >> 8);
+		if (channels->n_channels == 4)
+			dst[3] = 0xff;
+		dst += channels->n_channels;
+
+		dst[channels->red] = _clamp_8 ((298 * y1 + red) >> 8);
+		dst[channels->green] = _clamp_8 ((298 * y1 + green) >> 8);
+		dst[channels->blue] = _clamp_8 ((298 * y1 + blue) >> 8);
+		if (channels->n_channels == 4)
+			dst[3] = 0xff;
+		dst += channels->n_channels;
+	}
+}
+
+/* Position of the red pixel in the 2x2 pattern */
+
+static void
+_get_red_phase (ArvBufferConvertFilter filter, guint *red_x, guint *red_y)
+{
+	switch (filter) {
+		case ARV_BUFFER_CONVERT_FILTER_BAYER_GR: *red_x = 1; *red_y = 0; break;
+		case ARV_BUFFER_CONVERT_FILTER_BAYER_RG: *red_x = 0; *red_y = 0; break;
+		case ARV_BUFFER_CONVERT_FILTER_BAYER_GB: *red_x = 0; *red_y = 1; break;
+		default: *red_x = 1; *red_y = 1; break;
+	}
+}
+
+/* Bilinear demosaic of a row, using the rows above and below. The image borders are mirrored, which keeps the
+ * color filter phase of the neighbours. */
+
+static void
+_demosaic_row (ArvBufferConvertFilter filter, guint y,
+	       const guint8 *above, const guint8 *row, const guint8 *below, guint width,
+	       const ArvBufferConvertChannels *channels, guint8 *dst)
+{
+	guint red_x, red_y;
+	guint i;
+
+	_get_red_phase (filter, &red_x, &red_y);
+
+	for (i = 0; i < width; i++, dst += channels->n_channels) {
+		guint left = i > 0 ? i - 1 : 1;
+		guint right = i + 1 < width ? i + 1 : width - 2;
+		gboolean is_red_row = (y & 1) == red_y;
+		gboolean is_red_column = (i & 1) == red_x;
+		guint8 center = row[i];
+		guint8 horizontal = (row[left] + row[right] + 1) >> 1;
+		guint8 vertical = (above[i] + below[i] + 1) >> 1;
+		guint8 red, green, blue;
+
+		if (is_red_row && is_red_column) {
+			red = center;
+			green = (row[left] + row[right] + above[i] + below[i] + 2) >> 2;
+			blue = (above[left] + above[right] + below[left] + below[right] + 2) >> 2;
+		} else if (!is_red_row && !is_red_column) {
+			blue = center;
+			green = (row[left] + row[right] + above[i] + below[i] + 2) >> 2;
+			red = (above[left] + above[right] + below[left] + below[right] + 2) >> 2;
+		} else if (is_red_row) {
+			green = center;
+			red = horizontal;
+			blue = vertical;
+		} else {
+			green = center;
+			red = vertical;
+			blue = horizontal;
+		}
+
+		dst[channels->red] = red;
+		dst[channels->green] = green;
+		dst[channels->blue] = blue;
+		if (channels->n_channels == 4)
+			dst[3] = 0xff;
+	}
+}
+
+/* 8 bit rows of a raw image, the last three being cached for the demosaic */
+
+typedef struct {
+	const ArvBufferConvertFormat *format;
+	const guint8 *data;
+	size_t stride;
+	guint width;
+
+	guint16 *unpacked;
+	guint8 *rows[3];
+	gint row_ids[3];
+	const guint8 *row_data[3];
+} ArvBufferConvertRows;
+
+static const guint8 *
+_get_cached_row (ArvBufferConvertRows *rows, guint y)
+{
+	guint slot = y % 3;
+
+	if (rows->row_ids[slot] != (gint) y) {
+		rows->row_data[slot] = _get_row_8 (rows->format, rows->data + y * rows->stride, rows->width,
+						   rows->unpacked, rows->rows[slot]);
+		rows->row_ids[slot] = y;
+	}
+
+	return rows->row_data[slot];
+}
+
+/* Unpacked rows of a raw image, the last three being cached for the demosaic, and the channel rows of the tensor
+ * conversion */
+
+typedef struct {
+	const ArvBufferConvertFormat *format;
+	const guint8 *data;
+	size_t stride;
+	guint width;
+	guint height;
+
+	guint16 *rows[3];
+	gint row_ids[3];
+	guint16 *planes[3];
+} ArvBufferTensorRows;
+
+static const guint16 *
+_get_cached_unpacked_row (ArvBufferTensorRows *rows, guint y)
+{
+	guint slot = y % 3;
+
+	if (rows->row_ids[slot] != (gint) y) {
+		_unpack_row (rows->format, rows->data + y * rows->stride, rows->width, rows->rows[slot]);
+		rows->row_ids[slot] = y;
+	}
+
+	return rows->rows[slot];
+}
+
+/* Same demosaic as _demosaic_row(), at full precision and to planar rows */
+
+static void
+_demosaic_row_planar (ArvBufferConvertFilter filter, guint y,
+		      const guint16 *above, const guint16 *row, const guint16 *below, guint width,
+		      guint16 *red, guint16 *green, guint16 *blue)
+{
+	guint red_x, red_y;
+	guint i;
+
+	_get_red_phase (filter, &red_x, &red_y);
+
+	for (i = 0; i < width; i++) {
+		guint left = i > 0 ? i - 1 : 1;
+		guint right = i + 1 < width ? i + 1 : width - 2;
+		gboolean is_red_row = (y & 1) == red_y;
+		gboolean is_red_column = (i & 1) == red_x;
+		guint16 cross = (row[left] + row[right] + above[i] + below[i] + 2) >> 2;
+		guint16 diagonal = (above[left] + above[right] + below[left] + below[right] + 2) >> 2;
+		guint16 horizontal = (row[left] + row[right] + 1) >> 1;
+		guint16 vertical = (above[i] + below[i] + 1) >> 1;
+
+		if (is_red_row && is_red_column) {
+			red[i] = row[i];
+			green[i] = cross;
+			blue[i] = diagonal;
+		} else if (!is_red_row && !is_red_column) {
+			red[i] = diagonal;
+			green[i] = cross;
+			blue[i] = row[i];
+		} else if (is_red_row) {
+			red[i] = horizontal;
+			green[i] = row[i];
+			blue[i] = vertical;
+		} else {
+			red[i] = vertical;
+			green[i] = row[i];
+			blue[i] = horizontal;
+		}
+	}
+}
+
+/* Red, green and blue rows of an input row, the three pointing to the same row for the monochrome images */
+
+static void
+_get_tensor_row (ArvBufferTensorRows *rows, guint y, const guint16 **planes)
+{
+	const ArvBufferConvertFormat *format = rows->format;
+	guint i;
+
+	if (format->filter == ARV_BUFFER_CONVERT_FILTER_MONO) {
+		planes[0] = planes[1] = planes[2] = _get_cached_unpacked_row (rows, y);
+		return;
+	}
+
+	if (_is_raw (format)) {
+		guint above = y > 0 ? y - 1 : 1;
+		guint below = y + 1 < rows->height ? y + 1 : rows->height - 2;
+
+		/* The cache slots of the three rows are distinct, as they are consecutive or mirrored */
+		_demosaic_row_planar (format->filter, y,
+				      _get_cached_unpacked_row (rows, above),
+				      _get_cached_unpacked_row (rows, y),
+				      _get_cached_unpacked_row (rows, below),
+				      rows->width, rows->planes[0], rows->planes[1], rows->planes[2]);
+	} else {
+		ArvBufferConvertChannels channels;
+		const guint8 *src = rows->data + y * rows->stride;
+
+		_get_channels (format, &channels);
+		for (i = 0; i < rows->width; i++, src += channels.n_channels) {
+			rows->planes[0][i] = src[channels.red];
+			rows->planes[1][i] = src[channels.green];
+			rows->planes[2][i] = src[channels.blue];
+		}
+	}
+
+	for (i = 0; i < 3; i++)
+		planes[i] = rows->planes[i];
+}
+
+/* Unpacking of the packed raw formats during the stream reception. The pixels of the packed layouts are stored by
+ * groups of n_group_pixels pixels in n_group_bytes bytes, unpacked to 16 bit values in the host byte order. */
+
+gboolean
+arv_pixel_format_get_unpacking (ArvPixelFormat pixel_format, ArvPixelFormat *unpacked_format,
+				guint *n_group_bytes, guint *n_group_pixels)
+{
+	const ArvBufferConvertFormat *format = _find_format (pixel_format);
+	guint i;
+
+	/* The unpacked formats are little endian */
+	if (format == NULL || G_BYTE_ORDER != G_LITTLE_ENDIAN)
+		return FALSE;
+
+	switch (format->layout) {
+		case ARV_BUFFER_CONVERT_LAYOUT_10_PACKED:
+		case ARV_BUFFER_CONVERT_LAYOUT_12_PACKED:
+		case ARV_BUFFER_CONVERT_LAYOUT_12P:
+			if (n_group_bytes != NULL)
+				*n_group_bytes = 3;
+			if (n_group_pixels != NULL)
+				*n_group_pixels = 2;
+			break;
+		case ARV_BUFFER_CONVERT_LAYOUT_10P:
+			if (n_group_bytes != NULL)
+				*n_group_bytes = 5;
+			if (n_group_pixels != NULL)
+				*n_group_pixels = 4;
+			break;
+		default:
+			return FALSE;
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (arv_buffer_convert_formats); i++)
+		if (arv_buffer_convert_formats[i].layout == ARV_BUFFER_CONVERT_LAYOUT_16 &&
+		    arv_buffer_convert_formats[i].filter == format->filter &&
+		    arv_buffer_convert_formats[i].n_bits == format->n_bits) {
+			if (unpacked_format != NULL)
+				*unpacked_format = arv_buffer_convert_formats[i].pixel_format;
+			return TRUE;
+		}
+
+	return FALSE;
+}
+
+void
+arv_buffer_unpack_pixel_groups (ArvPixelFormat pixel_format, const void *data, size_t n_groups, void *unpacked)
+{
+	const ArvBufferConvertFormat *format = _find_format (pixel_format);
+	guint n_group_pixels;
+
+	g_return_if_fail (arv_pixel_format_get_unpacking (pixel_format, NULL, NULL, &n_group_pixels));
+
+	_unpack_row (format, data, n_groups * n_group_pixels, unpacked);
+}
+
+#define ARV_BUFFER_UNPACK_CHUNK_GROUPS		512
+
+/*
+ * Unpacks in place the packed image of a buffer, from its end to its start. The output of a group chunk never
+ * overlaps the input of the previous groups, and the chunk input is copied to a small scratch buffer, which
+ * protects it from the chunk output.
+ */
+
+gboolean
+arv_buffer_unpack_pixels (ArvBuffer *buffer)
+{
+	guint8 scratch[ARV_BUFFER_UNPACK_CHUNK_GROUPS * 5];
+	ArvPixelFormat unpacked_format;
+	guint n_group_bytes, n_group_pixels;
+	size_t n_groups;
+	size_t group;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
+	    !arv_pixel_format_get_unpacking (buffer->priv->pixel_format, &unpacked_format,
+					     &n_group_bytes, &n_group_pixels))
+		return FALSE;
+
+	n_groups = MIN (buffer->priv->received_size,
+			(size_t) buffer->priv->width * buffer->priv->height *
+			ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format) / 8) / n_group_bytes;
+	if (n_groups * n_group_pixels * 2 > buffer->priv->allocated_size)
+		return FALSE;
+
+	group = n_groups;
+	while (group > 0) {
+		size_t n_chunk_groups = MIN (group, ARV_BUFFER_UNPACK_CHUNK_GROUPS);
+
+		group -= n_chunk_groups;
+		memcpy (scratch, buffer->priv->data + group * n_group_bytes, n_chunk_groups * n_group_bytes);
+		arv_buffer_unpack_pixel_groups (buffer->priv->pixel_format, scratch, n_chunk_groups,
+						buffer->priv->data + group * n_group_pixels * 2);
+	}
+
+	buffer->priv->pixel_format = unpacked_format;
+	buffer->priv->received_size = n_groups * n_group_pixels * 2;
+
+	return TRUE;
+}
+
+/* Data, row stride and size of an image part, checked against the received data */
+
+static gboolean
+_get_input_image (ArvBuffer *buffer, guint part_id, const ArvBufferConvertFormat *input,
+		  const guint8 **input_data, size_t *input_stride, gint *width, gint *height, GError **error)
+{
+	size_t input_size;
+	size_t input_row_size;
+
+	*input_data = arv_buffer_get_part_data (buffer, part_id, &input_size);
+	arv_buffer_get_part_region (buffer, part_id, NULL, NULL, width, height);
+
+	if (*width < 2 || *height < 2 ||
+	    (*width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (input->pixel_format)) % 8 != 0 ||
+	    ((input->layout == ARV_BUFFER_CONVERT_LAYOUT_UYVY || input->layout == ARV_BUFFER_CONVERT_LAYOUT_YUYV) &&
+	     (*width & 1) != 0)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid image size (%d x %d)", *width, *height);
+		return FALSE;
+	}
+
+	input_row_size = *width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (input->pixel_format) / 8;
+	*input_stride = input_row_size + (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ?
+					  buffer->priv->parts[part_id].x_padding :
+					  buffer->priv->x_padding);
+	if (*input_data == NULL || input_size < *input_stride * (*height - 1) + input_row_size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Incomplete image data (%" G_GSIZE_FORMAT " bytes instead of %" G_GSIZE_FORMAT ")",
+			     input_size, *input_stride * (*height - 1) + input_row_size);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_pixel_format_can_convert:
+ * @input_format: a pixel format
+ * @output_format: a pixel format
+ *
+ * Checks if the images of @input_format can be converted to @output_format using arv_buffer_convert(). The
+ * supported output formats are 8 bit RGB, BGR, RGBA and BGRA (from monochrome, Bayer, RGB and YUV 4:2:2 formats),
+ * and the unpacked monochrome and Bayer formats of the same color filter, which allows to unpack the 10 and 12 bit
+ * packed formats.
+ *
+ * Returns: %TRUE if the conversion is supported.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_pixel_format_can_convert (ArvPixelFormat input_format, ArvPixelFormat output_format)
+{
+	return _is_supported (_find_format (input_format), _find_format (output_format));
+}
+
+/**
+ * arv_buffer_convert_part_rows:
+ * @buffer: a #ArvBuffer
+ * @part_id: image part index, 0 for image payloads
+ * @format: output pixel format
+ * @data: (out caller-allocates): output image, at least @n_rows * @stride bytes after the @first_row offset
+ * @stride: output row stride in bytes, 0 for the minimal stride
+ * @first_row: index of the first converted row
+ * @n_rows: number of converted rows
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the rows @first_row to @first_row + @n_rows - 1 of a buffer image part to @format. The output row y is
+ * written at @data + y * @stride, @data pointing to the full output image. This function only reads @buffer, the
+ * conversion of an image can be split between several threads working on disjoint row ranges.
+ *
+ * The width of the packed images must correspond to a whole number of bytes per row. The input row stride is taken
+ * into account, which allows the conversion of the views created by arv_buffer_new_view().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_convert_part_rows (ArvBuffer *buffer, guint part_id, ArvPixelFormat format,
+			      void *data, size_t stride, guint first_row, guint n_rows, GError **error)
+{
+	const ArvBufferConvertFormat *input;
+	const ArvBufferConvertFormat *output;
+	ArvBufferConvertChannels channels;
+	ArvBufferConvertRows rows;
+	const guint8 *input_data;
+	size_t input_stride;
+	gint width, height;
+	guint output_pixel_size;
+	guint y;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+
+	if (part_id >= arv_buffer_get_n_parts (buffer)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE, "No image part %u", part_id);
+		return FALSE;
+	}
+
+	input = _find_format (arv_buffer_get_part_pixel_format (buffer, part_id));
+	output = _find_format (format);
+	if (!_is_supported (input, output)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Unsupported conversion from pixel format 0x%08x to 0x%08x",
+			     arv_buffer_get_part_pixel_format (buffer, part_id), format);
+		return FALSE;
+	}
+
+	if (!_get_input_image (buffer, part_id, input, &input_data, &input_stride, &width, &height, error))
+		return FALSE;
+
+	if (first_row > (guint) height || n_rows > (guint) height - first_row) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid row range (%u rows from row %u, image height %d)", n_rows, first_row, height);
+		return FALSE;
+	}
+
+	output_pixel_size = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (output->pixel_format) / 8;
+	if (stride == 0)
+		stride = width * output_pixel_size;
+	g_return_val_if_fail (stride >= width * output_pixel_size, FALSE);
+
+	rows.format = input;
+	rows.data = input_data;
+	rows.stride = input_stride;
+	rows.width = width;
+	rows.unpacked = g_new (guint16, width);
+	rows.rows[0] = g_malloc (3 * width);
+	rows.rows[1] = rows.rows[0] + width;
+	rows.rows[2] = rows.rows[1] + width;
+	rows.row_ids[0] = rows.row_ids[1] = rows.row_ids[2] = -1;
+
+	if (_is_rgb (output))
+		_get_channels (output, &channels);
+
+	for (y = first_row; y < first_row + n_rows; y++) {
+		const guint8 *src = input_data + y * input_stride;
+		guint8 *dst = (guint8 *) data + y * stride;
+
+		if (!_is_rgb (output)) {
+			_store_raw_row (input, output, src, width, rows.unpacked, dst);
+		} else if (input->filter == ARV_BUFFER_CONVERT_FILTER_MONO) {
+			_mono_to_rgb_row (_get_cached_row (&rows, y), width, &channels, dst);
+		} else if (_is_raw (input)) {
+			guint above = y > 0 ? y - 1 : 1;
+			guint below = y + 1 < (guint) height ? y + 1 : (guint) height - 2;
+
+			/* The cache slots of the three rows are distinct, as they are consecutive or mirrored */
+			_demosaic_row (input->filter, y,
+				       _get_cached_row (&rows, above),
+				       _get_cached_row (&rows, y),
+				       _get_cached_row (&rows, below),
+				       width, &channels, dst);
+		} else if (_is_rgb (input)) {
+			_rgb_to_rgb_row (input, src, width, &channels, dst);
+		} else {
+			_yuv422_to_rgb_row (input, src, width, &channels, dst);
+		}
+	}
+
+	g_free (rows.rows[0]);
+	g_free (rows.unpacked);
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_convert:
+ * @buffer: a #ArvBuffer
+ * @format: output pixel format
+ * @data: (out caller-allocates): output image, at least image height * @stride bytes
+ * @stride: output row stride in bytes, 0 for the minimal stride
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the image of @buffer, or the first part of a multipart payload, to @format. See
+ * arv_pixel_format_can_convert() for the supported conversions, and arv_buffer_convert_part_rows() for the
+ * conversion of a row range.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_convert (ArvBuffer *buffer, ArvPixelFormat format, void *data, size_t stride, GError **error)
+{
+	gint height = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (arv_buffer_get_n_parts (buffer) > 0)
+		arv_buffer_get_part_region (buffer, 0, NULL, NULL, NULL, &height);
+
+	return arv_buffer_convert_part_rows (buffer, 0, format, data, stride, 0, height, error);
+}
+
+/**
+ * arv_buffer_convert_tensor_rows:
+ * @buffer: a #ArvBuffer
+ * @format: tensor format
+ * @data: (out caller-allocates): output tensor, at least @format->n_channels * @format->height * @format->width
+ * floats
+ * @first_row: index of the first converted tensor row
+ * @n_rows: number of converted tensor rows
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the image of @buffer, or the first part of a multipart payload, to the rows @first_row to @first_row +
+ * @n_rows - 1 of a planar float tensor, in the CHW layout of the inference engines. The channel c of the tensor row
+ * y is written at @data + (c * @format->height + y) * @format->width.
+ *
+ * The monochrome, Bayer and 8 bit RGB images are supported, the Bayer images being demosaiced at full precision.
+ * The monochrome images are replicated to the 3 channel tensors. The image is resized to the tensor size by
+ * averaging the input pixels covered by each output pixel, and the pixel values, scaled to [0, 1], are normalized
+ * using the mean and standard deviation of each channel. All the steps are done in a single pass over the input
+ * rows. Like arv_buffer_convert_part_rows(), the conversion can be split between several threads working on
+ * disjoint row ranges.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_convert_tensor_rows (ArvBuffer *buffer, const ArvBufferTensorFormat *format, float *data,
+				guint first_row, guint n_rows, GError **error)
+{
+	const ArvBufferConvertFormat *input;
+	ArvBufferTensorRows rows;
+	const guint8 *input_data;
+	size_t input_stride;
+	size_t plane_size;
+	gint width, height;
+	guint *x_starts;
+	guint *x_ends;
+	float *x_scales;
+	float *sums;
+	guint max_value;
+	guint c, i, x, y, oy;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (format != NULL, FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+
+	if (format->width == 0 || format->height == 0 || (format->n_channels != 1 && format->n_channels != 3)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid tensor format (%u x %u, %u channels)",
+			     format->width, format->height, format->n_channels);
+		return FALSE;
+	}
+
+	for (c = 0; c < format->n_channels; c++) {
+		if (format->std[c] == 0.0f) {
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+				     "Null standard deviation for tensor channel %u", c);
+			return FALSE;
+		}
+	}
+
+	if (first_row > format->height || n_rows > format->height - first_row) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid row range (%u rows from row %u, tensor height %u)",
+			     n_rows, first_row, format->height);
+		return FALSE;
+	}
+
+	if (arv_buffer_get_n_parts (buffer) < 1) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE, "No image part 0");
+		return FALSE;
+	}
+
+	input = _find_format (arv_buffer_get_part_pixel_format (buffer, 0));
+	if (input == NULL || !(_is_raw (input) || _is_rgb (input)) ||
+	    (format->n_channels == 1 && input->filter != ARV_BUFFER_CONVERT_FILTER_MONO)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Unsupported conversion from pixel format 0x%08x to a %u channel tensor",
+			     arv_buffer_get_part_pixel_format (buffer, 0), format->n_channels);
+		return FALSE;
+	}
+
+	if (!_get_input_image (buffer, 0, input, &input_data, &input_stride, &width, &height, error))
+		return FALSE;
+
+	rows.format = input;
+	rows.data = input_data;
+	rows.stride = input_stride;
+	rows.width = width;
+	rows.height = height;
+	rows.rows[0] = g_new (guint16, 6 * width);
+	for (i = 0; i < 3; i++) {
+		rows.rows[i] = rows.rows[0] + i * width;
+		rows.planes[i] = rows.rows[0] + (3 + i) * width;
+		rows.row_ids[i] = -1;
+	}
+
+	/* Input columns covered by each output column, at least one for the upscaling */
+	x_starts = g_new (guint, 2 * format->width);
+	x_ends = x_starts + format->width;
+	x_scales = g_new (float, format->width);
+	for (x = 0; x < format->width; x++) {
+		x_starts[x] = (guint64) x * width / format->width;
+		x_ends[x] = MAX ((guint64) (x + 1) * width / format->width, x_starts[x] + 1);
+		x_scales[x] = 1.0f / (x_ends[x] - x_starts[x]);
+	}
+
+	sums = g_new (float, format->n_channels * format->width);
+	max_value = (1U << input->n_bits) - 1;
+	plane_size = (size_t) format->width * format->height;
+
+	for (oy = first_row; oy < first_row + n_rows; oy++) {
+		guint y_start = (guint64) oy * height / format->height;
+		guint y_end = MAX ((guint64) (oy + 1) * height / format->height, y_start + 1);
+
+		memset (sums, 0, format->n_channels * format->width * sizeof (float));
+
+		for (y = y_start; y < y_end; y++) {
+			const guint16 *planes[3];
+
+			_get_tensor_row (&rows, y, planes);
+
+			for (c = 0; c < format->n_channels; c++) {
+				const guint16 *plane = planes[c];
+				float *channel_sums = sums + c * format->width;
+
+				for (x = 0; x < format->width; x++) {
+					guint32 sum = 0;
+
+					for (i = x_starts[x]; i < x_ends[x]; i++)
+						sum += plane[i];
+					channel_sums[x] += sum;
+				}
+			}
+		}
+
+		for (c = 0; c < format->n_channels; c++) {
+			const float *channel_sums = sums + c * format->width;
+			float *dst = data + c * plane_size + (size_t) oy * format->width;
+			float scale = 1.0f / ((float) (y_end - y_start) * max_value * format->std[c]);
+			float offset = -format->mean[c] / format->std[c];
+
+			for (x = 0; x < format->width; x++)
+				dst[x] = channel_sums[x] * x_scales[x] * scale + offset;
+		}
+	}
+
+	g_free (sums);
+	g_free (x_scales);
+	g_free (x_starts);
+	g_free (rows.rows[0]);
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_convert_tensor:
+ * @buffer: a #ArvBuffer
+ * @format: tensor format
+ * @data: (out caller-allocates): output tensor, at least @format->n_channels * @format->height * @format->width
+ * floats
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the image of @buffer to a planar float tensor, see arv_buffer_convert_tensor_rows().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_convert_tensor (ArvBuffer *buffer, const ArvBufferTensorFormat *format, float *data, GError **error)
+{
+	g_return_val_if_fail (format != NULL, FALSE);
+
+	return arv_buffer_convert_tensor_rows (buffer, format, data, 0, format->height, error);
+}
+
+/**
+ * arv_buffer_set_tensor_data:
+ * @buffer: a #ArvBuffer
+ * @data: (transfer none) (nullable): tensor memory, %NULL to let the tensor stage allocate it
+ * @size: size of @data, in bytes
+ *
+ * Sets the memory receiving the tensor computed by the stream stage added by arv_stream_add_tensor_stage(), for
+ * example pinned memory for the transfers to a GPU. @data must stay valid until it is replaced, or @buffer is
+ * destroyed.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_buffer_set_tensor_data (ArvBuffer *buffer, float *data, size_t size)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (buffer->priv->tensor_is_owned)
+		g_free (buffer->priv->tensor_data);
+
+	buffer->priv->tensor_data = data;
+	buffer->priv->tensor_size = data != NULL ? size : 0;
+	buffer->priv->tensor_is_owned = FALSE;
+	buffer->priv->has_tensor = FALSE;
+}
+
+/**
+ * arv_buffer_get_tensor_data:
+ * @buffer: a #ArvBuffer
+ * @size: (out) (optional): size of the tensor memory, in bytes
+ *
+ * Gets the tensor computed for the current frame by the stream stage added by arv_stream_add_tensor_stage().
+ *
+ * Returns: (transfer none): the tensor, %NULL if it was not computed for this frame.
+ *
+ * Since: 0.8.24
+ */
+
+const float *
+arv_buffer_get_tensor_data (ArvBuffer *buffer, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (!buffer->priv->has_tensor) {
+		if (size != NULL)
+			*size = 0;
+		return NULL;
+	}
+
+	if (size != NULL)
+		*size = buffer->priv->tensor_size;
+
+	return buffer->priv->tensor_data;
+}
+
+/* Decimation. The input rows of an output row are first summed, on contiguous rows left to the compiler
+ * auto-vectorization, then the column sums are reduced by blocks of factor samples. The samples of a block are
+ * pitch samples apart, the pitch being the number of interleaved channels, or 2 for the binning of the Bayer cells,
+ * which keeps the color filter pattern. */
+
+typedef struct {
+	const ArvBufferConvertFormat *input;
+	const ArvBufferConvertFormat *output;
+	guint factor;
+	gboolean debayer;
+	/* Samples per input row, and blocks geometry */
+	guint n_samples;
+	guint x_pitch;
+	guint y_pitch;
+	gint width;
+	gint height;
+} ArvBufferDecimation;
+
+static const ArvBufferConvertFormat *
+_find_raw_format (ArvBufferConvertFilter filter, ArvBufferConvertLayout layout, guint n_bits)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_buffer_convert_formats); i++)
+		if (arv_buffer_convert_formats[i].layout == layout &&
+		    arv_buffer_convert_formats[i].filter == filter &&
+		    arv_buffer_convert_formats[i].n_bits == n_bits)
+			return &arv_buffer_convert_formats[i];
+
+	return NULL;
+}
+
+static gboolean
+_get_decimation (ArvPixelFormat pixel_format, gint width, gint height, guint factor, gboolean debayer,
+		 ArvBufferDecimation *decimation, GError **error)
+{
+	const ArvBufferConvertFormat *input = _find_format (pixel_format);
+	guint n_channels = 1;
+
+	/* The 16 bit sums of the blocks fit in 32 bits */
+	if (factor < 1 || factor > 256) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid decimation factor %u", factor);
+		return FALSE;
+	}
+
+	if (input == NULL || (!_is_raw (input) && !_is_rgb (input))) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Unsupported decimation of pixel format 0x%08x", pixel_format);
+		return FALSE;
+	}
+
+	decimation->input = input;
+	decimation->factor = factor;
+	decimation->debayer = debayer && _is_raw (input) && input->filter != ARV_BUFFER_CONVERT_FILTER_MONO;
+	decimation->x_pitch = 1;
+	decimation->y_pitch = 1;
+
+	if (decimation->debayer) {
+		if ((factor & 1) != 0) {
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+				     "Debayering decimation factor %u is not even", factor);
+			return FALSE;
+		}
+		decimation->output = _find_format (ARV_PIXEL_FORMAT_RGB_8_PACKED);
+	} else if (_is_rgb (input)) {
+		ArvBufferConvertChannels channels;
+
+		_get_channels (input, &channels);
+		n_channels = channels.n_channels;
+		decimation->x_pitch = n_channels;
+		decimation->output = input;
+	} else {
+		if (input->filter != ARV_BUFFER_CONVERT_FILTER_MONO) {
+			decimation->x_pitch = 2;
+			decimation->y_pitch = 2;
+		}
+		/* The packed layouts are unpacked */
+		decimation->output = input->layout == ARV_BUFFER_CONVERT_LAYOUT_8 ?
+			input : _find_raw_format (input->filter, ARV_BUFFER_CONVERT_LAYOUT_16, input->n_bits);
+	}
+
+	/* The binned Bayer images keep whole 2x2 cells */
+	decimation->n_samples = width * n_channels;
+	decimation->width = width / (factor * decimation->y_pitch) * decimation->y_pitch;
+	decimation->height = height / (factor * decimation->y_pitch) * decimation->y_pitch;
+
+	if (decimation->output == NULL || decimation->width < 1 || decimation->height < 1) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Image too small (%d x %d) for a decimation by %u", width, height, factor);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static size_t
+_get_decimated_row_size (const ArvBufferDecimation *decimation)
+{
+	return (size_t) decimation->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (decimation->output->pixel_format) / 8;
+}
+
+static void
+_sum_rows (const ArvBufferDecimation *decimation, const guint8 *data, size_t stride, guint first_row, guint n_rows,
+	   guint row_pitch, guint16 *unpacked, guint32 *sums)
+{
+	guint n_samples = decimation->n_samples;
+	guint i, j;
+
+	memset (sums, 0, n_samples * sizeof (guint32));
+
+	for (j = 0; j < n_rows; j++) {
+		const guint8 *src = data + (size_t) (first_row + j * row_pitch) * stride;
+
+		if (_is_raw (decimation->input)) {
+			_unpack_row (decimation->input, src, n_samples, unpacked);
+			for (i = 0; i < n_samples; i++)
+				sums[i] += unpacked[i];
+		} else {
+			for (i = 0; i < n_samples; i++)
+				sums[i] += src[i];
+		}
+	}
+}
+
+/* Reduction of the column sums of the factor x factor blocks, the output samples being the block averages */
+
+static void
+_reduce_columns (const ArvBufferDecimation *decimation, const guint32 *sums, guint8 *dst)
+{
+	guint factor = decimation->factor;
+	guint pitch = decimation->x_pitch;
+	guint n_output_samples = decimation->width * (_is_rgb (decimation->input) ? pitch : 1);
+	guint32 area = factor * factor;
+	guint o, i;
+
+	for (o = 0; o < n_output_samples; o++) {
+		const guint32 *block = sums + (o / pitch) * pitch * factor + o % pitch;
+		guint32 sum = 0;
+
+		for (i = 0; i < factor; i++)
+			sum += block[i * pitch];
+
+		sum = (sum + area / 2) / area;
+		if (decimation->output->layout == ARV_BUFFER_CONVERT_LAYOUT_16) {
+			dst[2 * o] = sum & 0xff;
+			dst[2 * o + 1] = sum >> 8;
+		} else {
+			dst[o] = sum;
+		}
+	}
+}
+
+/* Averages of the color samples of the factor x factor blocks, factor being even. The even and odd rows of a block are
+ * summed separately, the 2x2 phase of a sample being given by its position in the block. */
+
+static void
+_reduce_bayer_columns (const ArvBufferDecimation *decimation, const guint32 *even_sums, const guint32 *odd_sums,
+		       guint8 *dst)
+{
+	guint factor = decimation->factor;
+	guint shift = decimation->input->n_bits - 8;
+	guint32 quarter = factor * factor / 4;
+	guint red_x, red_y;
+	guint o, i;
+
+	_get_red_phase (decimation->input->filter, &red_x, &red_y);
+
+	for (o = 0; o < (guint) decimation->width; o++) {
+		const guint32 *rows[2] = {even_sums + o * factor, odd_sums + o * factor};
+		guint32 phases[2][2] = {{0, 0}, {0, 0}};
+		guint32 red, green, blue;
+
+		for (i = 0; i < factor; i += 2) {
+			phases[0][0] += rows[0][i];
+			phases[0][1] += rows[0][i + 1];
+			phases[1][0] += rows[1][i];
+			phases[1][1] += rows[1][i + 1];
+		}
+
+		red = phases[red_y][red_x];
+		blue = phases[1 - red_y][1 - red_x];
+		green = phases[red_y][1 - red_x] + phases[1 - red_y][red_x];
+
+		dst[3 * o] = ((red + quarter / 2) / quarter) >> shift;
+		dst[3 * o + 1] = ((green + quarter) / (2 * quarter)) >> shift;
+		dst[3 * o + 2] = ((blue + quarter / 2) / quarter) >> shift;
+	}
+}
+
+/**
+ * arv_buffer_get_decimated_size:
+ * @buffer: a #ArvBuffer
+ * @factor: decimation factor
+ * @debayer: whether the Bayer images are debayered
+ *
+ * Computes the size of the image written by arv_buffer_decimate() for the image of @buffer.
+ *
+ * Returns: the decimated image size in bytes, 0 if the decimation is not supported.
+ *
+ * Since: 0.8.24
+ */
+
+size_t
+arv_buffer_get_decimated_size (ArvBuffer *buffer, guint factor, gboolean debayer)
+{
+	ArvBufferDecimation decimation;
+	gint width = 0, height = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	if (arv_buffer_get_n_parts (buffer) < 1)
+		return 0;
+
+	arv_buffer_get_part_region (buffer, 0, NULL, NULL, &width, &height);
+	if (!_get_decimation (arv_buffer_get_part_pixel_format (buffer, 0), width, height, factor, debayer,
+			      &decimation, NULL))
+		return 0;
+
+	return _get_decimated_row_size (&decimation) * decimation.height;
+}
+
+/**
+ * arv_buffer_decimate:
+ * @buffer: a #ArvBuffer
+ * @output: the #ArvBuffer receiving the decimated image
+ * @factor: decimation factor
+ * @debayer: whether the Bayer images are debayered
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Writes to @output the image of @buffer, or the first part of a multipart payload, reduced by @factor in both
+ * directions, typically for a preview of the full resolution images. Each output pixel is the average of a @factor x
+ * @factor block. The monochrome and RGB images keep their pixel format, the packed layouts being unpacked. The Bayer
+ * images are either binned by 2x2 cells, which keeps the color filter pattern, or debayered to
+ * #ARV_PIXEL_FORMAT_RGB_8_PACKED if @debayer is set, @factor being even, each block giving the color of an output
+ * pixel. On success, @output has the frame id and the timestamps of @buffer.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_decimate (ArvBuffer *buffer, ArvBuffer *output, guint factor, gboolean debayer, GError **error)
+{
+	ArvBufferDecimation decimation;
+	const guint8 *input_data;
+	size_t input_stride;
+	size_t row_size;
+	gint width, height;
+	guint16 *unpacked;
+	guint32 *sums[2];
+	guint y;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (output), FALSE);
+	g_return_val_if_fail (buffer != output, FALSE);
+
+	if (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS || arv_buffer_get_n_parts (buffer) < 1) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Buffer is not a complete image (status %d)", buffer->priv->status);
+		return FALSE;
+	}
+
+	arv_buffer_get_part_region (buffer, 0, NULL, NULL, &width, &height);
+	if (!_get_decimation (arv_buffer_get_part_pixel_format (buffer, 0), width, height, factor, debayer,
+			      &decimation, error))
+		return FALSE;
+
+	if (!_get_input_image (buffer, 0, decimation.input, &input_data, &input_stride, &width, &height, error))
+		return FALSE;
+
+	row_size = _get_decimated_row_size (&decimation);
+	if (row_size * decimation.height > output->priv->allocated_size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Output buffer too small for a %dx%d image (%zu bytes)",
+			     decimation.width, decimation.height, output->priv->allocated_size);
+		return FALSE;
+	}
+
+	unpacked = g_new (guint16, decimation.n_samples);
+	sums[0] = g_new (guint32, decimation.n_samples);
+	sums[1] = g_new (guint32, decimation.n_samples);
+
+	for (y = 0; y < (guint) decimation.height; y++) {
+		guint8 *dst = output->priv->data + y * row_size;
+
+		if (decimation.debayer) {
+			guint first_row = y * factor;
+
+			_sum_rows (&decimation, input_data, input_stride, first_row, factor / 2, 2, unpacked, sums[0]);
+			_sum_rows (&decimation, input_data, input_stride, first_row + 1, factor / 2, 2, unpacked, sums[1]);
+			_reduce_bayer_columns (&decimation, sums[0], sums[1], dst);
+		} else {
+			guint pitch = decimation.y_pitch;
+			guint first_row = (y / pitch) * pitch * factor + y % pitch;
+
+			_sum_rows (&decimation, input_data, input_stride, first_row, factor, pitch, unpacked, sums[0]);
+			_reduce_columns (&decimation, sums[0], dst);
+		}
+	}
+
+	g_free (sums[1]);
+	g_free (sums[0]);
+	g_free (unpacked);
+
+	output->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	output->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	output->priv->pixel_format = decimation.output->pixel_format;
+	output->priv->width = decimation.width;
+	output->priv->height = decimation.height;
+	output->priv->x_padding = 0;
+	output->priv->received_size = row_size * decimation.height;
+	output->priv->frame_id = buffer->priv->frame_id;
+	output->priv->timestamp_ns = buffer->priv->timestamp_ns;
+	output->priv->system_timestamp_ns = buffer->priv->system_timestamp_ns;
+	output->priv->host_timestamp_ns = buffer->priv->host_timestamp_ns;
+	output->priv->first_packet_time_us = buffer->priv->first_packet_time_us;
+	output->priv->last_packet_time_us = buffer->priv->last_packet_time_us;
+	output->priv->output_time_us = buffer->priv->output_time_us;
+	output->priv->metadata = buffer->priv->metadata;
+	output->priv->x_offset = buffer->priv->x_offset;
+	output->priv->y_offset = buffer->priv->y_offset;
+	output->priv->n_parts = 0;
+	output->priv->has_chunk_index = FALSE;
+
+	return TRUE;
+}
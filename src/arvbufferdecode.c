@@ -0,0 +1,178 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Decoding of the compressed payloads.
+ *
+ * JPEG payloads are decoded by libjpeg-turbo, using one decompressor per thread, into an image buffer supplied by
+ * the caller, typically popped from an #ArvBufferPool. Video payloads like H.264 need a decoder state spanning the
+ * frames, and are better handled by the hardware decoders of GStreamer, behind aravissrc.
+ */
+
+#include <arvbuffer.h>
+#include <arvbufferprivate.h>
+#include <arvfeatures.h>
+#include <arvdebugprivate.h>
+
+#if ARAVIS_HAS_JPEG
+#include <turbojpeg.h>
+
+static void
+_destroy_decompressor (gpointer handle)
+{
+	tjDestroy (handle);
+}
+
+static GPrivate jpeg_decompressor = G_PRIVATE_INIT (_destroy_decompressor);
+
+static gboolean
+_decode_jpeg (ArvBuffer *buffer, ArvBuffer *output, GError **error)
+{
+	tjhandle handle;
+	int width, height, subsampling, colorspace;
+	int pixel_size;
+	int tj_format;
+	ArvPixelFormat pixel_format;
+
+	handle = g_private_get (&jpeg_decompressor);
+	if (handle == NULL) {
+		handle = tjInitDecompress ();
+		if (handle == NULL) {
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+				     "Failed to create a JPEG decompressor");
+			return FALSE;
+		}
+		g_private_set (&jpeg_decompressor, handle);
+	}
+
+	if (tjDecompressHeader3 (handle, buffer->priv->data, buffer->priv->received_size,
+				 &width, &height, &subsampling, &colorspace) != 0) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Invalid JPEG header: %s", tjGetErrorStr2 (handle));
+		return FALSE;
+	}
+
+	if (colorspace == TJCS_GRAY) {
+		pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+		tj_format = TJPF_GRAY;
+	} else {
+		pixel_format = ARV_PIXEL_FORMAT_RGB_8_PACKED;
+		tj_format = TJPF_RGB;
+	}
+	pixel_size = tjPixelSize[tj_format];
+
+	if ((size_t) width * height * pixel_size > output->priv->allocated_size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Output buffer too small for a %dx%d image (%zu bytes)",
+			     width, height, output->priv->allocated_size);
+		return FALSE;
+	}
+
+	if (tjDecompress2 (handle, buffer->priv->data, buffer->priv->received_size, output->priv->data,
+			   width, width * pixel_size, height, tj_format, TJFLAG_FASTDCT) != 0 &&
+	    tjGetErrorCode (handle) != TJERR_WARNING) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "JPEG decoding failed: %s", tjGetErrorStr2 (handle));
+		return FALSE;
+	}
+
+	output->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	output->priv->pixel_format = pixel_format;
+	output->priv->width = width;
+	output->priv->height = height;
+	output->priv->x_padding = 0;
+	output->priv->received_size = (size_t) width * height * pixel_size;
+
+	return TRUE;
+}
+
+#endif
+
+/**
+ * arv_buffer_decode:
+ * @buffer: a #ArvBuffer with a compressed payload
+ * @output: the #ArvBuffer receiving the decoded image
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Decodes the compressed payload of @buffer into @output, which is typically popped from an #ArvBufferPool sized for
+ * the uncompressed image. On success, @output has an image payload, with the frame id, the timestamps and the
+ * reception times of @buffer. JPEG payloads are decoded to #ARV_PIXEL_FORMAT_MONO_8 or
+ * #ARV_PIXEL_FORMAT_RGB_8_PACKED images, when aravis is compiled with libjpeg-turbo. The other compressed payloads
+ * are not supported, the GStreamer source element advertising them as caps for the decoders of the pipeline.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_decode (ArvBuffer *buffer, ArvBuffer *output, GError **error)
+{
+	gboolean success = FALSE;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (output), FALSE);
+	g_return_val_if_fail (buffer != output, FALSE);
+
+	if (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE,
+			     "Buffer is not complete (status %d)", buffer->priv->status);
+		return FALSE;
+	}
+
+	switch (buffer->priv->payload_type) {
+		case ARV_BUFFER_PAYLOAD_TYPE_JPEG:
+#if ARAVIS_HAS_JPEG
+			success = _decode_jpeg (buffer, output, error);
+#else
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+				     "JPEG decoding support not compiled in");
+#endif
+			break;
+		default:
+			g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD,
+				     "Decoding of payload type 0x%04x not supported", buffer->priv->payload_type);
+			break;
+	}
+
+	if (!success)
+		return FALSE;
+
+	output->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	output->priv->frame_id = buffer->priv->frame_id;
+	output->priv->timestamp_ns = buffer->priv->timestamp_ns;
+	output->priv->system_timestamp_ns = buffer->priv->system_timestamp_ns;
+	output->priv->host_timestamp_ns = buffer->priv->host_timestamp_ns;
+	output->priv->first_packet_time_us = buffer->priv->first_packet_time_us;
+	output->priv->last_packet_time_us = buffer->priv->last_packet_time_us;
+	output->priv->output_time_us = buffer->priv->output_time_us;
+	output->priv->metadata = buffer->priv->metadata;
+	output->priv->x_offset = buffer->priv->x_offset;
+	output->priv->y_offset = buffer->priv->y_offset;
+	output->priv->n_parts = 0;
+	output->priv->has_chunk_index = FALSE;
+
+	arv_debug_misc ("[Buffer::decode] Frame %" G_GUINT64_FORMAT " decoded to %ux%u",
+			output->priv->frame_id, output->priv->width, output->priv->height);
+
+	return TRUE;
+}
@@ -0,0 +1,549 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvBufferPool:
+ *
+ * [class@ArvBufferPool] allocates a set of [class@ArvBuffer] of the same size in a single contiguous memory arena.
+ *
+ * The arena can be backed by huge pages, which reduces the TLB misses on large buffer sets, aligned for SIMD
+ * processing or DMA transfers, and bound to a given NUMA node.
+ *
+ * Once a pool is attached to a [class@ArvStream] using [method@ArvBufferPool.attach_stream], all its buffers are
+ * pushed to the stream input queue, and a buffer is automatically given back to the stream when its last reference
+ * held outside of the pool is dropped. The application doesn't need to push back the buffers it retrieved using
+ * [method@ArvStream.pop_buffer], a simple g_object_unref() is sufficient.
+ *
+ * When the stream uses lock-free queues (see [property@ArvStream:lock-free-queue-size]), the buffers must all be
+ * released from the same thread.
+ */
+
+#include <arvbufferpool.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <errno.h>
+
+#ifdef G_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#define ARV_BUFFER_POOL_DEFAULT_ALIGNMENT	64
+#define ARV_BUFFER_POOL_HUGE_PAGE_SIZE		(2 * 1024 * 1024)
+
+/* From linux/mempolicy.h */
+#define ARV_BUFFER_POOL_MPOL_BIND		2
+
+GQuark
+arv_buffer_pool_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-buffer-pool-error-quark");
+}
+
+/* Memory arena, released when the pool and all its buffers are released */
+
+typedef struct {
+	gint ref_count;
+
+	void *memory;
+	size_t memory_size;
+	gboolean is_mapped;
+
+	guint8 *data;
+} ArvBufferPoolArena;
+
+static size_t
+_align_size (size_t size, size_t alignment)
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+static gboolean
+_bind_numa_node (void *memory, size_t size, gint numa_node)
+{
+#if defined (__linux__) && defined (SYS_mbind)
+	unsigned long node_mask;
+
+	if (numa_node < 0 || numa_node >= (gint) (8 * sizeof (node_mask)))
+		return FALSE;
+
+	node_mask = 1UL << numa_node;
+
+	return syscall (SYS_mbind, memory, size, ARV_BUFFER_POOL_MPOL_BIND,
+			&node_mask, 8 * sizeof (node_mask) + 1, 0) == 0;
+#else
+	return FALSE;
+#endif
+}
+
+static ArvBufferPoolArena *
+_arena_new (size_t size, size_t alignment, ArvBufferPoolFlags *flags, gint numa_node, GError **error)
+{
+	ArvBufferPoolArena *arena;
+	void *memory = NULL;
+	size_t memory_size = 0;
+	gboolean is_mapped = FALSE;
+
+#ifdef G_OS_UNIX
+	{
+		size_t page_size = sysconf (_SC_PAGESIZE);
+		void *mapped = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+		if (*flags & ARV_BUFFER_POOL_FLAGS_HUGE_PAGES) {
+			memory_size = _align_size (size + (alignment > ARV_BUFFER_POOL_HUGE_PAGE_SIZE ? alignment : 0),
+						   ARV_BUFFER_POOL_HUGE_PAGE_SIZE);
+			mapped = mmap (NULL, memory_size, PROT_READ | PROT_WRITE,
+				       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (mapped == MAP_FAILED)
+				arv_info_misc ("[BufferPool::new] Huge pages not available (%s)", g_strerror (errno));
+		}
+#endif
+		if (mapped == MAP_FAILED) {
+			*flags &= ~ARV_BUFFER_POOL_FLAGS_HUGE_PAGES;
+			memory_size = _align_size (size + (alignment > page_size ? alignment : 0), page_size);
+			mapped = mmap (NULL, memory_size, PROT_READ | PROT_WRITE,
+				       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		}
+
+		if (mapped != MAP_FAILED) {
+			memory = mapped;
+			is_mapped = TRUE;
+
+#ifdef MADV_HUGEPAGE
+			if ((*flags & ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES) &&
+			    madvise (memory, memory_size, MADV_HUGEPAGE) != 0) {
+				arv_info_misc ("[BufferPool::new] Transparent huge pages not available (%s)",
+					       g_strerror (errno));
+				*flags &= ~ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES;
+			}
+#else
+			*flags &= ~ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES;
+#endif
+		}
+	}
+#endif
+
+	if (memory == NULL) {
+		*flags &= ~(ARV_BUFFER_POOL_FLAGS_HUGE_PAGES | ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES);
+		memory_size = size + alignment;
+		memory = g_try_malloc (memory_size);
+	}
+
+	if (memory == NULL) {
+		g_set_error (error, ARV_BUFFER_POOL_ERROR, ARV_BUFFER_POOL_ERROR_ALLOCATION_FAILURE,
+			     "Can't allocate %" G_GSIZE_FORMAT " bytes for buffer pool", size);
+		return NULL;
+	}
+
+	/* Pages are not touched yet, the memory policy applies to the first access */
+	if (numa_node >= 0 && (!is_mapped || !_bind_numa_node (memory, memory_size, numa_node)))
+		arv_warning_misc ("[BufferPool::new] Can't bind buffer pool memory to NUMA node %d", numa_node);
+
+	arena = g_new0 (ArvBufferPoolArena, 1);
+	arena->ref_count = 1;
+	arena->memory = memory;
+	arena->memory_size = memory_size;
+	arena->is_mapped = is_mapped;
+	arena->data = GSIZE_TO_POINTER (_align_size (GPOINTER_TO_SIZE (memory), alignment));
+
+	return arena;
+}
+
+static ArvBufferPoolArena *
+_arena_ref (ArvBufferPoolArena *arena)
+{
+	g_atomic_int_inc (&arena->ref_count);
+
+	return arena;
+}
+
+static void
+_arena_unref (void *data)
+{
+	ArvBufferPoolArena *arena = data;
+
+	if (!g_atomic_int_dec_and_test (&arena->ref_count))
+		return;
+
+#ifdef G_OS_UNIX
+	if (arena->is_mapped)
+		munmap (arena->memory, arena->memory_size);
+#endif
+	if (!arena->is_mapped)
+		g_free (arena->memory);
+
+	g_free (arena);
+}
+
+/* ArvBufferPool */
+
+typedef struct {
+	ArvBufferPoolArena *arena;
+
+	ArvBuffer **buffers;
+	guint n_buffers;
+	size_t buffer_size;
+	ArvBufferPoolFlags flags;
+
+	GMutex mutex;
+	GQueue free_buffers;
+
+	GWeakRef stream;
+} ArvBufferPoolPrivate;
+
+struct _ArvBufferPool {
+	GObject	object;
+
+	ArvBufferPoolPrivate *priv;
+};
+
+struct _ArvBufferPoolClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvBufferPool, arv_buffer_pool, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvBufferPool))
+
+/* Set while a buffer is pushed to the stream by the current thread. A buffer dropped by the stream during the push
+ * goes to the free list instead of being pushed again. */
+static GPrivate arv_buffer_pool_recycling = G_PRIVATE_INIT (NULL);
+
+static void
+_buffer_toggle_notify (gpointer data, GObject *object, gboolean is_last_ref)
+{
+	ArvBufferPool *pool = data;
+	ArvBuffer *buffer = ARV_BUFFER (object);
+	ArvStream *stream = NULL;
+
+	/* Only the pool reference is left when is_last_ref is TRUE */
+	if (!is_last_ref)
+		return;
+
+	if (g_private_get (&arv_buffer_pool_recycling) == NULL)
+		stream = g_weak_ref_get (&pool->priv->stream);
+
+	if (stream != NULL) {
+		g_private_set (&arv_buffer_pool_recycling, pool);
+		arv_stream_push_buffer (stream, g_object_ref (buffer));
+		g_private_set (&arv_buffer_pool_recycling, NULL);
+
+		g_object_unref (stream);
+		return;
+	}
+
+	g_mutex_lock (&pool->priv->mutex);
+	g_queue_push_tail (&pool->priv->free_buffers, buffer);
+	g_mutex_unlock (&pool->priv->mutex);
+}
+
+/**
+ * arv_buffer_pool_new:
+ * @n_buffers: number of buffers
+ * @buffer_size: size of each buffer, in bytes
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new pool of @n_buffers buffers, using the default alignment, no huge pages and no NUMA placement.
+ *
+ * Returns: (transfer full): a new #ArvBufferPool, %NULL on error
+ *
+ * Since: 0.8.24
+ */
+
+ArvBufferPool *
+arv_buffer_pool_new (guint n_buffers, size_t buffer_size, GError **error)
+{
+	return arv_buffer_pool_new_full (n_buffers, buffer_size, 0, ARV_BUFFER_POOL_FLAGS_NONE, -1, error);
+}
+
+/**
+ * arv_buffer_pool_new_full:
+ * @n_buffers: number of buffers
+ * @buffer_size: size of each buffer, in bytes
+ * @alignment: buffer data alignment, a power of 2, 0 for the default alignment of 64 bytes
+ * @flags: allocation flags
+ * @numa_node: NUMA node of the buffer memory, -1 for no placement
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new pool of @n_buffers buffers, allocated in a single memory arena. Huge pages and NUMA placement are
+ * a best effort, the pool falls back to regular pages when they are not available. The flags in use are retrieved
+ * using [method@ArvBufferPool.get_flags].
+ *
+ * Returns: (transfer full): a new #ArvBufferPool, %NULL on error
+ *
+ * Since: 0.8.24
+ */
+
+ArvBufferPool *
+arv_buffer_pool_new_full (guint n_buffers, size_t buffer_size, size_t alignment, ArvBufferPoolFlags flags,
+			  gint numa_node, GError **error)
+{
+	ArvBufferPool *pool;
+	ArvBufferPoolArena *arena;
+	size_t stride;
+	guint i;
+
+	g_return_val_if_fail (n_buffers > 0, NULL);
+	g_return_val_if_fail (buffer_size > 0, NULL);
+	g_return_val_if_fail ((alignment & (alignment - 1)) == 0, NULL);
+
+	if (alignment == 0)
+		alignment = ARV_BUFFER_POOL_DEFAULT_ALIGNMENT;
+
+	stride = _align_size (buffer_size, alignment);
+	if (stride > G_MAXSIZE / n_buffers) {
+		g_set_error (error, ARV_BUFFER_POOL_ERROR, ARV_BUFFER_POOL_ERROR_ALLOCATION_FAILURE,
+			     "Invalid buffer pool size (%u x %" G_GSIZE_FORMAT " bytes)", n_buffers, buffer_size);
+		return NULL;
+	}
+
+	arena = _arena_new (stride * n_buffers, alignment, &flags, numa_node, error);
+	if (arena == NULL)
+		return NULL;
+
+	pool = g_object_new (ARV_TYPE_BUFFER_POOL, NULL);
+	pool->priv->arena = arena;
+	pool->priv->n_buffers = n_buffers;
+	pool->priv->buffer_size = buffer_size;
+	pool->priv->flags = flags;
+	pool->priv->buffers = g_new (ArvBuffer *, n_buffers);
+
+	for (i = 0; i < n_buffers; i++) {
+		ArvBuffer *buffer;
+
+		buffer = arv_buffer_new_take_data (buffer_size, arena->data + i * stride,
+						   _arena_ref (arena), _arena_unref);
+		pool->priv->buffers[i] = buffer;
+
+		/* Dropping the creation reference moves the buffer to the free list */
+		g_object_add_toggle_ref (G_OBJECT (buffer), _buffer_toggle_notify, pool);
+		g_object_unref (buffer);
+	}
+
+	arv_info_misc ("[BufferPool::new] %u buffers of %" G_GSIZE_FORMAT " bytes, stride %" G_GSIZE_FORMAT
+		       ", flags 0x%x", n_buffers, buffer_size, stride, flags);
+
+	return pool;
+}
+
+/**
+ * arv_buffer_pool_get_n_buffers:
+ * @pool: a #ArvBufferPool
+ *
+ * Returns: the number of buffers allocated by @pool
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_pool_get_n_buffers (ArvBufferPool *pool)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER_POOL (pool), 0);
+
+	return pool->priv->n_buffers;
+}
+
+/**
+ * arv_buffer_pool_get_buffer_size:
+ * @pool: a #ArvBufferPool
+ *
+ * Returns: the size of the buffers of @pool, in bytes
+ *
+ * Since: 0.8.24
+ */
+
+size_t
+arv_buffer_pool_get_buffer_size (ArvBufferPool *pool)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER_POOL (pool), 0);
+
+	return pool->priv->buffer_size;
+}
+
+/**
+ * arv_buffer_pool_get_flags:
+ * @pool: a #ArvBufferPool
+ *
+ * Returns: the allocation flags actually in use, which may differ from the requested ones if huge pages are not
+ * available.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBufferPoolFlags
+arv_buffer_pool_get_flags (ArvBufferPool *pool)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER_POOL (pool), ARV_BUFFER_POOL_FLAGS_NONE);
+
+	return pool->priv->flags;
+}
+
+/**
+ * arv_buffer_pool_get_n_free_buffers:
+ * @pool: a #ArvBufferPool
+ *
+ * Returns: the number of buffers neither in use by the application nor given to a stream.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_pool_get_n_free_buffers (ArvBufferPool *pool)
+{
+	guint n_free_buffers;
+
+	g_return_val_if_fail (ARV_IS_BUFFER_POOL (pool), 0);
+
+	g_mutex_lock (&pool->priv->mutex);
+	n_free_buffers = g_queue_get_length (&pool->priv->free_buffers);
+	g_mutex_unlock (&pool->priv->mutex);
+
+	return n_free_buffers;
+}
+
+/**
+ * arv_buffer_pool_pop_buffer:
+ * @pool: a #ArvBufferPool
+ *
+ * Retrieves a free buffer from @pool. The buffer returns to the pool, or to the attached stream, when the returned
+ * reference is dropped.
+ *
+ * Returns: (transfer full): a #ArvBuffer, %NULL if no buffer is available.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_buffer_pool_pop_buffer (ArvBufferPool *pool)
+{
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (ARV_IS_BUFFER_POOL (pool), NULL);
+
+	g_mutex_lock (&pool->priv->mutex);
+	buffer = g_queue_pop_head (&pool->priv->free_buffers);
+	g_mutex_unlock (&pool->priv->mutex);
+
+	return buffer != NULL ? g_object_ref (buffer) : NULL;
+}
+
+/**
+ * arv_buffer_pool_attach_stream:
+ * @pool: a #ArvBufferPool
+ * @stream: a #ArvStream
+ *
+ * Pushes all the free buffers of @pool to the input queue of @stream, and gives back the buffers to @stream as soon
+ * as they are released by the application. The pool doesn't hold a reference to @stream. Buffers still in use by a
+ * previously attached stream are given to @stream once released.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_buffer_pool_attach_stream (ArvBufferPool *pool, ArvStream *stream)
+{
+	ArvBuffer *buffer;
+
+	g_return_if_fail (ARV_IS_BUFFER_POOL (pool));
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_weak_ref_set (&pool->priv->stream, stream);
+
+	while ((buffer = arv_buffer_pool_pop_buffer (pool)) != NULL)
+		arv_stream_push_buffer (stream, buffer);
+}
+
+/**
+ * arv_buffer_pool_detach_stream:
+ * @pool: a #ArvBufferPool
+ *
+ * Stops giving back the released buffers to the attached stream. The buffers still in the stream queues return to
+ * the pool once the stream releases them.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_buffer_pool_detach_stream (ArvBufferPool *pool)
+{
+	g_return_if_fail (ARV_IS_BUFFER_POOL (pool));
+
+	g_weak_ref_set (&pool->priv->stream, NULL);
+}
+
+static void
+arv_buffer_pool_init (ArvBufferPool *pool)
+{
+	pool->priv = arv_buffer_pool_get_instance_private (pool);
+
+	g_mutex_init (&pool->priv->mutex);
+	g_queue_init (&pool->priv->free_buffers);
+	g_weak_ref_init (&pool->priv->stream, NULL);
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvBufferPool *pool = ARV_BUFFER_POOL (object);
+	guint i;
+
+	g_weak_ref_set (&pool->priv->stream, NULL);
+
+	if (pool->priv->buffers != NULL) {
+		g_mutex_lock (&pool->priv->mutex);
+		g_queue_clear (&pool->priv->free_buffers);
+		g_mutex_unlock (&pool->priv->mutex);
+
+		/* Buffers still in use keep the arena alive until they are released */
+		for (i = 0; i < pool->priv->n_buffers; i++)
+			g_object_remove_toggle_ref (G_OBJECT (pool->priv->buffers[i]), _buffer_toggle_notify, pool);
+
+		g_clear_pointer (&pool->priv->buffers, g_free);
+	}
+
+	G_OBJECT_CLASS (arv_buffer_pool_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvBufferPool *pool = ARV_BUFFER_POOL (object);
+
+	g_clear_pointer (&pool->priv->arena, _arena_unref);
+
+	g_weak_ref_clear (&pool->priv->stream);
+	g_mutex_clear (&pool->priv->mutex);
+
+	G_OBJECT_CLASS (arv_buffer_pool_parent_class)->finalize (object);
+}
+
+static void
+arv_buffer_pool_class_init (ArvBufferPoolClass *pool_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (pool_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,86 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_BUFFER_POOL_H
+#define ARV_BUFFER_POOL_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvbuffer.h>
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+#define ARV_BUFFER_POOL_ERROR arv_buffer_pool_error_quark()
+
+ARV_API GQuark		arv_buffer_pool_error_quark		(void);
+
+/**
+ * ArvBufferPoolError:
+ * @ARV_BUFFER_POOL_ERROR_ALLOCATION_FAILURE: the buffer memory can not be allocated
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_POOL_ERROR_ALLOCATION_FAILURE
+} ArvBufferPoolError;
+
+/**
+ * ArvBufferPoolFlags:
+ * @ARV_BUFFER_POOL_FLAGS_NONE: no flag
+ * @ARV_BUFFER_POOL_FLAGS_HUGE_PAGES: use explicit huge pages (MAP_HUGETLB), if available
+ * @ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES: ask for transparent huge pages (MADV_HUGEPAGE), if available
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_BUFFER_POOL_FLAGS_NONE =			0,
+	ARV_BUFFER_POOL_FLAGS_HUGE_PAGES =		1 << 0,
+	ARV_BUFFER_POOL_FLAGS_TRANSPARENT_HUGE_PAGES =	1 << 1
+} ArvBufferPoolFlags;
+
+#define ARV_TYPE_BUFFER_POOL             (arv_buffer_pool_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvBufferPool, arv_buffer_pool, ARV, BUFFER_POOL, GObject)
+
+ARV_API ArvBufferPool *		arv_buffer_pool_new		(guint n_buffers, size_t buffer_size, GError **error);
+ARV_API ArvBufferPool *		arv_buffer_pool_new_full	(guint n_buffers, size_t buffer_size, size_t alignment,
+								 ArvBufferPoolFlags flags, gint numa_node, GError **error);
+
+ARV_API guint			arv_buffer_pool_get_n_buffers	(ArvBufferPool *pool);
+ARV_API size_t			arv_buffer_pool_get_buffer_size	(ArvBufferPool *pool);
+ARV_API ArvBufferPoolFlags	arv_buffer_pool_get_flags	(ArvBufferPool *pool);
+ARV_API guint			arv_buffer_pool_get_n_free_buffers	(ArvBufferPool *pool);
+
+ARV_API ArvBuffer *		arv_buffer_pool_pop_buffer	(ArvBufferPool *pool);
+
+ARV_API void			arv_buffer_pool_attach_stream	(ArvBufferPool *pool, ArvStream *stream);
+ARV_API void			arv_buffer_pool_detach_stream	(ArvBufferPool *pool);
+
+G_END_DECLS
+
+#endif
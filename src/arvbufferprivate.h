@@ -29,30 +29,142 @@
 G_BEGIN_DECLS
 
 typedef struct {
+	size_t data_offset;
+	size_t size;
+	guint component_id;
+	ArvBufferPartDataType data_type;
+	ArvPixelFormat pixel_format;
+	guint32 width;
+	guint32 height;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 x_padding;
+	guint32 y_padding;
+} ArvBufferPartInfos;
+
+/* Region of a multiple region payload, the regions being packed one after the other, without row padding */
+typedef struct {
+	size_t offset;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 width;
+	guint32 height;
+} ArvBufferRegionInfos;
+
+typedef struct _ArvBufferStatistics ArvBufferStatistics;
+
+#define ARV_BUFFER_COMPRESSION_MAX_BANDS	64
+
+typedef enum {
+	ARV_BUFFER_COMPRESSION_FILTER_NONE,
+	ARV_BUFFER_COMPRESSION_FILTER_DELTA
+} ArvBufferCompressionFilter;
+
+typedef struct {
+	gboolean is_valid;
+
+	ArvBufferCompression compression;
+	ArvBufferCompressionFilter filter;
+	guint bytes_per_pixel;
+
+	/* Rows distributed between the bands, 0 if the data has no row structure */
+	guint n_rows;
+	size_t row_stride;
+	size_t uncompressed_size;
+
+	guint n_bands;
+	size_t band_sizes[ARV_BUFFER_COMPRESSION_MAX_BANDS];
+
+	/* Concatenated compressed bands, the allocation being reused by the next frames */
+	void *data;
+	size_t size;
 	size_t allocated_size;
+} ArvBufferCompressed;
+
+typedef struct {
+	size_t allocated_size;
+	/* Payload offset of the first data byte, non zero for the chunk only buffers keeping the end of the payloads */
+	size_t window_offset;
 	gboolean is_preallocated;
 	unsigned char *data;
 
 	void *user_data;
 	GDestroyNotify user_data_destroy_func;
 
+	/* Release of memory allocated by a device specific allocator */
+	void *data_destroy_data;
+	GDestroyNotify data_destroy_func;
+
+	/* DMA buffer file descriptor of the data, -1 if not a DMA buffer */
+	int dmabuf_fd;
+
+	/* Imported memory properties, the handle being opaque to the library */
+	ArvBufferMemoryType memory_type;
+	guint64 memory_handle;
+
+	/* Data faulted in, and locked if possible, by a stream in locked memory mode */
+	gboolean is_memory_prepared;
+	gboolean is_memory_locked;
+
 	ArvBufferStatus status;
 	size_t received_size;
 
 	ArvBufferPayloadType payload_type;
 
 	guint32 chunk_endianness;
+	GArray *chunks;
+	gboolean has_chunk_index;
 
 	guint64 frame_id;
 	guint64 timestamp_ns;
 	guint64 system_timestamp_ns;
+	guint64 host_timestamp_ns;
+
+	/* Monotonic times of the frame reception stages, in µs, 0 when unknown */
+	guint64 first_packet_time_us;
+	guint64 last_packet_time_us;
+	guint64 output_time_us;
 
 	guint32 x_offset;
 	guint32 y_offset;
 	guint32 width;
 	guint32 height;
+	/* Bytes between the end of a row and the start of the next one */
+	guint32 x_padding;
 
 	ArvPixelFormat pixel_format;
+
+	/* Part descriptors of multipart payloads, pointing into data */
+	ArvBufferPartInfos *parts;
+	guint n_parts;
+	guint n_allocated_parts;
+
+	/* Image statistics accumulated during the reception, allocated on first use */
+	ArvBufferStatistics *statistics;
+
+	/* Compressed copy of the data, allocated on first use */
+	ArvBufferCompressed *compressed;
+
+	/* Tensor computed by the tensor stage, in memory supplied by the application or allocated on first use */
+	float *tensor_data;
+	size_t tensor_size;
+	gboolean tensor_is_owned;
+	gboolean has_tensor;
+
+	/* Transport counters of the frame, the other fields being copied on retrieval */
+	ArvBufferMetadata metadata;
+
+	/* Index of the packed frames, only allocated for the batch buffers */
+	GArray *batch_frames;
+
+	/* Ranges of the data received in an incomplete frame, allocated on first use */
+	GArray *valid_ranges;
+
+	/* ArvBufferRegionInfos table of a multiple region payload, shared with the stream, never modified */
+	GArray *regions;
+
+	/* First image after a width, height or pixel format change, set by the stream on output */
+	gboolean has_new_geometry;
 } ArvBufferPrivate;
 
 struct _ArvBuffer {
@@ -65,9 +177,58 @@ struct _ArvBufferClass {
 	GObjectClass parent_class;
 };
 
+ArvBuffer *	arv_buffer_new_take_data		(size_t size, void *data,
+							 void *data_destroy_data, GDestroyNotify data_destroy_func);
+
+typedef struct {
+	guint32 id;
+	size_t offset;
+	size_t size;
+} ArvBufferChunk;
+
+/* private, but used by tests */
+ARV_API void	arv_buffer_set_n_parts			(ArvBuffer *buffer, guint n_parts);
+
+/* private, but used by tests */
+ARV_API void	arv_buffer_update_chunk_index		(ArvBuffer *buffer);
+
 gboolean	arv_buffer_payload_type_has_chunks 	(ArvBufferPayloadType payload_type);
 gboolean	arv_buffer_payload_type_has_aoi 	(ArvBufferPayloadType payload_type);
 
+gboolean	arv_pixel_format_get_unpacking		(ArvPixelFormat pixel_format, ArvPixelFormat *unpacked_format,
+							 guint *n_group_bytes, guint *n_group_pixels);
+void		arv_buffer_unpack_pixel_groups		(ArvPixelFormat pixel_format, const void *data, size_t n_groups,
+							 void *unpacked);
+/* private, but used by tests */
+ARV_API gboolean	arv_buffer_unpack_pixels	(ArvBuffer *buffer);
+
+/* private, but used by tests */
+void			arv_buffer_clear_metadata	(ArvBuffer *buffer);
+/* private, but used by tests */
+ARV_API void		arv_buffer_add_valid_range	(ArvBuffer *buffer, size_t offset, size_t size);
+/* private, but used by tests */
+ARV_API void		arv_buffer_set_regions		(ArvBuffer *buffer, GArray *regions);
+gboolean		arv_buffer_grow			(ArvBuffer *buffer, size_t size);
+
+void			arv_buffer_batch_reset		(ArvBuffer *buffer);
+gboolean		arv_buffer_batch_append		(ArvBuffer *buffer, ArvBuffer *frame);
+
+ARV_API void		arv_buffer_statistics_start	(ArvBuffer *buffer, guint grid_size);
+/* private, but used by tests */
+ARV_API void		arv_buffer_statistics_add_block	(ArvBuffer *buffer, size_t offset, size_t size);
+/* private, but used by tests */
+ARV_API void		arv_buffer_statistics_clear	(ArvBuffer *buffer);
+/* private, but used by tests */
+ARV_API gboolean	arv_buffer_statistics_finish	(ArvBuffer *buffer, guint grid_size);
+void			arv_buffer_statistics_free	(ArvBufferStatistics *statistics);
+
+/* private, but used by tests */
+ARV_API void		arv_buffer_compression_clear	(ArvBuffer *buffer);
+/* private, but used by tests */
+ARV_API gboolean	arv_buffer_decompress		(const ArvBufferCompressed *compressed, const void *data,
+							 size_t size, void *output, GError **error);
+void			arv_buffer_compressed_free	(ArvBufferCompressed *compressed);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,570 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Image statistics computed during the reception.
+ *
+ * The stream implementations start the statistics on leader reception, then accumulate each data block once it is
+ * stored in the buffer, while it is still in the processor cache. The statistics are finished when the buffer is
+ * pushed to the output queue, with a full pass over the image if they could not be accumulated block by block, for
+ * example for the images unpacked on completion, or for the blocks not aligned on the pixel components.
+ */
+
+#include <arvbuffer.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#define ARV_BUFFER_STATISTICS_N_CHANNELS_MAX	3
+#define ARV_BUFFER_STATISTICS_N_BINS		256
+#define ARV_BUFFER_STATISTICS_GRID_SIZE_MAX	16
+#define ARV_BUFFER_STATISTICS_IGNORED_COMPONENT	0xff
+
+struct _ArvBufferStatistics {
+	gboolean is_started;
+	gboolean is_complete;
+	gboolean needs_full_pass;
+
+	/* Image layout */
+	ArvPixelFormat pixel_format;
+	guint32 width;
+	guint32 height;
+	size_t row_size;
+	size_t stride;
+	guint component_size;
+	guint n_pixel_components;
+	guint shift;
+	guint32 saturation;
+
+	/* Channel of the components, by row parity and component index modulo period */
+	guint n_channels;
+	guint period;
+	guint8 channels[2][4];
+
+	guint requested_grid_size;
+	guint grid_size;
+	/* Grid column of each component of a row */
+	guint8 *grid_columns;
+	size_t n_allocated_grid_columns;
+
+	guint32 histograms[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX][ARV_BUFFER_STATISTICS_N_BINS];
+	guint64 sums[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+	guint64 n_values[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+	guint32 minimums[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+	guint32 maximums[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+	guint64 n_saturated[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+	double means[ARV_BUFFER_STATISTICS_N_CHANNELS_MAX];
+
+	guint64 grid_sums[ARV_BUFFER_STATISTICS_GRID_SIZE_MAX * ARV_BUFFER_STATISTICS_GRID_SIZE_MAX];
+	guint64 grid_counts[ARV_BUFFER_STATISTICS_GRID_SIZE_MAX * ARV_BUFFER_STATISTICS_GRID_SIZE_MAX];
+	double grid_means[ARV_BUFFER_STATISTICS_GRID_SIZE_MAX * ARV_BUFFER_STATISTICS_GRID_SIZE_MAX];
+};
+
+/* Channels of the components, by row parity and component index modulo the period, 0xff for the ignored alpha
+ * components. The Bayer formats have one component per pixel. */
+
+static const struct {
+	ArvPixelFormat pixel_format;
+	guint bit_depth;
+	guint period;
+	gboolean is_bayer;
+	guint8 channels[2][4];
+} arv_buffer_statistics_formats[] = {
+	{ARV_PIXEL_FORMAT_MONO_8,		 8, 1, FALSE, {{0}, {0}}},
+	{ARV_PIXEL_FORMAT_MONO_10,		10, 1, FALSE, {{0}, {0}}},
+	{ARV_PIXEL_FORMAT_MONO_12,		12, 1, FALSE, {{0}, {0}}},
+	{ARV_PIXEL_FORMAT_MONO_14,		14, 1, FALSE, {{0}, {0}}},
+	{ARV_PIXEL_FORMAT_MONO_16,		16, 1, FALSE, {{0}, {0}}},
+	{ARV_PIXEL_FORMAT_BAYER_GR_8,		 8, 2, TRUE, {{1, 0}, {2, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_RG_8,		 8, 2, TRUE, {{0, 1}, {1, 2}}},
+	{ARV_PIXEL_FORMAT_BAYER_GB_8,		 8, 2, TRUE, {{1, 2}, {0, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_BG_8,		 8, 2, TRUE, {{2, 1}, {1, 0}}},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10,		10, 2, TRUE, {{1, 0}, {2, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10,		10, 2, TRUE, {{0, 1}, {1, 2}}},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10,		10, 2, TRUE, {{1, 2}, {0, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10,		10, 2, TRUE, {{2, 1}, {1, 0}}},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12,		12, 2, TRUE, {{1, 0}, {2, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12,		12, 2, TRUE, {{0, 1}, {1, 2}}},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12,		12, 2, TRUE, {{1, 2}, {0, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12,		12, 2, TRUE, {{2, 1}, {1, 0}}},
+	{ARV_PIXEL_FORMAT_BAYER_GR_16,		16, 2, TRUE, {{1, 0}, {2, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_RG_16,		16, 2, TRUE, {{0, 1}, {1, 2}}},
+	{ARV_PIXEL_FORMAT_BAYER_GB_16,		16, 2, TRUE, {{1, 2}, {0, 1}}},
+	{ARV_PIXEL_FORMAT_BAYER_BG_16,		16, 2, TRUE, {{2, 1}, {1, 0}}},
+	{ARV_PIXEL_FORMAT_RGB_8_PACKED,		 8, 3, FALSE, {{0, 1, 2}, {0, 1, 2}}},
+	{ARV_PIXEL_FORMAT_BGR_8_PACKED,		 8, 3, FALSE, {{2, 1, 0}, {2, 1, 0}}},
+	{ARV_PIXEL_FORMAT_RGBA_8_PACKED,	 8, 4, FALSE, {{0, 1, 2, 0xff}, {0, 1, 2, 0xff}}},
+	{ARV_PIXEL_FORMAT_BGRA_8_PACKED,	 8, 4, FALSE, {{2, 1, 0, 0xff}, {2, 1, 0, 0xff}}},
+};
+
+static gboolean
+_setup_layout (ArvBufferStatistics *stats, ArvBuffer *buffer, guint grid_size)
+{
+	ArvPixelFormat pixel_format = buffer->priv->pixel_format;
+	size_t n_row_components;
+	size_t i;
+
+	if (!arv_buffer_payload_type_has_aoi (buffer->priv->payload_type))
+		return FALSE;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_buffer_statistics_formats); i++)
+		if (arv_buffer_statistics_formats[i].pixel_format == pixel_format)
+			break;
+	if (i == G_N_ELEMENTS (arv_buffer_statistics_formats))
+		return FALSE;
+
+	stats->period = arv_buffer_statistics_formats[i].period;
+	stats->n_pixel_components = arv_buffer_statistics_formats[i].is_bayer ? 1 : stats->period;
+	stats->n_channels = stats->period > 1 ? 3 : 1;
+	stats->component_size = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (pixel_format) / stats->n_pixel_components / 8;
+	stats->shift = arv_buffer_statistics_formats[i].bit_depth - 8;
+	stats->saturation = (1u << arv_buffer_statistics_formats[i].bit_depth) - 1;
+	memcpy (stats->channels, arv_buffer_statistics_formats[i].channels, sizeof (stats->channels));
+
+	stats->pixel_format = pixel_format;
+	stats->width = buffer->priv->width;
+	stats->height = buffer->priv->height;
+	n_row_components = (size_t) stats->width * stats->n_pixel_components;
+	stats->row_size = n_row_components * stats->component_size;
+	stats->stride = stats->row_size + buffer->priv->x_padding;
+
+	if (stats->width == 0 || stats->height == 0 || stats->stride % stats->component_size != 0 ||
+	    stats->stride * (stats->height - 1) + stats->row_size > buffer->priv->allocated_size)
+		return FALSE;
+
+	stats->requested_grid_size = grid_size;
+	stats->grid_size = MIN (grid_size, ARV_BUFFER_STATISTICS_GRID_SIZE_MAX);
+	stats->grid_size = MIN (stats->grid_size, MIN (stats->width, stats->height));
+	if (stats->grid_size > 0) {
+		if (n_row_components > stats->n_allocated_grid_columns) {
+			g_free (stats->grid_columns);
+			stats->grid_columns = g_malloc (n_row_components);
+			stats->n_allocated_grid_columns = n_row_components;
+		}
+		for (i = 0; i < n_row_components; i++)
+			stats->grid_columns[i] = (i / stats->n_pixel_components) * stats->grid_size / stats->width;
+	}
+
+	return TRUE;
+}
+
+static void
+_reset_accumulators (ArvBufferStatistics *stats)
+{
+	guint i;
+
+	memset (stats->histograms, 0, sizeof (stats->histograms));
+	memset (stats->sums, 0, sizeof (stats->sums));
+	memset (stats->n_saturated, 0, sizeof (stats->n_saturated));
+	memset (stats->grid_sums, 0, sizeof (stats->grid_sums));
+	memset (stats->grid_counts, 0, sizeof (stats->grid_counts));
+	for (i = 0; i < ARV_BUFFER_STATISTICS_N_CHANNELS_MAX; i++) {
+		stats->minimums[i] = G_MAXUINT32;
+		stats->maximums[i] = 0;
+	}
+}
+
+/* One function per component size, the value loads being the only difference */
+
+#define ARV_BUFFER_STATISTICS_ACCUMULATE_ROW(name, type)						\
+static void												\
+name (ArvBufferStatistics *stats, const guint8 *row_data, size_t row,					\
+      size_t first_component, size_t end_component)							\
+{													\
+	const type *values = (const type *) row_data;							\
+	const guint8 *channels = stats->channels[row & 1];						\
+	guint64 *grid_sums = NULL;									\
+	guint64 *grid_counts = NULL;									\
+	guint period = stats->period;									\
+	guint shift = stats->shift;									\
+	guint32 saturation = stats->saturation;								\
+	guint k = first_component % period;								\
+	size_t i;											\
+													\
+	if (stats->grid_size > 0) {									\
+		size_t grid_row = row * stats->grid_size / stats->height;				\
+													\
+		grid_sums = &stats->grid_sums[grid_row * stats->grid_size];				\
+		grid_counts = &stats->grid_counts[grid_row * stats->grid_size];				\
+	}												\
+													\
+	for (i = first_component; i < end_component; i++) {						\
+		guint channel = channels[k];								\
+		guint32 value = values[i];								\
+													\
+		k = k + 1 == period ? 0 : k + 1;							\
+		if (channel == ARV_BUFFER_STATISTICS_IGNORED_COMPONENT)					\
+			continue;									\
+													\
+		value = MIN (value, saturation);							\
+		stats->histograms[channel][value >> shift]++;						\
+		stats->sums[channel] += value;								\
+		stats->minimums[channel] = MIN (stats->minimums[channel], value);			\
+		stats->maximums[channel] = MAX (stats->maximums[channel], value);			\
+		stats->n_saturated[channel] += value == saturation;					\
+		if (grid_sums != NULL) {								\
+			grid_sums[stats->grid_columns[i]] += value;					\
+			grid_counts[stats->grid_columns[i]]++;						\
+		}											\
+	}												\
+}
+
+ARV_BUFFER_STATISTICS_ACCUMULATE_ROW (_accumulate_row_8, guint8)
+ARV_BUFFER_STATISTICS_ACCUMULATE_ROW (_accumulate_row_16, guint16)
+
+static void
+_accumulate (ArvBufferStatistics *stats, const guint8 *data, size_t offset, size_t size)
+{
+	size_t image_size = stats->stride * (stats->height - 1) + stats->row_size;
+	size_t end = MIN (offset + size, image_size);
+
+	while (offset < end) {
+		size_t row = offset / stats->stride;
+		size_t row_start = row * stats->stride;
+		size_t first = offset - row_start;
+		size_t last = MIN (stats->row_size, end - row_start);
+
+		if (first < last) {
+			if (stats->component_size == 1)
+				_accumulate_row_8 (stats, data + row_start, row, first, last);
+			else
+				_accumulate_row_16 (stats, data + row_start, row,
+						    first / 2, last / 2);
+		}
+
+		offset = row_start + stats->stride;
+	}
+}
+
+/* Called by the stream threads once the image layout is known. The image is processed in one pass on completion if
+ * its pixel format can't be accumulated block by block. */
+
+void
+arv_buffer_statistics_start (ArvBuffer *buffer, guint grid_size)
+{
+	ArvBufferStatistics *stats;
+
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (buffer->priv->statistics == NULL)
+		buffer->priv->statistics = g_new0 (ArvBufferStatistics, 1);
+
+	stats = buffer->priv->statistics;
+	stats->is_started = TRUE;
+	stats->is_complete = FALSE;
+	stats->needs_full_pass = !_setup_layout (stats, buffer, grid_size);
+
+	if (!stats->needs_full_pass)
+		_reset_accumulators (stats);
+}
+
+/* Adds a data block, once stored in the buffer. Each block must be added once. */
+
+void
+arv_buffer_statistics_add_block (ArvBuffer *buffer, size_t offset, size_t size)
+{
+	ArvBufferStatistics *stats = buffer->priv->statistics;
+
+	if (stats == NULL || !stats->is_started || stats->needs_full_pass)
+		return;
+
+	if (offset % stats->component_size != 0 || size % stats->component_size != 0) {
+		arv_debug_stream_thread ("[Buffer::statistics_add_block] Unaligned block at %" G_GSIZE_FORMAT
+					 ", statistics computed on completion", offset);
+		stats->needs_full_pass = TRUE;
+		return;
+	}
+
+	_accumulate (stats, buffer->priv->data, offset, size);
+}
+
+/* Invalidates the statistics of the previous image, when the buffer is popped from the input queue */
+
+void
+arv_buffer_statistics_clear (ArvBuffer *buffer)
+{
+	if (buffer->priv->statistics != NULL) {
+		buffer->priv->statistics->is_started = FALSE;
+		buffer->priv->statistics->is_complete = FALSE;
+	}
+}
+
+/* Completes the statistics, with a pass over the whole image if they were not accumulated block by block during the
+ * reception, or if the image layout changed since, for example after unpacking. */
+
+gboolean
+arv_buffer_statistics_finish (ArvBuffer *buffer, guint grid_size)
+{
+	ArvBufferStatistics *stats;
+	guint n_cells;
+	guint i, j;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	stats = buffer->priv->statistics;
+
+	if (stats == NULL || !stats->is_started || stats->needs_full_pass ||
+	    stats->pixel_format != buffer->priv->pixel_format ||
+	    stats->requested_grid_size != grid_size) {
+		if (stats == NULL)
+			buffer->priv->statistics = stats = g_new0 (ArvBufferStatistics, 1);
+
+		stats->is_started = FALSE;
+		stats->is_complete = FALSE;
+
+		if (!_setup_layout (stats, buffer, grid_size))
+			return FALSE;
+
+		_reset_accumulators (stats);
+		_accumulate (stats, buffer->priv->data, 0, stats->stride * stats->height);
+	}
+
+	for (i = 0; i < stats->n_channels; i++) {
+		stats->n_values[i] = 0;
+		for (j = 0; j < ARV_BUFFER_STATISTICS_N_BINS; j++)
+			stats->n_values[i] += stats->histograms[i][j];
+		stats->means[i] = stats->n_values[i] > 0 ? (double) stats->sums[i] / stats->n_values[i] : 0.0;
+		if (stats->n_values[i] == 0)
+			stats->minimums[i] = 0;
+	}
+
+	n_cells = stats->grid_size * stats->grid_size;
+	for (i = 0; i < n_cells; i++)
+		stats->grid_means[i] = stats->grid_counts[i] > 0 ?
+			(double) stats->grid_sums[i] / stats->grid_counts[i] : 0.0;
+
+	stats->is_started = FALSE;
+	stats->is_complete = TRUE;
+
+	return TRUE;
+}
+
+void
+arv_buffer_statistics_free (ArvBufferStatistics *stats)
+{
+	if (stats == NULL)
+		return;
+
+	g_free (stats->grid_columns);
+	g_free (stats);
+}
+
+static ArvBufferStatistics *
+_get_statistics (ArvBuffer *buffer, guint channel)
+{
+	ArvBufferStatistics *stats = buffer->priv->statistics;
+
+	if (stats == NULL || !stats->is_complete || buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS ||
+	    channel >= stats->n_channels)
+		return NULL;
+
+	return stats;
+}
+
+/**
+ * arv_buffer_has_statistics:
+ * @buffer: a #ArvBuffer
+ *
+ * Checks whether @buffer has the image statistics computed during the reception, when enabled by
+ * arv_stream_set_compute_statistics(). The statistics are available for the successfully received images of the
+ * 8 bit and unpacked monochrome, Bayer and RGB pixel formats.
+ *
+ * Returns: %TRUE if the statistics of the image are available.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_has_statistics (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	return _get_statistics (buffer, 0) != NULL;
+}
+
+/**
+ * arv_buffer_get_statistics_n_channels:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the number of channels of the image statistics, 1 for the monochrome images, or 3 for the color ones, the
+ * channels being then red, green and blue, in this order.
+ *
+ * Returns: the number of channels, 0 if @buffer has no statistics.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_buffer_get_statistics_n_channels (ArvBuffer *buffer)
+{
+	ArvBufferStatistics *stats;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	stats = _get_statistics (buffer, 0);
+
+	return stats != NULL ? stats->n_channels : 0;
+}
+
+/**
+ * arv_buffer_get_statistics_histogram:
+ * @buffer: a #ArvBuffer
+ * @channel: channel index
+ * @n_bins: (out) (optional): number of bins of the histogram
+ *
+ * Gets the histogram of a channel of the image, the bins being indexed by the 8 most significant bits of the pixel
+ * values.
+ *
+ * Returns: (array length=n_bins) (transfer none) (nullable): the pixel counts of the histogram bins, %NULL if
+ * @buffer has no statistics.
+ *
+ * Since: 0.8.24
+ */
+
+const guint32 *
+arv_buffer_get_statistics_histogram (ArvBuffer *buffer, guint channel, guint *n_bins)
+{
+	ArvBufferStatistics *stats;
+
+	if (n_bins != NULL)
+		*n_bins = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	stats = _get_statistics (buffer, channel);
+	if (stats == NULL)
+		return NULL;
+
+	if (n_bins != NULL)
+		*n_bins = ARV_BUFFER_STATISTICS_N_BINS;
+
+	return stats->histograms[channel];
+}
+
+/**
+ * arv_buffer_get_statistics_mean:
+ * @buffer: a #ArvBuffer
+ * @channel: channel index
+ *
+ * Returns: the mean pixel value of a channel of the image, in the pixel format unit, 0 if @buffer has no statistics.
+ *
+ * Since: 0.8.24
+ */
+
+double
+arv_buffer_get_statistics_mean (ArvBuffer *buffer, guint channel)
+{
+	ArvBufferStatistics *stats;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0.0);
+
+	stats = _get_statistics (buffer, channel);
+
+	return stats != NULL ? stats->means[channel] : 0.0;
+}
+
+/**
+ * arv_buffer_get_statistics_range:
+ * @buffer: a #ArvBuffer
+ * @channel: channel index
+ * @minimum: (out) (optional): minimum pixel value
+ * @maximum: (out) (optional): maximum pixel value
+ *
+ * Gets the pixel value range of a channel of the image, in the pixel format unit.
+ *
+ * Returns: %TRUE if @buffer has statistics.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_buffer_get_statistics_range (ArvBuffer *buffer, guint channel, guint *minimum, guint *maximum)
+{
+	ArvBufferStatistics *stats;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	stats = _get_statistics (buffer, channel);
+
+	if (minimum != NULL)
+		*minimum = stats != NULL ? stats->minimums[channel] : 0;
+	if (maximum != NULL)
+		*maximum = stats != NULL ? stats->maximums[channel] : 0;
+
+	return stats != NULL;
+}
+
+/**
+ * arv_buffer_get_statistics_n_saturated:
+ * @buffer: a #ArvBuffer
+ * @channel: channel index
+ *
+ * Returns: the number of pixels of a channel at the maximum value of the pixel format, 0 if @buffer has no
+ * statistics.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_buffer_get_statistics_n_saturated (ArvBuffer *buffer, guint channel)
+{
+	ArvBufferStatistics *stats;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	stats = _get_statistics (buffer, channel);
+
+	return stats != NULL ? stats->n_saturated[channel] : 0;
+}
+
+/**
+ * arv_buffer_get_statistics_grid_means:
+ * @buffer: a #ArvBuffer
+ * @grid_size: (out) (optional): number of rows and columns of the grid
+ *
+ * Gets the mean pixel values of the regions of a grid dividing the image, all channels included, when enabled by
+ * arv_stream_set_statistics_grid_size(). The means are stored row by row.
+ *
+ * Returns: (transfer none) (nullable): the grid_size × grid_size region means, %NULL if not available.
+ *
+ * Since: 0.8.24
+ */
+
+const double *
+arv_buffer_get_statistics_grid_means (ArvBuffer *buffer, guint *grid_size)
+{
+	ArvBufferStatistics *stats;
+
+	if (grid_size != NULL)
+		*grid_size = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	stats = _get_statistics (buffer, 0);
+	if (stats == NULL || stats->grid_size == 0)
+		return NULL;
+
+	if (grid_size != NULL)
+		*grid_size = stats->grid_size;
+
+	return stats->grid_means;
+}
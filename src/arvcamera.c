@@ -43,12 +43,18 @@
 #include <arvgcstring.h>
 #include <arvbuffer.h>
 #include <arvgc.h>
+#include <arvgcfeaturenodeprivate.h>
 #include <arvgvdevice.h>
 #if ARAVIS_HAS_USB
 #include <arvuvdevice.h>
 #endif
 #include <arvenums.h>
 #include <arvstr.h>
+#include <arvdebugprivate.h>
+#include <arvdeviceprivate.h>
+#include <arvstreamprivate.h>
+#include <arvbufferprivate.h>
+#include <math.h>
 
 static void arv_camera_get_integer_bounds_as_gint (ArvCamera *camera, const char *feature, gint *min, gint *max, GError **error);
 static void arv_camera_get_integer_bounds_as_guint (ArvCamera *camera, const char *feature, guint *min, guint *max, GError **error);
@@ -95,6 +101,20 @@ typedef enum {
 	ARV_CAMERA_SERIES_IMPERX_OTHER
 } ArvCameraSeries;
 
+typedef struct {
+	double target;
+	double tolerance;
+	double max_saturated_fraction;
+	double damping;
+	guint n_settling_frames;
+	double exposure_time_min;
+	double exposure_time_max;
+	double gain_min;
+	double gain_max;
+} ArvCameraAutoExposureSettings;
+
+typedef struct _ArvCameraAutoExposure ArvCameraAutoExposure;
+
 typedef struct {
 	char *name;
 	ArvDevice *device;
@@ -120,6 +140,34 @@ typedef struct {
 
         gboolean has_region_offset;
 
+	/* Features resolved at construction, for the vendor specific variations of the most used settings. A
+	 * NULL handle means the feature is missing, the accesses then use the feature name, for the error
+	 * report. */
+	ArvFeatureHandle *exposure_time;
+	const char *exposure_time_name;
+	ArvFeatureHandle *gain;
+	const char *gain_name;
+	ArvFeatureHandle *frame_rate;
+	const char *frame_rate_name;
+	gboolean frame_rate_is_fps_enumeration;
+	ArvFeatureHandle *frame_rate_enable;
+	ArvFeatureHandle *frame_rate_enabled;
+	ArvFeatureHandle *frame_rate_auto;
+
+	/* Last PayloadSize value, valid while the memo key of the feature is unchanged and not 0 */
+	ArvFeatureHandle *payload_size;
+	guint64 payload_memo_key;
+	guint payload;
+
+	/* Persistent snap stream, and the last snapped buffer, owned until the next snap */
+	ArvStream *snap_stream;
+	ArvBuffer *snap_buffer;
+	gboolean snap_software_trigger;
+
+	/* Host auto exposure settings, and the running controller */
+	ArvCameraAutoExposureSettings auto_exposure_settings;
+	ArvCameraAutoExposure *auto_exposure;
+
 	GError *init_error;
 } ArvCameraPrivate;
 
@@ -256,6 +304,44 @@ arv_camera_get_device_id (ArvCamera *camera, GError **error)
 	return arv_camera_get_string (camera, "DeviceID", error);
 }
 
+/* Accesses to the features resolved at construction, falling back to the feature name for the error report */
+
+static void
+_set_float (ArvCamera *camera, ArvFeatureHandle *handle, const char *feature, double value, GError **error)
+{
+	if (handle != NULL)
+		arv_feature_handle_set_float (handle, value, error);
+	else
+		arv_camera_set_float (camera, feature, value, error);
+}
+
+static double
+_get_float (ArvCamera *camera, ArvFeatureHandle *handle, const char *feature, GError **error)
+{
+	if (handle != NULL)
+		return arv_feature_handle_get_float (handle, error);
+
+	return arv_camera_get_float (camera, feature, error);
+}
+
+static void
+_set_integer (ArvCamera *camera, ArvFeatureHandle *handle, const char *feature, gint64 value, GError **error)
+{
+	if (handle != NULL)
+		arv_feature_handle_set_integer (handle, value, error);
+	else
+		arv_camera_set_integer (camera, feature, value, error);
+}
+
+static gint64
+_get_integer (ArvCamera *camera, ArvFeatureHandle *handle, const char *feature, GError **error)
+{
+	if (handle != NULL)
+		return arv_feature_handle_get_integer (handle, error);
+
+	return arv_camera_get_integer (camera, feature, error);
+}
+
 /* Image format control */
 
 /**
@@ -381,11 +467,16 @@ arv_camera_set_region (ArvCamera *camera, gint x, gint y, gint width, gint heigh
 void
 arv_camera_get_region (ArvCamera *camera, gint *x, gint *y, gint *width, gint *height, GError **error)
 {
+	static const char *region_features[] = {"OffsetX", "OffsetY", "Width", "Height", NULL};
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
 	GError *local_error = NULL;
 
 	g_return_if_fail (ARV_IS_CAMERA (camera));
 
+	/* Errors are reported by the individual feature reads */
+	arv_gc_prefetch_features (priv->genicam,
+				  priv->has_region_offset ? region_features : region_features + 2, NULL);
+
 	if (x != NULL)
 		*x = priv->has_region_offset ? arv_camera_get_integer (camera, "OffsetX", &local_error) : 0;
 	if (y != NULL && local_error == NULL)
@@ -791,6 +882,116 @@ arv_camera_dup_available_pixel_formats_as_display_names (ArvCamera *camera, guin
 
 /* Acquisition control */
 
+/* Builds the region table of a multiple region payload from the region selector configuration, the enabled regions
+ * being packed in the selector order. Returns NULL if less than two regions are enabled. */
+
+static GArray *
+_dup_regions (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *error = NULL;
+	GArray *regions;
+	const char **selectors;
+	char *selector;
+	gboolean has_region_mode;
+	size_t bits_per_pixel;
+	size_t offset = 0;
+	guint n_selectors = 0;
+	guint i;
+
+	bits_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_camera_get_pixel_format (camera, &error));
+	if (error != NULL || bits_per_pixel == 0) {
+		g_clear_error (&error);
+		return NULL;
+	}
+
+	selectors = arv_device_dup_available_enumeration_feature_values_as_strings (priv->device, "RegionSelector",
+										   &n_selectors, &error);
+	if (error != NULL || n_selectors < 2) {
+		g_clear_error (&error);
+		g_free (selectors);
+		return NULL;
+	}
+
+	selector = g_strdup (arv_device_get_string_feature_value (priv->device, "RegionSelector", NULL));
+	has_region_mode = ARV_IS_GC_ENUMERATION (arv_device_get_feature (priv->device, "RegionMode"));
+	regions = g_array_new (FALSE, TRUE, sizeof (ArvBufferRegionInfos));
+
+	for (i = 0; i < n_selectors && error == NULL; i++) {
+		ArvBufferRegionInfos infos;
+		const char *mode;
+
+		/* Skip the "All" entry */
+		if (!g_str_has_prefix (selectors[i], "Region"))
+			continue;
+
+		arv_device_set_string_feature_value (priv->device, "RegionSelector", selectors[i], &error);
+		if (error != NULL)
+			break;
+
+		if (has_region_mode) {
+			mode = arv_device_get_string_feature_value (priv->device, "RegionMode", &error);
+			if (error != NULL || g_strcmp0 (mode, "On") != 0)
+				continue;
+		}
+
+		infos.offset = offset;
+		infos.width = arv_device_get_integer_feature_value (priv->device, "Width", &error);
+		infos.height = arv_device_get_integer_feature_value (priv->device, "Height", &error);
+		infos.x_offset = arv_device_get_integer_feature_value (priv->device, "OffsetX", NULL);
+		infos.y_offset = arv_device_get_integer_feature_value (priv->device, "OffsetY", NULL);
+		if (error != NULL)
+			break;
+
+		g_array_append_val (regions, infos);
+		offset += (infos.width * bits_per_pixel + 7) / 8 * infos.height;
+
+		arv_debug_device ("[Camera::dup_regions] %s: %ux%u at (%u, %u), offset %zu", selectors[i],
+				  infos.width, infos.height, infos.x_offset, infos.y_offset, infos.offset);
+	}
+
+	if (selector != NULL)
+		arv_device_set_string_feature_value (priv->device, "RegionSelector", selector, NULL);
+
+	if (error != NULL) {
+		arv_warning_device ("[Camera::dup_regions] Failed to read the region configuration: %s",
+				    error->message);
+		g_clear_error (&error);
+		g_clear_pointer (&regions, g_array_unref);
+	} else if (regions->len < 2)
+		g_clear_pointer (&regions, g_array_unref);
+
+	g_free (selector);
+	g_free (selectors);
+
+	return regions;
+}
+
+/* Attaches the region table to the buffers of the streams of the cameras supporting multiple regions */
+
+static void
+_update_stream_regions (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GPtrArray *streams;
+	GArray *regions = NULL;
+	guint i;
+
+	if (!ARV_IS_GC_ENUMERATION (arv_device_get_feature (priv->device, "RegionSelector")))
+		return;
+
+	streams = arv_device_dup_streams (priv->device);
+	if (streams->len > 0)
+		regions = _dup_regions (camera);
+
+	for (i = 0; i < streams->len; i++)
+		arv_stream_set_regions (g_ptr_array_index (streams, i), regions);
+
+	if (regions != NULL)
+		g_array_unref (regions);
+	g_ptr_array_unref (streams);
+}
+
 /**
  * arv_camera_start_acquisition:
  * @camera: a #ArvCamera
@@ -798,12 +999,19 @@ arv_camera_dup_available_pixel_formats_as_display_names (ArvCamera *camera, guin
  *
  * Starts video stream acquisition.
  *
+ * On the cameras supporting multiple regions of interest, the enabled regions of the region selector are described
+ * in a table attached to the buffers of the camera streams, see arv_buffer_get_n_regions().
+ *
  * Since: 0.8.0
  */
 
 void
 arv_camera_start_acquisition (ArvCamera *camera, GError **error)
 {
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	_update_stream_regions (camera);
+
 	arv_camera_execute_command (camera, "AcquisitionStart", error);
 }
 
@@ -839,6 +1047,78 @@ arv_camera_abort_acquisition (ArvCamera *camera, GError **error)
 	arv_camera_execute_command (camera, "AcquisitionAbort", error);
 }
 
+/**
+ * arv_camera_begin_reconfiguration:
+ * @camera: a #ArvCamera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts a reconfiguration of a running acquisition, for example a region of interest or a pixel format change,
+ * without the teardown of the stream. The acquisition stop and the following feature writes are queued in a feature
+ * transaction, see arv_device_begin_transaction(), and sent to the device by arv_camera_end_reconfiguration().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_begin_reconfiguration (ArvCamera *camera, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_begin_transaction (priv->device);
+	arv_camera_stop_acquisition (camera, error);
+}
+
+/**
+ * arv_camera_end_reconfiguration:
+ * @camera: a #ArvCamera
+ * @stream: (allow-none): the #ArvStream of the running acquisition
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Ends the reconfiguration started by arv_camera_begin_reconfiguration(). The queued writes are sent to the device,
+ * the @stream buffers are grown if the payload size increased, using arv_stream_grow_buffers(), and the acquisition
+ * is restarted. The stream thread and its socket stay alive, and the first image of the new geometry is tagged, see
+ * arv_buffer_has_new_geometry(). The USB3 Vision streams read the payload size at their start, and still need to be
+ * recreated for a payload size increase.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_end_reconfiguration (ArvCamera *camera, ArvStream *stream, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	guint payload;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (stream == NULL || ARV_IS_STREAM (stream), FALSE);
+
+	if (!arv_device_commit (priv->device, &local_error)) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	payload = arv_camera_get_payload (camera, &local_error);
+	if (local_error == NULL && stream != NULL)
+		arv_stream_grow_buffers (stream, payload);
+
+	if (local_error == NULL)
+		arv_camera_start_acquisition (camera, &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_info_device ("[Camera::end_reconfiguration] Acquisition restarted with a %u bytes payload", payload);
+
+	return TRUE;
+}
+
 /**
  * arv_camera_acquisition:
  * @camera: a #ArvCamera
@@ -899,6 +1179,177 @@ arv_camera_acquisition (ArvCamera *camera, guint64 timeout, GError **error)
 	return buffer;
 }
 
+/**
+ * arv_camera_start_snap:
+ * @camera: a #ArvCamera
+ * @n_buffers: number of stream buffers, at least 2
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Prepares @camera for repeated single frame acquisitions using arv_camera_snap(). A stream is created with
+ * @n_buffers buffers, the camera is put in software trigger mode, if supported, and the acquisition is started, once
+ * for all the following snaps. Stream and device settings, like the packet size or the stream thread priority, are
+ * then kept between snaps. The camera stays in acquisition until arv_camera_stop_snap().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_start_snap (ArvCamera *camera, guint n_buffers, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	gint payload;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+
+	if (priv->snap_stream != NULL)
+		arv_camera_stop_snap (camera, NULL);
+
+	priv->snap_stream = arv_camera_create_stream (camera, NULL, NULL, &local_error);
+	if (!ARV_IS_STREAM (priv->snap_stream)) {
+		priv->snap_stream = NULL;
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	payload = arv_camera_get_payload (camera, &local_error);
+	for (i = 0; i < MAX (n_buffers, 2) && local_error == NULL; i++)
+		arv_stream_push_buffer (priv->snap_stream, arv_buffer_new (payload, NULL));
+
+	if (local_error == NULL)
+		arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, &local_error);
+
+	/* Without software trigger, the next frame of the free running acquisition is returned */
+	priv->snap_software_trigger = local_error == NULL && arv_camera_is_software_trigger_supported (camera, NULL);
+	if (priv->snap_software_trigger)
+		arv_camera_set_trigger (camera, "Software", &local_error);
+
+	if (local_error == NULL)
+		arv_camera_start_acquisition (camera, &local_error);
+
+	if (local_error != NULL) {
+		if (priv->snap_software_trigger)
+			arv_camera_clear_triggers (camera, NULL);
+		g_clear_object (&priv->snap_stream);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_snap:
+ * @camera: a #ArvCamera
+ * @timeout: acquisition timeout in µs. Zero means no timeout.
+ * @time_to_frame_us: (out) (optional): placeholder for the time between the request and the frame reception, in µs
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Acquires one image buffer, using the persistent stream set up by arv_camera_start_snap(), which is called with 2
+ * buffers on the first snap if needed. The frames received since the last snap are discarded, then a software
+ * trigger is sent and the resulting frame is returned. Without software trigger support, the next frame of the
+ * continuous acquisition is returned, its exposure may have started before the call.
+ *
+ * The returned buffer stays owned by @camera, and is valid until the next call to arv_camera_snap() or
+ * arv_camera_stop_snap(). This avoids any buffer allocation after the first snap.
+ *
+ * Returns: (transfer none): the acquired #ArvBuffer, which status must be checked, or %NULL on error or timeout.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_camera_snap (ArvCamera *camera, guint64 timeout, guint64 *time_to_frame_us, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	ArvBuffer *buffer;
+	gint64 start_time_us;
+
+	if (time_to_frame_us != NULL)
+		*time_to_frame_us = 0;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+
+	if (priv->snap_stream == NULL &&
+	    !arv_camera_start_snap (camera, 2, error))
+		return NULL;
+
+	if (priv->snap_buffer != NULL) {
+		arv_stream_push_buffer (priv->snap_stream, priv->snap_buffer);
+		priv->snap_buffer = NULL;
+	}
+
+	/* Discard the stale frames */
+	while ((buffer = arv_stream_try_pop_buffer (priv->snap_stream)) != NULL)
+		arv_stream_push_buffer (priv->snap_stream, buffer);
+
+	start_time_us = g_get_monotonic_time ();
+
+	if (priv->snap_software_trigger) {
+		arv_camera_software_trigger (camera, &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return NULL;
+		}
+	}
+
+	if (timeout > 0)
+		buffer = arv_stream_timeout_pop_buffer (priv->snap_stream, timeout);
+	else
+		buffer = arv_stream_pop_buffer (priv->snap_stream);
+
+	if (buffer == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+			     "No frame received in %" G_GUINT64_FORMAT " µs", timeout);
+		return NULL;
+	}
+
+	if (time_to_frame_us != NULL)
+		*time_to_frame_us = g_get_monotonic_time () - start_time_us;
+
+	priv->snap_buffer = buffer;
+
+	return buffer;
+}
+
+/**
+ * arv_camera_stop_snap:
+ * @camera: a #ArvCamera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Stops the acquisition started by arv_camera_start_snap(), clears the triggers set for the snaps, and releases the
+ * snap stream and buffers, including the last buffer returned by arv_camera_snap().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_stop_snap (ArvCamera *camera, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	if (priv->snap_stream == NULL)
+		return;
+
+	arv_camera_stop_acquisition (camera, &local_error);
+	if (priv->snap_software_trigger)
+		arv_camera_clear_triggers (camera, local_error == NULL ? &local_error : NULL);
+
+	g_clear_object (&priv->snap_buffer);
+	g_clear_object (&priv->snap_stream);
+	priv->snap_software_trigger = FALSE;
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+}
+
 /*
  * arv_camera_set_acquisition_mode:
  * @camera: a #ArvCamera
@@ -1028,19 +1479,19 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 {
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
 	GError *local_error = NULL;
-	ArvGcNode *feature;
 	double minimum;
 	double maximum;
 
 	g_return_if_fail (ARV_IS_CAMERA (camera));
 
 	if (frame_rate <= 0.0) {
-		if (arv_camera_is_feature_available (camera, "AcquisitionFrameRateEnable", &local_error)) {
+		if (priv->frame_rate_enable != NULL &&
+		    arv_feature_handle_is_available (priv->frame_rate_enable, &local_error)) {
 			if (local_error == NULL)
-				arv_camera_set_boolean (camera, "AcquisitionFrameRateEnable", FALSE, error);
-			else
-				g_propagate_error (error, local_error);
+				arv_feature_handle_set_boolean (priv->frame_rate_enable, FALSE, error);
 		}
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
 		return;
 	}
 
@@ -1062,26 +1513,24 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 	switch (priv->vendor) {
 		case ARV_CAMERA_VENDOR_BASLER:
 			if (local_error == NULL){
-				if (arv_camera_is_feature_available (camera, "AcquisitionFrameRateEnable", &local_error)){
+				if (priv->frame_rate_enable != NULL &&
+				    arv_feature_handle_is_available (priv->frame_rate_enable, &local_error)){
 					/* enable is optional on some devices */
 					if (local_error == NULL)
-						arv_camera_set_boolean (camera, "AcquisitionFrameRateEnable", TRUE, &local_error);
+						arv_feature_handle_set_boolean (priv->frame_rate_enable, TRUE,
+										&local_error);
 				}
 			}
 			if (local_error == NULL)
-				arv_camera_set_float (camera,
-						      priv->has_acquisition_frame_rate ?
-						      "AcquisitionFrameRate":
-						      "AcquisitionFrameRateAbs", frame_rate, &local_error);
+				_set_float (camera, priv->frame_rate, priv->frame_rate_name, frame_rate, &local_error);
 			break;
 		case ARV_CAMERA_VENDOR_PROSILICA:
 			if (local_error == NULL)
-				arv_camera_set_float (camera, "AcquisitionFrameRateAbs", frame_rate, &local_error);
+				_set_float (camera, priv->frame_rate, priv->frame_rate_name, frame_rate, &local_error);
 			break;
 		case ARV_CAMERA_VENDOR_TIS:
 			if (local_error == NULL) {
-				feature = arv_device_get_feature (priv->device, "FPS");
-				if (ARV_IS_GC_ENUMERATION (feature)) {
+				if (priv->frame_rate_is_fps_enumeration) {
 					gint64 *values;
 					guint n_values;
 					guint i;
@@ -1093,28 +1542,33 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 
 							e = (int)((10000000/(double) values[i]) * 100 + 0.5) / 100.0;
 							if (e == frame_rate) {
-								arv_camera_set_integer (camera, "FPS", values[i], &local_error);
+								_set_integer (camera, priv->frame_rate,
+									      priv->frame_rate_name, values[i],
+									      &local_error);
 								break;
 							}
 						}
 					}
 					g_free (values);
 				} else
-					arv_camera_set_float (camera, "FPS", frame_rate, &local_error);
+					_set_float (camera, priv->frame_rate, priv->frame_rate_name, frame_rate,
+						    &local_error);
 			}
 			break;
 		case ARV_CAMERA_VENDOR_POINT_GREY_FLIR:
 			if (local_error == NULL) {
-				if (priv->has_acquisition_frame_rate_enabled)
-					arv_camera_set_boolean (camera, "AcquisitionFrameRateEnabled", TRUE, &local_error);
+				if (priv->frame_rate_enabled != NULL)
+					arv_feature_handle_set_boolean (priv->frame_rate_enabled, TRUE, &local_error);
+				else if (priv->frame_rate_enable != NULL)
+					arv_feature_handle_set_boolean (priv->frame_rate_enable, TRUE, &local_error);
 				else
 					arv_camera_set_boolean (camera, "AcquisitionFrameRateEnable", TRUE, &local_error);
 			}
 			if (local_error == NULL)
-				if (priv->has_acquisition_frame_rate_auto)
-					arv_camera_set_string (camera, "AcquisitionFrameRateAuto", "Off", &local_error);
+				if (priv->frame_rate_auto != NULL)
+					arv_feature_handle_set_string (priv->frame_rate_auto, "Off", &local_error);
 			if (local_error == NULL)
-				arv_camera_set_float (camera, "AcquisitionFrameRate", frame_rate, &local_error);
+				_set_float (camera, priv->frame_rate, priv->frame_rate_name, frame_rate, &local_error);
 			break;
 		case ARV_CAMERA_VENDOR_DALSA:
 		case ARV_CAMERA_VENDOR_RICOH:
@@ -1123,16 +1577,16 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 		case ARV_CAMERA_VENDOR_IMPERX:
 		case ARV_CAMERA_VENDOR_UNKNOWN:
                         if (local_error == NULL) {
-                                if (arv_camera_is_feature_available (camera, "AcquisitionFrameRateEnable", &local_error)) {
+                                if (priv->frame_rate_enable != NULL &&
+                                    arv_feature_handle_is_available (priv->frame_rate_enable, &local_error)) {
                                         if (local_error == NULL)
-                                                arv_camera_set_boolean (camera, "AcquisitionFrameRateEnable", TRUE, &local_error);
+                                                arv_feature_handle_set_boolean (priv->frame_rate_enable, TRUE,
+                                                                                &local_error);
                                 }
                         }
                         if (local_error == NULL)
-                                arv_camera_set_float (camera,
-                                                      priv->has_acquisition_frame_rate ?
-                                                      "AcquisitionFrameRate":
-                                                      "AcquisitionFrameRateAbs", frame_rate, &local_error);
+                                _set_float (camera, priv->frame_rate, priv->frame_rate_name, frame_rate,
+                                            &local_error);
                         break;
         }
 
@@ -1154,27 +1608,25 @@ double
 arv_camera_get_frame_rate (ArvCamera *camera, GError **error)
 {
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
-	ArvGcNode *feature;
 
 	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0);
 
 	switch (priv->vendor) {
 		case ARV_CAMERA_VENDOR_PROSILICA:
-			return arv_camera_get_float (camera, "AcquisitionFrameRateAbs", error);
+			return _get_float (camera, priv->frame_rate, priv->frame_rate_name, error);
 		case ARV_CAMERA_VENDOR_TIS:
 			{
-				feature = arv_device_get_feature (priv->device, "FPS");
-				if (ARV_IS_GC_ENUMERATION (feature)) {
+				if (priv->frame_rate_is_fps_enumeration) {
 					gint64 i;
 
-					i = arv_camera_get_integer (camera, "FPS", error);
+					i = _get_integer (camera, priv->frame_rate, priv->frame_rate_name, error);
 
 					if (i > 0)
 						return (int)((10000000/(double) i) * 100 + 0.5) / 100.0;
 					else
 						return 0;
 				} else
-					return arv_camera_get_float (camera, "FPS", error);
+					return _get_float (camera, priv->frame_rate, priv->frame_rate_name, error);
 			}
 		case ARV_CAMERA_VENDOR_POINT_GREY_FLIR:
 		case ARV_CAMERA_VENDOR_DALSA:
@@ -1184,10 +1636,7 @@ arv_camera_get_frame_rate (ArvCamera *camera, GError **error)
 		case ARV_CAMERA_VENDOR_MATRIX_VISION:
 		case ARV_CAMERA_VENDOR_IMPERX:
 		case ARV_CAMERA_VENDOR_UNKNOWN:
-			return arv_camera_get_float (camera,
-						     priv->has_acquisition_frame_rate ?
-						     "AcquisitionFrameRate": "AcquisitionFrameRateAbs",
-						     error);
+			return _get_float (camera, priv->frame_rate, priv->frame_rate_name, error);
 	}
 
 	return 0;
@@ -1209,14 +1658,12 @@ void
 arv_camera_get_frame_rate_bounds (ArvCamera *camera, double *min, double *max, GError **error)
 {
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
-	ArvGcNode *feature;
 
 	g_return_if_fail (ARV_IS_CAMERA (camera));
 
 	switch (priv->vendor) {
 		case ARV_CAMERA_VENDOR_TIS:
-			feature = arv_device_get_feature (priv->device, "FPS");
-			if (ARV_IS_GC_ENUMERATION (feature)) {
+			if (priv->frame_rate_is_fps_enumeration) {
 				GError *local_error = NULL;
 				gint64 *values;
 				guint n_values;
@@ -1536,23 +1983,21 @@ arv_camera_set_exposure_time (ArvCamera *camera, double exposure_time_us, GError
 				arv_camera_set_integer (camera, "ExposureTimeRaw", 1, &local_error);
 			break;
 		case ARV_CAMERA_SERIES_RICOH:
-			arv_camera_set_integer (camera, "ExposureTimeRaw", exposure_time_us, &local_error);
-			break;
 		case ARV_CAMERA_SERIES_XIMEA:
-			arv_camera_set_integer (camera, "ExposureTime", exposure_time_us, &local_error);
+			_set_integer (camera, priv->exposure_time, priv->exposure_time_name, exposure_time_us,
+				      &local_error);
 			break;
 		case ARV_CAMERA_SERIES_IMPERX_CHEETAH:
 		case ARV_CAMERA_SERIES_MATRIX_VISION:
 			arv_camera_set_string (camera, "ExposureMode", "Timed", &local_error);
 			if (local_error == NULL)
-				arv_camera_set_float (camera, "ExposureTime", exposure_time_us, &local_error);
+				_set_float (camera, priv->exposure_time, priv->exposure_time_name, exposure_time_us,
+					    &local_error);
 			break;
 		case ARV_CAMERA_SERIES_BASLER_ACE:
 		default:
-			arv_camera_set_float (camera,
-					      priv->has_exposure_time ?
-					      "ExposureTime" :
-					      "ExposureTimeAbs", exposure_time_us, &local_error);
+			_set_float (camera, priv->exposure_time, priv->exposure_time_name, exposure_time_us,
+				    &local_error);
 			break;
 	}
 
@@ -1579,14 +2024,10 @@ arv_camera_get_exposure_time (ArvCamera *camera, GError **error)
 
 	switch (priv->series) {
 		case ARV_CAMERA_SERIES_XIMEA:
-			return arv_camera_get_integer (camera,"ExposureTime", error);
 		case ARV_CAMERA_SERIES_RICOH:
-			return arv_camera_get_integer (camera,"ExposureTimeRaw", error);
+			return _get_integer (camera, priv->exposure_time, priv->exposure_time_name, error);
 		default:
-			return arv_camera_get_float (camera,
-						     priv->has_exposure_time ?
-						     "ExposureTime" :
-						     "ExposureTimeAbs", error);
+			return _get_float (camera, priv->exposure_time, priv->exposure_time_name, error);
 	}
 }
 
@@ -1714,16 +2155,10 @@ arv_camera_set_gain (ArvCamera *camera, double gain, GError **error)
 	if (gain < 0)
 		return;
 
-	if (priv->has_gain)
-		arv_camera_set_float (camera, "Gain", gain, error);
-	else {
-		if (priv->gain_raw_as_float)
-			arv_camera_set_float (camera, "GainRaw", gain, error);
-		else if (priv->gain_abs_as_float)
-			arv_camera_set_float (camera, "GainAbs", gain, error);
-		else
-			arv_camera_set_integer (camera, "GainRaw", gain, error);
-	}
+	if (priv->has_gain || priv->gain_raw_as_float || priv->gain_abs_as_float)
+		_set_float (camera, priv->gain, priv->gain_name, gain, error);
+	else
+		_set_integer (camera, priv->gain, priv->gain_name, gain, error);
 }
 
 /**
@@ -1743,14 +2178,10 @@ arv_camera_get_gain (ArvCamera *camera, GError **error)
 
 	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0.0);
 
-	if (priv->has_gain)
-		return arv_camera_get_float (camera, "Gain", error);
-	else if (priv->gain_raw_as_float)
-		return arv_camera_get_float (camera, "GainRaw", error);
-	else if (priv->gain_abs_as_float)
-		return arv_camera_get_float (camera, "GainAbs", error);
+	if (priv->has_gain || priv->gain_raw_as_float || priv->gain_abs_as_float)
+		return _get_float (camera, priv->gain, priv->gain_name, error);
 
-	return arv_camera_get_integer (camera, "GainRaw", error);
+	return _get_integer (camera, priv->gain, priv->gain_name, error);
 }
 
 /**
@@ -1960,6 +2391,431 @@ arv_camera_get_black_level_auto (ArvCamera *camera, GError **error)
 	return arv_auto_from_string (arv_camera_get_string (camera, "BlackLevelAuto", error));
 }
 
+/* Host auto exposure */
+
+/* Controller state, shared by the stream stage and the writer thread. The stage owns a reference, dropped with the
+ * stream stages, and the camera another one, until the controller is stopped. */
+
+struct _ArvCameraAutoExposure {
+	gint ref_count;
+	gint is_running;
+
+	ArvDevice *device;
+	ArvFeatureHandle *exposure_time;
+	gboolean exposure_time_is_integer;
+	ArvFeatureHandle *gain;
+	gboolean gain_is_integer;
+
+	/* Settings and pending writes, protected by the mutex */
+	GMutex mutex;
+	ArvCameraAutoExposureSettings settings;
+	double pending_exposure_time;
+	double pending_gain;
+	gboolean is_write_pending;
+
+	/* Device bounds, read on start */
+	double exposure_time_min;
+	double exposure_time_max;
+	double gain_min;
+	double gain_max;
+
+	/* Only used by the stream stage */
+	double exposure_time_us;
+	double gain_db;
+	guint n_settling_frames;
+
+	GThreadPool *writer;
+};
+
+static ArvCameraAutoExposure *
+_auto_exposure_ref (ArvCameraAutoExposure *auto_exposure)
+{
+	g_atomic_int_inc (&auto_exposure->ref_count);
+
+	return auto_exposure;
+}
+
+static void
+_auto_exposure_unref (void *data)
+{
+	ArvCameraAutoExposure *auto_exposure = data;
+
+	if (!g_atomic_int_dec_and_test (&auto_exposure->ref_count))
+		return;
+
+	/* The last reference is never held by the writer thread */
+	if (auto_exposure->writer != NULL)
+		g_thread_pool_free (auto_exposure->writer, FALSE, TRUE);
+	g_mutex_clear (&auto_exposure->mutex);
+	g_object_unref (auto_exposure->device);
+	g_free (auto_exposure);
+}
+
+/* Applies the last computed setting, exposure time and gain being written in one feature transaction */
+
+static void
+_auto_exposure_write (gpointer data, gpointer user_data)
+{
+	ArvCameraAutoExposure *auto_exposure = user_data;
+	GError *error = NULL;
+	double exposure_time_us;
+	double gain;
+
+	g_mutex_lock (&auto_exposure->mutex);
+	exposure_time_us = auto_exposure->pending_exposure_time;
+	gain = auto_exposure->pending_gain;
+	auto_exposure->is_write_pending = FALSE;
+	g_mutex_unlock (&auto_exposure->mutex);
+
+	if (!g_atomic_int_get (&auto_exposure->is_running))
+		return;
+
+	arv_device_begin_transaction (auto_exposure->device);
+
+	if (auto_exposure->exposure_time_is_integer)
+		arv_feature_handle_set_integer (auto_exposure->exposure_time, exposure_time_us, &error);
+	else
+		arv_feature_handle_set_float (auto_exposure->exposure_time, exposure_time_us, &error);
+
+	if (error == NULL && auto_exposure->gain != NULL) {
+		if (auto_exposure->gain_is_integer)
+			arv_feature_handle_set_integer (auto_exposure->gain, gain, &error);
+		else
+			arv_feature_handle_set_float (auto_exposure->gain, gain, &error);
+	}
+
+	if (error == NULL)
+		arv_device_commit (auto_exposure->device, &error);
+	else
+		arv_device_commit (auto_exposure->device, NULL);
+
+	if (error != NULL) {
+		arv_warning_device ("[Camera::auto_exposure_write] Failed to apply exposure %g µs, gain %g: %s",
+				    exposure_time_us, gain, error->message);
+		g_clear_error (&error);
+	} else
+		arv_debug_device ("[Camera::auto_exposure_write] Exposure %g µs, gain %g", exposure_time_us, gain);
+}
+
+/* Stream stage, run in the stream thread on the statistics of each completed buffer */
+
+static void
+_auto_exposure_stage (ArvBuffer *buffer, void *user_data)
+{
+	ArvCameraAutoExposure *auto_exposure = user_data;
+	ArvCameraAutoExposureSettings settings;
+	double exposure_min, exposure_max, gain_min, gain_max;
+	double level = 0.0, saturated_fraction;
+	double ratio, brightness, exposure_time_us, gain_db;
+	guint64 n_values = 0, n_saturated = 0;
+	guint n_channels;
+	guint i, j;
+
+	if (!g_atomic_int_get (&auto_exposure->is_running) ||
+	    !arv_buffer_has_statistics (buffer))
+		return;
+
+	/* The frames exposed before the last setting reached the camera */
+	if (auto_exposure->n_settling_frames > 0) {
+		auto_exposure->n_settling_frames--;
+		return;
+	}
+
+	/* Mean level and saturation of all the channels, relative to the full scale of the pixel format */
+	n_channels = arv_buffer_get_statistics_n_channels (buffer);
+	for (i = 0; i < n_channels; i++) {
+		const guint32 *histogram = arv_buffer_get_statistics_histogram (buffer, i, NULL);
+
+		for (j = 0; j < 256; j++) {
+			level += (j + 0.5) * histogram[j];
+			n_values += histogram[j];
+		}
+		n_saturated += arv_buffer_get_statistics_n_saturated (buffer, i);
+	}
+	if (n_values == 0)
+		return;
+	level /= 256.0 * n_values;
+	saturated_fraction = (double) n_saturated / n_values;
+
+	g_mutex_lock (&auto_exposure->mutex);
+	settings = auto_exposure->settings;
+	g_mutex_unlock (&auto_exposure->mutex);
+
+	if (saturated_fraction > settings.max_saturated_fraction)
+		ratio = 0.5;
+	else if (fabs (level - settings.target) > settings.tolerance)
+		ratio = settings.target / MAX (level, 0.5 / 256.0);
+	else
+		return;
+
+	exposure_min = MAX (settings.exposure_time_min, auto_exposure->exposure_time_min);
+	exposure_max = MAX (MIN (settings.exposure_time_max, auto_exposure->exposure_time_max), exposure_min);
+	gain_min = MAX (settings.gain_min, auto_exposure->gain_min);
+	gain_max = MAX (MIN (settings.gain_max, auto_exposure->gain_max), gain_min);
+
+	/* Proportional control of the logarithm of the brightness, the exposure time being increased before the gain,
+	 * in dB, and the gain decreased before the exposure time */
+	brightness = auto_exposure->exposure_time_us * pow (10.0, (auto_exposure->gain_db - gain_min) / 20.0) *
+		pow (ratio, settings.damping);
+	exposure_time_us = CLAMP (brightness, exposure_min, exposure_max);
+	gain_db = auto_exposure->gain != NULL ?
+		CLAMP (gain_min + 20.0 * log10 (brightness / exposure_time_us), gain_min, gain_max) :
+		auto_exposure->gain_db;
+
+	if (auto_exposure->exposure_time_is_integer)
+		exposure_time_us = round (exposure_time_us);
+	if (auto_exposure->gain_is_integer)
+		gain_db = round (gain_db);
+
+	if (exposure_time_us == auto_exposure->exposure_time_us && gain_db == auto_exposure->gain_db)
+		return;
+
+	auto_exposure->exposure_time_us = exposure_time_us;
+	auto_exposure->gain_db = gain_db;
+	auto_exposure->n_settling_frames = settings.n_settling_frames;
+
+	/* Only the last setting is written if the writer thread is late */
+	g_mutex_lock (&auto_exposure->mutex);
+	auto_exposure->pending_exposure_time = exposure_time_us;
+	auto_exposure->pending_gain = gain_db;
+	if (!auto_exposure->is_write_pending) {
+		auto_exposure->is_write_pending = TRUE;
+		g_thread_pool_push (auto_exposure->writer, GINT_TO_POINTER (1), NULL);
+	}
+	g_mutex_unlock (&auto_exposure->mutex);
+}
+
+/**
+ * arv_camera_start_host_auto_exposure:
+ * @camera: a #ArvCamera
+ * @stream: the #ArvStream of @camera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts an exposure control loop running on the host, as a replacement of the camera auto exposure modes. The
+ * statistics of the images received by @stream, enabled by this function, are used for the computation of the next
+ * exposure time and gain, in a stage of @stream, see arv_stream_add_stage(). The mean level of the images is driven
+ * to the target set by arv_camera_set_host_auto_exposure_target(), by proportional steps of the logarithm of the
+ * brightness, see arv_camera_set_host_auto_exposure_controller(). The exposure time is used before the gain, which is
+ * assumed to be in dB. The new settings are written by a dedicated thread, exposure time and gain being sent in a
+ * single feature transaction, without blocking the stream thread.
+ *
+ * The camera auto exposure and auto gain are switched off. The loop runs until arv_camera_stop_host_auto_exposure(),
+ * or until @camera is destroyed.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_start_host_auto_exposure (ArvCamera *camera, ArvStream *stream, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvCameraAutoExposure *auto_exposure;
+	GError *local_error = NULL;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	arv_camera_stop_host_auto_exposure (camera);
+
+	if (priv->exposure_time == NULL || priv->series == ARV_CAMERA_SERIES_BASLER_SCOUT) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+			     "No exposure time feature usable for host auto exposure");
+		return FALSE;
+	}
+
+	auto_exposure = g_new0 (ArvCameraAutoExposure, 1);
+	auto_exposure->ref_count = 1;
+	auto_exposure->device = g_object_ref (priv->device);
+	auto_exposure->exposure_time = priv->exposure_time;
+	auto_exposure->exposure_time_is_integer = priv->series == ARV_CAMERA_SERIES_RICOH ||
+		priv->series == ARV_CAMERA_SERIES_XIMEA;
+	auto_exposure->gain = priv->gain;
+	auto_exposure->gain_is_integer = !(priv->has_gain || priv->gain_raw_as_float || priv->gain_abs_as_float);
+	auto_exposure->settings = priv->auto_exposure_settings;
+	g_mutex_init (&auto_exposure->mutex);
+
+	if (arv_camera_is_exposure_auto_available (camera, NULL))
+		arv_camera_set_exposure_time_auto (camera, ARV_AUTO_OFF, NULL);
+	if (auto_exposure->gain != NULL && arv_camera_is_gain_auto_available (camera, NULL))
+		arv_camera_set_gain_auto (camera, ARV_AUTO_OFF, NULL);
+
+	auto_exposure->exposure_time_us = arv_camera_get_exposure_time (camera, &local_error);
+	if (local_error == NULL)
+		arv_camera_get_exposure_time_bounds (camera, &auto_exposure->exposure_time_min,
+						     &auto_exposure->exposure_time_max, &local_error);
+	/* Also selects the timed exposure mode of some cameras */
+	if (local_error == NULL)
+		arv_camera_set_exposure_time (camera, auto_exposure->exposure_time_us, &local_error);
+	if (local_error == NULL && auto_exposure->gain != NULL) {
+		auto_exposure->gain_db = arv_camera_get_gain (camera, &local_error);
+		if (local_error == NULL)
+			arv_camera_get_gain_bounds (camera, &auto_exposure->gain_min, &auto_exposure->gain_max,
+						    &local_error);
+	}
+	if (local_error == NULL)
+		auto_exposure->writer = g_thread_pool_new (_auto_exposure_write, auto_exposure, 1, FALSE,
+							   &local_error);
+
+	if (local_error != NULL) {
+		_auto_exposure_unref (auto_exposure);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	auto_exposure->is_running = TRUE;
+	priv->auto_exposure = auto_exposure;
+
+	arv_stream_set_compute_statistics (stream, TRUE);
+	arv_stream_add_stage (stream, _auto_exposure_stage, _auto_exposure_ref (auto_exposure),
+			      _auto_exposure_unref, ARV_STREAM_STAGE_MODE_INLINE);
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_stop_host_auto_exposure:
+ * @camera: a #ArvCamera
+ *
+ * Stops the exposure control loop started by arv_camera_start_host_auto_exposure(). The last exposure time and gain
+ * settings are kept.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_stop_host_auto_exposure (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	if (priv->auto_exposure == NULL)
+		return;
+
+	/* The stage stays in the stream, doing nothing */
+	g_atomic_int_set (&priv->auto_exposure->is_running, FALSE);
+	g_clear_pointer (&priv->auto_exposure, _auto_exposure_unref);
+}
+
+/**
+ * arv_camera_is_host_auto_exposure_running:
+ * @camera: a #ArvCamera
+ *
+ * Returns: %TRUE if the control loop started by arv_camera_start_host_auto_exposure() is running.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_is_host_auto_exposure_running (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+
+	return priv->auto_exposure != NULL;
+}
+
+static void
+_update_auto_exposure_settings (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	if (priv->auto_exposure == NULL)
+		return;
+
+	g_mutex_lock (&priv->auto_exposure->mutex);
+	priv->auto_exposure->settings = priv->auto_exposure_settings;
+	g_mutex_unlock (&priv->auto_exposure->mutex);
+}
+
+/**
+ * arv_camera_set_host_auto_exposure_target:
+ * @camera: a #ArvCamera
+ * @target: target mean level, as a fraction of the full scale of the pixel format, defaults to 0.45
+ * @tolerance: accepted deviation of the mean level from @target, defaults to 0.02
+ * @max_saturated_fraction: fraction of saturated pixels above which the brightness is halved, defaults to 0.01
+ *
+ * Sets the target of the host auto exposure, which can be changed while it is running.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_set_host_auto_exposure_target (ArvCamera *camera, double target, double tolerance,
+					  double max_saturated_fraction)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+	g_return_if_fail (target > 0.0 && target < 1.0);
+
+	priv->auto_exposure_settings.target = target;
+	priv->auto_exposure_settings.tolerance = MAX (tolerance, 0.0);
+	priv->auto_exposure_settings.max_saturated_fraction = CLAMP (max_saturated_fraction, 0.0, 1.0);
+
+	_update_auto_exposure_settings (camera);
+}
+
+/**
+ * arv_camera_set_host_auto_exposure_controller:
+ * @camera: a #ArvCamera
+ * @damping: fraction of the brightness correction applied at each step, in the logarithmic domain, between 0 and 1,
+ * defaults to 0.5
+ * @n_settling_frames: number of frames ignored after each setting change, for the latency of the camera, defaults
+ * to 2
+ *
+ * Tunes the response of the host auto exposure, a @damping of 1 applying the full correction in one step.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_set_host_auto_exposure_controller (ArvCamera *camera, double damping, guint n_settling_frames)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+	g_return_if_fail (damping > 0.0 && damping <= 1.0);
+
+	priv->auto_exposure_settings.damping = damping;
+	priv->auto_exposure_settings.n_settling_frames = n_settling_frames;
+
+	_update_auto_exposure_settings (camera);
+}
+
+/**
+ * arv_camera_set_host_auto_exposure_limits:
+ * @camera: a #ArvCamera
+ * @min_exposure_time_us: minimum exposure time, in µs
+ * @max_exposure_time_us: maximum exposure time, in µs, for example for keeping the frame rate
+ * @min_gain: minimum gain
+ * @max_gain: maximum gain, for example for limiting the noise
+ *
+ * Restricts the exposure time and gain ranges used by the host auto exposure, the device bounds being used by
+ * default.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_set_host_auto_exposure_limits (ArvCamera *camera, double min_exposure_time_us, double max_exposure_time_us,
+					  double min_gain, double max_gain)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	priv->auto_exposure_settings.exposure_time_min = min_exposure_time_us;
+	priv->auto_exposure_settings.exposure_time_max = max_exposure_time_us;
+	priv->auto_exposure_settings.gain_min = min_gain;
+	priv->auto_exposure_settings.gain_max = max_gain;
+
+	_update_auto_exposure_settings (camera);
+}
+
 /* Transport layer control */
 
 /**
@@ -1978,7 +2834,32 @@ arv_camera_get_black_level_auto (ArvCamera *camera, GError **error)
 guint
 arv_camera_get_payload (ArvCamera *camera, GError **error)
 {
-	return arv_camera_get_integer (camera, "PayloadSize", error);
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	guint64 memo_key;
+	guint payload;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0);
+
+	if (priv->payload_size == NULL)
+		return arv_camera_get_integer (camera, "PayloadSize", error);
+
+	/* Is computed from unchanged register values */
+	memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (priv->payload_size));
+	if (memo_key != 0 && memo_key == priv->payload_memo_key)
+		return priv->payload;
+
+	payload = arv_feature_handle_get_integer (priv->payload_size, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		priv->payload_memo_key = 0;
+		return 0;
+	}
+
+	priv->payload = payload;
+	priv->payload_memo_key = memo_key;
+
+	return payload;
 }
 
 /**
@@ -2694,6 +3575,30 @@ arv_camera_is_feature_available (ArvCamera *camera, const char *feature, GError
 	return arv_device_is_feature_available (priv->device, feature, error);
 }
 
+/**
+ * arv_camera_get_feature_handle:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Resolves @feature once, for repeated accesses using the arv_feature_handle functions, for example
+ * arv_feature_handle_set_float(), which skip the feature lookup by name.
+ *
+ * Returns: (transfer none): a handle on @feature, valid as long as @camera, %NULL if the feature doesn't exist.
+ *
+ * Since: 0.8.24
+ */
+
+ArvFeatureHandle *
+arv_camera_get_feature_handle (ArvCamera *camera, const char *feature, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+
+	return arv_device_get_feature_handle (priv->device, feature, error);
+}
+
 /**
  * arv_camera_set_register_cache_policy:
  * @camera: a #ArvCamera
@@ -2841,6 +3746,36 @@ arv_camera_gv_select_stream_channel (ArvCamera *camera, gint channel_id, GError
 	arv_camera_set_integer (camera, "GevStreamChannelSelector", channel_id, error);
 }
 
+/**
+ * arv_camera_gv_create_stream_for_channel:
+ * @camera: a #ArvCamera
+ * @channel_id: id of the stream channel
+ * @callback: (scope notified) (allow-none): a frame processing callback
+ * @user_data: (closure) (allow-none): user data for @callback
+ * @destroy: a #GDestroyNotify placeholder, %NULL to ignore
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new [class@ArvStream] for the reception of the stream channel @channel_id. Streams of different channels
+ * of the same camera can be received concurrently, each one with its own statistics. See
+ * [method@ArvGvDevice.create_stream_for_channel].
+ *
+ * Returns: (transfer full): a new [class@ArvStream], to be freed after use with [method@GObject.Object.unref].
+ *
+ * Since: 0.8.24
+ */
+
+ArvStream *
+arv_camera_gv_create_stream_for_channel (ArvCamera *camera, guint channel_id, ArvStreamCallback callback,
+					 gpointer user_data, GDestroyNotify destroy, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_val_if_fail (arv_camera_is_gv_device (camera), NULL);
+
+	return arv_gv_device_create_stream_for_channel (ARV_GV_DEVICE (priv->device), channel_id,
+							callback, user_data, destroy, error);
+}
+
 /**
  * arv_camera_gv_get_current_stream_channel:
  * @camera: a #ArvCamera
@@ -3058,6 +3993,28 @@ arv_camera_gv_set_stream_options (ArvCamera *camera, ArvGvStreamOption options)
 	arv_gv_device_set_stream_options (ARV_GV_DEVICE (priv->device), options);
 }
 
+/**
+ * arv_camera_gv_set_stream_multicast_group:
+ * @camera: a #ArvCamera
+ * @group: (nullable): an IPv4 multicast address, %NULL for unicast streaming
+ * @port: stream destination port, 0 for an automatically allocated one
+ *
+ * Sets a multicast group as stream destination, see arv_gv_device_set_stream_multicast_group(). It must be called
+ * before arv_camera_create_stream().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_gv_set_stream_multicast_group (ArvCamera *camera, GInetAddress *group, guint16 port)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (arv_camera_is_gv_device (camera));
+
+	arv_gv_device_set_stream_multicast_group (ARV_GV_DEVICE (priv->device), group, port);
+}
+
 /**
  * arv_camera_gv_set_packet_size_adjustment:
  * @camera: a #ArvCamera
@@ -3078,6 +4035,27 @@ arv_camera_gv_set_packet_size_adjustment (ArvCamera *camera, ArvGvPacketSizeAdju
 	arv_gv_device_set_packet_size_adjustment (ARV_GV_DEVICE (priv->device), adjustment);
 }
 
+/**
+ * arv_camera_gv_set_packet_size_alignment:
+ * @camera: a #ArvCamera
+ * @alignment: payload alignment, in bytes, 0 for none
+ *
+ * Makes the packet size adjustment prefer the packet sizes whose payload is a multiple of @alignment. See
+ * arv_gv_device_set_packet_size_alignment().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_gv_set_packet_size_alignment (ArvCamera *camera, guint alignment)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (arv_camera_is_gv_device (camera));
+
+	arv_gv_device_set_packet_size_alignment (ARV_GV_DEVICE (priv->device), alignment);
+}
+
 /**
  * arv_camera_gv_get_persistent_ip:
  * @camera: a #ArvCamera
@@ -3198,6 +4176,42 @@ arv_camera_gv_set_ip_configuration_mode (ArvCamera *camera, ArvGvIpConfiguration
 	arv_gv_device_set_ip_configuration_mode (ARV_GV_DEVICE (priv->device), mode, error);
 }
 
+/**
+ * arv_camera_gv_set_action_keys:
+ * @camera: a #ArvCamera
+ * @action_id: the action index, as used by the ActionSelector feature, starting at 1
+ * @device_key: the device key
+ * @group_key: the group key of the action
+ * @group_mask: the group mask of the action
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Configures the keys the action commands sent by arv_gv_device_issue_action_command() are matched against. The
+ * corresponding trigger source is usually named "Action1" for the first action.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_gv_set_action_keys (ArvCamera *camera, guint action_id,
+			       guint32 device_key, guint32 group_key, guint32 group_mask,
+			       GError **error)
+{
+	GError *local_error = NULL;
+
+	g_return_if_fail (arv_camera_is_gv_device (camera));
+
+	arv_camera_set_integer (camera, "ActionDeviceKey", device_key, &local_error);
+	if (local_error == NULL && arv_camera_is_feature_available (camera, "ActionSelector", NULL))
+		arv_camera_set_integer (camera, "ActionSelector", action_id, &local_error);
+	if (local_error == NULL)
+		arv_camera_set_integer (camera, "ActionGroupKey", group_key, &local_error);
+	if (local_error == NULL)
+		arv_camera_set_integer (camera, "ActionGroupMask", group_mask, &local_error);
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+}
+
 /**
  * arv_camera_is_uv_device:
  * @camera: a #ArvCamera
@@ -3619,6 +4633,17 @@ arv_camera_new_with_device (ArvDevice *device, GError **error)
 static void
 arv_camera_init (ArvCamera *camera)
 {
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	priv->auto_exposure_settings.target = 0.45;
+	priv->auto_exposure_settings.tolerance = 0.02;
+	priv->auto_exposure_settings.max_saturated_fraction = 0.01;
+	priv->auto_exposure_settings.damping = 0.5;
+	priv->auto_exposure_settings.n_settling_frames = 2;
+	priv->auto_exposure_settings.exposure_time_min = 0.0;
+	priv->auto_exposure_settings.exposure_time_max = G_MAXDOUBLE;
+	priv->auto_exposure_settings.gain_min = -G_MAXDOUBLE;
+	priv->auto_exposure_settings.gain_max = G_MAXDOUBLE;
 }
 
 static void
@@ -3626,6 +4651,9 @@ arv_camera_finalize (GObject *object)
 {
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (ARV_CAMERA (object));
 
+	arv_camera_stop_snap (ARV_CAMERA (object), NULL);
+	arv_camera_stop_host_auto_exposure (ARV_CAMERA (object));
+
 	g_clear_pointer (&priv->name, g_free);
 	g_clear_object (&priv->device);
 	g_clear_error (&priv->init_error);
@@ -3735,6 +4763,50 @@ arv_camera_constructed (GObject *object)
 
         priv->has_region_offset = ARV_IS_GC_INTEGER(arv_device_get_feature(priv->device, "OffsetX")) &&
                 ARV_IS_GC_INTEGER(arv_device_get_feature(priv->device, "OffsetY"));
+
+	switch (series) {
+		case ARV_CAMERA_SERIES_XIMEA:
+			priv->exposure_time_name = "ExposureTime";
+			break;
+		case ARV_CAMERA_SERIES_RICOH:
+			priv->exposure_time_name = "ExposureTimeRaw";
+			break;
+		default:
+			priv->exposure_time_name = priv->has_exposure_time ? "ExposureTime" : "ExposureTimeAbs";
+			break;
+	}
+	priv->exposure_time = arv_device_get_feature_handle (priv->device, priv->exposure_time_name, NULL);
+	priv->payload_size = arv_device_get_feature_handle (priv->device, "PayloadSize", NULL);
+
+	if (priv->has_gain)
+		priv->gain_name = "Gain";
+	else if (priv->gain_abs_as_float && !priv->gain_raw_as_float)
+		priv->gain_name = "GainAbs";
+	else
+		priv->gain_name = "GainRaw";
+	priv->gain = arv_device_get_feature_handle (priv->device, priv->gain_name, NULL);
+
+	switch (vendor) {
+		case ARV_CAMERA_VENDOR_PROSILICA:
+			priv->frame_rate_name = "AcquisitionFrameRateAbs";
+			break;
+		case ARV_CAMERA_VENDOR_TIS:
+			priv->frame_rate_name = "FPS";
+			priv->frame_rate_is_fps_enumeration = ARV_IS_GC_ENUMERATION (arv_device_get_feature (priv->device,
+													     "FPS"));
+			break;
+		default:
+			priv->frame_rate_name = priv->has_acquisition_frame_rate ?
+				"AcquisitionFrameRate" : "AcquisitionFrameRateAbs";
+			break;
+	}
+	priv->frame_rate = arv_device_get_feature_handle (priv->device, priv->frame_rate_name, NULL);
+	priv->frame_rate_enable = arv_device_get_feature_handle (priv->device, "AcquisitionFrameRateEnable", NULL);
+	if (priv->has_acquisition_frame_rate_enabled)
+		priv->frame_rate_enabled = arv_device_get_feature_handle (priv->device, "AcquisitionFrameRateEnabled",
+									  NULL);
+	if (priv->has_acquisition_frame_rate_auto)
+		priv->frame_rate_auto = arv_device_get_feature_handle (priv->device, "AcquisitionFrameRateAuto", NULL);
 }
 
 static void
@@ -93,9 +93,16 @@ ARV_API const char **	arv_camera_dup_available_pixel_formats_as_display_names	(A
 ARV_API void		arv_camera_start_acquisition		(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_stop_acquisition		(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_abort_acquisition		(ArvCamera *camera, GError **error);
+ARV_API void		arv_camera_begin_reconfiguration	(ArvCamera *camera, GError **error);
+ARV_API gboolean	arv_camera_end_reconfiguration		(ArvCamera *camera, ArvStream *stream, GError **error);
 
 ARV_API ArvBuffer *	arv_camera_acquisition			(ArvCamera *camera, guint64 timeout, GError **error);
 
+ARV_API gboolean	arv_camera_start_snap			(ArvCamera *camera, guint n_buffers, GError **error);
+ARV_API ArvBuffer *	arv_camera_snap				(ArvCamera *camera, guint64 timeout, guint64 *time_to_frame_us,
+								 GError **error);
+ARV_API void		arv_camera_stop_snap			(ArvCamera *camera, GError **error);
+
 ARV_API void			arv_camera_set_acquisition_mode (ArvCamera *camera, ArvAcquisitionMode value, GError **error);
 ARV_API ArvAcquisitionMode	arv_camera_get_acquisition_mode (ArvCamera *camera, GError **error);
 
@@ -148,6 +155,19 @@ ARV_API void		arv_camera_get_black_level_bounds	(ArvCamera *camera, double *min,
 ARV_API void		arv_camera_set_black_level_auto		(ArvCamera *camera, ArvAuto auto_mode, GError **error);
 ARV_API ArvAuto		arv_camera_get_black_level_auto		(ArvCamera *camera, GError **error);
 
+/* Host auto exposure */
+
+ARV_API gboolean	arv_camera_start_host_auto_exposure		(ArvCamera *camera, ArvStream *stream, GError **error);
+ARV_API void		arv_camera_stop_host_auto_exposure		(ArvCamera *camera);
+ARV_API gboolean	arv_camera_is_host_auto_exposure_running	(ArvCamera *camera);
+ARV_API void		arv_camera_set_host_auto_exposure_target	(ArvCamera *camera, double target, double tolerance,
+									 double max_saturated_fraction);
+ARV_API void		arv_camera_set_host_auto_exposure_controller	(ArvCamera *camera, double damping,
+									 guint n_settling_frames);
+ARV_API void		arv_camera_set_host_auto_exposure_limits	(ArvCamera *camera,
+									 double min_exposure_time_us, double max_exposure_time_us,
+									 double min_gain, double max_gain);
+
 /* Transport layer control */
 
 ARV_API guint		arv_camera_get_payload			(ArvCamera *camera, GError **error);
@@ -183,6 +203,7 @@ ARV_API gboolean        arv_camera_is_enumeration_entry_available
 										 const char *entry, GError **error);
 
 ARV_API gboolean	arv_camera_is_feature_available			(ArvCamera *camera, const char *feature, GError **error);
+ARV_API ArvFeatureHandle *	arv_camera_get_feature_handle		(ArvCamera *camera, const char *feature, GError **error);
 
 /* Runtime policies */
 
@@ -197,6 +218,9 @@ ARV_API gboolean	arv_camera_is_gv_device				(ArvCamera *camera);
 ARV_API gint		arv_camera_gv_get_n_stream_channels		(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_gv_select_stream_channel		(ArvCamera *camera, gint channel_id, GError **error);
 ARV_API int		arv_camera_gv_get_current_stream_channel	(ArvCamera *camera, GError **error);
+ARV_API ArvStream *	arv_camera_gv_create_stream_for_channel		(ArvCamera *camera, guint channel_id,
+									 ArvStreamCallback callback, void *user_data,
+									 GDestroyNotify destroy, GError **error);
 
 ARV_API void		arv_camera_gv_set_packet_delay			(ArvCamera *camera, gint64 delay_ns, GError **error);
 ARV_API gint64		arv_camera_gv_get_packet_delay			(ArvCamera *camera, GError **error);
@@ -205,8 +229,10 @@ ARV_API guint		arv_camera_gv_get_packet_size			(ArvCamera *camera, GError **erro
 ARV_API guint		arv_camera_gv_auto_packet_size			(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_gv_set_packet_size_adjustment	(ArvCamera *camera,
 									 ArvGvPacketSizeAdjustment adjustment);
+ARV_API void		arv_camera_gv_set_packet_size_alignment		(ArvCamera *camera, guint alignment);
 
 ARV_API void		arv_camera_gv_set_stream_options		(ArvCamera *camera, ArvGvStreamOption options);
+ARV_API void		arv_camera_gv_set_stream_multicast_group	(ArvCamera *camera, GInetAddress *group, guint16 port);
 
 ARV_API void		arv_camera_gv_get_persistent_ip			(ArvCamera *camera, GInetAddress **ip, GInetAddressMask **mask, GInetAddress **gateway, GError **error);
 ARV_API void		arv_camera_gv_set_persistent_ip_from_string	(ArvCamera *camera, const char *ip, const char *mask, const char *gateway, GError **error);
@@ -214,6 +240,10 @@ ARV_API void		arv_camera_gv_set_persistent_ip			(ArvCamera *camera, GInetAddress
 ARV_API ArvGvIpConfigurationMode	arv_camera_gv_get_ip_configuration_mode	(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_gv_set_ip_configuration_mode		(ArvCamera *camera, ArvGvIpConfigurationMode mode, GError **error);
 
+ARV_API void		arv_camera_gv_set_action_keys			(ArvCamera *camera, guint action_id,
+									 guint32 device_key, guint32 group_key,
+									 guint32 group_mask, GError **error);
+
 ARV_API gboolean	arv_camera_is_uv_device				(ArvCamera *camera);
 ARV_API gboolean	arv_camera_uv_is_bandwidth_control_available	(ArvCamera *camera, GError **error);
 ARV_API void		arv_camera_uv_set_bandwidth			(ArvCamera *camera, guint bandwidth, GError **error);
@@ -232,6 +262,32 @@ ARV_API gboolean		arv_camera_get_chunk_state		(ArvCamera *camera, const char *ch
 ARV_API void			arv_camera_set_chunks			(ArvCamera *camera, const char *chunk_list, GError **error);
 ARV_API ArvChunkParser *	arv_camera_create_chunk_parser		(ArvCamera *camera);
 
+/* Bulk transfers */
+
+/**
+ * ArvCameraProgressCallback:
+ * @n_bytes: number of bytes already transferred
+ * @n_total_bytes: total number of bytes to transfer
+ * @user_data: the user data passed to the transfer function
+ *
+ * Progress report of a bulk transfer.
+ *
+ * Returns: %FALSE to cancel the transfer.
+ *
+ * Since: 0.8.24
+ */
+
+typedef gboolean (*ArvCameraProgressCallback)	(guint64 n_bytes, guint64 n_total_bytes, void *user_data);
+
+ARV_API gboolean		arv_camera_set_lut			(ArvCamera *camera, const char *lut_selector,
+									 const gint64 *values, guint n_values,
+									 ArvCameraProgressCallback callback, void *user_data,
+									 GError **error);
+ARV_API gboolean		arv_camera_write_file			(ArvCamera *camera, const char *file_selector,
+									 const void *data, size_t size,
+									 ArvCameraProgressCallback callback, void *user_data,
+									 GError **error);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,457 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvCameraGroup:
+ *
+ * [class@ArvCameraGroup] manages many cameras with few threads, for the setups with tens of low rate cameras, where
+ * a receive thread per stream is the main cost.
+ *
+ * The GigE Vision streams created through the group share a pool of receive threads, each one waiting for the
+ * packets of several stream sockets at once, using epoll on Linux. The streams are assigned to the least loaded
+ * thread. Only the standard socket method is used on a shared thread: the multi-threaded receive, busy polling and
+ * the packet socket, io_uring, XDP and kernel module methods are not available, and the stream callbacks are called
+ * from the shared thread. Streams of the other protocols keep their own thread.
+ *
+ * The heartbeats of all the GigE Vision devices are already sent by a single scheduler thread, whatever the number
+ * of devices.
+ *
+ * The group keeps a reference on its cameras and streams until it is destroyed.
+ */
+
+#include <arvcameragroup.h>
+#include <arvgvstream.h>
+#include <arvgvstreamprivate.h>
+#include <arvdebugprivate.h>
+
+typedef struct {
+	guint n_receive_threads;
+
+	GMutex mutex;
+
+	GPtrArray *cameras;
+	GPtrArray *streams;
+	GPtrArray *workers;
+} ArvCameraGroupPrivate;
+
+struct _ArvCameraGroup {
+	GObject	object;
+
+	ArvCameraGroupPrivate *priv;
+};
+
+struct _ArvCameraGroupClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvCameraGroup, arv_camera_group, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvCameraGroup))
+
+/* Returns the least loaded worker, creating a new one while the pool is not full and all the workers are busy. Called
+ * with the mutex held. */
+
+static ArvGvStreamWorker *
+_get_worker (ArvCameraGroupPrivate *priv)
+{
+	ArvGvStreamWorker *worker = NULL;
+	guint n_streams = 0;
+	guint i;
+
+	for (i = 0; i < priv->workers->len; i++) {
+		ArvGvStreamWorker *candidate = g_ptr_array_index (priv->workers, i);
+		guint n_candidate_streams = arv_gv_stream_worker_get_n_streams (candidate);
+
+		if (worker == NULL || n_candidate_streams < n_streams) {
+			worker = candidate;
+			n_streams = n_candidate_streams;
+		}
+	}
+
+	if ((worker == NULL || n_streams > 0) && priv->workers->len < priv->n_receive_threads) {
+		worker = arv_gv_stream_worker_new ();
+		g_ptr_array_add (priv->workers, worker);
+
+		arv_info_stream ("[CameraGroup::get_worker] Receive thread %u/%u started",
+				 priv->workers->len, priv->n_receive_threads);
+	}
+
+	return worker;
+}
+
+/**
+ * arv_camera_group_new:
+ * @n_receive_threads: the maximum number of receive threads, 0 for the number of processors
+ *
+ * Returns: (transfer full): a new empty #ArvCameraGroup.
+ *
+ * Since: 0.8.24
+ */
+
+ArvCameraGroup *
+arv_camera_group_new (guint n_receive_threads)
+{
+	ArvCameraGroup *group;
+
+	group = g_object_new (ARV_TYPE_CAMERA_GROUP, NULL);
+	group->priv->n_receive_threads = n_receive_threads > 0 ? n_receive_threads : g_get_num_processors ();
+
+	return group;
+}
+
+/**
+ * arv_camera_group_add_camera:
+ * @group: a #ArvCameraGroup
+ * @camera: a #ArvCamera
+ *
+ * Adds a camera to the group. Adding a camera twice returns its existing index.
+ *
+ * Returns: the index of the camera in the group.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_camera_group_add_camera (ArvCameraGroup *group, ArvCamera *camera)
+{
+	guint index;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), 0);
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0);
+
+	g_mutex_lock (&group->priv->mutex);
+
+	for (index = 0; index < group->priv->cameras->len; index++)
+		if (g_ptr_array_index (group->priv->cameras, index) == camera)
+			break;
+
+	if (index == group->priv->cameras->len)
+		g_ptr_array_add (group->priv->cameras, g_object_ref (camera));
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	return index;
+}
+
+/**
+ * arv_camera_group_get_n_cameras:
+ * @group: a #ArvCameraGroup
+ *
+ * Returns: the number of cameras of @group.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_camera_group_get_n_cameras (ArvCameraGroup *group)
+{
+	guint n_cameras;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), 0);
+
+	g_mutex_lock (&group->priv->mutex);
+	n_cameras = group->priv->cameras->len;
+	g_mutex_unlock (&group->priv->mutex);
+
+	return n_cameras;
+}
+
+/**
+ * arv_camera_group_get_camera:
+ * @group: a #ArvCameraGroup
+ * @index: a camera index
+ *
+ * Returns: (transfer none): the camera of index @index, or %NULL if out of range.
+ *
+ * Since: 0.8.24
+ */
+
+ArvCamera *
+arv_camera_group_get_camera (ArvCameraGroup *group, guint index)
+{
+	ArvCamera *camera = NULL;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), NULL);
+
+	g_mutex_lock (&group->priv->mutex);
+	if (index < group->priv->cameras->len)
+		camera = g_ptr_array_index (group->priv->cameras, index);
+	g_mutex_unlock (&group->priv->mutex);
+
+	return camera;
+}
+
+/**
+ * arv_camera_group_create_stream:
+ * @group: a #ArvCameraGroup
+ * @index: a camera index
+ * @callback: (scope call) (closure user_data) (nullable): a frame processing callback
+ * @user_data: (nullable): user data for @callback
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a stream for the camera of index @index, like arv_camera_create_stream(). The packets of a GigE Vision
+ * stream are received by one of the shared receive threads of the group, which also calls @callback.
+ *
+ * Returns: (transfer full): a new #ArvStream, or %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvStream *
+arv_camera_group_create_stream (ArvCameraGroup *group, guint index, ArvStreamCallback callback, void *user_data,
+				GError **error)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), NULL);
+
+	camera = arv_camera_group_get_camera (group, index);
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+
+	stream = arv_camera_create_stream (camera, callback, user_data, error);
+	if (stream == NULL)
+		return NULL;
+
+	g_mutex_lock (&group->priv->mutex);
+
+	/* The stream thread started by the stream creation is stopped, the stream running from now on the worker */
+	if (ARV_IS_GV_STREAM (stream))
+		arv_gv_stream_set_worker (ARV_GV_STREAM (stream), _get_worker (group->priv));
+
+	g_ptr_array_add (group->priv->streams, g_object_ref (stream));
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	return stream;
+}
+
+/**
+ * arv_camera_group_start_acquisition:
+ * @group: a #ArvCameraGroup
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts the acquisition of all the cameras. On error, the acquisitions already started are stopped.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_group_start_acquisition (ArvCameraGroup *group, GError **error)
+{
+	GError *local_error = NULL;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), FALSE);
+
+	g_mutex_lock (&group->priv->mutex);
+
+	for (i = 0; i < group->priv->cameras->len && local_error == NULL; i++)
+		arv_camera_start_acquisition (g_ptr_array_index (group->priv->cameras, i), &local_error);
+
+	if (local_error != NULL) {
+		/* i is past the failed camera */
+		for (i = i - 1; i > 0; i--)
+			arv_camera_stop_acquisition (g_ptr_array_index (group->priv->cameras, i - 1), NULL);
+	}
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_group_stop_acquisition:
+ * @group: a #ArvCameraGroup
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Stops the acquisition of all the cameras, even if some of them fail.
+ *
+ * Returns: %TRUE on success, %FALSE if a camera failed, @error being set to its error.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_group_stop_acquisition (ArvCameraGroup *group, GError **error)
+{
+	GError *first_error = NULL;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), FALSE);
+
+	g_mutex_lock (&group->priv->mutex);
+
+	for (i = 0; i < group->priv->cameras->len; i++) {
+		GError *local_error = NULL;
+
+		arv_camera_stop_acquisition (g_ptr_array_index (group->priv->cameras, i), &local_error);
+		if (local_error != NULL) {
+			if (first_error == NULL)
+				first_error = local_error;
+			else
+				g_error_free (local_error);
+		}
+	}
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	if (first_error != NULL) {
+		g_propagate_error (error, first_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_group_get_n_receive_threads:
+ * @group: a #ArvCameraGroup
+ *
+ * Returns: the number of shared receive threads currently running, which is at most the number given to
+ * arv_camera_group_new().
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_camera_group_get_n_receive_threads (ArvCameraGroup *group)
+{
+	guint n_threads;
+
+	g_return_val_if_fail (ARV_IS_CAMERA_GROUP (group), 0);
+
+	g_mutex_lock (&group->priv->mutex);
+	n_threads = group->priv->workers->len;
+	g_mutex_unlock (&group->priv->mutex);
+
+	return n_threads;
+}
+
+/**
+ * arv_camera_group_get_statistics:
+ * @group: a #ArvCameraGroup
+ * @n_completed_buffers: (out) (optional): total number of completed buffers
+ * @n_failures: (out) (optional): total number of failures
+ * @n_underruns: (out) (optional): total number of underruns
+ *
+ * Sums the statistics of all the streams created by the group, as given by arv_stream_get_statistics().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_camera_group_get_statistics (ArvCameraGroup *group,
+				 guint64 *n_completed_buffers,
+				 guint64 *n_failures,
+				 guint64 *n_underruns)
+{
+	guint64 total_completed_buffers = 0;
+	guint64 total_failures = 0;
+	guint64 total_underruns = 0;
+	guint i;
+
+	g_return_if_fail (ARV_IS_CAMERA_GROUP (group));
+
+	g_mutex_lock (&group->priv->mutex);
+
+	for (i = 0; i < group->priv->streams->len; i++) {
+		guint64 n_stream_completed_buffers;
+		guint64 n_stream_failures;
+		guint64 n_stream_underruns;
+
+		arv_stream_get_statistics (g_ptr_array_index (group->priv->streams, i),
+					   &n_stream_completed_buffers, &n_stream_failures, &n_stream_underruns);
+
+		total_completed_buffers += n_stream_completed_buffers;
+		total_failures += n_stream_failures;
+		total_underruns += n_stream_underruns;
+	}
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	if (n_completed_buffers != NULL)
+		*n_completed_buffers = total_completed_buffers;
+	if (n_failures != NULL)
+		*n_failures = total_failures;
+	if (n_underruns != NULL)
+		*n_underruns = total_underruns;
+}
+
+static void
+arv_camera_group_init (ArvCameraGroup *group)
+{
+	group->priv = arv_camera_group_get_instance_private (group);
+
+	g_mutex_init (&group->priv->mutex);
+	group->priv->cameras = g_ptr_array_new_with_free_func (g_object_unref);
+	group->priv->streams = g_ptr_array_new_with_free_func (g_object_unref);
+	group->priv->workers = g_ptr_array_new_with_free_func ((GDestroyNotify) arv_gv_stream_worker_free);
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvCameraGroup *group = ARV_CAMERA_GROUP (object);
+	guint i;
+
+	/* The streams still in use go back to their own thread, before the release of the workers */
+	for (i = 0; i < group->priv->streams->len; i++) {
+		ArvStream *stream = g_ptr_array_index (group->priv->streams, i);
+
+		if (ARV_IS_GV_STREAM (stream))
+			arv_gv_stream_set_worker (ARV_GV_STREAM (stream), NULL);
+	}
+
+	g_ptr_array_set_size (group->priv->streams, 0);
+	g_ptr_array_set_size (group->priv->workers, 0);
+	g_ptr_array_set_size (group->priv->cameras, 0);
+
+	G_OBJECT_CLASS (arv_camera_group_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvCameraGroup *group = ARV_CAMERA_GROUP (object);
+
+	g_ptr_array_unref (group->priv->cameras);
+	g_ptr_array_unref (group->priv->streams);
+	g_ptr_array_unref (group->priv->workers);
+	g_mutex_clear (&group->priv->mutex);
+
+	G_OBJECT_CLASS (arv_camera_group_parent_class)->finalize (object);
+}
+
+static void
+arv_camera_group_class_init (ArvCameraGroupClass *group_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (group_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,64 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_CAMERA_GROUP_H
+#define ARV_CAMERA_GROUP_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvcamera.h>
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_CAMERA_GROUP             (arv_camera_group_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvCameraGroup, arv_camera_group, ARV, CAMERA_GROUP, GObject)
+
+ARV_API ArvCameraGroup *	arv_camera_group_new				(guint n_receive_threads);
+
+ARV_API guint			arv_camera_group_add_camera			(ArvCameraGroup *group,
+										 ArvCamera *camera);
+ARV_API guint			arv_camera_group_get_n_cameras			(ArvCameraGroup *group);
+ARV_API ArvCamera *		arv_camera_group_get_camera			(ArvCameraGroup *group, guint index);
+
+ARV_API ArvStream *		arv_camera_group_create_stream			(ArvCameraGroup *group, guint index,
+										 ArvStreamCallback callback,
+										 void *user_data, GError **error);
+
+ARV_API gboolean		arv_camera_group_start_acquisition		(ArvCameraGroup *group,
+										 GError **error);
+ARV_API gboolean		arv_camera_group_stop_acquisition		(ArvCameraGroup *group,
+										 GError **error);
+
+ARV_API guint			arv_camera_group_get_n_receive_threads		(ArvCameraGroup *group);
+ARV_API void			arv_camera_group_get_statistics			(ArvCameraGroup *group,
+										 guint64 *n_completed_buffers,
+										 guint64 *n_failures,
+										 guint64 *n_underruns);
+
+G_END_DECLS
+
+#endif
@@ -1,9 +1,15 @@
 #include <arvdebugprivate.h>
 #include <arvgvstreamprivate.h>
+#include <arvhdrhistogramprivate.h>
 #include <arv.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <stdio.h>
+#include <math.h>
+#include <time.h>
+#ifdef G_OS_UNIX
+#include <pthread.h>
+#endif
 
 static char *arv_option_camera_name = NULL;
 static char *arv_option_debug_domains = NULL;
@@ -18,6 +24,7 @@ static double arv_option_exposure_time_us = -1;
 static int arv_option_gain = -1;
 static gboolean arv_option_auto_socket_buffer = FALSE;
 static char *arv_option_packet_size_adjustment = NULL;
+static int arv_option_packet_size_alignment = -1;
 static gboolean arv_option_no_packet_resend = FALSE;
 static double arv_option_packet_request_ratio = -1.0;
 static unsigned int arv_option_initial_packet_timeout = ARV_GV_STREAM_INITIAL_PACKET_TIMEOUT_US_DEFAULT / 1000;
@@ -28,7 +35,20 @@ static int arv_option_gv_packet_delay = -1;
 static int arv_option_gv_packet_size = -1;
 static gboolean arv_option_realtime = FALSE;
 static gboolean arv_option_high_priority = FALSE;
+static gboolean arv_option_lock_memory = FALSE;
+static int arv_option_deadline_budget = -1;
 static gboolean arv_option_no_packet_socket = FALSE;
+static gboolean arv_option_xdp = FALSE;
+static gboolean arv_option_io_uring = FALSE;
+static gboolean arv_option_kernel_module = FALSE;
+static int arv_option_receive_threads = -1;
+static char *arv_option_packet_timestamp = NULL;
+static int arv_option_packet_request_merge_distance = -1;
+static gboolean arv_option_adaptive_packet_timeout = FALSE;
+static int arv_option_busy_poll = -1;
+static char *arv_option_multicast = NULL;
+static char *arv_option_cpu_affinity = NULL;
+static char *arv_option_heartbeat_cpu_affinity = NULL;
 static char *arv_option_chunks = NULL;
 static int arv_option_bandwidth_limit = -1;
 static char *arv_option_register_cache = NULL;
@@ -36,6 +56,13 @@ static char *arv_option_range_check = NULL;
 static char *arv_option_access_check = NULL;
 static int arv_option_duration_s = -1;
 static char *arv_option_uv_usb_mode = NULL;
+static char *arv_option_record = NULL;
+static int arv_option_record_size = 1024;
+static char *arv_option_replay = NULL;
+static gboolean arv_option_replay_max_rate = FALSE;
+static char *arv_option_benchmark = NULL;
+static gboolean arv_option_json = FALSE;
+static gboolean arv_option_arm = FALSE;
 
 /* clang-format off */
 static const GOptionEntry arv_option_entries[] =
@@ -100,6 +127,11 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_packet_size_adjustment,	"Packet size adjustment",
 		"{never|always|once|on-failure|on-failure-once}"
 	},
+	{
+		"packet-size-alignment",		'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_packet_size_alignment,	"Prefer the packet sizes with an aligned payload",
+		"<n_bytes>"
+	},
 	{
 		"no-packet-resend",			'r', 0, G_OPTION_ARG_NONE,
 		&arv_option_no_packet_resend,		"No packet resend",
@@ -121,6 +153,23 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_packet_timeout, 		"Packet timeout",
 		"<ms>"
 	},
+	{
+		"packet-request-merge-distance",	'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_packet_request_merge_distance,
+		"Maximum packet distance between merged resend requests",
+		"<n_packets>"
+	},
+	{
+		"adaptive-packet-timeout",		'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_adaptive_packet_timeout,
+		"Derive the packet timeouts from the inter-packet delays",
+		NULL
+	},
+	{
+		"busy-poll",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_busy_poll,			"Busy poll time of the stream threads",
+		"<µs>"
+	},
 	{
 		"frame-retention", 			'm', 0, G_OPTION_ARG_INT,
 		&arv_option_frame_retention, 		"Frame retention",
@@ -161,15 +210,66 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_high_priority,		"Make stream thread high priority",
 		NULL
 	},
+	{
+		"lock-memory",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_lock_memory,		"Lock buffers and stream thread memory in RAM",
+		NULL
+	},
+	{
+		"deadline",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_deadline_budget,		"Schedule stream thread with SCHED_DEADLINE, "
+		"with a CPU budget per frame",
+		"<budget_us>"
+	},
 	{
 		"no-packet-socket",			'\0', 0, G_OPTION_ARG_NONE,
 		&arv_option_no_packet_socket,		"Disable use of packet socket",
 		NULL
 	},
+	{
+		"xdp",					'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_xdp,			"Enable use of AF_XDP socket",
+		NULL
+	},
+	{
+		"io-uring",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_io_uring,			"Enable use of io_uring for packet reception",
+		NULL
+	},
+	{
+		"kernel-module",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_kernel_module,		"Enable use of the aravis kernel module for packet reception",
+		NULL
+	},
+	{
+		"multicast",				'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_multicast,			"Stream to a multicast group",
+		"<address>[:<port>]"
+	},
+	{
+		"receive-threads",			'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_receive_threads,		"Number of stream receiving threads",
+		NULL
+	},
+	{
+		"packet-timestamp",			'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_packet_timestamp,		"Packet timestamp source",
+		"{system|kernel|hardware}"
+	},
+	{
+		"cpu-affinity",				'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_cpu_affinity,		"CPU list of the stream threads",
+		"<cpu_list>"
+	},
+	{
+		"heartbeat-cpu-affinity",		'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_heartbeat_cpu_affinity,	"CPU list of the GigEVision heartbeat thread",
+		"<cpu_list>"
+	},
 	{
 		"register-cache",			'\0', 0, G_OPTION_ARG_STRING,
 		&arv_option_register_cache,		"Register cache policy",
-		"{disable|enable|debug}"
+		"{disable|enable|debug|static}"
 	},
 	{
 		"range-check",				'\0', 0, G_OPTION_ARG_STRING,
@@ -191,6 +291,42 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_duration_s,		        "Test duration (s)",
 		NULL
 	},
+	{
+		"record",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_record,			"Record the frames to a file",
+		"<filename>"
+	},
+	{
+		"record-size",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_record_size,		"Size of the record file (MiB)",
+		"<size>"
+	},
+	{
+		"replay",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_replay,			"Replay an ArvRecorder file (not a pcap capture) through the fake camera stream",
+		"<filename>"
+	},
+	{
+		"replay-max-rate",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_replay_max_rate,		"Replay at maximum rate instead of the recorded rate",
+		NULL
+	},
+	{
+		"arm",					'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_arm,			"Arm the stream before the acquisition start",
+		NULL
+	},
+	{
+		"benchmark",				'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_benchmark,			"Measure the software trigger to buffer latency of a set of "
+							"cameras, acquiring in parallel",
+		"{<camera_id>[,...]|all}"
+	},
+	{
+		"json",					'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_json,			"Print the benchmark results in JSON format",
+		NULL
+	},
 	{
 		"debug", 				'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 		NULL,
@@ -202,6 +338,7 @@ static const GOptionEntry arv_option_entries[] =
 
 typedef struct {
 	GMainLoop *main_loop;
+	ArvStream *stream;
 
 	int buffer_count;
 	int error_count;
@@ -210,7 +347,19 @@ typedef struct {
 	ArvChunkParser *chunk_parser;
 	char **chunks;
 
+	ArvRecorder *recorder;
+	guint64 n_records;
+	guint64 n_dropped_buffers;
+	guint64 n_recorded_bytes;
+
         gint64 start_time;
+
+	gint64 acquisition_start_time;
+	/* Set by the stream thread on the first completed buffer */
+	gint64 first_frame_time;
+
+	/* Frame period of the SCHED_DEADLINE reservation */
+	double frame_rate;
 } ApplicationData;
 
 static gboolean cancel = FALSE;
@@ -269,8 +418,22 @@ new_buffer_cb (ArvStream *stream, ApplicationData *data)
 static void
 stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
 {
+	ApplicationData *data = user_data;
+
+	if (type == ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE &&
+	    data->first_frame_time == 0 &&
+	    data->acquisition_start_time != 0 &&
+	    arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+		data->first_frame_time = g_get_monotonic_time ();
+
 	if (type == ARV_STREAM_CALLBACK_TYPE_INIT) {
-		if (arv_option_realtime) {
+		if (arv_option_cpu_affinity != NULL)
+			arv_check_thread_cpu_isolation ();
+
+		if (arv_option_deadline_budget >= 0) {
+			if (!arv_make_thread_deadline (data->frame_rate, arv_option_deadline_budget))
+				printf ("Failed to make stream thread deadline scheduled\n");
+		} else if (arv_option_realtime) {
 			if (!arv_make_thread_realtime (10))
 				printf ("Failed to make stream thread realtime\n");
 		} else if (arv_option_high_priority) {
@@ -285,10 +448,39 @@ periodic_task_cb (void *abstract_data)
 {
 	ApplicationData *data = abstract_data;
 
+	if (data->recorder != NULL) {
+		guint64 n_records, n_dropped_buffers, n_bytes;
+
+		arv_recorder_get_statistics (data->recorder, &n_records, &n_dropped_buffers, &n_bytes);
+		data->buffer_count = n_records - data->n_records;
+		data->error_count = n_dropped_buffers - data->n_dropped_buffers;
+		data->transferred = n_bytes - data->n_recorded_bytes;
+		data->n_records = n_records;
+		data->n_dropped_buffers = n_dropped_buffers;
+		data->n_recorded_bytes = n_bytes;
+	}
+
 	printf ("%3d frame%s - %7.3g MiB/s",
 		data->buffer_count,
 		data->buffer_count > 1 ? "s/s" : "/s ",
 		(double) data->transferred / 1e6);
+	if (data->stream != NULL && data->buffer_count > 0) {
+		double p50_us = arv_stream_get_info_double_by_name (data->stream, "latency_total_p50_us");
+		double p99_us = arv_stream_get_info_double_by_name (data->stream, "latency_total_p99_us");
+
+		if (p50_us > 0.0)
+			printf (" - latency %.3g/%.3g ms (p50/p99)", p50_us / 1e3, p99_us / 1e3);
+	}
+	if (data->stream != NULL) {
+		double frame_rate_10s = arv_stream_get_info_double_by_name (data->stream, "frame_rate_10s");
+		double frame_rate_60s = arv_stream_get_info_double_by_name (data->stream, "frame_rate_60s");
+		double failure_rate_10s = arv_stream_get_info_double_by_name (data->stream, "failure_rate_10s");
+
+		if (frame_rate_10s > 0.0)
+			printf (" - %.4g/%.4g frames/s (10s/60s)", frame_rate_10s, frame_rate_60s);
+		if (failure_rate_10s > 0.0)
+			printf (" - %.3g failures/s (10s)", failure_rate_10s);
+	}
 	if (data->error_count > 0)
 		printf (" - %d error%s\n", data->error_count, data->error_count > 1 ? "s" : "");
 	else
@@ -325,6 +517,331 @@ control_lost_cb (ArvGvDevice *gv_device)
 	cancel = TRUE;
 }
 
+/* Latency benchmark: each camera is software triggered by its own thread, which waits for the buffer before the
+ * next trigger. The trigger to buffer latency includes the trigger command round trip, the exposure, the transfer
+ * and the stream thread wake up. */
+
+typedef struct {
+	char *camera_id;
+	ArvCamera *camera;
+	ArvStream *stream;
+	GThread *thread;
+	char *error_message;
+
+	ArvHdrHistogram *latencies;
+	double latency_sum;
+	double latency_square_sum;
+
+	guint64 n_triggers;
+	guint64 n_buffers;
+	guint64 n_failures;
+	guint64 n_timeouts;
+
+	gint64 start_us;
+	gint64 end_us;
+
+	int has_stream_clock;
+#ifdef G_OS_UNIX
+	clockid_t stream_clock;
+#endif
+	double stream_cpu_s;
+	double consumer_cpu_s;
+} BenchmarkData;
+
+static double
+_get_thread_cpu_time (BenchmarkData *data, gboolean stream_thread)
+{
+#ifdef G_OS_UNIX
+	struct timespec time;
+	clockid_t clock = CLOCK_THREAD_CPUTIME_ID;
+
+	if (stream_thread) {
+		if (!g_atomic_int_get (&data->has_stream_clock))
+			return 0.0;
+		clock = data->stream_clock;
+	}
+
+	if (clock_gettime (clock, &time) == 0)
+		return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+	return 0.0;
+}
+
+static void
+benchmark_stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+	BenchmarkData *data = user_data;
+
+	stream_cb (NULL, type, buffer);
+
+#ifdef G_OS_UNIX
+	if (type == ARV_STREAM_CALLBACK_TYPE_INIT &&
+	    pthread_getcpuclockid (pthread_self (), &data->stream_clock) == 0)
+		g_atomic_int_set (&data->has_stream_clock, TRUE);
+	else if (type == ARV_STREAM_CALLBACK_TYPE_EXIT)
+		g_atomic_int_set (&data->has_stream_clock, FALSE);
+#endif
+}
+
+static void *
+benchmark_thread (void *user_data)
+{
+	BenchmarkData *data = user_data;
+	GError *error = NULL;
+	gint64 end_us;
+	gint64 next_trigger_us;
+	gint64 period_us;
+	double stream_cpu_s;
+	double consumer_cpu_s;
+
+	period_us = arv_option_software_trigger > 0.0 ? 1000000.0 / arv_option_software_trigger : 0;
+
+	data->start_us = g_get_monotonic_time ();
+	end_us = data->start_us + (gint64) arv_option_duration_s * 1000000;
+	next_trigger_us = data->start_us;
+	stream_cpu_s = _get_thread_cpu_time (data, TRUE);
+	consumer_cpu_s = _get_thread_cpu_time (data, FALSE);
+
+	while (!cancel && g_get_monotonic_time () < end_us) {
+		ArvBuffer *buffer;
+		gint64 trigger_us;
+		gint64 now_us;
+
+		if (period_us > 0) {
+			now_us = g_get_monotonic_time ();
+			if (now_us < next_trigger_us)
+				g_usleep (next_trigger_us - now_us);
+			next_trigger_us += period_us;
+		}
+
+		trigger_us = g_get_monotonic_time ();
+		arv_camera_software_trigger (data->camera, &error);
+		if (error != NULL) {
+			data->error_message = g_strdup_printf ("Software trigger failed: %s", error->message);
+			g_clear_error (&error);
+			break;
+		}
+		data->n_triggers++;
+
+		buffer = arv_stream_timeout_pop_buffer (data->stream, 1000000);
+		now_us = g_get_monotonic_time ();
+
+		if (buffer == NULL) {
+			data->n_timeouts++;
+			continue;
+		}
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			double latency_us = now_us - trigger_us;
+
+			data->n_buffers++;
+			arv_hdr_histogram_fill (data->latencies, 0, 0, now_us - trigger_us);
+			data->latency_sum += latency_us;
+			data->latency_square_sum += latency_us * latency_us;
+		} else
+			data->n_failures++;
+
+		arv_stream_push_buffer (data->stream, buffer);
+	}
+
+	data->end_us = g_get_monotonic_time ();
+	data->stream_cpu_s = _get_thread_cpu_time (data, TRUE) - stream_cpu_s;
+	data->consumer_cpu_s = _get_thread_cpu_time (data, FALSE) - consumer_cpu_s;
+
+	return NULL;
+}
+
+static gboolean
+benchmark_setup (BenchmarkData *data, ArvRegisterCachePolicy register_cache_policy,
+		 ArvRangeCheckPolicy range_check_policy, ArvAccessCheckPolicy access_check_policy)
+{
+	GError *error = NULL;
+	gint payload = 0;
+	int i;
+
+	data->latencies = arv_hdr_histogram_new (1, 1);
+	arv_hdr_histogram_set_variable_name (data->latencies, 0, "latency");
+
+	data->camera = arv_camera_new (data->camera_id, &error);
+	if (data->camera == NULL) {
+		data->error_message = g_strdup_printf ("Can't open camera: %s",
+						       error != NULL ? error->message : "not found");
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	arv_camera_set_register_cache_policy (data->camera, register_cache_policy);
+	arv_camera_set_range_check_policy (data->camera, range_check_policy);
+	arv_camera_set_access_check_policy (data->camera, access_check_policy);
+
+	if (error == NULL) arv_camera_set_region (data->camera, -1, -1, arv_option_width, arv_option_height, &error);
+	if (error == NULL) arv_camera_set_exposure_time (data->camera, arv_option_exposure_time_us, &error);
+	if (error == NULL) arv_camera_set_acquisition_mode (data->camera, ARV_ACQUISITION_MODE_CONTINUOUS, &error);
+	if (error == NULL) arv_camera_set_trigger (data->camera, "Software", &error);
+	if (error == NULL) payload = arv_camera_get_payload (data->camera, &error);
+	if (error == NULL) data->stream = arv_camera_create_stream (data->camera, benchmark_stream_cb, data, &error);
+
+	if (error != NULL) {
+		data->error_message = g_strdup_printf ("Can't configure camera: %s", error->message);
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	if (arv_option_cpu_affinity != NULL) {
+		g_object_set (data->stream, "cpu-affinity", arv_option_cpu_affinity, NULL);
+		arv_stream_stop_thread (data->stream, FALSE);
+		arv_stream_start_thread (data->stream);
+	}
+
+	for (i = 0; i < 10; i++)
+		arv_stream_push_buffer (data->stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (data->camera, &error);
+	if (error != NULL) {
+		data->error_message = g_strdup_printf ("Can't start acquisition: %s", error->message);
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+benchmark_print (BenchmarkData *data, gboolean is_last)
+{
+	double duration_s = (data->end_us - data->start_us) / 1e6;
+	double mean_us = data->n_buffers > 0 ? data->latency_sum / data->n_buffers : 0.0;
+	double jitter_us = data->n_buffers > 0 ?
+		sqrt (MAX (0.0, data->latency_square_sum / data->n_buffers - mean_us * mean_us)) : 0.0;
+
+	if (duration_s <= 0.0)
+		duration_s = 1.0;
+
+	if (arv_option_json) {
+		char *camera_id = g_strescape (data->camera_id != NULL ? data->camera_id : "", NULL);
+
+		printf ("  {\"camera\": \"%s\", ", camera_id);
+		g_free (camera_id);
+
+		if (data->error_message != NULL) {
+			char *message = g_strescape (data->error_message, NULL);
+
+			printf ("\"error\": \"%s\", ", message);
+			g_free (message);
+		}
+
+		printf ("\"duration_s\": %.3f, \"n_triggers\": %" G_GUINT64_FORMAT ", "
+			"\"n_buffers\": %" G_GUINT64_FORMAT ", \"n_failures\": %" G_GUINT64_FORMAT ", "
+			"\"n_timeouts\": %" G_GUINT64_FORMAT ", \"frame_rate\": %.3f, "
+			"\"latency_us\": {\"min\": %" G_GUINT64_FORMAT ", \"mean\": %.3f, \"p50\": %.3f, "
+			"\"p99\": %.3f, \"p999\": %.3f, \"max\": %" G_GUINT64_FORMAT "}, "
+			"\"jitter_us\": %.3f, \"stream_thread_cpu\": %.4f, \"consumer_thread_cpu\": %.4f}%s\n",
+			data->start_us > 0 ? duration_s : 0.0,
+			data->n_triggers, data->n_buffers, data->n_failures, data->n_timeouts,
+			data->n_buffers / duration_s,
+			arv_hdr_histogram_get_minimum (data->latencies, 0), mean_us,
+			arv_hdr_histogram_get_percentile (data->latencies, 0, 50.0),
+			arv_hdr_histogram_get_percentile (data->latencies, 0, 99.0),
+			arv_hdr_histogram_get_percentile (data->latencies, 0, 99.9),
+			arv_hdr_histogram_get_maximum (data->latencies, 0),
+			jitter_us, data->stream_cpu_s / duration_s, data->consumer_cpu_s / duration_s,
+			is_last ? "" : ",");
+		return;
+	}
+
+	printf ("%s:\n", data->camera_id != NULL ? data->camera_id : "");
+	if (data->error_message != NULL)
+		printf ("  error                = %s\n", data->error_message);
+	printf ("  triggers             = %" G_GUINT64_FORMAT "\n", data->n_triggers);
+	printf ("  buffers              = %" G_GUINT64_FORMAT " (%.3f frames/s)\n",
+		data->n_buffers, data->n_buffers / duration_s);
+	printf ("  failures             = %" G_GUINT64_FORMAT "\n", data->n_failures);
+	printf ("  timeouts             = %" G_GUINT64_FORMAT "\n", data->n_timeouts);
+	printf ("  latency p50/p99/max  = %.3f/%.3f/%.3f ms\n",
+		arv_hdr_histogram_get_percentile (data->latencies, 0, 50.0) / 1e3,
+		arv_hdr_histogram_get_percentile (data->latencies, 0, 99.0) / 1e3,
+		arv_hdr_histogram_get_maximum (data->latencies, 0) / 1e3);
+	printf ("  jitter               = %.3f ms\n", jitter_us / 1e3);
+	printf ("  stream thread cpu    = %.1f %%\n", 100.0 * data->stream_cpu_s / duration_s);
+	printf ("  consumer thread cpu  = %.1f %%\n", 100.0 * data->consumer_cpu_s / duration_s);
+}
+
+static int
+run_benchmark (ArvRegisterCachePolicy register_cache_policy,
+	       ArvRangeCheckPolicy range_check_policy,
+	       ArvAccessCheckPolicy access_check_policy)
+{
+	BenchmarkData *benchmarks;
+	void (*old_sigint_handler)(int);
+	char **camera_ids;
+	guint n_cameras;
+	guint i;
+
+	if (g_strcmp0 (arv_option_benchmark, "all") == 0) {
+		arv_update_device_list ();
+		n_cameras = arv_get_n_devices ();
+		camera_ids = g_new0 (char *, n_cameras + 1);
+		for (i = 0; i < n_cameras; i++)
+			camera_ids[i] = g_strdup (arv_get_device_id (i));
+	} else {
+		camera_ids = g_strsplit (arv_option_benchmark, ",", -1);
+		n_cameras = g_strv_length (camera_ids);
+	}
+
+	if (n_cameras == 0) {
+		printf ("No camera found\n");
+		g_strfreev (camera_ids);
+		return EXIT_FAILURE;
+	}
+
+	if (arv_option_duration_s <= 0)
+		arv_option_duration_s = 10;
+
+	benchmarks = g_new0 (BenchmarkData, n_cameras);
+
+	/* All cameras are opened and started before the measurement threads, to acquire in parallel */
+	for (i = 0; i < n_cameras; i++) {
+		benchmarks[i].camera_id = g_strstrip (camera_ids[i]);
+		benchmark_setup (&benchmarks[i], register_cache_policy, range_check_policy, access_check_policy);
+	}
+
+	old_sigint_handler = signal (SIGINT, set_cancel);
+
+	for (i = 0; i < n_cameras; i++)
+		if (benchmarks[i].error_message == NULL)
+			benchmarks[i].thread = g_thread_new ("arv-camera-test-benchmark", benchmark_thread,
+							     &benchmarks[i]);
+
+	for (i = 0; i < n_cameras; i++)
+		if (benchmarks[i].thread != NULL)
+			g_thread_join (benchmarks[i].thread);
+
+	signal (SIGINT, old_sigint_handler);
+
+	if (arv_option_json)
+		printf ("[\n");
+
+	for (i = 0; i < n_cameras; i++) {
+		if (benchmarks[i].camera != NULL)
+			arv_camera_stop_acquisition (benchmarks[i].camera, NULL);
+
+		benchmark_print (&benchmarks[i], i + 1 == n_cameras);
+
+		g_clear_object (&benchmarks[i].stream);
+		g_clear_object (&benchmarks[i].camera);
+		g_clear_pointer (&benchmarks[i].latencies, arv_hdr_histogram_unref);
+		g_free (benchmarks[i].error_message);
+	}
+
+	if (arv_option_json)
+		printf ("]\n");
+
+	g_free (benchmarks);
+	g_strfreev (camera_ids);
+
+	return EXIT_SUCCESS;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -338,6 +855,7 @@ main (int argc, char **argv)
 	ArvUvUsbMode usb_mode;
 	GOptionContext *context;
 	GError *error = NULL;
+	ArvBufferPool *pool = NULL;
 	int i;
 
 	data.buffer_count = 0;
@@ -345,6 +863,14 @@ main (int argc, char **argv)
 	data.transferred = 0;
 	data.chunks = NULL;
 	data.chunk_parser = NULL;
+	data.stream = NULL;
+	data.recorder = NULL;
+	data.n_records = 0;
+	data.n_dropped_buffers = 0;
+	data.n_recorded_bytes = 0;
+	data.acquisition_start_time = 0;
+	data.first_frame_time = 0;
+	data.frame_rate = 0.0;
 
 	context = g_option_context_new (NULL);
 	g_option_context_add_main_entries (context, arv_option_entries, NULL);
@@ -366,6 +892,8 @@ main (int argc, char **argv)
 		register_cache_policy = ARV_REGISTER_CACHE_POLICY_ENABLE;
 	else if (g_strcmp0 (arv_option_register_cache, "debug") == 0)
 		register_cache_policy = ARV_REGISTER_CACHE_POLICY_DEBUG;
+	else if (g_strcmp0 (arv_option_register_cache, "static") == 0)
+		register_cache_policy = ARV_REGISTER_CACHE_POLICY_STATIC;
 	else {
 		printf ("Invalid register cache policy\n");
 		return EXIT_FAILURE;
@@ -440,6 +968,9 @@ main (int argc, char **argv)
         setbuf(stdout,NULL);
     #endif
 
+	if (arv_option_benchmark != NULL)
+		return run_benchmark (register_cache_policy, range_check_policy, access_check_policy);
+
 	if (arv_option_camera_name == NULL)
 		g_print ("Looking for the first available camera\n");
 	else
@@ -511,11 +1042,38 @@ main (int argc, char **argv)
 			if (error == NULL) arv_camera_gv_set_packet_delay (camera, arv_option_gv_packet_delay, &error);
 			if (error == NULL) arv_camera_gv_set_packet_size (camera, arv_option_gv_packet_size, &error);
 
-			arv_camera_gv_set_stream_options (camera, arv_option_no_packet_socket ?
-							  ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED :
-							  ARV_GV_STREAM_OPTION_NONE);
+			arv_camera_gv_set_stream_options (camera,
+							  (arv_option_no_packet_socket ?
+							   ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_xdp ?
+							   ARV_GV_STREAM_OPTION_XDP_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_io_uring ?
+							   ARV_GV_STREAM_OPTION_IO_URING_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_kernel_module ?
+							   ARV_GV_STREAM_OPTION_KERNEL_MODULE_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE));
 			if (arv_option_packet_size_adjustment != NULL)
 				arv_camera_gv_set_packet_size_adjustment (camera, adjustment);
+			if (arv_option_packet_size_alignment > 0)
+				arv_camera_gv_set_packet_size_alignment (camera, arv_option_packet_size_alignment);
+			if (arv_option_multicast != NULL) {
+				GInetAddress *group;
+				char **tokens;
+
+				tokens = g_strsplit (arv_option_multicast, ":", 2);
+				group = g_inet_address_new_from_string (tokens[0]);
+				if (group != NULL && g_inet_address_get_is_multicast (group)) {
+					arv_camera_gv_set_stream_multicast_group (camera, group,
+										  tokens[1] != NULL ?
+										  g_ascii_strtoull (tokens[1], NULL, 10) : 0);
+				} else
+					printf ("Invalid multicast group '%s'\n", tokens[0]);
+				g_clear_object (&group);
+				g_strfreev (tokens);
+			}
 		}
 
 		if (error != NULL) {
@@ -588,7 +1146,9 @@ main (int argc, char **argv)
 		}
 
 		if (success) {
-		    stream = arv_camera_create_stream (camera, stream_cb, NULL, &error);
+		    data.frame_rate = arv_option_frequency > 0.0 ?
+			    arv_option_frequency : arv_camera_get_frame_rate (camera, NULL);
+		    stream = arv_camera_create_stream (camera, stream_cb, &data, &error);
 
                     if (arv_camera_is_gv_device (camera)) {
                             guint gv_packet_size;
@@ -618,10 +1178,96 @@ main (int argc, char **argv)
 						  "packet-timeout", (unsigned) arv_option_packet_timeout * 1000,
 						  "frame-retention", (unsigned) arv_option_frame_retention * 1000,
 						  NULL);
+				    if (arv_option_packet_request_merge_distance >= 0)
+					    g_object_set (stream,
+							  "packet-request-merge-distance",
+							  (unsigned) arv_option_packet_request_merge_distance,
+							  NULL);
+				    if (arv_option_adaptive_packet_timeout)
+					    g_object_set (stream,
+							  "packet-resend-timing", ARV_GV_STREAM_PACKET_RESEND_TIMING_ADAPTIVE,
+							  NULL);
+				    if (arv_option_busy_poll >= 0)
+					    g_object_set (stream, "busy-poll", (unsigned) arv_option_busy_poll, NULL);
+
+				    if (arv_option_packet_timestamp != NULL) {
+					    ArvGvStreamPacketTimestamp packet_timestamp;
+
+					    if (g_strcmp0 (arv_option_packet_timestamp, "kernel") == 0)
+						    packet_timestamp = ARV_GV_STREAM_PACKET_TIMESTAMP_KERNEL;
+					    else if (g_strcmp0 (arv_option_packet_timestamp, "hardware") == 0)
+						    packet_timestamp = ARV_GV_STREAM_PACKET_TIMESTAMP_HARDWARE;
+					    else
+						    packet_timestamp = ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM;
+
+					    g_object_set (stream, "packet-timestamp", packet_timestamp, NULL);
+				    }
+
+				    if (arv_option_receive_threads > 0) {
+					    g_object_set (stream,
+							  "receive-threads", (unsigned) arv_option_receive_threads,
+							  NULL);
+				    }
+
+				    /* Restart the stream thread for the changes to take effect */
+				    if (arv_option_receive_threads > 0 || arv_option_packet_timestamp != NULL ||
+					arv_option_busy_poll >= 0) {
+					    arv_stream_stop_thread (stream, FALSE);
+					    arv_stream_start_thread (stream);
+				    }
+			    }
+
+			    if (arv_option_cpu_affinity != NULL || arv_option_lock_memory) {
+				    if (arv_option_cpu_affinity != NULL)
+					    g_object_set (stream, "cpu-affinity", arv_option_cpu_affinity, NULL);
+				    g_object_set (stream, "lock-memory", arv_option_lock_memory, NULL);
+				    /* Restart the stream thread for the change to take effect */
+				    arv_stream_stop_thread (stream, FALSE);
+				    arv_stream_start_thread (stream);
+			    }
+
+			    if (arv_option_heartbeat_cpu_affinity != NULL &&
+				ARV_IS_GV_DEVICE (arv_camera_get_device (camera)))
+				    g_object_set (arv_camera_get_device (camera),
+						  "heartbeat-cpu-affinity", arv_option_heartbeat_cpu_affinity,
+						  NULL);
+
+			    if (arv_option_replay != NULL) {
+				    if (!ARV_IS_FAKE_STREAM (stream))
+					    printf ("Replay is only supported by the fake camera\n");
+				    else if (!arv_fake_stream_set_replay (ARV_FAKE_STREAM (stream), arv_option_replay,
+									  arv_option_replay_max_rate ?
+									  ARV_FAKE_STREAM_REPLAY_MODE_MAX_RATE :
+									  ARV_FAKE_STREAM_REPLAY_MODE_ORIGINAL_RATE,
+									  &error)) {
+					    printf ("Can't replay %s: %s\n", arv_option_replay, error->message);
+					    g_clear_error (&error);
+				    }
 			    }
 
-			    for (i = 0; i < 50; i++)
+			    /* Block aligned buffers are written to the record file without copy */
+			    if (arv_option_record != NULL
+#if ARAVIS_HAS_USB
+				&& !ARV_IS_UV_STREAM (stream)
+#endif
+			       ) {
+				    pool = arv_buffer_pool_new_full (50, payload, ARV_RECORDER_BLOCK_SIZE,
+								     ARV_BUFFER_POOL_FLAGS_NONE, -1, NULL);
+				    if (pool != NULL)
+					    arv_buffer_pool_attach_stream (pool, stream);
+			    }
+
+			    for (i = 0; i < 50 && pool == NULL; i++) {
+#if ARAVIS_HAS_USB
+				    if (ARV_IS_UV_STREAM (stream)) {
+					    arv_stream_push_buffer (stream,
+								    arv_uv_stream_new_buffer (ARV_UV_STREAM (stream),
+											      payload));
+					    continue;
+				    }
+#endif
 				    arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+			    }
 
 			    arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
 
@@ -638,15 +1284,31 @@ main (int argc, char **argv)
 									     emit_software_trigger, camera);
 			    }
 
-			    arv_camera_start_acquisition (camera, NULL);
+			    if (arv_option_record != NULL) {
+				    data.recorder = arv_recorder_new (stream, arv_option_record,
+								      (guint64) arv_option_record_size * 1024 * 1024,
+								      &error);
+				    if (data.recorder == NULL) {
+					    printf ("Can't record to %s: %s\n", arv_option_record, error->message);
+					    g_clear_error (&error);
+					    cancel = TRUE;
+				    }
+			    } else {
+				    g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &data);
+				    arv_stream_set_emit_signals (stream, TRUE);
+			    }
+
+			    if (arv_option_arm)
+				    arv_stream_arm (stream);
 
-			    g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &data);
-			    arv_stream_set_emit_signals (stream, TRUE);
+			    data.acquisition_start_time = g_get_monotonic_time ();
+			    arv_camera_start_acquisition (camera, NULL);
 
 			    g_signal_connect (arv_camera_get_device (camera), "control-lost",
 					      G_CALLBACK (control_lost_cb), NULL);
 
                             data.start_time = g_get_monotonic_time();
+                            data.stream = stream;
 
 			    g_timeout_add (1000, periodic_task_cb, &data);
 
@@ -665,19 +1327,38 @@ main (int argc, char **argv)
 
 			    arv_stream_get_statistics (stream, &n_completed_buffers, &n_failures, &n_underruns);
 
+			    if (data.first_frame_time > 0)
+				    printf ("Time to first frame    = %.3f ms\n",
+					    (data.first_frame_time - data.acquisition_start_time) / 1e3);
+
                             for (i = 0; i < arv_stream_get_n_infos (stream); i++) {
                                     if (arv_stream_get_info_type (stream, i) == G_TYPE_UINT64) {
                                             g_print ("%-22s = %" G_GUINT64_FORMAT "\n",
                                                      arv_stream_get_info_name (stream, i),
                                                      arv_stream_get_info_uint64 (stream, i));
+                                    } else if (arv_stream_get_info_type (stream, i) == G_TYPE_DOUBLE) {
+                                            g_print ("%-22s = %g\n",
+                                                     arv_stream_get_info_name (stream, i),
+                                                     arv_stream_get_info_double (stream, i));
                                     }
                             }
 
 			    arv_camera_stop_acquisition (camera, NULL);
 
+			    if (data.recorder != NULL) {
+				    guint64 n_records, n_dropped_buffers;
+
+				    arv_recorder_stop (data.recorder);
+				    arv_recorder_get_statistics (data.recorder, &n_records, &n_dropped_buffers, NULL);
+				    printf ("Recorded %" G_GUINT64_FORMAT " frames to %s, %" G_GUINT64_FORMAT " dropped\n",
+					    n_records, arv_option_record, n_dropped_buffers);
+				    g_clear_object (&data.recorder);
+			    }
+
 			    arv_stream_set_emit_signals (stream, FALSE);
 
 			    g_object_unref (stream);
+			    g_clear_object (&pool);
 		    } else {
 			    printf ("Can't create stream thread%s%s\n",
 				    error != NULL ? ": " : "",
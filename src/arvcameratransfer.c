@@ -0,0 +1,430 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Bulk transfers of the LUT and FileAccess features.
+ *
+ * A LUT exposed as a LUTValue register indexed by LUTIndex is usually a contiguous table in the device memory. Once
+ * its layout is probed, the whole table is written using large memory writes instead of a pair of register writes per
+ * entry. On GigE Vision devices, these writes are only pipelined when the gvcp-window-size property of ArvGvDevice
+ * allows more than one command in flight. The GenICam FileAccess transfers are bounded by the size of the
+ * FileAccessBuffer register, which is used at its full length for each operation.
+ */
+
+#include <arvcamera.h>
+#include <arvdevice.h>
+#include <arvgc.h>
+#include <arvgcintegernode.h>
+#include <arvgcintregnode.h>
+#include <arvgcregister.h>
+#include <arvgcregisternodeprivate.h>
+#include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
+#include <arvshadowmemoryprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+/* Size of the memory writes between two progress reports */
+#define ARV_CAMERA_TRANSFER_BLOCK_SIZE	16384
+
+static gboolean
+_report_progress (ArvCameraProgressCallback callback, void *user_data, guint64 n_bytes, guint64 n_total_bytes,
+		  GError **error)
+{
+	if (callback == NULL || callback (n_bytes, n_total_bytes, user_data))
+		return TRUE;
+
+	g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Transfer cancelled");
+
+	return FALSE;
+}
+
+/* Follows the pValue links of the Integer nodes down to the register holding the value */
+
+static ArvGcRegisterNode *
+_get_value_register (ArvGcNode *node)
+{
+	guint i;
+
+	for (i = 0; i < 8 && ARV_IS_GC_INTEGER_NODE (node); i++) {
+		ArvGcFeatureNodeClass *node_class = ARV_GC_FEATURE_NODE_GET_CLASS (node);
+
+		node = node_class->get_linked_feature != NULL ?
+			ARV_GC_NODE (node_class->get_linked_feature (ARV_GC_FEATURE_NODE (node))) : NULL;
+	}
+
+	return ARV_IS_GC_INT_REG_NODE (node) ? ARV_GC_REGISTER_NODE (node) : NULL;
+}
+
+/* Probes the address of the LUT entries for the two first indexes. The table can be written in one block if the
+ * entries are contiguous. */
+
+static gboolean
+_get_lut_layout (ArvCamera *camera, ArvGcRegisterNode *value_register, gint64 first_index,
+		 guint64 *address, gint64 *length)
+{
+	GError *local_error = NULL;
+	gint64 second_address;
+
+	arv_camera_set_integer (camera, "LUTIndex", first_index, &local_error);
+	if (local_error == NULL)
+		*address = arv_gc_register_get_address (ARV_GC_REGISTER (value_register), &local_error);
+	if (local_error == NULL)
+		*length = arv_gc_register_get_length (ARV_GC_REGISTER (value_register), &local_error);
+	if (local_error == NULL)
+		arv_camera_set_integer (camera, "LUTIndex", first_index + 1, &local_error);
+	if (local_error == NULL)
+		second_address = arv_gc_register_get_address (ARV_GC_REGISTER (value_register), &local_error);
+
+	if (local_error != NULL) {
+		arv_info_misc ("[Camera::set_lut] Layout probe failed: %s", local_error->message);
+		g_clear_error (&local_error);
+		return FALSE;
+	}
+
+	return (*length == 1 || *length == 2 || *length == 4 || *length == 8) &&
+		second_address - (gint64) *address == *length;
+}
+
+static gboolean
+_set_lut_entries (ArvCamera *camera, gint64 first_index, const gint64 *values, guint n_values,
+		  ArvCameraProgressCallback callback, void *user_data, GError **error)
+{
+	GError *local_error = NULL;
+	guint i;
+
+	for (i = 0; i < n_values; i++) {
+		arv_camera_set_integer (camera, "LUTIndex", first_index + i, &local_error);
+		if (local_error == NULL)
+			arv_camera_set_integer (camera, "LUTValue", values[i], &local_error);
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+
+		if ((i + 1) % 256 == 0 || i + 1 == n_values)
+			if (!_report_progress (callback, user_data, (guint64) (i + 1) * sizeof (gint64),
+					       (guint64) n_values * sizeof (gint64), error))
+				return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* The table was written behind the LUTValue node, which drops its cached value, as well as the register it reads
+ * and the device memory copy of the written range */
+
+static void
+_invalidate_lut_table (ArvGcNode *lut_value, ArvGcRegisterNode *value_register, guint64 address, guint64 size)
+{
+	ArvShadowMemory *shadow_memory;
+
+	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (value_register));
+	if (lut_value != ARV_GC_NODE (value_register) && ARV_IS_GC_FEATURE_NODE (lut_value))
+		arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (lut_value));
+
+	shadow_memory = arv_gc_get_shadow_memory (arv_gc_node_get_genicam (ARV_GC_NODE (value_register)));
+	if (shadow_memory != NULL)
+		arv_shadow_memory_invalidate (shadow_memory, address, size);
+}
+
+static gboolean
+_write_lut_table (ArvDevice *device, ArvGcNode *lut_value, ArvGcRegisterNode *value_register, guint64 address,
+		  gint64 length, const gint64 *values, guint n_values, ArvCameraProgressCallback callback,
+		  void *user_data, GError **error)
+{
+	guint endianness = arv_gc_register_node_get_endianness (value_register);
+	guint64 size = (guint64) n_values * length;
+	guint8 *table;
+	guint64 offset;
+	guint i;
+
+	table = g_malloc (size);
+
+	for (i = 0; i < n_values; i++) {
+		guint8 *entry = table + (guint64) i * length;
+		guint64 value = values[i];
+		gint64 j;
+
+		for (j = 0; j < length; j++)
+			entry[endianness == G_LITTLE_ENDIAN ? j : length - 1 - j] = (value >> (8 * j)) & 0xff;
+	}
+
+	for (offset = 0; offset < size; offset += ARV_CAMERA_TRANSFER_BLOCK_SIZE) {
+		guint32 block_size = MIN (size - offset, ARV_CAMERA_TRANSFER_BLOCK_SIZE);
+
+		if (!arv_device_write_memory (device, address + offset, block_size, table + offset, error) ||
+		    !_report_progress (callback, user_data, offset + block_size, size, error)) {
+			g_free (table);
+			_invalidate_lut_table (lut_value, value_register, address, size);
+			return FALSE;
+		}
+	}
+
+	g_free (table);
+
+	_invalidate_lut_table (lut_value, value_register, address, size);
+
+	arv_debug_misc ("[Camera::set_lut] %u entries written at 0x%08" G_GINT64_MODIFIER "x", n_values, address);
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_set_lut:
+ * @camera: a #ArvCamera
+ * @lut_selector: (allow-none): the LUT to update, as a LUTSelector value, %NULL for the current one
+ * @values: (array length=n_values): the LUT values, from the minimum LUTIndex value
+ * @n_values: number of values
+ * @callback: (scope call) (allow-none): a progress callback
+ * @user_data: (closure): data passed to @callback
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Uploads a LUT exposed through the LUTIndex and LUTValue features. If the LUT entries are contiguous in the device
+ * memory, the table is written using large memory writes. Otherwise, each entry is written using the LUTIndex and
+ * LUTValue features. The LUTIndex value is restored after the transfer.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_set_lut (ArvCamera *camera, const char *lut_selector, const gint64 *values, guint n_values,
+		    ArvCameraProgressCallback callback, void *user_data, GError **error)
+{
+	ArvDevice *device;
+	ArvGcNode *lut_value;
+	ArvGcRegisterNode *value_register;
+	GError *local_error = NULL;
+	gint64 initial_index;
+	gint64 min, max;
+	guint64 address = 0;
+	gint64 length = 0;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (values != NULL || n_values == 0, FALSE);
+
+	device = arv_camera_get_device (camera);
+
+	if (lut_selector != NULL) {
+		arv_camera_set_string (camera, "LUTSelector", lut_selector, &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+	}
+
+	initial_index = arv_camera_get_integer (camera, "LUTIndex", &local_error);
+	if (local_error == NULL)
+		arv_camera_get_integer_bounds (camera, "LUTIndex", &min, &max, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (n_values == 0)
+		return TRUE;
+
+	if ((guint64) n_values > (guint64) (max - min) + 1) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+			     "Too many LUT values (%u for %" G_GINT64_FORMAT " entries)", n_values, max - min + 1);
+		return FALSE;
+	}
+
+	lut_value = arv_device_get_feature (device, "LUTValue");
+	value_register = _get_value_register (lut_value);
+
+	if (value_register != NULL && n_values > 1 &&
+	    _get_lut_layout (camera, value_register, min, &address, &length)) {
+		success = _write_lut_table (device, lut_value, value_register, address, length, values, n_values,
+					    callback, user_data, error);
+	} else {
+		arv_info_misc ("[Camera::set_lut] LUT not contiguous, fall back to entry writes");
+		success = _set_lut_entries (camera, min, values, n_values, callback, user_data, error);
+	}
+
+	arv_camera_set_integer (camera, "LUTIndex", initial_index, success ? &local_error : NULL);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return success;
+}
+
+static gboolean
+_execute_file_operation (ArvCamera *camera, const char *operation, gint64 *result, GError **error)
+{
+	GError *local_error = NULL;
+	const char *status;
+
+	arv_camera_set_string (camera, "FileOperationSelector", operation, &local_error);
+	if (local_error == NULL)
+		arv_camera_execute_command (camera, "FileOperationExecute", &local_error);
+	if (local_error == NULL)
+		status = arv_camera_get_string (camera, "FileOperationStatus", &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (g_strcmp0 (status, "Success") != 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "File operation %s failed (%s)", operation, status != NULL ? status : "unknown status");
+		return FALSE;
+	}
+
+	if (result != NULL) {
+		*result = arv_camera_get_integer (camera, "FileOperationResult", &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+_write_file_blocks (ArvCamera *camera, ArvGcRegister *buffer_register, const guint8 *data, size_t size,
+		    ArvCameraProgressCallback callback, void *user_data, GError **error)
+{
+	ArvDevice *device = arv_camera_get_device (camera);
+	GError *local_error = NULL;
+	guint64 buffer_address;
+	gint64 buffer_length;
+	size_t offset = 0;
+
+	buffer_address = arv_gc_register_get_address (buffer_register, &local_error);
+	if (local_error == NULL)
+		buffer_length = arv_gc_register_get_length (buffer_register, &local_error);
+	if (local_error == NULL && buffer_length <= 0)
+		g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Invalid FileAccessBuffer length (%" G_GINT64_FORMAT ")", buffer_length);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_camera_set_string (camera, "FileOperationSelector", "Write", &local_error);
+
+	while (offset < size && local_error == NULL) {
+		guint32 block_size = MIN ((guint64) (size - offset), (guint64) buffer_length);
+		gint64 n_written = 0;
+
+		/* The buffer is only written up to the transfer length */
+		if (!arv_device_write_memory (device, buffer_address, block_size, (void *) (data + offset),
+					      &local_error))
+			break;
+		arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (buffer_register));
+
+		arv_camera_set_integer (camera, "FileAccessOffset", offset, &local_error);
+		if (local_error == NULL)
+			arv_camera_set_integer (camera, "FileAccessLength", block_size, &local_error);
+		if (local_error == NULL)
+			_execute_file_operation (camera, "Write", &n_written, &local_error);
+		if (local_error == NULL && (n_written <= 0 || n_written > block_size))
+			g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+				     "Invalid file write result (%" G_GINT64_FORMAT " for %u bytes)",
+				     n_written, block_size);
+		if (local_error != NULL)
+			break;
+
+		offset += n_written;
+
+		_report_progress (callback, user_data, offset, size, &local_error);
+	}
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_camera_write_file:
+ * @camera: a #ArvCamera
+ * @file_selector: the file to write, as a FileSelector value
+ * @data: (array length=size) (element-type guint8): the file content
+ * @size: size of the file content
+ * @callback: (scope call) (allow-none): a progress callback
+ * @user_data: (closure): data passed to @callback
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Writes a file of the device through the GenICam FileAccess features, like a flat-field correction table. Each
+ * write operation transfers a whole FileAccessBuffer, in a single memory write. The file is closed on failure or
+ * cancellation.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_camera_write_file (ArvCamera *camera, const char *file_selector, const void *data, size_t size,
+		       ArvCameraProgressCallback callback, void *user_data, GError **error)
+{
+	ArvGcNode *buffer_register;
+	GError *local_error = NULL;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (file_selector != NULL, FALSE);
+	g_return_val_if_fail (data != NULL || size == 0, FALSE);
+
+	buffer_register = arv_device_get_feature (arv_camera_get_device (camera), "FileAccessBuffer");
+	if (!ARV_IS_GC_REGISTER (buffer_register)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+			     "FileAccessBuffer register not found");
+		return FALSE;
+	}
+
+	arv_camera_set_string (camera, "FileSelector", file_selector, &local_error);
+	if (local_error == NULL)
+		arv_camera_set_string (camera, "FileOpenMode", "Write", &local_error);
+	if (local_error == NULL)
+		_execute_file_operation (camera, "Open", NULL, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	success = _write_file_blocks (camera, ARV_GC_REGISTER (buffer_register), data, size, callback, user_data,
+				      &local_error);
+
+	_execute_file_operation (camera, "Close", NULL, success ? &local_error : NULL);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_debug_misc ("[Camera::write_file] %" G_GSIZE_FORMAT " bytes written to %s", size, file_selector);
+
+	return TRUE;
+}
@@ -58,6 +58,9 @@ arv_chunk_parser_error_quark (void)
 
 typedef struct {
 	ArvGc *genicam;
+
+	GPtrArray *accessors;
+	GHashTable *accessor_indexes;
 } ArvChunkParserPrivate;
 
 struct _ArvChunkParser {
@@ -228,6 +231,189 @@ arv_chunk_parser_get_float_value (ArvChunkParser *parser, ArvBuffer *buffer, con
 	return value;
 }
 
+/**
+ * arv_chunk_parser_get_accessor:
+ * @parser: a #ArvChunkParser
+ * @chunk: chunk data name
+ * @error: a #GError placeholder
+ *
+ * Resolves the chunk data feature once, and returns a handle usable with the `_by_accessor` getters and with
+ * [method@ArvChunkParser.parse_buffer]. This avoids the feature lookup for each buffer. Only integer, float and
+ * boolean features are supported. Calling this function several times for the same chunk returns the same accessor.
+ *
+ * Returns: an accessor index, -1 on error.
+ *
+ * Since: 0.8.24
+ */
+
+gint
+arv_chunk_parser_get_accessor (ArvChunkParser *parser, const char *chunk, GError **error)
+{
+	ArvGcNode *node;
+	gpointer index;
+
+	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), -1);
+	g_return_val_if_fail (chunk != NULL, -1);
+
+	/* Indexes are stored with a +1 offset, in order to differentiate index 0 from a missing key */
+	index = g_hash_table_lookup (parser->priv->accessor_indexes, chunk);
+	if (index != NULL)
+		return GPOINTER_TO_INT (index) - 1;
+
+	node = arv_gc_get_node (parser->priv->genicam, chunk);
+	if (!ARV_IS_GC_INTEGER (node) && !ARV_IS_GC_FLOAT (node) && !ARV_IS_GC_BOOLEAN (node)) {
+		g_set_error (error, ARV_CHUNK_PARSER_ERROR, ARV_CHUNK_PARSER_ERROR_INVALID_FEATURE_TYPE,
+			     "[%s] Not an integer, float or boolean", chunk);
+		return -1;
+	}
+
+	g_ptr_array_add (parser->priv->accessors, node);
+	g_hash_table_insert (parser->priv->accessor_indexes, g_strdup (chunk),
+			     GINT_TO_POINTER (parser->priv->accessors->len));
+
+	return parser->priv->accessors->len - 1;
+}
+
+static ArvGcNode *
+_get_accessor_node (ArvChunkParser *parser, gint accessor, GError **error)
+{
+	if (accessor < 0 || accessor >= (gint) parser->priv->accessors->len) {
+		g_set_error (error, ARV_CHUNK_PARSER_ERROR, ARV_CHUNK_PARSER_ERROR_INVALID_FEATURE_TYPE,
+			     "Invalid chunk accessor %d", accessor);
+		return NULL;
+	}
+
+	return g_ptr_array_index (parser->priv->accessors, accessor);
+}
+
+static void
+_read_accessor_value (ArvGcNode *node, ArvChunkValue *value, GError **error)
+{
+	GError *local_error = NULL;
+
+	value->is_valid = FALSE;
+	value->int_value = 0;
+	value->float_value = 0.0;
+
+	if (ARV_IS_GC_INTEGER (node)) {
+		value->int_value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
+		value->float_value = value->int_value;
+	} else if (ARV_IS_GC_FLOAT (node)) {
+		value->float_value = arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error);
+		value->int_value = value->float_value;
+	} else {
+		value->int_value = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), &local_error) ? 1 : 0;
+		value->float_value = value->int_value;
+	}
+
+	if (local_error != NULL) {
+		arv_warning_chunk ("%s", local_error->message);
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	value->is_valid = TRUE;
+}
+
+/**
+ * arv_chunk_parser_get_integer_value_by_accessor:
+ * @parser: a #ArvChunkParser
+ * @buffer: a #ArvBuffer with a #ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA payload
+ * @accessor: an accessor returned by [method@ArvChunkParser.get_accessor]
+ * @error: a #GError placeholder
+ *
+ * Returns: the chunk data value, as an integer.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_chunk_parser_get_integer_value_by_accessor (ArvChunkParser *parser, ArvBuffer *buffer, gint accessor,
+						GError **error)
+{
+	ArvChunkValue value = {0};
+
+	arv_chunk_parser_parse_buffer (parser, buffer, &accessor, 1, &value, error);
+
+	return value.int_value;
+}
+
+/**
+ * arv_chunk_parser_get_float_value_by_accessor:
+ * @parser: a #ArvChunkParser
+ * @buffer: a #ArvBuffer with a #ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA payload
+ * @accessor: an accessor returned by [method@ArvChunkParser.get_accessor]
+ * @error: a #GError placeholder
+ *
+ * Returns: the chunk data value, as a floating point number.
+ *
+ * Since: 0.8.24
+ */
+
+double
+arv_chunk_parser_get_float_value_by_accessor (ArvChunkParser *parser, ArvBuffer *buffer, gint accessor,
+					      GError **error)
+{
+	ArvChunkValue value = {0};
+
+	arv_chunk_parser_parse_buffer (parser, buffer, &accessor, 1, &value, error);
+
+	return value.float_value;
+}
+
+/**
+ * arv_chunk_parser_parse_buffer:
+ * @parser: a #ArvChunkParser
+ * @buffer: a #ArvBuffer with a #ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA payload
+ * @accessors: (array length=n_accessors): accessors returned by [method@ArvChunkParser.get_accessor]
+ * @n_accessors: number of accessors
+ * @values: (array length=n_accessors) (out caller-allocates): placeholder for the chunk values
+ * @error: a #GError placeholder
+ *
+ * Reads all the chunk values of @accessors from @buffer. The buffer chunk trailer is only walked once, whatever the
+ * number of requested values. On error, the remaining values are still read, and @error is set to the first error.
+ *
+ * Returns: %TRUE if all the values were successfully read.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_chunk_parser_parse_buffer (ArvChunkParser *parser, ArvBuffer *buffer,
+			       const gint *accessors, guint n_accessors,
+			       ArvChunkValue *values, GError **error)
+{
+	gboolean success = TRUE;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (n_accessors == 0 || (accessors != NULL && values != NULL), FALSE);
+
+	arv_gc_set_buffer (parser->priv->genicam, buffer);
+
+	for (i = 0; i < n_accessors; i++) {
+		GError *local_error = NULL;
+		ArvGcNode *node;
+
+		node = _get_accessor_node (parser, accessors[i], &local_error);
+		if (node != NULL)
+			_read_accessor_value (node, &values[i], &local_error);
+		else
+			values[i].is_valid = FALSE;
+
+		if (local_error != NULL) {
+			if (success)
+				g_propagate_error (error, local_error);
+			else
+				g_error_free (local_error);
+			success = FALSE;
+		}
+	}
+
+	return success;
+}
+
 /**
  * arv_chunk_parser_new:
  * @xml: XML genicam data
@@ -294,6 +480,9 @@ static void
 arv_chunk_parser_init (ArvChunkParser *chunk_parser)
 {
 	chunk_parser->priv = arv_chunk_parser_get_instance_private (chunk_parser);
+
+	chunk_parser->priv->accessors = g_ptr_array_new ();
+	chunk_parser->priv->accessor_indexes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 }
 
 static void
@@ -301,6 +490,8 @@ _finalize (GObject *object)
 {
 	ArvChunkParser *chunk_parser = ARV_CHUNK_PARSER (object);
 
+	g_clear_pointer (&chunk_parser->priv->accessors, g_ptr_array_unref);
+	g_clear_pointer (&chunk_parser->priv->accessor_indexes, g_hash_table_unref);
 	g_clear_object (&chunk_parser->priv->genicam);
 
 	G_OBJECT_CLASS (arv_chunk_parser_parent_class)->finalize (object);
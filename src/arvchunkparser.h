@@ -50,6 +50,23 @@ typedef enum {
 	ARV_CHUNK_PARSER_ERROR_CHUNK_NOT_FOUND
 } ArvChunkParserError;
 
+/**
+ * ArvChunkValue:
+ * @int_value: the chunk value, as an integer
+ * @float_value: the chunk value, as a floating point number
+ * @is_valid: %TRUE if the value was successfully read from the buffer
+ *
+ * Chunk value filled by [method@ArvChunkParser.parse_buffer].
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	gint64 int_value;
+	double float_value;
+	gboolean is_valid;
+} ArvChunkValue;
+
 #define ARV_TYPE_CHUNK_PARSER             (arv_chunk_parser_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvChunkParser, arv_chunk_parser, ARV, CHUNK_PARSER, GObject)
 
@@ -63,6 +80,19 @@ ARV_API gint64			arv_chunk_parser_get_integer_value	(ArvChunkParser *parser, Arv
 ARV_API double			arv_chunk_parser_get_float_value	(ArvChunkParser *parser, ArvBuffer *buffer,
 									 const char *chunk, GError **error);
 
+
+ARV_API gint			arv_chunk_parser_get_accessor		(ArvChunkParser *parser, const char *chunk,
+									 GError **error);
+ARV_API gint64			arv_chunk_parser_get_integer_value_by_accessor	(ArvChunkParser *parser,
+										 ArvBuffer *buffer,
+										 gint accessor, GError **error);
+ARV_API double			arv_chunk_parser_get_float_value_by_accessor	(ArvChunkParser *parser,
+										 ArvBuffer *buffer,
+										 gint accessor, GError **error);
+ARV_API gboolean		arv_chunk_parser_parse_buffer		(ArvChunkParser *parser, ArvBuffer *buffer,
+									 const gint *accessors, guint n_accessors,
+									 ArvChunkValue *values, GError **error);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,228 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * ArvClockModel maps the timestamps of a device clock to the host real time clock. The model is a line fitted by least
+ * squares on the last clock samples, its slope accounting for the drift between the two clocks. Each sample pairs a
+ * latched device time with the host time at the middle of the latch transaction. Samples with a round trip much
+ * longer than the best one of the window are discarded, as their host time is not accurate.
+ */
+
+#include <arvclockmodelprivate.h>
+#include <math.h>
+
+#define ARV_CLOCK_MODEL_N_SAMPLES		16
+#define ARV_CLOCK_MODEL_ROUND_TRIP_RATIO	4
+
+typedef struct {
+	guint64 device_ns;
+	gint64 host_ns;
+	guint64 round_trip_ns;
+} ArvClockSample;
+
+struct _ArvClockModel {
+	GMutex mutex;
+
+	ArvClockSample samples[ARV_CLOCK_MODEL_N_SAMPLES];
+	guint n_samples;
+	guint next_sample;
+
+	/* host_ns = reference_host_ns + (device_ns - reference_device_ns) * slope */
+	guint64 reference_device_ns;
+	gint64 reference_host_ns;
+	double slope;
+};
+
+/**
+ * arv_clock_model_new:
+ *
+ * Returns: a new #ArvClockModel, without any sample
+ */
+
+ArvClockModel *
+arv_clock_model_new (void)
+{
+	ArvClockModel *model;
+
+	model = g_new0 (ArvClockModel, 1);
+	g_mutex_init (&model->mutex);
+	model->slope = 1.0;
+
+	return model;
+}
+
+void
+arv_clock_model_free (ArvClockModel *model)
+{
+	if (model == NULL)
+		return;
+
+	g_mutex_clear (&model->mutex);
+	g_free (model);
+}
+
+static void
+_update_model (ArvClockModel *model)
+{
+	const ArvClockSample *reference;
+	double mean_x = 0.0, mean_y = 0.0;
+	double sxx = 0.0, sxy = 0.0;
+	guint i;
+
+	/* Relative to an arbitrary sample, for the double precision */
+	reference = &model->samples[0];
+
+	for (i = 0; i < model->n_samples; i++) {
+		mean_x += (double) (gint64) (model->samples[i].device_ns - reference->device_ns);
+		mean_y += (double) (model->samples[i].host_ns - reference->host_ns);
+	}
+	mean_x /= model->n_samples;
+	mean_y /= model->n_samples;
+
+	for (i = 0; i < model->n_samples; i++) {
+		double dx = (double) (gint64) (model->samples[i].device_ns - reference->device_ns) - mean_x;
+		double dy = (double) (model->samples[i].host_ns - reference->host_ns) - mean_y;
+
+		sxx += dx * dx;
+		sxy += dx * dy;
+	}
+
+	model->reference_device_ns = reference->device_ns + (gint64) mean_x;
+	model->reference_host_ns = reference->host_ns + (gint64) mean_y;
+	model->slope = sxx > 0.0 ? sxy / sxx : 1.0;
+}
+
+/**
+ * arv_clock_model_add_sample:
+ * @model: a #ArvClockModel
+ * @device_ns: the device time, in nanoseconds
+ * @host_ns: the host real time corresponding to @device_ns, in nanoseconds
+ * @round_trip_ns: the duration of the transaction used for the sampling
+ *
+ * Returns: %TRUE if the sample was used for the model update.
+ */
+
+gboolean
+arv_clock_model_add_sample (ArvClockModel *model, guint64 device_ns, gint64 host_ns, guint64 round_trip_ns)
+{
+	guint64 best_round_trip_ns = G_MAXUINT64;
+	guint i;
+
+	g_return_val_if_fail (model != NULL, FALSE);
+
+	g_mutex_lock (&model->mutex);
+
+	for (i = 0; i < model->n_samples; i++)
+		best_round_trip_ns = MIN (best_round_trip_ns, model->samples[i].round_trip_ns);
+
+	if (model->n_samples >= 4 &&
+	    round_trip_ns > ARV_CLOCK_MODEL_ROUND_TRIP_RATIO * MAX (best_round_trip_ns, 1)) {
+		g_mutex_unlock (&model->mutex);
+		return FALSE;
+	}
+
+	/* A device clock going backward, after a timestamp reset, invalidates the previous samples */
+	if (model->n_samples > 0 &&
+	    device_ns < model->samples[(model->next_sample + ARV_CLOCK_MODEL_N_SAMPLES - 1) %
+				       ARV_CLOCK_MODEL_N_SAMPLES].device_ns) {
+		model->n_samples = 0;
+		model->next_sample = 0;
+	}
+
+	model->samples[model->next_sample].device_ns = device_ns;
+	model->samples[model->next_sample].host_ns = host_ns;
+	model->samples[model->next_sample].round_trip_ns = round_trip_ns;
+	model->next_sample = (model->next_sample + 1) % ARV_CLOCK_MODEL_N_SAMPLES;
+	model->n_samples = MIN (model->n_samples + 1, ARV_CLOCK_MODEL_N_SAMPLES);
+
+	_update_model (model);
+
+	g_mutex_unlock (&model->mutex);
+
+	return TRUE;
+}
+
+/**
+ * arv_clock_model_get_n_samples:
+ * @model: a #ArvClockModel
+ *
+ * Returns: the number of samples currently used by the model.
+ */
+
+guint
+arv_clock_model_get_n_samples (ArvClockModel *model)
+{
+	guint n_samples;
+
+	g_return_val_if_fail (model != NULL, 0);
+
+	g_mutex_lock (&model->mutex);
+	n_samples = model->n_samples;
+	g_mutex_unlock (&model->mutex);
+
+	return n_samples;
+}
+
+/**
+ * arv_clock_model_get_drift:
+ * @model: a #ArvClockModel
+ *
+ * Returns: the drift of the device clock relative to the host clock, in parts per million.
+ */
+
+double
+arv_clock_model_get_drift (ArvClockModel *model)
+{
+	double slope;
+
+	g_return_val_if_fail (model != NULL, 0.0);
+
+	g_mutex_lock (&model->mutex);
+	slope = model->slope;
+	g_mutex_unlock (&model->mutex);
+
+	return (slope - 1.0) * 1e6;
+}
+
+/**
+ * arv_clock_model_to_host:
+ * @model: a #ArvClockModel
+ * @device_ns: a device time, in nanoseconds
+ *
+ * Returns: the host real time corresponding to @device_ns, in nanoseconds, or 0 if the model has no sample yet.
+ */
+
+guint64
+arv_clock_model_to_host (ArvClockModel *model, guint64 device_ns)
+{
+	gint64 host_ns = 0;
+
+	g_return_val_if_fail (model != NULL, 0);
+
+	g_mutex_lock (&model->mutex);
+	if (model->n_samples > 0)
+		host_ns = model->reference_host_ns +
+			(gint64) llround ((double) (gint64) (device_ns - model->reference_device_ns) * model->slope);
+	g_mutex_unlock (&model->mutex);
+
+	return host_ns > 0 ? host_ns : 0;
+}
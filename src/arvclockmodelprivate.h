@@ -0,0 +1,45 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_CLOCK_MODEL_PRIVATE_H
+#define ARV_CLOCK_MODEL_PRIVATE_H
+
+#include <arvapi.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvClockModel ArvClockModel;
+
+/* private, but used by tests */
+ARV_API ArvClockModel *	arv_clock_model_new		(void);
+ARV_API void		arv_clock_model_free		(ArvClockModel *model);
+
+ARV_API gboolean	arv_clock_model_add_sample	(ArvClockModel *model, guint64 device_ns, gint64 host_ns,
+							 guint64 round_trip_ns);
+ARV_API guint		arv_clock_model_get_n_samples	(ArvClockModel *model);
+ARV_API double		arv_clock_model_get_drift	(ArvClockModel *model);
+ARV_API guint64		arv_clock_model_to_host		(ArvClockModel *model, guint64 device_ns);
+
+G_END_DECLS
+
+#endif
@@ -66,6 +66,47 @@ ArvDebugLevelInfos arv_debug_level_infos[] = {
 	{ .color = "\033[0m",		.symbol = "🆃 "}
 };
 
+/*
+ * Asynchronous output. Each logging thread formats its messages in fixed size records of a ring, which is drained to
+ * stderr by a background thread. A full ring drops the new records instead of blocking the logging thread, the number
+ * of dropped records being reported by the drain thread. The rings are single producer, single consumer, the mutex
+ * only protecting the list of rings, on the first message of a thread and in the drain thread.
+ */
+
+#define ARV_DEBUG_RECORD_TEXT_SIZE	240
+#define ARV_DEBUG_RING_N_RECORDS	256
+#define ARV_DEBUG_DRAIN_PERIOD_US	10000
+
+typedef struct {
+	gint64 time_us;
+	ArvDebugCategory category;
+	ArvDebugLevel level;
+	char text[ARV_DEBUG_RECORD_TEXT_SIZE];
+} ArvDebugRecord;
+
+typedef struct {
+	ArvDebugRecord records[ARV_DEBUG_RING_N_RECORDS];
+	guint id;
+	/* Written by the logging thread */
+	guint head;
+	guint n_dropped;
+	/* Written by the drain thread */
+	guint tail;
+	guint n_reported_dropped;
+	/* Set on the logging thread exit, the ring being freed by the drain thread once empty */
+	gint is_orphaned;
+} ArvDebugRing;
+
+static void _orphan_ring (gpointer data);
+
+static GPrivate debug_ring = G_PRIVATE_INIT (_orphan_ring);
+static GMutex debug_rings_mutex;
+static GSList *debug_rings = NULL;
+static guint debug_n_rings = 0;
+static GMutex debug_drain_mutex;
+static GThread *debug_drain_thread = NULL;
+static gint debug_is_async = 0;
+
 static gboolean
 arv_debug_initialize (const char *debug_var)
 {
@@ -82,7 +123,9 @@ arv_debug_initialize (const char *debug_var)
 		unsigned int j;
 
 		infos = g_strsplit (categories[i], ":", -1);
-		if (infos[0] != NULL) {
+		if (g_strcmp0 (infos[0], "async") == 0) {
+			arv_debug_set_async (TRUE);
+		} else if (infos[0] != NULL) {
 			gboolean found = FALSE;
 			for (j = 0; j < G_N_ELEMENTS (arv_debug_category_infos); j++) {
 				if (g_strcmp0 (arv_debug_category_infos[j].name, infos[0]) == 0 ||
@@ -130,31 +173,17 @@ arv_debug_check	(ArvDebugCategory category, ArvDebugLevel level)
 	if (level <= 0 || level >= ARV_DEBUG_LEVEL_N_ELEMENTS)
 		return FALSE;
 
-	if ((int) level <= (int) arv_debug_category_infos[category].level)
-		return TRUE;
-
-	return FALSE;
+	return arv_debug_is_enabled (category, level);
 }
 
-static void arv_debug_with_level (ArvDebugCategory category,
-				  ArvDebugLevel level,
-				  const char *format,
-				  va_list args) G_GNUC_PRINTF(3,0);
-
 static void
-arv_debug_with_level (ArvDebugCategory category, ArvDebugLevel level, const char *format, va_list args)
+_write_message (ArvDebugCategory category, ArvDebugLevel level, GDateTime *date, const char *text)
 {
-        char *text = NULL;
         char *header = NULL;
 	char *time_str = NULL;
-        GDateTime *date = NULL;
         char **lines;
         gint i;
 
-	if (!arv_debug_check (category, level))
-		return;
-
-        date = g_date_time_new_now_local ();
         time_str = g_date_time_format (date, "%H:%M:%S");
 
 	if (stderr_has_color_support ())
@@ -174,7 +203,6 @@ arv_debug_with_level (ArvDebugCategory category, ArvDebugLevel level, const char
 
                 g_fprintf (stderr, "%s", header);
 
-                text = g_strdup_vprintf (format, args);
                 lines = g_strsplit (text, "\n", -1);
 
                 for (i = 0; lines[i] != NULL; i++) {
@@ -188,12 +216,226 @@ arv_debug_with_level (ArvDebugCategory category, ArvDebugLevel level, const char
                 #endif
         }
 
-        g_free (text);
         g_free (header);
         g_free (time_str);
+}
+
+static void
+_orphan_ring (gpointer data)
+{
+	ArvDebugRing *ring = data;
+
+	g_atomic_int_set (&ring->is_orphaned, 1);
+}
+
+static ArvDebugRing *
+_get_ring (void)
+{
+	ArvDebugRing *ring;
+
+	ring = g_private_get (&debug_ring);
+	if (G_LIKELY (ring != NULL))
+		return ring;
+
+	ring = g_new0 (ArvDebugRing, 1);
+
+	g_mutex_lock (&debug_rings_mutex);
+	ring->id = debug_n_rings++;
+	debug_rings = g_slist_prepend (debug_rings, ring);
+	g_mutex_unlock (&debug_rings_mutex);
+
+	g_private_set (&debug_ring, ring);
+
+	return ring;
+}
+
+static void _queue_message (ArvDebugCategory category,
+			    ArvDebugLevel level,
+			    const char *format,
+			    va_list args) G_GNUC_PRINTF(3,0);
+
+static void
+_queue_message (ArvDebugCategory category, ArvDebugLevel level, const char *format, va_list args)
+{
+	ArvDebugRing *ring = _get_ring ();
+	ArvDebugRecord *record;
+	guint head = ring->head;
+
+	if (head - g_atomic_int_get (&ring->tail) >= ARV_DEBUG_RING_N_RECORDS) {
+		g_atomic_int_inc (&ring->n_dropped);
+		return;
+	}
+
+	record = &ring->records[head % ARV_DEBUG_RING_N_RECORDS];
+	record->time_us = g_get_real_time ();
+	record->category = category;
+	record->level = level;
+	g_vsnprintf (record->text, sizeof (record->text), format, args);
+
+	g_atomic_int_set (&ring->head, head + 1);
+}
+
+static void
+_drain_ring (ArvDebugRing *ring)
+{
+	guint head = g_atomic_int_get (&ring->head);
+	guint n_dropped = g_atomic_int_get (&ring->n_dropped);
+	guint tail;
+
+	for (tail = ring->tail; tail != head; tail++) {
+		ArvDebugRecord *record = &ring->records[tail % ARV_DEBUG_RING_N_RECORDS];
+		GDateTime *second_date;
+		GDateTime *date;
+
+		second_date = g_date_time_new_from_unix_local (record->time_us / G_USEC_PER_SEC);
+		date = g_date_time_add (second_date, record->time_us % G_USEC_PER_SEC);
+		g_date_time_unref (second_date);
+
+		_write_message (record->category, record->level, date, record->text);
+
+		g_date_time_unref (date);
+
+		g_atomic_int_set (&ring->tail, tail + 1);
+	}
+
+	if (n_dropped != ring->n_reported_dropped) {
+		GDateTime *date = g_date_time_new_now_local ();
+		char *text;
+
+		text = g_strdup_printf ("[Debug::drain] %u messages of thread %u dropped, the output being too slow",
+					n_dropped - ring->n_reported_dropped, ring->id);
+		_write_message (ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_WARNING, date, text);
+		g_free (text);
+		g_date_time_unref (date);
+
+		ring->n_reported_dropped = n_dropped;
+	}
+}
+
+/* Drains all the rings, and frees the ones of the terminated threads */
+
+static void
+_drain_rings (void)
+{
+	GSList *rings = NULL;
+	GSList *iter;
+
+	g_mutex_lock (&debug_drain_mutex);
+
+	g_mutex_lock (&debug_rings_mutex);
+	for (iter = debug_rings; iter != NULL; iter = iter->next)
+		rings = g_slist_prepend (rings, iter->data);
+	g_mutex_unlock (&debug_rings_mutex);
+
+	for (iter = rings; iter != NULL; iter = iter->next) {
+		ArvDebugRing *ring = iter->data;
+
+		/* The orphaned flag is read first, no record being added after it is set */
+		if (g_atomic_int_get (&ring->is_orphaned)) {
+			_drain_ring (ring);
+
+			g_mutex_lock (&debug_rings_mutex);
+			debug_rings = g_slist_remove (debug_rings, ring);
+			g_mutex_unlock (&debug_rings_mutex);
+
+			g_free (ring);
+		} else
+			_drain_ring (ring);
+	}
+
+	g_slist_free (rings);
+
+	fflush (stderr);
+
+	g_mutex_unlock (&debug_drain_mutex);
+}
+
+static void *
+_drain_thread (void *data)
+{
+	while (g_atomic_int_get (&debug_is_async)) {
+		_drain_rings ();
+		g_usleep (ARV_DEBUG_DRAIN_PERIOD_US);
+	}
+
+	return NULL;
+}
+
+static void
+_drain_at_exit (void)
+{
+	_drain_rings ();
+}
+
+static void arv_debug_with_level (ArvDebugCategory category,
+				  ArvDebugLevel level,
+				  const char *format,
+				  va_list args) G_GNUC_PRINTF(3,0);
+
+static void
+arv_debug_with_level (ArvDebugCategory category, ArvDebugLevel level, const char *format, va_list args)
+{
+        GDateTime *date;
+        char *text;
+
+	if (!arv_debug_check (category, level))
+		return;
+
+	if (g_atomic_int_get (&debug_is_async)) {
+		_queue_message (category, level, format, args);
+		return;
+	}
+
+        date = g_date_time_new_now_local ();
+        text = g_strdup_vprintf (format, args);
+
+        _write_message (category, level, date, text);
+
+        g_free (text);
         g_date_time_unref (date);
 }
 
+/**
+ * arv_debug_set_async:
+ * @async: whether the debug output is asynchronous
+ *
+ * Makes the debug output asynchronous, or synchronous again. When asynchronous, the messages are formatted in per
+ * thread rings of fixed size records, and written to stderr by a background thread, which avoids blocking the stream
+ * threads on the output. The messages longer than 240 bytes are truncated, and the messages logged while the ring of
+ * the thread is full are dropped, their number being reported in the output. Asynchronous output is also enabled by the
+ * `async` keyword of the debug category selection, see arv_debug_enable().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_debug_set_async (gboolean async)
+{
+	static gsize exit_handler_installed = 0;
+	GThread *thread = NULL;
+
+	if (g_once_init_enter (&exit_handler_installed)) {
+		atexit (_drain_at_exit);
+		g_once_init_leave (&exit_handler_installed, 1);
+	}
+
+	g_mutex_lock (&debug_drain_mutex);
+	if (async && debug_drain_thread == NULL) {
+		g_atomic_int_set (&debug_is_async, 1);
+		debug_drain_thread = g_thread_new ("arv_debug_drain", _drain_thread, NULL);
+	} else if (!async && debug_drain_thread != NULL) {
+		g_atomic_int_set (&debug_is_async, 0);
+		thread = debug_drain_thread;
+		debug_drain_thread = NULL;
+	}
+	g_mutex_unlock (&debug_drain_mutex);
+
+	if (thread != NULL) {
+		g_thread_join (thread);
+		_drain_rings ();
+	}
+}
+
 void
 arv_warning (ArvDebugCategory category, const char *format, ...)
 {
@@ -248,6 +490,8 @@ arv_trace (ArvDebugCategory category, const char *format, ...)
  * arv_debug_enable ("gvcp:3,genicam");
  * ```
  *
+ * The `async` keyword makes the output asynchronous, see arv_debug_set_async().
+ *
  * Returns: %TRUE on success
  * Since: 0.8.8
  */
@@ -273,6 +517,7 @@ arv_debug_dup_infos_as_string (void)
 					arv_debug_category_infos[i].description);
 	}
 	g_string_append (string, "all            : Everything\n");
+	g_string_append (string, "async          : Asynchronous output, for the real-time threads\n");
 
 	g_string_append (string, "\nDebug levels:\n");
 	for (i = 0; i < ARV_DEBUG_LEVEL_N_ELEMENTS; i++) {
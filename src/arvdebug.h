@@ -33,6 +33,7 @@
 G_BEGIN_DECLS
 
 ARV_API gboolean	arv_debug_enable		(const char *category_selection);
+ARV_API void		arv_debug_set_async		(gboolean async);
 
 G_END_DECLS
 
@@ -61,59 +61,82 @@ typedef enum {
 
 extern ArvDebugCategoryInfos arv_debug_category_infos[];
 
-#define arv_warning_dom(...)		arv_warning (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
-#define arv_info_dom(...)	 	arv_info (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
-#define arv_debug_dom(...)		arv_debug (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
-
-#define arv_warning_interface(...)	arv_warning (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
-#define arv_info_interface(...) 	arv_info (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
-#define arv_debug_interface(...)	arv_debug (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
-
-#define arv_warning_device(...)		arv_warning (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
-#define arv_info_device(...) 		arv_info (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
-#define arv_debug_device(...)		arv_debug (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
-
-#define arv_warning_chunk(...)		arv_warning (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
-#define arv_info_chunk(...) 		arv_info (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
-#define arv_debug_chunk(...)		arv_debug (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
-
-#define arv_warning_stream(...)		arv_warning (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
-#define arv_info_stream(...) 		arv_info (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
-#define arv_debug_stream(...)		arv_debug (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
-
-#define arv_warning_stream_thread(...)	arv_warning (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
-#define arv_info_stream_thread(...) 	arv_info (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
-#define arv_debug_stream_thread(...)	arv_debug (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
-
-#define arv_warning_cp(...)		arv_warning (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_info_cp(...) 		arv_info (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_debug_cp(...)		arv_debug (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_trace_cp(...)		arv_trace (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-
-#define arv_warning_sp(...)		arv_warning (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_info_sp(...) 		arv_info (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_debug_sp(...)		arv_debug (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_trace_sp(...)		arv_trace (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-
-#define arv_warning_genicam(...)	arv_warning (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
-#define arv_info_genicam(...) 		arv_info (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
-#define arv_debug_genicam(...)		arv_debug (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
-
-#define arv_warning_policies(...)	arv_warning (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
-#define arv_info_policies(...) 		arv_info (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
-#define arv_debug_policies(...)		arv_debug (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
-
-#define arv_warning_evaluator(...)	arv_warning (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
-#define arv_info_evaluator(...) 	arv_info (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
-#define arv_debug_evaluator(...)	arv_debug (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
-
-#define arv_warning_misc(...)		arv_warning (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
-#define arv_info_misc(...) 		arv_info (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
-#define arv_debug_misc(...)		arv_debug (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
-
-#define arv_warning_viewer(...)		arv_warning (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
-#define arv_info_viewer(...)	 	arv_info (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
-#define arv_debug_viewer(...)		arv_debug (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
+#ifdef ARAVIS_COMPILATION
+
+#include <arvparamsprivate.h>
+
+/* Inside the library, the debug level is checked before the evaluation of the message arguments, and the levels above
+ * ARV_DEBUG_LEVEL_MAX are compiled out. */
+
+#define arv_debug_is_enabled(category, level)							\
+	((int) (level) <= (int) ARV_DEBUG_LEVEL_MAX &&						\
+	 (int) (level) <= (int) arv_debug_category_infos[category].level)
+
+#define arv_debug_if_enabled(func, category, level, ...)					\
+	G_STMT_START {										\
+		if (G_UNLIKELY (arv_debug_is_enabled (category, level)))			\
+			func (category, __VA_ARGS__);						\
+	} G_STMT_END
+
+#else
+
+#define arv_debug_if_enabled(func, category, level, ...)	func (category, __VA_ARGS__)
+
+#endif
+
+#define arv_warning_dom(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_dom(...)	 	arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_dom(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_interface(...)	arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_interface(...) 	arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_interface(...)	arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_device(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_device(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_device(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_chunk(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_chunk(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_chunk(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_stream(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_stream(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_stream(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_stream_thread(...)	arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_stream_thread(...) 	arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_stream_thread(...)	arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_cp(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_cp(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_cp(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+#define arv_trace_cp(...)		arv_debug_if_enabled (arv_trace, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_TRACE, __VA_ARGS__)
+
+#define arv_warning_sp(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_sp(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_sp(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+#define arv_trace_sp(...)		arv_debug_if_enabled (arv_trace, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_TRACE, __VA_ARGS__)
+
+#define arv_warning_genicam(...)	arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_genicam(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_genicam(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_policies(...)	arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_policies(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_policies(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_evaluator(...)	arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_evaluator(...) 	arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_evaluator(...)	arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_misc(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_misc(...) 		arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_misc(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_viewer(...)		arv_debug_if_enabled (arv_warning, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_viewer(...)	 	arv_debug_if_enabled (arv_info, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_viewer(...)		arv_debug_if_enabled (arv_debug, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
 gboolean	arv_debug_check			(ArvDebugCategory category, ArvDebugLevel level);
 
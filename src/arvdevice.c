@@ -39,11 +39,16 @@
 #include <arvgcboolean.h>
 #include <arvgcenumeration.h>
 #include <arvgcstring.h>
+#include <arvgccategory.h>
+#include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvstream.h>
-#include <arvdebug.h>
+#include <arvdebugprivate.h>
+#include <string.h>
 
 enum {
 	ARV_DEVICE_SIGNAL_CONTROL_LOST,
+	ARV_DEVICE_SIGNAL_EVENT,
 	ARV_DEVICE_SIGNAL_LAST
 } ArvDeviceSignals;
 
@@ -57,8 +62,26 @@ arv_device_error_quark (void)
 
 typedef struct {
 	GError *init_error;
+
+	GMutex dispatcher_mutex;
+	GThreadPool *dispatcher;	/* single thread pool running the asynchronous commands, created on demand */
+
+	GMutex event_mutex;
+	GHashTable *event_data;		/* event id -> GBytes of the last received event item */
+
+	GMutex streams_mutex;
+	GPtrArray *streams;		/* GWeakRef on the streams created from this device */
+
+	GPtrArray *infos;
 } ArvDevicePrivate;
 
+typedef struct {
+	char *name;
+	GType type;
+	gpointer data;
+	ArvDeviceInfoFunc func;
+} ArvDeviceInfo;
+
 static void arv_device_initable_iface_init (GInitableIface *iface);
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvDevice, arv_device, G_TYPE_OBJECT,
@@ -209,6 +232,93 @@ arv_device_write_register (ArvDevice *device, guint64 address, guint32 value, GE
 	return ARV_DEVICE_GET_CLASS (device)->write_register (device, address, value, error);
 }
 
+/**
+ * arv_device_read_registers:
+ * @device: a #ArvDevice
+ * @n_registers: number of registers
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (array length=n_registers) (out caller-allocates): placeholder for the read values
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Reads the value of several device registers. Depending on the protocol, the registers are read using a
+ * minimal number of transactions, which is faster than successive calls to arv_device_read_register().
+ *
+ * Return value: TRUE on success.
+ *
+ * Since: 0.8.24
+ **/
+
+gboolean
+arv_device_read_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, guint32 *values,
+			   GError **error)
+{
+	ArvDeviceClass *device_class;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (n_registers == 0 || addresses != NULL, FALSE);
+	g_return_val_if_fail (n_registers == 0 || values != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (n_registers == 0)
+		return TRUE;
+
+	device_class = ARV_DEVICE_GET_CLASS (device);
+
+	if (device_class->read_registers != NULL)
+		return device_class->read_registers (device, n_registers, addresses, values, error);
+
+	for (i = 0; i < n_registers; i++)
+		if (!device_class->read_register (device, addresses[i], &values[i], error))
+			return FALSE;
+
+	return TRUE;
+}
+
+/**
+ * arv_device_write_registers:
+ * @device: a #ArvDevice
+ * @n_registers: number of registers
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (array length=n_registers): values to write
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Writes several device registers, in the order of @addresses. Depending on the protocol, the registers are
+ * written using a minimal number of transactions, which is faster than successive calls to
+ * arv_device_write_register().
+ *
+ * Return value: TRUE on success.
+ *
+ * Since: 0.8.24
+ **/
+
+gboolean
+arv_device_write_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, const guint32 *values,
+			    GError **error)
+{
+	ArvDeviceClass *device_class;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (n_registers == 0 || addresses != NULL, FALSE);
+	g_return_val_if_fail (n_registers == 0 || values != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (n_registers == 0)
+		return TRUE;
+
+	device_class = ARV_DEVICE_GET_CLASS (device);
+
+	if (device_class->write_registers != NULL)
+		return device_class->write_registers (device, n_registers, addresses, values, error);
+
+	for (i = 0; i < n_registers; i++)
+		if (!device_class->write_register (device, addresses[i], values[i], error))
+			return FALSE;
+
+	return TRUE;
+}
+
 /**
  * arv_device_get_genicam:
  * @device: a #ArvDevice
@@ -228,6 +338,60 @@ arv_device_get_genicam (ArvDevice *device)
 	return ARV_DEVICE_GET_CLASS (device)->get_genicam (device);
 }
 
+/**
+ * arv_device_begin_transaction:
+ * @device: a #ArvDevice
+ *
+ * Starts a feature transaction. The register writes triggered by the following feature assignments are queued,
+ * merged when they target the same or adjacent registers, and only sent to the device by arv_device_commit(),
+ * in their original order. It allows applying a configuration in a few transactions.
+ *
+ * See arv_gc_begin_transaction().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_begin_transaction (ArvDevice *device)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	arv_gc_begin_transaction (genicam);
+}
+
+/**
+ * arv_device_commit:
+ * @device: a #ArvDevice
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Ends the feature transaction started by arv_device_begin_transaction(), and flushes the queued writes.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_commit (ArvDevice *device, GError **error)
+{
+	ArvGc *genicam;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+
+	genicam = arv_device_get_genicam (device);
+	if (!ARV_IS_GC (genicam)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_GENICAM_NOT_FOUND, "Genicam data not found");
+		return FALSE;
+	}
+
+	return arv_gc_commit_transaction (genicam, error);
+}
+
 /**
  * arv_device_get_genicam_xml:
  * @device: a #ArvDevice
@@ -278,6 +442,190 @@ arv_device_create_chunk_parser (ArvDevice *device)
 	return arv_chunk_parser_new (xml, size);
 }
 
+/**
+ * arv_device_start_event_channel:
+ * @device: a #ArvDevice
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts the reception of the device events, on the GigE Vision message channel or on the USB3 Vision event
+ * endpoint. Each received event is signaled by #ArvDevice::event, and its content is made available to the Genicam
+ * nodes mapped on the event port of the same event id. The events to be sent must still be enabled on the device
+ * side, usually using the EventSelector and EventNotification features.
+ *
+ * Returns: %TRUE if the event channel is running.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_start_event_channel (ArvDevice *device, GError **error)
+{
+	ArvDeviceClass *device_class;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+
+	device_class = ARV_DEVICE_GET_CLASS (device);
+	if (device_class->start_event_channel == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Events not supported by this device type");
+		return FALSE;
+	}
+
+	return device_class->start_event_channel (device, error);
+}
+
+/**
+ * arv_device_stop_event_channel:
+ * @device: a #ArvDevice
+ *
+ * Stops the event reception started by arv_device_start_event_channel(). It must not be called from an
+ * #ArvDevice::event callback.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_stop_event_channel (ArvDevice *device)
+{
+	ArvDeviceClass *device_class;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	device_class = ARV_DEVICE_GET_CLASS (device);
+	if (device_class->stop_event_channel != NULL)
+		device_class->stop_event_channel (device);
+}
+
+/**
+ * arv_device_reconnect:
+ * @device: a #ArvDevice
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Reestablishes the connection to a device after a link or a control loss, typically signaled by
+ * #ArvDevice::control-lost. The device identity is checked, the Genicam data is kept, but the register cache is
+ * invalidated, as the device may have been power cycled. The streams created from @device are then restarted with
+ * their queued buffers, which spares the time of a full reinstantiation of the device and of its streams. If the
+ * reconnection fails, the streams stay stopped, and the reconnection can be retried later.
+ *
+ * The device settings are not restored, as they may have been reset by a power cycle.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_reconnect (ArvDevice *device, GError **error)
+{
+	ArvDeviceClass *device_class;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+
+	device_class = ARV_DEVICE_GET_CLASS (device);
+	if (device_class->reconnect == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Reconnection not supported by this device type");
+		return FALSE;
+	}
+
+	return device_class->reconnect (device, error);
+}
+
+static void
+_weak_ref_free (GWeakRef *weak_ref)
+{
+	g_weak_ref_clear (weak_ref);
+	g_free (weak_ref);
+}
+
+/* Keeps track of the streams created from the device, for their restart after a reconnection. The streams hold a
+ * reference on their device, hence the weak references. */
+
+void
+arv_device_add_stream (ArvDevice *device, ArvStream *stream)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GWeakRef *weak_ref;
+	guint i;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_mutex_lock (&priv->streams_mutex);
+
+	for (i = 0; i < priv->streams->len; ) {
+		GObject *object = g_weak_ref_get (g_ptr_array_index (priv->streams, i));
+
+		if (object == NULL) {
+			g_ptr_array_remove_index_fast (priv->streams, i);
+		} else {
+			g_object_unref (object);
+			i++;
+		}
+	}
+
+	weak_ref = g_new0 (GWeakRef, 1);
+	g_weak_ref_init (weak_ref, stream);
+	g_ptr_array_add (priv->streams, weak_ref);
+
+	g_mutex_unlock (&priv->streams_mutex);
+}
+
+/* Returns the alive streams created from the device, the array holding a reference on each of them. */
+
+GPtrArray *
+arv_device_dup_streams (ArvDevice *device)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GPtrArray *streams;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	streams = g_ptr_array_new_with_free_func (g_object_unref);
+
+	g_mutex_lock (&priv->streams_mutex);
+	for (i = 0; i < priv->streams->len; i++) {
+		GObject *object = g_weak_ref_get (g_ptr_array_index (priv->streams, i));
+
+		if (object != NULL)
+			g_ptr_array_add (streams, object);
+	}
+	g_mutex_unlock (&priv->streams_mutex);
+
+	return streams;
+}
+
+/**
+ * arv_device_dup_event_data:
+ * @device: a #ArvDevice
+ * @event_id: an event identifier
+ *
+ * Returns: (transfer full) (nullable): the last received event item of id @event_id, including its header, as
+ * accessed by the Genicam event port nodes, or %NULL.
+ *
+ * Since: 0.8.24
+ */
+
+GBytes *
+arv_device_dup_event_data (ArvDevice *device, guint event_id)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GBytes *bytes = NULL;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	g_mutex_lock (&priv->event_mutex);
+	if (priv->event_data != NULL) {
+		bytes = g_hash_table_lookup (priv->event_data, GUINT_TO_POINTER (event_id));
+		if (bytes != NULL)
+			g_bytes_ref (bytes);
+	}
+	g_mutex_unlock (&priv->event_mutex);
+
+	return bytes;
+}
+
 /**
  * arv_device_get_feature:
  * @device: a #ArvDevice
@@ -484,6 +832,9 @@ arv_device_set_string_feature_value (ArvDevice *device, const char *feature, con
  * @feature: feature name
  * @error: a #GError placeholder
  *
+ * The returned string is owned by the feature node, and is only valid until the next read of the feature. Use
+ * arv_device_dup_string_feature_value() when the feature may be read from several threads.
+ *
  * Returns: the string feature value, %NULL on error.
  *
  * Since: 0.8.0
@@ -501,6 +852,32 @@ arv_device_get_string_feature_value (ArvDevice *device, const char *feature, GEr
 	return NULL;
 }
 
+/**
+ * arv_device_dup_string_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_get_string_feature_value(), but returns a copy of the value, which stays valid when the
+ * feature is read from another thread.
+ *
+ * Returns: (transfer full): the string feature value, to be freed with g_free(), %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_device_dup_string_feature_value (ArvDevice *device, const char *feature, GError  **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_STRING, feature, error);
+	if (node != NULL)
+		return arv_gc_string_dup_value (ARV_GC_STRING (node), error);
+
+	return NULL;
+}
+
 /**
  * arv_device_set_integer_feature_value:
  * @device: a #ArvDevice
@@ -776,63 +1153,334 @@ arv_device_get_float_feature_increment (ArvDevice *device, const char *feature,
 }
 
 /**
- * arv_device_dup_available_enumeration_feature_values:
- * @device: an #ArvDevice
+ * ArvFeatureHandle:
+ *
+ * An opaque handle on a device feature, resolved once by arv_device_get_feature_handle(). The accesses through a
+ * handle skip the feature lookup by name, which is useful for the features set or read for each acquired frame.
+ * A handle is owned by the device, and stays valid until the device is destroyed.
+ *
+ * Since: 0.8.24
+ */
+
+/**
+ * arv_device_get_feature_handle:
+ * @device: a #ArvDevice
  * @feature: feature name
- * @n_values: placeholder for the number of returned values
  * @error: a #GError placeholder
  *
- * Get all the available values of @feature, as integers.
- *
- * Returns: (array length=n_values) (transfer container): a newly created array of 64 bit integers, which must freed after use using g_free,
- * or NULL on error.
+ * Returns: (transfer none): a handle on @feature, %NULL if the feature doesn't exist.
  *
- * Since: 0.8.0
+ * Since: 0.8.24
  */
 
-gint64 *
-arv_device_dup_available_enumeration_feature_values (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+ArvFeatureHandle *
+arv_device_get_feature_handle (ArvDevice *device, const char *feature, GError **error)
 {
-	ArvGcNode *node;
+	return _get_feature (device, ARV_TYPE_GC_FEATURE_NODE, feature, error);
+}
 
-	if (n_values != NULL)
-		*n_values = 0;
+static void *
+_get_handle_feature (ArvFeatureHandle *handle, GType node_type, GError **error)
+{
+	void *node = handle;
 
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), n_values, error);
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (node), NULL);
 
-	return NULL;
+	if (!(G_TYPE_CHECK_INSTANCE_TYPE ((node), node_type))) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_WRONG_FEATURE,
+			     "[%s:%s] Not a %s", arv_gc_feature_node_get_name (node),
+			     G_OBJECT_TYPE_NAME (node), g_type_name (node_type));
+		return NULL;
+	}
+
+	return node;
 }
 
 /**
- * arv_device_dup_available_enumeration_feature_values_as_strings:
- * @device: an #ArvDevice
- * @feature: feature name
- * @n_values: placeholder for the number of returned values
- * @error: a #GError placeholder
- *
- * Get all the available values of @feature, as strings.
+ * arv_feature_handle_get_name:
+ * @handle: a #ArvFeatureHandle
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
- * or NULL on error.
+ * Returns: the feature name.
  *
- * Since: 0.8.0
+ * Since: 0.8.24
  */
 
-const char **
-arv_device_dup_available_enumeration_feature_values_as_strings (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+const char *
+arv_feature_handle_get_name (ArvFeatureHandle *handle)
 {
-	ArvGcNode *node;
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (handle), NULL);
 
-	if (n_values != NULL)
-		*n_values = 0;
-
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node), n_values, error);
-
-	return NULL;
+	return arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (handle));
+}
+
+/**
+ * arv_feature_handle_is_available:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Returns: %TRUE if the feature is implemented and available, see arv_device_is_feature_available().
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_feature_handle_is_available (ArvFeatureHandle *handle, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (handle), FALSE);
+
+	return arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (handle), error);
+}
+
+/**
+ * arv_feature_handle_execute_command:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_execute_command(), using a feature handle.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_feature_handle_execute_command (ArvFeatureHandle *handle, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_COMMAND, error);
+	if (node != NULL)
+		arv_gc_command_execute (ARV_GC_COMMAND (node), error);
+}
+
+/**
+ * arv_feature_handle_set_boolean:
+ * @handle: a #ArvFeatureHandle
+ * @value: feature value
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_set_boolean_feature_value(), using a feature handle.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_feature_handle_set_boolean (ArvFeatureHandle *handle, gboolean value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_BOOLEAN, error);
+	if (node != NULL)
+		arv_gc_boolean_set_value (ARV_GC_BOOLEAN (node), value, error);
+}
+
+/**
+ * arv_feature_handle_get_boolean:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Returns: the boolean feature value, %FALSE on error.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_feature_handle_get_boolean (ArvFeatureHandle *handle, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_BOOLEAN, error);
+	if (node != NULL)
+		return arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), error);
+
+	return FALSE;
+}
+
+/**
+ * arv_feature_handle_set_string:
+ * @handle: a #ArvFeatureHandle
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_set_string_feature_value(), using a feature handle.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_feature_handle_set_string (ArvFeatureHandle *handle, const char *value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_STRING, error);
+	if (node != NULL)
+		arv_gc_string_set_value (ARV_GC_STRING (node), value, error);
+}
+
+/**
+ * arv_feature_handle_get_string:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Returns: the string feature value, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+const char *
+arv_feature_handle_get_string (ArvFeatureHandle *handle, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_STRING, error);
+	if (node != NULL)
+		return arv_gc_string_get_value (ARV_GC_STRING (node), error);
+
+	return NULL;
+}
+
+/**
+ * arv_feature_handle_set_integer:
+ * @handle: a #ArvFeatureHandle
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_set_integer_feature_value(), using a feature handle.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_feature_handle_set_integer (ArvFeatureHandle *handle, gint64 value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_INTEGER, error);
+	if (node != NULL)
+		arv_gc_integer_set_value (ARV_GC_INTEGER (node), value, error);
+}
+
+/**
+ * arv_feature_handle_get_integer:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Returns: the integer feature value, 0 on error.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_feature_handle_get_integer (ArvFeatureHandle *handle, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_INTEGER, error);
+	if (node != NULL)
+		return arv_gc_integer_get_value (ARV_GC_INTEGER (node), error);
+
+	return 0;
+}
+
+/**
+ * arv_feature_handle_set_float:
+ * @handle: a #ArvFeatureHandle
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Same as arv_device_set_float_feature_value(), using a feature handle.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_feature_handle_set_float (ArvFeatureHandle *handle, double value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_FLOAT, error);
+	if (node != NULL)
+		arv_gc_float_set_value (ARV_GC_FLOAT (node), value, error);
+}
+
+/**
+ * arv_feature_handle_get_float:
+ * @handle: a #ArvFeatureHandle
+ * @error: a #GError placeholder
+ *
+ * Returns: the float feature value, 0.0 on error.
+ *
+ * Since: 0.8.24
+ */
+
+double
+arv_feature_handle_get_float (ArvFeatureHandle *handle, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_handle_feature (handle, ARV_TYPE_GC_FLOAT, error);
+	if (node != NULL)
+		return arv_gc_float_get_value (ARV_GC_FLOAT (node), error);
+
+	return 0.0;
+}
+
+/**
+ * arv_device_dup_available_enumeration_feature_values:
+ * @device: an #ArvDevice
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder
+ *
+ * Get all the available values of @feature, as integers.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of 64 bit integers, which must freed after use using g_free,
+ * or NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+gint64 *
+arv_device_dup_available_enumeration_feature_values (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_dup_available_enumeration_feature_values_as_strings:
+ * @device: an #ArvDevice
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder
+ *
+ * Get all the available values of @feature, as strings.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
+ * or NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+const char **
+arv_device_dup_available_enumeration_feature_values_as_strings (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
 }
 
 /**
@@ -844,239 +1492,1330 @@ arv_device_dup_available_enumeration_feature_values_as_strings (ArvDevice *devic
  *
  * Get display names of all the available entries of @feature.
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of const strings, to be freed after use using g_free, or
- * %NULL on error.
+ * Returns: (array length=n_values) (transfer container): a newly created array of const strings, to be freed after use using g_free, or
+ * %NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+const char **
+arv_device_dup_available_enumeration_feature_values_as_display_names (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_display_names (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_is_enumeration_entry_available:
+ * @device: an #ArvDevice instance
+ * @feature: enumeration feature name
+ * @entry: entry name
+ * @error: a #GError placeholder
+ *
+ * Returns: %TRUE if the feature and the feature entry are available
+ *
+ * Since: 0.8.17
+ */
+
+gboolean
+arv_device_is_enumeration_entry_available (ArvDevice *device, const char *feature, const char *entry, GError **error)
+{
+        GError *local_error = NULL;
+        const char **entries = NULL;
+        guint n_entries = 0;
+        gboolean is_available = FALSE;
+        unsigned int i;
+
+        if (!arv_device_is_feature_available (device, feature, &local_error)) {
+                if (local_error != NULL)
+                        g_propagate_error (error, local_error);
+                return FALSE;
+        }
+
+        entries = arv_device_dup_available_enumeration_feature_values_as_strings (device, feature, &n_entries,
+                                                                                  &local_error);
+
+        if (local_error != NULL) {
+                g_propagate_error (error, local_error);
+                return FALSE;
+        }
+
+        for (i = 0; i < n_entries && !is_available; i++) {
+                if (g_strcmp0 (entry, entries[i]) == 0)
+                        is_available = TRUE;
+        }
+        g_free (entries);
+
+        return is_available;
+}
+
+/**
+ * arv_device_set_features_from_string:
+ * @device: a #ArvDevice
+ * @string: a space separated list of features assignments
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Set features from a string containing a list of space separated feature assignments or command names. For example:
+ *
+ * |[<!-- language="C" -->
+ * arv_device_set_features_from_string (device, "Width=256 Height=256 PixelFormat='Mono8' TriggerStart", &error);
+ * ]|
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_device_set_features_from_string (ArvDevice *device, const char *string, GError **error)
+{
+	return arv_device_set_features_from_string_full (device, string, ARV_DEVICE_SET_FEATURES_FLAGS_NONE, error);
+}
+
+/**
+ * arv_device_set_features_from_string_full:
+ * @device: a #ArvDevice
+ * @string: a space separated list of features assignments
+ * @flags: a set of #ArvDeviceSetFeaturesFlags
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Same as arv_device_set_features_from_string(), with additional options. With
+ * %ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY, the register cache of the listed features is first updated using a
+ * minimal number of device transactions (see arv_gc_prefetch_features()), and each feature is only written if its
+ * current value differs. The comparison is done just before the write, in the list order, which makes it correct for
+ * the features depending on a selector set earlier in the list. Commands are always executed.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_set_features_from_string_full (ArvDevice *device, const char *string, ArvDeviceSetFeaturesFlags flags,
+					  GError **error)
+{
+	GMatchInfo *match_info = NULL;
+	GError *local_error = NULL;
+	GRegex *regex;
+	GPtrArray *keys;
+	GPtrArray *values;
+	guint n_skipped = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+
+	if (string == NULL)
+		return TRUE;
+
+	regex = g_regex_new ("((?<Key>[^\\s\"'\\=]+)|\"(?<Key>[^\"]*)\"|'(?<Key>[^']*)')"
+			     "(?:\\=((?<Value>[^\\s\"']+)|\"(?<Value>[^\"]*)\"|'(?<Value>[^']*)'))?",
+			     G_REGEX_DUPNAMES, 0, NULL);
+
+	keys = g_ptr_array_new_with_free_func (g_free);
+	values = g_ptr_array_new_with_free_func (g_free);
+
+	if (g_regex_match (regex, string, 0, &match_info)) {
+		while (g_match_info_matches (match_info)) {
+			g_ptr_array_add (keys, g_match_info_fetch_named (match_info, "Key"));
+			g_ptr_array_add (values, g_match_info_fetch_named (match_info, "Value"));
+
+			g_match_info_next (match_info, NULL);
+		}
+		g_match_info_unref (match_info);
+	}
+
+	g_regex_unref (regex);
+
+	if ((flags & ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY) != 0 && keys->len > 0) {
+		ArvGc *genicam = arv_device_get_genicam (device);
+		GPtrArray *features = g_ptr_array_new ();
+
+		/* One batched read for the comparisons, missing features are reported below */
+		for (i = 0; i < keys->len; i++)
+			if (ARV_IS_GC_FEATURE_NODE (arv_device_get_feature (device, g_ptr_array_index (keys, i))))
+				g_ptr_array_add (features, g_ptr_array_index (keys, i));
+		g_ptr_array_add (features, NULL);
+
+		if (ARV_IS_GC (genicam))
+			arv_gc_prefetch_features (genicam, (const char **) features->pdata, NULL);
+
+		g_ptr_array_unref (features);
+	}
+
+	if ((flags & ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION) != 0)
+		arv_device_begin_transaction (device);
+
+	for (i = 0; i < keys->len && local_error == NULL; i++) {
+		ArvGcNode *feature;
+		const char *key = g_ptr_array_index (keys, i);
+		const char *value = g_ptr_array_index (values, i);
+
+		feature = arv_device_get_feature (device, key);
+		if (ARV_IS_GC_FEATURE_NODE (feature)) {
+			if (ARV_IS_GC_COMMAND (feature)) {
+				arv_device_execute_command (device, key, &local_error);
+			} else if (value != NULL) {
+				if ((flags & ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY) != 0 &&
+				    arv_gc_feature_node_is_value_equal_to_string (ARV_GC_FEATURE_NODE (feature), value))
+					n_skipped++;
+				else
+					arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (feature), value,
+										   &local_error);
+			} else {
+				g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+					     "[%s] Require a parameter value to set", key);
+			}
+		} else
+			g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+				     "[%s] Not found", key);
+	}
+
+	if ((flags & ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION) != 0)
+		arv_device_commit (device, local_error == NULL ? &local_error : NULL);
+
+	if (n_skipped > 0)
+		arv_info_device ("[Device::set_features_from_string] %u unchanged feature(s) skipped", n_skipped);
+
+	g_ptr_array_unref (keys);
+	g_ptr_array_unref (values);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+_append_feature_values (ArvGc *genicam, const char *name, gboolean writable_only, GHashTable *names, GString *string)
+{
+	ArvGcNode *node;
+	ArvGcAccessMode access_mode;
+
+	if (g_hash_table_contains (names, name))
+		return;
+	g_hash_table_add (names, (char *) name);
+
+	node = arv_gc_get_node (genicam, name);
+	if (!ARV_IS_GC_FEATURE_NODE (node) ||
+	    !arv_gc_feature_node_is_implemented (ARV_GC_FEATURE_NODE (node), NULL) ||
+	    !arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (node), NULL))
+		return;
+
+	if (ARV_IS_GC_CATEGORY (node)) {
+		const GSList *iter;
+
+		for (iter = arv_gc_category_get_features (ARV_GC_CATEGORY (node)); iter != NULL; iter = iter->next)
+			_append_feature_values (genicam, iter->data, writable_only, names, string);
+		return;
+	}
+
+	if (!ARV_IS_GC_INTEGER (node) && !ARV_IS_GC_FLOAT (node) &&
+	    !ARV_IS_GC_STRING (node) && !ARV_IS_GC_BOOLEAN (node))
+		return;
+
+	access_mode = arv_gc_feature_node_get_actual_access_mode (ARV_GC_FEATURE_NODE (node));
+	if (access_mode == ARV_GC_ACCESS_MODE_WO ||
+	    (writable_only && access_mode != ARV_GC_ACCESS_MODE_RW))
+		return;
+
+	if (ARV_IS_GC_FLOAT (node) && !ARV_IS_GC_INTEGER (node)) {
+		char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+		GError *error = NULL;
+		double value;
+
+		/* Shortest representation which reads back to the same value */
+		value = arv_gc_float_get_value (ARV_GC_FLOAT (node), &error);
+		if (error == NULL)
+			g_string_append_printf (string, "%s='%s'\n", name,
+						g_ascii_dtostr (buffer, sizeof (buffer), value));
+		g_clear_error (&error);
+	} else {
+		GError *error = NULL;
+		char *value;
+
+		value = arv_gc_feature_node_dup_value_as_string (ARV_GC_FEATURE_NODE (node), &error);
+		if (error == NULL && value != NULL) {
+			if (strchr (value, '\'') == NULL)
+				g_string_append_printf (string, "%s='%s'\n", name, value);
+			else
+				g_string_append_printf (string, "%s=\"%s\"\n", name, value);
+		}
+		g_free (value);
+		g_clear_error (&error);
+	}
+}
+
+/* Feature values in the arv_device_set_features_from_string() format, one per line, in the feature tree order */
+
+char *
+arv_device_dup_feature_values (ArvDevice *device, gboolean writable_only)
+{
+	ArvGc *genicam;
+	GHashTable *names;
+	GString *string;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	genicam = arv_device_get_genicam (device);
+	if (!ARV_IS_GC (genicam))
+		return NULL;
+
+	names = g_hash_table_new (g_str_hash, g_str_equal);
+	string = g_string_new (NULL);
+
+	_append_feature_values (genicam, "Root", writable_only, names, string);
+
+	g_hash_table_unref (names);
+
+	return g_string_free (string, FALSE);
+}
+
+/**
+ * arv_device_dup_feature_snapshot:
+ * @device: a #ArvDevice
+ *
+ * Takes a host side snapshot of the current value of the writable features, that can be restored using
+ * arv_device_set_features_from_string_full(). The features are listed in the feature tree order, one per line. The
+ * features depending on a selector are only saved for the current selector value.
+ *
+ * Returns: (transfer full): a newly allocated string, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_device_dup_feature_snapshot (ArvDevice *device)
+{
+	return arv_device_dup_feature_values (device, TRUE);
+}
+
+/**
+ * arv_device_save_feature_snapshot:
+ * @device: a #ArvDevice
+ * @filename: destination file name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Saves a feature snapshot to a file. See arv_device_dup_feature_snapshot().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_save_feature_snapshot (ArvDevice *device, const char *filename, GError **error)
+{
+	char *snapshot;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	snapshot = arv_device_dup_feature_snapshot (device);
+	if (snapshot == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_GENICAM_NOT_FOUND, "Genicam data not found");
+		return FALSE;
+	}
+
+	success = g_file_set_contents (filename, snapshot, -1, error);
+
+	g_free (snapshot);
+
+	return success;
+}
+
+/**
+ * arv_device_load_feature_snapshot:
+ * @device: a #ArvDevice
+ * @filename: snapshot file name
+ * @flags: a set of #ArvDeviceSetFeaturesFlags
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Restores a feature snapshot saved by arv_device_save_feature_snapshot(). Using
+ * %ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY, only the features whose value differs from the snapshot are written.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_load_feature_snapshot (ArvDevice *device, const char *filename, ArvDeviceSetFeaturesFlags flags,
+				  GError **error)
+{
+	char *snapshot = NULL;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	if (!g_file_get_contents (filename, &snapshot, NULL, error))
+		return FALSE;
+
+	success = arv_device_set_features_from_string_full (device, snapshot, flags, error);
+
+	g_free (snapshot);
+
+	return success;
+}
+
+/**
+ * arv_device_set_register_cache_policy:
+ * @device: a #ArvDevice
+ * @policy: cache policy
+ *
+ * Sets the register cache policy.
+ *
+ * <warning><para>Be aware that some camera may have wrong Cachable properties defined in their Genicam metadata, which
+ * may lead to incorrect readouts. Using the debug cache policy, and activating genicam debug output (export
+ * ARV_DEBUG=genicam), can help you to check the cache validity. In this mode, every time the cache content is not in
+ * sync with the actual register value, a debug message is printed on the console.</para></warning>
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_set_register_cache_policy (ArvDevice *device, ArvRegisterCachePolicy policy)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, policy);
+}
+
+/**
+ * arv_device_set_range_check_policy:
+ * @device: a #ArvDevice
+ * @policy: range check policy
+ *
+ * Sets the range check policy. When enabled, before being set, the value of all nodes with an #ArvGcFloat or
+ * #ArvGcInteger interface will be checked against their Min and Max properties.
+ *
+ * <warning><para>Be aware that some camera may have wrong definition of Min and Max, as this check is defined as not
+ * mandatory in the Genicam specification. If this is the case, it will not possible to set the value of the features
+ * with faulty Min or Max definition. Range check is disabled by default.</para></warning>
+ *
+ * Since: 0.8.6
+ */
+
+void
+arv_device_set_range_check_policy (ArvDevice *device, ArvRangeCheckPolicy policy)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_range_check_policy (genicam, policy);
+}
+
+/**
+ * arv_device_set_access_check_policy:
+ * @device: a #ArvDevice
+ * @policy: access check policy
+ *
+ * Sets the feature access check policy. When enabled, before being accessed, the actual read/write access of register
+ * is checked using AccessMode properties. On some devices, it helps to avoid forbidden writes to registers that may put
+ * the device in a bad state.
+ *
+ * <warning><para>Access check is disabled by default.</para></warning>
+ *
+ * Since: 0.8.22
+ */
+
+void
+arv_device_set_access_check_policy (ArvDevice *device, ArvAccessCheckPolicy policy)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_access_check_policy (genicam, policy);
+}
+
+void
+arv_device_emit_control_lost_signal (ArvDevice *device)
+{
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	g_signal_emit (device, arv_device_signals[ARV_DEVICE_SIGNAL_CONTROL_LOST], 0);
+}
+
+/* Called from the event reception thread. The event item is stored before the emission, for the signal handlers to
+ * be able to read the event features. */
+
+void
+arv_device_emit_event_signal (ArvDevice *device, guint event_id, guint64 timestamp,
+			      const void *item, size_t item_size,
+			      const void *data, size_t data_size)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GBytes *data_bytes;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	g_mutex_lock (&priv->event_mutex);
+	if (priv->event_data == NULL)
+		priv->event_data = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+							  NULL, (GDestroyNotify) g_bytes_unref);
+	g_hash_table_replace (priv->event_data, GUINT_TO_POINTER (event_id), g_bytes_new (item, item_size));
+	g_mutex_unlock (&priv->event_mutex);
+
+	data_bytes = g_bytes_new (data, data_size);
+	g_signal_emit (device, arv_device_signals[ARV_DEVICE_SIGNAL_EVENT], 0, event_id, timestamp, data_bytes);
+	g_bytes_unref (data_bytes);
+}
+
+
+void arv_device_take_init_error (ArvDevice *device, GError *error)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	g_clear_error (&priv->init_error);
+	priv->init_error = error;
+}
+
+/* Asynchronous API */
+
+typedef enum {
+	ARV_DEVICE_ASYNC_READ_MEMORY,
+	ARV_DEVICE_ASYNC_WRITE_MEMORY,
+	ARV_DEVICE_ASYNC_READ_REGISTER,
+	ARV_DEVICE_ASYNC_WRITE_REGISTER,
+	ARV_DEVICE_ASYNC_EXECUTE_COMMAND,
+	ARV_DEVICE_ASYNC_SET_BOOLEAN,
+	ARV_DEVICE_ASYNC_SET_STRING,
+	ARV_DEVICE_ASYNC_SET_INTEGER,
+	ARV_DEVICE_ASYNC_SET_FLOAT
+} ArvDeviceAsyncCommand;
+
+typedef struct {
+	ArvDeviceAsyncCommand command;
+
+	guint64 address;
+	guint32 size;
+	GBytes *data;
+	guint32 register_value;
+
+	char *feature;
+	gboolean boolean_value;
+	char *string_value;
+	gint64 integer_value;
+	double float_value;
+} ArvDeviceAsyncData;
+
+static void
+_async_data_free (ArvDeviceAsyncData *async_data)
+{
+	g_clear_pointer (&async_data->data, g_bytes_unref);
+	g_clear_pointer (&async_data->feature, g_free);
+	g_clear_pointer (&async_data->string_value, g_free);
+	g_free (async_data);
+}
+
+/* Runs in the device dispatcher thread. The dispatcher has a single thread, which keeps the commands of a device in
+ * order, while the commands of different devices run concurrently. */
+
+static void
+_dispatch_async_command (gpointer data, gpointer user_data)
+{
+	GTask *task = data;
+	ArvDevice *device = g_task_get_source_object (task);
+	ArvDeviceAsyncData *async_data = g_task_get_task_data (task);
+	GError *error = NULL;
+
+	if (g_task_return_error_if_cancelled (task)) {
+		g_object_unref (task);
+		return;
+	}
+
+	switch (async_data->command) {
+		case ARV_DEVICE_ASYNC_READ_MEMORY:
+			{
+				void *buffer = g_malloc (async_data->size);
+
+				if (arv_device_read_memory (device, async_data->address, async_data->size, buffer, &error))
+					g_task_return_pointer (task, g_bytes_new_take (buffer, async_data->size),
+							       (GDestroyNotify) g_bytes_unref);
+				else {
+					g_free (buffer);
+					g_task_return_error (task, error);
+				}
+			}
+			g_object_unref (task);
+			return;
+		case ARV_DEVICE_ASYNC_WRITE_MEMORY:
+			arv_device_write_memory (device, async_data->address, async_data->size,
+						 (void *) g_bytes_get_data (async_data->data, NULL), &error);
+			break;
+		case ARV_DEVICE_ASYNC_READ_REGISTER:
+			arv_device_read_register (device, async_data->address, &async_data->register_value, &error);
+			break;
+		case ARV_DEVICE_ASYNC_WRITE_REGISTER:
+			arv_device_write_register (device, async_data->address, async_data->register_value, &error);
+			break;
+		case ARV_DEVICE_ASYNC_EXECUTE_COMMAND:
+			arv_device_execute_command (device, async_data->feature, &error);
+			break;
+		case ARV_DEVICE_ASYNC_SET_BOOLEAN:
+			arv_device_set_boolean_feature_value (device, async_data->feature, async_data->boolean_value,
+							      &error);
+			break;
+		case ARV_DEVICE_ASYNC_SET_STRING:
+			arv_device_set_string_feature_value (device, async_data->feature, async_data->string_value,
+							     &error);
+			break;
+		case ARV_DEVICE_ASYNC_SET_INTEGER:
+			arv_device_set_integer_feature_value (device, async_data->feature, async_data->integer_value,
+							      &error);
+			break;
+		case ARV_DEVICE_ASYNC_SET_FLOAT:
+			arv_device_set_float_feature_value (device, async_data->feature, async_data->float_value,
+							    &error);
+			break;
+	}
+
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_boolean (task, TRUE);
+
+	g_object_unref (task);
+}
+
+static void
+_push_async_command (ArvDevice *device, ArvDeviceAsyncData *async_data, gpointer source_tag,
+		     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GTask *task;
+
+	task = g_task_new (device, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+	g_task_set_task_data (task, async_data, (GDestroyNotify) _async_data_free);
+
+	g_mutex_lock (&priv->dispatcher_mutex);
+	if (priv->dispatcher == NULL)
+		priv->dispatcher = g_thread_pool_new (_dispatch_async_command, NULL, 1, FALSE, NULL);
+	g_thread_pool_push (priv->dispatcher, task, NULL);
+	g_mutex_unlock (&priv->dispatcher_mutex);
+}
+
+static gboolean
+_finish_async_command (ArvDevice *device, GAsyncResult *result, gpointer source_tag, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, device), FALSE);
+	g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == source_tag, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * arv_device_read_memory_async:
+ * @device: a #ArvDevice
+ * @address: memory address
+ * @size: number of bytes to read
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the data is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_read_memory(). The commands of a device are run in order, in a
+ * dispatcher thread, and @callback is invoked in the thread default main context of the caller. Use
+ * arv_device_read_memory_finish() to get the result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_read_memory_async (ArvDevice *device, guint64 address, guint32 size, GCancellable *cancellable,
+			      GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (size > 0);
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_READ_MEMORY;
+	async_data->address = address;
+	async_data->size = size;
+
+	_push_async_command (device, async_data, arv_device_read_memory_async, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_read_memory_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Finishes an operation started with arv_device_read_memory_async().
+ *
+ * Returns: (transfer full): the read data, or %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+GBytes *
+arv_device_read_memory_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+	g_return_val_if_fail (g_task_is_valid (result, device), NULL);
+	g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == arv_device_read_memory_async, NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * arv_device_write_memory_async:
+ * @device: a #ArvDevice
+ * @address: memory address
+ * @size: number of bytes to write
+ * @buffer: (array length=size) (element-type guint8): the data to write, copied by this function
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the data is written
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_write_memory(). Use arv_device_write_memory_finish() to get the result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_write_memory_async (ArvDevice *device, guint64 address, guint32 size, const void *buffer,
+			       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (buffer != NULL);
+	g_return_if_fail (size > 0);
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_WRITE_MEMORY;
+	async_data->address = address;
+	async_data->size = size;
+	async_data->data = g_bytes_new (buffer, size);
+
+	_push_async_command (device, async_data, arv_device_write_memory_async, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_write_memory_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Finishes an operation started with arv_device_write_memory_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_write_memory_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return _finish_async_command (device, result, arv_device_write_memory_async, error);
+}
+
+/**
+ * arv_device_read_register_async:
+ * @device: a #ArvDevice
+ * @address: register address
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the register is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_read_register(). Use arv_device_read_register_finish() to get the result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_read_register_async (ArvDevice *device, guint64 address, GCancellable *cancellable,
+				GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_READ_REGISTER;
+	async_data->address = address;
+
+	_push_async_command (device, async_data, arv_device_read_register_async, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_read_register_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @value: (out): a placeholder for the read value
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Finishes an operation started with arv_device_read_register_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_read_register_finish (ArvDevice *device, GAsyncResult *result, guint32 *value, GError **error)
+{
+	gboolean success;
+
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	success = _finish_async_command (device, result, arv_device_read_register_async, error);
+	if (success) {
+		ArvDeviceAsyncData *async_data = g_task_get_task_data (G_TASK (result));
+
+		*value = async_data->register_value;
+	} else
+		*value = 0;
+
+	return success;
+}
+
+/**
+ * arv_device_write_register_async:
+ * @device: a #ArvDevice
+ * @address: register address
+ * @value: value to write
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the register is written
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_write_register(). Use arv_device_write_register_finish() to get the
+ * result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_write_register_async (ArvDevice *device, guint64 address, guint32 value, GCancellable *cancellable,
+				 GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_WRITE_REGISTER;
+	async_data->address = address;
+	async_data->register_value = value;
+
+	_push_async_command (device, async_data, arv_device_write_register_async, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_write_register_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Finishes an operation started with arv_device_write_register_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_device_write_register_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return _finish_async_command (device, result, arv_device_write_register_async, error);
+}
+
+static void
+_push_feature_command (ArvDevice *device, ArvDeviceAsyncData *async_data, const char *feature,
+		       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	async_data->feature = g_strdup (feature);
+
+	_push_async_command (device, async_data, _push_feature_command, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_execute_command_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the command is executed
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_execute_command(). Use arv_device_feature_finish() to get the result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_execute_command_async (ArvDevice *device, const char *feature, GCancellable *cancellable,
+				  GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_EXECUTE_COMMAND;
+
+	_push_feature_command (device, async_data, feature, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_set_boolean_feature_value_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_set_boolean_feature_value(). Use arv_device_feature_finish() to get the
+ * result.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_device_set_boolean_feature_value_async (ArvDevice *device, const char *feature, gboolean value,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_SET_BOOLEAN;
+	async_data->boolean_value = value;
+
+	_push_feature_command (device, async_data, feature, cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_set_string_feature_value_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_set_string_feature_value(). Use arv_device_feature_finish() to get the
+ * result.
  *
- * Since: 0.8.0
+ * Since: 0.8.24
  */
 
-const char **
-arv_device_dup_available_enumeration_feature_values_as_display_names (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+void
+arv_device_set_string_feature_value_async (ArvDevice *device, const char *feature, const char *value,
+					   GCancellable *cancellable, GAsyncReadyCallback callback,
+					   gpointer user_data)
 {
-	ArvGcNode *node;
+	ArvDeviceAsyncData *async_data;
 
-	if (n_values != NULL)
-		*n_values = 0;
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
 
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_display_names (ARV_GC_ENUMERATION (node), n_values, error);
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_SET_STRING;
+	async_data->string_value = g_strdup (value);
 
-	return NULL;
+	_push_feature_command (device, async_data, feature, cancellable, callback, user_data);
 }
 
 /**
- * arv_device_is_enumeration_entry_available:
- * @device: an #ArvDevice instance
- * @feature: enumeration feature name
- * @entry: entry name
- * @error: a #GError placeholder
+ * arv_device_set_integer_feature_value_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
  *
- * Returns: %TRUE if the feature and the feature entry are available
+ * Asynchronous version of arv_device_set_integer_feature_value(). Use arv_device_feature_finish() to get the
+ * result.
  *
- * Since: 0.8.17
+ * Since: 0.8.24
  */
 
-gboolean
-arv_device_is_enumeration_entry_available (ArvDevice *device, const char *feature, const char *entry, GError **error)
+void
+arv_device_set_integer_feature_value_async (ArvDevice *device, const char *feature, gint64 value,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
 {
-        GError *local_error = NULL;
-        const char **entries = NULL;
-        guint n_entries = 0;
-        gboolean is_available = FALSE;
-        unsigned int i;
+	ArvDeviceAsyncData *async_data;
 
-        if (!arv_device_is_feature_available (device, feature, &local_error)) {
-                if (local_error != NULL)
-                        g_propagate_error (error, local_error);
-                return FALSE;
-        }
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
 
-        entries = arv_device_dup_available_enumeration_feature_values_as_strings (device, feature, &n_entries,
-                                                                                  &local_error);
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_SET_INTEGER;
+	async_data->integer_value = value;
 
-        if (local_error != NULL) {
-                g_propagate_error (error, local_error);
-                return FALSE;
-        }
+	_push_feature_command (device, async_data, feature, cancellable, callback, user_data);
+}
 
-        for (i = 0; i < n_entries && !is_available; i++) {
-                if (g_strcmp0 (entry, entries[i]) == 0)
-                        is_available = TRUE;
-        }
-        g_free (entries);
+/**
+ * arv_device_set_float_feature_value_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (allow-none): a #GCancellable, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_set_float_feature_value(). Use arv_device_feature_finish() to get the
+ * result.
+ *
+ * Since: 0.8.24
+ */
 
-        return is_available;
+void
+arv_device_set_float_feature_value_async (ArvDevice *device, const char *feature, double value,
+					  GCancellable *cancellable, GAsyncReadyCallback callback,
+					  gpointer user_data)
+{
+	ArvDeviceAsyncData *async_data;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
+
+	async_data = g_new0 (ArvDeviceAsyncData, 1);
+	async_data->command = ARV_DEVICE_ASYNC_SET_FLOAT;
+	async_data->float_value = value;
+
+	_push_feature_command (device, async_data, feature, cancellable, callback, user_data);
 }
 
 /**
- * arv_device_set_features_from_string:
+ * arv_device_feature_finish:
  * @device: a #ArvDevice
- * @string: a space separated list of features assignments
- * @error: a #GError placeholder, %NULL to ignore
+ * @result: a #GAsyncResult
+ * @error: (out) (allow-none): a #GError placeholder
  *
- * Set features from a string containing a list of space separated feature assignments or command names. For example:
+ * Finishes an operation started with arv_device_execute_command_async() or one of the
+ * arv_device_set_*_feature_value_async() functions.
  *
- * |[<!-- language="C" -->
- * arv_device_set_features_from_string (device, "Width=256 Height=256 PixelFormat='Mono8' TriggerStart", &error);
- * ]|
+ * Returns: %TRUE on success.
  *
- * Since: 0.8.0
+ * Since: 0.8.24
  */
 
 gboolean
-arv_device_set_features_from_string (ArvDevice *device, const char *string, GError **error)
+arv_device_feature_finish (ArvDevice *device, GAsyncResult *result, GError **error)
 {
-	GMatchInfo *match_info = NULL;
-	GError *local_error = NULL;
-	GRegex *regex;
+	return _finish_async_command (device, result, _push_feature_command, error);
+}
 
-	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+static void
+arv_device_info_free (ArvDeviceInfo *info)
+{
+	if (info == NULL)
+		return;
 
-	if (string == NULL)
-		return TRUE;
+	g_free (info->name);
+	g_free (info);
+}
 
-	regex = g_regex_new ("((?<Key>[^\\s\"'\\=]+)|\"(?<Key>[^\"]*)\"|'(?<Key>[^']*)')"
-			     "(?:\\=((?<Value>[^\\s\"']+)|\"(?<Value>[^\"]*)\"|'(?<Value>[^']*)'))?",
-			     G_REGEX_DUPNAMES, 0, NULL);
+static void
+_declare_info (ArvDevice *device, const char *name, GType type, gpointer data, ArvDeviceInfoFunc func)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvDeviceInfo *info;
 
-	if (g_regex_match (regex, string, 0, &match_info)) {
-		while (g_match_info_matches (match_info) && local_error == NULL) {
-			ArvGcNode *feature;
-			char *key = g_match_info_fetch_named (match_info, "Key");
-			char *value = g_match_info_fetch_named (match_info, "Value");
-
-			feature = arv_device_get_feature (device, key);
-			if (ARV_IS_GC_FEATURE_NODE (feature)) {
-				if (ARV_IS_GC_COMMAND (feature)) {
-					arv_device_execute_command (device, key, &local_error);
-				} else if (value != NULL) {
-					arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (feature), value, &local_error);
-				} else {
-					g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
-						     "[%s] Require a parameter value to set", key);
-				}
-			} else
-				g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
-					     "[%s] Not found", key);
+	info = g_new0 (ArvDeviceInfo, 1);
+	info->name = g_strdup (name);
+	info->type = type;
+	info->data = data;
+	info->func = func;
+
+	g_ptr_array_add (priv->infos, info);
+}
 
-			g_free (key);
-			g_free (value);
+/*
+ * Device informations point to counters or gauges owned by the device implementation, which must stay valid for the
+ * device lifetime. They are read without any lock.
+ */
 
-			g_match_info_next (match_info, NULL);
-		}
-		g_match_info_unref (match_info);
-	}
+void
+arv_device_declare_info (ArvDevice *device, const char *name, GType type, gpointer data)
+{
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (type == G_TYPE_DOUBLE || type == G_TYPE_UINT64);
+	g_return_if_fail (data != NULL);
 
-	g_regex_unref (regex);
+	_declare_info (device, name, type, data, NULL);
+}
 
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
-		return FALSE;
+/* Declares a %G_TYPE_UINT64 information computed on read by @func */
+
+void
+arv_device_declare_info_func (ArvDevice *device, const char *name, ArvDeviceInfoFunc func)
+{
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (func != NULL);
+
+	_declare_info (device, name, G_TYPE_UINT64, NULL, func);
+}
+
+static const ArvDeviceInfo *
+_get_info (ArvDevice *device, guint id)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_return_val_if_fail (id < priv->infos->len, NULL);
+
+	return g_ptr_array_index (priv->infos, id);
+}
+
+static const ArvDeviceInfo *
+_find_info_by_name (ArvDevice *device, const char *name)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	guint i;
+
+	for (i = 0; i < priv->infos->len; i++) {
+		ArvDeviceInfo *info = g_ptr_array_index (priv->infos, i);
+
+		if (g_strcmp0 (name, info->name) == 0)
+			return info;
 	}
 
-	return TRUE;
+	return NULL;
+}
+
+static guint64
+_get_info_uint64 (ArvDevice *device, const ArvDeviceInfo *info)
+{
+	g_return_val_if_fail (info != NULL, 0);
+	g_return_val_if_fail (info->type == G_TYPE_UINT64, 0);
+
+	if (info->func != NULL)
+		return info->func (device);
+
+	return *((guint64 *) info->data);
+}
+
+static double
+_get_info_double (ArvDevice *device, const ArvDeviceInfo *info)
+{
+	g_return_val_if_fail (info != NULL, 0.0);
+	g_return_val_if_fail (info->type == G_TYPE_DOUBLE, 0.0);
+
+	return *((double *) info->data);
 }
 
 /**
- * arv_device_set_register_cache_policy:
+ * arv_device_get_n_infos:
  * @device: a #ArvDevice
- * @policy: cache policy
  *
- * Sets the register cache policy.
- *
- * <warning><para>Be aware that some camera may have wrong Cachable properties defined in their Genicam metadata, which
- * may lead to incorrect readouts. Using the debug cache policy, and activating genicam debug output (export
- * ARV_DEBUG=genicam), can help you to check the cache validity. In this mode, every time the cache content is not in
- * sync with the actual register value, a debug message is printed on the console.</para></warning>
+ * Returns: the number of device informations. Like the stream informations, these are counters and gauges about
+ * the device communication, e.g. the number of control command retries, or the register cache hits.
  *
- * Since: 0.8.0
+ * Since: 0.8.24
  */
 
-void
-arv_device_set_register_cache_policy (ArvDevice *device, ArvRegisterCachePolicy policy)
+guint
+arv_device_get_n_infos (ArvDevice *device)
 {
-	ArvGc *genicam;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
 
-	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0);
 
-	genicam = arv_device_get_genicam (device);
-	arv_gc_set_register_cache_policy (genicam, policy);
+	return priv->infos->len;
 }
 
 /**
- * arv_device_set_range_check_policy:
+ * arv_device_get_info_name:
  * @device: a #ArvDevice
- * @policy: range check policy
+ * @id: info id
  *
- * Sets the range check policy. When enabled, before being set, the value of all nodes with an #ArvGcFloat or
- * #ArvGcInteger interface will be checked against their Min and Max properties.
+ * Returns: the name of the corresponding device information.
  *
- * <warning><para>Be aware that some camera may have wrong definition of Min and Max, as this check is defined as not
- * mandatory in the Genicam specification. If this is the case, it will not possible to set the value of the features
- * with faulty Min or Max definition. Range check is disabled by default.</para></warning>
+ * Since: 0.8.24
+ */
+
+const char *
+arv_device_get_info_name (ArvDevice *device, guint id)
+{
+	const ArvDeviceInfo *info;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	info = _get_info (device, id);
+
+	return info != NULL ? info->name : NULL;
+}
+
+/**
+ * arv_device_get_info_type:
+ * @device: a #ArvDevice
+ * @id: info id
  *
- * Since: 0.8.6
+ * Returns: the #GType of the corresponding device information, %G_TYPE_UINT64 for counters, %G_TYPE_DOUBLE for
+ * gauges.
+ *
+ * Since: 0.8.24
  */
 
-void
-arv_device_set_range_check_policy (ArvDevice *device, ArvRangeCheckPolicy policy)
+GType
+arv_device_get_info_type (ArvDevice *device, guint id)
 {
-	ArvGc *genicam;
+	const ArvDeviceInfo *info;
 
-	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0);
 
-	genicam = arv_device_get_genicam (device);
-	arv_gc_set_range_check_policy (genicam, policy);
+	info = _get_info (device, id);
+
+	return info != NULL ? info->type : 0;
 }
 
 /**
- * arv_device_set_access_check_policy:
+ * arv_device_get_info_uint64:
  * @device: a #ArvDevice
- * @policy: access check policy
+ * @id: info id
  *
- * Sets the feature access check policy. When enabled, before being accessed, the actual read/write access of register
- * is checked using AccessMode properties. On some devices, it helps to avoid forbidden writes to registers that may put
- * the device in a bad state.
+ * Returns: the value of the corresponding device information, as a 64 bit unsigned integer.
  *
- * <warning><para>Access check is disabled by default.</para></warning>
+ * Since: 0.8.24
+ */
+
+guint64
+arv_device_get_info_uint64 (ArvDevice *device, guint id)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0);
+
+	return _get_info_uint64 (device, _get_info (device, id));
+}
+
+/**
+ * arv_device_get_info_double:
+ * @device: a #ArvDevice
+ * @id: info id
  *
- * Since: 0.8.22
+ * Returns: the value of the corresponding device information, as a double.
+ *
+ * Since: 0.8.24
  */
 
-void
-arv_device_set_access_check_policy (ArvDevice *device, ArvAccessCheckPolicy policy)
+double
+arv_device_get_info_double (ArvDevice *device, guint id)
 {
-	ArvGc *genicam;
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0.0);
 
-	g_return_if_fail (ARV_IS_DEVICE (device));
+	return _get_info_double (device, _get_info (device, id));
+}
 
-	genicam = arv_device_get_genicam (device);
-	arv_gc_set_access_check_policy (genicam, policy);
+/**
+ * arv_device_get_info_uint64_by_name:
+ * @device: a #ArvDevice
+ * @name: info name
+ *
+ * Returns: the value of the corresponding device information, as a 64 bit unsigned integer.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_device_get_info_uint64_by_name (ArvDevice *device, const char *name)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0);
+	g_return_val_if_fail (name != NULL, 0);
+
+	return _get_info_uint64 (device, _find_info_by_name (device, name));
 }
 
-void
-arv_device_emit_control_lost_signal (ArvDevice *device)
+/**
+ * arv_device_get_info_double_by_name:
+ * @device: a #ArvDevice
+ * @name: info name
+ *
+ * Returns: the value of the corresponding device information, as a double.
+ *
+ * Since: 0.8.24
+ */
+
+double
+arv_device_get_info_double_by_name (ArvDevice *device, const char *name)
 {
-	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_val_if_fail (ARV_IS_DEVICE (device), 0.0);
+	g_return_val_if_fail (name != NULL, 0.0);
 
-	g_signal_emit (device, arv_device_signals[ARV_DEVICE_SIGNAL_CONTROL_LOST], 0);
+	return _get_info_double (device, _find_info_by_name (device, name));
 }
 
+static guint64
+_get_n_register_cache_hits (ArvDevice *device)
+{
+	ArvGc *genicam = arv_device_get_genicam (device);
+	guint64 n_hits = 0;
+
+	if (ARV_IS_GC (genicam))
+		arv_gc_get_register_cache_statistics (genicam, &n_hits, NULL, NULL);
 
-void arv_device_take_init_error (ArvDevice *device, GError *error)
+	return n_hits;
+}
+
+static guint64
+_get_n_register_cache_misses (ArvDevice *device)
 {
-	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvGc *genicam = arv_device_get_genicam (device);
+	guint64 n_misses = 0;
 
-	g_return_if_fail (ARV_IS_DEVICE (device));
+	if (ARV_IS_GC (genicam))
+		arv_gc_get_register_cache_statistics (genicam, NULL, &n_misses, NULL);
 
-	g_clear_error (&priv->init_error);
-	priv->init_error = error;
+	return n_misses;
+}
+
+static guint64
+_get_n_register_cache_errors (ArvDevice *device)
+{
+	ArvGc *genicam = arv_device_get_genicam (device);
+	guint64 n_errors = 0;
+
+	if (ARV_IS_GC (genicam))
+		arv_gc_get_register_cache_statistics (genicam, NULL, NULL, &n_errors);
+
+	return n_errors;
 }
 
 static void
 arv_device_init (ArvDevice *device)
 {
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_mutex_init (&priv->dispatcher_mutex);
+	g_mutex_init (&priv->event_mutex);
+	g_mutex_init (&priv->streams_mutex);
+
+	priv->streams = g_ptr_array_new_with_free_func ((GDestroyNotify) _weak_ref_free);
+	priv->infos = g_ptr_array_new_with_free_func ((GDestroyNotify) arv_device_info_free);
+
+	arv_device_declare_info_func (device, "n_register_cache_hits", _get_n_register_cache_hits);
+	arv_device_declare_info_func (device, "n_register_cache_misses", _get_n_register_cache_misses);
+	arv_device_declare_info_func (device, "n_register_cache_errors", _get_n_register_cache_errors);
 }
 
 static void
@@ -1086,6 +2825,20 @@ arv_device_finalize (GObject *object)
 
 	g_clear_error (&priv->init_error);
 
+	/* The pending tasks hold a reference on the device, the dispatcher is idle at this point. Don't wait for it, as
+	 * the last reference may be released by a task finalization in the dispatcher thread itself. */
+	if (priv->dispatcher != NULL)
+		g_thread_pool_free (priv->dispatcher, FALSE, FALSE);
+	g_mutex_clear (&priv->dispatcher_mutex);
+
+	g_clear_pointer (&priv->event_data, g_hash_table_unref);
+	g_mutex_clear (&priv->event_mutex);
+
+	g_clear_pointer (&priv->streams, g_ptr_array_unref);
+	g_mutex_clear (&priv->streams_mutex);
+
+	g_clear_pointer (&priv->infos, g_ptr_array_unref);
+
 	G_OBJECT_CLASS (arv_device_parent_class)->finalize (object);
 }
 
@@ -1115,6 +2868,29 @@ arv_device_class_init (ArvDeviceClass *device_class)
 			      G_STRUCT_OFFSET (ArvDeviceClass, control_lost),
 			      NULL, NULL,
 			      g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0, G_TYPE_NONE);
+
+	/**
+	 * ArvDevice::event:
+	 * @device: a #ArvDevice
+	 * @event_id: the event identifier
+	 * @timestamp: the device timestamp of the event
+	 * @data: the data attached to the event, may be empty
+	 *
+	 * Signal the reception of a device event, once arv_device_start_event_channel() was called.
+	 *
+	 * This signal is emitted directly from the event reception thread, as soon as the event is decoded, so
+	 * please take care to shared data access from the callback, and keep it short, as the next events are not
+	 * received during its execution. The event features can be read from the callback.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	arv_device_signals[ARV_DEVICE_SIGNAL_EVENT] =
+		g_signal_new ("event",
+			      G_TYPE_FROM_CLASS (device_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 3, G_TYPE_UINT, G_TYPE_UINT64, G_TYPE_BYTES);
 }
 
 static gboolean
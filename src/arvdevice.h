@@ -32,6 +32,7 @@
 #include <arvtypes.h>
 #include <arvstream.h>
 #include <arvchunkparser.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
@@ -70,6 +71,21 @@ typedef enum {
 	ARV_DEVICE_ERROR_UNKNOWN
 } ArvDeviceError;
 
+/**
+ * ArvDeviceSetFeaturesFlags:
+ * @ARV_DEVICE_SET_FEATURES_FLAGS_NONE: write every listed feature
+ * @ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY: only write the features whose current value differs
+ * @ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION: queue the writes in a feature transaction, see arv_device_begin_transaction()
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_DEVICE_SET_FEATURES_FLAGS_NONE =		0,
+	ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY =	1 << 0,
+	ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION =	1 << 1
+} ArvDeviceSetFeaturesFlags;
+
 #define ARV_TYPE_DEVICE             (arv_device_get_type ())
 ARV_API G_DECLARE_DERIVABLE_TYPE (ArvDevice, arv_device, ARV, DEVICE, GObject)
 
@@ -88,6 +104,18 @@ struct _ArvDeviceClass {
 
 	/* signals */
 	void		(*control_lost)		(ArvDevice *device);
+
+	/* Appended after the existing members, for the ABI compatibility of the subclasses */
+
+	gboolean	(*read_registers)	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 guint32 *values, GError **error);
+	gboolean	(*write_registers)	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 const guint32 *values, GError **error);
+
+	gboolean	(*start_event_channel)	(ArvDevice *device, GError **error);
+	void		(*stop_event_channel)	(ArvDevice *device);
+
+	gboolean	(*reconnect)		(ArvDevice *device, GError **error);
 };
 
 ARV_API ArvStream *	arv_device_create_stream		(ArvDevice *device, ArvStreamCallback callback, void *user_data, GError **error);
@@ -97,24 +125,72 @@ ARV_API gboolean	arv_device_read_memory			(ArvDevice *device, guint64 address, g
 ARV_API gboolean	arv_device_write_memory			(ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error);
 ARV_API gboolean	arv_device_read_register		(ArvDevice *device, guint64 address, guint32 *value, GError **error);
 ARV_API gboolean	arv_device_write_register		(ArvDevice *device, guint64 address, guint32 value, GError **error);
+ARV_API gboolean	arv_device_read_registers		(ArvDevice *device, guint n_registers, const guint64 *addresses,
+								 guint32 *values, GError **error);
+ARV_API gboolean	arv_device_write_registers		(ArvDevice *device, guint n_registers, const guint64 *addresses,
+								 const guint32 *values, GError **error);
+
+ARV_API void		arv_device_read_memory_async		(ArvDevice *device, guint64 address, guint32 size,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+ARV_API GBytes *	arv_device_read_memory_finish		(ArvDevice *device, GAsyncResult *result, GError **error);
+ARV_API void		arv_device_write_memory_async		(ArvDevice *device, guint64 address, guint32 size,
+								 const void *buffer, GCancellable *cancellable,
+								 GAsyncReadyCallback callback, gpointer user_data);
+ARV_API gboolean	arv_device_write_memory_finish		(ArvDevice *device, GAsyncResult *result, GError **error);
+ARV_API void		arv_device_read_register_async		(ArvDevice *device, guint64 address, GCancellable *cancellable,
+								 GAsyncReadyCallback callback, gpointer user_data);
+ARV_API gboolean	arv_device_read_register_finish		(ArvDevice *device, GAsyncResult *result, guint32 *value,
+								 GError **error);
+ARV_API void		arv_device_write_register_async		(ArvDevice *device, guint64 address, guint32 value,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+ARV_API gboolean	arv_device_write_register_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
 
 ARV_API const char *	arv_device_get_genicam_xml		(ArvDevice *device, size_t *size);
 ARV_API ArvGc *		arv_device_get_genicam			(ArvDevice *device);
 
+ARV_API void		arv_device_begin_transaction		(ArvDevice *device);
+ARV_API gboolean	arv_device_commit			(ArvDevice *device, GError **error);
+
 ARV_API gboolean 	arv_device_is_feature_available		(ArvDevice *device, const char *feature, GError **error);
 ARV_API ArvGcNode *	arv_device_get_feature			(ArvDevice *device, const char *feature);
 ARV_API ArvGcAccessMode	arv_device_get_feature_access_mode	(ArvDevice *device, const char *feature);
 
 ARV_API ArvChunkParser *arv_device_create_chunk_parser		(ArvDevice *device);
 
+ARV_API gboolean	arv_device_start_event_channel		(ArvDevice *device, GError **error);
+ARV_API void		arv_device_stop_event_channel		(ArvDevice *device);
+
+ARV_API gboolean	arv_device_reconnect			(ArvDevice *device, GError **error);
+ARV_API GBytes *	arv_device_dup_event_data		(ArvDevice *device, guint event_id);
+
 ARV_API void		arv_device_execute_command		(ArvDevice *device, const char *feature, GError **error);
 
+ARV_API void		arv_device_execute_command_async	(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+ARV_API void		arv_device_set_boolean_feature_value_async	(ArvDevice *device, const char *feature, gboolean value,
+									 GCancellable *cancellable, GAsyncReadyCallback callback,
+									 gpointer user_data);
+ARV_API void		arv_device_set_string_feature_value_async	(ArvDevice *device, const char *feature, const char *value,
+									 GCancellable *cancellable, GAsyncReadyCallback callback,
+									 gpointer user_data);
+ARV_API void		arv_device_set_integer_feature_value_async	(ArvDevice *device, const char *feature, gint64 value,
+									 GCancellable *cancellable, GAsyncReadyCallback callback,
+									 gpointer user_data);
+ARV_API void		arv_device_set_float_feature_value_async	(ArvDevice *device, const char *feature, double value,
+									 GCancellable *cancellable, GAsyncReadyCallback callback,
+									 gpointer user_data);
+ARV_API gboolean	arv_device_feature_finish		(ArvDevice *device, GAsyncResult *result, GError **error);
+
 ARV_API void		arv_device_set_boolean_feature_value	(ArvDevice *device, const char *feature, gboolean value, GError **error);
 ARV_API gboolean	arv_device_get_boolean_feature_value	(ArvDevice *device, const char *feature, GError **error);
 ARV_API void		arv_device_get_boolean_feature_value_gi	(ArvDevice *device, const char *feature, gboolean *value, GError **error);
 
 ARV_API void		arv_device_set_string_feature_value	(ArvDevice *device, const char *feature, const char *value, GError **error);
 ARV_API const char *	arv_device_get_string_feature_value	(ArvDevice *device, const char *feature, GError **error);
+ARV_API char *		arv_device_dup_string_feature_value	(ArvDevice *device, const char *feature, GError **error);
 
 ARV_API void		arv_device_set_integer_feature_value	(ArvDevice *device, const char *feature, gint64 value, GError **error);
 ARV_API gint64		arv_device_get_integer_feature_value	(ArvDevice *device, const char *feature, GError **error);
@@ -126,6 +202,20 @@ ARV_API double		arv_device_get_float_feature_value	(ArvDevice *device, const cha
 ARV_API void		arv_device_get_float_feature_bounds	(ArvDevice *device, const char *feature, double *min, double *max, GError **error);
 ARV_API double		arv_device_get_float_feature_increment	(ArvDevice *device, const char *feature, GError **error);
 
+ARV_API ArvFeatureHandle *	arv_device_get_feature_handle		(ArvDevice *device, const char *feature, GError **error);
+
+ARV_API const char *	arv_feature_handle_get_name		(ArvFeatureHandle *handle);
+ARV_API gboolean	arv_feature_handle_is_available		(ArvFeatureHandle *handle, GError **error);
+ARV_API void		arv_feature_handle_execute_command	(ArvFeatureHandle *handle, GError **error);
+ARV_API void		arv_feature_handle_set_boolean		(ArvFeatureHandle *handle, gboolean value, GError **error);
+ARV_API gboolean	arv_feature_handle_get_boolean		(ArvFeatureHandle *handle, GError **error);
+ARV_API void		arv_feature_handle_set_string		(ArvFeatureHandle *handle, const char *value, GError **error);
+ARV_API const char *	arv_feature_handle_get_string		(ArvFeatureHandle *handle, GError **error);
+ARV_API void		arv_feature_handle_set_integer		(ArvFeatureHandle *handle, gint64 value, GError **error);
+ARV_API gint64		arv_feature_handle_get_integer		(ArvFeatureHandle *handle, GError **error);
+ARV_API void		arv_feature_handle_set_float		(ArvFeatureHandle *handle, double value, GError **error);
+ARV_API double		arv_feature_handle_get_float		(ArvFeatureHandle *handle, GError **error);
+
 ARV_API gint64 *	arv_device_dup_available_enumeration_feature_values			(ArvDevice *device, const char *feature,
 												 guint *n_values, GError **error);
 ARV_API const char **	arv_device_dup_available_enumeration_feature_values_as_strings		(ArvDevice *device, const char *feature,
@@ -136,11 +226,26 @@ ARV_API gboolean	arv_device_is_enumeration_entry_available				(ArvDevice *device
 												 const char *entry, GError **error);
 
 ARV_API gboolean	arv_device_set_features_from_string	(ArvDevice *device, const char *string, GError **error);
+ARV_API gboolean	arv_device_set_features_from_string_full	(ArvDevice *device, const char *string,
+									 ArvDeviceSetFeaturesFlags flags, GError **error);
+
+ARV_API char *		arv_device_dup_feature_snapshot		(ArvDevice *device);
+ARV_API gboolean	arv_device_save_feature_snapshot	(ArvDevice *device, const char *filename, GError **error);
+ARV_API gboolean	arv_device_load_feature_snapshot	(ArvDevice *device, const char *filename,
+								 ArvDeviceSetFeaturesFlags flags, GError **error);
 
 ARV_API void		arv_device_set_register_cache_policy	(ArvDevice *device, ArvRegisterCachePolicy policy);
 ARV_API void		arv_device_set_range_check_policy	(ArvDevice *device, ArvRangeCheckPolicy policy);
 ARV_API void            arv_device_set_access_check_policy      (ArvDevice *device, ArvAccessCheckPolicy policy);
 
+ARV_API guint		arv_device_get_n_infos			(ArvDevice *device);
+ARV_API const char *	arv_device_get_info_name		(ArvDevice *device, guint id);
+ARV_API GType		arv_device_get_info_type		(ArvDevice *device, guint id);
+ARV_API guint64		arv_device_get_info_uint64		(ArvDevice *device, guint id);
+ARV_API double		arv_device_get_info_double		(ArvDevice *device, guint id);
+ARV_API guint64		arv_device_get_info_uint64_by_name	(ArvDevice *device, const char *name);
+ARV_API double		arv_device_get_info_double_by_name	(ArvDevice *device, const char *name);
+
 G_END_DECLS
 
 #endif
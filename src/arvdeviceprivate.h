@@ -32,8 +32,21 @@
 G_BEGIN_DECLS
 
 void 		arv_device_emit_control_lost_signal 	(ArvDevice *device);
+void		arv_device_emit_event_signal		(ArvDevice *device, guint event_id, guint64 timestamp,
+							 const void *item, size_t item_size,
+							 const void *data, size_t data_size);
 void		arv_device_take_init_error		(ArvDevice *device, GError *error);
 
+void		arv_device_add_stream			(ArvDevice *device, ArvStream *stream);
+GPtrArray *	arv_device_dup_streams			(ArvDevice *device);
+
+char *		arv_device_dup_feature_values		(ArvDevice *device, gboolean writable_only);
+
+typedef guint64	(*ArvDeviceInfoFunc)			(ArvDevice *device);
+
+void		arv_device_declare_info			(ArvDevice *device, const char *name, GType type, gpointer data);
+void		arv_device_declare_info_func		(ArvDevice *device, const char *name, ArvDeviceInfoFunc func);
+
 G_END_DECLS
 
 #endif
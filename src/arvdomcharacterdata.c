@@ -26,12 +26,13 @@
  * @short_description: Base class for DOM character data nodes
  */
 
-#include <arvdomcharacterdata.h>
+#include <arvdomcharacterdataprivate.h>
 #include <arvdebugprivate.h>
 #include <string.h>
 
 typedef struct {
 	char *data;
+	gboolean is_static;
 } ArvDomCharacterDataPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvDomCharacterData, arv_dom_character_data, ARV_TYPE_DOM_NODE, G_ADD_PRIVATE (ArvDomCharacterData))
@@ -70,14 +71,35 @@ arv_dom_character_data_set_data (ArvDomCharacterData* self, const char * value)
 	g_return_if_fail (ARV_IS_DOM_CHARACTER_DATA (self));
 	g_return_if_fail (value != NULL);
 
-	g_free (priv->data);
+	if (!priv->is_static)
+		g_free (priv->data);
 	priv->data = g_strdup (value);
+	priv->is_static = FALSE;
 
 	arv_debug_dom ("[ArvDomCharacterData::set_data] Value = '%s'", value);
 
 	arv_dom_node_changed (ARV_DOM_NODE (self));
 }
 
+/* Same as arv_dom_character_data_set_data(), but @value is not copied, and must stay valid during the node
+ * lifetime, or until the next data change. Used for the strings interned by the owner document. */
+
+void
+arv_dom_character_data_set_static_data (ArvDomCharacterData *self, const char *value)
+{
+	ArvDomCharacterDataPrivate *priv = arv_dom_character_data_get_instance_private (ARV_DOM_CHARACTER_DATA (self));
+
+	g_return_if_fail (ARV_IS_DOM_CHARACTER_DATA (self));
+	g_return_if_fail (value != NULL);
+
+	if (!priv->is_static)
+		g_free (priv->data);
+	priv->data = (char *) value;
+	priv->is_static = TRUE;
+
+	arv_dom_node_changed (ARV_DOM_NODE (self));
+}
+
 static void
 arv_dom_character_data_init (ArvDomCharacterData *character_data)
 {
@@ -88,7 +110,8 @@ arv_dom_character_data_finalize (GObject *self)
 {
 	ArvDomCharacterDataPrivate *priv = arv_dom_character_data_get_instance_private (ARV_DOM_CHARACTER_DATA (self));
 
-	g_free (priv->data);
+	if (!priv->is_static)
+		g_free (priv->data);
 
 	G_OBJECT_CLASS (arv_dom_character_data_parent_class)->finalize (self);
 }
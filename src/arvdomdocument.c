@@ -26,7 +26,8 @@
  * @short_description: Base class for DOM document nodes
  */
 
-#include <arvdomdocument.h>
+#include <arvdomdocumentprivate.h>
+#include <arvdomcharacterdataprivate.h>
 #include <arvdomelement.h>
 #include <arvstr.h>
 #include <arvdebug.h>
@@ -37,6 +38,14 @@
 typedef struct {
 	char *		url;
 
+	/* Interned strings, shared by the document nodes */
+	GMutex		strings_mutex;
+	GStringChunk *	strings;
+
+	/* String table of the compiled data the document was instantiated from, used in place */
+	GBytes *	static_bytes;
+	const char *	static_strings;
+	gsize		static_strings_size;
 } ArvDomDocumentPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvDomDocument, arv_dom_document, ARV_TYPE_DOM_NODE, G_ADD_PRIVATE (ArvDomDocument))
@@ -99,7 +108,14 @@ arv_dom_document_create_element (ArvDomDocument *self, const char *tag_name)
 static ArvDomText *
 arv_dom_document_create_text_node_base (ArvDomDocument *document, const char *data)
 {
-	return ARV_DOM_TEXT (arv_dom_text_new (data));
+	ArvDomNode *node;
+
+	/* Text nodes are only created by the parser, their initial content is mostly made of repeated node names */
+	node = g_object_new (ARV_TYPE_DOM_TEXT, NULL);
+	arv_dom_character_data_set_static_data (ARV_DOM_CHARACTER_DATA (node),
+						arv_dom_document_intern_string (document, data));
+
+	return ARV_DOM_TEXT (node);
 }
 
 /**
@@ -159,6 +175,59 @@ arv_dom_document_set_url (ArvDomDocument *self, const char *url)
 	priv->url = g_strdup (url);
 }
 
+/* Returns a copy of @string, shared with the other identical strings of @document, and valid until the document
+ * destruction. Strings of orphan nodes, without @document, are interned globally. */
+
+const char *
+arv_dom_document_intern_string (ArvDomDocument *document, const char *string)
+{
+	ArvDomDocumentPrivate *priv;
+	const char *interned;
+
+	if (string == NULL)
+		return NULL;
+
+	if (!ARV_IS_DOM_DOCUMENT (document))
+		return g_intern_string (string);
+
+	priv = arv_dom_document_get_instance_private (document);
+
+	g_mutex_lock (&priv->strings_mutex);
+	if (string >= priv->static_strings && string < priv->static_strings + priv->static_strings_size) {
+		interned = string;
+	} else {
+		if (priv->strings == NULL)
+			priv->strings = g_string_chunk_new (4096);
+		interned = g_string_chunk_insert_const (priv->strings, string);
+	}
+	g_mutex_unlock (&priv->strings_mutex);
+
+	return interned;
+}
+
+/* Declares @strings, a table of @size bytes of null terminated strings inside @bytes, as valid until the document
+ * destruction. The strings of this table are then used as is by arv_dom_document_intern_string(), without any copy.
+ * Only one table is supported, the strings of any other table being copied as usual. */
+
+void
+arv_dom_document_set_static_strings (ArvDomDocument *document, GBytes *bytes, const char *strings, gsize size)
+{
+	ArvDomDocumentPrivate *priv;
+
+	g_return_if_fail (ARV_IS_DOM_DOCUMENT (document));
+	g_return_if_fail (bytes != NULL);
+
+	priv = arv_dom_document_get_instance_private (document);
+
+	g_mutex_lock (&priv->strings_mutex);
+	if (priv->static_bytes == NULL) {
+		priv->static_bytes = g_bytes_ref (bytes);
+		priv->static_strings = strings;
+		priv->static_strings_size = size;
+	}
+	g_mutex_unlock (&priv->strings_mutex);
+}
+
 /**
  * arv_dom_document_get_href_data:
  * @self: a #ArvDomDocument
@@ -211,16 +280,28 @@ arv_dom_document_get_href_data (ArvDomDocument *self, const char *href, gsize *s
 static void
 arv_dom_document_init (ArvDomDocument *document)
 {
+	ArvDomDocumentPrivate *priv = arv_dom_document_get_instance_private (document);
+
+	g_mutex_init (&priv->strings_mutex);
 }
 
 static void
 arv_dom_document_finalize (GObject *self)
 {
 	ArvDomDocumentPrivate *priv = arv_dom_document_get_instance_private (ARV_DOM_DOCUMENT (self));
+	GStringChunk *strings = priv->strings;
+	GBytes *static_bytes = priv->static_bytes;
 
 	g_free (priv->url);
 
+	/* The child nodes are destroyed by the parent class, and may still use the interned strings */
 	G_OBJECT_CLASS (arv_dom_document_parent_class)->finalize (self);
+
+	if (strings != NULL)
+		g_string_chunk_free (strings);
+	if (static_bytes != NULL)
+		g_bytes_unref (static_bytes);
+	g_mutex_clear (&priv->strings_mutex);
 }
 
 /* ArvDomDocument class */
@@ -25,7 +25,8 @@
 #include <arvdomimplementation.h>
 #include <arvdomnode.h>
 #include <arvdomelement.h>
-#include <arvdomparser.h>
+#include <arvdomparserprivate.h>
+#include <arvdomdocumentprivate.h>
 #include <arvstr.h>
 #include <libxml/parser.h>
 #include <gio/gio.h>
@@ -35,6 +36,37 @@ typedef enum {
 	STATE
 } ArvDomSaxParserStateEnum;
 
+/* The compiled form of a document is the sequence of the parser events, with interned strings. It is made of a
+ * header, followed by the event words and by the string table. The event words are:
+ *
+ * ARV_DOM_COMPILED_START_ELEMENT, name index, number of attributes, and the attribute name and value index pairs
+ * ARV_DOM_COMPILED_END_ELEMENT
+ * ARV_DOM_COMPILED_CHARACTERS, text index
+ *
+ * All words are stored in little endian order. The string table is a list of null terminated strings. */
+
+#define ARV_DOM_COMPILED_MAGIC "ARVDOM01"
+
+typedef struct {
+	char magic[8];
+	guint32 n_words;
+	guint32 n_strings;
+	guint32 strings_size;
+} ArvDomCompiledHeader;
+
+typedef enum {
+	ARV_DOM_COMPILED_START_ELEMENT,
+	ARV_DOM_COMPILED_END_ELEMENT,
+	ARV_DOM_COMPILED_CHARACTERS
+} ArvDomCompiledOpcode;
+
+typedef struct {
+	GHashTable *string_indexes;
+	GString *strings;
+	GArray *words;
+	GString *scratch;	/* Null terminated copy of the strings given with a length, for the lookups */
+} ArvDomCompiler;
+
 typedef struct {
 	ArvDomSaxParserStateEnum state;
 
@@ -46,8 +78,102 @@ typedef struct {
 	int error_depth;
 
 	GHashTable *entities;
+
+	ArvDomCompiler *compiler;
+	gboolean is_compile_only;
+
+	/* Source of a replay, whose null terminated strings are used in place by the document */
+	ArvDomCompiled *compiled;
+	/* Null terminated copy of the text chunks of the xml parser */
+	GString *text;
 } ArvDomSaxParserState;
 
+struct _ArvDomCompiled {
+	GBytes *bytes;
+	const guint32 *words;
+	guint32 n_words;
+	const char **strings;
+	guint32 n_strings;
+	const char *strings_data;
+	guint32 strings_size;
+};
+
+static ArvDomCompiler *
+arv_dom_compiler_new (void)
+{
+	ArvDomCompiler *compiler;
+
+	compiler = g_new0 (ArvDomCompiler, 1);
+	compiler->string_indexes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	compiler->strings = g_string_new (NULL);
+	compiler->words = g_array_new (FALSE, FALSE, sizeof (guint32));
+	compiler->scratch = g_string_new (NULL);
+
+	return compiler;
+}
+
+static void
+arv_dom_compiler_free (ArvDomCompiler *compiler)
+{
+	if (compiler == NULL)
+		return;
+
+	g_hash_table_unref (compiler->string_indexes);
+	g_string_free (compiler->strings, TRUE);
+	g_array_unref (compiler->words);
+	g_string_free (compiler->scratch, TRUE);
+	g_free (compiler);
+}
+
+static void
+arv_dom_compiler_add_word (ArvDomCompiler *compiler, guint32 word)
+{
+	word = GUINT32_TO_LE (word);
+	g_array_append_val (compiler->words, word);
+}
+
+static void
+arv_dom_compiler_add_string (ArvDomCompiler *compiler, const char *string, int len)
+{
+	gpointer index;
+
+	/* Most strings are already known, they are only copied on their first occurence */
+	if (len >= 0) {
+		g_string_truncate (compiler->scratch, 0);
+		g_string_append_len (compiler->scratch, string, len);
+		string = compiler->scratch->str;
+	}
+
+	if (!g_hash_table_lookup_extended (compiler->string_indexes, string, NULL, &index)) {
+		index = GUINT_TO_POINTER (g_hash_table_size (compiler->string_indexes));
+		g_string_append_len (compiler->strings, string, strlen (string) + 1);
+		g_hash_table_insert (compiler->string_indexes, g_strdup (string), index);
+	}
+
+	arv_dom_compiler_add_word (compiler, GPOINTER_TO_UINT (index));
+}
+
+static GBytes *
+arv_dom_compiler_get_bytes (ArvDomCompiler *compiler)
+{
+	ArvDomCompiledHeader header;
+	GByteArray *array;
+
+	memcpy (header.magic, ARV_DOM_COMPILED_MAGIC, sizeof (header.magic));
+	header.n_words = GUINT32_TO_LE (compiler->words->len);
+	header.n_strings = GUINT32_TO_LE (g_hash_table_size (compiler->string_indexes));
+	header.strings_size = GUINT32_TO_LE (compiler->strings->len);
+
+	array = g_byte_array_sized_new (sizeof (header) +
+					compiler->words->len * sizeof (guint32) +
+					compiler->strings->len);
+	g_byte_array_append (array, (guint8 *) &header, sizeof (header));
+	g_byte_array_append (array, (guint8 *) compiler->words->data, compiler->words->len * sizeof (guint32));
+	g_byte_array_append (array, (guint8 *) compiler->strings->str, compiler->strings->len);
+
+	return g_byte_array_free_to_bytes (array);
+}
+
 static void
 _free_entity (void *data)
 {
@@ -70,6 +196,7 @@ arv_dom_parser_start_document (void *user_data)
 	state->is_error = FALSE;
 	state->error_depth = 0;
 	state->entities = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, _free_entity);
+	state->text = g_string_new (NULL);
 }
 
 static void
@@ -78,6 +205,8 @@ arv_dom_parser_end_document (void *user_data)
 	ArvDomSaxParserState *state = user_data;
 
 	g_hash_table_unref (state->entities);
+	g_string_free (state->text, TRUE);
+	state->text = NULL;
 }
 
 static void
@@ -89,6 +218,22 @@ arv_dom_parser_start_element(void *user_data,
 	ArvDomNode *node;
 	int i;
 
+	if (state->compiler != NULL) {
+		int n_attrs = 0;
+
+		if (attrs != NULL)
+			for (n_attrs = 0; attrs[2 * n_attrs] != NULL && attrs[2 * n_attrs + 1] != NULL; n_attrs++);
+
+		arv_dom_compiler_add_word (state->compiler, ARV_DOM_COMPILED_START_ELEMENT);
+		arv_dom_compiler_add_string (state->compiler, (char *) name, -1);
+		arv_dom_compiler_add_word (state->compiler, n_attrs);
+		for (i = 0; i < 2 * n_attrs; i++)
+			arv_dom_compiler_add_string (state->compiler, (char *) attrs[i], -1);
+	}
+
+	if (state->is_compile_only)
+		return;
+
 	if (state->is_error) {
 		state->error_depth++;
 		return;
@@ -99,6 +244,11 @@ arv_dom_parser_start_element(void *user_data,
 		state->current_node = ARV_DOM_NODE (state->document);
 
 		g_return_if_fail (ARV_IS_DOM_DOCUMENT (state->document));
+
+		if (state->compiled != NULL)
+			arv_dom_document_set_static_strings (state->document, state->compiled->bytes,
+							     state->compiled->strings_data,
+							     state->compiled->strings_size);
 	}
 
 	node = ARV_DOM_NODE (arv_dom_document_create_element (ARV_DOM_DOCUMENT (state->document), (char *) name));
@@ -125,6 +275,12 @@ arv_dom_parser_end_element (void *user_data,
 {
 	ArvDomSaxParserState *state = user_data;
 
+	if (state->compiler != NULL)
+		arv_dom_compiler_add_word (state->compiler, ARV_DOM_COMPILED_END_ELEMENT);
+
+	if (state->is_compile_only)
+		return;
+
 	if (state->is_error) {
 		state->error_depth--;
 		if (state->error_depth > 0) {
@@ -143,16 +299,27 @@ arv_dom_parser_characters (void *user_data, const xmlChar *ch, int len)
 {
 	ArvDomSaxParserState *state = user_data;
 
-	if (!state->is_error) {
+	if (state->compiler != NULL) {
+		arv_dom_compiler_add_word (state->compiler, ARV_DOM_COMPILED_CHARACTERS);
+		arv_dom_compiler_add_string (state->compiler, (char *) ch, len);
+	}
+
+	if (!state->is_error && !state->is_compile_only) {
 		ArvDomNode *node;
-		char *text;
+		const char *text;
+
+		/* The replayed strings are null terminated, and used in place by the document */
+		if (state->compiled != NULL) {
+			text = (const char *) ch;
+		} else {
+			g_string_truncate (state->text, 0);
+			g_string_append_len (state->text, (const char *) ch, len);
+			text = state->text->str;
+		}
 
-		text = g_strndup ((char *) ch, len);
 		node = ARV_DOM_NODE (arv_dom_document_create_text_node (ARV_DOM_DOCUMENT (state->document), text));
 
 		arv_dom_node_append_child (state->current_node, node);
-
-		g_free (text);
 	}
 }
 
@@ -214,16 +381,18 @@ arv_dom_document_error_quark (void)
 #define ARV_DOM_DOCUMENT_ERROR arv_dom_document_error_quark ()
 
 typedef enum {
-	ARV_DOM_DOCUMENT_ERROR_INVALID_XML
+	ARV_DOM_DOCUMENT_ERROR_INVALID_XML,
+	ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA
 } ArvDomDocumentError;
 
 static ArvDomDocument *
 _parse_memory (ArvDomDocument *document, ArvDomNode *node,
-	       const void *buffer, int size, GError **error)
+	       const void *buffer, int size, ArvDomCompiler *compiler, GError **error)
 {
-	static ArvDomSaxParserState state;
+	ArvDomSaxParserState state = {0};
 
 	state.document = document;
+	state.compiler = compiler;
 	if (node != NULL)
 		state.current_node = node;
 	else
@@ -270,7 +439,7 @@ arv_dom_document_append_from_memory (ArvDomDocument *document, ArvDomNode *node,
 	g_return_if_fail (ARV_IS_DOM_NODE (node) || node == NULL);
 	g_return_if_fail (buffer != NULL);
 
-	_parse_memory (document, node, buffer, size, error);
+	_parse_memory (document, node, buffer, size, NULL, error);
 }
 
 ArvDomDocument *
@@ -278,7 +447,545 @@ arv_dom_document_new_from_memory (const void *buffer, int size, GError **error)
 {
 	g_return_val_if_fail (buffer != NULL, NULL);
 
-	return _parse_memory (NULL, NULL, buffer, size, error);
+	return _parse_memory (NULL, NULL, buffer, size, NULL, error);
+}
+
+/**
+ * arv_dom_document_new_from_memory_full:
+ * @buffer: a memory buffer holding xml data
+ * @size: size of the xml data, in bytes
+ * @compiled: (out) (optional): placeholder for the compiled form of the document
+ * @error: an error placeholder
+ *
+ * Same as arv_dom_document_new_from_memory(), but also returns a compiled form of the document, which can be
+ * instantiated by arv_dom_document_new_from_compiled() without the xml parsing overhead.
+ */
+
+ArvDomDocument *
+arv_dom_document_new_from_memory_full (const void *buffer, int size, GBytes **compiled, GError **error)
+{
+	ArvDomDocument *document;
+	ArvDomCompiler *compiler = NULL;
+
+	g_return_val_if_fail (buffer != NULL, NULL);
+
+	if (compiled != NULL) {
+		*compiled = NULL;
+		compiler = arv_dom_compiler_new ();
+	}
+
+	document = _parse_memory (NULL, NULL, buffer, size, compiler, error);
+
+	if (document != NULL && compiled != NULL)
+		*compiled = arv_dom_compiler_get_bytes (compiler);
+
+	arv_dom_compiler_free (compiler);
+
+	return document;
+}
+
+/**
+ * arv_dom_compile_from_memory:
+ * @buffer: a memory buffer holding xml data
+ * @size: size of the xml data, in bytes
+ * @error: an error placeholder
+ *
+ * Compiles xml data, without building the corresponding document.
+ *
+ * Returns: (transfer full) (nullable): the compiled form of the xml data
+ */
+
+GBytes *
+arv_dom_compile_from_memory (const void *buffer, int size, GError **error)
+{
+	ArvDomSaxParserState state = {0};
+	GBytes *compiled = NULL;
+
+	g_return_val_if_fail (buffer != NULL, NULL);
+
+	state.compiler = arv_dom_compiler_new ();
+	state.is_compile_only = TRUE;
+
+	if (size < 0)
+		size = strlen (buffer);
+
+	if (xmlSAXUserParseMemory (&sax_handler, &state, buffer, size) < 0) {
+		arv_warning_dom ("[ArvDomParser::compile_from_memory] Invalid document");
+
+		g_set_error (error,
+			     ARV_DOM_DOCUMENT_ERROR,
+			     ARV_DOM_DOCUMENT_ERROR_INVALID_XML,
+			     "Invalid document");
+	} else
+		compiled = arv_dom_compiler_get_bytes (state.compiler);
+
+	arv_dom_compiler_free (state.compiler);
+
+	return compiled;
+}
+
+struct _ArvDomPushParser {
+	ArvDomSaxParserState state;
+	xmlParserCtxtPtr context;
+	gboolean is_error;
+};
+
+/**
+ * arv_dom_push_parser_new:
+ * @compile: whether the compiled form of the document must also be built
+ *
+ * Creates an incremental parser, which builds a document from xml data received in several chunks, for example
+ * while it is downloaded or inflated.
+ *
+ * Returns: (transfer full): a new #ArvDomPushParser, to be released with arv_dom_push_parser_finish() or
+ * arv_dom_push_parser_free().
+ */
+
+ArvDomPushParser *
+arv_dom_push_parser_new (gboolean compile)
+{
+	ArvDomPushParser *parser;
+
+	parser = g_new0 (ArvDomPushParser, 1);
+	if (compile)
+		parser->state.compiler = arv_dom_compiler_new ();
+
+	parser->context = xmlCreatePushParserCtxt (&sax_handler, &parser->state, NULL, 0, NULL);
+	parser->is_error = parser->context == NULL;
+
+	return parser;
+}
+
+/**
+ * arv_dom_push_parser_feed:
+ * @parser: a #ArvDomPushParser
+ * @buffer: the next chunk of xml data
+ * @size: size of the chunk, in bytes
+ *
+ * Parses the next chunk of xml data.
+ *
+ * Returns: %FALSE if the xml data is invalid, in which case the following chunks are ignored.
+ */
+
+gboolean
+arv_dom_push_parser_feed (ArvDomPushParser *parser, const void *buffer, int size)
+{
+	g_return_val_if_fail (parser != NULL, FALSE);
+	g_return_val_if_fail (buffer != NULL || size == 0, FALSE);
+
+	if (parser->is_error)
+		return FALSE;
+
+	if (size > 0 && xmlParseChunk (parser->context, buffer, size, 0) != 0)
+		parser->is_error = TRUE;
+
+	return !parser->is_error;
+}
+
+/**
+ * arv_dom_push_parser_finish:
+ * @parser: (transfer full): a #ArvDomPushParser
+ * @compiled: (out) (optional): placeholder for the compiled form of the document
+ * @error: an error placeholder
+ *
+ * Ends the parsing, and releases @parser. @compiled is only set if the parser was created with @compile set.
+ *
+ * Returns: (transfer full) (nullable): the parsed document
+ */
+
+ArvDomDocument *
+arv_dom_push_parser_finish (ArvDomPushParser *parser, GBytes **compiled, GError **error)
+{
+	ArvDomDocument *document;
+
+	g_return_val_if_fail (parser != NULL, NULL);
+
+	if (compiled != NULL)
+		*compiled = NULL;
+
+	if (!parser->is_error &&
+	    (xmlParseChunk (parser->context, NULL, 0, 1) != 0 || !parser->context->wellFormed))
+		parser->is_error = TRUE;
+
+	document = parser->state.document;
+
+	if (parser->is_error) {
+		g_clear_object (&document);
+
+		arv_warning_dom ("[ArvDomParser::push_parser_finish] Invalid document");
+
+		g_set_error (error,
+			     ARV_DOM_DOCUMENT_ERROR,
+			     ARV_DOM_DOCUMENT_ERROR_INVALID_XML,
+			     "Invalid document");
+	} else if (compiled != NULL && parser->state.compiler != NULL)
+		*compiled = arv_dom_compiler_get_bytes (parser->state.compiler);
+
+	parser->state.document = NULL;
+	arv_dom_push_parser_free (parser);
+
+	return document;
+}
+
+/**
+ * arv_dom_push_parser_free:
+ * @parser: (transfer full): a #ArvDomPushParser
+ *
+ * Releases @parser, and the partially parsed document.
+ */
+
+void
+arv_dom_push_parser_free (ArvDomPushParser *parser)
+{
+	if (parser == NULL)
+		return;
+
+	if (parser->context != NULL)
+		xmlFreeParserCtxt (parser->context);
+	g_clear_object (&parser->state.document);
+	arv_dom_compiler_free (parser->state.compiler);
+	g_free (parser);
+}
+
+/**
+ * arv_dom_compiled_new:
+ * @bytes: compiled document data, from arv_dom_document_new_from_memory_full() or arv_dom_compile_from_memory()
+ * @error: an error placeholder
+ *
+ * Validates the compiled data header and string table, and builds the string index. A reference to @bytes is
+ * kept, as the strings returned to the #ArvDomDeferFunc callback point directly into the compiled data.
+ *
+ * Returns: (transfer full) (nullable): a new #ArvDomCompiled, to be freed with arv_dom_compiled_free().
+ */
+
+ArvDomCompiled *
+arv_dom_compiled_new (GBytes *bytes, GError **error)
+{
+	ArvDomCompiled *compiled;
+	const ArvDomCompiledHeader *header;
+	const char *strings;
+	gsize size;
+	guint32 strings_size;
+	guint32 i, j;
+
+	g_return_val_if_fail (bytes != NULL, NULL);
+
+	header = g_bytes_get_data (bytes, &size);
+	if (header == NULL || size < sizeof (ArvDomCompiledHeader) ||
+	    memcmp (header->magic, ARV_DOM_COMPILED_MAGIC, sizeof (header->magic)) != 0) {
+		g_set_error (error, ARV_DOM_DOCUMENT_ERROR, ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA,
+			     "Invalid compiled document header");
+		return NULL;
+	}
+
+	compiled = g_new0 (ArvDomCompiled, 1);
+	compiled->n_words = GUINT32_FROM_LE (header->n_words);
+	compiled->n_strings = GUINT32_FROM_LE (header->n_strings);
+	strings_size = GUINT32_FROM_LE (header->strings_size);
+
+	if ((guint64) sizeof (ArvDomCompiledHeader) + (guint64) compiled->n_words * sizeof (guint32) +
+	    strings_size != size ||
+	    compiled->n_strings > strings_size) {
+		g_free (compiled);
+		g_set_error (error, ARV_DOM_DOCUMENT_ERROR, ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA,
+			     "Invalid compiled document size");
+		return NULL;
+	}
+
+	compiled->words = (const guint32 *) (header + 1);
+	strings = (const char *) (compiled->words + compiled->n_words);
+	compiled->strings_data = strings;
+	compiled->strings_size = strings_size;
+
+	compiled->strings = g_new (const char *, compiled->n_strings);
+	for (i = 0, j = 0; i < compiled->n_strings && j < strings_size; i++) {
+		compiled->strings[i] = strings + j;
+		while (j < strings_size && strings[j] != '\0')
+			j++;
+		j++;
+	}
+	if (i != compiled->n_strings || j != strings_size) {
+		g_free (compiled->strings);
+		g_free (compiled);
+		g_set_error (error, ARV_DOM_DOCUMENT_ERROR, ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA,
+			     "Invalid compiled document string table");
+		return NULL;
+	}
+
+	compiled->bytes = g_bytes_ref (bytes);
+
+	return compiled;
+}
+
+void
+arv_dom_compiled_free (ArvDomCompiled *compiled)
+{
+	if (compiled == NULL)
+		return;
+
+	g_bytes_unref (compiled->bytes);
+	g_free (compiled->strings);
+	g_free (compiled);
+}
+
+/* Returns the index of the word following the start element at @offset, and decodes its name and attributes.
+ * @attrs is reallocated as needed. Returns 0 on error. */
+
+static guint32
+_compiled_decode_start_element (ArvDomCompiled *compiled, guint32 offset,
+				const char **name, const char ***attrs)
+{
+	guint32 i = offset;
+	guint32 index;
+	guint32 n_attrs;
+	guint32 j;
+
+	if (compiled->n_words - i < 3 ||
+	    GUINT32_FROM_LE (compiled->words[i]) != ARV_DOM_COMPILED_START_ELEMENT)
+		return 0;
+
+	index = GUINT32_FROM_LE (compiled->words[i + 1]);
+	n_attrs = GUINT32_FROM_LE (compiled->words[i + 2]);
+	i += 3;
+
+	if (index >= compiled->n_strings || n_attrs > (compiled->n_words - i) / 2)
+		return 0;
+
+	*name = compiled->strings[index];
+
+	*attrs = g_renew (const char *, *attrs, 2 * n_attrs + 1);
+	for (j = 0; j < 2 * n_attrs; j++) {
+		index = GUINT32_FROM_LE (compiled->words[i++]);
+		if (index >= compiled->n_strings)
+			return 0;
+		(*attrs)[j] = compiled->strings[index];
+	}
+	(*attrs)[2 * n_attrs] = NULL;
+
+	return i;
+}
+
+/* Returns the index of the word following the end of the element starting at @offset, or 0 on error. */
+
+static guint32
+_compiled_skip_element (ArvDomCompiled *compiled, guint32 offset)
+{
+	guint32 i = offset;
+	int depth = 0;
+
+	do {
+		guint32 opcode;
+
+		if (i >= compiled->n_words)
+			return 0;
+
+		opcode = GUINT32_FROM_LE (compiled->words[i++]);
+		switch (opcode) {
+			case ARV_DOM_COMPILED_START_ELEMENT:
+				if (compiled->n_words - i < 2 ||
+				    GUINT32_FROM_LE (compiled->words[i + 1]) > (compiled->n_words - i - 2) / 2)
+					return 0;
+				i += 2 + 2 * GUINT32_FROM_LE (compiled->words[i + 1]);
+				depth++;
+				break;
+			case ARV_DOM_COMPILED_END_ELEMENT:
+				depth--;
+				break;
+			case ARV_DOM_COMPILED_CHARACTERS:
+				i++;
+				break;
+			default:
+				return 0;
+		}
+	} while (depth > 0);
+
+	return i;
+}
+
+/* Replays the compiled events from @offset. If @is_subtree is TRUE, the replay stops at the end of the element
+ * starting at @offset. */
+
+static gboolean
+_compiled_replay (ArvDomCompiled *compiled, ArvDomSaxParserState *state, guint32 offset, gboolean is_subtree,
+		  ArvDomDeferFunc defer_func, gpointer user_data)
+{
+	const char **attrs = NULL;
+	guint32 i;
+	int depth = 0;
+	gboolean is_valid = TRUE;
+
+	state->compiled = compiled;
+	if (state->document != NULL)
+		arv_dom_document_set_static_strings (state->document, compiled->bytes,
+						     compiled->strings_data, compiled->strings_size);
+
+	arv_dom_parser_start_document (state);
+
+	for (i = offset; i < compiled->n_words && is_valid; ) {
+		const char *name;
+		guint32 index;
+		guint32 next;
+
+		switch (GUINT32_FROM_LE (compiled->words[i])) {
+			case ARV_DOM_COMPILED_START_ELEMENT:
+				next = _compiled_decode_start_element (compiled, i, &name, &attrs);
+				if (next == 0) {
+					is_valid = FALSE;
+					break;
+				}
+				if (defer_func != NULL && state->document != NULL && !state->is_error &&
+				    defer_func (state->current_node, name, attrs, i, user_data)) {
+					next = _compiled_skip_element (compiled, i);
+					is_valid = next != 0;
+					i = next;
+					break;
+				}
+				arv_dom_parser_start_element (state, (const xmlChar *) name, (const xmlChar **) attrs);
+				is_valid = ARV_IS_DOM_DOCUMENT (state->document);
+				depth++;
+				i = next;
+				break;
+			case ARV_DOM_COMPILED_END_ELEMENT:
+				if (depth <= 0) {
+					is_valid = FALSE;
+					break;
+				}
+				arv_dom_parser_end_element (state, NULL);
+				depth--;
+				i++;
+				break;
+			case ARV_DOM_COMPILED_CHARACTERS:
+				if (i + 1 >= compiled->n_words || depth <= 0) {
+					is_valid = FALSE;
+					break;
+				}
+				index = GUINT32_FROM_LE (compiled->words[i + 1]);
+				if (index >= compiled->n_strings) {
+					is_valid = FALSE;
+					break;
+				}
+				arv_dom_parser_characters (state, (const xmlChar *) compiled->strings[index],
+							   strlen (compiled->strings[index]));
+				i += 2;
+				break;
+			default:
+				is_valid = FALSE;
+				break;
+		}
+
+		if (is_subtree && depth == 0)
+			break;
+	}
+
+	arv_dom_parser_end_document (state);
+
+	g_free (attrs);
+
+	return is_valid && depth == 0;
+}
+
+/**
+ * arv_dom_compiled_new_document:
+ * @compiled: a #ArvDomCompiled
+ * @defer_func: (nullable): a function called for each element below the document element
+ * @user_data: data passed to @defer_func
+ * @error: an error placeholder
+ *
+ * Instantiates a document from its compiled form. The subtrees of the elements for which @defer_func returns
+ * %TRUE are not instantiated. They can be added later to the document using arv_dom_compiled_append_element(),
+ * with the offset given to @defer_func.
+ *
+ * Returns: (transfer full) (nullable): a new #ArvDomDocument
+ */
+
+ArvDomDocument *
+arv_dom_compiled_new_document (ArvDomCompiled *compiled, ArvDomDeferFunc defer_func, gpointer user_data,
+			       GError **error)
+{
+	ArvDomSaxParserState state = {0};
+
+	g_return_val_if_fail (compiled != NULL, NULL);
+
+	if (!_compiled_replay (compiled, &state, 0, FALSE, defer_func, user_data) || state.document == NULL) {
+		g_clear_object (&state.document);
+
+		arv_warning_dom ("[ArvDomParser::from_compiled] Invalid compiled document");
+
+		g_set_error (error, ARV_DOM_DOCUMENT_ERROR, ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA,
+			     "Invalid compiled document");
+		return NULL;
+	}
+
+	return state.document;
+}
+
+/**
+ * arv_dom_compiled_append_element:
+ * @compiled: a #ArvDomCompiled
+ * @document: a document instantiated from @compiled
+ * @parent: the parent node of the deferred element
+ * @offset: the deferred element offset, as given to the #ArvDomDeferFunc callback
+ * @error: an error placeholder
+ *
+ * Instantiates a deferred element subtree and appends it to @parent.
+ *
+ * Returns: %TRUE on success.
+ */
+
+gboolean
+arv_dom_compiled_append_element (ArvDomCompiled *compiled, ArvDomDocument *document, ArvDomNode *parent,
+				 guint32 offset, GError **error)
+{
+	ArvDomSaxParserState state = {0};
+
+	g_return_val_if_fail (compiled != NULL, FALSE);
+	g_return_val_if_fail (ARV_IS_DOM_DOCUMENT (document), FALSE);
+	g_return_val_if_fail (ARV_IS_DOM_NODE (parent), FALSE);
+
+	state.document = document;
+	state.current_node = parent;
+
+	if (offset >= compiled->n_words ||
+	    GUINT32_FROM_LE (compiled->words[offset]) != ARV_DOM_COMPILED_START_ELEMENT ||
+	    !_compiled_replay (compiled, &state, offset, TRUE, NULL, NULL)) {
+		arv_warning_dom ("[ArvDomParser::append_element] Invalid compiled element");
+
+		g_set_error (error, ARV_DOM_DOCUMENT_ERROR, ARV_DOM_DOCUMENT_ERROR_INVALID_COMPILED_DATA,
+			     "Invalid compiled element");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_dom_document_new_from_compiled:
+ * @compiled: compiled document data, from arv_dom_document_new_from_memory_full()
+ * @error: an error placeholder
+ *
+ * Instantiates a document from its compiled form. The compiled data is validated, and an error is returned if it
+ * is truncated or corrupted.
+ *
+ * Returns: (transfer full) (nullable): a new #ArvDomDocument
+ */
+
+ArvDomDocument *
+arv_dom_document_new_from_compiled (GBytes *compiled, GError **error)
+{
+	ArvDomCompiled *compiled_document;
+	ArvDomDocument *document;
+
+	g_return_val_if_fail (compiled != NULL, NULL);
+
+	compiled_document = arv_dom_compiled_new (compiled, error);
+	if (compiled_document == NULL)
+		return NULL;
+
+	document = arv_dom_compiled_new_document (compiled_document, NULL, NULL, error);
+
+	arv_dom_compiled_free (compiled_document);
+
+	return document;
 }
 
 static ArvDomDocument *
@@ -0,0 +1,70 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author:
+ * 	Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_DOM_PARSER_PRIVATE_H
+#define ARV_DOM_PARSER_PRIVATE_H
+
+#include <arvdomparser.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvDomCompiled ArvDomCompiled;
+typedef struct _ArvDomPushParser ArvDomPushParser;
+
+/**
+ * ArvDomDeferFunc:
+ * @parent: the parent of the element
+ * @name: the element name
+ * @attrs: a %NULL terminated list of attribute name and value pairs
+ * @offset: the element offset in the compiled data
+ * @user_data: user data
+ *
+ * Returns: %TRUE if the element subtree instantiation must be deferred.
+ */
+
+typedef gboolean (*ArvDomDeferFunc) (ArvDomNode *parent, const char *name, const char **attrs, guint32 offset,
+				     gpointer user_data);
+
+GBytes *		arv_dom_compile_from_memory		(const void *buffer, int size, GError **error);
+
+ArvDomCompiled *	arv_dom_compiled_new			(GBytes *bytes, GError **error);
+void			arv_dom_compiled_free			(ArvDomCompiled *compiled);
+ArvDomDocument *	arv_dom_compiled_new_document		(ArvDomCompiled *compiled, ArvDomDeferFunc defer_func,
+								 gpointer user_data, GError **error);
+gboolean		arv_dom_compiled_append_element		(ArvDomCompiled *compiled, ArvDomDocument *document,
+								 ArvDomNode *parent, guint32 offset, GError **error);
+
+/* private, but used by tests */
+ARV_API ArvDomPushParser *	arv_dom_push_parser_new			(gboolean compile);
+ARV_API gboolean		arv_dom_push_parser_feed		(ArvDomPushParser *parser, const void *buffer, int size);
+ARV_API ArvDomDocument *	arv_dom_push_parser_finish		(ArvDomPushParser *parser, GBytes **compiled,
+									 GError **error);
+ARV_API void			arv_dom_push_parser_free		(ArvDomPushParser *parser);
+
+ARV_API ArvDomDocument *	arv_dom_document_new_from_memory_full	(const void *buffer, int size, GBytes **compiled,
+									 GError **error);
+ARV_API ArvDomDocument *	arv_dom_document_new_from_compiled	(GBytes *compiled, GError **error);
+
+G_END_DECLS
+
+#endif
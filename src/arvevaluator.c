@@ -31,6 +31,7 @@
 #include <arvstr.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define ARV_EVALUATOR_STACK_SIZE	128
 
@@ -52,11 +53,20 @@ typedef enum {
 	ARV_EVALUATOR_STATUS_FORBIDDEN_RECUSRION
 } ArvEvaluatorStatus;
 
+typedef struct {
+	ArvValue value;
+	gboolean is_set;
+} ArvEvaluatorVariable;
+
+typedef struct _ArvEvaluatorProgram ArvEvaluatorProgram;
+
 typedef struct {
 	char *expression;
-	GSList *rpn_stack;
+	ArvEvaluatorProgram *program;	/* shared with the other evaluators of the same expression */
+	guint *bindings;		/* program variable slot to variables index */
 	ArvEvaluatorStatus parsing_status;
-	GHashTable *variables;
+	GArray *variables;	/* ArvEvaluatorVariable array, indexed by variable_indexes values */
+	GHashTable *variable_indexes;
 	GHashTable *sub_expressions;
 	GHashTable *constants;
 } ArvEvaluatorPrivate;
@@ -214,8 +224,24 @@ typedef struct {
 		gint64		v_int64;
 		char * 		name;
 	} data;
+	guint variable_index;	/* program variable slot, for variable tokens */
 } ArvEvaluatorToken;
 
+/* An immutable compiled expression, interned in a process wide cache keyed by the expression text, the sub-expressions
+ * and the constants. The SwissKnife and Converter nodes of a genicam tree, and of the other devices using the same
+ * description, share a single program per formula, each evaluator only keeping its own variable bindings. */
+
+struct _ArvEvaluatorProgram {
+	int ref_count;
+	char *key;
+	ArvEvaluatorStatus status;
+	GArray *tokens;			/* flat ArvEvaluatorToken array, in RPN order */
+	GPtrArray *variable_names;	/* indexed by the variable slots */
+};
+
+static GMutex program_cache_mutex;
+static GHashTable *program_cache = NULL;
+
 typedef struct {
 	gint32 parenthesis_level;
 	ArvValue value;
@@ -269,15 +295,18 @@ arv_evaluator_token_free (ArvEvaluatorToken *token)
 }
 
 static void
-arv_evaluator_token_debug (ArvEvaluatorToken *token, GHashTable *variables)
+arv_evaluator_token_debug (const ArvEvaluatorToken *token, const guint *bindings, GArray *variables)
 {
-	ArvValue *value;
+	ArvEvaluatorVariable *variable;
+	ArvValue *value = NULL;
 
 	g_return_if_fail (token != NULL);
 
 	switch (token->token_id) {
 		case ARV_EVALUATOR_TOKEN_VARIABLE:
-			value = g_hash_table_lookup (variables, token->data.name);
+			variable = &g_array_index (variables, ArvEvaluatorVariable, bindings[token->variable_index]);
+			if (variable->is_set)
+				value = &variable->value;
                         if (value != NULL && arv_value_holds_double (value))
                                 arv_debug_evaluator ("(var) %s = %g (double)",
                                                      token->data.name,
@@ -554,13 +583,14 @@ get_arguments_count(ArvEvaluatorValuesStackItem * stack, int current_index)
 }
 
 static ArvEvaluatorStatus
-evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v_double)
+evaluate (const ArvEvaluatorProgram *program, const guint *bindings, GArray *variables,
+	  gint64 *v_int64, double *v_double)
 {
-	ArvEvaluatorToken *token;
+	const ArvEvaluatorToken *token;
 	ArvEvaluatorStatus status;
-	GSList *iter;
 	ArvEvaluatorValuesStackItem stack[ARV_EVALUATOR_STACK_SIZE];
-	ArvValue *value;
+	ArvEvaluatorVariable *variable;
+	guint i;
 	int index = -1;
 	gboolean integer_mode;
 
@@ -568,10 +598,10 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 
 	integer_mode = v_int64 != NULL;
 
-	for (iter = token_stack; iter != NULL; iter = iter->next) {
+	for (i = 0; i < program->tokens->len; i++) {
 		int actual_arguments_count;
 
-		token = iter->data;
+		token = &g_array_index (program->tokens, ArvEvaluatorToken, i);
 
 		if (index < (arv_evaluator_token_infos[token->token_id].n_args - 1)) {
 			status = ARV_EVALUATOR_STATUS_MISSING_ARGUMENTS;
@@ -588,7 +618,7 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 			goto CLEANUP;
 		}
 
-		arv_evaluator_token_debug (token, variables);
+		arv_evaluator_token_debug (token, bindings, variables);
 
 		actual_arguments_count = arv_evaluator_token_infos[token->token_id].n_args;
 
@@ -936,9 +966,9 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 				stack[index+1].parenthesis_level = token->parenthesis_level;
 				break;
 			case ARV_EVALUATOR_TOKEN_VARIABLE:
-				value = g_hash_table_lookup (variables, token->data.name);
-				if (value != NULL) {
-					arv_value_copy (&stack[index+1].value, value);
+				variable = &g_array_index (variables, ArvEvaluatorVariable, bindings[token->variable_index]);
+				if (variable->is_set) {
+					arv_value_copy (&stack[index+1].value, &variable->value);
 					stack[index+1].parenthesis_level = token->parenthesis_level;
 				} else {
 					status = ARV_EVALUATOR_STATUS_UNKNOWN_VARIABLE;
@@ -1002,7 +1032,7 @@ typedef struct {
 } ArvEvaluatorParserState;
 
 static ArvEvaluatorStatus
-parse_to_stacks (ArvEvaluator *evaluator, char *expression, ArvEvaluatorParserState *state)
+parse_to_stacks (GHashTable *sub_expressions, GHashTable *constants, char *expression, ArvEvaluatorParserState *state)
 {
 	ArvEvaluatorToken *token;
 	ArvEvaluatorStatus status;
@@ -1024,10 +1054,10 @@ parse_to_stacks (ArvEvaluator *evaluator, char *expression, ArvEvaluatorParserSt
 			state->previous_token_was_right_parenthesis = arv_evaluator_token_is_right_parenthesis (token);
 
 			if (arv_evaluator_token_is_variable (token)) {
-				if (g_hash_table_lookup_extended (evaluator->priv->constants, token->data.name, NULL, NULL)) {
+				if (g_hash_table_lookup_extended (constants, token->data.name, NULL, NULL)) {
 					const char *constant;
 
-					constant = g_hash_table_lookup (evaluator->priv->constants, token->data.name);
+					constant = g_hash_table_lookup (constants, token->data.name);
 
 					if (constant != NULL) {
 						arv_evaluator_token_free (token);
@@ -1038,10 +1068,10 @@ parse_to_stacks (ArvEvaluator *evaluator, char *expression, ArvEvaluatorParserSt
 						status = ARV_EVALUATOR_STATUS_UNKNOWN_CONSTANT;
 						goto CLEANUP;
 					}
-				} else if (g_hash_table_lookup_extended (evaluator->priv->sub_expressions, token->data.name, NULL, NULL)) {
+				} else if (g_hash_table_lookup_extended (sub_expressions, token->data.name, NULL, NULL)) {
 					const char *sub_expression;
 
-					sub_expression = g_hash_table_lookup (evaluator->priv->sub_expressions, token->data.name);
+					sub_expression = g_hash_table_lookup (sub_expressions, token->data.name);
 
 					if (sub_expression != NULL) {
 						char *string;
@@ -1053,7 +1083,7 @@ parse_to_stacks (ArvEvaluator *evaluator, char *expression, ArvEvaluatorParserSt
 
 						string = g_strdup_printf ("(%s)", sub_expression);
 						state->in_sub_expression = TRUE;
-						status = parse_to_stacks (evaluator, string, state);
+						status = parse_to_stacks (sub_expressions, constants, string, state);
 						state->in_sub_expression = FALSE;
 						g_free (string);
 
@@ -1131,21 +1161,101 @@ CLEANUP:
 }
 
 static void
-free_rpn_stack (ArvEvaluator *evaluator)
+program_free (ArvEvaluatorProgram *program)
 {
-	GSList *iter;
+	guint i;
 
-	for (iter = evaluator->priv->rpn_stack; iter != NULL; iter = iter->next)
-		arv_evaluator_token_free (iter->data);
-	g_slist_free (evaluator->priv->rpn_stack);
-	evaluator->priv->rpn_stack = NULL;
+	for (i = 0; i < program->tokens->len; i++) {
+		ArvEvaluatorToken *token = &g_array_index (program->tokens, ArvEvaluatorToken, i);
+
+		if (token->token_id == ARV_EVALUATOR_TOKEN_VARIABLE)
+			g_free (token->data.name);
+	}
+	g_array_unref (program->tokens);
+	g_ptr_array_unref (program->variable_names);
+	g_free (program->key);
+	g_free (program);
+}
+
+static void
+program_unref (ArvEvaluatorProgram *program)
+{
+	gboolean is_last;
+
+	if (program == NULL)
+		return;
+
+	/* The cache lookup takes its reference under the same lock, a program can not be resurrected once its count
+	 * dropped to zero. */
+	g_mutex_lock (&program_cache_mutex);
+	is_last = --program->ref_count == 0;
+	if (is_last)
+		g_hash_table_remove (program_cache, program->key);
+	g_mutex_unlock (&program_cache_mutex);
+
+	if (is_last)
+		program_free (program);
+}
+
+static int
+_compare_names (const void *a, const void *b)
+{
+	return strcmp (*(const char **) a, *(const char **) b);
+}
+
+static void
+_append_sorted_table (GString *key, GHashTable *table)
+{
+	const char **names;
+	guint n_names;
+	guint i;
+
+	names = (const char **) g_hash_table_get_keys_as_array (table, &n_names);
+	qsort (names, n_names, sizeof (char *), _compare_names);
+
+	/* The unit and record separators are not allowed in the XML genicam descriptions */
+	for (i = 0; i < n_names; i++)
+		g_string_append_printf (key, "\x1e%s\x1f%s", names[i], (char *) g_hash_table_lookup (table, names[i]));
+	g_string_append_c (key, '\x1d');
+
+	g_free (names);
+}
+
+static char *
+program_build_key (const char *expression, GHashTable *sub_expressions, GHashTable *constants)
+{
+	GString *key;
+
+	key = g_string_new (expression);
+	g_string_append_c (key, '\x1d');
+	_append_sorted_table (key, sub_expressions);
+	_append_sorted_table (key, constants);
+
+	return g_string_free (key, FALSE);
+}
+
+static guint
+_get_variable_index (ArvEvaluator *evaluator, const char *name)
+{
+	gpointer index;
+
+	if (g_hash_table_lookup_extended (evaluator->priv->variable_indexes, name, NULL, &index))
+		return GPOINTER_TO_UINT (index);
+
+	g_array_set_size (evaluator->priv->variables, evaluator->priv->variables->len + 1);
+	g_hash_table_insert (evaluator->priv->variable_indexes, g_strdup (name),
+			     GUINT_TO_POINTER (evaluator->priv->variables->len - 1));
+
+	return evaluator->priv->variables->len - 1;
 }
 
 static ArvEvaluatorStatus
-parse_expression (ArvEvaluator *evaluator)
+program_parse (ArvEvaluatorProgram *program, const char *expression,
+	       GHashTable *sub_expressions, GHashTable *constants)
 {
 	ArvEvaluatorParserState state;
 	ArvEvaluatorStatus status;
+	GHashTable *slots;
 	GSList *iter;
 	int count;
 
@@ -1157,11 +1267,9 @@ parse_expression (ArvEvaluator *evaluator)
 	state.garbage_stack = NULL;
 	state.in_sub_expression = FALSE;
 
-	free_rpn_stack (evaluator);
+	arv_debug_evaluator ("[Evaluator::parse_expression] %s", expression);
 
-	arv_debug_evaluator ("[Evaluator::parse_expression] %s", evaluator->priv->expression);
-
-	status = parse_to_stacks (evaluator, evaluator->priv->expression, &state);
+	status = parse_to_stacks (sub_expressions, constants, (char *) expression, &state);
 
 	if (status != ARV_EVALUATOR_STATUS_SUCCESS)
 		goto CLEANUP;
@@ -1177,16 +1285,38 @@ parse_expression (ArvEvaluator *evaluator)
 		state.operator_stack = g_slist_delete_link (state.operator_stack, state.operator_stack);
 	}
 
-	evaluator->priv->rpn_stack = g_slist_reverse (state.token_stack);
+	/* Flatten the token list, and give each distinct variable a program slot, bound to the variables of each
+	 * evaluator using the program. The token structures are copied, the variable names are now owned by the
+	 * token array. */
+	slots = g_hash_table_new (g_str_hash, g_str_equal);
+	state.token_stack = g_slist_reverse (state.token_stack);
+	for (iter = state.token_stack; iter != NULL; iter = iter->next) {
+		ArvEvaluatorToken *token = iter->data;
+
+		if (token->token_id == ARV_EVALUATOR_TOKEN_VARIABLE) {
+			gpointer slot;
+
+			if (!g_hash_table_lookup_extended (slots, token->data.name, NULL, &slot)) {
+				slot = GUINT_TO_POINTER (program->variable_names->len);
+				g_ptr_array_add (program->variable_names, token->data.name);
+				g_hash_table_insert (slots, token->data.name, slot);
+			}
+			token->variable_index = GPOINTER_TO_UINT (slot);
+		}
+		g_array_append_val (program->tokens, *token);
+		g_free (token);
+	}
+	g_slist_free (state.token_stack);
+	g_hash_table_unref (slots);
 
 	for (iter = state.garbage_stack, count = 0; iter != NULL; iter = iter->next, count++)
 		arv_evaluator_token_free (iter->data);
 	g_slist_free (state.garbage_stack);
 
 	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in garbage list", count);
-	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in token list", g_slist_length (evaluator->priv->rpn_stack));
+	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in token list", program->tokens->len);
 
-	return evaluator->priv->rpn_stack == NULL ? ARV_EVALUATOR_STATUS_EMPTY_EXPRESSION : ARV_EVALUATOR_STATUS_SUCCESS;
+	return program->tokens->len == 0 ? ARV_EVALUATOR_STATUS_EMPTY_EXPRESSION : ARV_EVALUATOR_STATUS_SUCCESS;
 
 CLEANUP:
 	for (iter = state.garbage_stack; iter != NULL; iter = iter->next)
@@ -1202,6 +1332,76 @@ CLEANUP:
 	return status;
 }
 
+static ArvEvaluatorProgram *
+program_lookup (const char *expression, GHashTable *sub_expressions, GHashTable *constants)
+{
+	ArvEvaluatorProgram *program;
+	ArvEvaluatorProgram *cached;
+	char *key;
+
+	key = program_build_key (expression, sub_expressions, constants);
+
+	g_mutex_lock (&program_cache_mutex);
+	if (program_cache == NULL)
+		program_cache = g_hash_table_new (g_str_hash, g_str_equal);
+	program = g_hash_table_lookup (program_cache, key);
+	if (program != NULL)
+		program->ref_count++;
+	g_mutex_unlock (&program_cache_mutex);
+
+	if (program != NULL) {
+		arv_debug_evaluator ("[Evaluator::parse_expression] Reuse cached program for %s", expression);
+		g_free (key);
+		return program;
+	}
+
+	/* Parse outside of the lock. The failures are cached too, the status being part of the program. */
+	program = g_new0 (ArvEvaluatorProgram, 1);
+	program->ref_count = 1;
+	program->key = key;
+	program->tokens = g_array_new (FALSE, FALSE, sizeof (ArvEvaluatorToken));
+	program->variable_names = g_ptr_array_new ();
+	program->status = program_parse (program, expression, sub_expressions, constants);
+
+	g_mutex_lock (&program_cache_mutex);
+	cached = g_hash_table_lookup (program_cache, key);
+	if (cached != NULL)
+		cached->ref_count++;
+	else
+		g_hash_table_insert (program_cache, program->key, program);
+	g_mutex_unlock (&program_cache_mutex);
+
+	/* Another thread was faster */
+	if (cached != NULL) {
+		program_free (program);
+		return cached;
+	}
+
+	return program;
+}
+
+static ArvEvaluatorStatus
+parse_expression (ArvEvaluator *evaluator)
+{
+	ArvEvaluatorProgram *program;
+	guint i;
+
+	program_unref (evaluator->priv->program);
+	g_clear_pointer (&evaluator->priv->bindings, g_free);
+
+	program = program_lookup (evaluator->priv->expression,
+				  evaluator->priv->sub_expressions,
+				  evaluator->priv->constants);
+
+	evaluator->priv->program = program;
+	evaluator->priv->bindings = g_new (guint, MAX (program->variable_names->len, 1));
+	for (i = 0; i < program->variable_names->len; i++)
+		evaluator->priv->bindings[i] = _get_variable_index (evaluator,
+								    g_ptr_array_index (program->variable_names, i));
+
+	return program->status;
+}
+
 static void
 arv_evaluator_set_error (GError **error, ArvEvaluatorStatus status)
 {
@@ -1239,7 +1439,8 @@ arv_evaluator_evaluate_as_double (ArvEvaluator *evaluator, GError **error)
 		return 0.0;
 	}
 
-	status = evaluate (evaluator->priv->rpn_stack, evaluator->priv->variables, NULL, &value);
+	status = evaluate (evaluator->priv->program, evaluator->priv->bindings, evaluator->priv->variables,
+			   NULL, &value);
 
 	if (status != ARV_EVALUATOR_STATUS_SUCCESS) {
 		arv_evaluator_set_error (error, status);
@@ -1271,7 +1472,8 @@ arv_evaluator_evaluate_as_int64 (ArvEvaluator *evaluator, GError **error)
 		return 0.0;
 	}
 
-	status = evaluate (evaluator->priv->rpn_stack, evaluator->priv->variables, &value, NULL);
+	status = evaluate (evaluator->priv->program, evaluator->priv->bindings, evaluator->priv->variables,
+			   &value, NULL);
 
 	if (status != ARV_EVALUATOR_STATUS_SUCCESS) {
 
@@ -1423,21 +1625,80 @@ arv_evaluator_get_constant (ArvEvaluator *evaluator, const char *name)
 	return g_hash_table_lookup (evaluator->priv->constants, name);
 }
 
+/**
+ * arv_evaluator_get_variable_index:
+ * @evaluator: a #ArvEvaluator
+ * @name: variable name
+ *
+ * Retrieves the index of a variable, for use with arv_evaluator_set_double_variable_by_index() or
+ * arv_evaluator_set_int64_variable_by_index(). The index stays valid for the evaluator lifetime, even if the
+ * expression changes.
+ *
+ * Returns: the variable index.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_evaluator_get_variable_index (ArvEvaluator *evaluator, const char *name)
+{
+	g_return_val_if_fail (ARV_IS_EVALUATOR (evaluator), 0);
+	g_return_val_if_fail (name != NULL, 0);
+
+	return _get_variable_index (evaluator, name);
+}
+
+/**
+ * arv_evaluator_set_double_variable_by_index:
+ * @evaluator: a #ArvEvaluator
+ * @index: a variable index, from arv_evaluator_get_variable_index()
+ * @v_double: variable value
+ *
+ * Since: 0.8.24
+ */
+
 void
-arv_evaluator_set_double_variable (ArvEvaluator *evaluator, const char *name, double v_double)
+arv_evaluator_set_double_variable_by_index (ArvEvaluator *evaluator, guint index, double v_double)
 {
-	ArvValue *old_value;
+	ArvEvaluatorVariable *variable;
 
 	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
-	g_return_if_fail (name != NULL);
+	g_return_if_fail (index < evaluator->priv->variables->len);
 
-	old_value = g_hash_table_lookup (evaluator->priv->variables, name);
-	if (old_value != NULL && (arv_value_get_double (old_value) == v_double))
-		return;
+	variable = &g_array_index (evaluator->priv->variables, ArvEvaluatorVariable, index);
+	arv_value_set_double (&variable->value, v_double);
+	variable->is_set = TRUE;
+}
+
+/**
+ * arv_evaluator_set_int64_variable_by_index:
+ * @evaluator: a #ArvEvaluator
+ * @index: a variable index, from arv_evaluator_get_variable_index()
+ * @v_int64: variable value
+ *
+ * Since: 0.8.24
+ */
 
-        g_hash_table_replace (evaluator->priv->variables,
-                              g_strdup (name),
-                              arv_value_new_double (v_double));
+void
+arv_evaluator_set_int64_variable_by_index (ArvEvaluator *evaluator, guint index, gint64 v_int64)
+{
+	ArvEvaluatorVariable *variable;
+
+	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
+	g_return_if_fail (index < evaluator->priv->variables->len);
+
+	variable = &g_array_index (evaluator->priv->variables, ArvEvaluatorVariable, index);
+	arv_value_set_int64 (&variable->value, v_int64);
+	variable->is_set = TRUE;
+}
+
+void
+arv_evaluator_set_double_variable (ArvEvaluator *evaluator, const char *name, double v_double)
+{
+	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
+	g_return_if_fail (name != NULL);
+
+	arv_evaluator_set_double_variable_by_index (evaluator, _get_variable_index (evaluator, name), v_double);
 
 	arv_debug_evaluator ("[Evaluator::set_double_variable] %s = %g",
 			   name, v_double);
@@ -1446,18 +1707,10 @@ arv_evaluator_set_double_variable (ArvEvaluator *evaluator, const char *name, do
 void
 arv_evaluator_set_int64_variable (ArvEvaluator *evaluator, const char *name, gint64 v_int64)
 {
-	ArvValue *old_value;
-
 	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
 	g_return_if_fail (name != NULL);
 
-	old_value = g_hash_table_lookup (evaluator->priv->variables, name);
-	if (old_value != NULL && (arv_value_get_int64 (old_value) == v_int64))
-		return;
-
-        g_hash_table_replace (evaluator->priv->variables,
-                              g_strdup (name),
-                              arv_value_new_int64 (v_int64));
+	arv_evaluator_set_int64_variable_by_index (evaluator, _get_variable_index (evaluator, name), v_int64);
 
 	arv_debug_evaluator ("[Evaluator::set_int64_variable] %s = %" G_GINT64_FORMAT, name, v_int64);
 }
@@ -1489,8 +1742,10 @@ arv_evaluator_init (ArvEvaluator *evaluator)
 	evaluator->priv = arv_evaluator_get_instance_private (evaluator);
 
 	evaluator->priv->expression = NULL;
-	evaluator->priv->rpn_stack = NULL;
-	evaluator->priv->variables = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) arv_value_free);
+	evaluator->priv->program = NULL;
+	evaluator->priv->bindings = NULL;
+	evaluator->priv->variables = g_array_new (FALSE, TRUE, sizeof (ArvEvaluatorVariable));
+	evaluator->priv->variable_indexes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 	evaluator->priv->sub_expressions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 	evaluator->priv->constants = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
@@ -1504,10 +1759,12 @@ arv_evaluator_finalize (GObject *object)
 	ArvEvaluator *evaluator = ARV_EVALUATOR (object);
 
 	arv_evaluator_set_expression (evaluator, NULL);
-	g_hash_table_unref (evaluator->priv->variables);
+	g_array_unref (evaluator->priv->variables);
+	g_hash_table_unref (evaluator->priv->variable_indexes);
 	g_hash_table_unref (evaluator->priv->sub_expressions);
 	g_hash_table_unref (evaluator->priv->constants);
-	free_rpn_stack (evaluator);
+	program_unref (evaluator->priv->program);
+	g_free (evaluator->priv->bindings);
 
 	G_OBJECT_CLASS (arv_evaluator_parent_class)->finalize (object);
 }
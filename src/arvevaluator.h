@@ -46,6 +46,11 @@ ARV_API double			arv_evaluator_evaluate_as_double	(ArvEvaluator *evaluator, GErr
 ARV_API gint64			arv_evaluator_evaluate_as_int64		(ArvEvaluator *evaluator, GError **error);
 ARV_API void			arv_evaluator_set_double_variable	(ArvEvaluator *evaluator, const char *name, double v_double);
 ARV_API void			arv_evaluator_set_int64_variable	(ArvEvaluator *evaluator, const char *name, gint64 v_int64);
+ARV_API guint			arv_evaluator_get_variable_index	(ArvEvaluator *evaluator, const char *name);
+ARV_API void			arv_evaluator_set_double_variable_by_index	(ArvEvaluator *evaluator, guint index,
+										 double v_double);
+ARV_API void			arv_evaluator_set_int64_variable_by_index	(ArvEvaluator *evaluator, guint index,
+										 gint64 v_int64);
 
 G_END_DECLS
 
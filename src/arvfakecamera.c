@@ -38,6 +38,8 @@
 #include <arvbufferprivate.h>
 #include <arvdebug.h>
 #include <arvmiscprivate.h>
+#include <arvrecording.h>
+#include <arvfakecameraprivate.h>
 #include <string.h>
 #include <math.h>
 
@@ -77,6 +79,18 @@ typedef struct {
 
 	ArvFakeCameraFillPattern fill_pattern_callback;
 	void *fill_pattern_data;
+
+	/* Pre-rendered or loaded frames, sent in rotation, protected by fill_pattern_mutex */
+	GPtrArray *frame_bank;
+	guint frame_bank_size;
+	guint frame_bank_index;
+	gboolean is_frame_bank_loaded;
+	/* Rendering parameters of the pre-rendered frames */
+	guint32 frame_bank_width;
+	guint32 frame_bank_height;
+	guint32 frame_bank_pixel_format;
+	guint32 frame_bank_exposure_time_us;
+	guint32 frame_bank_gain;
 } ArvFakeCameraPrivate;
 
 struct _ArvFakeCamera {
@@ -125,6 +139,19 @@ arv_fake_camera_read_memory (ArvFakeCamera *camera, guint32 address, guint32 siz
 	return TRUE;
 }
 
+static guint32
+_get_register (ArvFakeCamera *camera, guint32 address)
+{
+	guint32 value;
+
+	if (address + sizeof (guint32) > ARV_FAKE_CAMERA_MEMORY_SIZE)
+		return 0;
+
+	value = *((guint32 *) (((char *)(camera->priv->memory) + address)));
+
+	return GUINT32_FROM_BE (value);
+}
+
 gboolean
 arv_fake_camera_write_memory (ArvFakeCamera *camera, guint32 address, guint32 size, const void *buffer)
 {
@@ -139,6 +166,18 @@ arv_fake_camera_write_memory (ArvFakeCamera *camera, guint32 address, guint32 si
 
 	memcpy (((char *) camera->priv->memory) + address, buffer, size);
 
+	/* The timestamp counter is the host real time, at a 1 GHz tick frequency */
+	if (address <= ARV_GVBS_TIMESTAMP_CONTROL_OFFSET &&
+	    address + size >= ARV_GVBS_TIMESTAMP_CONTROL_OFFSET + sizeof (guint32) &&
+	    (_get_register (camera, ARV_GVBS_TIMESTAMP_CONTROL_OFFSET) & ARV_GVBS_TIMESTAMP_CONTROL_LATCH) != 0) {
+		guint64 timestamp = g_get_real_time () * 1000LL;
+
+		arv_fake_camera_write_register (camera, ARV_GVBS_TIMESTAMP_LATCHED_VALUE_HIGH_OFFSET, timestamp >> 32);
+		arv_fake_camera_write_register (camera, ARV_GVBS_TIMESTAMP_LATCHED_VALUE_LOW_OFFSET,
+						timestamp & 0xffffffff);
+		arv_fake_camera_write_register (camera, ARV_GVBS_TIMESTAMP_CONTROL_OFFSET, 0);
+	}
+
 	return TRUE;
 }
 
@@ -174,19 +213,6 @@ arv_fake_camera_write_register (ArvFakeCamera *camera, guint32 address, guint32
 	return arv_fake_camera_write_memory (camera, address, sizeof (value), &be_value);
 }
 
-static guint32
-_get_register (ArvFakeCamera *camera, guint32 address)
-{
-	guint32 value;
-
-	if (address + sizeof (guint32) > ARV_FAKE_CAMERA_MEMORY_SIZE)
-		return 0;
-
-	value = *((guint32 *) (((char *)(camera->priv->memory) + address)));
-
-	return GUINT32_FROM_BE (value);
-}
-
 size_t
 arv_fake_camera_get_payload (ArvFakeCamera *camera)
 {
@@ -507,6 +533,64 @@ static struct {
    {128,     0,   0},
   };
 
+/* Color channel of each bayer pattern, indexed by [y & 1][x & 1], 0 for red, 1 for green, 2 for blue */
+
+static const guint8 bayer_bg_channels [2][2] = {{0, 1}, {1, 2}};
+static const guint8 bayer_gb_channels [2][2] = {{1, 2}, {0, 1}};
+static const guint8 bayer_gr_channels [2][2] = {{1, 0}, {2, 1}};
+static const guint8 bayer_rg_channels [2][2] = {{2, 1}, {1, 0}};
+
+static guint8
+_jet_colormap_channel (guint index, guint channel)
+{
+	switch (channel) {
+		case 0:
+			return jet_colormap [index].r;
+		case 1:
+			return jet_colormap [index].g;
+		default:
+			return jet_colormap [index].b;
+	}
+}
+
+/* The pixel value only depends on x + y. A line of the width + height values is rendered once per frame, and each row
+ * is a copy of this line, starting at offset y, which leaves the bulk of the work to the vectorized memcpy. */
+
+static void
+_diagonal_ramp_fill_rows (ArvBuffer *buffer, const guint8 *line, size_t line_stride, size_t pixel_size)
+{
+	guint32 width = buffer->priv->width;
+	guint32 height = buffer->priv->height;
+	size_t row_size = (size_t) width * pixel_size;
+	guint32 y;
+
+	for (y = 0; y < height; y++)
+		memcpy (&buffer->priv->data [(size_t) y * row_size],
+			&line [(y & 1) * line_stride + (size_t) y * pixel_size],
+			row_size);
+
+	buffer->priv->received_size = (size_t) height * row_size;
+}
+
+static void
+_diagonal_ramp_bayer (ArvBuffer *buffer, const guint8 *indexes, size_t n_indexes, const guint8 channels [2][2])
+{
+	guint8 *line;
+	size_t j;
+
+	line = g_malloc (2 * n_indexes);
+
+	for (j = 0; j < n_indexes; j++) {
+		/* x = j - y, for even then odd rows */
+		line [j] = _jet_colormap_channel (indexes [j], channels [0][j & 1]);
+		line [n_indexes + j] = _jet_colormap_channel (indexes [j], channels [1][(j + 1) & 1]);
+	}
+
+	_diagonal_ramp_fill_rows (buffer, line, n_indexes, 1);
+
+	g_free (line);
+}
+
 static void
 arv_fake_camera_diagonal_ramp (ArvBuffer *buffer, void *fill_pattern_data,
 			       guint32 exposure_time_us,
@@ -515,194 +599,89 @@ arv_fake_camera_diagonal_ramp (ArvBuffer *buffer, void *fill_pattern_data,
 {
 	double pixel_value;
 	double scale;
-	guint32 x, y;
+	guint8 *indexes;
+	size_t n_indexes;
+	size_t j;
 	guint32 width;
 	guint32 height;
+	size_t n_pixels;
 
 	if (buffer == NULL)
 		return;
 
 	width = buffer->priv->width;
 	height = buffer->priv->height;
+	n_pixels = (size_t) width * height;
 
 	scale = 1.0 + gain + log10 ((double) exposure_time_us / 10000.0);
 
+	/* Scaled 8 bit value of each x + y diagonal */
+	n_indexes = (size_t) width + height;
+	indexes = g_malloc (n_indexes);
+	for (j = 0; j < n_indexes; j++) {
+		pixel_value = (j + buffer->priv->frame_id) % 255;
+		pixel_value *= scale;
+
+		indexes [j] = CLAMP (pixel_value, 0, 255);
+	}
+
 	switch (pixel_format)
 	{
 		case ARV_PIXEL_FORMAT_MONO_8:
-			if (height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned char *pixel = &buffer->priv->data [y * width + x];
-
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
-
-						*pixel = CLAMP (pixel_value, 0, 255);
-					}
-				}
-                                buffer->priv->received_size = height * width;
-			}
+			if (n_pixels <= buffer->priv->allocated_size)
+				_diagonal_ramp_fill_rows (buffer, indexes, 0, 1);
 			break;
 
 		case ARV_PIXEL_FORMAT_MONO_16:
-			if (2 * height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned short *pixel = (unsigned short *)&buffer->priv->data [2*y * width + 2*x];
+			if (2 * n_pixels <= buffer->priv->allocated_size) {
+				guint16 *line = g_new (guint16, n_indexes);
 
-						pixel_value = (256*x + 256*buffer->priv->frame_id + 256*y) % 65535;
-						pixel_value *= scale;
+				for (j = 0; j < n_indexes; j++) {
+					pixel_value = (256 * (j + buffer->priv->frame_id)) % 65535;
+					pixel_value *= scale;
 
-						*pixel = CLAMP (pixel_value, 0, 65535);
-					}
+					line [j] = CLAMP (pixel_value, 0, 65535);
 				}
-                                buffer->priv->received_size = 2 * height * width;
+
+				_diagonal_ramp_fill_rows (buffer, (guint8 *) line, 0, 2);
+
+				g_free (line);
 			}
 			break;
 
 		case ARV_PIXEL_FORMAT_BAYER_BG_8:
-			if (height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned int index;
-						unsigned char *pixel;
-
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
-						index = CLAMP (pixel_value, 0, 255);
-
-						// BG
-						// GR
-						pixel = &buffer->priv->data [y * width + x];
-						if (x & 1) {
-							if (y & 1)
-								*pixel = jet_colormap [index].b;
-							else
-								*pixel = jet_colormap [index].g;
-						} else {
-							if (y & 1)
-								*pixel = jet_colormap [index].g;
-							else
-								*pixel = jet_colormap [index].r;
-						}
-					}
-				}
-                                buffer->priv->received_size = height * width;
-			}
+			if (n_pixels <= buffer->priv->allocated_size)
+				_diagonal_ramp_bayer (buffer, indexes, n_indexes, bayer_bg_channels);
 			break;
 
 		case ARV_PIXEL_FORMAT_BAYER_GB_8:
-			if (height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned int index;
-						unsigned char *pixel;
-
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
-						index = CLAMP (pixel_value, 0, 255);
-
-						// GB
-						// RG
-						pixel = &buffer->priv->data [y * width + x];
-						if (x & 1) {
-							if (y & 1)
-								*pixel = jet_colormap [index].g;
-							else
-								*pixel = jet_colormap [index].b;
-						} else {
-							if (y & 1)
-								*pixel = jet_colormap [index].r;
-							else
-								*pixel = jet_colormap [index].g;
-						}
-					}
-				}
-                                buffer->priv->received_size = height * width;
-			}
+			if (n_pixels <= buffer->priv->allocated_size)
+				_diagonal_ramp_bayer (buffer, indexes, n_indexes, bayer_gb_channels);
 			break;
 
 		case ARV_PIXEL_FORMAT_BAYER_GR_8:
-			if (height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned int index;
-						unsigned char *pixel;
-
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
-						index = CLAMP (pixel_value, 0, 255);
-
-						// GR
-						// BG
-						pixel = &buffer->priv->data [y * width + x];
-						if (x & 1) {
-							if (y & 1)
-								*pixel = jet_colormap [index].g;
-							else
-								*pixel = jet_colormap [index].r;
-						} else {
-							if (y & 1)
-								*pixel = jet_colormap [index].b;
-							else
-								*pixel = jet_colormap [index].g;
-						}
-					}
-				}
-                                buffer->priv->received_size = height * width;
-			}
+			if (n_pixels <= buffer->priv->allocated_size)
+				_diagonal_ramp_bayer (buffer, indexes, n_indexes, bayer_gr_channels);
 			break;
 
 		case ARV_PIXEL_FORMAT_BAYER_RG_8:
-			if (height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned int index;
-						unsigned char *pixel;
-
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
-						index = CLAMP (pixel_value, 0, 255);
-
-						// RG
-						// GB
-						pixel = &buffer->priv->data [y * width + x];
-						if (x & 1) {
-							if (y & 1)
-								*pixel = jet_colormap [index].r;
-							else
-								*pixel = jet_colormap [index].g;
-						} else {
-							if (y & 1)
-								*pixel = jet_colormap [index].g;
-							else
-								*pixel = jet_colormap [index].b;
-						}
-					}
-				}
-                                buffer->priv->received_size = height * width;
-			}
+			if (n_pixels <= buffer->priv->allocated_size)
+				_diagonal_ramp_bayer (buffer, indexes, n_indexes, bayer_rg_channels);
 			break;
 
 		case ARV_PIXEL_FORMAT_RGB_8_PACKED:
-			if (3 * height * width <= buffer->priv->allocated_size) {
-				for (y = 0; y < height; y++) {
-					for (x = 0; x < width; x++) {
-						unsigned char *pixel = &buffer->priv->data [3 * (y * width + x)];
-						unsigned int index;
+			if (3 * n_pixels <= buffer->priv->allocated_size) {
+				guint8 *line = g_malloc (3 * n_indexes);
 
-						pixel_value = (x + buffer->priv->frame_id + y) % 255;
-						pixel_value *= scale;
+				for (j = 0; j < n_indexes; j++) {
+					line [3 * j] = jet_colormap [indexes [j]].r;
+					line [3 * j + 1] = jet_colormap [indexes [j]].g;
+					line [3 * j + 2] = jet_colormap [indexes [j]].b;
+				}
 
-						index = CLAMP (pixel_value, 0, 255);
+				_diagonal_ramp_fill_rows (buffer, line, 0, 3);
 
-						pixel[0] = jet_colormap [index].r;
-						pixel[1] = jet_colormap [index].g;
-						pixel[2] = jet_colormap [index].b;
-					}
-				}
-                                buffer->priv->received_size = 3 * height * width;
+				g_free (line);
 			}
 			break;
 
@@ -710,6 +689,8 @@ arv_fake_camera_diagonal_ramp (ArvBuffer *buffer, void *fill_pattern_data,
 			g_critical ("Unsupported pixel format");
 			break;
 	}
+
+	g_free (indexes);
 }
 
 /**
@@ -738,40 +719,116 @@ arv_fake_camera_set_fill_pattern (ArvFakeCamera *camera,
 		camera->priv->fill_pattern_data = NULL;
 	}
 
+	if (!camera->priv->is_frame_bank_loaded)
+		g_ptr_array_set_size (camera->priv->frame_bank, 0);
+
 	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
 }
 
 /**
- * arv_fake_camera_fill_buffer:
+ * arv_fake_camera_set_frame_bank_size:
  * @camera: a #ArvFakeCamera
- * @buffer: the #ArvBuffer to fill
- * @packet_size: (out) (optional): the packet size
+ * @n_frames: number of pre-rendered frames, 0 to render every frame
  *
- * Fill a buffer with data from the fake camera.
+ * Enables the frame bank mode, where the @n_frames first frames are rendered by the fill pattern callback, and then
+ * sent in rotation, only the frame id and the timestamp being updated. This removes the rendering cost from the
+ * frame rate of large images. The frames are rendered again after a change of the image size, the pixel format,
+ * the exposure time, the gain or the fill pattern. This also drops a bank loaded by
+ * arv_fake_camera_load_frame_bank().
+ *
+ * Since: 0.8.24
  */
 
 void
-arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *packet_size)
+arv_fake_camera_set_frame_bank_size (ArvFakeCamera *camera, guint n_frames)
 {
-	guint32 width;
-	guint32 height;
-	guint32 exposure_time_us;
-	guint32 gain;
-	guint32 pixel_format;
-	size_t payload;
+	g_return_if_fail (ARV_IS_FAKE_CAMERA (camera));
 
-	if (camera == NULL || buffer == NULL)
-		return;
+	g_mutex_lock (&camera->priv->fill_pattern_mutex);
 
-	width = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_WIDTH);
-	height = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_HEIGHT);
-	payload = arv_fake_camera_get_payload (camera);
+	camera->priv->frame_bank_size = n_frames;
+	camera->priv->frame_bank_index = 0;
+	camera->priv->is_frame_bank_loaded = FALSE;
+	g_ptr_array_set_size (camera->priv->frame_bank, 0);
 
-	if (buffer->priv->allocated_size < payload) {
-		buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
-		return;
+	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+}
+
+/**
+ * arv_fake_camera_load_frame_bank:
+ * @camera: a #ArvFakeCamera
+ * @filename: path to a recording file, as written by #ArvRecorder
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Loads the frames of a recording into the frame bank. The recorded frames are then sent in rotation, with their own
+ * image size and pixel format, only the frame id and the timestamp being updated. The frame data stay in the
+ * mapped recording file.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_fake_camera_load_frame_bank (ArvFakeCamera *camera, const char *filename, GError **error)
+{
+	ArvRecording *recording;
+	GPtrArray *frames;
+	guint64 n_frames;
+	guint64 i;
+
+	g_return_val_if_fail (ARV_IS_FAKE_CAMERA (camera), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	recording = arv_recording_new (filename, error);
+	if (recording == NULL)
+		return FALSE;
+
+	n_frames = arv_recording_get_n_frames (recording);
+	if (n_frames == 0 || n_frames > G_MAXUINT) {
+		g_set_error (error, ARV_RECORDING_ERROR, ARV_RECORDING_ERROR_INVALID_FILE,
+			     "Invalid frame count (%" G_GUINT64_FORMAT ") in '%s'", n_frames, filename);
+		g_object_unref (recording);
+		return FALSE;
+	}
+
+	frames = g_ptr_array_new_full (n_frames, g_object_unref);
+	for (i = 0; i < n_frames; i++) {
+		ArvBuffer *frame = arv_recording_get_buffer (recording, i);
+
+		if (frame == NULL) {
+			g_set_error (error, ARV_RECORDING_ERROR, ARV_RECORDING_ERROR_INVALID_FILE,
+				     "Corrupted frame %" G_GUINT64_FORMAT " in '%s'", i, filename);
+			g_ptr_array_unref (frames);
+			g_object_unref (recording);
+			return FALSE;
+		}
+
+		g_ptr_array_add (frames, frame);
 	}
 
+	g_object_unref (recording);
+
+	g_mutex_lock (&camera->priv->fill_pattern_mutex);
+
+	g_ptr_array_unref (camera->priv->frame_bank);
+	camera->priv->frame_bank = frames;
+	camera->priv->frame_bank_size = n_frames;
+	camera->priv->frame_bank_index = 0;
+	camera->priv->is_frame_bank_loaded = TRUE;
+
+	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+
+	arv_info_misc ("[FakeCamera::load_frame_bank] %u frames loaded from '%s'", (guint) n_frames, filename);
+
+	return TRUE;
+}
+
+/* Increments the frame id, and sets the metadata of a new frame. */
+
+static void
+_set_frame_infos (ArvFakeCamera *camera, ArvBuffer *buffer)
+{
 	/* frame id is a 16 bit value, 0 is invalid */
 	camera->priv->frame_id = (camera->priv->frame_id + 1) % 65536;
 	if (camera->priv->frame_id == 0)
@@ -779,8 +836,9 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 
 	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
 	buffer->priv->chunk_endianness = G_BIG_ENDIAN;
-	buffer->priv->width = width;
-	buffer->priv->height = height;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->width = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_WIDTH);
+	buffer->priv->height = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_HEIGHT);
         buffer->priv->x_offset = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_X_OFFSET);
         buffer->priv->y_offset = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_Y_OFFSET);
 	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
@@ -788,9 +846,171 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 	buffer->priv->system_timestamp_ns = buffer->priv->timestamp_ns;
 	buffer->priv->frame_id = camera->priv->frame_id;
 	buffer->priv->pixel_format = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT);
+}
+
+static guint32
+_get_packet_size (ArvFakeCamera *camera)
+{
+	return (_get_register (camera, ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_OFFSET) >>
+		ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_POS) &
+		ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_MASK;
+}
+
+/* Returns the next frame of the bank, rendering it if needed, or NULL if the frame bank mode is disabled. Must be
+ * called with fill_pattern_mutex locked. */
+
+static ArvBuffer *
+_get_bank_frame (ArvFakeCamera *camera)
+{
+	ArvFakeCameraPrivate *priv = camera->priv;
+	ArvBuffer *frame;
+	guint32 width, height, pixel_format, exposure_time_us, gain;
+
+	if (priv->frame_bank_size == 0)
+		return NULL;
+
+	if (!priv->is_frame_bank_loaded) {
+		width = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_WIDTH);
+		height = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_HEIGHT);
+		pixel_format = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT);
+		exposure_time_us = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_EXPOSURE_TIME_US);
+		gain = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_GAIN_RAW);
+
+		if (width != priv->frame_bank_width ||
+		    height != priv->frame_bank_height ||
+		    pixel_format != priv->frame_bank_pixel_format ||
+		    exposure_time_us != priv->frame_bank_exposure_time_us ||
+		    gain != priv->frame_bank_gain) {
+			g_ptr_array_set_size (priv->frame_bank, 0);
+			priv->frame_bank_width = width;
+			priv->frame_bank_height = height;
+			priv->frame_bank_pixel_format = pixel_format;
+			priv->frame_bank_exposure_time_us = exposure_time_us;
+			priv->frame_bank_gain = gain;
+		}
+
+		if (priv->frame_bank->len < priv->frame_bank_size) {
+			frame = arv_buffer_new_allocate (arv_fake_camera_get_payload (camera));
+			_set_frame_infos (camera, frame);
+			priv->fill_pattern_callback (frame, priv->fill_pattern_data,
+						     exposure_time_us, gain, pixel_format);
+			if (frame->priv->received_size == 0)
+				frame->priv->received_size = frame->priv->allocated_size;
+			g_ptr_array_add (priv->frame_bank, frame);
+			priv->frame_bank_index = 0;
+
+			return frame;
+		}
+	}
+
+	frame = g_ptr_array_index (priv->frame_bank, priv->frame_bank_index);
+	priv->frame_bank_index = (priv->frame_bank_index + 1) % priv->frame_bank->len;
+
+	/* Only the frame counter and the timestamp change */
+	camera->priv->frame_id = (camera->priv->frame_id + 1) % 65536;
+	if (camera->priv->frame_id == 0)
+		camera->priv->frame_id = 1;
+	frame->priv->frame_id = camera->priv->frame_id;
+	frame->priv->timestamp_ns = g_get_real_time () * 1000;
+	frame->priv->system_timestamp_ns = frame->priv->timestamp_ns;
+
+	return frame;
+}
+
+/*
+ * arv_fake_camera_get_bank_frame:
+ * @camera: a #ArvFakeCamera
+ * @packet_size: (out) (optional): the packet size
+ *
+ * Zero copy variant of arv_fake_camera_fill_buffer(), for the frame bank mode.
+ *
+ * Returns: (transfer full): the next frame of the bank, with updated frame id and timestamp, or %NULL if the frame
+ * bank mode is disabled. The returned buffer must be treated as read only, and is only valid until the next call.
+ */
+
+ArvBuffer *
+arv_fake_camera_get_bank_frame (ArvFakeCamera *camera, guint32 *packet_size)
+{
+	ArvBuffer *frame;
+
+	g_return_val_if_fail (ARV_IS_FAKE_CAMERA (camera), NULL);
 
 	g_mutex_lock (&camera->priv->fill_pattern_mutex);
 
+	frame = _get_bank_frame (camera);
+	if (frame != NULL)
+		g_object_ref (frame);
+
+	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+
+	if (frame != NULL && packet_size != NULL)
+		*packet_size = _get_packet_size (camera);
+
+	return frame;
+}
+
+/**
+ * arv_fake_camera_fill_buffer:
+ * @camera: a #ArvFakeCamera
+ * @buffer: the #ArvBuffer to fill
+ * @packet_size: (out) (optional): the packet size
+ *
+ * Fill a buffer with data from the fake camera.
+ */
+
+void
+arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *packet_size)
+{
+	ArvBuffer *frame;
+	guint32 exposure_time_us;
+	guint32 gain;
+	guint32 pixel_format;
+	size_t payload;
+
+	if (camera == NULL || buffer == NULL)
+		return;
+
+	g_mutex_lock (&camera->priv->fill_pattern_mutex);
+
+	frame = _get_bank_frame (camera);
+	if (frame != NULL) {
+		if (buffer->priv->allocated_size < frame->priv->received_size) {
+			buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		} else {
+			buffer->priv->payload_type = frame->priv->payload_type;
+			buffer->priv->chunk_endianness = frame->priv->chunk_endianness;
+			buffer->priv->has_chunk_index = FALSE;
+			buffer->priv->width = frame->priv->width;
+			buffer->priv->height = frame->priv->height;
+			buffer->priv->x_offset = frame->priv->x_offset;
+			buffer->priv->y_offset = frame->priv->y_offset;
+			buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+			buffer->priv->timestamp_ns = frame->priv->timestamp_ns;
+			buffer->priv->system_timestamp_ns = frame->priv->system_timestamp_ns;
+			buffer->priv->frame_id = frame->priv->frame_id;
+			buffer->priv->pixel_format = frame->priv->pixel_format;
+			memcpy (buffer->priv->data, frame->priv->data, frame->priv->received_size);
+			buffer->priv->received_size = frame->priv->received_size;
+		}
+
+		g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+
+		if (packet_size != NULL)
+			*packet_size = _get_packet_size (camera);
+
+		return;
+	}
+
+	payload = arv_fake_camera_get_payload (camera);
+
+	if (buffer->priv->allocated_size < payload) {
+		g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+		buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		return;
+	}
+
+	_set_frame_infos (camera, buffer);
+
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_EXPOSURE_TIME_US, &exposure_time_us);
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_GAIN_RAW, &gain);
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT, &pixel_format);
@@ -800,10 +1020,7 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
 
 	if (packet_size != NULL)
-		*packet_size =
-			(_get_register (camera, ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_OFFSET) >>
-			 ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_POS) &
-			ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_MASK;
+		*packet_size = _get_packet_size (camera);
 }
 
 void
@@ -973,6 +1190,7 @@ arv_fake_camera_new_full (const char *serial_number, const char *genicam_filenam
 	g_mutex_init (&fake_camera->priv->fill_pattern_mutex);
 	fake_camera->priv->fill_pattern_callback = arv_fake_camera_diagonal_ramp;
 	fake_camera->priv->fill_pattern_data = NULL;
+	fake_camera->priv->frame_bank = g_ptr_array_new_with_free_func (g_object_unref);
 
 	if (genicam_filename != NULL)
 		filename = g_strdup (genicam_filename);
@@ -1089,6 +1307,7 @@ arv_fake_camera_finalize (GObject *object)
 	ArvFakeCamera *fake_camera = ARV_FAKE_CAMERA (object);
 
 	g_mutex_clear (&fake_camera->priv->fill_pattern_mutex);
+	g_clear_pointer (&fake_camera->priv->frame_bank, g_ptr_array_unref);
 	g_clear_pointer (&fake_camera->priv->memory, g_free);
 	g_clear_pointer (&fake_camera->priv->genicam_xml, g_free);
 
@@ -86,6 +86,11 @@ ARV_API void			arv_set_fake_camera_genicam_filename (const char *filename);
 #define ARV_FAKE_CAMERA_REGISTER_GAIN_RAW		0x110
 #define ARV_FAKE_CAMERA_REGISTER_GAIN_MODE		0x114
 
+/* LUT control */
+
+#define ARV_FAKE_CAMERA_REGISTER_LUT_VALUE		0x8000
+#define ARV_FAKE_CAMERA_LUT_SIZE			256
+
 #define ARV_TYPE_FAKE_CAMERA             (arv_fake_camera_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvFakeCamera, arv_fake_camera, ARV, FAKE_CAMERA, GObject)
 
@@ -118,6 +123,9 @@ ARV_API guint32			arv_fake_camera_get_heartbeat_timeout		(ArvFakeCamera *camera)
 ARV_API void			arv_fake_camera_set_fill_pattern	(ArvFakeCamera *camera,
 									 ArvFakeCameraFillPattern fill_pattern_callback,
 									 void *fill_pattern_data);
+ARV_API void			arv_fake_camera_set_frame_bank_size	(ArvFakeCamera *camera, guint n_frames);
+ARV_API gboolean		arv_fake_camera_load_frame_bank		(ArvFakeCamera *camera, const char *filename,
+									 GError **error);
 ARV_API void			arv_fake_camera_set_trigger_frequency	(ArvFakeCamera *camera, double frequency);
 ARV_API gboolean		arv_fake_camera_is_in_free_running_mode (ArvFakeCamera *camera);
 ARV_API gboolean		arv_fake_camera_is_in_software_trigger_mode (ArvFakeCamera *camera);
@@ -38,6 +38,11 @@ static char *arv_option_serial_number = NULL;
 static char *arv_option_genicam_file = NULL;
 static double arv_option_gvsp_lost_ratio = 0.0;
 static char *arv_option_debug_domains = NULL;
+static int arv_option_count = 1;
+static int arv_option_n_threads = 0;
+static char *arv_option_gvcp_impairment = NULL;
+static char *arv_option_gvsp_impairment = NULL;
+static int arv_option_impairment_seed = 0;
 
 static const GOptionEntry arv_option_entries[] =
 {
@@ -49,6 +54,16 @@ static const GOptionEntry arv_option_entries[] =
 	        &arv_option_genicam_file, 	"XML Genicam file to use", "genicam_filename"},
 	{ "gvsp-lost-ratio",    'r', 0, G_OPTION_ARG_DOUBLE,
 	        &arv_option_gvsp_lost_ratio,	"GVSP lost packet ratio", "packet_per_thousand"},
+	{ "count",		'n', 0, G_OPTION_ARG_INT,
+		&arv_option_count,		"Number of fake cameras, on consecutive addresses", "n_cameras"},
+	{ "threads",		't', 0, G_OPTION_ARG_INT,
+		&arv_option_n_threads,		"Number of threads driving the fake cameras", "n_threads"},
+	{ "gvcp-impairment",	'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_gvcp_impairment,	"GVCP acknowledge network impairments", "<key>=<value>[,...]"},
+	{ "gvsp-impairment",	'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_gvsp_impairment,	"GVSP packet network impairments", "<key>=<value>[,...]"},
+	{ "impairment-seed",	'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_impairment_seed,	"Random seed of the network impairments", "seed"},
 	{
 		"debug", 			'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 	NULL,
@@ -63,16 +78,81 @@ description_content[] =
 "any arbitrary genicam data, as the declared features must match the registers\n"
 "of the fake device.\n"
 "\n"
+"With a camera count greater than 1, the interface option must be an IPv4\n"
+"address. The cameras listen on consecutive addresses starting from this one,\n"
+"which must all be assigned to a local interface, and the serial option is\n"
+"used as a serial number prefix.\n"
+"\n"
+"The impairment options simulate a degraded network on the control\n"
+"acknowledges or the stream packets. The keys are latency and jitter, in µs,\n"
+"reorder-ratio, duplicate-ratio and burst-loss-ratio, from 0 to 1, and\n"
+"burst-length, the number of packets lost in each loss burst. A non zero seed\n"
+"makes the impairments reproducible.\n"
+"\n"
 "Examples:\n"
 "\n"
 "arv-fake-gv-camera-" ARAVIS_API_VERSION " -i eth0\n"
 "arv-fake-gv-camera-" ARAVIS_API_VERSION " -i 127.0.0.1\n"
-"arv-fake-gv-camera-" ARAVIS_API_VERSION " -s GV02 -d all\n";
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -s GV02 -d all\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -i 127.0.0.2 -n 32 -t 4\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " --gvsp-impairment latency=500,jitter=200,burst-loss-ratio=0.001,burst-length=8\n";
+
+static gboolean
+set_impairment (GObject *camera, const char *prefix, const char *impairment)
+{
+	char **settings;
+	gboolean success = TRUE;
+	guint i;
+
+	if (impairment == NULL)
+		return TRUE;
+
+	settings = g_strsplit (impairment, ",", -1);
+
+	for (i = 0; settings[i] != NULL && success; i++) {
+		char **tokens = g_strsplit (settings[i], "=", 2);
+		char *name;
+		GParamSpec *pspec;
+
+		name = g_strdup_printf ("%s-%s", prefix, g_strstrip (tokens[0]));
+		pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (camera), name);
+
+		if (pspec == NULL || tokens[1] == NULL) {
+			printf ("Invalid %s impairment '%s'\n", prefix, settings[i]);
+			success = FALSE;
+		} else if (G_IS_PARAM_SPEC_DOUBLE (pspec))
+			g_object_set (camera, name, g_ascii_strtod (tokens[1], NULL), NULL);
+		else
+			g_object_set (camera, name, (guint) g_ascii_strtoull (tokens[1], NULL, 10), NULL);
+
+		g_free (name);
+		g_strfreev (tokens);
+	}
+
+	g_strfreev (settings);
+
+	return success;
+}
+
+static gboolean
+set_impairments (ArvGvFakeCamera *camera, guint index)
+{
+	g_object_set (camera, "gvsp-lost-ratio", arv_option_gvsp_lost_ratio / 1000.0, NULL);
+
+	/* A distinct sequence for each camera of a farm */
+	if (arv_option_impairment_seed != 0)
+		g_object_set (camera, "impairment-seed", (guint) arv_option_impairment_seed + index, NULL);
+
+	return set_impairment (G_OBJECT (camera), "gvcp", arv_option_gvcp_impairment) &&
+		set_impairment (G_OBJECT (camera), "gvsp", arv_option_gvsp_impairment);
+}
 
 int
 main (int argc, char **argv)
 {
-	ArvGvFakeCamera *gv_camera;
+	ArvGvFakeCamera *gv_camera = NULL;
+	ArvGvFakeCameraFarm *farm = NULL;
+	gboolean is_running;
 	GOptionContext *context;
 	GError *error = NULL;
 
@@ -98,19 +178,38 @@ main (int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
-	gv_camera = arv_gv_fake_camera_new_full (arv_option_interface_name, arv_option_serial_number, arv_option_genicam_file);
-
-	g_object_set (gv_camera, "gvsp-lost-ratio", arv_option_gvsp_lost_ratio / 1000.0, NULL);
+	if (arv_option_count > 1) {
+		guint i;
+
+		farm = arv_gv_fake_camera_farm_new (arv_option_interface_name, arv_option_serial_number,
+						    arv_option_count, MAX (arv_option_n_threads, 0),
+						    arv_option_genicam_file, &error);
+		if (farm == NULL) {
+			printf ("%s\n", error->message);
+			g_clear_error (&error);
+		} else
+			for (i = 0; i < arv_gv_fake_camera_farm_get_n_cameras (farm); i++)
+				if (!set_impairments (arv_gv_fake_camera_farm_get_camera (farm, i), i)) {
+					g_clear_object (&farm);
+					break;
+				}
+		is_running = farm != NULL;
+	} else {
+		gv_camera = arv_gv_fake_camera_new_full (arv_option_interface_name, arv_option_serial_number,
+							 arv_option_genicam_file);
+		is_running = set_impairments (gv_camera, 0) && arv_gv_fake_camera_is_running (gv_camera);
+	}
 
 	signal (SIGINT, set_cancel);
 
-	if (arv_gv_fake_camera_is_running (gv_camera))
+	if (is_running)
 		while (!cancel)
 			g_usleep (1000000);
 	else
 		printf ("Failed to start camera\n");
 
-	g_object_unref (gv_camera);
+	g_clear_object (&gv_camera);
+	g_clear_object (&farm);
 
 	return EXIT_SUCCESS;
 }
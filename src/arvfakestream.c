@@ -23,6 +23,15 @@
 /**
  * SECTION: arvfakestream
  * @short_description: Fake stream
+ *
+ * The fake stream fills the buffers with the test pattern of the fake camera, or with the frames of a file written
+ * by [class@ArvRecorder] when a replay is set using [method@ArvFakeStream.set_replay]. The replay of packet captures
+ * (pcap) of the GigE Vision stream traffic is not supported.
+ *
+ * In benchmark mode, set using [method@ArvFakeStream.set_benchmark_mode], the frames are output as fast as the input
+ * buffers allow, optionally without filling their data, which measures the overhead of the [class@ArvStream] queues
+ * and callbacks independently of any transport. The achieved rate is available as the "benchmark_frame_rate" stream
+ * info.
  */
 
 #include <arvfakestreamprivate.h>
@@ -30,8 +39,18 @@
 #include <arvfakedevice.h>
 #include <arvstreamprivate.h>
 #include <arvbufferprivate.h>
-#include <arvdebug.h>
+#include <arvrecording.h>
+#include <arvdebugprivate.h>
 #include <arvmisc.h>
+#include <string.h>
+
+/* Maximum sleep between two replayed frames, keeping the thread responsive to the stop requests */
+#define ARV_FAKE_STREAM_REPLAY_MAX_DELAY_US	1000000
+/* Sleep after an unreadable recorded frame, which avoids spinning on a corrupted file in maximum rate mode */
+#define ARV_FAKE_STREAM_REPLAY_ERROR_DELAY_US	100000
+
+/* Input buffer wait in benchmark mode, keeping the thread responsive to the stop requests */
+#define ARV_FAKE_STREAM_BENCHMARK_TIMEOUT_US	100000
 
 typedef struct {
 	ArvStream *stream;
@@ -42,6 +61,19 @@ typedef struct {
 
 	gboolean cancel;
 
+	/* Replay, protected by replay_mutex */
+	GMutex replay_mutex;
+	ArvRecording *replay;
+	ArvFakeStreamReplayMode replay_mode;
+	guint64 replay_index;
+	gint64 replay_start_time_us;
+	guint64 replay_start_timestamp_ns;
+
+	/* Benchmark, mode accessed atomically */
+	ArvFakeStreamBenchmarkMode benchmark_mode;
+	guint64 benchmark_frame_id;
+	double benchmark_frame_rate;
+
 	/* Statistics */
 
 	guint64 n_completed_buffers;
@@ -70,19 +102,187 @@ G_DEFINE_TYPE_WITH_CODE (ArvFakeStream, arv_fake_stream, ARV_TYPE_STREAM, G_ADD_
 
 /* Acquisition thread */
 
+/* Returns FALSE if no replay is set. Otherwise, waits for the time of the next recorded frame, and returns it in
+ * @frame, or NULL if the record is corrupted. The replay loops back to the first frame at the end of the file. */
+
+static gboolean
+_replay_next_frame (ArvFakeStreamThreadData *thread_data, ArvBuffer **frame)
+{
+	gint64 delay_us = 0;
+	guint64 n_frames;
+
+	*frame = NULL;
+
+	g_mutex_lock (&thread_data->replay_mutex);
+
+	if (thread_data->replay == NULL) {
+		g_mutex_unlock (&thread_data->replay_mutex);
+		return FALSE;
+	}
+
+	n_frames = arv_recording_get_n_frames (thread_data->replay);
+	if (n_frames > 0) {
+		if (thread_data->replay_index >= n_frames)
+			thread_data->replay_index = 0;
+
+		*frame = arv_recording_get_buffer (thread_data->replay, thread_data->replay_index);
+
+		if (*frame != NULL && thread_data->replay_mode == ARV_FAKE_STREAM_REPLAY_MODE_ORIGINAL_RATE) {
+			gint64 time_us = g_get_monotonic_time ();
+			guint64 timestamp_ns = arv_buffer_get_timestamp (*frame);
+
+			if (thread_data->replay_index == 0 || timestamp_ns < thread_data->replay_start_timestamp_ns) {
+				thread_data->replay_start_time_us = time_us;
+				thread_data->replay_start_timestamp_ns = timestamp_ns;
+			}
+
+			delay_us = thread_data->replay_start_time_us +
+				(gint64) ((timestamp_ns - thread_data->replay_start_timestamp_ns) / 1000) - time_us;
+		}
+
+		if (*frame == NULL) {
+			arv_warning_stream_thread ("[FakeStream::replay_next_frame] Failed to read recorded frame %"
+						   G_GUINT64_FORMAT, thread_data->replay_index);
+			delay_us = ARV_FAKE_STREAM_REPLAY_ERROR_DELAY_US;
+		}
+
+		thread_data->replay_index++;
+	} else
+		delay_us = ARV_FAKE_STREAM_REPLAY_MAX_DELAY_US;
+
+	g_mutex_unlock (&thread_data->replay_mutex);
+
+	if (delay_us > 0)
+		g_usleep (MIN (delay_us, ARV_FAKE_STREAM_REPLAY_MAX_DELAY_US));
+
+	return TRUE;
+}
+
+static void
+_replay_fill_buffer (ArvBuffer *buffer, ArvBuffer *frame)
+{
+	if (buffer->priv->allocated_size < frame->priv->received_size) {
+		buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		return;
+	}
+
+	memcpy (buffer->priv->data, frame->priv->data, frame->priv->received_size);
+
+	buffer->priv->received_size = frame->priv->received_size;
+	buffer->priv->payload_type = frame->priv->payload_type;
+	buffer->priv->chunk_endianness = frame->priv->chunk_endianness;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->frame_id = frame->priv->frame_id;
+	buffer->priv->timestamp_ns = frame->priv->timestamp_ns;
+	buffer->priv->system_timestamp_ns = g_get_real_time () * 1000;
+	buffer->priv->x_offset = frame->priv->x_offset;
+	buffer->priv->y_offset = frame->priv->y_offset;
+	buffer->priv->width = frame->priv->width;
+	buffer->priv->height = frame->priv->height;
+	buffer->priv->x_padding = frame->priv->x_padding;
+	buffer->priv->pixel_format = frame->priv->pixel_format;
+
+	arv_buffer_set_n_parts (buffer, frame->priv->n_parts);
+	if (frame->priv->n_parts > 0)
+		memcpy (buffer->priv->parts, frame->priv->parts, frame->priv->n_parts * sizeof (ArvBufferPartInfos));
+
+	buffer->priv->status = frame->priv->status;
+}
+
+/* Metadata only frame of the benchmark mode */
+
+static void
+_benchmark_fill_buffer (ArvFakeStreamThreadData *thread_data, ArvBuffer *buffer)
+{
+	guint64 time_ns = g_get_real_time () * 1000LL;
+
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->frame_id = ++thread_data->benchmark_frame_id;
+	buffer->priv->timestamp_ns = time_ns;
+	buffer->priv->system_timestamp_ns = time_ns;
+	buffer->priv->received_size = 0;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+}
+
 static void *
 arv_fake_stream_thread (void *data)
 {
 	ArvFakeStreamThreadData *thread_data = data;
+	ArvFakeStreamBenchmarkMode benchmark_mode = ARV_FAKE_STREAM_BENCHMARK_MODE_DISABLE;
+	gint64 benchmark_start_time_us = 0;
+	guint64 n_benchmark_frames = 0;
 	ArvBuffer *buffer;
 
 	arv_debug_stream_thread ("[FakeStream::thread] Start");
 
+	arv_stream_apply_thread_affinity (thread_data->stream);
+
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
 
 	while (!g_atomic_int_get (&thread_data->cancel)) {
-		arv_fake_camera_wait_for_next_frame (thread_data->fake_camera);
+		ArvBuffer *frame;
+		gboolean is_replaying;
+
+		if ((ArvFakeStreamBenchmarkMode) g_atomic_int_get (&thread_data->benchmark_mode) != benchmark_mode) {
+			benchmark_mode = g_atomic_int_get (&thread_data->benchmark_mode);
+			benchmark_start_time_us = g_get_monotonic_time ();
+			n_benchmark_frames = 0;
+		}
+
+		is_replaying = _replay_next_frame (thread_data, &frame);
+		if (!is_replaying && benchmark_mode != ARV_FAKE_STREAM_BENCHMARK_MODE_DISABLE) {
+			buffer = arv_stream_timeout_pop_input_buffer (thread_data->stream,
+								      ARV_FAKE_STREAM_BENCHMARK_TIMEOUT_US);
+			if (buffer == NULL) {
+				thread_data->n_underruns++;
+				continue;
+			}
+
+			if (thread_data->callback != NULL)
+				thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
+						       NULL);
+
+			if (benchmark_mode == ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE) {
+				buffer->priv->received_size = 0;
+				arv_fake_camera_fill_buffer (thread_data->fake_camera, buffer, NULL);
+				thread_data->n_transferred_bytes += buffer->priv->received_size;
+			} else
+				_benchmark_fill_buffer (thread_data, buffer);
+
+			if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
+				thread_data->n_completed_buffers++;
+			else
+				thread_data->n_failures++;
+			arv_stream_push_output_buffer (thread_data->stream, buffer);
+
+			if (thread_data->callback != NULL)
+				thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+						       buffer);
+
+			n_benchmark_frames++;
+			thread_data->benchmark_frame_rate = (double) n_benchmark_frames * 1e6 /
+				MAX (g_get_monotonic_time () - benchmark_start_time_us, 1);
+			continue;
+		}
+
+		if (!is_replaying) {
+			gboolean has_replay;
+
+			arv_fake_camera_wait_for_next_frame (thread_data->fake_camera);
+
+			/* Don't fill a pattern frame if a replay was set during the wait */
+			g_mutex_lock (&thread_data->replay_mutex);
+			has_replay = thread_data->replay != NULL;
+			g_mutex_unlock (&thread_data->replay_mutex);
+			if (has_replay)
+				continue;
+		} else if (frame == NULL) {
+			thread_data->n_failures++;
+			continue;
+		}
+
 		buffer = arv_stream_pop_input_buffer (thread_data->stream);
 		if (buffer != NULL) {
                         buffer->priv->received_size = 0;
@@ -90,9 +290,13 @@ arv_fake_stream_thread (void *data)
 				thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
 						       NULL);
 
-			arv_fake_camera_fill_buffer (thread_data->fake_camera, buffer, NULL);
-
-                        thread_data->n_transferred_bytes += buffer->priv->allocated_size;
+			if (is_replaying) {
+				_replay_fill_buffer (buffer, frame);
+				thread_data->n_transferred_bytes += buffer->priv->received_size;
+			} else {
+				arv_fake_camera_fill_buffer (thread_data->fake_camera, buffer, NULL);
+				thread_data->n_transferred_bytes += buffer->priv->allocated_size;
+			}
 
 			if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
 				thread_data->n_completed_buffers++;
@@ -105,6 +309,8 @@ arv_fake_stream_thread (void *data)
 						       buffer);
 		} else
 			thread_data->n_underruns++;
+
+		g_clear_object (&frame);
 	}
 
 	if (thread_data->callback != NULL)
@@ -151,6 +357,102 @@ arv_fake_stream_stop_thread (ArvStream *stream)
 	priv->thread = NULL;
 }
 
+static void
+arv_fake_stream_arm (ArvStream *stream, size_t buffer_size)
+{
+	ArvFakeStreamPrivate *priv = arv_fake_stream_get_instance_private (ARV_FAKE_STREAM (stream));
+
+	if (priv->thread != NULL)
+		arv_fake_stream_stop_thread (stream);
+
+	arv_fake_stream_start_thread (stream);
+}
+
+static void
+arv_fake_stream_disarm (ArvStream *stream)
+{
+	ArvFakeStreamPrivate *priv = arv_fake_stream_get_instance_private (ARV_FAKE_STREAM (stream));
+
+	if (priv->thread != NULL)
+		arv_fake_stream_stop_thread (stream);
+}
+
+/**
+ * arv_fake_stream_set_replay:
+ * @fake_stream: a #ArvFakeStream
+ * @filename: (nullable): path of a file written by [class@ArvRecorder], %NULL to go back to the test pattern
+ * @mode: replay timing
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Fills the stream buffers with the recorded frames instead of the fake camera test pattern, starting from the first
+ * frame, and looping at the end of the recording. The buffers keep the recorded frame ids and timestamps, only the
+ * system timestamps are set to the replay time. The unreadable frames of a corrupted file are skipped, and counted
+ * as failures. Only the files of [class@ArvRecorder] are supported, not the packet captures (pcap) of the stream
+ * traffic.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_fake_stream_set_replay (ArvFakeStream *fake_stream, const char *filename, ArvFakeStreamReplayMode mode,
+			    GError **error)
+{
+	ArvFakeStreamPrivate *priv = arv_fake_stream_get_instance_private (fake_stream);
+	ArvRecording *recording = NULL;
+
+	g_return_val_if_fail (ARV_IS_FAKE_STREAM (fake_stream), FALSE);
+
+	if (filename != NULL) {
+		recording = arv_recording_new (filename, error);
+		if (recording == NULL)
+			return FALSE;
+
+		arv_info_stream ("[FakeStream::set_replay] Replay %" G_GUINT64_FORMAT " frames from '%s'%s",
+				 arv_recording_get_n_frames (recording), filename,
+				 mode == ARV_FAKE_STREAM_REPLAY_MODE_MAX_RATE ? " at maximum rate" : "");
+	}
+
+	g_mutex_lock (&priv->thread_data->replay_mutex);
+	g_clear_object (&priv->thread_data->replay);
+	priv->thread_data->replay = recording;
+	priv->thread_data->replay_mode = mode;
+	priv->thread_data->replay_index = 0;
+	g_mutex_unlock (&priv->thread_data->replay_mutex);
+
+	return TRUE;
+}
+
+/**
+ * arv_fake_stream_set_benchmark_mode:
+ * @fake_stream: a #ArvFakeStream
+ * @mode: benchmark mode
+ *
+ * Outputs the frames as fast as the input buffers allow, ignoring the frame rate of the fake camera, in order to
+ * measure the overhead of the stream queues and callbacks. With
+ * %ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE_METADATA_ONLY, the buffer data are left untouched, only the frame id, the
+ * timestamps and the status being set. The frame rate achieved since the last mode change is available as the
+ * "benchmark_frame_rate" stream info. A replay set by [method@ArvFakeStream.set_replay] takes precedence.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_fake_stream_set_benchmark_mode (ArvFakeStream *fake_stream, ArvFakeStreamBenchmarkMode mode)
+{
+	ArvFakeStreamPrivate *priv = arv_fake_stream_get_instance_private (fake_stream);
+
+	g_return_if_fail (ARV_IS_FAKE_STREAM (fake_stream));
+
+	arv_info_stream ("[FakeStream::set_benchmark_mode] %s",
+			 mode == ARV_FAKE_STREAM_BENCHMARK_MODE_DISABLE ? "Disable" :
+			 mode == ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE ? "Maximum rate" :
+			 "Maximum rate, metadata only");
+
+	g_atomic_int_set (&priv->thread_data->benchmark_mode, mode);
+}
+
 /**
  * arv_fake_stream_new: (skip)
  * @camera: a #ArvFakeDevice
@@ -194,6 +496,8 @@ arv_fake_stream_constructed (GObject *object)
 
 	thread_data->cancel = FALSE;
 
+	g_mutex_init (&thread_data->replay_mutex);
+
         arv_stream_declare_info (ARV_STREAM (fake_stream), "n_completed_buffers",
                                  G_TYPE_UINT64, &thread_data->n_completed_buffers);
         arv_stream_declare_info (ARV_STREAM (fake_stream), "n_failures",
@@ -204,6 +508,8 @@ arv_fake_stream_constructed (GObject *object)
                                  G_TYPE_UINT64, &thread_data->n_transferred_bytes);
         arv_stream_declare_info (ARV_STREAM (fake_stream), "n_ignored_bytes",
                                  G_TYPE_UINT64, &thread_data->n_ignored_bytes);
+        arv_stream_declare_info (ARV_STREAM (fake_stream), "benchmark_frame_rate",
+                                 G_TYPE_DOUBLE, &thread_data->benchmark_frame_rate);
 
 	priv->thread_data = thread_data;
 
@@ -227,9 +533,13 @@ arv_fake_stream_finalize (GObject *object)
 	ArvFakeStream *fake_stream = ARV_FAKE_STREAM (object);
 	ArvFakeStreamPrivate *priv = arv_fake_stream_get_instance_private (fake_stream);
 
-	arv_fake_stream_stop_thread (ARV_STREAM (fake_stream));
+	/* The thread may have been stopped by arv_stream_disarm() */
+	if (priv->thread != NULL)
+		arv_fake_stream_stop_thread (ARV_STREAM (fake_stream));
 
 	if (priv->thread_data != NULL) {
+		g_clear_object (&priv->thread_data->replay);
+		g_mutex_clear (&priv->thread_data->replay_mutex);
 		g_clear_pointer (&priv->thread_data, g_free);
 	}
 
@@ -247,4 +557,6 @@ arv_fake_stream_class_init (ArvFakeStreamClass *fake_stream_class)
 
 	stream_class->start_thread = arv_fake_stream_start_thread;
 	stream_class->stop_thread = arv_fake_stream_stop_thread;
+	stream_class->arm = arv_fake_stream_arm;
+	stream_class->disarm = arv_fake_stream_disarm;
 }
@@ -32,9 +32,43 @@
 
 G_BEGIN_DECLS
 
+/**
+ * ArvFakeStreamReplayMode:
+ * @ARV_FAKE_STREAM_REPLAY_MODE_ORIGINAL_RATE: replay the frames with their recorded inter-frame timing
+ * @ARV_FAKE_STREAM_REPLAY_MODE_MAX_RATE: replay the frames as fast as the input buffers allow
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_FAKE_STREAM_REPLAY_MODE_ORIGINAL_RATE,
+	ARV_FAKE_STREAM_REPLAY_MODE_MAX_RATE
+} ArvFakeStreamReplayMode;
+
+/**
+ * ArvFakeStreamBenchmarkMode:
+ * @ARV_FAKE_STREAM_BENCHMARK_MODE_DISABLE: frames paced by the fake camera frame rate
+ * @ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE: filled frames, as fast as the input buffers allow
+ * @ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE_METADATA_ONLY: frames with only their metadata set, as fast as the input
+ * buffers allow
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_FAKE_STREAM_BENCHMARK_MODE_DISABLE,
+	ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE,
+	ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE_METADATA_ONLY
+} ArvFakeStreamBenchmarkMode;
+
 #define ARV_TYPE_FAKE_STREAM             (arv_fake_stream_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvFakeStream, arv_fake_stream, ARV, FAKE_STREAM, ArvStream)
 
+ARV_API gboolean	arv_fake_stream_set_replay	(ArvFakeStream *fake_stream, const char *filename,
+							 ArvFakeStreamReplayMode mode, GError **error);
+ARV_API void		arv_fake_stream_set_benchmark_mode	(ArvFakeStream *fake_stream,
+								 ArvFakeStreamBenchmarkMode mode);
+
 G_END_DECLS
 
 #endif
@@ -27,6 +27,13 @@
  * #ArvGc implements the root document for the storage of the Genicam feature
  * nodes. It builds the node tree by parsing an xml file in the Genicam
  * standard format. See http://www.genicam.org.
+ *
+ * Feature reads and writes may be issued from several threads. The node table is protected by a read-write lock,
+ * the instantiation of the deferred nodes of a lazily loaded document is serialized, and each register node
+ * protects its own cache, so that reads hitting the cache don't block each other. Device accesses are serialized
+ * by the device itself. The strings returned by the string getters stay owned by their node, and are only valid
+ * until the next read of the same node, from any thread. When a string feature may be read from several threads, its
+ * value must be retrieved with arv_gc_string_dup_value() or arv_gc_feature_node_dup_value_as_string().
  */
 
 #include <arvgcprivate.h>
@@ -40,9 +47,10 @@
 #include <arvgccategory.h>
 #include <arvgcenumeration.h>
 #include <arvgcenumentry.h>
+#include <arvgcselector.h>
 #include <arvgcintegernode.h>
 #include <arvgcfloatnode.h>
-#include <arvgcregisternode.h>
+#include <arvgcregisternodeprivate.h>
 #include <arvgcintregnode.h>
 #include <arvgcmaskedintregnode.h>
 #include <arvgcfloatregnode.h>
@@ -59,25 +67,98 @@
 #include <arvgcconverternode.h>
 #include <arvgcintconverternode.h>
 #include <arvgcport.h>
+#include <arvgcfeaturenodeprivate.h>
+#include <arvgvdevice.h>
 #include <arvbuffer.h>
 #include <arvdebugprivate.h>
-#include <arvdomparser.h>
+#include <arvmiscprivate.h>
+#include <arvdomparserprivate.h>
+#include <arvgenicamcacheprivate.h>
+#include <arvshadowmemoryprivate.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
 
+typedef struct {
+	ArvDomNode *parent;
+	guint32 offset;
+} ArvGcDeferredNode;
+
+typedef struct {
+	ArvGcPort *port;
+	guint64 address;
+	GByteArray *data;
+	gboolean is_register;	/* Must be written using a register write, can't be merged with adjacent writes */
+} ArvGcPendingWrite;
+
+static void
+arv_gc_pending_write_free (ArvGcPendingWrite *pending_write)
+{
+	g_byte_array_unref (pending_write->data);
+	g_free (pending_write);
+}
+
 typedef struct {
 	GHashTable *nodes;
+	GRWLock nodes_lock;
+
+	ArvDomCompiled *compiled;
+	GHashTable *deferred_nodes;
+	GRecMutex deferred_mutex;	/* Serializes the deferred node instantiations */
 	ArvDevice *device;
 	ArvBuffer *buffer;
 
 	ArvRegisterCachePolicy cache_policy;
+	/* Incremented on each cache policy change, global or per register */
+	gint cache_policy_epoch;
 	ArvRangeCheckPolicy range_check_policy;
 	ArvAccessCheckPolicy access_check_policy;
+	gint64 struct_entry_snapshot_lifetime_us;
+
+	/* Allocated on the first enable, and kept until the document destruction */
+	ArvShadowMemory *shadow_memory;
+	gint is_shadow_memory_enabled;
 
         unsigned n_register_cache_errors;
+	unsigned n_register_cache_hits;
+	unsigned n_register_cache_misses;
+
+	GMutex transaction_mutex;
+	guint transaction_depth;
+	GPtrArray *pending_writes;	/* ArvGcPendingWrite, in write order */
+
+	GMutex feature_index_mutex;
+	GHashTable *feature_indexes;	/* ArvGcIndexedFeature arrays, keyed by root node */
+
+	GMutex change_mutex;
+	GHashTable *changed_features;	/* Names of the watched features changed since the last emission */
+	GMainContext *change_context;
+	GSource *change_source;
+
+	GMutex poll_mutex;
+	GCond poll_cond;
+	GThread *poll_thread;
+	gboolean is_poll_cancelled;
+	GPtrArray *poll_groups;		/* ArvGcPollGroup, one per polling time */
+
+	gint is_profiling_enabled;
+	GMutex profile_mutex;
+	GHashTable *profiles;		/* ArvGcFeatureProfile, keyed by feature name */
 } ArvGcPrivate;
 
+typedef struct {
+	gint64 period_us;
+	gint64 next_time_us;
+	GPtrArray *nodes;		/* Polled ArvGcRegisterNode */
+} ArvGcPollGroup;
+
+static void
+arv_gc_poll_group_free (ArvGcPollGroup *group)
+{
+	g_ptr_array_unref (group->nodes);
+	g_free (group);
+}
+
 struct _ArvGc {
 	ArvDomDocument base;
 
@@ -88,6 +169,13 @@ struct _ArvGcClass {
 	ArvDomDocumentClass parent_class;
 };
 
+enum {
+	ARV_GC_SIGNAL_FEATURE_CHANGED,
+	ARV_GC_SIGNAL_LAST
+} ArvGcSignals;
+
+static guint arv_gc_signals[ARV_GC_SIGNAL_LAST] = {0};
+
 GQuark
 arv_gc_error_quark (void)
 {
@@ -279,6 +367,26 @@ arv_gc_create_element (ArvDomDocument *document, const char *tag_name)
 
 /* ArvGc implementation */
 
+static gint arv_gc_node_generation = 0;
+
+guint
+arv_gc_get_node_generation (void)
+{
+	return g_atomic_int_get (&arv_gc_node_generation);
+}
+
+static ArvGcNode *
+_lookup_node (ArvGc *genicam, const char *name)
+{
+	ArvGcNode *node;
+
+	g_rw_lock_reader_lock (&genicam->priv->nodes_lock);
+	node = g_hash_table_lookup (genicam->priv->nodes, name);
+	g_rw_lock_reader_unlock (&genicam->priv->nodes_lock);
+
+	return node;
+}
+
 /**
  * arv_gc_get_node:
  * @genicam: a #ArvGc object
@@ -292,222 +400,2541 @@ arv_gc_create_element (ArvDomDocument *document, const char *tag_name)
 ArvGcNode *
 arv_gc_get_node	(ArvGc *genicam, const char *name)
 {
+	ArvGcDeferredNode *deferred_node;
+	ArvGcDeferredNode node_data;
+	ArvGcNode *node;
+
 	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
 	g_return_val_if_fail (name != NULL, NULL);
 
-	return g_hash_table_lookup (genicam->priv->nodes, name);
+	node = _lookup_node (genicam, name);
+	if (node != NULL || genicam->priv->compiled == NULL)
+		return node;
+
+	g_rec_mutex_lock (&genicam->priv->deferred_mutex);
+
+	/* The node may have been instantiated by another thread in the meantime */
+	node = _lookup_node (genicam, name);
+	if (node != NULL)
+		goto out;
+
+	deferred_node = g_hash_table_lookup (genicam->priv->deferred_nodes, name);
+	if (deferred_node == NULL)
+		goto out;
+
+	/* Remove the entry first, the node instantiation registers it under the same name */
+	node_data = *deferred_node;
+	g_hash_table_remove (genicam->priv->deferred_nodes, name);
+
+	arv_debug_genicam ("[Gc::get_node] Instantiate deferred node '%s'", name);
+
+	if (arv_dom_compiled_append_element (genicam->priv->compiled, ARV_DOM_DOCUMENT (genicam),
+					     node_data.parent, node_data.offset, NULL))
+		node = _lookup_node (genicam, name);
+
+out:
+	g_rec_mutex_unlock (&genicam->priv->deferred_mutex);
+
+	return node;
 }
 
 /**
- * arv_gc_get_device:
+ * arv_gc_prefetch_features:
  * @genicam: a #ArvGc object
+ * @features: (array zero-terminated=1): a %NULL terminated list of feature names
+ * @error: a #GError placeholder, %NULL to ignore
  *
- * Retrieves the device handled by this genicam interface. The device is used for register access.
+ * Updates the register cache of the given features, using a minimal number of device transactions. For
+ * GigEVision devices, all the 4 bytes registers of the feature list are read using multiple register read
+ * commands, and the adjacent longer registers are merged into single memory reads. Features which are not
+ * directly backed by a register are ignored, and will be read as usual when accessed. See arv_gc_read_all() for
+ * the prefetch of a whole feature tree, which follows the node dependencies.
  *
- * Return value: (transfer none): a #ArvDevice.
+ * This function does nothing if the register cache is disabled, see arv_gc_set_register_cache_policy().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
  */
 
-ArvDevice *
-arv_gc_get_device (ArvGc *genicam)
+/* Adds the register backing the value of @node, either @node itself or the register linked by its pValue */
+
+static void
+_add_value_registers (GPtrArray *nodes, ArvGcNode *node)
 {
-	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+	ArvDomNode *iter;
 
-	return genicam->priv->device;
+	if (ARV_IS_GC_REGISTER_NODE (node)) {
+		g_ptr_array_add (nodes, node);
+		return;
+	}
+
+	if (ARV_IS_GC_STRUCT_ENTRY_NODE (node)) {
+		ArvDomNode *struct_register = arv_dom_node_get_parent_node (ARV_DOM_NODE (node));
+
+		if (ARV_IS_GC_REGISTER_NODE (struct_register))
+			g_ptr_array_add (nodes, struct_register);
+		return;
+	}
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter) &&
+		    arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) ==
+		    ARV_GC_PROPERTY_NODE_TYPE_P_VALUE) {
+			ArvGcNode *value_node;
+
+			value_node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (iter));
+			if (ARV_IS_GC_REGISTER_NODE (value_node))
+				g_ptr_array_add (nodes, value_node);
+		}
+	}
 }
 
-void
-arv_gc_register_feature_node (ArvGc *genicam, ArvGcFeatureNode *node)
+gboolean
+arv_gc_prefetch_features (ArvGc *genicam, const char **features, GError **error)
 {
-	const char *name;
+	GPtrArray *nodes;
+	gboolean success;
+	guint i;
 
-	g_return_if_fail (ARV_IS_GC (genicam));
-	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (node));
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (features != NULL, FALSE);
 
+	if (arv_gc_get_register_cache_policy (genicam) == ARV_REGISTER_CACHE_POLICY_DISABLE)
+		return TRUE;
 
-	name = arv_gc_feature_node_get_name (node);
-	if (name == NULL)
-		return;
+	nodes = g_ptr_array_new ();
 
-	g_object_ref (node);
+	for (i = 0; features[i] != NULL; i++) {
+		ArvGcNode *node;
 
-	g_hash_table_remove (genicam->priv->nodes, (char *) name);
-	g_hash_table_insert (genicam->priv->nodes, (char *) name, node);
+		node = arv_gc_get_node (genicam, features[i]);
+		if (node == NULL) {
+			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
+				     "Feature '%s' not found", features[i]);
+			g_ptr_array_unref (nodes);
+			return FALSE;
+		}
 
-	arv_debug_genicam ("[Gc::register_feature_node] Register node '%s' [%s]", name,
-			 arv_dom_node_get_node_name (ARV_DOM_NODE (node)));
-}
+		_add_value_registers (nodes, node);
+	}
 
-void
-arv_gc_set_default_node_data (ArvGc *genicam, const char *node_name, ...)
-{
-	va_list args;
-	char *node_data;
+	success = arv_gc_register_node_prefetch ((ArvGcRegisterNode **) nodes->pdata, nodes->len, error);
 
-	g_return_if_fail (ARV_IS_GC (genicam));
-	g_return_if_fail (node_name != NULL);
+	g_ptr_array_unref (nodes);
 
-	if (arv_gc_get_node (genicam, node_name) != NULL)
-		return;
+	return success;
+}
 
-	arv_info_genicam ("[Gc::set_default_node_data] Add '%s'", node_name);
+typedef struct {
+	GHashTable *visited;
+	GPtrArray *address_registers;
+	GPtrArray *registers;
+} ArvGcReadAllData;
 
-	va_start (args, node_name);
-	do {
-		node_data = va_arg (args, char *);
-		if (node_data != NULL)
-			arv_dom_document_append_from_memory (ARV_DOM_DOCUMENT (genicam), NULL, node_data, -1, NULL);
-	} while (node_data != NULL);
-	va_end (args);
-}
+/* Collects the registers a node depends on. The registers used for the computation of a register address, length
+ * or index go to a separate list, as they must be read before the address of the dependent register is known. */
 
-void
-arv_gc_set_register_cache_policy (ArvGc *genicam, ArvRegisterCachePolicy policy)
+static void
+_collect_registers (ArvGcReadAllData *data, ArvGcNode *node, gboolean is_address_dependency)
 {
-	g_return_if_fail (ARV_IS_GC (genicam));
+	ArvDomNode *iter;
 
-	genicam->priv->cache_policy = policy;
+	if (node == NULL || g_hash_table_contains (data->visited, node))
+		return;
+	g_hash_table_add (data->visited, node);
+
+	if (ARV_IS_GC_REGISTER_NODE (node))
+		g_ptr_array_add (is_address_dependency ? data->address_registers : data->registers, node);
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter)) {
+			switch (arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter))) {
+				/* Not needed for the evaluation of the node */
+				case ARV_GC_PROPERTY_NODE_TYPE_P_FEATURE:
+				case ARV_GC_PROPERTY_NODE_TYPE_P_SELECTED:
+				case ARV_GC_PROPERTY_NODE_TYPE_P_INVALIDATOR:
+				case ARV_GC_PROPERTY_NODE_TYPE_P_PORT:
+					break;
+				default:
+					_collect_registers (data,
+							    arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (iter)),
+							    is_address_dependency || ARV_IS_GC_REGISTER_NODE (node));
+					break;
+			}
+		} else if (ARV_IS_GC_NODE (iter)) {
+			/* Enumeration and structure entries */
+			_collect_registers (data, ARV_GC_NODE (iter), is_address_dependency);
+		}
+	}
 }
 
-ArvRegisterCachePolicy
-arv_gc_get_register_cache_policy (ArvGc *genicam)
+static void
+_collect_features (ArvGcReadAllData *data, ArvGc *genicam, const char *name, GRegex *regex)
 {
-	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_REGISTER_CACHE_POLICY_DISABLE);
+	ArvGcNode *node;
+	gboolean match;
 
-	return genicam->priv->cache_policy;
-}
+	node = arv_gc_get_node (genicam, name);
+	if (!ARV_IS_GC_FEATURE_NODE (node))
+		return;
 
-void
-arv_gc_set_range_check_policy (ArvGc *genicam, ArvRangeCheckPolicy policy)
-{
-	g_return_if_fail (ARV_IS_GC (genicam));
+	match = regex == NULL || g_regex_match (regex, name, 0, NULL);
 
-	genicam->priv->range_check_policy = policy;
-}
+	if (ARV_IS_GC_CATEGORY (node)) {
+		const GSList *iter;
 
-ArvRangeCheckPolicy
-arv_gc_get_range_check_policy (ArvGc *genicam)
-{
-	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_RANGE_CHECK_POLICY_DISABLE);
+		if (g_hash_table_contains (data->visited, node))
+			return;
+		g_hash_table_add (data->visited, node);
 
-	return genicam->priv->range_check_policy;
+		for (iter = arv_gc_category_get_features (ARV_GC_CATEGORY (node)); iter != NULL; iter = iter->next)
+			_collect_features (data, genicam, iter->data, match ? NULL : regex);
+	} else if (match)
+		_collect_registers (data, node, FALSE);
 }
 
-void
-arv_gc_set_access_check_policy (ArvGc *genicam, ArvAccessCheckPolicy policy)
+/**
+ * arv_gc_read_all:
+ * @genicam: a #ArvGc object
+ * @filter: (nullable): a glob pattern selecting the features by name, %NULL for all features
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Fills the register cache with the registers needed for the evaluation of the features of the feature tree
+ * selected by @filter, using a minimal number of device transactions. A selected category selects all its
+ * features. The features can then be read locally, from the register cache, for a fast dump of the device state.
+ *
+ * The 4 bytes registers are read using multiple register read commands, and the adjacent longer registers are
+ * merged into single memory reads, see arv_gc_prefetch_features(). The registers used for the computation of
+ * register addresses, like the selector registers, are read first.
+ *
+ * Registers behind the current selector values only are read. A read error does not stop the prefetch, the
+ * registers involved are read as usual when accessed.
+ *
+ * This function does nothing if the register cache is disabled, see arv_gc_set_register_cache_policy().
+ *
+ * Returns: %TRUE on success, %FALSE if some of the registers could not be read.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_read_all (ArvGc *genicam, const char *filter, GError **error)
 {
-	g_return_if_fail (ARV_IS_GC (genicam));
+	ArvGcReadAllData data;
+	GRegex *regex = NULL;
+	GError *local_error = NULL;
+	gint64 start;
 
-	genicam->priv->access_check_policy = policy;
-}
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
 
-ArvAccessCheckPolicy
-arv_gc_get_access_check_policy (ArvGc *genicam)
-{
-	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_ACCESS_CHECK_POLICY_DISABLE);
+	if (arv_gc_get_register_cache_policy (genicam) == ARV_REGISTER_CACHE_POLICY_DISABLE)
+		return TRUE;
 
-	return genicam->priv->access_check_policy;
-}
+	start = g_get_monotonic_time ();
 
-static void
-_weak_notify_cb (gpointer data, GObject *object)
-{
-	ArvGc *genicam = data;
+	if (filter != NULL)
+		regex = arv_regex_new_from_glob_pattern (filter, TRUE);
 
-	genicam->priv->buffer = NULL;
-}
+	data.visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+	data.address_registers = g_ptr_array_new ();
+	data.registers = g_ptr_array_new ();
 
-void
-arv_gc_set_buffer (ArvGc *genicam, ArvBuffer *buffer)
-{
-	g_return_if_fail (ARV_IS_GC (genicam));
-	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	_collect_features (&data, genicam, "Root", regex);
 
-	if (genicam->priv->buffer != NULL)
-		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+	arv_gc_register_node_prefetch ((ArvGcRegisterNode **) data.address_registers->pdata,
+				       data.address_registers->len, &local_error);
+	arv_gc_register_node_prefetch ((ArvGcRegisterNode **) data.registers->pdata,
+				       data.registers->len, local_error == NULL ? &local_error : NULL);
 
-	g_object_weak_ref (G_OBJECT (buffer), _weak_notify_cb, genicam);
+	arv_info_genicam ("[Gc::read_all] %u + %u register(s) prefetched in %g s",
+			  data.address_registers->len, data.registers->len,
+			  (g_get_monotonic_time () - start) / 1000000.0);
 
-	genicam->priv->buffer = buffer;
+	g_ptr_array_unref (data.address_registers);
+	g_ptr_array_unref (data.registers);
+	g_hash_table_unref (data.visited);
+	g_clear_pointer (&regex, g_regex_unref);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
 }
 
 /**
- * arv_gc_get_buffer:
+ * arv_gc_dup_selected_feature_values:
  * @genicam: a #ArvGc object
+ * @selector: the name of a selector enumeration, like LineSelector or GainSelector
+ * @error: a #GError placeholder, %NULL to ignore
  *
- * Retrieves the binded buffer.
+ * Reads the features selected by @selector, for each of its available values. For each selector value, the selector
+ * is written once, then the registers of all the selected features are read using a minimal number of device
+ * transactions, as in arv_gc_prefetch_features(), when the register cache is enabled. The selector is put back to its
+ * initial value on return.
  *
- * Return value: (transfer none): a #ArvBuffer.
+ * The result is a snapshot of the selected features, keyed by selector value, which can be kept and looked up
+ * instead of switching the selector again. The features not available for a given selector value are not in its
+ * table.
+ *
+ * Returns: (transfer full) (element-type utf8 GHashTable): a new table of the selector values, each associated to a
+ * table of the selected feature values as strings, keyed by feature name. %NULL on error.
+ *
+ * Since: 0.8.24
  */
 
-ArvBuffer *
-arv_gc_get_buffer (ArvGc *genicam)
+GHashTable *
+arv_gc_dup_selected_feature_values (ArvGc *genicam, const char *selector, GError **error)
 {
+	ArvGcNode *node;
+	ArvGcEnumeration *enumeration;
+	GHashTable *selector_values;
+	GPtrArray *features;
+	GPtrArray *registers;
+	GError *local_error = NULL;
+	const char **entries;
+	const GSList *iter;
+	gint64 initial_value;
+	guint n_entries;
+	guint i, j;
+
 	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+	g_return_val_if_fail (selector != NULL, NULL);
 
-	return genicam->priv->buffer;
+	node = arv_gc_get_node (genicam, selector);
+	if (!ARV_IS_GC_ENUMERATION (node) || !arv_gc_selector_is_selector (ARV_GC_SELECTOR (node))) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
+			     "Selector '%s' not found", selector);
+		return NULL;
+	}
+
+	enumeration = ARV_GC_ENUMERATION (node);
+
+	features = g_ptr_array_new ();
+	registers = g_ptr_array_new ();
+	for (iter = arv_gc_selector_get_selected_features (ARV_GC_SELECTOR (node)); iter != NULL; iter = iter->next) {
+		g_ptr_array_add (features, iter->data);
+		_add_value_registers (registers, iter->data);
+	}
+
+	initial_value = arv_gc_enumeration_get_int_value (enumeration, &local_error);
+	entries = local_error == NULL ?
+		arv_gc_enumeration_dup_available_string_values (enumeration, &n_entries, &local_error) : NULL;
+
+	selector_values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+						 (GDestroyNotify) g_hash_table_unref);
+
+	for (i = 0; entries != NULL && i < n_entries && local_error == NULL; i++) {
+		GHashTable *values;
+
+		if (!arv_gc_enumeration_set_string_value (enumeration, entries[i], &local_error))
+			break;
+
+		/* The selected registers may lack the pInvalidator link to the selector, they are always read again */
+		for (j = 0; j < registers->len; j++)
+			arv_gc_feature_node_increment_change_count (g_ptr_array_index (registers, j));
+
+		if (!arv_gc_register_node_prefetch ((ArvGcRegisterNode **) registers->pdata, registers->len,
+						    &local_error))
+			break;
+
+		values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+		for (j = 0; j < features->len; j++) {
+			ArvGcFeatureNode *feature = g_ptr_array_index (features, j);
+			GError *feature_error = NULL;
+			char *value;
+
+			if (!arv_gc_feature_node_is_available (feature, NULL))
+				continue;
+
+			value = arv_gc_feature_node_dup_value_as_string (feature, &feature_error);
+			if (feature_error != NULL) {
+				arv_debug_genicam ("[Gc::dup_selected_feature_values] %s[%s]: %s",
+						   arv_gc_feature_node_get_name (feature), entries[i],
+						   feature_error->message);
+				g_clear_error (&feature_error);
+				g_free (value);
+				continue;
+			}
+
+			g_hash_table_insert (values, g_strdup (arv_gc_feature_node_get_name (feature)), value);
+		}
+
+		g_hash_table_insert (selector_values, g_strdup (entries[i]), values);
+	}
+
+	if (entries != NULL)
+		arv_gc_enumeration_set_int_value (enumeration, initial_value,
+						  local_error == NULL ? &local_error : NULL);
+
+	g_free (entries);
+	g_ptr_array_unref (features);
+	g_ptr_array_unref (registers);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		g_hash_table_unref (selector_values);
+		return NULL;
+	}
+
+	return selector_values;
 }
 
-guint64
-arv_gc_register_cache_error_add (ArvGc *genicam, guint64 n_errors)
+/* Flattened category tree, built on first use, as the nodes of a lazily loaded document only exist once accessed.
+ * The entries are never moved, the availability cache fields are protected by the feature_index_mutex. */
+
+typedef struct {
+	ArvGcFeatureNode *node;
+	gint parent;
+	guint level;
+	gboolean is_category;
+
+	gboolean is_availability_cached;
+	guint64 availability_change_count;
+	gboolean is_implemented;
+	gboolean is_available;
+} ArvGcIndexedFeature;
+
+static void
+_index_features (GArray *index, ArvGcFeatureNode *node, gint parent, guint level)
 {
-	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
+	ArvGcIndexedFeature indexed = {0};
+	ArvDomNode *iter;
+	gint position;
+	gint ancestor;
+
+	/* Category cycle */
+	for (ancestor = parent; ancestor >= 0; ancestor = g_array_index (index, ArvGcIndexedFeature, ancestor).parent)
+		if (g_array_index (index, ArvGcIndexedFeature, ancestor).node == node)
+			return;
+
+	indexed.node = node;
+	indexed.parent = parent;
+	indexed.level = level;
+	indexed.is_category = ARV_IS_GC_CATEGORY (node);
+	g_array_append_val (index, indexed);
+
+	if (!indexed.is_category)
+		return;
 
-        genicam->priv->n_register_cache_errors += n_errors;
+	position = index->len - 1;
 
-        return genicam->priv->n_register_cache_errors;
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter) &&
+		    arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) ==
+		    ARV_GC_PROPERTY_NODE_TYPE_P_FEATURE) {
+			ArvGcNode *feature;
+
+			feature = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (iter));
+			if (ARV_IS_GC_FEATURE_NODE (feature))
+				_index_features (index, ARV_GC_FEATURE_NODE (feature), position, level + 1);
+		}
+	}
 }
 
-ArvGc *
-arv_gc_new (ArvDevice *device, const void *xml, size_t size)
+static GArray *
+_get_feature_index (ArvGc *genicam, ArvGcFeatureNode *root)
 {
-	ArvDomDocument *document;
-	ArvGc *genicam;
+	GArray *index;
 
-	document = arv_dom_document_new_from_memory (xml, size, NULL);
-	if (!ARV_IS_GC (document)) {
-		if (document != NULL)
-			g_object_unref (document);
-		return NULL;
+	g_mutex_lock (&genicam->priv->feature_index_mutex);
+	index = g_hash_table_lookup (genicam->priv->feature_indexes, root);
+	g_mutex_unlock (&genicam->priv->feature_index_mutex);
+
+	if (index != NULL)
+		return index;
+
+	index = g_array_new (FALSE, FALSE, sizeof (ArvGcIndexedFeature));
+	_index_features (index, root, -1, 0);
+
+	g_mutex_lock (&genicam->priv->feature_index_mutex);
+	if (g_hash_table_lookup (genicam->priv->feature_indexes, root) == NULL) {
+		g_hash_table_insert (genicam->priv->feature_indexes, root, index);
+	} else {
+		g_array_unref (index);
+		index = g_hash_table_lookup (genicam->priv->feature_indexes, root);
 	}
+	g_mutex_unlock (&genicam->priv->feature_index_mutex);
 
-	genicam = ARV_GC (document);
-	genicam->priv->device = device;
+	arv_debug_genicam ("[Gc::get_feature_index] %u entries under '%s'", index->len,
+			   arv_gc_feature_node_get_name (root));
 
-	return genicam;
+	return index;
 }
 
-G_DEFINE_TYPE_WITH_CODE (ArvGc, arv_gc, ARV_TYPE_DOM_DOCUMENT, G_ADD_PRIVATE (ArvGc))
+/* With the register cache enabled, the availability is kept until a change of the nodes behind the pIsAvailable and
+ * pIsImplemented properties, as for the enumeration entries */
 
 static void
-arv_gc_init (ArvGc *genicam)
+_get_indexed_feature_availability (ArvGc *genicam, ArvGcIndexedFeature *indexed, gboolean use_cache,
+				   gboolean *is_implemented, gboolean *is_available)
 {
-	genicam->priv = arv_gc_get_instance_private (genicam);
+	guint64 change_count = 0;
 
-	genicam->priv->nodes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
-	genicam->priv->cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
+	if (use_cache) {
+		gboolean is_cached;
+
+		change_count = arv_gc_feature_node_get_availability_change_count (indexed->node);
+
+		g_mutex_lock (&genicam->priv->feature_index_mutex);
+		is_cached = indexed->is_availability_cached && indexed->availability_change_count == change_count;
+		*is_implemented = indexed->is_implemented;
+		*is_available = indexed->is_available;
+		g_mutex_unlock (&genicam->priv->feature_index_mutex);
+
+		if (is_cached)
+			return;
+	}
+
+	*is_implemented = arv_gc_feature_node_is_implemented (indexed->node, NULL);
+	*is_available = *is_implemented && arv_gc_feature_node_is_available (indexed->node, NULL);
+
+	if (use_cache) {
+		g_mutex_lock (&genicam->priv->feature_index_mutex);
+		indexed->is_implemented = *is_implemented;
+		indexed->is_available = *is_available;
+		indexed->availability_change_count = change_count;
+		indexed->is_availability_cached = TRUE;
+		g_mutex_unlock (&genicam->priv->feature_index_mutex);
+	}
 }
 
-static void
-arv_gc_finalize (GObject *object)
+/**
+ * arv_gc_dup_feature_index:
+ * @genicam: a #ArvGc object
+ * @root: (allow-none): name of the root category, %NULL for "Root"
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Lists the features under @root, as a flattened category tree in depth first order, each category being followed
+ * by its content. A feature listed in several categories has an entry for each of them. The tree structure is
+ * built once and kept by @genicam, and the availability of the features is cached, as long as the register cache
+ * is enabled and the nodes it depends on don't change. This avoids walking the categories and looking up each
+ * feature by name when building a feature tree.
+ *
+ * ```c
+ * index = arv_gc_dup_feature_index (genicam, NULL, NULL);
+ * for (i = 0; i < index->len; i++) {
+ *	ArvGcFeatureIndexEntry *entry = &g_array_index (index, ArvGcFeatureIndexEntry, i);
+ *
+ *	if (entry->is_implemented)
+ *		printf ("%*s%s\n", 4 * entry->level, "", entry->name);
+ * }
+ * g_array_unref (index);
+ * ```
+ *
+ * Returns: (transfer full) (element-type ArvGcFeatureIndexEntry): an array of #ArvGcFeatureIndexEntry, %NULL if
+ * @root is not found.
+ *
+ * Since: 0.8.24
+ */
+
+GArray *
+arv_gc_dup_feature_index (ArvGc *genicam, const char *root, GError **error)
 {
-	ArvGc *genicam = ARV_GC (object);
+	ArvGcNode *root_node;
+	GArray *index;
+	GArray *entries;
+	gboolean use_cache;
+	guint i;
 
-	if (genicam->priv->buffer != NULL)
-		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
 
-	g_hash_table_unref (genicam->priv->nodes);
+	if (root == NULL)
+		root = "Root";
 
-	G_OBJECT_CLASS (arv_gc_parent_class)->finalize (object);
+	root_node = arv_gc_get_node (genicam, root);
+	if (!ARV_IS_GC_FEATURE_NODE (root_node)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND, "Node '%s' not found", root);
+		return NULL;
+	}
+
+	index = _get_feature_index (genicam, ARV_GC_FEATURE_NODE (root_node));
+	use_cache = arv_gc_get_register_cache_policy (genicam) == ARV_REGISTER_CACHE_POLICY_ENABLE;
+
+	entries = g_array_sized_new (FALSE, FALSE, sizeof (ArvGcFeatureIndexEntry), index->len);
+	g_array_set_size (entries, index->len);
+
+	for (i = 0; i < index->len; i++) {
+		ArvGcIndexedFeature *indexed = &g_array_index (index, ArvGcIndexedFeature, i);
+		ArvGcFeatureIndexEntry *entry = &g_array_index (entries, ArvGcFeatureIndexEntry, i);
+
+		entry->name = arv_gc_feature_node_get_name (indexed->node);
+		entry->node = indexed->node;
+		entry->parent = indexed->parent;
+		entry->level = indexed->level;
+		entry->is_category = indexed->is_category;
+
+		_get_indexed_feature_availability (genicam, indexed, use_cache,
+						   &entry->is_implemented, &entry->is_available);
+
+		entry->access_mode = entry->is_implemented ?
+			arv_gc_feature_node_get_actual_access_mode (indexed->node) :
+			ARV_GC_ACCESS_MODE_UNDEFINED;
+	}
+
+	return entries;
 }
 
-static void
-arv_gc_class_init (ArvGcClass *node_class)
+static gboolean
+_emit_feature_changes (gpointer data)
 {
-	GObjectClass *object_class = G_OBJECT_CLASS (node_class);
-	ArvDomNodeClass *d_node_class = ARV_DOM_NODE_CLASS (node_class);
-	ArvDomDocumentClass *d_document_class = ARV_DOM_DOCUMENT_CLASS (node_class);
+	ArvGc *genicam = data;
+	GHashTable *changed_features;
+	GHashTableIter iter;
+	gpointer name;
+
+	g_mutex_lock (&genicam->priv->change_mutex);
+	changed_features = genicam->priv->changed_features;
+	genicam->priv->changed_features = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_clear_pointer (&genicam->priv->change_source, g_source_unref);
+	g_mutex_unlock (&genicam->priv->change_mutex);
+
+	g_hash_table_iter_init (&iter, changed_features);
+	while (g_hash_table_iter_next (&iter, &name, NULL))
+		g_signal_emit (genicam, arv_gc_signals[ARV_GC_SIGNAL_FEATURE_CHANGED],
+			       g_quark_from_string (name), name);
+
+	g_hash_table_unref (changed_features);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Must be called with the change mutex held */
+
+static void
+_schedule_feature_changes (ArvGc *genicam)
+{
+	if (genicam->priv->change_source != NULL ||
+	    g_hash_table_size (genicam->priv->changed_features) == 0)
+		return;
+
+	genicam->priv->change_source = g_idle_source_new ();
+	g_source_set_callback (genicam->priv->change_source, _emit_feature_changes, genicam, NULL);
+	g_source_attach (genicam->priv->change_source, genicam->priv->change_context);
+}
+
+/* Called on each change of a watched feature. The changes are collected until the next iteration of the main
+ * context, or until the end of the current transaction. */
+
+void
+arv_gc_queue_feature_change (ArvGc *genicam, ArvGcFeatureNode *node)
+{
+	gboolean is_in_transaction;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+	is_in_transaction = genicam->priv->transaction_depth > 0;
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+
+	g_mutex_lock (&genicam->priv->change_mutex);
+	g_hash_table_add (genicam->priv->changed_features, (gpointer) arv_gc_feature_node_get_name (node));
+	if (!is_in_transaction)
+		_schedule_feature_changes (genicam);
+	g_mutex_unlock (&genicam->priv->change_mutex);
+}
+
+/**
+ * arv_gc_watch_feature:
+ * @genicam: a #ArvGc object
+ * @feature: a feature name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Enables the emission of the #ArvGc::feature-changed signal for @feature, when it is written, or when one of the
+ * nodes its value is computed from is written or invalidated. Only the changes known to @genicam are reported,
+ * changes made by the device itself are not detected unless an invalidator or an event brings them. A feature can
+ * be watched several times, it is then watched until the same number of calls to arv_gc_unwatch_feature().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_watch_feature (ArvGc *genicam, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+
+	node = arv_gc_get_node (genicam, feature);
+	if (!ARV_IS_GC_FEATURE_NODE (node)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND, "Feature '%s' not found", feature);
+		return FALSE;
+	}
+
+	g_mutex_lock (&genicam->priv->change_mutex);
+	if (genicam->priv->change_context == NULL)
+		genicam->priv->change_context = g_main_context_ref_thread_default ();
+	g_mutex_unlock (&genicam->priv->change_mutex);
+
+	arv_gc_feature_node_watch (ARV_GC_FEATURE_NODE (node));
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_unwatch_feature:
+ * @genicam: a #ArvGc object
+ * @feature: a feature name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Reverts a call to arv_gc_watch_feature().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_unwatch_feature (ArvGc *genicam, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+
+	node = arv_gc_get_node (genicam, feature);
+	if (!ARV_IS_GC_FEATURE_NODE (node)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND, "Feature '%s' not found", feature);
+		return FALSE;
+	}
+
+	arv_gc_feature_node_unwatch (ARV_GC_FEATURE_NODE (node));
+
+	return TRUE;
+}
+
+/* Refreshes the groups whose period elapsed, each in a single call to the batched register read. Rounds falling
+ * during a transaction are skipped, as the caches hold the pending writes. */
+
+static gpointer
+_poll_thread (gpointer data)
+{
+	ArvGc *genicam = data;
+	ArvGcPrivate *priv = genicam->priv;
+
+	g_mutex_lock (&priv->poll_mutex);
+
+	while (!priv->is_poll_cancelled) {
+		gint64 now_us = g_get_monotonic_time ();
+		gint64 wakeup_us = G_MAXINT64;
+		guint i;
+
+		for (i = 0; i < priv->poll_groups->len; i++) {
+			ArvGcPollGroup *group = g_ptr_array_index (priv->poll_groups, i);
+
+			if (group->next_time_us <= now_us) {
+				gboolean is_in_transaction;
+				GError *error = NULL;
+
+				g_mutex_lock (&priv->transaction_mutex);
+				is_in_transaction = priv->transaction_depth > 0;
+				g_mutex_unlock (&priv->transaction_mutex);
+
+				if (!is_in_transaction &&
+				    !arv_gc_register_node_poll ((ArvGcRegisterNode **) group->nodes->pdata,
+								group->nodes->len, &error)) {
+					arv_debug_genicam ("[Gc::poll] %u ms group: %s",
+							   (guint) (group->period_us / 1000), error->message);
+					g_clear_error (&error);
+				}
+
+				/* Late rounds are not caught up */
+				group->next_time_us += group->period_us;
+				if (group->next_time_us <= now_us)
+					group->next_time_us = now_us + group->period_us;
+			}
+
+			wakeup_us = MIN (wakeup_us, group->next_time_us);
+		}
+
+		if (!priv->is_poll_cancelled)
+			g_cond_wait_until (&priv->poll_cond, &priv->poll_mutex, wakeup_us);
+	}
+
+	g_mutex_unlock (&priv->poll_mutex);
+
+	return NULL;
+}
+
+static ArvGcPollGroup *
+_get_poll_group (GPtrArray *groups, gint64 period_us)
+{
+	ArvGcPollGroup *group;
+	guint i;
+
+	for (i = 0; i < groups->len; i++) {
+		group = g_ptr_array_index (groups, i);
+		if (group->period_us == period_us)
+			return group;
+	}
+
+	group = g_new0 (ArvGcPollGroup, 1);
+	group->period_us = period_us;
+	group->nodes = g_ptr_array_new_with_free_func (g_object_unref);
+	g_ptr_array_add (groups, group);
+
+	return group;
+}
+
+/**
+ * arv_gc_start_polling:
+ * @genicam: a #ArvGc object
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts the refresh of the registers declaring a `PollingTime`, from a dedicated thread. The registers are grouped
+ * by polling time, and the registers of a group are read in a single batch of register reads and memory block reads
+ * at each period, which updates their register caches. The registers whose value changed are pushed to their
+ * dependent nodes, and the watched features depending on them emit #ArvGc::feature-changed, see
+ * arv_gc_watch_feature().
+ *
+ * With the lazy loading of the genicam data, only the registers already instantiated are polled. Calling this
+ * function again restarts the polling with an updated list of registers.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_start_polling (ArvGc *genicam, GError **error)
+{
+	GHashTableIter iter;
+	GPtrArray *groups;
+	gpointer value;
+	gint64 now_us;
+	guint n_nodes = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	if (!ARV_IS_DEVICE (genicam->priv->device)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET, "No device set for register polling");
+		return FALSE;
+	}
+
+	arv_gc_stop_polling (genicam);
+
+	groups = g_ptr_array_new_with_free_func ((GDestroyNotify) arv_gc_poll_group_free);
+
+	g_rw_lock_reader_lock (&genicam->priv->nodes_lock);
+	g_hash_table_iter_init (&iter, genicam->priv->nodes);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		gint64 polling_time;
+
+		if (!ARV_IS_GC_REGISTER_NODE (value))
+			continue;
+
+		polling_time = arv_gc_register_node_get_polling_time (value);
+		if (polling_time > 0) {
+			g_ptr_array_add (_get_poll_group (groups, polling_time * 1000)->nodes, g_object_ref (value));
+			n_nodes++;
+		}
+	}
+	g_rw_lock_reader_unlock (&genicam->priv->nodes_lock);
+
+	if (n_nodes == 0) {
+		arv_info_genicam ("[Gc::start_polling] No register with polling time");
+		g_ptr_array_unref (groups);
+		return TRUE;
+	}
+
+	now_us = g_get_monotonic_time ();
+	for (i = 0; i < groups->len; i++) {
+		ArvGcPollGroup *group = g_ptr_array_index (groups, i);
+
+		group->next_time_us = now_us + group->period_us;
+		arv_info_genicam ("[Gc::start_polling] %u register(s) polled every %" G_GINT64_FORMAT " ms",
+				  group->nodes->len, group->period_us / 1000);
+	}
+
+	genicam->priv->poll_groups = groups;
+	genicam->priv->is_poll_cancelled = FALSE;
+	genicam->priv->poll_thread = g_thread_new ("arv_gc_poll", _poll_thread, genicam);
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_stop_polling:
+ * @genicam: a #ArvGc object
+ *
+ * Stops the register polling started by arv_gc_start_polling(). Does nothing if the polling is not running.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_stop_polling (ArvGc *genicam)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	if (genicam->priv->poll_thread == NULL)
+		return;
+
+	g_mutex_lock (&genicam->priv->poll_mutex);
+	genicam->priv->is_poll_cancelled = TRUE;
+	g_cond_signal (&genicam->priv->poll_cond);
+	g_mutex_unlock (&genicam->priv->poll_mutex);
+
+	g_thread_join (genicam->priv->poll_thread);
+	genicam->priv->poll_thread = NULL;
+	g_clear_pointer (&genicam->priv->poll_groups, g_ptr_array_unref);
+}
+
+/**
+ * arv_gc_get_device:
+ * @genicam: a #ArvGc object
+ *
+ * Retrieves the device handled by this genicam interface. The device is used for register access.
+ *
+ * Return value: (transfer none): a #ArvDevice.
+ */
+
+ArvDevice *
+arv_gc_get_device (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return genicam->priv->device;
+}
+
+void
+arv_gc_register_feature_node (ArvGc *genicam, ArvGcFeatureNode *node)
+{
+	const char *name;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (node));
+
+
+	name = arv_gc_feature_node_get_name (node);
+	if (name == NULL)
+		return;
+
+	g_object_ref (node);
+
+	g_rec_mutex_lock (&genicam->priv->deferred_mutex);
+	if (genicam->priv->deferred_nodes != NULL)
+		g_hash_table_remove (genicam->priv->deferred_nodes, name);
+	g_rec_mutex_unlock (&genicam->priv->deferred_mutex);
+
+	g_rw_lock_writer_lock (&genicam->priv->nodes_lock);
+
+	/* Invalidate the linked node pointers cached by the property nodes */
+	if (g_hash_table_contains (genicam->priv->nodes, name))
+		g_atomic_int_inc (&arv_gc_node_generation);
+
+	g_hash_table_remove (genicam->priv->nodes, (char *) name);
+	g_hash_table_insert (genicam->priv->nodes, (char *) name, node);
+
+	g_rw_lock_writer_unlock (&genicam->priv->nodes_lock);
+
+	arv_debug_genicam ("[Gc::register_feature_node] Register node '%s' [%s]", name,
+			 arv_dom_node_get_node_name (ARV_DOM_NODE (node)));
+}
+
+void
+arv_gc_set_default_node_data (ArvGc *genicam, const char *node_name, ...)
+{
+	va_list args;
+	char *node_data;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (node_name != NULL);
+
+	if (arv_gc_get_node (genicam, node_name) != NULL)
+		return;
+
+	arv_info_genicam ("[Gc::set_default_node_data] Add '%s'", node_name);
+
+	va_start (args, node_name);
+	do {
+		node_data = va_arg (args, char *);
+		if (node_data != NULL)
+			arv_dom_document_append_from_memory (ARV_DOM_DOCUMENT (genicam), NULL, node_data, -1, NULL);
+	} while (node_data != NULL);
+	va_end (args);
+}
+
+void
+arv_gc_set_register_cache_policy (ArvGc *genicam, ArvRegisterCachePolicy policy)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_atomic_int_set ((gint *) &genicam->priv->cache_policy, policy);
+	g_atomic_int_inc (&genicam->priv->cache_policy_epoch);
+}
+
+ArvRegisterCachePolicy
+arv_gc_get_register_cache_policy (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_REGISTER_CACHE_POLICY_DISABLE);
+
+	return g_atomic_int_get ((gint *) &genicam->priv->cache_policy);
+}
+
+/* Collects the value registers of @feature, and of all the features below it if it is a category */
+
+static void
+_collect_feature_registers (ArvGc *genicam, const char *feature, GHashTable *visited, GPtrArray *registers)
+{
+	ArvGcNode *node;
+
+	node = arv_gc_get_node (genicam, feature);
+	if (node == NULL || !g_hash_table_add (visited, node))
+		return;
+
+	if (ARV_IS_GC_CATEGORY (node)) {
+		const GSList *iter;
+
+		for (iter = arv_gc_category_get_features (ARV_GC_CATEGORY (node)); iter != NULL; iter = iter->next)
+			_collect_feature_registers (genicam, iter->data, visited, registers);
+	} else
+		_add_value_registers (registers, node);
+}
+
+static gboolean
+_set_feature_register_cache_policy (ArvGc *genicam, const char *feature, gint policy, GError **error)
+{
+	GHashTable *visited;
+	GPtrArray *registers;
+	guint i;
+
+	if (arv_gc_get_node (genicam, feature) == NULL) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND, "Node '%s' not found", feature);
+		return FALSE;
+	}
+
+	visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+	registers = g_ptr_array_new ();
+
+	_collect_feature_registers (genicam, feature, visited, registers);
+
+	for (i = 0; i < registers->len; i++)
+		arv_gc_register_node_set_cache_policy (g_ptr_array_index (registers, i), policy);
+	g_atomic_int_inc (&genicam->priv->cache_policy_epoch);
+
+	arv_debug_policies ("[Gc::set_feature_register_cache_policy] %s: %d for %u register(s)",
+			    feature, policy, registers->len);
+
+	g_ptr_array_unref (registers);
+	g_hash_table_unref (visited);
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_set_feature_register_cache_policy:
+ * @genicam: a #ArvGc object
+ * @feature: a feature or category name
+ * @policy: the register cache policy of @feature
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Overrides the register cache policy set by arv_gc_set_register_cache_policy() for the registers backing the value
+ * of @feature. If @feature is a category, the override applies to all the features it contains, recursively. It
+ * allows for example to cache all the registers in debug mode, except the volatile status registers:
+ *
+ * |[<!-- language="C" -->
+ * arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DEBUG);
+ * arv_gc_set_feature_register_cache_policy (genicam, "DeviceTemperature",
+ *                                           ARV_REGISTER_CACHE_POLICY_DISABLE, NULL);
+ * ]|
+ *
+ * The cached values of the involved registers are dropped.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_set_feature_register_cache_policy (ArvGc *genicam, const char *feature, ArvRegisterCachePolicy policy,
+					  GError **error)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+
+	return _set_feature_register_cache_policy (genicam, feature, policy, error);
+}
+
+/**
+ * arv_gc_reset_feature_register_cache_policy:
+ * @genicam: a #ArvGc object
+ * @feature: a feature or category name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Removes the override set by arv_gc_set_feature_register_cache_policy(), the registers of @feature following again
+ * the register cache policy of @genicam.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_reset_feature_register_cache_policy (ArvGc *genicam, const char *feature, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+
+	return _set_feature_register_cache_policy (genicam, feature, -1, error);
+}
+
+/**
+ * arv_gc_get_cache_statistics:
+ * @genicam: a #ArvGc object
+ * @feature: (nullable): a feature or category name, %NULL for the whole document
+ * @n_hits: (out) (optional): the number of register cache hits
+ * @n_misses: (out) (optional): the number of register cache misses
+ * @n_errors: (out) (optional): the number of mismatches between the cached and the actual register values,
+ * detected with the debug cache policy
+ *
+ * Retrieves the register cache counters, summed over the registers backing the value of @feature, or over all the
+ * registers if @feature is %NULL. Each miss means a device access, which makes these counters useful for the search
+ * of the features causing traffic, and for the tuning of the per feature cache policies, see
+ * arv_gc_set_feature_register_cache_policy().
+ *
+ * Returns: %TRUE on success, %FALSE if @feature was not found.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_get_cache_statistics (ArvGc *genicam, const char *feature,
+			     guint64 *n_hits, guint64 *n_misses, guint64 *n_errors)
+{
+	GHashTable *visited;
+	GPtrArray *registers;
+	guint64 hits = 0, misses = 0, errors = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	if (feature == NULL) {
+		arv_gc_get_register_cache_statistics (genicam, n_hits, n_misses, n_errors);
+		return TRUE;
+	}
+
+	if (arv_gc_get_node (genicam, feature) == NULL)
+		return FALSE;
+
+	visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+	registers = g_ptr_array_new ();
+
+	_collect_feature_registers (genicam, feature, visited, registers);
+
+	/* A register shared by several features is counted once */
+	g_hash_table_remove_all (visited);
+
+	for (i = 0; i < registers->len; i++) {
+		guint64 node_hits, node_misses, node_errors;
+
+		if (!g_hash_table_add (visited, g_ptr_array_index (registers, i)))
+			continue;
+
+		arv_gc_register_node_get_cache_statistics (g_ptr_array_index (registers, i),
+							   &node_hits, &node_misses, &node_errors);
+		hits += node_hits;
+		misses += node_misses;
+		errors += node_errors;
+	}
+
+	g_ptr_array_unref (registers);
+	g_hash_table_unref (visited);
+
+	if (n_hits != NULL)
+		*n_hits = hits;
+	if (n_misses != NULL)
+		*n_misses = misses;
+	if (n_errors != NULL)
+		*n_errors = errors;
+
+	return TRUE;
+}
+
+/* Allows the nodes to cache what they derive from the register cache policies. Never 0. */
+
+guint
+arv_gc_get_cache_policy_epoch (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
+
+	return g_atomic_int_get (&genicam->priv->cache_policy_epoch);
+}
+
+void
+arv_gc_set_range_check_policy (ArvGc *genicam, ArvRangeCheckPolicy policy)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	genicam->priv->range_check_policy = policy;
+}
+
+ArvRangeCheckPolicy
+arv_gc_get_range_check_policy (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_RANGE_CHECK_POLICY_DISABLE);
+
+	return genicam->priv->range_check_policy;
+}
+
+void
+arv_gc_set_access_check_policy (ArvGc *genicam, ArvAccessCheckPolicy policy)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	genicam->priv->access_check_policy = policy;
+}
+
+ArvAccessCheckPolicy
+arv_gc_get_access_check_policy (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_ACCESS_CHECK_POLICY_DISABLE);
+
+	return genicam->priv->access_check_policy;
+}
+
+/**
+ * arv_gc_set_struct_entry_snapshot_lifetime:
+ * @genicam: a #ArvGc object
+ * @lifetime_us: snapshot lifetime, in µs, 0 to disable
+ *
+ * Coalesces the reads of the StructEntry nodes sharing a StructReg. The read of an entry keeps a snapshot of the
+ * register content, which serves the subsequent reads of its sibling entries during @lifetime_us, each entry
+ * being served once. The snapshot is dropped on any write to the register, or on its invalidation. This
+ * divides the device accesses by the number of entries when polling a packed status register with the register
+ * cache disabled.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_set_struct_entry_snapshot_lifetime (ArvGc *genicam, gint64 lifetime_us)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	genicam->priv->struct_entry_snapshot_lifetime_us = MAX (lifetime_us, 0);
+}
+
+/**
+ * arv_gc_get_struct_entry_snapshot_lifetime:
+ * @genicam: a #ArvGc object
+ *
+ * Returns: the StructEntry snapshot lifetime, in µs, 0 if the reads are not coalesced.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_gc_get_struct_entry_snapshot_lifetime (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
+
+	return genicam->priv->struct_entry_snapshot_lifetime_us;
+}
+
+/**
+ * arv_gc_set_shadow_memory_enable:
+ * @genicam: a #ArvGc object
+ * @enable: %TRUE to enable the shadow memory
+ *
+ * Makes the register nodes of the device port read through a shared, sparse copy of the device memory, instead of
+ * their own register caches. Overlapping registers then share their cached content, and a whole region can be
+ * cached in a single memory read, using arv_gc_prefetch_memory(). The shadow memory is filled by the register reads
+ * and the write-through register writes, and invalidated by the register invalidations.
+ *
+ * Only the registers with a constant address and length are shadowed, and only when the register cache is enabled,
+ * see arv_gc_set_register_cache_policy(). Disabling the shadow memory drops its content, and all the register cache
+ * contents.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_set_shadow_memory_enable (ArvGc *genicam, gboolean enable)
+{
+	gboolean was_enabled;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	if (enable && g_atomic_pointer_get (&genicam->priv->shadow_memory) == NULL) {
+		ArvShadowMemory *shadow_memory = arv_shadow_memory_new ();
+
+		if (!g_atomic_pointer_compare_and_exchange (&genicam->priv->shadow_memory, NULL, shadow_memory))
+			arv_shadow_memory_free (shadow_memory);
+	}
+
+	was_enabled = g_atomic_int_get (&genicam->priv->is_shadow_memory_enabled);
+	g_atomic_int_set (&genicam->priv->is_shadow_memory_enabled, enable ? 1 : 0);
+
+	/* The register caches were bypassed by the shadowed registers, and may be stale */
+	if (was_enabled && !enable)
+		arv_gc_invalidate_register_caches (genicam);
+}
+
+/**
+ * arv_gc_get_shadow_memory_enable:
+ * @genicam: a #ArvGc object
+ *
+ * Returns: %TRUE if the registers are read through the shadow memory.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_get_shadow_memory_enable (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	return g_atomic_int_get (&genicam->priv->is_shadow_memory_enabled);
+}
+
+/* Shadow memory used by the register nodes, NULL if disabled */
+
+ArvShadowMemory *
+arv_gc_get_shadow_memory (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	if (!g_atomic_int_get (&genicam->priv->is_shadow_memory_enabled))
+		return NULL;
+
+	return g_atomic_pointer_get (&genicam->priv->shadow_memory);
+}
+
+/**
+ * arv_gc_prefetch_memory:
+ * @genicam: a #ArvGc object
+ * @address: start of the device memory region
+ * @length: region length, in bytes
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Fills the shadow memory with a region of the device memory, like the bootstrap registers or the registers of a
+ * group of features, in a single memory read. The reads of the registers inside the region are then served from the
+ * shadow memory, until they are invalidated.
+ *
+ * This function does nothing if the shadow memory or the register cache is disabled, or during a transaction, which
+ * keeps the pending writes in the register caches. See arv_gc_set_shadow_memory_enable().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_prefetch_memory (ArvGc *genicam, guint64 address, guint32 length, GError **error)
+{
+	ArvShadowMemory *shadow_memory;
+	gboolean is_in_transaction;
+	void *data;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	shadow_memory = arv_gc_get_shadow_memory (genicam);
+	if (shadow_memory == NULL ||
+	    arv_gc_get_register_cache_policy (genicam) == ARV_REGISTER_CACHE_POLICY_DISABLE ||
+	    length == 0)
+		return TRUE;
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+	is_in_transaction = genicam->priv->transaction_depth > 0;
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+
+	if (is_in_transaction) {
+		arv_debug_genicam ("[Gc::prefetch_memory] Ignored during a transaction");
+		return TRUE;
+	}
+
+	if (!ARV_IS_DEVICE (genicam->priv->device)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET, "No device set for memory prefetch");
+		return FALSE;
+	}
+
+	data = g_malloc (length);
+	success = arv_device_read_memory (genicam->priv->device, address, length, data, error);
+	if (success) {
+		GHashTableIter iter;
+		GPtrArray *registers;
+		gpointer value;
+		guint i;
+
+		/* The registers inside the region may change, their dependents must drop the values computed from
+		 * them. This also invalidates the region in the shadow memory, before its update. */
+		registers = g_ptr_array_new_with_free_func (g_object_unref);
+
+		g_rw_lock_reader_lock (&genicam->priv->nodes_lock);
+		g_hash_table_iter_init (&iter, genicam->priv->nodes);
+		while (g_hash_table_iter_next (&iter, NULL, &value))
+			if (ARV_IS_GC_REGISTER_NODE (value))
+				g_ptr_array_add (registers, g_object_ref (value));
+		g_rw_lock_reader_unlock (&genicam->priv->nodes_lock);
+
+		for (i = 0; i < registers->len; i++) {
+			gint64 register_address;
+			gint64 register_length;
+
+			if (arv_gc_register_node_get_static_layout (g_ptr_array_index (registers, i),
+								    &register_address, &register_length) &&
+			    register_address < (gint64) (address + length) &&
+			    register_address + register_length > (gint64) address)
+				arv_gc_feature_node_increment_change_count (g_ptr_array_index (registers, i));
+		}
+
+		g_ptr_array_unref (registers);
+
+		arv_shadow_memory_write (shadow_memory, address, length, data);
+	}
+	g_free (data);
+
+	arv_debug_genicam ("[Gc::prefetch_memory] %u bytes read at 0x%08" G_GINT64_MODIFIER "x", length, address);
+
+	return success;
+}
+
+static void
+_weak_notify_cb (gpointer data, GObject *object)
+{
+	ArvGc *genicam = data;
+
+	genicam->priv->buffer = NULL;
+}
+
+void
+arv_gc_set_buffer (ArvGc *genicam, ArvBuffer *buffer)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (genicam->priv->buffer != NULL)
+		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+
+	g_object_weak_ref (G_OBJECT (buffer), _weak_notify_cb, genicam);
+
+	genicam->priv->buffer = buffer;
+}
+
+/**
+ * arv_gc_get_buffer:
+ * @genicam: a #ArvGc object
+ *
+ * Retrieves the binded buffer.
+ *
+ * Return value: (transfer none): a #ArvBuffer.
+ */
+
+ArvBuffer *
+arv_gc_get_buffer (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return genicam->priv->buffer;
+}
+
+/**
+ * arv_gc_begin_transaction:
+ * @genicam: a #ArvGc object
+ *
+ * Starts a feature transaction. Until the matching call to arv_gc_commit_transaction(), the device register
+ * writes are not sent to the device, but queued in write order. A write to the same register as the previous
+ * queued write, or to the address immediately following it, is merged with it. Reads of the queued registers
+ * return the queued content, which keeps the masked register read-modify-write sequences correct.
+ *
+ * Transactions can be nested, only the outermost commit flushes the queued writes.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_begin_transaction (ArvGc *genicam)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+
+	if (genicam->priv->transaction_depth == 0)
+		genicam->priv->pending_writes =
+			g_ptr_array_new_with_free_func ((GDestroyNotify) arv_gc_pending_write_free);
+	genicam->priv->transaction_depth++;
+
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+}
+
+/* Drops the cached register values, which may not reflect the device state after a failed commit or a
+ * reconnection */
+
+void
+arv_gc_invalidate_register_caches (ArvGc *genicam)
+{
+	GHashTableIter iter;
+	GPtrArray *registers;
+	gpointer value;
+	guint i;
+
+	registers = g_ptr_array_new_with_free_func (g_object_unref);
+
+	g_rw_lock_reader_lock (&genicam->priv->nodes_lock);
+	g_hash_table_iter_init (&iter, genicam->priv->nodes);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		if (ARV_IS_GC_REGISTER_NODE (value))
+			g_ptr_array_add (registers, g_object_ref (value));
+	g_rw_lock_reader_unlock (&genicam->priv->nodes_lock);
+
+	for (i = 0; i < registers->len; i++)
+		arv_gc_feature_node_increment_change_count (g_ptr_array_index (registers, i));
+
+	g_ptr_array_unref (registers);
+
+	if (genicam->priv->shadow_memory != NULL)
+		arv_shadow_memory_clear (genicam->priv->shadow_memory);
+}
+
+static gboolean
+_flush_pending_writes (ArvGc *genicam, GPtrArray *pending_writes, GError **error)
+{
+	ArvDevice *device = genicam->priv->device;
+	GArray *addresses;
+	GArray *values;
+	gboolean success = TRUE;
+	guint n_transactions = 0;
+	guint i;
+
+	if (!ARV_IS_DEVICE (device)) {
+		if (pending_writes->len > 0) {
+			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET, "No device set");
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	addresses = g_array_new (FALSE, FALSE, sizeof (guint64));
+	values = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+	for (i = 0; i < pending_writes->len && success; ) {
+		ArvGcPendingWrite *pending_write = g_ptr_array_index (pending_writes, i);
+
+		/* GigEVision registers are big endian, like the memory content, and consecutive 4 bytes writes
+		 * are sent in batches of register writes */
+		if (ARV_IS_GV_DEVICE (device) && pending_write->data->len == sizeof (guint32)) {
+			g_array_set_size (addresses, 0);
+			g_array_set_size (values, 0);
+
+			for (; i < pending_writes->len; i++) {
+				ArvGcPendingWrite *next = g_ptr_array_index (pending_writes, i);
+				guint32 value;
+
+				if (next->data->len != sizeof (guint32))
+					break;
+
+				memcpy (&value, next->data->data, sizeof (guint32));
+				value = GUINT32_FROM_BE (value);
+
+				g_array_append_val (addresses, next->address);
+				g_array_append_val (values, value);
+			}
+
+			success = arv_device_write_registers (device, addresses->len, (guint64 *) addresses->data,
+							      (guint32 *) values->data, error);
+		} else {
+			success = arv_device_write_memory (device, pending_write->address, pending_write->data->len,
+							   pending_write->data->data, error);
+			i++;
+		}
+
+		n_transactions++;
+	}
+
+	arv_debug_genicam ("[Gc::commit_transaction] %u write(s) flushed in %u transaction(s)",
+			   pending_writes->len, n_transactions);
+
+	g_array_unref (addresses);
+	g_array_unref (values);
+
+	return success;
+}
+
+/**
+ * arv_gc_commit_transaction:
+ * @genicam: a #ArvGc object
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Ends the feature transaction started by arv_gc_begin_transaction(). For the outermost transaction, the queued
+ * writes are sent to the device, in order. On GigEVision devices, consecutive 4 bytes writes are sent using
+ * multiple register write commands.
+ *
+ * On error, the remaining queued writes are dropped, and the register cache is invalidated.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_commit_transaction (ArvGc *genicam, GError **error)
+{
+	GPtrArray *pending_writes;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+
+	if (genicam->priv->transaction_depth == 0) {
+		g_mutex_unlock (&genicam->priv->transaction_mutex);
+		arv_warning_genicam ("[Gc::commit_transaction] No transaction in progress");
+		return TRUE;
+	}
+
+	genicam->priv->transaction_depth--;
+	if (genicam->priv->transaction_depth > 0) {
+		g_mutex_unlock (&genicam->priv->transaction_mutex);
+		return TRUE;
+	}
+
+	pending_writes = genicam->priv->pending_writes;
+	genicam->priv->pending_writes = NULL;
+
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+
+	success = _flush_pending_writes (genicam, pending_writes, error);
+	if (!success)
+		arv_gc_invalidate_register_caches (genicam);
+
+	g_ptr_array_unref (pending_writes);
+
+	g_mutex_lock (&genicam->priv->change_mutex);
+	_schedule_feature_changes (genicam);
+	g_mutex_unlock (&genicam->priv->change_mutex);
+
+	return success;
+}
+
+/* Queues a device write if a transaction is in progress, merging it with the previous write when it targets the
+ * same register or the following address. Returns %FALSE if the write must be sent to the device right away. */
+
+gboolean
+arv_gc_defer_write (ArvGc *genicam, ArvGcPort *port, guint64 address, guint64 length, const void *buffer,
+		    gboolean is_register)
+{
+	ArvGcPendingWrite *pending_write = NULL;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+
+	if (genicam->priv->transaction_depth == 0) {
+		g_mutex_unlock (&genicam->priv->transaction_mutex);
+		return FALSE;
+	}
+
+	if (genicam->priv->pending_writes->len > 0)
+		pending_write = g_ptr_array_index (genicam->priv->pending_writes,
+						   genicam->priv->pending_writes->len - 1);
+
+	if (pending_write != NULL && pending_write->port == port &&
+	    address >= pending_write->address &&
+	    address + length <= pending_write->address + pending_write->data->len) {
+		memcpy (pending_write->data->data + (address - pending_write->address), buffer, length);
+	} else if (pending_write != NULL && pending_write->port == port &&
+		   !is_register && !pending_write->is_register &&
+		   address == pending_write->address + pending_write->data->len) {
+		g_byte_array_append (pending_write->data, buffer, length);
+	} else {
+		pending_write = g_new0 (ArvGcPendingWrite, 1);
+		pending_write->port = port;
+		pending_write->address = address;
+		pending_write->data = g_byte_array_sized_new (length);
+		pending_write->is_register = is_register;
+		g_byte_array_append (pending_write->data, buffer, length);
+
+		g_ptr_array_add (genicam->priv->pending_writes, pending_write);
+	}
+
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+
+	return TRUE;
+}
+
+/* Overwrites the read data with the content of the overlapping queued writes */
+
+void
+arv_gc_apply_deferred_writes (ArvGc *genicam, ArvGcPort *port, guint64 address, guint64 length, void *buffer)
+{
+	guint i;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_mutex_lock (&genicam->priv->transaction_mutex);
+
+	for (i = 0; genicam->priv->pending_writes != NULL && i < genicam->priv->pending_writes->len; i++) {
+		ArvGcPendingWrite *pending_write = g_ptr_array_index (genicam->priv->pending_writes, i);
+		guint64 start;
+		guint64 end;
+
+		if (pending_write->port != port)
+			continue;
+
+		start = MAX (address, pending_write->address);
+		end = MIN (address + length, pending_write->address + pending_write->data->len);
+
+		if (start < end)
+			memcpy ((char *) buffer + (start - address),
+				pending_write->data->data + (start - pending_write->address), end - start);
+	}
+
+	g_mutex_unlock (&genicam->priv->transaction_mutex);
+}
+
+/* Device transfers and register cache lookups are attributed to the outermost feature access of the calling thread */
+
+typedef struct {
+	ArvGc *genicam;
+	guint depth;
+	gint64 start_time_us;
+	ArvGcFeatureProfile profile;
+} ArvGcProfileContext;
+
+static GPrivate arv_gc_profile_context = G_PRIVATE_INIT (g_free);
+static gint arv_gc_n_profiling_documents = 0;
+
+guint64
+arv_gc_register_cache_error_add (ArvGc *genicam, guint64 n_errors)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
+
+        return (guint) g_atomic_int_add ((gint *) &genicam->priv->n_register_cache_errors, n_errors) + n_errors;
+}
+
+void
+arv_gc_register_cache_lookup_add (ArvGc *genicam, gboolean is_hit)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	if (is_hit)
+		g_atomic_int_inc ((gint *) &genicam->priv->n_register_cache_hits);
+	else
+		g_atomic_int_inc ((gint *) &genicam->priv->n_register_cache_misses);
+
+	if (g_atomic_int_get (&arv_gc_n_profiling_documents) > 0) {
+		ArvGcProfileContext *context = g_private_get (&arv_gc_profile_context);
+
+		if (context != NULL && context->depth > 0 && context->genicam == genicam) {
+			if (is_hit)
+				context->profile.n_cache_hits++;
+			else
+				context->profile.n_cache_misses++;
+		}
+	}
+}
+
+void
+arv_gc_get_register_cache_statistics (ArvGc *genicam, guint64 *n_hits, guint64 *n_misses, guint64 *n_errors)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	if (n_hits != NULL)
+		*n_hits = (guint) g_atomic_int_get ((gint *) &genicam->priv->n_register_cache_hits);
+	if (n_misses != NULL)
+		*n_misses = (guint) g_atomic_int_get ((gint *) &genicam->priv->n_register_cache_misses);
+	if (n_errors != NULL)
+		*n_errors = (guint) g_atomic_int_get ((gint *) &genicam->priv->n_register_cache_errors);
+}
+
+/**
+ * arv_gc_set_profiling_enable:
+ * @genicam: a #ArvGc object
+ * @enable: %TRUE to enable the profiling of the feature accesses
+ *
+ * Enables the accounting of the wire cost of the feature accesses. For each outermost access to a feature value,
+ * bounds, or command, that is not counting the accesses to the nodes it depends on, like the ones behind a
+ * SwissKnife or a converter, the number of device reads and writes, the transferred bytes, the register cache hits
+ * and misses, and the wall time are accumulated in a per feature profile, retrieved using
+ * arv_gc_get_feature_profile() or arv_gc_dup_profile_report(). The writes deferred by a transaction are accounted to
+ * no feature, as they reach the device on the commit.
+ *
+ * Disabling the profiling keeps the collected profiles, see arv_gc_reset_profile().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_set_profiling_enable (ArvGc *genicam, gboolean enable)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_mutex_lock (&genicam->priv->profile_mutex);
+	if (genicam->priv->is_profiling_enabled != (enable ? 1 : 0)) {
+		g_atomic_int_add (&arv_gc_n_profiling_documents, enable ? 1 : -1);
+		g_atomic_int_set (&genicam->priv->is_profiling_enabled, enable ? 1 : 0);
+	}
+	g_mutex_unlock (&genicam->priv->profile_mutex);
+}
+
+/**
+ * arv_gc_get_profiling_enable:
+ * @genicam: a #ArvGc object
+ *
+ * Returns: %TRUE if the feature accesses are profiled.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_get_profiling_enable (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	return g_atomic_int_get (&genicam->priv->is_profiling_enabled);
+}
+
+/**
+ * arv_gc_reset_profile:
+ * @genicam: a #ArvGc object
+ *
+ * Drops the collected feature profiles.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gc_reset_profile (ArvGc *genicam)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_mutex_lock (&genicam->priv->profile_mutex);
+	g_hash_table_remove_all (genicam->priv->profiles);
+	g_mutex_unlock (&genicam->priv->profile_mutex);
+}
+
+/**
+ * arv_gc_get_feature_profile:
+ * @genicam: a #ArvGc object
+ * @feature: a feature name
+ * @profile: (out caller-allocates): the profile of @feature
+ *
+ * Retrieves the accumulated cost of the accesses to @feature, see arv_gc_set_profiling_enable().
+ *
+ * Returns: %TRUE if @feature was accessed while the profiling was enabled.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gc_get_feature_profile (ArvGc *genicam, const char *feature, ArvGcFeatureProfile *profile)
+{
+	ArvGcFeatureProfile *entry;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+	g_return_val_if_fail (profile != NULL, FALSE);
+
+	g_mutex_lock (&genicam->priv->profile_mutex);
+	entry = g_hash_table_lookup (genicam->priv->profiles, feature);
+	if (entry != NULL)
+		*profile = *entry;
+	g_mutex_unlock (&genicam->priv->profile_mutex);
+
+	if (entry == NULL)
+		memset (profile, 0, sizeof (ArvGcFeatureProfile));
+
+	return entry != NULL;
+}
+
+static int
+_compare_profiles (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	GHashTable *profiles = user_data;
+	const char *name_a = *((const char **) a);
+	const char *name_b = *((const char **) b);
+	ArvGcFeatureProfile *profile_a = g_hash_table_lookup (profiles, name_a);
+	ArvGcFeatureProfile *profile_b = g_hash_table_lookup (profiles, name_b);
+
+	if (profile_a->total_time_us != profile_b->total_time_us)
+		return profile_a->total_time_us < profile_b->total_time_us ? 1 : -1;
+
+	return g_strcmp0 (name_a, name_b);
+}
+
+static char **
+_dup_profiled_features (ArvGc *genicam, guint *n_features)
+{
+	GPtrArray *names;
+	GHashTableIter iter;
+	gpointer key;
+
+	names = g_ptr_array_new ();
+	g_hash_table_iter_init (&iter, genicam->priv->profiles);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+		g_ptr_array_add (names, g_strdup (key));
+	g_ptr_array_sort_with_data (names, _compare_profiles, genicam->priv->profiles);
+
+	if (n_features != NULL)
+		*n_features = names->len;
+
+	g_ptr_array_add (names, NULL);
+
+	return (char **) g_ptr_array_free (names, FALSE);
+}
+
+/**
+ * arv_gc_dup_profiled_features:
+ * @genicam: a #ArvGc object
+ * @n_features: (out) (optional): the number of profiled features
+ *
+ * Returns: (transfer full) (array zero-terminated=1): the names of the features accessed while the profiling was
+ * enabled, the most time consuming first. It should be freed using g_strfreev().
+ *
+ * Since: 0.8.24
+ */
+
+char **
+arv_gc_dup_profiled_features (ArvGc *genicam, guint *n_features)
+{
+	char **names;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	g_mutex_lock (&genicam->priv->profile_mutex);
+	names = _dup_profiled_features (genicam, n_features);
+	g_mutex_unlock (&genicam->priv->profile_mutex);
+
+	return names;
+}
+
+/**
+ * arv_gc_dup_profile_report:
+ * @genicam: a #ArvGc object
+ *
+ * Formats the collected feature profiles as a table, one feature per line, the most time consuming first, followed by
+ * the totals.
+ *
+ * Returns: (transfer full): the profile report, to be freed using g_free().
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_gc_dup_profile_report (ArvGc *genicam)
+{
+	ArvGcFeatureProfile total = {0};
+	GString *report;
+	char **names;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	report = g_string_new (NULL);
+	g_string_append_printf (report, "%-40s %8s %8s %8s %10s %8s %8s %12s %10s\n",
+				"Feature", "Calls", "Reads", "Writes", "Bytes", "Hits", "Misses", "Time (us)", "Max (us)");
+
+	g_mutex_lock (&genicam->priv->profile_mutex);
+
+	names = _dup_profiled_features (genicam, NULL);
+	for (i = 0; names[i] != NULL; i++) {
+		ArvGcFeatureProfile *profile = g_hash_table_lookup (genicam->priv->profiles, names[i]);
+
+		g_string_append_printf (report,
+					"%-40s %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT
+					" %10" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT
+					" %12" G_GINT64_FORMAT " %10" G_GINT64_FORMAT "\n",
+					names[i], profile->n_accesses, profile->n_reads, profile->n_writes,
+					profile->n_read_bytes + profile->n_written_bytes,
+					profile->n_cache_hits, profile->n_cache_misses,
+					profile->total_time_us, profile->max_time_us);
+
+		total.n_accesses += profile->n_accesses;
+		total.n_reads += profile->n_reads;
+		total.n_writes += profile->n_writes;
+		total.n_read_bytes += profile->n_read_bytes;
+		total.n_written_bytes += profile->n_written_bytes;
+		total.n_cache_hits += profile->n_cache_hits;
+		total.n_cache_misses += profile->n_cache_misses;
+		total.total_time_us += profile->total_time_us;
+		total.max_time_us = MAX (total.max_time_us, profile->max_time_us);
+	}
+
+	g_mutex_unlock (&genicam->priv->profile_mutex);
+
+	g_string_append_printf (report,
+				"%-40s %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT
+				" %10" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT
+				" %12" G_GINT64_FORMAT " %10" G_GINT64_FORMAT "\n",
+				"Total", total.n_accesses, total.n_reads, total.n_writes,
+				total.n_read_bytes + total.n_written_bytes,
+				total.n_cache_hits, total.n_cache_misses,
+				total.total_time_us, total.max_time_us);
+
+	g_strfreev (names);
+
+	return g_string_free (report, FALSE);
+}
+
+/* Called around the public accessors of the feature interfaces. Only the outermost access of a thread is profiled,
+ * the nested ones adding their costs to it. */
+
+void
+arv_gc_profile_enter (ArvGcFeatureNode *node)
+{
+	ArvGcProfileContext *context;
+	ArvGc *genicam;
+
+	context = g_private_get (&arv_gc_profile_context);
+	if (context != NULL && context->depth > 0) {
+		context->depth++;
+		return;
+	}
+
+	if (g_atomic_int_get (&arv_gc_n_profiling_documents) == 0)
+		return;
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (node));
+	if (!ARV_IS_GC (genicam) || !g_atomic_int_get (&genicam->priv->is_profiling_enabled))
+		return;
+
+	if (context == NULL) {
+		context = g_new0 (ArvGcProfileContext, 1);
+		g_private_set (&arv_gc_profile_context, context);
+	}
+
+	memset (&context->profile, 0, sizeof (ArvGcFeatureProfile));
+	context->genicam = genicam;
+	context->depth = 1;
+	context->start_time_us = g_get_monotonic_time ();
+}
+
+void
+arv_gc_profile_leave (ArvGcFeatureNode *node)
+{
+	ArvGcProfileContext *context;
+	ArvGcFeatureProfile *profile;
+	const char *name;
+	gint64 time_us;
+
+	context = g_private_get (&arv_gc_profile_context);
+	if (context == NULL || context->depth == 0)
+		return;
+
+	context->depth--;
+	if (context->depth > 0)
+		return;
+
+	time_us = g_get_monotonic_time () - context->start_time_us;
+	name = arv_gc_feature_node_get_name (node);
+	if (name == NULL)
+		return;
+
+	g_mutex_lock (&context->genicam->priv->profile_mutex);
+
+	profile = g_hash_table_lookup (context->genicam->priv->profiles, name);
+	if (profile == NULL) {
+		profile = g_new0 (ArvGcFeatureProfile, 1);
+		g_hash_table_insert (context->genicam->priv->profiles, g_strdup (name), profile);
+	}
+
+	profile->n_accesses++;
+	profile->n_reads += context->profile.n_reads;
+	profile->n_writes += context->profile.n_writes;
+	profile->n_read_bytes += context->profile.n_read_bytes;
+	profile->n_written_bytes += context->profile.n_written_bytes;
+	profile->n_cache_hits += context->profile.n_cache_hits;
+	profile->n_cache_misses += context->profile.n_cache_misses;
+	profile->total_time_us += time_us;
+	profile->max_time_us = MAX (profile->max_time_us, time_us);
+
+	g_mutex_unlock (&context->genicam->priv->profile_mutex);
+}
+
+/* Device transfers of the ports, @n_transfers being larger than one for the batched register reads */
+
+void
+arv_gc_profile_count_transfer (ArvGc *genicam, gboolean is_write, guint n_transfers, guint64 n_bytes)
+{
+	ArvGcProfileContext *context;
+
+	if (g_atomic_int_get (&arv_gc_n_profiling_documents) == 0)
+		return;
+
+	context = g_private_get (&arv_gc_profile_context);
+	if (context == NULL || context->depth == 0 || context->genicam != genicam)
+		return;
+
+	if (is_write) {
+		context->profile.n_writes += n_transfers;
+		context->profile.n_written_bytes += n_bytes;
+	} else {
+		context->profile.n_reads += n_transfers;
+		context->profile.n_read_bytes += n_bytes;
+	}
+}
+
+static gint arv_gc_lazy_loading = FALSE;
+
+/**
+ * arv_set_genicam_lazy_loading:
+ * @enable: %TRUE to enable the lazy loading of the Genicam feature nodes
+ *
+ * When the lazy loading is enabled, the documents created by arv_gc_new() only keep a compact compiled form of the
+ * feature definitions, and instantiate the feature nodes on their first retrieval by arv_gc_get_node(). This
+ * saves a lot of memory for the applications which access a small part of the device features.
+ *
+ * A side effect is that a traversal of the document using the #ArvDomNode API only finds the already
+ * instantiated nodes.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_set_genicam_lazy_loading (gboolean enable)
+{
+	g_atomic_int_set (&arv_gc_lazy_loading, enable ? TRUE : FALSE);
+}
+
+/**
+ * arv_get_genicam_lazy_loading:
+ *
+ * Returns: %TRUE if the Genicam feature node lazy loading is enabled.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_get_genicam_lazy_loading (void)
+{
+	return g_atomic_int_get (&arv_gc_lazy_loading);
+}
+
+static gint arv_gc_trusted_loading = FALSE;
+
+/**
+ * arv_set_genicam_trusted_loading:
+ * @enable: %TRUE to enable the trusted loading of the Genicam data
+ *
+ * When the trusted loading is enabled, the Genicam data found in the on-disk cache, see
+ * arv_set_genicam_cache_directory(), are considered valid, as they were stored after a successful download. Their
+ * compiled form is then retrieved using the device identification, which includes the device version, without a
+ * checksum computation over the whole data. This shortens the device opening for large Genicam files, at the cost of
+ * the use of stale data if the content of the cache directory is modified by hand.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_set_genicam_trusted_loading (gboolean enable)
+{
+	g_atomic_int_set (&arv_gc_trusted_loading, enable ? TRUE : FALSE);
+}
+
+/**
+ * arv_get_genicam_trusted_loading:
+ *
+ * Returns: %TRUE if the trusted loading of the cached Genicam data is enabled.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_get_genicam_trusted_loading (void)
+{
+	return g_atomic_int_get (&arv_gc_trusted_loading);
+}
+
+/* Defer the instantiation of the named features, which are the direct children of the document element or of a
+ * Group element. */
+
+static gboolean
+_defer_feature_node (ArvDomNode *parent, const char *name, const char **attrs, guint32 offset, gpointer user_data)
+{
+	GHashTable *deferred_nodes = user_data;
+	ArvGcDeferredNode *deferred_node;
+	const char *node_name = NULL;
+	unsigned int i;
+
+	if (!ARV_IS_GC_REGISTER_DESCRIPTION_NODE (parent) && !ARV_IS_GC_GROUP_NODE (parent))
+		return FALSE;
+
+	for (i = 0; attrs[i] != NULL && attrs[i + 1] != NULL; i += 2)
+		if (strcmp (attrs[i], "Name") == 0)
+			node_name = attrs[i + 1];
+
+	if (node_name == NULL)
+		return FALSE;
+
+	deferred_node = g_new (ArvGcDeferredNode, 1);
+	deferred_node->parent = parent;
+	deferred_node->offset = offset;
+
+	g_hash_table_insert (deferred_nodes, (char *) node_name, deferred_node);
+
+	return TRUE;
+}
+
+/* In-process cache of the compiled documents, keyed by the checksum of the Genicam data. It allows several devices
+ * of the same model to share the result of a single parsing. A template is marked as pending while its owner
+ * parses the Genicam data, the concurrent lookups of the same key waiting for the result. */
+
+typedef struct {
+	GBytes *compiled;
+	gboolean is_pending;
+} ArvGcTemplate;
+
+static GMutex arv_gc_template_mutex;
+static GCond arv_gc_template_cond;
+static GHashTable *arv_gc_templates = NULL;
+
+static void
+arv_gc_template_free (ArvGcTemplate *entry)
+{
+	g_clear_pointer (&entry->compiled, g_bytes_unref);
+	g_free (entry);
+}
+
+/* Returns the compiled document for @key if available. Otherwise, @is_owner is set to %TRUE, and the caller must
+ * call _publish_template() once the document is parsed, or if the parsing failed. */
+
+static GBytes *
+_acquire_template (const char *key, gboolean *is_owner)
+{
+	ArvGcTemplate *entry;
+	GBytes *compiled = NULL;
+
+	*is_owner = FALSE;
+
+	g_mutex_lock (&arv_gc_template_mutex);
+
+	if (arv_gc_templates == NULL)
+		arv_gc_templates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+							  (GDestroyNotify) arv_gc_template_free);
+
+	do {
+		entry = g_hash_table_lookup (arv_gc_templates, key);
+		if (entry == NULL) {
+			entry = g_new0 (ArvGcTemplate, 1);
+			entry->is_pending = TRUE;
+			g_hash_table_insert (arv_gc_templates, g_strdup (key), entry);
+			*is_owner = TRUE;
+		} else if (entry->is_pending)
+			g_cond_wait (&arv_gc_template_cond, &arv_gc_template_mutex);
+		else
+			compiled = g_bytes_ref (entry->compiled);
+	} while (compiled == NULL && !*is_owner);
+
+	g_mutex_unlock (&arv_gc_template_mutex);
+
+	return compiled;
+}
+
+/* A %NULL @compiled drops a pending entry, letting one of the waiting callers parse the data */
+
+static void
+_publish_template (const char *key, GBytes *compiled)
+{
+	ArvGcTemplate *entry;
+
+	g_mutex_lock (&arv_gc_template_mutex);
+
+	if (arv_gc_templates == NULL)
+		arv_gc_templates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+							  (GDestroyNotify) arv_gc_template_free);
+
+	entry = g_hash_table_lookup (arv_gc_templates, key);
+
+	if (compiled != NULL) {
+		if (entry == NULL) {
+			entry = g_new0 (ArvGcTemplate, 1);
+			g_hash_table_insert (arv_gc_templates, g_strdup (key), entry);
+		}
+		if (entry->compiled == NULL)
+			entry->compiled = g_bytes_ref (compiled);
+		entry->is_pending = FALSE;
+	} else if (entry != NULL && entry->is_pending)
+		g_hash_table_remove (arv_gc_templates, key);
+
+	g_cond_broadcast (&arv_gc_template_cond);
+
+	g_mutex_unlock (&arv_gc_template_mutex);
+}
+
+/* Releases the templates, called by arv_shutdown() */
+
+void
+arv_gc_template_cache_cleanup (void)
+{
+	g_mutex_lock (&arv_gc_template_mutex);
+
+	g_clear_pointer (&arv_gc_templates, g_hash_table_unref);
+
+	g_mutex_unlock (&arv_gc_template_mutex);
+}
+
+static ArvDomDocument *
+_new_lazy_document (GBytes *bytes)
+{
+	ArvDomDocument *document = NULL;
+	ArvDomCompiled *compiled = NULL;
+	GHashTable *deferred_nodes;
+
+	compiled = arv_dom_compiled_new (bytes, NULL);
+	if (compiled == NULL)
+		return NULL;
+
+	/* The hash table keys point to the compiled data strings */
+	deferred_nodes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+	document = arv_dom_compiled_new_document (compiled, _defer_feature_node, deferred_nodes, NULL);
+	if (!ARV_IS_GC (document)) {
+		g_clear_object (&document);
+		g_hash_table_unref (deferred_nodes);
+		arv_dom_compiled_free (compiled);
+		return NULL;
+	}
+
+	arv_info_genicam ("[Gc::new] %u deferred feature nodes", g_hash_table_size (deferred_nodes));
+
+	ARV_GC (document)->priv->compiled = compiled;
+	ARV_GC (document)->priv->deferred_nodes = deferred_nodes;
+
+	return document;
+}
+
+static ArvDomDocument *
+_new_document_from_compiled (GBytes *compiled)
+{
+	ArvDomDocument *document;
+
+	if (arv_get_genicam_lazy_loading ())
+		document = _new_lazy_document (compiled);
+	else
+		document = arv_dom_document_new_from_compiled (compiled, NULL);
+
+	if (document != NULL && !ARV_IS_GC (document))
+		g_clear_object (&document);
+
+	return document;
+}
+
+/**
+ * arv_gc_new:
+ * @device: (allow-none): the device the Genicam data belongs to
+ * @xml: the Genicam xml data
+ * @size: size of @xml, in bytes
+ *
+ * Builds the Genicam document described by @xml. The compiled form of the document is kept in an in-process cache,
+ * keyed by the checksum of @xml, which allows the next devices using the same Genicam data to skip the xml parsing.
+ * Only the document structure is shared, each device having its own feature nodes and register caches. Concurrent
+ * calls with the same data parse it only once.
+ *
+ * Returns: (transfer full): a new #ArvGc, %NULL on error
+ */
+
+static ArvGc *
+_new_gc (ArvDevice *device, const void *xml, size_t size, const char *key)
+{
+	ArvDomDocument *document = NULL;
+	ArvGc *genicam;
+	GBytes *compiled = NULL;
+	gboolean is_owner;
+
+	compiled = _acquire_template (key, &is_owner);
+	if (compiled != NULL) {
+		arv_info_genicam ("[Gc::new] Use the genicam data already parsed for another device");
+		document = _new_document_from_compiled (compiled);
+	} else if (arv_genicam_cache_is_enabled ()) {
+		compiled = arv_genicam_cache_load_compiled (key);
+		if (compiled != NULL) {
+			document = _new_document_from_compiled (compiled);
+			if (document == NULL)
+				arv_warning_genicam ("[Gc::new] Invalid compiled genicam data in cache");
+		}
+	}
+
+	if (document == NULL) {
+		g_clear_pointer (&compiled, g_bytes_unref);
+
+		if (arv_get_genicam_lazy_loading ()) {
+			compiled = arv_dom_compile_from_memory (xml, size, NULL);
+			if (compiled != NULL)
+				document = _new_document_from_compiled (compiled);
+		} else
+			document = arv_dom_document_new_from_memory_full (xml, size, &compiled, NULL);
+
+		if (compiled != NULL && ARV_IS_GC (document) && arv_genicam_cache_is_enabled ())
+			arv_genicam_cache_store_compiled (key, compiled);
+	}
+
+	if (is_owner)
+		_publish_template (key, ARV_IS_GC (document) ? compiled : NULL);
+
+	g_clear_pointer (&compiled, g_bytes_unref);
+
+	if (!ARV_IS_GC (document)) {
+		if (document != NULL)
+			g_object_unref (document);
+		return NULL;
+	}
+
+	genicam = ARV_GC (document);
+	genicam->priv->device = device;
+
+	return genicam;
+}
+
+ArvGc *
+arv_gc_new (ArvDevice *device, const void *xml, size_t size)
+{
+	ArvGc *genicam;
+	char *key;
+
+	key = g_compute_checksum_for_data (G_CHECKSUM_SHA1, xml, size);
+	genicam = _new_gc (device, xml, size, key);
+	g_free (key);
+
+	return genicam;
+}
+
+/* Same as arv_gc_new(), for Genicam data already known to be valid, like the data of the on-disk cache, which were
+ * stored after a successful download. The compiled document is looked up using @key instead of the checksum of
+ * @xml, which saves a pass over the whole data. The trust is in @key: it has to change with the content of @xml,
+ * the compiled form found under @key being used without any check against @xml. */
+
+ArvGc *
+arv_gc_new_trusted (ArvDevice *device, const void *xml, size_t size, const char *key)
+{
+	g_return_val_if_fail (key != NULL, NULL);
+
+	arv_info_genicam ("[Gc::new_trusted] Trusted genicam data, key = %s", key);
+
+	return _new_gc (device, xml, size, key);
+}
+
+/* Same as arv_gc_new(), for a document already parsed from @xml, for example while it was downloaded. Takes
+ * ownership of @document. @compiled is the compiled form of @document, made available to the next devices using
+ * the same genicam data, and stored in the genicam cache if enabled. */
+
+ArvGc *
+arv_gc_new_from_document (ArvDevice *device, ArvDomDocument *document, const void *xml, size_t size,
+			  GBytes *compiled)
+{
+	ArvGc *genicam;
+
+	if (!ARV_IS_GC (document)) {
+		g_clear_object (&document);
+		return NULL;
+	}
+
+	if (compiled != NULL) {
+		char *key;
+
+		key = g_compute_checksum_for_data (G_CHECKSUM_SHA1, xml, size);
+		_publish_template (key, compiled);
+		if (arv_genicam_cache_is_enabled ())
+			arv_genicam_cache_store_compiled (key, compiled);
+		g_free (key);
+	}
+
+	genicam = ARV_GC (document);
+	genicam->priv->device = device;
+
+	return genicam;
+}
+
+G_DEFINE_TYPE_WITH_CODE (ArvGc, arv_gc, ARV_TYPE_DOM_DOCUMENT, G_ADD_PRIVATE (ArvGc))
+
+static void
+arv_gc_init (ArvGc *genicam)
+{
+	genicam->priv = arv_gc_get_instance_private (genicam);
+
+	genicam->priv->nodes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
+	g_rw_lock_init (&genicam->priv->nodes_lock);
+	g_rec_mutex_init (&genicam->priv->deferred_mutex);
+	g_mutex_init (&genicam->priv->transaction_mutex);
+	genicam->priv->cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
+	genicam->priv->cache_policy_epoch = 1;
+	g_mutex_init (&genicam->priv->feature_index_mutex);
+	genicam->priv->feature_indexes = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+								(GDestroyNotify) g_array_unref);
+	g_mutex_init (&genicam->priv->change_mutex);
+	genicam->priv->changed_features = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_mutex_init (&genicam->priv->poll_mutex);
+	g_cond_init (&genicam->priv->poll_cond);
+	g_mutex_init (&genicam->priv->profile_mutex);
+	genicam->priv->profiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+static void
+arv_gc_finalize (GObject *object)
+{
+	ArvGc *genicam = ARV_GC (object);
+
+	arv_gc_stop_polling (genicam);
+	g_mutex_clear (&genicam->priv->poll_mutex);
+	g_cond_clear (&genicam->priv->poll_cond);
+
+	if (genicam->priv->buffer != NULL)
+		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+
+	g_hash_table_unref (genicam->priv->nodes);
+	g_clear_pointer (&genicam->priv->deferred_nodes, g_hash_table_unref);
+	g_clear_pointer (&genicam->priv->compiled, arv_dom_compiled_free);
+	g_rw_lock_clear (&genicam->priv->nodes_lock);
+	g_rec_mutex_clear (&genicam->priv->deferred_mutex);
+	g_clear_pointer (&genicam->priv->pending_writes, g_ptr_array_unref);
+	g_mutex_clear (&genicam->priv->transaction_mutex);
+	g_hash_table_unref (genicam->priv->feature_indexes);
+	g_mutex_clear (&genicam->priv->feature_index_mutex);
+	if (genicam->priv->change_source != NULL)
+		g_source_destroy (genicam->priv->change_source);
+	g_clear_pointer (&genicam->priv->change_source, g_source_unref);
+	g_clear_pointer (&genicam->priv->change_context, g_main_context_unref);
+	g_hash_table_unref (genicam->priv->changed_features);
+	g_mutex_clear (&genicam->priv->change_mutex);
+	arv_shadow_memory_free (genicam->priv->shadow_memory);
+	arv_gc_set_profiling_enable (genicam, FALSE);
+	g_hash_table_unref (genicam->priv->profiles);
+	g_mutex_clear (&genicam->priv->profile_mutex);
+
+	G_OBJECT_CLASS (arv_gc_parent_class)->finalize (object);
+}
+
+static void
+arv_gc_class_init (ArvGcClass *node_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (node_class);
+	ArvDomNodeClass *d_node_class = ARV_DOM_NODE_CLASS (node_class);
+	ArvDomDocumentClass *d_document_class = ARV_DOM_DOCUMENT_CLASS (node_class);
 
 	object_class->finalize = arv_gc_finalize;
 	d_node_class->can_append_child = arv_gc_can_append_child;
 	d_document_class->create_element = arv_gc_create_element;
+
+	/**
+	 * ArvGc::feature-changed:
+	 * @genicam: a #ArvGc
+	 * @feature: the name of the changed feature
+	 *
+	 * Signal the change of a feature watched using arv_gc_watch_feature(). The changes are coalesced, the signal
+	 * being emitted once per changed feature, from the main context that was the thread default one when the
+	 * first feature was watched, at its next iteration, or after the end of the current transaction. The signal
+	 * detail is the feature name, for connecting to "feature-changed::Width" for example.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	arv_gc_signals[ARV_GC_SIGNAL_FEATURE_CHANGED] =
+		g_signal_new ("feature-changed",
+			      G_TYPE_FROM_CLASS (node_class),
+			      G_SIGNAL_RUN_LAST | G_SIGNAL_DETAILED,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 1, G_TYPE_STRING);
 }
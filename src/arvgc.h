@@ -30,6 +30,7 @@
 #include <arvapi.h>
 #include <arvbuffer.h>
 #include <arvdomdocument.h>
+#include <arvgcenums.h>
 
 G_BEGIN_DECLS
 
@@ -59,6 +60,8 @@ typedef enum {
  * @ARV_REGISTER_CACHE_POLICY_DISABLE: disable register caching
  * @ARV_REGISTER_CACHE_POLICY_ENABLE: enable register caching
  * @ARV_REGISTER_CACHE_POLICY_DEBUG: enable register caching, but read the acual register value for comparison
+ * @ARV_REGISTER_CACHE_POLICY_STATIC: only cache the registers that no client can change, which are the read only
+ * registers without polling time, not declared as not cachable (Since 0.8.24)
  * @ARV_REGISTER_CACHE_POLICY_DEFAULT: default cache policy
  *
  * Since: 0.8.0
@@ -68,6 +71,7 @@ typedef enum {
 	ARV_REGISTER_CACHE_POLICY_DISABLE,
 	ARV_REGISTER_CACHE_POLICY_ENABLE,
 	ARV_REGISTER_CACHE_POLICY_DEBUG,
+	ARV_REGISTER_CACHE_POLICY_STATIC,
 	ARV_REGISTER_CACHE_POLICY_DEFAULT = ARV_REGISTER_CACHE_POLICY_DISABLE
 } ArvRegisterCachePolicy;
 
@@ -103,24 +107,123 @@ typedef enum {
 	ARV_ACCESS_CHECK_POLICY_DEFAULT = ARV_ACCESS_CHECK_POLICY_DISABLE
 } ArvAccessCheckPolicy;
 
+/**
+ * ArvGcFeatureIndexEntry:
+ * @name: the feature name
+ * @node: the feature node
+ * @parent: the index of the parent category entry, -1 for the root entry
+ * @level: the depth in the category tree, 0 for the root entry
+ * @is_category: %TRUE if the feature is a category
+ * @is_implemented: %TRUE if the feature is implemented
+ * @is_available: %TRUE if the feature is implemented and available
+ * @access_mode: the actual access mode of the feature, %ARV_GC_ACCESS_MODE_UNDEFINED if not implemented
+ *
+ * Feature entry returned by [method@ArvGc.dup_feature_index].
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	const char *name;
+	ArvGcFeatureNode *node;
+	gint parent;
+	guint level;
+	gboolean is_category;
+	gboolean is_implemented;
+	gboolean is_available;
+	ArvGcAccessMode access_mode;
+} ArvGcFeatureIndexEntry;
+
+/**
+ * ArvGcFeatureProfile:
+ * @n_accesses: the number of accesses to the feature
+ * @n_reads: the number of device reads, a batched register read counting for each register
+ * @n_writes: the number of device writes
+ * @n_read_bytes: the number of bytes read from the device
+ * @n_written_bytes: the number of bytes written to the device
+ * @n_cache_hits: the number of register cache hits
+ * @n_cache_misses: the number of register cache misses
+ * @total_time_us: the total wall time of the accesses, in µs
+ * @max_time_us: the longest access wall time, in µs
+ *
+ * Accumulated cost of the accesses to a feature, returned by [method@ArvGc.get_feature_profile].
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint64 n_accesses;
+	guint64 n_reads;
+	guint64 n_writes;
+	guint64 n_read_bytes;
+	guint64 n_written_bytes;
+	guint64 n_cache_hits;
+	guint64 n_cache_misses;
+	gint64 total_time_us;
+	gint64 max_time_us;
+} ArvGcFeatureProfile;
+
 #define ARV_TYPE_GC             (arv_gc_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvGc, arv_gc, ARV, GC, ArvDomDocument)
 
+ARV_API void				arv_set_genicam_lazy_loading		(gboolean enable);
+ARV_API gboolean			arv_get_genicam_lazy_loading		(void);
+ARV_API void				arv_set_genicam_trusted_loading		(gboolean enable);
+ARV_API gboolean			arv_get_genicam_trusted_loading		(void);
+
 ARV_API ArvGc *				arv_gc_new				(ArvDevice *device, const void *xml, size_t size);
 ARV_API void				arv_gc_register_feature_node		(ArvGc *genicam, ArvGcFeatureNode *node);
 ARV_API void				arv_gc_set_register_cache_policy	(ArvGc *genicam, ArvRegisterCachePolicy policy);
 ARV_API ArvRegisterCachePolicy		arv_gc_get_register_cache_policy	(ArvGc *genicam);
+ARV_API gboolean			arv_gc_set_feature_register_cache_policy	(ArvGc *genicam, const char *feature,
+											 ArvRegisterCachePolicy policy,
+											 GError **error);
+ARV_API gboolean			arv_gc_reset_feature_register_cache_policy	(ArvGc *genicam, const char *feature,
+											 GError **error);
+ARV_API gboolean			arv_gc_get_cache_statistics		(ArvGc *genicam, const char *feature,
+										 guint64 *n_hits, guint64 *n_misses,
+										 guint64 *n_errors);
+ARV_API void				arv_gc_set_profiling_enable		(ArvGc *genicam, gboolean enable);
+ARV_API gboolean			arv_gc_get_profiling_enable		(ArvGc *genicam);
+ARV_API void				arv_gc_reset_profile			(ArvGc *genicam);
+ARV_API gboolean			arv_gc_get_feature_profile		(ArvGc *genicam, const char *feature,
+										 ArvGcFeatureProfile *profile);
+ARV_API char **				arv_gc_dup_profiled_features		(ArvGc *genicam, guint *n_features);
+ARV_API char *				arv_gc_dup_profile_report		(ArvGc *genicam);
 ARV_API void				arv_gc_set_range_check_policy		(ArvGc *genicam, ArvRangeCheckPolicy policy);
 ARV_API ArvRangeCheckPolicy		arv_gc_get_range_check_policy		(ArvGc *genicam);
 ARV_API void                            arv_gc_set_access_check_policy          (ArvGc *genicam, ArvAccessCheckPolicy policy);
 ARV_API ArvAccessCheckPolicy            arv_gc_get_access_check_policy          (ArvGc *genicam);
+ARV_API void				arv_gc_set_struct_entry_snapshot_lifetime	(ArvGc *genicam, gint64 lifetime_us);
+ARV_API gint64				arv_gc_get_struct_entry_snapshot_lifetime	(ArvGc *genicam);
+ARV_API void				arv_gc_set_shadow_memory_enable		(ArvGc *genicam, gboolean enable);
+ARV_API gboolean			arv_gc_get_shadow_memory_enable		(ArvGc *genicam);
+ARV_API gboolean			arv_gc_prefetch_memory			(ArvGc *genicam, guint64 address,
+										 guint32 length, GError **error);
 ARV_API void				arv_gc_set_default_node_data		(ArvGc *genicam, const char *node_name, ...)
                                                                                 G_GNUC_NULL_TERMINATED;
 ARV_API ArvGcNode *			arv_gc_get_node				(ArvGc *genicam, const char *name);
 ARV_API ArvDevice *			arv_gc_get_device			(ArvGc *genicam);
+ARV_API gboolean			arv_gc_prefetch_features		(ArvGc *genicam, const char **features,
+										 GError **error);
+ARV_API gboolean			arv_gc_read_all				(ArvGc *genicam, const char *filter,
+										 GError **error);
+ARV_API GHashTable *			arv_gc_dup_selected_feature_values	(ArvGc *genicam, const char *selector,
+										 GError **error);
+ARV_API GArray *			arv_gc_dup_feature_index		(ArvGc *genicam, const char *root,
+										 GError **error);
+ARV_API gboolean			arv_gc_watch_feature			(ArvGc *genicam, const char *feature,
+										 GError **error);
+ARV_API gboolean			arv_gc_unwatch_feature			(ArvGc *genicam, const char *feature,
+										 GError **error);
+ARV_API gboolean			arv_gc_start_polling			(ArvGc *genicam, GError **error);
+ARV_API void				arv_gc_stop_polling			(ArvGc *genicam);
 ARV_API void				arv_gc_set_buffer			(ArvGc *genicam, ArvBuffer *buffer);
 ARV_API ArvBuffer *			arv_gc_get_buffer			(ArvGc *genicam);
 
+ARV_API void				arv_gc_begin_transaction		(ArvGc *genicam);
+ARV_API gboolean			arv_gc_commit_transaction		(ArvGc *genicam, GError **error);
+
 G_END_DECLS
 
 #endif
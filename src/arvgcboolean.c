@@ -28,6 +28,7 @@
 #include <arvgcboolean.h>
 #include <arvgcinteger.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvgc.h>
 #include <arvmisc.h>
 #include <string.h>
@@ -130,26 +131,13 @@ arv_gc_boolean_get_off_value (ArvGcBoolean *gc_boolean, GError **error)
 	return off_value;
 }
 
-/**
- * arv_gc_boolean_get_value:
- * @gc_boolean: a #ArvGcBoolean
- * @error: a #GError placeholder, %NULL to ignore
- *
- * Returns: the feature value.
- *
- * Since: 0.8.0
- */
-
-gboolean
-arv_gc_boolean_get_value (ArvGcBoolean *gc_boolean, GError **error)
+static gboolean
+_get_value (ArvGcBoolean *gc_boolean, GError **error)
 {
 	gboolean value;
 	gint64 on_value;
 	GError *local_error = NULL;
 
-	g_return_val_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean), FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-
 	if (gc_boolean->value == NULL)
 		return FALSE;
 
@@ -175,6 +163,31 @@ arv_gc_boolean_get_value (ArvGcBoolean *gc_boolean, GError **error)
 	return value == on_value;
 }
 
+/**
+ * arv_gc_boolean_get_value:
+ * @gc_boolean: a #ArvGcBoolean
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Returns: the feature value.
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_gc_boolean_get_value (ArvGcBoolean *gc_boolean, GError **error)
+{
+	gboolean value;
+
+	g_return_val_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_boolean));
+	value = _get_value (gc_boolean, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_boolean));
+
+	return value;
+}
+
 /**
  * arv_gc_boolean_get_value_gi: (rename-to arv_gc_boolean_get_value)
  * @gc_boolean: a #ArvGcBoolean
@@ -200,15 +213,12 @@ arv_gc_boolean_get_value_gi (ArvGcBoolean *gc_boolean, gboolean *value, GError *
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_boolean)));
 }
 
-void
-arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
+static void
+_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
 {
 	gboolean value;
 	GError *local_error = NULL;
 
-	g_return_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean));
-	g_return_if_fail (error == NULL || *error == NULL);
-
         if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (gc_boolean), error))
                 return;
 
@@ -231,6 +241,17 @@ arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError *
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_boolean)));
 }
 
+void
+arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
+{
+	g_return_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean));
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_boolean));
+	_set_value (gc_boolean, v_boolean, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_boolean));
+}
+
 static ArvGcFeatureNode *
 arv_gc_boolean_get_linked_feature (ArvGcFeatureNode *gc_feature_node)
 {
@@ -28,6 +28,7 @@
 #include <arvgccommand.h>
 #include <arvgcinteger.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvgcport.h>
 #include <arvgc.h>
 #include <arvmisc.h>
@@ -90,14 +91,13 @@ arv_gc_command_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 
 /* ArvGcCommand implementation */
 
-void
-arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
+static void
+_execute (ArvGcCommand *gc_command, GError **error)
 {
 	ArvGc *genicam;
 	GError *local_error = NULL;
 	gint64 command_value;
 
-	g_return_if_fail (ARV_IS_GC_COMMAND (gc_command));
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_command));
 	g_return_if_fail (ARV_IS_GC (genicam));
 
@@ -129,6 +129,16 @@ arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
 			 command_value);
 }
 
+void
+arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
+{
+	g_return_if_fail (ARV_IS_GC_COMMAND (gc_command));
+
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_command));
+	_execute (gc_command, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_command));
+}
+
 static ArvGcFeatureNode *
 arv_gc_command_get_linked_feature (ArvGcFeatureNode *gc_feature_node)
 {
@@ -52,6 +52,19 @@ typedef struct {
 
 	ArvEvaluator *formula_to;
 	ArvEvaluator *formula_from;
+
+	/* Evaluator variable indexes, in the variables list order */
+	GArray *formula_to_indexes;
+	GArray *formula_from_indexes;
+	guint from_index;
+	guint to_index;
+	gboolean are_formulas_set;
+
+	GRecMutex formula_mutex;	/* Makes the variable updates and the evaluations atomic */
+
+	/* Last converted value, valid while the memo key is unchanged, see arv_gc_feature_node_get_memo_key() */
+	guint64 value_memo_key;
+	double value_memo;
 } ArvGcConverterPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvGcConverter, arv_gc_converter, ARV_TYPE_GC_FEATURE_NODE,
@@ -70,21 +83,27 @@ arv_gc_converter_post_new_child (ArvDomNode *self, ArvDomNode *child)
 		switch (arv_gc_property_node_get_node_type (property_node)) {
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VARIABLE:
 				priv->variables = g_slist_prepend (priv->variables, property_node);
+				g_clear_pointer (&priv->formula_to_indexes, g_array_unref);
+				g_clear_pointer (&priv->formula_from_indexes, g_array_unref);
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VALUE:
 				priv->value = property_node;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA_TO:
 				priv->formula_to_node = property_node;
+				priv->are_formulas_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA_FROM:
 				priv->formula_from_node = property_node;
+				priv->are_formulas_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_EXPRESSION:
 				priv->expressions = g_slist_prepend (priv->expressions, property_node);
+				priv->are_formulas_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_CONSTANT:
 				priv->constants = g_slist_prepend (priv->constants, property_node);
+				priv->are_formulas_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_UNIT:
 				priv->unit = property_node;
@@ -126,7 +145,30 @@ arv_gc_converter_init (ArvGcConverter *self)
 
 	priv->formula_to = arv_evaluator_new (NULL);
 	priv->formula_from = arv_evaluator_new (NULL);
+	priv->from_index = arv_evaluator_get_variable_index (priv->formula_to, "FROM");
+	priv->to_index = arv_evaluator_get_variable_index (priv->formula_from, "TO");
 	priv->value = NULL;
+	g_rec_mutex_init (&priv->formula_mutex);
+}
+
+static GArray *
+_get_variable_indexes (ArvGcConverter *self, ArvEvaluator *evaluator, GArray **indexes)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (self);
+	GSList *iter;
+
+	if (*indexes != NULL)
+		return *indexes;
+
+	*indexes = g_array_new (FALSE, FALSE, sizeof (guint));
+	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+		guint index;
+
+		index = arv_evaluator_get_variable_index (evaluator, arv_gc_property_node_get_name (iter->data));
+		g_array_append_val (*indexes, index);
+	}
+
+	return *indexes;
 }
 
 static ArvGcFeatureNode *
@@ -156,6 +198,9 @@ arv_gc_converter_finalize (GObject *object)
 
 	g_object_unref (priv->formula_to);
 	g_object_unref (priv->formula_from);
+	g_clear_pointer (&priv->formula_to_indexes, g_array_unref);
+	g_clear_pointer (&priv->formula_from_indexes, g_array_unref);
+	g_rec_mutex_clear (&priv->formula_mutex);
 
 	G_OBJECT_CLASS (arv_gc_converter_parent_class)->finalize (object);
 }
@@ -200,16 +245,16 @@ arv_gc_converter_get_is_linear (ArvGcConverter *gc_converter, GError **error)
 }
 
 static gboolean
-arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConverterNodeType node_type, GError **error)
+_set_evaluator_formula (ArvGcConverter *gc_converter, ArvEvaluator *evaluator, ArvGcPropertyNode *formula_node,
+			GError **error)
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
-	ArvGcNode *node = NULL;
 	GError *local_error = NULL;
 	GSList *iter;
 	const char *expression;
 
-	if (priv->formula_from_node != NULL)
-		expression = arv_gc_property_node_get_string (priv->formula_from_node, &local_error);
+	if (formula_node != NULL)
+		expression = arv_gc_property_node_get_string (formula_node, &local_error);
 	else
 		expression = "";
 
@@ -218,7 +263,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 		return FALSE;
 	}
 
-	arv_evaluator_set_expression (priv->formula_from, expression);
+	arv_evaluator_set_expression (evaluator, expression);
 
 	for (iter = priv->expressions; iter != NULL; iter = iter->next) {
 		const char *expression;
@@ -232,7 +277,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 
 		name = arv_gc_property_node_get_name (iter->data);
 
-		arv_evaluator_set_sub_expression (priv->formula_from, name, expression);
+		arv_evaluator_set_sub_expression (evaluator, name, expression);
 	}
 
 	for (iter = priv->constants; iter != NULL; iter = iter->next) {
@@ -247,10 +292,47 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 
 		name = arv_gc_property_node_get_name (iter->data);
 
-		arv_evaluator_set_constant (priv->formula_from, name, constant);
+		arv_evaluator_set_constant (evaluator, name, constant);
 	}
 
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	return TRUE;
+}
+
+/* The formulas, the sub-expressions and the constants are constant properties, the evaluators get them once */
+
+static gboolean
+_set_formulas (ArvGcConverter *gc_converter, GError **error)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
+
+	if (priv->are_formulas_set)
+		return TRUE;
+
+	if (!_set_evaluator_formula (gc_converter, priv->formula_from, priv->formula_from_node, error) ||
+	    !_set_evaluator_formula (gc_converter, priv->formula_to, priv->formula_to_node, error))
+		return FALSE;
+
+	priv->are_formulas_set = TRUE;
+
+	return TRUE;
+}
+
+static gboolean
+arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConverterNodeType node_type, GError **error)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
+	ArvGcNode *node = NULL;
+	GError *local_error = NULL;
+	GSList *iter;
+	GArray *indexes;
+	guint i;
+
+	if (!_set_formulas (gc_converter, error))
+		return FALSE;
+
+	indexes = _get_variable_indexes (gc_converter, priv->formula_from, &priv->formula_from_indexes);
+
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
@@ -264,9 +346,9 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
                                 return FALSE;
                         }
 
-			arv_evaluator_set_int64_variable (priv->formula_from,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_index (priv->formula_from,
+								   g_array_index (indexes, guint, i),
+								   value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -277,9 +359,9 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 				return FALSE;
 			}
 
-			arv_evaluator_set_double_variable (priv->formula_from,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_double_variable_by_index (priv->formula_from,
+								   g_array_index (indexes, guint, i),
+								   value);
 		}
 	}
 
@@ -315,7 +397,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 				return FALSE;
 			}
 
-			arv_evaluator_set_int64_variable (priv->formula_from, "TO", value);
+			arv_evaluator_set_int64_variable_by_index (priv->formula_from, priv->to_index, value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -348,7 +430,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
                                 return FALSE;
                         }
 
-			arv_evaluator_set_double_variable (priv->formula_from, "TO", value);
+			arv_evaluator_set_double_variable_by_index (priv->formula_from, priv->to_index, value);
 		} else {
 			arv_warning_genicam ("[GcConverter::set_value] Invalid pValue node '%s'",
 					     arv_gc_property_node_get_string (priv->value, NULL));
@@ -371,11 +453,25 @@ arv_gc_converter_convert_to_double (ArvGcConverter *gc_converter, ArvGcConverter
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
 	GError *local_error = NULL;
+	guint64 memo_key = 0;
         double value;
 
 	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), 0.0);
 
+	if (node_type == ARV_GC_CONVERTER_NODE_TYPE_VALUE)
+		memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (gc_converter));
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+
+	if (memo_key != 0 && memo_key == priv->value_memo_key) {
+		value = priv->value_memo;
+		g_rec_mutex_unlock (&priv->formula_mutex);
+		return value;
+	}
+
 	if (!arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error)) {
+		g_rec_mutex_unlock (&priv->formula_mutex);
+
 		if (local_error != NULL)
                         g_propagate_prefixed_error (error, local_error, "[%s] ",
                                                     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_converter)));
@@ -392,6 +488,13 @@ arv_gc_converter_convert_to_double (ArvGcConverter *gc_converter, ArvGcConverter
 
 	value = arv_evaluator_evaluate_as_double (priv->formula_from, &local_error);
 
+	if (local_error == NULL && memo_key != 0) {
+		priv->value_memo_key = memo_key;
+		priv->value_memo = value;
+	}
+
+	g_rec_mutex_unlock (&priv->formula_mutex);
+
         if (local_error != NULL)
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_converter)));
@@ -404,11 +507,26 @@ arv_gc_converter_convert_to_int64 (ArvGcConverter *gc_converter, ArvGcConverterN
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
 	GError *local_error = NULL;
+	guint64 memo_key = 0;
+	double double_value;
         gint64 value;
 
 	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), 0);
 
+	if (node_type == ARV_GC_CONVERTER_NODE_TYPE_VALUE)
+		memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (gc_converter));
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+
+	if (memo_key != 0 && memo_key == priv->value_memo_key) {
+		value = priv->value_memo;
+		g_rec_mutex_unlock (&priv->formula_mutex);
+		return value;
+	}
+
 	if (!arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error)) {
+		g_rec_mutex_unlock (&priv->formula_mutex);
+
 		if (local_error != NULL)
                         g_propagate_prefixed_error (error, local_error, "[%s] ",
                                                     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_converter)));
@@ -423,7 +541,16 @@ arv_gc_converter_convert_to_int64 (ArvGcConverter *gc_converter, ArvGcConverterN
 		}
 	}
 
-	value = arv_evaluator_evaluate_as_double (priv->formula_from, &local_error);
+	double_value = arv_evaluator_evaluate_as_double (priv->formula_from, &local_error);
+
+	if (local_error == NULL && memo_key != 0) {
+		priv->value_memo_key = memo_key;
+		priv->value_memo = double_value;
+	}
+
+	g_rec_mutex_unlock (&priv->formula_mutex);
+
+	value = double_value;
 
         if (local_error != NULL)
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
@@ -439,51 +566,18 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 	ArvGcNode *node;
 	GError *local_error = NULL;
 	GSList *iter;
-	const char *expression;
-
-	if (priv->formula_to_node != NULL)
-		expression = arv_gc_property_node_get_string (priv->formula_to_node, &local_error);
-	else
-		expression = "";
+	GArray *indexes;
+	guint i;
 
+	_set_formulas (gc_converter, &local_error);
 	if (local_error != NULL) {
-                g_propagate_error (error, local_error);
+		g_propagate_error (error, local_error);
 		return;
 	}
 
-	arv_evaluator_set_expression (priv->formula_to, expression);
-
-	for (iter = priv->expressions; iter != NULL; iter = iter->next) {
-		const char *expression;
-		const char *name;
-
-		expression = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			return;
-		}
-
-		name = arv_gc_property_node_get_name (iter->data);
-
-		arv_evaluator_set_sub_expression (priv->formula_to, name, expression);
-	}
-
-	for (iter = priv->constants; iter != NULL; iter = iter->next) {
-		const char *constant;
-		const char *name;
+	indexes = _get_variable_indexes (gc_converter, priv->formula_to, &priv->formula_to_indexes);
 
-		constant = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			return;
-		}
-
-		name = arv_gc_property_node_get_name (iter->data);
-
-		arv_evaluator_set_constant (priv->formula_to, name, constant);
-	}
-
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
@@ -497,9 +591,9 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 				return;
 			}
 
-			arv_evaluator_set_int64_variable (priv->formula_to,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_index (priv->formula_to,
+								   g_array_index (indexes, guint, i),
+								   value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -510,9 +604,9 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 				return;
 			}
 
-			arv_evaluator_set_double_variable (priv->formula_to,
-							   arv_gc_property_node_get_name (variable_node),
-							   value);
+			arv_evaluator_set_double_variable_by_index (priv->formula_to,
+								   g_array_index (indexes, guint, i),
+								   value);
 		}
 	}
 
@@ -552,8 +646,11 @@ arv_gc_converter_convert_from_double (ArvGcConverter *gc_converter, double value
 	g_return_if_fail (ARV_IS_GC_CONVERTER (gc_converter));
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (gc_converter));
-	arv_evaluator_set_double_variable (priv->formula_to, "FROM", value);
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+	arv_evaluator_set_double_variable_by_index (priv->formula_to, priv->from_index, value);
 	arv_gc_converter_update_to_variables (gc_converter, &local_error);
+	g_rec_mutex_unlock (&priv->formula_mutex);
 
         if (local_error != NULL)
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
@@ -569,8 +666,11 @@ arv_gc_converter_convert_from_int64 (ArvGcConverter *gc_converter, gint64 value,
 	g_return_if_fail (ARV_IS_GC_CONVERTER (gc_converter));
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (gc_converter));
-	arv_evaluator_set_int64_variable (priv->formula_to, "FROM", value);
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+	arv_evaluator_set_int64_variable_by_index (priv->formula_to, priv->from_index, value);
 	arv_gc_converter_update_to_variables (gc_converter, &local_error);
+	g_rec_mutex_unlock (&priv->formula_mutex);
 
         if (local_error != NULL)
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
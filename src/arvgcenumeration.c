@@ -31,17 +31,36 @@
 #include <arvgcselector.h>
 #include <arvgcstring.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvgc.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
 #include <string.h>
 
+typedef struct {
+	ArvGcEnumEntry *entry;
+	gint64 value;
+
+	/* Protected by the availability mutex of the enumeration */
+	gboolean is_availability_cached;
+	gboolean is_selectable;
+	guint64 availability_change_count;
+} ArvGcEnumerationIndexedEntry;
+
 struct _ArvGcEnumeration {
 	ArvGcFeatureNode base;
 
 	ArvGcPropertyNode *value;
 	GSList *entries;
 
+	gsize is_index_built;
+	ArvGcEnumerationIndexedEntry *indexed_entries;	/* In document order */
+	guint n_indexed_entries;
+	GHashTable *entries_by_name;
+	GHashTable *entries_by_value;
+	gboolean has_duplicated_values;
+	GMutex availability_mutex;
+
 	GSList *selecteds;		/* #ArvGcPropertyNode */
 	GSList *selected_features;	/* #ArvGcFeatureNode */
 };
@@ -105,107 +124,157 @@ arv_gc_enumeration_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 
 /* ArvGcEnumeration implementation */
 
-/**
- * arv_gc_enumeration_dup_available_int_values:
- * @enumeration: a #ArvGcEnumeration
- * @n_values: (out): the number of values
- * @error: (out): the error that occured, or NULL
- *
- * Return value: (transfer full) (array length=n_values): a newly allocated array of 64 bit integers, to be freed after
- * use using g_free().
- *
- * Since: 0.8.0
- */
+/* Entries are indexed by name and by value on first use, the entry list being complete once the enumeration node is
+ * parsed. */
 
-gint64 *
-arv_gc_enumeration_dup_available_int_values (ArvGcEnumeration *enumeration, guint *n_values, GError **error)
+static void
+_build_index (ArvGcEnumeration *enumeration)
 {
-	gint64 *values;
-	const GSList *entries, *iter;
-	GSList *available_entries = NULL;
-	unsigned int i;
-	GError *local_error = NULL;
+	const GSList *iter;
+	guint i;
 
-	g_return_val_if_fail (n_values != NULL, NULL);
+	if (!g_once_init_enter (&enumeration->is_index_built))
+		return;
 
-	*n_values = 0;
+	enumeration->n_indexed_entries = g_slist_length (enumeration->entries);
+	enumeration->indexed_entries = g_new0 (ArvGcEnumerationIndexedEntry, enumeration->n_indexed_entries);
+	enumeration->entries_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+	enumeration->entries_by_value = g_hash_table_new (g_int64_hash, g_int64_equal);
 
-	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
-	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+	/* The entry list is in reverse document order. The value index keeps the first entry of the list, as the
+	 * linear search did for the duplicated values. */
+	for (iter = enumeration->entries, i = enumeration->n_indexed_entries; iter != NULL; iter = iter->next) {
+		ArvGcEnumerationIndexedEntry *indexed_entry = &enumeration->indexed_entries[--i];
+		const char *name;
+		GError *error = NULL;
 
-	entries = arv_gc_enumeration_get_entries (enumeration);
+		indexed_entry->entry = iter->data;
+		indexed_entry->value = arv_gc_enum_entry_get_value (iter->data, &error);
+		if (error != NULL) {
+			arv_warning_genicam ("[GcEnumeration::build_index] %s", error->message);
+			g_clear_error (&error);
+		}
 
-	*n_values = 0;
-	for (iter = entries; iter != NULL; iter = iter->next) {
-		gboolean is_available;
+		name = arv_gc_feature_node_get_name (iter->data);
+		if (name != NULL && !g_hash_table_contains (enumeration->entries_by_name, name))
+			g_hash_table_insert (enumeration->entries_by_name, (char *) name, indexed_entry);
 
-		is_available = arv_gc_feature_node_is_available (iter->data, &local_error);
+		if (g_hash_table_contains (enumeration->entries_by_value, &indexed_entry->value))
+			enumeration->has_duplicated_values = TRUE;
+		else
+			g_hash_table_insert (enumeration->entries_by_value, &indexed_entry->value, indexed_entry);
+	}
 
-		if (local_error != NULL) {
-			g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-			*n_values = 0;
-			g_slist_free (available_entries);
+	g_once_init_leave (&enumeration->is_index_built, TRUE);
+}
 
-			return NULL;
-		}
+/* An entry can be selected if it is available and implemented. With the register cache enabled, the result is kept
+ * until a change of the nodes behind the pIsAvailable and pIsImplemented properties of the entry, pushed through the
+ * dependency graph. */
 
-		if (is_available) {
-			gboolean is_implemented;
+static gboolean
+_is_entry_selectable (ArvGcEnumeration *enumeration, ArvGcEnumerationIndexedEntry *indexed_entry, GError **error)
+{
+	ArvGcFeatureNode *entry = ARV_GC_FEATURE_NODE (indexed_entry->entry);
+	GError *local_error = NULL;
+	gboolean use_cache;
+	gboolean is_selectable;
+	guint64 change_count = 0;
 
-			is_implemented = arv_gc_feature_node_is_implemented (iter->data, &local_error);
+	use_cache = arv_gc_get_register_cache_policy (arv_gc_node_get_genicam (ARV_GC_NODE (enumeration))) ==
+		ARV_REGISTER_CACHE_POLICY_ENABLE;
 
-			if (local_error != NULL) {
-                                g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                            arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-                                *n_values = 0;
-                                g_slist_free (available_entries);
+	if (use_cache) {
+		gboolean is_cached;
 
-				return NULL;
-			}
+		change_count = arv_gc_feature_node_get_availability_change_count (entry);
 
-			if (is_implemented) {
-				(*n_values)++;
-				available_entries = g_slist_prepend (available_entries, iter->data);
-			}
-		}
+		g_mutex_lock (&enumeration->availability_mutex);
+		is_cached = indexed_entry->is_availability_cached &&
+			indexed_entry->availability_change_count == change_count;
+		is_selectable = indexed_entry->is_selectable;
+		g_mutex_unlock (&enumeration->availability_mutex);
+
+		if (is_cached)
+			return is_selectable;
 	}
 
-	if (*n_values == 0) {
-		g_slist_free (available_entries);
-		return NULL;
+	is_selectable = arv_gc_feature_node_is_available (entry, &local_error);
+	if (local_error == NULL && is_selectable)
+		is_selectable = arv_gc_feature_node_is_implemented (entry, &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_prefixed_error (error, local_error, "[%s] ",
+					    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+		return FALSE;
 	}
 
-	values = g_new (gint64, *n_values);
-	for (iter = available_entries, i = 0; iter != NULL; iter = iter->next) {
+	/* A change during the evaluation leaves a stale change count, which forces a new evaluation */
+	if (use_cache) {
+		g_mutex_lock (&enumeration->availability_mutex);
+		indexed_entry->is_selectable = is_selectable;
+		indexed_entry->availability_change_count = change_count;
+		indexed_entry->is_availability_cached = TRUE;
+		g_mutex_unlock (&enumeration->availability_mutex);
+	}
+
+	return is_selectable;
+}
+
+/* Returns the selectable entries, in document order */
+
+static ArvGcEnumerationIndexedEntry **
+_dup_selectable_entries (ArvGcEnumeration *enumeration, guint *n_entries, GError **error)
+{
+	ArvGcEnumerationIndexedEntry **entries;
+	GError *local_error = NULL;
+	guint i;
+
+	*n_entries = 0;
+
+	_build_index (enumeration);
 
-		values[i] = arv_gc_enum_entry_get_value (iter->data, &local_error);
+	if (enumeration->n_indexed_entries == 0)
+		return NULL;
+
+	entries = g_new (ArvGcEnumerationIndexedEntry *, enumeration->n_indexed_entries);
+	for (i = 0; i < enumeration->n_indexed_entries; i++) {
+		if (_is_entry_selectable (enumeration, &enumeration->indexed_entries[i], &local_error))
+			entries[(*n_entries)++] = &enumeration->indexed_entries[i];
 
 		if (local_error != NULL) {
-                        g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-                        *n_values = 0;
-                        g_slist_free (available_entries);
-                        g_free (values);
+			g_propagate_error (error, local_error);
+			g_free (entries);
+			*n_entries = 0;
 
 			return NULL;
 		}
-		i++;
 	}
 
-	g_slist_free (available_entries);
+	if (*n_entries == 0)
+		g_clear_pointer (&entries, g_free);
 
-	return values;
+	return entries;
 }
 
-static const char **
-_dup_available_string_values (ArvGcEnumeration *enumeration, gboolean display_name ,guint *n_values, GError **error)
+/**
+ * arv_gc_enumeration_dup_available_int_values:
+ * @enumeration: a #ArvGcEnumeration
+ * @n_values: (out): the number of values
+ * @error: (out): the error that occured, or NULL
+ *
+ * Return value: (transfer full) (array length=n_values): a newly allocated array of 64 bit integers, to be freed after
+ * use using g_free().
+ *
+ * Since: 0.8.0
+ */
+
+gint64 *
+arv_gc_enumeration_dup_available_int_values (ArvGcEnumeration *enumeration, guint *n_values, GError **error)
 {
-	const char ** strings;
-	const GSList *entries, *iter;
-	GSList *available_entries = NULL;
+	ArvGcEnumerationIndexedEntry **entries;
+	gint64 *values;
 	unsigned int i;
-	GError *local_error = NULL;
 
 	g_return_val_if_fail (n_values != NULL, NULL);
 
@@ -214,60 +283,48 @@ _dup_available_string_values (ArvGcEnumeration *enumeration, gboolean display_na
 	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	entries = arv_gc_enumeration_get_entries (enumeration);
-
-	*n_values = 0;
-	for (iter = entries; iter != NULL; iter = iter->next) {
-		gboolean is_available;
-
-		is_available = arv_gc_feature_node_is_available (iter->data, &local_error);
+	entries = _dup_selectable_entries (enumeration, n_values, error);
+	if (entries == NULL)
+		return NULL;
 
-		if (local_error != NULL) {
-                        g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-			*n_values = 0;
-			g_slist_free (available_entries);
+	values = g_new (gint64, *n_values);
+	for (i = 0; i < *n_values; i++)
+		values[i] = entries[i]->value;
 
-			return NULL;
-		}
+	g_free (entries);
 
-		if (is_available) {
-			gboolean is_implemented;
+	return values;
+}
 
-			is_implemented = arv_gc_feature_node_is_implemented (iter->data, &local_error);
+static const char **
+_dup_available_string_values (ArvGcEnumeration *enumeration, gboolean display_name ,guint *n_values, GError **error)
+{
+	ArvGcEnumerationIndexedEntry **entries;
+	const char ** strings;
+	unsigned int i;
 
-			if (local_error != NULL) {
-                                g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                            arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-                                *n_values = 0;
-                                g_slist_free (available_entries);
+	g_return_val_if_fail (n_values != NULL, NULL);
 
-				return NULL;
-			}
+	*n_values = 0;
 
-			if (is_implemented) {
-				(*n_values)++;
-				available_entries = g_slist_prepend (available_entries, iter->data);
-			}
-		}
-	}
+	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	if (*n_values == 0) {
-		g_slist_free (available_entries);
+	entries = _dup_selectable_entries (enumeration, n_values, error);
+	if (entries == NULL)
 		return NULL;
-	}
 
 	strings = g_new (const char*, *n_values);
-	for (iter = available_entries, i = 0; iter != NULL; iter = iter->next, i++) {
+	for (i = 0; i < *n_values; i++) {
 		const char *string = NULL;
 		if (display_name)
-			string = arv_gc_feature_node_get_display_name (iter->data);
+			string = arv_gc_feature_node_get_display_name (ARV_GC_FEATURE_NODE (entries[i]->entry));
 		if (string == NULL)
-			string = arv_gc_feature_node_get_name (iter->data);
+			string = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (entries[i]->entry));
 		strings[i] = string;
 	}
 
-	g_slist_free (available_entries);
+	g_free (entries);
 
 	return strings;
 }
@@ -338,11 +395,50 @@ _get_int_value (ArvGcEnumeration *enumeration, GError **error)
 gint64
 arv_gc_enumeration_get_int_value (ArvGcEnumeration *enumeration, GError **error)
 {
+        gint64 value = 0;
+
+        arv_gc_profile_enter (ARV_GC_FEATURE_NODE (enumeration));
+
+        if (arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (enumeration), error))
+                value = _get_int_value (enumeration, error);
+
+        arv_gc_profile_leave (ARV_GC_FEATURE_NODE (enumeration));
+
+        return value;
+}
+
+/* An entry with @value can be selected. The value index gives the entry directly, unless several entries share the
+ * same value. */
+
+static gboolean
+_is_value_selectable (ArvGcEnumeration *enumeration, gint64 value, GError **error)
+{
+	ArvGcEnumerationIndexedEntry *indexed_entry;
+	guint i;
+
+	_build_index (enumeration);
+
+	if (!enumeration->has_duplicated_values) {
+		indexed_entry = g_hash_table_lookup (enumeration->entries_by_value, &value);
+
+		return indexed_entry != NULL && _is_entry_selectable (enumeration, indexed_entry, error);
+	}
 
-        if (!arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (enumeration), error))
-                return 0;
+	for (i = 0; i < enumeration->n_indexed_entries; i++) {
+		GError *local_error = NULL;
+
+		indexed_entry = &enumeration->indexed_entries[i];
+		if (indexed_entry->value == value &&
+		    _is_entry_selectable (enumeration, indexed_entry, &local_error))
+			return TRUE;
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+	}
 
-        return _get_int_value (enumeration, error);
+	return FALSE;
 }
 
 static gboolean
@@ -354,39 +450,36 @@ _set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
 	if (enumeration->value) {
 		GError *local_error = NULL;
 
-		{
+		if (!_is_value_selectable (enumeration, value, &local_error)) {
 			gint64 *available_values;
 			unsigned n_values;
-			unsigned i;
-			gboolean found = FALSE;
 
+			if (local_error != NULL) {
+                                g_propagate_prefixed_error (error, local_error, "[%s] ",
+                                                            arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+				return FALSE;
+			}
+
+			/* Error path only, for the empty enumeration report */
 			available_values = arv_gc_enumeration_dup_available_int_values (enumeration, &n_values, &local_error);
+			g_free (available_values);
+
 			if (local_error != NULL) {
                                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
 				return FALSE;
 			}
 
-			if (available_values == NULL) {
+			if (available_values == NULL)
 				g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EMPTY_ENUMERATION,
 					     "[%s] No available entry found",
 					     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-				return FALSE;
-			}
-
-			for (i = 0; i < n_values; i++)
-				if (available_values[i] == value)
-					found = TRUE;
-
-			g_free (available_values);
-
-			if (!found) {
+			else
 				g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
 					     "[%s] Value %" G_GINT64_FORMAT " not found",
 					     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)),
                                              value);
-				return FALSE;
-			}
+			return FALSE;
 		}
 
 		arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (enumeration));
@@ -410,16 +503,22 @@ _set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
 gboolean
 arv_gc_enumeration_set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
 {
-        if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (enumeration), error))
-                return FALSE;
+        gboolean success = FALSE;
 
-        return _set_int_value (enumeration, value, error);
+        arv_gc_profile_enter (ARV_GC_FEATURE_NODE (enumeration));
+
+        if (arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (enumeration), error))
+                success = _set_int_value (enumeration, value, error);
+
+        arv_gc_profile_leave (ARV_GC_FEATURE_NODE (enumeration));
+
+        return success;
 }
 
 static const char *
 _get_string_value (ArvGcEnumeration *enumeration, GError **error)
 {
-	const GSList *iter;
+	ArvGcEnumerationIndexedEntry *indexed_entry;
 	GError *local_error = NULL;
 	gint64 value;
 
@@ -434,25 +533,16 @@ _get_string_value (ArvGcEnumeration *enumeration, GError **error)
 		return NULL;
 	}
 
-	for (iter = enumeration->entries; iter != NULL; iter = iter->next) {
-		gint64 enum_value;
-
-		enum_value = arv_gc_enum_entry_get_value (iter->data, &local_error);
-
-		if (local_error != NULL) {
-                        g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-                        return NULL;
-                }
+	_build_index (enumeration);
 
-		if (enum_value == value) {
-			const char *string;
+	indexed_entry = g_hash_table_lookup (enumeration->entries_by_value, &value);
+	if (indexed_entry != NULL) {
+		const char *string;
 
-			string = arv_gc_feature_node_get_name (iter->data);
-			arv_debug_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " - string = %s",
-					 value, string);
-			return string;
-		}
+		string = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (indexed_entry->entry));
+		arv_debug_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " - string = %s",
+				   value, string);
+		return string;
 	}
 
 	arv_warning_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " not found for node %s",
@@ -464,47 +554,46 @@ _get_string_value (ArvGcEnumeration *enumeration, GError **error)
 const char *
 arv_gc_enumeration_get_string_value (ArvGcEnumeration *enumeration, GError **error)
 {
-        if (!arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (enumeration), error))
-                return NULL;
+        const char *value = NULL;
+
+        arv_gc_profile_enter (ARV_GC_FEATURE_NODE (enumeration));
 
-        return _get_string_value (enumeration, error);
+        if (arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (enumeration), error))
+                value = _get_string_value (enumeration, error);
+
+        arv_gc_profile_leave (ARV_GC_FEATURE_NODE (enumeration));
+
+        return value;
 }
 
 static gboolean
 _set_string_value (ArvGcEnumeration *enumeration, const char *value, GError **error)
 {
-	const GSList *iter;
+	ArvGcEnumerationIndexedEntry *indexed_entry;
 
 	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), FALSE);
 	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	for (iter = enumeration->entries; iter != NULL; iter = iter->next)
-		if (g_strcmp0 (arv_gc_feature_node_get_name (iter->data), value) == 0) {
-			GError *local_error = NULL;
-			gint64 enum_value;
+	_build_index (enumeration);
 
-			enum_value = arv_gc_enum_entry_get_value (iter->data, &local_error);
-
-			arv_debug_genicam ("[GcEnumeration::set_string_value] value = %" G_GINT64_FORMAT " - string = %s",
-					 enum_value, value);
+	indexed_entry = value != NULL ? g_hash_table_lookup (enumeration->entries_by_name, value) : NULL;
+	if (indexed_entry != NULL) {
+		GError *local_error = NULL;
 
-			if (local_error != NULL) {
-                                g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                            arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-                                return FALSE;
-                        }
+		arv_debug_genicam ("[GcEnumeration::set_string_value] value = %" G_GINT64_FORMAT " - string = %s",
+				   indexed_entry->value, value);
 
-			_set_int_value (enumeration, enum_value, &local_error);
+		_set_int_value (enumeration, indexed_entry->value, &local_error);
 
-			if (local_error != NULL) {
-                                g_propagate_prefixed_error (error, local_error, "[%s] ",
-                                                            arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-				return FALSE;
-			}
-
-			return TRUE;
+		if (local_error != NULL) {
+			g_propagate_prefixed_error (error, local_error, "[%s] ",
+						    arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+			return FALSE;
 		}
 
+		return TRUE;
+	}
+
 	arv_warning_genicam ("[GcEnumeration::set_string_value] entry %s not found", value);
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_ENUM_ENTRY_NOT_FOUND, "[%s] '%s' not an entry",
@@ -516,10 +605,16 @@ _set_string_value (ArvGcEnumeration *enumeration, const char *value, GError **er
 gboolean
 arv_gc_enumeration_set_string_value (ArvGcEnumeration *enumeration, const char *value, GError **error)
 {
-        if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (enumeration), error))
-                return FALSE;
+        gboolean success = FALSE;
+
+        arv_gc_profile_enter (ARV_GC_FEATURE_NODE (enumeration));
+
+        if (arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (enumeration), error))
+                success = _set_string_value (enumeration, value, error);
+
+        arv_gc_profile_leave (ARV_GC_FEATURE_NODE (enumeration));
 
-        return _set_string_value (enumeration, value, error);
+        return success;
 }
 
 /**
@@ -566,6 +661,7 @@ arv_gc_enumeration_new (void)
 static void
 arv_gc_enumeration_init (ArvGcEnumeration *gc_enumeration)
 {
+	g_mutex_init (&gc_enumeration->availability_mutex);
 }
 
 static void
@@ -576,6 +672,10 @@ arv_gc_enumeration_finalize (GObject *object)
 	g_clear_pointer (&enumeration->entries, g_slist_free);
 	g_clear_pointer (&enumeration->selecteds, g_slist_free);
 	g_clear_pointer (&enumeration->selected_features, g_slist_free);
+	g_clear_pointer (&enumeration->entries_by_name, g_hash_table_unref);
+	g_clear_pointer (&enumeration->entries_by_value, g_hash_table_unref);
+	g_clear_pointer (&enumeration->indexed_entries, g_free);
+	g_mutex_clear (&enumeration->availability_mutex);
 
 	G_OBJECT_CLASS (arv_gc_enumeration_parent_class)->finalize (object);
 }
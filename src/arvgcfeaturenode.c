@@ -31,11 +31,15 @@
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcpropertynode.h>
 #include <arvgc.h>
+#include <arvdomdocumentprivate.h>
 #include <arvgcboolean.h>
 #include <arvgcinteger.h>
 #include <arvgcfloat.h>
 #include <arvgcstring.h>
 #include <arvgcenumeration.h>
+#include <arvgcregisternodeprivate.h>
+#include <arvgcstructentrynode.h>
+#include <arvgcprivate.h>
 #include <arvgcenums.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
@@ -43,9 +47,10 @@
 
 typedef struct {
 
-	char *name;
+	/* Interned by the owner document */
+	const char *name;
 	ArvGcNameSpace name_space;
-        char *comment;
+        const char *comment;
 
 	ArvGcPropertyNode *tooltip;
 	ArvGcPropertyNode *description;
@@ -59,6 +64,16 @@ typedef struct {
 
 	guint64 change_count;
 
+	/* Reverse dependency graph: nodes to notify when this node changes */
+	GSList *dependents;
+	gboolean are_dependencies_tracked;
+	gint change_epoch;
+	guint n_watches;	/* Emission of the ArvGc::feature-changed signal */
+
+	/* Value stability, for the cache policy epoch stability_epoch */
+	guint stability_epoch;
+	gboolean is_value_stable;
+
 	char *string_buffer;
 } ArvGcFeatureNodePrivate;
 
@@ -163,10 +178,10 @@ arv_gc_feature_node_set_attribute (ArvDomElement *self, const char *name, const
 	if (strcmp (name, "Name") == 0) {
 		ArvGc *genicam;
 
-		g_free (priv->name);
-		priv->name = g_strdup (value);
-
 		genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+
+		priv->name = arv_dom_document_intern_string (ARV_DOM_DOCUMENT (genicam), value);
+
 		/* Kludge around ugly Genicam specification (Really, pre-parsing for EnumEntry Name substitution ?) */
 		if (strcmp (arv_dom_node_get_node_name (ARV_DOM_NODE (self)), "EnumEntry") != 0)
 			arv_gc_register_feature_node (genicam, ARV_GC_FEATURE_NODE (self));
@@ -176,8 +191,8 @@ arv_gc_feature_node_set_attribute (ArvDomElement *self, const char *name, const
 		else
 			priv->name_space = ARV_GC_NAME_SPACE_CUSTOM;
 	} else if (strcmp (name, "Comment") == 0) {
-                g_free (priv->comment);
-                priv->comment = g_strdup (value);
+                priv->comment = arv_dom_document_intern_string
+                        (ARV_DOM_DOCUMENT (arv_gc_node_get_genicam (ARV_GC_NODE (self))), value);
 	} else
 		arv_info_dom ("[GcFeature::set_attribute] Unknown attribute '%s'", name);
 }
@@ -478,15 +493,33 @@ arv_gc_feature_node_set_value_from_string (ArvGcFeatureNode *self, const char *s
  *
  * Retrieve the node value a string.
  *
- * <warning><para>Please note the string content is still owned by the @node object, which means the returned pointer may not be still valid after a new call to this function.</para></warning>
+ * <warning><para>Please note the string content is still owned by the @node object, which means the returned pointer may not be still valid after a new call to this function, from any thread. Use arv_gc_feature_node_dup_value_as_string() when the feature may be read from several threads.</para></warning>
  *
  * Returns: (transfer none): a string representation of the node value, %NULL if not applicable.
  */
 
+/* Serializes the replacements of the string buffers of the nodes */
+static GMutex arv_gc_feature_node_string_buffer_mutex;
+
+static const char *
+_set_string_buffer (ArvGcFeatureNode *self, char *string)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	char *old_string;
+
+	g_mutex_lock (&arv_gc_feature_node_string_buffer_mutex);
+	old_string = priv->string_buffer;
+	priv->string_buffer = string;
+	g_mutex_unlock (&arv_gc_feature_node_string_buffer_mutex);
+
+	g_free (old_string);
+
+	return string;
+}
+
 const char *
 arv_gc_feature_node_get_value_as_string (ArvGcFeatureNode *self, GError **error)
 {
-	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
         GError *local_error = NULL;
         const char *value = NULL;
 
@@ -495,14 +528,12 @@ arv_gc_feature_node_get_value_as_string (ArvGcFeatureNode *self, GError **error)
 	if (ARV_IS_GC_ENUMERATION (self)) {
                 value = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (self), &local_error);
 	} else if (ARV_IS_GC_INTEGER (self)) {
-		g_free (priv->string_buffer);
-		priv->string_buffer = g_strdup_printf ("%" G_GINT64_FORMAT,
-                                                       arv_gc_integer_get_value (ARV_GC_INTEGER (self), &local_error));
-		value = priv->string_buffer;
+		value = _set_string_buffer (self, g_strdup_printf ("%" G_GINT64_FORMAT,
+								   arv_gc_integer_get_value (ARV_GC_INTEGER (self),
+											     &local_error)));
 	} else if (ARV_IS_GC_FLOAT (self)) {
-		g_free (priv->string_buffer);
-		priv->string_buffer = g_strdup_printf ("%g", arv_gc_float_get_value (ARV_GC_FLOAT (self), &local_error));
-		value = priv->string_buffer;
+		value = _set_string_buffer (self, g_strdup_printf ("%g", arv_gc_float_get_value (ARV_GC_FLOAT (self),
+												 &local_error)));
 	} else if (ARV_IS_GC_STRING (self)) {
 		value =  arv_gc_string_get_value (ARV_GC_STRING (self), &local_error);
 	} else if (ARV_IS_GC_BOOLEAN (self)) {
@@ -518,14 +549,340 @@ arv_gc_feature_node_get_value_as_string (ArvGcFeatureNode *self, GError **error)
 	return value;
 }
 
+/**
+ * arv_gc_feature_node_dup_value_as_string:
+ * @gc_feature_node: a #ArvGcFeatureNode
+ * @error: return location for a GError, or NULL
+ *
+ * Same as arv_gc_feature_node_get_value_as_string(), but the returned string is a copy, which can't be changed by a
+ * read of the feature from another thread.
+ *
+ * Returns: (transfer full): a newly allocated string representation of the node value, %NULL if not applicable.
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_gc_feature_node_dup_value_as_string (ArvGcFeatureNode *self, GError **error)
+{
+        GError *local_error = NULL;
+        char *value = NULL;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), NULL);
+
+	if (ARV_IS_GC_INTEGER (self) && !ARV_IS_GC_ENUMERATION (self)) {
+		gint64 integer_value = arv_gc_integer_get_value (ARV_GC_INTEGER (self), &local_error);
+
+		if (local_error == NULL)
+			value = g_strdup_printf ("%" G_GINT64_FORMAT, integer_value);
+	} else if (ARV_IS_GC_FLOAT (self)) {
+		double float_value = arv_gc_float_get_value (ARV_GC_FLOAT (self), &local_error);
+
+		if (local_error == NULL)
+			value = g_strdup_printf ("%g", float_value);
+	} else if (ARV_IS_GC_STRING (self) && !ARV_IS_GC_ENUMERATION (self)) {
+		value = arv_gc_string_dup_value (ARV_GC_STRING (self), &local_error);
+	} else {
+		/* The enumeration entry names and the boolean strings are not owned by a value buffer */
+		value = g_strdup (arv_gc_feature_node_get_value_as_string (self, &local_error));
+	}
+
+        if (local_error != NULL)
+                g_propagate_error (error, local_error);
+
+	return value;
+}
+
+/* Compares the current node value with @string, parsed the same way as in arv_gc_feature_node_set_value_from_string().
+ * Returns %FALSE if the value can't be read. */
+
+gboolean
+arv_gc_feature_node_is_value_equal_to_string (ArvGcFeatureNode *self, const char *string)
+{
+	GError *local_error = NULL;
+	gboolean is_equal = FALSE;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), FALSE);
+	g_return_val_if_fail (string != NULL, FALSE);
+
+	if (arv_gc_feature_node_get_actual_access_mode (self) == ARV_GC_ACCESS_MODE_WO)
+		return FALSE;
+
+	if (ARV_IS_GC_ENUMERATION (self)) {
+		is_equal = g_strcmp0 (arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (self), &local_error),
+				      string) == 0;
+	} else if (ARV_IS_GC_INTEGER (self)) {
+		is_equal = arv_gc_integer_get_value (ARV_GC_INTEGER (self), &local_error) ==
+			g_ascii_strtoll (string, NULL, 0);
+	} else if (ARV_IS_GC_FLOAT (self)) {
+		is_equal = arv_gc_float_get_value (ARV_GC_FLOAT (self), &local_error) == g_ascii_strtod (string, NULL);
+	} else if (ARV_IS_GC_STRING (self)) {
+		char *value = arv_gc_string_dup_value (ARV_GC_STRING (self), &local_error);
+
+		is_equal = g_strcmp0 (value, string) == 0;
+		g_free (value);
+	} else if (ARV_IS_GC_BOOLEAN (self)) {
+		is_equal = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (self), &local_error) ==
+			(g_strcmp0 (string, "true") == 0);
+	}
+
+	if (local_error != NULL) {
+		g_clear_error (&local_error);
+		return FALSE;
+	}
+
+	return is_equal;
+}
+
+static gint arv_gc_feature_node_change_epoch = 0;
+
+/* Protects the dependent lists, the change epochs and the change counts of all the feature nodes. Recursive, as the
+ * dependency tracking walks the graph. */
+static GRecMutex arv_gc_feature_node_dependency_mutex;
+
+static void
+_propagate_change (ArvGcFeatureNode *self, gint epoch)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGcFeatureNodeClass *node_class = ARV_GC_FEATURE_NODE_GET_CLASS (self);
+	GSList *iter;
+
+	/* Already visited during this propagation, the graph may contain cycles */
+	if (priv->change_epoch == epoch)
+		return;
+
+	priv->change_epoch = epoch;
+	priv->change_count++;
+
+	if (node_class->invalidate != NULL)
+		node_class->invalidate (self);
+
+	if (priv->n_watches > 0)
+		arv_gc_queue_feature_change (arv_gc_node_get_genicam (ARV_GC_NODE (self)), self);
+
+	for (iter = priv->dependents; iter != NULL; iter = iter->next)
+		_propagate_change (iter->data, epoch);
+}
+
+/* Marks the node as changed, and pushes the change to the nodes depending on it, which drop their cached values */
+
 void
 arv_gc_feature_node_increment_change_count (ArvGcFeatureNode *self)
+{
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	_propagate_change (self, g_atomic_int_add (&arv_gc_feature_node_change_epoch, 1) + 1);
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+}
+
+void
+arv_gc_feature_node_add_dependent (ArvGcFeatureNode *self, ArvGcFeatureNode *dependent)
 {
 	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
 
 	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (dependent));
 
-	priv->change_count++;
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	if (dependent != self && g_slist_find (priv->dependents, dependent) == NULL)
+		priv->dependents = g_slist_prepend (priv->dependents, dependent);
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+}
+
+/* Properties linking to the nodes the value of a node is computed from */
+
+static gboolean
+_is_value_dependency (ArvGcPropertyNodeType type)
+{
+	return (type == ARV_GC_PROPERTY_NODE_TYPE_P_VALUE ||
+		type == ARV_GC_PROPERTY_NODE_TYPE_P_VARIABLE ||
+		type == ARV_GC_PROPERTY_NODE_TYPE_P_INDEX ||
+		type == ARV_GC_PROPERTY_NODE_TYPE_P_VALUE_INDEXED ||
+		type == ARV_GC_PROPERTY_NODE_TYPE_P_VALUE_DEFAULT);
+}
+
+/* Registers the node as a dependent of the nodes its value is computed from, recursively, in order to have the
+ * changes of the underlying registers pushed up to it. This is done once, on first use, as the nodes of a lazily
+ * loaded document only exist once they are accessed. */
+
+void
+arv_gc_feature_node_track_dependencies (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvDomNode *child;
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+
+	if (priv->are_dependencies_tracked) {
+		g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+		return;
+	}
+
+	priv->are_dependencies_tracked = TRUE;
+
+	for (child = arv_dom_node_get_first_child (ARV_DOM_NODE (self));
+	     child != NULL;
+	     child = arv_dom_node_get_next_sibling (child)) {
+		if (ARV_IS_GC_PROPERTY_NODE (child) &&
+		    _is_value_dependency (arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (child)))) {
+			ArvGcNode *linked_node;
+
+			linked_node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (child));
+			if (ARV_IS_GC_FEATURE_NODE (linked_node)) {
+				arv_gc_feature_node_add_dependent (ARV_GC_FEATURE_NODE (linked_node), self);
+				arv_gc_feature_node_track_dependencies (ARV_GC_FEATURE_NODE (linked_node));
+			}
+		}
+	}
+
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+}
+
+void
+arv_gc_feature_node_watch (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+
+	/* The changes of the underlying nodes must reach the watched one */
+	arv_gc_feature_node_track_dependencies (self);
+
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	priv->n_watches++;
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+}
+
+void
+arv_gc_feature_node_unwatch (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	if (priv->n_watches > 0)
+		priv->n_watches--;
+	else
+		arv_warning_genicam ("[GcFeatureNode::unwatch] '%s' is not watched", priv->name);
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+}
+
+#define ARV_GC_FEATURE_NODE_STABILITY_MAX_DEPTH	32
+
+static gboolean
+_is_value_stable (ArvGcFeatureNode *self, guint depth)
+{
+	ArvDomNode *child;
+
+	if (ARV_IS_GC_REGISTER_NODE (self))
+		return arv_gc_register_node_is_cache_stable (ARV_GC_REGISTER_NODE (self));
+
+	if (ARV_IS_GC_STRUCT_ENTRY_NODE (self)) {
+		ArvDomNode *struct_register = arv_dom_node_get_parent_node (ARV_DOM_NODE (self));
+
+		return ARV_IS_GC_REGISTER_NODE (struct_register) &&
+			arv_gc_register_node_is_cache_stable (ARV_GC_REGISTER_NODE (struct_register));
+	}
+
+	/* Too deep, or a dependency cycle */
+	if (depth > ARV_GC_FEATURE_NODE_STABILITY_MAX_DEPTH)
+		return FALSE;
+
+	for (child = arv_dom_node_get_first_child (ARV_DOM_NODE (self));
+	     child != NULL;
+	     child = arv_dom_node_get_next_sibling (child)) {
+		if (ARV_IS_GC_PROPERTY_NODE (child) &&
+		    _is_value_dependency (arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (child)))) {
+			ArvGcNode *linked_node;
+
+			linked_node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (child));
+			if (!ARV_IS_GC_FEATURE_NODE (linked_node) ||
+			    !_is_value_stable (ARV_GC_FEATURE_NODE (linked_node), depth + 1))
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* A node value is stable if it is computed from constants and from registers with a stable cache, see
+ * arv_gc_register_node_is_cache_stable(). It then only changes with the change count of the node. */
+
+gboolean
+arv_gc_feature_node_is_value_stable (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGc *genicam;
+	guint epoch;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), FALSE);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	if (!ARV_IS_GC (genicam))
+		return FALSE;
+
+	epoch = arv_gc_get_cache_policy_epoch (genicam);
+
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	if (priv->stability_epoch != epoch) {
+		priv->is_value_stable = _is_value_stable (self, 0);
+		priv->stability_epoch = epoch;
+	}
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+
+	return priv->is_value_stable;
+}
+
+/* Key of the value memoized by a node computing its value from other nodes, to be retrieved before reading them.
+ * Returns 0 if the value must be computed on each access. */
+
+guint64
+arv_gc_feature_node_get_memo_key (ArvGcFeatureNode *self)
+{
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), 0);
+
+	if (!arv_gc_feature_node_is_value_stable (self))
+		return 0;
+
+	arv_gc_feature_node_track_dependencies (self);
+
+	return arv_gc_feature_node_get_change_count (self) + 1;
+}
+
+/* Sum of the change counts of the nodes behind the pIsAvailable and pIsImplemented properties. The counts only grow, an
+ * unchanged sum means an unchanged availability, which can then be cached. */
+
+guint64
+arv_gc_feature_node_get_availability_change_count (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGcPropertyNode *properties[2];
+	guint64 change_count = 0;
+	unsigned i;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), 0);
+
+	properties[0] = priv->is_available;
+	properties[1] = priv->is_implemented;
+
+	for (i = 0; i < G_N_ELEMENTS (properties); i++) {
+		ArvGcNode *linked_node;
+
+		if (properties[i] == NULL)
+			continue;
+
+		linked_node = arv_gc_property_node_get_linked_node (properties[i]);
+		if (ARV_IS_GC_FEATURE_NODE (linked_node)) {
+			arv_gc_feature_node_track_dependencies (ARV_GC_FEATURE_NODE (linked_node));
+			change_count += arv_gc_feature_node_get_change_count (ARV_GC_FEATURE_NODE (linked_node));
+		}
+	}
+
+	return change_count;
 }
 
 guint64
@@ -533,9 +890,15 @@ arv_gc_feature_node_get_change_count (ArvGcFeatureNode *self)
 {
 	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
 
+	guint64 change_count;
+
 	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), 0);
 
-	return priv->change_count;
+	g_rec_mutex_lock (&arv_gc_feature_node_dependency_mutex);
+	change_count = priv->change_count;
+	g_rec_mutex_unlock (&arv_gc_feature_node_dependency_mutex);
+
+	return change_count;
 }
 
 static void
@@ -551,9 +914,8 @@ arv_gc_feature_node_finalize (GObject *object)
 {
 	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (ARV_GC_FEATURE_NODE(object));
 
-	g_clear_pointer (&priv->name, g_free);
-        g_clear_pointer (&priv->comment, g_free);
 	g_clear_pointer (&priv->string_buffer, g_free);
+	g_clear_pointer (&priv->dependents, g_slist_free);
 
 	G_OBJECT_CLASS (arv_gc_feature_node_parent_class)->finalize (object);
 }
@@ -44,6 +44,9 @@ struct _ArvGcFeatureNodeClass {
 	ArvGcAccessMode		(*get_access_mode)	(ArvGcFeatureNode *gc_feature_node);
 
         ArvGcAccessMode        default_access_mode;
+
+	/* Appended after the existing members, for the ABI compatibility of the subclasses */
+	void			(*invalidate)		(ArvGcFeatureNode *gc_feature_node);
 };
 
 ARV_API const char *		arv_gc_feature_node_get_name			(ArvGcFeatureNode *gc_feature_node);
@@ -64,6 +67,7 @@ ARV_API ArvGcAccessMode		arv_gc_feature_node_get_actual_access_mode	(ArvGcFeatur
 ARV_API void			arv_gc_feature_node_set_value_from_string	(ArvGcFeatureNode *gc_feature_node, const char *string,
 										 GError **error);
 ARV_API const char *		arv_gc_feature_node_get_value_as_string		(ArvGcFeatureNode *gc_feature_node, GError **error);
+ARV_API char *			arv_gc_feature_node_dup_value_as_string		(ArvGcFeatureNode *gc_feature_node, GError **error);
 
 G_END_DECLS
 
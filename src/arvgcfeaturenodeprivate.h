@@ -32,6 +32,16 @@ G_BEGIN_DECLS
 
 void			arv_gc_feature_node_increment_change_count	(ArvGcFeatureNode *gc_feature_node);
 guint64 		arv_gc_feature_node_get_change_count 		(ArvGcFeatureNode *gc_feature_node);
+void			arv_gc_feature_node_add_dependent		(ArvGcFeatureNode *gc_feature_node,
+									 ArvGcFeatureNode *dependent);
+void			arv_gc_feature_node_track_dependencies		(ArvGcFeatureNode *gc_feature_node);
+void			arv_gc_feature_node_watch			(ArvGcFeatureNode *gc_feature_node);
+void			arv_gc_feature_node_unwatch			(ArvGcFeatureNode *gc_feature_node);
+gboolean		arv_gc_feature_node_is_value_stable		(ArvGcFeatureNode *gc_feature_node);
+guint64			arv_gc_feature_node_get_memo_key		(ArvGcFeatureNode *gc_feature_node);
+guint64			arv_gc_feature_node_get_availability_change_count	(ArvGcFeatureNode *gc_feature_node);
+gboolean		arv_gc_feature_node_is_value_equal_to_string	(ArvGcFeatureNode *gc_feature_node,
+									 const char *string);
 
 static inline gboolean
 arv_gc_feature_node_check_write_access (ArvGcFeatureNode *gc_feature_node, GError **error)
@@ -27,6 +27,7 @@
 
 #include <arvgcfloat.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvgcdefaultsprivate.h>
 #include <arvgc.h>
 #include <arvmisc.h>
@@ -43,25 +44,28 @@ G_DEFINE_INTERFACE (ArvGcFloat, arv_gc_float, G_TYPE_OBJECT)
 double
 arv_gc_float_get_value (ArvGcFloat *gc_float, GError **error)
 {
+	double value = 0.0;
+
 	g_return_val_if_fail (ARV_IS_GC_FLOAT (gc_float), 0.0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0.0);
 
-        if (!arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_float), error))
-                return 0.0;
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_float));
+
+        if (arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_float), error))
+		value = ARV_GC_FLOAT_GET_IFACE (gc_float)->get_value (gc_float, error);
+
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_float));
 
-	return ARV_GC_FLOAT_GET_IFACE (gc_float)->get_value (gc_float, error);
+	return value;
 }
 
-void
-arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
+static void
+_set_value (ArvGcFloat *gc_float, double value, GError **error)
 {
 	ArvGc *genicam;
 	ArvRangeCheckPolicy policy;
 	GError *local_error = NULL;
 
-	g_return_if_fail (ARV_IS_GC_FLOAT (gc_float));
-	g_return_if_fail (error == NULL || *error == NULL);
-
         if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (gc_float), error))
                 return;
 
@@ -107,6 +111,17 @@ arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
 	ARV_GC_FLOAT_GET_IFACE (gc_float)->set_value (gc_float, value, error);
 }
 
+void
+arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
+{
+	g_return_if_fail (ARV_IS_GC_FLOAT (gc_float));
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_float));
+	_set_value (gc_float, value, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_float));
+}
+
 /**
  * arv_gc_float_get_min:
  * @gc_float: a #ArvGcFloat
@@ -125,8 +140,15 @@ arv_gc_float_get_min (ArvGcFloat *gc_float, GError **error)
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->get_min != NULL)
-		return float_interface->get_min (gc_float, error);
+	if (float_interface->get_min != NULL) {
+		double min;
+
+		arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_float));
+		min = float_interface->get_min (gc_float, error);
+		arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_float));
+
+		return min;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "[%s] <Min> node not found",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
@@ -152,8 +174,15 @@ arv_gc_float_get_max (ArvGcFloat *gc_float, GError **error)
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->get_max != NULL)
-		return float_interface->get_max (gc_float, error);
+	if (float_interface->get_max != NULL) {
+		double max;
+
+		arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_float));
+		max = float_interface->get_max (gc_float, error);
+		arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_float));
+
+		return max;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "[%s] <Max> node not found",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
@@ -28,7 +28,7 @@
 #include <arvgcfloatnode.h>
 #include <arvgcfloat.h>
 #include <arvgcinteger.h>
-#include <arvgcvalueindexednode.h>
+#include <arvgcvalueindexednodeprivate.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcdefaultsprivate.h>
 #include <arvgc.h>
@@ -51,6 +51,9 @@ struct _ArvGcFloatNode {
 	ArvGcPropertyNode *index;
 	GSList *value_indexed_nodes;
 	ArvGcPropertyNode *value_default;
+	/* Sorted on the first access, once the children are all known */
+	gsize is_value_index_sorted;
+	GPtrArray *sorted_value_indexed_nodes;
 };
 
 struct _ArvGcFloatNodeClass {
@@ -142,8 +145,8 @@ _get_value_node (ArvGcFloatNode *gc_float_node, GError **error)
 		return gc_float_node->value;
 
 	if (gc_float_node->index != NULL) {
+		ArvGcPropertyNode *value_node;
 		gint64 index;
-		GSList *iter;
 
 		index = arv_gc_property_node_get_int64 (ARV_GC_PROPERTY_NODE (gc_float_node->index), &local_error);
 		if (local_error != NULL) {
@@ -151,9 +154,15 @@ _get_value_node (ArvGcFloatNode *gc_float_node, GError **error)
 			return NULL;
 		}
 
-		for (iter = gc_float_node->value_indexed_nodes; iter != NULL; iter = iter->next)
-			if (arv_gc_value_indexed_node_get_index (iter->data) == index)
-				return iter->data;
+		if (g_once_init_enter (&gc_float_node->is_value_index_sorted)) {
+			gc_float_node->sorted_value_indexed_nodes =
+				arv_gc_value_indexed_node_sort (gc_float_node->value_indexed_nodes);
+			g_once_init_leave (&gc_float_node->is_value_index_sorted, TRUE);
+		}
+
+		value_node = arv_gc_value_indexed_node_lookup (gc_float_node->sorted_value_indexed_nodes, index);
+		if (value_node != NULL)
+			return value_node;
 
 		if (gc_float_node->value_default != NULL)
 			return gc_float_node->value_default;
@@ -203,6 +212,7 @@ arv_gc_float_node_finalize (GObject *object)
 	G_OBJECT_CLASS (arv_gc_float_node_parent_class)->finalize (object);
 
 	g_slist_free (gc_float_node->value_indexed_nodes);
+	g_clear_pointer (&gc_float_node->sorted_value_indexed_nodes, g_ptr_array_unref);
 }
 
 static void
@@ -36,6 +36,9 @@ typedef struct {
 	ArvGcPropertyNode *display_precision;
 
 	GSList *selecteds;
+
+	gsize is_endianness_resolved;
+	guint endianness_value;
 } ArvGcFloatRegNodePrivate;
 
 static void arv_gc_float_reg_node_init (ArvGcFloatRegNode *self);
@@ -87,39 +90,52 @@ arv_gc_float_reg_node_post_new_child (ArvDomNode *self, ArvDomNode *child)
 	}
 }
 
+/* The register content is converted directly, without the generic memory copy with endianness conversion */
+
+static guint
+_get_endianness (ArvGcFloatRegNode *self)
+{
+	ArvGcFloatRegNodePrivate *priv = arv_gc_float_reg_node_get_instance_private (self);
+
+	if (g_once_init_enter (&priv->is_endianness_resolved)) {
+		priv->endianness_value = arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+		g_once_init_leave (&priv->is_endianness_resolved, TRUE);
+	}
+
+	return priv->endianness_value;
+}
+
 static gdouble
 arv_gc_float_reg_node_get_float_value (ArvGcFloat *self, GError **error)
 {
-	ArvGcFloatRegNodePrivate *priv = arv_gc_float_reg_node_get_instance_private (ARV_GC_FLOAT_REG_NODE (self));
 	GError *local_error = NULL;
 	guint endianness;
 	gint64 length;
 	double v_double = 0.0;
 
-	endianness = arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+	endianness = _get_endianness (ARV_GC_FLOAT_REG_NODE (self));
 	length = arv_gc_register_get_length (ARV_GC_REGISTER (self), &local_error);
 	if (local_error == NULL) {
-		char *buffer;
-
-		buffer = g_malloc (length);
-		arv_gc_register_get (ARV_GC_REGISTER (self), buffer, length, &local_error);
-		if (local_error == NULL) {
-			if (length == 4) {
-				float v_float = 0.0;
-
-				arv_copy_memory_with_endianness (&v_float, sizeof (v_float), G_BYTE_ORDER,
-								buffer, length, endianness);
-
-				v_double = v_float;
-			} else if (length == 8) {
-				arv_copy_memory_with_endianness (&v_double, sizeof (v_double), G_BYTE_ORDER,
-								buffer, length, endianness);
-			} else {
-				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_INVALID_LENGTH,
-					     "Invalid register length for FloatReg node");
+		if (length == 4) {
+			union { guint32 i; float f; } v32;
+
+			arv_gc_register_get (ARV_GC_REGISTER (self), &v32.i, sizeof (v32.i), &local_error);
+			if (local_error == NULL) {
+				v32.i = endianness == G_BIG_ENDIAN ? GUINT32_FROM_BE (v32.i) : GUINT32_FROM_LE (v32.i);
+				v_double = v32.f;
+			}
+		} else if (length == 8) {
+			union { guint64 i; double f; } v64;
+
+			arv_gc_register_get (ARV_GC_REGISTER (self), &v64.i, sizeof (v64.i), &local_error);
+			if (local_error == NULL) {
+				v64.i = endianness == G_BIG_ENDIAN ? GUINT64_FROM_BE (v64.i) : GUINT64_FROM_LE (v64.i);
+				v_double = v64.f;
 			}
+		} else {
+			g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_INVALID_LENGTH,
+				     "Invalid register length for FloatReg node");
 		}
-		g_free (buffer);
 	}
 
 	if (local_error != NULL)
@@ -132,34 +148,29 @@ arv_gc_float_reg_node_get_float_value (ArvGcFloat *self, GError **error)
 static void
 arv_gc_float_reg_node_set_float_value (ArvGcFloat *self, gdouble value, GError **error)
 {
-	ArvGcFloatRegNodePrivate *priv = arv_gc_float_reg_node_get_instance_private (ARV_GC_FLOAT_REG_NODE (self));
 	GError *local_error = NULL;
 	guint endianness;
 	gint64 length;
 
-	endianness = arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+	endianness = _get_endianness (ARV_GC_FLOAT_REG_NODE (self));
 	length = arv_gc_register_get_length (ARV_GC_REGISTER (self), &local_error);
 	if (local_error == NULL) {
-		char *buffer;
-
-		buffer = g_malloc (length);
-		if (local_error == NULL) {
-			if (length == 4) {
-				float v_float = value;
-
-				arv_copy_memory_with_endianness (buffer, length, endianness, &v_float, sizeof (v_float), G_BYTE_ORDER);
-			} else if (length == 8) {
-				arv_copy_memory_with_endianness (buffer, length, endianness, &value, sizeof (value), G_BYTE_ORDER);
-			} else {
-				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_INVALID_LENGTH,
-					     "Invalid register length for FloatReg node");
-			}
+		if (length == 4) {
+			union { guint32 i; float f; } v32;
+
+			v32.f = value;
+			v32.i = endianness == G_BIG_ENDIAN ? GUINT32_TO_BE (v32.i) : GUINT32_TO_LE (v32.i);
+			arv_gc_register_set (ARV_GC_REGISTER (self), &v32.i, sizeof (v32.i), &local_error);
+		} else if (length == 8) {
+			union { guint64 i; double f; } v64;
+
+			v64.f = value;
+			v64.i = endianness == G_BIG_ENDIAN ? GUINT64_TO_BE (v64.i) : GUINT64_TO_LE (v64.i);
+			arv_gc_register_set (ARV_GC_REGISTER (self), &v64.i, sizeof (v64.i), &local_error);
+		} else {
+			g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_INVALID_LENGTH,
+				     "Invalid register length for FloatReg node");
 		}
-
-		if (local_error == NULL)
-			arv_gc_register_set (ARV_GC_REGISTER (self), buffer, length, &local_error);
-
-		g_free (buffer);
 	}
 
 	if (local_error != NULL)
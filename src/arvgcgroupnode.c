@@ -27,12 +27,13 @@
 
 #include <arvgcgroupnode.h>
 #include <arvgc.h>
+#include <arvdomdocumentprivate.h>
 #include <string.h>
 
 struct _ArvGcGroupNode {
 	ArvGcFeatureNode base;
 
-	char *comment;
+	const char *comment;
 };
 
 struct _ArvGcGroupNodeClass {
@@ -57,8 +58,8 @@ arv_gc_group_node_set_attribute (ArvDomElement *self, const char* name, const ch
 	ArvGcGroupNode *node = ARV_GC_GROUP_NODE (self);
 
 	if (strcmp (name, "Comment") == 0) {
-		g_free (node->comment);
-		node->comment = g_strdup (value);
+		node->comment = arv_dom_document_intern_string
+			(ARV_DOM_DOCUMENT (arv_gc_node_get_genicam (ARV_GC_NODE (self))), value);
 	}
 }
 
@@ -90,24 +91,12 @@ arv_gc_group_node_init (ArvGcGroupNode *gc_group_node)
 {
 }
 
-static void
-arv_gc_group_node_finalize (GObject *object)
-{
-	ArvGcGroupNode *group_node = ARV_GC_GROUP_NODE (object);
-
-	g_free (group_node->comment);
-
-	G_OBJECT_CLASS (arv_gc_group_node_parent_class)->finalize (object);
-}
-
 static void
 arv_gc_group_node_class_init (ArvGcGroupNodeClass *this_class)
 {
-	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
 	ArvDomNodeClass *dom_node_class = ARV_DOM_NODE_CLASS (this_class);
 	ArvDomElementClass *dom_element_class = ARV_DOM_ELEMENT_CLASS (this_class);
 
-	object_class->finalize = arv_gc_group_node_finalize;
 	dom_node_class->get_node_name = arv_gc_group_node_get_node_name;
 	dom_element_class->set_attribute = arv_gc_group_node_set_attribute;
 	dom_element_class->get_attribute = arv_gc_group_node_get_attribute;
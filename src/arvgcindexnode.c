@@ -25,10 +25,11 @@
  * @short_description: Class for Index nodes
  */
 
-#include <arvgcindexnode.h>
+#include <arvgcindexnodeprivate.h>
 #include <arvgcpropertynode.h>
 #include <arvgcinteger.h>
 #include <arvgc.h>
+#include <arvdomdocumentprivate.h>
 #include <arvdomtext.h>
 #include <arvmisc.h>
 #include <string.h>
@@ -36,7 +37,7 @@
 struct _ArvGcIndexNode {
 	ArvGcPropertyNode	base;
 
-	char *offset;
+	const char *offset;
 	gboolean is_p_offset;
 };
 
@@ -67,13 +68,13 @@ arv_gc_index_node_set_attribute (ArvDomElement *self, const char *name, const ch
 {
 	ArvGcIndexNode *index_node = ARV_GC_INDEX_NODE (self);
 
+	ArvDomDocument *document = ARV_DOM_DOCUMENT (arv_gc_node_get_genicam (ARV_GC_NODE (self)));
+
 	if (strcmp (name, "Offset") == 0) {
-		g_free (index_node->offset);
-		index_node->offset = g_strdup (value);
+		index_node->offset = arv_dom_document_intern_string (document, value);
 		index_node->is_p_offset = FALSE;
 	} else if (strcmp (name, "pOffset") == 0) {
-		g_free (index_node->offset);
-		index_node->offset = g_strdup (value);
+		index_node->offset = arv_dom_document_intern_string (document, value);
 		index_node->is_p_offset = TRUE;
 	}
 }
@@ -128,6 +129,19 @@ arv_gc_index_node_get_index (ArvGcIndexNode *index_node, gint64 default_offset,
 	return offset * node_value;
 }
 
+/* Node providing the offset, or NULL for a constant offset */
+
+ArvGcNode *
+arv_gc_index_node_get_offset_node (ArvGcIndexNode *index_node)
+{
+	g_return_val_if_fail (ARV_IS_GC_INDEX_NODE (index_node), NULL);
+
+	if (index_node->offset == NULL || !index_node->is_p_offset)
+		return NULL;
+
+	return arv_gc_get_node (arv_gc_node_get_genicam (ARV_GC_NODE (index_node)), index_node->offset);
+}
+
 ArvGcNode *
 arv_gc_index_node_new (void)
 {
@@ -141,24 +155,12 @@ arv_gc_index_node_init (ArvGcIndexNode *index_node)
 	index_node->is_p_offset = FALSE;
 }
 
-static void
-arv_gc_index_node_finalize (GObject *object)
-{
-	ArvGcIndexNode *index_node = ARV_GC_INDEX_NODE (object);
-
-	g_free (index_node->offset);
-
-	G_OBJECT_CLASS (arv_gc_index_node_parent_class)->finalize (object);
-}
-
 static void
 arv_gc_index_node_class_init (ArvGcIndexNodeClass *this_class)
 {
-	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
 	ArvDomNodeClass *dom_node_class = ARV_DOM_NODE_CLASS (this_class);
 	ArvDomElementClass *dom_element_class = ARV_DOM_ELEMENT_CLASS (this_class);
 
-	object_class->finalize = arv_gc_index_node_finalize;
 	dom_node_class->get_node_name = arv_gc_index_node_get_node_name;
 	dom_node_class->can_append_child = arv_gc_index_node_can_append_child;
 	dom_element_class->set_attribute = arv_gc_index_node_set_attribute;
@@ -27,6 +27,7 @@
 
 #include <arvgcinteger.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 #include <arvgc.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
@@ -41,25 +42,28 @@ G_DEFINE_INTERFACE (ArvGcInteger, arv_gc_integer, G_TYPE_OBJECT)
 gint64
 arv_gc_integer_get_value (ArvGcInteger *gc_integer, GError **error)
 {
+	gint64 value = 0;
+
 	g_return_val_if_fail (ARV_IS_GC_INTEGER (gc_integer), 0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0);
 
-        if (!arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_integer), error))
-                return 0;
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_integer));
+
+        if (arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_integer), error))
+		value = ARV_GC_INTEGER_GET_IFACE (gc_integer)->get_value (gc_integer, error);
+
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_integer));
 
-	return ARV_GC_INTEGER_GET_IFACE (gc_integer)->get_value (gc_integer, error);
+	return value;
 }
 
-void
-arv_gc_integer_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
+static void
+_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
 {
 	ArvGc *genicam;
 	ArvRangeCheckPolicy policy;
 	GError *local_error = NULL;
 
-	g_return_if_fail (ARV_IS_GC_INTEGER (gc_integer));
-	g_return_if_fail (error == NULL || *error == NULL);
-
         if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (gc_integer), error))
                 return;
 
@@ -107,6 +111,17 @@ arv_gc_integer_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error
 	ARV_GC_INTEGER_GET_IFACE (gc_integer)->set_value (gc_integer, value, error);
 }
 
+void
+arv_gc_integer_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
+{
+	g_return_if_fail (ARV_IS_GC_INTEGER (gc_integer));
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_integer));
+	_set_value (gc_integer, value, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_integer));
+}
+
 gint64
 arv_gc_integer_get_min (ArvGcInteger *gc_integer, GError **error)
 {
@@ -117,8 +132,15 @@ arv_gc_integer_get_min (ArvGcInteger *gc_integer, GError **error)
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->get_min != NULL)
-		return integer_interface->get_min (gc_integer, error);
+	if (integer_interface->get_min != NULL) {
+		gint64 min;
+
+		arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_integer));
+		min = integer_interface->get_min (gc_integer, error);
+		arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_integer));
+
+		return min;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "[%s] <Min> node not found",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
@@ -136,8 +158,15 @@ arv_gc_integer_get_max (ArvGcInteger *gc_integer, GError **error)
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->get_max != NULL)
-		return integer_interface->get_max (gc_integer, error);
+	if (integer_interface->get_max != NULL) {
+		gint64 max;
+
+		arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_integer));
+		max = integer_interface->get_max (gc_integer, error);
+		arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_integer));
+
+		return max;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "[%s] <Max> node not found",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
@@ -29,7 +29,7 @@
 #include <arvgcinteger.h>
 #include <arvgcfloat.h>
 #include <arvgcselector.h>
-#include <arvgcvalueindexednode.h>
+#include <arvgcvalueindexednodeprivate.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgc.h>
 #include <arvmisc.h>
@@ -49,6 +49,9 @@ struct _ArvGcIntegerNode {
 	ArvGcPropertyNode *index;
 	GSList *value_indexed_nodes;
 	ArvGcPropertyNode *value_default;
+	/* Sorted on the first access, once the children are all known */
+	gsize is_value_index_sorted;
+	GPtrArray *sorted_value_indexed_nodes;
 
 	GSList *selecteds;		/* #ArvGcPropertyNode */
 	GSList *selected_features;	/* #ArvGcFeatureNode */
@@ -142,8 +145,8 @@ _get_value_node (ArvGcIntegerNode *gc_integer_node, GError **error)
 		return gc_integer_node->value;
 
 	if (gc_integer_node->index != NULL) {
+		ArvGcPropertyNode *value_node;
 		gint64 index;
-		GSList *iter;
 
 		index = arv_gc_property_node_get_int64 (ARV_GC_PROPERTY_NODE (gc_integer_node->index), &local_error);
 		if (local_error != NULL) {
@@ -151,11 +154,16 @@ _get_value_node (ArvGcIntegerNode *gc_integer_node, GError **error)
 			return NULL;
 		}
 
-		for (iter = gc_integer_node->value_indexed_nodes; iter != NULL; iter = iter->next) {
-			if (arv_gc_value_indexed_node_get_index (iter->data) == index)
-				return iter->data;
+		if (g_once_init_enter (&gc_integer_node->is_value_index_sorted)) {
+			gc_integer_node->sorted_value_indexed_nodes =
+				arv_gc_value_indexed_node_sort (gc_integer_node->value_indexed_nodes);
+			g_once_init_leave (&gc_integer_node->is_value_index_sorted, TRUE);
 		}
 
+		value_node = arv_gc_value_indexed_node_lookup (gc_integer_node->sorted_value_indexed_nodes, index);
+		if (value_node != NULL)
+			return value_node;
+
 		if (gc_integer_node->value_default != NULL)
 			return gc_integer_node->value_default;
 	}
@@ -204,6 +212,7 @@ arv_gc_integer_node_finalize (GObject *object)
 	G_OBJECT_CLASS (arv_gc_integer_node_parent_class)->finalize (object);
 
 	g_clear_pointer (&gc_integer_node->value_indexed_nodes, g_slist_free);
+	g_clear_pointer (&gc_integer_node->sorted_value_indexed_nodes, g_ptr_array_unref);
 	g_clear_pointer (&gc_integer_node->selecteds, g_slist_free);
 	g_clear_pointer (&gc_integer_node->selected_features, g_slist_free);
 }
@@ -35,6 +35,11 @@ typedef struct {
 
 	GSList *selecteds;
 	GSList *selected_features;
+
+	/* Sign and Endianess are constant, resolved on the first access */
+	gsize are_constants_resolved;
+	ArvGcSignedness signedness_value;
+	guint endianness_value;
 } ArvGcIntRegNodePrivate;
 
 static void arv_gc_int_reg_node_init (ArvGcIntRegNode *self);
@@ -85,15 +90,29 @@ arv_gc_int_reg_node_post_new_child (ArvDomNode *self, ArvDomNode *child)
 	}
 }
 
+static ArvGcIntRegNodePrivate *
+_resolve_constants (ArvGcIntRegNode *self)
+{
+	ArvGcIntRegNodePrivate *priv = arv_gc_int_reg_node_get_instance_private (self);
+
+	if (g_once_init_enter (&priv->are_constants_resolved)) {
+		priv->signedness_value = arv_gc_property_node_get_sign (priv->sign, ARV_GC_SIGNEDNESS_UNSIGNED);
+		priv->endianness_value = arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+		g_once_init_leave (&priv->are_constants_resolved, TRUE);
+	}
+
+	return priv;
+}
+
 static gint64
 arv_gc_int_reg_node_get_integer_value (ArvGcInteger *self, GError **error)
 {
-	ArvGcIntRegNodePrivate *priv = arv_gc_int_reg_node_get_instance_private (ARV_GC_INT_REG_NODE (self));
+	ArvGcIntRegNodePrivate *priv = _resolve_constants (ARV_GC_INT_REG_NODE (self));
 
 	return arv_gc_register_node_get_masked_integer_value (ARV_GC_REGISTER_NODE (self),
 							      0, 31,
-							      arv_gc_property_node_get_sign (priv->sign, ARV_GC_SIGNEDNESS_UNSIGNED),
-							      arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN),
+							      priv->signedness_value,
+							      priv->endianness_value,
 							      ARV_GC_CACHABLE_UNDEFINED,
 							      FALSE, error);
 }
@@ -101,12 +120,12 @@ arv_gc_int_reg_node_get_integer_value (ArvGcInteger *self, GError **error)
 static void
 arv_gc_int_reg_node_set_integer_value (ArvGcInteger *self, gint64 value, GError **error)
 {
-	ArvGcIntRegNodePrivate *priv = arv_gc_int_reg_node_get_instance_private (ARV_GC_INT_REG_NODE (self));
+	ArvGcIntRegNodePrivate *priv = _resolve_constants (ARV_GC_INT_REG_NODE (self));
 
 	arv_gc_register_node_set_masked_integer_value (ARV_GC_REGISTER_NODE (self),
 						       0, 31,
-						       arv_gc_property_node_get_sign (priv->sign, ARV_GC_SIGNEDNESS_UNSIGNED),
-						       arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN),
+						       priv->signedness_value,
+						       priv->endianness_value,
 						       ARV_GC_CACHABLE_UNDEFINED,
 						       FALSE, value, error);
 }
@@ -25,7 +25,7 @@
  * @short_description: Class for Port nodes
  */
 
-#include <arvgcport.h>
+#include <arvgcportprivate.h>
 #include <arvgcregisterdescriptionnode.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvdevice.h>
@@ -33,7 +33,7 @@
 #include <arvchunkparserprivate.h>
 #include <arvbuffer.h>
 #include <arvgcpropertynode.h>
-#include <arvgc.h>
+#include <arvgcprivate.h>
 #include <memory.h>
 
 typedef struct {
@@ -49,6 +49,10 @@ static ArvGvLegacyInfos arv_gc_port_legacy_infos[] = {
 typedef struct {
 	ArvGcPropertyNode *chunk_id;
 	ArvGcPropertyNode *event_id;
+	guint chunk_id_value;
+	gboolean has_chunk_id_value;
+	guint event_id_value;
+	gboolean has_event_id_value;
 	gboolean has_done_legacy_check;
 	gboolean has_legacy_infos;
 } ArvGcPortPrivate;
@@ -84,6 +88,7 @@ _post_new_child (ArvDomNode *self, ArvDomNode *child)
 		switch (arv_gc_property_node_get_node_type (property_node)) {
 			case ARV_GC_PROPERTY_NODE_TYPE_CHUNK_ID:
 				node->priv->chunk_id = property_node;
+				node->priv->has_chunk_id_value = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_EVENT_ID:
 				node->priv->event_id = property_node;
@@ -137,6 +142,30 @@ _use_legacy_endianness_mechanism (ArvGcPort *port, guint64 length)
 	return length == 4 && port->priv->has_legacy_infos;
 }
 
+static guint
+_get_chunk_id (ArvGcPort *port)
+{
+	if (!port->priv->has_chunk_id_value) {
+		port->priv->chunk_id_value = g_ascii_strtoll (arv_gc_property_node_get_string (port->priv->chunk_id,
+											       NULL), NULL, 16);
+		port->priv->has_chunk_id_value = TRUE;
+	}
+
+	return port->priv->chunk_id_value;
+}
+
+static guint
+_get_event_id (ArvGcPort *port)
+{
+	if (!port->priv->has_event_id_value) {
+		port->priv->event_id_value = g_ascii_strtoll (arv_gc_property_node_get_string (port->priv->event_id,
+											       NULL), NULL, 16);
+		port->priv->has_event_id_value = TRUE;
+	}
+
+	return port->priv->event_id_value;
+}
+
 void
 arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length, GError **error)
 {
@@ -161,7 +190,7 @@ arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length
 			size_t chunk_data_size;
 			guint chunk_id;
 
-			chunk_id = g_ascii_strtoll (arv_gc_property_node_get_string (port->priv->chunk_id, NULL), NULL, 16);
+			chunk_id = _get_chunk_id (port);
 			chunk_data = (char *) arv_buffer_get_chunk_data (chunk_data_buffer, chunk_id, &chunk_data_size);
 
 			if (chunk_data != NULL) {
@@ -174,25 +203,54 @@ arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length
 			}
 		}
 	} else if (port->priv->event_id != NULL) {
-		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_EVENT_IMPLEMENTATION,
-			     "[%s] Events not implemented",
-                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (port)));
+		ArvDevice *device;
+		GBytes *event_data = NULL;
+		guint event_id;
+
+		device = arv_gc_get_device (genicam);
+		event_id = _get_event_id (port);
+
+		if (ARV_IS_DEVICE (device))
+			event_data = arv_device_dup_event_data (device, event_id);
+
+		if (event_data != NULL && address < g_bytes_get_size (event_data)) {
+			size_t event_data_size;
+			const char *data;
+
+			data = g_bytes_get_data (event_data, &event_data_size);
+			memcpy (buffer, data + address, MIN (event_data_size - address, length));
+		} else {
+			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_EVENT_IMPLEMENTATION,
+				     "[%s] Event 0x%04x not received",
+                                     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (port)),
+                                     event_id);
+		}
+
+		g_clear_pointer (&event_data, g_bytes_unref);
 	} else {
 		ArvDevice *device;
 
 		device = arv_gc_get_device (genicam);
 		if (ARV_IS_DEVICE (device)) {
+			gboolean success;
+
 			/* For schema < 1.1.0 and length == 4, register read must be used instead of memory read.
 			 * Only applies to GigE Vision devices. See Appendix 3 of Genicam 2.0 specification. */
 			if (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, length)) {
 				guint32 value = 0;
 
-				arv_device_read_register (device, address, &value, error);
+				success = arv_device_read_register (device, address, &value, error);
 
 				/* For schema < 1.1.0, all registers are big endian. */
 				*((guint32 *) buffer) = GUINT32_TO_BE (value);
 			} else
-				arv_device_read_memory (device, address, length, buffer, error);
+				success = arv_device_read_memory (device, address, length, buffer, error);
+
+			arv_gc_profile_count_transfer (genicam, FALSE, 1, length);
+
+			/* Writes queued by a transaction are not on the device yet */
+			if (success)
+				arv_gc_apply_deferred_writes (genicam, port, address, length, buffer);
 		} else {
 			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET,
 				     "[%s] No device set",
@@ -201,6 +259,66 @@ arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length
 	}
 }
 
+/* Chunk and event ports are backed by host memory, their reads are not device transactions */
+
+gboolean
+arv_gc_port_is_device_port (ArvGcPort *port)
+{
+	g_return_val_if_fail (ARV_IS_GC_PORT (port), FALSE);
+
+	return port->priv->chunk_id == NULL && port->priv->event_id == NULL;
+}
+
+/* Reads several 4 bytes registers in one go. The registers are batched only for GigEVision devices, which have a
+ * multiple register read command, and where register values are big endian, like the memory content. */
+
+gboolean
+arv_gc_port_read_registers (ArvGcPort *port, guint n_registers, const guint64 *addresses, void **buffers,
+			    GError **error)
+{
+	ArvDevice *device;
+	guint32 *values;
+	GError *local_error = NULL;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC_PORT (port), FALSE);
+	g_return_val_if_fail (n_registers == 0 || (addresses != NULL && buffers != NULL), FALSE);
+
+	device = arv_gc_get_device (arv_gc_node_get_genicam (ARV_GC_NODE (port)));
+
+	if (port->priv->chunk_id != NULL || port->priv->event_id != NULL || !ARV_IS_GV_DEVICE (device)) {
+		for (i = 0; i < n_registers && local_error == NULL; i++)
+			arv_gc_port_read (port, buffers[i], addresses[i], sizeof (guint32), &local_error);
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+
+		return TRUE;
+	}
+
+	values = g_new (guint32, n_registers);
+
+	arv_gc_profile_count_transfer (arv_gc_node_get_genicam (ARV_GC_NODE (port)), FALSE,
+				       n_registers, n_registers * sizeof (guint32));
+
+	if (!arv_device_read_registers (device, n_registers, addresses, values, error)) {
+		g_free (values);
+		return FALSE;
+	}
+
+	for (i = 0; i < n_registers; i++) {
+		*((guint32 *) buffers[i]) = GUINT32_TO_BE (values[i]);
+		arv_gc_apply_deferred_writes (arv_gc_node_get_genicam (ARV_GC_NODE (port)), port,
+					      addresses[i], sizeof (guint32), buffers[i]);
+	}
+
+	g_free (values);
+
+	return TRUE;
+}
+
 void
 arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 length, GError **error)
 {
@@ -228,7 +346,7 @@ arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 lengt
 			size_t chunk_data_size;
 			guint chunk_id;
 
-			chunk_id = g_ascii_strtoll (arv_gc_property_node_get_string (port->priv->chunk_id, NULL), NULL, 16);
+			chunk_id = _get_chunk_id (port);
 			chunk_data = (char *) arv_buffer_get_chunk_data (chunk_data_buffer, chunk_id, &chunk_data_size);
 
 			if (chunk_data != NULL) {
@@ -242,15 +360,24 @@ arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 lengt
 		}
 	} else if (port->priv->event_id != NULL) {
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_EVENT_IMPLEMENTATION,
-			     "[%s] Events  not implemented",
+			     "[%s] Event data can not be written",
                              arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (port)));
 	} else {
 		device = arv_gc_get_device (genicam);
 
 		if (ARV_IS_DEVICE (device)) {
+			gboolean is_register = ARV_IS_GV_DEVICE (device) &&
+				_use_legacy_endianness_mechanism (port, length);
+
+			/* Queued until the commit, during a transaction */
+			if (arv_gc_defer_write (genicam, port, address, length, buffer, is_register))
+				return;
+
+			arv_gc_profile_count_transfer (genicam, TRUE, 1, length);
+
 			/* For schema < 1.1.0 and length == 4, register write must be used instead of memory write.
 			 * Only applies to GigE Vision devices. See Appendix 3 of Genicam 2.0 specification. */
-			if (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, length)) {
+			if (is_register) {
 				guint32 value;
 
 				/* For schema < 1.1.0, all registers are big endian. */
@@ -0,0 +1,33 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef ARV_GC_PORT_PRIVATE_H
+#define ARV_GC_PORT_PRIVATE_H
+
+#include <arvgcport.h>
+
+gboolean	arv_gc_port_read_registers	(ArvGcPort *port, guint n_registers, const guint64 *addresses,
+						 void **buffers, GError **error);
+gboolean	arv_gc_port_is_device_port	(ArvGcPort *port);
+
+#endif
@@ -24,7 +24,35 @@
 #define ARV_GC_PRIVATE_H
 
 #include <arvgc.h>
+#include <arvshadowmemoryprivate.h>
 
 ARV_API guint64            arv_gc_register_cache_error_add         (ArvGc *genicam, guint64 n_errors);
+void			arv_gc_register_cache_lookup_add	(ArvGc *genicam, gboolean is_hit);
+void			arv_gc_get_register_cache_statistics	(ArvGc *genicam, guint64 *n_hits, guint64 *n_misses,
+								 guint64 *n_errors);
+
+void			arv_gc_profile_enter			(ArvGcFeatureNode *node);
+void			arv_gc_profile_leave			(ArvGcFeatureNode *node);
+void			arv_gc_profile_count_transfer		(ArvGc *genicam, gboolean is_write,
+								 guint n_transfers, guint64 n_bytes);
+
+guint			arv_gc_get_node_generation		(void);
+guint			arv_gc_get_cache_policy_epoch		(ArvGc *genicam);
+void			arv_gc_invalidate_register_caches	(ArvGc *genicam);
+ArvShadowMemory *	arv_gc_get_shadow_memory		(ArvGc *genicam);
+
+ArvGc *			arv_gc_new_from_document		(ArvDevice *device, ArvDomDocument *document,
+								 const void *xml, size_t size, GBytes *compiled);
+ArvGc *			arv_gc_new_trusted			(ArvDevice *device, const void *xml, size_t size,
+								 const char *key);
+void			arv_gc_template_cache_cleanup		(void);
+
+gboolean		arv_gc_defer_write			(ArvGc *genicam, ArvGcPort *port,
+								 guint64 address, guint64 length, const void *buffer,
+								 gboolean is_register);
+void			arv_gc_queue_feature_change		(ArvGc *genicam, ArvGcFeatureNode *node);
+
+void			arv_gc_apply_deferred_writes		(ArvGc *genicam, ArvGcPort *port,
+								 guint64 address, guint64 length, void *buffer);
 
 #endif
@@ -34,7 +34,7 @@
 #include <arvgcfloat.h>
 #include <arvgcboolean.h>
 #include <arvgcstring.h>
-#include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvdomtext.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
@@ -53,8 +53,13 @@ typedef struct {
 
 	char *name;
 
-	gboolean value_data_up_to_date;
+	gint value_data_up_to_date;
+	/* Points to the text child data for the common single child case, or to value_data */
+	const char *value;
 	char *value_data;
+
+	ArvGcNode *linked_node;
+	guint linked_node_generation;
 } ArvGcPropertyNodePrivate;
 
 G_DEFINE_TYPE_WITH_CODE (ArvGcPropertyNode, arv_gc_property_node, ARV_TYPE_GC_NODE, G_ADD_PRIVATE (ArvGcPropertyNode))
@@ -188,6 +193,7 @@ _post_new_child (ArvDomNode *parent, ArvDomNode *child)
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (ARV_GC_PROPERTY_NODE (parent));
 
 	priv->value_data_up_to_date = FALSE;
+	priv->linked_node = NULL;
 }
 
 static void
@@ -196,6 +202,7 @@ _pre_remove_child (ArvDomNode *parent, ArvDomNode *child)
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (ARV_GC_PROPERTY_NODE (parent));
 
 	priv->value_data_up_to_date = FALSE;
+	priv->linked_node = NULL;
 }
 
 /* ArvDomElement implementation */
@@ -227,27 +234,43 @@ arv_gc_property_node_get_attribute (ArvDomElement *self, const char *name)
 
 /* ArvGcPropertyNode implementation */
 
+/* Serializes the value data updates, which may be triggered concurrently by feature reads */
+static GMutex arv_gc_property_node_value_mutex;
+
 static const char *
 _get_value_data (ArvGcPropertyNode *property_node)
 {
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
 	ArvDomNode *dom_node = ARV_DOM_NODE (property_node);
 
-	if (!priv->value_data_up_to_date) {
-		ArvDomNode *iter;
-		GString *string = g_string_new (NULL);
+	if (G_UNLIKELY (!g_atomic_int_get (&priv->value_data_up_to_date))) {
+		g_mutex_lock (&arv_gc_property_node_value_mutex);
 
-		for (iter = arv_dom_node_get_first_child (dom_node);
-		     iter != NULL;
-		     iter = arv_dom_node_get_next_sibling (iter))
-			g_string_append (string, arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (iter)));
-		g_free (priv->value_data);
-		priv->value_data = string->str;
-		g_string_free (string, FALSE);
-		priv->value_data_up_to_date = TRUE;
+		if (!priv->value_data_up_to_date) {
+			ArvDomNode *first_child = arv_dom_node_get_first_child (dom_node);
+
+			g_clear_pointer (&priv->value_data, g_free);
+
+			if (first_child != NULL && arv_dom_node_get_next_sibling (first_child) == NULL) {
+				/* Single text child, its data is used without copy */
+				priv->value = arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (first_child));
+			} else {
+				ArvDomNode *iter;
+				GString *string = g_string_new (NULL);
+
+				for (iter = first_child; iter != NULL; iter = arv_dom_node_get_next_sibling (iter))
+					g_string_append (string,
+							 arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (iter)));
+				priv->value_data = g_string_free (string, FALSE);
+				priv->value = priv->value_data;
+			}
+			g_atomic_int_set (&priv->value_data_up_to_date, TRUE);
+		}
+
+		g_mutex_unlock (&arv_gc_property_node_value_mutex);
 	}
 
-	return priv->value_data;
+	return priv->value;
 }
 
 static void
@@ -256,6 +279,8 @@ _set_value_data (ArvGcPropertyNode *property_node, const char *data)
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
 	ArvDomNode *dom_node = ARV_DOM_NODE (property_node);
 
+	g_mutex_lock (&arv_gc_property_node_value_mutex);
+
 	if (arv_dom_node_get_first_child (dom_node) != NULL) {
 		ArvDomNode *iter;
 
@@ -266,26 +291,47 @@ _set_value_data (ArvGcPropertyNode *property_node, const char *data)
 			arv_dom_character_data_set_data (ARV_DOM_CHARACTER_DATA (iter), "");
 	}
 
-	g_free (priv->value_data);
-	priv->value_data = g_strdup (data);
-	priv->value_data_up_to_date = TRUE;
+	g_clear_pointer (&priv->value_data, g_free);
+	if (arv_dom_node_get_first_child (dom_node) != NULL &&
+	    arv_dom_node_get_next_sibling (arv_dom_node_get_first_child (dom_node)) == NULL) {
+		priv->value = arv_dom_character_data_get_data
+			(ARV_DOM_CHARACTER_DATA (arv_dom_node_get_first_child (dom_node)));
+	} else {
+		priv->value_data = g_strdup (data);
+		priv->value = priv->value_data;
+	}
+	g_atomic_int_set (&priv->value_data_up_to_date, TRUE);
+	priv->linked_node = NULL;
+
+	g_mutex_unlock (&arv_gc_property_node_value_mutex);
 }
 
-static ArvDomNode *
-_get_pvalue_node (ArvGcPropertyNode *property_node)
+/* The linked node is looked up once, and kept until the property value changes, or until a node is replaced in
+ * any genicam document. A node which is not found is not cached, as it may be added later. */
+
+static ArvGcNode *
+_get_linked_node (ArvGcPropertyNode *property_node)
 {
-	ArvDomNode *pvalue_node;
-	const char *node_name;
+	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
 	ArvGc *genicam;
 
-	if (arv_gc_property_node_get_node_type (property_node) < ARV_GC_PROPERTY_NODE_TYPE_P_UNKNONW)
-		return NULL;
+	if (priv->linked_node != NULL && priv->linked_node_generation == arv_gc_get_node_generation ())
+		return priv->linked_node;
 
-	node_name = _get_value_data (property_node);
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (property_node));
-	pvalue_node = ARV_DOM_NODE (arv_gc_get_node (genicam, node_name));
+	priv->linked_node = arv_gc_get_node (genicam, _get_value_data (property_node));
+	priv->linked_node_generation = arv_gc_get_node_generation ();
+
+	return priv->linked_node;
+}
 
-	return pvalue_node;
+static ArvDomNode *
+_get_pvalue_node (ArvGcPropertyNode *property_node)
+{
+	if (arv_gc_property_node_get_node_type (property_node) < ARV_GC_PROPERTY_NODE_TYPE_P_UNKNONW)
+		return NULL;
+
+	return ARV_DOM_NODE (_get_linked_node (property_node));
 }
 
 /**
@@ -496,15 +542,12 @@ arv_gc_property_node_get_node_type (ArvGcPropertyNode *node)
 ArvGcNode *
 arv_gc_property_node_get_linked_node (ArvGcPropertyNode *node)
 {
-	ArvGc *genicam;
-
 	g_return_val_if_fail (ARV_IS_GC_PROPERTY_NODE (node), NULL);
 
 	if (arv_gc_property_node_get_node_type (node) <= ARV_GC_PROPERTY_NODE_TYPE_P_UNKNONW)
 		return NULL;
 
-	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (node));
-	return arv_gc_get_node (genicam, _get_value_data (node));
+	return _get_linked_node (node);
 }
 
 static ArvGcNode *
@@ -1090,6 +1133,7 @@ arv_gc_property_node_init (ArvGcPropertyNode *self)
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (self);
 
 	priv->type = ARV_GC_PROPERTY_NODE_TYPE_UNKNOWN;
+	priv->value = NULL;
 	priv->value_data = NULL;
 	priv->value_data_up_to_date = FALSE;
 }
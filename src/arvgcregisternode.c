@@ -26,8 +26,7 @@
  */
 
 #include <arvgcregisternodeprivate.h>
-#include <arvgcindexnode.h>
-#include <arvgcinvalidatornode.h>
+#include <arvgcindexnodeprivate.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcswissknife.h>
 #include <arvgcregister.h>
@@ -35,7 +34,7 @@
 #include <arvgcselector.h>
 #include <arvgcfloat.h>
 #include <arvgcstring.h>
-#include <arvgcport.h>
+#include <arvgcportprivate.h>
 #include <arvgcprivate.h>
 #include <arvmiscprivate.h>
 #include <arvdebugprivate.h>
@@ -84,13 +83,51 @@ typedef struct {
 	ArvGcPropertyNode *endianness;
 
 	GSList *invalidators;		/* #ArvGcPropertyNode */
-
-	gboolean cached;
+	gsize are_invalidators_tracked;
+
+	/* Properties which can't change after the document is loaded, resolved on the first access. A register with
+	 * constant address and length has a single cache buffer, which skips the address evaluation and the cache
+	 * lookup. */
+	gsize are_constants_resolved;
+	ArvGcCachable cachable_value;
+	guint endianness_value;
+	gboolean has_static_layout;
+	gint64 static_address;
+	gint64 static_length;
+	void *static_cache;
+
+	/* Layout of the registers with a computed address or length, valid while the memo key of the address and
+	 * length inputs is unchanged. The cache buffer is NULL until the first cache access with this layout. */
+	GMutex layout_mutex;
+	guint64 layout_memo_key;
+	gint64 memo_address;
+	gint64 memo_length;
+	void *memo_cache;
+
+	/* Protects the cache table and the cache contents. The flags below are accessed atomically. */
+	GRWLock cache_lock;
+	/* Dirty bit, cleared by the change propagation from the invalidating nodes */
+	gint cached;
+	/* Incremented on each invalidation, for the detection of changes during a register access */
+	gint cache_generation;
 	GHashTable *caches;
+	/* Cache policy overriding the one of the document, or -1 */
+	gint cache_policy;
 	guint n_cache_hits;
 	guint n_cache_misses;
 	guint n_cache_errors;
 
+	/* Last content read on behalf of a StructEntry, served once to each of its siblings during the lifetime set
+	 * by arv_gc_set_struct_entry_snapshot_lifetime(). Tagged with the cache generation, and a bit per entry
+	 * already served. */
+	GMutex snapshot_mutex;
+	guint8 *snapshot;
+	gint64 snapshot_address;
+	gint64 snapshot_length;
+	gint snapshot_generation;
+	gint64 snapshot_time_us;
+	guint64 snapshot_served;
+
 	char v_string[G_ASCII_DTOSTR_BUF_SIZE];
 } ArvGcRegisterNodePrivate;
 
@@ -166,7 +203,7 @@ arv_gc_register_node_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 /* ArvGcRegisterNode implementation */
 
 static gint64
-_get_length (ArvGcRegisterNode *self, GError **error)
+_evaluate_length (ArvGcRegisterNode *self, GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
         GError *local_error = NULL;
@@ -185,7 +222,7 @@ _get_length (ArvGcRegisterNode *self, GError **error)
 }
 
 static guint64
-_get_address (ArvGcRegisterNode *self, GError **error)
+_evaluate_address (ArvGcRegisterNode *self, GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	ArvGc *genicam;
@@ -219,7 +256,7 @@ _get_address (ArvGcRegisterNode *self, GError **error)
 	if (priv->indexes != NULL) {
 		gint64 length;
 
-		length = _get_length (self, &local_error);
+		length = _evaluate_length (self, &local_error);
 		if (local_error != NULL) {
 			g_propagate_prefixed_error (error, local_error, "[%s] ",
                                                     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
@@ -240,20 +277,320 @@ _get_address (ArvGcRegisterNode *self, GError **error)
 	return value;
 }
 
-static ArvGcCachable
-_get_cachable (ArvGcRegisterNode *self)
+static ArvGcRegisterNodePrivate *
+_resolve_constants (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	gboolean has_static_layout;
+	GSList *iter;
+
+	if (!g_once_init_enter (&priv->are_constants_resolved))
+		return priv;
+
+	priv->cachable_value = arv_gc_property_node_get_cachable (priv->cachable,
+								  ARV_GC_REGISTER_NODE_GET_CLASS (self)->default_cachable);
+	priv->endianness_value = arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+
+	has_static_layout = priv->addresses != NULL && priv->swiss_knives == NULL && priv->indexes == NULL &&
+		(priv->length == NULL ||
+		 arv_gc_property_node_get_node_type (priv->length) == ARV_GC_PROPERTY_NODE_TYPE_LENGTH);
+	for (iter = priv->addresses; iter != NULL && has_static_layout; iter = iter->next)
+		if (arv_gc_property_node_get_node_type (iter->data) != ARV_GC_PROPERTY_NODE_TYPE_ADDRESS)
+			has_static_layout = FALSE;
+
+	if (has_static_layout) {
+		GError *local_error = NULL;
+
+		priv->static_address = _evaluate_address (self, &local_error);
+		if (local_error == NULL)
+			priv->static_length = _evaluate_length (self, &local_error);
+		if (local_error != NULL || priv->static_length <= 0)
+			has_static_layout = FALSE;
+		g_clear_error (&local_error);
+	}
+
+	priv->has_static_layout = has_static_layout;
+
+	g_once_init_leave (&priv->are_constants_resolved, TRUE);
+
+	return priv;
+}
+
+static gboolean
+_add_input_memo_key (ArvGcNode *node, guint64 *memo_key)
+{
+	guint64 node_memo_key;
+
+	if (!ARV_IS_GC_FEATURE_NODE (node))
+		return FALSE;
+
+	node_memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (node));
+	if (node_memo_key == 0)
+		return FALSE;
+
+	*memo_key += node_memo_key;
+
+	return TRUE;
+}
+
+static gboolean
+_add_property_memo_key (ArvGcPropertyNode *property_node, guint64 *memo_key)
+{
+	if (arv_gc_property_node_get_node_type (property_node) < ARV_GC_PROPERTY_NODE_TYPE_P_UNKNONW)
+		return TRUE;
+
+	return _add_input_memo_key (arv_gc_property_node_get_linked_node (property_node), memo_key);
+}
+
+/* Sum of the memo keys of the nodes the address and the length are computed from, or 0 if one of them is not stable.
+ * The change counts only grow, an unchanged sum means an unchanged layout. */
+
+static guint64
+_get_layout_memo_key (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	guint64 memo_key = 1;
+	GSList *iter;
+
+	for (iter = priv->addresses; iter != NULL; iter = iter->next)
+		if (!_add_property_memo_key (iter->data, &memo_key))
+			return 0;
+
+	for (iter = priv->swiss_knives; iter != NULL; iter = iter->next)
+		if (!_add_input_memo_key (iter->data, &memo_key))
+			return 0;
+
+	for (iter = priv->indexes; iter != NULL; iter = iter->next) {
+		ArvGcNode *offset_node;
+
+		if (!_add_property_memo_key (iter->data, &memo_key))
+			return 0;
+
+		offset_node = arv_gc_index_node_get_offset_node (iter->data);
+		if (offset_node != NULL && !_add_input_memo_key (offset_node, &memo_key))
+			return 0;
+	}
+
+	if (priv->length != NULL && !_add_property_memo_key (priv->length, &memo_key))
+		return 0;
+
+	return memo_key;
+}
+
+static gboolean
+_lookup_layout_memo (ArvGcRegisterNode *self, guint64 memo_key, gint64 *address, gint64 *length, void **cache)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	gboolean found = FALSE;
+
+	if (memo_key == 0)
+		return FALSE;
+
+	g_mutex_lock (&priv->layout_mutex);
+	if (priv->layout_memo_key == memo_key && (cache == NULL || priv->memo_cache != NULL)) {
+		if (address != NULL)
+			*address = priv->memo_address;
+		if (length != NULL)
+			*length = priv->memo_length;
+		if (cache != NULL)
+			*cache = priv->memo_cache;
+		found = TRUE;
+	}
+	g_mutex_unlock (&priv->layout_mutex);
+
+	return found;
+}
+
+static void
+_store_layout_memo (ArvGcRegisterNode *self, guint64 memo_key, gint64 address, gint64 length, void *cache)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 
-	return arv_gc_property_node_get_cachable (priv->cachable, ARV_GC_REGISTER_NODE_GET_CLASS (self)->default_cachable);
+	if (memo_key == 0)
+		return;
+
+	g_mutex_lock (&priv->layout_mutex);
+	priv->layout_memo_key = memo_key;
+	priv->memo_address = address;
+	priv->memo_length = length;
+	priv->memo_cache = cache;
+	g_mutex_unlock (&priv->layout_mutex);
+}
+
+static gint64
+_get_length (ArvGcRegisterNode *self, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = _resolve_constants (self);
+	gint64 length;
+
+	if (priv->has_static_layout)
+		return priv->static_length;
+
+	if (_lookup_layout_memo (self, _get_layout_memo_key (self), NULL, &length, NULL))
+		return length;
+
+	return _evaluate_length (self, error);
+}
+
+static guint64
+_get_address (ArvGcRegisterNode *self, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = _resolve_constants (self);
+	gint64 address;
+
+	if (priv->has_static_layout)
+		return priv->static_address;
+
+	if (_lookup_layout_memo (self, _get_layout_memo_key (self), &address, NULL, NULL))
+		return address;
+
+	return _evaluate_address (self, error);
+}
+
+static ArvGcCachable
+_get_cachable (ArvGcRegisterNode *self)
+{
+	return _resolve_constants (self)->cachable_value;
 }
 
 static guint
 _get_endianness (ArvGcRegisterNode *self)
+{
+	return _resolve_constants (self)->endianness_value;
+}
+
+/* Registers the node as a dependent of its invalidating nodes, which then reset the cached flag on change. This is
+ * done before the first cache use, a node being never cached before. */
+
+static void
+_track_invalidators (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	GSList *iter;
+
+	if (!g_once_init_enter (&priv->are_invalidators_tracked))
+		return;
+
+	for (iter = priv->invalidators; iter != NULL; iter = iter->next) {
+		ArvGcNode *linked_node = arv_gc_property_node_get_linked_node (iter->data);
+
+		if (ARV_IS_GC_FEATURE_NODE (linked_node)) {
+			arv_gc_feature_node_add_dependent (ARV_GC_FEATURE_NODE (linked_node),
+							   ARV_GC_FEATURE_NODE (self));
+			arv_gc_feature_node_track_dependencies (ARV_GC_FEATURE_NODE (linked_node));
+		}
+	}
+
+	g_once_init_leave (&priv->are_invalidators_tracked, TRUE);
+}
+
+/* Shadow memory serving the register, NULL if the shadow memory is disabled or if the register can't be shadowed.
+ * Registers with a computed layout are not shadowed, as their invalidation would have to cover all their possible
+ * addresses. */
+
+static ArvShadowMemory *
+_get_shadow_memory (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = _resolve_constants (self);
+	ArvShadowMemory *shadow_memory;
+	ArvGcNode *port;
+
+	if (!priv->has_static_layout ||
+	    priv->polling_time != NULL ||
+	    priv->cachable_value == ARV_GC_CACHABLE_NO_CACHE)
+		return NULL;
+
+	shadow_memory = arv_gc_get_shadow_memory (arv_gc_node_get_genicam (ARV_GC_NODE (self)));
+	if (shadow_memory == NULL)
+		return NULL;
+
+	/* Chunk data and event registers are not part of the device memory */
+	port = arv_gc_property_node_get_linked_node (priv->port);
+	if (!ARV_IS_GC_PORT (port) || !arv_gc_port_is_device_port (ARV_GC_PORT (port)))
+		return NULL;
+
+	return shadow_memory;
+}
+
+/* Registers cached by the static policy. Their value can't be changed by any other client of the device. */
+
+static gboolean
+_is_static (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	return priv->polling_time == NULL &&
+		_get_cachable (self) != ARV_GC_CACHABLE_NO_CACHE &&
+		(priv->access_mode == NULL ||
+		 arv_gc_property_node_get_access_mode (priv->access_mode, ARV_GC_ACCESS_MODE_RO) == ARV_GC_ACCESS_MODE_RO);
+}
+
+static ArvRegisterCachePolicy
+_get_cache_policy (ArvGcRegisterNode *self)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	gint cache_policy;
 
-	return arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
+	cache_policy = g_atomic_int_get (&priv->cache_policy);
+	if (cache_policy >= 0)
+		return cache_policy;
+
+	return arv_gc_get_register_cache_policy (arv_gc_node_get_genicam (ARV_GC_NODE (self)));
+}
+
+/* Registers whose value only changes on a write or an invalidation, both propagated to the dependent nodes, which
+ * can then keep the values they compute from it until the next change. Depends on the cache policies. */
+
+gboolean
+arv_gc_register_node_is_cache_stable (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv;
+	ArvRegisterCachePolicy cache_policy;
+	ArvGcNode *port;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), FALSE);
+
+	priv = _resolve_constants (self);
+
+	cache_policy = _get_cache_policy (self);
+	if (cache_policy == ARV_REGISTER_CACHE_POLICY_STATIC && _is_static (self))
+		cache_policy = ARV_REGISTER_CACHE_POLICY_ENABLE;
+
+	if (cache_policy != ARV_REGISTER_CACHE_POLICY_ENABLE ||
+	    priv->polling_time != NULL ||
+	    !priv->has_static_layout ||
+	    _get_cachable (self) == ARV_GC_CACHABLE_NO_CACHE)
+		return FALSE;
+
+	/* Chunk data and event registers change with the bound buffer or event */
+	port = arv_gc_property_node_get_linked_node (priv->port);
+	if (!ARV_IS_GC_PORT (port) || !arv_gc_port_is_device_port (ARV_GC_PORT (port)))
+		return FALSE;
+
+	_track_invalidators (self);
+
+	return TRUE;
+}
+
+/* Address and length of the registers with a constant layout */
+
+gboolean
+arv_gc_register_node_get_static_layout (ArvGcRegisterNode *self, gint64 *address, gint64 *length)
+{
+	ArvGcRegisterNodePrivate *priv;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), FALSE);
+
+	priv = _resolve_constants (self);
+	if (!priv->has_static_layout)
+		return FALSE;
+
+	if (address != NULL)
+		*address = priv->static_address;
+	if (length != NULL)
+		*length = priv->static_length;
+
+	return TRUE;
 }
 
 static gboolean
@@ -261,56 +598,113 @@ _get_cached (ArvGcRegisterNode *self, ArvRegisterCachePolicy *cache_policy)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	ArvGc *genicam;
-	GSList *iter;
-	gboolean cached = priv->cached;
+	gboolean cached;
 
 	*cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
 
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
 	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
 
-	*cache_policy = arv_gc_get_register_cache_policy (genicam);
+	*cache_policy = _get_cache_policy (self);
 
-	if (*cache_policy == ARV_REGISTER_CACHE_POLICY_DISABLE)
-		return FALSE;
+	if (*cache_policy == ARV_REGISTER_CACHE_POLICY_STATIC) {
+		if (_is_static (self))
+			*cache_policy = ARV_REGISTER_CACHE_POLICY_ENABLE;
+		else
+			*cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
+	}
 
-	for (iter = priv->invalidators; iter != NULL; iter = iter->next) {
-		if (arv_gc_invalidator_has_changed (iter->data))
-			cached = FALSE;
+	/* Uncached accesses are counted as misses, each miss being a device access */
+	if (*cache_policy == ARV_REGISTER_CACHE_POLICY_DISABLE) {
+		cached = FALSE;
+	} else {
+		_track_invalidators (self);
+		cached = g_atomic_int_get (&priv->cached);
 	}
 
 	if (cached)
-		priv->n_cache_hits++;
+		g_atomic_int_inc ((gint *) &priv->n_cache_hits);
 	else
-		priv->n_cache_misses++;
+		g_atomic_int_inc ((gint *) &priv->n_cache_misses);
+
+	arv_gc_register_cache_lookup_add (genicam, cached);
 
 	return cached;
 }
 
+/* Sets the cached flag, unless the cache was invalidated since @generation was retrieved, which means a change
+ * happened while the register was being accessed. */
+
+static void
+_validate_cache (ArvGcRegisterNode *self, gint generation)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	g_atomic_int_set (&priv->cached, TRUE);
+	if (g_atomic_int_get (&priv->cache_generation) != generation)
+		g_atomic_int_set (&priv->cached, FALSE);
+}
+
 static void *
 _get_cache (ArvGcRegisterNode *self, gint64 *address, gint64 *length, GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	GError *local_error = NULL;
 	ArvGcCacheKey key;
+	guint64 memo_key = 0;
 	void *cache;
 
-	key.address = _get_address (self, &local_error);
-	if (local_error == NULL)
-		key.length = _get_length (self, &local_error);
+	cache = g_atomic_pointer_get (&priv->static_cache);
+	if (cache != NULL) {
+		if (address != NULL)
+			*address = priv->static_address;
+		if (length != NULL)
+			*length = priv->static_length;
+		return cache;
+	}
+
+	/* The memo key is retrieved before the evaluation, a concurrent change of the inputs leaving the stored
+	 * layout behind the next key */
+	if (!_resolve_constants (self)->has_static_layout) {
+		memo_key = _get_layout_memo_key (self);
+		if (_lookup_layout_memo (self, memo_key, address, length, &cache))
+			return cache;
+	}
+
+	if (priv->has_static_layout) {
+		key.address = priv->static_address;
+		key.length = priv->static_length;
+	} else {
+		key.address = _evaluate_address (self, &local_error);
+		if (local_error == NULL)
+			key.length = _evaluate_length (self, &local_error);
+	}
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return NULL;
 	}
 
+	g_rw_lock_reader_lock (&priv->cache_lock);
 	cache = g_hash_table_lookup (priv->caches, &key);
+	g_rw_lock_reader_unlock (&priv->cache_lock);
 
+	/* Cache buffers are never removed before the node destruction, the pointer stays valid once unlocked */
 	if (cache == NULL) {
-		cache = g_malloc0 (key.length);
-		g_hash_table_replace (priv->caches, arv_gc_cache_key_new (key.address, key.length), cache);
+		g_rw_lock_writer_lock (&priv->cache_lock);
+		cache = g_hash_table_lookup (priv->caches, &key);
+		if (cache == NULL) {
+			cache = g_malloc0 (key.length);
+			g_hash_table_replace (priv->caches, arv_gc_cache_key_new (key.address, key.length), cache);
+		}
+		g_rw_lock_writer_unlock (&priv->cache_lock);
 	}
 
+	if (priv->has_static_layout)
+		g_atomic_pointer_set (&priv->static_cache, cache);
+	else
+		_store_layout_memo (self, memo_key, key.address, key.length, cache);
+
 	if (address != NULL)
 		*address = key.address;
 	if (length != NULL)
@@ -319,6 +713,23 @@ _get_cache (ArvGcRegisterNode *self, gint64 *address, gint64 *length, GError **e
 	return cache;
 }
 
+static void
+arv_gc_register_node_invalidate (ArvGcFeatureNode *gc_feature_node)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (gc_feature_node));
+
+	ArvShadowMemory *shadow_memory;
+
+	g_atomic_int_inc (&priv->cache_generation);
+	g_atomic_int_set (&priv->cached, FALSE);
+
+	/* Without port check, at worst a few useless invalidations of the device memory */
+	_resolve_constants (ARV_GC_REGISTER_NODE (gc_feature_node));
+	shadow_memory = arv_gc_get_shadow_memory (arv_gc_node_get_genicam (ARV_GC_NODE (gc_feature_node)));
+	if (shadow_memory != NULL && priv->has_static_layout)
+		arv_shadow_memory_invalidate (shadow_memory, priv->static_address, priv->static_length);
+}
+
 static ArvGcAccessMode
 arv_gc_register_node_get_access_mode (ArvGcFeatureNode *gc_feature_node)
 {
@@ -330,24 +741,35 @@ arv_gc_register_node_get_access_mode (ArvGcFeatureNode *gc_feature_node)
 	return arv_gc_property_node_get_access_mode (priv->access_mode, ARV_GC_ACCESS_MODE_RO);
 }
 
+/* Must be called with the cache writer lock held */
+
 static void
-_read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *buffer, ArvGcCachable cachable, GError **error)
+_read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *buffer, ArvGcCachable cachable,
+		 gboolean cached, ArvRegisterCachePolicy cache_policy, GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvShadowMemory *shadow_memory = NULL;
 	GError *local_error = NULL;
 	ArvGcNode *port;
-	ArvRegisterCachePolicy cache_policy;
 	void *cache = NULL;
-	gboolean cached;
+	gint generation;
 
-	cached = _get_cached (self, &cache_policy);
+	generation = g_atomic_int_get (&priv->cache_generation);
+
+	/* The shadow memory is the reference for the shadowed registers, its content may come from an overlapping
+	 * register or from a memory prefetch */
+	if (cache_policy == ARV_REGISTER_CACHE_POLICY_ENABLE && cachable != ARV_GC_CACHABLE_NO_CACHE) {
+		shadow_memory = _get_shadow_memory (self);
+		if (shadow_memory != NULL)
+			cached = arv_shadow_memory_read (shadow_memory, address, length, buffer);
+	}
 
 	port = arv_gc_property_node_get_linked_node (priv->port);
 	if (!ARV_IS_GC_PORT (port)) {
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
 			     "[%s] Port not found for node",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
-		priv->cached = FALSE;
+		g_atomic_int_set (&priv->cached, FALSE);
 		return;
 	}
 
@@ -362,7 +784,7 @@ _read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *b
 	if (local_error != NULL) {
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
-                priv->cached = FALSE;
+		g_atomic_int_set (&priv->cached, FALSE);
                 g_free (cache);
                 return;
         }
@@ -371,49 +793,544 @@ _read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *b
 		if (memcmp (cache, buffer, length) != 0) {
 			arv_warning_policies ("Current and cached value mismatch for '%s'\n",
 					      arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
-			priv->n_cache_errors++;
+			g_atomic_int_inc ((gint *) &priv->n_cache_errors);
 
                         arv_gc_register_cache_error_add (arv_gc_node_get_genicam (ARV_GC_NODE (self)), 1);
 		}
 		g_free (cache);
 	}
 
-	if (cachable != ARV_GC_CACHABLE_NO_CACHE)
-		priv->cached = TRUE;
-	else
-		priv->cached = FALSE;
+	if (cachable != ARV_GC_CACHABLE_NO_CACHE) {
+		_validate_cache (self, generation);
+		if (shadow_memory != NULL && !cached && g_atomic_int_get (&priv->cached))
+			arv_shadow_memory_write (shadow_memory, address, length, buffer);
+	} else
+		g_atomic_int_set (&priv->cached, FALSE);
 }
 
+/* Copies the register content to @value, which must be @length bytes long. Cache hits only take the reader lock,
+ * and don't block each other. */
+
+static void
+_read_cache (ArvGcRegisterNode *self, gint64 address, gint64 length, void *cache, void *value, ArvGcCachable cachable,
+	     GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvRegisterCachePolicy cache_policy;
+	GError *local_error = NULL;
+	gboolean cached;
+
+	cached = _get_cached (self, &cache_policy);
+
+	if (cached && cache_policy != ARV_REGISTER_CACHE_POLICY_DEBUG) {
+		ArvShadowMemory *shadow_memory = _get_shadow_memory (self);
+		gboolean hit;
+
+		g_rw_lock_reader_lock (&priv->cache_lock);
+		hit = g_atomic_int_get (&priv->cached);
+		if (hit && shadow_memory != NULL)
+			hit = arv_shadow_memory_read (shadow_memory, address, length, value);
+		else if (hit)
+			memcpy (value, cache, length);
+		g_rw_lock_reader_unlock (&priv->cache_lock);
+
+		if (hit)
+			return;
+	}
+
+	g_rw_lock_writer_lock (&priv->cache_lock);
+
+	/* The cache may have been updated while waiting for the lock */
+	if (cache_policy != ARV_REGISTER_CACHE_POLICY_DISABLE)
+		cached = g_atomic_int_get (&priv->cached);
+
+	_read_from_port (self, address, length, cache, cachable, cached, cache_policy, &local_error);
+	if (local_error == NULL)
+		memcpy (value, cache, length);
+
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+}
+
+/* Serves the read of a StructEntry from the snapshot of the register content, if it is still fresh and wasn't
+ * already used for this entry. A second read of the same entry means a new polling cycle, and refreshes the
+ * snapshot. */
+
+static void
+_read_snapshot (ArvGcRegisterNode *self, gint64 address, gint64 length, void *cache, void *value,
+		ArvGcCachable cachable, guint entry, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	guint64 entry_bit = G_GUINT64_CONSTANT (1) << (entry % 64);
+	GError *local_error = NULL;
+	gint64 lifetime_us;
+	gint64 time_us;
+	gint generation;
+	gboolean hit;
+
+	lifetime_us = arv_gc_get_struct_entry_snapshot_lifetime (genicam);
+	time_us = g_get_monotonic_time ();
+	generation = g_atomic_int_get (&priv->cache_generation);
+
+	g_mutex_lock (&priv->snapshot_mutex);
+	hit = priv->snapshot != NULL &&
+		priv->snapshot_address == address &&
+		priv->snapshot_length == length &&
+		priv->snapshot_generation == generation &&
+		time_us - priv->snapshot_time_us < lifetime_us &&
+		(priv->snapshot_served & entry_bit) == 0;
+	if (hit) {
+		memcpy (value, priv->snapshot, length);
+		priv->snapshot_served |= entry_bit;
+	}
+	g_mutex_unlock (&priv->snapshot_mutex);
+
+	if (hit) {
+		g_atomic_int_inc ((gint *) &priv->n_cache_hits);
+		arv_gc_register_cache_lookup_add (genicam, TRUE);
+		return;
+	}
+
+	_read_cache (self, address, length, cache, value, cachable, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	g_mutex_lock (&priv->snapshot_mutex);
+	if (priv->snapshot == NULL || priv->snapshot_length != length) {
+		g_free (priv->snapshot);
+		priv->snapshot = g_malloc (length);
+	}
+	memcpy (priv->snapshot, value, length);
+	priv->snapshot_address = address;
+	priv->snapshot_length = length;
+	priv->snapshot_generation = generation;
+	priv->snapshot_time_us = time_us;
+	priv->snapshot_served = entry_bit;
+	g_mutex_unlock (&priv->snapshot_mutex);
+}
+
+/* Must be called with the cache writer lock held */
+
 static void
 _write_to_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *buffer, ArvGcCachable cachable, GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvShadowMemory *shadow_memory;
 	GError *local_error = NULL;
 	ArvGcNode *port;
+	gint generation;
 
 	port = arv_gc_property_node_get_linked_node (priv->port);
 	if (!ARV_IS_GC_PORT (port)) {
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
 			     "[%s] Port not found for node",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
-		priv->cached = FALSE;
+		g_atomic_int_set (&priv->cached, FALSE);
 		return;
 	}
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (self));
+	generation = g_atomic_int_get (&priv->cache_generation);
+
+	g_mutex_lock (&priv->snapshot_mutex);
+	priv->snapshot_served = G_MAXUINT64;
+	g_mutex_unlock (&priv->snapshot_mutex);
+
 	arv_gc_port_write (ARV_GC_PORT (port), buffer, address, length, &local_error);
 
+	shadow_memory = _get_shadow_memory (self);
+
 	if (local_error != NULL) {
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
-		priv->cached = FALSE;
+		g_atomic_int_set (&priv->cached, FALSE);
+		if (shadow_memory != NULL)
+			arv_shadow_memory_invalidate (shadow_memory, address, length);
 		return;
 	}
 
 	if (cachable == ARV_GC_CACHABLE_WRITE_THROUGH)
-		priv->cached = TRUE;
+		_validate_cache (self, generation);
 	else
-		priv->cached = FALSE;
+		g_atomic_int_set (&priv->cached, FALSE);
+
+	if (shadow_memory != NULL) {
+		if (g_atomic_int_get (&priv->cached))
+			arv_shadow_memory_write (shadow_memory, address, length, buffer);
+		else
+			arv_shadow_memory_invalidate (shadow_memory, address, length);
+	}
+}
+
+typedef struct {
+	ArvGcRegisterNode *node;
+	ArvGcPort *port;
+	guint64 address;
+	guint64 length;
+	void *cache;
+	gint generation;
+	gboolean is_poll;
+	gboolean was_cached;
+} ArvGcRegisterPrefetch;
+
+/* Same as _get_cached, without the cache statistics update */
+
+static gboolean
+_is_cache_valid (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	_track_invalidators (self);
+
+	return g_atomic_int_get (&priv->cached);
+}
+
+static gint
+_compare_prefetches (gconstpointer a, gconstpointer b)
+{
+	const ArvGcRegisterPrefetch *prefetch_a = a;
+	const ArvGcRegisterPrefetch *prefetch_b = b;
+
+	if (prefetch_a->port != prefetch_b->port)
+		return prefetch_a->port < prefetch_b->port ? -1 : 1;
+	if (prefetch_a->address != prefetch_b->address)
+		return prefetch_a->address < prefetch_b->address ? -1 : 1;
+
+	return 0;
+}
+
+/* Copies the data read for a prefetch into the register cache, unless the register was invalidated meanwhile. For
+ * a poll, a new value is pushed to the dependent nodes, and the cache is validated again after the propagation,
+ * which invalidates the register itself. */
+
+static void
+_complete_prefetch (ArvGcRegisterPrefetch *prefetch, const void *data, gboolean success)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (prefetch->node);
+
+	if (success) {
+		ArvShadowMemory *shadow_memory = _get_shadow_memory (prefetch->node);
+		gboolean has_changed = FALSE;
+
+		g_rw_lock_writer_lock (&priv->cache_lock);
+		if (prefetch->is_poll)
+			has_changed = !prefetch->was_cached || memcmp (prefetch->cache, data, prefetch->length) != 0;
+		memcpy (prefetch->cache, data, prefetch->length);
+		_validate_cache (prefetch->node, prefetch->generation);
+		if (shadow_memory != NULL && g_atomic_int_get (&priv->cached))
+			arv_shadow_memory_write (shadow_memory, prefetch->address, prefetch->length, data);
+		g_rw_lock_writer_unlock (&priv->cache_lock);
+
+		if (has_changed) {
+			arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (prefetch->node));
+
+			g_rw_lock_writer_lock (&priv->cache_lock);
+			memcpy (prefetch->cache, data, prefetch->length);
+			_validate_cache (prefetch->node, g_atomic_int_get (&priv->cache_generation));
+			g_rw_lock_writer_unlock (&priv->cache_lock);
+		}
+	} else
+		g_atomic_int_set (&priv->cached, FALSE);
+}
+
+/* Reads the 4 bytes registers of a port using register read commands, which can address scattered registers in a
+ * single device transaction */
+
+static gboolean
+_prefetch_registers (ArvGcPort *port, GArray *batch, GError **error)
+{
+	GArray *addresses;
+	GPtrArray *buffers;
+	guint32 *values;
+	gboolean success;
+	guint i;
+
+	addresses = g_array_sized_new (FALSE, FALSE, sizeof (guint64), batch->len);
+	buffers = g_ptr_array_sized_new (batch->len);
+
+	/* Registers are read out of the caches, which are only updated under their node lock */
+	values = g_new0 (guint32, batch->len);
+	for (i = 0; i < batch->len; i++) {
+		g_array_append_val (addresses, g_array_index (batch, ArvGcRegisterPrefetch, i).address);
+		g_ptr_array_add (buffers, &values[i]);
+	}
+
+	success = arv_gc_port_read_registers (port, addresses->len, (guint64 *) addresses->data,
+					      buffers->pdata, error);
+
+	for (i = 0; i < batch->len; i++)
+		_complete_prefetch (&g_array_index (batch, ArvGcRegisterPrefetch, i), &values[i], success);
+
+	arv_debug_genicam ("[GcRegisterNode::prefetch] %u register(s) read from port", addresses->len);
+
+	g_array_unref (addresses);
+	g_ptr_array_unref (buffers);
+	g_free (values);
+
+	return success;
+}
+
+/* Reads a contiguous address range covering the registers of @blocks[first..last], using a single memory read */
+
+static gboolean
+_prefetch_block (GArray *blocks, guint first, guint last, guint64 end, GError **error)
+{
+	ArvGcRegisterPrefetch *head = &g_array_index (blocks, ArvGcRegisterPrefetch, first);
+	GError *local_error = NULL;
+	guint8 *data;
+	guint i;
+
+	data = g_malloc0 (end - head->address);
+
+	arv_gc_port_read (head->port, data, head->address, end - head->address, &local_error);
+
+	for (i = first; i <= last; i++) {
+		ArvGcRegisterPrefetch *prefetch = &g_array_index (blocks, ArvGcRegisterPrefetch, i);
+
+		_complete_prefetch (prefetch, data + (prefetch->address - head->address), local_error == NULL);
+	}
+
+	arv_debug_genicam ("[GcRegisterNode::prefetch] %u register(s) read from port in a %" G_GUINT64_FORMAT
+			   " bytes block", last - first + 1, end - head->address);
+
+	g_free (data);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Common implementation of the prefetch and of the poll */
+
+static gboolean
+_read_registers (ArvGcRegisterNode **nodes, guint n_nodes, gboolean is_poll, GError **error)
+{
+	GArray *prefetches;
+	GArray *blocks;
+	GError *local_error = NULL;
+	guint i;
+
+	g_return_val_if_fail (n_nodes == 0 || nodes != NULL, FALSE);
+
+	if (n_nodes == 0)
+		return TRUE;
+
+	prefetches = g_array_new (FALSE, FALSE, sizeof (ArvGcRegisterPrefetch));
+	blocks = g_array_new (FALSE, FALSE, sizeof (ArvGcRegisterPrefetch));
+
+	for (i = 0; i < n_nodes; i++) {
+		ArvGcRegisterNodePrivate *priv;
+		ArvGcRegisterPrefetch prefetch;
+		ArvRegisterCachePolicy cache_policy;
+		ArvGcNode *port;
+		GError *cache_error = NULL;
+		gint64 address;
+		gint64 length;
+
+		if (!ARV_IS_GC_REGISTER_NODE (nodes[i]))
+			continue;
+
+		priv = arv_gc_register_node_get_instance_private (nodes[i]);
+		cache_policy = _get_cache_policy (nodes[i]);
+
+		if (arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (nodes[i])) == ARV_GC_ACCESS_MODE_WO)
+			continue;
+
+		/* A poll always reads the device, for the detection of the changes */
+		prefetch.was_cached = _is_cache_valid (nodes[i]);
+		if (!is_poll &&
+		    (cache_policy == ARV_REGISTER_CACHE_POLICY_DISABLE ||
+		     prefetch.was_cached ||
+		     (cache_policy == ARV_REGISTER_CACHE_POLICY_STATIC && !_is_static (nodes[i])) ||
+		     _get_cachable (nodes[i]) == ARV_GC_CACHABLE_NO_CACHE))
+			continue;
+
+		port = arv_gc_property_node_get_linked_node (priv->port);
+		if (!ARV_IS_GC_PORT (port) || !arv_gc_port_is_device_port (ARV_GC_PORT (port)))
+			continue;
+
+		prefetch.cache = _get_cache (nodes[i], &address, &length, &cache_error);
+		if (cache_error != NULL) {
+			g_clear_error (&cache_error);
+			continue;
+		}
+		if (length <= 0)
+			continue;
+
+		prefetch.node = nodes[i];
+		prefetch.port = ARV_GC_PORT (port);
+		prefetch.address = address;
+		prefetch.length = length;
+		prefetch.generation = g_atomic_int_get (&priv->cache_generation);
+		prefetch.is_poll = is_poll;
+
+		if (length == sizeof (guint32))
+			g_array_append_val (prefetches, prefetch);
+		else
+			g_array_append_val (blocks, prefetch);
+	}
+
+	while (prefetches->len > 0) {
+		ArvGcPort *port = g_array_index (prefetches, ArvGcRegisterPrefetch, 0).port;
+		GArray *batch = g_array_new (FALSE, FALSE, sizeof (ArvGcRegisterPrefetch));
+
+		for (i = 0; i < prefetches->len; ) {
+			ArvGcRegisterPrefetch *prefetch = &g_array_index (prefetches, ArvGcRegisterPrefetch, i);
+
+			if (prefetch->port == port) {
+				g_array_append_val (batch, *prefetch);
+				g_array_remove_index (prefetches, i);
+			} else
+				i++;
+		}
+
+		_prefetch_registers (port, batch, local_error == NULL ? &local_error : NULL);
+
+		g_array_unref (batch);
+	}
+
+	g_array_sort (blocks, _compare_prefetches);
+
+	for (i = 0; i < blocks->len; ) {
+		ArvGcRegisterPrefetch *head = &g_array_index (blocks, ArvGcRegisterPrefetch, i);
+		guint64 end = head->address + head->length;
+		guint last = i;
+
+		while (last + 1 < blocks->len) {
+			ArvGcRegisterPrefetch *next = &g_array_index (blocks, ArvGcRegisterPrefetch, last + 1);
+
+			if (next->port != head->port || next->address > end)
+				break;
+
+			end = MAX (end, next->address + next->length);
+			last++;
+		}
+
+		_prefetch_block (blocks, i, last, end, local_error == NULL ? &local_error : NULL);
+
+		i = last + 1;
+	}
+
+	g_array_unref (prefetches);
+	g_array_unref (blocks);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_register_node_prefetch:
+ * @nodes: (array length=n_nodes): a list of #ArvGcRegisterNode
+ * @n_nodes: number of nodes
+ * @error: a #GError placeholder
+ *
+ * Updates the register cache of @nodes. The 4 bytes registers of each port are read in a single batch. The other
+ * registers are sorted by address, and the adjacent or overlapping ones are merged into blocks, each read using a
+ * single memory read. Nodes with a valid cache, write only, not cachable or not backed by a device port are ignored,
+ * and will be read as usual when accessed, as are the nodes with a disabled register cache. With the static cache
+ * policy, only the static registers are prefetched.
+ *
+ * A read error does not stop the prefetch of the other batches or blocks, the registers involved are simply left
+ * uncached.
+ *
+ * Returns: %TRUE on success, %FALSE if any of the reads failed.
+ */
+
+gboolean
+arv_gc_register_node_prefetch (ArvGcRegisterNode **nodes, guint n_nodes, GError **error)
+{
+	return _read_registers (nodes, n_nodes, FALSE, error);
+}
+
+/**
+ * arv_gc_register_node_poll:
+ * @nodes: (array length=n_nodes): a list of #ArvGcRegisterNode
+ * @n_nodes: number of nodes
+ * @error: a #GError placeholder
+ *
+ * Reads @nodes from the device, using the same batches and blocks as arv_gc_register_node_prefetch(), whatever the
+ * state of their cache, and updates their register cache. The nodes whose content changed since their last cached
+ * value, or without a previous cached value, are marked as changed, which invalidates their dependent nodes and
+ * queues the change notification of the watched features.
+ *
+ * Returns: %TRUE on success, %FALSE if any of the reads failed.
+ */
+
+gboolean
+arv_gc_register_node_poll (ArvGcRegisterNode **nodes, guint n_nodes, GError **error)
+{
+	return _read_registers (nodes, n_nodes, TRUE, error);
+}
+
+/* Polling time in milliseconds, 0 for the registers without polling time */
+
+gint64
+arv_gc_register_node_get_polling_time (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv;
+	GError *local_error = NULL;
+	gint64 polling_time;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), 0);
+
+	priv = arv_gc_register_node_get_instance_private (self);
+	if (priv->polling_time == NULL)
+		return 0;
+
+	polling_time = arv_gc_property_node_get_int64 (priv->polling_time, &local_error);
+	if (local_error != NULL) {
+		g_clear_error (&local_error);
+		return 0;
+	}
+
+	return MAX (polling_time, 0);
+}
+
+/**
+ * arv_gc_register_node_set_cache_policy:
+ * @self: a #ArvGcRegisterNode
+ * @cache_policy: the cache policy of this register, or -1 for the policy of the document
+ *
+ * Overrides the register cache policy of the document for this register. The cached value is dropped.
+ */
+
+void
+arv_gc_register_node_set_cache_policy (ArvGcRegisterNode *self, gint cache_policy)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	g_return_if_fail (ARV_IS_GC_REGISTER_NODE (self));
+
+	g_atomic_int_set (&priv->cache_policy, cache_policy < 0 ? -1 : cache_policy);
+	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (self));
+}
+
+void
+arv_gc_register_node_get_cache_statistics (ArvGcRegisterNode *self,
+					   guint64 *n_hits, guint64 *n_misses, guint64 *n_errors)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	g_return_if_fail (ARV_IS_GC_REGISTER_NODE (self));
+
+	if (n_hits != NULL)
+		*n_hits = (guint) g_atomic_int_get ((gint *) &priv->n_cache_hits);
+	if (n_misses != NULL)
+		*n_misses = (guint) g_atomic_int_get ((gint *) &priv->n_cache_misses);
+	if (n_errors != NULL)
+		*n_errors = (guint) g_atomic_int_get ((gint *) &priv->n_cache_errors);
 }
 
 ArvGcNode *
@@ -428,10 +1345,15 @@ arv_gc_register_node_init (ArvGcRegisterNode *self)
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 
 	priv->cached = FALSE;
+	priv->cache_generation = 0;
+	g_rw_lock_init (&priv->cache_lock);
 	priv->caches = g_hash_table_new_full (arv_gc_cache_key_hash, arv_gc_cache_key_equal, g_free, g_free);
+	priv->cache_policy = -1;
 	priv->n_cache_hits = 0;
 	priv->n_cache_misses = 0;
 	priv->n_cache_errors = 0;
+	g_mutex_init (&priv->snapshot_mutex);
+	g_mutex_init (&priv->layout_mutex);
 }
 
 static void
@@ -445,12 +1367,16 @@ arv_gc_register_node_finalize (GObject *self)
 	g_slist_free (priv->indexes);
 	g_slist_free (priv->invalidators);
 	g_clear_pointer (&priv->caches, g_hash_table_unref);
+	g_rw_lock_clear (&priv->cache_lock);
+	g_clear_pointer (&priv->snapshot, g_free);
+	g_mutex_clear (&priv->snapshot_mutex);
+	g_mutex_clear (&priv->layout_mutex);
 
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
 	if (ARV_IS_GC (genicam)) {
 		ArvRegisterCachePolicy cache_policy;
 
-		cache_policy = arv_gc_get_register_cache_policy (genicam);
+		cache_policy = _get_cache_policy (ARV_GC_REGISTER_NODE (self));
 
 		if (priv->n_cache_hits > 0 || priv->n_cache_misses > 0) {
 			const char *name = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self));
@@ -487,6 +1413,7 @@ arv_gc_register_node_class_init (ArvGcRegisterNodeClass *this_class)
 	dom_node_class->post_new_child = arv_gc_register_node_post_new_child;
 	dom_node_class->pre_remove_child = arv_gc_register_node_pre_remove_child;
 	gc_feature_node_class->get_access_mode = arv_gc_register_node_get_access_mode;
+	gc_feature_node_class->invalidate = arv_gc_register_node_invalidate;
 
 	this_class->default_cachable = ARV_GC_CACHABLE_WRITE_THROUGH;
 }
@@ -515,17 +1442,15 @@ arv_gc_register_node_get (ArvGcRegister *gc_register, void *buffer, guint64 leng
 		return;
 	}
 
-	_read_from_port (gc_register_node, address, cache_length, cache, _get_cachable (gc_register_node), &local_error);
+	_read_cache (gc_register_node, address, cache_length, cache, buffer, _get_cachable (gc_register_node),
+		     &local_error);
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return;
 	}
 
-	if (length > cache_length) {
-		memcpy (buffer, cache, cache_length);
+	if (length > cache_length)
 		memset (((char *) buffer) + cache_length, 0, length - cache_length);
-	} else
-		memcpy (buffer, cache, length);
 
 	arv_debug_genicam ("[GcRegisterNode::get] 0x%" G_GINT64_MODIFIER "x,%" G_GUINT64_FORMAT, address, length);
 }
@@ -534,6 +1459,7 @@ static void
 arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint64 length, GError **error)
 {
 	ArvGcRegisterNode *gc_register_node = ARV_GC_REGISTER_NODE (gc_register);
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (gc_register_node);
 	GError *local_error = NULL;
 	void *cache;
 	gint64 address;
@@ -552,6 +1478,8 @@ arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint6
 		return;
 	}
 
+	g_rw_lock_writer_lock (&priv->cache_lock);
+
 	if (cache_length > length) {
 		memcpy (cache, buffer, length);
 		memset (((char *) cache) + length, 0, cache_length - length);
@@ -560,6 +1488,8 @@ arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint6
 
 	_write_to_port (gc_register_node, address, cache_length, cache, _get_cachable (gc_register_node), &local_error);
 
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return;
@@ -595,31 +1525,83 @@ arv_gc_register_node_register_interface_init (ArvGcRegisterInterface *interface)
 
 /* ArvGcInteger interface implementation */
 
+/* Conversions between the register content and its value, with a direct path for the 4 and 8 bytes registers */
+
+static guint64
+_load_value (const void *data, gint64 length, guint endianness)
+{
+	guint64 value;
+
+	if (length == 4) {
+		guint32 value32;
+
+		memcpy (&value32, data, sizeof (value32));
+		return endianness == G_BIG_ENDIAN ? GUINT32_FROM_BE (value32) : GUINT32_FROM_LE (value32);
+	}
+
+	if (length == 8) {
+		memcpy (&value, data, sizeof (value));
+		return endianness == G_BIG_ENDIAN ? GUINT64_FROM_BE (value) : GUINT64_FROM_LE (value);
+	}
+
+	arv_copy_memory_with_endianness (&value, sizeof (value), G_BYTE_ORDER, (void *) data, length, endianness);
+
+	return value;
+}
+
+static void
+_store_value (void *data, gint64 length, guint endianness, guint64 value)
+{
+	if (length == 4) {
+		guint32 value32 = endianness == G_BIG_ENDIAN ? GUINT32_TO_BE (value) : GUINT32_TO_LE (value);
+
+		memcpy (data, &value32, sizeof (value32));
+	} else if (length == 8) {
+		value = endianness == G_BIG_ENDIAN ? GUINT64_TO_BE (value) : GUINT64_TO_LE (value);
+
+		memcpy (data, &value, sizeof (value));
+	} else
+		arv_copy_memory_with_endianness (data, length, endianness, &value, sizeof (value), G_BYTE_ORDER);
+}
+
 static gint64
 _get_integer_value (ArvGcRegisterNode *gc_register_node,
 		    guint register_lsb, guint register_msb,
 		    ArvGcSignedness signedness, guint endianness,
 		    ArvGcCachable cachable,
-		    gboolean is_masked, GError **error)
+		    gboolean is_masked, gint entry, GError **error)
 {
 	GError *local_error = NULL;
 	gint64 value;
 	guint lsb;
 	guint msb;
 	void *cache;
+	guint8 static_data[sizeof (gint64)];
+	void *data = static_data;
 	gint64 address;
 	gint64 length;
 
 	cache = _get_cache (gc_register_node, &address, &length, &local_error);
-	if (local_error == NULL)
-		_read_from_port (gc_register_node, address, length, cache, cachable, &local_error);
+	if (local_error == NULL) {
+		if ((gsize) length > sizeof (static_data))
+			data = g_malloc (length);
+		if (entry >= 0 && arv_gc_get_struct_entry_snapshot_lifetime
+		    (arv_gc_node_get_genicam (ARV_GC_NODE (gc_register_node))) > 0)
+			_read_snapshot (gc_register_node, address, length, cache, data, cachable, entry, &local_error);
+		else
+			_read_cache (gc_register_node, address, length, cache, data, cachable, &local_error);
+	}
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
+		if (data != static_data)
+			g_free (data);
 		return 0;
 	}
 
-	arv_copy_memory_with_endianness (&value, sizeof (value), G_BYTE_ORDER,
-					cache, length, endianness);
+	value = _load_value (data, length, endianness);
+
+	if (data != static_data)
+		g_free (data);
 
 	if (is_masked) {
 		guint64 mask;
@@ -658,7 +1640,7 @@ _get_integer_value (ArvGcRegisterNode *gc_register_node,
 	}
 
 	arv_debug_genicam ("[GcRegisterNode::_get_integer_value] address = 0x%" G_GINT64_MODIFIER "x, value = 0x%" G_GINT64_MODIFIER "x",
-			 _get_address (gc_register_node, NULL), value);
+			 address, value);
 
 	return value;
 }
@@ -679,7 +1661,28 @@ arv_gc_register_node_get_masked_integer_value (ArvGcRegisterNode *self,
 	if (endianness == 0)
 		endianness = _get_endianness (self);
 
-	return _get_integer_value (self, lsb, msb, signedness, endianness, cachable, is_masked, error);
+	return _get_integer_value (self, lsb, msb, signedness, endianness, cachable, is_masked, -1, error);
+}
+
+/* Same as arv_gc_register_node_get_masked_integer_value, for the StructEntry at position @entry in the children
+ * of @self, whose reads may be coalesced with the ones of its siblings */
+
+gint64
+arv_gc_register_node_get_struct_entry_value (ArvGcRegisterNode *self, guint entry,
+					     guint lsb, guint msb,
+					     ArvGcSignedness signedness, guint endianness,
+					     ArvGcCachable cachable, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), 0);
+	g_return_val_if_fail (error == NULL || *error == NULL, 0);
+
+	if (cachable == ARV_GC_CACHABLE_UNDEFINED)
+		cachable = _get_cachable (self);
+
+	if (endianness == 0)
+		endianness = _get_endianness (self);
+
+	return _get_integer_value (self, lsb, msb, signedness, endianness, cachable, TRUE, entry, error);
 }
 
 static void
@@ -689,12 +1692,16 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 		    ArvGcCachable cachable,
 		    gboolean is_masked, gint64 value, GError **error)
 {
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (gc_register_node);
 	GError *local_error = NULL;
 	guint lsb;
 	guint msb;
 	void *cache;
 	gint64 address;
 	gint64 length;
+	gboolean is_readable;
+	gboolean cached = FALSE;
+	ArvRegisterCachePolicy cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
 
 	cache = _get_cache (gc_register_node, &address, &length, &local_error);
 	if (local_error != NULL) {
@@ -702,20 +1709,32 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 		return;
 	}
 
+	is_readable = ARV_GC_ACCESS_MODE_WO !=
+		arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (gc_register_node));
+	if (is_masked && is_readable)
+		_get_cached (gc_register_node, &cache_policy);
+
+	/* The read-modify-write sequence of masked registers must not interleave with other accesses */
+	g_rw_lock_writer_lock (&priv->cache_lock);
+
 	if (is_masked) {
 		gint64 current_value;
 		guint64 mask;
 
-		if (ARV_GC_ACCESS_MODE_WO != arv_gc_register_node_get_access_mode(ARV_GC_FEATURE_NODE(gc_register_node))) {
-			_read_from_port (gc_register_node, address, length, cache, cachable, &local_error);
+		if (is_readable) {
+			if (cache_policy != ARV_REGISTER_CACHE_POLICY_DISABLE)
+				cached = g_atomic_int_get (&priv->cached);
+
+			_read_from_port (gc_register_node, address, length, cache, cachable, cached, cache_policy,
+					 &local_error);
 			if (local_error != NULL) {
+				g_rw_lock_writer_unlock (&priv->cache_lock);
 				g_propagate_error (error, local_error);
 				return;
 			}
 		}
 
-		arv_copy_memory_with_endianness (&current_value, sizeof (current_value), G_BYTE_ORDER,
-						cache, length, endianness);
+		current_value = _load_value (cache, length, endianness);
 
 		if (endianness == G_LITTLE_ENDIAN) {
 			msb = register_msb;
@@ -740,12 +1759,14 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 	}
 
 	arv_debug_genicam ("[GcRegisterNode::_set_integer_value] address = 0x%" G_GINT64_MODIFIER "x, value = 0x%" G_GINT64_MODIFIER "x",
-			 _get_address (gc_register_node, NULL), value);
+			 address, value);
 
-	arv_copy_memory_with_endianness (cache, length, endianness,
-					&value, sizeof (value), G_BYTE_ORDER);
+	_store_value (cache, length, endianness, value);
 
 	_write_to_port (gc_register_node, address, length, cache, cachable, &local_error);
+
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return;
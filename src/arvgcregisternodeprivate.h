@@ -36,7 +36,23 @@ void 		arv_gc_register_node_set_masked_integer_value 	(ArvGcRegisterNode *gc_reg
 								 ArvGcCachable cachable,
 								 gboolean is_masked,
 								 gint64 value, GError **error);
+gint64		arv_gc_register_node_get_struct_entry_value	(ArvGcRegisterNode *gc_register_node,
+								 guint entry, guint lsb, guint msb,
+								 ArvGcSignedness signedness, guint endianness,
+								 ArvGcCachable cachable, GError **error);
+gboolean	arv_gc_register_node_is_cache_stable		(ArvGcRegisterNode *gc_register_node);
+gboolean	arv_gc_register_node_get_static_layout		(ArvGcRegisterNode *gc_register_node,
+								 gint64 *address, gint64 *length);
 guint 		arv_gc_register_node_get_endianness 		(ArvGcRegisterNode *register_node);
+gboolean	arv_gc_register_node_prefetch			(ArvGcRegisterNode **nodes, guint n_nodes,
+								 GError **error);
+gboolean	arv_gc_register_node_poll			(ArvGcRegisterNode **nodes, guint n_nodes,
+								 GError **error);
+gint64		arv_gc_register_node_get_polling_time		(ArvGcRegisterNode *self);
+void		arv_gc_register_node_set_cache_policy		(ArvGcRegisterNode *self, gint cache_policy);
+void		arv_gc_register_node_get_cache_statistics	(ArvGcRegisterNode *self,
+								 guint64 *n_hits, guint64 *n_misses,
+								 guint64 *n_errors);
 
 
 #endif
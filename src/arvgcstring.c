@@ -28,6 +28,7 @@
 #include <arvgcstring.h>
 #include <arvmisc.h>
 #include <arvgcfeaturenodeprivate.h>
+#include <arvgcprivate.h>
 
 static void
 arv_gc_string_default_init (ArvGcStringInterface *gc_string_iface)
@@ -36,12 +37,16 @@ arv_gc_string_default_init (ArvGcStringInterface *gc_string_iface)
 
 G_DEFINE_INTERFACE (ArvGcString, arv_gc_string, G_TYPE_OBJECT)
 
+/* Serializes the updates of the value buffers owned by the string nodes. Recursive, as a string node may read its
+ * value from another one. */
+static GRecMutex arv_gc_string_mutex;
+
 /**
  * arv_gc_string_get_value:
  * @gc_string: an object implementing #ArvGcString
  * @error: a #GError placeholder, or %NULL to ignore
  *
- * <warning><para>Please note the string content is still owned by the @gc_string object, which means the returned pointer may not be still valid after a new call to this function.</para></warning>
+ * <warning><para>Please note the string content is still owned by the @gc_string object, which means the returned pointer may not be still valid after a new call to this function, from any thread. Use arv_gc_string_dup_value() when the feature may be read from several threads.</para></warning>
  *
  * Returns: the string value.
  */
@@ -49,13 +54,50 @@ G_DEFINE_INTERFACE (ArvGcString, arv_gc_string, G_TYPE_OBJECT)
 const char *
 arv_gc_string_get_value (ArvGcString *gc_string, GError **error)
 {
+	const char *value = NULL;
+
 	g_return_val_if_fail (ARV_IS_GC_STRING (gc_string), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-        if (!arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_string), error))
-                return NULL;
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_string));
+
+        if (arv_gc_feature_node_check_read_access (ARV_GC_FEATURE_NODE (gc_string), error)) {
+		g_rec_mutex_lock (&arv_gc_string_mutex);
+		value = ARV_GC_STRING_GET_IFACE (gc_string)->get_value (gc_string, error);
+		g_rec_mutex_unlock (&arv_gc_string_mutex);
+	}
 
-	return ARV_GC_STRING_GET_IFACE (gc_string)->get_value (gc_string, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_string));
+
+	return value;
+}
+
+/**
+ * arv_gc_string_dup_value:
+ * @gc_string: an object implementing #ArvGcString
+ * @error: a #GError placeholder, or %NULL to ignore
+ *
+ * Same as arv_gc_string_get_value(), but the returned string is a copy, which can't be changed by a read of the
+ * feature from another thread.
+ *
+ * Returns: (transfer full): a newly allocated copy of the string value, to be freed with g_free().
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_gc_string_dup_value (ArvGcString *gc_string, GError **error)
+{
+	char *value;
+
+	g_return_val_if_fail (ARV_IS_GC_STRING (gc_string), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	g_rec_mutex_lock (&arv_gc_string_mutex);
+	value = g_strdup (arv_gc_string_get_value (gc_string, error));
+	g_rec_mutex_unlock (&arv_gc_string_mutex);
+
+	return value;
 }
 
 /**
@@ -73,10 +115,12 @@ arv_gc_string_set_value (ArvGcString *gc_string, const char *value, GError **err
 	g_return_if_fail (ARV_IS_GC_STRING (gc_string));
 	g_return_if_fail (error == NULL || *error == NULL);
 
-        if (!arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (gc_string), error))
-                return;
+	arv_gc_profile_enter (ARV_GC_FEATURE_NODE (gc_string));
+
+        if (arv_gc_feature_node_check_write_access (ARV_GC_FEATURE_NODE (gc_string), error))
+		ARV_GC_STRING_GET_IFACE (gc_string)->set_value (gc_string, value, error);
 
-	ARV_GC_STRING_GET_IFACE (gc_string)->set_value (gc_string, value, error);
+	arv_gc_profile_leave (ARV_GC_FEATURE_NODE (gc_string));
 }
 
 /**
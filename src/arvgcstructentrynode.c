@@ -48,6 +48,9 @@ struct _ArvGcStructEntryNode {
 	ArvGcPropertyNode *access_mode;
 	ArvGcPropertyNode *cachable;
 
+	/* Position in the entries of the StructReg, plus one, for the coalescing of the register reads */
+	gsize entry_index;
+
 	char v_string[G_ASCII_DTOSTR_BUF_SIZE];
 };
 
@@ -245,6 +248,25 @@ arv_gc_struct_entry_node_register_interface_init (ArvGcRegisterInterface *interf
 
 /* ArvGcInteger interface implementation */
 
+static guint
+_get_entry_index (ArvGcStructEntryNode *self)
+{
+	if (g_once_init_enter (&self->entry_index)) {
+		ArvDomNode *iter;
+		gsize index = 0;
+
+		for (iter = arv_dom_node_get_previous_sibling (ARV_DOM_NODE (self));
+		     iter != NULL;
+		     iter = arv_dom_node_get_previous_sibling (iter))
+			if (ARV_IS_GC_STRUCT_ENTRY_NODE (iter))
+				index++;
+
+		g_once_init_leave (&self->entry_index, index + 1);
+	}
+
+	return self->entry_index - 1;
+}
+
 static gint64
 arv_gc_struct_entry_node_get_integer_value (ArvGcInteger *gc_integer, GError **error)
 {
@@ -255,14 +277,15 @@ arv_gc_struct_entry_node_get_integer_value (ArvGcInteger *gc_integer, GError **e
 	if (!ARV_IS_GC_REGISTER_NODE (struct_register))
 		return 0;
 
-	return arv_gc_register_node_get_masked_integer_value
+	return arv_gc_register_node_get_struct_entry_value
 		(ARV_GC_REGISTER_NODE (struct_register),
+		 _get_entry_index (struct_entry),
 		 arv_gc_property_node_get_lsb (struct_entry->lsb, 0),
 		 arv_gc_property_node_get_msb (struct_entry->msb, 31),
 		 arv_gc_property_node_get_sign (struct_entry->sign, ARV_GC_SIGNEDNESS_UNSIGNED),
 		 0,
 		 arv_gc_property_node_get_cachable (struct_entry->cachable, ARV_GC_CACHABLE_WRITE_AROUND),
-		 TRUE, error);
+		 error);
 }
 
 static void
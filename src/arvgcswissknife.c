@@ -26,6 +26,7 @@
  */
 
 #include <arvgcswissknifeprivate.h>
+#include <arvgcfeaturenodeprivate.h>
 #include <arvevaluator.h>
 #include <arvgcinteger.h>
 #include <arvgcfloat.h>
@@ -45,6 +46,15 @@ typedef struct {
 	ArvGcPropertyNode *representation;
 
 	ArvEvaluator *formula;
+	GArray *variable_indexes;	/* evaluator variable indexes, in the variables list order */
+	gboolean is_formula_set;
+	GRecMutex formula_mutex;	/* Makes the variable update and the evaluation atomic */
+
+	/* Last values, valid while the memo key is unchanged, see arv_gc_feature_node_get_memo_key() */
+	guint64 int64_memo_key;
+	gint64 int64_memo;
+	guint64 double_memo_key;
+	double double_memo;
 } ArvGcSwissKnifePrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvGcSwissKnife, arv_gc_swiss_knife, ARV_TYPE_GC_FEATURE_NODE, G_ADD_PRIVATE (ArvGcSwissKnife))
@@ -62,9 +72,11 @@ arv_gc_swiss_knife_post_new_child (ArvDomNode *self, ArvDomNode *child)
 		switch (arv_gc_property_node_get_node_type (property_node)) {
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VARIABLE:
 				priv->variables = g_slist_prepend (priv->variables, property_node);
+				g_clear_pointer (&priv->variable_indexes, g_array_unref);
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA:
 				priv->formula_node = property_node;
+				priv->is_formula_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_UNIT:
 				priv->unit = property_node;
@@ -74,9 +86,11 @@ arv_gc_swiss_knife_post_new_child (ArvDomNode *self, ArvDomNode *child)
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_EXPRESSION:
 				priv->expressions = g_slist_prepend (priv->expressions, property_node);
+				priv->is_formula_set = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_CONSTANT:
 				priv->constants = g_slist_prepend (priv->constants, property_node);
+				priv->is_formula_set = FALSE;
 				break;
 			default:
 				ARV_DOM_NODE_CLASS (arv_gc_swiss_knife_parent_class)->post_new_child (self, child);
@@ -99,6 +113,7 @@ arv_gc_swiss_knife_init (ArvGcSwissKnife *self)
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 
 	priv->formula = arv_evaluator_new (NULL);
+	g_rec_mutex_init (&priv->formula_mutex);
 }
 
 static ArvGcAccessMode
@@ -117,6 +132,8 @@ arv_gc_swiss_knife_finalize (GObject *object)
 	g_slist_free (priv->constants);
 
 	g_clear_object (&priv->formula);
+	g_clear_pointer (&priv->variable_indexes, g_array_unref);
+	g_rec_mutex_clear (&priv->formula_mutex);
 
 	G_OBJECT_CLASS (arv_gc_swiss_knife_parent_class)->finalize (object);
 }
@@ -136,15 +153,39 @@ arv_gc_swiss_knife_class_init (ArvGcSwissKnifeClass *this_class)
 
 /* ArvGcInteger interface implementation */
 
+static GArray *
+_get_variable_indexes (ArvGcSwissKnife *self)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
+	GSList *iter;
+
+	if (priv->variable_indexes != NULL)
+		return priv->variable_indexes;
+
+	priv->variable_indexes = g_array_new (FALSE, FALSE, sizeof (guint));
+	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+		guint index;
+
+		index = arv_evaluator_get_variable_index (priv->formula, arv_gc_property_node_get_name (iter->data));
+		g_array_append_val (priv->variable_indexes, index);
+	}
+
+	return priv->variable_indexes;
+}
+
+/* The formula, the sub-expressions and the constants are constant properties, the evaluator gets them once */
+
 static void
-_update_variables (ArvGcSwissKnife *self, GError **error)
+_set_formula (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
-	ArvGcNode *node;
 	GError *local_error = NULL;
 	GSList *iter;
 	const char *expression;
 
+	if (priv->is_formula_set)
+		return;
+
 	if (priv->formula_node != NULL)
 		expression = arv_gc_property_node_get_string (priv->formula_node, &local_error);
 	else
@@ -190,7 +231,28 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 		arv_evaluator_set_constant (priv->formula, name, constant);
 	}
 
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	priv->is_formula_set = TRUE;
+}
+
+static void
+_update_variables (ArvGcSwissKnife *self, GError **error)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
+	ArvGcNode *node;
+	GError *local_error = NULL;
+	GSList *iter;
+	GArray *indexes;
+	guint i;
+
+	_set_formula (self, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	indexes = _get_variable_indexes (self);
+
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
@@ -205,9 +267,9 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
                                 return;
                         }
 
-			arv_evaluator_set_int64_variable (priv->formula,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_index (priv->formula,
+								   g_array_index (indexes, guint, i),
+								   value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -219,9 +281,9 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 				return;
 			}
 
-			arv_evaluator_set_double_variable (priv->formula,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_double_variable_by_index (priv->formula,
+								   g_array_index (indexes, guint, i),
+								   value);
 		}
 	}
 }
@@ -231,18 +293,38 @@ arv_gc_swiss_knife_get_integer_value (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 	GError *local_error = NULL;
+	guint64 memo_key;
+	gint64 value;
 
 	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), 0);
 
+	memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+
+	if (memo_key != 0 && memo_key == priv->int64_memo_key) {
+		value = priv->int64_memo;
+		g_rec_mutex_unlock (&priv->formula_mutex);
+		return value;
+	}
+
 	_update_variables (self, &local_error);
 
 	if (local_error != NULL) {
+		g_rec_mutex_unlock (&priv->formula_mutex);
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
                 return 0;
         }
 
-	return arv_evaluator_evaluate_as_int64 (priv->formula, NULL);
+	value = arv_evaluator_evaluate_as_int64 (priv->formula, NULL);
+
+	priv->int64_memo_key = memo_key;
+	priv->int64_memo = value;
+
+	g_rec_mutex_unlock (&priv->formula_mutex);
+
+	return value;
 }
 
 double
@@ -250,18 +332,38 @@ arv_gc_swiss_knife_get_float_value (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 	GError *local_error = NULL;
+	guint64 memo_key;
+	double value;
 
 	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), 0.0);
 
+	memo_key = arv_gc_feature_node_get_memo_key (ARV_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_lock (&priv->formula_mutex);
+
+	if (memo_key != 0 && memo_key == priv->double_memo_key) {
+		value = priv->double_memo;
+		g_rec_mutex_unlock (&priv->formula_mutex);
+		return value;
+	}
+
 	_update_variables (self, &local_error);
 
 	if (local_error != NULL) {
+		g_rec_mutex_unlock (&priv->formula_mutex);
                 g_propagate_prefixed_error (error, local_error, "[%s] ",
                                             arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
 		return 0.0;
 	}
 
-	return arv_evaluator_evaluate_as_double (priv->formula, NULL);
+	value = arv_evaluator_evaluate_as_double (priv->formula, NULL);
+
+	priv->double_memo_key = memo_key;
+	priv->double_memo = value;
+
+	g_rec_mutex_unlock (&priv->formula_mutex);
+
+	return value;
 }
 
 ArvGcRepresentation
@@ -25,7 +25,7 @@
  * @short_description: Class for Index nodes
  */
 
-#include <arvgcvalueindexednode.h>
+#include <arvgcvalueindexednodeprivate.h>
 #include <arvgcpropertynode.h>
 #include <arvgcinteger.h>
 #include <arvgc.h>
@@ -36,7 +36,7 @@
 struct _ArvGcValueIndexedNode {
 	ArvGcPropertyNode	base;
 
-	char *index;
+	gint64 index;
 };
 
 struct _ArvGcValueIndexedNodeClass {
@@ -73,10 +73,8 @@ arv_gc_value_indexed_node_set_attribute (ArvDomElement *self, const char *name,
 {
 	ArvGcValueIndexedNode *value_indexed_node = ARV_GC_VALUE_INDEXED_NODE (self);
 
-	if (strcmp (name, "Index") == 0) {
-		g_free (value_indexed_node->index);
-		value_indexed_node->index = g_strdup (value);
-	}
+	if (strcmp (name, "Index") == 0)
+		value_indexed_node->index = g_ascii_strtoll (value, NULL, 0);
 }
 
 static const char *
@@ -92,16 +90,73 @@ arv_gc_value_indexed_node_get_attribute (ArvDomElement *self, const char *name)
 gint64
 arv_gc_value_indexed_node_get_index (ArvGcValueIndexedNode *value_indexed_node)
 {
-	gint64 index;
-
 	g_return_val_if_fail (ARV_IS_GC_VALUE_INDEXED_NODE (value_indexed_node), 0);
 
-	if (value_indexed_node->index == NULL)
-		index = 0;
-	else
-		index = g_ascii_strtoll (value_indexed_node->index, NULL, 0);
+	return value_indexed_node->index;
+}
+
+static gint
+_compare_indexes (gconstpointer a, gconstpointer b)
+{
+	gint64 index_a = (*(ArvGcValueIndexedNode **) a)->index;
+	gint64 index_b = (*(ArvGcValueIndexedNode **) b)->index;
 
-	return index;
+	return index_a < index_b ? -1 : (index_a > index_b ? 1 : 0);
+}
+
+/* Array of the nodes ordered by index, for a binary search of the current index in the large tables like the LUTs.
+ * For duplicated indexes, only the first node in @value_indexed_nodes is kept, which matches a linear search of the
+ * list. */
+
+GPtrArray *
+arv_gc_value_indexed_node_sort (GSList *value_indexed_nodes)
+{
+	GPtrArray *sorted_nodes;
+	GSList *iter;
+	guint i;
+
+	sorted_nodes = g_ptr_array_sized_new (g_slist_length (value_indexed_nodes));
+	for (iter = value_indexed_nodes; iter != NULL; iter = iter->next)
+		if (ARV_IS_GC_VALUE_INDEXED_NODE (iter->data))
+			g_ptr_array_add (sorted_nodes, iter->data);
+
+	/* Stable sort */
+	g_ptr_array_sort (sorted_nodes, _compare_indexes);
+
+	for (i = 1; i < sorted_nodes->len; ) {
+		if (_compare_indexes (&g_ptr_array_index (sorted_nodes, i - 1),
+				      &g_ptr_array_index (sorted_nodes, i)) == 0)
+			g_ptr_array_remove_index (sorted_nodes, i);
+		else
+			i++;
+	}
+
+	return sorted_nodes;
+}
+
+ArvGcPropertyNode *
+arv_gc_value_indexed_node_lookup (GPtrArray *sorted_nodes, gint64 index)
+{
+	guint low = 0;
+	guint high;
+
+	g_return_val_if_fail (sorted_nodes != NULL, NULL);
+
+	high = sorted_nodes->len;
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+		ArvGcValueIndexedNode *node = g_ptr_array_index (sorted_nodes, middle);
+
+		if (node->index == index)
+			return ARV_GC_PROPERTY_NODE (node);
+
+		if (node->index < index)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return NULL;
 }
 
 ArvGcNode *
@@ -119,27 +174,15 @@ arv_gc_p_value_indexed_node_new (void)
 static void
 arv_gc_value_indexed_node_init (ArvGcValueIndexedNode *value_indexed_node)
 {
-	value_indexed_node->index = NULL;
-}
-
-static void
-arv_gc_value_indexed_node_finalize (GObject *object)
-{
-	ArvGcValueIndexedNode *value_indexed_node = ARV_GC_VALUE_INDEXED_NODE (object);
-
-	g_clear_pointer (&value_indexed_node->index, g_free);
-
-	G_OBJECT_CLASS (arv_gc_value_indexed_node_parent_class)->finalize (object);
+	value_indexed_node->index = 0;
 }
 
 static void
 arv_gc_value_indexed_node_class_init (ArvGcValueIndexedNodeClass *this_class)
 {
-	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
 	ArvDomNodeClass *dom_node_class = ARV_DOM_NODE_CLASS (this_class);
 	ArvDomElementClass *dom_element_class = ARV_DOM_ELEMENT_CLASS (this_class);
 
-	object_class->finalize = arv_gc_value_indexed_node_finalize;
 	dom_node_class->get_node_name = arv_gc_value_indexed_node_get_node_name;
 	dom_node_class->can_append_child = arv_gc_value_indexed_node_can_append_child;
 	dom_element_class->set_attribute = arv_gc_value_indexed_node_set_attribute;
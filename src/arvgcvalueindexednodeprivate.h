@@ -0,0 +1,35 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_GC_VALUE_INDEXED_NODE_PRIVATE_H
+#define ARV_GC_VALUE_INDEXED_NODE_PRIVATE_H
+
+#include <arvgcvalueindexednode.h>
+
+G_BEGIN_DECLS
+
+GPtrArray *		arv_gc_value_indexed_node_sort		(GSList *value_indexed_nodes);
+ArvGcPropertyNode *	arv_gc_value_indexed_node_lookup	(GPtrArray *sorted_nodes, gint64 index);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,511 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * SECTION:arvgenicamcache
+ * @short_description: Persistent Genicam data cache
+ *
+ * The Genicam data downloaded from the devices are stored in a cache directory, in order to skip the download and
+ * the decompression on the next connection to a device of the same model. The cache key includes the vendor
+ * name, the model name, the device version and the Genicam data URL, which makes sure a firmware update doesn't
+ * lead to the use of stale data.
+ *
+ * For the Genicam data downloaded from a web server, the HTTP validators of the cached copy are stored next to it.
+ * The copy is used without network access until its expiration, then revalidated using a conditional request.
+ *
+ * A compiled form of the parsed Genicam document is also stored, keyed by the checksum of the Genicam data. It is
+ * used by arv_gc_new() to skip the xml parsing.
+ *
+ * The default cache directory is `$XDG_CACHE_HOME/aravis/genicam`. It can be changed using the
+ * `ARV_GENICAM_CACHE_DIR` environment variable, an empty value disabling the cache, or using
+ * arv_set_genicam_cache_directory().
+ */
+
+#include <arvgenicamcacheprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+static GMutex arv_genicam_cache_mutex;
+static gboolean arv_genicam_cache_is_initialized = FALSE;
+static char *arv_genicam_cache_directory = NULL;
+
+static void
+_initialize (void)
+{
+	const char *env;
+
+	if (arv_genicam_cache_is_initialized)
+		return;
+
+	env = g_getenv ("ARV_GENICAM_CACHE_DIR");
+	if (env != NULL)
+		arv_genicam_cache_directory = env[0] != '\0' ? g_strdup (env) : NULL;
+	else
+		arv_genicam_cache_directory = g_build_filename (g_get_user_cache_dir (), "aravis", "genicam", NULL);
+
+	arv_genicam_cache_is_initialized = TRUE;
+}
+
+/**
+ * arv_set_genicam_cache_directory:
+ * @directory: (nullable): a directory path, %NULL to disable the cache
+ *
+ * Sets the directory used for the storage of the Genicam data cache, overriding the default directory and the
+ * `ARV_GENICAM_CACHE_DIR` environment variable. The directory is created on the first cache write.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_set_genicam_cache_directory (const char *directory)
+{
+	g_mutex_lock (&arv_genicam_cache_mutex);
+
+	g_free (arv_genicam_cache_directory);
+	arv_genicam_cache_directory = g_strdup (directory);
+	arv_genicam_cache_is_initialized = TRUE;
+
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+}
+
+/**
+ * arv_get_genicam_cache_directory:
+ *
+ * Returns: (transfer full) (nullable): the Genicam data cache directory, %NULL if the cache is disabled.
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_get_genicam_cache_directory (void)
+{
+	char *directory;
+
+	g_mutex_lock (&arv_genicam_cache_mutex);
+
+	_initialize ();
+	directory = g_strdup (arv_genicam_cache_directory);
+
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+
+	return directory;
+}
+
+/* The terminating null characters are used as separators */
+
+static void
+_checksum_update (GChecksum *checksum, const char *string)
+{
+	if (string == NULL)
+		string = "";
+
+	g_checksum_update (checksum, (const guchar *) string, strlen (string) + 1);
+}
+
+/**
+ * arv_genicam_cache_get_key:
+ * @vendor: device vendor name
+ * @model: device model name
+ * @version: device version
+ * @url: Genicam data URL, or any string identifying the Genicam data, like a SHA1 hash
+ *
+ * Returns: (transfer full): a cache key, suitable as a file name.
+ */
+
+char *
+arv_genicam_cache_get_key (const char *vendor, const char *model, const char *version, const char *url)
+{
+	GChecksum *checksum;
+	char *key;
+
+	checksum = g_checksum_new (G_CHECKSUM_SHA1);
+
+	_checksum_update (checksum, vendor);
+	_checksum_update (checksum, model);
+	_checksum_update (checksum, version);
+	_checksum_update (checksum, url);
+
+	key = g_strdup (g_checksum_get_string (checksum));
+
+	g_checksum_free (checksum);
+
+	return key;
+}
+
+static char *
+_get_filename (const char *key, const char *extension)
+{
+	char *filename = NULL;
+	char *basename;
+
+	g_mutex_lock (&arv_genicam_cache_mutex);
+
+	_initialize ();
+
+	if (arv_genicam_cache_directory != NULL) {
+		basename = g_strdup_printf ("%s.%s", key, extension);
+		filename = g_build_filename (arv_genicam_cache_directory, basename, NULL);
+		g_free (basename);
+	}
+
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+
+	return filename;
+}
+
+static void
+_store (const char *key, const char *extension, const void *data, size_t size)
+{
+	GError *error = NULL;
+	char *filename;
+	char *dirname;
+
+	if (data == NULL || size == 0)
+		return;
+
+	filename = _get_filename (key, extension);
+	if (filename == NULL)
+		return;
+
+	dirname = g_path_get_dirname (filename);
+
+	if (g_mkdir_with_parents (dirname, 0755) != 0)
+		arv_warning_misc ("[GenicamCache::store] Can't create %s", dirname);
+	else if (!g_file_set_contents (filename, data, size, &error)) {
+		arv_warning_misc ("[GenicamCache::store] Can't write %s: %s", filename, error->message);
+		g_clear_error (&error);
+	} else
+		arv_info_misc ("[GenicamCache::store] Stored %s", filename);
+
+	g_free (dirname);
+	g_free (filename);
+}
+
+/**
+ * arv_genicam_cache_is_enabled:
+ *
+ * Returns: %TRUE if a cache directory is set.
+ */
+
+gboolean
+arv_genicam_cache_is_enabled (void)
+{
+	gboolean is_enabled;
+
+	g_mutex_lock (&arv_genicam_cache_mutex);
+
+	_initialize ();
+	is_enabled = arv_genicam_cache_directory != NULL;
+
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+
+	return is_enabled;
+}
+
+/**
+ * arv_genicam_cache_load:
+ * @key: a cache key, from arv_genicam_cache_get_key()
+ * @size: (out): placeholder for the data size
+ *
+ * Returns: (transfer full) (nullable): the cached Genicam data, %NULL if not found.
+ */
+
+char *
+arv_genicam_cache_load (const char *key, size_t *size)
+{
+	char *filename;
+	char *xml = NULL;
+	gsize length = 0;
+
+	g_return_val_if_fail (key != NULL, NULL);
+	g_return_val_if_fail (size != NULL, NULL);
+
+	*size = 0;
+
+	filename = _get_filename (key, "xml");
+	if (filename == NULL)
+		return NULL;
+
+	if (g_file_get_contents (filename, &xml, &length, NULL) && length > 0) {
+		arv_info_misc ("[GenicamCache::load] Found %s", filename);
+		*size = length;
+	} else {
+		g_clear_pointer (&xml, g_free);
+	}
+
+	g_free (filename);
+
+	return xml;
+}
+
+/**
+ * arv_genicam_cache_store:
+ * @key: a cache key, from arv_genicam_cache_get_key()
+ * @xml: Genicam data
+ * @size: data size
+ *
+ * Stores @xml in the cache. The write is atomic, and failures are not fatal.
+ */
+
+void
+arv_genicam_cache_store (const char *key, const char *xml, size_t size)
+{
+	g_return_if_fail (key != NULL);
+
+	_store (key, "xml", xml, size);
+}
+
+/**
+ * arv_genicam_cache_load_http_validators:
+ * @key: a cache key, from arv_genicam_cache_get_key()
+ * @etag: (out) (transfer full) (nullable): entity tag of the cached copy
+ * @last_modified: (out) (transfer full) (nullable): modification date of the cached copy
+ * @expiration_s: (out): expiration time of the cached copy, in seconds since the epoch, 0 if already stale
+ *
+ * Returns: %TRUE if validators were found for @key.
+ */
+
+gboolean
+arv_genicam_cache_load_http_validators (const char *key, char **etag, char **last_modified, gint64 *expiration_s)
+{
+	GKeyFile *key_file;
+	char *filename;
+	gboolean found = FALSE;
+
+	g_return_val_if_fail (key != NULL, FALSE);
+	g_return_val_if_fail (etag != NULL && last_modified != NULL && expiration_s != NULL, FALSE);
+
+	*etag = NULL;
+	*last_modified = NULL;
+	*expiration_s = 0;
+
+	filename = _get_filename (key, "http");
+	if (filename == NULL)
+		return FALSE;
+
+	key_file = g_key_file_new ();
+
+	if (g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, NULL)) {
+		*etag = g_key_file_get_string (key_file, "http", "etag", NULL);
+		*last_modified = g_key_file_get_string (key_file, "http", "last-modified", NULL);
+		*expiration_s = g_key_file_get_int64 (key_file, "http", "expiration", NULL);
+		found = TRUE;
+	}
+
+	g_key_file_unref (key_file);
+	g_free (filename);
+
+	return found;
+}
+
+/**
+ * arv_genicam_cache_store_http_validators:
+ * @key: a cache key, from arv_genicam_cache_get_key()
+ * @etag: (nullable): entity tag of the cached copy
+ * @last_modified: (nullable): modification date of the cached copy
+ * @expiration_s: expiration time of the cached copy, in seconds since the epoch
+ *
+ * Stores the HTTP validators of the Genicam data cached with the same key.
+ */
+
+void
+arv_genicam_cache_store_http_validators (const char *key, const char *etag, const char *last_modified,
+					 gint64 expiration_s)
+{
+	GKeyFile *key_file;
+	char *data;
+	gsize size;
+
+	g_return_if_fail (key != NULL);
+
+	key_file = g_key_file_new ();
+
+	if (etag != NULL)
+		g_key_file_set_string (key_file, "http", "etag", etag);
+	if (last_modified != NULL)
+		g_key_file_set_string (key_file, "http", "last-modified", last_modified);
+	g_key_file_set_int64 (key_file, "http", "expiration", expiration_s);
+
+	data = g_key_file_to_data (key_file, &size, NULL);
+	_store (key, "http", data, size);
+	g_free (data);
+
+	g_key_file_unref (key_file);
+}
+
+/**
+ * arv_genicam_cache_load_compiled:
+ * @key: a cache key, usually the checksum of the Genicam data
+ *
+ * Maps the cached compiled Genicam document in memory.
+ *
+ * Returns: (transfer full) (nullable): the compiled document data, %NULL if not found.
+ */
+
+GBytes *
+arv_genicam_cache_load_compiled (const char *key)
+{
+	GMappedFile *mapped_file;
+	GBytes *bytes = NULL;
+	char *filename;
+
+	g_return_val_if_fail (key != NULL, NULL);
+
+	filename = _get_filename (key, "arvc");
+	if (filename == NULL)
+		return NULL;
+
+	mapped_file = g_mapped_file_new (filename, FALSE, NULL);
+	if (mapped_file != NULL) {
+		arv_info_misc ("[GenicamCache::load_compiled] Found %s", filename);
+		bytes = g_mapped_file_get_bytes (mapped_file);
+		g_mapped_file_unref (mapped_file);
+	}
+
+	g_free (filename);
+
+	return bytes;
+}
+
+/**
+ * arv_genicam_cache_store_compiled:
+ * @key: a cache key, usually the checksum of the Genicam data
+ * @compiled: a compiled Genicam document
+ *
+ * Stores @compiled in the cache. The write is atomic, and failures are not fatal.
+ */
+
+void
+arv_genicam_cache_store_compiled (const char *key, GBytes *compiled)
+{
+	gconstpointer data;
+	gsize size;
+
+	g_return_if_fail (key != NULL);
+	g_return_if_fail (compiled != NULL);
+
+	data = g_bytes_get_data (compiled, &size);
+
+	_store (key, "arvc", data, size);
+}
+
+static GMutex arv_packet_size_cache_mutex;
+
+/**
+ * arv_genicam_cache_load_packet_size:
+ * @device_mac: the device MAC address
+ * @interface_address: the address of the host interface
+ * @mtu: the current path MTU between the host interface and the device, 0 if unknown
+ *
+ * Looks for the stream packet size found during a previous session, for the same device, host interface and MTU.
+ * The packet sizes are stored next to the Genicam data, and a link change invalidates the cached value.
+ *
+ * Returns: the cached packet size, or 0 if not found.
+ */
+
+guint
+arv_genicam_cache_load_packet_size (const char *device_mac, const char *interface_address, guint mtu)
+{
+	GKeyFile *key_file;
+	char *filename;
+	guint packet_size = 0;
+
+	g_return_val_if_fail (device_mac != NULL, 0);
+	g_return_val_if_fail (interface_address != NULL, 0);
+
+	filename = _get_filename ("packet-size", "ini");
+	if (filename == NULL)
+		return 0;
+
+	key_file = g_key_file_new ();
+
+	g_mutex_lock (&arv_packet_size_cache_mutex);
+
+	if (g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, NULL)) {
+		char *cached_interface;
+		gint cached_mtu;
+
+		cached_interface = g_key_file_get_string (key_file, device_mac, "interface", NULL);
+		cached_mtu = g_key_file_get_integer (key_file, device_mac, "mtu", NULL);
+
+		if (g_strcmp0 (cached_interface, interface_address) == 0 && cached_mtu == (gint) mtu)
+			packet_size = MAX (0, g_key_file_get_integer (key_file, device_mac, "packet-size", NULL));
+
+		g_free (cached_interface);
+	}
+
+	g_mutex_unlock (&arv_packet_size_cache_mutex);
+
+	if (packet_size > 0)
+		arv_info_misc ("[GenicamCache::load_packet_size] Found %u bytes for %s", packet_size, device_mac);
+
+	g_key_file_unref (key_file);
+	g_free (filename);
+
+	return packet_size;
+}
+
+/**
+ * arv_genicam_cache_store_packet_size:
+ * @device_mac: the device MAC address
+ * @interface_address: the address of the host interface
+ * @mtu: the current path MTU between the host interface and the device, 0 if unknown
+ * @packet_size: the negotiated packet size
+ *
+ * Stores the result of a packet size negotiation, for use by arv_genicam_cache_load_packet_size().
+ */
+
+void
+arv_genicam_cache_store_packet_size (const char *device_mac, const char *interface_address, guint mtu,
+				     guint packet_size)
+{
+	GKeyFile *key_file;
+	char *filename;
+	char *data;
+	gsize size;
+
+	g_return_if_fail (device_mac != NULL);
+	g_return_if_fail (interface_address != NULL);
+
+	filename = _get_filename ("packet-size", "ini");
+	if (filename == NULL)
+		return;
+
+	key_file = g_key_file_new ();
+
+	g_mutex_lock (&arv_packet_size_cache_mutex);
+
+	g_key_file_load_from_file (key_file, filename, G_KEY_FILE_KEEP_COMMENTS, NULL);
+
+	g_key_file_set_string (key_file, device_mac, "interface", interface_address);
+	g_key_file_set_integer (key_file, device_mac, "mtu", mtu);
+	g_key_file_set_integer (key_file, device_mac, "packet-size", packet_size);
+
+	data = g_key_file_to_data (key_file, &size, NULL);
+	_store ("packet-size", "ini", data, size);
+	g_free (data);
+
+	g_mutex_unlock (&arv_packet_size_cache_mutex);
+
+	g_key_file_unref (key_file);
+	g_free (filename);
+}
@@ -0,0 +1,51 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_GENICAM_CACHE_PRIVATE_H
+#define ARV_GENICAM_CACHE_PRIVATE_H
+
+#include <arvgenicamcache.h>
+
+G_BEGIN_DECLS
+
+/* private, but used by tests */
+ARV_API char *		arv_genicam_cache_get_key	(const char *vendor, const char *model, const char *version,
+							 const char *url);
+ARV_API char *		arv_genicam_cache_load		(const char *key, size_t *size);
+ARV_API void		arv_genicam_cache_store		(const char *key, const char *xml, size_t size);
+ARV_API gboolean	arv_genicam_cache_load_http_validators	(const char *key, char **etag, char **last_modified,
+								 gint64 *expiration_s);
+ARV_API void		arv_genicam_cache_store_http_validators	(const char *key, const char *etag,
+								 const char *last_modified, gint64 expiration_s);
+
+gboolean		arv_genicam_cache_is_enabled	(void);
+GBytes *		arv_genicam_cache_load_compiled	(const char *key);
+void			arv_genicam_cache_store_compiled (const char *key, GBytes *compiled);
+
+guint			arv_genicam_cache_load_packet_size	(const char *device_mac, const char *interface_address,
+								 guint mtu);
+void			arv_genicam_cache_store_packet_size	(const char *device_mac, const char *interface_address,
+								 guint mtu, guint packet_size);
+
+G_END_DECLS
+
+#endif
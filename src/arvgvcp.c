@@ -40,31 +40,26 @@ arv_gvcp_packet_free (ArvGvcpPacket *packet)
 }
 
 /**
- * arv_gvcp_packet_new_read_memory_cmd: (skip)
+ * arv_gvcp_packet_init_read_memory_cmd: (skip)
+ * @packet: a memory block large enough for the command
  * @address: read address
  * @size: read size, in bytes
  * @packet_id: packet id
- * @packet_size: (out): packet size, in bytes
- * Return value: (transfer full): a new #ArvGvcpPacket
+ * Return value: the packet size, in bytes
  *
- * Create a gvcp packet for a memory read command.
+ * Write a memory read command in @packet.
  */
 
-ArvGvcpPacket *
-arv_gvcp_packet_new_read_memory_cmd (guint32 address, guint32 size, guint16 packet_id, size_t *packet_size)
+size_t
+arv_gvcp_packet_init_read_memory_cmd (ArvGvcpPacket *packet, guint32 address, guint32 size, guint16 packet_id)
 {
-	ArvGvcpPacket *packet;
 	guint32 n_address = g_htonl (address);
 	guint32 n_size;
 
-	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (packet != NULL, 0);
 
 	n_size = g_htonl (((size + sizeof (guint32) - 1) / sizeof (guint32)) * sizeof (guint32));
 
-	*packet_size = sizeof (ArvGvcpHeader) + 2 * sizeof (guint32);
-
-	packet = g_malloc (*packet_size);
-
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
 	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
 	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_MEMORY_CMD);
@@ -74,6 +69,30 @@ arv_gvcp_packet_new_read_memory_cmd (guint32 address, guint32 size, guint16 pack
 	memcpy (&packet->data, &n_address, sizeof (guint32));
 	memcpy (&packet->data[sizeof(guint32)], &n_size, sizeof (guint32));
 
+	return sizeof (ArvGvcpHeader) + 2 * sizeof (guint32);
+}
+
+/**
+ * arv_gvcp_packet_new_read_memory_cmd: (skip)
+ * @address: read address
+ * @size: read size, in bytes
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a memory read command.
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_read_memory_cmd (guint32 address, guint32 size, guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	packet = g_malloc (sizeof (ArvGvcpHeader) + 2 * sizeof (guint32));
+	*packet_size = arv_gvcp_packet_init_read_memory_cmd (packet, address, size, packet_id);
+
 	return packet;
 }
 
@@ -112,31 +131,28 @@ arv_gvcp_packet_new_read_memory_ack (guint32 address, guint32 size, guint16 pack
 }
 
 /**
- * arv_gvcp_packet_new_write_memory_cmd: (skip)
+ * arv_gvcp_packet_init_write_memory_cmd: (skip)
+ * @packet: a memory block large enough for the command
  * @address: write address
  * @size: write size, in bytes
+ * @buffer: data to write
  * @packet_id: packet id
- * @packet_size: (out): packet size, in bytes
- * Return value: (transfer full): a new #ArvGvcpPacket
+ * Return value: the packet size, in bytes
  *
- * Create a gvcp packet for a memory write command.
+ * Write a memory write command in @packet. The data are padded to a multiple of 4 bytes.
  */
 
-ArvGvcpPacket *
-arv_gvcp_packet_new_write_memory_cmd (guint32 address, guint32 size, const char *buffer, guint16 packet_id, size_t *packet_size)
+size_t
+arv_gvcp_packet_init_write_memory_cmd (ArvGvcpPacket *packet, guint32 address, guint32 size, const char *buffer,
+				       guint16 packet_id)
 {
-	ArvGvcpPacket *packet;
 	guint32 n_address = g_htonl (address);
 	guint32 actual_size;
 
-	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (packet != NULL, 0);
 
 	actual_size = ((size + sizeof (guint32) - 1) / sizeof (guint32)) * sizeof (guint32);
 
-	*packet_size = sizeof (ArvGvcpHeader) + sizeof (guint32) + actual_size;
-
-	packet = g_malloc (*packet_size);
-
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
 	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
 	packet->header.command = g_htons (ARV_GVCP_COMMAND_WRITE_MEMORY_CMD);
@@ -145,6 +161,32 @@ arv_gvcp_packet_new_write_memory_cmd (guint32 address, guint32 size, const char
 
 	memcpy (&packet->data, &n_address, sizeof (guint32));
 	memcpy ((char *) packet + sizeof (ArvGvcpPacket) + sizeof (guint32), buffer, size);
+	memset ((char *) packet + sizeof (ArvGvcpPacket) + sizeof (guint32) + size, 0, actual_size - size);
+
+	return sizeof (ArvGvcpHeader) + sizeof (guint32) + actual_size;
+}
+
+/**
+ * arv_gvcp_packet_new_write_memory_cmd: (skip)
+ * @address: write address
+ * @size: write size, in bytes
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a memory write command.
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_write_memory_cmd (guint32 address, guint32 size, const char *buffer, guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	packet = g_malloc (sizeof (ArvGvcpHeader) + sizeof (guint32) +
+			   ((size + sizeof (guint32) - 1) / sizeof (guint32)) * sizeof (guint32));
+	*packet_size = arv_gvcp_packet_init_write_memory_cmd (packet, address, size, buffer, packet_id);
 
 	return packet;
 }
@@ -184,6 +226,73 @@ arv_gvcp_packet_new_write_memory_ack (guint32 address,
 	return packet;
 }
 
+/**
+ * arv_gvcp_packet_init_read_registers_cmd: (skip)
+ * @packet: a memory block large enough for the command
+ * @n_registers: number of registers, at most %ARV_GVCP_READ_REGISTERS_MAX
+ * @addresses: (array length=n_registers): register addresses
+ * @packet_id: packet id
+ * Return value: the packet size, in bytes
+ *
+ * Write a read command of several registers in @packet.
+ */
+
+size_t
+arv_gvcp_packet_init_read_registers_cmd (ArvGvcpPacket *packet,
+					 guint n_registers,
+					 const guint32 *addresses,
+					 guint16 packet_id)
+{
+	guint i;
+
+	g_return_val_if_fail (packet != NULL, 0);
+	g_return_val_if_fail (addresses != NULL, 0);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_READ_REGISTERS_MAX, 0);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
+	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_CMD);
+	packet->header.size = g_htons (n_registers * sizeof (guint32));
+	packet->header.id = g_htons (packet_id);
+
+	for (i = 0; i < n_registers; i++) {
+		guint32 n_address = g_htonl (addresses[i]);
+
+		memcpy (&packet->data[i * sizeof (guint32)], &n_address, sizeof (guint32));
+	}
+
+	return sizeof (ArvGvcpHeader) + n_registers * sizeof (guint32);
+}
+
+/**
+ * arv_gvcp_packet_new_read_registers_cmd: (skip)
+ * @n_registers: number of registers, at most %ARV_GVCP_READ_REGISTERS_MAX
+ * @addresses: (array length=n_registers): register addresses
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a read command of several registers.
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_read_registers_cmd (guint n_registers,
+					const guint32 *addresses,
+					guint16 packet_id,
+					size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (addresses != NULL, NULL);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_READ_REGISTERS_MAX, NULL);
+
+	packet = g_malloc (sizeof (ArvGvcpHeader) + n_registers * sizeof (guint32));
+	*packet_size = arv_gvcp_packet_init_read_registers_cmd (packet, n_registers, addresses, packet_id);
+
+	return packet;
+}
+
 /**
  * arv_gvcp_packet_new_read_register_cmd: (skip)
  * @address: write address
@@ -198,23 +307,49 @@ ArvGvcpPacket *
 arv_gvcp_packet_new_read_register_cmd (guint32 address,
 				       guint16 packet_id,
 				       size_t *packet_size)
+{
+	return arv_gvcp_packet_new_read_registers_cmd (1, &address, packet_id, packet_size);
+}
+
+/**
+ * arv_gvcp_packet_new_read_registers_ack: (skip)
+ * @n_registers: number of registers, at most %ARV_GVCP_READ_REGISTERS_MAX
+ * @values: (array length=n_registers): read values
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a read acknowledge of several registers.
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_read_registers_ack (guint n_registers,
+					const guint32 *values,
+					guint16 packet_id,
+					size_t *packet_size)
 {
 	ArvGvcpPacket *packet;
-	guint32 n_address = g_htonl (address);
+	guint i;
 
 	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (values != NULL, NULL);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_READ_REGISTERS_MAX, NULL);
 
-	*packet_size = sizeof (ArvGvcpHeader) + sizeof (guint32);
+	*packet_size = arv_gvcp_packet_get_read_registers_ack_size (n_registers);
 
 	packet = g_malloc (*packet_size);
 
-	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
-	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
-	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_CMD);
-	packet->header.size = g_htons (sizeof (guint32));
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
+	packet->header.packet_flags = 0;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_ACK);
+	packet->header.size = g_htons (n_registers * sizeof (guint32));
 	packet->header.id = g_htons (packet_id);
 
-	memcpy (&packet->data, &n_address, sizeof (guint32));
+	for (i = 0; i < n_registers; i++) {
+		guint32 n_value = g_htonl (values[i]);
+
+		memcpy (&packet->data[i * sizeof (guint32)], &n_value, sizeof (guint32));
+	}
 
 	return packet;
 }
@@ -234,22 +369,80 @@ arv_gvcp_packet_new_read_register_ack (guint32 value,
 				       guint16 packet_id,
 				       size_t *packet_size)
 {
-	ArvGvcpPacket *packet;
-	guint32 n_value = g_htonl (value);
+	return arv_gvcp_packet_new_read_registers_ack (1, &value, packet_id, packet_size);
+}
 
-	g_return_val_if_fail (packet_size != NULL, NULL);
+/**
+ * arv_gvcp_packet_init_write_registers_cmd: (skip)
+ * @packet: a memory block large enough for the command
+ * @n_registers: number of registers, at most %ARV_GVCP_WRITE_REGISTERS_MAX
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (array length=n_registers): values to write
+ * @packet_id: packet id
+ * Return value: the packet size, in bytes
+ *
+ * Write a write command of several registers in @packet.
+ */
 
-	*packet_size = arv_gvcp_packet_get_read_register_ack_size ();
+size_t
+arv_gvcp_packet_init_write_registers_cmd (ArvGvcpPacket *packet,
+					  guint n_registers,
+					  const guint32 *addresses,
+					  const guint32 *values,
+					  guint16 packet_id)
+{
+	guint i;
 
-	packet = g_malloc (*packet_size);
+	g_return_val_if_fail (packet != NULL, 0);
+	g_return_val_if_fail (addresses != NULL, 0);
+	g_return_val_if_fail (values != NULL, 0);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_WRITE_REGISTERS_MAX, 0);
 
-	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
-	packet->header.packet_flags = 0;
-	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_ACK);
-	packet->header.size = g_htons (sizeof (guint32));
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
+	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_WRITE_REGISTER_CMD);
+	packet->header.size = g_htons (2 * n_registers * sizeof (guint32));
 	packet->header.id = g_htons (packet_id);
 
-	memcpy (&packet->data, &n_value, sizeof (guint32));
+	for (i = 0; i < n_registers; i++) {
+		guint32 n_address = g_htonl (addresses[i]);
+		guint32 n_value = g_htonl (values[i]);
+
+		memcpy (&packet->data[2 * i * sizeof (guint32)], &n_address, sizeof (guint32));
+		memcpy (&packet->data[(2 * i + 1) * sizeof (guint32)], &n_value, sizeof (guint32));
+	}
+
+	return sizeof (ArvGvcpHeader) + 2 * n_registers * sizeof (guint32);
+}
+
+/**
+ * arv_gvcp_packet_new_write_registers_cmd: (skip)
+ * @n_registers: number of registers, at most %ARV_GVCP_WRITE_REGISTERS_MAX
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (array length=n_registers): values to write
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a write command of several registers.
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_write_registers_cmd (guint n_registers,
+					 const guint32 *addresses,
+					 const guint32 *values,
+					 guint16 packet_id,
+					 size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (addresses != NULL, NULL);
+	g_return_val_if_fail (values != NULL, NULL);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_WRITE_REGISTERS_MAX, NULL);
+
+	packet = g_malloc (sizeof (ArvGvcpHeader) + 2 * n_registers * sizeof (guint32));
+	*packet_size = arv_gvcp_packet_init_write_registers_cmd (packet, n_registers, addresses, values, packet_id);
 
 	return packet;
 }
@@ -271,26 +464,7 @@ arv_gvcp_packet_new_write_register_cmd (guint32 address,
 					guint16 packet_id,
 					size_t *packet_size)
 {
-	ArvGvcpPacket *packet;
-	guint32 n_address = g_htonl (address);
-	guint32 n_value = g_htonl (value);
-
-	g_return_val_if_fail (packet_size != NULL, NULL);
-
-	*packet_size = sizeof (ArvGvcpHeader) + 2 * sizeof (guint32);
-
-	packet = g_malloc (*packet_size);
-
-	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
-	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
-	packet->header.command = g_htons (ARV_GVCP_COMMAND_WRITE_REGISTER_CMD);
-	packet->header.size = g_htons (2 * sizeof (guint32));
-	packet->header.id = g_htons (packet_id);
-
-	memcpy (&packet->data, &n_address, sizeof (guint32));
-	memcpy (&packet->data[sizeof (guint32)], &n_value, sizeof (guint32));
-
-	return packet;
+	return arv_gvcp_packet_new_write_registers_cmd (1, &address, &value, packet_id, packet_size);
 }
 
 /**
@@ -386,16 +560,67 @@ arv_gvcp_packet_new_discovery_ack (guint16 packet_id, size_t *packet_size)
 	return packet;
 }
 
+/**
+ * arv_gvcp_packet_init_packet_resend_cmd: (skip)
+ * @packet: a memory block of at least %ARV_GVCP_PACKET_RESEND_CMD_SIZE_MAX bytes
+ * @frame_id: frame id
+ * @first_block: first missing packet
+ * @last_block: last missing packet
+ * @extended_ids: use extended frame and block ids
+ * @stream_channel: index of the stream channel
+ * @packet_id: packet id
+ *
+ * Write a packet resend command in @packet, which allows the stream threads to build their requests without any
+ * allocation. The stream channel index is in the upper 16 bits of the first word.
+ *
+ * Return value: the packet size, in bytes
+ */
+
+size_t
+arv_gvcp_packet_init_packet_resend_cmd (ArvGvcpPacket *packet, guint64 frame_id,
+					guint32 first_block, guint32 last_block,
+					gboolean extended_ids, guint16 stream_channel,
+					guint16 packet_id)
+{
+	guint32 *data;
+
+	g_return_val_if_fail (packet != NULL, 0);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
+	packet->header.packet_flags = extended_ids ? ARV_GVCP_CMD_PACKET_FLAGS_EXTENDED_IDS : 0;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_PACKET_RESEND_CMD);
+	packet->header.size = g_htons ((extended_ids ? 5 : 3) * sizeof (guint32));
+	packet->header.id = g_htons (packet_id);
+
+	data = (guint32 *) &packet->data;
+
+	if (extended_ids) {
+		data[0] = g_htonl ((guint32) stream_channel << 16);
+		data[1] = g_htonl (first_block);
+		data[2] = g_htonl (last_block);
+		*((guint64 *) &data[3]) = GUINT64_TO_BE (frame_id);
+	} else {
+		data[0] = g_htonl (((guint32) stream_channel << 16) | ((guint32) frame_id & 0xffff));
+		/* With regular ids, only the 24 bits are valid */
+		data[1] = g_htonl (first_block & ARV_GVSP_PACKET_ID_MASK);
+		data[2] = g_htonl (last_block & ARV_GVSP_PACKET_ID_MASK);
+	}
+
+	return sizeof (ArvGvcpHeader) + sizeof (guint32) * (extended_ids ? 5 : 3);
+}
+
 /**
  * arv_gvcp_packet_new_packet_resend_cmd: (skip)
  * @frame_id: frame id
  * @first_block: first missing packet
  * @last_block: last missing packet
  * @extended_ids: use extended frame and block ids
+ * @stream_channel: index of the stream channel
  * @packet_id: packet id
  * @packet_size: (out): packet size, in bytes
  *
- * Create a gvcp packet for a packet resend command.
+ * Create a gvcp packet for a packet resend command. The stream channel index is in the upper 16 bits of the first
+ * word.
  *
  * Return value: (transfer full): a new #ArvGvcpPacket
  */
@@ -403,41 +628,183 @@ arv_gvcp_packet_new_discovery_ack (guint16 packet_id, size_t *packet_size)
 ArvGvcpPacket *
 arv_gvcp_packet_new_packet_resend_cmd (guint64 frame_id,
 				       guint32 first_block, guint32 last_block,
-				       gboolean extended_ids,
+				       gboolean extended_ids, guint16 stream_channel,
 				       guint16 packet_id, size_t *packet_size)
 {
 	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	packet = g_malloc (ARV_GVCP_PACKET_RESEND_CMD_SIZE_MAX);
+	*packet_size = arv_gvcp_packet_init_packet_resend_cmd (packet, frame_id, first_block, last_block,
+							       extended_ids, stream_channel, packet_id);
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_new_action_cmd: (skip)
+ * @device_key: device key, matched against the ActionDeviceKey of the devices
+ * @group_key: group key, matched against the ActionGroupKey of the devices
+ * @group_mask: group mask, ANDed with the ActionGroupMask of the devices
+ * @scheduled: whether the action is scheduled at @action_time
+ * @action_time: device time of the scheduled action
+ * @ack_required: whether the devices must acknowledge the action
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an action command.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_action_cmd (guint32 device_key, guint32 group_key, guint32 group_mask,
+				gboolean scheduled, guint64 action_time, gboolean ack_required,
+				guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
 	guint32 *data;
+	size_t data_size;
 
 	g_return_val_if_fail (packet_size != NULL, NULL);
 
-	*packet_size = sizeof (ArvGvcpHeader) + sizeof (guint32) * (extended_ids ? 5 : 3);
+	data_size = sizeof (guint32) * (scheduled ? 5 : 3);
+	*packet_size = sizeof (ArvGvcpHeader) + data_size;
 
 	packet = g_malloc (*packet_size);
 
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
-	packet->header.packet_flags = extended_ids ? ARV_GVCP_CMD_PACKET_FLAGS_EXTENDED_IDS : 0;
-	packet->header.command = g_htons (ARV_GVCP_COMMAND_PACKET_RESEND_CMD);
-	packet->header.size = g_htons ((extended_ids ? 5 : 3) * sizeof (guint32));
+	packet->header.packet_flags = (scheduled ? ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED : 0) |
+		(ack_required ? ARV_GVCP_ACTION_PACKET_FLAGS_ACK_REQUIRED : 0);
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_ACTION_CMD);
+	packet->header.size = g_htons (data_size);
 	packet->header.id = g_htons (packet_id);
 
 	data = (guint32 *) &packet->data;
 
-	if (extended_ids) {
-		data[0] = 0;
-		data[1] = g_htonl (first_block);
-		data[2] = g_htonl (last_block);
-		*((guint64 *) &data[3]) = GUINT64_TO_BE (frame_id);
-	} else {
-		data[0] = g_htonl ((guint32) frame_id);
-		/* With regular ids, only the 24 bits are valid */
-		data[1] = g_htonl (first_block & ARV_GVSP_PACKET_ID_MASK);
-		data[2] = g_htonl (last_block & ARV_GVSP_PACKET_ID_MASK);
+	data[0] = g_htonl (device_key);
+	data[1] = g_htonl (group_key);
+	data[2] = g_htonl (group_mask);
+	if (scheduled) {
+		data[3] = g_htonl ((guint32) (action_time >> 32));
+		data[4] = g_htonl ((guint32) action_time);
 	}
 
 	return packet;
 }
 
+/**
+ * arv_gvcp_packet_new_event_ack: (skip)
+ * @event_command: the acknowledged command, %ARV_GVCP_COMMAND_EVENT_CMD or %ARV_GVCP_COMMAND_EVENT_DATA_CMD
+ * @packet_id: id of the acknowledged packet
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an event acknowledge.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_event_ack (ArvGvcpCommand event_command, guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	*packet_size = sizeof (ArvGvcpHeader);
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
+	packet->header.packet_flags = 0;
+	packet->header.command = g_htons (event_command == ARV_GVCP_COMMAND_EVENT_DATA_CMD ?
+					  ARV_GVCP_COMMAND_EVENT_DATA_ACK :
+					  ARV_GVCP_COMMAND_EVENT_ACK);
+	packet->header.size = 0;
+	packet->header.id = g_htons (packet_id);
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_get_event_item: (skip)
+ * @packet: an event or event data command packet
+ * @packet_size: received size of @packet, in bytes
+ * @offset: (inout): offset of the next item in the packet payload, 0 for the first one
+ * @event_id: (out) (allow-none): event identifier
+ * @timestamp: (out) (allow-none): device timestamp of the event
+ * @item: (out) (allow-none): start of the event item, including its header
+ * @item_size: (out) (allow-none): event item size
+ * @data: (out) (allow-none): data attached to the event, after the item header
+ * @data_size: (out) (allow-none): size of @data
+ *
+ * Iterates over the event items of a message channel packet. An EVENT_CMD packet may carry several items, an
+ * EVENTDATA_CMD packet carries a single item followed by its data.
+ *
+ * Returns: %TRUE if an item was found at @offset.
+ */
+
+gboolean
+arv_gvcp_packet_get_event_item (const ArvGvcpPacket *packet, size_t packet_size, size_t *offset,
+				guint16 *event_id, guint64 *timestamp,
+				const void **item, size_t *item_size,
+				const void **data, size_t *data_size)
+{
+	const char *payload;
+	const char *ptr;
+	size_t payload_size;
+	size_t header_size;
+	size_t size;
+	guint16 declared_size;
+	gboolean extended_ids;
+
+	g_return_val_if_fail (offset != NULL, FALSE);
+
+	if (packet == NULL || packet_size < sizeof (ArvGvcpHeader))
+		return FALSE;
+
+	payload = (const char *) &packet->data;
+	payload_size = MIN (g_ntohs (packet->header.size), packet_size - sizeof (ArvGvcpHeader));
+
+	/* Extended ids events have a 64 bit block id, and a 64 bit timestamp */
+	extended_ids = (packet->header.packet_flags & ARV_GVCP_EVENT_PACKET_FLAGS_64BIT_ID) != 0;
+	header_size = extended_ids ? 24 : 16;
+
+	if (*offset + header_size > payload_size)
+		return FALSE;
+
+	ptr = payload + *offset;
+
+	if (g_ntohs (packet->header.command) == ARV_GVCP_COMMAND_EVENT_DATA_CMD) {
+		size = payload_size - *offset;
+	} else {
+		/* The first field is reserved in GigE Vision 1.x, and holds the item size since 2.0 */
+		declared_size = g_ntohs (*((guint16 *) ptr));
+		size = declared_size >= header_size ? MIN (declared_size, payload_size - *offset) : header_size;
+	}
+
+	if (event_id != NULL)
+		*event_id = g_ntohs (*((guint16 *) (ptr + 2)));
+	if (timestamp != NULL) {
+		const guint32 *ts = (const guint32 *) (ptr + header_size - 8);
+
+		*timestamp = ((guint64) g_ntohl (ts[0]) << 32) | g_ntohl (ts[1]);
+	}
+	if (item != NULL)
+		*item = ptr;
+	if (item_size != NULL)
+		*item_size = size;
+	if (data != NULL)
+		*data = ptr + header_size;
+	if (data_size != NULL)
+		*data_size = size - header_size;
+
+	*offset += size;
+
+	return TRUE;
+}
+
 static const char *
 arv_enum_to_string (GType type,
 		    guint enum_value)
@@ -116,6 +116,8 @@ G_BEGIN_DECLS
 #define ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_HIGH_OFFSET	0x0000093c
 #define ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_LOW_OFFSET	0x00000940
 #define ARV_GVBS_TIMESTAMP_CONTROL_OFFSET		0x00000944
+#define ARV_GVBS_TIMESTAMP_CONTROL_RESET		1 << 0
+#define ARV_GVBS_TIMESTAMP_CONTROL_LATCH		1 << 1
 #define ARV_GVBS_TIMESTAMP_LATCHED_VALUE_HIGH_OFFSET	0x00000948
 #define ARV_GVBS_TIMESTAMP_LATCHED_VALUE_LOW_OFFSET	0x0000094c
 
@@ -123,6 +125,12 @@ G_BEGIN_DECLS
 #define ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL	1 << 1
 #define ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_EXCLUSIVE	1 << 0
 
+#define ARV_GVBS_MESSAGE_CHANNEL_0_PORT_OFFSET			0x00000b00
+#define ARV_GVBS_MESSAGE_CHANNEL_0_DESTINATION_ADDRESS_OFFSET	0x00000b10
+#define ARV_GVBS_MESSAGE_CHANNEL_0_TRANSMISSION_TIMEOUT_OFFSET	0x00000b14
+#define ARV_GVBS_MESSAGE_CHANNEL_0_RETRY_COUNT_OFFSET		0x00000b18
+#define ARV_GVBS_MESSAGE_CHANNEL_0_SOURCE_PORT_OFFSET		0x00000b1c
+
 #define ARV_GVBS_STREAM_CHANNEL_0_PORT_OFFSET		0x00000d00
 
 #define ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_OFFSET		0x00000d04
@@ -157,6 +165,12 @@ G_BEGIN_DECLS
 #define ARV_GVBS_STREAM_CHANNEL_0_FRAME_JITTER_MAX_OFFSET		0x0000c10c
 
 #define ARV_GVCP_DATA_SIZE_MAX				512
+/* Largest READMEM_CMD data size allowed by the protocol, for a 548 bytes ack payload */
+#define ARV_GVCP_READ_MEMORY_SIZE_MAX			536
+
+/* Maximum number of registers in a single READREG_CMD / WRITEREG_CMD, for a 540 bytes payload */
+#define ARV_GVCP_READ_REGISTERS_MAX			135
+#define ARV_GVCP_WRITE_REGISTERS_MAX			67
 
 /**
  * ArvGvcpPacketType:
@@ -253,6 +267,19 @@ typedef enum {
 	ARV_GVCP_EVENT_PACKET_FLAGS_64BIT_ID =			0x10,
 } ArvGvcpEventPacketFlags;
 
+/**
+ * ArvGvcpActionPacketFlags:
+ * @ARV_GVCP_ACTION_PACKET_FLAGS_NONE: no flag defined
+ * @ARV_GVCP_ACTION_PACKET_FLAGS_ACK_REQUIRED: acknowledge required
+ * @ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED: scheduled action, the packet contains the action time
+ */
+
+typedef enum {
+	ARV_GVCP_ACTION_PACKET_FLAGS_NONE =			0x00,
+	ARV_GVCP_ACTION_PACKET_FLAGS_ACK_REQUIRED =		0x01,
+	ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED =		0x80,
+} ArvGvcpActionPacketFlags;
+
 /**
  * ArvGvcpDiscoveryPacketFlags:
  * @ARV_GVCP_DISCOVERY_PACKET_FLAGS_NONE: no flag defined
@@ -281,6 +308,12 @@ typedef enum {
  * @ARV_GVCP_COMMAND_WRITE_MEMORY_CMD: write memory command
  * @ARV_GVCP_COMMAND_WRITE_MEMORY_ACK: write memory acknowledge
  * @ARV_GVCP_COMMAND_PENDING_ACK: pending command acknowledge
+ * @ARV_GVCP_COMMAND_EVENT_CMD: event command, on the message channel
+ * @ARV_GVCP_COMMAND_EVENT_ACK: event acknowledge
+ * @ARV_GVCP_COMMAND_EVENT_DATA_CMD: event command with attached data, on the message channel
+ * @ARV_GVCP_COMMAND_EVENT_DATA_ACK: event with data acknowledge
+ * @ARV_GVCP_COMMAND_ACTION_CMD: action command
+ * @ARV_GVCP_COMMAND_ACTION_ACK: action acknowledge
  */
 
 typedef enum {
@@ -298,7 +331,13 @@ typedef enum {
 	ARV_GVCP_COMMAND_READ_MEMORY_ACK =	0x0085,
 	ARV_GVCP_COMMAND_WRITE_MEMORY_CMD =	0x0086,
 	ARV_GVCP_COMMAND_WRITE_MEMORY_ACK =	0x0087,
-	ARV_GVCP_COMMAND_PENDING_ACK =		0x0089
+	ARV_GVCP_COMMAND_PENDING_ACK =		0x0089,
+	ARV_GVCP_COMMAND_EVENT_CMD =		0x00c0,
+	ARV_GVCP_COMMAND_EVENT_ACK =		0x00c1,
+	ARV_GVCP_COMMAND_EVENT_DATA_CMD =	0x00c2,
+	ARV_GVCP_COMMAND_EVENT_DATA_ACK =	0x00c3,
+	ARV_GVCP_COMMAND_ACTION_CMD =		0x0100,
+	ARV_GVCP_COMMAND_ACTION_ACK =		0x0101
 } ArvGvcpCommand;
 
 #pragma pack(push,1)
@@ -337,7 +376,19 @@ typedef struct {
 
 #pragma pack(pop)
 
+/* Size of a packet resend command with extended ids, the largest one */
+#define ARV_GVCP_PACKET_RESEND_CMD_SIZE_MAX	(sizeof (ArvGvcpHeader) + 5 * sizeof (guint32))
+
 void 			arv_gvcp_packet_free 			(ArvGvcpPacket *packet);
+size_t			arv_gvcp_packet_init_read_memory_cmd	(ArvGvcpPacket *packet, guint32 address, guint32 size,
+								 guint16 packet_id);
+size_t			arv_gvcp_packet_init_write_memory_cmd	(ArvGvcpPacket *packet, guint32 address, guint32 size,
+								 const char *buffer, guint16 packet_id);
+size_t			arv_gvcp_packet_init_read_registers_cmd	(ArvGvcpPacket *packet, guint n_registers,
+								 const guint32 *addresses, guint16 packet_id);
+size_t			arv_gvcp_packet_init_write_registers_cmd (ArvGvcpPacket *packet, guint n_registers,
+								  const guint32 *addresses, const guint32 *values,
+								  guint16 packet_id);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_memory_cmd 	(guint32 address, guint32 size,
 								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_memory_ack 	(guint32 address, guint32 size, guint16 packet_id,
@@ -346,6 +397,13 @@ ArvGvcpPacket * 	arv_gvcp_packet_new_write_memory_cmd	(guint32 address, guint32
 								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_write_memory_ack	(guint32 address,
 								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_read_registers_cmd 	(guint n_registers, const guint32 *addresses,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_read_registers_ack 	(guint n_registers, const guint32 *values,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_write_registers_cmd	(guint n_registers, const guint32 *addresses,
+								 const guint32 *values,
+								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_register_cmd 	(guint32 address,
 								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_register_ack 	(guint32 value,
@@ -358,8 +416,22 @@ ArvGvcpPacket * 	arv_gvcp_packet_new_discovery_cmd 	(size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_discovery_ack 	(guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_packet_resend_cmd 	(guint64 frame_id,
 								 guint32 first_block, guint32 last_block,
-								 gboolean extended_ids,
+								 gboolean extended_ids, guint16 stream_channel,
+								 guint16 packet_id, size_t *packet_size);
+size_t			arv_gvcp_packet_init_packet_resend_cmd	(ArvGvcpPacket *packet, guint64 frame_id,
+								 guint32 first_block, guint32 last_block,
+								 gboolean extended_ids, guint16 stream_channel,
+								 guint16 packet_id);
+ArvGvcpPacket * 	arv_gvcp_packet_new_action_cmd 		(guint32 device_key, guint32 group_key,
+								 guint32 group_mask, gboolean scheduled,
+								 guint64 action_time, gboolean ack_required,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_event_ack 		(ArvGvcpCommand event_command,
 								 guint16 packet_id, size_t *packet_size);
+gboolean		arv_gvcp_packet_get_event_item		(const ArvGvcpPacket *packet, size_t packet_size,
+								 size_t *offset, guint16 *event_id, guint64 *timestamp,
+								 const void **item, size_t *item_size,
+								 const void **data, size_t *data_size);
 
 const char *		arv_gvcp_packet_type_to_string 		(ArvGvcpPacketType value);
 const char * 		arv_gvcp_command_to_string 		(ArvGvcpCommand value);
@@ -532,6 +604,66 @@ arv_gvcp_packet_get_write_register_cmd_infos (const ArvGvcpPacket *packet, guint
 		*value = g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) + sizeof (guint32))));
 }
 
+static inline guint
+arv_gvcp_packet_get_read_registers_cmd_n_registers (const ArvGvcpPacket *packet)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohs (packet->header.size) / sizeof (guint32);
+}
+
+static inline guint32
+arv_gvcp_packet_get_read_registers_cmd_address (const ArvGvcpPacket *packet, guint index)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) + index * sizeof (guint32))));
+}
+
+static inline guint32
+arv_gvcp_packet_get_read_registers_ack_value (const ArvGvcpPacket *packet, guint index)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) + index * sizeof (guint32))));
+}
+
+static inline size_t
+arv_gvcp_packet_get_read_registers_ack_size (guint n_registers)
+{
+	return sizeof (ArvGvcpHeader) + n_registers * sizeof (guint32);
+}
+
+static inline guint
+arv_gvcp_packet_get_write_registers_cmd_n_registers (const ArvGvcpPacket *packet)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohs (packet->header.size) / (2 * sizeof (guint32));
+}
+
+static inline void
+arv_gvcp_packet_get_write_registers_cmd_infos (const ArvGvcpPacket *packet, guint index,
+					       guint32 *address, guint32 *value)
+{
+	const char *data;
+
+	if (packet == NULL) {
+		if (address != NULL)
+			*address = 0;
+		if (value != NULL)
+			*value = 0;
+		return;
+	}
+
+	data = (const char *) packet + sizeof (ArvGvcpPacket) + 2 * index * sizeof (guint32);
+
+	if (address != NULL)
+		*address = g_ntohl (*((guint32 *) data));
+	if (value != NULL)
+		*value = g_ntohl (*((guint32 *) (data + sizeof (guint32))));
+}
+
 static inline size_t
 arv_gvcp_packet_get_write_register_ack_size (void)
 {
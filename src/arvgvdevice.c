@@ -35,11 +35,17 @@
 #include <arvgvstreamprivate.h>
 #include <arvgvcpprivate.h>
 #include <arvgvspprivate.h>
+#include <arvtraceprivate.h>
 #include <arvnetworkprivate.h>
-#include <arvzip.h>
+#include <arvzipprivate.h>
+#include <arvdomparserprivate.h>
+#include <arvgcprivate.h>
 #include <arvstr.h>
 #include <arvmiscprivate.h>
 #include <arvenumtypes.h>
+#include <arvrealtime.h>
+#include <arvgenicamcacheprivate.h>
+#include <arvhttpprivate.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -50,7 +56,10 @@ enum
 	PROP_0,
 	PROP_GV_DEVICE_INTERFACE_ADDRESS,
 	PROP_GV_DEVICE_DEVICE_ADDRESS,
-	PROP_GV_DEVICE_PACKET_SIZE_ADJUSTEMENT
+	PROP_GV_DEVICE_PACKET_SIZE_ADJUSTEMENT,
+	PROP_GV_DEVICE_HEARTBEAT_CPU_AFFINITY,
+	PROP_GV_DEVICE_GVCP_WINDOW_SIZE,
+	PROP_GV_DEVICE_MONITOR
 };
 
 typedef struct {
@@ -65,36 +74,133 @@ typedef struct {
 	GPollFD poll_in_event;
 
 	void *buffer;
+	/* Command packet, preallocated for the _send_cmd_and_receive_ack calls */
+	ArvGvcpPacket *cmd_packet;
 
 	unsigned int gvcp_n_retries;
 	unsigned int gvcp_timeout_ms;
+	unsigned int gvcp_window_size;
+	guint32 gvcp_read_memory_size;
+	/* Set when the READMEM size probe is claimed, on the first large read */
+	gint is_read_memory_size_negotiated;
+	/* Key of the negotiated READMEM size cache, 0 if unknown */
+	guint64 device_mac;
+	gboolean is_pipelining_disabled;
 
 	gboolean is_controller;
+
+	gint last_ack_ms;	/* monotonic time of the last acknowledge, truncated to 32 bits */
+
+	/* Smoothed round trip time and its mean deviation, 0 until the first sample */
+	guint64 gvcp_srtt_us;
+	guint64 gvcp_rttvar_us;
+
+	/* Statistics, updated with the mutex held, exported as device informations */
+	guint64 n_gvcp_commands;
+	guint64 n_gvcp_resent_commands;
+	guint64 n_gvcp_pending_acks;
+	guint64 n_gvcp_failures;
 } ArvGvDeviceIOData;
 
+static void
+_ack_received (ArvGvDeviceIOData *io_data)
+{
+	g_atomic_int_set (&io_data->last_ack_ms, (guint32) (g_get_monotonic_time () / 1000));
+}
+
+/* Jacobson/Karels estimation of the round trip time, only sampled on the commands acknowledged at the first send,
+ * without pending acknowledge (Karn's algorithm). Called with the mutex held. */
+
+static void
+_update_rtt (ArvGvDeviceIOData *io_data, guint64 rtt_us)
+{
+	rtt_us = MAX (rtt_us, 1);
+
+	if (io_data->gvcp_srtt_us == 0) {
+		io_data->gvcp_srtt_us = rtt_us;
+		io_data->gvcp_rttvar_us = rtt_us / 2;
+	} else {
+		guint64 delta_us = rtt_us > io_data->gvcp_srtt_us ?
+			rtt_us - io_data->gvcp_srtt_us :
+			io_data->gvcp_srtt_us - rtt_us;
+
+		io_data->gvcp_rttvar_us = (3 * io_data->gvcp_rttvar_us + delta_us) / 4;
+		io_data->gvcp_srtt_us = MAX ((7 * io_data->gvcp_srtt_us + rtt_us) / 8, 1);
+	}
+}
+
+/* The acknowledge timeout of a send, derived from the round trip time and doubled at each retry. It is bounded by
+ * gvcp_timeout_ms, which is also used for the last send, as some devices are slow to execute some commands, like the
+ * ones writing into flash memory, without sending pending acknowledges. */
+
+static guint
+_get_ack_timeout_ms (ArvGvDeviceIOData *io_data, unsigned int n_retries, unsigned int n_retries_max)
+{
+	guint64 timeout_ms;
+
+	if (io_data->gvcp_srtt_us == 0 || n_retries + 1 >= n_retries_max)
+		return io_data->gvcp_timeout_ms;
+
+	timeout_ms = (io_data->gvcp_srtt_us + 4 * io_data->gvcp_rttvar_us + 999) / 1000;
+	timeout_ms = MAX (timeout_ms, ARV_GV_DEVICE_GVCP_TIMEOUT_MS_MIN) << MIN (n_retries, 16);
+
+	return MIN (timeout_ms, io_data->gvcp_timeout_ms);
+}
+
+typedef struct _ArvGvDeviceGenicamFetch ArvGvDeviceGenicamFetch;
+
 typedef struct {
 	GInetAddress *interface_address;
 	GInetAddress *device_address;
 
 	ArvGvDeviceIOData *io_data;
 
-	void *heartbeat_thread;
 	void *heartbeat_data;
+	char *heartbeat_cpu_affinity;
+
+	ArvClockModel *clock_model;
+
+	guint gvcp_window_size;
 
 	ArvGc *genicam;
 
 	char *genicam_xml;
 	size_t genicam_xml_size;
 
+	/* Parsed during the xml download, until the genicam instantiation */
+	ArvDomDocument *genicam_document;
+	GBytes *genicam_compiled;
+	/* Cache key of the xml data, when they were loaded from the on-disk cache */
+	char *genicam_cache_key;
+	/* Download from a web server, running during the bootstrap register reads */
+	ArvGvDeviceGenicamFetch *genicam_fetch;
+
 	gboolean is_big_endian_device;
 
 	gboolean is_packet_resend_supported;
 	gboolean is_write_memory_supported;
+	gboolean is_event_supported;
+
+	GSocket *event_socket;
+	GThread *event_thread;
+	gint event_thread_cancel;
 
 	ArvGvStreamOption stream_options;
 	ArvGvPacketSizeAdjustment packet_size_adjustment;
+	guint packet_size_alignment;
+
+	GInetAddress *stream_multicast_group;
+	guint16 stream_multicast_port;
 
-	gboolean first_stream_created;
+	/* Serializes the stream creations, which select the channel of the GevSCxx features */
+	GMutex stream_channel_mutex;
+	/* Channels for which a stream was created, for the packet size adjustment */
+	guint64 channels_with_stream;
+
+	gboolean is_monitor;
+
+	/* Read at construction, for the identity check of the reconnections */
+	guint64 device_mac;
 
 	gboolean init_success;
 } ArvGvDevicePrivate ;
@@ -109,19 +215,58 @@ struct _ArvGvDeviceClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvGvDevice, arv_gv_device, ARV_TYPE_DEVICE, G_ADD_PRIVATE (ArvGvDevice))
 
+/* The acknowledges of the previous commands arriving after their retries, or duplicated by the network, are discarded
+ * in a single call before a new command is sent, instead of being rejected one by one while waiting for the expected
+ * answer. */
+
+static void
+_drain_stale_acks (ArvGvDeviceIOData *io_data)
+{
+	GInputVector vectors[ARV_GV_DEVICE_N_DRAINED_ACKS];
+	GInputMessage messages[ARV_GV_DEVICE_N_DRAINED_ACKS];
+	int n_messages;
+	int i;
+
+	if (g_poll (&io_data->poll_in_event, 1, 0) <= 0)
+		return;
+
+	arv_gpollfd_clear_one (&io_data->poll_in_event, io_data->socket);
+
+	memset (messages, 0, sizeof (messages));
+	for (i = 0; i < ARV_GV_DEVICE_N_DRAINED_ACKS; i++) {
+		vectors[i].buffer = io_data->buffer;
+		vectors[i].size = ARV_GV_DEVICE_BUFFER_SIZE;
+		messages[i].vectors = &vectors[i];
+		messages[i].num_vectors = 1;
+	}
+
+	n_messages = g_socket_receive_messages (io_data->socket, messages, ARV_GV_DEVICE_N_DRAINED_ACKS, 0,
+						NULL, NULL);
+	if (n_messages > 0)
+		arv_debug_device ("[GvDevice::drain_stale_acks] %d stale packet(s) discarded", n_messages);
+}
+
+/* For register commands, @size is the number of registers times 4, @addresses contains the register addresses and
+ * @buffer the register values. For memory commands, @addresses contains the memory address. The command is sent at
+ * most @n_retries_max times, or gvcp_n_retries times if it is 0. */
+
 static gboolean
 _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
-			   guint64 address, size_t size, void *buffer, GError **error)
+			   const guint64 *addresses, size_t size, void *buffer, unsigned int n_retries_max,
+			   GError **error)
 {
 	ArvGvcpCommand expected_ack_command;
 	ArvGvcpPacket *ack_packet = io_data->buffer;
-	ArvGvcpPacket *packet;
+	ArvGvcpPacket *packet = io_data->cmd_packet;
 	const char *operation;
 	size_t packet_size;
 	size_t ack_size;
 	unsigned int n_retries = 0;
 	gboolean success = FALSE;
 	ArvGvcpError command_error = ARV_GVCP_ERROR_NONE;
+	guint32 register_addresses[ARV_GVCP_READ_REGISTERS_MAX];
+	guint n_registers = size / sizeof (guint32);
+	guint i;
 	int count;
 
 	switch (command) {
@@ -138,60 +283,83 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
 			operation = "read_register";
 			expected_ack_command = ARV_GVCP_COMMAND_READ_REGISTER_ACK;
-			ack_size = arv_gvcp_packet_get_read_register_ack_size ();
+			ack_size = arv_gvcp_packet_get_read_registers_ack_size (n_registers);
+			g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_READ_REGISTERS_MAX, FALSE);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
 			operation = "write_register";
 			expected_ack_command = ARV_GVCP_COMMAND_WRITE_REGISTER_ACK;
 			ack_size = arv_gvcp_packet_get_write_register_ack_size ();
+			g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_WRITE_REGISTERS_MAX, FALSE);
 			break;
 		default:
 			g_assert_not_reached ();
 	}
 
+	if (command == ARV_GVCP_COMMAND_READ_REGISTER_CMD ||
+	    command == ARV_GVCP_COMMAND_WRITE_REGISTER_CMD)
+		for (i = 0; i < n_registers; i++)
+			register_addresses[i] = addresses[i];
+
 	g_return_val_if_fail (ack_size <= ARV_GV_DEVICE_BUFFER_SIZE, FALSE);
 
 	g_mutex_lock (&io_data->mutex);
 
+	if (n_retries_max == 0)
+		n_retries_max = io_data->gvcp_n_retries;
+
 	io_data->packet_id = arv_gvcp_next_packet_id (io_data->packet_id);
 
 	switch (command) {
 		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
-			packet = arv_gvcp_packet_new_read_memory_cmd (address, size,
-								      io_data->packet_id, &packet_size);
+			packet_size = arv_gvcp_packet_init_read_memory_cmd (packet, addresses[0], size,
+									    io_data->packet_id);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
-			packet = arv_gvcp_packet_new_write_memory_cmd (address, size, buffer,
-								       io_data->packet_id, &packet_size);
+			packet_size = arv_gvcp_packet_init_write_memory_cmd (packet, addresses[0], size, buffer,
+									     io_data->packet_id);
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			packet = arv_gvcp_packet_new_read_register_cmd (address,
-									io_data->packet_id, &packet_size);
+			packet_size = arv_gvcp_packet_init_read_registers_cmd (packet, n_registers, register_addresses,
+									       io_data->packet_id);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			packet = arv_gvcp_packet_new_write_register_cmd (address, *((guint32 *) buffer),
-									 io_data->packet_id, &packet_size);
+			packet_size = arv_gvcp_packet_init_write_registers_cmd (packet, n_registers, register_addresses,
+										buffer, io_data->packet_id);
 			break;
 		default:
 			g_assert_not_reached ();
 	}
 
+	io_data->n_gvcp_commands++;
+
+	_drain_stale_acks (io_data);
+
 	do {
 		GError *local_error = NULL;
 
+		if (n_retries > 0)
+			io_data->n_gvcp_resent_commands++;
+
 		arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_TRACE);
 
-		success = g_socket_send_to (io_data->socket, io_data->device_address,
-					    (const char *) packet, packet_size,
-					    NULL, &local_error) >= 0;
+		success = g_socket_send (io_data->socket, (const char *) packet, packet_size,
+					 NULL, &local_error) >= 0;
+
+		ARV_TRACEPOINT (gvcp_command, command, io_data->packet_id, g_get_monotonic_time ());
 
 		if (success) {
 			gint timeout_ms;
 			gint64 timeout_stop_ms;
+			gint64 send_time_us;
+			guint ack_timeout_ms;
 			gboolean pending_ack;
+			gboolean any_pending_ack = FALSE;
 			gboolean expected_answer;
 
-			timeout_stop_ms = g_get_monotonic_time () / 1000 + io_data->gvcp_timeout_ms;
+			send_time_us = g_get_monotonic_time ();
+			ack_timeout_ms = _get_ack_timeout_ms (io_data, n_retries, n_retries_max);
+			timeout_stop_ms = send_time_us / 1000 + ack_timeout_ms;
 
 			do {
 				pending_ack = FALSE;
@@ -222,13 +390,22 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 					ack_command = arv_gvcp_packet_get_command (ack_packet);
 					packet_id = arv_gvcp_packet_get_packet_id (ack_packet);
 
+					ARV_TRACEPOINT (gvcp_ack, ack_command, packet_id, packet_type,
+							g_get_monotonic_time ());
+
 					if (ack_command == ARV_GVCP_COMMAND_PENDING_ACK &&
 					    count >= arv_gvcp_packet_get_pending_ack_size ()) {
 						gint64 pending_ack_timeout_ms = arv_gvcp_packet_get_pending_ack_timeout (ack_packet);
 						pending_ack = TRUE;
+						any_pending_ack = TRUE;
 						expected_answer = FALSE;
+						io_data->n_gvcp_pending_acks++;
 
-						timeout_stop_ms = g_get_monotonic_time () / 1000 + pending_ack_timeout_ms;
+						/* The device is alive and executing the command, wait for its answer
+						 * instead of sending the command again */
+						_ack_received (io_data);
+						timeout_stop_ms = g_get_monotonic_time () / 1000 + pending_ack_timeout_ms +
+							ack_timeout_ms;
 
 						arv_debug_device ("[GvDevice::%s] Pending ack timeout = %" G_GINT64_FORMAT,
 								operation, pending_ack_timeout_ms);
@@ -264,6 +441,12 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 
 			success = success && expected_answer;
 
+			if (success) {
+				_ack_received (io_data);
+				if (n_retries == 0 && !any_pending_ack)
+					_update_rtt (io_data, g_get_monotonic_time () - send_time_us);
+			}
+
 			if (success && command_error == ARV_GVCP_ERROR_NONE) {
 				switch (command) {
 					case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
@@ -272,7 +455,9 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 					case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
 						break;
 					case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-						*((gint32 *) buffer) = arv_gvcp_packet_get_read_register_ack_value (ack_packet);
+						for (i = 0; i < n_registers; i++)
+							((guint32 *) buffer)[i] =
+								arv_gvcp_packet_get_read_registers_ack_value (ack_packet, i);
 						break;
 					case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
 						break;
@@ -287,9 +472,10 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 		}
 
 		n_retries++;
-	} while (!success && n_retries < io_data->gvcp_n_retries);
+	} while (!success && n_retries < n_retries_max);
 
-	arv_gvcp_packet_free (packet);
+	if (!success || command_error != ARV_GVCP_ERROR_NONE)
+		io_data->n_gvcp_failures++;
 
 	g_mutex_unlock (&io_data->mutex);
 
@@ -303,7 +489,7 @@ _send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
 			case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
 				break;
 			case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-				*((guint32 *) buffer) = 0;
+				memset (buffer, 0, size);
 				break;
 			case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
 				break;
@@ -329,48 +515,337 @@ static gboolean
 _read_memory (ArvGvDeviceIOData *io_data, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_MEMORY_CMD,
-					  address, size, buffer, error);
+					  &address, size, buffer, 0, error);
 }
 
 static gboolean
 _write_memory (ArvGvDeviceIOData *io_data, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	return  _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_WRITE_MEMORY_CMD,
-					   address, size, buffer, error);
+					   &address, size, buffer, 0, error);
 }
 
 static gboolean
-_read_register (ArvGvDeviceIOData *io_data, guint32 address, guint32 *value_placeholder, GError **error)
+_read_registers (ArvGvDeviceIOData *io_data, guint n_registers, const guint64 *addresses, guint32 *values,
+		 GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_REGISTER_CMD,
-					  address, sizeof (guint32), value_placeholder, error);
+					  addresses, n_registers * sizeof (guint32), values, 0, error);
 }
 
 static gboolean
-_write_register (ArvGvDeviceIOData *io_data, guint32 address, guint32 value, GError **error)
+_write_registers (ArvGvDeviceIOData *io_data, guint n_registers, const guint64 *addresses, const guint32 *values,
+		  GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_WRITE_REGISTER_CMD,
-					  address, sizeof (guint32), &value, error);
+					  addresses, n_registers * sizeof (guint32), (void *) values, 0, error);
 }
 
 static gboolean
-arv_gv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
+_read_register (ArvGvDeviceIOData *io_data, guint64 address, guint32 *value_placeholder, GError **error)
 {
-	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	return _read_registers (io_data, 1, &address, value_placeholder, error);
+}
+
+static gboolean
+_write_register (ArvGvDeviceIOData *io_data, guint64 address, guint32 value, GError **error)
+{
+	return _write_registers (io_data, 1, &address, &value, error);
+}
+
+/* Pipelined memory transfers
+ *
+ * Up to gvcp_window_size READMEM/WRITEMEM commands, each with its own packet_id, are kept in flight. Acks are
+ * matched by packet_id as they arrive, and each command is retransmitted on its own timeout, up to gvcp_n_retries
+ * sends. */
+
+typedef struct {
+	ArvGvcpPacket *packet;
+	size_t packet_size;
+	guint16 packet_id;
+	guint32 size;
+	char *data;
+	gint64 timeout_stop_ms;
+	unsigned int n_sends;
+} ArvGvDevicePipelinedCommand;
+
+/* Called with the data received in order, as soon as a contiguous range from the start address is complete */
+typedef void (*ArvGvDeviceProgressFunc) (const void *data, guint32 size, void *user_data);
+
+static void
+_pipelined_send (ArvGvDeviceIOData *io_data, ArvGvDevicePipelinedCommand *cmd, const char *operation)
+{
+	GError *local_error = NULL;
+
+	arv_gvcp_packet_debug (cmd->packet, ARV_DEBUG_LEVEL_TRACE);
+
+	if (g_socket_send (io_data->socket, (const char *) cmd->packet, cmd->packet_size,
+			   NULL, &local_error) < 0) {
+		arv_warning_device ("[GvDevice::%s] Command sending error: %s", operation,
+				    local_error != NULL ? local_error->message : "unknown");
+		g_clear_error (&local_error);
+	}
+
+	if (cmd->n_sends == 0)
+		io_data->n_gvcp_commands++;
+	else
+		io_data->n_gvcp_resent_commands++;
+
+	cmd->n_sends++;
+	cmd->timeout_stop_ms = g_get_monotonic_time () / 1000 + io_data->gvcp_timeout_ms;
+}
+
+static gboolean
+_send_pipelined_memory_cmds (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
+			     guint64 address, guint32 size, void *buffer,
+			     guint32 block_size, guint window_size,
+			     ArvGvDeviceProgressFunc progress_func, void *progress_data, GError **error)
+{
+	ArvGvDevicePipelinedCommand *cmds;
+	ArvGvcpCommand expected_ack_command;
+	ArvGvcpPacket *ack_packet = io_data->buffer;
+	ArvGvcpError command_error = ARV_GVCP_ERROR_NONE;
+	const char *operation;
+	guint n_blocks;
+	guint first_pending = 0;
+	guint next_block = 0;
+	guint n_done = 0;
+	guint i;
+	gboolean success = TRUE;
+
+	switch (command) {
+		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
+			operation = "read_memory";
+			expected_ack_command = ARV_GVCP_COMMAND_READ_MEMORY_ACK;
+			break;
+		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
+			operation = "write_memory";
+			expected_ack_command = ARV_GVCP_COMMAND_WRITE_MEMORY_ACK;
+			break;
+		default:
+			g_assert_not_reached ();
+	}
+
+	n_blocks = (size + block_size - 1) / block_size;
+	if (n_blocks == 0)
+		return TRUE;
+
+	cmds = g_new0 (ArvGvDevicePipelinedCommand, n_blocks);
+
+	for (i = 0; i < n_blocks; i++) {
+		cmds[i].size = MIN (block_size, size - i * block_size);
+		cmds[i].data = ((char *) buffer) + i * block_size;
+	}
+
+	g_mutex_lock (&io_data->mutex);
+
+	while (success && n_done < n_blocks) {
+		gint64 timeout_stop_ms = G_MAXINT64;
+		gint64 now_ms;
+		gint timeout_ms;
+		int count = 0;
+
+		/* Fill the window */
+		while (next_block < n_blocks && next_block - first_pending < window_size) {
+			ArvGvDevicePipelinedCommand *cmd = &cmds[next_block];
+			guint64 block_address = address + next_block * block_size;
+
+			io_data->packet_id = arv_gvcp_next_packet_id (io_data->packet_id);
+			cmd->packet_id = io_data->packet_id;
+
+			if (command == ARV_GVCP_COMMAND_READ_MEMORY_CMD)
+				cmd->packet = arv_gvcp_packet_new_read_memory_cmd (block_address, cmd->size,
+										   cmd->packet_id, &cmd->packet_size);
+			else
+				cmd->packet = arv_gvcp_packet_new_write_memory_cmd (block_address, cmd->size, cmd->data,
+										    cmd->packet_id, &cmd->packet_size);
+
+			_pipelined_send (io_data, cmd, operation);
+
+			next_block++;
+		}
+
+		for (i = first_pending; i < next_block; i++)
+			if (cmds[i].packet != NULL)
+				timeout_stop_ms = MIN (timeout_stop_ms, cmds[i].timeout_stop_ms);
+
+		timeout_ms = timeout_stop_ms - g_get_monotonic_time () / 1000;
+		if (timeout_ms < 0)
+			timeout_ms = 0;
+
+		if (g_poll (&io_data->poll_in_event, 1, timeout_ms) > 0) {
+			GError *local_error = NULL;
+
+			arv_gpollfd_clear_one (&io_data->poll_in_event, io_data->socket);
+			count = g_socket_receive (io_data->socket, io_data->buffer,
+						  ARV_GV_DEVICE_BUFFER_SIZE, NULL, &local_error);
+			if (local_error != NULL) {
+				arv_warning_device ("[GvDevice::%s] Ack reception error: %s", operation,
+						    local_error->message);
+				g_clear_error (&local_error);
+			}
+		}
+
+		if (count >= (int) sizeof (ArvGvcpHeader)) {
+			ArvGvDevicePipelinedCommand *cmd = NULL;
+			ArvGvcpPacketType packet_type;
+			ArvGvcpCommand ack_command;
+			guint16 packet_id;
+
+			arv_gvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_TRACE);
+
+			packet_type = arv_gvcp_packet_get_packet_type (ack_packet);
+			ack_command = arv_gvcp_packet_get_command (ack_packet);
+			packet_id = arv_gvcp_packet_get_packet_id (ack_packet);
+
+			for (i = first_pending; i < next_block && cmd == NULL; i++)
+				if (cmds[i].packet != NULL && cmds[i].packet_id == packet_id)
+					cmd = &cmds[i];
+
+			if (cmd == NULL) {
+				arv_info_device ("[GvDevice::%s] Unexpected answer (0x%02x, id %u)", operation,
+						 packet_type, packet_id);
+			} else if (ack_command == ARV_GVCP_COMMAND_PENDING_ACK &&
+				   count >= arv_gvcp_packet_get_pending_ack_size ()) {
+				gint64 pending_ack_timeout_ms = arv_gvcp_packet_get_pending_ack_timeout (ack_packet);
+
+				io_data->n_gvcp_pending_acks++;
+				cmd->timeout_stop_ms = g_get_monotonic_time () / 1000 + pending_ack_timeout_ms;
+
+				arv_debug_device ("[GvDevice::%s] Pending ack timeout = %" G_GINT64_FORMAT,
+						  operation, pending_ack_timeout_ms);
+			} else if (packet_type == ARV_GVCP_PACKET_TYPE_ERROR ||
+				   packet_type == ARV_GVCP_PACKET_TYPE_UNKNOWN_ERROR) {
+				if (ack_command == expected_ack_command) {
+					command_error = arv_gvcp_packet_get_packet_flags (ack_packet);
+					success = FALSE;
+				} else
+					arv_info_device ("[GvDevice::%s] Unexpected answer (0x%02x)", operation,
+							 packet_type);
+			} else if (packet_type == ARV_GVCP_PACKET_TYPE_ACK &&
+				   ack_command == expected_ack_command &&
+				   (command != ARV_GVCP_COMMAND_READ_MEMORY_CMD ||
+				    count >= arv_gvcp_packet_get_read_memory_ack_size (cmd->size))) {
+				if (command == ARV_GVCP_COMMAND_READ_MEMORY_CMD)
+					memcpy (cmd->data, arv_gvcp_packet_get_read_memory_ack_data (ack_packet),
+						cmd->size);
+
+				if (cmd->n_sends > 1)
+					arv_debug_device ("[GvDevice::%s] Block %u sent %u times", operation,
+							  (guint) (cmd - cmds), cmd->n_sends);
+
+				g_clear_pointer (&cmd->packet, arv_gvcp_packet_free);
+				n_done++;
+
+				_ack_received (io_data);
+
+				while (first_pending < next_block && cmds[first_pending].packet == NULL) {
+					if (progress_func != NULL)
+						progress_func (cmds[first_pending].data, cmds[first_pending].size,
+							       progress_data);
+					first_pending++;
+				}
+			} else
+				arv_info_device ("[GvDevice::%s] Unexpected answer (0x%02x)", operation,
+						 packet_type);
+		}
+
+		/* Retransmit the commands whose ack did not come in time */
+		now_ms = g_get_monotonic_time () / 1000;
+		for (i = first_pending; success && i < next_block; i++) {
+			if (cmds[i].packet == NULL || cmds[i].timeout_stop_ms > now_ms)
+				continue;
+
+			if (cmds[i].n_sends >= io_data->gvcp_n_retries) {
+				arv_warning_device ("[GvDevice::%s] Ack reception timeout", operation);
+				success = FALSE;
+			} else {
+				/* Some devices silently drop the commands received while they are busy. Don't
+				 * use pipelined transfers anymore with those. */
+				if (window_size > 1 && !io_data->is_pipelining_disabled) {
+					arv_info_device ("[GvDevice::%s] Command lost, disable pipelined transfers",
+							 operation);
+					io_data->is_pipelining_disabled = TRUE;
+				}
+				window_size = 1;
+
+				_pipelined_send (io_data, &cmds[i], operation);
+			}
+		}
+	}
+
+	if (!success)
+		io_data->n_gvcp_failures++;
+
+	g_mutex_unlock (&io_data->mutex);
+
+	for (i = 0; i < n_blocks; i++)
+		g_clear_pointer (&cmds[i].packet, arv_gvcp_packet_free);
+	g_free (cmds);
+
+	if (!success) {
+		if (command == ARV_GVCP_COMMAND_READ_MEMORY_CMD)
+			memset (buffer, 0, size);
+
+		if (error != NULL && *error == NULL) {
+			if (command_error != ARV_GVCP_ERROR_NONE)
+				*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+						      "GigEVision %s error (%s)", operation,
+						      arv_gvcp_error_to_string (command_error));
+			else
+				*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+						      "GigEVision %s timeout", operation);
+		}
+	}
+
+	return success;
+}
+
+static void _negotiate_read_memory_size (ArvGvDeviceIOData *io_data);
+
+static gboolean
+_read_memory_blocks (ArvGvDeviceIOData *io_data, guint64 address, guint32 size, void *buffer, guint window_size,
+		     ArvGvDeviceProgressFunc progress_func, void *progress_data, GError **error)
+{
+	guint32 block_size_max;
 	int i;
 	gint32 block_size;
 
-	for (i = 0; i < (size + ARV_GVCP_DATA_SIZE_MAX - 1) / ARV_GVCP_DATA_SIZE_MAX; i++) {
-		block_size = MIN (ARV_GVCP_DATA_SIZE_MAX, size - i * ARV_GVCP_DATA_SIZE_MAX);
-		if (!_read_memory (priv->io_data,
-				   address + i * ARV_GVCP_DATA_SIZE_MAX,
-				   block_size, ((char *) buffer) + i * ARV_GVCP_DATA_SIZE_MAX, error))
+	if (size > ARV_GVCP_DATA_SIZE_MAX)
+		_negotiate_read_memory_size (io_data);
+
+	block_size_max = io_data->gvcp_read_memory_size;
+
+	if (io_data->is_pipelining_disabled)
+		window_size = 1;
+
+	if (window_size > 1 && size > block_size_max)
+		return _send_pipelined_memory_cmds (io_data, ARV_GVCP_COMMAND_READ_MEMORY_CMD,
+						    address, size, buffer, block_size_max, window_size,
+						    progress_func, progress_data, error);
+
+	for (i = 0; i < (size + block_size_max - 1) / block_size_max; i++) {
+		block_size = MIN (block_size_max, size - i * block_size_max);
+		if (!_read_memory (io_data,
+				   address + i * block_size_max,
+				   block_size, ((char *) buffer) + i * block_size_max, error))
 			return FALSE;
+		if (progress_func != NULL)
+			progress_func (((char *) buffer) + i * block_size_max, block_size, progress_data);
 	}
 
 	return TRUE;
 }
 
+static gboolean
+arv_gv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+
+	return _read_memory_blocks (priv->io_data, address, size, buffer, priv->io_data->gvcp_window_size,
+				    NULL, NULL, error);
+}
+
 static gboolean
 arv_gv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
 {
@@ -378,6 +853,12 @@ arv_gv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, vo
 	int i;
 	gint32 block_size;
 
+	if (priv->io_data->gvcp_window_size > 1 && !priv->io_data->is_pipelining_disabled &&
+	    size > ARV_GVCP_DATA_SIZE_MAX)
+		return _send_pipelined_memory_cmds (priv->io_data, ARV_GVCP_COMMAND_WRITE_MEMORY_CMD,
+						    address, size, buffer, ARV_GVCP_DATA_SIZE_MAX,
+						    priv->io_data->gvcp_window_size, NULL, NULL, error);
+
 	for (i = 0; i < (size + ARV_GVCP_DATA_SIZE_MAX - 1) / ARV_GVCP_DATA_SIZE_MAX; i++) {
 		block_size = MIN (ARV_GVCP_DATA_SIZE_MAX, size - i * ARV_GVCP_DATA_SIZE_MAX);
 		if (!_write_memory (priv->io_data,
@@ -389,6 +870,65 @@ arv_gv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, vo
 	return TRUE;
 }
 
+/* The largest READMEM size is device dependent, up to the GVCP limit. A device which doesn't support the
+ * requested size is supposed to answer with an error status, but some just don't answer, so only one try is
+ * done. As this may cost a full GVCP timeout, the size is only probed on the first read larger than the default
+ * size, and the result is kept by device MAC address for the next instances of the same device. */
+
+static GMutex arv_gv_read_memory_size_mutex;
+static GHashTable *arv_gv_read_memory_sizes = NULL;
+
+static void
+_negotiate_read_memory_size (ArvGvDeviceIOData *io_data)
+{
+	char *buffer;
+	guint64 address = 0;
+	gboolean success;
+	gpointer cached_size = NULL;
+
+	if (!g_atomic_int_compare_and_exchange (&io_data->is_read_memory_size_negotiated, FALSE, TRUE))
+		return;
+
+	if (io_data->device_mac != 0) {
+		g_mutex_lock (&arv_gv_read_memory_size_mutex);
+		if (arv_gv_read_memory_sizes != NULL)
+			cached_size = g_hash_table_lookup (arv_gv_read_memory_sizes, &io_data->device_mac);
+		g_mutex_unlock (&arv_gv_read_memory_size_mutex);
+
+		if (cached_size != NULL) {
+			io_data->gvcp_read_memory_size = GPOINTER_TO_UINT (cached_size);
+			arv_info_device ("[GvDevice::negotiate_read_memory_size] Cached read memory size = %u bytes",
+					 io_data->gvcp_read_memory_size);
+			return;
+		}
+	}
+
+	buffer = g_malloc (ARV_GVCP_READ_MEMORY_SIZE_MAX);
+
+	success = _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_MEMORY_CMD,
+					     &address, ARV_GVCP_READ_MEMORY_SIZE_MAX, buffer, 1, NULL);
+
+	g_free (buffer);
+
+	io_data->gvcp_read_memory_size = success ? ARV_GVCP_READ_MEMORY_SIZE_MAX : ARV_GVCP_DATA_SIZE_MAX;
+
+	if (io_data->device_mac != 0) {
+		guint64 *key = g_new (guint64, 1);
+
+		*key = io_data->device_mac;
+
+		g_mutex_lock (&arv_gv_read_memory_size_mutex);
+		if (arv_gv_read_memory_sizes == NULL)
+			arv_gv_read_memory_sizes = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+		g_hash_table_replace (arv_gv_read_memory_sizes, key,
+				      GUINT_TO_POINTER (io_data->gvcp_read_memory_size));
+		g_mutex_unlock (&arv_gv_read_memory_size_mutex);
+	}
+
+	arv_info_device ("[GvDevice::negotiate_read_memory_size] Read memory size = %u bytes",
+			 io_data->gvcp_read_memory_size);
+}
+
 static gboolean
 arv_gv_device_read_register (ArvDevice *device, guint64 address, guint32 *value, GError **error)
 {
@@ -405,77 +945,639 @@ arv_gv_device_write_register (ArvDevice *device, guint64 address, guint32 value,
 	return _write_register (priv->io_data, address, value, error);
 }
 
-/* Heartbeat thread */
+static gboolean
+arv_gv_device_read_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, guint32 *values,
+			      GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	guint i;
+
+	for (i = 0; i < n_registers; i += ARV_GVCP_READ_REGISTERS_MAX)
+		if (!_read_registers (priv->io_data, MIN (ARV_GVCP_READ_REGISTERS_MAX, n_registers - i),
+				      &addresses[i], &values[i], error))
+			return FALSE;
+
+	return TRUE;
+}
+
+static gboolean
+arv_gv_device_write_registers (ArvDevice *device, guint n_registers, const guint64 *addresses,
+			       const guint32 *values, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	guint i;
+
+	for (i = 0; i < n_registers; i += ARV_GVCP_WRITE_REGISTERS_MAX)
+		if (!_write_registers (priv->io_data, MIN (ARV_GVCP_WRITE_REGISTERS_MAX, n_registers - i),
+				       &addresses[i], &values[i], error))
+			return FALSE;
+
+	return TRUE;
+}
+
+/* Heartbeat scheduler */
+
+/* A single thread issues the heartbeats of all the controlled devices of the process. The pending heartbeats are
+ * kept in a sequence sorted by due time. A heartbeat is skipped if a control command was acknowledged by the device
+ * during the last period, as any control traffic refreshes the device heartbeat timer, but the control privilege
+ * is still checked at least every ARV_GV_DEVICE_HEARTBEAT_MAX_SKIPPED periods. */
 
 typedef struct {
 	ArvGvDevice *gv_device;
 	ArvGvDeviceIOData *io_data;
-	int period_us;
+	gint64 period_us;
+
+	gint64 due_time;
+	gint64 retry_start_time;	/* 0 when no retry is pending */
+	guint n_tries;
+	guint n_skipped;
 
-	GCancellable *cancellable;
+	GSequenceIter *iter;		/* NULL while the heartbeat is running */
+	gboolean is_busy;
+	gint is_cancelled;
+
+	ArvClockModel *clock_model;
+	guint64 timestamp_tick_frequency;
+	gint64 next_clock_sample_time;	/* G_MAXINT64 if the device can't latch its timestamp */
 } ArvGvDeviceHeartbeatData;
 
+typedef struct {
+	GThread *thread;
+	gboolean cancel;
+} ArvGvHeartbeatThread;
+
+static GMutex arv_gv_heartbeat_mutex;
+static GCond arv_gv_heartbeat_cond;
+static GSequence *arv_gv_heartbeats = NULL;
+static guint arv_gv_heartbeat_n_devices = 0;
+static ArvGvHeartbeatThread *arv_gv_heartbeat_thread = NULL;
+static char *arv_gv_heartbeat_cpu_affinity = NULL;
+static gboolean arv_gv_heartbeat_is_affinity_changed = FALSE;
+
+static gint
+_heartbeat_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const ArvGvDeviceHeartbeatData *heartbeat_a = a;
+	const ArvGvDeviceHeartbeatData *heartbeat_b = b;
+
+	if (heartbeat_a->due_time < heartbeat_b->due_time)
+		return -1;
+
+	return heartbeat_a->due_time > heartbeat_b->due_time ? 1 : 0;
+}
+
+static void
+_heartbeat_update_affinity (const char *cpu_affinity)
+{
+	if (cpu_affinity != NULL && cpu_affinity[0] != '\0') {
+		if (arv_set_thread_cpu_affinity (cpu_affinity))
+			arv_info_device ("[GvDevice::Heartbeat] CPU affinity set to %s", cpu_affinity);
+		else
+			arv_warning_device ("[GvDevice::Heartbeat] Failed to set CPU affinity to %s",
+					    cpu_affinity);
+	}
+}
+
+static void
+_heartbeat_set_cpu_affinity (const char *cpu_affinity)
+{
+	g_mutex_lock (&arv_gv_heartbeat_mutex);
+	g_free (arv_gv_heartbeat_cpu_affinity);
+	arv_gv_heartbeat_cpu_affinity = g_strdup (cpu_affinity);
+	arv_gv_heartbeat_is_affinity_changed = TRUE;
+	g_cond_broadcast (&arv_gv_heartbeat_cond);
+	g_mutex_unlock (&arv_gv_heartbeat_mutex);
+}
+
+/* Samples the device clock for the device to host timestamp mapping. The device time is latched by a write to the
+ * timestamp control register, the matching host time being taken at the middle of the write transaction. The
+ * sampling traffic also refreshes the device heartbeat timer. */
+
+static void
+_clock_sample (ArvGvDeviceHeartbeatData *heartbeat_data, gint64 now)
+{
+	ArvGvDeviceIOData *io_data = heartbeat_data->io_data;
+	guint64 addresses[2] = {ARV_GVBS_TIMESTAMP_LATCHED_VALUE_HIGH_OFFSET, ARV_GVBS_TIMESTAMP_LATCHED_VALUE_LOW_OFFSET};
+	guint32 values[2];
+	guint64 frequency;
+	guint64 timestamp;
+	guint64 device_ns;
+	gint64 start_time;
+	gint64 end_time;
+
+	heartbeat_data->next_clock_sample_time = now + ARV_GV_DEVICE_CLOCK_SAMPLING_PERIOD_US;
+
+	if (heartbeat_data->timestamp_tick_frequency == 0) {
+		guint64 frequency_addresses[2] = {ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_HIGH_OFFSET,
+						  ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_LOW_OFFSET};
+
+		if (!_read_registers (io_data, 2, frequency_addresses, values, NULL))
+			return;
+
+		heartbeat_data->timestamp_tick_frequency = ((guint64) values[0] << 32) | values[1];
+		if (heartbeat_data->timestamp_tick_frequency == 0) {
+			arv_info_device ("[GvDevice::clock_sample] No timestamp tick frequency, clock model disabled");
+			heartbeat_data->next_clock_sample_time = G_MAXINT64;
+			return;
+		}
+	}
+
+	start_time = g_get_real_time ();
+	if (!_write_register (io_data, ARV_GVBS_TIMESTAMP_CONTROL_OFFSET, ARV_GVBS_TIMESTAMP_CONTROL_LATCH, NULL))
+		return;
+	end_time = g_get_real_time ();
+
+	if (!_read_registers (io_data, 2, addresses, values, NULL))
+		return;
+
+	timestamp = ((guint64) values[0] << 32) | values[1];
+	if (timestamp == 0) {
+		arv_info_device ("[GvDevice::clock_sample] Timestamp latch not supported, clock model disabled");
+		heartbeat_data->next_clock_sample_time = G_MAXINT64;
+		return;
+	}
+
+	/* Same conversion as the stream data leader timestamps */
+	frequency = heartbeat_data->timestamp_tick_frequency;
+	device_ns = (timestamp / frequency) * 1000000000 + ((timestamp % frequency) * 1000000000) / frequency;
+
+	if (!arv_clock_model_add_sample (heartbeat_data->clock_model, device_ns,
+					 (start_time + end_time) / 2 * 1000, (end_time - start_time) * 1000))
+		arv_debug_device ("[GvDevice::clock_sample] Sample discarded, round trip = %" G_GINT64_FORMAT " µs",
+				  end_time - start_time);
+}
+
+/* Runs one heartbeat step of a device, and sets its next due time. A failed read is retried every
+ * ARV_GV_DEVICE_HEARTBEAT_RETRY_DELAY_US by rescheduling, instead of blocking the other devices. */
+
+static void
+_heartbeat_run (ArvGvDeviceHeartbeatData *heartbeat_data)
+{
+	ArvGvDeviceIOData *io_data = heartbeat_data->io_data;
+	gint64 now;
+	guint32 value;
+
+	now = g_get_monotonic_time ();
+
+	heartbeat_data->due_time = now + heartbeat_data->period_us;
+
+	if (!io_data->is_controller) {
+		heartbeat_data->retry_start_time = 0;
+		return;
+	}
+
+	if (heartbeat_data->retry_start_time == 0) {
+		gint64 elapsed_ms;
+
+		if (now >= heartbeat_data->next_clock_sample_time)
+			_clock_sample (heartbeat_data, now);
+
+		elapsed_ms = (guint32) (now / 1000) - (guint32) g_atomic_int_get (&io_data->last_ack_ms);
+		if (elapsed_ms * 1000 < heartbeat_data->period_us &&
+		    heartbeat_data->n_skipped < ARV_GV_DEVICE_HEARTBEAT_MAX_SKIPPED) {
+			heartbeat_data->n_skipped++;
+			heartbeat_data->due_time = now + heartbeat_data->period_us - elapsed_ms * 1000;
+			return;
+		}
+
+		heartbeat_data->n_skipped = 0;
+		heartbeat_data->n_tries = 0;
+		heartbeat_data->retry_start_time = now;
+	}
+
+	/* TODO: Instead of reading the control register, Pylon does write the heartbeat
+	 * timeout value, which is interresting, as doing this we could get an error
+	 * ack packet which will indicate we lost the control access. */
+
+	heartbeat_data->n_tries++;
+
+	if (!_read_register (io_data, ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET, &value, NULL)) {
+		now = g_get_monotonic_time ();
+		if (now - heartbeat_data->retry_start_time <
+		    ARV_GV_DEVICE_HEARTBEAT_RETRY_TIMEOUT_S * G_USEC_PER_SEC) {
+			heartbeat_data->due_time = now + ARV_GV_DEVICE_HEARTBEAT_RETRY_DELAY_US;
+			return;
+		}
+	}
+
+	heartbeat_data->retry_start_time = 0;
+
+	if (g_atomic_int_get (&heartbeat_data->is_cancelled)) {
+		io_data->is_controller = FALSE;
+		return;
+	}
+
+	arv_debug_device ("[GvDevice::Heartbeat] Ack value = %d", value);
+
+	if (heartbeat_data->n_tries > 1)
+		arv_debug_device ("[GvDevice::Heartbeat] Tried %u times", heartbeat_data->n_tries);
+
+	if ((value & (ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL |
+		      ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_EXCLUSIVE)) == 0) {
+		arv_warning_device ("[GvDevice::Heartbeat] Control access lost");
+
+		arv_device_emit_control_lost_signal (ARV_DEVICE (heartbeat_data->gv_device));
+
+		io_data->is_controller = FALSE;
+	}
+}
+
 static void *
 arv_gv_device_heartbeat_thread (void *data)
 {
-	ArvGvDeviceHeartbeatData *thread_data = data;
-	ArvGvDeviceIOData *io_data = thread_data->io_data;
+	ArvGvHeartbeatThread *thread = data;
+
+	g_mutex_lock (&arv_gv_heartbeat_mutex);
+
+	while (!thread->cancel) {
+		ArvGvDeviceHeartbeatData *heartbeat_data;
+		GSequenceIter *first;
+
+		if (arv_gv_heartbeat_is_affinity_changed) {
+			char *cpu_affinity;
+
+			cpu_affinity = g_strdup (arv_gv_heartbeat_cpu_affinity);
+			arv_gv_heartbeat_is_affinity_changed = FALSE;
+
+			g_mutex_unlock (&arv_gv_heartbeat_mutex);
+			_heartbeat_update_affinity (cpu_affinity);
+			g_free (cpu_affinity);
+			g_mutex_lock (&arv_gv_heartbeat_mutex);
+			continue;
+		}
+
+		first = g_sequence_get_begin_iter (arv_gv_heartbeats);
+		if (g_sequence_iter_is_end (first)) {
+			g_cond_wait (&arv_gv_heartbeat_cond, &arv_gv_heartbeat_mutex);
+			continue;
+		}
+
+		heartbeat_data = g_sequence_get (first);
+		if (heartbeat_data->due_time > g_get_monotonic_time ()) {
+			g_cond_wait_until (&arv_gv_heartbeat_cond, &arv_gv_heartbeat_mutex, heartbeat_data->due_time);
+			continue;
+		}
+
+		g_sequence_remove (first);
+		heartbeat_data->iter = NULL;
+		heartbeat_data->is_busy = TRUE;
+
+		g_mutex_unlock (&arv_gv_heartbeat_mutex);
+		_heartbeat_run (heartbeat_data);
+		g_mutex_lock (&arv_gv_heartbeat_mutex);
+
+		heartbeat_data->is_busy = FALSE;
+
+		if (g_atomic_int_get (&heartbeat_data->is_cancelled))
+			g_cond_broadcast (&arv_gv_heartbeat_cond);
+		else
+			heartbeat_data->iter = g_sequence_insert_sorted (arv_gv_heartbeats, heartbeat_data,
+									 _heartbeat_compare, NULL);
+	}
+
+	g_mutex_unlock (&arv_gv_heartbeat_mutex);
+
+	return NULL;
+}
+
+static void
+_heartbeat_register (ArvGvDeviceHeartbeatData *heartbeat_data)
+{
+	g_mutex_lock (&arv_gv_heartbeat_mutex);
+
+	if (arv_gv_heartbeats == NULL)
+		arv_gv_heartbeats = g_sequence_new (NULL);
+
+	heartbeat_data->due_time = g_get_monotonic_time () + heartbeat_data->period_us;
+	heartbeat_data->iter = g_sequence_insert_sorted (arv_gv_heartbeats, heartbeat_data,
+							 _heartbeat_compare, NULL);
+	arv_gv_heartbeat_n_devices++;
+
+	if (arv_gv_heartbeat_thread == NULL) {
+		arv_gv_heartbeat_thread = g_new0 (ArvGvHeartbeatThread, 1);
+		arv_gv_heartbeat_thread->thread = g_thread_new ("arv_gv_heartbeat", arv_gv_device_heartbeat_thread,
+								arv_gv_heartbeat_thread);
+		arv_gv_heartbeat_is_affinity_changed = arv_gv_heartbeat_cpu_affinity != NULL;
+	}
+
+	g_cond_broadcast (&arv_gv_heartbeat_cond);
+
+	g_mutex_unlock (&arv_gv_heartbeat_mutex);
+}
+
+/* Waits for a running heartbeat of the device, and stops the scheduler thread with the last device */
+
+static void
+_heartbeat_unregister (ArvGvDeviceHeartbeatData *heartbeat_data)
+{
+	ArvGvHeartbeatThread *thread = NULL;
+
+	g_mutex_lock (&arv_gv_heartbeat_mutex);
+
+	g_atomic_int_set (&heartbeat_data->is_cancelled, TRUE);
+
+	while (heartbeat_data->is_busy)
+		g_cond_wait (&arv_gv_heartbeat_cond, &arv_gv_heartbeat_mutex);
+
+	if (heartbeat_data->iter != NULL) {
+		g_sequence_remove (heartbeat_data->iter);
+		heartbeat_data->iter = NULL;
+	}
+
+	arv_gv_heartbeat_n_devices--;
+
+	if (arv_gv_heartbeat_n_devices == 0 && arv_gv_heartbeat_thread != NULL) {
+		thread = arv_gv_heartbeat_thread;
+		thread->cancel = TRUE;
+		arv_gv_heartbeat_thread = NULL;
+		g_cond_broadcast (&arv_gv_heartbeat_cond);
+	}
+
+	g_mutex_unlock (&arv_gv_heartbeat_mutex);
+
+	if (thread != NULL) {
+		g_thread_join (thread->thread);
+		g_free (thread);
+	}
+}
+
+/* Message channel. The event thread blocks on its socket, and emits the event signals as soon as a packet is decoded,
+ * without any dispatch through a main loop. */
+
+static void *
+_event_thread (void *data)
+{
+	ArvGvDevice *gv_device = data;
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvcpPacket *packet;
 	GPollFD poll_fd;
-	gboolean use_poll;
-	GTimer *timer;
-	guint32 value;
+	guint16 last_packet_id = 0;
+	gboolean has_last_packet_id = FALSE;
+
+	packet = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
+
+	poll_fd.fd = g_socket_get_fd (priv->event_socket);
+	poll_fd.events = G_IO_IN;
+	poll_fd.revents = 0;
+
+	arv_gpollfd_prepare_all (&poll_fd, 1);
+
+	while (!g_atomic_int_get (&priv->event_thread_cancel)) {
+		GSocketAddress *source_address = NULL;
+		ArvGvcpCommand command;
+		guint16 packet_id;
+		gssize count;
+		size_t offset = 0;
+		guint16 event_id;
+		guint64 timestamp;
+		const void *item;
+		size_t item_size;
+		const void *event_data;
+		size_t event_data_size;
+
+		if (g_poll (&poll_fd, 1, ARV_GV_DEVICE_EVENT_POLL_TIMEOUT_MS) <= 0)
+			continue;
+
+		arv_gpollfd_clear_one (&poll_fd, priv->event_socket);
+		count = g_socket_receive_from (priv->event_socket, &source_address, (char *) packet,
+					       ARV_GV_DEVICE_BUFFER_SIZE, NULL, NULL);
+
+		command = arv_gvcp_packet_get_command (packet);
+		if (count < (gssize) sizeof (ArvGvcpHeader) ||
+		    arv_gvcp_packet_get_packet_type (packet) != ARV_GVCP_PACKET_TYPE_CMD ||
+		    (command != ARV_GVCP_COMMAND_EVENT_CMD && command != ARV_GVCP_COMMAND_EVENT_DATA_CMD)) {
+			arv_debug_device ("[GvDevice::event_thread] Unexpected message channel packet");
+			g_clear_object (&source_address);
+			continue;
+		}
+
+		arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_TRACE);
+
+		packet_id = arv_gvcp_packet_get_packet_id (packet);
+
+		if ((arv_gvcp_packet_get_packet_flags (packet) & ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED) != 0) {
+			ArvGvcpPacket *ack_packet;
+			size_t ack_size;
+
+			ack_packet = arv_gvcp_packet_new_event_ack (command, packet_id, &ack_size);
+			g_socket_send_to (priv->event_socket, source_address, (const char *) ack_packet, ack_size,
+					  NULL, NULL);
+			arv_gvcp_packet_free (ack_packet);
+		}
+
+		g_clear_object (&source_address);
+
+		/* A retransmission of an already processed event, its acknowledge was lost */
+		if (has_last_packet_id && packet_id == last_packet_id)
+			continue;
+
+		last_packet_id = packet_id;
+		has_last_packet_id = TRUE;
+
+		while (arv_gvcp_packet_get_event_item (packet, count, &offset, &event_id, &timestamp,
+						       &item, &item_size, &event_data, &event_data_size)) {
+			arv_debug_device ("[GvDevice::event_thread] Event 0x%04x, timestamp %" G_GUINT64_FORMAT,
+					  event_id, timestamp);
+			arv_device_emit_event_signal (ARV_DEVICE (gv_device), event_id, timestamp,
+						      item, item_size, event_data, event_data_size);
+		}
+	}
+
+	arv_gpollfd_finish_all (&poll_fd, 1);
+
+	g_free (packet);
+
+	return NULL;
+}
+
+static gboolean
+arv_gv_device_start_event_channel (ArvDevice *device, GError **error)
+{
+	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	GSocketAddress *socket_address;
+	GInetSocketAddress *local_address;
+	GError *local_error = NULL;
+	guint32 ip;
+
+	if (priv->event_thread != NULL)
+		return TRUE;
+
+	if (!priv->is_event_supported) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Message channel not supported by the device");
+		return FALSE;
+	}
+
+	priv->event_socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, NULL);
+	socket_address = g_inet_socket_address_new (priv->interface_address, 0);
+	if (!g_socket_bind (priv->event_socket, socket_address, FALSE, &local_error)) {
+		g_propagate_prefixed_error (error, local_error, "Failed to bind the message channel socket: ");
+		g_object_unref (socket_address);
+		g_clear_object (&priv->event_socket);
+		return FALSE;
+	}
+	g_object_unref (socket_address);
+
+	local_address = G_INET_SOCKET_ADDRESS (g_socket_get_local_address (priv->event_socket, NULL));
+	ip = g_ntohl (*((guint32 *) g_inet_address_to_bytes (priv->interface_address)));
+
+	if (!arv_gv_device_write_register (device, ARV_GVBS_MESSAGE_CHANNEL_0_DESTINATION_ADDRESS_OFFSET, ip,
+					   &local_error) ||
+	    !arv_gv_device_write_register (device, ARV_GVBS_MESSAGE_CHANNEL_0_PORT_OFFSET,
+					   g_inet_socket_address_get_port (local_address), &local_error)) {
+		g_propagate_prefixed_error (error, local_error, "Failed to configure the message channel: ");
+		g_clear_object (&local_address);
+		g_clear_object (&priv->event_socket);
+		return FALSE;
+	}
+
+	arv_info_device ("[GvDevice::start_event_channel] Message channel on port %d",
+			 g_inet_socket_address_get_port (local_address));
+
+	g_clear_object (&local_address);
+
+	priv->event_thread_cancel = FALSE;
+	priv->event_thread = g_thread_new ("arv_gv_event", _event_thread, gv_device);
+
+	return TRUE;
+}
+
+static void
+arv_gv_device_stop_event_channel (ArvDevice *device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+
+	if (priv->event_thread == NULL)
+		return;
+
+	arv_gv_device_write_register (device, ARV_GVBS_MESSAGE_CHANNEL_0_PORT_OFFSET, 0, NULL);
+
+	g_atomic_int_set (&priv->event_thread_cancel, TRUE);
+	g_thread_join (priv->event_thread);
+	priv->event_thread = NULL;
+
+	g_clear_object (&priv->event_socket);
+}
+
+static gboolean
+_read_device_mac (ArvGvDevice *gv_device, guint64 *mac, GError **error)
+{
+	guint32 high, low;
+
+	if (!arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_DEVICE_MAC_ADDRESS_HIGH_OFFSET, &high,
+					  error) ||
+	    !arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_DEVICE_MAC_ADDRESS_LOW_OFFSET, &low,
+					  error))
+		return FALSE;
+
+	*mac = ((guint64) (high & 0xffff) << 32) | low;
+
+	return TRUE;
+}
+
+/* Reestablishes the control channel after a link or a device power cycle. The socket and the Genicam data are kept,
+ * only the device side state is restored: control privilege, message channel destination and stream channel
+ * registers. */
+
+static gboolean
+arv_gv_device_reconnect (ArvDevice *device, GError **error)
+{
+	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvDeviceIOData *io_data = priv->io_data;
+	GPtrArray *streams;
+	GError *local_error = NULL;
+	gint64 start_time_us;
+	guint64 mac;
+	guint i;
+
+	if (io_data == NULL || !ARV_IS_GC (priv->genicam)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED,
+			     "Device not initialized");
+		return FALSE;
+	}
 
-	timer = g_timer_new ();
+	start_time_us = g_get_monotonic_time ();
 
-	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd);
+	streams = arv_device_dup_streams (device);
+	for (i = 0; i < streams->len; i++)
+		if (ARV_IS_GV_STREAM (g_ptr_array_index (streams, i)))
+			arv_gv_stream_suspend (g_ptr_array_index (streams, i));
 
-	do {
-		if (use_poll)
-			g_poll (&poll_fd, 1, thread_data->period_us / 1000);
-		else
-			g_usleep (thread_data->period_us);
+	/* The acknowledges of the commands sent while the link was down are meaningless now, and the round trip time
+	 * of the previous link may not apply */
+	g_mutex_lock (&io_data->mutex);
+	_drain_stale_acks (io_data);
+	io_data->gvcp_srtt_us = 0;
+	io_data->gvcp_rttvar_us = 0;
+	g_mutex_unlock (&io_data->mutex);
 
-		if (io_data->is_controller) {
-			guint counter = 1;
+	if (!_read_device_mac (gv_device, &mac, &local_error)) {
+		g_propagate_prefixed_error (error, local_error, "[GvDevice::reconnect] ");
+		g_ptr_array_unref (streams);
+		return FALSE;
+	}
 
-			/* TODO: Instead of reading the control register, Pylon does write the heartbeat
-			 * timeout value, which is interresting, as doing this we could get an error
-			 * ack packet which will indicate we lost the control access. */
+	if (mac != priv->device_mac) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND,
+			     "Device identity changed (MAC %012" G_GINT64_MODIFIER "x instead of %012"
+			     G_GINT64_MODIFIER "x)", mac, priv->device_mac);
+		g_ptr_array_unref (streams);
+		return FALSE;
+	}
 
-			g_timer_start (timer);
+	/* The device may have been power cycled */
+	arv_gc_invalidate_register_caches (priv->genicam);
 
-			while (!_read_register (io_data, ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET, &value, NULL) &&
-			       g_timer_elapsed (timer, NULL) < ARV_GV_DEVICE_HEARTBEAT_RETRY_TIMEOUT_S &&
-			       !g_cancellable_is_cancelled (thread_data->cancellable)) {
-				g_usleep (ARV_GV_DEVICE_HEARTBEAT_RETRY_DELAY_US);
-				counter++;
-			}
+	if (!priv->is_monitor && !arv_gv_device_take_control (gv_device, &local_error)) {
+		g_propagate_prefixed_error (error, local_error, "[GvDevice::reconnect] ");
+		g_ptr_array_unref (streams);
+		return FALSE;
+	}
 
-			if (!g_cancellable_is_cancelled (thread_data->cancellable)) {
-				arv_debug_device ("[GvDevice::Heartbeat] Ack value = %d", value);
+	if (priv->event_thread != NULL) {
+		GInetSocketAddress *local_address;
+		guint32 ip;
+
+		local_address = G_INET_SOCKET_ADDRESS (g_socket_get_local_address (priv->event_socket, NULL));
+		ip = g_ntohl (*((guint32 *) g_inet_address_to_bytes (priv->interface_address)));
+
+		if (!arv_gv_device_write_register (device, ARV_GVBS_MESSAGE_CHANNEL_0_DESTINATION_ADDRESS_OFFSET, ip,
+						   &local_error) ||
+		    !arv_gv_device_write_register (device, ARV_GVBS_MESSAGE_CHANNEL_0_PORT_OFFSET,
+						   g_inet_socket_address_get_port (local_address), &local_error))
+			arv_warning_device ("[GvDevice::reconnect] Failed to restore the message channel: %s",
+					    local_error->message);
+		g_clear_error (&local_error);
+		g_clear_object (&local_address);
+	}
 
-				if (counter > 1)
-					arv_debug_device ("[GvDevice::Heartbeat] Tried %u times", counter);
+	g_mutex_lock (&priv->stream_channel_mutex);
+	for (i = 0; i < streams->len && local_error == NULL; i++) {
+		ArvStream *stream = g_ptr_array_index (streams, i);
+		guint channel;
 
-				if ((value & (ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL |
-					      ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_EXCLUSIVE)) == 0) {
-					arv_warning_device ("[GvDevice::Heartbeat] Control access lost");
+		if (!ARV_IS_GV_STREAM (stream))
+			continue;
 
-					arv_device_emit_control_lost_signal (ARV_DEVICE (thread_data->gv_device));
+		g_object_get (stream, "channel", &channel, NULL);
+		if (arv_gv_device_select_stream_channel (gv_device, channel, &local_error))
+			arv_gv_stream_resume (ARV_GV_STREAM (stream), &local_error);
+	}
+	g_mutex_unlock (&priv->stream_channel_mutex);
 
-					io_data->is_controller = FALSE;
-				}
-			} else
-				io_data->is_controller = FALSE;
-		}
-	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+	g_ptr_array_unref (streams);
 
-	if (use_poll)
-		g_cancellable_release_fd (thread_data->cancellable);
+	if (local_error != NULL) {
+		g_propagate_prefixed_error (error, local_error, "[GvDevice::reconnect] ");
+		return FALSE;
+	}
 
-	g_timer_destroy (timer);
+	arv_info_device ("[GvDevice::reconnect] Reconnected in %" G_GINT64_FORMAT " µs",
+			 g_get_monotonic_time () - start_time_us);
 
-	return NULL;
+	return TRUE;
 }
 
 /* ArvGvDevice implemenation */
@@ -496,6 +1598,12 @@ arv_gv_device_take_control (ArvGvDevice *gv_device, GError **error)
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
 	gboolean success = TRUE;
 
+	if (priv->is_monitor) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONTROLLER,
+			     "Control can't be taken in monitor mode");
+		return FALSE;
+	}
+
 	success = arv_gv_device_write_register (ARV_DEVICE (gv_device),
 					     ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET,
 					     ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL,
@@ -634,7 +1742,7 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 	guint16 port;
 	gboolean do_not_fragment;
 	gboolean is_command;
-	guint max_size, min_size;
+	guint max_size, min_size, lowest_size;
 	gint64 minimum, maximum, packet_size;
 	guint inc;
 	char *buffer;
@@ -656,6 +1764,7 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 	arv_device_get_integer_feature_bounds (device, "GevSCPSPacketSize", &minimum, &maximum, NULL);
 	max_size = MIN (ARV_GVSP_MAXIMUM_PACKET_SIZE, maximum);
 	min_size = MAX (ARV_GVSP_MINIMUM_PACKET_SIZE, minimum);
+	lowest_size = min_size;
 
 	if (max_size < min_size ||
 	    inc > max_size - min_size) {
@@ -701,9 +1810,55 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 	} else {
                 GError *local_error = NULL;
 		guint current_size = packet_size;
+		guint candidate_size;
+		gboolean is_candidate_valid = FALSE;
+		guint32 mac_high = 0, mac_low = 0;
+		char *interface_string;
+		char *mac_string;
+		guint mtu;
+
+		/* Fast path: try the packet size negotiated during a previous session over the same link, or the
+		 * path MTU, before falling back to the full search, bounded by the failing candidate. */
+
+		mtu = arv_network_get_path_mtu (interface_address, priv->device_address);
+
+		_read_register (priv->io_data, ARV_GVBS_DEVICE_MAC_ADDRESS_HIGH_OFFSET, &mac_high, NULL);
+		_read_register (priv->io_data, ARV_GVBS_DEVICE_MAC_ADDRESS_LOW_OFFSET, &mac_low, NULL);
+		mac_string = g_strdup_printf ("%02x:%02x:%02x:%02x:%02x:%02x",
+					      (mac_high >> 8) & 0xff, mac_high & 0xff,
+					      (mac_low >> 24) & 0xff, (mac_low >> 16) & 0xff,
+					      (mac_low >> 8) & 0xff, mac_low & 0xff);
+		interface_string = g_inet_address_to_string (interface_address);
+
+		candidate_size = arv_genicam_cache_load_packet_size (mac_string, interface_string, mtu);
+		if (candidate_size == 0)
+			candidate_size = mtu;
+
+		if (candidate_size > 0) {
+			candidate_size = CLAMP (candidate_size, min_size, max_size);
+			candidate_size = min_size + ((candidate_size - min_size) / inc) * inc;
+
+			arv_info_device ("[GvDevice::auto_packet_size] Try packet size = %d (MTU %u)",
+					 candidate_size, mtu);
+			arv_device_set_integer_feature_value (device, "GevSCPSPacketSize", candidate_size, NULL);
+			current_size = arv_device_get_integer_feature_value (device, "GevSCPSPacketSize",
+									     &local_error);
+			last_size = current_size;
+
+			if (local_error == NULL &&
+			    test_packet_check (device, &poll_fd, socket, buffer, max_size, current_size, is_command)) {
+				packet_size = current_size;
+				is_candidate_valid = TRUE;
+			} else if (local_error == NULL) {
+				max_size = current_size;
+				current_size = min_size + (((max_size - min_size) / 2 + 1) / inc) * inc;
+			}
+		}
 
 		do {
-			if (current_size == last_size ||
+			if (local_error != NULL ||
+			    is_candidate_valid ||
+			    current_size == last_size ||
                             min_size + inc >= max_size)
 				break;
 
@@ -731,13 +1886,28 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 		} while (TRUE);
 
                 if (local_error == NULL) {
+			if (priv->packet_size_alignment > 1) {
+				guint overhead;
+
+				overhead = arv_device_get_boolean_feature_value (device, "GevGVSPExtendedIDMode", NULL) ?
+					ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+					ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+				packet_size = arv_gvsp_align_packet_size (packet_size, lowest_size, inc, overhead,
+									  priv->packet_size_alignment);
+			}
+
                         arv_device_set_integer_feature_value (device, "GevSCPSPacketSize", packet_size, error);
 
                         arv_info_device ("[GvDevice::auto_packet_size] Packet size set to %" G_GINT64_FORMAT " bytes",
                                          packet_size);
+
+			arv_genicam_cache_store_packet_size (mac_string, interface_string, mtu, packet_size);
                 } else {
                         g_propagate_error (error, local_error);
                 }
+
+		g_free (mac_string);
+		g_free (interface_string);
         }
 
 	g_clear_pointer (&buffer, g_free);
@@ -758,6 +1928,13 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
  * Automatically determine the biggest packet size that can be used data streaming, and set GevSCPSPacketSize value
  * accordingly. This function relies on the GevSCPSFireTestPacket feature.
  *
+ * The packet size found during a previous session for the same device, host interface and path MTU is tried
+ * first, then the path MTU itself. A full search is only run if this first check fails. The negotiated packet
+ * sizes are stored in the Genicam cache directory.
+ *
+ * If an alignment was set using arv_gv_device_set_packet_size_alignment(), the largest working size is reduced to
+ * the closest size whose payload is aligned.
+ *
  * Returns: The automatic packet size, in bytes, or the current one if GevSCPSFireTestPacket is not supported.
  *
  * Since: 0.6.0
@@ -793,6 +1970,29 @@ arv_gv_device_set_packet_size_adjustment (ArvGvDevice *gv_device, ArvGvPacketSiz
 	priv->packet_size_adjustment = adjustment;
 }
 
+/**
+ * arv_gv_device_set_packet_size_alignment:
+ * @gv_device: a #ArvGvDevice
+ * @alignment: payload alignment, in bytes, 0 for none
+ *
+ * Makes the automatic packet size adjustment prefer the packet sizes whose payload is a multiple of @alignment, at
+ * the cost of a few bytes per packet. The data blocks are then stored at aligned offsets of the buffers, which
+ * speeds up their copy when they are not received in place. A typical value is 64, the cache line size. The default
+ * is 0, which selects the largest working packet size.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gv_device_set_packet_size_alignment (ArvGvDevice *gv_device, guint alignment)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+
+	priv->packet_size_alignment = alignment;
+}
+
 /**
  * arv_gv_device_get_current_ip:
  * @gv_device: a #ArvGvDevice
@@ -1096,80 +2296,528 @@ arv_gv_device_get_ip_configuration_mode (ArvGvDevice *gv_device, GError **error)
 }
 
 
-/**
- * arv_gv_device_set_ip_configuration_mode:
- * @gv_device: a #ArvGvDevice
- * @mode: IP address configuration mode
- * @error: a #GError placeholder, %NULL to ignore
- *
- * Sets the IP address configuration mode.
- * Available modes are ARV_GV_IP_CONFIGURATION_MODE_DHCP, ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP,
- * ARV_GV_IP_CONFIGURATION_MODE_LLA
- *
- * Since: 0.8.22
- */
+/**
+ * arv_gv_device_set_ip_configuration_mode:
+ * @gv_device: a #ArvGvDevice
+ * @mode: IP address configuration mode
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sets the IP address configuration mode.
+ * Available modes are ARV_GV_IP_CONFIGURATION_MODE_DHCP, ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP,
+ * ARV_GV_IP_CONFIGURATION_MODE_LLA
+ *
+ * Since: 0.8.22
+ */
+
+void
+arv_gv_device_set_ip_configuration_mode (ArvGvDevice *gv_device, ArvGvIpConfigurationMode mode, GError **error)
+{
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+        g_return_if_fail ((mode == ARV_GV_IP_CONFIGURATION_MODE_DHCP) ||
+                          (mode == ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP) ||
+                          (mode == ARV_GV_IP_CONFIGURATION_MODE_LLA));
+
+	if (mode == ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP) {
+		/* Persistent IP: disable DHCP, enable persistent IP */
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationDHCP", FALSE, NULL);
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationPersistentIP", TRUE, NULL);
+	} else if (mode == ARV_GV_IP_CONFIGURATION_MODE_DHCP) {
+		/* DHCP: enable DHCP, disable persistent IP */
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationDHCP", TRUE, NULL);
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationPersistentIP", FALSE, NULL);
+	} else {
+		/* LLA: disable both */
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationDHCP", FALSE, NULL);
+		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
+                                                      "GevCurrentIPConfigurationPersistentIP", FALSE, NULL);
+	}
+}
+
+/* Device to host clock mapping, fed by the heartbeat thread. Only controllers can latch the device timestamp. */
+
+ArvClockModel *
+arv_gv_device_get_clock_model (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), NULL);
+
+	return priv->clock_model;
+}
+
+/**
+ * arv_gv_device_is_controller:
+ * @gv_device: a #ArvGvDevice
+ *
+ * Returns: value indicating whether the ArvGvDevice has control access to the camera
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_gv_device_is_controller (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), 0);
+
+	return priv->io_data->is_controller;
+}
+
+/* Action commands are not bound to a device, a single packet triggers all the devices matching the keys */
+
+static gint arv_gv_action_packet_id = 0;
+
+static gboolean
+_issue_action_command (guint32 device_key, guint32 group_key, guint32 group_mask,
+		       gboolean scheduled, guint64 timestamp_ns,
+		       GInetAddress *broadcast_address,
+		       GInetAddress ***inet_addresses, guint *n_acknowledges,
+		       GError **error)
+{
+	GSocket *socket;
+	GSocketAddress *destination;
+	ArvGvcpPacket *packet;
+	GPtrArray *acknowledges = NULL;
+	size_t packet_size;
+	guint16 packet_id;
+	gboolean ack_required;
+	gboolean success = TRUE;
+
+	g_return_val_if_fail (G_IS_INET_ADDRESS (broadcast_address), FALSE);
+
+	ack_required = inet_addresses != NULL || n_acknowledges != NULL;
+
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, error);
+	if (socket == NULL)
+		return FALSE;
+
+	g_socket_set_broadcast (socket, TRUE);
+
+	packet_id = arv_gvcp_next_packet_id ((guint16) g_atomic_int_add (&arv_gv_action_packet_id, 1));
+	packet = arv_gvcp_packet_new_action_cmd (device_key, group_key, group_mask, scheduled, timestamp_ns,
+						 ack_required, packet_id, &packet_size);
+
+	arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+
+	destination = g_inet_socket_address_new (broadcast_address, ARV_GVCP_PORT);
+	success = g_socket_send_to (socket, destination, (const char *) packet, packet_size, NULL, error) >= 0;
+
+	arv_gvcp_packet_free (packet);
+	g_object_unref (destination);
+
+	if (success && ack_required) {
+		ArvGvcpPacket *ack_packet;
+		GPollFD poll_fd;
+		gint64 timeout_stop_ms;
+		gint timeout_ms;
+
+		ack_packet = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
+		acknowledges = g_ptr_array_new ();
+
+		poll_fd.fd = g_socket_get_fd (socket);
+		poll_fd.events = G_IO_IN;
+		poll_fd.revents = 0;
+
+		arv_gpollfd_prepare_all (&poll_fd, 1);
+
+		/* The acknowledges of all the matching devices are collected until the timeout */
+		timeout_stop_ms = g_get_monotonic_time () / 1000 + ARV_GV_DEVICE_GVCP_TIMEOUT_MS_DEFAULT;
+		while ((timeout_ms = timeout_stop_ms - g_get_monotonic_time () / 1000) > 0 &&
+		       g_poll (&poll_fd, 1, timeout_ms) > 0) {
+			GSocketAddress *source_address = NULL;
+			ArvGvcpPacketType packet_type;
+			gssize count;
+
+			arv_gpollfd_clear_one (&poll_fd, socket);
+			count = g_socket_receive_from (socket, &source_address, (char *) ack_packet,
+						       ARV_GV_DEVICE_BUFFER_SIZE, NULL, NULL);
+
+			packet_type = arv_gvcp_packet_get_packet_type (ack_packet);
+			if (count >= (gssize) sizeof (ArvGvcpHeader) &&
+			    arv_gvcp_packet_get_command (ack_packet) == ARV_GVCP_COMMAND_ACTION_ACK &&
+			    arv_gvcp_packet_get_packet_id (ack_packet) == packet_id &&
+			    G_IS_INET_SOCKET_ADDRESS (source_address)) {
+				GInetAddress *address;
+
+				address = g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (source_address));
+
+				if (packet_type == ARV_GVCP_PACKET_TYPE_ACK) {
+					g_ptr_array_add (acknowledges, g_object_ref (address));
+				} else {
+					char *address_string = g_inet_address_to_string (address);
+
+					arv_warning_device ("[GvDevice::issue_action_command] Error from %s (%s)",
+							    address_string,
+							    arv_gvcp_error_to_string
+							    (arv_gvcp_packet_get_packet_flags (ack_packet)));
+					g_free (address_string);
+				}
+			}
+
+			g_clear_object (&source_address);
+		}
+
+		arv_gpollfd_finish_all (&poll_fd, 1);
+		g_free (ack_packet);
+	}
+
+	g_object_unref (socket);
+
+	if (n_acknowledges != NULL)
+		*n_acknowledges = acknowledges != NULL ? acknowledges->len : 0;
+
+	if (inet_addresses != NULL) {
+		if (acknowledges != NULL) {
+			g_ptr_array_add (acknowledges, NULL);
+			*inet_addresses = (GInetAddress **) g_ptr_array_free (acknowledges, FALSE);
+		} else
+			*inet_addresses = NULL;
+	} else if (acknowledges != NULL) {
+		g_ptr_array_foreach (acknowledges, (GFunc) g_object_unref, NULL);
+		g_ptr_array_free (acknowledges, TRUE);
+	}
+
+	return success;
+}
+
+/**
+ * arv_gv_device_issue_action_command:
+ * @device_key: the device key, matched against the ActionDeviceKey feature of the devices
+ * @group_key: the group key, matched against the ActionGroupKey feature
+ * @group_mask: the group mask, ANDed with the ActionGroupMask feature
+ * @broadcast_address: the destination, either a subnet broadcast address or a device address
+ * @inet_addresses: (out) (optional) (array zero-terminated=1) (transfer full): the addresses of the devices which have
+ * acknowledged the action
+ * @n_acknowledges: (out) (optional): the number of acknowledges
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sends an action command, which fires the action on all the devices with matching keys at the packet arrival. A
+ * single broadcast packet triggers all the cameras of a subnet with a much lower skew than individual software
+ * triggers. The acknowledges are requested only if @inet_addresses or @n_acknowledges is not %NULL, in which case
+ * the function waits for the GVCP timeout.
+ *
+ * Returns: %TRUE if the command was sent.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gv_device_issue_action_command (guint32 device_key, guint32 group_key, guint32 group_mask,
+				    GInetAddress *broadcast_address,
+				    GInetAddress ***inet_addresses, guint *n_acknowledges,
+				    GError **error)
+{
+	return _issue_action_command (device_key, group_key, group_mask, FALSE, 0, broadcast_address,
+				      inet_addresses, n_acknowledges, error);
+}
+
+/**
+ * arv_gv_device_issue_scheduled_action_command:
+ * @device_key: the device key, matched against the ActionDeviceKey feature of the devices
+ * @group_key: the group key, matched against the ActionGroupKey feature
+ * @group_mask: the group mask, ANDed with the ActionGroupMask feature
+ * @timestamp_ns: the action time, in the device timestamp domain, which is PTP time in ns for synchronized devices
+ * @broadcast_address: the destination, either a subnet broadcast address or a device address
+ * @inet_addresses: (out) (optional) (array zero-terminated=1) (transfer full): the addresses of the devices which have
+ * acknowledged the action
+ * @n_acknowledges: (out) (optional): the number of acknowledges
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Same as arv_gv_device_issue_action_command(), but the action is fired by each device when its clock reaches
+ * @timestamp_ns, which makes the trigger independent of the network latency.
+ *
+ * Returns: %TRUE if the command was sent.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_gv_device_issue_scheduled_action_command (guint32 device_key, guint32 group_key, guint32 group_mask,
+					      guint64 timestamp_ns, GInetAddress *broadcast_address,
+					      GInetAddress ***inet_addresses, guint *n_acknowledges,
+					      GError **error)
+{
+	return _issue_action_command (device_key, group_key, group_mask, TRUE, timestamp_ns, broadcast_address,
+				      inet_addresses, n_acknowledges, error);
+}
+
+/* The manufacturer name, model name and device version strings are contiguous in the bootstrap registers, and are
+ * read in one go. */
+
+static char *
+_get_genicam_cache_key (ArvGvDevice *gv_device, const char *url)
+{
+	char strings[ARV_GVBS_MANUFACTURER_NAME_SIZE + ARV_GVBS_MODEL_NAME_SIZE + ARV_GVBS_DEVICE_VERSION_SIZE];
+	char *vendor;
+	char *model;
+	char *version;
+	char *key;
+
+	G_STATIC_ASSERT (ARV_GVBS_MODEL_NAME_OFFSET ==
+			 ARV_GVBS_MANUFACTURER_NAME_OFFSET + ARV_GVBS_MANUFACTURER_NAME_SIZE);
+	G_STATIC_ASSERT (ARV_GVBS_DEVICE_VERSION_OFFSET == ARV_GVBS_MODEL_NAME_OFFSET + ARV_GVBS_MODEL_NAME_SIZE);
+
+	if (!arv_gv_device_read_memory (ARV_DEVICE (gv_device), ARV_GVBS_MANUFACTURER_NAME_OFFSET,
+					sizeof (strings), strings, NULL))
+		return NULL;
+
+	vendor = g_strndup (strings, ARV_GVBS_MANUFACTURER_NAME_SIZE);
+	model = g_strndup (strings + ARV_GVBS_MANUFACTURER_NAME_SIZE, ARV_GVBS_MODEL_NAME_SIZE);
+	version = g_strndup (strings + ARV_GVBS_MANUFACTURER_NAME_SIZE + ARV_GVBS_MODEL_NAME_SIZE,
+			     ARV_GVBS_DEVICE_VERSION_SIZE);
+
+	key = arv_genicam_cache_get_key (vendor, model, version, url);
+
+	g_free (vendor);
+	g_free (model);
+	g_free (version);
+
+	return key;
+}
+
+/* The Genicam data pointed to by an http URL are downloaded in a separate thread, started before the bootstrap
+ * register reads of the device construction. A cached copy is used without network access until its expiration, then
+ * revalidated using a conditional request. The cached copy is also used when the web server can't be reached. */
+
+struct _ArvGvDeviceGenicamFetch {
+	char *url;
+	char *cache_key;
+	char *cached_xml;
+	size_t cached_size;
+	char *etag;
+	char *last_modified;
+
+	GThread *thread;
+	ArvHttpResponse response;
+	GError *error;
+};
+
+static void *
+_genicam_fetch_thread (void *data)
+{
+	ArvGvDeviceGenicamFetch *fetch = data;
+
+	arv_http_get (fetch->url, fetch->etag, fetch->last_modified, ARV_GV_DEVICE_GENICAM_HTTP_TIMEOUT_MS, NULL,
+		      &fetch->response, &fetch->error);
+
+	return NULL;
+}
+
+static ArvGvDeviceGenicamFetch *
+_genicam_fetch_start (ArvGvDevice *gv_device, const char *url)
+{
+	ArvGvDeviceGenicamFetch *fetch;
+	gint64 expiration_s = 0;
+
+	fetch = g_new0 (ArvGvDeviceGenicamFetch, 1);
+	fetch->url = g_strdup (url);
+	fetch->cache_key = _get_genicam_cache_key (gv_device, url);
+
+	if (fetch->cache_key != NULL) {
+		fetch->cached_xml = arv_genicam_cache_load (fetch->cache_key, &fetch->cached_size);
+		if (fetch->cached_xml != NULL)
+			arv_genicam_cache_load_http_validators (fetch->cache_key, &fetch->etag, &fetch->last_modified,
+								&expiration_s);
+	}
+
+	if (fetch->cached_xml != NULL && expiration_s > g_get_real_time () / 1000000) {
+		arv_info_device ("[GvDevice::genicam_fetch_start] Fresh cached copy of %s", url);
+		return fetch;
+	}
+
+	arv_info_device ("[GvDevice::genicam_fetch_start] Download %s%s", url,
+			 fetch->cached_xml != NULL ? " (revalidation)" : "");
+
+	fetch->thread = g_thread_new ("arv_genicam_fetch", _genicam_fetch_thread, fetch);
+
+	return fetch;
+}
+
+static void
+_genicam_fetch_free (ArvGvDeviceGenicamFetch *fetch)
+{
+	if (fetch == NULL)
+		return;
+
+	if (fetch->thread != NULL)
+		g_thread_join (fetch->thread);
+
+	arv_http_response_clear (&fetch->response);
+	g_clear_error (&fetch->error);
+	g_free (fetch->url);
+	g_free (fetch->cache_key);
+	g_free (fetch->cached_xml);
+	g_free (fetch->etag);
+	g_free (fetch->last_modified);
+	g_free (fetch);
+}
+
+/* Returns the xml data, and the cache key when they come from the cache */
+
+static char *
+_genicam_fetch_finish (ArvGvDeviceGenicamFetch *fetch, const char *path, size_t *size, char **cache_key)
+{
+	ArvHttpResponse *response = &fetch->response;
+	char *genicam = NULL;
+	gint64 max_age_s;
+
+	*size = 0;
+	*cache_key = NULL;
+
+	if (fetch->thread != NULL) {
+		g_thread_join (fetch->thread);
+		fetch->thread = NULL;
+	} else {
+		*size = fetch->cached_size;
+		*cache_key = g_strdup (fetch->cache_key);
+		return g_steal_pointer (&fetch->cached_xml);
+	}
+
+	max_age_s = response->max_age_s >= 0 ? response->max_age_s : ARV_GV_DEVICE_GENICAM_HTTP_FRESHNESS_S;
+
+	if (fetch->error == NULL && response->status == ARV_HTTP_STATUS_OK && response->body != NULL) {
+		gconstpointer data;
+		gsize data_size;
+
+		data = g_bytes_get_data (response->body, &data_size);
+
+		if (g_str_has_suffix (path, ".zip")) {
+			ArvZip *zip;
+			const GSList *zip_files;
+
+			arv_info_device ("[GvDevice::genicam_fetch_finish] Zipped xml data");
+
+			zip = arv_zip_new (data, data_size);
+			zip_files = arv_zip_get_file_list (zip);
+			if (zip_files != NULL)
+				genicam = arv_zip_get_file (zip, arv_zip_file_get_name (zip_files->data), size);
+			else
+				arv_warning_device ("[GvDevice::genicam_fetch_finish] Invalid format");
+			arv_zip_free (zip);
+		} else {
+			genicam = g_malloc (data_size + 1);
+			memcpy (genicam, data, data_size);
+			genicam[data_size] = '\0';
+			*size = data_size;
+		}
+
+		if (genicam != NULL && fetch->cache_key != NULL) {
+			arv_genicam_cache_store (fetch->cache_key, genicam, *size);
+			arv_genicam_cache_store_http_validators (fetch->cache_key, response->etag,
+								 response->last_modified,
+								 g_get_real_time () / 1000000 + max_age_s);
+		}
+
+		return genicam;
+	}
+
+	if (fetch->error == NULL && response->status == ARV_HTTP_STATUS_NOT_MODIFIED && fetch->cached_xml != NULL) {
+		arv_info_device ("[GvDevice::genicam_fetch_finish] Cached copy of %s not modified", fetch->url);
+
+		arv_genicam_cache_store_http_validators (fetch->cache_key,
+							 response->etag != NULL ? response->etag : fetch->etag,
+							 response->last_modified != NULL ?
+							 response->last_modified : fetch->last_modified,
+							 g_get_real_time () / 1000000 + max_age_s);
+	} else if (fetch->error != NULL)
+		arv_warning_device ("[GvDevice::genicam_fetch_finish] Download of %s failed: %s",
+				    fetch->url, fetch->error->message);
+	else
+		arv_warning_device ("[GvDevice::genicam_fetch_finish] Download of %s failed: HTTP status %u",
+				    fetch->url, response->status);
+
+	if (fetch->cached_xml != NULL) {
+		*size = fetch->cached_size;
+		*cache_key = g_strdup (fetch->cache_key);
+		return g_steal_pointer (&fetch->cached_xml);
+	}
+
+	return NULL;
+}
+
+static gboolean
+_is_http_scheme (const char *scheme)
+{
+	return scheme != NULL && (g_ascii_strcasecmp (scheme, "http") == 0 || g_ascii_strcasecmp (scheme, "https") == 0);
+}
+
+/* Starts the download of the Genicam data if the first URL points to a web server */
+
+static void
+_start_genicam_fetch (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	char filename[ARV_GVBS_XML_URL_SIZE];
+	char *scheme = NULL;
+
+	if (!arv_gv_device_read_memory (ARV_DEVICE (gv_device), ARV_GVBS_XML_URL_0_OFFSET, ARV_GVBS_XML_URL_SIZE,
+					filename, NULL))
+		return;
+
+	filename[ARV_GVBS_XML_URL_SIZE - 1] = '\0';
+
+	arv_parse_genicam_url (filename, -1, &scheme, NULL, NULL, NULL, NULL, NULL, NULL);
+	if (_is_http_scheme (scheme))
+		priv->genicam_fetch = _genicam_fetch_start (gv_device, filename);
+
+	g_free (scheme);
+}
+
+/* The xml data is inflated and parsed while it is downloaded, hiding the parsing time behind the network latency */
+
+typedef struct {
+	ArvZipStream *zip_stream;
+	GByteArray *xml;
+	ArvDomPushParser *parser;
+} ArvGvDeviceGenicamLoader;
 
-void
-arv_gv_device_set_ip_configuration_mode (ArvGvDevice *gv_device, ArvGvIpConfigurationMode mode, GError **error)
+static void
+_genicam_loader_xml_cb (const void *data, size_t size, void *user_data)
 {
-	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
-        g_return_if_fail ((mode == ARV_GV_IP_CONFIGURATION_MODE_DHCP) ||
-                          (mode == ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP) ||
-                          (mode == ARV_GV_IP_CONFIGURATION_MODE_LLA));
+	ArvGvDeviceGenicamLoader *loader = user_data;
 
-	if (mode == ARV_GV_IP_CONFIGURATION_MODE_PERSISTENT_IP) {
-		/* Persistent IP: disable DHCP, enable persistent IP */
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationDHCP", FALSE, NULL);
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationPersistentIP", TRUE, NULL);
-	} else if (mode == ARV_GV_IP_CONFIGURATION_MODE_DHCP) {
-		/* DHCP: enable DHCP, disable persistent IP */
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationDHCP", TRUE, NULL);
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationPersistentIP", FALSE, NULL);
-	} else {
-		/* LLA: disable both */
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationDHCP", FALSE, NULL);
-		arv_device_set_boolean_feature_value (ARV_DEVICE (gv_device),
-                                                      "GevCurrentIPConfigurationPersistentIP", FALSE, NULL);
-	}
+	if (loader->xml != NULL)
+		g_byte_array_append (loader->xml, data, size);
+	if (loader->parser != NULL)
+		arv_dom_push_parser_feed (loader->parser, data, size);
 }
 
-/**
- * arv_gv_device_is_controller:
- * @gv_device: a #ArvGvDevice
- *
- * Returns: value indicating whether the ArvGvDevice has control access to the camera
- *
- * Since: 0.8.0
- */
-
-gboolean
-arv_gv_device_is_controller (ArvGvDevice *gv_device)
+static void
+_genicam_loader_progress_cb (const void *data, guint32 size, void *user_data)
 {
-	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
-
-	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), 0);
+	ArvGvDeviceGenicamLoader *loader = user_data;
 
-	return priv->io_data->is_controller;
+	if (loader->zip_stream != NULL)
+		arv_zip_stream_feed (loader->zip_stream, data, size);
+	else
+		_genicam_loader_xml_cb (data, size, loader);
 }
 
 static char *
-_load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **error)
+_load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size,
+	       ArvDomDocument **document, GBytes **compiled, GError **error)
 {
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
 	char filename[ARV_GVBS_XML_URL_SIZE];
 	char *genicam = NULL;
 	char *scheme = NULL;
 	char *path = NULL;
+	char *cache_key = NULL;
 	guint64 file_address;
 	guint64 file_size;
 
 	g_return_val_if_fail (size != NULL, NULL);
+	g_return_val_if_fail (document != NULL && compiled != NULL, NULL);
 
 	*size = 0;
+	*document = NULL;
+	*compiled = NULL;
 
 	if (!arv_gv_device_read_memory (ARV_DEVICE (gv_device), address, ARV_GVBS_XML_URL_SIZE, filename, error))
 		return NULL;
@@ -1191,10 +2839,41 @@ _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **
 		arv_info_device ("[GvDevice::load_genicam] Xml address = 0x%" G_GINT64_MODIFIER "x - "
 				  "size = 0x%" G_GINT64_MODIFIER "x - %s", file_address, file_size, path);
 
+		cache_key = _get_genicam_cache_key (gv_device, filename);
+		if (cache_key != NULL) {
+			size_t cached_size;
+
+			genicam = arv_genicam_cache_load (cache_key, &cached_size);
+			if (genicam != NULL) {
+				arv_info_device ("[GvDevice::load_genicam] Use cached xml data");
+				*size = cached_size;
+				file_size = 0;
+
+				g_free (priv->genicam_cache_key);
+				priv->genicam_cache_key = g_strdup (cache_key);
+			}
+		}
+
 		if (file_size > 0) {
+			ArvGvDeviceGenicamLoader loader = {0};
+			gboolean is_zip = g_str_has_suffix (path, ".zip");
+			gboolean is_streamed = FALSE;
+			gboolean is_xml = TRUE;
+			char *streamed_filename = NULL;
+
+			/* Lazy loading instantiates the document from its compiled form */
+			if (!arv_get_genicam_lazy_loading ())
+				loader.parser = arv_dom_push_parser_new (TRUE);
+			if (is_zip) {
+				loader.xml = g_byte_array_new ();
+				loader.zip_stream = arv_zip_stream_new (_genicam_loader_xml_cb, &loader);
+			}
+
 			genicam = g_malloc (file_size);
-			if (arv_gv_device_read_memory (ARV_DEVICE (gv_device), file_address, file_size,
-						    genicam, NULL)) {
+			if (_read_memory_blocks (priv->io_data, file_address, file_size, genicam,
+						 priv->io_data->gvcp_window_size,
+						 _genicam_loader_progress_cb, &loader,
+						 NULL)) {
 
 				if (arv_debug_check (ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_DEBUG)) {
 					GString *string = g_string_new ("");
@@ -1209,64 +2888,106 @@ _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **
 					g_string_free (string, TRUE);
 				}
 
-				if (g_str_has_suffix (path, ".zip")) {
+				if (is_zip) {
 					ArvZip *zip;
 					const GSList *zip_files;
 
 					arv_info_device ("[GvDevice::load_genicam] Zipped xml data");
 
+					is_streamed = arv_zip_stream_finish (g_steal_pointer (&loader.zip_stream),
+									     &streamed_filename);
+
 					zip = arv_zip_new (genicam, file_size);
 					zip_files = arv_zip_get_file_list (zip);
 
 					if (zip_files != NULL) {
 						const char *zip_filename;
-						void *tmp_buffer;
-						size_t tmp_buffer_size;
 
 						zip_filename = arv_zip_file_get_name (zip_files->data);
-						tmp_buffer = arv_zip_get_file (zip, zip_filename,
-									       &tmp_buffer_size);
 
-						g_free (genicam);
-						file_size = tmp_buffer_size;
-						genicam = tmp_buffer;
-					} else
+						/* The streamed file must be the one given by the central directory */
+						is_streamed = is_streamed &&
+							g_strcmp0 (streamed_filename, zip_filename) == 0 &&
+							arv_zip_file_get_uncompressed_size (zip_files->data) ==
+							loader.xml->len;
+
+						if (is_streamed) {
+							arv_info_device ("[GvDevice::load_genicam] Xml data inflated "
+									 "during download");
+							g_free (genicam);
+							file_size = loader.xml->len;
+							genicam = (char *) g_byte_array_free (g_steal_pointer (&loader.xml),
+											      FALSE);
+						} else {
+							void *tmp_buffer;
+							size_t tmp_buffer_size;
+
+							tmp_buffer = arv_zip_get_file (zip, zip_filename,
+										       &tmp_buffer_size);
+
+							g_free (genicam);
+							file_size = tmp_buffer_size;
+							genicam = tmp_buffer;
+							is_xml = genicam != NULL;
+						}
+					} else {
 						arv_warning_device ("[GvDevice::load_genicam] Invalid format");
+						is_streamed = FALSE;
+						is_xml = FALSE;
+					}
 					arv_zip_free (zip);
-				}
+				} else
+					is_streamed = TRUE;
 				*size = file_size;
+
+				if (is_streamed && loader.parser != NULL) {
+					*document = arv_dom_push_parser_finish (g_steal_pointer (&loader.parser),
+										compiled, NULL);
+					if (*document != NULL)
+						arv_info_device ("[GvDevice::load_genicam] Xml data parsed "
+								 "during download");
+				}
+
+				/* Only the xml data is cached, not the data of a failed decompression */
+				if (cache_key != NULL && is_xml)
+					arv_genicam_cache_store (cache_key, genicam, file_size);
 			} else {
 				g_free (genicam);
 				genicam = NULL;
 				*size = 0;
 			}
-		}
-	} else if (g_ascii_strcasecmp (scheme, "http")) {
-		GFile *file;
-		GFileInputStream *stream;
 
-		file = g_file_new_for_uri (filename);
-		stream = g_file_read (file, NULL, NULL);
-		if(stream) {
-			GDataInputStream *data_stream;
-			gsize len;
-
-			data_stream = g_data_input_stream_new (G_INPUT_STREAM (stream));
-			genicam = g_data_input_stream_read_upto (data_stream, "", 0, &len, NULL, NULL);
+			/* Streaming state left when the download failed, or when the streamed data is not used */
+			g_clear_pointer (&loader.parser, arv_dom_push_parser_free);
+			if (loader.zip_stream != NULL)
+				arv_zip_stream_finish (loader.zip_stream, NULL);
+			if (loader.xml != NULL)
+				g_byte_array_unref (loader.xml);
+			g_free (streamed_filename);
+		}
+	} else if (_is_http_scheme (scheme)) {
+		ArvGvDeviceGenicamFetch *fetch = priv->genicam_fetch;
 
-			if (genicam)
-				*size = len;
+		if (fetch != NULL && g_strcmp0 (fetch->url, filename) == 0)
+			priv->genicam_fetch = NULL;
+		else
+			fetch = _genicam_fetch_start (gv_device, filename);
 
-			g_object_unref (data_stream);
-			g_object_unref (stream);
+		genicam = _genicam_fetch_finish (fetch, path, size, &cache_key);
+		if (genicam != NULL && cache_key != NULL) {
+			arv_info_device ("[GvDevice::load_genicam] Use cached xml data");
+			g_free (priv->genicam_cache_key);
+			priv->genicam_cache_key = g_strdup (cache_key);
 		}
-		g_object_unref (file);
+
+		_genicam_fetch_free (fetch);
 	} else {
 		g_critical ("Unkown GENICAM url scheme: '%s'", filename);
 	}
 
 	g_free (scheme);
 	g_free (path);
+	g_free (cache_key);
 
 	return genicam;
 }
@@ -1286,9 +3007,11 @@ _get_genicam_xml (ArvDevice *device, size_t *size, GError **error)
 
 	*size = 0;
 
-	xml = _load_genicam (gv_device, ARV_GVBS_XML_URL_0_OFFSET, size, &local_error);
+	xml = _load_genicam (gv_device, ARV_GVBS_XML_URL_0_OFFSET, size,
+			     &priv->genicam_document, &priv->genicam_compiled, &local_error);
 	if (xml == NULL && local_error == NULL)
-		xml = _load_genicam (gv_device, ARV_GVBS_XML_URL_1_OFFSET, size, &local_error);
+		xml = _load_genicam (gv_device, ARV_GVBS_XML_URL_1_OFFSET, size,
+				     &priv->genicam_document, &priv->genicam_compiled, &local_error);
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
@@ -1316,7 +3039,17 @@ arv_gv_device_load_genicam (ArvGvDevice *gv_device, GError **error)
 
 	genicam = _get_genicam_xml (ARV_DEVICE (gv_device), &size, error);
 	if (genicam != NULL) {
-		priv->genicam = arv_gc_new (ARV_DEVICE (gv_device), genicam, size);
+		if (priv->genicam_document != NULL)
+			priv->genicam = arv_gc_new_from_document (ARV_DEVICE (gv_device),
+								  g_steal_pointer (&priv->genicam_document),
+								  genicam, size, priv->genicam_compiled);
+		else if (priv->genicam_cache_key != NULL && arv_get_genicam_trusted_loading ())
+			priv->genicam = arv_gc_new_trusted (ARV_DEVICE (gv_device), genicam, size,
+							    priv->genicam_cache_key);
+		else
+			priv->genicam = arv_gc_new (ARV_DEVICE (gv_device), genicam, size);
+		g_clear_pointer (&priv->genicam_compiled, g_bytes_unref);
+		g_clear_pointer (&priv->genicam_cache_key, g_free);
 
 		arv_gc_set_default_node_data (priv->genicam, "GevCurrentIPConfigurationLLA",
 					      "<Boolean Name=\"GevCurrentIPConfigurationLLA\">"
@@ -1636,15 +3369,122 @@ arv_gv_device_load_genicam (ArvGvDevice *gv_device, GError **error)
 
 /* ArvDevice implemenation */
 
-static ArvStream *
-arv_gv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GDestroyNotify destroy, GError **error)
+/* Selects the stream channel addressed by the GevSCxx features. Streams are created with the stream_channel_mutex
+ * held, as the selector is shared by all the channels. */
+
+gboolean
+arv_gv_device_select_stream_channel (ArvGvDevice *gv_device, guint channel, GError **error)
 {
-	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
+	ArvDevice *device = ARV_DEVICE (gv_device);
+	GError *local_error = NULL;
+	gboolean available;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), FALSE);
+
+	available = arv_device_is_feature_available (device, "GevStreamChannelSelector", &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (!available) {
+		if (channel == 0)
+			return TRUE;
+
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
+			     "No stream channel selector for channel %u", channel);
+		return FALSE;
+	}
+
+	arv_device_set_integer_feature_value (device, "GevStreamChannelSelector", channel, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* In place recovery of a stalled stream, called by the stream thread: the stream channel registers are written again,
+ * in case the device lost them, and the acquisition is restarted. */
+
+gboolean
+arv_gv_device_restart_stream (ArvGvDevice *gv_device, ArvGvStream *gv_stream, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	GError *local_error = NULL;
+	guint channel;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), FALSE);
+	g_return_val_if_fail (ARV_IS_GV_STREAM (gv_stream), FALSE);
+
+	g_object_get (gv_stream, "channel", &channel, NULL);
+
+	g_mutex_lock (&priv->stream_channel_mutex);
+	if (arv_gv_device_select_stream_channel (gv_device, channel, &local_error))
+		arv_gv_stream_restore_channel (gv_stream, gv_device, &local_error);
+	g_mutex_unlock (&priv->stream_channel_mutex);
+
+	if (local_error == NULL) {
+		/* The device may still consider the acquisition as running */
+		arv_device_execute_command (ARV_DEVICE (gv_device), "AcquisitionStop", NULL);
+		arv_device_execute_command (ARV_DEVICE (gv_device), "AcquisitionStart", &local_error);
+	}
+
+	if (local_error != NULL) {
+		g_propagate_prefixed_error (error, local_error, "[GvDevice::restart_stream] ");
+		return FALSE;
+	}
+
+	arv_info_device ("[GvDevice::restart_stream] Stream channel %u restarted", channel);
+
+	return TRUE;
+}
+
+static guint
+_get_selected_stream_channel (ArvGvDevice *gv_device)
+{
+	ArvDevice *device = ARV_DEVICE (gv_device);
+
+	if (!arv_device_is_feature_available (device, "GevStreamChannelSelector", NULL))
+		return 0;
+
+	return MAX (arv_device_get_integer_feature_value (device, "GevStreamChannelSelector", NULL), 0);
+}
+
+/**
+ * arv_gv_device_create_stream_for_channel:
+ * @gv_device: a #ArvGvDevice
+ * @channel: stream channel index
+ * @callback: (scope notified) (allow-none): a frame processing callback
+ * @user_data: (closure) (allow-none): user data for @callback
+ * @destroy: a #GDestroyNotify placeholder, %NULL to ignore
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new [class@ArvStream] for the reception of the stream channel @channel, for the devices with several
+ * stream channels. Each stream has its own socket, port, receiving thread and statistics, and the packet size is
+ * negotiated for each channel, following the [method@ArvGvDevice.set_packet_size_adjustment] setting. The streams
+ * of different channels can be received concurrently. arv_device_create_stream() uses the channel selected by
+ * GevStreamChannelSelector.
+ *
+ * Returns: (transfer full): a new [class@ArvStream], to be freed after use with [method@GObject.Object.unref].
+ *
+ * Since: 0.8.24
+ */
+
+ArvStream *
+arv_gv_device_create_stream_for_channel (ArvGvDevice *gv_device, guint channel, ArvStreamCallback callback,
+					 void *user_data, GDestroyNotify destroy, GError **error)
+{
+	ArvDevice *device = ARV_DEVICE (gv_device);
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
-	ArvStream *stream;
+	ArvStream *stream = NULL;
 	guint32 n_stream_channels;
+	gboolean is_first_stream;
 	GError *local_error = NULL;
 
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), NULL);
+
 	n_stream_channels = arv_device_get_integer_feature_value (device, "GevStreamChannelCount", NULL);
 	arv_info_device ("[GvDevice::create_stream] Number of stream channels = %d", n_stream_channels);
 
@@ -1654,39 +3494,70 @@ arv_gv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void
 		return NULL;
 	}
 
-	if (!priv->io_data->is_controller) {
+	if (channel >= n_stream_channels) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
+			     "Stream channel %u not found (%u channels)", channel, n_stream_channels);
+		return NULL;
+	}
+
+	/* Monitors can receive a multicast stream configured by the controller */
+	if (!priv->io_data->is_controller &&
+	    (priv->stream_multicast_group == NULL || priv->stream_multicast_port == 0)) {
 		arv_warning_device ("[GvDevice::create_stream] Can't create stream without control access");
 		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONTROLLER,
 			     "Controller privilege required for streaming control");
 		return NULL;
 	}
 
-	if (priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_NEVER &&
+	g_mutex_lock (&priv->stream_channel_mutex);
+
+	if (!arv_gv_device_select_stream_channel (gv_device, channel, &local_error)) {
+		g_mutex_unlock (&priv->stream_channel_mutex);
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	is_first_stream = channel >= 64 || (priv->channels_with_stream & (G_GUINT64_CONSTANT (1) << channel)) == 0;
+
+	if (priv->io_data->is_controller &&
+	    priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_NEVER &&
 	    ((priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ONCE &&
 	      priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE) ||
-	     !priv->first_stream_created)) {
+	     is_first_stream)) {
 		auto_packet_size (gv_device,
 				  priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE ||
 				      priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE,
 				  &local_error);
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			return NULL;
-		}
 	}
 
-	stream = arv_gv_stream_new (gv_device, callback, user_data, destroy, error);
-	if (!ARV_IS_STREAM (stream))
+	if (local_error == NULL)
+		stream = arv_gv_stream_new (gv_device, channel, callback, user_data, destroy, &local_error);
+
+	if (ARV_IS_STREAM (stream) && channel < 64)
+		priv->channels_with_stream |= G_GUINT64_CONSTANT (1) << channel;
+
+	g_mutex_unlock (&priv->stream_channel_mutex);
+
+	if (!ARV_IS_STREAM (stream)) {
+		g_propagate_error (error, local_error);
 		return NULL;
+	}
 
 	if (!priv->is_packet_resend_supported)
 		g_object_set (stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
 
-	priv->first_stream_created = TRUE;
-
 	return stream;
 }
 
+static ArvStream *
+arv_gv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GDestroyNotify destroy, GError **error)
+{
+	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
+
+	return arv_gv_device_create_stream_for_channel (gv_device, _get_selected_stream_channel (gv_device),
+							callback, user_data, destroy, error);
+}
+
 static ArvGc *
 arv_gv_device_get_genicam (ArvDevice *device)
 {
@@ -1734,6 +3605,63 @@ arv_gv_device_set_stream_options (ArvGvDevice *gv_device, ArvGvStreamOption opti
 	priv->stream_options = options;
 }
 
+/**
+ * arv_gv_device_get_stream_multicast_group:
+ * @gv_device: a #ArvGvDevice
+ * @port: (out) (optional): stream destination port placeholder
+ *
+ * Returns: (transfer none) (nullable): the multicast group used as stream destination, %NULL for unicast streaming.
+ *
+ * Since: 0.8.24
+ */
+
+GInetAddress *
+arv_gv_device_get_stream_multicast_group (ArvGvDevice *gv_device, guint16 *port)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	if (port != NULL)
+		*port = 0;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), NULL);
+
+	if (port != NULL)
+		*port = priv->stream_multicast_port;
+
+	return priv->stream_multicast_group;
+}
+
+/**
+ * arv_gv_device_set_stream_multicast_group:
+ * @gv_device: a #ArvGvDevice
+ * @group: (nullable): an IPv4 multicast address, %NULL for unicast streaming
+ * @port: stream destination port, 0 for an automatically allocated one
+ *
+ * Sets a multicast group as stream destination, which allows several hosts to receive the same stream. On the
+ * controller, the stream creation sets the device stream destination (GevSCDA and GevSCPHostPort) to @group and
+ * @port. Other hosts, which don't have the control privilege, can then create a stream in monitor mode, using the
+ * same group and port, without modifying the device configuration. It must be called before
+ * arv_device_create_stream().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gv_device_set_stream_multicast_group (ArvGvDevice *gv_device, GInetAddress *group, guint16 port)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+	g_return_if_fail (group == NULL || G_IS_INET_ADDRESS (group));
+	g_return_if_fail (group == NULL ||
+			  (g_inet_address_get_family (group) == G_SOCKET_FAMILY_IPV4 &&
+			   g_inet_address_get_is_multicast (group)));
+
+	g_clear_object (&priv->stream_multicast_group);
+	priv->stream_multicast_group = group != NULL ? g_object_ref (group) : NULL;
+	priv->stream_multicast_port = group != NULL ? port : 0;
+}
+
 /**
  * arv_gv_device_new:
  * @interface_address: address of the interface connected to the device
@@ -1754,6 +3682,34 @@ arv_gv_device_new (GInetAddress *interface_address, GInetAddress *device_address
 			       NULL);
 }
 
+/**
+ * arv_gv_device_new_monitor:
+ * @interface_address: address of the interface connected to the device
+ * @device_address: device address
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a device in monitor mode, for the access to a device controlled by another client. A monitor never
+ * requests the control privilege and doesn't send heartbeats, it can only read the device registers. The register
+ * cache uses the %ARV_REGISTER_CACHE_POLICY_STATIC policy, which avoids reading again the registers other clients
+ * can't change. The other registers, like the temperatures or the counters, are read on each access.
+ * arv_device_read_registers() reads several of them in a single transaction, which keeps the load on the control
+ * channel low when monitoring many devices.
+ *
+ * Returns: a newly created #ArvDevice using GigE protocol, in monitor mode
+ *
+ * Since: 0.8.24
+ */
+
+ArvDevice *
+arv_gv_device_new_monitor (GInetAddress *interface_address, GInetAddress *device_address, GError **error)
+{
+	return g_initable_new (ARV_TYPE_GV_DEVICE, NULL, error,
+			       "interface-address", interface_address,
+			       "device-address", device_address,
+			       "monitor", TRUE,
+			       NULL);
+}
+
 static void
 arv_gv_device_constructed (GObject *object)
 {
@@ -1767,6 +3723,7 @@ arv_gv_device_constructed (GObject *object)
 	char *address_string;
 	guint32 capabilities;
 	guint32 device_mode;
+	guint32 n_message_channels = 0;
 
         G_OBJECT_CLASS (arv_gv_device_parent_class)->constructed (object);
 
@@ -1804,9 +3761,22 @@ arv_gv_device_constructed (GObject *object)
 		return;
 	}
 
+	/* A connected socket saves the route lookup of each send, and filters out the packets of the other peers */
+	if (!g_socket_connect (io_data->socket, io_data->device_address, NULL, &local_error)) {
+		if (local_error == NULL)
+			local_error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_UNKNOWN,
+						   "Unknown error trying to connect to the device");
+		arv_device_take_init_error (ARV_DEVICE (gv_device), local_error);
+
+		return;
+	}
+
 	io_data->buffer = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
+	io_data->cmd_packet = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
 	io_data->gvcp_n_retries = ARV_GV_DEVICE_GVCP_N_RETRIES_DEFAULT;
 	io_data->gvcp_timeout_ms = ARV_GV_DEVICE_GVCP_TIMEOUT_MS_DEFAULT;
+	io_data->gvcp_window_size = priv->gvcp_window_size;
+	io_data->gvcp_read_memory_size = ARV_GVCP_DATA_SIZE_MAX;
 	io_data->poll_in_event.fd = g_socket_get_fd (io_data->socket);
 	io_data->poll_in_event.events =  G_IO_IN;
 	io_data->poll_in_event.revents = 0;
@@ -1815,6 +3785,31 @@ arv_gv_device_constructed (GObject *object)
 
 	priv->io_data = io_data;
 
+	arv_device_declare_info (ARV_DEVICE (gv_device), "n_gvcp_commands", G_TYPE_UINT64, &io_data->n_gvcp_commands);
+	arv_device_declare_info (ARV_DEVICE (gv_device), "n_gvcp_resent_commands", G_TYPE_UINT64,
+				 &io_data->n_gvcp_resent_commands);
+	arv_device_declare_info (ARV_DEVICE (gv_device), "n_gvcp_pending_acks", G_TYPE_UINT64,
+				 &io_data->n_gvcp_pending_acks);
+	arv_device_declare_info (ARV_DEVICE (gv_device), "n_gvcp_failures", G_TYPE_UINT64, &io_data->n_gvcp_failures);
+	arv_device_declare_info (ARV_DEVICE (gv_device), "gvcp_srtt_us", G_TYPE_UINT64, &io_data->gvcp_srtt_us);
+	arv_device_declare_info (ARV_DEVICE (gv_device), "gvcp_rttvar_us", G_TYPE_UINT64, &io_data->gvcp_rttvar_us);
+
+	/* A download from a web server runs during the bootstrap register reads */
+	_start_genicam_fetch (gv_device);
+
+	_read_device_mac (gv_device, &priv->device_mac, NULL);
+	io_data->device_mac = priv->device_mac;
+
+	arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_DEVICE_MODE_OFFSET, &device_mode, NULL);
+	priv->is_big_endian_device = (device_mode & ARV_GVBS_DEVICE_MODE_BIG_ENDIAN) != 0;
+
+	arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_GVCP_CAPABILITY_OFFSET, &capabilities, NULL);
+	priv->is_packet_resend_supported = (capabilities & ARV_GVBS_GVCP_CAPABILITY_PACKET_RESEND) != 0;
+	priv->is_write_memory_supported = (capabilities & ARV_GVBS_GVCP_CAPABILITY_WRITE_MEMORY) != 0;
+
+	arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_N_MESSAGE_CHANNELS_OFFSET, &n_message_channels, NULL);
+	priv->is_event_supported = (capabilities & ARV_GVBS_GVCP_CAPABILITY_EVENT) != 0 && n_message_channels > 0;
+
 	arv_gv_device_load_genicam (gv_device, &local_error);
 	if (local_error != NULL) {
 		arv_device_take_init_error (ARV_DEVICE (gv_device), local_error);
@@ -1829,28 +3824,30 @@ arv_gv_device_constructed (GObject *object)
 		return;
 	}
 
-	arv_gv_device_take_control (gv_device, NULL);
-
-	heartbeat_data = g_new (ArvGvDeviceHeartbeatData, 1);
-	heartbeat_data->gv_device = gv_device;
-	heartbeat_data->io_data = io_data;
-	heartbeat_data->period_us = ARV_GV_DEVICE_HEARTBEAT_PERIOD_US;
-	heartbeat_data->cancellable = g_cancellable_new ();
+	if (priv->is_monitor) {
+		arv_info_device ("[GvDevice::new] Monitor mode, no control request");
+		arv_gc_set_register_cache_policy (priv->genicam, ARV_REGISTER_CACHE_POLICY_STATIC);
+	} else {
+		arv_gv_device_take_control (gv_device, NULL);
 
-	priv->heartbeat_data = heartbeat_data;
+		if (priv->heartbeat_cpu_affinity != NULL)
+			_heartbeat_set_cpu_affinity (priv->heartbeat_cpu_affinity);
 
-	priv->heartbeat_thread = g_thread_new ("arv_gv_heartbeat", arv_gv_device_heartbeat_thread, priv->heartbeat_data);
+		heartbeat_data = g_new0 (ArvGvDeviceHeartbeatData, 1);
+		heartbeat_data->gv_device = gv_device;
+		heartbeat_data->io_data = io_data;
+		heartbeat_data->period_us = ARV_GV_DEVICE_HEARTBEAT_PERIOD_US;
+		heartbeat_data->clock_model = priv->clock_model;
 
-	arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_DEVICE_MODE_OFFSET, &device_mode, NULL);
-	priv->is_big_endian_device = (device_mode & ARV_GVBS_DEVICE_MODE_BIG_ENDIAN) != 0;
+		priv->heartbeat_data = heartbeat_data;
 
-	arv_gv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_GVCP_CAPABILITY_OFFSET, &capabilities, NULL);
-	priv->is_packet_resend_supported = (capabilities & ARV_GVBS_GVCP_CAPABILITY_PACKET_RESEND) != 0;
-	priv->is_write_memory_supported = (capabilities & ARV_GVBS_GVCP_CAPABILITY_WRITE_MEMORY) != 0;
+		_heartbeat_register (heartbeat_data);
+	}
 
 	arv_info_device ("[GvDevice::new] Device endianness = %s", priv->is_big_endian_device ? "big" : "little");
 	arv_info_device ("[GvDevice::new] Packet resend     = %s", priv->is_packet_resend_supported ? "yes" : "no");
 	arv_info_device ("[GvDevice::new] Write memory      = %s", priv->is_write_memory_supported ? "yes" : "no");
+	arv_info_device ("[GvDevice::new] Message channel   = %s", priv->is_event_supported ? "yes" : "no");
 
 	document = ARV_DOM_DOCUMENT (priv->genicam);
 	register_description = ARV_GC_REGISTER_DESCRIPTION_NODE (arv_dom_document_get_document_element (document));
@@ -1870,6 +3867,17 @@ arv_gv_device_init (ArvGvDevice *gv_device)
 	priv->genicam_xml = NULL;
 	priv->genicam_xml_size = 0;
 	priv->stream_options = ARV_GV_STREAM_OPTION_NONE;
+	priv->clock_model = arv_clock_model_new ();
+	g_mutex_init (&priv->stream_channel_mutex);
+}
+
+static void
+arv_gv_device_dispose (GObject *object)
+{
+	/* The event signals can't be emitted during the finalization */
+	arv_gv_device_stop_event_channel (ARV_DEVICE (object));
+
+	G_OBJECT_CLASS (arv_gv_device_parent_class)->dispose (object);
 }
 
 static void
@@ -1879,22 +3887,13 @@ arv_gv_device_finalize (GObject *object)
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
 	ArvGvDeviceIOData *io_data;
 
-	if (priv->heartbeat_thread != NULL) {
-		ArvGvDeviceHeartbeatData *heartbeat_data;
-
-		heartbeat_data = priv->heartbeat_data;
-
-		g_cancellable_cancel (heartbeat_data->cancellable);
-		g_thread_join (priv->heartbeat_thread);
-		g_clear_object (&heartbeat_data->cancellable);
+	if (priv->heartbeat_data != NULL) {
+		_heartbeat_unregister (priv->heartbeat_data);
 
-		g_clear_pointer (&heartbeat_data, g_free);
-
-		priv->heartbeat_data = NULL;
-		priv->heartbeat_thread = NULL;
+		g_clear_pointer (&priv->heartbeat_data, g_free);
 	}
 
-	if (priv->init_success)
+	if (priv->init_success && !priv->is_monitor)
 		arv_gv_device_leave_control (gv_device, NULL);
 
 	io_data = priv->io_data;
@@ -1902,6 +3901,7 @@ arv_gv_device_finalize (GObject *object)
 	g_clear_object (&io_data->interface_address);
 	g_clear_object (&io_data->socket);
 	g_clear_pointer (&io_data->buffer, g_free);
+	g_clear_pointer (&io_data->cmd_packet, g_free);
 	g_mutex_clear (&io_data->mutex);
 
 	arv_gpollfd_finish_all (&io_data->poll_in_event, 1);
@@ -1910,6 +3910,14 @@ arv_gv_device_finalize (GObject *object)
 
 	g_clear_object (&priv->genicam);
 	g_clear_pointer (&priv->genicam_xml, g_free);
+	g_clear_object (&priv->genicam_document);
+	g_clear_pointer (&priv->genicam_compiled, g_bytes_unref);
+	g_clear_pointer (&priv->genicam_cache_key, g_free);
+	g_clear_pointer (&priv->genicam_fetch, _genicam_fetch_free);
+	g_clear_object (&priv->stream_multicast_group);
+	g_clear_pointer (&priv->heartbeat_cpu_affinity, g_free);
+	g_clear_pointer (&priv->clock_model, arv_clock_model_free);
+	g_mutex_clear (&priv->stream_channel_mutex);
 
 	g_clear_object (&priv->interface_address);
 	g_clear_object (&priv->device_address);
@@ -1967,6 +3975,23 @@ arv_gv_device_set_property (GObject *self, guint prop_id, const GValue *value, G
 		case PROP_GV_DEVICE_PACKET_SIZE_ADJUSTEMENT:
 			priv->packet_size_adjustment = g_value_get_enum (value);
 			break;
+		case PROP_GV_DEVICE_GVCP_WINDOW_SIZE:
+			priv->gvcp_window_size = g_value_get_uint (value);
+			if (priv->io_data != NULL) {
+				g_mutex_lock (&priv->io_data->mutex);
+				priv->io_data->gvcp_window_size = priv->gvcp_window_size;
+				g_mutex_unlock (&priv->io_data->mutex);
+			}
+			break;
+		case PROP_GV_DEVICE_MONITOR:
+			priv->is_monitor = g_value_get_boolean (value);
+			break;
+		case PROP_GV_DEVICE_HEARTBEAT_CPU_AFFINITY:
+			g_free (priv->heartbeat_cpu_affinity);
+			priv->heartbeat_cpu_affinity = g_value_dup_string (value);
+			if (priv->heartbeat_data != NULL)
+				_heartbeat_set_cpu_affinity (priv->heartbeat_cpu_affinity);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
 			break;
@@ -1982,6 +4007,15 @@ arv_gv_device_get_property (GObject *object, guint prop_id, GValue *value, GPara
 		case PROP_GV_DEVICE_PACKET_SIZE_ADJUSTEMENT:
 			g_value_set_enum (value, priv->packet_size_adjustment);
 			break;
+		case PROP_GV_DEVICE_HEARTBEAT_CPU_AFFINITY:
+			g_value_set_string (value, priv->heartbeat_cpu_affinity);
+			break;
+		case PROP_GV_DEVICE_GVCP_WINDOW_SIZE:
+			g_value_set_uint (value, priv->gvcp_window_size);
+			break;
+		case PROP_GV_DEVICE_MONITOR:
+			g_value_set_boolean (value, priv->is_monitor);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -1994,6 +4028,7 @@ arv_gv_device_class_init (ArvGvDeviceClass *gv_device_class)
 	GObjectClass *object_class = G_OBJECT_CLASS (gv_device_class);
 	ArvDeviceClass *device_class = ARV_DEVICE_CLASS (gv_device_class);
 
+	object_class->dispose = arv_gv_device_dispose;
 	object_class->finalize = arv_gv_device_finalize;
 	object_class->constructed = arv_gv_device_constructed;
 	object_class->set_property = arv_gv_device_set_property;
@@ -2006,6 +4041,11 @@ arv_gv_device_class_init (ArvGvDeviceClass *gv_device_class)
 	device_class->write_memory = arv_gv_device_write_memory;
 	device_class->read_register = arv_gv_device_read_register;
 	device_class->write_register = arv_gv_device_write_register;
+	device_class->read_registers = arv_gv_device_read_registers;
+	device_class->write_registers = arv_gv_device_write_registers;
+	device_class->start_event_channel = arv_gv_device_start_event_channel;
+	device_class->stop_event_channel = arv_gv_device_stop_event_channel;
+	device_class->reconnect = arv_gv_device_reconnect;
 
 	g_object_class_install_property
 		(object_class,
@@ -2030,4 +4070,54 @@ arv_gv_device_class_init (ArvGvDeviceClass *gv_device_class)
 							    ARV_GV_PACKET_SIZE_ADJUSTMENT_DEFAULT,
 							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
 								G_PARAM_CONSTRUCT));
+
+	/**
+	 * ArvGvDevice:heartbeat-cpu-affinity:
+	 *
+	 * List of CPUs the heartbeat thread is allowed to run on, using the "0-3,8" syntax. %NULL or an empty
+	 * string leaves the affinity untouched. The heartbeat thread is shared by all the devices of the process,
+	 * the last set affinity applies to all of them.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	g_object_class_install_property (object_class, PROP_GV_DEVICE_HEARTBEAT_CPU_AFFINITY,
+					 g_param_spec_string ("heartbeat-cpu-affinity", "Heartbeat CPU affinity",
+							      "CPU list of the heartbeat thread",
+							      NULL,
+							      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvGvDevice:gvcp-window-size:
+	 *
+	 * Maximum number of memory read or write commands kept in flight during large memory transfers, like the
+	 * Genicam data download. The default value of 1 means stop-and-wait. Not all devices are able to queue
+	 * commands, a larger value should only be used with devices known to handle it. Pipelined transfers are
+	 * disabled for the device as soon as a command is lost.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	g_object_class_install_property (object_class, PROP_GV_DEVICE_GVCP_WINDOW_SIZE,
+					 g_param_spec_uint ("gvcp-window-size", "GVCP window size",
+							    "Maximum number of pending GVCP memory commands",
+							    1, ARV_GV_DEVICE_GVCP_WINDOW_SIZE_MAX, 1,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+								G_PARAM_CONSTRUCT));
+
+	/**
+	 * ArvGvDevice:monitor:
+	 *
+	 * Monitor mode, where the device is accessed without the control privilege and without heartbeat. See
+	 * arv_gv_device_new_monitor().
+	 *
+	 * Since: 0.8.24
+	 */
+
+	g_object_class_install_property (object_class, PROP_GV_DEVICE_MONITOR,
+					 g_param_spec_boolean ("monitor", "Monitor",
+							       "Monitor mode, without control privilege",
+							       FALSE,
+							       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+								   G_PARAM_CONSTRUCT_ONLY));
 }
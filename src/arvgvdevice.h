@@ -70,6 +70,8 @@ ARV_API G_DECLARE_FINAL_TYPE (ArvGvDevice, arv_gv_device, ARV, GV_DEVICE, ArvDev
 
 ARV_API ArvDevice *		arv_gv_device_new				(GInetAddress *interface_address, GInetAddress *device_address,
 										 GError **error);
+ARV_API ArvDevice *		arv_gv_device_new_monitor			(GInetAddress *interface_address, GInetAddress *device_address,
+										 GError **error);
 
 ARV_API gboolean		arv_gv_device_take_control			(ArvGvDevice *gv_device, GError **error);
 ARV_API gboolean		arv_gv_device_leave_control			(ArvGvDevice *gv_device, GError **error);
@@ -83,10 +85,17 @@ ARV_API guint			arv_gv_device_get_packet_size			(ArvGvDevice *gv_device, GError
 ARV_API void			arv_gv_device_set_packet_size			(ArvGvDevice *gv_device, gint packet_size, GError **error);
 ARV_API void			arv_gv_device_set_packet_size_adjustment	(ArvGvDevice *gv_device,
 										 ArvGvPacketSizeAdjustment adjustment);
+ARV_API void			arv_gv_device_set_packet_size_alignment		(ArvGvDevice *gv_device, guint alignment);
 ARV_API guint			arv_gv_device_auto_packet_size			(ArvGvDevice *gv_device, GError **error);
 
+ARV_API ArvStream *		arv_gv_device_create_stream_for_channel		(ArvGvDevice *gv_device, guint channel,
+										 ArvStreamCallback callback, void *user_data,
+										 GDestroyNotify destroy, GError **error);
+
 ARV_API ArvGvStreamOption	arv_gv_device_get_stream_options		(ArvGvDevice *gv_device);
 ARV_API void			arv_gv_device_set_stream_options		(ArvGvDevice *gv_device, ArvGvStreamOption options);
+ARV_API GInetAddress *		arv_gv_device_get_stream_multicast_group	(ArvGvDevice *gv_device, guint16 *port);
+ARV_API void			arv_gv_device_set_stream_multicast_group	(ArvGvDevice *gv_device, GInetAddress *group, guint16 port);
 
 ARV_API void			arv_gv_device_get_current_ip			(ArvGvDevice *gv_device, GInetAddress **ip, GInetAddressMask **mask, GInetAddress **gateway, GError **error);
 ARV_API void			arv_gv_device_get_persistent_ip			(ArvGvDevice *gv_device, GInetAddress **ip, GInetAddressMask **mask, GInetAddress **gateway, GError **error);
@@ -97,6 +106,17 @@ ARV_API void			arv_gv_device_set_ip_configuration_mode		(ArvGvDevice *gv_device,
 
 ARV_API gboolean		arv_gv_device_is_controller			(ArvGvDevice *gv_device);
 
+ARV_API gboolean		arv_gv_device_issue_action_command		(guint32 device_key, guint32 group_key,
+										 guint32 group_mask,
+										 GInetAddress *broadcast_address,
+										 GInetAddress ***inet_addresses,
+										 guint *n_acknowledges, GError **error);
+ARV_API gboolean		arv_gv_device_issue_scheduled_action_command	(guint32 device_key, guint32 group_key,
+										 guint32 group_mask, guint64 timestamp_ns,
+										 GInetAddress *broadcast_address,
+										 GInetAddress ***inet_addresses,
+										 guint *n_acknowledges, GError **error);
+
 G_END_DECLS
 
 #endif
@@ -28,6 +28,7 @@
 #endif
 
 #include <arvgvdevice.h>
+#include <arvclockmodelprivate.h>
 
 G_BEGIN_DECLS
 
@@ -45,12 +46,35 @@ G_BEGIN_DECLS
     #define ARV_GV_DEVICE_HEARTBEAT_RETRY_TIMEOUT_S 5.0		/* FIXME */
 #endif
 
+#define ARV_GV_DEVICE_HEARTBEAT_MAX_SKIPPED	4
+
+/* Lower bound of the acknowledge timeout derived from the round trip time */
+#define ARV_GV_DEVICE_GVCP_TIMEOUT_MS_MIN	5
+
 #define ARV_GV_DEVICE_GVSP_PACKET_SIZE_DEFAULT	1500
 
 #define ARV_GV_DEVICE_BUFFER_SIZE	1024
+/* Maximum number of stale acknowledges discarded in a single receive call */
+#define ARV_GV_DEVICE_N_DRAINED_ACKS	8
+
+#define ARV_GV_DEVICE_EVENT_POLL_TIMEOUT_MS	100
+
+#define ARV_GV_DEVICE_CLOCK_SAMPLING_PERIOD_US	1000000
+
+#define ARV_GV_DEVICE_GVCP_WINDOW_SIZE_MAX	16
+
+#define ARV_GV_DEVICE_GENICAM_HTTP_TIMEOUT_MS	5000
+/* Freshness of the Genicam data downloaded from a web server not giving any */
+#define ARV_GV_DEVICE_GENICAM_HTTP_FRESHNESS_S	86400
 
 GRegex * 		arv_gv_device_get_url_regex 			(void);
 
+ArvClockModel *		arv_gv_device_get_clock_model			(ArvGvDevice *gv_device);
+
+gboolean		arv_gv_device_select_stream_channel		(ArvGvDevice *gv_device, guint channel, GError **error);
+gboolean		arv_gv_device_restart_stream			(ArvGvDevice *gv_device, ArvGvStream *gv_stream,
+									 GError **error);
+
 G_END_DECLS
 
 #endif
@@ -20,8 +20,11 @@
  * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
  */
 
+#define _GNU_SOURCE /* for sendmmsg */
+
 #include <arvgvfakecamera.h>
 #include <arvfakecamera.h>
+#include <arvfakecameraprivate.h>
 #include <arvbufferprivate.h>
 #include <arvgvcpprivate.h>
 #include <arvgvspprivate.h>
@@ -29,6 +32,20 @@
 #include <arvmiscprivate.h>
 #include <arvnetworkprivate.h>
 
+#if defined (__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <errno.h>
+#include <string.h>
+#define ARV_GV_FAKE_CAMERA_HAS_SENDMMSG 1
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#else
+#define ARV_GV_FAKE_CAMERA_HAS_SENDMMSG 0
+#endif
+
 /**
  * SECTION: arvgvfakecamera
  * @short_description: GigE Vision Simulator
@@ -38,6 +55,19 @@
 
 #define ARV_GV_FAKE_CAMERA_BUFFER_SIZE	65536
 
+/* Data blocks sent by a single sendmmsg call */
+#define ARV_GV_FAKE_CAMERA_N_MESSAGES		64
+/* Kernel limits of the UDP segmentation offload */
+#define ARV_GV_FAKE_CAMERA_N_SEGMENTS_MAX	64
+#define ARV_GV_FAKE_CAMERA_GSO_SIZE_MAX		65000
+
+#define ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE	(sizeof (ArvGvspPacket) + sizeof (ArvGvspHeader))
+
+#define ARV_GV_FAKE_CAMERA_LOST_PACKET_PATTERN_SIZE	4096
+
+/* Extra delay of the reordered packets, overtaken by the following ones */
+#define ARV_GV_FAKE_CAMERA_REORDER_DELAY_US	1000
+
 enum {
 	ARV_GV_FAKE_CAMERA_INPUT_SOCKET_GVCP = 0,
 	ARV_GV_FAKE_CAMERA_INPUT_SOCKET_GLOBAL_DISCOVERY,
@@ -52,9 +82,47 @@ enum
   PROP_SERIAL_NUMBER,
   PROP_GENICAM_FILENAME,
   PROP_GVSP_LOST_PACKET_RATIO,
-  PROP_CM_DOMAIN
+  PROP_STANDALONE,
+  PROP_CM_DOMAIN,
+  PROP_GVCP_LATENCY,
+  PROP_GVCP_JITTER,
+  PROP_GVCP_REORDER_RATIO,
+  PROP_GVCP_DUPLICATE_RATIO,
+  PROP_GVCP_BURST_LOSS_RATIO,
+  PROP_GVCP_BURST_LENGTH,
+  PROP_GVSP_LATENCY,
+  PROP_GVSP_JITTER,
+  PROP_GVSP_REORDER_RATIO,
+  PROP_GVSP_DUPLICATE_RATIO,
+  PROP_GVSP_BURST_LOSS_RATIO,
+  PROP_GVSP_BURST_LENGTH,
+  PROP_IMPAIRMENT_SEED
 };
 
+/* Network impairment simulation, for the GVCP acknowledges or the GVSP packets */
+
+typedef struct {
+	guint latency_us;
+	guint jitter_us;
+	double reorder_ratio;
+	double duplicate_ratio;
+	double burst_loss_ratio;
+	guint burst_length;
+
+	/* Packets still to be dropped in the current loss burst */
+	guint n_burst_lost_packets;
+} ArvGvFakeCameraImpairment;
+
+typedef struct {
+	gint64 time_us;
+	GSocket *socket;
+	GSocketAddress *address;
+	size_t size;
+	guint8 data[];
+} ArvGvFakeCameraDelayedPacket;
+
+typedef struct _ArvGvFakeCameraSender ArvGvFakeCameraSender;
+
 typedef struct {
 	char *interface_name;
 	char *serial_number;
@@ -77,7 +145,29 @@ typedef struct {
 	GThread *thread;
 	gboolean cancel;
 
+	/* Streaming state, only accessed by the camera thread, or by the farm thread driving the camera */
+	ArvBuffer *image_buffer;
+	GSocketAddress *stream_address;
+	size_t payload;
+	gboolean is_streaming;
+	ArvGvFakeCameraSender *sender;
+	void *packet_buffer;
+	GInputVector input_vector;
+
+	gboolean is_standalone;
+	guint farm_index;
+	guint farm_size;
+
 	double gvsp_lost_packet_ratio;
+	/* Precomputed loss simulation, cycled over the sent packets */
+	guint8 lost_packet_pattern[ARV_GV_FAKE_CAMERA_LOST_PACKET_PATTERN_SIZE];
+	guint lost_packet_index;
+
+	ArvGvFakeCameraImpairment gvcp_impairment;
+	ArvGvFakeCameraImpairment gvsp_impairment;
+	GRand *impairment_rand;
+	/* Delayed packets, sorted by send time */
+	GQueue delayed_packets;
 } ArvGvFakeCameraPrivate;
 
 struct _ArvGvFakeCamera {
@@ -106,6 +196,132 @@ _g_inet_socket_address_is_equal (GInetSocketAddress *a, GInetSocketAddress *b)
 				     g_inet_socket_address_get_address (b));
 }
 
+static gboolean
+_is_impaired (ArvGvFakeCameraImpairment *impairment)
+{
+	return impairment->latency_us > 0 ||
+		impairment->jitter_us > 0 ||
+		impairment->reorder_ratio > 0.0 ||
+		impairment->duplicate_ratio > 0.0 ||
+		impairment->burst_loss_ratio > 0.0;
+}
+
+static void
+_delay_packet (ArvGvFakeCameraPrivate *priv, GSocket *socket, GSocketAddress *address,
+	       const void *data, size_t size, gint64 time_us)
+{
+	ArvGvFakeCameraDelayedPacket *packet;
+	GList *iter;
+
+	packet = g_malloc (sizeof (ArvGvFakeCameraDelayedPacket) + size);
+	packet->time_us = time_us;
+	packet->socket = g_object_ref (socket);
+	packet->address = g_object_ref (address);
+	packet->size = size;
+	memcpy (packet->data, data, size);
+
+	/* The send times are mostly increasing */
+	for (iter = priv->delayed_packets.tail; iter != NULL; iter = iter->prev) {
+		ArvGvFakeCameraDelayedPacket *previous = iter->data;
+
+		if (previous->time_us <= time_us)
+			break;
+	}
+
+	if (iter != NULL)
+		g_queue_insert_after (&priv->delayed_packets, iter, packet);
+	else
+		g_queue_push_head (&priv->delayed_packets, packet);
+}
+
+static void
+_delayed_packet_free (ArvGvFakeCameraDelayedPacket *packet)
+{
+	g_object_unref (packet->socket);
+	g_object_unref (packet->address);
+	g_free (packet);
+}
+
+/* Time of the next delayed packet, G_MAXINT64 if there is none */
+
+static gint64
+_get_next_delayed_packet_time (ArvGvFakeCameraPrivate *priv)
+{
+	ArvGvFakeCameraDelayedPacket *packet = g_queue_peek_head (&priv->delayed_packets);
+
+	return packet != NULL ? packet->time_us : G_MAXINT64;
+}
+
+static void
+_send_delayed_packets (ArvGvFakeCameraPrivate *priv)
+{
+	ArvGvFakeCameraDelayedPacket *packet;
+	gint64 now_us = g_get_real_time ();
+
+	while ((packet = g_queue_peek_head (&priv->delayed_packets)) != NULL && packet->time_us <= now_us) {
+		GError *error = NULL;
+
+		g_queue_pop_head (&priv->delayed_packets);
+
+		g_socket_send_to (packet->socket, packet->address, (const char *) packet->data, packet->size,
+				  NULL, &error);
+		if (error != NULL) {
+			arv_info_device ("[GvFakeCamera::send_delayed_packets] Failed to send packet: %s",
+					 error->message);
+			g_clear_error (&error);
+		}
+
+		_delayed_packet_free (packet);
+	}
+}
+
+/* Sends a packet through the simulated network: the loss bursts start with a probability of burst_loss_ratio and
+ * drop burst_length packets, the duplicated packets are sent twice, and the packets are delayed by the latency plus
+ * a random jitter, the reordered ones being held back further. */
+
+static void
+_send_packet (ArvGvFakeCameraPrivate *priv, ArvGvFakeCameraImpairment *impairment,
+	      GSocket *socket, GSocketAddress *address, const void *data, size_t size, GError **error)
+{
+	guint n_copies = 1;
+	guint i;
+
+	if (!_is_impaired (impairment)) {
+		g_socket_send_to (socket, address, data, size, NULL, error);
+		return;
+	}
+
+	if (impairment->n_burst_lost_packets > 0) {
+		impairment->n_burst_lost_packets--;
+		return;
+	}
+
+	if (impairment->burst_loss_ratio > 0.0 &&
+	    g_rand_double (priv->impairment_rand) < impairment->burst_loss_ratio) {
+		impairment->n_burst_lost_packets = MAX (impairment->burst_length, 1) - 1;
+		return;
+	}
+
+	if (impairment->duplicate_ratio > 0.0 &&
+	    g_rand_double (priv->impairment_rand) < impairment->duplicate_ratio)
+		n_copies = 2;
+
+	for (i = 0; i < n_copies; i++) {
+		gint64 delay_us = impairment->latency_us;
+
+		if (impairment->jitter_us > 0)
+			delay_us += g_rand_int_range (priv->impairment_rand, 0, impairment->jitter_us + 1);
+		if (impairment->reorder_ratio > 0.0 &&
+		    g_rand_double (priv->impairment_rand) < impairment->reorder_ratio)
+			delay_us += ARV_GV_FAKE_CAMERA_REORDER_DELAY_US;
+
+		if (delay_us > 0)
+			_delay_packet (priv, socket, address, data, size, g_get_real_time () + delay_us);
+		else
+			g_socket_send_to (socket, address, data, size, NULL, error);
+	}
+}
+
 static gboolean
 _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 			GSocketAddress *remote_address,
@@ -119,6 +335,9 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 	guint16 packet_type;
 	guint32 register_address;
 	guint32 register_value;
+	guint32 register_values[ARV_GVCP_READ_REGISTERS_MAX];
+	guint n_registers;
+	guint i;
 	gboolean write_access;
 	gboolean success = FALSE;
 
@@ -186,29 +405,45 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 									   &ack_packet_size);
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			arv_gvcp_packet_get_read_register_cmd_infos (packet, &register_address);
-			arv_fake_camera_read_register (gv_fake_camera->priv->camera, register_address, &register_value);
-			arv_info_device ("[GvFakeCamera::handle_control_packet] Read register command %d -> %d",
-					  register_address, register_value);
-			ack_packet = arv_gvcp_packet_new_read_register_ack (register_value, packet_id,
-									    &ack_packet_size);
+			n_registers = MIN (arv_gvcp_packet_get_read_registers_cmd_n_registers (packet),
+					   ARV_GVCP_READ_REGISTERS_MAX);
+			if (n_registers == 0) {
+				arv_warning_device ("[GvFakeCamera::handle_control_packet] Empty read register command");
+				break;
+			}
 
-			if (register_address == ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET)
-				gv_fake_camera->priv->controller_time = g_get_real_time ();
+			for (i = 0; i < n_registers; i++) {
+				register_address = arv_gvcp_packet_get_read_registers_cmd_address (packet, i);
+				arv_fake_camera_read_register (gv_fake_camera->priv->camera, register_address,
+							       &register_values[i]);
+				arv_info_device ("[GvFakeCamera::handle_control_packet] Read register command %d -> %d",
+						 register_address, register_values[i]);
 
+				if (register_address == ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET)
+					gv_fake_camera->priv->controller_time = g_get_real_time ();
+			}
+
+			ack_packet = arv_gvcp_packet_new_read_registers_ack (n_registers, register_values, packet_id,
+									     &ack_packet_size);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			arv_gvcp_packet_get_write_register_cmd_infos (packet, &register_address, &register_value);
 			if (!write_access) {
+				arv_gvcp_packet_get_write_register_cmd_infos (packet, &register_address, &register_value);
 				arv_warning_device("[GvFakeCamera::handle_control_packet] Ignore Write register command %d (%d) not controller",
 					register_address, register_value);
 				break;
 			}
 
-			arv_fake_camera_write_register (gv_fake_camera->priv->camera, register_address, register_value);
-			arv_info_device ("[GvFakeCamera::handle_control_packet] Write register command %d -> %d",
-					  register_address, register_value);
-			ack_packet = arv_gvcp_packet_new_write_register_ack (1, packet_id,
+			n_registers = arv_gvcp_packet_get_write_registers_cmd_n_registers (packet);
+
+			for (i = 0; i < n_registers; i++) {
+				arv_gvcp_packet_get_write_registers_cmd_infos (packet, i, &register_address, &register_value);
+				arv_fake_camera_write_register (gv_fake_camera->priv->camera, register_address, register_value);
+				arv_info_device ("[GvFakeCamera::handle_control_packet] Write register command %d -> %d",
+						 register_address, register_value);
+			}
+
+			ack_packet = arv_gvcp_packet_new_write_register_ack (n_registers, packet_id,
 									     &ack_packet_size);
 			break;
 		default:
@@ -216,7 +451,8 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 	}
 
 	if (ack_packet != NULL) {
-		g_socket_send_to (socket, remote_address, (char *) ack_packet, ack_packet_size, NULL, NULL);
+		_send_packet (gv_fake_camera->priv, &gv_fake_camera->priv->gvcp_impairment,
+			      socket, remote_address, ack_packet, ack_packet_size, NULL);
 		arv_gvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_DEBUG);
 		g_free (ack_packet);
 
@@ -241,196 +477,485 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 	return success;
 }
 
-static void *
-_thread (void *user_data)
+static gboolean
+_is_packet_lost (ArvGvFakeCameraPrivate *priv)
 {
-	ArvGvFakeCamera *gv_fake_camera = user_data;
-	ArvBuffer *image_buffer = NULL;
-	GError *error = NULL;
-	GSocketAddress *stream_address = NULL;
-	void *packet_buffer;
-	size_t packet_size;
-	size_t payload = 0;
-	guint16 block_id;
-	ptrdiff_t offset;
-	guint32 gv_packet_size;
-	GInputVector input_vector;
-	int n_events;
-	gboolean is_streaming = FALSE;
+	if (priv->gvsp_lost_packet_ratio <= 0.0)
+		return FALSE;
 
-	input_vector.buffer = g_malloc0 (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
-	input_vector.size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	priv->lost_packet_index = (priv->lost_packet_index + 1) % ARV_GV_FAKE_CAMERA_LOST_PACKET_PATTERN_SIZE;
 
-	packet_buffer = g_malloc (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	return priv->lost_packet_pattern[priv->lost_packet_index] != 0;
+}
 
-	do {
-		guint64 next_timestamp_us;
+static void
+_update_lost_packet_pattern (ArvGvFakeCameraPrivate *priv)
+{
+	guint i;
+
+	for (i = 0; i < ARV_GV_FAKE_CAMERA_LOST_PACKET_PATTERN_SIZE; i++)
+		priv->lost_packet_pattern[i] = g_random_double () < priv->gvsp_lost_packet_ratio;
+}
+
+/* The data blocks are sent without copy, using an I/O vector for the packet header and another one pointing to the
+ * data in the image buffer. */
+
+struct _ArvGvFakeCameraSender {
+	guint8 *headers;
+	GOutputVector *vectors;
+#if ARV_GV_FAKE_CAMERA_HAS_SENDMMSG
+	struct mmsghdr msgs[ARV_GV_FAKE_CAMERA_N_MESSAGES];
+	struct sockaddr_storage address;
+	int gso_size;
+	gboolean is_gso_disabled;
+#endif
+};
+
+#if ARV_GV_FAKE_CAMERA_HAS_SENDMMSG
+/* GOutputVector has the same layout as struct iovec, which allows to pass the vectors to sendmmsg */
+G_STATIC_ASSERT (sizeof (GOutputVector) == sizeof (struct iovec));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (GOutputVector, buffer) == G_STRUCT_OFFSET (struct iovec, iov_base));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (GOutputVector, size) == G_STRUCT_OFFSET (struct iovec, iov_len));
+#endif
+
+static ArvGvFakeCameraSender *
+_sender_new (void)
+{
+	ArvGvFakeCameraSender *sender;
 
-		if (is_streaming) {
-			arv_fake_camera_get_sleep_time_for_next_frame (gv_fake_camera->priv->camera, &next_timestamp_us);
+	sender = g_new0 (ArvGvFakeCameraSender, 1);
+	sender->headers = g_malloc0 (ARV_GV_FAKE_CAMERA_N_MESSAGES * ARV_GV_FAKE_CAMERA_N_SEGMENTS_MAX *
+				     ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE);
+	sender->vectors = g_new0 (GOutputVector, ARV_GV_FAKE_CAMERA_N_MESSAGES * ARV_GV_FAKE_CAMERA_N_SEGMENTS_MAX * 2);
+
+	return sender;
+}
+
+static void
+_sender_free (ArvGvFakeCameraSender *sender)
+{
+	g_free (sender->headers);
+	g_free (sender->vectors);
+	g_free (sender);
+}
+
+#if ARV_GV_FAKE_CAMERA_HAS_SENDMMSG
+
+/* Consecutive blocks of the same size are sent as a single message, segmented by the kernel or the network interface
+ * using UDP_SEGMENT. The messages are sent in batches by sendmmsg. */
+
+static guint32
+_send_data_blocks (ArvGvFakeCamera *gv_fake_camera, ArvGvFakeCameraSender *sender, GSocketAddress *stream_address,
+		   guint64 frame_id, guint32 block_id, const char *data, size_t payload, size_t data_size_max)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	socklen_t address_size;
+	int fd = g_socket_get_fd (priv->gvsp_socket);
+	size_t offset = 0;
+	guint n_segments_max = 1;
+	int gso_size = 0;
+
+	address_size = g_socket_address_get_native_size (stream_address);
+	if (!g_socket_address_to_native (stream_address, &sender->address, sizeof (sender->address), NULL))
+		return block_id;
+
+	/* The leader and trailer packets must not be segmented */
+	if (!sender->is_gso_disabled && data_size_max >= sizeof (ArvGvspDataLeader)) {
+		n_segments_max = CLAMP (ARV_GV_FAKE_CAMERA_GSO_SIZE_MAX /
+					(ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE + data_size_max),
+					1, ARV_GV_FAKE_CAMERA_N_SEGMENTS_MAX);
+		if (n_segments_max > 1)
+			gso_size = ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE + data_size_max;
+	}
+
+	if (gso_size != sender->gso_size) {
+		if (setsockopt (fd, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof (gso_size)) == 0) {
+			arv_info_stream_thread ("[GvFakeCamera::send_data_blocks] UDP segment size = %d", gso_size);
+			sender->gso_size = gso_size;
 		} else {
-			next_timestamp_us = g_get_real_time () + 100000;
+			arv_info_stream_thread ("[GvFakeCamera::send_data_blocks] UDP segmentation offload not available");
+			sender->is_gso_disabled = TRUE;
+			n_segments_max = 1;
 		}
+	}
 
-		do {
-			gint timeout_ms;
+	while (offset < payload) {
+		guint n_msgs = 0;
+		guint n_vectors = 0;
+		guint n_sent = 0;
 
-			timeout_ms =  (next_timestamp_us - g_get_real_time ()) / 1000LL;
-			if (timeout_ms < 0)
-				timeout_ms = 0;
-			else if (timeout_ms > 100)
-				timeout_ms = 100;
+		while (n_msgs < ARV_GV_FAKE_CAMERA_N_MESSAGES && offset < payload) {
+			struct msghdr *msg = &sender->msgs[n_msgs].msg_hdr;
+			guint first_vector = n_vectors;
+			guint n_segments = 0;
 
-			n_events = g_poll (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds, timeout_ms);
-			if (n_events > 0) {
-				unsigned int i;
+			while (n_segments < n_segments_max && offset < payload) {
+				size_t data_size = MIN (data_size_max, payload - offset);
+				size_t header_size = ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE;
 
-				for (i = 0; i < ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS; i++) {
-					GSocket *socket = gv_fake_camera->priv->input_sockets[i];
-					int count;
+				if (_is_packet_lost (priv)) {
+					arv_info_stream_thread ("Drop GVSP data packet frame:%" G_GUINT64_FORMAT
+								", block:%u", frame_id, block_id);
+					offset += data_size;
+					block_id++;
+					/* A message can't have holes in the segment sequence */
+					if (n_segments > 0)
+						break;
+					continue;
+				}
 
-					if (G_IS_SOCKET (socket)) {
-						GSocketAddress *remote_address = NULL;
+				sender->vectors[n_vectors].buffer = sender->headers + (n_vectors / 2) * header_size;
+				sender->vectors[n_vectors].size = header_size;
+				arv_gvsp_packet_new_data_block_header (frame_id, block_id,
+								       (void *) sender->vectors[n_vectors].buffer,
+								       &header_size);
+				sender->vectors[n_vectors + 1].buffer = data + offset;
+				sender->vectors[n_vectors + 1].size = data_size;
+				n_vectors += 2;
 
-						arv_gpollfd_clear_one (&gv_fake_camera->priv->socket_fds[i], socket);
+				offset += data_size;
+				block_id++;
+				n_segments++;
 
-						count = g_socket_receive_message (socket, &remote_address, &input_vector, 1, NULL, NULL,
-										  NULL, NULL, NULL);
-						if (count > 0) {
-							if (_handle_control_packet (gv_fake_camera, socket,
-										    remote_address, input_vector.buffer, count))
-								arv_info_device ("[GvFakeCamera::thread] Control packet received");
-						}
-						g_clear_object (&remote_address);
-					}
-				}
+				/* Only the last segment may be shorter */
+				if (data_size < data_size_max)
+					break;
+			}
 
-				if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) == 0 ||
-				    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) == 0) {
-					if (stream_address != NULL) {
-						g_object_unref (stream_address);
-						stream_address = NULL;
-						g_object_unref (image_buffer);
-						image_buffer = NULL;
-						arv_info_stream_thread ("[GvFakeCamera::thread] Stop stream");
-					}
-					is_streaming = FALSE;
-				}
+			if (n_segments == 0)
+				continue;
+
+			memset (msg, 0, sizeof (*msg));
+			msg->msg_name = &sender->address;
+			msg->msg_namelen = address_size;
+			msg->msg_iov = (struct iovec *) &sender->vectors[first_vector];
+			msg->msg_iovlen = n_vectors - first_vector;
+			n_msgs++;
+		}
+
+		while (n_sent < n_msgs) {
+			int result;
+
+			result = sendmmsg (fd, &sender->msgs[n_sent], n_msgs - n_sent, 0);
+			if (result < 0) {
+				if (errno == EINTR)
+					continue;
+
+				/* Segmentation offload is not supported by the route to the receiver */
+				if (errno == EIO && sender->gso_size != 0) {
+					int no_gso_size = 0;
+
+					arv_info_stream_thread ("[GvFakeCamera::send_data_blocks] "
+								"Disable UDP segmentation offload");
+					setsockopt (fd, SOL_UDP, UDP_SEGMENT, &no_gso_size, sizeof (no_gso_size));
+					sender->gso_size = 0;
+					sender->is_gso_disabled = TRUE;
+				} else
+					arv_info_stream_thread ("[GvFakeCamera::send_data_blocks] Failed to send frame"
+								" %" G_GUINT64_FORMAT " blocks: %s",
+								frame_id, strerror (errno));
+				break;
 			}
-		} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel) && g_get_real_time () < next_timestamp_us);
-
-		if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) != 0 &&
-		    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) != 0) {
-			if (stream_address == NULL) {
-				GInetAddress *inet_address;
-				char *inet_address_string;
-
-				stream_address = arv_fake_camera_get_stream_address (gv_fake_camera->priv->camera);
-				inet_address = g_inet_socket_address_get_address
-					(G_INET_SOCKET_ADDRESS (stream_address));
-				inet_address_string = g_inet_address_to_string (inet_address);
-				arv_info_stream_thread ("[GvFakeCamera::thread] Start stream to %s (%d)",
-							 inet_address_string,
-							 g_inet_socket_address_get_port
-							 (G_INET_SOCKET_ADDRESS (stream_address)));
-				g_free (inet_address_string);
-
-				payload = arv_fake_camera_get_payload (gv_fake_camera->priv->camera);
-				image_buffer = arv_buffer_new (payload, NULL);
+			n_sent += result;
+		}
+	}
+
+	return block_id;
+}
+
+#else
+
+static guint32
+_send_data_blocks (ArvGvFakeCamera *gv_fake_camera, ArvGvFakeCameraSender *sender, GSocketAddress *stream_address,
+		   guint64 frame_id, guint32 block_id, const char *data, size_t payload, size_t data_size_max)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	GError *error = NULL;
+	size_t offset = 0;
+
+	while (offset < payload) {
+		size_t data_size = MIN (data_size_max, payload - offset);
+		size_t header_size = ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE;
+
+		if (!_is_packet_lost (priv)) {
+			arv_gvsp_packet_new_data_block_header (frame_id, block_id, sender->headers, &header_size);
+
+			sender->vectors[0].buffer = sender->headers;
+			sender->vectors[0].size = header_size;
+			sender->vectors[1].buffer = data + offset;
+			sender->vectors[1].size = data_size;
+
+			g_socket_send_message (priv->gvsp_socket, stream_address, sender->vectors, 2,
+					       NULL, 0, 0, NULL, &error);
+			if (error != NULL) {
+				arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send frame block %d for frame"
+							" %" G_GUINT64_FORMAT ": %s",
+							block_id, frame_id, error->message);
+				g_clear_error (&error);
 			}
+		} else
+			arv_info_stream_thread ("Drop GVSP data packet frame:%" G_GUINT64_FORMAT
+						", block:%u", frame_id, block_id);
 
-			if (arv_fake_camera_is_in_free_running_mode (gv_fake_camera->priv->camera) ||
-			    (arv_fake_camera_is_in_software_trigger_mode (gv_fake_camera->priv->camera) &&
-			     arv_fake_camera_check_and_acknowledge_software_trigger (gv_fake_camera->priv->camera))) {
-				arv_fake_camera_fill_buffer (gv_fake_camera->priv->camera, image_buffer, &gv_packet_size);
-
-				arv_info_stream_thread ("[GvFakeCamera::thread] Send frame %" G_GUINT64_FORMAT, image_buffer->priv->frame_id);
-
-				block_id = 0;
-
-				packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-				arv_gvsp_packet_new_data_leader (image_buffer->priv->frame_id,
-								block_id,
-								image_buffer->priv->timestamp_ns,
-								image_buffer->priv->pixel_format,
-								image_buffer->priv->width, image_buffer->priv->height,
-								image_buffer->priv->x_offset, image_buffer->priv->y_offset,
-								packet_buffer, &packet_size);
-
-				if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-					g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-							packet_buffer, packet_size, NULL, &error);
-				else
-					arv_info_stream_thread ("Drop GVSP leader packet frame: %" G_GUINT64_FORMAT, image_buffer->priv->frame_id);
-
-				if (error != NULL) {
-					arv_warning_stream_thread ("[GvFakeCamera::thread] Failed to send leader for frame %" G_GUINT64_FORMAT
-								": %s", image_buffer->priv->frame_id, error->message);
-					g_clear_error (&error);
-				}
+		offset += data_size;
+		block_id++;
+	}
 
-				block_id++;
+	return block_id;
+}
 
-				offset = 0;
-				while (offset < payload) {
-					size_t data_size;
+#endif
 
-					data_size = MIN (gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD,
-							payload - offset);
+/* Data blocks sent one by one through the network simulation, copied to the packet buffer */
 
-					packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-					arv_gvsp_packet_new_data_block (image_buffer->priv->frame_id, block_id,
-									data_size, ((char *) image_buffer->priv->data) + offset,
-									packet_buffer, &packet_size);
+static guint32
+_send_impaired_data_blocks (ArvGvFakeCamera *gv_fake_camera, GSocketAddress *stream_address,
+			    guint64 frame_id, guint32 block_id, const char *data, size_t payload, size_t data_size_max)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	guint8 *packet = priv->packet_buffer;
+	GError *error = NULL;
+	size_t offset = 0;
 
-					if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-						g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-								packet_buffer, packet_size, NULL, &error);
-					else
-						arv_info_stream_thread ("Drop GVSP data packet frame:%" G_GUINT64_FORMAT
-									", block:%u", image_buffer->priv->frame_id, block_id);
+	data_size_max = MIN (data_size_max, ARV_GV_FAKE_CAMERA_BUFFER_SIZE - ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE);
 
-					if (error != NULL) {
-						arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send frame block %d for frame"
-									" %" G_GUINT64_FORMAT ": %s",
-									block_id, image_buffer->priv->frame_id, error->message);
-						g_clear_error (&error);
-					}
+	while (offset < payload) {
+		size_t data_size = MIN (data_size_max, payload - offset);
+		size_t header_size = ARV_GV_FAKE_CAMERA_BLOCK_HEADER_SIZE;
 
-					offset += data_size;
-					block_id++;
-				}
+		if (!_is_packet_lost (priv)) {
+			arv_gvsp_packet_new_data_block_header (frame_id, block_id, packet, &header_size);
+			memcpy (packet + header_size, data + offset, data_size);
 
-				packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-				arv_gvsp_packet_new_data_trailer (image_buffer->priv->frame_id, block_id,
-								packet_buffer, &packet_size);
-
-				if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-					g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-							packet_buffer, packet_size, NULL, &error);
-				else
-					arv_info_stream_thread ("Drop GVSP trailer packet frame: %" G_GUINT64_FORMAT,
-								image_buffer->priv->frame_id);
-
-				if (error != NULL) {
-					arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send trailer for frame %" G_GUINT64_FORMAT
-								": %s", image_buffer->priv->frame_id, error->message);
-					g_clear_error (&error);
-				}
+			_send_packet (priv, &priv->gvsp_impairment, priv->gvsp_socket, stream_address,
+				      packet, header_size + data_size, &error);
+			if (error != NULL) {
+				arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send frame block %d for frame"
+							" %" G_GUINT64_FORMAT ": %s",
+							block_id, frame_id, error->message);
+				g_clear_error (&error);
+			}
+		} else
+			arv_info_stream_thread ("Drop GVSP data packet frame:%" G_GUINT64_FORMAT
+						", block:%u", frame_id, block_id);
 
-				is_streaming = TRUE;
+		offset += data_size;
+		block_id++;
+	}
+
+	return block_id;
+}
+
+/* Handles the pending control packets, and stops the stream when the acquisition is stopped or the control is lost */
+
+static void
+_process_input (ArvGvFakeCamera *gv_fake_camera)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	unsigned int i;
+
+	for (i = 0; i < ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS; i++) {
+		GSocket *socket = priv->input_sockets[i];
+		int count;
+
+		if (G_IS_SOCKET (socket)) {
+			GSocketAddress *remote_address = NULL;
+
+			arv_gpollfd_clear_one (&priv->socket_fds[i], socket);
+
+			count = g_socket_receive_message (socket, &remote_address, &priv->input_vector, 1, NULL, NULL,
+							  NULL, NULL, NULL);
+			if (count > 0) {
+				if (_handle_control_packet (gv_fake_camera, socket,
+							    remote_address, priv->input_vector.buffer, count))
+					arv_info_device ("[GvFakeCamera::thread] Control packet received");
 			}
+			g_clear_object (&remote_address);
 		}
+	}
+
+	if (arv_fake_camera_get_control_channel_privilege (priv->camera) == 0 ||
+	    arv_fake_camera_get_acquisition_status (priv->camera) == 0) {
+		if (priv->stream_address != NULL) {
+			g_clear_object (&priv->stream_address);
+			g_clear_object (&priv->image_buffer);
+			arv_info_stream_thread ("[GvFakeCamera::thread] Stop stream");
+		}
+		priv->is_streaming = FALSE;
+	}
+}
+
+/* Time of the next frame, or of the next acquisition status check when not streaming.  The frames of the cameras
+ * of a farm are spread over the frame period. */
+
+static gint64
+_get_next_frame_time (ArvGvFakeCamera *gv_fake_camera)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	guint64 next_timestamp_us;
+	guint32 trigger_mode = 0;
+	guint32 period_us = 0;
+	gint64 phase_us;
+
+	if (!priv->is_streaming)
+		return g_get_real_time () + 100000;
+
+	arv_fake_camera_get_sleep_time_for_next_frame (priv->camera, &next_timestamp_us);
 
-	} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel));
+	if (priv->farm_size <= 1)
+		return next_timestamp_us;
 
-	if (stream_address != NULL)
-		g_object_unref (stream_address);
-	if (image_buffer != NULL)
-		g_object_unref (image_buffer);
+	arv_fake_camera_read_register (priv->camera, ARV_FAKE_CAMERA_REGISTER_TRIGGER_MODE, &trigger_mode);
+	arv_fake_camera_read_register (priv->camera, ARV_FAKE_CAMERA_REGISTER_ACQUISITION_FRAME_PERIOD_US, &period_us);
+	if (trigger_mode != 0 || period_us == 0)
+		return next_timestamp_us;
 
-	g_free (packet_buffer);
-	g_free (input_vector.buffer);
+	phase_us = (gint64) period_us * priv->farm_index / priv->farm_size;
+	if ((gint64) next_timestamp_us + phase_us - period_us > g_get_real_time ())
+		return next_timestamp_us + phase_us - period_us;
+
+	return next_timestamp_us + phase_us;
+}
+
+/* Sends a frame if the acquisition is running, and if the camera is free running or was triggered */
+
+static void
+_send_frame (ArvGvFakeCamera *gv_fake_camera)
+{
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+	GError *error = NULL;
+	size_t packet_size;
+	guint32 block_id;
+	guint32 gv_packet_size;
+	ArvBuffer *frame;
+	size_t frame_size;
+
+	if (arv_fake_camera_get_control_channel_privilege (priv->camera) == 0 ||
+	    arv_fake_camera_get_acquisition_status (priv->camera) == 0)
+		return;
+
+	if (priv->stream_address == NULL) {
+		GInetAddress *inet_address;
+		char *inet_address_string;
+
+		priv->stream_address = arv_fake_camera_get_stream_address (priv->camera);
+		inet_address = g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (priv->stream_address));
+		inet_address_string = g_inet_address_to_string (inet_address);
+		arv_info_stream_thread ("[GvFakeCamera::thread] Start stream to %s (%d)",
+					inet_address_string,
+					g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (priv->stream_address)));
+		g_free (inet_address_string);
+
+		priv->payload = arv_fake_camera_get_payload (priv->camera);
+		priv->image_buffer = arv_buffer_new (priv->payload, NULL);
+	}
+
+	if (!arv_fake_camera_is_in_free_running_mode (priv->camera) &&
+	    !(arv_fake_camera_is_in_software_trigger_mode (priv->camera) &&
+	      arv_fake_camera_check_and_acknowledge_software_trigger (priv->camera)))
+		return;
+
+	/* The frames of a frame bank are sent without copy */
+	frame = arv_fake_camera_get_bank_frame (priv->camera, &gv_packet_size);
+	if (frame != NULL) {
+		frame_size = frame->priv->received_size;
+	} else {
+		arv_fake_camera_fill_buffer (priv->camera, priv->image_buffer, &gv_packet_size);
+		frame = g_object_ref (priv->image_buffer);
+		frame_size = priv->payload;
+	}
+
+	arv_info_stream_thread ("[GvFakeCamera::thread] Send frame %" G_GUINT64_FORMAT,
+				frame->priv->frame_id);
+
+	block_id = 0;
+
+	packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	arv_gvsp_packet_new_data_leader (frame->priv->frame_id,
+					 block_id,
+					 frame->priv->timestamp_ns,
+					 frame->priv->pixel_format,
+					 frame->priv->width, frame->priv->height,
+					 frame->priv->x_offset, frame->priv->y_offset,
+					 priv->packet_buffer, &packet_size);
+
+	if (!_is_packet_lost (priv))
+		_send_packet (priv, &priv->gvsp_impairment, priv->gvsp_socket, priv->stream_address,
+			      priv->packet_buffer, packet_size, &error);
+	else
+		arv_info_stream_thread ("Drop GVSP leader packet frame: %" G_GUINT64_FORMAT,
+					frame->priv->frame_id);
+
+	if (error != NULL) {
+		arv_warning_stream_thread ("[GvFakeCamera::thread] Failed to send leader for frame %" G_GUINT64_FORMAT
+					   ": %s", frame->priv->frame_id, error->message);
+		g_clear_error (&error);
+	}
+
+	block_id++;
+
+	if (_is_impaired (&priv->gvsp_impairment))
+		block_id = _send_impaired_data_blocks (gv_fake_camera, priv->stream_address,
+						       frame->priv->frame_id, block_id,
+						       (const char *) frame->priv->data, frame_size,
+						       gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+	else
+		block_id = _send_data_blocks (gv_fake_camera, priv->sender, priv->stream_address,
+					      frame->priv->frame_id, block_id,
+					      (const char *) frame->priv->data, frame_size,
+					      gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	arv_gvsp_packet_new_data_trailer (frame->priv->frame_id, block_id,
+					  priv->packet_buffer, &packet_size);
+
+	if (!_is_packet_lost (priv))
+		_send_packet (priv, &priv->gvsp_impairment, priv->gvsp_socket, priv->stream_address,
+			      priv->packet_buffer, packet_size, &error);
+	else
+		arv_info_stream_thread ("Drop GVSP trailer packet frame: %" G_GUINT64_FORMAT,
+					frame->priv->frame_id);
+
+	if (error != NULL) {
+		arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send trailer for frame %" G_GUINT64_FORMAT
+					": %s", frame->priv->frame_id, error->message);
+		g_clear_error (&error);
+	}
+
+	g_object_unref (frame);
+
+	priv->is_streaming = TRUE;
+}
+
+static void *
+_thread (void *user_data)
+{
+	ArvGvFakeCamera *gv_fake_camera = user_data;
+	ArvGvFakeCameraPrivate *priv = gv_fake_camera->priv;
+
+	do {
+		gint64 next_timestamp_us;
+
+		next_timestamp_us = _get_next_frame_time (gv_fake_camera);
+
+		do {
+			gint timeout_ms;
+
+			timeout_ms =  (MIN (next_timestamp_us, _get_next_delayed_packet_time (priv)) -
+				       g_get_real_time ()) / 1000LL;
+			if (timeout_ms < 0)
+				timeout_ms = 0;
+			else if (timeout_ms > 100)
+				timeout_ms = 100;
+
+			if (g_poll (priv->socket_fds, priv->n_socket_fds, timeout_ms) > 0)
+				_process_input (gv_fake_camera);
+
+			_send_delayed_packets (priv);
+		} while (!g_atomic_int_get (&priv->cancel) && g_get_real_time () < next_timestamp_us);
+
+		_send_frame (gv_fake_camera);
+	} while (!g_atomic_int_get (&priv->cancel));
 
 	return NULL;
 }
@@ -555,8 +1080,14 @@ arv_gv_fake_camera_start (ArvGvFakeCamera *gv_fake_camera)
 
 	arv_gpollfd_prepare_all (gv_fake_camera->priv->socket_fds, n_socket_fds);
 
+	gv_fake_camera->priv->input_vector.buffer = g_malloc0 (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	gv_fake_camera->priv->input_vector.size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	gv_fake_camera->priv->packet_buffer = g_malloc (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	gv_fake_camera->priv->sender = _sender_new ();
+
 	gv_fake_camera->priv->cancel = FALSE;
-	gv_fake_camera->priv->thread = g_thread_new ("arv_fake_gv_fake_camera", _thread, gv_fake_camera);
+	if (gv_fake_camera->priv->is_standalone)
+		gv_fake_camera->priv->thread = g_thread_new ("arv_fake_gv_fake_camera", _thread, gv_fake_camera);
 
 	return TRUE;
 }
@@ -578,12 +1109,22 @@ arv_gv_fake_camera_stop (ArvGvFakeCamera *gv_fake_camera)
 
 	arv_gpollfd_finish_all (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds);
 
+	g_clear_object (&gv_fake_camera->priv->stream_address);
+	g_clear_object (&gv_fake_camera->priv->image_buffer);
+	g_clear_pointer (&gv_fake_camera->priv->sender, _sender_free);
+	g_clear_pointer (&gv_fake_camera->priv->packet_buffer, g_free);
+	g_clear_pointer (&gv_fake_camera->priv->input_vector.buffer, g_free);
+	gv_fake_camera->priv->is_streaming = FALSE;
+
 	for (i = 0; i < ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS; i++) {
 		g_clear_object (&gv_fake_camera->priv->input_sockets[i]);
 	}
 	g_clear_object (&gv_fake_camera->priv->gvsp_socket);
 
 	g_clear_object (&gv_fake_camera->priv->controller_address);
+
+	g_queue_foreach (&gv_fake_camera->priv->delayed_packets, (GFunc) _delayed_packet_free, NULL);
+	g_queue_clear (&gv_fake_camera->priv->delayed_packets);
 }
 
 /**
@@ -625,6 +1166,12 @@ arv_gv_fake_camera_new (const char *interface_name, const char *serial_number)
 	return arv_gv_fake_camera_new_full (interface_name, serial_number, NULL);
 }
 
+static ArvGvFakeCameraImpairment *
+_get_impairment (ArvGvFakeCameraPrivate *priv, guint prop_id)
+{
+	return prop_id >= PROP_GVSP_LATENCY ? &priv->gvsp_impairment : &priv->gvcp_impairment;
+}
+
 static void
 _set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
 {
@@ -646,6 +1193,38 @@ _set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *
 			break;
 		case PROP_GVSP_LOST_PACKET_RATIO:
 			gv_fake_camera->priv->gvsp_lost_packet_ratio = g_value_get_double (value);
+			_update_lost_packet_pattern (gv_fake_camera->priv);
+			break;
+		case PROP_STANDALONE:
+			gv_fake_camera->priv->is_standalone = g_value_get_boolean (value);
+			break;
+		case PROP_GVCP_LATENCY:
+		case PROP_GVSP_LATENCY:
+			_get_impairment (gv_fake_camera->priv, prop_id)->latency_us = g_value_get_uint (value);
+			break;
+		case PROP_GVCP_JITTER:
+		case PROP_GVSP_JITTER:
+			_get_impairment (gv_fake_camera->priv, prop_id)->jitter_us = g_value_get_uint (value);
+			break;
+		case PROP_GVCP_REORDER_RATIO:
+		case PROP_GVSP_REORDER_RATIO:
+			_get_impairment (gv_fake_camera->priv, prop_id)->reorder_ratio = g_value_get_double (value);
+			break;
+		case PROP_GVCP_DUPLICATE_RATIO:
+		case PROP_GVSP_DUPLICATE_RATIO:
+			_get_impairment (gv_fake_camera->priv, prop_id)->duplicate_ratio = g_value_get_double (value);
+			break;
+		case PROP_GVCP_BURST_LOSS_RATIO:
+		case PROP_GVSP_BURST_LOSS_RATIO:
+			_get_impairment (gv_fake_camera->priv, prop_id)->burst_loss_ratio = g_value_get_double (value);
+			break;
+		case PROP_GVCP_BURST_LENGTH:
+		case PROP_GVSP_BURST_LENGTH:
+			_get_impairment (gv_fake_camera->priv, prop_id)->burst_length = g_value_get_uint (value);
+			break;
+		case PROP_IMPAIRMENT_SEED:
+			if (g_value_get_uint (value) != 0)
+				g_rand_set_seed (gv_fake_camera->priv->impairment_rand, g_value_get_uint (value));
 			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -693,6 +1272,8 @@ static void
 arv_gv_fake_camera_init (ArvGvFakeCamera *gv_fake_camera)
 {
 	gv_fake_camera->priv = arv_gv_fake_camera_get_instance_private (gv_fake_camera);
+	gv_fake_camera->priv->impairment_rand = g_rand_new ();
+	g_queue_init (&gv_fake_camera->priv->delayed_packets);
 }
 
 static void
@@ -720,10 +1301,44 @@ _finalize (GObject *object)
 	g_clear_pointer (&gv_fake_camera->priv->interface_name, g_free);
 	g_clear_pointer (&gv_fake_camera->priv->serial_number, g_free);
 	g_clear_pointer (&gv_fake_camera->priv->genicam_filename, g_free);
+	g_clear_pointer (&gv_fake_camera->priv->impairment_rand, g_rand_free);
 
 	G_OBJECT_CLASS (arv_gv_fake_camera_parent_class)->finalize (object);
 }
 
+static void
+_install_impairment_properties (GObjectClass *object_class, guint first_prop_id, const char *prefix)
+{
+	const struct {
+		const char *name;
+		const char *nick;
+		gboolean is_ratio;
+		guint maximum;
+	} properties[] = {
+		{ "latency",		"latency (µs)",			FALSE,	10000000 },
+		{ "jitter",		"jitter (µs)",			FALSE,	10000000 },
+		{ "reorder-ratio",	"reordered packet ratio",	TRUE,	0 },
+		{ "duplicate-ratio",	"duplicated packet ratio",	TRUE,	0 },
+		{ "burst-loss-ratio",	"loss burst start ratio",	TRUE,	0 },
+		{ "burst-length",	"packets lost per burst",	FALSE,	G_MAXUINT16 }
+	};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (properties); i++) {
+		char *name = g_strdup_printf ("%s-%s", prefix, properties[i].name);
+		char *nick = g_strdup_printf ("%s %s", prefix, properties[i].nick);
+
+		g_object_class_install_property
+			(object_class, first_prop_id + i,
+			 properties[i].is_ratio ?
+			 g_param_spec_double (name, nick, nick, 0.0, 1.0, 0.0, G_PARAM_WRITABLE) :
+			 g_param_spec_uint (name, nick, nick, 0, properties[i].maximum, 0, G_PARAM_WRITABLE));
+
+		g_free (name);
+		g_free (nick);
+	}
+}
+
 static void
 arv_gv_fake_camera_class_init (ArvGvFakeCameraClass *this_class)
 {
@@ -769,4 +1384,313 @@ arv_gv_fake_camera_class_init (ArvGvFakeCameraClass *this_class)
 							      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
 							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
 							      G_PARAM_STATIC_BLURB));
+	/* A camera which is not standalone has no thread, and is driven by a #ArvGvFakeCameraFarm */
+	g_object_class_install_property (object_class,
+					 PROP_STANDALONE,
+					 g_param_spec_boolean ("standalone",
+							       "Standalone",
+							       "Camera with its own thread",
+							       TRUE,
+							       G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
+	/* Network impairments of the GVCP acknowledges and of the GVSP packets. The loss bursts start with a
+	 * probability of burst-loss-ratio per packet, and drop burst-length packets. The packets are delayed by the
+	 * latency plus a random jitter, the reordered ones being held back 1 ms further. */
+	_install_impairment_properties (object_class, PROP_GVCP_LATENCY, "gvcp");
+	_install_impairment_properties (object_class, PROP_GVSP_LATENCY, "gvsp");
+	/* Seed of the impairment simulations, for reproducible runs, 0 for a random seed */
+	g_object_class_install_property (object_class,
+					 PROP_IMPAIRMENT_SEED,
+					 g_param_spec_uint ("impairment-seed",
+							    "Impairment seed",
+							    "Random seed of the network impairments",
+							    0, G_MAXUINT, 0,
+							    G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+}
+
+/* ArvGvFakeCameraFarm implementation */
+
+typedef struct {
+	ArvGvFakeCameraFarm *farm;
+	guint first_camera;
+	GThread *thread;
+} ArvGvFakeCameraFarmThread;
+
+struct _ArvGvFakeCameraFarm {
+	GObject object;
+
+	ArvGvFakeCamera **cameras;
+	guint n_cameras;
+
+	ArvGvFakeCameraFarmThread *threads;
+	guint n_threads;
+
+	gboolean cancel;
+};
+
+struct _ArvGvFakeCameraFarmClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (ArvGvFakeCameraFarm, arv_gv_fake_camera_farm, G_TYPE_OBJECT)
+
+/* Each thread drives the cameras first_camera, first_camera + n_threads, ..., using a single poll call for all the
+ * control sockets of its cameras, and the earliest frame deadline as the poll timeout. */
+
+static void *
+_farm_thread (void *user_data)
+{
+	ArvGvFakeCameraFarmThread *thread = user_data;
+	ArvGvFakeCameraFarm *farm = thread->farm;
+	ArvGvFakeCamera **cameras;
+	GPollFD *fds;
+	gint64 *next_timestamps_us;
+	guint *first_fds;
+	guint n_cameras;
+	guint i;
+
+	n_cameras = (farm->n_cameras - thread->first_camera + farm->n_threads - 1) / farm->n_threads;
+
+	cameras = g_new (ArvGvFakeCamera *, n_cameras);
+	fds = g_new0 (GPollFD, n_cameras * ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS);
+	next_timestamps_us = g_new (gint64, n_cameras);
+	first_fds = g_new (guint, n_cameras + 1);
+
+	first_fds[0] = 0;
+	for (i = 0; i < n_cameras; i++) {
+		cameras[i] = farm->cameras[thread->first_camera + i * farm->n_threads];
+		first_fds[i + 1] = first_fds[i] + cameras[i]->priv->n_socket_fds;
+		next_timestamps_us[i] = _get_next_frame_time (cameras[i]);
+	}
+
+	do {
+		gint64 next_timestamp_us = G_MAXINT64;
+		gint64 now_us;
+		gint timeout_ms;
+
+		for (i = 0; i < n_cameras; i++) {
+			ArvGvFakeCameraPrivate *priv = cameras[i]->priv;
+			guint j;
+
+			for (j = 0; j < priv->n_socket_fds; j++) {
+				fds[first_fds[i] + j] = priv->socket_fds[j];
+				fds[first_fds[i] + j].revents = 0;
+			}
+
+			next_timestamp_us = MIN (next_timestamp_us, next_timestamps_us[i]);
+			next_timestamp_us = MIN (next_timestamp_us, _get_next_delayed_packet_time (priv));
+		}
+
+		timeout_ms = (next_timestamp_us - g_get_real_time ()) / 1000LL;
+		if (timeout_ms < 0)
+			timeout_ms = 0;
+		else if (timeout_ms > 100)
+			timeout_ms = 100;
+
+		if (g_poll (fds, first_fds[n_cameras], timeout_ms) > 0) {
+			for (i = 0; i < n_cameras; i++) {
+				ArvGvFakeCameraPrivate *priv = cameras[i]->priv;
+				gboolean has_events = FALSE;
+				guint j;
+
+				for (j = 0; j < priv->n_socket_fds; j++) {
+					priv->socket_fds[j].revents = fds[first_fds[i] + j].revents;
+					has_events = has_events || priv->socket_fds[j].revents != 0;
+				}
+
+				if (has_events)
+					_process_input (cameras[i]);
+			}
+		}
+
+		now_us = g_get_real_time ();
+		for (i = 0; i < n_cameras; i++) {
+			_send_delayed_packets (cameras[i]->priv);
+
+			if (now_us >= next_timestamps_us[i]) {
+				_send_frame (cameras[i]);
+				next_timestamps_us[i] = _get_next_frame_time (cameras[i]);
+			}
+		}
+	} while (!g_atomic_int_get (&farm->cancel));
+
+	g_free (cameras);
+	g_free (fds);
+	g_free (next_timestamps_us);
+	g_free (first_fds);
+
+	return NULL;
+}
+
+/**
+ * arv_gv_fake_camera_farm_new:
+ * @interface_address: (nullable): IPv4 address of the first camera, default is 127.0.0.1
+ * @serial_prefix: (nullable): serial number prefix, default is GV
+ * @n_cameras: number of cameras
+ * @n_threads: number of threads, 0 for one thread per 8 cameras
+ * @genicam_filename: (nullable): path to alternative genicam data
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates @n_cameras fake GigEVision cameras, driven by @n_threads threads. As the GVCP port is fixed, each camera
+ * listens on its own address: the camera of index i uses @interface_address + i, which must be an address of a local
+ * interface (e.g. an alias address added with `ip address add`, or an address of the 127.0.0.0/8 loopback network).
+ * The serial number of the camera of index i is @serial_prefix followed by i + 1 on two digits. The frames of the free
+ * running cameras are spread over the frame period.
+ *
+ * Returns: (transfer full): a new #ArvGvFakeCameraFarm, %NULL on error
+ *
+ * Since: 0.8.24
+ */
+
+ArvGvFakeCameraFarm *
+arv_gv_fake_camera_farm_new (const char *interface_address, const char *serial_prefix, guint n_cameras, guint n_threads,
+			     const char *genicam_filename, GError **error)
+{
+	ArvGvFakeCameraFarm *farm;
+	GInetAddress *inet_address;
+	guint32 base_address;
+	guint i;
+
+	g_return_val_if_fail (n_cameras > 0, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	if (interface_address == NULL)
+		interface_address = ARV_GV_FAKE_CAMERA_DEFAULT_INTERFACE;
+
+	inet_address = g_inet_address_new_from_string (interface_address);
+	if (inet_address == NULL || g_inet_address_get_family (inet_address) != G_SOCKET_FAMILY_IPV4) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+			     "Invalid IPv4 address '%s'", interface_address);
+		g_clear_object (&inet_address);
+		return NULL;
+	}
+
+	base_address = g_ntohl (*((guint32 *) g_inet_address_to_bytes (inet_address)));
+	g_clear_object (&inet_address);
+
+	if (n_threads == 0)
+		n_threads = (n_cameras + 7) / 8;
+	n_threads = MIN (n_threads, n_cameras);
+
+	farm = g_object_new (ARV_TYPE_GV_FAKE_CAMERA_FARM, NULL);
+	farm->n_cameras = n_cameras;
+	farm->cameras = g_new0 (ArvGvFakeCamera *, n_cameras);
+
+	for (i = 0; i < n_cameras; i++) {
+		guint32 be_address = g_htonl (base_address + i);
+		char *address_string;
+		char *serial_number;
+		gboolean is_running;
+
+		inet_address = g_inet_address_new_from_bytes ((guint8 *) &be_address, G_SOCKET_FAMILY_IPV4);
+		address_string = g_inet_address_to_string (inet_address);
+		serial_number = g_strdup_printf ("%s%02u", serial_prefix != NULL ? serial_prefix : "GV", i + 1);
+
+		farm->cameras[i] = g_object_new (ARV_TYPE_GV_FAKE_CAMERA,
+						 "interface-name", address_string,
+						 "serial-number", serial_number,
+						 "genicam-filename", genicam_filename,
+						 "standalone", FALSE,
+						 NULL);
+		farm->cameras[i]->priv->farm_index = i;
+		farm->cameras[i]->priv->farm_size = n_cameras;
+
+		is_running = arv_gv_fake_camera_is_running (farm->cameras[i]);
+		if (!is_running)
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+				     "Failed to start fake camera %s on %s", serial_number, address_string);
+
+		g_free (serial_number);
+		g_free (address_string);
+		g_clear_object (&inet_address);
+
+		if (!is_running) {
+			g_object_unref (farm);
+			return NULL;
+		}
+	}
+
+	farm->n_threads = n_threads;
+	farm->threads = g_new0 (ArvGvFakeCameraFarmThread, n_threads);
+	for (i = 0; i < n_threads; i++) {
+		farm->threads[i].farm = farm;
+		farm->threads[i].first_camera = i;
+		farm->threads[i].thread = g_thread_new ("arv_fake_gv_camera_farm", _farm_thread, &farm->threads[i]);
+	}
+
+	arv_info_device ("[GvFakeCameraFarm::new] %u cameras driven by %u threads", n_cameras, n_threads);
+
+	return farm;
+}
+
+/**
+ * arv_gv_fake_camera_farm_get_n_cameras:
+ * @farm: a #ArvGvFakeCameraFarm
+ *
+ * Returns: the number of cameras of @farm
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_gv_fake_camera_farm_get_n_cameras (ArvGvFakeCameraFarm *farm)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA_FARM (farm), 0);
+
+	return farm->n_cameras;
+}
+
+/**
+ * arv_gv_fake_camera_farm_get_camera:
+ * @farm: a #ArvGvFakeCameraFarm
+ * @index: camera index
+ *
+ * Returns: (transfer none): the camera of index @index, %NULL if @index is out of range
+ *
+ * Since: 0.8.24
+ */
+
+ArvGvFakeCamera *
+arv_gv_fake_camera_farm_get_camera (ArvGvFakeCameraFarm *farm, guint index)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA_FARM (farm), NULL);
+
+	if (index >= farm->n_cameras)
+		return NULL;
+
+	return farm->cameras[index];
+}
+
+static void
+arv_gv_fake_camera_farm_init (ArvGvFakeCameraFarm *farm)
+{
+}
+
+static void
+_farm_finalize (GObject *object)
+{
+	ArvGvFakeCameraFarm *farm = ARV_GV_FAKE_CAMERA_FARM (object);
+	guint i;
+
+	g_atomic_int_set (&farm->cancel, TRUE);
+	for (i = 0; i < farm->n_threads; i++)
+		g_thread_join (farm->threads[i].thread);
+	g_clear_pointer (&farm->threads, g_free);
+
+	for (i = 0; i < farm->n_cameras; i++)
+		g_clear_object (&farm->cameras[i]);
+	g_clear_pointer (&farm->cameras, g_free);
+
+	G_OBJECT_CLASS (arv_gv_fake_camera_farm_parent_class)->finalize (object);
+}
+
+static void
+arv_gv_fake_camera_farm_class_init (ArvGvFakeCameraFarmClass *this_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
+
+	object_class->finalize = _farm_finalize;
 }
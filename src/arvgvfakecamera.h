@@ -43,6 +43,15 @@ ARV_API ArvGvFakeCamera *		arv_gv_fake_camera_new_full		(const char *interface_n
 ARV_API gboolean			arv_gv_fake_camera_is_running		(ArvGvFakeCamera *gv_fake_camera);
 ARV_API ArvFakeCamera *			arv_gv_fake_camera_get_fake_camera	(ArvGvFakeCamera *gv_fake_camera);
 
+#define ARV_TYPE_GV_FAKE_CAMERA_FARM (arv_gv_fake_camera_farm_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvGvFakeCameraFarm, arv_gv_fake_camera_farm, ARV, GV_FAKE_CAMERA_FARM, GObject)
+
+ARV_API ArvGvFakeCameraFarm *		arv_gv_fake_camera_farm_new		(const char *interface_address, const char *serial_prefix,
+										 guint n_cameras, guint n_threads,
+										 const char *genicam_filename, GError **error);
+ARV_API guint				arv_gv_fake_camera_farm_get_n_cameras	(ArvGvFakeCameraFarm *farm);
+ARV_API ArvGvFakeCamera *		arv_gv_fake_camera_farm_get_camera	(ArvGvFakeCameraFarm *farm, guint index);
+
 G_END_DECLS
 
 #endif
@@ -324,6 +324,16 @@ arv_gv_interface_device_infos_unref (ArvGvInterfaceDeviceInfos *infos)
 
 typedef struct {
 	GHashTable *devices;
+	GMutex devices_mutex;	/* protects devices, which is only locked for lookups and swaps, and the
+				   discovery thread state */
+
+	GMutex discovery_mutex;	/* serializes the registry refreshes */
+
+	GThread *discovery_thread;
+	GCond discovery_cond;
+	guint discovery_interval_ms;
+	gboolean discovery_cancel;
+	gboolean discovery_triggered;
 } ArvGvInterfacePrivate;
 
 struct _ArvGvInterface {
@@ -338,6 +348,29 @@ struct _ArvGvInterfaceClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvGvInterface, arv_gv_interface, ARV_TYPE_INTERFACE, G_ADD_PRIVATE (ArvGvInterface))
 
+static GHashTable *
+_device_table_new (void)
+{
+	return g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+				      (GDestroyNotify) arv_gv_interface_device_infos_unref);
+}
+
+static void
+_registry_add (GHashTable *devices, ArvGvInterfaceDeviceInfos *device_infos)
+{
+	if (device_infos->id != NULL && device_infos->id[0] != '\0')
+		g_hash_table_replace (devices, device_infos->id, arv_gv_interface_device_infos_ref (device_infos));
+	if (device_infos->user_id != NULL && device_infos->user_id[0] != '\0')
+		g_hash_table_replace (devices, device_infos->user_id, arv_gv_interface_device_infos_ref (device_infos));
+	if (device_infos->vendor_serial != NULL && device_infos->vendor_serial[0] != '\0')
+		g_hash_table_replace (devices, device_infos->vendor_serial,
+				      arv_gv_interface_device_infos_ref (device_infos));
+	if (device_infos->vendor_alias_serial != NULL && device_infos->vendor_alias_serial[0] != '\0')
+		g_hash_table_replace (devices, device_infos->vendor_alias_serial,
+				      arv_gv_interface_device_infos_ref (device_infos));
+	g_hash_table_replace (devices, device_infos->mac, arv_gv_interface_device_infos_ref (device_infos));
+}
+
 static ArvGvInterfaceDeviceInfos *
 _discover (GHashTable *devices, const char *device_id)
 {
@@ -416,30 +449,8 @@ _discover (GHashTable *devices, const char *device_id)
 						g_free (address_string);
 
 						if (devices != NULL) {
-							if (device_infos->id != NULL &&
-                                                            device_infos->id[0] != '\0')
-								g_hash_table_replace
-                                                                        (devices, device_infos->id,
-                                                                         arv_gv_interface_device_infos_ref (device_infos));
-                                                        if (device_infos->user_id != NULL &&
-                                                            device_infos->user_id[0] != '\0')
-                                                                g_hash_table_replace
-                                                                        (devices, device_infos->user_id,
-                                                                         arv_gv_interface_device_infos_ref (device_infos));
-                                                        if (device_infos->vendor_serial != NULL &&
-                                                            device_infos->vendor_serial[0] != '\0')
-                                                                g_hash_table_replace
-                                                                        (devices, device_infos->vendor_serial,
-                                                                         arv_gv_interface_device_infos_ref (device_infos));
-                                                        if (device_infos->vendor_alias_serial != NULL &&
-                                                            device_infos->vendor_alias_serial[0] != '\0')
-                                                                g_hash_table_replace
-                                                                        (devices, device_infos->vendor_alias_serial,
-                                                                         arv_gv_interface_device_infos_ref (device_infos));
-                                                        g_hash_table_replace
-                                                                (devices, device_infos->mac,
-                                                                 arv_gv_interface_device_infos_ref (device_infos));
-                                                } else {
+							_registry_add (devices, device_infos);
+						} else {
                                                         if (device_id == NULL ||
                                                             g_strcmp0 (device_infos->id, device_id) == 0 ||
                                                             g_strcmp0 (device_infos->user_id, device_id) == 0 ||
@@ -460,10 +471,222 @@ _discover (GHashTable *devices, const char *device_id)
 	} while (1);
 }
 
+static void
+_registry_remove (GHashTable *devices, ArvGvInterfaceDeviceInfos *device_infos)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	g_hash_table_iter_init (&iter, devices);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		if (value == device_infos)
+			g_hash_table_iter_remove (&iter);
+}
+
+/* Collects the ids of the devices of @a which are not in @b. Only the entries indexed by the device id are
+ * considered, the other keys being aliases of the same device. */
+
+static GPtrArray *
+_registry_diff (GHashTable *a, GHashTable *b)
+{
+	GPtrArray *ids;
+	GHashTableIter iter;
+	gpointer key, value;
+
+	ids = g_ptr_array_new_with_free_func (g_free);
+
+	g_hash_table_iter_init (&iter, a);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		ArvGvInterfaceDeviceInfos *infos = value;
+
+		if (g_strcmp0 (key, infos->id) == 0 && !g_hash_table_contains (b, key))
+			g_ptr_array_add (ids, g_strdup (key));
+	}
+
+	return ids;
+}
+
+/* Runs a full discovery into a new table, then swaps it with the registry. The discovery timeout is spent
+ * outside of devices_mutex, so device opening is not blocked by a registry refresh. */
+
 static void
 arv_gv_interface_discover (ArvGvInterface *gv_interface)
 {
-	_discover (gv_interface->priv->devices, NULL);
+	ArvGvInterfacePrivate *priv = gv_interface->priv;
+	GHashTable *devices;
+	GHashTable *old_devices;
+	GPtrArray *added;
+	GPtrArray *removed;
+	guint i;
+
+	g_mutex_lock (&priv->discovery_mutex);
+
+	devices = _device_table_new ();
+	_discover (devices, NULL);
+
+	g_mutex_lock (&priv->devices_mutex);
+	old_devices = priv->devices;
+	priv->devices = devices;
+	g_mutex_unlock (&priv->devices_mutex);
+
+	added = _registry_diff (devices, old_devices);
+	removed = _registry_diff (old_devices, devices);
+
+	g_hash_table_unref (old_devices);
+
+	g_mutex_unlock (&priv->discovery_mutex);
+
+	for (i = 0; i < removed->len; i++) {
+		arv_info_interface ("[GvInterface::discover] Device '%s' removed", (char *) removed->pdata[i]);
+		arv_interface_emit_device_removed_signal (ARV_INTERFACE (gv_interface), removed->pdata[i]);
+	}
+	for (i = 0; i < added->len; i++) {
+		arv_info_interface ("[GvInterface::discover] Device '%s' added", (char *) added->pdata[i]);
+		arv_interface_emit_device_added_signal (ARV_INTERFACE (gv_interface), added->pdata[i]);
+	}
+
+	g_ptr_array_unref (added);
+	g_ptr_array_unref (removed);
+}
+
+static gboolean
+_is_discovery_running (ArvGvInterface *gv_interface)
+{
+	gboolean is_running;
+
+	g_mutex_lock (&gv_interface->priv->devices_mutex);
+	is_running = gv_interface->priv->discovery_thread != NULL;
+	g_mutex_unlock (&gv_interface->priv->devices_mutex);
+
+	return is_running;
+}
+
+static void *
+arv_gv_interface_discovery_thread (void *data)
+{
+	ArvGvInterface *gv_interface = data;
+	ArvGvInterfacePrivate *priv = gv_interface->priv;
+
+	g_mutex_lock (&priv->devices_mutex);
+
+	while (!priv->discovery_cancel) {
+		gint64 end_time;
+
+		priv->discovery_triggered = FALSE;
+
+		g_mutex_unlock (&priv->devices_mutex);
+		arv_gv_interface_discover (gv_interface);
+		g_mutex_lock (&priv->devices_mutex);
+
+		end_time = g_get_monotonic_time () + (gint64) priv->discovery_interval_ms * G_TIME_SPAN_MILLISECOND;
+
+		while (!priv->discovery_cancel && !priv->discovery_triggered) {
+			if (priv->discovery_interval_ms == 0)
+				g_cond_wait (&priv->discovery_cond, &priv->devices_mutex);
+			else if (!g_cond_wait_until (&priv->discovery_cond, &priv->devices_mutex, end_time))
+				break;
+		}
+	}
+
+	g_mutex_unlock (&priv->devices_mutex);
+
+	return NULL;
+}
+
+/**
+ * arv_gv_interface_start_discovery:
+ * @gv_interface: a #ArvGvInterface
+ * @interval_ms: the delay between two discovery broadcasts, in milliseconds, or 0 for triggered broadcasts only
+ *
+ * Starts a background thread which keeps the device registry up to date, using a discovery broadcast every
+ * @interval_ms, or on each call to arv_gv_interface_trigger_discovery(). A first broadcast is sent right away.
+ *
+ * While the discovery thread is running, arv_update_device_list() returns the registry content without waiting for
+ * a discovery timeout, and arv_open_device() resolves the known device ids without a new discovery.
+ * #ArvInterface::device-added and #ArvInterface::device-removed are emitted on registry changes.
+ *
+ * If the discovery thread is already running, only the interval is updated.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gv_interface_start_discovery (ArvGvInterface *gv_interface, guint interval_ms)
+{
+	ArvGvInterfacePrivate *priv;
+
+	g_return_if_fail (ARV_IS_GV_INTERFACE (gv_interface));
+
+	priv = gv_interface->priv;
+
+	g_mutex_lock (&priv->devices_mutex);
+
+	priv->discovery_interval_ms = interval_ms;
+
+	if (priv->discovery_thread == NULL) {
+		priv->discovery_cancel = FALSE;
+		priv->discovery_thread = g_thread_new ("arv_gv_discovery", arv_gv_interface_discovery_thread,
+						       gv_interface);
+	} else
+		g_cond_signal (&priv->discovery_cond);
+
+	g_mutex_unlock (&priv->devices_mutex);
+}
+
+/**
+ * arv_gv_interface_stop_discovery:
+ * @gv_interface: a #ArvGvInterface
+ *
+ * Stops the background discovery thread started by arv_gv_interface_start_discovery(). The registry content is
+ * kept.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gv_interface_stop_discovery (ArvGvInterface *gv_interface)
+{
+	ArvGvInterfacePrivate *priv;
+	GThread *thread;
+
+	g_return_if_fail (ARV_IS_GV_INTERFACE (gv_interface));
+
+	priv = gv_interface->priv;
+
+	g_mutex_lock (&priv->devices_mutex);
+	thread = priv->discovery_thread;
+	priv->discovery_thread = NULL;
+	priv->discovery_cancel = TRUE;
+	g_cond_signal (&priv->discovery_cond);
+	g_mutex_unlock (&priv->devices_mutex);
+
+	if (thread != NULL)
+		g_thread_join (thread);
+}
+
+/**
+ * arv_gv_interface_trigger_discovery:
+ * @gv_interface: a #ArvGvInterface
+ *
+ * Asks the background discovery thread for an immediate registry refresh. This function does not wait for the
+ * discovery completion, and does nothing if the discovery thread is not running.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_gv_interface_trigger_discovery (ArvGvInterface *gv_interface)
+{
+	ArvGvInterfacePrivate *priv;
+
+	g_return_if_fail (ARV_IS_GV_INTERFACE (gv_interface));
+
+	priv = gv_interface->priv;
+
+	g_mutex_lock (&priv->devices_mutex);
+	priv->discovery_triggered = TRUE;
+	g_cond_signal (&priv->discovery_cond);
+	g_mutex_unlock (&priv->devices_mutex);
 }
 
 static GInetAddress *
@@ -489,7 +712,10 @@ arv_gv_interface_update_device_list (ArvInterface *interface, GArray *device_ids
 
 	gv_interface = ARV_GV_INTERFACE (interface);
 
-	arv_gv_interface_discover (gv_interface);
+	if (!_is_discovery_running (gv_interface))
+		arv_gv_interface_discover (gv_interface);
+
+	g_mutex_lock (&gv_interface->priv->devices_mutex);
 
 	g_hash_table_iter_init (&iter, gv_interface->priv->devices);
 	while (g_hash_table_iter_next (&iter, &key, &value)) {
@@ -515,6 +741,8 @@ arv_gv_interface_update_device_list (ArvInterface *interface, GArray *device_ids
 			g_object_unref (device_address);
 		}
 	}
+
+	g_mutex_unlock (&gv_interface->priv->devices_mutex);
 }
 
 static GInetAddress *
@@ -626,23 +854,34 @@ arv_gv_interface_camera_locate (ArvGvInterface *gv_interface, GInetAddress *devi
 }
 
 static ArvDevice *
-_open_device (ArvInterface *interface, GHashTable *devices, const char *device_id, GError **error)
+_open_device (ArvInterface *interface, const char *device_id, GError **error)
 {
 	ArvGvInterface *gv_interface;
 	ArvDevice *device = NULL;
 	ArvGvInterfaceDeviceInfos *device_infos;
 	GInetAddress *device_address;
+	GError *local_error = NULL;
 
 	gv_interface = ARV_GV_INTERFACE (interface);
 
+	/* The device instantiation, which includes the genicam data download, is done outside of the lock, allowing
+	 * the concurrent opening of several devices */
+
+	g_mutex_lock (&gv_interface->priv->devices_mutex);
+
 	if (device_id == NULL) {
 		GList *device_list;
 
-		device_list = g_hash_table_get_values (devices);
+		device_list = g_hash_table_get_values (gv_interface->priv->devices);
 		device_infos = device_list != NULL ? device_list->data : NULL;
 		g_list_free (device_list);
 	} else
-		device_infos = g_hash_table_lookup (devices, device_id);
+		device_infos = g_hash_table_lookup (gv_interface->priv->devices, device_id);
+
+	if (device_infos != NULL)
+		arv_gv_interface_device_infos_ref (device_infos);
+
+	g_mutex_unlock (&gv_interface->priv->devices_mutex);
 
 	if (device_infos == NULL) {
 		struct addrinfo hints;
@@ -693,9 +932,24 @@ _open_device (ArvInterface *interface, GHashTable *devices, const char *device_i
 	}
 
 	device_address = _device_infos_to_ginetaddress (device_infos);
-	device = arv_gv_device_new (device_infos->interface_address, device_address, error);
+	device = arv_gv_device_new (device_infos->interface_address, device_address, &local_error);
 	g_object_unref (device_address);
 
+	if (local_error != NULL) {
+		/* The registry entry may be stale, for example after an IP address change of the device. Drop it, and
+		 * let the caller run a new discovery. */
+
+		arv_info_interface ("[GvInterface::open_device] Failed to open registered device '%s': %s",
+				    device_infos->id, local_error->message);
+		g_clear_error (&local_error);
+
+		g_mutex_lock (&gv_interface->priv->devices_mutex);
+		_registry_remove (gv_interface->priv->devices, device_infos);
+		g_mutex_unlock (&gv_interface->priv->devices_mutex);
+	}
+
+	arv_gv_interface_device_infos_unref (device_infos);
+
 	return device;
 }
 
@@ -706,7 +960,7 @@ arv_gv_interface_open_device (ArvInterface *interface, const char *device_id, GE
 	ArvGvInterfaceDeviceInfos *device_infos;
 	GError *local_error = NULL;
 
-	device = _open_device (interface, ARV_GV_INTERFACE (interface)->priv->devices, device_id, &local_error);
+	device = _open_device (interface, device_id, &local_error);
 	if (ARV_IS_DEVICE (device) || local_error != NULL) {
 		if (local_error != NULL)
 			g_propagate_error (error, local_error);
@@ -715,8 +969,15 @@ arv_gv_interface_open_device (ArvInterface *interface, const char *device_id, GE
 
 	device_infos = _discover (NULL, device_id);
 	if (device_infos != NULL) {
+		ArvGvInterface *gv_interface = ARV_GV_INTERFACE (interface);
 		GInetAddress *device_address;
 
+		/* Keep the device in the registry, the next opening will not need a discovery */
+
+		g_mutex_lock (&gv_interface->priv->devices_mutex);
+		_registry_add (gv_interface->priv->devices, device_infos);
+		g_mutex_unlock (&gv_interface->priv->devices_mutex);
+
 		device_address = _device_infos_to_ginetaddress (device_infos);
 		device = arv_gv_device_new (device_infos->interface_address, device_address, error);
 		g_object_unref (device_address);
@@ -771,8 +1032,18 @@ arv_gv_interface_init (ArvGvInterface *gv_interface)
 {
 	gv_interface->priv = arv_gv_interface_get_instance_private (gv_interface);
 
-	gv_interface->priv->devices = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
-							     (GDestroyNotify) arv_gv_interface_device_infos_unref);
+	gv_interface->priv->devices = _device_table_new ();
+	g_mutex_init (&gv_interface->priv->devices_mutex);
+	g_mutex_init (&gv_interface->priv->discovery_mutex);
+	g_cond_init (&gv_interface->priv->discovery_cond);
+}
+
+static void
+arv_gv_interface_dispose (GObject *object)
+{
+	arv_gv_interface_stop_discovery (ARV_GV_INTERFACE (object));
+
+	G_OBJECT_CLASS (arv_gv_interface_parent_class)->dispose (object);
 }
 
 static void
@@ -782,6 +1053,9 @@ arv_gv_interface_finalize (GObject *object)
 
 	g_hash_table_unref (gv_interface->priv->devices);
 	gv_interface->priv->devices = NULL;
+	g_mutex_clear (&gv_interface->priv->devices_mutex);
+	g_mutex_clear (&gv_interface->priv->discovery_mutex);
+	g_cond_clear (&gv_interface->priv->discovery_cond);
 
 	G_OBJECT_CLASS (arv_gv_interface_parent_class)->finalize (object);
 }
@@ -792,6 +1066,7 @@ arv_gv_interface_class_init (ArvGvInterfaceClass *gv_interface_class)
 	GObjectClass *object_class = G_OBJECT_CLASS (gv_interface_class);
 	ArvInterfaceClass *interface_class = ARV_INTERFACE_CLASS (gv_interface_class);
 
+	object_class->dispose = arv_gv_interface_dispose;
 	object_class->finalize = arv_gv_interface_finalize;
 
 	interface_class->update_device_list = arv_gv_interface_update_device_list;
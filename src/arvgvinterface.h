@@ -38,6 +38,10 @@ ARV_API G_DECLARE_FINAL_TYPE (ArvGvInterface, arv_gv_interface, ARV, GV_INTERFAC
 
 ARV_API ArvInterface *		arv_gv_interface_get_instance		(void);
 
+ARV_API void			arv_gv_interface_start_discovery	(ArvGvInterface *gv_interface, guint interval_ms);
+ARV_API void			arv_gv_interface_stop_discovery		(ArvGvInterface *gv_interface);
+ARV_API void			arv_gv_interface_trigger_discovery	(ArvGvInterface *gv_interface);
+
 G_END_DECLS
 
 #endif
@@ -129,6 +129,14 @@ arv_gvsp_packet_new_data_block (guint16 frame_id, guint32 packet_id,
 	return packet;
 }
 
+/* Only the packet header is written, the block data being sent from its own buffer using a separate I/O vector */
+
+ArvGvspPacket *
+arv_gvsp_packet_new_data_block_header (guint16 frame_id, guint32 packet_id, void *buffer, size_t *buffer_size)
+{
+	return arv_gvsp_packet_new (ARV_GVSP_CONTENT_TYPE_DATA_BLOCK, frame_id, packet_id, 0, buffer, buffer_size);
+}
+
 static const char *
 arv_enum_to_string (GType type,
 		    guint enum_value)
@@ -201,11 +209,18 @@ arv_gvsp_packet_to_string (const ArvGvspPacket *packet, size_t packet_size)
 				case ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK:
 					g_string_append (string, "payload_type = image extended chunk\n");
 					break;
+				case ARV_GVSP_PAYLOAD_TYPE_MULTIPART:
+					g_string_append (string, "payload_type = multipart\n");
+					g_string_append_printf (string, "n_parts      = %d\n",
+								arv_gvsp_packet_get_n_parts (packet, packet_size));
+					break;
 				default:
 					g_string_append_printf (string, "payload_type = unknown (0x%08x)\n",
 								g_ntohs (leader->payload_type));
 					break;
 			}
+			if (g_ntohs (leader->payload_type) == ARV_GVSP_PAYLOAD_TYPE_MULTIPART)
+				break;
 			g_string_append_printf (string, "pixel format = %s\n",
 						arv_pixel_format_to_gst_caps_string (g_ntohl (leader->pixel_format)));
 			g_string_append_printf (string, "width        = %d\n", g_ntohl (leader->width));
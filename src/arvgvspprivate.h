@@ -72,6 +72,7 @@ typedef enum {
  * @ARV_GVSP_PAYLOAD_TYPE_JPEG2000: JPEG2000 data
  * @ARV_GVSP_PAYLOAD_TYPE_H264: h264 data
  * @ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE: multizone image
+ * @ARV_GVSP_PAYLOAD_TYPE_MULTIPART: multipart data
 */
 
 typedef enum {
@@ -84,6 +85,7 @@ typedef enum {
 	ARV_GVSP_PAYLOAD_TYPE_JPEG2000 = 		0x0007,
 	ARV_GVSP_PAYLOAD_TYPE_H264 = 			0x0008,
 	ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE = 	0x0009,
+	ARV_GVSP_PAYLOAD_TYPE_MULTIPART =		0x000a,
 	ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK = 	0x4001,
 
 } ArvGvspPayloadType;
@@ -140,6 +142,89 @@ typedef struct {
 	guint32	y_offset;
 } ArvGvspDataLeader;
 
+/**
+ * ArvGvspPartInfos:
+ * @data_type: a #ArvBufferPartDataType identifier
+ * @part_length_high: most significant bits of part length
+ * @part_length_low: least significant bits of part length
+ * @pixel_format: a #ArvPixelFormat identifier
+ * @reserved: reserved
+ * @source_id: part source identifier
+ * @additional_zones: number of additional zones
+ * @parts_flags: part flags
+ * @zone_directions: zone direction bitfield
+ * @data_purpose_id: data purpose identifier
+ * @region_id: region identifier
+ * @width: part width, in pixels
+ * @height: part height, in pixels
+ * @x_offset: part x offset, in pixels
+ * @y_offset: part y offset, in pixels
+ * @x_padding: part horizontal padding, in bytes
+ * @reserved2: reserved
+ * @y_padding: part vertical padding, in bytes
+ *
+ * GVSP multipart leader part descriptor.
+ */
+
+typedef struct {
+	guint16 data_type;
+	guint16 part_length_high;
+	guint32 part_length_low;
+	guint32 pixel_format;
+	guint8 reserved;
+	guint8 source_id;
+	guint8 additional_zones;
+	guint8 parts_flags;
+	guint32 zone_directions;
+	guint16 data_purpose_id;
+	guint16 region_id;
+	guint32 width;
+	guint32 height;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint16 x_padding;
+	guint16 reserved2;
+	guint32 y_padding;
+} ArvGvspPartInfos;
+
+/**
+ * ArvGvspMultipartLeader:
+ * @flags: generic flags
+ * @payload_type: ID of the payload type
+ * @timestamp_high: most significant bits of frame timestamp
+ * @timestamp_low: least significant bits of frame timestamp_low
+ * @parts: part descriptors
+ *
+ * GVSP multipart data leader packet data area.
+ */
+
+typedef struct {
+	guint16 flags;
+	guint16 payload_type;
+	guint32 timestamp_high;
+	guint32 timestamp_low;
+	ArvGvspPartInfos parts[];
+} ArvGvspMultipartLeader;
+
+/**
+ * ArvGvspMultipart:
+ * @part_id: index of the part in the multipart leader
+ * @zone_info: zone identifier and direction
+ * @offset_high: most significant bits of the data offset in the part
+ * @offset_low: least significant bits of the data offset in the part
+ * @data: data byte array
+ *
+ * GVSP multipart data block packet data area.
+ */
+
+typedef struct {
+	guint8 part_id;
+	guint8 zone_info;
+	guint16 offset_high;
+	guint32 offset_low;
+	guint8 data[];
+} ArvGvspMultipart;
+
 /**
  * ArvGvspDataTrailer:
  * @payload_type: ID of the payload type
@@ -180,16 +265,44 @@ typedef struct {
 
 #pragma pack(pop)
 
-ArvGvspPacket *		arv_gvsp_packet_new_data_leader		(guint16 frame_id, guint32 packet_id,
+/**
+ * ArvGvspHeaderInfos:
+ * @packet_type: packet type, with the error flag
+ * @content_type: packet content type
+ * @extended_ids: whether the packet uses the extended ids layout
+ * @packet_id: packet identifier
+ * @frame_id: frame identifier
+ * @data: packet data area
+ * @header_size: size of the packet header, before @data
+ *
+ * GVSP packet header fields, decoded in host byte order by arv_gvsp_packet_parse_header().
+ */
+
+typedef struct {
+	ArvGvspPacketType packet_type;
+	ArvGvspContentType content_type;
+	gboolean extended_ids;
+	guint32 packet_id;
+	guint64 frame_id;
+	const void *data;
+	size_t header_size;
+} ArvGvspHeaderInfos;
+
+/* private, but used by tests */
+ARV_API ArvGvspPacket *	arv_gvsp_packet_new_data_leader		(guint16 frame_id, guint32 packet_id,
 								 guint64 timestamp, ArvPixelFormat pixel_format,
 								 guint32 width, guint32 height,
 								 guint32 x_offset, guint32 y_offset,
 								 void *buffer, size_t *buffer_size);
-ArvGvspPacket *		arv_gvsp_packet_new_data_trailer	(guint16 frame_id, guint32 packet_id,
+/* private, but used by tests */
+ARV_API ArvGvspPacket *	arv_gvsp_packet_new_data_trailer	(guint16 frame_id, guint32 packet_id,
 								 void *buffer, size_t *buffer_size);
-ArvGvspPacket *		arv_gvsp_packet_new_data_block		(guint16 frame_id, guint32 packet_id,
+/* private, but used by tests */
+ARV_API ArvGvspPacket *	arv_gvsp_packet_new_data_block		(guint16 frame_id, guint32 packet_id,
 								 size_t size, void *data,
 								 void *buffer, size_t *buffer_size);
+ArvGvspPacket *		arv_gvsp_packet_new_data_block_header	(guint16 frame_id, guint32 packet_id,
+								 void *buffer, size_t *buffer_size);
 char * 			arv_gvsp_packet_to_string 		(const ArvGvspPacket *packet, size_t packet_size);
 void 			arv_gvsp_packet_debug 			(const ArvGvspPacket *packet, size_t packet_size,
 								 ArvDebugLevel level);
@@ -269,6 +382,37 @@ arv_gvsp_packet_get_data (const ArvGvspPacket *packet)
 	}
 }
 
+/* Decodes all the header fields used on packet reception at once. The packet infos word is at the same offset in
+ * both layouts, and holds the extended ids flag, which leaves a single branch for the layout specific fields. */
+
+static inline void
+arv_gvsp_packet_parse_header (const ArvGvspPacket *packet, ArvGvspHeaderInfos *infos)
+{
+	guint32 packet_infos = g_ntohl (((const ArvGvspHeader *) (const void *) &packet->header)->packet_infos);
+
+	infos->packet_type = (ArvGvspPacketType) g_ntohs (packet->packet_type);
+	infos->content_type = (ArvGvspContentType) ((packet_infos & ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_MASK) >>
+						    ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_POS);
+
+	if (G_LIKELY ((packet_infos & ((guint32) ARV_GVSP_PACKET_EXTENDED_ID_MODE_MASK << 24)) == 0)) {
+		const ArvGvspHeader *header = (const void *) &packet->header;
+
+		infos->extended_ids = FALSE;
+		infos->packet_id = packet_infos & ARV_GVSP_PACKET_ID_MASK;
+		infos->frame_id = g_ntohs (header->frame_id);
+		infos->data = &header->data;
+		infos->header_size = sizeof (ArvGvspPacket) + sizeof (ArvGvspHeader);
+	} else {
+		const ArvGvspExtendedHeader *header = (const void *) &packet->header;
+
+		infos->extended_ids = TRUE;
+		infos->packet_id = g_ntohl (header->packet_id);
+		infos->frame_id = GUINT64_FROM_BE (header->frame_id);
+		infos->data = &header->data;
+		infos->header_size = sizeof (ArvGvspPacket) + sizeof (ArvGvspExtendedHeader);
+	}
+}
+
 static inline ArvBufferPayloadType
 arv_gvsp_packet_get_buffer_payload_type (const ArvGvspPacket *packet)
 {
@@ -298,6 +442,8 @@ arv_gvsp_packet_get_buffer_payload_type (const ArvGvspPacket *packet)
 			return ARV_BUFFER_PAYLOAD_TYPE_H264;
 		case ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE:
 			return ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE;
+		case ARV_GVSP_PAYLOAD_TYPE_MULTIPART:
+			return ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
 		case ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK:
 			return ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK;
 	}
@@ -382,6 +528,74 @@ arv_gvsp_packet_get_data_size (const ArvGvspPacket *packet, size_t packet_size)
 		return packet_size - sizeof (ArvGvspPacket) - sizeof (ArvGvspHeader);
 }
 
+static inline guint
+arv_gvsp_packet_get_n_parts (const ArvGvspPacket *packet, size_t packet_size)
+{
+	size_t data_size = arv_gvsp_packet_get_data_size (packet, packet_size);
+
+	if (data_size < sizeof (ArvGvspMultipartLeader))
+		return 0;
+
+	return (data_size - sizeof (ArvGvspMultipartLeader)) / sizeof (ArvGvspPartInfos);
+}
+
+static inline const ArvGvspPartInfos *
+arv_gvsp_packet_get_part_infos (const ArvGvspPacket *packet, guint part_id)
+{
+	ArvGvspMultipartLeader *leader;
+
+	leader = arv_gvsp_packet_get_data (packet);
+	return &leader->parts[part_id];
+}
+
+static inline guint64
+arv_gvsp_part_infos_get_length (const ArvGvspPartInfos *infos)
+{
+	return ((guint64) g_ntohs (infos->part_length_high) << 32) | g_ntohl (infos->part_length_low);
+}
+
+static inline guint
+arv_gvsp_packet_get_multipart_part_id (const ArvGvspPacket *packet)
+{
+	ArvGvspMultipart *multipart;
+
+	multipart = arv_gvsp_packet_get_data (packet);
+	return multipart->part_id;
+}
+
+static inline guint64
+arv_gvsp_packet_get_multipart_offset (const ArvGvspPacket *packet)
+{
+	ArvGvspMultipart *multipart;
+
+	multipart = arv_gvsp_packet_get_data (packet);
+	return ((guint64) g_ntohs (multipart->offset_high) << 32) | g_ntohl (multipart->offset_low);
+}
+
+/* Returns the largest valid packet size not above @packet_size, whose payload is a multiple of @alignment bytes, or
+ * @packet_size if there is none within @alignment increments. The block offsets in the buffers being multiples of the
+ * payload size, the data block copies are then aligned. */
+
+static inline guint
+arv_gvsp_align_packet_size (guint packet_size, guint min_size, guint inc, guint overhead, guint alignment)
+{
+	guint size = packet_size;
+	guint i;
+
+	if (alignment < 2 || inc < 1)
+		return packet_size;
+
+	for (i = 0; i < alignment; i++) {
+		if (size > overhead && (size - overhead) % alignment == 0)
+			return size;
+		if (size < min_size + inc)
+			break;
+		size -= inc;
+	}
+
+	return packet_size;
+}
+
 G_END_DECLS
 
 #endif
@@ -23,8 +23,17 @@
 /**
  * SECTION: arvgvstream
  * @short_description: GigEVision stream
+ *
+ * In addition to the #ArvStream informations, a GigEVision stream provides the distribution of the "packet_time",
+ * from the first packet of a frame to each of its packets, of the "inter_packet" time, and of the "frame_retention"
+ * time, from the first packet to the frame completion. Each one is available as "_n_samples", "_p50_us", "_p99_us",
+ * "_p999_us", "_p9999_us" and "_max_us" informations, computed when read, with a precision of about 3%.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for recvmmsg */
+#endif
+
 #include <arvgvstreamprivate.h>
 #include <arvgvdeviceprivate.h>
 #include <arvstreamprivate.h>
@@ -33,47 +42,172 @@
 #include <arvparamsprivate.h>
 #include <arvgvspprivate.h>
 #include <arvgvcpprivate.h>
+#include <arvtraceprivate.h>
+#include <arvhdrhistogramprivate.h>
+#include <arvgcfloat.h>
 #include <arvdebug.h>
 #include <arvmisc.h>
 #include <arvmiscprivate.h>
 #include <arvnetworkprivate.h>
+#include <arvwakeupprivate.h>
 #include <arvstr.h>
 #include <arvenumtypes.h>
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
+#include <math.h>
+#include <gio/gnetworking.h>
 
-#if ARAVIS_HAS_PACKET_SOCKET
+#if ARAVIS_HAS_PACKET_SOCKET || ARAVIS_HAS_XDP
 #include <ifaddrs.h>
 #include <netinet/udp.h>
 #include <net/if.h>
 #include <netinet/in.h>
-#include <linux/if_packet.h>
 #include <linux/if_ether.h>
 #include <linux/ip.h>
-#include <linux/filter.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #endif
 
+#if ARAVIS_HAS_PACKET_SOCKET
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <unistd.h>
+#endif
+
+#if defined (__linux__)
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <linux/sockios.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#endif
+
+#if defined (__linux__) && defined (SO_TIMESTAMPING)
+#define ARV_GV_STREAM_HAS_TIMESTAMPING 1
+#else
+#define ARV_GV_STREAM_HAS_TIMESTAMPING 0
+#endif
+
+#if defined (SO_REUSEPORT) && defined (SO_ATTACH_REUSEPORT_CBPF)
+#define ARV_GV_STREAM_HAS_REUSEPORT 1
+#else
+#define ARV_GV_STREAM_HAS_REUSEPORT 0
+#endif
+
+#if ARAVIS_HAS_IO_URING
+#include <liburing.h>
+#include <poll.h>
+#endif
+
+#if ARAVIS_HAS_KERNEL_GVSP
+#include <aravis-module.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#if ARAVIS_HAS_XDP
+#include <xdp/xsk.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#endif
+
 #define ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD	100
 
+/* Maximum number of frames being received at the same time, must be a power of 2 */
+#define ARV_GV_STREAM_FRAME_RING_SIZE			64
+#define ARV_GV_STREAM_FRAME_RING_MASK			(ARV_GV_STREAM_FRAME_RING_SIZE - 1)
+
+#define ARV_GV_STREAM_MAX_RECEIVE_THREADS		16
+
+#define ARV_GV_STREAM_MULTIPART_MAX_PARTS		16
+
+/* Adaptive resend timing: the initial packet timeout is this factor times the inter-packet delay jitter */
+#define ARV_GV_STREAM_ADAPTIVE_TIMEOUT_FACTOR		8
+#define ARV_GV_STREAM_ADAPTIVE_TIMEOUT_MIN_US		100
+
+/* Burst size of the resend budget shared by the streams of an interface, as a duration at the budget rate */
+#define ARV_GV_STREAM_RESEND_BUDGET_BURST_MS		100
+
+#define ARV_GV_STREAM_RING_MINIMUM_SIZE			(4 << 20)
+#define ARV_GV_STREAM_RING_MAXIMUM_SIZE			(256 << 20)
+#define ARV_GV_STREAM_RING_MAXIMUM_BLOCK_SIZE		(4 << 20)
+#define ARV_GV_STREAM_RING_MINIMUM_BLOCK_COUNT		16
+#define ARV_GV_STREAM_RING_DURATION_MS			50
+#define ARV_GV_STREAM_RING_FRAME_SIZE_DEFAULT		1024
+#define ARV_GV_STREAM_RING_BLOCK_TIMEOUT_MS_DEFAULT	5
+
 enum {
 	ARV_GV_STREAM_PROPERTY_0,
 	ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER,
 	ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_SIZE,
+	ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_MAX_SIZE,
 	ARV_GV_STREAM_PROPERTY_PACKET_RESEND,
 	ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_RATIO,
 	ARV_GV_STREAM_PROPERTY_INITIAL_PACKET_TIMEOUT,
 	ARV_GV_STREAM_PROPERTY_PACKET_TIMEOUT,
-	ARV_GV_STREAM_PROPERTY_FRAME_RETENTION
+	ARV_GV_STREAM_PROPERTY_FRAME_RETENTION,
+	ARV_GV_STREAM_PROPERTY_DIRECT_RECEIVE,
+	ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE,
+	ARV_GV_STREAM_PROPERTY_RING_BLOCK_COUNT,
+	ARV_GV_STREAM_PROPERTY_RING_FRAME_SIZE,
+	ARV_GV_STREAM_PROPERTY_RING_BLOCK_TIMEOUT,
+	ARV_GV_STREAM_PROPERTY_PACKET_FANOUT,
+	ARV_GV_STREAM_PROPERTY_RECEIVE_THREADS,
+	ARV_GV_STREAM_PROPERTY_PACKET_TIMESTAMP,
+	ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_MERGE_DISTANCE,
+	ARV_GV_STREAM_PROPERTY_PACKET_RESEND_TIMING,
+	ARV_GV_STREAM_PROPERTY_BUSY_POLL,
+	ARV_GV_STREAM_PROPERTY_CHANNEL,
+	ARV_GV_STREAM_PROPERTY_RESEND_BUDGET,
+	ARV_GV_STREAM_PROPERTY_PAYLOAD_COPY,
+	ARV_GV_STREAM_PROPERTY_STALL_WATCHDOG,
+	ARV_GV_STREAM_PROPERTY_STALL_FRAMES,
+	ARV_GV_STREAM_PROPERTY_TIMING_STATISTICS
 } ArvGvStreamProperties;
 
+enum {
+	ARV_GV_STREAM_SIGNAL_STALLED,
+	ARV_GV_STREAM_SIGNAL_LAST
+} ArvGvStreamSignals;
+
+static guint arv_gv_stream_signals[ARV_GV_STREAM_SIGNAL_LAST] = {0};
+
 typedef struct _ArvGvStreamThreadData ArvGvStreamThreadData;
+typedef struct _ArvGvStreamFrameData ArvGvStreamFrameData;
+
+typedef ArvGvStreamFrameData * (*ArvGvStreamProcessPacket) (ArvGvStreamThreadData *thread_data,
+							    const ArvGvspPacket *packet, size_t packet_size,
+							    const void *data, guint64 time_us, guint64 timestamp_ns);
 
 typedef struct {
 	GThread *thread;
 	ArvGvStreamThreadData *thread_data;
+
+	/* Stream without device nor socket, fed by arv_gv_stream_offline_process_packet() */
+	gboolean is_offline;
+
+	/* Receiver thread stopped by arv_gv_stream_suspend(), until arv_gv_stream_resume() */
+	gboolean is_suspended;
+
+	/* Shared receive worker set by arv_gv_stream_set_worker(), running the stream instead of its own thread */
+	ArvGvStreamWorker *worker;
+	gboolean is_running;
 } ArvGvStreamPrivate;
 
 struct _ArvGvStream {
@@ -88,13 +222,133 @@ G_DEFINE_TYPE_WITH_CODE (ArvGvStream, arv_gv_stream, ARV_TYPE_STREAM, G_ADD_PRIV
 
 /* Acquisition thread */
 
-typedef struct {
-	gboolean received;
-        gboolean resend_requested;
-	guint64 abs_timeout_us;
-} ArvGvStreamPacketData;
+/*
+ * Packet tracking: received and resend requested packets are stored in bitmaps, one bit per packet. Resend timeouts
+ * are shared by the packets of a same bitmap word.
+ */
 
-typedef struct {
+#define ARV_GV_STREAM_BITMAP_WORD_SHIFT		6
+#define ARV_GV_STREAM_BITMAP_WORD_BITS		(1 << ARV_GV_STREAM_BITMAP_WORD_SHIFT)
+#define ARV_GV_STREAM_BITMAP_N_WORDS(n_bits)	(((n_bits) + ARV_GV_STREAM_BITMAP_WORD_BITS - 1) >> \
+						 ARV_GV_STREAM_BITMAP_WORD_SHIFT)
+
+static inline guint
+_count_trailing_zeros (guint64 value)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll (value);
+#else
+	guint count = 0;
+
+	while ((value & 1) == 0) {
+		value >>= 1;
+		count++;
+	}
+
+	return count;
+#endif
+}
+
+static inline guint
+_count_set_bits (guint64 value)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll (value);
+#else
+	value = value - ((value >> 1) & G_GUINT64_CONSTANT (0x5555555555555555));
+	value = (value & G_GUINT64_CONSTANT (0x3333333333333333)) +
+		((value >> 2) & G_GUINT64_CONSTANT (0x3333333333333333));
+	value = (value + (value >> 4)) & G_GUINT64_CONSTANT (0x0f0f0f0f0f0f0f0f);
+
+	return (value * G_GUINT64_CONSTANT (0x0101010101010101)) >> 56;
+#endif
+}
+
+static inline gboolean
+_bitmap_get (const guint64 *bitmap, guint index)
+{
+	return (bitmap[index >> ARV_GV_STREAM_BITMAP_WORD_SHIFT] >> (index & (ARV_GV_STREAM_BITMAP_WORD_BITS - 1))) & 1;
+}
+
+static inline void
+_bitmap_set (guint64 *bitmap, guint index)
+{
+	bitmap[index >> ARV_GV_STREAM_BITMAP_WORD_SHIFT] |=
+		G_GUINT64_CONSTANT (1) << (index & (ARV_GV_STREAM_BITMAP_WORD_BITS - 1));
+}
+
+static inline void
+_bitmap_clear (guint64 *bitmap, guint index)
+{
+	bitmap[index >> ARV_GV_STREAM_BITMAP_WORD_SHIFT] &=
+		~(G_GUINT64_CONSTANT (1) << (index & (ARV_GV_STREAM_BITMAP_WORD_BITS - 1)));
+}
+
+/* Returns the mask of the bits of a word in the [start, end[ range, word_start being the index of the first bit */
+
+static inline guint64
+_bitmap_word_mask (guint word_start, guint start, guint end)
+{
+	guint64 mask = G_MAXUINT64;
+
+	if (start > word_start)
+		mask &= G_MAXUINT64 << (start - word_start);
+	if (end < word_start + ARV_GV_STREAM_BITMAP_WORD_BITS)
+		mask &= ~(G_MAXUINT64 << (end - word_start));
+
+	return mask;
+}
+
+static void
+_bitmap_set_range (guint64 *bitmap, guint start, guint end)
+{
+	guint word;
+
+	for (word = start >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+	     (word << ARV_GV_STREAM_BITMAP_WORD_SHIFT) < end;
+	     word++)
+		bitmap[word] |= _bitmap_word_mask (word << ARV_GV_STREAM_BITMAP_WORD_SHIFT, start, end);
+}
+
+/* Returns the index of the first bit equal to value in the [start, end[ range, or end if none */
+
+static guint
+_bitmap_find (const guint64 *bitmap, guint start, guint end, gboolean value)
+{
+	guint word;
+
+	for (word = start >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+	     (word << ARV_GV_STREAM_BITMAP_WORD_SHIFT) < end;
+	     word++) {
+		guint word_start = word << ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+		guint64 bits;
+
+		bits = (value ? bitmap[word] : ~bitmap[word]) & _bitmap_word_mask (word_start, start, end);
+		if (bits != 0)
+			return word_start + _count_trailing_zeros (bits);
+	}
+
+	return MAX (start, end);
+}
+
+/* Returns the number of set bits in the [start, end[ range */
+
+static guint
+_bitmap_count (const guint64 *bitmap, guint start, guint end)
+{
+	guint word;
+	guint count = 0;
+
+	for (word = start >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+	     (word << ARV_GV_STREAM_BITMAP_WORD_SHIFT) < end;
+	     word++)
+		count += _count_set_bits (bitmap[word] &
+					  _bitmap_word_mask (word << ARV_GV_STREAM_BITMAP_WORD_SHIFT, start, end));
+
+	return count;
+}
+
+struct _ArvGvStreamFrameData {
 	ArvBuffer *buffer;
 	guint64 frame_id;
 
@@ -106,14 +360,60 @@ typedef struct {
 
 	gboolean disable_resend_request;
 
+	/* Expected number of packets, estimated from the payload size until the trailer reception fixes it. The
+	 * bitmaps are allocated for the buffer size, but only cleared up to the estimation. */
 	guint n_packets;
-	ArvGvStreamPacketData *packet_data;
+	gboolean n_packets_known;
+	guint max_n_packets;
+	guint64 *received_packets;
+	guint64 *resend_requested_packets;
+	guint64 *resend_timeouts_us;
+	guint n_allocated_words;
+	guint n_cleared_words;
 
 	guint n_packet_resend_requests;
 	gboolean resend_ratio_reached;
+	gboolean resend_budget_exceeded;
 
 	gboolean extended_ids;
-} ArvGvStreamFrameData;
+
+	/* Kernel drop count at the frame start */
+	guint64 n_kernel_dropped_packets;
+
+	/* Number of data blocks being copied by a receiver thread outside of the frame lock */
+	guint n_pending_copies;
+
+	/* Pixel unpacking on reception. The data blocks are either unpacked when they are stored in the buffer, or when
+	 * the leader was not the first received packet, the whole image is unpacked in place on frame completion. */
+	gboolean unpack_blocks;
+	gboolean unpack_frame;
+
+	/* Copy of the data blocks stored as received, selected on the leader */
+	ArvMemoryCopyMode copy_mode;
+	ArvPixelFormat packed_format;
+	guint n_group_bytes;
+	guint n_group_pixels;
+	size_t packed_size;
+};
+
+typedef struct {
+	ArvGvStreamThreadData *thread_data;
+	GSocket *socket;
+	GThread *thread;
+	guint32 n_socket_drops;
+} ArvGvStreamReceiver;
+
+/* Token bucket limiting the packet resend requests of all the streams bound to the same interface */
+
+typedef struct {
+	GInetAddress *interface_address;
+	guint ref_count;
+
+	GMutex mutex;
+	guint rate;		/* Requested packets per second, 0 for no limit */
+	double tokens;
+	gint64 last_refill_us;
+} ArvGvStreamResendBudget;
 
 struct _ArvGvStreamThreadData {
 	GCancellable *cancellable;
@@ -130,27 +430,80 @@ struct _ArvGvStreamThreadData {
 	GSocket *socket;
 	GInetAddress *interface_address;
 	GSocketAddress *interface_socket_address;
+	/* Multicast stream destination, NULL for unicast */
+	GInetAddress *multicast_group;
 	GInetAddress *device_address;
 	GSocketAddress *device_socket_address;
 	guint16 source_stream_port;
 	guint16 stream_port;
+	guint16 stream_channel;
 
 	ArvGvStreamPacketResend packet_resend;
 	double packet_request_ratio;
 	guint initial_packet_timeout_us;
 	guint packet_timeout_us;
+	guint packet_request_merge_distance;
+	ArvGvStreamPacketResendTiming packet_resend_timing;
+	ArvGvStreamPayloadCopy payload_copy;
 	guint frame_retention_us;
+	gboolean direct_receive;
+	guint n_receive_threads;
+	guint busy_poll_us;
+	gboolean timing_statistics;
+
+	/* Packet processing variant for the current configuration, see _select_packet_processing() */
+	ArvGvStreamProcessPacket process_packet;
+	gboolean variant_extended_ids;
+
+	/* Payload type of the last received leader, ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN before the first one */
+	ArvBufferPayloadType leader_payload_type;
+
+	/* Shared with the other streams of the interface, set at construction */
+	ArvGvStreamResendBudget *resend_budget;
+	guint resend_budget_rate;
 
 	guint64 timestamp_tick_frequency;
+	ArvClockModel *clock_model;	/* Owned by the device, which outlives the stream */
 	guint scps_packet_size;
 
 	guint16 packet_id;
 
-	GSList *frames;
+	/* Frames being received, stored at the frame_id modulo ring size index. frame_order lists the used slots
+	 * in frame arrival order. */
+	ArvGvStreamFrameData frame_ring[ARV_GV_STREAM_FRAME_RING_SIZE];
+	guint frame_order[ARV_GV_STREAM_FRAME_RING_SIZE];
+	guint first_frame;
+	guint n_frames;
+	ArvGvStreamFrameData *last_hit_frame;
+	/* Earliest frame retention or resend deadline, possibly too early */
+	guint64 next_deadline_us;
+
+	/* Additional receiver threads, each one with its own socket bound to the stream port. When they are running,
+	 * frame_mutex protects the frame ring and the statistics, and frames are only completed by the stream thread. */
+	ArvGvStreamReceiver receivers[ARV_GV_STREAM_MAX_RECEIVE_THREADS - 1];
+	guint n_receivers;
+	GMutex frame_mutex;
+	ArvWakeup *completion_wakeup;
+
 	gboolean first_packet;
 	guint64 last_frame_id;
 
 	gboolean use_packet_socket;
+	gboolean use_xdp;
+	gboolean use_io_uring;
+	gboolean use_kernel_module;
+
+	/* Packet socket ring geometry, 0 means automatic */
+	guint ring_block_size;
+	guint ring_block_count;
+	guint ring_frame_size;
+	guint ring_block_timeout_ms;
+	gboolean packet_fanout;
+	ArvGvStreamPacketTimestamp packet_timestamp;
+
+	/* Stream characteristics used for the automatic ring geometry, 0 if unknown */
+	guint64 payload_size;
+	double frame_rate;
 
 	/* Statistics */
 
@@ -171,19 +524,64 @@ struct _ArvGvStreamThreadData {
 	guint64 n_resent_packets;
 	guint64 n_resend_ratio_reached;
         guint64 n_resend_disabled;
+	guint64 n_resend_budget_exceeded;
 	guint64 n_duplicated_packets;
+	guint64 n_direct_packets;
 
         guint64 n_transferred_bytes;
         guint64 n_ignored_bytes;
 
-	ArvHistogram *histogram;
+	guint64 n_kernel_dropped_packets;
+
+	/* Filled with the frame lock held when there are several receiver threads, a single shard is enough */
+	ArvHdrHistogram *histogram;
 	guint32 statistic_count;
 
+	/* Packet counter rates, sampled with the frame lock held */
+	ArvRateWindow *rate_window;
+
+	/* Smoothed inter-packet delay and its mean deviation, for the adaptive resend timing */
+	double inter_packet_mean_us;
+	double inter_packet_deviation_us;
+	gboolean has_inter_packet_estimate;
+
 	ArvGvStreamSocketBuffer socket_buffer_option;
 	int socket_buffer_size;
+	int socket_buffer_max_size;
 	int current_socket_buffer_size;
+
+	/* Last value of the kernel drop counter of the stream socket, and the socket buffer size grown from the
+	 * detected drops in auto mode */
+	guint32 n_socket_drops;
+	int grown_socket_buffer_size;
+
+	/* Stall watchdog, based on the frame period smoothed over the frame starts */
+	ArvGvStreamStallWatchdog stall_watchdog;
+	guint stall_frames;
+	guint64 last_received_time_us;
+	guint64 last_frame_start_us;
+	double frame_period_us;
+	gboolean is_stalled;
+	guint n_stall_recovery_attempts;
+	guint64 next_stall_recovery_us;
+	guint64 n_stalls;
+	guint64 n_stall_recoveries;
 };
 
+static inline void
+_frame_lock (ArvGvStreamThreadData *thread_data)
+{
+	if (thread_data->n_receivers > 0)
+		g_mutex_lock (&thread_data->frame_mutex);
+}
+
+static inline void
+_frame_unlock (ArvGvStreamThreadData *thread_data)
+{
+	if (thread_data->n_receivers > 0)
+		g_mutex_unlock (&thread_data->frame_mutex);
+}
+
 static void
 _send_packet_request (ArvGvStreamThreadData *thread_data,
 		      guint64 frame_id,
@@ -191,24 +589,85 @@ _send_packet_request (ArvGvStreamThreadData *thread_data,
 		      guint32 last_block,
 		      gboolean extended_ids)
 {
-	ArvGvcpPacket *packet;
+	/* Built on the stack, resend requests are on the hot path of lossy links */
+	guint64 packet_data[(ARV_GVCP_PACKET_RESEND_CMD_SIZE_MAX + sizeof (guint64) - 1) / sizeof (guint64)];
+	ArvGvcpPacket *packet = (ArvGvcpPacket *) packet_data;
 	size_t packet_size;
 
 	thread_data->packet_id = arv_gvcp_next_packet_id (thread_data->packet_id);
 
-	packet = arv_gvcp_packet_new_packet_resend_cmd (frame_id, first_block, last_block, extended_ids,
-							thread_data->packet_id, &packet_size);
+	packet_size = arv_gvcp_packet_init_packet_resend_cmd (packet, frame_id, first_block, last_block, extended_ids,
+							      thread_data->stream_channel, thread_data->packet_id);
 
 	arv_debug_stream_thread ("[GvStream::send_packet_request] frame_id = %" G_GUINT64_FORMAT
 			       " (from packet %" G_GUINT32_FORMAT " to %" G_GUINT32_FORMAT ")",
 			       frame_id, first_block, last_block);
 
+	ARV_TRACEPOINT (gv_packet_resend_request, frame_id, first_block, last_block, g_get_monotonic_time ());
+
 	arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
 
-	g_socket_send_to (thread_data->socket, thread_data->device_socket_address, (const char *) packet, packet_size,
-			  NULL, NULL);
+	if (thread_data->socket != NULL)
+		g_socket_send_to (thread_data->socket, thread_data->device_socket_address, (const char *) packet,
+				  packet_size, NULL, NULL);
+}
+
+/* Packets dropped by the kernel because the socket buffer was full never reach the stream thread, and are only seen as
+ * missing packets. Their count is reported separately, and in auto mode the socket buffer is doubled on each frame
+ * showing new drops, up to socket-buffer-max-size. */
+
+static guint32
+_read_socket_drops (GSocket *socket, guint32 *last_drops)
+{
+	guint32 n_drops;
+	guint32 n_new_drops;
+
+	if (!arv_socket_get_n_drops (g_socket_get_fd (socket), &n_drops))
+		return 0;
+
+	n_new_drops = n_drops - *last_drops;
+	*last_drops = n_drops;
+
+	return n_new_drops;
+}
+
+static void
+_check_socket_drops (ArvGvStreamThreadData *thread_data)
+{
+	guint64 n_new_drops;
+	int max_size;
+	guint i;
+
+	n_new_drops = _read_socket_drops (thread_data->socket, &thread_data->n_socket_drops);
+	for (i = 0; i < thread_data->n_receivers; i++)
+		n_new_drops += _read_socket_drops (thread_data->receivers[i].socket,
+						   &thread_data->receivers[i].n_socket_drops);
+
+	if (n_new_drops == 0)
+		return;
+
+	thread_data->n_kernel_dropped_packets += n_new_drops;
+
+	if (thread_data->socket_buffer_option != ARV_GV_STREAM_SOCKET_BUFFER_AUTO ||
+	    thread_data->current_socket_buffer_size <= 0)
+		return;
+
+	max_size = thread_data->socket_buffer_max_size > 0 ?
+		thread_data->socket_buffer_max_size :
+		ARV_GV_STREAM_SOCKET_BUFFER_DEFAULT_MAX_SIZE;
+
+	if (thread_data->current_socket_buffer_size >= max_size) {
+		arv_debug_stream_thread ("[GvStream::check_socket_drops] %" G_GUINT64_FORMAT
+					 " packets dropped by the kernel, socket buffer already at its maximum size",
+					 n_new_drops);
+		return;
+	}
+
+	thread_data->grown_socket_buffer_size = MIN ((gint64) thread_data->current_socket_buffer_size * 2, max_size);
 
-	arv_gvcp_packet_free (packet);
+	arv_info_stream_thread ("[GvStream::check_socket_drops] %" G_GUINT64_FORMAT
+				" packets dropped by the kernel, growing socket buffer to %d",
+				n_new_drops, thread_data->grown_socket_buffer_size);
 }
 
 static void
@@ -216,6 +675,12 @@ _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 {
 	int buffer_size = thread_data->current_socket_buffer_size;
 	int fd;
+	guint i;
+
+	if (thread_data->socket == NULL)
+		return;
+
+	_check_socket_drops (thread_data);
 
 	if (thread_data->socket_buffer_option == ARV_GV_STREAM_SOCKET_BUFFER_FIXED &&
 	    thread_data->socket_buffer_size <= 0)
@@ -229,9 +694,11 @@ _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 			break;
 		case ARV_GV_STREAM_SOCKET_BUFFER_AUTO:
 			if (thread_data->socket_buffer_size <= 0)
-				buffer_size = buffer->priv->allocated_size;
+				buffer_size = buffer->priv->window_offset + buffer->priv->allocated_size;
 			else
-				buffer_size = MIN (buffer->priv->allocated_size, thread_data->socket_buffer_size);
+				buffer_size = MIN (buffer->priv->window_offset + buffer->priv->allocated_size,
+						   thread_data->socket_buffer_size);
+			buffer_size = MAX (buffer_size, thread_data->grown_socket_buffer_size);
 			break;
 	}
 
@@ -239,6 +706,8 @@ _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 		gboolean result;
 
 		result = arv_socket_set_recv_buffer_size (fd, buffer_size);
+		for (i = 0; i < thread_data->n_receivers; i++)
+			arv_socket_set_recv_buffer_size (g_socket_get_fd (thread_data->receivers[i].socket), buffer_size);
 		if (result) {
 			thread_data->current_socket_buffer_size = buffer_size;
 			arv_info_stream_thread ("[GvStream::update_socket] Socket buffer size set to %d", buffer_size);
@@ -249,11 +718,86 @@ _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 	}
 }
 
+/* Imported pinned and DMA buffer memory is always filled in direct receive mode, when available */
+
+static gboolean
+_use_direct_receive (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
+{
+	return thread_data->direct_receive || buffer->priv->memory_type != ARV_BUFFER_MEMORY_TYPE_SYSTEM;
+}
+
+static void
+_prepare_unpacking (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer = frame->buffer;
+	ArvPixelFormat unpacked_format;
+	size_t n_groups;
+
+	if (!arv_pixel_format_get_unpacking (buffer->priv->pixel_format, &unpacked_format,
+					     &frame->n_group_bytes, &frame->n_group_pixels))
+		return;
+
+	frame->packed_size = (size_t) buffer->priv->width * buffer->priv->height *
+		ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format) / 8;
+	n_groups = frame->packed_size / frame->n_group_bytes;
+	if (n_groups * frame->n_group_pixels * 2 > buffer->priv->allocated_size) {
+		arv_debug_stream_thread ("[GvStream::prepare_unpacking] Buffer too small for unpacked frame %"
+					 G_GUINT64_FORMAT, frame->frame_id);
+		return;
+	}
+
+	/* The data blocks received before the leader, or directly into the buffer, are stored packed */
+	if (frame->received_size > 0 || _use_direct_receive (thread_data, buffer)) {
+		frame->unpack_frame = TRUE;
+		return;
+	}
+
+	frame->packed_format = buffer->priv->pixel_format;
+	buffer->priv->pixel_format = unpacked_format;
+	frame->unpack_blocks = TRUE;
+}
+
+static guint
+_estimate_n_packets (ArvGvStreamThreadData *thread_data, gboolean extended_ids, size_t payload_size)
+{
+	guint32 block_size = thread_data->scps_packet_size -
+		(extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	return (payload_size + block_size - 1) / block_size + 2;
+}
+
+/* Changes the expected number of packets, within the bitmap allocation, clearing the bitmap words not used yet */
+
+static void
+_set_frame_n_packets (ArvGvStreamFrameData *frame, guint n_packets)
+{
+	guint n_words;
+
+	n_packets = MIN (n_packets, frame->max_n_packets);
+	n_words = ARV_GV_STREAM_BITMAP_N_WORDS (n_packets);
+
+	if (n_words > frame->n_cleared_words) {
+		size_t size = (n_words - frame->n_cleared_words) * sizeof (guint64);
+
+		memset (frame->received_packets + frame->n_cleared_words, 0, size);
+		memset (frame->resend_requested_packets + frame->n_cleared_words, 0, size);
+		memset (frame->resend_timeouts_us + frame->n_cleared_words, 0, size);
+		frame->n_cleared_words = n_words;
+	}
+
+	arv_debug_stream_thread ("[GvStream::set_frame_n_packets] Update expected number of packets (%u → %u)",
+				 frame->n_packets, n_packets);
+
+	frame->n_packets = n_packets;
+}
+
 static void
 _process_data_leader (ArvGvStreamThreadData *thread_data,
 		      ArvGvStreamFrameData *frame,
 		      const ArvGvspPacket *packet,
-		      guint32 packet_id)
+		      guint32 packet_id,
+		      size_t read_count,
+		      guint64 packet_timestamp_ns)
 {
 	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
 		return;
@@ -265,9 +809,11 @@ _process_data_leader (ArvGvStreamThreadData *thread_data,
 
 	frame->buffer->priv->payload_type = arv_gvsp_packet_get_buffer_payload_type (packet);
 	frame->buffer->priv->frame_id = frame->frame_id;
+	thread_data->leader_payload_type = frame->buffer->priv->payload_type;
 	frame->buffer->priv->chunk_endianness = G_BIG_ENDIAN;
 
-	frame->buffer->priv->system_timestamp_ns = g_get_real_time() * 1000LL;
+	frame->buffer->priv->system_timestamp_ns = packet_timestamp_ns != 0 ?
+		packet_timestamp_ns : g_get_real_time() * 1000LL;
 	if (frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_H264) {
 		if (G_LIKELY (thread_data->timestamp_tick_frequency != 0))
 			frame->buffer->priv->timestamp_ns = arv_gvsp_packet_get_timestamp (packet,
@@ -278,32 +824,206 @@ _process_data_leader (ArvGvStreamThreadData *thread_data,
 	} else
 		frame->buffer->priv->timestamp_ns = frame->buffer->priv->system_timestamp_ns;
 
+	frame->buffer->priv->host_timestamp_ns = thread_data->timestamp_tick_frequency != 0 ?
+		arv_clock_model_to_host (thread_data->clock_model, frame->buffer->priv->timestamp_ns) : 0;
+
 	if (arv_buffer_payload_type_has_aoi (frame->buffer->priv->payload_type)) {
 		frame->buffer->priv->x_offset = arv_gvsp_packet_get_x_offset (packet);
 		frame->buffer->priv->y_offset = arv_gvsp_packet_get_y_offset (packet);
 		frame->buffer->priv->width = arv_gvsp_packet_get_width (packet);
 		frame->buffer->priv->height = arv_gvsp_packet_get_height (packet);
 		frame->buffer->priv->pixel_format = arv_gvsp_packet_get_pixel_format (packet);
+	} else if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+		guint n_parts = arv_gvsp_packet_get_n_parts (packet, read_count);
+		size_t data_offset = 0;
+		guint i;
+
+		/* The parts are stored one after the other in the buffer, in the leader order */
+		arv_buffer_set_n_parts (frame->buffer, n_parts);
+		for (i = 0; i < n_parts; i++) {
+			const ArvGvspPartInfos *infos = arv_gvsp_packet_get_part_infos (packet, i);
+			ArvBufferPartInfos *part = &frame->buffer->priv->parts[i];
+
+			part->data_offset = data_offset;
+			part->size = arv_gvsp_part_infos_get_length (infos);
+			part->component_id = infos->source_id;
+			part->data_type = g_ntohs (infos->data_type);
+			part->pixel_format = g_ntohl (infos->pixel_format);
+			part->width = g_ntohl (infos->width);
+			part->height = g_ntohl (infos->height);
+			part->x_offset = g_ntohl (infos->x_offset);
+			part->y_offset = g_ntohl (infos->y_offset);
+			part->x_padding = g_ntohs (infos->x_padding);
+			part->y_padding = g_ntohl (infos->y_padding);
+
+			data_offset += part->size;
+		}
+
+		if (data_offset > frame->buffer->priv->allocated_size) {
+			arv_info_stream_thread ("[GvStream::process_data_leader] Multipart payload too large for buffer"
+						" (%" G_GSIZE_FORMAT " > %" G_GSIZE_FORMAT ")",
+						data_offset, frame->buffer->priv->allocated_size);
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		}
+	}
+
+	/* Refine the expected number of packets from the leader payload information, unless the trailer was already
+	 * received, or packets were received past the new estimation */
+	if (!frame->n_packets_known) {
+		guint n_packets = 0;
+
+		if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE) {
+			n_packets = _estimate_n_packets (thread_data, frame->extended_ids,
+							 (size_t) frame->buffer->priv->width * frame->buffer->priv->height *
+							 ARV_PIXEL_FORMAT_BIT_PER_PIXEL (frame->buffer->priv->pixel_format) / 8);
+		} else if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+			guint32 block_size = thread_data->scps_packet_size - ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD -
+				sizeof (ArvGvspMultipart);
+			guint i;
+
+			n_packets = 2;
+			for (i = 0; i < frame->buffer->priv->n_parts; i++)
+				n_packets += (frame->buffer->priv->parts[i].size + block_size - 1) / block_size;
+		}
+
+		if (n_packets > 2 && n_packets != frame->n_packets &&
+		    (n_packets > frame->n_packets ||
+		     _bitmap_find (frame->received_packets, n_packets, frame->n_packets, TRUE) >= frame->n_packets))
+			_set_frame_n_packets (frame, n_packets);
 	}
 
-	if (frame->packet_data[packet_id].resend_requested) {
+	if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE &&
+	    arv_stream_get_unpack_pixels (thread_data->stream))
+		_prepare_unpacking (thread_data, frame);
+
+	/* Image statistics are accumulated block by block only for the blocks stored as received, in the receiving
+	 * thread, the other cases being processed in one pass on completion */
+	if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE &&
+	    arv_stream_get_compute_statistics (thread_data->stream) &&
+	    !frame->unpack_blocks && !frame->unpack_frame &&
+	    frame->received_size == 0 && thread_data->n_receivers == 0)
+		arv_buffer_statistics_start (frame->buffer, arv_stream_get_statistics_grid_size (thread_data->stream));
+
+	frame->copy_mode = _select_copy_mode (thread_data, frame);
+
+	if (_bitmap_get (frame->resend_requested_packets, packet_id)) {
 		thread_data->n_resent_packets++;
+		frame->buffer->priv->metadata.n_resent_packets++;
+		ARV_TRACEPOINT (gv_resent_packet, frame->frame_id, packet_id);
 		arv_debug_stream_thread ("[GvStream::process_data_leader] Received resent packet %u for frame %" G_GUINT64_FORMAT,
 				       packet_id, frame->frame_id);
 	}
 }
 
+/* The non-temporal copies keep the frames larger than the last level cache out of it, unless the receiving thread reads
+ * the data next, for the statistics, the in place unpacking or an inline processing stage. */
+
+static ArvMemoryCopyMode
+_select_copy_mode (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	switch (thread_data->payload_copy) {
+		case ARV_GV_STREAM_PAYLOAD_COPY_TEMPORAL:
+			return ARV_MEMORY_COPY_MODE_TEMPORAL;
+		case ARV_GV_STREAM_PAYLOAD_COPY_NON_TEMPORAL:
+			return ARV_MEMORY_COPY_MODE_NON_TEMPORAL;
+		default:
+			break;
+	}
+
+	return arv_memory_select_copy_mode (frame->buffer->priv->allocated_size,
+					    frame->unpack_frame ||
+					    arv_stream_get_compute_statistics (thread_data->stream) ||
+					    arv_stream_has_inline_stages (thread_data->stream));
+}
+
+/* When unpacking, the bytes of the pixel groups crossing the data block boundaries are stored raw at the place of the
+ * unpacked group, which is only written by _finish_unpacking. */
+
+static void
+_store_data_block (ArvGvStreamFrameData *frame, const void *data, size_t block_offset, size_t block_size)
+{
+	guint8 *buffer_data = frame->buffer->priv->data;
+	size_t n_group_bytes = frame->n_group_bytes;
+	size_t n_unpacked_bytes = frame->n_group_pixels * 2;
+	size_t block_end = block_offset + block_size;
+	size_t first_group, end_group;
+	size_t i;
+
+	if (!frame->unpack_blocks) {
+		arv_memory_copy (buffer_data + block_offset, data, block_size, frame->copy_mode);
+		return;
+	}
+
+	first_group = (block_offset + n_group_bytes - 1) / n_group_bytes;
+	end_group = block_end / n_group_bytes;
+
+	if (end_group > first_group)
+		arv_buffer_unpack_pixel_groups (frame->packed_format,
+						(const guint8 *) data + first_group * n_group_bytes - block_offset,
+						end_group - first_group,
+						buffer_data + first_group * n_unpacked_bytes);
+
+	for (i = block_offset; i < MIN (first_group * n_group_bytes, block_end); i++)
+		buffer_data[(i / n_group_bytes) * n_unpacked_bytes + i % n_group_bytes] =
+			((const guint8 *) data)[i - block_offset];
+	for (i = MAX (end_group, first_group) * n_group_bytes; i < block_end; i++)
+		buffer_data[(i / n_group_bytes) * n_unpacked_bytes + i % n_group_bytes] =
+			((const guint8 *) data)[i - block_offset];
+}
+
+static void
+_finish_unpacking (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	guint8 *buffer_data = frame->buffer->priv->data;
+	size_t n_unpacked_bytes = frame->n_group_pixels * 2;
+	size_t block_size;
+	size_t offset;
+	size_t last_group = G_MAXSIZE;
+
+	if (frame->unpack_frame) {
+		arv_buffer_unpack_pixels (frame->buffer);
+		return;
+	}
+
+	if (!frame->unpack_blocks)
+		return;
+
+	/* All the data blocks but the last one have the same size */
+	block_size = thread_data->scps_packet_size - (frame->extended_ids ?
+						      ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+						      ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	for (offset = block_size; offset < frame->packed_size; offset += block_size) {
+		size_t group = offset / frame->n_group_bytes;
+		guint8 group_data[8];
+
+		/* Small blocks may put several boundaries in the same group */
+		if (offset % frame->n_group_bytes == 0 || group == last_group)
+			continue;
+		last_group = group;
+
+		memcpy (group_data, buffer_data + group * n_unpacked_bytes, frame->n_group_bytes);
+		arv_buffer_unpack_pixel_groups (frame->packed_format, group_data, 1,
+						buffer_data + group * n_unpacked_bytes);
+	}
+
+	frame->buffer->priv->received_size = MIN (frame->received_size, frame->packed_size) /
+		frame->n_group_bytes * n_unpacked_bytes;
+}
+
 static void
 _process_data_block (ArvGvStreamThreadData *thread_data,
 		     ArvGvStreamFrameData *frame,
 		     const ArvGvspPacket *packet,
-		     guint32 packet_id,
+		     const ArvGvspHeaderInfos *header,
+		     const void *data,
 		     size_t read_count)
 {
+	guint32 packet_id = header->packet_id;
 	size_t block_size;
 	ptrdiff_t block_offset;
 	ptrdiff_t block_end;
-	gboolean extended_ids;
+	ptrdiff_t payload_end;
 
 	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
 		return;
@@ -314,31 +1034,121 @@ _process_data_block (ArvGvStreamThreadData *thread_data,
 		return;
 	}
 
-	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
+	/* Before the leader, the location of a multipart data block is unknown, as it depends on the part sizes. When
+	 * the stream may be multipart, the block is left unreceived, in order to get it resent after the leader. */
+	if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN && header->extended_ids &&
+	    (thread_data->leader_payload_type == ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN ||
+	     thread_data->leader_payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART)) {
+		arv_debug_stream_thread ("[GvStream::process_data_block] Packet %u of frame %" G_GUINT64_FORMAT
+					 " received before the leader", packet_id, frame->frame_id);
+		_bitmap_clear (frame->received_packets, packet_id);
+		thread_data->n_ignored_packets++;
+		return;
+	}
+
+	block_size = read_count - header->header_size;
+
+	if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+		guint64 multipart_offset;
+		guint part_id;
+
+		/* Multipart data blocks carry their offset in the part, the packet size is not constant */
+		if (block_size < sizeof (ArvGvspMultipart) ||
+		    (part_id = arv_gvsp_packet_get_multipart_part_id (packet)) >= frame->buffer->priv->n_parts) {
+			arv_gvsp_packet_debug (packet, read_count, ARV_DEBUG_LEVEL_INFO);
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+			return;
+		}
+
+		block_size -= sizeof (ArvGvspMultipart);
+		multipart_offset = arv_gvsp_packet_get_multipart_offset (packet);
+
+		/* The block must stay in its part */
+		if (multipart_offset > frame->buffer->priv->parts[part_id].size ||
+		    block_size > frame->buffer->priv->parts[part_id].size - multipart_offset) {
+			arv_info_stream_thread ("[GvStream::process_data_block] Block of packet %u out of part %u"
+						" for frame %" G_GUINT64_FORMAT, packet_id, part_id, frame->frame_id);
+			thread_data->n_size_mismatch_errors++;
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+			return;
+		}
 
-	block_size = arv_gvsp_packet_get_data_size (packet, read_count);
-	block_offset = (packet_id - 1) * (thread_data->scps_packet_size - (extended_ids ?
-									   ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
-									   ARV_GVSP_PACKET_PROTOCOL_OVERHEAD));
+		block_offset = frame->buffer->priv->parts[part_id].data_offset + multipart_offset;
+		data = ((const ArvGvspMultipart *) header->data)->data;
+	} else
+		block_offset = (packet_id - 1) * (thread_data->scps_packet_size - (header->extended_ids ?
+										   ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+										   ARV_GVSP_PACKET_PROTOCOL_OVERHEAD));
 	block_end = block_size + block_offset;
+	payload_end = frame->buffer->priv->window_offset + frame->buffer->priv->allocated_size;
+
+	/* Nothing of the block fits in the buffer, the size clamps below would wrap around */
+	if (block_offset >= payload_end) {
+		arv_info_stream_thread ("[GvStream::process_data_block] Packet %u out of the buffer"
+					" for frame %" G_GUINT64_FORMAT, packet_id, frame->frame_id);
+		thread_data->n_size_mismatch_errors++;
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		return;
+	}
+
+	/* The unpacked image size was checked against the buffer size on leader reception */
+	if (frame->unpack_blocks && block_end > frame->packed_size) {
+		arv_info_stream_thread ("[GvStream::process_data_block] %" G_GINTPTR_FORMAT " unexpected bytes in packet %u "
+					 " for frame %" G_GUINT64_FORMAT,
+					 block_end - (ptrdiff_t) frame->packed_size,
+					 packet_id, frame->frame_id);
+		thread_data->n_size_mismatch_errors++;
+
+		block_end = MAX (block_offset, (ptrdiff_t) frame->packed_size);
+		block_size = block_end - block_offset;
+	}
 
-	if (block_end > frame->buffer->priv->allocated_size) {
+	if (block_end > payload_end) {
 		arv_info_stream_thread ("[GvStream::process_data_block] %" G_GINTPTR_FORMAT " unexpected bytes in packet %u "
 					 " for frame %" G_GUINT64_FORMAT,
-					 block_end - frame->buffer->priv->allocated_size,
+					 block_end - payload_end,
 					 packet_id, frame->frame_id);
 		thread_data->n_size_mismatch_errors++;
 
-		block_end = frame->buffer->priv->allocated_size;
+		block_end = payload_end;
 		block_size = block_end - block_offset;
 	}
 
-	memcpy (((char *) frame->buffer->priv->data) + block_offset, arv_gvsp_packet_get_data (packet), block_size);
+	if (data == NULL)
+		data = header->data;
+
+	if (frame->buffer->priv->window_offset > 0) {
+		ptrdiff_t window_offset = frame->buffer->priv->window_offset;
+
+		/* Chunk only buffers keep the end of the payload, the data before are only accounted */
+		if (block_end > window_offset) {
+			ptrdiff_t skipped_size = MAX (window_offset - block_offset, 0);
+
+			memcpy (((char *) frame->buffer->priv->data) + block_offset + skipped_size - window_offset,
+				(const char *) data + skipped_size, block_end - block_offset - skipped_size);
+		}
+	} else if (data == ((char *) frame->buffer->priv->data) + block_offset) {
+		/* In direct receive mode, the payload may already be at its final place */
+		thread_data->n_direct_packets++;
+	} else if (thread_data->n_receivers > 0) {
+		/* The frame can't be closed while the copy is pending */
+		frame->n_pending_copies++;
+		g_mutex_unlock (&thread_data->frame_mutex);
+		_store_data_block (frame, data, block_offset, block_size);
+		g_mutex_lock (&thread_data->frame_mutex);
+		frame->n_pending_copies--;
+	} else
+		_store_data_block (frame, data, block_offset, block_size);
+
+	if (frame->buffer->priv->window_offset == 0)
+		arv_buffer_statistics_add_block (frame->buffer, block_offset, block_size);
 
         frame->received_size += block_size;
 
-	if (frame->packet_data[packet_id].resend_requested) {
+	if (_bitmap_get (frame->resend_requested_packets, packet_id)) {
 		thread_data->n_resent_packets++;
+		frame->buffer->priv->metadata.n_resent_packets++;
+		ARV_TRACEPOINT (gv_resent_packet, frame->frame_id, packet_id);
 		arv_debug_stream_thread ("[GvStream::process_data_block] Received resent packet %u for frame %" G_GUINT64_FORMAT,
 				       packet_id, frame->frame_id);
 	}
@@ -357,25 +1167,249 @@ _process_data_trailer (ArvGvStreamThreadData *thread_data,
                 return;
         }
 
-        /* Trailer packet received before expected, because the actual payload size is smaller than the buffer size */
-        if (frame->n_packets != packet_id + 1) {
-		arv_debug_stream_thread ("[GvStream::process_data_trailer] Update expected number of packets (%u → %u)",
-                                         frame->n_packets, packet_id + 1);
-                frame->n_packets = packet_id + 1;
-        }
+        /* The trailer fixes the expected number of packets, which was only estimated from the payload size */
+        if (frame->n_packets != packet_id + 1)
+		_set_frame_n_packets (frame, packet_id + 1);
+	frame->n_packets_known = TRUE;
 
-	if (frame->packet_data[packet_id].resend_requested) {
+	if (_bitmap_get (frame->resend_requested_packets, packet_id)) {
 		thread_data->n_resent_packets++;
+		frame->buffer->priv->metadata.n_resent_packets++;
+		ARV_TRACEPOINT (gv_resent_packet, frame->frame_id, packet_id);
 		arv_debug_stream_thread ("[GvStream::process_data_trailer] Received resent packet %u for frame %"
                                          G_GUINT64_FORMAT,
                                          packet_id, frame->frame_id);
         }
 }
 
+/* Returns the index-th frame, in arrival order */
+
 static ArvGvStreamFrameData *
-_find_frame_data (ArvGvStreamThreadData *thread_data,
-		  const ArvGvspPacket *packet,
-		  size_t packet_size,
+_get_frame (ArvGvStreamThreadData *thread_data, guint index)
+{
+	return &thread_data->frame_ring[thread_data->frame_order[(thread_data->first_frame + index) &
+								 ARV_GV_STREAM_FRAME_RING_MASK]];
+}
+
+static ArvGvStreamFrameData *
+_find_frame_by_id (ArvGvStreamThreadData *thread_data, guint64 frame_id)
+{
+	ArvGvStreamFrameData *frame;
+
+	frame = thread_data->last_hit_frame;
+	if (frame != NULL && frame->buffer != NULL && frame->frame_id == frame_id)
+		return frame;
+
+	frame = &thread_data->frame_ring[frame_id & ARV_GV_STREAM_FRAME_RING_MASK];
+	if (frame->buffer != NULL && frame->frame_id == frame_id) {
+		thread_data->last_hit_frame = frame;
+		return frame;
+	}
+
+	return NULL;
+}
+
+/* Builds the map of the data received in an incomplete frame from the packet bitmap, all the data blocks but the last
+ * one having the same size. The multipart and chunk only frames, whose block offsets can't be derived from the packet
+ * ids, are not mapped. */
+
+static void
+_set_valid_ranges (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer = frame->buffer;
+	size_t block_size;
+	size_t last_block_size;
+	size_t data_size;
+	size_t valid_end = 0;
+	guint end_packet;
+	guint n_received;
+	guint first, end;
+
+	if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ||
+	    buffer->priv->window_offset > 0 ||
+	    frame->n_packets < 3 ||
+	    frame->received_size == 0)
+		return;
+
+	block_size = thread_data->scps_packet_size - (frame->extended_ids ?
+						      ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+						      ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	/* Data blocks are in the [1, n_packets - 1[ packet id range */
+	end_packet = frame->n_packets - 1;
+	n_received = _bitmap_count (frame->received_packets, 1, end_packet);
+	if (n_received == 0)
+		return;
+
+	/* The received size being the sum of the received block sizes, it gives the size of the last block */
+	last_block_size = block_size;
+	if (_bitmap_find (frame->received_packets, end_packet - 1, end_packet, TRUE) == end_packet - 1 &&
+	    frame->received_size > (n_received - 1) * block_size)
+		last_block_size = MIN (frame->received_size - (n_received - 1) * block_size, block_size);
+
+	data_size = frame->unpack_blocks ? frame->packed_size : buffer->priv->allocated_size;
+
+	if (frame->unpack_blocks)
+		_finish_unpacking (thread_data, frame);
+
+	for (first = _bitmap_find (frame->received_packets, 1, end_packet, TRUE);
+	     first < end_packet;
+	     first = _bitmap_find (frame->received_packets, end, end_packet, TRUE)) {
+		size_t offset;
+		size_t range_end;
+
+		end = _bitmap_find (frame->received_packets, first, end_packet, FALSE);
+
+		offset = (size_t) (first - 1) * block_size;
+		range_end = (size_t) (end - 1) * block_size;
+		if (end == end_packet)
+			range_end = range_end - block_size + last_block_size;
+		range_end = MIN (range_end, data_size);
+		if (offset >= range_end)
+			break;
+
+		/* Only the pixel groups fully inside the range are unpacked */
+		if (frame->unpack_blocks) {
+			size_t n_unpacked_bytes = frame->n_group_pixels * 2;
+
+			offset = (offset + frame->n_group_bytes - 1) / frame->n_group_bytes * n_unpacked_bytes;
+			range_end = range_end / frame->n_group_bytes * n_unpacked_bytes;
+			if (offset >= range_end)
+				continue;
+		}
+
+		arv_buffer_add_valid_range (buffer, offset, range_end - offset);
+		valid_end = range_end;
+	}
+
+	buffer->priv->received_size = valid_end;
+
+	arv_debug_stream_thread ("[GvStream::set_valid_ranges] %" G_GSIZE_FORMAT " bytes of frame %" G_GUINT64_FORMAT
+				 " received in %u range(s)", arv_buffer_get_valid_size (buffer), frame->frame_id,
+				 buffer->priv->valid_ranges != NULL ? buffer->priv->valid_ranges->len : 0);
+}
+
+static void
+_close_frame (ArvGvStreamThreadData *thread_data,
+              guint64 time_us,
+              ArvGvStreamFrameData *frame)
+{
+	frame->buffer->priv->first_packet_time_us = frame->first_packet_time_us;
+	frame->buffer->priv->last_packet_time_us = frame->last_packet_time_us;
+
+	if (thread_data->socket != NULL)
+		_check_socket_drops (thread_data);
+	frame->buffer->priv->metadata.n_kernel_dropped_packets = thread_data->n_kernel_dropped_packets -
+		frame->n_kernel_dropped_packets;
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS) {
+		arv_buffer_update_chunk_index (frame->buffer);
+		thread_data->n_completed_buffers++;
+	} else
+		if (frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
+			thread_data->n_failures++;
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_TIMEOUT)
+		thread_data->n_timeouts++;
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_ABORTED)
+		thread_data->n_aborted++;
+
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
+	    frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED) {
+		guint n_missing_packets = frame->n_packets - _bitmap_count (frame->received_packets, 0, frame->n_packets);
+
+		thread_data->n_missing_packets += n_missing_packets;
+		frame->buffer->priv->metadata.n_missing_packets += n_missing_packets;
+	}
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_MISSING_PACKETS ||
+	    frame->buffer->priv->status == ARV_BUFFER_STATUS_TIMEOUT)
+		_set_valid_ranges (thread_data, frame);
+
+	ARV_TRACEPOINT (gv_frame_done, frame->frame_id, frame->buffer->priv->status,
+			frame->first_packet_time_us, time_us);
+
+	arv_stream_push_output_buffer (thread_data->stream, frame->buffer);
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+				       frame->buffer);
+
+	if (thread_data->timing_statistics)
+		arv_hdr_histogram_fill (thread_data->histogram, 0, 0, time_us - frame->first_packet_time_us);
+
+	arv_debug_stream_thread ("[GvStream::close_frame] Close frame %" G_GUINT64_FORMAT, frame->frame_id);
+
+	frame->buffer = NULL;
+	frame->frame_id = 0;
+}
+
+static void
+_close_first_frame (ArvGvStreamThreadData *thread_data,
+		    guint64 time_us)
+{
+	ArvGvStreamFrameData *frame;
+
+	g_return_if_fail (thread_data->n_frames > 0);
+
+	frame = _get_frame (thread_data, 0);
+
+	_close_frame (thread_data, time_us, frame);
+
+	thread_data->first_frame = (thread_data->first_frame + 1) & ARV_GV_STREAM_FRAME_RING_MASK;
+	thread_data->n_frames--;
+	if (thread_data->last_hit_frame == frame)
+		thread_data->last_hit_frame = NULL;
+}
+
+static void
+_update_inter_packet_estimate (ArvGvStreamThreadData *thread_data, gint64 delay_us)
+{
+	double error_us;
+
+	if (delay_us < 0)
+		return;
+
+	if (!thread_data->has_inter_packet_estimate) {
+		thread_data->inter_packet_mean_us = delay_us;
+		thread_data->inter_packet_deviation_us = delay_us / 2.0;
+		thread_data->has_inter_packet_estimate = TRUE;
+		return;
+	}
+
+	/* Same gains as the TCP retransmission timer estimator (RFC 6298) */
+	error_us = delay_us - thread_data->inter_packet_mean_us;
+	thread_data->inter_packet_mean_us += error_us / 8.0;
+	thread_data->inter_packet_deviation_us += (fabs (error_us) - thread_data->inter_packet_deviation_us) / 4.0;
+}
+
+/* Grows the bitmaps of the idle ring slots along with the ones of a new frame, which moves the allocations to the first
+ * frame of the acquisition, instead of the first use of each slot */
+
+static void
+_grow_frame_bitmaps (ArvGvStreamThreadData *thread_data, guint n_words)
+{
+	guint i;
+
+	for (i = 0; i < ARV_GV_STREAM_FRAME_RING_SIZE; i++) {
+		ArvGvStreamFrameData *frame = &thread_data->frame_ring[i];
+
+		if (frame->buffer != NULL || frame->n_allocated_words >= n_words)
+			continue;
+
+		g_free (frame->received_packets);
+		frame->received_packets = g_new0 (guint64, 3 * n_words);
+		frame->resend_requested_packets = frame->received_packets + n_words;
+		frame->resend_timeouts_us = frame->received_packets + 2 * n_words;
+		frame->n_allocated_words = n_words;
+	}
+}
+
+static ArvGvStreamFrameData *
+_find_frame_data (ArvGvStreamThreadData *thread_data,
+		  const ArvGvspPacket *packet,
+		  size_t packet_size,
 		  guint64 frame_id,
 		  guint32 packet_id,
 		  gboolean extended_ids,
@@ -383,21 +1417,28 @@ _find_frame_data (ArvGvStreamThreadData *thread_data,
 		  guint64 time_us)
 {
 	ArvGvStreamFrameData *frame = NULL;
+	guint64 *packet_bitmaps;
 	ArvBuffer *buffer;
-	GSList *iter;
 	guint n_packets = 0;
+	guint max_n_packets;
+	guint n_words;
+	guint n_allocated_words;
 	gint64 frame_id_inc;
 	guint32 block_size;
+	size_t payload_size;
 
-	for (iter = thread_data->frames; iter != NULL; iter = iter->next) {
-		frame = iter->data;
-		if (frame->frame_id == frame_id) {
-                        arv_histogram_fill (thread_data->histogram, 1, time_us - frame->first_packet_time_us);
-                        arv_histogram_fill (thread_data->histogram, 2, time_us - frame->last_packet_time_us);
-
-			frame->last_packet_time_us = time_us;
-			return frame;
+	frame = _find_frame_by_id (thread_data, frame_id);
+	if (frame != NULL) {
+		if (thread_data->timing_statistics) {
+			arv_hdr_histogram_fill (thread_data->histogram, 0, 1,
+						time_us - frame->first_packet_time_us);
+			arv_hdr_histogram_fill (thread_data->histogram, 0, 2,
+						time_us - frame->last_packet_time_us);
 		}
+		_update_inter_packet_estimate (thread_data, time_us - frame->last_packet_time_us);
+
+		frame->last_packet_time_us = time_us;
+		return frame;
 	}
 
 	if (extended_ids) {
@@ -420,6 +1461,29 @@ _find_frame_data (ArvGvStreamThreadData *thread_data,
 		return NULL;
 	}
 
+	/* The slot is still used by an older frame, which means too many frames are in flight. Close the oldest ones
+	 * until the slot is released. */
+	frame = &thread_data->frame_ring[frame_id & ARV_GV_STREAM_FRAME_RING_MASK];
+	while (frame->buffer != NULL) {
+		ArvGvStreamFrameData *first_frame = _get_frame (thread_data, 0);
+
+		if (first_frame->n_pending_copies > 0)
+			return NULL;
+
+		arv_warning_stream_thread ("[GvStream::find_frame_data] Too many frames in flight, close frame %"
+					   G_GUINT64_FORMAT, first_frame->frame_id);
+		first_frame->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+		_close_first_frame (thread_data, time_us);
+	}
+
+	if (thread_data->last_frame_start_us > 0 && time_us > thread_data->last_frame_start_us) {
+		double period_us = time_us - thread_data->last_frame_start_us;
+
+		thread_data->frame_period_us = thread_data->frame_period_us > 0.0 ?
+			0.875 * thread_data->frame_period_us + 0.125 * period_us : period_us;
+	}
+	thread_data->last_frame_start_us = time_us;
+
 	buffer = arv_stream_pop_input_buffer (thread_data->stream);
 	if (buffer == NULL) {
 		thread_data->n_underruns++;
@@ -430,7 +1494,9 @@ _find_frame_data (ArvGvStreamThreadData *thread_data,
 	block_size = thread_data->scps_packet_size -
 		(extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
 
-	frame = g_new0 (ArvGvStreamFrameData, 1);
+	packet_bitmaps = frame->received_packets;
+	n_allocated_words = frame->n_allocated_words;
+	memset (frame, 0, sizeof (ArvGvStreamFrameData));
 
 	frame->disable_resend_request = FALSE;
 
@@ -439,15 +1505,51 @@ _find_frame_data (ArvGvStreamThreadData *thread_data,
 
 	frame->buffer = buffer;
 	_update_socket (thread_data, frame->buffer);
+	frame->n_kernel_dropped_packets = thread_data->n_kernel_dropped_packets;
 	frame->buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+	/* Set by the leader */
+	frame->buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN;
         frame->buffer->priv->received_size = 0;
-	n_packets = (frame->buffer->priv->allocated_size + block_size - 1) / block_size + 2;
+	frame->buffer->priv->has_chunk_index = FALSE;
+	payload_size = frame->buffer->priv->window_offset + frame->buffer->priv->allocated_size;
+	max_n_packets = (payload_size + block_size - 1) / block_size + 2;
+
+	/* The payload type is not known before the leader reception. Multipart frames, which need extended ids, use
+	 * smaller data blocks, and end each part with a partial block. The trailer packet fixes the estimation. */
+	if (extended_ids) {
+		block_size -= sizeof (ArvGvspMultipart);
+		max_n_packets = (payload_size + block_size - 1) / block_size +
+			ARV_GV_STREAM_MULTIPART_MAX_PARTS + 2;
+	}
+
+	/* Buffers are often larger than the payload, in order to survive the region of interest changes. The packet
+	 * tracking starts with the device payload size, and grows with the leader information or the packet ids. */
+	n_packets = max_n_packets;
+	if (thread_data->payload_size > 0 && thread_data->payload_size < payload_size)
+		n_packets = MIN (max_n_packets, _estimate_n_packets (thread_data, extended_ids,
+								     thread_data->payload_size));
 
 	frame->first_packet_time_us = time_us;
 	frame->last_packet_time_us = time_us;
 
-	frame->packet_data = g_new0 (ArvGvStreamPacketData, n_packets);
-	frame->n_packets = n_packets;
+	ARV_TRACEPOINT (gv_frame_start, frame_id, time_us);
+
+	/* Received and resend requested bitmaps, and resend timeouts, in a single allocation sized for the buffer */
+	n_words = ARV_GV_STREAM_BITMAP_N_WORDS (max_n_packets);
+	if (n_words > n_allocated_words) {
+		g_free (packet_bitmaps);
+		packet_bitmaps = g_new0 (guint64, 3 * n_words);
+		n_allocated_words = n_words;
+		_grow_frame_bitmaps (thread_data, n_words);
+		frame->n_cleared_words = n_words;
+	}
+
+	frame->received_packets = packet_bitmaps;
+	frame->resend_requested_packets = packet_bitmaps + n_allocated_words;
+	frame->resend_timeouts_us = packet_bitmaps + 2 * n_allocated_words;
+	frame->n_allocated_words = n_allocated_words;
+	frame->max_n_packets = max_n_packets;
+	_set_frame_n_packets (frame, n_packets);
 
 	if (thread_data->callback != NULL &&
 	    frame->buffer != NULL)
@@ -463,273 +1565,653 @@ _find_frame_data (ArvGvStreamThreadData *thread_data,
 				       frame_id_inc - 1, frame_id);
 	}
 
-	thread_data->frames = g_slist_append (thread_data->frames, frame);
+	thread_data->frame_order[(thread_data->first_frame + thread_data->n_frames) & ARV_GV_STREAM_FRAME_RING_MASK] =
+		frame - thread_data->frame_ring;
+	thread_data->n_frames++;
+	thread_data->last_hit_frame = frame;
+	thread_data->next_deadline_us = MIN (thread_data->next_deadline_us,
+					     time_us + MIN (thread_data->frame_retention_us,
+							    thread_data->packet_timeout_us));
 
 	arv_debug_stream_thread ("[GvStream::find_frame_data] Start frame %" G_GUINT64_FORMAT, frame_id);
 
 	frame->extended_ids = extended_ids;
 
-        arv_histogram_fill (thread_data->histogram, 1, 0);
+	if (thread_data->timing_statistics)
+		arv_hdr_histogram_fill (thread_data->histogram, 0, 1, 0);
 
 	return frame;
 }
 
 static void
-_missing_packet_check (ArvGvStreamThreadData *thread_data,
-		       ArvGvStreamFrameData *frame,
-		       guint32 packet_id,
-		       guint64 time_us)
+_get_resend_timeouts (ArvGvStreamThreadData *thread_data,
+		      guint *initial_packet_timeout_us,
+		      guint *packet_timeout_us)
 {
-	int i;
+	double jitter_us;
 
-	if (thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER ||
-	    frame->disable_resend_request ||
-	    frame->resend_ratio_reached)
-		return;
+	*initial_packet_timeout_us = thread_data->initial_packet_timeout_us;
+	*packet_timeout_us = thread_data->packet_timeout_us;
 
-	if ((int) (frame->n_packets * thread_data->packet_request_ratio) <= 0)
+	if (thread_data->packet_resend_timing != ARV_GV_STREAM_PACKET_RESEND_TIMING_ADAPTIVE ||
+	    !thread_data->has_inter_packet_estimate)
 		return;
 
-	if (packet_id < frame->n_packets) {
-		int first_missing = -1;
-
-		for (i = frame->last_valid_packet + 1; i <= packet_id + 1; i++) {
-			gboolean need_resend;
-
-			if (i <= packet_id && !frame->packet_data[i].received) {
-                                if (frame->packet_data[i].abs_timeout_us == 0)
-                                        frame->packet_data[i].abs_timeout_us = time_us +
-                                                thread_data->initial_packet_timeout_us;
-                                need_resend = time_us > frame->packet_data[i].abs_timeout_us;
-                        } else
-                                need_resend = FALSE;
+	/* Packets arriving later than this are most likely lost, rather than reordered */
+	jitter_us = thread_data->inter_packet_mean_us + 4.0 * thread_data->inter_packet_deviation_us;
 
-			if (need_resend) {
-				if (first_missing < 0)
-					first_missing = i;
-			}
+	*initial_packet_timeout_us = CLAMP (ARV_GV_STREAM_ADAPTIVE_TIMEOUT_FACTOR * jitter_us,
+					    MIN (ARV_GV_STREAM_ADAPTIVE_TIMEOUT_MIN_US,
+						 thread_data->initial_packet_timeout_us),
+					    thread_data->initial_packet_timeout_us);
+	*packet_timeout_us = CLAMP (4 * ARV_GV_STREAM_ADAPTIVE_TIMEOUT_FACTOR * jitter_us,
+				    MIN (ARV_GV_STREAM_ADAPTIVE_TIMEOUT_MIN_US, thread_data->packet_timeout_us),
+				    thread_data->packet_timeout_us);
+}
 
-			if (i > packet_id || !need_resend) {
-				if (first_missing >= 0) {
-					int last_missing;
-					int n_missing_packets;
-					int j;
+/*
+ * Resend budget: the retransmissions requested by all the streams of an interface share its link with the regular
+ * stream traffic, and a burst of losses on several cameras can turn into a burst of retransmissions making the
+ * congestion worse. The budgets are kept in a process wide list, one per interface address, and referenced by the
+ * streams for their lifetime.
+ */
 
-					last_missing = i - 1;
-					n_missing_packets = last_missing - first_missing + 1;
+static GMutex resend_budget_mutex;
+static GSList *resend_budgets = NULL;
 
-					if (frame->n_packet_resend_requests + n_missing_packets >
-					    (frame->n_packets * thread_data->packet_request_ratio)) {
-						frame->n_packet_resend_requests += n_missing_packets;
+static ArvGvStreamResendBudget *
+_resend_budget_acquire (GInetAddress *interface_address)
+{
+	ArvGvStreamResendBudget *budget = NULL;
+	GSList *iter;
 
-						arv_info_stream_thread ("[GvStream::missing_packet_check]"
-									 " Maximum number of requests "
-									 "reached at dt = %" G_GINT64_FORMAT
-									 ", n_packet_requests = %u (%u packets/frame), frame_id = %"
-									 G_GUINT64_FORMAT,
-									 time_us - frame->first_packet_time_us,
-									 frame->n_packet_resend_requests, frame->n_packets,
-									 frame->frame_id);
+	g_mutex_lock (&resend_budget_mutex);
 
-						thread_data->n_resend_ratio_reached++;
-						frame->resend_ratio_reached = TRUE;
+	for (iter = resend_budgets; iter != NULL; iter = iter->next) {
+		if (g_inet_address_equal (((ArvGvStreamResendBudget *) iter->data)->interface_address,
+					  interface_address)) {
+			budget = iter->data;
+			break;
+		}
+	}
 
-						return;
-					}
+	if (budget == NULL) {
+		budget = g_new0 (ArvGvStreamResendBudget, 1);
+		budget->interface_address = g_object_ref (interface_address);
+		g_mutex_init (&budget->mutex);
 
-					arv_debug_stream_thread ("[GvStream::missing_packet_check]"
-							       " Resend request at dt = %" G_GINT64_FORMAT
-							       ", packet id = %u (%u packets/frame)",
-							       time_us - frame->first_packet_time_us,
-							       packet_id, frame->n_packets);
+		resend_budgets = g_slist_prepend (resend_budgets, budget);
+	}
 
-					_send_packet_request (thread_data,
-							      frame->frame_id,
-							      first_missing,
-							      last_missing,
-							      frame->extended_ids);
+	budget->ref_count++;
 
-					for (j = first_missing; j <= last_missing; j++) {
-						frame->packet_data[j].abs_timeout_us = time_us +
-                                                        thread_data->packet_timeout_us;
-                                                frame->packet_data[j].resend_requested = TRUE;
-                                        }
+	g_mutex_unlock (&resend_budget_mutex);
 
-					thread_data->n_resend_requests += n_missing_packets;
+	return budget;
+}
 
-					first_missing = -1;
-				}
-			}
-		}
+static void
+_resend_budget_release (ArvGvStreamResendBudget *budget)
+{
+	g_mutex_lock (&resend_budget_mutex);
+
+	budget->ref_count--;
+	if (budget->ref_count == 0) {
+		resend_budgets = g_slist_remove (resend_budgets, budget);
+		g_mutex_clear (&budget->mutex);
+		g_object_unref (budget->interface_address);
+		g_free (budget);
 	}
+
+	g_mutex_unlock (&resend_budget_mutex);
 }
 
 static void
-_close_frame (ArvGvStreamThreadData *thread_data,
-              guint64 time_us,
-              ArvGvStreamFrameData *frame)
+_resend_budget_set_rate (ArvGvStreamResendBudget *budget, guint rate)
 {
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
-		thread_data->n_completed_buffers++;
-	else
-		if (frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
-			thread_data->n_failures++;
+	g_mutex_lock (&budget->mutex);
 
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_TIMEOUT)
-		thread_data->n_timeouts++;
+	budget->rate = rate;
+	budget->tokens = (double) rate * ARV_GV_STREAM_RESEND_BUDGET_BURST_MS / 1000.0;
+	budget->last_refill_us = g_get_monotonic_time ();
 
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_ABORTED)
-		thread_data->n_aborted++;
+	g_mutex_unlock (&budget->mutex);
+}
 
-	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
-	    frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
-		thread_data->n_missing_packets += (int) frame->n_packets - (frame->last_valid_packet + 1);
+/* Takes n_packets tokens, provided a reserve is left for the other frames. The reserve is proportional to the missing
+ * fraction of the frame, so that nearly complete frames, the ones a retransmission is most likely to save, can drain
+ * the bucket, while mostly lost frames need a full one. The bucket may go negative after a large request. */
 
-	arv_stream_push_output_buffer (thread_data->stream, frame->buffer);
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data,
-				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-				       frame->buffer);
+static gboolean
+_resend_budget_take (ArvGvStreamResendBudget *budget, guint n_packets, double missing_fraction, gint64 time_us)
+{
+	double burst;
+	double need;
+	gboolean granted;
 
-        arv_histogram_fill (thread_data->histogram, 0,
-                            time_us - frame->first_packet_time_us);
+	if (budget == NULL)
+		return TRUE;
 
-	arv_debug_stream_thread ("[GvStream::close_frame] Close frame %" G_GUINT64_FORMAT, frame->frame_id);
+	g_mutex_lock (&budget->mutex);
 
-	frame->buffer = NULL;
-	frame->frame_id = 0;
+	if (budget->rate == 0) {
+		g_mutex_unlock (&budget->mutex);
+		return TRUE;
+	}
+
+	burst = MAX (1.0, (double) budget->rate * ARV_GV_STREAM_RESEND_BUDGET_BURST_MS / 1000.0);
+	if (time_us > budget->last_refill_us) {
+		budget->tokens = MIN (burst, budget->tokens +
+				      (double) budget->rate * (time_us - budget->last_refill_us) / 1e6);
+		budget->last_refill_us = time_us;
+	}
+
+	need = MIN ((double) n_packets, burst);
+	granted = budget->tokens >= need + (burst - need) * missing_fraction;
+	if (granted)
+		budget->tokens -= n_packets;
 
-	g_free (frame->packet_data);
-	g_free (frame);
+	g_mutex_unlock (&budget->mutex);
+
+	return granted;
 }
 
-static void
-_check_frame_completion (ArvGvStreamThreadData *thread_data,
-			 guint64 time_us,
-			 ArvGvStreamFrameData *current_frame)
+static gboolean
+_request_missing_packets (ArvGvStreamThreadData *thread_data,
+			  ArvGvStreamFrameData *frame,
+			  guint32 packet_id,
+			  guint first_missing,
+			  guint last_missing,
+			  guint packet_timeout_us,
+			  guint64 time_us)
 {
-	GSList *iter;
-	ArvGvStreamFrameData *frame;
-	gboolean can_close_frame = TRUE;
-
-	for (iter = thread_data->frames; iter != NULL;) {
-		frame = iter->data;
+	guint n_missing_packets;
+	guint i;
+
+	/* Merged ranges may contain already received packets */
+	n_missing_packets = last_missing - first_missing + 1 -
+		_bitmap_count (frame->received_packets, first_missing, last_missing + 1);
+
+	if (frame->n_packet_resend_requests + n_missing_packets >
+	    (frame->n_packets * thread_data->packet_request_ratio)) {
+		frame->n_packet_resend_requests += n_missing_packets;
+
+		arv_info_stream_thread ("[GvStream::missing_packet_check]"
+					 " Maximum number of requests "
+					 "reached at dt = %" G_GINT64_FORMAT
+					 ", n_packet_requests = %u (%u packets/frame), frame_id = %"
+					 G_GUINT64_FORMAT,
+					 time_us - frame->first_packet_time_us,
+					 frame->n_packet_resend_requests, frame->n_packets,
+					 frame->frame_id);
+
+		thread_data->n_resend_ratio_reached++;
+		frame->resend_ratio_reached = TRUE;
+
+		return FALSE;
+	}
 
-		if (can_close_frame &&
-		    thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER &&
-		    iter->next != NULL) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
-			arv_info_stream_thread ("[GvStream::check_frame_completion] Incomplete frame %" G_GUINT64_FORMAT,
-						 frame->frame_id);
-			_close_frame (thread_data, time_us, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
+	if (!_resend_budget_take (thread_data->resend_budget, n_missing_packets,
+				  1.0 - (double) _bitmap_count (frame->received_packets, 0, frame->n_packets) /
+				  frame->n_packets,
+				  time_us)) {
+		thread_data->n_resend_budget_exceeded++;
+
+		/* The resend timeouts are left untouched, the request is retried on the next check. But once a newer
+		 * frame is being received, this one is already late, and it is better to give up on it than to delay the
+		 * others. */
+		if (frame->frame_id != thread_data->last_frame_id) {
+			arv_info_stream_thread ("[GvStream::missing_packet_check]"
+						" Resend budget exceeded for late frame %" G_GUINT64_FORMAT
+						", stop resend requests",
+						frame->frame_id);
+			frame->resend_budget_exceeded = TRUE;
 		}
 
-		if (can_close_frame &&
-		    frame->last_valid_packet == frame->n_packets - 1) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
-                        frame->buffer->priv->received_size = frame->received_size;
-			arv_debug_stream_thread ("[GvStream::check_frame_completion] Completed frame %" G_GUINT64_FORMAT,
-					       frame->frame_id);
-			_close_frame (thread_data, time_us, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
-		}
+		return FALSE;
+	}
 
-		if (can_close_frame &&
-		    time_us - frame->last_packet_time_us >= thread_data->frame_retention_us) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_TIMEOUT;
-			arv_warning_stream_thread ("[GvStream::check_frame_completion] Timeout for frame %"
-						   G_GUINT64_FORMAT " at dt = %" G_GUINT64_FORMAT,
-						   frame->frame_id, time_us - frame->first_packet_time_us);
-#if 0
-			if (arv_debug_check (&arv_debug_category_stream_thread, ARV_DEBUG_LEVEL_LOG)) {
-				int i;
-				arv_debug_stream_thread ("frame_id          = %Lu", frame->frame_id);
-				arv_debug_stream_thread ("last_valid_packet = %d", frame->last_valid_packet);
-				for (i = 0; i < frame->n_packets; i++) {
-					arv_debug_stream_thread ("%d - time = %Lu%s", i,
-							       frame->packet_data[i].time_us,
-							       frame->packet_data[i].received ? " - OK" : "");
-				}
-			}
-#endif
-			_close_frame (thread_data, time_us, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
-		}
+	arv_debug_stream_thread ("[GvStream::missing_packet_check]"
+			       " Resend request at dt = %" G_GINT64_FORMAT
+			       ", packet id = %u (%u packets/frame)",
+			       time_us - frame->first_packet_time_us,
+			       packet_id, frame->n_packets);
 
-		can_close_frame = FALSE;
+	_send_packet_request (thread_data,
+			      frame->frame_id,
+			      first_missing,
+			      last_missing,
+			      frame->extended_ids);
 
-		if (frame != current_frame &&
-		    time_us - frame->last_packet_time_us >= thread_data->packet_timeout_us) {
-			_missing_packet_check (thread_data, frame, frame->n_packets - 1, time_us);
-			iter = iter->next;
-			continue;
-		}
+	for (i = first_missing >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+	     i <= last_missing >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+	     i++)
+		frame->resend_timeouts_us[i] = time_us + packet_timeout_us;
+	_bitmap_set_range (frame->resend_requested_packets, first_missing, last_missing + 1);
 
-		iter = iter->next;
-	}
+	thread_data->n_resend_requests += n_missing_packets;
+	frame->buffer->priv->metadata.n_resend_requested_packets += n_missing_packets;
+
+	return TRUE;
 }
 
-static void
-_flush_frames (ArvGvStreamThreadData *thread_data,
-               guint64 time_us)
+static gboolean
+_add_missing_range (ArvGvStreamThreadData *thread_data,
+		    ArvGvStreamFrameData *frame,
+		    guint32 packet_id,
+		    gint64 *pending_first,
+		    guint *pending_last,
+		    guint first_missing,
+		    guint last_missing,
+		    guint packet_timeout_us,
+		    guint64 time_us)
 {
-	GSList *iter;
-	ArvGvStreamFrameData *frame;
-
-	for (iter = thread_data->frames; iter != NULL; iter = iter->next) {
-		frame = iter->data;
-		frame->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
-		_close_frame (thread_data, time_us, frame);
+	/* Ranges separated by less than the merge distance are sent as a single request */
+	if (*pending_first >= 0 &&
+	    first_missing <= *pending_last + 1 + thread_data->packet_request_merge_distance) {
+		*pending_last = last_missing;
+		return TRUE;
 	}
 
-	g_slist_free (thread_data->frames);
-	thread_data->frames = NULL;
-}
+	if (*pending_first >= 0 &&
+	    !_request_missing_packets (thread_data, frame, packet_id, *pending_first, *pending_last,
+				       packet_timeout_us, time_us))
+		return FALSE;
 
-static ArvGvStreamFrameData *
-_process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet, size_t packet_size, guint64 time_us)
+	*pending_first = first_missing;
+	*pending_last = last_missing;
+
+	return TRUE;
+}
 
+static void
+_missing_packet_check (ArvGvStreamThreadData *thread_data,
+		       ArvGvStreamFrameData *frame,
+		       guint32 packet_id,
+		       guint64 time_us)
 {
-	ArvGvStreamFrameData *frame;
-	guint32 packet_id;
-	guint64 frame_id;
-	gboolean extended_ids;
-	int i;
+	gint64 first_missing = -1;
+	gint64 pending_first = -1;
+	guint pending_last = 0;
+	guint initial_packet_timeout_us;
+	guint packet_timeout_us;
+	guint end;
+	guint i;
 
-	thread_data->n_received_packets++;
+	if (thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER ||
+	    frame->disable_resend_request ||
+	    frame->resend_ratio_reached ||
+	    frame->resend_budget_exceeded)
+		return;
 
-	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
-	frame_id = arv_gvsp_packet_get_frame_id (packet);
-	packet_id = arv_gvsp_packet_get_packet_id (packet);
+	if ((int) (frame->n_packets * thread_data->packet_request_ratio) <= 0)
+		return;
 
-	if (thread_data->first_packet) {
-		thread_data->last_frame_id = frame_id - 1;
-		thread_data->first_packet = FALSE;
-	}
+	if (packet_id >= frame->n_packets)
+		return;
 
-	frame = _find_frame_data (thread_data, packet, packet_size, frame_id, packet_id, extended_ids, packet_size, time_us);
+	_get_resend_timeouts (thread_data, &initial_packet_timeout_us, &packet_timeout_us);
 
-	if (frame != NULL) {
-		ArvGvspPacketType packet_type = arv_gvsp_packet_get_packet_type (packet);
+	end = packet_id + 1;
+	i = frame->last_valid_packet + 1;
 
-		if (arv_gvsp_packet_type_is_error (packet_type)) {
-                        ArvGvcpError error = packet_type & 0xff;
+	while (i < end) {
+		guint missing_end;
 
-			arv_info_stream_thread ("[GvStream::process_packet]"
-						 " Error packet at dt = %" G_GINT64_FORMAT ", packet id = %u"
-						 " frame id = %" G_GUINT64_FORMAT,
-						 time_us - frame->first_packet_time_us,
-						 packet_id, frame->frame_id);
+		/* [i, missing_end[ is a range of missing packets */
+		i = _bitmap_find (frame->received_packets, i, end, FALSE);
+		if (i >= end)
+			break;
+		missing_end = _bitmap_find (frame->received_packets, i, end, TRUE);
+
+		/* Split it on resend timeout boundaries */
+		while (i < missing_end) {
+			guint word = i >> ARV_GV_STREAM_BITMAP_WORD_SHIFT;
+			guint range_end = MIN ((word + 1) << ARV_GV_STREAM_BITMAP_WORD_SHIFT, missing_end);
+
+			if (frame->resend_timeouts_us[word] == 0)
+				frame->resend_timeouts_us[word] = time_us + initial_packet_timeout_us;
+
+			if (time_us > frame->resend_timeouts_us[word]) {
+				if (first_missing < 0)
+					first_missing = i;
+			} else if (first_missing >= 0) {
+				if (!_add_missing_range (thread_data, frame, packet_id, &pending_first, &pending_last,
+							 first_missing, i - 1, packet_timeout_us, time_us))
+					return;
+				first_missing = -1;
+			}
+
+			i = range_end;
+		}
+
+		if (first_missing >= 0) {
+			if (!_add_missing_range (thread_data, frame, packet_id, &pending_first, &pending_last,
+						 first_missing, missing_end - 1, packet_timeout_us, time_us))
+				return;
+			first_missing = -1;
+		}
+	}
+
+	if (pending_first >= 0)
+		_request_missing_packets (thread_data, frame, packet_id, pending_first, pending_last,
+					  packet_timeout_us, time_us);
+}
+
+/* Reports the data received contiguously from the start of the frame, when it has grown since the last call. The
+ * received size of the buffer is used for the reported size. */
+
+static void
+_report_frame_progress (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	size_t contiguous_size;
+
+	if (thread_data->callback == NULL ||
+	    frame->n_pending_copies > 0 ||
+	    frame->last_valid_packet < 1 ||
+	    frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING ||
+	    frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ||
+	    frame->unpack_blocks ||
+	    frame->buffer->priv->window_offset > 0 ||
+	    !arv_stream_get_buffer_progress (thread_data->stream))
+		return;
+
+	/* All the data blocks but the last one have the same size */
+	if (frame->last_valid_packet >= frame->n_packets - 2)
+		contiguous_size = frame->received_size;
+	else
+		contiguous_size = MIN ((size_t) frame->last_valid_packet *
+				       (thread_data->scps_packet_size - (frame->extended_ids ?
+									 ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+									 ARV_GVSP_PACKET_PROTOCOL_OVERHEAD)),
+				       frame->buffer->priv->allocated_size);
+
+	if (contiguous_size <= frame->buffer->priv->received_size)
+		return;
+
+	frame->buffer->priv->received_size = contiguous_size;
+	thread_data->callback (thread_data->callback_data,
+			       ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS,
+			       frame->buffer);
+}
+
+/* Closes the frames at the head of the ring which don't need more packets */
+
+static void
+_close_completed_frames (ArvGvStreamThreadData *thread_data, guint64 time_us)
+{
+	ArvGvStreamFrameData *frame;
+
+	while (thread_data->n_frames > 0) {
+		frame = _get_frame (thread_data, 0);
+
+		if (frame->n_pending_copies > 0)
+			return;
+
+		if (thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER &&
+		    thread_data->n_frames > 1) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+			arv_info_stream_thread ("[GvStream::check_frame_completion] Incomplete frame %" G_GUINT64_FORMAT,
+						 frame->frame_id);
+			_close_first_frame (thread_data, time_us);
+			continue;
+		}
+
+		if (!frame->n_packets_known || frame->last_valid_packet != frame->n_packets - 1)
+			return;
+
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+		frame->buffer->priv->received_size = frame->received_size;
+		if (frame->buffer->priv->window_offset > 0)
+			frame->buffer->priv->received_size =
+				frame->received_size > frame->buffer->priv->window_offset ?
+				MIN (frame->received_size - frame->buffer->priv->window_offset,
+				     frame->buffer->priv->allocated_size) : 0;
+		_finish_unpacking (thread_data, frame);
+		arv_debug_stream_thread ("[GvStream::check_frame_completion] Completed frame %" G_GUINT64_FORMAT,
+					 frame->frame_id);
+		_close_first_frame (thread_data, time_us);
+	}
+}
+
+/* Frame retention and resend deadlines of the frames not receiving packets anymore. Called only once the earliest
+ * deadline, cached in next_deadline_us, is reached. The cached value is only lowered by the frame creation, the
+ * frames receiving packets pushing their deadlines back, which is caught by the next pass. */
+
+static void
+_check_frame_deadlines (ArvGvStreamThreadData *thread_data, guint64 time_us)
+{
+	ArvGvStreamFrameData *frame;
+	guint64 next_deadline_us = G_MAXUINT64;
+	guint initial_packet_timeout_us;
+	guint packet_timeout_us;
+	gboolean can_close_frame = TRUE;
+	guint i = 0;
+
+	_get_resend_timeouts (thread_data, &initial_packet_timeout_us, &packet_timeout_us);
+
+	while (i < thread_data->n_frames) {
+		frame = _get_frame (thread_data, i);
+
+		if (frame->n_pending_copies > 0)
+			can_close_frame = FALSE;
+
+		if (can_close_frame &&
+		    time_us - frame->last_packet_time_us >= thread_data->frame_retention_us) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_TIMEOUT;
+			arv_warning_stream_thread ("[GvStream::check_frame_completion] Timeout for frame %"
+						   G_GUINT64_FORMAT " at dt = %" G_GUINT64_FORMAT,
+						   frame->frame_id, time_us - frame->first_packet_time_us);
+			_close_first_frame (thread_data, time_us);
+			_close_completed_frames (thread_data, time_us);
+			continue;
+		}
+
+		can_close_frame = FALSE;
+
+		next_deadline_us = MIN (next_deadline_us, frame->last_packet_time_us + thread_data->frame_retention_us);
+
+		if (time_us - frame->last_packet_time_us >= thread_data->packet_timeout_us) {
+			_missing_packet_check (thread_data, frame, frame->n_packets - 1, time_us);
+			/* The next resend requests are due after the resend timeouts */
+			next_deadline_us = MIN (next_deadline_us,
+						time_us + MIN (initial_packet_timeout_us, packet_timeout_us));
+		} else
+			next_deadline_us = MIN (next_deadline_us,
+						frame->last_packet_time_us + thread_data->packet_timeout_us);
+
+		i++;
+	}
+
+	thread_data->next_deadline_us = next_deadline_us;
+}
+
+/* Time without packets after which the stream is considered as stalled, 0 while the frame period is unknown. The
+ * measured period is preferred to the configured frame rate, which is not used in triggered modes. */
+
+static guint64
+_get_stall_timeout_us (ArvGvStreamThreadData *thread_data)
+{
+	double period_us = thread_data->frame_period_us;
+
+	if (period_us <= 0.0 && thread_data->frame_rate > 0.0)
+		period_us = 1e6 / thread_data->frame_rate;
+	if (period_us <= 0.0)
+		return 0;
+
+	return MAX (thread_data->stall_frames * period_us, thread_data->frame_retention_us);
+}
+
+static void
+_recover_stall (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvDevice *gv_device = NULL;
+	GError *error = NULL;
+
+	g_object_get (thread_data->stream, "device", &gv_device, NULL);
+	if (!ARV_IS_GV_DEVICE (gv_device)) {
+		g_clear_object (&gv_device);
+		return;
+	}
+
+	thread_data->n_stall_recovery_attempts++;
+
+	if (!arv_gv_device_is_controller (gv_device)) {
+		arv_warning_stream_thread ("[GvStream::recover_stall] Not the device controller, can't restart the stream");
+	} else if (!arv_gv_device_restart_stream (gv_device, ARV_GV_STREAM (thread_data->stream), &error)) {
+		arv_warning_stream_thread ("[GvStream::recover_stall] Recovery attempt %u failed: %s",
+					   thread_data->n_stall_recovery_attempts, error->message);
+		g_clear_error (&error);
+	} else {
+		/* The device may restart its frame count */
+		thread_data->first_packet = TRUE;
+	}
+
+	g_object_unref (gv_device);
+}
+
+/* Runs on the wake ups without packet. The stall is reported once, and the recovery attempted a few times, until the
+ * next packet. */
+
+static void
+_check_stall (ArvGvStreamThreadData *thread_data, guint64 time_us)
+{
+	guint64 stall_timeout_us;
+
+	if (thread_data->stall_watchdog == ARV_GV_STREAM_STALL_WATCHDOG_DISABLED ||
+	    thread_data->last_received_time_us == 0 ||
+	    time_us < thread_data->last_received_time_us)
+		return;
+
+	stall_timeout_us = _get_stall_timeout_us (thread_data);
+	if (stall_timeout_us == 0 || time_us - thread_data->last_received_time_us < stall_timeout_us)
+		return;
+
+	if (!thread_data->is_stalled) {
+		ArvGvDevice *gv_device = NULL;
+		gboolean is_controller = FALSE;
+
+		thread_data->is_stalled = TRUE;
+		thread_data->n_stalls++;
+		thread_data->n_stall_recovery_attempts = 0;
+		thread_data->next_stall_recovery_us = time_us;
+
+		if (thread_data->socket != NULL)
+			_check_socket_drops (thread_data);
+
+		g_object_get (thread_data->stream, "device", &gv_device, NULL);
+		if (ARV_IS_GV_DEVICE (gv_device))
+			is_controller = arv_gv_device_is_controller (gv_device);
+		g_clear_object (&gv_device);
+
+		arv_warning_stream_thread ("[GvStream::check_stall] No packet for %" G_GUINT64_FORMAT
+					   " µs (frame period %.0f µs, %" G_GUINT64_FORMAT
+					   " kernel dropped packets, %s)",
+					   time_us - thread_data->last_received_time_us, thread_data->frame_period_us,
+					   thread_data->n_kernel_dropped_packets,
+					   is_controller ? "controller" : "no control");
+
+		g_signal_emit (thread_data->stream, arv_gv_stream_signals[ARV_GV_STREAM_SIGNAL_STALLED], 0,
+			       thread_data->last_received_time_us, thread_data->n_kernel_dropped_packets,
+			       is_controller);
+	}
+
+	if (thread_data->stall_watchdog == ARV_GV_STREAM_STALL_WATCHDOG_RECOVER &&
+	    thread_data->n_stall_recovery_attempts < ARV_GV_STREAM_STALL_MAX_RECOVERIES &&
+	    time_us >= thread_data->next_stall_recovery_us) {
+		_recover_stall (thread_data);
+		thread_data->next_stall_recovery_us = g_get_monotonic_time () + stall_timeout_us;
+	}
+}
+
+/* Called after each packet, with the frame of the packet, or on each wake up without packet, with a NULL frame. The
+ * per packet work is limited to the head of the ring and the current frame, the deadlines being only checked when the
+ * earliest one is reached. */
+
+static void
+_check_frame_completion (ArvGvStreamThreadData *thread_data,
+			 guint64 time_us,
+			 ArvGvStreamFrameData *current_frame)
+{
+	guint i;
+
+	arv_rate_window_update (thread_data->rate_window, time_us);
+
+	_close_completed_frames (thread_data, time_us);
+
+	if (current_frame != NULL) {
+		if (current_frame->buffer != NULL)
+			_report_frame_progress (thread_data, current_frame);
+	} else {
+		for (i = 0; i < thread_data->n_frames; i++)
+			_report_frame_progress (thread_data, _get_frame (thread_data, i));
+	}
+
+	if (time_us >= thread_data->next_deadline_us)
+		_check_frame_deadlines (thread_data, time_us);
+
+	if (current_frame == NULL)
+		_check_stall (thread_data, time_us);
+}
+
+static void
+_flush_frames (ArvGvStreamThreadData *thread_data,
+               guint64 time_us)
+{
+	while (thread_data->n_frames > 0) {
+		_get_frame (thread_data, 0)->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
+		_close_first_frame (thread_data, time_us);
+	}
+}
+
+/* @data points to the packet payload if it is not stored right after the packet header, NULL otherwise */
+
+static ArvGvStreamFrameData *
+_process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet, size_t packet_size,
+		 const void *data, guint64 time_us, guint64 timestamp_ns)
+
+{
+	ArvGvStreamFrameData *frame;
+	ArvGvspHeaderInfos header;
+	guint32 packet_id;
+
+	thread_data->n_received_packets++;
+
+	if (G_UNLIKELY (thread_data->is_stalled)) {
+		arv_info_stream_thread ("[GvStream::process_packet] Stream resumed after %" G_GUINT64_FORMAT " µs",
+					time_us - thread_data->last_received_time_us);
+		if (thread_data->n_stall_recovery_attempts > 0)
+			thread_data->n_stall_recoveries++;
+		thread_data->is_stalled = FALSE;
+	}
+	thread_data->last_received_time_us = time_us;
+
+	arv_gvsp_packet_parse_header (packet, &header);
+	packet_id = header.packet_id;
+
+	if (thread_data->first_packet) {
+		thread_data->last_frame_id = header.frame_id - 1;
+		thread_data->first_packet = FALSE;
+	}
+
+	frame = _find_frame_data (thread_data, packet, packet_size, header.frame_id, packet_id, header.extended_ids,
+				  packet_size, time_us);
+
+	if (frame != NULL) {
+		/* Packet past the estimated payload, leave room for the trailer */
+		if (G_UNLIKELY (packet_id >= frame->n_packets) &&
+		    !frame->n_packets_known && packet_id < frame->max_n_packets &&
+		    !arv_gvsp_packet_type_is_error (header.packet_type))
+			_set_frame_n_packets (frame, packet_id + 2);
+
+		if (arv_gvsp_packet_type_is_error (header.packet_type)) {
+                        ArvGvcpError error = header.packet_type & 0xff;
+
+			arv_info_stream_thread ("[GvStream::process_packet]"
+						 " Error packet at dt = %" G_GINT64_FORMAT ", packet id = %u"
+						 " frame id = %" G_GUINT64_FORMAT,
+						 time_us - frame->first_packet_time_us,
+						 packet_id, frame->frame_id);
 			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_INFO);
 
                         if (error == ARV_GVCP_ERROR_PACKET_AND_PREVIOUS_REMOVED_FROM_MEMORY ||
@@ -742,7 +2224,7 @@ _process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet
 			thread_data->n_error_packets++;
                         thread_data->n_transferred_bytes += packet_size;
 		} else if (packet_id < frame->n_packets &&
-		           frame->packet_data[packet_id].received) {
+		           _bitmap_get (frame->received_packets, packet_id)) {
 			/* Ignore duplicate packet */
 			thread_data->n_duplicated_packets++;
 			arv_debug_stream_thread ("[GvStream::process_packet] Duplicated packet %d for frame %" G_GUINT64_FORMAT,
@@ -751,33 +2233,28 @@ _process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet
 
                         thread_data->n_transferred_bytes += packet_size;
 		} else {
-			ArvGvspContentType content_type;
-
 			if (packet_id < frame->n_packets) {
-				frame->packet_data[packet_id].received = TRUE;
+				_bitmap_set (frame->received_packets, packet_id);
 			}
 
 			/* Keep track of last packet of a continuous block starting from packet 0 */
-			for (i = frame->last_valid_packet + 1; i < frame->n_packets; i++)
-				if (!frame->packet_data[i].received)
-					break;
-			frame->last_valid_packet = i - 1;
+			frame->last_valid_packet = _bitmap_find (frame->received_packets, frame->last_valid_packet + 1,
+								 frame->n_packets, FALSE) - 1;
 
-			content_type = arv_gvsp_packet_get_content_type (packet);
+			if (G_UNLIKELY (arv_debug_is_enabled (ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_DEBUG)))
+				arv_gvsp_packet_debug (packet, packet_size,
+						       header.content_type == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK ?
+						       ARV_DEBUG_LEVEL_TRACE :
+						       ARV_DEBUG_LEVEL_DEBUG);
 
-			arv_gvsp_packet_debug (packet, packet_size,
-					       content_type == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK ?
-					       ARV_DEBUG_LEVEL_TRACE :
-					       ARV_DEBUG_LEVEL_DEBUG);
-
-			switch (content_type) {
+			switch (header.content_type) {
 				case ARV_GVSP_CONTENT_TYPE_DATA_LEADER:
-					_process_data_leader (thread_data, frame, packet, packet_id);
+					_process_data_leader (thread_data, frame, packet, packet_id, packet_size,
+							      timestamp_ns);
                                         thread_data->n_transferred_bytes += packet_size;
 					break;
 				case ARV_GVSP_CONTENT_TYPE_DATA_BLOCK:
-					_process_data_block (thread_data, frame, packet, packet_id,
-							     packet_size);
+					_process_data_block (thread_data, frame, packet, &header, data, packet_size);
                                         thread_data->n_transferred_bytes += packet_size;
 					break;
 				case ARV_GVSP_CONTENT_TYPE_DATA_TRAILER:
@@ -800,130 +2277,1032 @@ _process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet
 	return frame;
 }
 
-static void
-_loop (ArvGvStreamThreadData *thread_data)
-{
-	ArvGvStreamFrameData *frame;
-	ArvGvspPacket *packet_buffers;
-	GPollFD poll_fd[2];
-	guint64 time_us;
-	int n_msgs;
-	gboolean use_poll;
-	unsigned i;
-	GInputVector packet_iv[ARV_GV_STREAM_NUM_BUFFERS] = { {NULL, 0}, };
-	GInputMessage packet_im[ARV_GV_STREAM_NUM_BUFFERS] = { {NULL, NULL, 0, 0, 0, NULL, NULL}, };
-	// we don't need to consider the IP and UDP header size
-	guint packet_buffer_size = thread_data->scps_packet_size - 20 - 8;
-
-	arv_info_stream ("[GvStream::loop] Standard socket method");
+/*
+ * Specialized packet processing. The variants are generated from a single inlined body, with the packet resend mode,
+ * the packet id format and the timing statistics as compile-time constants, which removes the corresponding branches
+ * from the per-packet path. The variants only handle the data packets of the frames already in the ring, which are
+ * the bulk of the traffic. The first packet, the packets of a new frame, the error and duplicated packets, and the
+ * packets past the estimated payload go through _process_packet().
+ *
+ * The variant is selected when the packet resend mode or the timing statistics are changed, and on the first packet
+ * using the other id format. _process_packet() is used for every packet while the stream debug output is enabled.
+ */
 
-	poll_fd[0].fd = g_socket_get_fd (thread_data->socket);
-	poll_fd[0].events =  G_IO_IN;
-	poll_fd[0].revents = 0;
+#define ARV_GV_STREAM_VARIANT_RESEND			(1 << 0)
+#define ARV_GV_STREAM_VARIANT_EXTENDED_IDS		(1 << 1)
+#define ARV_GV_STREAM_VARIANT_TIMING_STATISTICS		(1 << 2)
 
-	arv_gpollfd_prepare_all(poll_fd,1);
+#if defined(__GNUC__)
+#define ARV_GV_STREAM_ALWAYS_INLINE inline __attribute__ ((always_inline))
+#else
+#define ARV_GV_STREAM_ALWAYS_INLINE inline
+#endif
 
-	packet_buffers = g_malloc0 (packet_buffer_size * ARV_GV_STREAM_NUM_BUFFERS);
+static void _select_packet_processing (ArvGvStreamThreadData *thread_data);
 
-	for (i = 0; i < ARV_GV_STREAM_NUM_BUFFERS; i++) {
-		packet_iv[i].buffer = (char *) packet_buffers + i * packet_buffer_size;
-		packet_iv[i].size = packet_buffer_size;
-		packet_im[i].vectors = &packet_iv[i];
-		packet_im[i].num_vectors = 1;
-	}
+static ARV_GV_STREAM_ALWAYS_INLINE ArvGvStreamFrameData *
+_process_packet_variant (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet, size_t packet_size,
+			 const void *data, guint64 time_us, guint64 timestamp_ns, const guint variant)
+{
+	ArvGvStreamFrameData *frame;
+	ArvGvspHeaderInfos header;
 
-	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+	arv_gvsp_packet_parse_header (packet, &header);
 
-        g_mutex_lock (&thread_data->thread_started_mutex);
-        thread_data->thread_started = TRUE;
-        g_cond_signal (&thread_data->thread_started_cond);
-        g_mutex_unlock (&thread_data->thread_started_mutex);
+	if (G_UNLIKELY (header.extended_ids != ((variant & ARV_GV_STREAM_VARIANT_EXTENDED_IDS) != 0))) {
+		thread_data->variant_extended_ids = header.extended_ids;
+		_select_packet_processing (thread_data);
+		return _process_packet (thread_data, packet, packet_size, data, time_us, timestamp_ns);
+	}
 
-	do {
-                int timeout_ms;
-		int n_events;
-		int errsv;
+	frame = _find_frame_by_id (thread_data, header.frame_id);
 
-		if (thread_data->frames != NULL)
-			timeout_ms = thread_data->packet_timeout_us / 1000;
-		else
-			timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+	if (G_UNLIKELY (frame == NULL ||
+			thread_data->first_packet ||
+			thread_data->is_stalled ||
+			arv_gvsp_packet_type_is_error (header.packet_type) ||
+			header.packet_id >= frame->n_packets ||
+			_bitmap_get (frame->received_packets, header.packet_id)))
+		return _process_packet (thread_data, packet, packet_size, data, time_us, timestamp_ns);
 
-		do {
-			poll_fd[0].revents = 0;
-			n_events = g_poll (poll_fd, use_poll ?  2 : 1, timeout_ms);
-			errsv = errno;
+	thread_data->n_received_packets++;
+	thread_data->last_received_time_us = time_us;
 
-		} while (n_events < 0 && errsv == EINTR);
+	if (variant & ARV_GV_STREAM_VARIANT_TIMING_STATISTICS) {
+		arv_hdr_histogram_fill (thread_data->histogram, 0, 1, time_us - frame->first_packet_time_us);
+		arv_hdr_histogram_fill (thread_data->histogram, 0, 2, time_us - frame->last_packet_time_us);
+	}
+	_update_inter_packet_estimate (thread_data, time_us - frame->last_packet_time_us);
+	frame->last_packet_time_us = time_us;
 
-		if (poll_fd[0].revents != 0) {
-			arv_gpollfd_clear_one (&poll_fd[0], thread_data->socket);
-			n_msgs = g_socket_receive_messages (thread_data->socket,
-		 					    packet_im,
-		 					    ARV_GV_STREAM_NUM_BUFFERS,
-		 					    G_SOCKET_MSG_NONE,
-		 					    NULL,
-		 					    NULL);
-			time_us = g_get_monotonic_time ();
-			for (i = 0; i < n_msgs; i++) {
-				frame = _process_packet (thread_data,
-						 	 packet_iv[i].buffer,
-						 	 packet_im[i].bytes_received,
-						 	 time_us);
-				_check_frame_completion (thread_data, time_us, frame);
-			}
-		} else {
-			time_us = g_get_monotonic_time ();
-			_check_frame_completion (thread_data, time_us, NULL);
-                }
+	_bitmap_set (frame->received_packets, header.packet_id);
+	frame->last_valid_packet = _bitmap_find (frame->received_packets, frame->last_valid_packet + 1,
+						 frame->n_packets, FALSE) - 1;
 
-	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+	switch (header.content_type) {
+		case ARV_GVSP_CONTENT_TYPE_DATA_BLOCK:
+			_process_data_block (thread_data, frame, packet, &header, data, packet_size);
+			thread_data->n_transferred_bytes += packet_size;
+			break;
+		case ARV_GVSP_CONTENT_TYPE_DATA_LEADER:
+			_process_data_leader (thread_data, frame, packet, header.packet_id, packet_size, timestamp_ns);
+			thread_data->n_transferred_bytes += packet_size;
+			break;
+		case ARV_GVSP_CONTENT_TYPE_DATA_TRAILER:
+			_process_data_trailer (thread_data, frame, header.packet_id);
+			thread_data->n_transferred_bytes += packet_size;
+			break;
+		default:
+			thread_data->n_ignored_packets++;
+			thread_data->n_ignored_bytes += packet_size;
+			break;
+	}
 
-	if (use_poll)
-		g_cancellable_release_fd (thread_data->cancellable);
+	if (variant & ARV_GV_STREAM_VARIANT_RESEND)
+		_missing_packet_check (thread_data, frame, header.packet_id, time_us);
 
-	arv_gpollfd_finish_all (poll_fd,1);
-	g_free (packet_buffers);
+	return frame;
 }
 
+#define ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT(variant)						\
+static ArvGvStreamFrameData *										\
+_process_packet_variant_##variant (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet,	\
+				   size_t packet_size, const void *data, guint64 time_us,		\
+				   guint64 timestamp_ns)						\
+{													\
+	return _process_packet_variant (thread_data, packet, packet_size, data, time_us, timestamp_ns,	\
+					variant);							\
+}
 
-#if ARAVIS_HAS_PACKET_SOCKET
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (0)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (1)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (2)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (3)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (4)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (5)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (6)
+ARV_GV_STREAM_DEFINE_PROCESS_PACKET_VARIANT (7)
+
+static const ArvGvStreamProcessPacket arv_gv_stream_process_packet_variants[] = {
+	_process_packet_variant_0, _process_packet_variant_1, _process_packet_variant_2, _process_packet_variant_3,
+	_process_packet_variant_4, _process_packet_variant_5, _process_packet_variant_6, _process_packet_variant_7
+};
 
 static void
-_set_socket_filter (int socket, guint32 source_ip, guint32 source_port, guint32 destination_ip, guint32 destination_port)
+_select_packet_processing (ArvGvStreamThreadData *thread_data)
 {
+	ArvGvStreamProcessPacket process_packet;
+	guint variant = 0;
+
+	if (thread_data->packet_resend != ARV_GV_STREAM_PACKET_RESEND_NEVER)
+		variant |= ARV_GV_STREAM_VARIANT_RESEND;
+	if (thread_data->variant_extended_ids)
+		variant |= ARV_GV_STREAM_VARIANT_EXTENDED_IDS;
+	if (thread_data->timing_statistics)
+		variant |= ARV_GV_STREAM_VARIANT_TIMING_STATISTICS;
+
+	if (arv_debug_is_enabled (ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_DEBUG))
+		process_packet = _process_packet;
+	else
+		process_packet = arv_gv_stream_process_packet_variants[variant];
+
+	g_atomic_pointer_set (&thread_data->process_packet, process_packet);
+}
 
-#if 0
 /*
- * sudo tcpdump -i lo -e -nn  "udp and src host 192.168.0.1 and src port 10 and dst host 192.168.0.2 and dst port 20" -d
- *
- * (000) ldh      [12]
- * (001) jeq      #0x86dd          jt 17	jf 2
- * (002) jeq      #0x800           jt 3	        jf 17
- * (003) ldb      [23]
- * (004) jeq      #0x11            jt 5	        jf 17
- * (005) ld       [26]
- * (006) jeq      #0xc0a80001      jt 7	        jf 17           Source host
- * (007) ldh      [20]
- * (008) jset     #0x1fff          jt 17	jf 9
- * (009) ldxb     4*([14]&0xf)
- * (010) ldh      [x + 14]
- * (011) jeq      #0xa             jt 12	jf 17           Source port
- * (012) ld       [30]
- * (013) jeq      #0xc0a80002      jt 14	jf 17           Destination host
- * (014) ldh      [x + 16]
- * (015) jeq      #0x14            jt 16	jf 17           Destination port
- * (016) ret      #262144
- * (017) ret      #0
+ * Direct receive mode: for each message of the next receive call, guess which data block will be received, and split
+ * its reception in a header vector pointing to the staging packet buffer, a payload vector pointing to the final
+ * location of the data block in the frame buffer, and a tail vector for any unexpected extra bytes.
  */
 
-	struct sock_filter bpf[] = {
-		{ 0x28, 0, 0, 0x0000000c },
-		{ 0x15, 15, 0, 0x000086dd },
-		{ 0x15, 0, 14, 0x00000800 },
-		{ 0x30, 0, 0, 0x00000017 },
-		{ 0x15, 0, 12, 0x00000011 },
-		{ 0x20, 0, 0, 0x0000001a },
+static unsigned
+_direct_receive_prepare (ArvGvStreamThreadData *thread_data,
+			 ArvGvStreamFrameData *frame,
+			 guint32 packet_id,
+			 char *packet_buffers,
+			 guint packet_buffer_size,
+			 GInputMessage *packet_im,
+			 GInputVector (*packet_iv)[3],
+			 guint32 *predicted_packet_ids)
+{
+	size_t header_size = 0;
+	size_t block_size = 0;
+	unsigned n_predicted = 0;
+	unsigned i;
+
+	/* Multipart data block locations can't be predicted from their packet id, and the payload type is only known
+	 * after the leader */
+	if (frame != NULL && frame->buffer->priv->status == ARV_BUFFER_STATUS_FILLING &&
+	    frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN &&
+	    frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+		header_size = sizeof (ArvGvspPacket) +
+			(frame->extended_ids ? sizeof (ArvGvspExtendedHeader) : sizeof (ArvGvspHeader));
+		block_size = thread_data->scps_packet_size -
+			(frame->extended_ids ?
+			 ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+			 ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+	} else
+		frame = NULL;
+
+	for (i = 0; i < ARV_GV_STREAM_NUM_BUFFERS; i++) {
+		char *packet_buffer = packet_buffers + i * packet_buffer_size;
+		size_t block_offset = 0;
+		gboolean predicted = FALSE;
+
+		if (frame != NULL) {
+			if (packet_id < frame->n_packets - 1)
+				packet_id = _bitmap_find (frame->received_packets, packet_id, frame->n_packets - 1, FALSE);
+
+			block_offset = (packet_id - 1) * block_size;
+			predicted = packet_id >= 1 && packet_id < frame->n_packets - 1 &&
+				frame->buffer->priv->window_offset == 0 &&
+				block_offset < frame->buffer->priv->allocated_size;
+		}
+
+		packet_im[i].vectors = packet_iv[i];
+
+		if (predicted) {
+			size_t payload_size = MIN (block_size, frame->buffer->priv->allocated_size - block_offset);
+
+			packet_iv[i][0].buffer = packet_buffer;
+			packet_iv[i][0].size = header_size;
+			packet_iv[i][1].buffer = ((char *) frame->buffer->priv->data) + block_offset;
+			packet_iv[i][1].size = payload_size;
+			packet_iv[i][2].buffer = packet_buffer + header_size + payload_size;
+			packet_iv[i][2].size = packet_buffer_size - header_size - payload_size;
+			packet_im[i].num_vectors = 3;
+
+			predicted_packet_ids[i] = packet_id++;
+			n_predicted++;
+		} else {
+			packet_iv[i][0].buffer = packet_buffer;
+			packet_iv[i][0].size = packet_buffer_size;
+			packet_im[i].num_vectors = 1;
+
+			predicted_packet_ids[i] = 0;
+		}
+	}
+
+	return n_predicted;
+}
+
+/*
+ * Check the guesses made by _direct_receive_prepare. Mispredicted packets are copied back into their staging buffer,
+ * before any payload is written to the frame buffer, as their payload overwrote the location of a not yet received data
+ * block that may be the destination of another packet of the same batch.
+ */
+
+static void
+_direct_receive_check (ArvGvStreamFrameData *frame,
+		       unsigned n_msgs,
+		       GInputMessage *packet_im,
+		       GInputVector (*packet_iv)[3],
+		       guint32 *predicted_packet_ids)
+{
+	unsigned i;
+
+	for (i = 0; i < n_msgs; i++) {
+		size_t header_size = packet_iv[i][0].size;
+		size_t size = packet_im[i].bytes_received;
+		ArvGvspHeaderInfos header;
+
+		if (predicted_packet_ids[i] == 0)
+			continue;
+
+		if (size > header_size &&
+		    size - header_size <= packet_iv[i][1].size) {
+			arv_gvsp_packet_parse_header (packet_iv[i][0].buffer, &header);
+
+			if (!arv_gvsp_packet_type_is_error (header.packet_type) &&
+			    header.extended_ids == frame->extended_ids &&
+			    header.frame_id == frame->frame_id &&
+			    header.content_type == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK &&
+			    header.packet_id == predicted_packet_ids[i])
+				continue;
+		}
+
+		if (size > header_size)
+			memcpy (((char *) packet_iv[i][0].buffer) + header_size, packet_iv[i][1].buffer,
+				MIN (size - header_size, packet_iv[i][1].size));
+
+		predicted_packet_ids[i] = 0;
+	}
+}
+
+/* Conversion of a realtime clock packet timestamp to the monotonic clock base used by the resend logic */
+
+static guint64
+_packet_time_us (guint64 time_us, guint64 real_time_ns, guint64 timestamp_ns)
+{
+	guint64 age_us;
+
+	if (timestamp_ns == 0 || timestamp_ns >= real_time_ns)
+		return time_us;
+
+	age_us = (real_time_ns - timestamp_ns) / 1000;
+
+	return age_us < time_us ? time_us - age_us : time_us;
+}
+
+#if ARV_GV_STREAM_HAS_TIMESTAMPING
+
+static gboolean
+_enable_hardware_timestamping (int fd, GInetAddress *interface_address)
+{
+	struct ifaddrs *ifaddr = NULL;
+	struct ifaddrs *ifa;
+	struct hwtstamp_config config = {0};
+	struct ifreq ifr = {0};
+	const guint8 *bytes;
+	guint32 ip;
+	gboolean success = FALSE;
+
+	bytes = g_inet_address_to_bytes (interface_address);
+	memcpy (&ip, bytes, sizeof (ip));
+
+	if (getifaddrs (&ifaddr) == -1)
+		return FALSE;
+
+	for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
+		if (ifa->ifa_addr != NULL &&
+		    ifa->ifa_addr->sa_family == AF_INET &&
+		    ((struct sockaddr_in *) ifa->ifa_addr)->sin_addr.s_addr == ip) {
+			g_strlcpy (ifr.ifr_name, ifa->ifa_name, sizeof (ifr.ifr_name));
+			break;
+		}
+	}
+
+	freeifaddrs (ifaddr);
+
+	if (ifr.ifr_name[0] == '\0')
+		return FALSE;
+
+	/* Setting the interface receive filter needs CAP_NET_ADMIN, but it may already be set, by a PTP daemon */
+	config.tx_type = HWTSTAMP_TX_OFF;
+	config.rx_filter = HWTSTAMP_FILTER_ALL;
+	ifr.ifr_data = (void *) &config;
+
+	if (ioctl (fd, SIOCSHWTSTAMP, &ifr) == 0 ||
+	    ioctl (fd, SIOCGHWTSTAMP, &ifr) == 0)
+		success = config.rx_filter != HWTSTAMP_FILTER_NONE;
+
+	if (!success)
+		arv_warning_stream_thread ("[GvStream::enable_hardware_timestamping] "
+					   "Hardware timestamps are not available on %s", ifr.ifr_name);
+
+	return success;
+}
+
+static gboolean
+_enable_socket_timestamping (ArvGvStreamThreadData *thread_data, int fd)
+{
+	int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+	if (thread_data->packet_timestamp == ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM)
+		return FALSE;
+
+	if (thread_data->packet_timestamp == ARV_GV_STREAM_PACKET_TIMESTAMP_HARDWARE &&
+	    _enable_hardware_timestamping (fd, thread_data->interface_address))
+		flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+	if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof (flags)) != 0) {
+		arv_warning_stream_thread ("[GvStream::enable_socket_timestamping] Failed to enable packet timestamps (%s)",
+					   g_strerror (errno));
+		return FALSE;
+	}
+
+	arv_info_stream_thread ("[GvStream::enable_socket_timestamping] %s packet timestamps enabled",
+				(flags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0 ? "Hardware" : "Kernel");
+
+	return TRUE;
+}
+
+/* GInputVector has the same layout as struct iovec, which allows to pass the packet vectors to recvmmsg */
+G_STATIC_ASSERT (sizeof (GInputVector) == sizeof (struct iovec));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (GInputVector, buffer) == G_STRUCT_OFFSET (struct iovec, iov_base));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (GInputVector, size) == G_STRUCT_OFFSET (struct iovec, iov_len));
+
+#else
+
+static gboolean
+_enable_socket_timestamping (ArvGvStreamThreadData *thread_data, int fd)
+{
+	if (thread_data->packet_timestamp != ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM)
+		arv_warning_stream_thread ("[GvStream::enable_socket_timestamping] Packet timestamps are not available");
+
+	return FALSE;
+}
+
+#endif
+
+static void
+_enable_busy_poll (ArvGvStreamThreadData *thread_data, int fd)
+{
+#ifdef SO_BUSY_POLL
+	int busy_poll_us = MIN (thread_data->busy_poll_us, G_MAXINT);
+#ifdef SO_PREFER_BUSY_POLL
+	int prefer_busy_poll = 1;
+#endif
+
+	if (busy_poll_us == 0)
+		return;
+
+	/* Values above net.core.busy_read need CAP_NET_ADMIN */
+	if (setsockopt (fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof (busy_poll_us)) != 0)
+		arv_warning_stream_thread ("[GvStream::enable_busy_poll] Failed to set SO_BUSY_POLL (%s)",
+					   g_strerror (errno));
+#ifdef SO_PREFER_BUSY_POLL
+	if (setsockopt (fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer_busy_poll, sizeof (prefer_busy_poll)) != 0)
+		arv_info_stream_thread ("[GvStream::enable_busy_poll] Failed to set SO_PREFER_BUSY_POLL (%s)",
+					g_strerror (errno));
+#endif
+#endif
+}
+
+/*
+ * Wait for socket events. With busy polling, the file descriptors are polled without blocking during the busy poll
+ * time, which avoids the interrupt and wakeup latencies, before falling back to a blocking poll.
+ */
+
+static int
+_poll_sockets (ArvGvStreamThreadData *thread_data, GPollFD *poll_fds, guint n_poll_fds, int timeout_ms)
+{
+	int n_events;
+	int errsv;
+	guint i;
+
+	if (thread_data->busy_poll_us > 0) {
+		gint64 end_time_us = g_get_monotonic_time () + thread_data->busy_poll_us;
+
+		do {
+			for (i = 0; i < n_poll_fds; i++)
+				poll_fds[i].revents = 0;
+			n_events = g_poll (poll_fds, n_poll_fds, 0);
+			if (n_events > 0 || (n_events < 0 && errno != EINTR))
+				return n_events;
+		} while (g_get_monotonic_time () < end_time_us);
+	}
+
+	do {
+		for (i = 0; i < n_poll_fds; i++)
+			poll_fds[i].revents = 0;
+		n_events = g_poll (poll_fds, n_poll_fds, timeout_ms);
+		errsv = errno;
+	} while (n_events < 0 && errsv == EINTR);
+
+	return n_events;
+}
+
+/*
+ * Receive a batch of packets. When packet timestamping is enabled, recvmmsg is used instead of
+ * g_socket_receive_messages, which drops the SCM_TIMESTAMPING control messages. @timestamps_ns receives the hardware
+ * timestamps if available, the software ones otherwise, and @software_timestamps_ns the software ones.
+ */
+
+static int
+_receive_messages (ArvGvStreamThreadData *thread_data,
+		   gboolean use_timestamps,
+		   GInputMessage *packet_im,
+		   guint64 *timestamps_ns,
+		   guint64 *software_timestamps_ns)
+{
+	int n_msgs;
+
+#if ARV_GV_STREAM_HAS_TIMESTAMPING
+	if (use_timestamps) {
+		struct mmsghdr msgs[ARV_GV_STREAM_NUM_BUFFERS];
+		char control[ARV_GV_STREAM_NUM_BUFFERS][CMSG_SPACE (sizeof (struct scm_timestamping))];
+		int i;
+
+		memset (msgs, 0, sizeof (msgs));
+		for (i = 0; i < ARV_GV_STREAM_NUM_BUFFERS; i++) {
+			msgs[i].msg_hdr.msg_iov = (struct iovec *) packet_im[i].vectors;
+			msgs[i].msg_hdr.msg_iovlen = packet_im[i].num_vectors;
+			msgs[i].msg_hdr.msg_control = control[i];
+			msgs[i].msg_hdr.msg_controllen = sizeof (control[i]);
+		}
+
+		n_msgs = recvmmsg (g_socket_get_fd (thread_data->socket), msgs, ARV_GV_STREAM_NUM_BUFFERS,
+				   MSG_DONTWAIT, NULL);
+		if (n_msgs < 0)
+			return 0;
+
+		for (i = 0; i < n_msgs; i++) {
+			struct cmsghdr *cmsg;
+
+			packet_im[i].bytes_received = msgs[i].msg_len;
+			timestamps_ns[i] = 0;
+			software_timestamps_ns[i] = 0;
+
+			for (cmsg = CMSG_FIRSTHDR (&msgs[i].msg_hdr); cmsg != NULL;
+			     cmsg = CMSG_NXTHDR (&msgs[i].msg_hdr, cmsg)) {
+				if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+					struct scm_timestamping ts;
+
+					memcpy (&ts, CMSG_DATA (cmsg), sizeof (ts));
+					software_timestamps_ns[i] = ts.ts[0].tv_sec * 1000000000LL + ts.ts[0].tv_nsec;
+					timestamps_ns[i] = ts.ts[2].tv_sec != 0 || ts.ts[2].tv_nsec != 0 ?
+						ts.ts[2].tv_sec * 1000000000LL + ts.ts[2].tv_nsec :
+						software_timestamps_ns[i];
+				}
+			}
+		}
+
+		return n_msgs;
+	}
+#endif
+
+	n_msgs = g_socket_receive_messages (thread_data->socket,
+					    packet_im,
+					    ARV_GV_STREAM_NUM_BUFFERS,
+					    G_SOCKET_MSG_NONE,
+					    NULL,
+					    NULL);
+
+	return n_msgs < 0 ? 0 : n_msgs;
+}
+
+/*
+ * State of the standard socket method, split from the loop so that a shared worker can run the packet reception of
+ * several streams in a single thread.
+ */
+
+typedef struct {
+	ArvGvspPacket *packet_buffers;
+	guint packet_buffer_size;
+	GInputVector packet_iv[ARV_GV_STREAM_NUM_BUFFERS][3];
+	GInputMessage packet_im[ARV_GV_STREAM_NUM_BUFFERS];
+	guint32 predicted_packet_ids[ARV_GV_STREAM_NUM_BUFFERS];
+	guint64 timestamps_ns[ARV_GV_STREAM_NUM_BUFFERS];
+	guint64 software_timestamps_ns[ARV_GV_STREAM_NUM_BUFFERS];
+	gboolean use_timestamps;
+	guint64 direct_frame_id;
+	guint32 direct_packet_id;
+	gboolean scattered;
+	/* Direct receive needs exclusive access to the not yet received parts of the frame buffers */
+	gboolean can_direct_receive;
+	gboolean is_memory_locked;
+	GPollFD poll_fd;
+} ArvGvStreamSocketLoop;
+
+static ArvGvStreamSocketLoop *
+_socket_loop_new (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamSocketLoop *loop;
+	unsigned i;
+
+	loop = g_new0 (ArvGvStreamSocketLoop, 1);
+
+	loop->can_direct_receive = thread_data->n_receivers == 0;
+	// we don't need to consider the IP and UDP header size
+	loop->packet_buffer_size = thread_data->scps_packet_size - 20 - 8;
+	loop->use_timestamps = _enable_socket_timestamping (thread_data, g_socket_get_fd (thread_data->socket));
+
+	loop->poll_fd.fd = g_socket_get_fd (thread_data->socket);
+	loop->poll_fd.events =  G_IO_IN;
+	loop->poll_fd.revents = 0;
+
+	arv_gpollfd_prepare_all (&loop->poll_fd, 1);
+
+	loop->packet_buffers = g_malloc0 (loop->packet_buffer_size * ARV_GV_STREAM_NUM_BUFFERS);
+	loop->is_memory_locked = arv_stream_lock_memory (thread_data->stream, loop->packet_buffers,
+							 loop->packet_buffer_size * ARV_GV_STREAM_NUM_BUFFERS);
+
+	for (i = 0; i < ARV_GV_STREAM_NUM_BUFFERS; i++) {
+		loop->packet_iv[i][0].buffer = (char *) loop->packet_buffers + i * loop->packet_buffer_size;
+		loop->packet_iv[i][0].size = loop->packet_buffer_size;
+		loop->packet_im[i].vectors = loop->packet_iv[i];
+		loop->packet_im[i].num_vectors = 1;
+	}
+
+	return loop;
+}
+
+static void
+_socket_loop_free (ArvGvStreamSocketLoop *loop)
+{
+	arv_gpollfd_finish_all (&loop->poll_fd, 1);
+	if (loop->is_memory_locked)
+		arv_memory_unlock (loop->packet_buffers, loop->packet_buffer_size * ARV_GV_STREAM_NUM_BUFFERS);
+	g_free (loop->packet_buffers);
+	g_free (loop);
+}
+
+/* Receives and processes the pending packets, once the stream socket is readable */
+
+static void
+_socket_loop_receive (ArvGvStreamThreadData *thread_data, ArvGvStreamSocketLoop *loop)
+{
+	ArvGvStreamProcessPacket process_packet;
+	ArvGvStreamFrameData *frame;
+	ArvGvStreamFrameData *direct_frame = NULL;
+	unsigned n_predicted = 0;
+	guint64 time_us;
+	guint64 real_time_ns;
+	int n_msgs;
+	unsigned i;
+
+	arv_gpollfd_clear_one (&loop->poll_fd, thread_data->socket);
+
+	if (loop->can_direct_receive && loop->direct_packet_id > 0) {
+		direct_frame = _find_frame_by_id (thread_data, loop->direct_frame_id);
+		if (direct_frame != NULL && !_use_direct_receive (thread_data, direct_frame->buffer))
+			direct_frame = NULL;
+	}
+	/* Also called without frame after a direct receive, in order to restore the staging vectors */
+	if (direct_frame != NULL || loop->scattered)
+		n_predicted = _direct_receive_prepare (thread_data, direct_frame, loop->direct_packet_id,
+						       (char *) loop->packet_buffers, loop->packet_buffer_size,
+						       loop->packet_im, loop->packet_iv, loop->predicted_packet_ids);
+	loop->scattered = n_predicted > 0;
+
+	n_msgs = _receive_messages (thread_data, loop->use_timestamps, loop->packet_im, loop->timestamps_ns,
+				    loop->software_timestamps_ns);
+
+	time_us = g_get_monotonic_time ();
+	real_time_ns = loop->use_timestamps ? g_get_real_time () * 1000LL : 0;
+
+	if (n_predicted > 0)
+		_direct_receive_check (direct_frame, n_msgs, loop->packet_im, loop->packet_iv,
+				       loop->predicted_packet_ids);
+
+	process_packet = thread_data->process_packet;
+
+	_frame_lock (thread_data);
+	for (i = 0; i < n_msgs; i++) {
+		guint64 packet_time_us = time_us;
+
+		/* Kernel software timestamps also give the packet age, for the resend logic */
+		if (loop->software_timestamps_ns[i] != 0)
+			packet_time_us = _packet_time_us (time_us, real_time_ns, loop->software_timestamps_ns[i]);
+
+		frame = process_packet (thread_data,
+					loop->packet_iv[i][0].buffer,
+					loop->packet_im[i].bytes_received,
+					loop->predicted_packet_ids[i] != 0 ? loop->packet_iv[i][1].buffer : NULL,
+					packet_time_us,
+					loop->timestamps_ns[i]);
+		if (frame != NULL && frame->frame_id == thread_data->last_frame_id) {
+			guint32 packet_id = arv_gvsp_packet_get_packet_id (loop->packet_iv[i][0].buffer);
+
+			if (frame->frame_id != loop->direct_frame_id) {
+				loop->direct_frame_id = frame->frame_id;
+				loop->direct_packet_id = 0;
+			}
+			if (packet_id + 1 > loop->direct_packet_id)
+				loop->direct_packet_id = packet_id + 1;
+		}
+		_check_frame_completion (thread_data, time_us, frame);
+	}
+	_frame_unlock (thread_data);
+}
+
+/* Checks the packet and frame timeouts, when no packet was received */
+
+static void
+_socket_loop_check (ArvGvStreamThreadData *thread_data)
+{
+	guint64 time_us = g_get_monotonic_time ();
+
+	_frame_lock (thread_data);
+	_check_frame_completion (thread_data, time_us, NULL);
+	_frame_unlock (thread_data);
+}
+
+static int
+_socket_loop_get_timeout_ms (ArvGvStreamThreadData *thread_data)
+{
+	guint64 timeout_us = ARV_GV_STREAM_POLL_TIMEOUT_US;
+
+	if (thread_data->n_frames > 0)
+		return thread_data->packet_timeout_us / 1000;
+
+	/* Wake up often enough for the stall detection to take a few frames */
+	if (thread_data->stall_watchdog != ARV_GV_STREAM_STALL_WATCHDOG_DISABLED) {
+		guint64 stall_timeout_us = _get_stall_timeout_us (thread_data);
+
+		if (stall_timeout_us > 0)
+			timeout_us = CLAMP (stall_timeout_us / 4, 1000, timeout_us);
+	}
+
+	return timeout_us / 1000;
+}
+
+static void
+_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamSocketLoop *loop;
+	GPollFD poll_fd[3];
+	guint n_poll_fds = 1;
+	guint wakeup_poll_fd = 0;
+	gboolean use_poll;
+
+	arv_info_stream ("[GvStream::loop] Standard socket method");
+
+	loop = _socket_loop_new (thread_data);
+	_enable_busy_poll (thread_data, g_socket_get_fd (thread_data->socket));
+
+	poll_fd[0] = loop->poll_fd;
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+	if (use_poll)
+		n_poll_fds++;
+	/* Receiver threads wake up the stream thread when they have received the last missing packet of a frame */
+	if (thread_data->completion_wakeup != NULL) {
+		arv_wakeup_get_pollfd (thread_data->completion_wakeup, &poll_fd[n_poll_fds]);
+		wakeup_poll_fd = n_poll_fds;
+		n_poll_fds++;
+	}
+
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+
+	do {
+		_poll_sockets (thread_data, poll_fd, n_poll_fds, _socket_loop_get_timeout_ms (thread_data));
+
+		if (wakeup_poll_fd > 0 && poll_fd[wakeup_poll_fd].revents != 0)
+			arv_wakeup_acknowledge (thread_data->completion_wakeup);
+
+		if (poll_fd[0].revents != 0) {
+			loop->poll_fd.revents = poll_fd[0].revents;
+			_socket_loop_receive (thread_data, loop);
+		} else
+			_socket_loop_check (thread_data);
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	_socket_loop_free (loop);
+}
+
+/* g_socket_join_multicast_group() selects the interface by name, while the stream only knows its address */
+
+static gboolean
+_join_multicast_group (GSocket *socket, GInetAddress *group, GInetAddress *interface_address, GError **error)
+{
+	struct ip_mreq request;
+
+	memset (&request, 0, sizeof (request));
+	memcpy (&request.imr_multiaddr, g_inet_address_to_bytes (group), sizeof (request.imr_multiaddr));
+	memcpy (&request.imr_interface, g_inet_address_to_bytes (interface_address), sizeof (request.imr_interface));
+
+	if (setsockopt (g_socket_get_fd (socket), IPPROTO_IP, IP_ADD_MEMBERSHIP,
+			(const char *) &request, sizeof (request)) != 0) {
+		char *group_string = g_inet_address_to_string (group);
+
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Failed to join multicast group %s (%s)", group_string, g_strerror (errno));
+		g_free (group_string);
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Multi-threaded receive: additional sockets are bound to the stream port using SO_REUSEPORT, and a classic BPF
+ * program attached to the socket group dispatches the data block packets to the sockets using their packet id modulo
+ * the number of sockets. All the other packets (leaders, trailers, errors) go to the stream thread socket, which is
+ * the first member of the group. Each receiver thread reassembles its packets in the shared frame ring, but only the
+ * stream thread completes the frames.
+ */
+
+#if ARV_GV_STREAM_HAS_REUSEPORT
+
+/* SO_REUSEPORT lets any process of the same user bind to the stream port and take a share of the packets. It is
+ * only set while several receive threads are configured. */
+
+static gboolean
+_set_reuseport (GSocket *socket, gboolean enable)
+{
+	int value = enable ? 1 : 0;
+
+	return setsockopt (g_socket_get_fd (socket), SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) == 0;
+}
+
+/* g_socket_bind() can't be used, as it only sets SO_REUSEPORT along with SO_REUSEADDR */
+
+static gboolean
+_bind_with_reuseport (GSocket *socket, GSocketAddress *address)
+{
+	struct sockaddr_storage native_address;
+
+	if (!g_socket_address_to_native (address, &native_address, sizeof (native_address), NULL))
+		return FALSE;
+
+	return _set_reuseport (socket, TRUE) &&
+		bind (g_socket_get_fd (socket), (struct sockaddr *) &native_address,
+		      g_socket_address_get_native_size (address)) == 0;
+}
+
+static gboolean
+_set_reuseport_filter (int socket, guint n_sockets)
+{
+	/* The program runs with the UDP payload at offset 0 */
+	struct sock_filter bpf[] = {
+		{ BPF_LD | BPF_B | BPF_ABS, 0, 0, 4 },			/* ldb [4]: first byte of packet infos */
+		{ BPF_MISC | BPF_TAX, 0, 0, 0 },			/* tax */
+		{ BPF_ALU | BPF_AND | BPF_K, 0, 0, 0x7f },		/* and #0x7f: content type */
+		{ BPF_JMP | BPF_JEQ | BPF_K, 0, 8, ARV_GVSP_CONTENT_TYPE_DATA_BLOCK },
+		{ BPF_MISC | BPF_TXA, 0, 0, 0 },			/* txa */
+		{ BPF_JMP | BPF_JSET | BPF_K, 0, 2, ARV_GVSP_PACKET_EXTENDED_ID_MODE_MASK },
+		{ BPF_LD | BPF_W | BPF_ABS, 0, 0, 16 },			/* ld [16]: extended packet id */
+		{ BPF_JMP | BPF_JA, 0, 0, 2 },
+		{ BPF_LD | BPF_W | BPF_ABS, 0, 0, 4 },			/* ld [4]: packet infos */
+		{ BPF_ALU | BPF_AND | BPF_K, 0, 0, ARV_GVSP_PACKET_ID_MASK },
+		{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, n_sockets },
+		{ BPF_RET | BPF_A, 0, 0, 0 },				/* ret a: socket index */
+		{ BPF_RET | BPF_K, 0, 0, 0 },				/* ret #0: stream thread socket */
+	};
+	struct sock_fprog bpf_prog = {G_N_ELEMENTS (bpf), bpf};
+
+	return setsockopt (socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &bpf_prog, sizeof (bpf_prog)) == 0;
+}
+
+static void *
+_receiver_thread (void *data)
+{
+	ArvGvStreamReceiver *receiver = data;
+	ArvGvStreamThreadData *thread_data = receiver->thread_data;
+	ArvGvStreamProcessPacket process_packet;
+	char *packet_buffers;
+	GPollFD poll_fd[2];
+	GInputVector packet_iv[ARV_GV_STREAM_NUM_BUFFERS];
+	GInputMessage packet_im[ARV_GV_STREAM_NUM_BUFFERS] = { {NULL, NULL, 0, 0, 0, NULL, NULL}, };
+	gboolean use_poll;
+	unsigned i;
+	// we don't need to consider the IP and UDP header size
+	guint packet_buffer_size = thread_data->scps_packet_size - 20 - 8;
+
+	arv_stream_apply_thread_affinity (thread_data->stream);
+
+	_enable_busy_poll (thread_data, g_socket_get_fd (receiver->socket));
+
+	poll_fd[0].fd = g_socket_get_fd (receiver->socket);
+	poll_fd[0].events =  G_IO_IN;
+	poll_fd[0].revents = 0;
+
+	arv_gpollfd_prepare_all(poll_fd,1);
+
+	packet_buffers = g_malloc0 (packet_buffer_size * ARV_GV_STREAM_NUM_BUFFERS);
+
+	for (i = 0; i < ARV_GV_STREAM_NUM_BUFFERS; i++) {
+		packet_iv[i].buffer = packet_buffers + i * packet_buffer_size;
+		packet_iv[i].size = packet_buffer_size;
+		packet_im[i].vectors = &packet_iv[i];
+		packet_im[i].num_vectors = 1;
+	}
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+
+	do {
+		_poll_sockets (thread_data, poll_fd, use_poll ? 2 : 1, ARV_GV_STREAM_POLL_TIMEOUT_US / 1000);
+
+		if (poll_fd[0].revents != 0) {
+			gboolean frame_completed = FALSE;
+			guint64 time_us;
+			int n_msgs;
+
+			arv_gpollfd_clear_one (&poll_fd[0], receiver->socket);
+
+			n_msgs = g_socket_receive_messages (receiver->socket,
+							    packet_im,
+							    ARV_GV_STREAM_NUM_BUFFERS,
+							    G_SOCKET_MSG_NONE,
+							    NULL,
+							    NULL);
+
+			if (n_msgs < 0)
+				n_msgs = 0;
+
+			time_us = g_get_monotonic_time ();
+			process_packet = thread_data->process_packet;
+
+			g_mutex_lock (&thread_data->frame_mutex);
+			for (i = 0; i < n_msgs; i++) {
+				ArvGvStreamFrameData *frame;
+
+				frame = process_packet (thread_data,
+							packet_iv[i].buffer,
+							packet_im[i].bytes_received,
+							NULL,
+							time_us, 0);
+				if (frame != NULL && frame->n_packets_known &&
+				    frame->last_valid_packet == frame->n_packets - 1)
+					frame_completed = TRUE;
+			}
+			g_mutex_unlock (&thread_data->frame_mutex);
+
+			if (frame_completed)
+				arv_wakeup_signal (thread_data->completion_wakeup);
+		}
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	arv_gpollfd_finish_all (poll_fd,1);
+	g_free (packet_buffers);
+
+	return NULL;
+}
+
+#endif
+
+static void
+_start_receivers (ArvGvStreamThreadData *thread_data)
+{
+#if ARV_GV_STREAM_HAS_REUSEPORT
+	GSocketAddress *socket_address;
+	guint n_receivers;
+	guint i;
+
+	n_receivers = CLAMP (thread_data->n_receive_threads, 1, ARV_GV_STREAM_MAX_RECEIVE_THREADS) - 1;
+	if (n_receivers == 0)
+		return;
+
+	/* Multicast datagrams are delivered to all the sockets of a reuseport group */
+	if (thread_data->multicast_group != NULL) {
+		arv_info_stream_thread ("[GvStream::start_receivers] Multi-threaded receive is not available "
+					"for multicast streams");
+		return;
+	}
+
+	/* The receive threads may have been enabled after the stream socket was bound. A bound socket joins the
+	 * reuseport group of the receiver sockets once the option is set. */
+	if (!_set_reuseport (thread_data->socket, TRUE)) {
+		arv_warning_stream_thread ("[GvStream::start_receivers] Failed to set SO_REUSEPORT (%s)",
+					   g_strerror (errno));
+		return;
+	}
+
+	socket_address = g_inet_socket_address_new (thread_data->interface_address, thread_data->stream_port);
+
+	for (i = 0; i < n_receivers; i++) {
+		GSocket *socket;
+		GError *error = NULL;
+
+		socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, &error);
+		if (socket != NULL) {
+			g_socket_set_blocking (socket, FALSE);
+			if (!_bind_with_reuseport (socket, socket_address))
+				g_clear_object (&socket);
+		}
+
+		if (socket == NULL) {
+			arv_warning_stream_thread ("[GvStream::start_receivers] Failed to create receiver socket (%s)",
+						   error != NULL ? error->message : g_strerror (errno));
+			g_clear_error (&error);
+			break;
+		}
+
+		if (thread_data->current_socket_buffer_size > 0)
+			arv_socket_set_recv_buffer_size (g_socket_get_fd (socket),
+							 thread_data->current_socket_buffer_size);
+
+		thread_data->receivers[i].thread_data = thread_data;
+		thread_data->receivers[i].socket = socket;
+		thread_data->receivers[i].n_socket_drops = 0;
+	}
+
+	g_object_unref (socket_address);
+
+	if (i > 0 && !_set_reuseport_filter (g_socket_get_fd (thread_data->socket), i + 1)) {
+		arv_warning_stream_thread ("[GvStream::start_receivers] Failed to attach reuseport filter (%s)",
+					   g_strerror (errno));
+		while (i > 0)
+			g_clear_object (&thread_data->receivers[--i].socket);
+	}
+
+	if (i == 0) {
+		_set_reuseport (thread_data->socket, FALSE);
+		return;
+	}
+
+	thread_data->completion_wakeup = arv_wakeup_new ();
+	thread_data->n_receivers = i;
+
+	for (i = 0; i < thread_data->n_receivers; i++)
+		thread_data->receivers[i].thread = g_thread_new ("arv_gv_stream_receiver", _receiver_thread,
+								 &thread_data->receivers[i]);
+
+	arv_info_stream_thread ("[GvStream::start_receivers] %u additional receiver thread%s",
+				thread_data->n_receivers, thread_data->n_receivers > 1 ? "s" : "");
+#else
+	if (thread_data->n_receive_threads > 1)
+		arv_warning_stream_thread ("[GvStream::start_receivers] Multi-threaded receive is not supported");
+#endif
+}
+
+/* Must be called after the stream thread cancellable is cancelled */
+
+static void
+_stop_receivers (ArvGvStreamThreadData *thread_data)
+{
+	guint i;
+
+	for (i = 0; i < thread_data->n_receivers; i++) {
+		g_thread_join (thread_data->receivers[i].thread);
+		thread_data->receivers[i].thread = NULL;
+	}
+
+	/* Frames can't be modified by the receivers anymore */
+	thread_data->n_receivers = 0;
+
+	for (i = 0; i < G_N_ELEMENTS (thread_data->receivers); i++)
+		g_clear_object (&thread_data->receivers[i].socket);
+
+#if ARV_GV_STREAM_HAS_REUSEPORT
+	/* Don't let other sockets join the stream port while it is not shared by receive threads */
+	if (thread_data->multicast_group == NULL && thread_data->n_receive_threads <= 1)
+		_set_reuseport (thread_data->socket, FALSE);
+#endif
+
+	g_clear_pointer (&thread_data->completion_wakeup, arv_wakeup_free);
+}
+
+
+#if ARAVIS_HAS_PACKET_SOCKET
+
+static void
+_set_socket_filter (int socket, guint32 source_ip, guint32 source_port, guint32 destination_ip, guint32 destination_port)
+{
+
+#if 0
+/*
+ * sudo tcpdump -i lo -e -nn  "udp and src host 192.168.0.1 and src port 10 and dst host 192.168.0.2 and dst port 20" -d
+ *
+ * (000) ldh      [12]
+ * (001) jeq      #0x86dd          jt 17	jf 2
+ * (002) jeq      #0x800           jt 3	        jf 17
+ * (003) ldb      [23]
+ * (004) jeq      #0x11            jt 5	        jf 17
+ * (005) ld       [26]
+ * (006) jeq      #0xc0a80001      jt 7	        jf 17           Source host
+ * (007) ldh      [20]
+ * (008) jset     #0x1fff          jt 17	jf 9
+ * (009) ldxb     4*([14]&0xf)
+ * (010) ldh      [x + 14]
+ * (011) jeq      #0xa             jt 12	jf 17           Source port
+ * (012) ld       [30]
+ * (013) jeq      #0xc0a80002      jt 14	jf 17           Destination host
+ * (014) ldh      [x + 16]
+ * (015) jeq      #0x14            jt 16	jf 17           Destination port
+ * (016) ret      #262144
+ * (017) ret      #0
+ */
+
+	struct sock_filter bpf[] = {
+		{ 0x28, 0, 0, 0x0000000c },
+		{ 0x15, 15, 0, 0x000086dd },
+		{ 0x15, 0, 14, 0x00000800 },
+		{ 0x30, 0, 0, 0x00000017 },
+		{ 0x15, 0, 12, 0x00000011 },
+		{ 0x20, 0, 0, 0x0000001a },
 		{ 0x15, 0, 10, source_ip },
 		{ 0x28, 0, 0, 0x00000014 },
 		{ 0x45, 8, 0, 0x00001fff },
@@ -931,272 +3310,1821 @@ _set_socket_filter (int socket, guint32 source_ip, guint32 source_port, guint32
 		{ 0x48, 0, 0, 0x0000000e },
 		{ 0x15, 0, 5, source_port },
 		{ 0x20, 0, 0, 0x0000001e },
-		{ 0x15, 0, 3, destination_ip },
+		{ 0x15, 0, 3, destination_ip },
+		{ 0x48, 0, 0, 0x00000010 },
+		{ 0x15, 0, 1, destination_port },
+		{ 0x6, 0, 0, 0x00040000 },
+		{ 0x6, 0, 0, 0x00000000 }
+	};
+#else /* Variant without source port check. */
+/*
+ * sudo tcpdump -i lo -e -nn  "udp and src host 192.168.0.1 and dst host 192.168.0.2 and dst port 20" -d
+ *
+ * (000) ldh      [12]
+ * (001) jeq      #0x86dd          jt 15	jf 2
+ * (002) jeq      #0x800           jt 3	jf 15
+ * (003) ldb      [23]
+ * (004) jeq      #0x11            jt 5	jf 15
+ * (005) ld       [26]
+ * (006) jeq      #0xc0a80001      jt 7	jf 15
+ * (007) ld       [30]
+ * (008) jeq      #0xc0a80002      jt 9	jf 15
+ * (009) ldh      [20]
+ * (010) jset     #0x1fff          jt 15	jf 11
+ * (011) ldxb     4*([14]&0xf)
+ * (012) ldh      [x + 16]
+ * (013) jeq      #0x14            jt 14	jf 15
+ * (014) ret      #262144
+ * (015) ret      #0
+ */
+
+	struct sock_filter bpf[] = {
+		{ 0x28, 0, 0, 0x0000000c },
+		{ 0x15, 13, 0, 0x000086dd },
+		{ 0x15, 0, 12, 0x00000800 },
+		{ 0x30, 0, 0, 0x00000017 },
+		{ 0x15, 0, 10, 0x00000011 },
+		{ 0x20, 0, 0, 0x0000001a },
+		{ 0x15, 0, 8, source_ip },
+		{ 0x20, 0, 0, 0x0000001e },
+		{ 0x15, 0, 6, destination_ip },
+                { 0x28, 0, 0, 0x00000014},
+		{ 0x45, 4, 0, 0x00001fff },
+		{ 0xb1, 0, 0, 0x0000000e },
 		{ 0x48, 0, 0, 0x00000010 },
 		{ 0x15, 0, 1, destination_port },
 		{ 0x6, 0, 0, 0x00040000 },
 		{ 0x6, 0, 0, 0x00000000 }
 	};
-#else /* Variant without source port check. */
+#endif
+
+	struct sock_fprog bpf_prog = {G_N_ELEMENTS (bpf), bpf};
+
+	arv_info_stream_thread ("[GvStream::set_socket_filter] source ip = 0x%08x - port = %d - dest ip = 0x%08x - port %d",
+				 source_ip, source_port, destination_ip, destination_port);
+
+	if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &bpf_prog, sizeof(bpf_prog)) != 0)
+		arv_warning_stream_thread ("[GvStream::set_socket_filter] Failed to attach Beckerley Packet Filter to stream socket");
+}
+
+#endif /* ARAVIS_HAS_PACKET_SOCKET */
+
+#if ARAVIS_HAS_PACKET_SOCKET || ARAVIS_HAS_XDP
+
+static unsigned
+_interface_index_from_address (guint32 ip)
+{
+    struct ifaddrs *ifaddr = NULL;
+    struct ifaddrs *ifa;
+    unsigned index = 0;
+
+    if (getifaddrs(&ifaddr) == -1) {
+        return index;
+    }
+
+    for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
+	    if (ifa->ifa_addr != NULL &&
+		ifa->ifa_addr->sa_family == AF_INET) {
+		    struct sockaddr_in *sa;
+
+		    sa = (struct sockaddr_in *) (ifa->ifa_addr);
+		    if (ip == g_ntohl (sa->sin_addr.s_addr)) {
+			    index = if_nametoindex (ifa->ifa_name);
+			    break;
+		    }
+	    }
+    }
+
+    freeifaddrs (ifaddr);
+
+    return index;
+}
+
+#endif /* ARAVIS_HAS_PACKET_SOCKET || ARAVIS_HAS_XDP */
+
+#if ARAVIS_HAS_PACKET_SOCKET
+
+typedef struct {
+	guint32 version;
+	guint32 offset_to_priv;
+	struct tpacket_hdr_v1 h1;
+} ArvGvStreamBlockDescriptor;
+
+/*
+ * Ring size is computed for the storage of at least 2 frames, or ARV_GV_STREAM_RING_DURATION_MS of stream data if the
+ * frame rate is known. Block size is chosen in order to have at least ARV_GV_STREAM_RING_MINIMUM_BLOCK_COUNT blocks
+ * in the ring. Each of the geometry parameter can be overriden using the ring-* properties.
+ */
+
+static void
+_ring_buffer_compute_geometry (ArvGvStreamThreadData *thread_data, struct tpacket_req3 *req)
+{
+	guint64 packet_frame_size;
+	guint64 ring_size;
+	guint block_size;
+	guint page_size;
+
+	page_size = sysconf (_SC_PAGESIZE);
+	packet_frame_size = TPACKET_ALIGN (TPACKET_ALIGN (TPACKET3_HDRLEN) + ETH_HLEN + thread_data->scps_packet_size);
+
+	if (thread_data->payload_size > 0) {
+		guint64 data_size;
+		guint64 frame_ring_size;
+
+		data_size = thread_data->scps_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+		frame_ring_size = ((thread_data->payload_size + data_size - 1) / data_size + 2) * packet_frame_size;
+
+		ring_size = 2 * frame_ring_size;
+		if (thread_data->frame_rate > 0.0)
+			ring_size = MAX (ring_size, (guint64) (frame_ring_size * thread_data->frame_rate *
+							       ARV_GV_STREAM_RING_DURATION_MS / 1000.0));
+		ring_size = CLAMP (ring_size, ARV_GV_STREAM_RING_MINIMUM_SIZE, ARV_GV_STREAM_RING_MAXIMUM_SIZE);
+	} else
+		ring_size = 1 << 25;
+
+	block_size = thread_data->ring_block_size;
+	if (block_size == 0) {
+		block_size = page_size;
+		while ((block_size < ring_size / ARV_GV_STREAM_RING_MINIMUM_BLOCK_COUNT &&
+			block_size < ARV_GV_STREAM_RING_MAXIMUM_BLOCK_SIZE) ||
+		       block_size < 4 * packet_frame_size)
+			block_size <<= 1;
+	}
+
+	req->tp_block_size = block_size;
+	req->tp_block_nr = thread_data->ring_block_count > 0 ?
+		thread_data->ring_block_count :
+		MAX ((ring_size + block_size - 1) / block_size, 2);
+	req->tp_frame_size = thread_data->ring_frame_size > 0 ?
+		thread_data->ring_frame_size :
+		ARV_GV_STREAM_RING_FRAME_SIZE_DEFAULT;
+	req->tp_frame_nr = (req->tp_block_size / req->tp_frame_size) * req->tp_block_nr;
+	req->tp_sizeof_priv = 0;
+	req->tp_retire_blk_tov = thread_data->ring_block_timeout_ms > 0 ?
+		thread_data->ring_block_timeout_ms :
+		ARV_GV_STREAM_RING_BLOCK_TIMEOUT_MS_DEFAULT;
+	req->tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+}
+
+/*
+ * Packet socket fanout: all the packet sockets of the process bound to the same interface join a single fanout group.
+ * A classic BPF program demultiplexes the incoming packets to the socket of the corresponding stream, using the UDP
+ * destination port, instead of having each socket filter run on every packet. In order to know the socket index used
+ * by the kernel, the member list in ArvGvStreamFanoutGroup mirrors the kernel one: members are appended on join, and
+ * on leave the last member replaces the leaving one.
+ */
+
+typedef struct {
+	unsigned interface_index;
+	int group_id;
+	GArray *fds;
+	GArray *ports;
+} ArvGvStreamFanoutGroup;
+
+static GMutex fanout_mutex;
+static GSList *fanout_groups = NULL;
+
+static void
+_fanout_group_update_program (ArvGvStreamFanoutGroup *group)
+{
+	struct sock_filter *bpf;
+	struct sock_fprog bpf_prog;
+	unsigned n_members = group->fds->len;
+	unsigned i;
+
+	bpf = g_new0 (struct sock_filter, 2 * n_members + 3);
+
+	/* ldxb 4*([0]&0xf) - IP header length */
+	bpf[0].code = BPF_LDX | BPF_B | BPF_MSH;
+	/* ldh [x + 2] - UDP destination port */
+	bpf[1].code = BPF_LD | BPF_H | BPF_IND;
+	bpf[1].k = 2;
+	/* jeq #port_i jt ret #i */
+	for (i = 0; i < n_members; i++) {
+		bpf[2 + i].code = BPF_JMP | BPF_JEQ | BPF_K;
+		bpf[2 + i].jt = n_members;
+		bpf[2 + i].k = g_array_index (group->ports, guint16, i);
+	}
+	/* ret #0 */
+	bpf[2 + n_members].code = BPF_RET | BPF_K;
+	for (i = 0; i < n_members; i++) {
+		bpf[3 + n_members + i].code = BPF_RET | BPF_K;
+		bpf[3 + n_members + i].k = i;
+	}
+
+	bpf_prog.len = 2 * n_members + 3;
+	bpf_prog.filter = bpf;
+
+	if (setsockopt (g_array_index (group->fds, int, 0), SOL_PACKET, PACKET_FANOUT_DATA,
+			&bpf_prog, sizeof (bpf_prog)) != 0)
+		arv_warning_stream_thread ("[GvStream::fanout_update_program] Failed to set fanout program (%s)",
+					   g_strerror (errno));
+
+	g_free (bpf);
+}
+
+static gboolean
+_fanout_join (int fd, unsigned interface_index, guint16 port)
+{
+	ArvGvStreamFanoutGroup *group = NULL;
+	GSList *iter;
+	int arg;
+
+	g_mutex_lock (&fanout_mutex);
+
+	for (iter = fanout_groups; iter != NULL; iter = iter->next) {
+		if (((ArvGvStreamFanoutGroup *) iter->data)->interface_index == interface_index) {
+			group = iter->data;
+			break;
+		}
+	}
+
+	if (group == NULL) {
+		socklen_t arg_size = sizeof (arg);
+
+		arg = (PACKET_FANOUT_CBPF | PACKET_FANOUT_FLAG_UNIQUEID) << 16;
+		if (setsockopt (fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof (arg)) != 0 ||
+		    getsockopt (fd, SOL_PACKET, PACKET_FANOUT, &arg, &arg_size) != 0) {
+			arv_warning_stream_thread ("[GvStream::fanout_join] Failed to create fanout group (%s)",
+						   g_strerror (errno));
+			g_mutex_unlock (&fanout_mutex);
+			return FALSE;
+		}
+
+		group = g_new0 (ArvGvStreamFanoutGroup, 1);
+		group->interface_index = interface_index;
+		group->group_id = arg & 0xffff;
+		group->fds = g_array_new (FALSE, FALSE, sizeof (int));
+		group->ports = g_array_new (FALSE, FALSE, sizeof (guint16));
+
+		fanout_groups = g_slist_prepend (fanout_groups, group);
+	} else {
+		arg = group->group_id | (PACKET_FANOUT_CBPF << 16);
+		if (setsockopt (fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof (arg)) != 0) {
+			arv_warning_stream_thread ("[GvStream::fanout_join] Failed to join fanout group %d (%s)",
+						   group->group_id, g_strerror (errno));
+			g_mutex_unlock (&fanout_mutex);
+			return FALSE;
+		}
+	}
+
+	g_array_append_val (group->fds, fd);
+	g_array_append_val (group->ports, port);
+
+	_fanout_group_update_program (group);
+
+	arv_info_stream_thread ("[GvStream::fanout_join] Join fanout group %d (%u member%s)",
+				group->group_id, group->fds->len, group->fds->len > 1 ? "s" : "");
+
+	g_mutex_unlock (&fanout_mutex);
+
+	return TRUE;
+}
+
+/* Closes fd, under the fanout lock in order to keep the member list in sync with the kernel one */
+
+static void
+_fanout_leave (int fd)
+{
+	GSList *iter;
+
+	g_mutex_lock (&fanout_mutex);
+
+	close (fd);
+
+	for (iter = fanout_groups; iter != NULL; iter = iter->next) {
+		ArvGvStreamFanoutGroup *group = iter->data;
+		unsigned i;
+
+		for (i = 0; i < group->fds->len; i++) {
+			if (g_array_index (group->fds, int, i) == fd) {
+				g_array_remove_index_fast (group->fds, i);
+				g_array_remove_index_fast (group->ports, i);
+
+				if (group->fds->len > 0) {
+					_fanout_group_update_program (group);
+				} else {
+					fanout_groups = g_slist_remove (fanout_groups, group);
+					g_array_unref (group->fds);
+					g_array_unref (group->ports);
+					g_free (group);
+				}
+
+				g_mutex_unlock (&fanout_mutex);
+				return;
+			}
+		}
+	}
+
+	g_mutex_unlock (&fanout_mutex);
+}
+
+/* The kernel counts the packets dropped because the ring was full, clearing the statistics on each read. The ring
+ * geometry can't change during the acquisition, the drops are only reported. */
+
+static void
+_check_ring_drops (ArvGvStreamThreadData *thread_data, int fd)
+{
+	struct tpacket_stats_v3 statistics;
+	socklen_t length = sizeof (statistics);
+
+	if (getsockopt (fd, SOL_PACKET, PACKET_STATISTICS, &statistics, &length) != 0 ||
+	    statistics.tp_drops == 0)
+		return;
+
+	thread_data->n_kernel_dropped_packets += statistics.tp_drops;
+
+	arv_info_stream_thread ("[GvStream::check_ring_drops] %u packets dropped by the kernel, consider a larger ring"
+				" (ring-block-count property)", statistics.tp_drops);
+}
+
+#if defined (__GNUC__)
+#define ARV_GV_STREAM_PREFETCH(address) __builtin_prefetch (address)
+#else
+#define ARV_GV_STREAM_PREFETCH(address)
+#endif
+
+/* Processes the packets of a retired block in a batch. The address and port checks are done once for the whole socket
+ * by its filter, and the payloads are copied straight from the ring to the frame buffers. The frame headers of the next
+ * packet are prefetched, assuming the same MAC header offset, and the frame completion is only checked when the
+ * packets switch to another frame, and at the end of the block. */
+
+static void
+_ring_buffer_process_block (ArvGvStreamThreadData *thread_data, const ArvGvStreamBlockDescriptor *descriptor,
+			    guint64 time_us, guint64 real_time_ns)
+{
+	ArvGvStreamFrameData *frame = NULL;
+	ArvGvStreamFrameData *last_frame = NULL;
+	ArvGvStreamProcessPacket process_packet;
+	const struct tpacket3_hdr *header;
+	gboolean use_packet_timestamps;
+	unsigned n_packets;
+	unsigned i;
+
+	use_packet_timestamps = thread_data->packet_timestamp != ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM;
+	process_packet = thread_data->process_packet;
+	n_packets = descriptor->h1.num_pkts;
+
+	header = (void *) (((char *) descriptor) + descriptor->h1.offset_to_first_pkt);
+
+	for (i = 0; i < n_packets; i++) {
+		const struct tpacket3_hdr *next_header;
+		const struct iphdr *ip;
+		const ArvGvspPacket *packet;
+		size_t size;
+
+		next_header = (void *) (((char *) header) + header->tp_next_offset);
+		if (G_LIKELY (i + 1 < n_packets)) {
+			ARV_GV_STREAM_PREFETCH (next_header);
+			ARV_GV_STREAM_PREFETCH (((char *) next_header) + header->tp_mac + ETH_HLEN);
+		}
+
+		ip = (void *) (((char *) header) + header->tp_mac + ETH_HLEN);
+		packet = (void *) (((char *) ip) + sizeof (struct iphdr) + sizeof (struct udphdr));
+		size = g_ntohs (ip->tot_len) -  sizeof (struct iphdr) - sizeof (struct udphdr);
+
+		if (use_packet_timestamps && header->tp_sec != 0) {
+			guint64 timestamp_ns = header->tp_sec * 1000000000LL + header->tp_nsec;
+
+			/* Software timestamps are in the realtime clock base */
+			frame = process_packet (thread_data, packet, size, NULL,
+						(header->tp_status & TP_STATUS_TS_RAW_HARDWARE) != 0 ?
+						time_us :
+						_packet_time_us (time_us, real_time_ns, timestamp_ns),
+						timestamp_ns);
+		} else
+			frame = process_packet (thread_data, packet, size, NULL, time_us, 0);
+
+		if (frame != NULL && frame != last_frame) {
+			_check_frame_completion (thread_data, time_us, frame);
+			last_frame = frame;
+		}
+
+		header = next_header;
+	}
+
+	/* Frame of the last packet, or NULL for a check of all the frames */
+	_check_frame_completion (thread_data, time_us, frame);
+}
+
+static void
+_ring_buffer_loop (ArvGvStreamThreadData *thread_data)
+{
+	GPollFD poll_fd[2];
+	char *buffer;
+	struct tpacket_req3 req;
+	struct sockaddr_ll local_address = {0};
+	enum tpacket_versions version;
+	int fd;
+	unsigned block_id;
+	const guint8 *bytes;
+	guint32 interface_address;
+	guint32 device_address;
+	guint32 destination_address;
+	gboolean use_poll;
+	gboolean use_fanout = FALSE;
+
+	arv_info_stream ("[GvStream::loop] Packet socket method");
+
+	/* Protocol is set at bind time, after the filter and the ring are ready, in order to not receive and store
+	 * unrelated traffic in the meantime. */
+	fd = socket (PF_PACKET, SOCK_RAW, 0);
+	if (fd < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to create AF_PACKET socket");
+		goto af_packet_error;
+	}
+
+	bytes = g_inet_address_to_bytes (thread_data->interface_address);
+	interface_address = g_ntohl (*((guint32 *) bytes));
+	bytes = g_inet_address_to_bytes (thread_data->device_address);
+	device_address = g_ntohl (*((guint32 *) bytes));
+	bytes = g_inet_address_to_bytes (thread_data->multicast_group != NULL ?
+					 thread_data->multicast_group : thread_data->interface_address);
+	destination_address = g_ntohl (*((guint32 *) bytes));
+
+	_set_socket_filter (fd, device_address, thread_data->source_stream_port, destination_address,
+			    thread_data->stream_port);
+
+	version = TPACKET_V3;
+	if (setsockopt (fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet version");
+		goto socket_option_error;
+	}
+
+#if ARV_GV_STREAM_HAS_TIMESTAMPING
+	/* The ring frame headers carry software timestamps by default */
+	if (thread_data->packet_timestamp == ARV_GV_STREAM_PACKET_TIMESTAMP_HARDWARE &&
+	    _enable_hardware_timestamping (fd, thread_data->interface_address)) {
+		int timestamp_flags = SOF_TIMESTAMPING_RAW_HARDWARE;
+
+		if (setsockopt (fd, SOL_PACKET, PACKET_TIMESTAMP, &timestamp_flags, sizeof (timestamp_flags)) < 0)
+			arv_warning_stream_thread ("[GvStream::loop] Failed to enable hardware packet timestamps");
+	}
+#endif
+
+	_ring_buffer_compute_geometry (thread_data, &req);
+
+	arv_info_stream_thread ("[GvStream::loop] Ring geometry: %u blocks of %u bytes, frame size = %u,"
+				" block timeout = %u ms",
+				req.tp_block_nr, req.tp_block_size, req.tp_frame_size, req.tp_retire_blk_tov);
+
+	if (setsockopt (fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet rx ring (%s)", g_strerror (errno));
+		goto socket_option_error;
+	}
+
+	buffer = mmap (NULL, (size_t) req.tp_block_size * req.tp_block_nr, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+	if (buffer == MAP_FAILED) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to map ring buffer");
+		goto map_error;
+	}
+
+	local_address.sll_family   = AF_PACKET;
+	local_address.sll_protocol = g_htons(ETH_P_IP);
+	local_address.sll_ifindex  = _interface_index_from_address (interface_address);
+	local_address.sll_hatype   = 0;
+	local_address.sll_pkttype  = 0;
+	local_address.sll_halen    = 0;
+	if (bind (fd, (struct sockaddr *) &local_address, sizeof(local_address)) == -1) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to bind packet socket");
+		goto bind_error;
+	}
+
+	if (thread_data->packet_fanout)
+		use_fanout = _fanout_join (fd, local_address.sll_ifindex, thread_data->stream_port);
+
+	poll_fd[0].fd = fd;
+	poll_fd[0].events =  G_IO_IN;
+	poll_fd[0].revents = 0;
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+
+	block_id = 0;
+	do {
+		ArvGvStreamBlockDescriptor *descriptor;
+		guint64 time_us;
+		guint64 real_time_ns;
+
+		time_us = g_get_monotonic_time ();
+		real_time_ns = g_get_real_time () * 1000LL;
+
+		descriptor = (void *) (buffer + block_id * req.tp_block_size);
+		if ((descriptor->h1.block_status & TP_STATUS_USER) == 0) {
+                        int timeout_ms;
+			int n_events;
+			int errsv;
+
+			_check_frame_completion (thread_data, time_us, NULL);
+
+                        if (thread_data->n_frames > 0)
+                                timeout_ms = thread_data->packet_timeout_us / 1000;
+                        else
+                                timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+
+			do {
+				n_events = g_poll (poll_fd, use_poll ? 2 : 1,  timeout_ms);
+				errsv = errno;
+			} while (n_events < 0 && errsv == EINTR);
+		} else {
+			gboolean is_losing = (descriptor->h1.block_status & TP_STATUS_LOSING) != 0;
+
+			_ring_buffer_process_block (thread_data, descriptor, time_us, real_time_ns);
+
+			descriptor->h1.block_status = TP_STATUS_KERNEL;
+			block_id = (block_id + 1) % req.tp_block_nr;
+
+			/* The kernel flags the blocks retired while it was dropping packets */
+			if (is_losing)
+				_check_ring_drops (thread_data, fd);
+		}
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+bind_error:
+	munmap (buffer, (size_t) req.tp_block_size * req.tp_block_nr);
+socket_option_error:
+map_error:
+	if (use_fanout)
+		_fanout_leave (fd);
+	else
+		close (fd);
+af_packet_error:
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+}
+
+#endif /* ARAVIS_HAS_PACKET_SOCKET */
+
+#if ARAVIS_HAS_XDP
+
+#define ARV_GV_STREAM_XDP_MAX_QUEUES	8
+#define ARV_GV_STREAM_XDP_N_FRAMES	2048
+#define ARV_GV_STREAM_XDP_FRAME_SIZE	XSK_UMEM__DEFAULT_FRAME_SIZE
+#define ARV_GV_STREAM_XDP_BATCH_SIZE	64
+
+#define ARV_GV_STREAM_XDP_INSN(insn_code,dst,src,offset,immediate)				\
+	((struct bpf_insn) { .code = (insn_code), .dst_reg = (dst), .src_reg = (src),		\
+			     .off = (offset), .imm = (immediate) })
+
+typedef struct {
+	struct xsk_umem *umem;
+	struct xsk_socket *xsk;
+	struct xsk_ring_prod fill;
+	struct xsk_ring_cons completion;
+	struct xsk_ring_cons rx;
+	void *area;
+} ArvGvStreamXdpQueue;
+
 /*
- * sudo tcpdump -i lo -e -nn  "udp and src host 192.168.0.1 and dst host 192.168.0.2 and dst port 20" -d
+ * XDP program redirecting the UDP packets coming from the device to the stream port toward the AF_XDP socket bound
+ * to the receiving queue. Everything else, including fragmented packets and packets with IP options, is passed to
+ * the kernel network stack.
  *
- * (000) ldh      [12]
- * (001) jeq      #0x86dd          jt 15	jf 2
- * (002) jeq      #0x800           jt 3	jf 15
- * (003) ldb      [23]
- * (004) jeq      #0x11            jt 5	jf 15
- * (005) ld       [26]
- * (006) jeq      #0xc0a80001      jt 7	jf 15
- * (007) ld       [30]
- * (008) jeq      #0xc0a80002      jt 9	jf 15
- * (009) ldh      [20]
- * (010) jset     #0x1fff          jt 15	jf 11
- * (011) ldxb     4*([14]&0xf)
- * (012) ldh      [x + 16]
- * (013) jeq      #0x14            jt 14	jf 15
- * (014) ret      #262144
- * (015) ret      #0
+ * r6 = ctx
+ * r2 = ctx->data, r3 = ctx->data_end
+ * if (r2 + ETH_HLEN + IP header + UDP header > r3) goto pass
+ * if (eth->h_proto != ETH_P_IP) goto pass
+ * if (ip->ihl != 5) goto pass
+ * if (ip->protocol != IPPROTO_UDP) goto pass
+ * if (ip->frag_off & (IP_MF | IP_OFFMASK)) goto pass
+ * if (ip->saddr != device_address) goto pass
+ * if (udp->dest != stream_port) goto pass
+ * return bpf_redirect_map (xsks_map, ctx->rx_queue_index, XDP_PASS)
+ * pass:
+ * return XDP_PASS
+ */
+
+static int
+_xdp_load_program (guint32 device_address, guint16 stream_port, int map_fd)
+{
+	struct bpf_insn program[] = {
+		/* 0 */  ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+		/* 1 */  ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1, 0, 0),
+		/* 2 */  ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1, 4, 0),
+		/* 3 */  ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0),
+		/* 4 */  ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0,
+						 ETH_HLEN + sizeof (struct iphdr) + sizeof (struct udphdr)),
+		/* 5 */  ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 19, 0),
+		/* 6 */  ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, 12, 0),
+		/* 7 */  ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 17, g_htons (ETH_P_IP)),
+		/* 8 */  ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETH_HLEN, 0),
+		/* 9 */  ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_AND | BPF_K, BPF_REG_5, 0, 0, 0x0f),
+		/* 10 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 14, 5),
+		/* 11 */ ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETH_HLEN + 9, 0),
+		/* 12 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 12, IPPROTO_UDP),
+		/* 13 */ ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, ETH_HLEN + 6, 0),
+		/* 14 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JSET | BPF_K, BPF_REG_5, 0, 10, g_htons (0x3fff)),
+		/* 15 */ ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_5, BPF_REG_2, ETH_HLEN + 12, 0),
+		/* 16 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP32 | BPF_JNE | BPF_K, BPF_REG_5, 0, 8,
+						 (gint32) g_htonl (device_address)),
+		/* 17 */ ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2,
+						 ETH_HLEN + sizeof (struct iphdr) + 2, 0),
+		/* 18 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 6, g_htons (stream_port)),
+		/* 19 */ ARV_GV_STREAM_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, 16, 0),
+		/* 20 */ ARV_GV_STREAM_XDP_INSN (BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map_fd),
+		/* 21 */ ARV_GV_STREAM_XDP_INSN (0, 0, 0, 0, 0),
+		/* 22 */ ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS),
+		/* 23 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+		/* 24 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+		/* 25 */ ARV_GV_STREAM_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS),
+		/* 26 */ ARV_GV_STREAM_XDP_INSN (BPF_JMP | BPF_EXIT, 0, 0, 0, 0)
+	};
+
+	return bpf_prog_load (BPF_PROG_TYPE_XDP, "arv_gvsp", "GPL", program, G_N_ELEMENTS (program), NULL);
+}
+
+static unsigned
+_xdp_get_n_queues (const char *interface_name)
+{
+	struct ethtool_channels channels = {0};
+	struct ifreq ifr = {0};
+	unsigned n_queues = 1;
+	int fd;
+
+	fd = socket (AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return n_queues;
+
+	channels.cmd = ETHTOOL_GCHANNELS;
+	ifr.ifr_data = (void *) &channels;
+	g_strlcpy (ifr.ifr_name, interface_name, IFNAMSIZ);
+
+	if (ioctl (fd, SIOCETHTOOL, &ifr) == 0 &&
+	    channels.rx_count + channels.combined_count > 0)
+		n_queues = channels.rx_count + channels.combined_count;
+
+	close (fd);
+
+	return MIN (n_queues, ARV_GV_STREAM_XDP_MAX_QUEUES);
+}
+
+static gboolean
+_xdp_queue_init (ArvGvStreamXdpQueue *queue, const char *interface_name, unsigned queue_id, gboolean zero_copy)
+{
+	struct xsk_umem_config umem_config = {
+		.fill_size = ARV_GV_STREAM_XDP_N_FRAMES,
+		.comp_size = XSK_RING_CONS__DEFAULT_NUM_DESCS,
+		.frame_size = ARV_GV_STREAM_XDP_FRAME_SIZE,
+		.frame_headroom = 0,
+		.flags = 0
+	};
+	struct xsk_socket_config socket_config = {
+		.rx_size = XSK_RING_CONS__DEFAULT_NUM_DESCS,
+		.tx_size = XSK_RING_PROD__DEFAULT_NUM_DESCS,
+		.libxdp_flags = XSK_LIBXDP_FLAGS__INHIBIT_PROG_LOAD,
+		.xdp_flags = 0,
+		.bind_flags = XDP_USE_NEED_WAKEUP
+	};
+	size_t area_size = (size_t) ARV_GV_STREAM_XDP_N_FRAMES * ARV_GV_STREAM_XDP_FRAME_SIZE;
+	guint32 index;
+	unsigned i;
+	int result;
+
+	memset (queue, 0, sizeof (ArvGvStreamXdpQueue));
+
+	queue->area = mmap (NULL, area_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	if (queue->area == MAP_FAILED) {
+		queue->area = NULL;
+		return FALSE;
+	}
+
+	result = xsk_umem__create (&queue->umem, queue->area, area_size, &queue->fill, &queue->completion,
+				   &umem_config);
+	if (result != 0) {
+		arv_info_stream_thread ("[GvStream::xdp_queue_init] Failed to create UMEM for queue %u (%s)",
+					queue_id, g_strerror (-result));
+		goto error;
+	}
+
+	if (zero_copy) {
+		socket_config.bind_flags |= XDP_ZEROCOPY;
+		result = xsk_socket__create (&queue->xsk, interface_name, queue_id, queue->umem, &queue->rx, NULL,
+					     &socket_config);
+		if (result != 0) {
+			arv_info_stream_thread ("[GvStream::xdp_queue_init] Zero copy mode unavailable for queue %u (%s)",
+						queue_id, g_strerror (-result));
+			queue->xsk = NULL;
+		}
+		socket_config.bind_flags &= ~XDP_ZEROCOPY;
+	}
+
+	if (queue->xsk == NULL) {
+		socket_config.bind_flags |= XDP_COPY;
+		result = xsk_socket__create (&queue->xsk, interface_name, queue_id, queue->umem, &queue->rx, NULL,
+					     &socket_config);
+		if (result != 0) {
+			arv_info_stream_thread ("[GvStream::xdp_queue_init] Failed to create socket for queue %u (%s)",
+						queue_id, g_strerror (-result));
+			queue->xsk = NULL;
+			goto error;
+		}
+	}
+
+	if (xsk_ring_prod__reserve (&queue->fill, ARV_GV_STREAM_XDP_N_FRAMES, &index) != ARV_GV_STREAM_XDP_N_FRAMES)
+		goto error;
+	for (i = 0; i < ARV_GV_STREAM_XDP_N_FRAMES; i++)
+		*xsk_ring_prod__fill_addr (&queue->fill, index++) = (guint64) i * ARV_GV_STREAM_XDP_FRAME_SIZE;
+	xsk_ring_prod__submit (&queue->fill, ARV_GV_STREAM_XDP_N_FRAMES);
+
+	return TRUE;
+
+error:
+	g_clear_pointer (&queue->xsk, xsk_socket__delete);
+	g_clear_pointer (&queue->umem, xsk_umem__delete);
+	munmap (queue->area, area_size);
+	queue->area = NULL;
+
+	return FALSE;
+}
+
+static void
+_xdp_queue_cleanup (ArvGvStreamXdpQueue *queue)
+{
+	g_clear_pointer (&queue->xsk, xsk_socket__delete);
+	g_clear_pointer (&queue->umem, xsk_umem__delete);
+	if (queue->area != NULL)
+		munmap (queue->area, (size_t) ARV_GV_STREAM_XDP_N_FRAMES * ARV_GV_STREAM_XDP_FRAME_SIZE);
+	queue->area = NULL;
+}
+
+/* Returns FALSE if the AF_XDP setup failed, in which case the caller is expected to fall back to another method. */
+
+static gboolean
+_xdp_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamXdpQueue queues[ARV_GV_STREAM_XDP_MAX_QUEUES];
+	GPollFD poll_fd[ARV_GV_STREAM_XDP_MAX_QUEUES + 1];
+	char interface_name[IF_NAMESIZE] = {0};
+	const guint8 *bytes;
+	guint32 interface_address;
+	guint32 device_address;
+	unsigned interface_index;
+	unsigned n_queues;
+	unsigned i;
+	guint32 xdp_flags;
+	gboolean use_poll;
+	int map_fd;
+	int program_fd;
+
+	if (thread_data->scps_packet_size + ETH_HLEN > ARV_GV_STREAM_XDP_FRAME_SIZE - XDP_PACKET_HEADROOM) {
+		arv_info_stream ("[GvStream::xdp_loop] Packet size too large for AF_XDP method (%u bytes)",
+				 thread_data->scps_packet_size);
+		return FALSE;
+	}
+
+	bytes = g_inet_address_to_bytes (thread_data->interface_address);
+	interface_address = g_ntohl (*((guint32 *) bytes));
+	bytes = g_inet_address_to_bytes (thread_data->device_address);
+	device_address = g_ntohl (*((guint32 *) bytes));
+
+	interface_index = _interface_index_from_address (interface_address);
+	if (interface_index == 0 || if_indextoname (interface_index, interface_name) == NULL) {
+		arv_info_stream ("[GvStream::xdp_loop] Failed to retrieve network interface");
+		return FALSE;
+	}
+
+	n_queues = _xdp_get_n_queues (interface_name);
+
+	map_fd = bpf_map_create (BPF_MAP_TYPE_XSKMAP, "arv_xsks", sizeof (int), sizeof (int), n_queues, NULL);
+	if (map_fd < 0) {
+		arv_info_stream ("[GvStream::xdp_loop] Failed to create XSK map (%s)", g_strerror (-map_fd));
+		return FALSE;
+	}
+
+	program_fd = _xdp_load_program (device_address, thread_data->stream_port, map_fd);
+	if (program_fd < 0) {
+		arv_info_stream ("[GvStream::xdp_loop] Failed to load XDP program (%s)", g_strerror (-program_fd));
+		close (map_fd);
+		return FALSE;
+	}
+
+	/* Don't replace an already attached program, which may belong to another stream on the same interface */
+	xdp_flags = XDP_FLAGS_UPDATE_IF_NOEXIST | XDP_FLAGS_DRV_MODE;
+	if (bpf_xdp_attach (interface_index, program_fd, xdp_flags, NULL) != 0) {
+		xdp_flags = XDP_FLAGS_UPDATE_IF_NOEXIST | XDP_FLAGS_SKB_MODE;
+		if (bpf_xdp_attach (interface_index, program_fd, xdp_flags, NULL) != 0) {
+			arv_info_stream ("[GvStream::xdp_loop] Failed to attach XDP program to %s", interface_name);
+			close (program_fd);
+			close (map_fd);
+			return FALSE;
+		}
+	}
+
+	for (i = 0; i < n_queues; i++) {
+		if (!_xdp_queue_init (&queues[i], interface_name, i, (xdp_flags & XDP_FLAGS_DRV_MODE) != 0) ||
+		    xsk_socket__update_xskmap (queues[i].xsk, map_fd) != 0) {
+			_xdp_queue_cleanup (&queues[i]);
+			break;
+		}
+
+		poll_fd[i].fd = xsk_socket__fd (queues[i].xsk);
+		poll_fd[i].events = G_IO_IN;
+		poll_fd[i].revents = 0;
+	}
+
+	if (i == 0) {
+		arv_info_stream ("[GvStream::xdp_loop] Failed to create AF_XDP sockets on %s", interface_name);
+		bpf_xdp_detach (interface_index, xdp_flags, NULL);
+		close (program_fd);
+		close (map_fd);
+		return FALSE;
+	}
+	n_queues = i;
+
+	arv_info_stream ("[GvStream::loop] AF_XDP socket method (%s, %u queue%s, %s mode)",
+			 interface_name, n_queues, n_queues > 1 ? "s" : "",
+			 (xdp_flags & XDP_FLAGS_DRV_MODE) != 0 ? "native" : "generic");
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[n_queues]);
+
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+
+	do {
+		unsigned n_received = 0;
+
+		for (i = 0; i < n_queues; i++) {
+			ArvGvStreamXdpQueue *queue = &queues[i];
+			guint32 rx_index;
+			guint32 fill_index;
+			guint64 time_us;
+			ArvGvStreamProcessPacket process_packet;
+			unsigned n_packets;
+			unsigned j;
+
+			n_packets = xsk_ring_cons__peek (&queue->rx, ARV_GV_STREAM_XDP_BATCH_SIZE, &rx_index);
+			if (n_packets == 0)
+				continue;
+
+			/* All frames not sitting in the rx ring are in the fill ring, reservation can't fail */
+			if (xsk_ring_prod__reserve (&queue->fill, n_packets, &fill_index) != n_packets) {
+				xsk_ring_cons__cancel (&queue->rx, n_packets);
+				continue;
+			}
+
+			time_us = g_get_monotonic_time ();
+			process_packet = thread_data->process_packet;
+
+			for (j = 0; j < n_packets; j++) {
+				const struct xdp_desc *descriptor;
+				const struct iphdr *ip;
+				const ArvGvspPacket *packet;
+				ArvGvStreamFrameData *frame;
+				size_t ip_size;
+				size_t size;
+
+				descriptor = xsk_ring_cons__rx_desc (&queue->rx, rx_index + j);
+
+				ip = (void *) (((char *) xsk_umem__get_data (queue->area, descriptor->addr)) + ETH_HLEN);
+				packet = (void *) (((char *) ip) + sizeof (struct iphdr) + sizeof (struct udphdr));
+
+				/* The IP total length must cover the headers, and fit in the received frame */
+				ip_size = descriptor->len >= ETH_HLEN + sizeof (struct iphdr) ? g_ntohs (ip->tot_len) : 0;
+				if (ip->ihl * 4 != sizeof (struct iphdr) ||
+				    ip_size < sizeof (struct iphdr) + sizeof (struct udphdr) ||
+				    ETH_HLEN + ip_size > descriptor->len) {
+					thread_data->n_ignored_packets++;
+					frame = NULL;
+				} else {
+					size = ip_size - sizeof (struct iphdr) - sizeof (struct udphdr);
+					frame = process_packet (thread_data, packet, size, NULL, time_us, 0);
+				}
+
+				_check_frame_completion (thread_data, time_us, frame);
+
+				*xsk_ring_prod__fill_addr (&queue->fill, fill_index + j) =
+					descriptor->addr & ~((guint64) ARV_GV_STREAM_XDP_FRAME_SIZE - 1);
+			}
+
+			xsk_ring_prod__submit (&queue->fill, n_packets);
+			xsk_ring_cons__release (&queue->rx, n_packets);
+
+			n_received += n_packets;
+		}
+
+		if (n_received == 0) {
+			int timeout_ms;
+			int n_events;
+			int errsv;
+
+			_check_frame_completion (thread_data, g_get_monotonic_time (), NULL);
+
+			if (thread_data->n_frames > 0)
+				timeout_ms = thread_data->packet_timeout_us / 1000;
+			else
+				timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+
+			do {
+				n_events = g_poll (poll_fd, n_queues + (use_poll ? 1 : 0), timeout_ms);
+				errsv = errno;
+			} while (n_events < 0 && errsv == EINTR);
+		}
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	for (i = 0; i < n_queues; i++)
+		_xdp_queue_cleanup (&queues[i]);
+
+	bpf_xdp_detach (interface_index, xdp_flags, NULL);
+	close (program_fd);
+	close (map_fd);
+
+	return TRUE;
+}
+
+#endif /* ARAVIS_HAS_XDP */
+
+#if ARAVIS_HAS_IO_URING
+
+/*
+ * io_uring method: a multishot recvmsg request on the stream socket picks its packet buffers in a ring of provided
+ * buffers, and keeps posting completions until the buffers are exhausted. The packets are processed directly from the
+ * completion queue, and their buffers are given back to the ring in batches, which leaves only the completion waits
+ * as syscalls, like with the packet socket method, but without needing the CAP_NET_RAW capability.
+ */
+
+#define ARV_GV_STREAM_IO_URING_N_BUFFERS	256	/* Must be a power of 2 */
+#define ARV_GV_STREAM_IO_URING_QUEUE_DEPTH	8
+#define ARV_GV_STREAM_IO_URING_BUFFER_GROUP	0
+
+enum {
+	ARV_GV_STREAM_IO_URING_RECEIVE = 1,
+	ARV_GV_STREAM_IO_URING_CANCEL
+};
+
+static void
+_io_uring_prepare_receive (struct io_uring *ring, int fd, struct msghdr *msg)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = io_uring_get_sqe (ring);
+	io_uring_prep_recvmsg_multishot (sqe, fd, msg, 0);
+	sqe->flags |= IOSQE_BUFFER_SELECT;
+	sqe->buf_group = ARV_GV_STREAM_IO_URING_BUFFER_GROUP;
+	io_uring_sqe_set_data64 (sqe, ARV_GV_STREAM_IO_URING_RECEIVE);
+}
+
+static void
+_io_uring_prepare_cancel (struct io_uring *ring, int fd)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = io_uring_get_sqe (ring);
+	io_uring_prep_poll_add (sqe, fd, POLLIN);
+	io_uring_sqe_set_data64 (sqe, ARV_GV_STREAM_IO_URING_CANCEL);
+}
+
+/* Returns FALSE if the io_uring setup failed, in which case the caller is expected to fall back to another method. */
+
+static gboolean
+_io_uring_loop (ArvGvStreamThreadData *thread_data)
+{
+	struct io_uring ring;
+	struct io_uring_buf_ring *buffer_ring;
+	struct io_uring_cqe *cqe;
+	struct io_uring_sync_cancel_reg cancel_request;
+	struct msghdr msg;
+	GPollFD cancel_poll_fd;
+	char *buffers;
+	size_t buffer_size;
+	gboolean use_poll;
+	gboolean use_timestamps;
+	unsigned buffer_mask = io_uring_buf_ring_mask (ARV_GV_STREAM_IO_URING_N_BUFFERS);
+	int fd = g_socket_get_fd (thread_data->socket);
+	int status;
+	unsigned i;
+
+	status = io_uring_queue_init (ARV_GV_STREAM_IO_URING_QUEUE_DEPTH, &ring, 0);
+	if (status < 0) {
+		arv_info_stream ("[GvStream::io_uring_loop] Failed to create io_uring (%s)", g_strerror (-status));
+		return FALSE;
+	}
+
+	buffer_ring = io_uring_setup_buf_ring (&ring, ARV_GV_STREAM_IO_URING_N_BUFFERS,
+					       ARV_GV_STREAM_IO_URING_BUFFER_GROUP, 0, &status);
+	if (buffer_ring == NULL) {
+		arv_info_stream ("[GvStream::io_uring_loop] Failed to register provided buffer ring (%s)",
+				 g_strerror (-status));
+		io_uring_queue_exit (&ring);
+		return FALSE;
+	}
+
+	use_timestamps = _enable_socket_timestamping (thread_data, fd);
+
+	/* Each buffer receives a recvmsg header, the control messages and the packet data */
+	memset (&msg, 0, sizeof (msg));
+	msg.msg_controllen = use_timestamps ? CMSG_SPACE (sizeof (struct scm_timestamping)) : 0;
+	buffer_size = sizeof (struct io_uring_recvmsg_out) + msg.msg_controllen + thread_data->scps_packet_size - 20 - 8;
+	buffer_size = (buffer_size + 63) & ~((size_t) 63);
+
+	buffers = g_malloc (buffer_size * ARV_GV_STREAM_IO_URING_N_BUFFERS);
+	for (i = 0; i < ARV_GV_STREAM_IO_URING_N_BUFFERS; i++)
+		io_uring_buf_ring_add (buffer_ring, buffers + i * buffer_size, buffer_size, i, buffer_mask, i);
+	io_uring_buf_ring_advance (buffer_ring, ARV_GV_STREAM_IO_URING_N_BUFFERS);
+
+	/* Multishot recvmsg needs Linux 6.0, unsupported requests fail during submission */
+	_io_uring_prepare_receive (&ring, fd, &msg);
+	io_uring_submit (&ring);
+	if (io_uring_peek_cqe (&ring, &cqe) == 0 && cqe->res < 0 && (cqe->flags & IORING_CQE_F_MORE) == 0) {
+		arv_info_stream ("[GvStream::io_uring_loop] Multishot receive not supported (%s)",
+				 g_strerror (-cqe->res));
+		io_uring_free_buf_ring (&ring, buffer_ring, ARV_GV_STREAM_IO_URING_N_BUFFERS,
+					ARV_GV_STREAM_IO_URING_BUFFER_GROUP);
+		io_uring_queue_exit (&ring);
+		g_free (buffers);
+		return FALSE;
+	}
+
+	arv_info_stream ("[GvStream::loop] io_uring method");
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &cancel_poll_fd);
+	if (use_poll) {
+		_io_uring_prepare_cancel (&ring, cancel_poll_fd.fd);
+		io_uring_submit (&ring);
+	}
+
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+
+	do {
+		struct __kernel_timespec timeout;
+		gboolean rearm_receive = FALSE;
+		gboolean rearm_cancel = FALSE;
+		guint64 time_us;
+		guint64 real_time_ns;
+		ArvGvStreamProcessPacket process_packet;
+		unsigned n_cqes = 0;
+		unsigned n_buffers = 0;
+		unsigned head;
+		guint64 timeout_us;
+
+		timeout_us = thread_data->n_frames > 0 ? thread_data->packet_timeout_us : ARV_GV_STREAM_POLL_TIMEOUT_US;
+		timeout.tv_sec = timeout_us / 1000000;
+		timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+
+		status = io_uring_wait_cqe_timeout (&ring, &cqe, &timeout);
+		if (status < 0 && status != -ETIME && status != -EINTR)
+			arv_warning_stream_thread ("[GvStream::io_uring_loop] Completion wait failed (%s)",
+						   g_strerror (-status));
+
+		time_us = g_get_monotonic_time ();
+		real_time_ns = use_timestamps ? g_get_real_time () * 1000LL : 0;
+		process_packet = thread_data->process_packet;
+
+		io_uring_for_each_cqe (&ring, head, cqe) {
+			n_cqes++;
+
+			if (io_uring_cqe_get_data64 (cqe) == ARV_GV_STREAM_IO_URING_CANCEL) {
+				rearm_cancel = TRUE;
+				continue;
+			}
+
+			if ((cqe->flags & IORING_CQE_F_MORE) == 0)
+				rearm_receive = TRUE;
+
+			if (cqe->res < 0) {
+				/* ENOBUFS only means the buffers given back below were not available yet */
+				if (cqe->res != -ENOBUFS)
+					arv_warning_stream_thread ("[GvStream::io_uring_loop] Receive failed (%s)",
+								   g_strerror (-cqe->res));
+				continue;
+			}
+
+			if ((cqe->flags & IORING_CQE_F_BUFFER) != 0) {
+				unsigned buffer_id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+				char *buffer = buffers + buffer_id * buffer_size;
+				struct io_uring_recvmsg_out *out;
+
+				out = io_uring_recvmsg_validate (buffer, cqe->res, &msg);
+				if (out != NULL && (out->flags & MSG_TRUNC) == 0) {
+					ArvGvStreamFrameData *frame;
+					guint64 packet_time_us = time_us;
+					guint64 timestamp_ns = 0;
+					struct cmsghdr *cmsg;
+
+					for (cmsg = io_uring_recvmsg_cmsg_firsthdr (out, &msg); cmsg != NULL;
+					     cmsg = io_uring_recvmsg_cmsg_nexthdr (out, &msg, cmsg)) {
+						if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+							struct scm_timestamping ts;
+							guint64 software_timestamp_ns;
+
+							memcpy (&ts, CMSG_DATA (cmsg), sizeof (ts));
+							software_timestamp_ns = ts.ts[0].tv_sec * 1000000000LL + ts.ts[0].tv_nsec;
+							timestamp_ns = ts.ts[2].tv_sec != 0 || ts.ts[2].tv_nsec != 0 ?
+								ts.ts[2].tv_sec * 1000000000LL + ts.ts[2].tv_nsec :
+								software_timestamp_ns;
+							packet_time_us = _packet_time_us (time_us, real_time_ns,
+											  software_timestamp_ns);
+						}
+					}
+
+					frame = process_packet (thread_data,
+								io_uring_recvmsg_payload (out, &msg),
+								io_uring_recvmsg_payload_length (out, cqe->res, &msg),
+								NULL, packet_time_us, timestamp_ns);
+					_check_frame_completion (thread_data, time_us, frame);
+				}
+
+				io_uring_buf_ring_add (buffer_ring, buffer, buffer_size, buffer_id, buffer_mask, n_buffers);
+				n_buffers++;
+			}
+		}
+
+		io_uring_cq_advance (&ring, n_cqes);
+		if (n_buffers > 0)
+			io_uring_buf_ring_advance (buffer_ring, n_buffers);
+
+		if (n_cqes == 0)
+			_check_frame_completion (thread_data, time_us, NULL);
+
+		if (rearm_receive)
+			_io_uring_prepare_receive (&ring, fd, &msg);
+		if (rearm_cancel && !g_cancellable_is_cancelled (thread_data->cancellable))
+			_io_uring_prepare_cancel (&ring, cancel_poll_fd.fd);
+		if (rearm_receive || rearm_cancel)
+			io_uring_submit (&ring);
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	/* The receive request must be gone before the buffers are released */
+	memset (&cancel_request, 0, sizeof (cancel_request));
+	cancel_request.addr = ARV_GV_STREAM_IO_URING_RECEIVE;
+	cancel_request.timeout.tv_sec = -1;
+	cancel_request.timeout.tv_nsec = -1;
+	io_uring_register_sync_cancel (&ring, &cancel_request);
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	io_uring_free_buf_ring (&ring, buffer_ring, ARV_GV_STREAM_IO_URING_N_BUFFERS,
+				ARV_GV_STREAM_IO_URING_BUFFER_GROUP);
+	io_uring_queue_exit (&ring);
+	g_free (buffers);
+
+	return TRUE;
+}
+
+#endif /* ARAVIS_HAS_IO_URING */
+
+#if ARAVIS_HAS_KERNEL_GVSP
+
+/*
+ * Kernel module method: the aravis kernel module steals the stream packets before the socket layer, copies the data
+ * blocks directly to the queued buffers, and posts the completed frames in a ring shared with the stream thread,
+ * which only wakes up once per frame, or on packet timeout for the resend requests.
  */
 
-	struct sock_filter bpf[] = {
-		{ 0x28, 0, 0, 0x0000000c },
-		{ 0x15, 13, 0, 0x000086dd },
-		{ 0x15, 0, 12, 0x00000800 },
-		{ 0x30, 0, 0, 0x00000017 },
-		{ 0x15, 0, 10, 0x00000011 },
-		{ 0x20, 0, 0, 0x0000001a },
-		{ 0x15, 0, 8, source_ip },
-		{ 0x20, 0, 0, 0x0000001e },
-		{ 0x15, 0, 6, destination_ip },
-                { 0x28, 0, 0, 0x00000014},
-		{ 0x45, 4, 0, 0x00001fff },
-		{ 0xb1, 0, 0, 0x0000000e },
-		{ 0x48, 0, 0, 0x00000010 },
-		{ 0x15, 0, 1, destination_port },
-		{ 0x6, 0, 0, 0x00040000 },
-		{ 0x6, 0, 0, 0x00000000 }
-	};
-#endif
+static const ArvBufferStatus kernel_gvsp_status[] = {
+	[ARV_GVSP_STATUS_SUCCESS] =		ARV_BUFFER_STATUS_SUCCESS,
+	[ARV_GVSP_STATUS_MISSING_PACKETS] =	ARV_BUFFER_STATUS_MISSING_PACKETS,
+	[ARV_GVSP_STATUS_SIZE_MISMATCH] =	ARV_BUFFER_STATUS_SIZE_MISMATCH,
+	[ARV_GVSP_STATUS_WRONG_PACKET_ID] =	ARV_BUFFER_STATUS_WRONG_PACKET_ID,
+	[ARV_GVSP_STATUS_ABORTED] =		ARV_BUFFER_STATUS_ABORTED
+};
 
-	struct sock_fprog bpf_prog = {G_N_ELEMENTS (bpf), bpf};
+static void
+_kernel_complete_frame (ArvGvStreamThreadData *thread_data, ArvBuffer **buffers,
+			const struct arv_gvsp_completion *completion)
+{
+	ArvGvStreamFrameData frame = {0};
+	guint64 no_resend_request = 0;
+	ArvBufferStatus status;
 
-	arv_info_stream_thread ("[GvStream::set_socket_filter] source ip = 0x%08x - port = %d - dest ip = 0x%08x - port %d",
-				 source_ip, source_port, destination_ip, destination_port);
+	if (completion->cookie >= ARV_GVSP_RING_SIZE || buffers[completion->cookie] == NULL) {
+		arv_warning_stream_thread ("[GvStream::kernel_loop] Invalid completion cookie %" G_GUINT64_FORMAT,
+					   (guint64) completion->cookie);
+		return;
+	}
 
-	if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &bpf_prog, sizeof(bpf_prog)) != 0)
-		arv_warning_stream_thread ("[GvStream::set_socket_filter] Failed to attach Beckerley Packet Filter to stream socket");
+	frame.buffer = buffers[completion->cookie];
+	buffers[completion->cookie] = NULL;
+
+	frame.frame_id = completion->frame_id;
+	frame.received_size = completion->received_size;
+	frame.first_packet_time_us = completion->first_packet_time_ns / 1000;
+	frame.last_packet_time_us = completion->last_packet_time_ns / 1000;
+	frame.resend_requested_packets = &no_resend_request;
+	frame.n_kernel_dropped_packets = thread_data->n_kernel_dropped_packets;
+
+	frame.buffer->priv->received_size = completion->received_size;
+
+	if (completion->leader_size >= sizeof (ArvGvspPacket) + sizeof (ArvGvspHeader) + sizeof (ArvGvspDataLeader))
+		_process_data_leader (thread_data, &frame, (const ArvGvspPacket *) completion->leader, 0,
+				      completion->leader_size, 0);
+
+	status = completion->status < G_N_ELEMENTS (kernel_gvsp_status) ?
+		kernel_gvsp_status[completion->status] : ARV_BUFFER_STATUS_UNKNOWN;
+	if (status == ARV_BUFFER_STATUS_SUCCESS && completion->leader_size == 0)
+		status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+
+	/* The leader processing may have found an error */
+	if (frame.buffer->priv->status == ARV_BUFFER_STATUS_FILLING)
+		frame.buffer->priv->status = status;
+
+	if (frame.buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
+		_finish_unpacking (thread_data, &frame);
+
+	if (frame.buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
+	    frame.buffer->priv->status != ARV_BUFFER_STATUS_ABORTED) {
+		thread_data->n_missing_packets += completion->n_missing_packets;
+		frame.buffer->priv->metadata.n_missing_packets = completion->n_missing_packets;
+	}
+
+	_close_frame (thread_data, g_get_monotonic_time (), &frame);
 }
 
-static unsigned
-_interface_index_from_address (guint32 ip)
+/* Returns the number of consumed completions */
+
+static guint
+_kernel_read_completions (ArvGvStreamThreadData *thread_data, struct arv_gvsp_ring *ring, ArvBuffer **buffers)
 {
-    struct ifaddrs *ifaddr = NULL;
-    struct ifaddrs *ifa;
-    unsigned index = 0;
+	guint32 head = __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE);
+	guint32 tail = ring->tail;
+	guint n_completions = 0;
 
-    if (getifaddrs(&ifaddr) == -1) {
-        return index;
-    }
+	for (; tail != head; tail++, n_completions++)
+		_kernel_complete_frame (thread_data, buffers, &ring->completions[tail & ARV_GVSP_RING_MASK]);
 
-    for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-	    if (ifa->ifa_addr != NULL &&
-		ifa->ifa_addr->sa_family == AF_INET) {
-		    struct sockaddr_in *sa;
+	__atomic_store_n (&ring->tail, tail, __ATOMIC_RELEASE);
 
-		    sa = (struct sockaddr_in *) (ifa->ifa_addr);
-		    if (ip == g_ntohl (sa->sin_addr.s_addr)) {
-			    index = if_nametoindex (ifa->ifa_name);
-			    break;
-		    }
-	    }
-    }
+	return n_completions;
+}
 
-    freeifaddrs (ifaddr);
+static void
+_kernel_update_statistics (ArvGvStreamThreadData *thread_data, const struct arv_gvsp_ring *ring,
+			   struct arv_gvsp_statistics *last)
+{
+	struct arv_gvsp_statistics current = ring->statistics;
 
-    return index;
+	thread_data->n_received_packets += current.n_received_packets - last->n_received_packets;
+	thread_data->n_ignored_packets += current.n_ignored_packets - last->n_ignored_packets;
+	thread_data->n_error_packets += current.n_error_packets - last->n_error_packets;
+	thread_data->n_duplicated_packets += current.n_duplicated_packets - last->n_duplicated_packets;
+	thread_data->n_underruns += current.n_underruns - last->n_underruns;
+	thread_data->n_transferred_bytes += current.n_transferred_bytes - last->n_transferred_bytes;
+
+	*last = current;
 }
 
-typedef struct {
-	guint32 version;
-	guint32 offset_to_priv;
-	struct tpacket_hdr_v1 h1;
-} ArvGvStreamBlockDescriptor;
+/* Returns FALSE if the kernel module is not available, in which case the caller is expected to fall back to another
+ * method. */
 
-static void
-_ring_buffer_loop (ArvGvStreamThreadData *thread_data)
+static gboolean
+_kernel_loop (ArvGvStreamThreadData *thread_data)
 {
-	GPollFD poll_fd[2];
-	char *buffer;
-	struct tpacket_req3 req;
-	struct sockaddr_ll local_address = {0};
-	enum tpacket_versions version;
-	int fd;
-	unsigned block_id;
-	const guint8 *bytes;
-	guint32 interface_address;
-	guint32 device_address;
+	struct arv_gvsp_config config = {0};
+	struct arv_gvsp_statistics statistics = {0};
+	struct arv_gvsp_check check;
+	struct arv_gvsp_ring *ring;
+	ArvBuffer *buffers[ARV_GVSP_RING_SIZE] = {NULL};
+	GPollFD cancel_poll_fd;
+	struct pollfd poll_fds[2];
 	gboolean use_poll;
+	size_t ring_size;
+	guint n_queued = 0;
+	int fd;
+	guint i;
 
-	arv_info_stream ("[GvStream::loop] Packet socket method");
+	/* The module only receives the packets addressed to the stream socket */
+	if (thread_data->socket == NULL)
+		return FALSE;
 
-	fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL));
+	fd = open ("/dev/" ARV_GVSP_MODULE_DEVICE_NAME, O_RDWR | O_CLOEXEC);
 	if (fd < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to create AF_PACKET socket");
-		goto af_packet_error;
+		arv_info_stream ("[GvStream::kernel_loop] Kernel module not available (%s)", g_strerror (errno));
+		return FALSE;
 	}
 
-	version = TPACKET_V3;
-	if (setsockopt (fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet version");
-		goto socket_option_error;
+	config.version = ARV_GVSP_MODULE_VERSION;
+	memcpy (&config.source_address, g_inet_address_to_bytes (thread_data->device_address),
+		sizeof (config.source_address));
+	config.source_port = thread_data->source_stream_port;
+	config.socket_fd = g_socket_get_fd (thread_data->socket);
+	config.packet_size = thread_data->scps_packet_size;
+
+	if (ioctl (fd, ARV_GVSP_IOC_CONFIGURE, &config) < 0) {
+		arv_info_stream ("[GvStream::kernel_loop] Failed to configure the kernel stream (%s)",
+				 g_strerror (errno));
+		close (fd);
+		return FALSE;
 	}
 
-	req.tp_block_size = 1 << 21;
-	req.tp_frame_size = 1024;
-	req.tp_block_nr = 16;
-	req.tp_frame_nr = (req.tp_block_size * req.tp_block_nr) / req.tp_frame_size;
-	req.tp_sizeof_priv = 0;
-	req.tp_retire_blk_tov = 5;
-	req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
-	if (setsockopt (fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet rx ring");
-		goto socket_option_error;
+	ring_size = sizeof (struct arv_gvsp_ring);
+	ring = mmap (NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (ring == MAP_FAILED) {
+		arv_info_stream ("[GvStream::kernel_loop] Failed to map the completion ring (%s)", g_strerror (errno));
+		close (fd);
+		return FALSE;
 	}
 
-	buffer = mmap (NULL, req.tp_block_size * req.tp_block_nr, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
-	if (buffer == MAP_FAILED) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to map ring buffer");
-		goto map_error;
+	arv_info_stream ("[GvStream::loop] Kernel module method");
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &cancel_poll_fd);
+
+	poll_fds[0].fd = fd;
+	poll_fds[0].events = POLLIN;
+	poll_fds[1].fd = use_poll ? cancel_poll_fd.fd : -1;
+	poll_fds[1].events = POLLIN;
+
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = TRUE;
+        g_cond_signal (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+
+	do {
+		int timeout_ms;
+
+		/* Keeps the module supplied with buffers, one ring entry is kept for the flush */
+		for (i = 0; i < ARV_GVSP_RING_SIZE && n_queued < ARV_GVSP_RING_SIZE - 1; i++) {
+			struct arv_gvsp_queue_buffer request;
+			ArvBuffer *buffer;
+
+			if (buffers[i] != NULL)
+				continue;
+
+			buffer = arv_stream_pop_input_buffer (thread_data->stream);
+			if (buffer == NULL)
+				break;
+
+			buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+			buffer->priv->received_size = 0;
+
+			request.address = (guintptr) buffer->priv->data;
+			request.size = buffer->priv->allocated_size;
+			request.cookie = i;
+
+			/* The module writes the whole payload, the chunk only buffers are not supported */
+			if (buffer->priv->memory_type != ARV_BUFFER_MEMORY_TYPE_SYSTEM ||
+			    buffer->priv->window_offset > 0 ||
+			    ioctl (fd, ARV_GVSP_IOC_QUEUE_BUFFER, &request) < 0) {
+				arv_warning_stream_thread ("[GvStream::kernel_loop] Failed to queue buffer (%s)",
+							   g_strerror (errno));
+				buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
+				arv_stream_push_output_buffer (thread_data->stream, buffer);
+				continue;
+			}
+
+			buffers[i] = buffer;
+			n_queued++;
+		}
+
+		timeout_ms = MAX (1, (n_queued > 0 ? thread_data->packet_timeout_us :
+				      ARV_GV_STREAM_POLL_TIMEOUT_US) / 1000);
+		if (poll (poll_fds, 2, timeout_ms) < 0 && errno != EINTR)
+			arv_warning_stream_thread ("[GvStream::kernel_loop] Poll failed (%s)", g_strerror (errno));
+
+		n_queued -= _kernel_read_completions (thread_data, ring, buffers);
+
+		/* Missing packets, and frame retention */
+		memset (&check, 0, sizeof (check));
+		check.packet_timeout_us = thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER ?
+			G_MAXUINT32 : thread_data->packet_timeout_us;
+		check.frame_retention_us = thread_data->frame_retention_us;
+		if (ioctl (fd, ARV_GVSP_IOC_CHECK, &check) == 0) {
+			for (i = 0; i < check.n_ranges && i < ARV_GVSP_MAX_MISSING_RANGES; i++) {
+				_send_packet_request (thread_data, check.ranges[i].frame_id,
+						      check.ranges[i].first_packet, check.ranges[i].last_packet,
+						      check.ranges[i].extended_ids != 0);
+				thread_data->n_resend_requests += check.ranges[i].last_packet -
+					check.ranges[i].first_packet + 1;
+			}
+		}
+
+		n_queued -= _kernel_read_completions (thread_data, ring, buffers);
+
+		_kernel_update_statistics (thread_data, ring, &statistics);
+		arv_rate_window_update (thread_data->rate_window, g_get_monotonic_time ());
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	/* Gets back all the buffers */
+	ioctl (fd, ARV_GVSP_IOC_FLUSH);
+	n_queued -= _kernel_read_completions (thread_data, ring, buffers);
+	_kernel_update_statistics (thread_data, ring, &statistics);
+
+	if (n_queued > 0)
+		arv_warning_stream_thread ("[GvStream::kernel_loop] %u buffers not given back by the kernel module",
+					   n_queued);
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	munmap (ring, ring_size);
+	close (fd);
+
+	return TRUE;
+}
+
+#endif /* ARAVIS_HAS_KERNEL_GVSP */
+
+/* Called from the thread which receives the stream packets, before the first and after the last one */
+
+static void
+_thread_begin (ArvGvStreamThreadData *thread_data)
+{
+	thread_data->first_frame = 0;
+	thread_data->n_frames = 0;
+	thread_data->last_hit_frame = NULL;
+	thread_data->last_frame_id = 0;
+	thread_data->first_packet = TRUE;
+	thread_data->leader_payload_type = ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN;
+
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
+}
+
+static void
+_thread_end (ArvGvStreamThreadData *thread_data)
+{
+	_flush_frames (thread_data, g_get_monotonic_time ());
+
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
+}
+
+static void *
+arv_gv_stream_thread (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
+	gboolean done = FALSE;
+#if ARAVIS_HAS_PACKET_SOCKET
+	int fd;
+#endif
+
+	arv_stream_apply_thread_affinity (thread_data->stream);
+
+	_thread_begin (thread_data);
+
+#if ARAVIS_HAS_KERNEL_GVSP
+	if (thread_data->use_kernel_module)
+		done = _kernel_loop (thread_data);
+#endif
+
+#if ARAVIS_HAS_XDP
+	if (!done && thread_data->use_xdp)
+		done = _xdp_loop (thread_data);
+#endif
+
+#if ARAVIS_HAS_IO_URING
+	/* The io_uring method doesn't support multi-threaded receive and busy polling */
+	if (!done && thread_data->use_io_uring &&
+	    thread_data->n_receive_threads <= 1 && thread_data->busy_poll_us == 0)
+		done = _io_uring_loop (thread_data);
+#endif
+
+	if (!done) {
+#if ARAVIS_HAS_PACKET_SOCKET
+		/* Multi-threaded receive and busy polling are only implemented for the standard socket method */
+		if (thread_data->use_packet_socket && thread_data->n_receive_threads <= 1 &&
+		    thread_data->busy_poll_us == 0 &&
+		    (fd = socket (PF_PACKET, SOCK_RAW, 0)) >= 0) {
+			close (fd);
+			_ring_buffer_loop (thread_data);
+		} else
+#endif
+		{
+			_start_receivers (thread_data);
+			_loop (thread_data);
+			_stop_receivers (thread_data);
+		}
 	}
 
-	bytes = g_inet_address_to_bytes (thread_data->interface_address);
-	interface_address = g_ntohl (*((guint32 *) bytes));
-	bytes = g_inet_address_to_bytes (thread_data->device_address);
-	device_address = g_ntohl (*((guint32 *) bytes));
+	_thread_end (thread_data);
 
-	local_address.sll_family   = AF_PACKET;
-	local_address.sll_protocol = g_htons(ETH_P_IP);
-	local_address.sll_ifindex  = _interface_index_from_address (interface_address);
-	local_address.sll_hatype   = 0;
-	local_address.sll_pkttype  = 0;
-	local_address.sll_halen    = 0;
-	if (bind (fd, (struct sockaddr *) &local_address, sizeof(local_address)) == -1) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to bind packet socket");
-		goto bind_error;
+	return NULL;
+}
+
+/*
+ * Shared receive workers: a worker thread runs the standard socket method for several streams, waiting for the
+ * packets of all their sockets at once. This avoids a thread per stream for the setups with many low rate cameras.
+ * Streams are added and removed by the worker thread itself, which calls the stream callbacks, and the callers wait
+ * for thread_started to change.
+ */
+
+#if defined (__linux__)
+#define ARV_GV_STREAM_WORKER_HAS_EPOLL 1
+#else
+#define ARV_GV_STREAM_WORKER_HAS_EPOLL 0
+#endif
+
+#define ARV_GV_STREAM_WORKER_MAX_EVENTS		64
+
+typedef struct {
+	ArvGvStreamThreadData *thread_data;
+	ArvGvStreamSocketLoop *loop;
+	gboolean is_readable;
+} ArvGvStreamWorkerEntry;
+
+struct _ArvGvStreamWorker {
+	GThread *thread;
+
+	GMutex mutex;
+	GPtrArray *added;
+	GPtrArray *removed;
+	gboolean cancel;
+	guint n_streams;
+
+	ArvWakeup *wakeup;
+
+	/* Only accessed by the worker thread */
+	GPtrArray *entries;
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+	int epoll_fd;
+#endif
+};
+
+static void
+_set_thread_started (ArvGvStreamThreadData *thread_data, gboolean thread_started)
+{
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        thread_data->thread_started = thread_started;
+        g_cond_broadcast (&thread_data->thread_started_cond);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+}
+
+static void
+_wait_thread_started (ArvGvStreamThreadData *thread_data, gboolean thread_started)
+{
+        g_mutex_lock (&thread_data->thread_started_mutex);
+        while (thread_data->thread_started != thread_started)
+                g_cond_wait (&thread_data->thread_started_cond,
+                             &thread_data->thread_started_mutex);
+        g_mutex_unlock (&thread_data->thread_started_mutex);
+}
+
+static void
+_worker_add_entry (ArvGvStreamWorker *worker, ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamWorkerEntry *entry;
+
+	_thread_begin (thread_data);
+
+	entry = g_new0 (ArvGvStreamWorkerEntry, 1);
+	entry->thread_data = thread_data;
+	entry->loop = _socket_loop_new (thread_data);
+
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+	{
+		struct epoll_event event = {0};
+
+		event.events = EPOLLIN;
+		event.data.ptr = entry;
+		if (epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, g_socket_get_fd (thread_data->socket), &event) != 0)
+			arv_warning_stream_thread ("[GvStreamWorker::add] Failed to watch stream socket (%s)",
+						   g_strerror (errno));
+	}
+#endif
+
+	g_ptr_array_add (worker->entries, entry);
+
+	_set_thread_started (thread_data, TRUE);
+}
+
+static void
+_worker_remove_entry (ArvGvStreamWorker *worker, ArvGvStreamThreadData *thread_data)
+{
+	guint i;
+
+	for (i = 0; i < worker->entries->len; i++) {
+		ArvGvStreamWorkerEntry *entry = g_ptr_array_index (worker->entries, i);
+
+		if (entry->thread_data != thread_data)
+			continue;
+
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+		epoll_ctl (worker->epoll_fd, EPOLL_CTL_DEL, g_socket_get_fd (thread_data->socket), NULL);
+#endif
+		_socket_loop_free (entry->loop);
+		g_ptr_array_remove_index (worker->entries, i);
+		g_free (entry);
+		break;
+	}
+
+	_thread_end (thread_data);
+
+	_set_thread_started (thread_data, FALSE);
+}
+
+/* Waits for the packets of all the streams, and flags the entries with a readable socket */
+
+static void
+_worker_wait (ArvGvStreamWorker *worker, int timeout_ms)
+{
+	GPollFD wakeup_fd;
+	guint i;
+
+	arv_wakeup_get_pollfd (worker->wakeup, &wakeup_fd);
+
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+	{
+		struct epoll_event events[ARV_GV_STREAM_WORKER_MAX_EVENTS];
+		int n_events;
+
+		n_events = epoll_wait (worker->epoll_fd, events, G_N_ELEMENTS (events), timeout_ms);
+		for (i = 0; n_events > 0 && i < (guint) n_events; i++) {
+			ArvGvStreamWorkerEntry *entry = events[i].data.ptr;
+
+			if (entry == NULL)
+				arv_wakeup_acknowledge (worker->wakeup);
+			else
+				entry->is_readable = TRUE;
+		}
 	}
+#else
+	{
+		GPollFD *poll_fds;
+		guint n_poll_fds = worker->entries->len + 1;
+		int n_events;
 
-	_set_socket_filter (fd, device_address, thread_data->source_stream_port, interface_address, thread_data->stream_port);
+		poll_fds = g_newa (GPollFD, n_poll_fds);
+		for (i = 0; i < worker->entries->len; i++) {
+			ArvGvStreamWorkerEntry *entry = g_ptr_array_index (worker->entries, i);
+
+			poll_fds[i] = entry->loop->poll_fd;
+			poll_fds[i].revents = 0;
+		}
+		poll_fds[worker->entries->len] = wakeup_fd;
+		poll_fds[worker->entries->len].revents = 0;
+
+		n_events = g_poll (poll_fds, n_poll_fds, timeout_ms);
+		for (i = 0; n_events > 0 && i < worker->entries->len; i++) {
+			ArvGvStreamWorkerEntry *entry = g_ptr_array_index (worker->entries, i);
+
+			entry->is_readable = poll_fds[i].revents != 0;
+		}
+		if (n_events > 0 && poll_fds[worker->entries->len].revents != 0)
+			arv_wakeup_acknowledge (worker->wakeup);
+	}
+#endif
+}
 
-	poll_fd[0].fd = fd;
-	poll_fd[0].events =  G_IO_IN;
-	poll_fd[0].revents = 0;
+static void *
+_worker_thread (void *data)
+{
+	ArvGvStreamWorker *worker = data;
+	GPtrArray *added = g_ptr_array_new ();
+	GPtrArray *removed = g_ptr_array_new ();
+	gboolean cancel;
 
-	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+	do {
+		GPtrArray *swap;
+		int timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+		guint i;
+
+		g_mutex_lock (&worker->mutex);
+		swap = worker->added; worker->added = added; added = swap;
+		swap = worker->removed; worker->removed = removed; removed = swap;
+		cancel = worker->cancel;
+		g_mutex_unlock (&worker->mutex);
+
+		for (i = 0; i < added->len; i++)
+			_worker_add_entry (worker, g_ptr_array_index (added, i));
+		for (i = 0; i < removed->len; i++)
+			_worker_remove_entry (worker, g_ptr_array_index (removed, i));
+		g_ptr_array_set_size (added, 0);
+		g_ptr_array_set_size (removed, 0);
+
+		if (cancel)
+			break;
 
-        g_mutex_lock (&thread_data->thread_started_mutex);
-        thread_data->thread_started = TRUE;
-        g_cond_signal (&thread_data->thread_started_cond);
-        g_mutex_unlock (&thread_data->thread_started_mutex);
+		for (i = 0; i < worker->entries->len; i++) {
+			ArvGvStreamWorkerEntry *entry = g_ptr_array_index (worker->entries, i);
 
-	block_id = 0;
-	do {
-		ArvGvStreamBlockDescriptor *descriptor;
-		guint64 time_us;
+			timeout_ms = MIN (timeout_ms, _socket_loop_get_timeout_ms (entry->thread_data));
+		}
 
-		time_us = g_get_monotonic_time ();
+		_worker_wait (worker, timeout_ms);
 
-		descriptor = (void *) (buffer + block_id * req.tp_block_size);
-		if ((descriptor->h1.block_status & TP_STATUS_USER) == 0) {
-                        int timeout_ms;
-			int n_events;
-			int errsv;
+		for (i = 0; i < worker->entries->len; i++) {
+			ArvGvStreamWorkerEntry *entry = g_ptr_array_index (worker->entries, i);
 
-			_check_frame_completion (thread_data, time_us, NULL);
+			/* The frame timeouts of the idle streams are checked even if the others are busy */
+			if (entry->is_readable)
+				_socket_loop_receive (entry->thread_data, entry->loop);
+			else
+				_socket_loop_check (entry->thread_data);
+			entry->is_readable = FALSE;
+		}
+	} while (TRUE);
 
-                        if (thread_data->frames != NULL)
-                                timeout_ms = thread_data->packet_timeout_us / 1000;
-                        else
-                                timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+	g_ptr_array_unref (added);
+	g_ptr_array_unref (removed);
 
-			do {
-				n_events = g_poll (poll_fd, use_poll ? 2 : 1,  timeout_ms);
-				errsv = errno;
-			} while (n_events < 0 && errsv == EINTR);
-		} else {
-			ArvGvStreamFrameData *frame;
-			const struct tpacket3_hdr *header;
-			unsigned i;
+	return NULL;
+}
 
-			header = (void *) (((char *) descriptor) + descriptor->h1.offset_to_first_pkt);
+ArvGvStreamWorker *
+arv_gv_stream_worker_new (void)
+{
+	ArvGvStreamWorker *worker;
+
+	worker = g_new0 (ArvGvStreamWorker, 1);
+
+	g_mutex_init (&worker->mutex);
+	worker->added = g_ptr_array_new ();
+	worker->removed = g_ptr_array_new ();
+	worker->entries = g_ptr_array_new ();
+	worker->wakeup = arv_wakeup_new ();
+
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+	{
+		struct epoll_event event = {0};
+		GPollFD wakeup_fd;
+
+		arv_wakeup_get_pollfd (worker->wakeup, &wakeup_fd);
+
+		worker->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+		event.events = EPOLLIN;
+		event.data.ptr = NULL;
+		if (worker->epoll_fd < 0 ||
+		    epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, wakeup_fd.fd, &event) != 0)
+			arv_warning_stream_thread ("[GvStreamWorker::new] Failed to create epoll instance (%s)",
+						   g_strerror (errno));
+	}
+#endif
 
-			for (i = 0; i < descriptor->h1.num_pkts; i++) {
-				const struct iphdr *ip;
-				const ArvGvspPacket *packet;
-				size_t size;
+	worker->thread = g_thread_new ("arv_gv_stream_worker", _worker_thread, worker);
 
-				ip = (void *) (((char *) header) + header->tp_mac + ETH_HLEN);
-				packet = (void *) (((char *) ip) + sizeof (struct iphdr) + sizeof (struct udphdr));
-				size = g_ntohs (ip->tot_len) -  sizeof (struct iphdr) - sizeof (struct udphdr);
+	return worker;
+}
 
-				frame = _process_packet (thread_data, packet, size, time_us);
+/* The streams must have been removed from the worker */
 
-				_check_frame_completion (thread_data, time_us, frame);
+void
+arv_gv_stream_worker_free (ArvGvStreamWorker *worker)
+{
+	g_return_if_fail (worker != NULL);
+	g_return_if_fail (worker->n_streams == 0);
 
-				header = (void *) (((char *) header) + header->tp_next_offset);
-			}
+	g_mutex_lock (&worker->mutex);
+	worker->cancel = TRUE;
+	g_mutex_unlock (&worker->mutex);
+	arv_wakeup_signal (worker->wakeup);
 
-			descriptor->h1.block_status = TP_STATUS_KERNEL;
-			block_id = (block_id + 1) % req.tp_block_nr;
-		}
-	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+	g_thread_join (worker->thread);
 
-	if (use_poll)
-		g_cancellable_release_fd (thread_data->cancellable);
+#if ARV_GV_STREAM_WORKER_HAS_EPOLL
+	if (worker->epoll_fd >= 0)
+		close (worker->epoll_fd);
+#endif
 
-bind_error:
-	munmap (buffer, req.tp_block_size * req.tp_block_nr);
-socket_option_error:
-map_error:
-	close (fd);
-af_packet_error:
-        g_mutex_lock (&thread_data->thread_started_mutex);
-        thread_data->thread_started = TRUE;
-        g_cond_signal (&thread_data->thread_started_cond);
-        g_mutex_unlock (&thread_data->thread_started_mutex);
+	arv_wakeup_free (worker->wakeup);
+	g_ptr_array_unref (worker->entries);
+	g_ptr_array_unref (worker->added);
+	g_ptr_array_unref (worker->removed);
+	g_mutex_clear (&worker->mutex);
+	g_free (worker);
 }
 
-#endif /* ARAVIS_HAS_PACKET_SOCKET */
+/* Number of streams assigned to the worker, for the load balancing */
 
-static void *
-arv_gv_stream_thread (void *data)
+guint
+arv_gv_stream_worker_get_n_streams (ArvGvStreamWorker *worker)
 {
-	ArvGvStreamThreadData *thread_data = data;
-#if ARAVIS_HAS_PACKET_SOCKET
-	int fd;
-#endif
+	guint n_streams;
 
-	thread_data->frames = NULL;
-	thread_data->last_frame_id = 0;
-	thread_data->first_packet = TRUE;
+	g_return_val_if_fail (worker != NULL, 0);
 
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
+	g_mutex_lock (&worker->mutex);
+	n_streams = worker->n_streams;
+	g_mutex_unlock (&worker->mutex);
 
-#if ARAVIS_HAS_PACKET_SOCKET
-	if (thread_data->use_packet_socket && (fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL))) >= 0) {
-		close (fd);
-		_ring_buffer_loop (thread_data);
-	} else
-#endif
-		_loop (thread_data);
+	return n_streams;
+}
 
-	_flush_frames (thread_data, g_get_monotonic_time ());
+static void
+_worker_start_stream (ArvGvStreamWorker *worker, ArvGvStreamThreadData *thread_data)
+{
+	g_mutex_lock (&worker->mutex);
+	g_ptr_array_add (worker->added, thread_data);
+	g_mutex_unlock (&worker->mutex);
+	arv_wakeup_signal (worker->wakeup);
 
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
+	_wait_thread_started (thread_data, TRUE);
+}
 
-	return NULL;
+static void
+_worker_stop_stream (ArvGvStreamWorker *worker, ArvGvStreamThreadData *thread_data)
+{
+	g_mutex_lock (&worker->mutex);
+	g_ptr_array_add (worker->removed, thread_data);
+	g_mutex_unlock (&worker->mutex);
+	arv_wakeup_signal (worker->wakeup);
+
+	_wait_thread_started (thread_data, FALSE);
 }
 
 /* ArvGvStream implementation */
@@ -1211,26 +5139,63 @@ arv_gv_stream_get_port (ArvGvStream *gv_stream)
 	return priv->thread_data->stream_port;
 }
 
+/* Retrieve the stream characteristics from the device, while the stream thread is not running */
+
+static void
+_update_stream_characteristics (ArvStream *stream, ArvGvStreamThreadData *thread_data)
+{
+	ArvDevice *device = NULL;
+	GError *error = NULL;
+	const char *frame_rate_feature = NULL;
+
+	g_object_get (stream, "device", &device, NULL);
+	if (!ARV_IS_DEVICE (device)) {
+		g_clear_object (&device);
+		return;
+	}
+
+	thread_data->payload_size = MAX (0, arv_device_get_integer_feature_value (device, "PayloadSize", &error));
+	g_clear_error (&error);
+
+	if (ARV_IS_GC_FLOAT (arv_device_get_feature (device, "AcquisitionFrameRate")))
+		frame_rate_feature = "AcquisitionFrameRate";
+	else if (ARV_IS_GC_FLOAT (arv_device_get_feature (device, "AcquisitionFrameRateAbs")))
+		frame_rate_feature = "AcquisitionFrameRateAbs";
+
+	thread_data->frame_rate = frame_rate_feature != NULL ?
+		MAX (0.0, arv_device_get_float_feature_value (device, frame_rate_feature, &error)) : 0.0;
+	g_clear_error (&error);
+
+	g_object_unref (device);
+}
+
 static void
 arv_gv_stream_start_thread (ArvStream *stream)
 {
 	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
 	ArvGvStreamThreadData *thread_data;
 
-	g_return_if_fail (priv->thread == NULL);
+	g_return_if_fail (!priv->is_running);
 	g_return_if_fail (priv->thread_data != NULL);
 
+	if (priv->is_offline)
+		return;
+
 	thread_data = priv->thread_data;
 
+	_update_stream_characteristics (stream, thread_data);
+
         thread_data->thread_started = FALSE;
 	thread_data->cancellable = g_cancellable_new ();
-	priv->thread = g_thread_new ("arv_gv_stream", arv_gv_stream_thread, priv->thread_data);
+	if (priv->worker != NULL) {
+		_worker_start_stream (priv->worker, thread_data);
+	} else {
+		priv->thread = g_thread_new ("arv_gv_stream", arv_gv_stream_thread, priv->thread_data);
+		_wait_thread_started (thread_data, TRUE);
+	}
 
-        g_mutex_lock (&thread_data->thread_started_mutex);
-        while (!thread_data->thread_started)
-                g_cond_wait (&thread_data->thread_started_cond,
-                             &thread_data->thread_started_mutex);
-        g_mutex_unlock (&thread_data->thread_started_mutex);
+	priv->is_running = TRUE;
+	priv->is_suspended = FALSE;
 }
 
 static void
@@ -1239,21 +5204,212 @@ arv_gv_stream_stop_thread (ArvStream *stream)
 	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
 	ArvGvStreamThreadData *thread_data;
 
-	g_return_if_fail (priv->thread != NULL);
+	if (priv->is_offline)
+		return;
+
+	/* Already stopped by a reconnection in progress */
+	if (priv->is_suspended) {
+		priv->is_suspended = FALSE;
+		return;
+	}
+
+	g_return_if_fail (priv->is_running);
 	g_return_if_fail (priv->thread_data != NULL);
 
 	thread_data = priv->thread_data;
 
 	g_cancellable_cancel (thread_data->cancellable);
-	g_thread_join (priv->thread);
+	if (priv->worker != NULL) {
+		_worker_stop_stream (priv->worker, thread_data);
+	} else {
+		g_thread_join (priv->thread);
+		priv->thread = NULL;
+	}
 	g_clear_object (&thread_data->cancellable);
 
-	priv->thread = NULL;
+	priv->is_running = FALSE;
+}
+
+/*
+ * Moves the packet reception of the stream to a shared receive worker, or back to its own thread if @worker is
+ * %NULL. The worker only implements the standard socket method, without multi-threaded receive and busy polling.
+ */
+
+void
+arv_gv_stream_set_worker (ArvGvStream *gv_stream, ArvGvStreamWorker *worker)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	gboolean is_running;
+
+	g_return_if_fail (ARV_IS_GV_STREAM (gv_stream));
+
+	if (priv->is_offline || priv->thread_data->socket == NULL || priv->worker == worker)
+		return;
+
+	is_running = priv->is_running;
+	if (is_running)
+		arv_gv_stream_stop_thread (ARV_STREAM (gv_stream));
+
+	if (priv->worker != NULL) {
+		g_mutex_lock (&priv->worker->mutex);
+		priv->worker->n_streams--;
+		g_mutex_unlock (&priv->worker->mutex);
+	}
+
+	priv->worker = worker;
+
+	if (worker != NULL) {
+		g_mutex_lock (&worker->mutex);
+		worker->n_streams++;
+		g_mutex_unlock (&worker->mutex);
+
+		if (priv->thread_data->n_receive_threads > 1 || priv->thread_data->busy_poll_us > 0)
+			arv_info_stream ("[GvStream::set_worker] Multi-threaded receive and busy polling "
+					 "are disabled on shared workers");
+	}
+
+	if (is_running)
+		arv_gv_stream_start_thread (ARV_STREAM (gv_stream));
+}
+
+/* Allocates the packet bitmaps of all the ring slots for the largest queued buffer, using the multipart estimation
+ * which needs the most packets, and restarts the receiver thread, which resets the frame id tracking */
+
+static void
+arv_gv_stream_arm (ArvStream *stream, size_t buffer_size)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
+	ArvGvStreamThreadData *thread_data = priv->thread_data;
+	guint32 block_size;
+	guint max_n_packets;
+
+	/* Offline streams and streams which failed to initialize have no receiver thread */
+	if (priv->is_offline || thread_data->socket == NULL)
+		return;
+
+	if (priv->is_running)
+		arv_gv_stream_stop_thread (stream);
+
+	block_size = thread_data->scps_packet_size - ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD -
+		sizeof (ArvGvspMultipart);
+	max_n_packets = (buffer_size + block_size - 1) / block_size + ARV_GV_STREAM_MULTIPART_MAX_PARTS + 2;
+	_grow_frame_bitmaps (thread_data, ARV_GV_STREAM_BITMAP_N_WORDS (max_n_packets));
+
+	arv_gv_stream_start_thread (stream);
+}
+
+static void
+arv_gv_stream_disarm (ArvStream *stream)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
+
+	if (priv->is_running)
+		arv_gv_stream_stop_thread (stream);
+}
+
+/* Stops the receiver thread during a device reconnection. The frames in progress are returned as aborted, while the
+ * queued buffers are kept for the resumption. */
+
+void
+arv_gv_stream_suspend (ArvGvStream *gv_stream)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+
+	g_return_if_fail (ARV_IS_GV_STREAM (gv_stream));
+
+	if (priv->is_offline || priv->is_suspended || !priv->is_running)
+		return;
+
+	arv_gv_stream_stop_thread (ARV_STREAM (gv_stream));
+	priv->is_suspended = TRUE;
+
+	arv_info_stream ("[GvStream::suspend] Stream channel %d suspended", priv->thread_data->stream_channel);
+}
+
+/* Writes the stream channel registers again, for a device which may have lost them. The stream channel must be
+ * selected by the caller. */
+
+gboolean
+arv_gv_stream_restore_channel (ArvGvStream *gv_stream, ArvGvDevice *gv_device, GError **error)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	ArvGvStreamThreadData *thread_data;
+	GError *local_error = NULL;
+
+	g_return_val_if_fail (ARV_IS_GV_STREAM (gv_stream), FALSE);
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), FALSE);
+
+	thread_data = priv->thread_data;
+
+	if (arv_gv_device_is_controller (gv_device)) {
+		const guint8 *address_bytes;
+
+		address_bytes = g_inet_address_to_bytes (thread_data->multicast_group != NULL ?
+							 thread_data->multicast_group :
+							 thread_data->interface_address);
+
+		arv_gv_device_set_packet_size (gv_device, thread_data->scps_packet_size, &local_error);
+		if (local_error == NULL)
+			arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCDA",
+							      g_htonl (*((guint32 *) address_bytes)), &local_error);
+		if (local_error == NULL)
+			arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCPHostPort",
+							      thread_data->stream_port, &local_error);
+	}
+
+	if (local_error == NULL)
+		thread_data->source_stream_port = arv_device_get_integer_feature_value (ARV_DEVICE (gv_device),
+											"GevSCSP", NULL);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Restores the stream channel registers, which may have been reset by a device power cycle, and restarts the
+ * receiver thread stopped by arv_gv_stream_suspend(). The stream channel must be selected by the caller. */
+
+gboolean
+arv_gv_stream_resume (ArvGvStream *gv_stream, GError **error)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	ArvGvStreamThreadData *thread_data;
+	ArvGvDevice *gv_device = NULL;
+	GError *local_error = NULL;
+
+	g_return_val_if_fail (ARV_IS_GV_STREAM (gv_stream), FALSE);
+
+	if (priv->is_offline || !priv->is_suspended)
+		return TRUE;
+
+	thread_data = priv->thread_data;
+
+	g_object_get (gv_stream, "device", &gv_device, NULL);
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), FALSE);
+
+	arv_gv_stream_restore_channel (gv_stream, gv_device, &local_error);
+
+	g_object_unref (gv_device);
+
+	if (local_error != NULL) {
+		g_propagate_prefixed_error (error, local_error, "[GvStream::resume] ");
+		return FALSE;
+	}
+
+	arv_gv_stream_start_thread (ARV_STREAM (gv_stream));
+
+	arv_info_stream ("[GvStream::resume] Stream channel %d resumed", thread_data->stream_channel);
+
+	return TRUE;
 }
 
 /**
  * arv_gv_stream_new: (skip)
  * @gv_device: a #ArvGvDevice
+ * @channel: stream channel index, already selected by GevStreamChannelSelector
  * @callback: (scope call): processing callback
  * @callback_data: (closure): user data for @callback
  *
@@ -1261,16 +5417,109 @@ arv_gv_stream_stop_thread (ArvStream *stream)
  */
 
 ArvStream *
-arv_gv_stream_new (ArvGvDevice *gv_device, ArvStreamCallback callback, void *callback_data, GDestroyNotify destroy, GError **error)
+arv_gv_stream_new (ArvGvDevice *gv_device, guint channel, ArvStreamCallback callback, void *callback_data,
+		   GDestroyNotify destroy, GError **error)
 {
 	return g_initable_new (ARV_TYPE_GV_STREAM, NULL, error,
 			       "device", gv_device,
+			       "channel", channel,
 			       "callback", callback,
 			       "callback-data", callback_data,
 						 "destroy-notify", destroy,
 			       NULL);
 }
 
+/*
+ * arv_gv_stream_new_offline:
+ * @packet_size: GVSP packet size, including the IP and UDP headers
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a stream without device, socket nor thread, which reassembles the packets given to
+ * arv_gv_stream_offline_process_packet(), using the buffers pushed in its input queue. Resend requests are
+ * only accounted in the statistics. This is intended for the benchmarking of the frame reassembly, without network.
+ *
+ * Return value: (transfer full): a new #ArvStream.
+ */
+
+ArvStream *
+arv_gv_stream_new_offline (guint packet_size, GError **error)
+{
+	ArvStream *stream;
+	ArvGvStreamPrivate *priv;
+
+	if (packet_size <= ARV_GVSP_PACKET_PROTOCOL_OVERHEAD) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Invalid packet size (%d byte(s))", packet_size);
+		return NULL;
+	}
+
+	stream = g_initable_new (ARV_TYPE_GV_STREAM, NULL, error, NULL);
+	if (stream == NULL)
+		return NULL;
+
+	priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
+	priv->thread_data->scps_packet_size = packet_size;
+
+	return stream;
+}
+
+/*
+ * arv_gv_stream_offline_process_packet:
+ * @gv_stream: an offline #ArvGvStream
+ * @packet: (nullable): a GVSP packet, without the IP and UDP headers
+ * @packet_size: size of @packet
+ * @time_us: reception time of the packet, in µs
+ *
+ * Processes a packet, and checks the frame completion and the resend timeouts at @time_us, the way the stream
+ * thread does on packet reception. A %NULL @packet only checks the frames, as on a poll timeout.
+ */
+
+void
+arv_gv_stream_offline_process_packet (ArvGvStream *gv_stream, const void *packet, size_t packet_size, guint64 time_us)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	ArvGvStreamFrameData *frame = NULL;
+
+	g_return_if_fail (ARV_IS_GV_STREAM (gv_stream));
+	g_return_if_fail (priv->is_offline);
+
+	if (packet != NULL) {
+		if (packet_size < sizeof (ArvGvspPacket) + sizeof (ArvGvspHeader)) {
+			priv->thread_data->n_ignored_packets++;
+			return;
+		}
+
+		frame = priv->thread_data->process_packet (priv->thread_data, packet, packet_size, NULL, time_us, 0);
+	}
+
+	_check_frame_completion (priv->thread_data, time_us, frame);
+}
+
+/*
+ * arv_gv_stream_offline_flush:
+ * @gv_stream: an offline #ArvGvStream
+ * @time_us: current time, in µs
+ *
+ * Closes the frames being reassembled as aborted, and resets the frame id tracking, as a stream thread stop does.
+ */
+
+void
+arv_gv_stream_offline_flush (ArvGvStream *gv_stream, guint64 time_us)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+
+	g_return_if_fail (ARV_IS_GV_STREAM (gv_stream));
+	g_return_if_fail (priv->is_offline);
+
+	_flush_frames (priv->thread_data, time_us);
+
+	priv->thread_data->first_frame = 0;
+	priv->thread_data->last_hit_frame = NULL;
+	priv->thread_data->last_frame_id = 0;
+	priv->thread_data->first_packet = TRUE;
+	priv->thread_data->leader_payload_type = ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN;
+}
+
 /* ArvStream implementation */
 
 /**
@@ -1315,20 +5564,81 @@ arv_gv_stream_set_property (GObject * object, guint prop_id,
 		case ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_SIZE:
 			thread_data->socket_buffer_size = g_value_get_int (value);
 			break;
+		case ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_MAX_SIZE:
+			thread_data->socket_buffer_max_size = g_value_get_int (value);
+			break;
 		case ARV_GV_STREAM_PROPERTY_PACKET_RESEND:
 			thread_data->packet_resend = g_value_get_enum (value);
+			_select_packet_processing (thread_data);
 			break;
 		case ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_RATIO:
 			thread_data->packet_request_ratio = g_value_get_double (value);
 			break;
+		case ARV_GV_STREAM_PROPERTY_PAYLOAD_COPY:
+			thread_data->payload_copy = g_value_get_enum (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_STALL_WATCHDOG:
+			thread_data->stall_watchdog = g_value_get_enum (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_STALL_FRAMES:
+			thread_data->stall_frames = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_TIMING_STATISTICS:
+			thread_data->timing_statistics = g_value_get_boolean (value);
+			_select_packet_processing (thread_data);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RESEND_BUDGET:
+			thread_data->resend_budget_rate = g_value_get_uint (value);
+			if (thread_data->resend_budget != NULL)
+				_resend_budget_set_rate (thread_data->resend_budget, thread_data->resend_budget_rate);
+			break;
 		case ARV_GV_STREAM_PROPERTY_INITIAL_PACKET_TIMEOUT:
 			thread_data->initial_packet_timeout_us = g_value_get_uint (value);
+			thread_data->next_deadline_us = 0;
 			break;
 		case ARV_GV_STREAM_PROPERTY_PACKET_TIMEOUT:
 			thread_data->packet_timeout_us = g_value_get_uint (value);
+			thread_data->next_deadline_us = 0;
 			break;
 		case ARV_GV_STREAM_PROPERTY_FRAME_RETENTION:
 			thread_data->frame_retention_us = g_value_get_uint (value);
+			thread_data->next_deadline_us = 0;
+			break;
+		case ARV_GV_STREAM_PROPERTY_DIRECT_RECEIVE:
+			thread_data->direct_receive = g_value_get_boolean (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE:
+			thread_data->ring_block_size = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_COUNT:
+			thread_data->ring_block_count = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_FRAME_SIZE:
+			thread_data->ring_frame_size = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_TIMEOUT:
+			thread_data->ring_block_timeout_ms = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_FANOUT:
+			thread_data->packet_fanout = g_value_get_boolean (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECEIVE_THREADS:
+			thread_data->n_receive_threads = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_TIMESTAMP:
+			thread_data->packet_timestamp = g_value_get_enum (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_MERGE_DISTANCE:
+			thread_data->packet_request_merge_distance = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_RESEND_TIMING:
+			thread_data->packet_resend_timing = g_value_get_enum (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_BUSY_POLL:
+			thread_data->busy_poll_us = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CHANNEL:
+			thread_data->stream_channel = g_value_get_uint (value);
 			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1352,12 +5662,35 @@ arv_gv_stream_get_property (GObject * object, guint prop_id,
 		case ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_SIZE:
 			g_value_set_int (value, thread_data->socket_buffer_size);
 			break;
+		case ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_MAX_SIZE:
+			g_value_set_int (value, thread_data->socket_buffer_max_size);
+			break;
 		case ARV_GV_STREAM_PROPERTY_PACKET_RESEND:
 			g_value_set_enum (value, thread_data->packet_resend);
 			break;
 		case ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_RATIO:
 			g_value_set_double (value, thread_data->packet_request_ratio);
 			break;
+		case ARV_GV_STREAM_PROPERTY_PAYLOAD_COPY:
+			g_value_set_enum (value, thread_data->payload_copy);
+			break;
+		case ARV_GV_STREAM_PROPERTY_STALL_WATCHDOG:
+			g_value_set_enum (value, thread_data->stall_watchdog);
+			break;
+		case ARV_GV_STREAM_PROPERTY_STALL_FRAMES:
+			g_value_set_uint (value, thread_data->stall_frames);
+			break;
+		case ARV_GV_STREAM_PROPERTY_TIMING_STATISTICS:
+			g_value_set_boolean (value, thread_data->timing_statistics);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RESEND_BUDGET:
+			if (thread_data->resend_budget != NULL) {
+				g_mutex_lock (&thread_data->resend_budget->mutex);
+				g_value_set_uint (value, thread_data->resend_budget->rate);
+				g_mutex_unlock (&thread_data->resend_budget->mutex);
+			} else
+				g_value_set_uint (value, thread_data->resend_budget_rate);
+			break;
 		case ARV_GV_STREAM_PROPERTY_INITIAL_PACKET_TIMEOUT:
 			g_value_set_uint (value, thread_data->initial_packet_timeout_us);
 			break;
@@ -1367,6 +5700,42 @@ arv_gv_stream_get_property (GObject * object, guint prop_id,
 		case ARV_GV_STREAM_PROPERTY_FRAME_RETENTION:
 			g_value_set_uint (value, thread_data->frame_retention_us);
 			break;
+		case ARV_GV_STREAM_PROPERTY_DIRECT_RECEIVE:
+			g_value_set_boolean (value, thread_data->direct_receive);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE:
+			g_value_set_uint (value, thread_data->ring_block_size);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_COUNT:
+			g_value_set_uint (value, thread_data->ring_block_count);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_FRAME_SIZE:
+			g_value_set_uint (value, thread_data->ring_frame_size);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_TIMEOUT:
+			g_value_set_uint (value, thread_data->ring_block_timeout_ms);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_FANOUT:
+			g_value_set_boolean (value, thread_data->packet_fanout);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECEIVE_THREADS:
+			g_value_set_uint (value, thread_data->n_receive_threads);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_TIMESTAMP:
+			g_value_set_enum (value, thread_data->packet_timestamp);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_MERGE_DISTANCE:
+			g_value_set_uint (value, thread_data->packet_request_merge_distance);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_RESEND_TIMING:
+			g_value_set_enum (value, thread_data->packet_resend_timing);
+			break;
+		case ARV_GV_STREAM_PROPERTY_BUSY_POLL:
+			g_value_set_uint (value, thread_data->busy_poll_us);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CHANNEL:
+			g_value_set_uint (value, thread_data->stream_channel);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -1379,6 +5748,79 @@ arv_gv_stream_init (ArvGvStream *gv_stream)
 	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
 
 	priv->thread_data = g_new0 (ArvGvStreamThreadData, 1);
+	priv->thread_data->leader_payload_type = ARV_BUFFER_PAYLOAD_TYPE_UNKNOWN;
+}
+
+static void
+_declare_infos (ArvGvStream *gv_stream)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	guint i;
+
+	priv->thread_data->histogram = arv_hdr_histogram_new (3, 1);
+
+	arv_hdr_histogram_set_variable_name (priv->thread_data->histogram, 0, "frame_retention");
+	arv_hdr_histogram_set_variable_name (priv->thread_data->histogram, 1, "packet_time");
+	arv_hdr_histogram_set_variable_name (priv->thread_data->histogram, 2, "inter_packet");
+
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_completed_buffers",
+                                 G_TYPE_UINT64, &priv->thread_data->n_completed_buffers);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_failures",
+                                 G_TYPE_UINT64, &priv->thread_data->n_failures);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_underruns",
+                                 G_TYPE_UINT64, &priv->thread_data->n_underruns);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_timeouts",
+                                 G_TYPE_UINT64, &priv->thread_data->n_timeouts);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_aborted",
+                                 G_TYPE_UINT64, &priv->thread_data->n_aborted);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_missing_frames",
+                                 G_TYPE_UINT64, &priv->thread_data->n_missing_frames);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_size_mismatch_errors",
+                                 G_TYPE_UINT64, &priv->thread_data->n_size_mismatch_errors);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_received_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_received_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_missing_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_missing_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_error_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_error_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_ignored_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_ignored_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_requests",
+                                 G_TYPE_UINT64, &priv->thread_data->n_resend_requests);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resent_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_resent_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_ratio_reached",
+                                 G_TYPE_UINT64, &priv->thread_data->n_resend_ratio_reached);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_disabled",
+                                 G_TYPE_UINT64, &priv->thread_data->n_resend_disabled);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_budget_exceeded",
+                                 G_TYPE_UINT64, &priv->thread_data->n_resend_budget_exceeded);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_duplicated_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_duplicated_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_direct_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_direct_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_transferred_bytes",
+                                 G_TYPE_UINT64, &priv->thread_data->n_transferred_bytes);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_ignored_bytes",
+                                 G_TYPE_UINT64, &priv->thread_data->n_ignored_bytes);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_kernel_dropped_packets",
+                                 G_TYPE_UINT64, &priv->thread_data->n_kernel_dropped_packets);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_stalls",
+                                 G_TYPE_UINT64, &priv->thread_data->n_stalls);
+        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_stall_recoveries",
+                                 G_TYPE_UINT64, &priv->thread_data->n_stall_recoveries);
+
+	for (i = 0; i < 3; i++)
+		arv_stream_declare_histogram_infos (ARV_STREAM (gv_stream), priv->thread_data->histogram, i);
+
+	priv->thread_data->rate_window = arv_rate_window_new (3);
+	arv_rate_window_set_counter (priv->thread_data->rate_window, 0, "missing_packet",
+				     &priv->thread_data->n_missing_packets);
+	arv_rate_window_set_counter (priv->thread_data->rate_window, 1, "resend_request",
+				     &priv->thread_data->n_resend_requests);
+	arv_rate_window_set_counter (priv->thread_data->rate_window, 2, "transferred_byte",
+				     &priv->thread_data->n_transferred_bytes);
+	arv_stream_declare_rate_infos (ARV_STREAM (gv_stream), priv->thread_data->rate_window);
 }
 
 static void
@@ -1394,17 +5836,32 @@ arv_gv_stream_constructed (GObject *object)
 	guint64 timestamp_tick_frequency;
 	const guint8 *address_bytes;
 	GInetSocketAddress *local_address;
+	GInetAddress *multicast_group;
+	guint16 multicast_port;
+	gboolean is_controller;
 	guint packet_size;
 
 	G_OBJECT_CLASS (arv_gv_stream_parent_class)->constructed (object);
 
 	g_object_get (object, "device", &gv_device, NULL);
 
+	if (gv_device == NULL) {
+		priv->is_offline = TRUE;
+		priv->thread_data->stream = stream;
+		priv->thread_data->first_packet = TRUE;
+		priv->thread_data->packet_id = 65300;
+		_declare_infos (gv_stream);
+		return;
+	}
+
 	timestamp_tick_frequency = arv_gv_device_get_timestamp_tick_frequency (gv_device, NULL);
 	options = arv_gv_device_get_stream_options (gv_device);
 
+	is_controller = arv_gv_device_is_controller (gv_device);
+	multicast_group = arv_gv_device_get_stream_multicast_group (gv_device, &multicast_port);
+
 	packet_size = arv_gv_device_get_packet_size (gv_device, NULL);
-	if (packet_size <= ARV_GVSP_PACKET_PROTOCOL_OVERHEAD) {
+	if (packet_size <= ARV_GVSP_PACKET_PROTOCOL_OVERHEAD && is_controller) {
 		arv_gv_device_set_packet_size (gv_device, ARV_GV_DEVICE_GVSP_PACKET_SIZE_DEFAULT, NULL);
 		arv_info_device ("[GvStream::stream_new] Packet size set to default value (%d)",
 				  ARV_GV_DEVICE_GVSP_PACKET_SIZE_DEFAULT);
@@ -1428,17 +5885,15 @@ arv_gv_stream_constructed (GObject *object)
 		      NULL);
 
 	priv->thread_data->timestamp_tick_frequency = timestamp_tick_frequency;
+	priv->thread_data->clock_model = arv_gv_device_get_clock_model (gv_device);
 	priv->thread_data->scps_packet_size = packet_size;
 	priv->thread_data->use_packet_socket = (options & ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED) == 0;
+	priv->thread_data->use_xdp = (options & ARV_GV_STREAM_OPTION_XDP_ENABLED) != 0;
+	priv->thread_data->use_io_uring = (options & ARV_GV_STREAM_OPTION_IO_URING_ENABLED) != 0;
+	priv->thread_data->use_kernel_module = (options & ARV_GV_STREAM_OPTION_KERNEL_MODULE_ENABLED) != 0;
 
 	priv->thread_data->packet_id = 65300;
 
-	priv->thread_data->histogram = arv_histogram_new (3, 100, 2000, 0);
-
-	arv_histogram_set_variable_name (priv->thread_data->histogram, 0, "frame_retention");
-	arv_histogram_set_variable_name (priv->thread_data->histogram, 1, "packet_time");
-	arv_histogram_set_variable_name (priv->thread_data->histogram, 2, "inter_packet");
-
 	interface_address = g_inet_socket_address_get_address
                 (G_INET_SOCKET_ADDRESS (arv_gv_device_get_interface_address (gv_device)));
 	device_address = g_inet_socket_address_get_address
@@ -1448,58 +5903,63 @@ arv_gv_stream_constructed (GObject *object)
 	priv->thread_data->device_address = g_object_ref (device_address);
 	priv->thread_data->interface_address = g_object_ref (interface_address);
 	priv->thread_data->interface_socket_address = g_inet_socket_address_new (interface_address, 0);
+	/* The construct time value only overrides the shared budget when set */
+	priv->thread_data->resend_budget = _resend_budget_acquire (interface_address);
+	if (priv->thread_data->resend_budget_rate != 0)
+		_resend_budget_set_rate (priv->thread_data->resend_budget, priv->thread_data->resend_budget_rate);
 	priv->thread_data->device_socket_address = g_inet_socket_address_new (device_address, ARV_GVCP_PORT);
 	g_socket_set_blocking (priv->thread_data->socket, FALSE);
-	g_socket_bind (priv->thread_data->socket, priv->thread_data->interface_socket_address, FALSE, NULL);
+
+	if (multicast_group != NULL) {
+		GSocketAddress *multicast_socket_address;
+		GInetAddress *any_address;
+		GError *error = NULL;
+
+		priv->thread_data->multicast_group = g_object_ref (multicast_group);
+
+		/* Multicast datagrams are not delivered to sockets bound to a unicast address. Address reuse allows
+		 * several applications of the same host to receive the stream. */
+		any_address = g_inet_address_new_any (G_SOCKET_FAMILY_IPV4);
+		multicast_socket_address = g_inet_socket_address_new (any_address, multicast_port);
+		if (!g_socket_bind (priv->thread_data->socket, multicast_socket_address, TRUE, &error) ||
+		    !_join_multicast_group (priv->thread_data->socket, multicast_group, interface_address, &error)) {
+			arv_stream_take_init_error (stream, error);
+			g_object_unref (multicast_socket_address);
+			g_object_unref (any_address);
+			g_clear_object (&gv_device);
+			return;
+		}
+		g_object_unref (multicast_socket_address);
+		g_object_unref (any_address);
+	} else {
+#if ARV_GV_STREAM_HAS_REUSEPORT
+		/* Allow the binding of the receiver thread sockets to the same port */
+		if (priv->thread_data->n_receive_threads <= 1 ||
+		    !_bind_with_reuseport (priv->thread_data->socket, priv->thread_data->interface_socket_address))
+#endif
+			g_socket_bind (priv->thread_data->socket, priv->thread_data->interface_socket_address, FALSE, NULL);
+	}
 
 	local_address = G_INET_SOCKET_ADDRESS (g_socket_get_local_address (priv->thread_data->socket, NULL));
 	priv->thread_data->stream_port = g_inet_socket_address_get_port (local_address);
 	g_object_unref (local_address);
 
-	address_bytes = g_inet_address_to_bytes (interface_address);
-	arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCDA", g_htonl (*((guint32 *) address_bytes)), NULL);
-	arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCPHostPort", priv->thread_data->stream_port, NULL);
+	/* In monitor mode, the stream destination is set by the controller */
+	if (is_controller) {
+		address_bytes = g_inet_address_to_bytes (multicast_group != NULL ? multicast_group : interface_address);
+		arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCDA",
+						      g_htonl (*((guint32 *) address_bytes)), NULL);
+		arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCPHostPort",
+						      priv->thread_data->stream_port, NULL);
+	} else
+		arv_info_stream ("[GvStream::stream_new] Monitor mode");
 	priv->thread_data->source_stream_port = arv_device_get_integer_feature_value (ARV_DEVICE (gv_device), "GevSCSP", NULL);
 
 	arv_info_stream ("[GvStream::stream_new] Destination stream port = %d", priv->thread_data->stream_port);
 	arv_info_stream ("[GvStream::stream_new] Source stream port = %d", priv->thread_data->source_stream_port);
+	arv_info_stream ("[GvStream::stream_new] Stream channel = %d", priv->thread_data->stream_channel);
 
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_completed_buffers",
-                                 G_TYPE_UINT64, &priv->thread_data->n_completed_buffers);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_failures",
-                                 G_TYPE_UINT64, &priv->thread_data->n_failures);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_underruns",
-                                 G_TYPE_UINT64, &priv->thread_data->n_underruns);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_timeouts",
-                                 G_TYPE_UINT64, &priv->thread_data->n_timeouts);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_aborted",
-                                 G_TYPE_UINT64, &priv->thread_data->n_aborted);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_missing_frames",
-                                 G_TYPE_UINT64, &priv->thread_data->n_missing_frames);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_size_mismatch_errors",
-                                 G_TYPE_UINT64, &priv->thread_data->n_size_mismatch_errors);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_received_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_received_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_missing_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_missing_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_error_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_error_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_ignored_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_ignored_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_requests",
-                                 G_TYPE_UINT64, &priv->thread_data->n_resend_requests);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resent_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_resent_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_ratio_reached",
-                                 G_TYPE_UINT64, &priv->thread_data->n_resend_ratio_reached);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_resend_disabled",
-                                 G_TYPE_UINT64, &priv->thread_data->n_resend_disabled);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_duplicated_packets",
-                                 G_TYPE_UINT64, &priv->thread_data->n_duplicated_packets);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_transferred_bytes",
-                                 G_TYPE_UINT64, &priv->thread_data->n_transferred_bytes);
-        arv_stream_declare_info (ARV_STREAM (gv_stream), "n_ignored_bytes",
-                                 G_TYPE_UINT64, &priv->thread_data->n_ignored_bytes);
+	_declare_infos (gv_stream);
 
 	arv_gv_stream_start_thread (ARV_STREAM (gv_stream));
 
@@ -1511,18 +5971,30 @@ arv_gv_stream_finalize (GObject *object)
 {
 	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (object));
 
-	arv_gv_stream_stop_thread (ARV_STREAM (object));
+	/* The thread may have been stopped by arv_stream_disarm() */
+	if (priv->is_running)
+		arv_gv_stream_stop_thread (ARV_STREAM (object));
+
+	arv_gv_stream_set_worker (ARV_GV_STREAM (object), NULL);
 
 	if (priv->thread_data != NULL) {
 		ArvGvStreamThreadData *thread_data;
 		char *histogram_string;
+		unsigned i;
 
 		thread_data = priv->thread_data;
 
-		histogram_string = arv_histogram_to_string (thread_data->histogram);
-		arv_info_stream ("%s", histogram_string);
-		g_free (histogram_string);
-		arv_histogram_unref (thread_data->histogram);
+		if (priv->is_offline)
+			_flush_frames (thread_data, g_get_monotonic_time ());
+
+		if (thread_data->histogram != NULL) {
+			histogram_string = arv_hdr_histogram_to_string (thread_data->histogram);
+			arv_info_stream ("%s", histogram_string);
+			g_free (histogram_string);
+			arv_hdr_histogram_unref (thread_data->histogram);
+		}
+
+		g_clear_pointer (&thread_data->rate_window, arv_rate_window_unref);
 
 		arv_info_stream ("[GvStream::finalize] n_completed_buffers    = %" G_GUINT64_FORMAT,
 				  thread_data->n_completed_buffers);
@@ -1557,18 +6029,32 @@ arv_gv_stream_finalize (GObject *object)
 				  thread_data->n_resend_ratio_reached);
 		arv_info_stream ("[GvStream::finalize] n_resend_disabled      = %" G_GUINT64_FORMAT,
 				  thread_data->n_resend_disabled);
+		arv_info_stream ("[GvStream::finalize] n_resend_budget_exceeded = %" G_GUINT64_FORMAT,
+				  thread_data->n_resend_budget_exceeded);
 		arv_info_stream ("[GvStream::finalize] n_duplicated_packets   = %" G_GUINT64_FORMAT,
 				  thread_data->n_duplicated_packets);
 
+		arv_info_stream ("[GvStream::finalize] n_direct_packets       = %" G_GUINT64_FORMAT,
+				  thread_data->n_direct_packets);
+
 		arv_info_stream ("[GvStream::finalize] n_transferred_bytes    = %" G_GUINT64_FORMAT,
 				  thread_data->n_transferred_bytes);
 		arv_info_stream ("[GvStream::finalize] n_ignored_bytes        = %" G_GUINT64_FORMAT,
 				  thread_data->n_ignored_bytes);
 
+		arv_info_stream ("[GvStream::finalize] n_kernel_dropped_packets = %" G_GUINT64_FORMAT,
+				  thread_data->n_kernel_dropped_packets);
+
+		for (i = 0; i < ARV_GV_STREAM_FRAME_RING_SIZE; i++)
+			g_free (thread_data->frame_ring[i].received_packets);
+
+		g_clear_pointer (&thread_data->resend_budget, _resend_budget_release);
+
 		g_clear_object (&thread_data->device_address);
 		g_clear_object (&thread_data->interface_address);
 		g_clear_object (&thread_data->device_socket_address);
 		g_clear_object (&thread_data->interface_socket_address);
+		g_clear_object (&thread_data->multicast_group);
 		g_clear_object (&thread_data->socket);
 
 		g_clear_pointer (&thread_data, g_free);
@@ -1590,6 +6076,8 @@ arv_gv_stream_class_init (ArvGvStreamClass *gv_stream_class)
 
 	stream_class->start_thread = arv_gv_stream_start_thread;
 	stream_class->stop_thread = arv_gv_stream_stop_thread;
+	stream_class->arm = arv_gv_stream_arm;
+	stream_class->disarm = arv_gv_stream_disarm;
 
         /**
          * ArvGvStream:socket-buffer:
@@ -1617,6 +6105,22 @@ arv_gv_stream_class_init (ArvGvStreamClass *gv_stream_class)
 				  -1, G_MAXINT, 0,
 				  G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
 		);
+        /**
+         * ArvGvStream:socket-buffer-max-size:
+         *
+         * Maximum size in bytes of the incoming socket buffer in auto mode. The socket buffer is grown beyond the
+         * payload size when packets are dropped by the kernel, up to this size, or 64 MiB if 0. The effective size is
+         * also limited by the net.core.rmem_max system setting.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER_MAX_SIZE,
+		g_param_spec_int ("socket-buffer-max-size", "Socket buffer maximum size",
+				  "Maximum socket buffer size in auto mode, in bytes (0 for default)",
+				  0, G_MAXINT, 0,
+				  G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
         /**
          * ArvGvStream:packet-resend:
          *
@@ -1691,4 +6195,309 @@ arv_gv_stream_class_init (ArvGvStreamClass *gv_stream_class)
 				   ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT,
 				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
 		);
+        /**
+         * ArvGvStream:direct-receive:
+         *
+         * Receive the data block payloads directly into the frame buffer, by predicting the identifier of the next
+         * incoming packets. Packets that don't match the prediction are copied as usual. This only applies to the
+         * standard socket method. The buffers created by arv_buffer_new_import() with pinned or DMA buffer memory
+         * always use this mode.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_DIRECT_RECEIVE,
+		g_param_spec_boolean ("direct-receive", "Direct receive",
+				      "Receive payload directly into buffers",
+				      FALSE,
+				      G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:ring-block-size:
+         *
+         * Size in bytes of the blocks of the packet socket ring buffer. It must be a multiple of the page size. 0 means
+         * the block size is computed from the packet size and the total ring size. Changes are applied on the next
+         * stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE,
+		g_param_spec_uint ("ring-block-size", "Ring block size",
+				   "Packet socket ring block size, in bytes (0 for automatic)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:ring-block-count:
+         *
+         * Number of blocks of the packet socket ring buffer. 0 means the block count is computed from the payload
+         * size, the frame rate and the packet size. Changes are applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_BLOCK_COUNT,
+		g_param_spec_uint ("ring-block-count", "Ring block count",
+				   "Packet socket ring block count (0 for automatic)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:ring-frame-size:
+         *
+         * Nominal frame size of the packet socket ring buffer. 0 means the default value. Changes are applied on the
+         * next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_FRAME_SIZE,
+		g_param_spec_uint ("ring-frame-size", "Ring frame size",
+				   "Packet socket ring frame size, in bytes (0 for default)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:ring-block-timeout:
+         *
+         * Delay after which the kernel hands over a partially filled ring block. 0 means the default value. Changes
+         * are applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_BLOCK_TIMEOUT,
+		g_param_spec_uint ("ring-block-timeout", "Ring block timeout",
+				   "Packet socket ring block retire timeout, in ms (0 for default)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:packet-fanout:
+         *
+         * Make the packet sockets of the streams received on the same network interface join a fanout group, which
+         * distributes the incoming packets to the right stream socket, instead of having each stream filter all the
+         * interface traffic. Changes are applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PACKET_FANOUT,
+		g_param_spec_boolean ("packet-fanout", "Packet fanout",
+				      "Use a packet socket fanout group",
+				      FALSE,
+				      G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:receive-threads:
+         *
+         * Number of threads receiving the stream packets. When greater than 1, additional sockets are bound to the
+         * stream port using SO_REUSEPORT, and the data packets are dispatched to them, each thread copying its
+         * packets into the frame buffers. As any other process of the same user could then join the stream port, the
+         * option is only set on the stream socket while several receive threads are configured. It is only available on Linux, with the standard socket method, which is used instead of the
+         * packet socket one in this case. Buffer callbacks may then be called from any of these threads. Changes are
+         * applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RECEIVE_THREADS,
+		g_param_spec_uint ("receive-threads", "Receive threads",
+				   "Number of packet receiving threads",
+				   1, ARV_GV_STREAM_MAX_RECEIVE_THREADS, 1,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:packet-timestamp:
+         *
+         * Source of the packet reception timestamps, used for the buffer system timestamp and for the packet resend
+         * logic. Kernel and hardware timestamps are not affected by the stream thread scheduling latency. They are
+         * available on Linux, with the standard and packet socket methods. Hardware timestamps use the network
+         * interface clock, which should be synchronized with the system clock, for example by phc2sys, and their
+         * activation may need the CAP_NET_ADMIN capability. Kernel timestamps are used when they are not available.
+         * Changes are applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PACKET_TIMESTAMP,
+		g_param_spec_enum ("packet-timestamp", "Packet timestamp",
+				   "Packet timestamp source",
+				   ARV_TYPE_GV_STREAM_PACKET_TIMESTAMP,
+				   ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:packet-request-merge-distance:
+         *
+         * Maximum number of packets between two missing packet ranges for them to be asked in a single resend
+         * request. The packets in between are requested again, which trades some bandwidth for fewer control
+         * packets and fewer interruptions of the device stream, under bursty packet loss.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_MERGE_DISTANCE,
+		g_param_spec_uint ("packet-request-merge-distance", "Packet request merge distance",
+				   "Maximum packet distance between merged resend requests",
+				   0, G_MAXUINT, ARV_GV_STREAM_PACKET_REQUEST_MERGE_DISTANCE_DEFAULT,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:packet-resend-timing:
+         *
+         * Packet resend request timing. In adaptive mode, the resend timeouts are derived from the smoothed
+         * inter-packet delay and its deviation, and #ArvGvStream:initial-packet-timeout and #ArvGvStream:packet-timeout
+         * are used as upper bounds.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PACKET_RESEND_TIMING,
+		g_param_spec_enum ("packet-resend-timing", "Packet resend timing",
+				   "Packet resend request timing",
+				   ARV_TYPE_GV_STREAM_PACKET_RESEND_TIMING,
+				   ARV_GV_STREAM_PACKET_RESEND_TIMING_FIXED,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:busy-poll:
+         *
+         * Busy poll time, in µs. When not 0, the stream threads poll their sockets without sleeping during this time
+         * each time they wait for packets, and the busy polling of the network device queue is enabled on the sockets
+         * on Linux (SO_BUSY_POLL and SO_PREFER_BUSY_POLL). This reduces the packet reception latency at the cost of
+         * CPU usage, and is best used with a realtime stream thread pinned on an isolated core (see
+         * #ArvStream:cpu-affinity). The standard socket method is used instead of the packet socket one in this case.
+         * Changes are applied on the next stream thread start.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_BUSY_POLL,
+		g_param_spec_uint ("busy-poll", "Busy poll",
+				   "Busy poll time, in µs (0 to disable)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:channel:
+         *
+         * Index of the device stream channel received by this stream. The device GevSCxx features are configured
+         * for this channel at stream creation, and the packet resend requests are addressed to it.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CHANNEL,
+		g_param_spec_uint ("channel", "Channel",
+				   "Stream channel index",
+				   0, G_MAXUINT16, 0,
+				   G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:resend-budget:
+         *
+         * Maximum number of packets per second requested for resend by all the streams bound to the same interface,
+         * or 0 for no limit. The budget is shared between these streams, the last value set on any of them being
+         * used. When it is exhausted, the frames closest to completion are served first, and the frames already
+         * overtaken by a newer one stop requesting resends.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RESEND_BUDGET,
+		g_param_spec_uint ("resend-budget", "Resend budget",
+				   "Shared packet resend requests per second (0 for no limit)",
+				   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:payload-copy:
+         *
+         * Copy of the packet payloads into the buffers, when they are not received directly in place. The non-temporal
+         * stores of %ARV_GV_STREAM_PAYLOAD_COPY_AUTO avoid evicting the working set of the application from the last
+         * level cache by frames that would not fit in it anyway.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PAYLOAD_COPY,
+		g_param_spec_enum ("payload-copy", "Payload copy",
+				   "Payload copy mode",
+				   ARV_TYPE_GV_STREAM_PAYLOAD_COPY,
+				   ARV_GV_STREAM_PAYLOAD_COPY_AUTO,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:stall-watchdog:
+         *
+         * Detection of the streams which silently stop, when no packet is received for #ArvGvStream:stall-frames
+         * frame periods. The watchdog can't tell a stall from an acquisition stopped by the application, it should
+         * be disabled before a voluntary stop, and is not suited to the irregular triggered acquisitions. It is not
+         * available with the kernel module reception.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_STALL_WATCHDOG,
+		g_param_spec_enum ("stall-watchdog", "Stall watchdog",
+				   "Stream stall detection and recovery",
+				   ARV_TYPE_GV_STREAM_STALL_WATCHDOG,
+				   ARV_GV_STREAM_STALL_WATCHDOG_DISABLED,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+        /**
+         * ArvGvStream:stall-frames:
+         *
+         * Number of frame periods without packet after which the stream is considered as stalled. The frame period
+         * is measured on the received frames, or taken from the frame rate of the device before the first frames.
+         * The stall timeout is never shorter than #ArvGvStream:frame-retention.
+         *
+         * Since: 0.8.24
+         */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_STALL_FRAMES,
+		g_param_spec_uint ("stall-frames", "Stall frames",
+				   "Frame periods without packet before a stall",
+				   2, 1000, ARV_GV_STREAM_STALL_FRAMES_DEFAULT,
+				   G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:timing-statistics:
+	 *
+	 * Fill the frame_retention, packet_time and inter_packet histograms of the stream informations. Disabling them
+	 * selects a packet processing path without any histogram update.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_TIMING_STATISTICS,
+		g_param_spec_boolean ("timing-statistics", "Timing statistics",
+				      "Fill the packet timing histograms",
+				      TRUE,
+				      G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream::stalled:
+	 * @gv_stream: the stream that emitted the signal
+	 * @last_packet_time_us: monotonic time of the last received packet, in µs
+	 * @n_kernel_dropped_packets: number of packets dropped by the kernel since the stream creation
+	 * @is_controller: whether the control channel is still held
+	 *
+	 * Signal emitted by the stream thread, once per stall, when #ArvGvStream:stall-watchdog is enabled. With
+	 * %ARV_GV_STREAM_STALL_WATCHDOG_RECOVER, the stream channel registers are then written again and the
+	 * acquisition restarted, the queued buffers being kept. The handler must not block the stream thread.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	arv_gv_stream_signals[ARV_GV_STREAM_SIGNAL_STALLED] =
+		g_signal_new ("stalled",
+			      G_TYPE_FROM_CLASS (gv_stream_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 3, G_TYPE_UINT64, G_TYPE_UINT64, G_TYPE_BOOLEAN);
 }
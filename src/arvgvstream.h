@@ -37,17 +37,26 @@ G_BEGIN_DECLS
  * ArvGvStreamOption:
  * @ARV_GV_STREAM_OPTION_NONE: no option specified
  * @ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED: use of packet socket is disabled
+ * @ARV_GV_STREAM_OPTION_XDP_ENABLED: use of AF_XDP socket is enabled, if available (Since: 0.8.24)
+ * @ARV_GV_STREAM_OPTION_IO_URING_ENABLED: use of io_uring for the packet reception is enabled, if available (Since:
+ * 0.8.24)
+ * @ARV_GV_STREAM_OPTION_KERNEL_MODULE_ENABLED: use of the aravis kernel module for the packet reception is enabled, if
+ * loaded (Since: 0.8.24)
  */
 
 typedef enum {
 	ARV_GV_STREAM_OPTION_NONE = 0,
-	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED
+	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED = 1,
+	ARV_GV_STREAM_OPTION_XDP_ENABLED = 2,
+	ARV_GV_STREAM_OPTION_IO_URING_ENABLED = 4,
+	ARV_GV_STREAM_OPTION_KERNEL_MODULE_ENABLED = 8
 } ArvGvStreamOption;
 
 /**
  * ArvGvStreamSocketBuffer:
  * @ARV_GV_STREAM_SOCKET_BUFFER_FIXED: socket buffer is set to a given fixed value
- * @ARV_GV_STREAM_SOCKET_BUFFER_AUTO: socket buffer size is set to the payload size
+ * @ARV_GV_STREAM_SOCKET_BUFFER_AUTO: socket buffer size is set to the payload size, and grown when packets are dropped
+ * by the kernel
  */
 
 typedef enum {
@@ -66,6 +75,67 @@ typedef enum {
 	ARV_GV_STREAM_PACKET_RESEND_ALWAYS
 } ArvGvStreamPacketResend;
 
+/**
+ * ArvGvStreamPacketResendTiming:
+ * @ARV_GV_STREAM_PACKET_RESEND_TIMING_FIXED: resend requests use the #ArvGvStream:initial-packet-timeout and
+ * #ArvGvStream:packet-timeout values
+ * @ARV_GV_STREAM_PACKET_RESEND_TIMING_ADAPTIVE: resend request timeouts are derived from the observed inter-packet
+ * delays, bounded by the fixed values
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_GV_STREAM_PACKET_RESEND_TIMING_FIXED,
+	ARV_GV_STREAM_PACKET_RESEND_TIMING_ADAPTIVE
+} ArvGvStreamPacketResendTiming;
+
+/**
+ * ArvGvStreamPayloadCopy:
+ * @ARV_GV_STREAM_PAYLOAD_COPY_AUTO: use non-temporal stores for the frames larger than the last level cache, unless the
+ * data is read by the receiving thread right after the copy
+ * @ARV_GV_STREAM_PAYLOAD_COPY_TEMPORAL: always copy the payload through the caches
+ * @ARV_GV_STREAM_PAYLOAD_COPY_NON_TEMPORAL: always copy the payload with non-temporal stores, bypassing the caches
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_GV_STREAM_PAYLOAD_COPY_AUTO,
+	ARV_GV_STREAM_PAYLOAD_COPY_TEMPORAL,
+	ARV_GV_STREAM_PAYLOAD_COPY_NON_TEMPORAL
+} ArvGvStreamPayloadCopy;
+
+/**
+ * ArvGvStreamPacketTimestamp:
+ * @ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM: packets are timestamped by the stream thread, after their reception
+ * @ARV_GV_STREAM_PACKET_TIMESTAMP_KERNEL: use the kernel software receive timestamps
+ * @ARV_GV_STREAM_PACKET_TIMESTAMP_HARDWARE: use the network interface hardware receive timestamps, if available
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_GV_STREAM_PACKET_TIMESTAMP_SYSTEM,
+	ARV_GV_STREAM_PACKET_TIMESTAMP_KERNEL,
+	ARV_GV_STREAM_PACKET_TIMESTAMP_HARDWARE
+} ArvGvStreamPacketTimestamp;
+
+/**
+ * ArvGvStreamStallWatchdog:
+ * @ARV_GV_STREAM_STALL_WATCHDOG_DISABLED: no stall detection
+ * @ARV_GV_STREAM_STALL_WATCHDOG_NOTIFY: emit the #ArvGvStream::stalled signal when the packets stop arriving
+ * @ARV_GV_STREAM_STALL_WATCHDOG_RECOVER: also restore the stream channel registers and restart the acquisition
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_GV_STREAM_STALL_WATCHDOG_DISABLED,
+	ARV_GV_STREAM_STALL_WATCHDOG_NOTIFY,
+	ARV_GV_STREAM_STALL_WATCHDOG_RECOVER
+} ArvGvStreamStallWatchdog;
+
 #define ARV_TYPE_GV_STREAM             (arv_gv_stream_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvGvStream, arv_gv_stream, ARV, GV_STREAM, ArvStream)
 
@@ -34,8 +34,32 @@ G_BEGIN_DECLS
 #define ARV_GV_STREAM_PACKET_TIMEOUT_US_DEFAULT		20000
 #define ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT	100000
 #define ARV_GV_STREAM_PACKET_REQUEST_RATIO_DEFAULT	0.25
+#define ARV_GV_STREAM_PACKET_REQUEST_MERGE_DISTANCE_DEFAULT	0
+#define ARV_GV_STREAM_SOCKET_BUFFER_DEFAULT_MAX_SIZE	(64 * 1024 * 1024)
+#define ARV_GV_STREAM_STALL_FRAMES_DEFAULT		5
+#define ARV_GV_STREAM_STALL_MAX_RECOVERIES		3
 
-ArvStream * 	arv_gv_stream_new		(ArvGvDevice *gv_device, ArvStreamCallback callback, void *callback_data, GDestroyNotify destroy, GError **error);
+ArvStream * 	arv_gv_stream_new		(ArvGvDevice *gv_device, guint channel, ArvStreamCallback callback, void *callback_data, GDestroyNotify destroy, GError **error);
+
+void		arv_gv_stream_suspend		(ArvGvStream *gv_stream);
+gboolean	arv_gv_stream_resume		(ArvGvStream *gv_stream, GError **error);
+gboolean	arv_gv_stream_restore_channel	(ArvGvStream *gv_stream, ArvGvDevice *gv_device, GError **error);
+
+typedef struct _ArvGvStreamWorker ArvGvStreamWorker;
+
+ArvGvStreamWorker *	arv_gv_stream_worker_new		(void);
+void			arv_gv_stream_worker_free		(ArvGvStreamWorker *worker);
+guint			arv_gv_stream_worker_get_n_streams	(ArvGvStreamWorker *worker);
+
+void		arv_gv_stream_set_worker	(ArvGvStream *gv_stream, ArvGvStreamWorker *worker);
+
+/* private, but used by tests */
+ARV_API ArvStream *	arv_gv_stream_new_offline		(guint packet_size, GError **error);
+/* private, but used by tests */
+ARV_API void		arv_gv_stream_offline_process_packet	(ArvGvStream *gv_stream, const void *packet,
+								 size_t packet_size, guint64 time_us);
+/* private, but used by tests */
+ARV_API void		arv_gv_stream_offline_flush		(ArvGvStream *gv_stream, guint64 time_us);
 
 G_END_DECLS
 
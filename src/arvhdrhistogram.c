@@ -0,0 +1,415 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/*
+ * ArvHdrHistogram accumulates distributions of unsigned values in log-linear buckets: each power of 2 range is split
+ * in ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT linear buckets, which gives a constant relative precision of about 3%, over
+ * the whole range, without any configuration.
+ *
+ * The counters are split in shards, one for each writer thread. A fill only touches the counters of its shard, without
+ * any lock or atomic operation. Readers merge the shards on the fly, and may miss the samples being added.
+ * arv_hdr_histogram_dup_snapshot() returns a merged copy, for consistent reads of several statistics.
+ */
+
+#include <arvhdrhistogramprivate.h>
+#include <string.h>
+#include <math.h>
+
+#define ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS	5
+#define ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT	(1 << ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS)
+#define ARV_HDR_HISTOGRAM_VALUE_BITS		40
+#define ARV_HDR_HISTOGRAM_N_BUCKETS		((ARV_HDR_HISTOGRAM_VALUE_BITS - ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS + 1) \
+						 << ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS)
+
+typedef struct {
+	guint64 n_samples;
+	guint64 minimum;
+	guint64 maximum;
+	guint64 sum;
+	guint64 buckets[ARV_HDR_HISTOGRAM_N_BUCKETS];
+} ArvHdrHistogramCounters;
+
+struct _ArvHdrHistogram {
+	guint n_variables;
+	guint n_shards;
+	char **names;
+
+	/* n_shards blocks of n_variables counters */
+	ArvHdrHistogramCounters *counters;
+
+	gint ref_count;
+};
+
+/* g_bit_storage() takes a gulong, which is 32 bit wide on some platforms */
+
+static guint
+_bit_storage (guint64 value)
+{
+	if ((value >> 32) != 0)
+		return 32 + g_bit_storage ((gulong) (value >> 32));
+
+	return g_bit_storage ((gulong) value);
+}
+
+static guint
+_value_to_bucket (guint64 value)
+{
+	guint n_bits;
+
+	if (value < ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT)
+		return value;
+
+	n_bits = _bit_storage (value);
+	if (n_bits > ARV_HDR_HISTOGRAM_VALUE_BITS)
+		return ARV_HDR_HISTOGRAM_N_BUCKETS - 1;
+
+	return ((n_bits - ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS) << ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS) +
+		(value >> (n_bits - 1 - ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS)) - ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT;
+}
+
+/* Center of the value range of a bucket */
+
+static double
+_bucket_to_value (guint bucket)
+{
+	guint n_bits;
+	guint64 width;
+
+	if (bucket < ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT)
+		return bucket;
+
+	n_bits = (bucket >> ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS) + ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS;
+	width = G_GUINT64_CONSTANT (1) << (n_bits - 1 - ARV_HDR_HISTOGRAM_SUB_BUCKET_BITS);
+
+	return (double) ((ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT +
+			  (bucket & (ARV_HDR_HISTOGRAM_SUB_BUCKET_COUNT - 1))) * width) + (width - 1) / 2.0;
+}
+
+static ArvHdrHistogramCounters *
+_get_counters (ArvHdrHistogram *histogram, guint shard, guint id)
+{
+	return &histogram->counters[shard * histogram->n_variables + id];
+}
+
+/**
+ * arv_hdr_histogram_new:
+ * @n_variables: number of variables
+ * @n_shards: number of writer threads
+ *
+ * Returns: a new #ArvHdrHistogram
+ */
+
+ArvHdrHistogram *
+arv_hdr_histogram_new (guint n_variables, guint n_shards)
+{
+	ArvHdrHistogram *histogram;
+	guint i;
+
+	g_return_val_if_fail (n_variables > 0, NULL);
+	g_return_val_if_fail (n_shards > 0, NULL);
+
+	histogram = g_new0 (ArvHdrHistogram, 1);
+	histogram->ref_count = 1;
+	histogram->n_variables = n_variables;
+	histogram->n_shards = n_shards;
+	histogram->names = g_new0 (char *, n_variables + 1);
+	for (i = 0; i < n_variables; i++)
+		histogram->names[i] = g_strdup_printf ("var%u", i);
+	histogram->counters = g_new (ArvHdrHistogramCounters, n_shards * n_variables);
+
+	arv_hdr_histogram_reset (histogram);
+
+	return histogram;
+}
+
+ArvHdrHistogram *
+arv_hdr_histogram_ref (ArvHdrHistogram *histogram)
+{
+	g_return_val_if_fail (histogram != NULL, NULL);
+
+	g_atomic_int_inc (&histogram->ref_count);
+
+	return histogram;
+}
+
+void
+arv_hdr_histogram_unref (ArvHdrHistogram *histogram)
+{
+	g_return_if_fail (histogram != NULL);
+
+	if (g_atomic_int_dec_and_test (&histogram->ref_count)) {
+		g_strfreev (histogram->names);
+		g_free (histogram->counters);
+		g_free (histogram);
+	}
+}
+
+void
+arv_hdr_histogram_set_variable_name (ArvHdrHistogram *histogram, guint id, const char *name)
+{
+	g_return_if_fail (histogram != NULL);
+	g_return_if_fail (id < histogram->n_variables);
+
+	g_free (histogram->names[id]);
+	histogram->names[id] = g_strdup (name);
+}
+
+const char *
+arv_hdr_histogram_get_variable_name (ArvHdrHistogram *histogram, guint id)
+{
+	g_return_val_if_fail (histogram != NULL, NULL);
+	g_return_val_if_fail (id < histogram->n_variables, NULL);
+
+	return histogram->names[id];
+}
+
+/**
+ * arv_hdr_histogram_reset:
+ * @histogram: a #ArvHdrHistogram
+ *
+ * Clears all the counters. Must not be called while a writer is filling @histogram.
+ */
+
+void
+arv_hdr_histogram_reset (ArvHdrHistogram *histogram)
+{
+	guint i;
+
+	g_return_if_fail (histogram != NULL);
+
+	memset (histogram->counters, 0, sizeof (ArvHdrHistogramCounters) * histogram->n_shards * histogram->n_variables);
+	for (i = 0; i < histogram->n_shards * histogram->n_variables; i++)
+		histogram->counters[i].minimum = G_MAXUINT64;
+}
+
+/**
+ * arv_hdr_histogram_fill:
+ * @histogram: a #ArvHdrHistogram
+ * @shard: shard of the calling thread
+ * @id: variable index
+ * @value: sample value
+ *
+ * Adds a sample. A shard must be filled by only one thread at a time.
+ */
+
+void
+arv_hdr_histogram_fill (ArvHdrHistogram *histogram, guint shard, guint id, guint64 value)
+{
+	ArvHdrHistogramCounters *counters;
+
+	g_return_if_fail (histogram != NULL);
+	g_return_if_fail (shard < histogram->n_shards && id < histogram->n_variables);
+
+	counters = _get_counters (histogram, shard, id);
+
+	counters->buckets[_value_to_bucket (value)]++;
+	counters->sum += value;
+	if (value < counters->minimum)
+		counters->minimum = value;
+	if (value > counters->maximum)
+		counters->maximum = value;
+	counters->n_samples++;
+}
+
+/**
+ * arv_hdr_histogram_dup_snapshot:
+ * @histogram: a #ArvHdrHistogram
+ *
+ * Returns: (transfer full): a new single shard histogram, with the merged counters of @histogram.
+ */
+
+ArvHdrHistogram *
+arv_hdr_histogram_dup_snapshot (ArvHdrHistogram *histogram)
+{
+	ArvHdrHistogram *snapshot;
+	guint shard, i, j;
+
+	g_return_val_if_fail (histogram != NULL, NULL);
+
+	snapshot = arv_hdr_histogram_new (histogram->n_variables, 1);
+
+	for (i = 0; i < histogram->n_variables; i++) {
+		ArvHdrHistogramCounters *merged = _get_counters (snapshot, 0, i);
+
+		arv_hdr_histogram_set_variable_name (snapshot, i, histogram->names[i]);
+
+		for (shard = 0; shard < histogram->n_shards; shard++) {
+			ArvHdrHistogramCounters *counters = _get_counters (histogram, shard, i);
+
+			for (j = 0; j < ARV_HDR_HISTOGRAM_N_BUCKETS; j++)
+				merged->buckets[j] += counters->buckets[j];
+			merged->sum += counters->sum;
+			merged->minimum = MIN (merged->minimum, counters->minimum);
+			merged->maximum = MAX (merged->maximum, counters->maximum);
+		}
+
+		/* Consistent with the bucket counts, even if a writer was running */
+		for (j = 0; j < ARV_HDR_HISTOGRAM_N_BUCKETS; j++)
+			merged->n_samples += merged->buckets[j];
+	}
+
+	return snapshot;
+}
+
+guint64
+arv_hdr_histogram_get_n_samples (ArvHdrHistogram *histogram, guint id)
+{
+	guint64 n_samples = 0;
+	guint shard;
+
+	g_return_val_if_fail (histogram != NULL, 0);
+	g_return_val_if_fail (id < histogram->n_variables, 0);
+
+	for (shard = 0; shard < histogram->n_shards; shard++)
+		n_samples += _get_counters (histogram, shard, id)->n_samples;
+
+	return n_samples;
+}
+
+guint64
+arv_hdr_histogram_get_minimum (ArvHdrHistogram *histogram, guint id)
+{
+	guint64 minimum = G_MAXUINT64;
+	guint shard;
+
+	g_return_val_if_fail (histogram != NULL, 0);
+	g_return_val_if_fail (id < histogram->n_variables, 0);
+
+	for (shard = 0; shard < histogram->n_shards; shard++)
+		minimum = MIN (minimum, _get_counters (histogram, shard, id)->minimum);
+
+	return minimum != G_MAXUINT64 ? minimum : 0;
+}
+
+guint64
+arv_hdr_histogram_get_maximum (ArvHdrHistogram *histogram, guint id)
+{
+	guint64 maximum = 0;
+	guint shard;
+
+	g_return_val_if_fail (histogram != NULL, 0);
+	g_return_val_if_fail (id < histogram->n_variables, 0);
+
+	for (shard = 0; shard < histogram->n_shards; shard++)
+		maximum = MAX (maximum, _get_counters (histogram, shard, id)->maximum);
+
+	return maximum;
+}
+
+double
+arv_hdr_histogram_get_mean (ArvHdrHistogram *histogram, guint id)
+{
+	guint64 n_samples = 0;
+	double sum = 0;
+	guint shard;
+
+	g_return_val_if_fail (histogram != NULL, 0.0);
+	g_return_val_if_fail (id < histogram->n_variables, 0.0);
+
+	for (shard = 0; shard < histogram->n_shards; shard++) {
+		ArvHdrHistogramCounters *counters = _get_counters (histogram, shard, id);
+
+		n_samples += counters->n_samples;
+		sum += counters->sum;
+	}
+
+	return n_samples > 0 ? sum / n_samples : 0.0;
+}
+
+/**
+ * arv_hdr_histogram_get_percentile:
+ * @histogram: a #ArvHdrHistogram
+ * @id: variable index
+ * @percentile: percentile, between 0 and 100
+ *
+ * Returns: the value below which @percentile % of the samples fall, within the bucket precision, or 0 if there is
+ * no sample.
+ */
+
+double
+arv_hdr_histogram_get_percentile (ArvHdrHistogram *histogram, guint id, double percentile)
+{
+	guint64 n_samples = 0;
+	guint64 rank;
+	guint64 count = 0;
+	guint shard, i;
+
+	g_return_val_if_fail (histogram != NULL, 0.0);
+	g_return_val_if_fail (id < histogram->n_variables, 0.0);
+
+	percentile = CLAMP (percentile, 0.0, 100.0);
+
+	for (shard = 0; shard < histogram->n_shards; shard++)
+		for (i = 0; i < ARV_HDR_HISTOGRAM_N_BUCKETS; i++)
+			n_samples += _get_counters (histogram, shard, id)->buckets[i];
+
+	if (n_samples == 0)
+		return 0.0;
+
+	rank = MAX (1, (guint64) ceil (percentile * n_samples / 100.0));
+
+	for (i = 0; i < ARV_HDR_HISTOGRAM_N_BUCKETS; i++) {
+		for (shard = 0; shard < histogram->n_shards; shard++)
+			count += _get_counters (histogram, shard, id)->buckets[i];
+
+		if (count >= rank)
+			return CLAMP (_bucket_to_value (i),
+				      (double) arv_hdr_histogram_get_minimum (histogram, id),
+				      (double) arv_hdr_histogram_get_maximum (histogram, id));
+	}
+
+	return arv_hdr_histogram_get_maximum (histogram, id);
+}
+
+char *
+arv_hdr_histogram_to_string (ArvHdrHistogram *histogram)
+{
+	ArvHdrHistogram *snapshot;
+	GString *string;
+	guint i;
+
+	g_return_val_if_fail (histogram != NULL, NULL);
+
+	snapshot = arv_hdr_histogram_dup_snapshot (histogram);
+	string = g_string_new ("");
+
+	g_string_append_printf (string, "%-16s;%12s;%12s;%12s;%12s;%12s;%12s;%12s;%12s\n",
+				"variable", "n_samples", "min", "mean", "p50", "p99", "p99.9", "p99.99", "max");
+
+	for (i = 0; i < snapshot->n_variables; i++)
+		g_string_append_printf (string, "%-16.16s;%12" G_GUINT64_FORMAT ";%12" G_GUINT64_FORMAT
+					";%12.1f;%12.1f;%12.1f;%12.1f;%12.1f;%12" G_GUINT64_FORMAT "\n",
+					snapshot->names[i],
+					arv_hdr_histogram_get_n_samples (snapshot, i),
+					arv_hdr_histogram_get_minimum (snapshot, i),
+					arv_hdr_histogram_get_mean (snapshot, i),
+					arv_hdr_histogram_get_percentile (snapshot, i, 50.0),
+					arv_hdr_histogram_get_percentile (snapshot, i, 99.0),
+					arv_hdr_histogram_get_percentile (snapshot, i, 99.9),
+					arv_hdr_histogram_get_percentile (snapshot, i, 99.99),
+					arv_hdr_histogram_get_maximum (snapshot, i));
+
+	arv_hdr_histogram_unref (snapshot);
+
+	return g_string_free (string, FALSE);
+}
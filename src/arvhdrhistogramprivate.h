@@ -0,0 +1,59 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_HDR_HISTOGRAM_PRIVATE_H
+#define ARV_HDR_HISTOGRAM_PRIVATE_H
+
+#include <arvapi.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvHdrHistogram ArvHdrHistogram;
+
+/* private, but used by tests */
+ARV_API ArvHdrHistogram *	arv_hdr_histogram_new			(guint n_variables, guint n_shards);
+ARV_API ArvHdrHistogram *	arv_hdr_histogram_ref			(ArvHdrHistogram *histogram);
+ARV_API void			arv_hdr_histogram_unref			(ArvHdrHistogram *histogram);
+
+ARV_API void			arv_hdr_histogram_set_variable_name	(ArvHdrHistogram *histogram, guint id,
+									 const char *name);
+ARV_API const char *		arv_hdr_histogram_get_variable_name	(ArvHdrHistogram *histogram, guint id);
+ARV_API void			arv_hdr_histogram_reset			(ArvHdrHistogram *histogram);
+
+ARV_API void			arv_hdr_histogram_fill			(ArvHdrHistogram *histogram, guint shard, guint id,
+									 guint64 value);
+
+ARV_API ArvHdrHistogram *	arv_hdr_histogram_dup_snapshot		(ArvHdrHistogram *histogram);
+
+ARV_API guint64			arv_hdr_histogram_get_n_samples		(ArvHdrHistogram *histogram, guint id);
+ARV_API guint64			arv_hdr_histogram_get_minimum		(ArvHdrHistogram *histogram, guint id);
+ARV_API guint64			arv_hdr_histogram_get_maximum		(ArvHdrHistogram *histogram, guint id);
+ARV_API double			arv_hdr_histogram_get_mean		(ArvHdrHistogram *histogram, guint id);
+ARV_API double			arv_hdr_histogram_get_percentile	(ArvHdrHistogram *histogram, guint id,
+									 double percentile);
+
+ARV_API char *			arv_hdr_histogram_to_string		(ArvHdrHistogram *histogram);
+
+G_END_DECLS
+
+#endif
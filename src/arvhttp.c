@@ -0,0 +1,479 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Minimal HTTP/1.1 client, used for the download of the Genicam data of the devices pointing to a vendor web server.
+ * It only issues GET requests, with optional If-None-Match and If-Modified-Since validators, and follows a few
+ * redirections. The body may be sent with a Content-Length, chunked, or delimited by the connection close. Content
+ * encodings are not supported, the request asking for the identity encoding. HTTPS works when a TLS backend is
+ * available to GIO.
+ */
+
+#include <arvhttpprivate.h>
+#include <arvmiscprivate.h>
+#include <arvdebugprivate.h>
+#include <arvversion.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARV_HTTP_N_REDIRECTIONS_MAX	4
+#define ARV_HTTP_BODY_SIZE_MAX		(64 * 1024 * 1024)
+#define ARV_HTTP_CHUNK_SIZE		65536
+#define ARV_HTTP_LINE_SIZE_MAX		8192
+
+/* Reads a line of at most ARV_HTTP_LINE_SIZE_MAX bytes. The last line may be terminated by the end of the stream. */
+
+static char *
+_read_line (GDataInputStream *stream, GCancellable *cancellable, GError **error)
+{
+	GError *local_error = NULL;
+	GString *line;
+	int byte;
+
+	line = g_string_new (NULL);
+
+	while ((byte = g_buffered_input_stream_read_byte (G_BUFFERED_INPUT_STREAM (stream),
+							  cancellable, &local_error)) != '\n') {
+		if (byte < 0) {
+			if (local_error != NULL)
+				g_propagate_error (error, local_error);
+			else if (line->len == 0)
+				g_set_error (error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT,
+					     "Unexpected end of HTTP response");
+			else
+				break;
+			g_string_free (line, TRUE);
+			return NULL;
+		}
+
+		if (line->len >= ARV_HTTP_LINE_SIZE_MAX) {
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE, "HTTP response line too long");
+			g_string_free (line, TRUE);
+			return NULL;
+		}
+
+		g_string_append_c (line, byte);
+	}
+
+	return g_strchomp (g_string_free (line, FALSE));
+}
+
+static gboolean
+_read_bytes (GDataInputStream *stream, GByteArray *body, gsize size, GCancellable *cancellable, GError **error)
+{
+	gsize offset = body->len;
+	gsize n_read;
+
+	if (offset + size > ARV_HTTP_BODY_SIZE_MAX) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE, "HTTP response body too large");
+		return FALSE;
+	}
+
+	g_byte_array_set_size (body, offset + size);
+	if (!g_input_stream_read_all (G_INPUT_STREAM (stream), body->data + offset, size, &n_read,
+				      cancellable, error))
+		return FALSE;
+
+	if (n_read != size) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated HTTP response body");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+_read_chunked_body (GDataInputStream *stream, GByteArray *body, GCancellable *cancellable, GError **error)
+{
+	for (;;) {
+		char *line;
+		char *end;
+		guint64 chunk_size;
+
+		line = _read_line (stream, cancellable, error);
+		if (line == NULL)
+			return FALSE;
+
+		/* Chunk extensions are ignored */
+		chunk_size = g_ascii_strtoull (line, &end, 16);
+		if (end == line) {
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid HTTP chunk size '%s'", line);
+			g_free (line);
+			return FALSE;
+		}
+		g_free (line);
+
+		if (chunk_size == 0)
+			break;
+
+		if (chunk_size > ARV_HTTP_BODY_SIZE_MAX ||
+		    !_read_bytes (stream, body, chunk_size, cancellable, error))
+			return FALSE;
+
+		/* Chunk terminator */
+		line = _read_line (stream, cancellable, error);
+		if (line == NULL)
+			return FALSE;
+		g_free (line);
+	}
+
+	/* Trailer fields */
+	for (;;) {
+		char *line;
+		gboolean is_empty;
+
+		line = _read_line (stream, cancellable, error);
+		if (line == NULL)
+			return FALSE;
+		is_empty = line[0] == '\0';
+		g_free (line);
+
+		if (is_empty)
+			return TRUE;
+	}
+}
+
+static gboolean
+_read_body_until_close (GDataInputStream *stream, GByteArray *body, GCancellable *cancellable, GError **error)
+{
+	guint8 buffer[ARV_HTTP_CHUNK_SIZE];
+	gssize n_read;
+
+	while ((n_read = g_input_stream_read (G_INPUT_STREAM (stream), buffer, sizeof (buffer),
+					      cancellable, error)) > 0) {
+		if (body->len + n_read > ARV_HTTP_BODY_SIZE_MAX) {
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE, "HTTP response body too large");
+			return FALSE;
+		}
+		g_byte_array_append (body, buffer, n_read);
+	}
+
+	return n_read == 0;
+}
+
+static gint64
+_parse_max_age (const char *cache_control)
+{
+	gint64 max_age = -1;
+	char **directives;
+	int i;
+
+	directives = g_strsplit (cache_control, ",", -1);
+	for (i = 0; directives[i] != NULL; i++) {
+		char *directive = g_strstrip (directives[i]);
+
+		if (g_ascii_strcasecmp (directive, "no-cache") == 0 ||
+		    g_ascii_strcasecmp (directive, "no-store") == 0) {
+			max_age = 0;
+			break;
+		}
+		if (g_ascii_strncasecmp (directive, "max-age=", 8) == 0)
+			max_age = MAX (0, g_ascii_strtoll (directive + 8, NULL, 10));
+	}
+	g_strfreev (directives);
+
+	return max_age;
+}
+
+/* The request line and the header fields must not be split by the URL parts or the validators */
+
+static gboolean
+_is_valid_field (const char *field)
+{
+	return field == NULL || strpbrk (field, "\r\n") == NULL;
+}
+
+/* Resolves a relative redirection target against the request URL. Dot segments are left to the server. */
+
+static char *
+_resolve_location (const char *location, const char *scheme, const char *authority, const char *path)
+{
+	char *uri_scheme;
+	const char *directory_end;
+
+	uri_scheme = g_uri_parse_scheme (location);
+	if (uri_scheme != NULL) {
+		g_free (uri_scheme);
+		return g_strdup (location);
+	}
+
+	if (g_str_has_prefix (location, "//"))
+		return g_strdup_printf ("%s:%s", scheme, location);
+
+	if (location[0] == '/')
+		return g_strdup_printf ("%s://%s%s", scheme, authority, location);
+
+	directory_end = strrchr (path, '/');
+
+	return g_strdup_printf ("%s://%s%.*s/%s", scheme, authority,
+				directory_end != NULL ? (int) (directory_end - path) : 0, path, location);
+}
+
+/* Returns the redirection target, if any */
+
+static char *
+_get (const char *url, const char *etag, const char *last_modified, guint timeout_ms,
+      GCancellable *cancellable, ArvHttpResponse *response, GError **error)
+{
+	GSocketClient *client = NULL;
+	GSocketConnectable *connectable = NULL;
+	GSocketConnection *connection = NULL;
+	GDataInputStream *stream = NULL;
+	GByteArray *body = NULL;
+	GString *request = NULL;
+	char *scheme = NULL;
+	char *authority = NULL;
+	char *path = NULL;
+	char *query = NULL;
+	char *location = NULL;
+	char *line = NULL;
+	gboolean is_https;
+	gboolean is_chunked = FALSE;
+	gint64 content_length = -1;
+
+	if (!arv_parse_genicam_url (url, -1, &scheme, &authority, &path, &query, NULL, NULL, NULL) ||
+	    scheme == NULL || authority == NULL ||
+	    (g_ascii_strcasecmp (scheme, "http") != 0 && g_ascii_strcasecmp (scheme, "https") != 0)) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid HTTP URL '%s'", url);
+		goto out;
+	}
+
+	if (!_is_valid_field (authority) || !_is_valid_field (path) || !_is_valid_field (query) ||
+	    !_is_valid_field (etag) || !_is_valid_field (last_modified)) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid HTTP request for '%s'", url);
+		goto out;
+	}
+
+	is_https = g_ascii_strcasecmp (scheme, "https") == 0;
+
+	connectable = g_network_address_parse (authority, is_https ? 443 : 80, error);
+	if (connectable == NULL)
+		goto out;
+
+	client = g_socket_client_new ();
+	g_socket_client_set_timeout (client, MAX (1, (timeout_ms + 999) / 1000));
+	g_socket_client_set_tls (client, is_https);
+
+	connection = g_socket_client_connect (client, connectable, cancellable, error);
+	if (connection == NULL)
+		goto out;
+
+	request = g_string_new (NULL);
+	g_string_append_printf (request, "GET %s%s%s HTTP/1.1\r\n", path != NULL && path[0] != '\0' ? path : "/",
+				query != NULL ? "?" : "", query != NULL ? query : "");
+	g_string_append_printf (request, "Host: %s\r\n", authority);
+	g_string_append (request, "User-Agent: Aravis/" ARAVIS_VERSION "\r\n");
+	g_string_append (request, "Accept-Encoding: identity\r\n");
+	g_string_append (request, "Connection: close\r\n");
+	if (etag != NULL)
+		g_string_append_printf (request, "If-None-Match: %s\r\n", etag);
+	if (last_modified != NULL)
+		g_string_append_printf (request, "If-Modified-Since: %s\r\n", last_modified);
+	g_string_append (request, "\r\n");
+
+	if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (connection)),
+					request->str, request->len, NULL, cancellable, error))
+		goto out;
+
+	stream = g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM (connection)));
+	g_data_input_stream_set_newline_type (stream, G_DATA_STREAM_NEWLINE_TYPE_LF);
+
+	line = _read_line (stream, cancellable, error);
+	if (line == NULL)
+		goto out;
+
+	/* HTTP/1.x NNN Reason */
+	if (g_str_has_prefix (line, "HTTP/1.") && strlen (line) >= 12)
+		response->status = g_ascii_strtoull (line + 9, NULL, 10);
+	if (response->status < 100 || response->status > 599) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid HTTP status line '%s'", line);
+		goto out;
+	}
+	g_clear_pointer (&line, g_free);
+
+	for (;;) {
+		char *value;
+
+		line = _read_line (stream, cancellable, error);
+		if (line == NULL)
+			goto out;
+
+		if (line[0] == '\0')
+			break;
+
+		value = strchr (line, ':');
+		if (value != NULL) {
+			*value = '\0';
+			value = g_strstrip (value + 1);
+
+			if (g_ascii_strcasecmp (line, "ETag") == 0) {
+				g_free (response->etag);
+				response->etag = g_strdup (value);
+			} else if (g_ascii_strcasecmp (line, "Last-Modified") == 0) {
+				g_free (response->last_modified);
+				response->last_modified = g_strdup (value);
+			} else if (g_ascii_strcasecmp (line, "Cache-Control") == 0) {
+				response->max_age_s = _parse_max_age (value);
+			} else if (g_ascii_strcasecmp (line, "Content-Length") == 0) {
+				content_length = g_ascii_strtoll (value, NULL, 10);
+			} else if (g_ascii_strcasecmp (line, "Transfer-Encoding") == 0) {
+				is_chunked = g_ascii_strcasecmp (value, "chunked") == 0;
+			} else if (g_ascii_strcasecmp (line, "Location") == 0) {
+				g_free (location);
+				location = _resolve_location (value, scheme, authority, path != NULL ? path : "");
+			}
+		}
+
+		g_clear_pointer (&line, g_free);
+	}
+	g_clear_pointer (&line, g_free);
+
+	if (response->status == 301 || response->status == 302 ||
+	    response->status == 307 || response->status == 308) {
+		if (location == NULL)
+			g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+				     "HTTP redirection without location");
+		goto out;
+	}
+	g_clear_pointer (&location, g_free);
+
+	/* No body for the informational, 204 and 304 responses */
+	if ((response->status >= 100 && response->status < 200) || response->status == 204 ||
+	    response->status == ARV_HTTP_STATUS_NOT_MODIFIED)
+		goto out;
+
+	body = g_byte_array_new ();
+
+	if (is_chunked) {
+		if (!_read_chunked_body (stream, body, cancellable, error))
+			goto out;
+	} else if (content_length >= 0) {
+		if (!_read_bytes (stream, body, content_length, cancellable, error))
+			goto out;
+	} else if (!_read_body_until_close (stream, body, cancellable, error))
+		goto out;
+
+	response->body = g_byte_array_free_to_bytes (g_steal_pointer (&body));
+
+out:
+	if (body != NULL)
+		g_byte_array_unref (body);
+	if (request != NULL)
+		g_string_free (request, TRUE);
+	g_clear_object (&stream);
+	g_clear_object (&connection);
+	g_clear_object (&client);
+	g_clear_object (&connectable);
+	g_free (line);
+	g_free (scheme);
+	g_free (authority);
+	g_free (path);
+	g_free (query);
+
+	return location;
+}
+
+/**
+ * arv_http_get:
+ * @url: an http or https URL
+ * @etag: (nullable): entity tag of a cached copy, sent as If-None-Match
+ * @last_modified: (nullable): modification date of a cached copy, sent as If-Modified-Since
+ * @timeout_ms: connection timeout, in milliseconds
+ * @cancellable: (nullable): a #GCancellable
+ * @response: (out caller-allocates): response placeholder, to be cleared by arv_http_response_clear()
+ * @error: a #GError placeholder
+ *
+ * Issues a GET request. The response body is only set for the 2xx status. A %ARV_HTTP_STATUS_NOT_MODIFIED status
+ * means the cached copy designated by the validators is still valid.
+ *
+ * Returns: %TRUE if a response was received, whatever its status.
+ */
+
+gboolean
+arv_http_get (const char *url, const char *etag, const char *last_modified, guint timeout_ms,
+	      GCancellable *cancellable, ArvHttpResponse *response, GError **error)
+{
+	GError *local_error = NULL;
+	char *current_url;
+	int i;
+
+	g_return_val_if_fail (url != NULL, FALSE);
+	g_return_val_if_fail (response != NULL, FALSE);
+
+	memset (response, 0, sizeof (ArvHttpResponse));
+	response->max_age_s = -1;
+
+	current_url = g_strdup (url);
+
+	for (i = 0; i <= ARV_HTTP_N_REDIRECTIONS_MAX; i++) {
+		char *location;
+
+		arv_info_misc ("[Http::get] GET %s", current_url);
+
+		location = _get (current_url, etag, last_modified, timeout_ms, cancellable, response, &local_error);
+		if (location == NULL || local_error != NULL) {
+			g_free (location);
+			break;
+		}
+
+		arv_info_misc ("[Http::get] Redirected to %s", location);
+
+		g_free (current_url);
+		current_url = location;
+		arv_http_response_clear (response);
+	}
+
+	if (i > ARV_HTTP_N_REDIRECTIONS_MAX)
+		local_error = g_error_new (G_IO_ERROR, G_IO_ERROR_TOO_MANY_LINKS, "Too many HTTP redirections");
+
+	g_free (current_url);
+
+	if (local_error != NULL) {
+		arv_http_response_clear (response);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_info_misc ("[Http::get] Status %u, %" G_GSIZE_FORMAT " bytes", response->status,
+		       response->body != NULL ? g_bytes_get_size (response->body) : 0);
+
+	return TRUE;
+}
+
+/**
+ * arv_http_response_clear:
+ * @response: a #ArvHttpResponse
+ *
+ * Frees the response content, and resets it.
+ */
+
+void
+arv_http_response_clear (ArvHttpResponse *response)
+{
+	g_return_if_fail (response != NULL);
+
+	g_clear_pointer (&response->body, g_bytes_unref);
+	g_clear_pointer (&response->etag, g_free);
+	g_clear_pointer (&response->last_modified, g_free);
+	response->status = 0;
+	response->max_age_s = -1;
+}
@@ -0,0 +1,52 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_HTTP_PRIVATE_H
+#define ARV_HTTP_PRIVATE_H
+
+#include <arvapi.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ARV_HTTP_STATUS_OK		200
+#define ARV_HTTP_STATUS_NOT_MODIFIED	304
+
+typedef struct {
+	guint status;
+	GBytes *body;
+	/* Validators, for the conditional requests */
+	char *etag;
+	char *last_modified;
+	/* Freshness lifetime given by Cache-Control, -1 if unspecified */
+	gint64 max_age_s;
+} ArvHttpResponse;
+
+/* private, but used by tests */
+ARV_API gboolean	arv_http_get			(const char *url, const char *etag, const char *last_modified,
+							 guint timeout_ms, GCancellable *cancellable,
+							 ArvHttpResponse *response, GError **error);
+ARV_API void		arv_http_response_clear		(ArvHttpResponse *response);
+
+G_END_DECLS
+
+#endif
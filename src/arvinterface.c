@@ -33,6 +33,14 @@
 
 #include <arvinterfaceprivate.h>
 
+enum {
+	ARV_INTERFACE_SIGNAL_DEVICE_ADDED,
+	ARV_INTERFACE_SIGNAL_DEVICE_REMOVED,
+	ARV_INTERFACE_SIGNAL_LAST
+} ArvInterfaceSignals;
+
+static guint arv_interface_signals[ARV_INTERFACE_SIGNAL_LAST] = {0};
+
 typedef struct {
 	GArray *device_ids;
 } ArvInterfacePrivate;
@@ -366,6 +374,22 @@ arv_interface_open_device (ArvInterface *iface, const char *device_id, GError **
 	return ARV_INTERFACE_GET_CLASS (iface)->open_device (iface, device_id, error);
 }
 
+void
+arv_interface_emit_device_added_signal (ArvInterface *iface, const char *device_id)
+{
+	g_return_if_fail (ARV_IS_INTERFACE (iface));
+
+	g_signal_emit (iface, arv_interface_signals[ARV_INTERFACE_SIGNAL_DEVICE_ADDED], 0, device_id);
+}
+
+void
+arv_interface_emit_device_removed_signal (ArvInterface *iface, const char *device_id)
+{
+	g_return_if_fail (ARV_IS_INTERFACE (iface));
+
+	g_signal_emit (iface, arv_interface_signals[ARV_INTERFACE_SIGNAL_DEVICE_REMOVED], 0, device_id);
+}
+
 static void
 arv_interface_init (ArvInterface *iface)
 {
@@ -393,4 +417,46 @@ arv_interface_class_init (ArvInterfaceClass *interface_class)
 	GObjectClass *object_class = G_OBJECT_CLASS (interface_class);
 
 	object_class->finalize = arv_interface_finalize;
+
+	/**
+	 * ArvInterface::device-added:
+	 * @iface: a #ArvInterface
+	 * @device_id: the id of the new device
+	 *
+	 * Signal that a device appeared on the interface. It is emitted by the interfaces which track their devices
+	 * in the background, like the GigEVision interface with its discovery thread running, or the USB3Vision
+	 * interface on hosts supporting hotplug notifications.
+	 *
+	 * This signal may be emited from a thread different than the main one,
+	 * so please take care to shared data access from the callback.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	arv_interface_signals[ARV_INTERFACE_SIGNAL_DEVICE_ADDED] =
+		g_signal_new ("device-added",
+			      G_TYPE_FROM_CLASS (interface_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL,
+			      g_cclosure_marshal_VOID__STRING, G_TYPE_NONE, 1, G_TYPE_STRING);
+
+	/**
+	 * ArvInterface::device-removed:
+	 * @iface: a #ArvInterface
+	 * @device_id: the id of the removed device
+	 *
+	 * Signal that a device disappeared from the interface. See #ArvInterface::device-added.
+	 *
+	 * This signal may be emited from a thread different than the main one,
+	 * so please take care to shared data access from the callback.
+	 *
+	 * Since: 0.8.24
+	 */
+
+	arv_interface_signals[ARV_INTERFACE_SIGNAL_DEVICE_REMOVED] =
+		g_signal_new ("device-removed",
+			      G_TYPE_FROM_CLASS (interface_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL,
+			      g_cclosure_marshal_VOID__STRING, G_TYPE_NONE, 1, G_TYPE_STRING);
 }
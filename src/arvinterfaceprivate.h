@@ -45,6 +45,9 @@ typedef struct {
 	char *serial_nbr;
 } ArvInterfaceDeviceIds;
 
+void		arv_interface_emit_device_added_signal		(ArvInterface *iface, const char *device_id);
+void		arv_interface_emit_device_removed_signal	(ArvInterface *iface, const char *device_id);
+
 G_END_DECLS
 
 #endif
@@ -26,10 +26,28 @@
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
+#include <arvfeatures.h>
+
+#if ARAVIS_HAS_LIBDEFLATE
+#include <libdeflate.h>
+#else
 #include <zlib.h>
+#endif
 
 #ifdef G_OS_WIN32
 	 #include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#if defined (__GNUC__) && defined (__SSE2__)
+#include <emmintrin.h>
+#define ARV_MEMORY_HAS_STREAMING_STORES 1
+#else
+#define ARV_MEMORY_HAS_STREAMING_STORES 0
 #endif
 
 /**
@@ -478,6 +496,83 @@ arv_value_holds_double (ArvValue *value)
 	return value->type == G_TYPE_DOUBLE;
 }
 
+/* Register values of 1, 2, 4 or 8 bytes are converted as integers, using the byte swap instructions. Truncation keeps
+ * the least significant bytes, and extension fills the most significant ones with zeros, as the byte copy does. */
+
+static inline gboolean
+_is_word_size (size_t size)
+{
+	return size == 1 || size == 2 || size == 4 || size == 8;
+}
+
+static inline guint64
+_load_word (const void *from, size_t size, guint endianness)
+{
+	guint16 value16;
+	guint32 value32;
+	guint64 value64;
+
+	switch (size) {
+		case 1:
+			return *((const guint8 *) from);
+		case 2:
+			memcpy (&value16, from, sizeof (value16));
+			return endianness == G_BIG_ENDIAN ? GUINT16_FROM_BE (value16) : GUINT16_FROM_LE (value16);
+		case 4:
+			memcpy (&value32, from, sizeof (value32));
+			return endianness == G_BIG_ENDIAN ? GUINT32_FROM_BE (value32) : GUINT32_FROM_LE (value32);
+		default:
+			memcpy (&value64, from, sizeof (value64));
+			return endianness == G_BIG_ENDIAN ? GUINT64_FROM_BE (value64) : GUINT64_FROM_LE (value64);
+	}
+}
+
+static inline void
+_store_word (void *to, size_t size, guint endianness, guint64 value)
+{
+	guint16 value16;
+	guint32 value32;
+
+	switch (size) {
+		case 1:
+			*((guint8 *) to) = value;
+			break;
+		case 2:
+			value16 = endianness == G_BIG_ENDIAN ? GUINT16_TO_BE (value) : GUINT16_TO_LE (value);
+			memcpy (to, &value16, sizeof (value16));
+			break;
+		case 4:
+			value32 = endianness == G_BIG_ENDIAN ? GUINT32_TO_BE (value) : GUINT32_TO_LE (value);
+			memcpy (to, &value32, sizeof (value32));
+			break;
+		default:
+			value = endianness == G_BIG_ENDIAN ? GUINT64_TO_BE (value) : GUINT64_TO_LE (value);
+			memcpy (to, &value, sizeof (value));
+			break;
+	}
+}
+
+/* Byte reversal of large blocks, like StructReg registers, 8 bytes at a time from both ends. The loop is simple enough
+ * to be turned into vector shuffles by the compiler. */
+
+static void
+_reverse_copy (char *to, const char *from, size_t size)
+{
+	const char *from_end = from + size;
+	size_t i;
+
+	for (i = 0; i + 8 <= size; i += 8) {
+		guint64 value;
+
+		memcpy (&value, from_end - i - 8, sizeof (value));
+		value = GUINT64_SWAP_LE_BE (value);
+		memcpy (to + i, &value, sizeof (value));
+	}
+
+	for (; i < size; i++)
+		to[i] = from_end[-1 - (gssize) i];
+}
+
 void
 arv_copy_memory_with_endianness (void *to, size_t to_size, guint to_endianness,
 				void *from, size_t from_size, guint from_endianness)
@@ -489,6 +584,20 @@ arv_copy_memory_with_endianness (void *to, size_t to_size, guint to_endianness,
 	g_return_if_fail (to != NULL);
 	g_return_if_fail (from != NULL);
 
+	if (_is_word_size (to_size) && _is_word_size (from_size) &&
+	    (to_endianness == G_LITTLE_ENDIAN || to_endianness == G_BIG_ENDIAN) &&
+	    (from_endianness == G_LITTLE_ENDIAN || from_endianness == G_BIG_ENDIAN)) {
+		_store_word (to, to_size, to_endianness, _load_word (from, from_size, from_endianness));
+		return;
+	}
+
+	if (to_endianness != from_endianness && to_size == from_size &&
+	    (to_endianness == G_LITTLE_ENDIAN || to_endianness == G_BIG_ENDIAN) &&
+	    (from_endianness == G_LITTLE_ENDIAN || from_endianness == G_BIG_ENDIAN)) {
+		_reverse_copy (to, from, to_size);
+		return;
+	}
+
 	if (to_endianness == G_LITTLE_ENDIAN &&
 	    from_endianness == G_BIG_ENDIAN) {
 		to_ptr = to;
@@ -533,7 +642,86 @@ arv_copy_memory_with_endianness (void *to, size_t to_size, guint to_endianness,
 		g_assert_not_reached ();
 }
 
-#define ARV_DECOMPRESS_CHUNK 16384
+/*
+ * arv_inflate:
+ * @input_buffer: raw deflate data
+ * @input_size: size of @input_buffer
+ * @output_buffer: output buffer
+ * @output_size: size of @output_buffer
+ * @inflated_size: (out) (optional): placeholder for the size of the inflated data
+ *
+ * Inflates @input_buffer in a single call, using libdeflate when available, zlib otherwise.
+ *
+ * Returns: #ARV_INFLATE_INSUFFICIENT_SPACE if @output_buffer is too small for the inflated data.
+ */
+
+ArvInflateResult
+arv_inflate (const void *input_buffer, size_t input_size, void *output_buffer, size_t output_size,
+	     size_t *inflated_size)
+{
+	ArvInflateResult inflate_result;
+#if ARAVIS_HAS_LIBDEFLATE
+	struct libdeflate_decompressor *decompressor;
+	enum libdeflate_result result;
+	size_t actual_size = 0;
+
+	decompressor = libdeflate_alloc_decompressor ();
+	if (decompressor == NULL)
+		return ARV_INFLATE_ERROR;
+
+	result = libdeflate_deflate_decompress (decompressor, input_buffer, input_size,
+						output_buffer, output_size, &actual_size);
+	libdeflate_free_decompressor (decompressor);
+
+	switch (result) {
+		case LIBDEFLATE_SUCCESS:
+			inflate_result = ARV_INFLATE_SUCCESS;
+			break;
+		case LIBDEFLATE_INSUFFICIENT_SPACE:
+			inflate_result = ARV_INFLATE_INSUFFICIENT_SPACE;
+			break;
+		default:
+			arv_warning_misc ("[Inflate] Invalid deflate data (%d)", result);
+			inflate_result = ARV_INFLATE_ERROR;
+			break;
+	}
+#else
+	z_stream stream = {0};
+	size_t actual_size;
+	int result;
+
+	if (input_size > G_MAXUINT || output_size > G_MAXUINT)
+		return ARV_INFLATE_ERROR;
+
+	if (inflateInit2 (&stream, -MAX_WBITS) != Z_OK)
+		return ARV_INFLATE_ERROR;
+
+	stream.next_in = (void *) input_buffer;
+	stream.avail_in = input_size;
+	stream.next_out = output_buffer;
+	stream.avail_out = output_size;
+
+	result = inflate (&stream, Z_FINISH);
+	actual_size = output_size - stream.avail_out;
+	inflateEnd (&stream);
+
+	if (result == Z_STREAM_END)
+		inflate_result = ARV_INFLATE_SUCCESS;
+	else if (result == Z_BUF_ERROR && stream.avail_out == 0)
+		inflate_result = ARV_INFLATE_INSUFFICIENT_SPACE;
+	else {
+		arv_warning_misc ("[Inflate] Invalid deflate data (%d)", result);
+		inflate_result = ARV_INFLATE_ERROR;
+	}
+#endif
+
+	if (inflated_size != NULL)
+		*inflated_size = inflate_result == ARV_INFLATE_SUCCESS ? actual_size : 0;
+
+	return inflate_result;
+}
+
+#define ARV_DECOMPRESS_MIN_SIZE 16384
 
 /**
  * arv_decompress:
@@ -546,92 +734,39 @@ arv_copy_memory_with_endianness (void *to, size_t to_size, guint to_endianness,
 void *
 arv_decompress (void *input_buffer, size_t input_size, size_t *output_size)
 {
-	z_stream stream;
-	GByteArray *output;
-	guchar z_stream_output[ARV_DECOMPRESS_CHUNK];
-	unsigned have;
-	int result;
+	ArvInflateResult result;
+	size_t allocated_size;
+	size_t inflated_size = 0;
+	void *output;
+
+	if (output_size != NULL)
+		*output_size = 0;
 
 	g_return_val_if_fail (input_buffer != NULL, NULL);
 	g_return_val_if_fail (input_size > 0, NULL);
 
-	/* allocate inflate state */
-	stream.zalloc = Z_NULL;
-	stream.zfree = Z_NULL;
-	stream.opaque = Z_NULL;
-	stream.avail_in = 0;
-	stream.next_in = Z_NULL;
-	stream.data_type = Z_UNKNOWN;
-
-	g_return_val_if_fail (inflateInit2(&stream, -MAX_WBITS) == Z_OK, NULL);
-
-	output = g_byte_array_new ();
-
-	/* decompress until deflate stream ends or end of file */
-	do {
-		stream.avail_in = MIN (input_size, ARV_DECOMPRESS_CHUNK);
-		stream.next_in = input_buffer;
-
-		arv_info_misc ("[Decompress] Input ptr = 0x%p - Chunk size = %d - %c",
-				(void *) stream.next_in, stream.avail_in, *stream.next_in);
-
-		input_size -= stream.avail_in;
-		input_buffer = ((char *) input_buffer) + stream.avail_in;
-
-		/* run inflate() on input until output buffer not full */
-		do {
-			stream.avail_out = ARV_DECOMPRESS_CHUNK;
-			stream.next_out = z_stream_output;
-			result = inflate(&stream, Z_NO_FLUSH);
-			if (result == Z_STREAM_ERROR) {
-				arv_warning_misc ("[Decompress] Z_STREAM_ERROR");
-				goto CLEANUP;
-			}
-
-			switch (result) {
-				case Z_NEED_DICT:
-					arv_warning_misc ("[Decompress] Z_NEED_DICT");
-					goto CLEANUP;
-				case Z_DATA_ERROR:
-					arv_warning_misc ("[Decompress] Z_DATA_ERROR");
-					goto CLEANUP;
-				case Z_MEM_ERROR:
-					arv_warning_misc ("[Decompress] Z_MEM_ERROR");
-					goto CLEANUP;
-			}
-
-			have = ARV_DECOMPRESS_CHUNK - stream.avail_out;
-			g_byte_array_append (output, z_stream_output, have);
-		} while (stream.avail_out == 0);
-
-		/* done when inflate() says it's done */
-	} while (input_size > 0 && result != Z_STREAM_END);
+	/* The inflated size is unknown. Text like GenICam XML data compresses about 10 times, the output buffer is
+	 * grown and the inflate restarted in the rare cases where it is not enough. */
+	allocated_size = MAX (input_size * 8, ARV_DECOMPRESS_MIN_SIZE);
+	output = g_malloc (allocated_size);
 
-	/* clean up and return */
-	inflateEnd(&stream);
+	while ((result = arv_inflate (input_buffer, input_size, output, allocated_size, &inflated_size)) ==
+	       ARV_INFLATE_INSUFFICIENT_SPACE) {
+		allocated_size *= 2;
+		output = g_realloc (output, allocated_size);
+	}
 
-	if (result != Z_STREAM_END) {
-		arv_warning_misc ("[Decompress] !Z_STREAM_END");
-		g_byte_array_free (output, TRUE);
-		if (output_size != NULL)
-			*output_size = 0;
+	if (result != ARV_INFLATE_SUCCESS) {
+		g_free (output);
 		return NULL;
 	}
 
-	if (output_size != NULL)
-		*output_size = output->len;
-
-	return g_byte_array_free (output, FALSE);
-
-CLEANUP:
+	arv_info_misc ("[Decompress] %zu bytes inflated to %zu bytes", input_size, inflated_size);
 
 	if (output_size != NULL)
-		*output_size = 0;
+		*output_size = inflated_size;
 
-	g_byte_array_free (output, TRUE);
-	inflateEnd(&stream);
-
-	return NULL;
+	return g_realloc (output, MAX (inflated_size, 1));
 }
 
 /**
@@ -1108,3 +1243,236 @@ arv_regex_new_from_glob_pattern (const char *glob, gboolean caseless)
 
 	return regex;
 }
+
+/*
+ * Memory locking, for the real-time acquisitions. mlock() faults the pages in, and keeps them resident, which moves
+ * the page faults of the first frames out of the stream threads. A failure is usually due to the RLIMIT_MEMLOCK
+ * limit, reported once with the current value.
+ */
+
+#define ARV_MEMORY_PAGE_SIZE		4096
+#define ARV_MEMORY_STACK_PREFAULT_SIZE	(256 * 1024)
+
+#ifndef G_OS_WIN32
+
+static void
+_warn_memory_lock_failure (size_t size, int errsv)
+{
+	static gint warned = 0;
+	struct rlimit rlim;
+	char *limit;
+
+	if (!g_atomic_int_compare_and_exchange (&warned, 0, 1))
+		return;
+
+	if (getrlimit (RLIMIT_MEMLOCK, &rlim) != 0)
+		limit = g_strdup ("unknown");
+	else if (rlim.rlim_cur == RLIM_INFINITY)
+		limit = g_strdup ("unlimited");
+	else
+		limit = g_strdup_printf ("%" G_GUINT64_FORMAT " bytes", (guint64) rlim.rlim_cur);
+
+	arv_warning_misc ("Failed to lock %zu bytes in memory (%s), the locked memory limit (RLIMIT_MEMLOCK) being %s. "
+			  "It can be raised using 'ulimit -l', the memlock entry of /etc/security/limits.conf, "
+			  "or LimitMEMLOCK for systemd services. Pages will be faulted in without being locked.",
+			  size, g_strerror (errsv), limit);
+
+	g_free (limit);
+}
+
+#endif
+
+/* Writes one byte per page */
+
+void
+arv_memory_prefault (void *data, size_t size)
+{
+	volatile guint8 *bytes = data;
+	size_t offset;
+
+	if (bytes == NULL)
+		return;
+
+	for (offset = 0; offset < size; offset += ARV_MEMORY_PAGE_SIZE)
+		bytes[offset] = 0;
+}
+
+/* Locks the pages of @data in memory, or falls back to arv_memory_prefault(). Returns %TRUE if the pages are locked. */
+
+gboolean
+arv_memory_lock (void *data, size_t size)
+{
+	if (data == NULL || size == 0)
+		return FALSE;
+
+#ifndef G_OS_WIN32
+	if (mlock (data, size) == 0)
+		return TRUE;
+
+	_warn_memory_lock_failure (size, errno);
+#endif
+
+	arv_memory_prefault (data, size);
+
+	return FALSE;
+}
+
+void
+arv_memory_unlock (void *data, size_t size)
+{
+#ifndef G_OS_WIN32
+	if (data != NULL && size > 0)
+		munlock (data, size);
+#endif
+}
+
+/* Touches, and locks if possible, the stack pages below the caller frame, which the receive loops may use */
+
+void
+arv_memory_prefault_stack (void)
+{
+	guint8 stack[ARV_MEMORY_STACK_PREFAULT_SIZE];
+
+	arv_memory_lock (stack, sizeof (stack));
+}
+
+/*
+ * Payload copies. The non-temporal copy writes the destination with streaming stores, which bypass the caches, and
+ * keeps the working set of the consumer in the last level cache when the frames are larger than it. The temporal copy
+ * is a plain memcpy(), preferable when the data is read right after, for example by an inline processing stage.
+ */
+
+#define ARV_MEMORY_DEFAULT_LAST_LEVEL_CACHE_SIZE	(8 * 1024 * 1024)
+#define ARV_MEMORY_NON_TEMPORAL_MIN_SIZE		256
+
+static gsize
+_read_last_level_cache_size (void)
+{
+#ifdef __linux__
+	guint max_level = 0;
+	gsize cache_size = 0;
+	unsigned int i;
+
+	for (i = 0; i < 16; i++) {
+		char *path;
+		char *contents = NULL;
+		guint level;
+		guint64 size;
+		char *end;
+
+		path = g_strdup_printf ("/sys/devices/system/cpu/cpu0/cache/index%u/level", i);
+		if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+			g_free (path);
+			break;
+		}
+		g_free (path);
+		level = g_ascii_strtoull (contents, NULL, 10);
+		g_free (contents);
+
+		path = g_strdup_printf ("/sys/devices/system/cpu/cpu0/cache/index%u/size", i);
+		if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+			g_free (path);
+			continue;
+		}
+		g_free (path);
+		size = g_ascii_strtoull (contents, &end, 10);
+		if (*end == 'K')
+			size *= 1024;
+		else if (*end == 'M')
+			size *= 1024 * 1024;
+		g_free (contents);
+
+		if (level >= max_level && size > 0) {
+			max_level = level;
+			cache_size = size;
+		}
+	}
+
+	if (cache_size > 0)
+		return cache_size;
+#endif
+
+#if defined (_SC_LEVEL3_CACHE_SIZE)
+	{
+		long size = sysconf (_SC_LEVEL3_CACHE_SIZE);
+
+		if (size > 0)
+			return size;
+	}
+#endif
+
+	return ARV_MEMORY_DEFAULT_LAST_LEVEL_CACHE_SIZE;
+}
+
+/* Returns the size of the last level cache of the first CPU, in bytes, 8 MiB if unknown */
+
+gsize
+arv_memory_get_last_level_cache_size (void)
+{
+	static gsize cache_size = 0;
+
+	if (g_once_init_enter (&cache_size)) {
+		gsize size = _read_last_level_cache_size ();
+
+		arv_info_misc ("[Memory::get_last_level_cache_size] %" G_GSIZE_FORMAT " bytes", size);
+
+		g_once_init_leave (&cache_size, size);
+	}
+
+	return cache_size;
+}
+
+/* Selects the copy mode of a frame of @frame_size bytes. @is_read_next is set when the data is read by the receiving
+ * thread right after the copy. */
+
+ArvMemoryCopyMode
+arv_memory_select_copy_mode (size_t frame_size, gboolean is_read_next)
+{
+	if (is_read_next || frame_size <= arv_memory_get_last_level_cache_size ())
+		return ARV_MEMORY_COPY_MODE_TEMPORAL;
+
+	return ARV_MEMORY_COPY_MODE_NON_TEMPORAL;
+}
+
+void
+arv_memory_copy (void *to, const void *from, size_t size, ArvMemoryCopyMode mode)
+{
+#if ARV_MEMORY_HAS_STREAMING_STORES
+	guint8 *dst = to;
+	const guint8 *src = from;
+	size_t head;
+
+	if (mode != ARV_MEMORY_COPY_MODE_NON_TEMPORAL || size < ARV_MEMORY_NON_TEMPORAL_MIN_SIZE) {
+		memcpy (to, from, size);
+		return;
+	}
+
+	/* The streaming stores need an aligned destination, the loads being unaligned */
+	head = (16 - ((guintptr) dst & 15)) & 15;
+	memcpy (dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+
+	for (; size >= 64; size -= 64, dst += 64, src += 64) {
+		__m128i a = _mm_loadu_si128 ((const __m128i *) src);
+		__m128i b = _mm_loadu_si128 ((const __m128i *) (src + 16));
+		__m128i c = _mm_loadu_si128 ((const __m128i *) (src + 32));
+		__m128i d = _mm_loadu_si128 ((const __m128i *) (src + 48));
+
+		_mm_stream_si128 ((__m128i *) dst, a);
+		_mm_stream_si128 ((__m128i *) (dst + 16), b);
+		_mm_stream_si128 ((__m128i *) (dst + 32), c);
+		_mm_stream_si128 ((__m128i *) (dst + 48), d);
+	}
+	for (; size >= 16; size -= 16, dst += 16, src += 16)
+		_mm_stream_si128 ((__m128i *) dst, _mm_loadu_si128 ((const __m128i *) src));
+
+	memcpy (dst, src, size);
+
+	/* Orders the streaming stores before the frame completion is published to the other threads */
+	_mm_sfence ();
+#else
+	memcpy (to, from, size);
+#endif
+}
@@ -72,9 +72,19 @@ ARV_API gboolean	arv_parse_genicam_url	(const char *url, gssize url_length,
 						 char **query, char **fragment,
 						 guint64 *address, guint64 *size);
 
-void 		arv_copy_memory_with_endianness	(void *to, size_t to_size, guint to_endianness,
+/* private, but used by tests */
+ARV_API void	arv_copy_memory_with_endianness	(void *to, size_t to_size, guint to_endianness,
 						 void *from, size_t from_size, guint from_endianness);
 
+typedef enum {
+	ARV_INFLATE_SUCCESS,
+	ARV_INFLATE_INSUFFICIENT_SPACE,
+	ARV_INFLATE_ERROR
+} ArvInflateResult;
+
+ArvInflateResult	arv_inflate	(const void *input_buffer, size_t input_size,
+					 void *output_buffer, size_t output_size, size_t *inflated_size);
+
 void * 		arv_decompress 			(void *input_buffer, size_t input_size, size_t *output_size);
 
 /* private, but used by tests */
@@ -83,6 +93,22 @@ ARV_API const char *	arv_vendor_alias_lookup	(const char *vendor);
 /* this only wraps g_get_monotonic_time on non-windows platforms */
 gint64 arv_monotonic_time_us (void);
 
+void		arv_memory_prefault		(void *data, size_t size);
+gboolean	arv_memory_lock			(void *data, size_t size);
+void		arv_memory_unlock		(void *data, size_t size);
+void		arv_memory_prefault_stack	(void);
+
+typedef enum {
+	ARV_MEMORY_COPY_MODE_TEMPORAL,
+	ARV_MEMORY_COPY_MODE_NON_TEMPORAL
+} ArvMemoryCopyMode;
+
+/* private, but used by tests */
+ARV_API gsize			arv_memory_get_last_level_cache_size	(void);
+ARV_API ArvMemoryCopyMode	arv_memory_select_copy_mode		(size_t frame_size, gboolean is_read_next);
+ARV_API void			arv_memory_copy				(void *to, const void *from, size_t size,
+									 ArvMemoryCopyMode mode);
+
 #if GLIB_CHECK_VERSION(2,68,0)
 #define arv_memdup(p,s) g_memdup2(p,s)
 #else
@@ -25,9 +25,24 @@
 #include <arvdebugprivate.h>
 #include <arvmiscprivate.h>
 
+#include <string.h>
+#include <errno.h>
+
 #ifndef G_OS_WIN32
 	#include <ifaddrs.h>
-#else
+	#include <sys/ioctl.h>
+	#include <unistd.h>
+#endif
+
+#if defined (__linux__)
+	#include <linux/sock_diag.h>
+	#include <linux/netlink.h>
+	#include <linux/rtnetlink.h>
+	#include <linux/ethtool.h>
+	#include <linux/sockios.h>
+#endif
+
+#ifdef G_OS_WIN32
 	#include <winsock2.h>
 	#include <iphlpapi.h>
 	#include <winnt.h>	/* For PWCHAR */
@@ -38,8 +53,120 @@ struct _ArvNetworkInterface{
 	struct sockaddr *netmask;
 	struct sockaddr *broadaddr;
 	char* name;
+
+	guint mtu;
+	guint link_speed;	/* Mbit/s */
+	gint numa_node;
+	guint n_rx_queues;
 };
 
+#if defined (__linux__)
+static gint64
+_read_integer_file (const char *filename, gint64 fallback)
+{
+	char *contents = NULL;
+	gint64 value = fallback;
+
+	if (g_file_get_contents (filename, &contents, NULL, NULL)) {
+		char *end;
+		gint64 parsed = g_ascii_strtoll (contents, &end, 10);
+
+		if (end != contents)
+			value = parsed;
+	}
+	g_free (contents);
+
+	return value;
+}
+
+static gint64
+_read_sysfs_integer (const char *name, const char *attribute, gint64 fallback)
+{
+	char *filename;
+	gint64 value;
+
+	filename = g_build_filename ("/sys/class/net", name, attribute, NULL);
+	value = _read_integer_file (filename, fallback);
+	g_free (filename);
+
+	return value;
+}
+
+static gboolean
+_ethtool_ioctl (const char *name, void *data)
+{
+	struct ifreq ifr = {0};
+	int result;
+	int fd;
+
+	fd = socket (AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return FALSE;
+
+	g_strlcpy (ifr.ifr_name, name, IFNAMSIZ);
+	ifr.ifr_data = data;
+	result = ioctl (fd, SIOCETHTOOL, &ifr);
+	close (fd);
+
+	return result == 0;
+}
+#endif
+
+/* Fills the interface properties used for the stream tuning */
+
+static void
+_read_interface_properties (ArvNetworkInterface *a)
+{
+	a->mtu = 0;
+	a->link_speed = 0;
+	a->numa_node = -1;
+	a->n_rx_queues = 0;
+
+	if (a->name == NULL)
+		return;
+
+#if defined (__linux__)
+	{
+		char *filename;
+		GDir *dir;
+		gint64 value;
+
+		value = _read_sysfs_integer (a->name, "mtu", 0);
+		a->mtu = value > 0 ? value : 0;
+		/* -1 if the link is down */
+		value = _read_sysfs_integer (a->name, "speed", 0);
+		a->link_speed = value > 0 ? value : 0;
+		a->numa_node = _read_sysfs_integer (a->name, "device/numa_node", -1);
+
+		filename = g_build_filename ("/sys/class/net", a->name, "queues", NULL);
+		dir = g_dir_open (filename, 0, NULL);
+		if (dir != NULL) {
+			const char *entry;
+
+			while ((entry = g_dir_read_name (dir)) != NULL)
+				if (g_str_has_prefix (entry, "rx-"))
+					a->n_rx_queues++;
+			g_dir_close (dir);
+		}
+		g_free (filename);
+	}
+#elif !defined(G_OS_WIN32) && defined(SIOCGIFMTU)
+	{
+		struct ifreq ifr = {0};
+		int fd;
+
+		g_strlcpy (ifr.ifr_name, a->name, IFNAMSIZ);
+
+		fd = socket (AF_INET, SOCK_DGRAM, 0);
+		if (fd >= 0) {
+			if (ioctl (fd, SIOCGIFMTU, &ifr) == 0 && ifr.ifr_mtu > 0)
+				a->mtu = ifr.ifr_mtu;
+			close (fd);
+		}
+	}
+#endif
+}
+
 #ifdef G_OS_WIN32
 
 ARV_DEFINE_CONSTRUCTOR (arv_initialize_networking)
@@ -102,8 +229,8 @@ arv_cleanup_networking (void)
 	}
 }
 
-GList *
-arv_enumerate_network_interfaces (void)
+static GList *
+_scan_network_interfaces (void)
 {
 	/*
 	 * docs: https://docs.microsoft.com/en-us/windows/win32/api/iphlpapi/nf-iphlpapi-getadaptersaddresses
@@ -240,6 +367,12 @@ arv_enumerate_network_interfaces (void)
 				wcstombs (a->name, name, asciiSize);
 			}
 
+			_read_interface_properties (a);
+			a->mtu = pAddrIter->Mtu;
+			#if WINVER >= _WIN32_WINNT_VISTA
+				a->link_speed = pAddrIter->TransmitLinkSpeed / 1000000;
+			#endif
+
 			ret = g_list_prepend(ret, a);
 		}
 	}
@@ -343,8 +476,8 @@ arv_gpollfd_finish_all (GPollFD *fds, guint nfds){
 
 #else /* not G_OS_WIN32 */
 
-GList*
-arv_enumerate_network_interfaces (void)
+static GList *
+_scan_network_interfaces (void)
 {
 	struct ifaddrs *ifap = NULL;
 	struct ifaddrs *ifap_iter;
@@ -385,6 +518,8 @@ arv_enumerate_network_interfaces (void)
 			if (ifap_iter->ifa_name)
 				a->name = g_strdup(ifap_iter->ifa_name);
 
+			_read_interface_properties (a);
+
 			ret = g_list_prepend (ret, a);
 		}
 	}
@@ -414,6 +549,136 @@ arv_gpollfd_finish_all(GPollFD *fds, guint nfds)
 
 #endif /* G_OS_WIN32 */
 
+static ArvNetworkInterface *
+_network_interface_copy (ArvNetworkInterface *a)
+{
+	ArvNetworkInterface *copy;
+
+	copy = arv_memdup (a, sizeof (ArvNetworkInterface));
+	copy->addr = a->addr != NULL ? arv_memdup (a->addr, sizeof (struct sockaddr)) : NULL;
+	copy->netmask = a->netmask != NULL ? arv_memdup (a->netmask, sizeof (struct sockaddr)) : NULL;
+	copy->broadaddr = a->broadaddr != NULL ? arv_memdup (a->broadaddr, sizeof (struct sockaddr)) : NULL;
+	copy->name = g_strdup (a->name);
+
+	return copy;
+}
+
+/* Process wide interface table. On Linux, it is refreshed after the reception of a rtnetlink link or address
+ * notification, which is checked without blocking on each access. Elsewhere, or if the netlink socket can't be
+ * opened, the table is scanned again when older than ARV_NETWORK_TABLE_LIFETIME_US. */
+
+#define ARV_NETWORK_TABLE_LIFETIME_US	1000000
+
+static GMutex arv_network_table_mutex;
+static GList *arv_network_table = NULL;
+static gboolean arv_network_table_is_valid = FALSE;
+static gint64 arv_network_table_time_us = 0;
+
+#if defined (__linux__)
+static int arv_network_netlink_fd = -2;	/* Not opened yet */
+
+static void
+_open_netlink_socket (void)
+{
+	struct sockaddr_nl address = {0};
+	int fd;
+
+	fd = socket (AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (fd >= 0) {
+		address.nl_family = AF_NETLINK;
+		address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+		if (bind (fd, (struct sockaddr *) &address, sizeof (address)) != 0) {
+			close (fd);
+			fd = -1;
+		}
+	}
+
+	if (fd < 0)
+		arv_info_interface ("[Network::open_netlink_socket] Failed, fall back to polling");
+
+	arv_network_netlink_fd = fd;
+}
+
+/* Returns TRUE if a notification was received, or if some were lost */
+
+static gboolean
+_drain_netlink_socket (void)
+{
+	char buffer[4096];
+	gboolean has_changed = FALSE;
+	ssize_t size;
+
+	while ((size = recv (arv_network_netlink_fd, buffer, sizeof (buffer), MSG_DONTWAIT)) > 0 ||
+	       (size < 0 && errno == ENOBUFS))
+		has_changed = TRUE;
+
+	return has_changed;
+}
+#endif
+
+/* Must be called with the table mutex held */
+
+static GList *
+_get_network_table (void)
+{
+	gint64 time_us = g_get_monotonic_time ();
+	gboolean is_valid = arv_network_table_is_valid;
+
+#if defined (__linux__)
+	if (arv_network_netlink_fd == -2)
+		_open_netlink_socket ();
+
+	if (arv_network_netlink_fd >= 0) {
+		if (_drain_netlink_socket ())
+			is_valid = FALSE;
+	} else
+#endif
+	if (time_us - arv_network_table_time_us > ARV_NETWORK_TABLE_LIFETIME_US)
+		is_valid = FALSE;
+
+	if (!is_valid) {
+		g_list_free_full (arv_network_table, (GDestroyNotify) arv_network_interface_free);
+		arv_network_table = _scan_network_interfaces ();
+		arv_network_table_time_us = time_us;
+		arv_network_table_is_valid = TRUE;
+
+		arv_debug_interface ("[Network::get_network_table] %u interfaces", g_list_length (arv_network_table));
+	}
+
+	return arv_network_table;
+}
+
+/* Returns a copy of the interface table, to be freed using g_list_free_full() and arv_network_interface_free() */
+
+GList *
+arv_enumerate_network_interfaces (void)
+{
+	GList *ifaces = NULL;
+	GList *iter;
+
+	g_mutex_lock (&arv_network_table_mutex);
+	for (iter = _get_network_table (); iter != NULL; iter = iter->next)
+		ifaces = g_list_prepend (ifaces, _network_interface_copy (iter->data));
+	g_mutex_unlock (&arv_network_table_mutex);
+
+	return g_list_reverse (ifaces);
+}
+
+void
+arv_network_cleanup (void)
+{
+	g_mutex_lock (&arv_network_table_mutex);
+	g_list_free_full (arv_network_table, (GDestroyNotify) arv_network_interface_free);
+	arv_network_table = NULL;
+	arv_network_table_is_valid = FALSE;
+#if defined (__linux__)
+	if (arv_network_netlink_fd >= 0)
+		close (arv_network_netlink_fd);
+	arv_network_netlink_fd = -2;
+#endif
+	g_mutex_unlock (&arv_network_table_mutex);
+}
+
 struct sockaddr *
 arv_network_interface_get_addr(ArvNetworkInterface* a)
 {
@@ -438,6 +703,117 @@ arv_network_interface_get_name(ArvNetworkInterface* a)
 	return a->name;
 }
 
+/* Link MTU, 0 if unknown */
+
+guint
+arv_network_interface_get_mtu (ArvNetworkInterface *a)
+{
+	return a->mtu;
+}
+
+/* Link speed in Mbit/s, 0 if unknown */
+
+guint
+arv_network_interface_get_link_speed (ArvNetworkInterface *a)
+{
+	return a->link_speed;
+}
+
+/* NUMA node of the network adapter, -1 if unknown */
+
+gint
+arv_network_interface_get_numa_node (ArvNetworkInterface *a)
+{
+	return a->numa_node;
+}
+
+/* Number of receive queues, 0 if unknown */
+
+guint
+arv_network_interface_get_n_rx_queues (ArvNetworkInterface *a)
+{
+	return a->n_rx_queues;
+}
+
+/* Current and maximum number of descriptors of the receive ring, FALSE if unknown */
+
+gboolean
+arv_network_interface_get_rx_ring_size (ArvNetworkInterface *a, guint *current, guint *maximum)
+{
+#if defined (__linux__)
+	struct ethtool_ringparam ring = { .cmd = ETHTOOL_GRINGPARAM };
+
+	if (a->name != NULL && _ethtool_ioctl (a->name, &ring)) {
+		if (current != NULL)
+			*current = ring.rx_pending;
+		if (maximum != NULL)
+			*maximum = ring.rx_max_pending;
+		return TRUE;
+	}
+#endif
+
+	return FALSE;
+}
+
+/* Receive interrupt coalescing settings, FALSE if unknown */
+
+gboolean
+arv_network_interface_get_rx_coalescing (ArvNetworkInterface *a, guint *usecs, guint *max_frames, gboolean *adaptive)
+{
+#if defined (__linux__)
+	struct ethtool_coalesce coalesce = { .cmd = ETHTOOL_GCOALESCE };
+
+	if (a->name != NULL && _ethtool_ioctl (a->name, &coalesce)) {
+		if (usecs != NULL)
+			*usecs = coalesce.rx_coalesce_usecs;
+		if (max_frames != NULL)
+			*max_frames = coalesce.rx_max_coalesced_frames;
+		if (adaptive != NULL)
+			*adaptive = coalesce.use_adaptive_rx_coalesce != 0;
+		return TRUE;
+	}
+#endif
+
+	return FALSE;
+}
+
+/* Effective reverse path filtering mode, the highest of the interface and global settings, -1 if unknown */
+
+gint
+arv_network_interface_get_rp_filter (ArvNetworkInterface *a)
+{
+#if defined (__linux__)
+	char *filename;
+	gint64 value;
+
+	if (a->name == NULL)
+		return -1;
+
+	filename = g_build_filename ("/proc/sys/net/ipv4/conf", a->name, "rp_filter", NULL);
+	value = _read_integer_file (filename, -1);
+	g_free (filename);
+
+	if (value < 0)
+		return -1;
+
+	return MAX (value, _read_integer_file ("/proc/sys/net/ipv4/conf/all/rp_filter", 0));
+#else
+	return -1;
+#endif
+}
+
+/* Maximum receive socket buffer size allowed by the net.core.rmem_max setting, -1 if unknown */
+
+gint64
+arv_network_get_rmem_max (void)
+{
+#if defined (__linux__)
+	return _read_integer_file ("/proc/sys/net/core/rmem_max", -1);
+#else
+	return -1;
+#endif
+}
+
 void
 arv_network_interface_free(ArvNetworkInterface *a)
 {
@@ -467,29 +843,121 @@ arv_socket_set_recv_buffer_size (int socket_fd, gint buffer_size)
 	return result == 0;
 }
 
+/*
+ * arv_socket_get_n_drops:
+ * @socket_fd: a socket file descriptor
+ * @n_drops: (out): placeholder for the drop counter
+ *
+ * Reads the number of datagrams dropped by the kernel on reception, mostly because the receive buffer was full. This
+ * is the counter reported by the SO_RXQ_OVFL control messages and in /proc/net/udp, obtained here without
+ * per-datagram overhead. It is cumulative, and wraps at 32 bits.
+ *
+ * Returns: %TRUE if the counter is available on this platform.
+ */
+
+gboolean
+arv_socket_get_n_drops (int socket_fd, guint32 *n_drops)
+{
+#if defined (__linux__) && defined (SO_MEMINFO)
+	guint32 meminfo[SK_MEMINFO_VARS];
+	socklen_t length = sizeof (meminfo);
+
+	if (getsockopt (socket_fd, SOL_SOCKET, SO_MEMINFO, meminfo, &length) != 0 ||
+	    length <= SK_MEMINFO_DROPS * sizeof (guint32))
+		return FALSE;
+
+	*n_drops = meminfo[SK_MEMINFO_DROPS];
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+/*
+ * arv_network_get_path_mtu:
+ * @interface_address: the host interface address
+ * @device_address: the remote device address
+ *
+ * Queries the MTU of the path between @interface_address and @device_address. On Linux, this is the route MTU
+ * known by the kernel, otherwise the MTU of the interface owning @interface_address.
+ *
+ * Returns: the path MTU, in bytes, or 0 if it can't be obtained.
+ */
+
+guint
+arv_network_get_path_mtu (GInetAddress *interface_address, GInetAddress *device_address)
+{
+	guint mtu = 0;
+
+	g_return_val_if_fail (G_IS_INET_ADDRESS (interface_address), 0);
+	g_return_val_if_fail (G_IS_INET_ADDRESS (device_address), 0);
+
+#if defined(__linux__) && defined(IP_MTU)
+	{
+		struct sockaddr_in local_sockaddr = {0};
+		struct sockaddr_in device_sockaddr = {0};
+		int discover = IP_PMTUDISC_DO;
+		socklen_t length = sizeof (int);
+		int value;
+		int fd;
+
+		local_sockaddr.sin_family = AF_INET;
+		memcpy (&local_sockaddr.sin_addr, g_inet_address_to_bytes (interface_address), 4);
+		device_sockaddr.sin_family = AF_INET;
+		device_sockaddr.sin_port = htons (3956);
+		memcpy (&device_sockaddr.sin_addr, g_inet_address_to_bytes (device_address), 4);
+
+		fd = socket (AF_INET, SOCK_DGRAM, 0);
+		if (fd >= 0) {
+			if (setsockopt (fd, IPPROTO_IP, IP_MTU_DISCOVER, &discover, sizeof (discover)) == 0 &&
+			    bind (fd, (struct sockaddr *) &local_sockaddr, sizeof (local_sockaddr)) == 0 &&
+			    connect (fd, (struct sockaddr *) &device_sockaddr, sizeof (device_sockaddr)) == 0 &&
+			    getsockopt (fd, IPPROTO_IP, IP_MTU, &value, &length) == 0 &&
+			    value > 0)
+				mtu = value;
+			close (fd);
+		}
+	}
+#else
+	{
+		ArvNetworkInterface *network_interface;
+		char *address_string;
+
+		/* Link MTU of the local interface */
+		address_string = g_inet_address_to_string (interface_address);
+		network_interface = arv_network_get_interface_by_address (address_string);
+		g_free (address_string);
+
+		if (network_interface != NULL) {
+			mtu = arv_network_interface_get_mtu (network_interface);
+			arv_network_interface_free (network_interface);
+		}
+	}
+#endif
+
+	arv_debug_interface ("[Network::get_path_mtu] MTU = %u", mtu);
+
+	return mtu;
+}
+
 
 ArvNetworkInterface*
 arv_network_get_interface_by_name (const char* name)
 {
-	GList *ifaces;
 	GList *iface_iter;
 	ArvNetworkInterface *ret = NULL;
 
-	ifaces = arv_enumerate_network_interfaces ();
+	g_mutex_lock (&arv_network_table_mutex);
 
-	for (iface_iter = ifaces; iface_iter != NULL; iface_iter = iface_iter->next) {
-		if (g_strcmp0 (name, arv_network_interface_get_name (iface_iter->data)) == 0)
+	for (iface_iter = _get_network_table (); iface_iter != NULL; iface_iter = iface_iter->next) {
+		if (g_strcmp0 (name, arv_network_interface_get_name (iface_iter->data)) == 0) {
+			ret = _network_interface_copy (iface_iter->data);
 			break;
+		}
 	}
 
-	if(iface_iter != NULL){
-		/* remove the interface node from the list (deleted below) but don't delete its data */
-		ret = iface_iter->data;
-		ifaces = g_list_remove_link(ifaces, iface_iter);
-		g_list_free(iface_iter);
-	}
-
-	g_list_free_full (ifaces, (GDestroyNotify) arv_network_interface_free);
+	g_mutex_unlock (&arv_network_table_mutex);
 
 	return ret;
 }
@@ -499,12 +967,9 @@ arv_network_get_interface_by_address (const char* addr)
 {
 	GInetSocketAddress *iaddr_s = NULL;
 	GInetAddress *iaddr = NULL;
-	GList *ifaces;
 	GList *iface_iter;
 	ArvNetworkInterface *ret = NULL;
 
-	ifaces = arv_enumerate_network_interfaces ();
-
 	if (!g_hostname_is_ip_address(addr))
 		return NULL;
 
@@ -514,7 +979,9 @@ arv_network_get_interface_by_address (const char* addr)
 
 	iaddr = g_inet_socket_address_get_address(iaddr_s);
 
-	for (iface_iter = ifaces; iface_iter != NULL; iface_iter = iface_iter->next) {
+	g_mutex_lock (&arv_network_table_mutex);
+
+	for (iface_iter = _get_network_table (); iface_iter != NULL; iface_iter = iface_iter->next) {
 		GSocketAddress *iface_sock_addr;
 		GInetAddress *iface_inet_addr;
 
@@ -523,19 +990,15 @@ arv_network_get_interface_by_address (const char* addr)
 		iface_inet_addr = g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (iface_sock_addr));
 		if (g_inet_address_equal (iaddr,iface_inet_addr)) {
 			g_clear_object (&iface_sock_addr);
+			ret = _network_interface_copy (iface_iter->data);
 			break;
 		}
 		g_clear_object(&iface_sock_addr);
 	}
 
-	if (iface_iter != NULL) {
-		ret = iface_iter->data;
-		ifaces = g_list_remove_link (ifaces, iface_iter);
-		g_list_free (iface_iter);
-	}
+	g_mutex_unlock (&arv_network_table_mutex);
 
 	g_clear_object(&iaddr_s);
-	g_list_free_full (ifaces, (GDestroyNotify) arv_network_interface_free);
 
 	return ret;
 }
@@ -546,6 +1009,7 @@ arv_network_get_fake_ipv4_loopback (void)
 	ArvNetworkInterface* ret = (ArvNetworkInterface*) g_malloc0(sizeof(ArvNetworkInterface));
 
 	ret->name = g_strdup ("<fake IPv4 localhost>");
+	ret->numa_node = -1;
 	ret->addr = g_malloc0 (sizeof(struct sockaddr_in));
 	ret->addr->sa_family = AF_INET;
 	((struct sockaddr_in*)ret->addr)->sin_addr.s_addr = htonl(0x7f000001); // INADDR_LOOPBACK
@@ -95,8 +95,10 @@ typedef struct _ArvNetworkInterface ArvNetworkInterface;
 /* private, but used by tests */
 ARV_API GList *		arv_enumerate_network_interfaces	(void);
 ArvNetworkInterface*	arv_network_get_interface_by_name	(const char* name);
-ArvNetworkInterface*	arv_network_get_interface_by_address	(const char* addr);
+/* private, but used by arv-tool */
+ARV_API ArvNetworkInterface*	arv_network_get_interface_by_address	(const char* addr);
 ArvNetworkInterface*	arv_network_get_fake_ipv4_loopback	(void);
+void			arv_network_cleanup			(void);
 
 /* private, but used by tests */
 ARV_API void 			arv_network_interface_free		(ArvNetworkInterface *a);
@@ -105,8 +107,24 @@ ARV_API struct sockaddr *	arv_network_interface_get_netmask	(ArvNetworkInterface
 ARV_API struct sockaddr *	arv_network_interface_get_broadaddr	(ArvNetworkInterface *a);
 ARV_API const char *		arv_network_interface_get_name		(ArvNetworkInterface *a);
 ARV_API gboolean		arv_network_interface_is_loopback	(ArvNetworkInterface *a);
+ARV_API guint			arv_network_interface_get_mtu		(ArvNetworkInterface *a);
+ARV_API guint			arv_network_interface_get_link_speed	(ArvNetworkInterface *a);
+ARV_API gint			arv_network_interface_get_numa_node	(ArvNetworkInterface *a);
+ARV_API guint			arv_network_interface_get_n_rx_queues	(ArvNetworkInterface *a);
+
+/* private, but used by arv-tool */
+ARV_API gboolean		arv_network_interface_get_rx_ring_size	(ArvNetworkInterface *a,
+									 guint *current, guint *maximum);
+ARV_API gboolean		arv_network_interface_get_rx_coalescing	(ArvNetworkInterface *a, guint *usecs,
+									 guint *max_frames, gboolean *adaptive);
+ARV_API gint			arv_network_interface_get_rp_filter	(ArvNetworkInterface *a);
+ARV_API gint64			arv_network_get_rmem_max		(void);
 
 gboolean			arv_socket_set_recv_buffer_size		(int socket_fd, gint buffer_size);
+gboolean			arv_socket_get_n_drops			(int socket_fd, guint32 *n_drops);
+
+guint				arv_network_get_path_mtu		(GInetAddress *interface_address,
+									 GInetAddress *device_address);
 
 #ifdef G_OS_WIN32
 	/* mingw only defines with _WIN32_WINNT>=0x0600, see
@@ -0,0 +1,181 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * SECTION: arvopenmetrics
+ * @short_description: OpenMetrics export of the device and stream statistics
+ *
+ * The device and stream informations are exported in the OpenMetrics text format, which can be served to a
+ * Prometheus compatible scraper. %G_TYPE_UINT64 informations are exported as counters, %G_TYPE_DOUBLE informations as
+ * gauges, with an "aravis_device_" or "aravis_stream_" prefix, and a "camera" label.
+ */
+
+#include <arvopenmetrics.h>
+#include <arvdevice.h>
+#include <arvstream.h>
+#include <string.h>
+
+typedef struct {
+	char *name;
+	gboolean is_counter;
+	GString *samples;
+} ArvOpenMetricsFamily;
+
+static void
+arv_open_metrics_family_free (ArvOpenMetricsFamily *family)
+{
+	g_free (family->name);
+	g_string_free (family->samples, TRUE);
+	g_free (family);
+}
+
+/* Metric names are restricted to [a-zA-Z0-9_:] */
+
+static char *
+_dup_metric_name (const char *prefix, const char *info_name)
+{
+	char *name = g_strconcat (prefix, info_name, NULL);
+	char *c;
+
+	for (c = name + strlen (prefix); *c != '\0'; c++)
+		if (!g_ascii_isalnum (*c) && *c != '_')
+			*c = '_';
+
+	return name;
+}
+
+static void
+_append_label_value (GString *string, const char *value)
+{
+	for (; *value != '\0'; value++) {
+		if (*value == '\\')
+			g_string_append (string, "\\\\");
+		else if (*value == '"')
+			g_string_append (string, "\\\"");
+		else if (*value == '\n')
+			g_string_append (string, "\\n");
+		else
+			g_string_append_c (string, *value);
+	}
+}
+
+static void
+_add_sample (GHashTable *families_by_name, GPtrArray *families, const char *prefix, const char *info_name,
+	     const char *camera_id, gboolean is_counter, guint64 counter, double gauge)
+{
+	ArvOpenMetricsFamily *family;
+	char *name;
+
+	name = _dup_metric_name (prefix, info_name);
+	family = g_hash_table_lookup (families_by_name, name);
+	if (family == NULL) {
+		family = g_new0 (ArvOpenMetricsFamily, 1);
+		family->name = name;
+		family->is_counter = is_counter;
+		family->samples = g_string_new ("");
+		g_hash_table_insert (families_by_name, family->name, family);
+		g_ptr_array_add (families, family);
+	} else
+		g_free (name);
+
+	if (family->is_counter != is_counter)
+		return;
+
+	g_string_append_printf (family->samples, "%s%s{camera=\"", family->name, is_counter ? "_total" : "");
+	_append_label_value (family->samples, camera_id);
+	if (is_counter)
+		g_string_append_printf (family->samples, "\"} %" G_GUINT64_FORMAT "\n", counter);
+	else
+		g_string_append_printf (family->samples, "\"} %.17g\n", gauge);
+}
+
+/**
+ * arv_dup_openmetrics:
+ * @n_cameras: number of cameras
+ * @camera_ids: (array length=n_cameras): camera identifiers, used as "camera" label values
+ * @devices: (array length=n_cameras) (nullable): camera devices, or %NULL
+ * @streams: (array length=n_cameras) (nullable): camera streams, or %NULL
+ *
+ * Exports the current device and stream informations of a set of cameras in the OpenMetrics text format. Any of the
+ * @devices and @streams entries may be %NULL. The values are read without locking the devices and streams, while
+ * they are running.
+ *
+ * Returns: (transfer full): a newly allocated OpenMetrics text exposition, terminated by "# EOF".
+ *
+ * Since: 0.8.24
+ */
+
+char *
+arv_dup_openmetrics (guint n_cameras, const char **camera_ids, ArvDevice **devices, ArvStream **streams)
+{
+	GHashTable *families_by_name;
+	GPtrArray *families;
+	GString *string;
+	guint i, j;
+
+	g_return_val_if_fail (n_cameras == 0 || camera_ids != NULL, NULL);
+
+	families_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+	families = g_ptr_array_new_with_free_func ((GDestroyNotify) arv_open_metrics_family_free);
+
+	for (i = 0; i < n_cameras; i++) {
+		const char *camera_id = camera_ids[i] != NULL ? camera_ids[i] : "";
+
+		if (devices != NULL && ARV_IS_DEVICE (devices[i])) {
+			for (j = 0; j < arv_device_get_n_infos (devices[i]); j++) {
+				gboolean is_counter = arv_device_get_info_type (devices[i], j) == G_TYPE_UINT64;
+
+				_add_sample (families_by_name, families, "aravis_device_",
+					     arv_device_get_info_name (devices[i], j), camera_id, is_counter,
+					     is_counter ? arv_device_get_info_uint64 (devices[i], j) : 0,
+					     is_counter ? 0.0 : arv_device_get_info_double (devices[i], j));
+			}
+		}
+
+		if (streams != NULL && ARV_IS_STREAM (streams[i])) {
+			for (j = 0; j < arv_stream_get_n_infos (streams[i]); j++) {
+				gboolean is_counter = arv_stream_get_info_type (streams[i], j) == G_TYPE_UINT64;
+
+				_add_sample (families_by_name, families, "aravis_stream_",
+					     arv_stream_get_info_name (streams[i], j), camera_id, is_counter,
+					     is_counter ? arv_stream_get_info_uint64 (streams[i], j) : 0,
+					     is_counter ? 0.0 : arv_stream_get_info_double (streams[i], j));
+			}
+		}
+	}
+
+	string = g_string_new ("");
+
+	for (i = 0; i < families->len; i++) {
+		ArvOpenMetricsFamily *family = g_ptr_array_index (families, i);
+
+		g_string_append_printf (string, "# TYPE %s %s\n", family->name, family->is_counter ? "counter" : "gauge");
+		g_string_append (string, family->samples->str);
+	}
+
+	g_string_append (string, "# EOF\n");
+
+	g_hash_table_unref (families_by_name);
+	g_ptr_array_unref (families);
+
+	return g_string_free (string, FALSE);
+}
@@ -0,0 +1,787 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvPixelCorrection:
+ *
+ * [class@ArvPixelCorrection] applies a flat field correction and a defective pixel correction to the images, for the
+ * cameras lacking them on board.
+ *
+ * The flat field correction uses a per pixel offset map, typically a dark frame, and a gain map: each pixel value p
+ * is replaced by (p - offset) * gain. The defective pixels are then replaced by the mean of their nearest valid
+ * neighbours of the same color, two pixels away for the Bayer images. The maps are given in sensor coordinates, the
+ * region of interest of each image being corrected using the map area under it.
+ *
+ * The monochrome and Bayer images with 8 or 16 bit pixels are supported. The packed pixel formats can be corrected
+ * when the stream unpacks them during the reception, see [method@ArvStream.set_unpack_pixels]. The flat field
+ * correction has AVX2 and NEON kernels, the AVX2 one being selected at runtime.
+ *
+ * The correction can run as a stream stage, see [method@ArvStream.add_pixel_correction_stage], in which case the
+ * buffers are corrected while their data is still in the CPU cache. The maps must not be modified once the
+ * correction is used by a stage.
+ *
+ * The corrections of a camera can be stored in a key file named after its serial number, and loaded using
+ * [ctor@ArvPixelCorrection.new_for_serial]:
+ *
+ * ```
+ * [PixelCorrection]
+ * Width=2048
+ * Height=1536
+ * GainMap=gain.raw
+ * OffsetMap=dark.raw
+ * Defects=12;40;1024;733
+ * ```
+ *
+ * The map files contain width * height floats in the host byte order, their path being relative to the directory of
+ * the key file. Defects is a list of x;y coordinate pairs. All the keys except Width and Height are optional.
+ */
+
+#include <arvpixelcorrection.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define ARV_PIXEL_CORRECTION_HAS_AVX2 1
+#include <immintrin.h>
+#else
+#define ARV_PIXEL_CORRECTION_HAS_AVX2 0
+#endif
+
+#if defined (__ARM_NEON)
+#define ARV_PIXEL_CORRECTION_HAS_NEON 1
+#include <arm_neon.h>
+#else
+#define ARV_PIXEL_CORRECTION_HAS_NEON 0
+#endif
+
+#define ARV_PIXEL_CORRECTION_GROUP		"PixelCorrection"
+#define ARV_PIXEL_CORRECTION_FILE_EXTENSION	".correction"
+
+GQuark
+arv_pixel_correction_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-pixel-correction-error-quark");
+}
+
+typedef struct {
+	guint width;
+	guint height;
+
+	/* Allocated together when one of them is set */
+	float *gain;
+	float *offset;
+
+	/* Defective pixel coordinates, and a bit mask of the defective pixels, allocated with the first defect */
+	GArray *defects;
+	guint8 *defect_mask;
+} ArvPixelCorrectionPrivate;
+
+struct _ArvPixelCorrection {
+	GObject	object;
+
+	ArvPixelCorrectionPrivate *priv;
+};
+
+struct _ArvPixelCorrectionClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvPixelCorrection, arv_pixel_correction, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvPixelCorrection))
+
+typedef struct {
+	guint x;
+	guint y;
+} ArvPixelCorrectionDefect;
+
+typedef struct {
+	ArvPixelFormat pixel_format;
+	guint n_bits;
+	gboolean is_bayer;
+} ArvPixelCorrectionFormat;
+
+static const ArvPixelCorrectionFormat arv_pixel_correction_formats[] = {
+	{ARV_PIXEL_FORMAT_MONO_8,		8,	FALSE},
+	{ARV_PIXEL_FORMAT_MONO_10,		10,	FALSE},
+	{ARV_PIXEL_FORMAT_MONO_12,		12,	FALSE},
+	{ARV_PIXEL_FORMAT_MONO_14,		14,	FALSE},
+	{ARV_PIXEL_FORMAT_MONO_16,		16,	FALSE},
+	{ARV_PIXEL_FORMAT_BAYER_GR_8,		8,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_RG_8,		8,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GB_8,		8,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_BG_8,		8,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10,		10,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10,		10,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10,		10,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10,		10,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12,		12,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12,		12,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12,		12,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12,		12,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GR_16,		16,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_RG_16,		16,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_GB_16,		16,	TRUE},
+	{ARV_PIXEL_FORMAT_BAYER_BG_16,		16,	TRUE}
+};
+
+static const ArvPixelCorrectionFormat *
+_find_format (ArvPixelFormat pixel_format)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_pixel_correction_formats); i++)
+		if (arv_pixel_correction_formats[i].pixel_format == pixel_format)
+			return &arv_pixel_correction_formats[i];
+
+	return NULL;
+}
+
+/* Flat field correction kernels, returning the number of corrected pixels */
+
+#if ARV_PIXEL_CORRECTION_HAS_AVX2
+
+static gboolean
+_cpu_has_avx2 (void)
+{
+	static gsize has_avx2 = 0;
+
+	if (g_once_init_enter (&has_avx2)) {
+		__builtin_cpu_init ();
+		g_once_init_leave (&has_avx2, __builtin_cpu_supports ("avx2") ? 2 : 1);
+	}
+
+	return has_avx2 == 2;
+}
+
+/* 8 pixels per iteration, returned as 16 bit values in the low 128 bit lane */
+
+__attribute__ ((target ("avx2")))
+static inline __m128i
+_correct_8_pixels_avx2 (__m256i pixels, const float *gain, const float *offset, __m256 max)
+{
+	__m256 v = _mm256_cvtepi32_ps (pixels);
+	__m256i result;
+
+	v = _mm256_mul_ps (_mm256_sub_ps (v, _mm256_loadu_ps (offset)), _mm256_loadu_ps (gain));
+	v = _mm256_min_ps (_mm256_max_ps (_mm256_add_ps (v, _mm256_set1_ps (0.5f)), _mm256_setzero_ps ()), max);
+	result = _mm256_cvttps_epi32 (v);
+	result = _mm256_packus_epi32 (result, result);
+	result = _mm256_permute4x64_epi64 (result, 0x08);
+
+	return _mm256_castsi256_si128 (result);
+}
+
+__attribute__ ((target ("avx2")))
+static guint
+_correct_row_16_avx2 (guint16 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	const __m256 max = _mm256_set1_ps (max_value);
+	guint i;
+
+	for (i = 0; i + 8 <= width; i += 8) {
+		__m256i pixels = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (row + i)));
+
+		_mm_storeu_si128 ((__m128i *) (row + i), _correct_8_pixels_avx2 (pixels, gain + i, offset + i, max));
+	}
+
+	return i;
+}
+
+__attribute__ ((target ("avx2")))
+static guint
+_correct_row_8_avx2 (guint8 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	const __m256 max = _mm256_set1_ps (max_value);
+	guint i;
+
+	for (i = 0; i + 8 <= width; i += 8) {
+		__m256i pixels = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *) (row + i)));
+		__m128i result = _correct_8_pixels_avx2 (pixels, gain + i, offset + i, max);
+
+		_mm_storel_epi64 ((__m128i *) (row + i), _mm_packus_epi16 (result, result));
+	}
+
+	return i;
+}
+
+#endif
+
+#if ARV_PIXEL_CORRECTION_HAS_NEON
+
+static inline uint16x8_t
+_correct_8_pixels_neon (uint16x8_t pixels, const float *gain, const float *offset, float32x4_t max)
+{
+	const float32x4_t half = vdupq_n_f32 (0.5f);
+	const float32x4_t zero = vdupq_n_f32 (0.0f);
+	float32x4_t low = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (pixels)));
+	float32x4_t high = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (pixels)));
+
+	low = vmulq_f32 (vsubq_f32 (low, vld1q_f32 (offset)), vld1q_f32 (gain));
+	high = vmulq_f32 (vsubq_f32 (high, vld1q_f32 (offset + 4)), vld1q_f32 (gain + 4));
+	low = vminq_f32 (vmaxq_f32 (vaddq_f32 (low, half), zero), max);
+	high = vminq_f32 (vmaxq_f32 (vaddq_f32 (high, half), zero), max);
+
+	return vcombine_u16 (vmovn_u32 (vcvtq_u32_f32 (low)), vmovn_u32 (vcvtq_u32_f32 (high)));
+}
+
+static guint
+_correct_row_16_neon (guint16 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	const float32x4_t max = vdupq_n_f32 (max_value);
+	guint i;
+
+	for (i = 0; i + 8 <= width; i += 8)
+		vst1q_u16 (row + i, _correct_8_pixels_neon (vld1q_u16 (row + i), gain + i, offset + i, max));
+
+	return i;
+}
+
+static guint
+_correct_row_8_neon (guint8 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	const float32x4_t max = vdupq_n_f32 (max_value);
+	guint i;
+
+	for (i = 0; i + 8 <= width; i += 8)
+		vst1_u8 (row + i, vmovn_u16 (_correct_8_pixels_neon (vmovl_u8 (vld1_u8 (row + i)),
+								      gain + i, offset + i, max)));
+
+	return i;
+}
+
+#endif
+
+static inline guint
+_correct_pixel (guint value, float gain, float offset, float max_value)
+{
+	float v = (value - offset) * gain + 0.5f;
+
+	return v <= 0.0f ? 0 : (v >= max_value ? (guint) max_value : (guint) v);
+}
+
+static void
+_correct_row_16 (guint16 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	guint i = 0;
+
+#if ARV_PIXEL_CORRECTION_HAS_AVX2
+	if (_cpu_has_avx2 ())
+		i = _correct_row_16_avx2 (row, width, gain, offset, max_value);
+#elif ARV_PIXEL_CORRECTION_HAS_NEON
+	i = _correct_row_16_neon (row, width, gain, offset, max_value);
+#endif
+
+	for (; i < width; i++)
+		row[i] = _correct_pixel (row[i], gain[i], offset[i], max_value);
+}
+
+static void
+_correct_row_8 (guint8 *row, guint width, const float *gain, const float *offset, float max_value)
+{
+	guint i = 0;
+
+#if ARV_PIXEL_CORRECTION_HAS_AVX2
+	if (_cpu_has_avx2 ())
+		i = _correct_row_8_avx2 (row, width, gain, offset, max_value);
+#elif ARV_PIXEL_CORRECTION_HAS_NEON
+	i = _correct_row_8_neon (row, width, gain, offset, max_value);
+#endif
+
+	for (; i < width; i++)
+		row[i] = _correct_pixel (row[i], gain[i], offset[i], max_value);
+}
+
+static gboolean
+_is_defective (ArvPixelCorrectionPrivate *priv, guint x, guint y)
+{
+	size_t index = (size_t) y * priv->width + x;
+
+	return (priv->defect_mask[index / 8] & (1 << (index % 8))) != 0;
+}
+
+/* Mean of the valid neighbours of the same color, at @step pixels in the four directions, in image coordinates */
+
+static guint
+_interpolate_defect (ArvPixelCorrectionPrivate *priv, const guint8 *data, size_t stride, guint bytes_per_pixel,
+		     guint x, guint y, guint width, guint height, guint x_offset, guint y_offset, guint step)
+{
+	const gint dx[] = {-1, 1, 0, 0};
+	const gint dy[] = {0, 0, -1, 1};
+	guint sum = 0;
+	guint n_neighbours = 0;
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (dx); i++) {
+		gint nx = (gint) x + dx[i] * (gint) step;
+		gint ny = (gint) y + dy[i] * (gint) step;
+		const guint8 *pixel;
+
+		if (nx < 0 || ny < 0 || nx >= (gint) width || ny >= (gint) height ||
+		    _is_defective (priv, nx + x_offset, ny + y_offset))
+			continue;
+
+		pixel = data + ny * stride + nx * bytes_per_pixel;
+		sum += bytes_per_pixel == 2 ? *((const guint16 *) pixel) : *pixel;
+		n_neighbours++;
+	}
+
+	if (n_neighbours == 0)
+		return bytes_per_pixel == 2 ?
+			*((const guint16 *) (data + y * stride + x * 2)) :
+			data[y * stride + x];
+
+	return (sum + n_neighbours / 2) / n_neighbours;
+}
+
+/**
+ * arv_pixel_correction_new:
+ * @width: sensor width
+ * @height: sensor height
+ *
+ * Creates an empty correction for a sensor of @width x @height pixels.
+ *
+ * Returns: (transfer full): a new #ArvPixelCorrection
+ *
+ * Since: 0.8.24
+ */
+
+ArvPixelCorrection *
+arv_pixel_correction_new (guint width, guint height)
+{
+	ArvPixelCorrection *correction;
+
+	g_return_val_if_fail (width > 0 && height > 0, NULL);
+
+	correction = g_object_new (ARV_TYPE_PIXEL_CORRECTION, NULL);
+	correction->priv->width = width;
+	correction->priv->height = height;
+
+	return correction;
+}
+
+static gboolean
+_load_map (ArvPixelCorrection *correction, GKeyFile *key_file, const char *key, const char *directory,
+	   gboolean is_gain, GError **error)
+{
+	char *name;
+	char *path;
+	char *contents = NULL;
+	gsize length = 0;
+	gboolean success;
+
+	name = g_key_file_get_string (key_file, ARV_PIXEL_CORRECTION_GROUP, key, NULL);
+	if (name == NULL)
+		return TRUE;
+
+	path = g_path_is_absolute (name) ? g_strdup (name) : g_build_filename (directory, name, NULL);
+	success = g_file_get_contents (path, &contents, &length, error);
+	if (success) {
+		if (is_gain)
+			success = arv_pixel_correction_set_gain_map (correction, (const float *) contents,
+								     length / sizeof (float), error);
+		else
+			success = arv_pixel_correction_set_offset_map (correction, (const float *) contents,
+								       length / sizeof (float), error);
+	}
+
+	g_free (contents);
+	g_free (path);
+	g_free (name);
+
+	return success;
+}
+
+/**
+ * arv_pixel_correction_new_from_file:
+ * @filename: path of a correction key file
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Loads a correction from a key file, see [class@ArvPixelCorrection] for its format.
+ *
+ * Returns: (transfer full): a new #ArvPixelCorrection, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvPixelCorrection *
+arv_pixel_correction_new_from_file (const char *filename, GError **error)
+{
+	ArvPixelCorrection *correction;
+	GKeyFile *key_file;
+	GError *local_error = NULL;
+	char *directory;
+	gint *defects;
+	gsize n_values = 0;
+	gint width, height;
+	gsize i;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	key_file = g_key_file_new ();
+	if (!g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, &local_error)) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_FILE,
+			     "Failed to load '%s': %s", filename, local_error->message);
+		g_clear_error (&local_error);
+		g_key_file_unref (key_file);
+		return NULL;
+	}
+
+	width = g_key_file_get_integer (key_file, ARV_PIXEL_CORRECTION_GROUP, "Width", NULL);
+	height = g_key_file_get_integer (key_file, ARV_PIXEL_CORRECTION_GROUP, "Height", NULL);
+	if (width <= 0 || height <= 0) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_FILE,
+			     "Invalid sensor size in '%s'", filename);
+		g_key_file_unref (key_file);
+		return NULL;
+	}
+
+	correction = arv_pixel_correction_new (width, height);
+	directory = g_path_get_dirname (filename);
+
+	if (!_load_map (correction, key_file, "GainMap", directory, TRUE, error) ||
+	    !_load_map (correction, key_file, "OffsetMap", directory, FALSE, error)) {
+		g_clear_object (&correction);
+	} else {
+		defects = g_key_file_get_integer_list (key_file, ARV_PIXEL_CORRECTION_GROUP, "Defects",
+						       &n_values, NULL);
+		for (i = 0; i + 1 < n_values; i += 2) {
+			if (defects[i] >= 0 && defects[i] < width && defects[i + 1] >= 0 && defects[i + 1] < height)
+				arv_pixel_correction_add_defect (correction, defects[i], defects[i + 1]);
+			else
+				arv_warning_misc ("[PixelCorrection::new_from_file] Ignore defect (%d, %d) "
+						  "outside of the sensor", defects[i], defects[i + 1]);
+		}
+		g_free (defects);
+
+		arv_info_misc ("[PixelCorrection::new_from_file] Loaded '%s' (%dx%d, %u defects)",
+			       filename, width, height, arv_pixel_correction_get_n_defects (correction));
+	}
+
+	g_free (directory);
+	g_key_file_unref (key_file);
+
+	return correction;
+}
+
+/**
+ * arv_pixel_correction_new_for_serial:
+ * @directory: (nullable): directory of the correction files, %NULL for the default one
+ * @serial_number: camera serial number
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Loads the correction of a camera from the `serial_number.correction` file of @directory. The default directory
+ * is `$XDG_CONFIG_HOME/aravis/pixel-correction`, which can be changed using the `ARV_PIXEL_CORRECTION_DIR`
+ * environment variable.
+ *
+ * Returns: (transfer full): a new #ArvPixelCorrection, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvPixelCorrection *
+arv_pixel_correction_new_for_serial (const char *directory, const char *serial_number, GError **error)
+{
+	ArvPixelCorrection *correction;
+	char *default_directory = NULL;
+	char *basename;
+	char *filename;
+
+	g_return_val_if_fail (serial_number != NULL && serial_number[0] != '\0', NULL);
+
+	if (directory == NULL) {
+		const char *env = g_getenv ("ARV_PIXEL_CORRECTION_DIR");
+
+		default_directory = env != NULL ?
+			g_strdup (env) :
+			g_build_filename (g_get_user_config_dir (), "aravis", "pixel-correction", NULL);
+		directory = default_directory;
+	}
+
+	basename = g_strconcat (serial_number, ARV_PIXEL_CORRECTION_FILE_EXTENSION, NULL);
+	filename = g_build_filename (directory, basename, NULL);
+
+	correction = arv_pixel_correction_new_from_file (filename, error);
+
+	g_free (filename);
+	g_free (basename);
+	g_free (default_directory);
+
+	return correction;
+}
+
+static gboolean
+_ensure_maps (ArvPixelCorrection *correction, size_t n_pixels, GError **error)
+{
+	ArvPixelCorrectionPrivate *priv = correction->priv;
+	size_t n_sensor_pixels = (size_t) priv->width * priv->height;
+	size_t i;
+
+	if (n_pixels != n_sensor_pixels) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_INVALID_MAP,
+			     "Map of %zu pixels instead of %ux%u", n_pixels, priv->width, priv->height);
+		return FALSE;
+	}
+
+	if (priv->gain == NULL) {
+		priv->gain = g_new (float, n_sensor_pixels);
+		priv->offset = g_new0 (float, n_sensor_pixels);
+		for (i = 0; i < n_sensor_pixels; i++)
+			priv->gain[i] = 1.0f;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_pixel_correction_set_gain_map:
+ * @correction: a #ArvPixelCorrection
+ * @gain: (array length=n_pixels): gain of each sensor pixel, row by row
+ * @n_pixels: number of values in @gain, sensor width * sensor height
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sets the gain map of the flat field correction. The gains default to 1.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_pixel_correction_set_gain_map (ArvPixelCorrection *correction, const float *gain, size_t n_pixels,
+				   GError **error)
+{
+	g_return_val_if_fail (ARV_IS_PIXEL_CORRECTION (correction), FALSE);
+	g_return_val_if_fail (gain != NULL, FALSE);
+
+	if (!_ensure_maps (correction, n_pixels, error))
+		return FALSE;
+
+	memcpy (correction->priv->gain, gain, n_pixels * sizeof (float));
+
+	return TRUE;
+}
+
+/**
+ * arv_pixel_correction_set_offset_map:
+ * @correction: a #ArvPixelCorrection
+ * @offset: (array length=n_pixels): offset of each sensor pixel, row by row, in pixel value units
+ * @n_pixels: number of values in @offset, sensor width * sensor height
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sets the offset map of the flat field correction, subtracted before the gain is applied. The offsets default to 0.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_pixel_correction_set_offset_map (ArvPixelCorrection *correction, const float *offset, size_t n_pixels,
+				     GError **error)
+{
+	g_return_val_if_fail (ARV_IS_PIXEL_CORRECTION (correction), FALSE);
+	g_return_val_if_fail (offset != NULL, FALSE);
+
+	if (!_ensure_maps (correction, n_pixels, error))
+		return FALSE;
+
+	memcpy (correction->priv->offset, offset, n_pixels * sizeof (float));
+
+	return TRUE;
+}
+
+/**
+ * arv_pixel_correction_add_defect:
+ * @correction: a #ArvPixelCorrection
+ * @x: defective pixel x position, in sensor coordinates
+ * @y: defective pixel y position, in sensor coordinates
+ *
+ * Adds a defective pixel, replaced by the mean of its neighbours.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_pixel_correction_add_defect (ArvPixelCorrection *correction, guint x, guint y)
+{
+	ArvPixelCorrectionPrivate *priv;
+	ArvPixelCorrectionDefect defect = {x, y};
+	size_t index;
+
+	g_return_if_fail (ARV_IS_PIXEL_CORRECTION (correction));
+	g_return_if_fail (x < correction->priv->width && y < correction->priv->height);
+
+	priv = correction->priv;
+
+	if (priv->defect_mask == NULL)
+		priv->defect_mask = g_malloc0 (((size_t) priv->width * priv->height + 7) / 8);
+
+	if (_is_defective (priv, x, y))
+		return;
+
+	index = (size_t) y * priv->width + x;
+	priv->defect_mask[index / 8] |= 1 << (index % 8);
+	g_array_append_val (priv->defects, defect);
+}
+
+/**
+ * arv_pixel_correction_get_n_defects:
+ * @correction: a #ArvPixelCorrection
+ *
+ * Returns: the number of defective pixels.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_pixel_correction_get_n_defects (ArvPixelCorrection *correction)
+{
+	g_return_val_if_fail (ARV_IS_PIXEL_CORRECTION (correction), 0);
+
+	return correction->priv->defects->len;
+}
+
+/**
+ * arv_pixel_correction_apply:
+ * @correction: a #ArvPixelCorrection
+ * @buffer: a #ArvBuffer with an image payload
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Corrects the image of @buffer in place.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_pixel_correction_apply (ArvPixelCorrection *correction, ArvBuffer *buffer, GError **error)
+{
+	ArvPixelCorrectionPrivate *priv;
+	const ArvPixelCorrectionFormat *format;
+	guint bytes_per_pixel;
+	size_t stride;
+	guint8 *data;
+	float max_value;
+	guint x_offset, y_offset, width, height;
+	guint step;
+	guint i, y;
+
+	g_return_val_if_fail (ARV_IS_PIXEL_CORRECTION (correction), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	priv = correction->priv;
+
+	format = _find_format (buffer->priv->pixel_format);
+	if (!arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) || format == NULL) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_UNSUPPORTED_FORMAT,
+			     "Unsupported pixel format 0x%08x", buffer->priv->pixel_format);
+		return FALSE;
+	}
+
+	x_offset = buffer->priv->x_offset;
+	y_offset = buffer->priv->y_offset;
+	width = buffer->priv->width;
+	height = buffer->priv->height;
+	if (x_offset > priv->width || width > priv->width - x_offset ||
+	    y_offset > priv->height || height > priv->height - y_offset) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_INVALID_REGION,
+			     "Image region (%u, %u, %u, %u) outside of the %ux%u sensor",
+			     x_offset, y_offset, width, height, priv->width, priv->height);
+		return FALSE;
+	}
+
+	bytes_per_pixel = format->n_bits > 8 ? 2 : 1;
+	stride = (size_t) width * bytes_per_pixel + buffer->priv->x_padding;
+	data = buffer->priv->data;
+	if (data == NULL || height == 0 ||
+	    buffer->priv->received_size < stride * (height - 1) + width * bytes_per_pixel) {
+		g_set_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_INVALID_REGION,
+			     "Incomplete image data (%zu bytes)", buffer->priv->received_size);
+		return FALSE;
+	}
+
+	if (priv->gain != NULL) {
+		max_value = (1U << format->n_bits) - 1;
+
+		for (y = 0; y < height; y++) {
+			size_t map_offset = (size_t) (y + y_offset) * priv->width + x_offset;
+
+			if (bytes_per_pixel == 2)
+				_correct_row_16 ((guint16 *) (data + y * stride), width,
+						 priv->gain + map_offset, priv->offset + map_offset, max_value);
+			else
+				_correct_row_8 (data + y * stride, width,
+						priv->gain + map_offset, priv->offset + map_offset, max_value);
+		}
+	}
+
+	step = format->is_bayer ? 2 : 1;
+	for (i = 0; i < priv->defects->len; i++) {
+		ArvPixelCorrectionDefect *defect = &g_array_index (priv->defects, ArvPixelCorrectionDefect, i);
+		guint x, value;
+
+		if (defect->x < x_offset || defect->x - x_offset >= width ||
+		    defect->y < y_offset || defect->y - y_offset >= height)
+			continue;
+
+		x = defect->x - x_offset;
+		y = defect->y - y_offset;
+		value = _interpolate_defect (priv, data, stride, bytes_per_pixel, x, y, width, height,
+					     x_offset, y_offset, step);
+		if (bytes_per_pixel == 2)
+			*((guint16 *) (data + y * stride + x * 2)) = value;
+		else
+			data[y * stride + x] = value;
+	}
+
+	return TRUE;
+}
+
+static void
+arv_pixel_correction_init (ArvPixelCorrection *correction)
+{
+	correction->priv = arv_pixel_correction_get_instance_private (correction);
+
+	correction->priv->defects = g_array_new (FALSE, FALSE, sizeof (ArvPixelCorrectionDefect));
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvPixelCorrection *correction = ARV_PIXEL_CORRECTION (object);
+
+	g_clear_pointer (&correction->priv->gain, g_free);
+	g_clear_pointer (&correction->priv->offset, g_free);
+	g_clear_pointer (&correction->priv->defect_mask, g_free);
+	g_clear_pointer (&correction->priv->defects, g_array_unref);
+
+	G_OBJECT_CLASS (arv_pixel_correction_parent_class)->finalize (object);
+}
+
+static void
+arv_pixel_correction_class_init (ArvPixelCorrectionClass *correction_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (correction_class);
+
+	object_class->finalize = _finalize;
+}
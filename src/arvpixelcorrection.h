@@ -0,0 +1,80 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_PIXEL_CORRECTION_H
+#define ARV_PIXEL_CORRECTION_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+#define ARV_PIXEL_CORRECTION_ERROR arv_pixel_correction_error_quark()
+
+ARV_API GQuark		arv_pixel_correction_error_quark		(void);
+
+/**
+ * ArvPixelCorrectionError:
+ * @ARV_PIXEL_CORRECTION_ERROR_FILE: the correction file can not be read
+ * @ARV_PIXEL_CORRECTION_ERROR_INVALID_MAP: a correction map doesn't match the sensor size
+ * @ARV_PIXEL_CORRECTION_ERROR_UNSUPPORTED_FORMAT: the buffer pixel format can not be corrected
+ * @ARV_PIXEL_CORRECTION_ERROR_INVALID_REGION: the buffer image is outside of the correction maps
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_PIXEL_CORRECTION_ERROR_FILE,
+	ARV_PIXEL_CORRECTION_ERROR_INVALID_MAP,
+	ARV_PIXEL_CORRECTION_ERROR_UNSUPPORTED_FORMAT,
+	ARV_PIXEL_CORRECTION_ERROR_INVALID_REGION
+} ArvPixelCorrectionError;
+
+#define ARV_TYPE_PIXEL_CORRECTION             (arv_pixel_correction_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvPixelCorrection, arv_pixel_correction, ARV, PIXEL_CORRECTION, GObject)
+
+ARV_API ArvPixelCorrection *	arv_pixel_correction_new		(guint width, guint height);
+ARV_API ArvPixelCorrection *	arv_pixel_correction_new_from_file	(const char *filename, GError **error);
+ARV_API ArvPixelCorrection *	arv_pixel_correction_new_for_serial	(const char *directory,
+									 const char *serial_number, GError **error);
+
+ARV_API gboolean		arv_pixel_correction_set_gain_map	(ArvPixelCorrection *correction,
+									 const float *gain, size_t n_pixels,
+									 GError **error);
+ARV_API gboolean		arv_pixel_correction_set_offset_map	(ArvPixelCorrection *correction,
+									 const float *offset, size_t n_pixels,
+									 GError **error);
+ARV_API void			arv_pixel_correction_add_defect		(ArvPixelCorrection *correction,
+									 guint x, guint y);
+ARV_API guint			arv_pixel_correction_get_n_defects	(ArvPixelCorrection *correction);
+
+ARV_API gboolean		arv_pixel_correction_apply		(ArvPixelCorrection *correction,
+									 ArvBuffer *buffer, GError **error);
+
+G_END_DECLS
+
+#endif
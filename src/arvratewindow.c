@@ -0,0 +1,235 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/*
+ * ArvRateWindow turns cumulative counters into rates over sliding windows of a few seconds to a minute. The writer,
+ * typically a stream thread, calls arv_rate_window_update() as often as it likes, with the current time. The counters
+ * are only sampled once per ARV_RATE_WINDOW_INTERVAL_US, the other calls returning after a single comparison. The
+ * samples are kept in a ring, from which the readers compute the rates without disturbing the writer more than the
+ * time of a short critical section.
+ *
+ * The writer may stop updating the window, for example when the stream is interrupted. In this case the counters are
+ * assumed unchanged since the last sample, and the rates decrease as the windows move past it.
+ */
+
+#include <arvratewindowprivate.h>
+
+#define ARV_RATE_WINDOW_INTERVAL_US	1000000
+#define ARV_RATE_WINDOW_N_SAMPLES	64
+
+struct _ArvRateWindow {
+	guint n_counters;
+	char **names;
+	const guint64 **counters;
+
+	/* Time of the next sample, only used by the writer */
+	guint64 next_sample_us;
+
+	/* Sample ring, n_counters values per sample, protected by mutex */
+	GMutex mutex;
+	guint64 times_us[ARV_RATE_WINDOW_N_SAMPLES];
+	guint64 *values;
+	guint n_samples;
+	guint last_sample;
+
+	gint ref_count;
+};
+
+/**
+ * arv_rate_window_new:
+ * @n_counters: number of counters
+ *
+ * Returns: a new #ArvRateWindow
+ */
+
+ArvRateWindow *
+arv_rate_window_new (guint n_counters)
+{
+	ArvRateWindow *window;
+	guint i;
+
+	g_return_val_if_fail (n_counters > 0, NULL);
+
+	window = g_new0 (ArvRateWindow, 1);
+	window->ref_count = 1;
+	window->n_counters = n_counters;
+	window->names = g_new0 (char *, n_counters + 1);
+	for (i = 0; i < n_counters; i++)
+		window->names[i] = g_strdup_printf ("counter%u", i);
+	window->counters = g_new0 (const guint64 *, n_counters);
+	window->values = g_new0 (guint64, ARV_RATE_WINDOW_N_SAMPLES * n_counters);
+	g_mutex_init (&window->mutex);
+
+	return window;
+}
+
+ArvRateWindow *
+arv_rate_window_ref (ArvRateWindow *window)
+{
+	g_return_val_if_fail (window != NULL, NULL);
+
+	g_atomic_int_inc (&window->ref_count);
+
+	return window;
+}
+
+void
+arv_rate_window_unref (ArvRateWindow *window)
+{
+	g_return_if_fail (window != NULL);
+
+	if (g_atomic_int_dec_and_test (&window->ref_count)) {
+		g_mutex_clear (&window->mutex);
+		g_strfreev (window->names);
+		g_free (window->counters);
+		g_free (window->values);
+		g_free (window);
+	}
+}
+
+/**
+ * arv_rate_window_set_counter:
+ * @window: a #ArvRateWindow
+ * @id: counter id
+ * @name: counter name
+ * @counter: cumulative counter, only read by the writer
+ *
+ * Must be called before the first update.
+ */
+
+void
+arv_rate_window_set_counter (ArvRateWindow *window, guint id, const char *name, const guint64 *counter)
+{
+	g_return_if_fail (window != NULL);
+	g_return_if_fail (id < window->n_counters);
+	g_return_if_fail (name != NULL);
+
+	g_free (window->names[id]);
+	window->names[id] = g_strdup (name);
+	window->counters[id] = counter;
+}
+
+guint
+arv_rate_window_get_n_counters (ArvRateWindow *window)
+{
+	g_return_val_if_fail (window != NULL, 0);
+
+	return window->n_counters;
+}
+
+const char *
+arv_rate_window_get_counter_name (ArvRateWindow *window, guint id)
+{
+	g_return_val_if_fail (window != NULL, NULL);
+	g_return_val_if_fail (id < window->n_counters, NULL);
+
+	return window->names[id];
+}
+
+/**
+ * arv_rate_window_update:
+ * @window: a #ArvRateWindow
+ * @time_us: current monotonic time, in µs
+ *
+ * Samples the counters if the last sample is older than a second. Must only be called by the writer.
+ */
+
+void
+arv_rate_window_update (ArvRateWindow *window, guint64 time_us)
+{
+	guint64 *values;
+	guint i;
+
+	if (G_LIKELY (time_us < window->next_sample_us))
+		return;
+
+	window->next_sample_us = time_us + ARV_RATE_WINDOW_INTERVAL_US;
+
+	g_mutex_lock (&window->mutex);
+
+	window->last_sample = (window->last_sample + 1) % ARV_RATE_WINDOW_N_SAMPLES;
+	window->n_samples = MIN (window->n_samples + 1, ARV_RATE_WINDOW_N_SAMPLES);
+	window->times_us[window->last_sample] = time_us;
+
+	values = &window->values[window->last_sample * window->n_counters];
+	for (i = 0; i < window->n_counters; i++)
+		values[i] = window->counters[i] != NULL ? *window->counters[i] : 0;
+
+	g_mutex_unlock (&window->mutex);
+}
+
+/**
+ * arv_rate_window_get_rate:
+ * @window: a #ArvRateWindow
+ * @id: counter id
+ * @duration_s: window duration, in s, up to a minute
+ * @time_us: current monotonic time, in µs
+ *
+ * Returns: the mean rate of the counter over the last @duration_s seconds, in counts per second, or over the
+ * available history if shorter. 0 before the second sample.
+ */
+
+double
+arv_rate_window_get_rate (ArvRateWindow *window, guint id, guint duration_s, guint64 time_us)
+{
+	guint64 end_us, start_us;
+	guint64 end_value, start_value;
+	guint sample;
+	guint i;
+
+	g_return_val_if_fail (window != NULL, 0.0);
+	g_return_val_if_fail (id < window->n_counters, 0.0);
+
+	g_mutex_lock (&window->mutex);
+
+	if (window->n_samples == 0) {
+		g_mutex_unlock (&window->mutex);
+		return 0.0;
+	}
+
+	end_us = window->times_us[window->last_sample];
+	end_value = window->values[window->last_sample * window->n_counters + id];
+
+	/* Without a recent sample, the counters are assumed unchanged since the last one */
+	if (time_us > end_us + 2 * ARV_RATE_WINDOW_INTERVAL_US)
+		end_us = time_us;
+
+	/* Most recent sample at least @duration_s older than the end, or the oldest one. The last sample is a candidate
+	 * when the end was moved past it. */
+	sample = window->last_sample;
+	for (i = end_us > window->times_us[window->last_sample] ? 0 : 1; i < window->n_samples; i++) {
+		sample = (window->last_sample + ARV_RATE_WINDOW_N_SAMPLES - i) % ARV_RATE_WINDOW_N_SAMPLES;
+		if (window->times_us[sample] + (guint64) duration_s * 1000000 <= end_us)
+			break;
+	}
+
+	start_us = window->times_us[sample];
+	start_value = window->values[sample * window->n_counters + id];
+
+	g_mutex_unlock (&window->mutex);
+
+	if (end_us <= start_us)
+		return 0.0;
+
+	return (double) (end_value - start_value) * 1e6 / (double) (end_us - start_us);
+}
@@ -0,0 +1,50 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef ARV_RATE_WINDOW_PRIVATE_H
+#define ARV_RATE_WINDOW_PRIVATE_H
+
+#include <arvapi.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvRateWindow ArvRateWindow;
+
+/* private, but used by tests */
+ARV_API ArvRateWindow *	arv_rate_window_new			(guint n_counters);
+ARV_API ArvRateWindow *	arv_rate_window_ref			(ArvRateWindow *window);
+ARV_API void		arv_rate_window_unref			(ArvRateWindow *window);
+
+ARV_API void		arv_rate_window_set_counter		(ArvRateWindow *window, guint id, const char *name,
+								 const guint64 *counter);
+ARV_API guint		arv_rate_window_get_n_counters		(ArvRateWindow *window);
+ARV_API const char *	arv_rate_window_get_counter_name	(ArvRateWindow *window, guint id);
+
+ARV_API void		arv_rate_window_update			(ArvRateWindow *window, guint64 time_us);
+ARV_API double		arv_rate_window_get_rate		(ArvRateWindow *window, guint id, guint duration_s,
+								 guint64 time_us);
+
+G_END_DECLS
+
+#endif
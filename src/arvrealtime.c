@@ -27,6 +27,10 @@
 
 */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for sched_setaffinity */
+#endif
+
 #include <arvrealtimeprivate.h>
 #include <arvdebugprivate.h>
 #include <memory.h>
@@ -372,3 +376,496 @@ arv_make_thread_high_priority (int nice_level)
 	return FALSE;
 }
 #endif
+
+/* CPU affinity and NUMA placement */
+
+#define ARV_REALTIME_MAX_CPUS	1024
+
+/* From linux/mempolicy.h */
+#define ARV_REALTIME_MPOL_PREFERRED	1
+
+/**
+ * arv_parse_cpu_list:
+ * @cpu_list: a CPU list, like "0-3,8"
+ *
+ * Parses a list of comma separated CPU indices or ranges, using the same syntax as the Linux cpuset lists.
+ *
+ * Returns: (transfer full): an array of guint CPU indices, %NULL if @cpu_list is invalid.
+ */
+
+GArray *
+arv_parse_cpu_list (const char *cpu_list)
+{
+	GArray *cpus;
+	char **ranges;
+	guint i;
+
+	g_return_val_if_fail (cpu_list != NULL, NULL);
+
+	cpus = g_array_new (FALSE, FALSE, sizeof (guint));
+	ranges = g_strsplit (cpu_list, ",", -1);
+
+	for (i = 0; ranges[i] != NULL; i++) {
+		char *range = g_strstrip (ranges[i]);
+		char *end;
+		guint64 first, last, cpu;
+
+		if (*range == '\0')
+			continue;
+
+		if (!g_ascii_isdigit (*range))
+			goto error;
+
+		first = g_ascii_strtoull (range, &end, 10);
+		last = first;
+		if (*end == '-') {
+			if (!g_ascii_isdigit (end[1]))
+				goto error;
+			last = g_ascii_strtoull (end + 1, &end, 10);
+		}
+
+		if (*end != '\0' || last < first || last >= ARV_REALTIME_MAX_CPUS)
+			goto error;
+
+		for (cpu = first; cpu <= last; cpu++) {
+			guint index = cpu;
+
+			g_array_append_val (cpus, index);
+		}
+	}
+
+	g_strfreev (ranges);
+
+	return cpus;
+
+error:
+	g_strfreev (ranges);
+	g_array_unref (cpus);
+
+	return NULL;
+}
+
+#if defined(__linux__)
+
+/**
+ * arv_set_thread_cpu_affinity:
+ * @cpu_list: a CPU list, like "0-3,8"
+ *
+ * Restricts the current thread to the CPUs of @cpu_list, which is a list of comma separated CPU indices or
+ * ranges.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_set_thread_cpu_affinity (const char *cpu_list)
+{
+	cpu_set_t cpu_set;
+	GArray *cpus;
+	guint i;
+
+	g_return_val_if_fail (cpu_list != NULL, FALSE);
+
+	cpus = arv_parse_cpu_list (cpu_list);
+	if (cpus == NULL || cpus->len == 0) {
+		arv_warning_misc ("Invalid CPU list '%s'", cpu_list);
+		if (cpus != NULL)
+			g_array_unref (cpus);
+		return FALSE;
+	}
+
+	CPU_ZERO (&cpu_set);
+	for (i = 0; i < cpus->len; i++)
+		if (g_array_index (cpus, guint, i) < CPU_SETSIZE)
+			CPU_SET (g_array_index (cpus, guint, i), &cpu_set);
+
+	g_array_unref (cpus);
+
+	if (sched_setaffinity (0, sizeof (cpu_set), &cpu_set) != 0) {
+		arv_warning_misc ("Failed to set thread CPU affinity to '%s': %s", cpu_list, strerror (errno));
+		return FALSE;
+	}
+
+	arv_info_misc ("Thread CPU affinity set to '%s'", cpu_list);
+
+	return TRUE;
+}
+
+/**
+ * arv_set_thread_numa_node:
+ * @numa_node: a NUMA node index
+ *
+ * Restricts the current thread to the CPUs of @numa_node, and makes the memory allocated by the thread come
+ * preferably from this node.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_set_thread_numa_node (int numa_node)
+{
+	unsigned long node_mask;
+	char *filename;
+	char *cpu_list = NULL;
+	gboolean success;
+
+	if (numa_node < 0 || numa_node >= (int) (8 * sizeof (node_mask))) {
+		arv_warning_misc ("Invalid NUMA node %d", numa_node);
+		return FALSE;
+	}
+
+	filename = g_strdup_printf ("/sys/devices/system/node/node%d/cpulist", numa_node);
+	success = g_file_get_contents (filename, &cpu_list, NULL, NULL);
+	g_free (filename);
+
+	if (!success) {
+		arv_warning_misc ("Unknown NUMA node %d", numa_node);
+		return FALSE;
+	}
+
+	success = arv_set_thread_cpu_affinity (g_strstrip (cpu_list));
+	g_free (cpu_list);
+
+	node_mask = 1UL << numa_node;
+	if (syscall (SYS_set_mempolicy, ARV_REALTIME_MPOL_PREFERRED, &node_mask, 8 * sizeof (node_mask) + 1) != 0) {
+		arv_warning_misc ("Failed to set thread memory policy to NUMA node %d: %s", numa_node, strerror (errno));
+		return FALSE;
+	}
+
+	arv_info_misc ("Thread memory policy set to NUMA node %d", numa_node);
+
+	return success;
+}
+
+#elif defined(G_OS_WIN32)
+
+gboolean
+arv_set_thread_cpu_affinity (const char *cpu_list)
+{
+	DWORD_PTR mask = 0;
+	GArray *cpus;
+	guint i;
+
+	g_return_val_if_fail (cpu_list != NULL, FALSE);
+
+	cpus = arv_parse_cpu_list (cpu_list);
+	if (cpus == NULL) {
+		arv_warning_misc ("Invalid CPU list '%s'", cpu_list);
+		return FALSE;
+	}
+
+	for (i = 0; i < cpus->len; i++)
+		if (g_array_index (cpus, guint, i) < 8 * sizeof (mask))
+			mask |= ((DWORD_PTR) 1) << g_array_index (cpus, guint, i);
+
+	g_array_unref (cpus);
+
+	if (mask == 0 || SetThreadAffinityMask (GetCurrentThread (), mask) == 0) {
+		arv_warning_misc ("Failed to set thread CPU affinity to '%s'", cpu_list);
+		return FALSE;
+	}
+
+	arv_info_misc ("Thread CPU affinity set to '%s'", cpu_list);
+
+	return TRUE;
+}
+
+gboolean
+arv_set_thread_numa_node (int numa_node)
+{
+	arv_info_misc ("NUMA placement not supported on Windows");
+
+	return FALSE;
+}
+
+#else
+
+gboolean
+arv_set_thread_cpu_affinity (const char *cpu_list)
+{
+	arv_info_misc ("Thread CPU affinity not supported on this platform");
+
+	return FALSE;
+}
+
+gboolean
+arv_set_thread_numa_node (int numa_node)
+{
+	arv_info_misc ("NUMA placement not supported on this platform");
+
+	return FALSE;
+}
+
+#endif
+
+/* Deadline scheduling and CPU isolation */
+
+#define ARV_REALTIME_DEADLINE_MIN_RUNTIME_NS	1024
+
+/**
+ * arv_compute_deadline_parameters:
+ * @frame_rate: frame rate, in Hz
+ * @budget_us: CPU time needed per frame, in µs
+ * @runtime_ns: (out): runtime
+ * @deadline_ns: (out): relative deadline
+ * @period_ns: (out): period
+ *
+ * Computes the SCHED_DEADLINE parameters of a stream thread, with a period of one frame, an implicit deadline at the
+ * end of the period, and a runtime of @budget_us.
+ *
+ * Returns: %TRUE if the budget fits in the frame period.
+ */
+
+gboolean
+arv_compute_deadline_parameters (double frame_rate, guint64 budget_us,
+				 guint64 *runtime_ns, guint64 *deadline_ns, guint64 *period_ns)
+{
+	double period;
+	guint64 runtime;
+
+	if (!(frame_rate > 0.0))
+		return FALSE;
+
+	period = 1e9 / frame_rate;
+	if (period > (double) G_MAXINT64)
+		return FALSE;
+
+	if (budget_us > G_MAXUINT64 / 1000)
+		return FALSE;
+
+	runtime = MAX (budget_us * 1000, ARV_REALTIME_DEADLINE_MIN_RUNTIME_NS);
+	if ((double) runtime > period)
+		return FALSE;
+
+	if (runtime_ns != NULL)
+		*runtime_ns = runtime;
+	if (deadline_ns != NULL)
+		*deadline_ns = (guint64) period;
+	if (period_ns != NULL)
+		*period_ns = (guint64) period;
+
+	return TRUE;
+}
+
+#if defined(__linux__)
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+/* From linux/sched/types.h, not exposed by the libc */
+typedef struct {
+	guint32 size;
+	guint32 sched_policy;
+	guint64 sched_flags;
+	gint32 sched_nice;
+	guint32 sched_priority;
+	guint64 sched_runtime;
+	guint64 sched_deadline;
+	guint64 sched_period;
+} ArvSchedAttr;
+
+/**
+ * arv_make_thread_deadline:
+ * @frame_rate: frame rate of the stream, in Hz
+ * @budget_us: CPU time needed by the thread per frame, in µs
+ *
+ * Schedules the current thread with the SCHED_DEADLINE policy, with a runtime of @budget_us every frame period. The
+ * kernel guarantees this CPU time per period, whatever the load of the other threads, as long as the admission
+ * control accepts the reservation. It needs the CAP_SYS_NICE capability, and a CPU affinity spanning a whole root
+ * domain, which means the thread should be placed on dedicated cores using an exclusive cpuset partition, instead of
+ * arv_set_thread_cpu_affinity().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_make_thread_deadline (double frame_rate, guint64 budget_us)
+{
+	ArvSchedAttr attr;
+	guint64 runtime_ns, deadline_ns, period_ns;
+
+	if (!arv_compute_deadline_parameters (frame_rate, budget_us, &runtime_ns, &deadline_ns, &period_ns)) {
+		arv_warning_misc ("Invalid SCHED_DEADLINE parameters: a budget of %" G_GUINT64_FORMAT " µs per frame "
+				  "at %g Hz", budget_us, frame_rate);
+		return FALSE;
+	}
+
+#ifdef SYS_sched_setattr
+	memset (&attr, 0, sizeof (attr));
+	attr.size = sizeof (attr);
+	attr.sched_policy = SCHED_DEADLINE;
+	attr.sched_runtime = runtime_ns;
+	attr.sched_deadline = deadline_ns;
+	attr.sched_period = period_ns;
+
+	if (syscall (SYS_sched_setattr, 0, &attr, 0) != 0) {
+		switch (errno) {
+			case EPERM:
+				arv_warning_misc ("Failed to set SCHED_DEADLINE: permission denied. It needs the "
+						  "CAP_SYS_NICE capability, and a CPU affinity spanning the whole root "
+						  "domain: use an exclusive cpuset partition for the dedicated cores, "
+						  "instead of a thread CPU affinity");
+				break;
+			case EBUSY:
+				arv_warning_misc ("Failed to set SCHED_DEADLINE: %.1f%% of a CPU refused by the admission "
+						  "control. Check the reservations of the other deadline threads, and "
+						  "the kernel.sched_rt_runtime_us limit",
+						  100.0 * runtime_ns / period_ns);
+				break;
+			default:
+				arv_warning_misc ("Failed to set SCHED_DEADLINE: %s", strerror (errno));
+				break;
+		}
+		return FALSE;
+	}
+
+	arv_info_misc ("Thread scheduled with SCHED_DEADLINE, runtime %" G_GUINT64_FORMAT " µs every %"
+		       G_GUINT64_FORMAT " µs", runtime_ns / 1000, period_ns / 1000);
+
+	return TRUE;
+#else
+	arv_info_misc ("SCHED_DEADLINE not supported by the system headers");
+
+	return FALSE;
+#endif
+}
+
+static gboolean
+_is_cpu_in_list_file (const char *filename, guint cpu)
+{
+	GArray *cpus;
+	char *cpu_list = NULL;
+	gboolean found = FALSE;
+	guint i;
+
+	if (!g_file_get_contents (filename, &cpu_list, NULL, NULL))
+		return FALSE;
+
+	/* Lists may be empty, or "(null)" for nohz_full without the kernel parameter */
+	cpus = arv_parse_cpu_list (g_strstrip (cpu_list));
+	g_free (cpu_list);
+
+	if (cpus == NULL)
+		return FALSE;
+
+	for (i = 0; i < cpus->len && !found; i++)
+		found = g_array_index (cpus, guint, i) == cpu;
+
+	g_array_unref (cpus);
+
+	return found;
+}
+
+/* Partition type of the cgroup v2 cpuset of the current thread, NULL if unknown */
+
+static char *
+_get_cpuset_partition (void)
+{
+	char *cpuset = NULL;
+	char *filename;
+	char *partition = NULL;
+
+	if (!g_file_get_contents ("/proc/thread-self/cpuset", &cpuset, NULL, NULL))
+		return NULL;
+
+	filename = g_strdup_printf ("/sys/fs/cgroup%s/cpuset.cpus.partition", g_strstrip (cpuset));
+	if (g_file_get_contents (filename, &partition, NULL, NULL))
+		g_strstrip (partition);
+
+	g_free (filename);
+	g_free (cpuset);
+
+	return partition;
+}
+
+/**
+ * arv_check_thread_cpu_isolation:
+ *
+ * Checks the isolation of the CPUs the current thread is pinned to, for a deterministic packet reception. Each CPU
+ * should be removed from the general scheduling, using the isolcpus kernel parameter or an isolated cpuset
+ * partition, and should run without scheduler tick, using the nohz_full kernel parameter. A warning is emitted for
+ * each missing setting, with the way to fix it.
+ *
+ * Returns: %TRUE if the thread is pinned to isolated CPUs.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_check_thread_cpu_isolation (void)
+{
+	cpu_set_t cpu_set;
+	char *partition;
+	gboolean is_partition_isolated;
+	gboolean success = TRUE;
+	long n_cpus;
+	guint cpu;
+
+	if (sched_getaffinity (0, sizeof (cpu_set), &cpu_set) != 0) {
+		arv_warning_misc ("Failed to get thread CPU affinity: %s", strerror (errno));
+		return FALSE;
+	}
+
+	n_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+	if (n_cpus > 1 && CPU_COUNT (&cpu_set) >= n_cpus) {
+		arv_warning_misc ("Thread is not pinned to dedicated CPUs: set the stream cpu-affinity property, or "
+				  "move the process to a dedicated cpuset");
+		return FALSE;
+	}
+
+	partition = _get_cpuset_partition ();
+	is_partition_isolated = g_strcmp0 (partition, "isolated") == 0;
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET (cpu, &cpu_set))
+			continue;
+
+		if (!is_partition_isolated &&
+		    !_is_cpu_in_list_file ("/sys/devices/system/cpu/isolated", cpu)) {
+			arv_warning_misc ("CPU %u is not isolated from the general scheduling: add it to the isolcpus "
+					  "kernel parameter, or use an isolated cpuset partition (current partition: "
+					  "%s)", cpu, partition != NULL ? partition : "unknown");
+			success = FALSE;
+		}
+
+		if (!_is_cpu_in_list_file ("/sys/devices/system/cpu/nohz_full", cpu)) {
+			arv_warning_misc ("CPU %u still runs the scheduler tick: add it to the nohz_full and rcu_nocbs "
+					  "kernel parameters", cpu);
+			success = FALSE;
+		}
+	}
+
+	g_free (partition);
+
+	if (success)
+		arv_info_misc ("Thread is pinned to isolated CPUs");
+
+	return success;
+}
+
+#else
+
+gboolean
+arv_make_thread_deadline (double frame_rate, guint64 budget_us)
+{
+	arv_info_misc ("SCHED_DEADLINE not supported on this platform");
+
+	return FALSE;
+}
+
+gboolean
+arv_check_thread_cpu_isolation (void)
+{
+	arv_info_misc ("CPU isolation check not supported on this platform");
+
+	return FALSE;
+}
+
+#endif
@@ -34,6 +34,10 @@ G_BEGIN_DECLS
 
 ARV_API gboolean	arv_make_thread_realtime 		(int priority);
 ARV_API gboolean	arv_make_thread_high_priority 		(int nice_level);
+ARV_API gboolean	arv_set_thread_cpu_affinity		(const char *cpu_list);
+ARV_API gboolean	arv_set_thread_numa_node		(int numa_node);
+ARV_API gboolean	arv_make_thread_deadline		(double frame_rate, guint64 budget_us);
+ARV_API gboolean	arv_check_thread_cpu_isolation		(void);
 
 G_END_DECLS
 
@@ -26,6 +26,13 @@
 #include <arvrealtime.h>
 #include <gio/gio.h>
 
+/* private, but used by tests */
+ARV_API GArray *	arv_parse_cpu_list			(const char *cpu_list);
+/* private, but used by tests */
+ARV_API gboolean	arv_compute_deadline_parameters		(double frame_rate, guint64 budget_us,
+								 guint64 *runtime_ns, guint64 *deadline_ns,
+								 guint64 *period_ns);
+
 #ifndef G_OS_WIN32
 
 #include <unistd.h> /* for pid_t */
@@ -0,0 +1,803 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/**
+ * ArvRecorder:
+ *
+ * [class@ArvRecorder] writes the buffers of a [class@ArvStream] to a preallocated file, from a dedicated thread.
+ *
+ * The recorder pops the completed buffers from the stream output queue, writes their data and metadata, and pushes
+ * them back to the stream input queue once their write is finished. The application must not pop the buffers
+ * itself while a recorder is attached to the stream.
+ *
+ * The file is opened with O_DIRECT when the filesystem supports it, bypassing the page cache. When the buffer data is
+ * aligned on %ARV_RECORDER_BLOCK_SIZE, for example when allocated by an [class@ArvBufferPool] with this alignment, it
+ * is written without any copy. Otherwise it is first copied to an aligned staging area. The writes are queued using
+ * io_uring when available, or done synchronously using pwritev().
+ *
+ * The file starts with an [struct@ArvRecorderFileHeader] block, followed by the GenICam data of the device and a
+ * snapshot of its feature values, then one record per buffer. Each record is an [struct@ArvRecorderRecordHeader]
+ * block followed by the complete buffer data, chunks included, padded to the block size. The buffers compressed by
+ * a stream stage, see [method@ArvStream.add_compression_stage], are written compressed, which reduces the disk
+ * bandwidth needed by the high rate cameras. When the file is full, the
+ * following buffers are dropped. A frame table is appended to the records when the recorder is stopped, allowing
+ * random access to the frames using [class@ArvRecording].
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for O_DIRECT */
+#endif
+
+#include <arvrecorder.h>
+#include <arvbufferprivate.h>
+#include <arvdeviceprivate.h>
+#include <arvdebugprivate.h>
+#include <arvfeatures.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef G_OS_UNIX
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+#if ARAVIS_HAS_IO_URING
+#include <liburing.h>
+#endif
+
+#ifdef O_DIRECT
+#define ARV_RECORDER_O_DIRECT		O_DIRECT
+#else
+#define ARV_RECORDER_O_DIRECT		0
+#endif
+
+#define ARV_RECORDER_FILE_VERSION	2
+#define ARV_RECORDER_QUEUE_DEPTH	8
+#define ARV_RECORDER_POP_TIMEOUT_US	100000
+#define ARV_RECORDER_REAP_TIMEOUT_NS	1000000
+
+GQuark
+arv_recorder_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-recorder-error-quark");
+}
+
+#ifdef G_OS_UNIX
+
+/* A record write, with the aligned staging memory holding the record header and the unaligned part of the data */
+
+typedef struct {
+	ArvBuffer *buffer;
+
+	void *staging;
+	size_t staging_size;
+
+	struct iovec iov[3];
+	int n_iov;
+	guint64 offset;
+	size_t size;
+} ArvRecorderSlot;
+
+#endif
+
+typedef struct {
+	ArvStream *stream;
+
+#ifdef G_OS_UNIX
+	int fd;
+	gboolean is_direct;
+	guint64 file_size;
+
+	guint64 records_offset;
+	guint64 genicam_offset;
+	guint64 genicam_size;
+	guint64 features_offset;
+	guint64 features_size;
+	guint64 index_offset;
+
+	/* Writer thread only */
+	guint64 offset;
+	gboolean failed;
+	ArvRecorderSlot slots[ARV_RECORDER_QUEUE_DEPTH];
+	GArray *index;
+#endif
+
+	GThread *thread;
+	gint cancel;
+
+	GMutex mutex;
+	guint64 n_records;
+	guint64 n_dropped_buffers;
+	guint64 n_bytes;
+} ArvRecorderPrivate;
+
+struct _ArvRecorder {
+	GObject	object;
+
+	ArvRecorderPrivate *priv;
+};
+
+struct _ArvRecorderClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvRecorder, arv_recorder, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvRecorder))
+
+#ifdef G_OS_UNIX
+
+static size_t
+_round_up (size_t size)
+{
+	return (size + ARV_RECORDER_BLOCK_SIZE - 1) & ~((size_t) ARV_RECORDER_BLOCK_SIZE - 1);
+}
+
+static gboolean
+_ensure_staging (ArvRecorderSlot *slot, size_t size)
+{
+	if (slot->staging_size >= size)
+		return TRUE;
+
+	free (slot->staging);
+	slot->staging_size = 0;
+
+	if (posix_memalign (&slot->staging, ARV_RECORDER_BLOCK_SIZE, size) != 0) {
+		slot->staging = NULL;
+		return FALSE;
+	}
+
+	slot->staging_size = size;
+
+	return TRUE;
+}
+
+static gboolean
+_write_file_header (ArvRecorderPrivate *priv)
+{
+	ArvRecorderFileHeader *header;
+	ArvRecorderSlot *slot = &priv->slots[0];
+	ssize_t n_written;
+
+	if (!_ensure_staging (slot, ARV_RECORDER_BLOCK_SIZE))
+		return FALSE;
+
+	memset (slot->staging, 0, ARV_RECORDER_BLOCK_SIZE);
+	header = slot->staging;
+	memcpy (header->magic, ARV_RECORDER_FILE_MAGIC, sizeof (header->magic));
+	header->version = ARV_RECORDER_FILE_VERSION;
+	header->block_size = ARV_RECORDER_BLOCK_SIZE;
+	header->n_records = priv->n_records;
+	header->data_size = priv->offset;
+	header->records_offset = priv->records_offset;
+	header->index_offset = priv->index_offset;
+	header->genicam_offset = priv->genicam_offset;
+	header->genicam_size = priv->genicam_size;
+	header->features_offset = priv->features_offset;
+	header->features_size = priv->features_size;
+
+	do {
+		n_written = pwrite (priv->fd, slot->staging, ARV_RECORDER_BLOCK_SIZE, 0);
+	} while (n_written < 0 && errno == EINTR);
+
+	return n_written == ARV_RECORDER_BLOCK_SIZE;
+}
+
+/* Writes data followed by zeros up to the next block boundary, with at least one null byte. Returns the size of the
+ * written region, 0 on error. */
+
+static size_t
+_write_region (int fd, guint64 offset, const void *data, size_t size)
+{
+	size_t region_size = _round_up (size + 1);
+	void *region;
+	ssize_t n_written;
+
+	if (posix_memalign (&region, ARV_RECORDER_BLOCK_SIZE, region_size) != 0)
+		return 0;
+
+	memcpy (region, data, size);
+	memset ((char *) region + size, 0, region_size - size);
+
+	do {
+		n_written = pwrite (fd, region, region_size, offset);
+	} while (n_written < 0 && errno == EINTR);
+
+	free (region);
+
+	return n_written == (ssize_t) region_size ? region_size : 0;
+}
+
+/* Writes the GenICam data and the feature snapshot after the file header, and sets the start of the records */
+
+static void
+_write_device_description (ArvRecorderPrivate *priv)
+{
+	ArvDevice *device = NULL;
+	const char *genicam;
+	size_t genicam_size = 0;
+	size_t region_size;
+	char *features;
+
+	priv->offset = ARV_RECORDER_BLOCK_SIZE;
+
+	g_object_get (priv->stream, "device", &device, NULL);
+	if (!ARV_IS_DEVICE (device)) {
+		g_clear_object (&device);
+		priv->records_offset = priv->offset;
+		return;
+	}
+
+	genicam = arv_device_get_genicam_xml (device, &genicam_size);
+	if (genicam != NULL && genicam_size > 0 &&
+	    priv->offset + _round_up (genicam_size + 1) < priv->file_size) {
+		region_size = _write_region (priv->fd, priv->offset, genicam, genicam_size);
+		if (region_size > 0) {
+			priv->genicam_offset = priv->offset;
+			priv->genicam_size = genicam_size;
+			priv->offset += region_size;
+		}
+	}
+
+	/* Read only features are included for reference */
+	features = arv_device_dup_feature_values (device, FALSE);
+	if (features != NULL &&
+	    priv->offset + _round_up (strlen (features) + 1) < priv->file_size) {
+		region_size = _write_region (priv->fd, priv->offset, features, strlen (features));
+		if (region_size > 0) {
+			priv->features_offset = priv->offset;
+			priv->features_size = strlen (features);
+			priv->offset += region_size;
+		}
+	}
+	g_free (features);
+
+	g_object_unref (device);
+
+	priv->records_offset = priv->offset;
+}
+
+static int
+_compare_index_entries (gconstpointer a, gconstpointer b)
+{
+	const ArvRecorderIndexEntry *entry_a = a;
+	const ArvRecorderIndexEntry *entry_b = b;
+
+	return entry_a->offset < entry_b->offset ? -1 : entry_a->offset > entry_b->offset ? 1 : 0;
+}
+
+/* Appends the frame table after the last record, sorted by offset as the io_uring writes may complete out of
+ * order */
+
+static guint64
+_write_index (ArvRecorderPrivate *priv)
+{
+	size_t region_size;
+
+	if (priv->index->len == 0)
+		return priv->offset;
+
+	g_array_sort (priv->index, _compare_index_entries);
+
+	region_size = _write_region (priv->fd, priv->offset, priv->index->data,
+				     priv->index->len * sizeof (ArvRecorderIndexEntry));
+	if (region_size == 0)
+		return priv->offset;
+
+	priv->index_offset = priv->offset;
+
+	return priv->offset + region_size;
+}
+
+G_STATIC_ASSERT (ARV_RECORDER_MAX_BANDS == ARV_BUFFER_COMPRESSION_MAX_BANDS);
+G_STATIC_ASSERT (sizeof (ArvRecorderRecordHeader) + ARV_RECORDER_MAX_PARTS * sizeof (ArvRecorderPartHeader) +
+		 sizeof (ArvRecorderCompressionHeader) <= ARV_RECORDER_BLOCK_SIZE);
+
+/* Data written for a buffer, its compressed copy if any */
+
+static const guint8 *
+_get_record_data (ArvBuffer *buffer, size_t *size)
+{
+	const ArvBufferCompressed *compressed = buffer->priv->compressed;
+
+	if (compressed != NULL && compressed->is_valid) {
+		*size = compressed->size;
+		return compressed->data;
+	}
+
+	*size = buffer->priv->data != NULL ? buffer->priv->received_size : 0;
+
+	return buffer->priv->data;
+}
+
+/* Prepares the write of a buffer record. The block aligned part of the data is written directly from the buffer
+ * memory if it is itself block aligned, the rest is copied to the staging memory, and zero padded. */
+
+static gboolean
+_prepare_slot (ArvRecorderSlot *slot, ArvBuffer *buffer)
+{
+	ArvBufferPrivate *buffer_priv = buffer->priv;
+	ArvRecorderRecordHeader *header;
+	const guint8 *data;
+	size_t data_size;
+	size_t direct_size = 0;
+	size_t copy_size;
+	size_t staging_size;
+
+	data = _get_record_data (buffer, &data_size);
+
+	if (((guintptr) data % ARV_RECORDER_BLOCK_SIZE) == 0)
+		direct_size = data_size - data_size % ARV_RECORDER_BLOCK_SIZE;
+
+	copy_size = data_size - direct_size;
+	staging_size = ARV_RECORDER_BLOCK_SIZE + _round_up (copy_size);
+
+	if (!_ensure_staging (slot, staging_size))
+		return FALSE;
+
+	memset (slot->staging, 0, ARV_RECORDER_BLOCK_SIZE);
+	header = slot->staging;
+	header->magic = ARV_RECORDER_RECORD_MAGIC;
+	header->header_size = ARV_RECORDER_BLOCK_SIZE;
+	header->record_size = ARV_RECORDER_BLOCK_SIZE + _round_up (data_size);
+	header->data_size = data_size;
+	header->frame_id = buffer_priv->frame_id;
+	header->timestamp_ns = buffer_priv->timestamp_ns;
+	header->system_timestamp_ns = buffer_priv->system_timestamp_ns;
+	header->status = buffer_priv->status;
+	header->payload_type = buffer_priv->payload_type;
+	header->pixel_format = buffer_priv->pixel_format;
+	header->x_offset = buffer_priv->x_offset;
+	header->y_offset = buffer_priv->y_offset;
+	header->width = buffer_priv->width;
+	header->height = buffer_priv->height;
+	header->x_padding = buffer_priv->x_padding;
+	header->has_chunks = arv_buffer_has_chunks (buffer) ? 1 : 0;
+	header->chunk_endianness = buffer_priv->chunk_endianness;
+
+	if (buffer_priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART) {
+		ArvRecorderPartHeader *parts = (ArvRecorderPartHeader *) (header + 1);
+		guint i;
+
+		header->n_parts = MIN (buffer_priv->n_parts, ARV_RECORDER_MAX_PARTS);
+		for (i = 0; i < header->n_parts; i++) {
+			parts[i].data_offset = buffer_priv->parts[i].data_offset;
+			parts[i].size = buffer_priv->parts[i].size;
+			parts[i].component_id = buffer_priv->parts[i].component_id;
+			parts[i].data_type = buffer_priv->parts[i].data_type;
+			parts[i].pixel_format = buffer_priv->parts[i].pixel_format;
+			parts[i].width = buffer_priv->parts[i].width;
+			parts[i].height = buffer_priv->parts[i].height;
+			parts[i].x_offset = buffer_priv->parts[i].x_offset;
+			parts[i].y_offset = buffer_priv->parts[i].y_offset;
+			parts[i].x_padding = buffer_priv->parts[i].x_padding;
+			parts[i].y_padding = buffer_priv->parts[i].y_padding;
+		}
+	} else if (buffer_priv->compressed != NULL && buffer_priv->compressed->is_valid) {
+		const ArvBufferCompressed *compressed = buffer_priv->compressed;
+		ArvRecorderCompressionHeader *compression = (ArvRecorderCompressionHeader *) (header + 1);
+		guint i;
+
+		header->compression = compressed->compression;
+		compression->filter = compressed->filter;
+		compression->bytes_per_pixel = compressed->bytes_per_pixel;
+		compression->uncompressed_size = compressed->uncompressed_size;
+		compression->n_rows = compressed->n_rows;
+		compression->row_stride = compressed->row_stride;
+		compression->n_bands = compressed->n_bands;
+		for (i = 0; i < compressed->n_bands; i++)
+			compression->band_sizes[i] = compressed->band_sizes[i];
+	}
+
+	if (copy_size > 0) {
+		memcpy ((char *) slot->staging + ARV_RECORDER_BLOCK_SIZE, data + direct_size, copy_size);
+		memset ((char *) slot->staging + ARV_RECORDER_BLOCK_SIZE + copy_size, 0,
+			staging_size - ARV_RECORDER_BLOCK_SIZE - copy_size);
+	}
+
+	slot->n_iov = 0;
+	slot->iov[slot->n_iov].iov_base = slot->staging;
+	slot->iov[slot->n_iov++].iov_len = ARV_RECORDER_BLOCK_SIZE;
+	if (direct_size > 0) {
+		slot->iov[slot->n_iov].iov_base = (void *) data;
+		slot->iov[slot->n_iov++].iov_len = direct_size;
+	}
+	if (staging_size > ARV_RECORDER_BLOCK_SIZE) {
+		slot->iov[slot->n_iov].iov_base = (char *) slot->staging + ARV_RECORDER_BLOCK_SIZE;
+		slot->iov[slot->n_iov++].iov_len = staging_size - ARV_RECORDER_BLOCK_SIZE;
+	}
+
+	slot->size = header->record_size;
+	slot->buffer = buffer;
+
+	return TRUE;
+}
+
+/* Assigns the next file region to a buffer, or drops it if the file is full */
+
+static gboolean
+_prepare_record (ArvRecorderPrivate *priv, ArvRecorderSlot *slot, ArvBuffer *buffer)
+{
+	size_t data_size;
+
+	_get_record_data (buffer, &data_size);
+
+	if (!priv->failed &&
+	    priv->offset + ARV_RECORDER_BLOCK_SIZE + _round_up (data_size) <= priv->file_size &&
+	    _prepare_slot (slot, buffer)) {
+		slot->offset = priv->offset;
+		priv->offset += slot->size;
+
+		return TRUE;
+	}
+
+	g_mutex_lock (&priv->mutex);
+	priv->n_dropped_buffers++;
+	g_mutex_unlock (&priv->mutex);
+
+	arv_stream_push_buffer (priv->stream, buffer);
+
+	return FALSE;
+}
+
+static void
+_complete_record (ArvRecorderPrivate *priv, ArvRecorderSlot *slot, gboolean success)
+{
+	if (success) {
+		ArvRecorderRecordHeader *header = slot->staging;
+		ArvRecorderIndexEntry entry;
+
+		entry.frame_id = header->frame_id;
+		entry.timestamp_ns = header->timestamp_ns;
+		entry.system_timestamp_ns = header->system_timestamp_ns;
+		entry.offset = slot->offset;
+		g_array_append_val (priv->index, entry);
+	}
+
+	g_mutex_lock (&priv->mutex);
+	if (success) {
+		priv->n_records++;
+		priv->n_bytes += slot->size;
+	} else
+		priv->n_dropped_buffers++;
+	g_mutex_unlock (&priv->mutex);
+
+	if (!success && !priv->failed) {
+		arv_warning_stream ("[Recorder::complete_record] Write failure, stop recording");
+		priv->failed = TRUE;
+	}
+
+	arv_stream_push_buffer (priv->stream, slot->buffer);
+	slot->buffer = NULL;
+}
+
+static void
+_pwritev_loop (ArvRecorderPrivate *priv)
+{
+	ArvRecorderSlot *slot = &priv->slots[0];
+	ArvBuffer *buffer;
+	ssize_t n_written;
+
+	while (!g_atomic_int_get (&priv->cancel)) {
+		buffer = arv_stream_timeout_pop_buffer (priv->stream, ARV_RECORDER_POP_TIMEOUT_US);
+		if (buffer == NULL || !_prepare_record (priv, slot, buffer))
+			continue;
+
+		do {
+			n_written = pwritev (priv->fd, slot->iov, slot->n_iov, slot->offset);
+		} while (n_written < 0 && errno == EINTR);
+
+		_complete_record (priv, slot, n_written == (ssize_t) slot->size);
+	}
+}
+
+#if ARAVIS_HAS_IO_URING
+
+/* Returns FALSE if the io_uring setup failed, in which case the caller is expected to fall back to pwritev() */
+
+static gboolean
+_io_uring_loop (ArvRecorderPrivate *priv)
+{
+	struct io_uring ring;
+	struct io_uring_sqe *sqe;
+	struct io_uring_cqe *cqe;
+	guint free_slots[ARV_RECORDER_QUEUE_DEPTH];
+	guint n_free_slots = ARV_RECORDER_QUEUE_DEPTH;
+	guint n_pending = 0;
+	guint i;
+	int result;
+
+	result = io_uring_queue_init (ARV_RECORDER_QUEUE_DEPTH, &ring, 0);
+	if (result < 0) {
+		arv_info_stream ("[Recorder::io_uring_loop] Setup failed (%s), fall back to pwritev",
+				 strerror (-result));
+		return FALSE;
+	}
+
+	for (i = 0; i < ARV_RECORDER_QUEUE_DEPTH; i++)
+		free_slots[i] = i;
+
+	while (!g_atomic_int_get (&priv->cancel) || n_pending > 0) {
+		struct __kernel_timespec timeout = {0, ARV_RECORDER_REAP_TIMEOUT_NS};
+
+		if (n_free_slots > 0 && !g_atomic_int_get (&priv->cancel)) {
+			ArvBuffer *buffer;
+			guint slot_id;
+
+			/* Only block on the output queue when there is no completion to wait for */
+			if (n_pending > 0)
+				buffer = arv_stream_try_pop_buffer (priv->stream);
+			else
+				buffer = arv_stream_timeout_pop_buffer (priv->stream, ARV_RECORDER_POP_TIMEOUT_US);
+
+			if (buffer != NULL) {
+				slot_id = free_slots[n_free_slots - 1];
+				if (_prepare_record (priv, &priv->slots[slot_id], buffer)) {
+					sqe = io_uring_get_sqe (&ring);
+					io_uring_prep_writev (sqe, priv->fd,
+							      priv->slots[slot_id].iov, priv->slots[slot_id].n_iov,
+							      priv->slots[slot_id].offset);
+					io_uring_sqe_set_data64 (sqe, slot_id);
+					io_uring_submit (&ring);
+
+					n_free_slots--;
+					n_pending++;
+				}
+				continue;
+			}
+		}
+
+		if (n_pending == 0)
+			continue;
+
+		io_uring_wait_cqe_timeout (&ring, &cqe, &timeout);
+
+		while (io_uring_peek_cqe (&ring, &cqe) == 0) {
+			guint slot_id = io_uring_cqe_get_data64 (cqe);
+
+			_complete_record (priv, &priv->slots[slot_id], cqe->res == (int) priv->slots[slot_id].size);
+			io_uring_cqe_seen (&ring, cqe);
+
+			free_slots[n_free_slots++] = slot_id;
+			n_pending--;
+		}
+	}
+
+	io_uring_queue_exit (&ring);
+
+	return TRUE;
+}
+
+#endif
+
+static void *
+_thread (void *data)
+{
+	ArvRecorderPrivate *priv = data;
+
+#if ARAVIS_HAS_IO_URING
+	if (_io_uring_loop (priv))
+		return NULL;
+#endif
+
+	_pwritev_loop (priv);
+
+	return NULL;
+}
+
+#endif
+
+/**
+ * arv_recorder_new:
+ * @stream: a #ArvStream
+ * @filename: path of the record file
+ * @file_size: maximum size of the record file, in bytes
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a record file of @file_size bytes, and starts writing the buffers of @stream to it.
+ *
+ * Returns: (transfer full): a new #ArvRecorder, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvRecorder *
+arv_recorder_new (ArvStream *stream, const char *filename, guint64 file_size, GError **error)
+{
+#ifdef G_OS_UNIX
+	ArvRecorder *recorder;
+	int fd;
+	int result;
+	gboolean is_direct = ARV_RECORDER_O_DIRECT != 0;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | ARV_RECORDER_O_DIRECT, 0644);
+	if (fd < 0 && errno == EINVAL && is_direct) {
+		arv_info_stream ("[Recorder::new] O_DIRECT not supported for '%s', use buffered writes", filename);
+		is_direct = FALSE;
+		fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	}
+	if (fd < 0) {
+		g_set_error (error, ARV_RECORDER_ERROR, ARV_RECORDER_ERROR_FILE,
+			     "Failed to create '%s': %s", filename, strerror (errno));
+		return NULL;
+	}
+
+	file_size = MAX (_round_up (file_size), ARV_RECORDER_BLOCK_SIZE);
+
+	result = posix_fallocate (fd, 0, file_size);
+	if (result == ENOSPC || result == EFBIG) {
+		g_set_error (error, ARV_RECORDER_ERROR, ARV_RECORDER_ERROR_FILE,
+			     "Failed to preallocate %" G_GUINT64_FORMAT " bytes for '%s': %s",
+			     file_size, filename, strerror (result));
+		close (fd);
+		return NULL;
+	} else if (result != 0)
+		arv_info_stream ("[Recorder::new] Preallocation of '%s' failed: %s", filename, strerror (result));
+
+	recorder = g_object_new (ARV_TYPE_RECORDER, NULL);
+	recorder->priv->stream = g_object_ref (stream);
+	recorder->priv->fd = fd;
+	recorder->priv->is_direct = is_direct;
+	recorder->priv->file_size = file_size;
+
+	_write_device_description (recorder->priv);
+
+	if (!_write_file_header (recorder->priv)) {
+		g_set_error (error, ARV_RECORDER_ERROR, ARV_RECORDER_ERROR_FILE,
+			     "Failed to write the header of '%s'", filename);
+		g_object_unref (recorder);
+		return NULL;
+	}
+
+	arv_info_stream ("[Recorder::new] Record to '%s' (%" G_GUINT64_FORMAT " bytes%s)",
+			 filename, file_size, is_direct ? ", O_DIRECT" : "");
+
+	recorder->priv->thread = g_thread_new ("arv_recorder", _thread, recorder->priv);
+
+	return recorder;
+#else
+	g_set_error (error, ARV_RECORDER_ERROR, ARV_RECORDER_ERROR_NOT_SUPPORTED,
+		     "Recording is not supported on this platform");
+	return NULL;
+#endif
+}
+
+/**
+ * arv_recorder_stop:
+ * @recorder: a #ArvRecorder
+ *
+ * Stops the recording, once the pending writes are complete, and truncates the file to the recorded data. The
+ * buffers still in the stream output queue are left there.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_recorder_stop (ArvRecorder *recorder)
+{
+#ifdef G_OS_UNIX
+	guint64 file_end;
+#endif
+
+	g_return_if_fail (ARV_IS_RECORDER (recorder));
+
+	if (recorder->priv->thread == NULL)
+		return;
+
+	g_atomic_int_set (&recorder->priv->cancel, TRUE);
+	g_thread_join (recorder->priv->thread);
+	recorder->priv->thread = NULL;
+
+#ifdef G_OS_UNIX
+	file_end = _write_index (recorder->priv);
+
+	if (!_write_file_header (recorder->priv) ||
+	    ftruncate (recorder->priv->fd, file_end) != 0 ||
+	    fdatasync (recorder->priv->fd) != 0)
+		arv_warning_stream ("[Recorder::stop] Failed to finalize the record file");
+#endif
+}
+
+/**
+ * arv_recorder_get_statistics:
+ * @recorder: a #ArvRecorder
+ * @n_records: (out) (optional): number of written buffers
+ * @n_dropped_buffers: (out) (optional): number of buffers not written, because the file was full or a write failed
+ * @n_bytes: (out) (optional): number of bytes written, including the record headers and paddings
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_recorder_get_statistics (ArvRecorder *recorder, guint64 *n_records, guint64 *n_dropped_buffers, guint64 *n_bytes)
+{
+	g_return_if_fail (ARV_IS_RECORDER (recorder));
+
+	g_mutex_lock (&recorder->priv->mutex);
+	if (n_records != NULL)
+		*n_records = recorder->priv->n_records;
+	if (n_dropped_buffers != NULL)
+		*n_dropped_buffers = recorder->priv->n_dropped_buffers;
+	if (n_bytes != NULL)
+		*n_bytes = recorder->priv->n_bytes;
+	g_mutex_unlock (&recorder->priv->mutex);
+}
+
+static void
+arv_recorder_init (ArvRecorder *recorder)
+{
+	recorder->priv = arv_recorder_get_instance_private (recorder);
+
+#ifdef G_OS_UNIX
+	recorder->priv->fd = -1;
+	recorder->priv->index = g_array_new (FALSE, FALSE, sizeof (ArvRecorderIndexEntry));
+#endif
+
+	g_mutex_init (&recorder->priv->mutex);
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvRecorder *recorder = ARV_RECORDER (object);
+
+	arv_recorder_stop (recorder);
+
+	g_clear_object (&recorder->priv->stream);
+
+	G_OBJECT_CLASS (arv_recorder_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvRecorder *recorder = ARV_RECORDER (object);
+
+#ifdef G_OS_UNIX
+	guint i;
+
+	for (i = 0; i < ARV_RECORDER_QUEUE_DEPTH; i++)
+		free (recorder->priv->slots[i].staging);
+
+	if (recorder->priv->fd >= 0)
+		close (recorder->priv->fd);
+
+	g_array_unref (recorder->priv->index);
+#endif
+
+	g_mutex_clear (&recorder->priv->mutex);
+
+	G_OBJECT_CLASS (arv_recorder_parent_class)->finalize (object);
+}
+
+static void
+arv_recorder_class_init (ArvRecorderClass *recorder_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (recorder_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,289 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef ARV_RECORDER_H
+#define ARV_RECORDER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+#define ARV_RECORDER_ERROR arv_recorder_error_quark()
+
+ARV_API GQuark		arv_recorder_error_quark		(void);
+
+/**
+ * ArvRecorderError:
+ * @ARV_RECORDER_ERROR_NOT_SUPPORTED: recording is not supported on this platform
+ * @ARV_RECORDER_ERROR_FILE: the record file can not be created or preallocated
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_RECORDER_ERROR_NOT_SUPPORTED,
+	ARV_RECORDER_ERROR_FILE
+} ArvRecorderError;
+
+/**
+ * ARV_RECORDER_BLOCK_SIZE:
+ *
+ * Size of the blocks of a record file. The file header, the record headers and the record data are all aligned on
+ * this size.
+ *
+ * Since: 0.8.24
+ */
+
+#define ARV_RECORDER_BLOCK_SIZE		4096
+
+/**
+ * ARV_RECORDER_FILE_MAGIC:
+ *
+ * First 8 bytes of a record file.
+ *
+ * Since: 0.8.24
+ */
+
+#define ARV_RECORDER_FILE_MAGIC		"ARVREC01"
+
+/**
+ * ARV_RECORDER_RECORD_MAGIC:
+ *
+ * First 4 bytes of a record header.
+ *
+ * Since: 0.8.24
+ */
+
+#define ARV_RECORDER_RECORD_MAGIC	0x43455241
+
+/**
+ * ARV_RECORDER_MAX_PARTS:
+ *
+ * Maximum number of part descriptors stored in a record header.
+ *
+ * Since: 0.8.24
+ */
+
+#define ARV_RECORDER_MAX_PARTS		32
+
+/**
+ * ARV_RECORDER_MAX_BANDS:
+ *
+ * Maximum number of independently compressed bands of a record.
+ *
+ * Since: 0.8.24
+ */
+
+#define ARV_RECORDER_MAX_BANDS		64
+
+/**
+ * ArvRecorderFileHeader:
+ * @magic: %ARV_RECORDER_FILE_MAGIC
+ * @version: file format version, currently 2, version 1 files having no compressed records
+ * @block_size: block size, %ARV_RECORDER_BLOCK_SIZE
+ * @n_records: number of records
+ * @data_size: offset of the end of the last record
+ * @records_offset: offset of the first record
+ * @index_offset: offset of the frame table, an array of @n_records [struct@ArvRecorderIndexEntry], 0 if missing
+ * @genicam_offset: offset of the GenICam XML data of the device, 0 if unknown
+ * @genicam_size: size of the GenICam XML data
+ * @features_offset: offset of the snapshot of the feature values taken at the recording start, 0 if unknown
+ * @features_size: size of the feature snapshot
+ *
+ * Header stored in the first block of a record file, in host byte order. The GenICam data and the feature snapshot
+ * are followed by at least one null byte. The snapshot is a list of `Feature='value'` lines, in the format accepted
+ * by [method@ArvDevice.set_features_from_string].
+ *
+ * @n_records, @data_size and @index_offset are only set once the recorder is stopped. Until then, or if the
+ * recording was interrupted, the records can still be found by walking them from @records_offset.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	char magic[8];
+	guint32 version;
+	guint32 block_size;
+	guint64 n_records;
+	guint64 data_size;
+	guint64 records_offset;
+	guint64 index_offset;
+	guint64 genicam_offset;
+	guint64 genicam_size;
+	guint64 features_offset;
+	guint64 features_size;
+} ArvRecorderFileHeader;
+
+/**
+ * ArvRecorderIndexEntry:
+ * @frame_id: buffer frame id
+ * @timestamp_ns: buffer timestamp, in nanoseconds
+ * @system_timestamp_ns: buffer system timestamp, in nanoseconds
+ * @offset: offset of the record in the file
+ *
+ * Entry of the frame table of a record file, sorted by record offset.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint64 offset;
+} ArvRecorderIndexEntry;
+
+/**
+ * ArvRecorderPartHeader:
+ * @data_offset: offset of the part data from the start of the buffer data
+ * @size: size of the part data
+ * @component_id: part component id
+ * @data_type: part #ArvBufferPartDataType
+ * @pixel_format: part pixel format
+ * @width: part width
+ * @height: part height
+ * @x_offset: part x offset
+ * @y_offset: part y offset
+ * @x_padding: part x padding
+ * @y_padding: part y padding
+ *
+ * Descriptor of a part of a multipart buffer, stored after the record header.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint64 data_offset;
+	guint64 size;
+	guint32 component_id;
+	guint32 data_type;
+	guint32 pixel_format;
+	guint32 width;
+	guint32 height;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 x_padding;
+	guint32 y_padding;
+	guint32 reserved;
+} ArvRecorderPartHeader;
+
+/**
+ * ArvRecorderRecordHeader:
+ * @magic: %ARV_RECORDER_RECORD_MAGIC
+ * @header_size: size of the record header, the buffer data starting at this offset from the record start
+ * @record_size: size of the record, including the header and the padding of the data to the block size
+ * @data_size: size of the buffer data, including the chunk data, if any
+ * @frame_id: buffer frame id
+ * @timestamp_ns: buffer timestamp, in nanoseconds
+ * @system_timestamp_ns: buffer system timestamp, in nanoseconds
+ * @status: buffer #ArvBufferStatus
+ * @payload_type: buffer #ArvBufferPayloadType
+ * @pixel_format: image pixel format, for image payloads
+ * @x_offset: image x offset
+ * @y_offset: image y offset
+ * @width: image width
+ * @height: image height
+ * @x_padding: image x padding
+ * @has_chunks: 1 if the buffer data contains chunks
+ * @chunk_endianness: byte order of the chunk layout, G_BIG_ENDIAN or G_LITTLE_ENDIAN
+ * @n_parts: number of [struct@ArvRecorderPartHeader] following the record header, for multipart payloads
+ * @compression: #ArvBufferCompression of the record data, followed by an [struct@ArvRecorderCompressionHeader] in
+ * place of the part descriptors if not %ARV_BUFFER_COMPRESSION_NONE
+ *
+ * Header stored at the start of each record, in host byte order. For the compressed records, @data_size is the size
+ * of the compressed data.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint32 magic;
+	guint32 header_size;
+	guint64 record_size;
+	guint64 data_size;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint32 status;
+	guint32 payload_type;
+	guint32 pixel_format;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 width;
+	guint32 height;
+	guint32 x_padding;
+	guint32 has_chunks;
+	guint32 chunk_endianness;
+	guint32 n_parts;
+	guint32 compression;
+} ArvRecorderRecordHeader;
+
+/**
+ * ArvRecorderCompressionHeader:
+ * @filter: 1 if the rows are delta filtered before compression, each pixel being replaced by its difference with
+ * the previous pixel of the row, 0 if not
+ * @bytes_per_pixel: pixel size of the delta filter, 1 or 2
+ * @uncompressed_size: size of the buffer data once decompressed
+ * @n_rows: number of rows distributed between the bands, 0 for a single band without row structure
+ * @row_stride: size of a row, in bytes
+ * @n_bands: number of bands
+ * @reserved: unused, 0
+ * @band_sizes: compressed size of each band
+ *
+ * Descriptor of the compressed data of a record, stored after the record header. The data is the concatenation of
+ * @n_bands independent compressed frames. Band i holds the rows i * @n_rows / @n_bands to (i + 1) * @n_rows /
+ * @n_bands, the last band also holding the data following the rows.
+ *
+ * Since: 0.8.24
+ */
+
+typedef struct {
+	guint32 filter;
+	guint32 bytes_per_pixel;
+	guint64 uncompressed_size;
+	guint32 n_rows;
+	guint32 row_stride;
+	guint32 n_bands;
+	guint32 reserved;
+	guint64 band_sizes[ARV_RECORDER_MAX_BANDS];
+} ArvRecorderCompressionHeader;
+
+#define ARV_TYPE_RECORDER             (arv_recorder_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvRecorder, arv_recorder, ARV, RECORDER, GObject)
+
+ARV_API ArvRecorder *		arv_recorder_new		(ArvStream *stream, const char *filename,
+								 guint64 file_size, GError **error);
+
+ARV_API void			arv_recorder_stop		(ArvRecorder *recorder);
+ARV_API void			arv_recorder_get_statistics	(ArvRecorder *recorder, guint64 *n_records,
+								 guint64 *n_dropped_buffers, guint64 *n_bytes);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,459 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+/**
+ * ArvRecording:
+ *
+ * [class@ArvRecording] gives a random access to the frames of a file written by [class@ArvRecorder].
+ *
+ * The file is memory mapped, and the frames are returned as [class@ArvBuffer] pointing directly to the mapped data,
+ * without any copy. These buffers are read only. The compressed frames are decompressed to newly allocated buffers.
+ * The frames are located using the frame table stored at the end of
+ * the file, which is rebuilt by walking the records if the recording was interrupted before the table was written.
+ */
+
+#include <arvrecording.h>
+#include <arvrecorder.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#define ARV_RECORDING_MIN_FILE_VERSION	1
+#define ARV_RECORDING_MAX_FILE_VERSION	2
+
+GQuark
+arv_recording_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-recording-error-quark");
+}
+
+typedef struct {
+	GMappedFile *file;
+	const char *data;
+	gsize size;
+
+	const ArvRecorderFileHeader *header;
+
+	const ArvRecorderIndexEntry *index;
+	GArray *rebuilt_index;
+	guint64 n_frames;
+} ArvRecordingPrivate;
+
+struct _ArvRecording {
+	GObject	object;
+
+	ArvRecordingPrivate *priv;
+};
+
+struct _ArvRecordingClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvRecording, arv_recording, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvRecording))
+
+static const ArvRecorderRecordHeader *
+_get_record_header (ArvRecordingPrivate *priv, guint64 offset)
+{
+	const ArvRecorderRecordHeader *header;
+	const ArvRecorderPartHeader *parts;
+	guint i;
+
+	if (offset % ARV_RECORDER_BLOCK_SIZE != 0 ||
+	    offset >= priv->size ||
+	    priv->size - offset < ARV_RECORDER_BLOCK_SIZE)
+		return NULL;
+
+	header = (const ArvRecorderRecordHeader *) (priv->data + offset);
+	if (header->magic != ARV_RECORDER_RECORD_MAGIC ||
+	    header->header_size < sizeof (ArvRecorderRecordHeader) + header->n_parts * sizeof (ArvRecorderPartHeader) ||
+	    header->header_size % ARV_RECORDER_BLOCK_SIZE != 0 ||
+	    header->n_parts > ARV_RECORDER_MAX_PARTS ||
+	    header->record_size < header->header_size ||
+	    header->record_size - header->header_size < header->data_size ||
+	    header->record_size > priv->size - offset ||
+	    (header->compression != ARV_BUFFER_COMPRESSION_NONE &&
+	     (header->n_parts > 0 ||
+	      header->header_size < sizeof (ArvRecorderRecordHeader) + sizeof (ArvRecorderCompressionHeader))))
+		return NULL;
+
+	parts = (const ArvRecorderPartHeader *) (header + 1);
+	for (i = 0; i < header->n_parts; i++) {
+		if (parts[i].data_offset > header->data_size ||
+		    parts[i].size > header->data_size - parts[i].data_offset)
+			return NULL;
+	}
+
+	return header;
+}
+
+static void
+_rebuild_index (ArvRecordingPrivate *priv)
+{
+	const ArvRecorderRecordHeader *header;
+	guint64 offset;
+
+	priv->rebuilt_index = g_array_new (FALSE, FALSE, sizeof (ArvRecorderIndexEntry));
+
+	for (offset = priv->header->records_offset;
+	     (header = _get_record_header (priv, offset)) != NULL;
+	     offset += header->record_size) {
+		ArvRecorderIndexEntry entry;
+
+		entry.frame_id = header->frame_id;
+		entry.timestamp_ns = header->timestamp_ns;
+		entry.system_timestamp_ns = header->system_timestamp_ns;
+		entry.offset = offset;
+		g_array_append_val (priv->rebuilt_index, entry);
+	}
+
+	priv->index = (const ArvRecorderIndexEntry *) priv->rebuilt_index->data;
+	priv->n_frames = priv->rebuilt_index->len;
+}
+
+/**
+ * arv_recording_new:
+ * @filename: path of a file written by [class@ArvRecorder]
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Returns: (transfer full): a new #ArvRecording, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvRecording *
+arv_recording_new (const char *filename, GError **error)
+{
+	ArvRecording *recording;
+	ArvRecordingPrivate *priv;
+	const ArvRecorderFileHeader *header;
+	GMappedFile *file;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	file = g_mapped_file_new (filename, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	header = (const ArvRecorderFileHeader *) g_mapped_file_get_contents (file);
+	if (g_mapped_file_get_length (file) < ARV_RECORDER_BLOCK_SIZE ||
+	    memcmp (header->magic, ARV_RECORDER_FILE_MAGIC, sizeof (header->magic)) != 0 ||
+	    header->version < ARV_RECORDING_MIN_FILE_VERSION ||
+	    header->version > ARV_RECORDING_MAX_FILE_VERSION ||
+	    header->block_size != ARV_RECORDER_BLOCK_SIZE) {
+		g_set_error (error, ARV_RECORDING_ERROR, ARV_RECORDING_ERROR_INVALID_FILE,
+			     "'%s' is not a record file", filename);
+		g_mapped_file_unref (file);
+		return NULL;
+	}
+
+	recording = g_object_new (ARV_TYPE_RECORDING, NULL);
+	priv = recording->priv;
+	priv->file = file;
+	priv->data = g_mapped_file_get_contents (file);
+	priv->size = g_mapped_file_get_length (file);
+	priv->header = header;
+
+	if (header->index_offset != 0 &&
+	    header->index_offset % ARV_RECORDER_BLOCK_SIZE == 0 &&
+	    header->index_offset <= priv->size &&
+	    header->n_records <= (priv->size - header->index_offset) / sizeof (ArvRecorderIndexEntry)) {
+		priv->index = (const ArvRecorderIndexEntry *) (priv->data + header->index_offset);
+		priv->n_frames = header->n_records;
+	} else {
+		arv_info_misc ("[Recording::new] No frame table in '%s', walk the records", filename);
+		_rebuild_index (priv);
+	}
+
+	return recording;
+}
+
+/**
+ * arv_recording_get_n_frames:
+ * @recording: a #ArvRecording
+ *
+ * Returns: the number of recorded frames.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_recording_get_n_frames (ArvRecording *recording)
+{
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), 0);
+
+	return recording->priv->n_frames;
+}
+
+static const char *
+_get_string (ArvRecordingPrivate *priv, guint64 offset, guint64 size)
+{
+	if (offset == 0 || offset >= priv->size || size >= priv->size - offset || priv->data[offset + size] != '\0')
+		return NULL;
+
+	return priv->data + offset;
+}
+
+/**
+ * arv_recording_get_genicam_xml:
+ * @recording: a #ArvRecording
+ * @size: (out) (optional): placeholder for the size of the GenICam data
+ *
+ * Returns: (transfer none): the null terminated GenICam XML data of the recorded device, %NULL if unknown.
+ *
+ * Since: 0.8.24
+ */
+
+const char *
+arv_recording_get_genicam_xml (ArvRecording *recording, size_t *size)
+{
+	const char *genicam;
+
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), NULL);
+
+	genicam = _get_string (recording->priv,
+			       recording->priv->header->genicam_offset, recording->priv->header->genicam_size);
+
+	if (size != NULL)
+		*size = genicam != NULL ? recording->priv->header->genicam_size : 0;
+
+	return genicam;
+}
+
+/**
+ * arv_recording_get_features:
+ * @recording: a #ArvRecording
+ *
+ * Returns: (transfer none): the feature values of the device at the recording start, as a list of `Feature='value'`
+ * lines, %NULL if unknown.
+ *
+ * Since: 0.8.24
+ */
+
+const char *
+arv_recording_get_features (ArvRecording *recording)
+{
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), NULL);
+
+	return _get_string (recording->priv,
+			    recording->priv->header->features_offset, recording->priv->header->features_size);
+}
+
+/**
+ * arv_recording_get_buffer:
+ * @recording: a #ArvRecording
+ * @index: frame index, between 0 and [method@ArvRecording.get_n_frames] - 1
+ *
+ * Returns a read only buffer pointing to the mapped data of a frame. The buffer keeps the file mapped until it is
+ * released, even if @recording is destroyed first. The compressed frames are decompressed to a new buffer.
+ *
+ * Returns: (transfer full): a new #ArvBuffer, %NULL if the record is corrupted.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_recording_get_buffer (ArvRecording *recording, guint64 index)
+{
+	const ArvRecorderRecordHeader *header;
+	const ArvRecorderPartHeader *parts;
+	ArvBuffer *buffer;
+	guint64 offset;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), NULL);
+	g_return_val_if_fail (index < recording->priv->n_frames, NULL);
+
+	offset = recording->priv->index[index].offset;
+	header = _get_record_header (recording->priv, offset);
+	if (header == NULL) {
+		arv_warning_misc ("[Recording::get_buffer] Invalid record at offset %" G_GUINT64_FORMAT, offset);
+		return NULL;
+	}
+
+	if (header->compression != ARV_BUFFER_COMPRESSION_NONE) {
+		const ArvRecorderCompressionHeader *compression = (const ArvRecorderCompressionHeader *) (header + 1);
+		ArvBufferCompressed compressed = {0};
+		GError *error = NULL;
+
+		compressed.compression = header->compression;
+		compressed.filter = compression->filter;
+		compressed.bytes_per_pixel = compression->bytes_per_pixel;
+		compressed.uncompressed_size = compression->uncompressed_size;
+		compressed.n_rows = compression->n_rows;
+		compressed.row_stride = compression->row_stride;
+		compressed.n_bands = compression->n_bands;
+		for (i = 0; i < MIN (compression->n_bands, ARV_RECORDER_MAX_BANDS); i++)
+			compressed.band_sizes[i] = compression->band_sizes[i];
+
+		buffer = arv_buffer_new_allocate (compression->uncompressed_size);
+		if (!arv_buffer_decompress (&compressed, recording->priv->data + offset + header->header_size,
+					    header->data_size, buffer->priv->data, &error)) {
+			arv_warning_misc ("[Recording::get_buffer] Invalid compressed record at offset %"
+					  G_GUINT64_FORMAT ": %s", offset, error->message);
+			g_clear_error (&error);
+			g_object_unref (buffer);
+			return NULL;
+		}
+		buffer->priv->received_size = compression->uncompressed_size;
+	} else {
+		buffer = arv_buffer_new_take_data (header->data_size,
+						   (void *) (recording->priv->data + offset + header->header_size),
+						   g_mapped_file_ref (recording->priv->file),
+						   (GDestroyNotify) g_mapped_file_unref);
+		buffer->priv->received_size = header->data_size;
+	}
+
+	buffer->priv->status = header->status;
+	buffer->priv->payload_type = header->payload_type;
+	buffer->priv->frame_id = header->frame_id;
+	buffer->priv->timestamp_ns = header->timestamp_ns;
+	buffer->priv->system_timestamp_ns = header->system_timestamp_ns;
+	buffer->priv->x_offset = header->x_offset;
+	buffer->priv->y_offset = header->y_offset;
+	buffer->priv->width = header->width;
+	buffer->priv->height = header->height;
+	buffer->priv->x_padding = header->x_padding;
+	buffer->priv->pixel_format = header->pixel_format;
+	buffer->priv->chunk_endianness = header->chunk_endianness;
+
+	parts = (const ArvRecorderPartHeader *) (header + 1);
+	arv_buffer_set_n_parts (buffer, header->n_parts);
+	for (i = 0; i < header->n_parts; i++) {
+		buffer->priv->parts[i].data_offset = parts[i].data_offset;
+		buffer->priv->parts[i].size = parts[i].size;
+		buffer->priv->parts[i].component_id = parts[i].component_id;
+		buffer->priv->parts[i].data_type = parts[i].data_type;
+		buffer->priv->parts[i].pixel_format = parts[i].pixel_format;
+		buffer->priv->parts[i].width = parts[i].width;
+		buffer->priv->parts[i].height = parts[i].height;
+		buffer->priv->parts[i].x_offset = parts[i].x_offset;
+		buffer->priv->parts[i].y_offset = parts[i].y_offset;
+		buffer->priv->parts[i].x_padding = parts[i].x_padding;
+		buffer->priv->parts[i].y_padding = parts[i].y_padding;
+	}
+
+	return buffer;
+}
+
+/**
+ * arv_recording_find_frame_id:
+ * @recording: a #ArvRecording
+ * @frame_id: a frame id
+ *
+ * Looks up a frame by its id, using a binary search as the frame ids are normally increasing. A linear search is
+ * done as a fallback, for the recordings where the frame id counter wrapped around.
+ *
+ * Returns: the index of the first frame with @frame_id, -1 if not found.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_recording_find_frame_id (ArvRecording *recording, guint64 frame_id)
+{
+	const ArvRecorderIndexEntry *index;
+	guint64 low = 0, high, i;
+
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), -1);
+
+	index = recording->priv->index;
+	high = recording->priv->n_frames;
+
+	while (low < high) {
+		guint64 middle = low + (high - low) / 2;
+
+		if (index[middle].frame_id < frame_id)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if (low < recording->priv->n_frames && index[low].frame_id == frame_id)
+		return low;
+
+	for (i = 0; i < recording->priv->n_frames; i++)
+		if (index[i].frame_id == frame_id)
+			return i;
+
+	return -1;
+}
+
+/**
+ * arv_recording_find_timestamp:
+ * @recording: a #ArvRecording
+ * @timestamp_ns: a buffer timestamp, in nanoseconds
+ *
+ * Looks up the first frame with a timestamp greater or equal to @timestamp_ns, using a binary search.
+ *
+ * Returns: a frame index, -1 if all the frames are older than @timestamp_ns.
+ *
+ * Since: 0.8.24
+ */
+
+gint64
+arv_recording_find_timestamp (ArvRecording *recording, guint64 timestamp_ns)
+{
+	const ArvRecorderIndexEntry *index;
+	guint64 low = 0, high;
+
+	g_return_val_if_fail (ARV_IS_RECORDING (recording), -1);
+
+	index = recording->priv->index;
+	high = recording->priv->n_frames;
+
+	while (low < high) {
+		guint64 middle = low + (high - low) / 2;
+
+		if (index[middle].timestamp_ns < timestamp_ns)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low < recording->priv->n_frames ? (gint64) low : -1;
+}
+
+static void
+arv_recording_init (ArvRecording *recording)
+{
+	recording->priv = arv_recording_get_instance_private (recording);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvRecording *recording = ARV_RECORDING (object);
+
+	g_clear_pointer (&recording->priv->rebuilt_index, g_array_unref);
+	g_clear_pointer (&recording->priv->file, g_mapped_file_unref);
+
+	G_OBJECT_CLASS (arv_recording_parent_class)->finalize (object);
+}
+
+static void
+arv_recording_class_init (ArvRecordingClass *recording_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (recording_class);
+
+	object_class->finalize = _finalize;
+}
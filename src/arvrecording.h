@@ -0,0 +1,67 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef ARV_RECORDING_H
+#define ARV_RECORDING_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+#define ARV_RECORDING_ERROR arv_recording_error_quark()
+
+ARV_API GQuark		arv_recording_error_quark		(void);
+
+/**
+ * ArvRecordingError:
+ * @ARV_RECORDING_ERROR_INVALID_FILE: the file is not a valid record file
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_RECORDING_ERROR_INVALID_FILE
+} ArvRecordingError;
+
+#define ARV_TYPE_RECORDING             (arv_recording_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvRecording, arv_recording, ARV, RECORDING, GObject)
+
+ARV_API ArvRecording *		arv_recording_new			(const char *filename, GError **error);
+
+ARV_API guint64			arv_recording_get_n_frames		(ArvRecording *recording);
+ARV_API const char *		arv_recording_get_genicam_xml		(ArvRecording *recording, size_t *size);
+ARV_API const char *		arv_recording_get_features		(ArvRecording *recording);
+
+ARV_API ArvBuffer *		arv_recording_get_buffer		(ArvRecording *recording, guint64 index);
+ARV_API gint64			arv_recording_find_frame_id		(ArvRecording *recording, guint64 frame_id);
+ARV_API gint64			arv_recording_find_timestamp		(ArvRecording *recording, guint64 timestamp_ns);
+
+G_END_DECLS
+
+#endif
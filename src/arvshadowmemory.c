@@ -0,0 +1,263 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * ArvShadowMemory is a sparse copy of the device address space, shared by all the register nodes of a Genicam
+ * document. It is split in pages allocated on the first write, each with a bitmap of the valid bytes. Reads
+ * only succeed if all the requested bytes are valid, which lets overlapping registers and bulk reads of a whole
+ * region share the same content.
+ */
+
+#include <arvshadowmemoryprivate.h>
+#include <string.h>
+
+#define ARV_SHADOW_MEMORY_N_VALID_WORDS	(ARV_SHADOW_MEMORY_PAGE_SIZE / 64)
+
+typedef struct {
+	guint64 index;
+	guint64 valid[ARV_SHADOW_MEMORY_N_VALID_WORDS];
+	guint8 data[ARV_SHADOW_MEMORY_PAGE_SIZE];
+} ArvShadowMemoryPage;
+
+struct _ArvShadowMemory {
+	GRWLock lock;
+	GHashTable *pages;	/* ArvShadowMemoryPage, keyed by page index */
+};
+
+/* Mask of the bits [first, last] of a bitmap word */
+
+static guint64
+_word_mask (guint first, guint last)
+{
+	guint64 mask = G_MAXUINT64 << first;
+
+	if (last < 63)
+		mask &= (G_GUINT64_CONSTANT (1) << (last + 1)) - 1;
+
+	return mask;
+}
+
+static gboolean
+_is_range_valid (ArvShadowMemoryPage *page, guint offset, guint length)
+{
+	guint last = offset + length - 1;
+	guint i;
+
+	for (i = offset / 64; i <= last / 64; i++) {
+		guint64 mask = _word_mask (i == offset / 64 ? offset % 64 : 0, i == last / 64 ? last % 64 : 63);
+
+		if ((page->valid[i] & mask) != mask)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+_set_range_valid (ArvShadowMemoryPage *page, guint offset, guint length, gboolean is_valid)
+{
+	guint last = offset + length - 1;
+	guint i;
+
+	for (i = offset / 64; i <= last / 64; i++) {
+		guint64 mask = _word_mask (i == offset / 64 ? offset % 64 : 0, i == last / 64 ? last % 64 : 63);
+
+		if (is_valid)
+			page->valid[i] |= mask;
+		else
+			page->valid[i] &= ~mask;
+	}
+}
+
+/* Length of the part of [address, address + length) inside the page of @address */
+
+static guint
+_get_chunk_length (guint64 address, guint64 length)
+{
+	return MIN (length, ARV_SHADOW_MEMORY_PAGE_SIZE - address % ARV_SHADOW_MEMORY_PAGE_SIZE);
+}
+
+/**
+ * arv_shadow_memory_read:
+ * @shadow: a #ArvShadowMemory
+ * @address: start of the range
+ * @length: range length, in bytes
+ * @buffer: (out caller-allocates): a @length bytes long buffer
+ *
+ * Copies the shadow content of the range to @buffer. @buffer content is undefined on failure.
+ *
+ * Returns: %TRUE if the range was entirely valid.
+ */
+
+gboolean
+arv_shadow_memory_read (ArvShadowMemory *shadow, guint64 address, guint64 length, void *buffer)
+{
+	guint8 *data = buffer;
+	gboolean success = length > 0;
+
+	g_return_val_if_fail (shadow != NULL, FALSE);
+
+	g_rw_lock_reader_lock (&shadow->lock);
+	while (length > 0 && success) {
+		guint64 index = address / ARV_SHADOW_MEMORY_PAGE_SIZE;
+		guint offset = address % ARV_SHADOW_MEMORY_PAGE_SIZE;
+		guint chunk_length = _get_chunk_length (address, length);
+		ArvShadowMemoryPage *page;
+
+		page = g_hash_table_lookup (shadow->pages, &index);
+		success = page != NULL && _is_range_valid (page, offset, chunk_length);
+		if (success)
+			memcpy (data, page->data + offset, chunk_length);
+
+		data += chunk_length;
+		address += chunk_length;
+		length -= chunk_length;
+	}
+	g_rw_lock_reader_unlock (&shadow->lock);
+
+	return success;
+}
+
+/**
+ * arv_shadow_memory_write:
+ * @shadow: a #ArvShadowMemory
+ * @address: start of the range
+ * @length: range length, in bytes
+ * @buffer: the @length bytes of the new content
+ *
+ * Updates the shadow content of the range, and marks it valid.
+ */
+
+void
+arv_shadow_memory_write (ArvShadowMemory *shadow, guint64 address, guint64 length, const void *buffer)
+{
+	const guint8 *data = buffer;
+
+	g_return_if_fail (shadow != NULL);
+
+	g_rw_lock_writer_lock (&shadow->lock);
+	while (length > 0) {
+		guint64 index = address / ARV_SHADOW_MEMORY_PAGE_SIZE;
+		guint offset = address % ARV_SHADOW_MEMORY_PAGE_SIZE;
+		guint chunk_length = _get_chunk_length (address, length);
+		ArvShadowMemoryPage *page;
+
+		page = g_hash_table_lookup (shadow->pages, &index);
+		if (page == NULL) {
+			page = g_new0 (ArvShadowMemoryPage, 1);
+			page->index = index;
+			g_hash_table_insert (shadow->pages, &page->index, page);
+		}
+
+		memcpy (page->data + offset, data, chunk_length);
+		_set_range_valid (page, offset, chunk_length, TRUE);
+
+		data += chunk_length;
+		address += chunk_length;
+		length -= chunk_length;
+	}
+	g_rw_lock_writer_unlock (&shadow->lock);
+}
+
+/**
+ * arv_shadow_memory_invalidate:
+ * @shadow: a #ArvShadowMemory
+ * @address: start of the range
+ * @length: range length, in bytes
+ *
+ * Marks the range invalid. The next reads overlapping it fail until it is written again.
+ */
+
+void
+arv_shadow_memory_invalidate (ArvShadowMemory *shadow, guint64 address, guint64 length)
+{
+	g_return_if_fail (shadow != NULL);
+
+	g_rw_lock_writer_lock (&shadow->lock);
+	while (length > 0) {
+		guint64 index = address / ARV_SHADOW_MEMORY_PAGE_SIZE;
+		guint chunk_length = _get_chunk_length (address, length);
+		ArvShadowMemoryPage *page;
+
+		page = g_hash_table_lookup (shadow->pages, &index);
+		if (page != NULL)
+			_set_range_valid (page, address % ARV_SHADOW_MEMORY_PAGE_SIZE, chunk_length, FALSE);
+
+		address += chunk_length;
+		length -= chunk_length;
+	}
+	g_rw_lock_writer_unlock (&shadow->lock);
+}
+
+/**
+ * arv_shadow_memory_clear:
+ * @shadow: a #ArvShadowMemory
+ *
+ * Drops all the pages.
+ */
+
+void
+arv_shadow_memory_clear (ArvShadowMemory *shadow)
+{
+	g_return_if_fail (shadow != NULL);
+
+	g_rw_lock_writer_lock (&shadow->lock);
+	g_hash_table_remove_all (shadow->pages);
+	g_rw_lock_writer_unlock (&shadow->lock);
+}
+
+guint
+arv_shadow_memory_get_n_pages (ArvShadowMemory *shadow)
+{
+	guint n_pages;
+
+	g_return_val_if_fail (shadow != NULL, 0);
+
+	g_rw_lock_reader_lock (&shadow->lock);
+	n_pages = g_hash_table_size (shadow->pages);
+	g_rw_lock_reader_unlock (&shadow->lock);
+
+	return n_pages;
+}
+
+ArvShadowMemory *
+arv_shadow_memory_new (void)
+{
+	ArvShadowMemory *shadow;
+
+	shadow = g_new0 (ArvShadowMemory, 1);
+	g_rw_lock_init (&shadow->lock);
+	shadow->pages = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL, g_free);
+
+	return shadow;
+}
+
+void
+arv_shadow_memory_free (ArvShadowMemory *shadow)
+{
+	if (shadow == NULL)
+		return;
+
+	g_hash_table_unref (shadow->pages);
+	g_rw_lock_clear (&shadow->lock);
+	g_free (shadow);
+}
@@ -0,0 +1,50 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_SHADOW_MEMORY_PRIVATE_H
+#define ARV_SHADOW_MEMORY_PRIVATE_H
+
+#include <arvapi.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define ARV_SHADOW_MEMORY_PAGE_SIZE	4096
+
+typedef struct _ArvShadowMemory ArvShadowMemory;
+
+/* private, but used by tests */
+ARV_API ArvShadowMemory *	arv_shadow_memory_new			(void);
+ARV_API void			arv_shadow_memory_free			(ArvShadowMemory *shadow);
+
+ARV_API gboolean		arv_shadow_memory_read			(ArvShadowMemory *shadow, guint64 address,
+									 guint64 length, void *buffer);
+ARV_API void			arv_shadow_memory_write			(ArvShadowMemory *shadow, guint64 address,
+									 guint64 length, const void *buffer);
+ARV_API void			arv_shadow_memory_invalidate		(ArvShadowMemory *shadow, guint64 address,
+									 guint64 length);
+ARV_API void			arv_shadow_memory_clear			(ArvShadowMemory *shadow);
+ARV_API guint			arv_shadow_memory_get_n_pages		(ArvShadowMemory *shadow);
+
+G_END_DECLS
+
+#endif
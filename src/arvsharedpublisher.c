@@ -0,0 +1,502 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvSharedPublisher:
+ *
+ * [class@ArvSharedPublisher] publishes the buffers of a [class@ArvStream] in a POSIX shared memory ring, from a
+ * dedicated thread, allowing several processes of the host to receive the frames of a camera controlled by another
+ * one, without any copy.
+ *
+ * The publisher allocates its buffers in the shared memory segment and pushes them to the stream input queue, the
+ * stream thread writing the frames directly in the ring slots. The completed buffers are popped from the stream
+ * output queue and made available to the [class@ArvSharedStream] readers. A slot goes back to the stream once
+ * none of the readers holds it, and once it has left the publication history, made of the latest @n_slots / 2
+ * frames. The readers which don't keep up with the frame rate miss the older frames, they never block the stream.
+ *
+ * The failed buffers are not published. The application must not pop the buffers from the stream, nor push its own
+ * buffers, while a publisher is attached to it. It can receive the frames using a [class@ArvSharedStream] as well.
+ */
+
+#include <arvsharedpublisher.h>
+#include <arvsharedringprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#if ARAVIS_HAS_SHARED_MEMORY
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define ARV_SHARED_PUBLISHER_POP_TIMEOUT_US		10000
+#define ARV_SHARED_PUBLISHER_READER_CHECK_PERIOD_US	1000000
+
+typedef struct {
+	ArvStream *stream;
+	char *shm_name;
+
+	guint n_slots;
+	size_t slot_size;
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	ArvSharedRingMap *map;
+	ArvBuffer **buffers;
+
+	/* Publisher thread only */
+	gboolean *is_in_stream;
+	gint64 last_reader_check;
+#endif
+
+	GThread *thread;
+	gint cancel;
+
+	GMutex mutex;
+	guint64 n_published_buffers;
+	guint64 n_failed_buffers;
+} ArvSharedPublisherPrivate;
+
+struct _ArvSharedPublisher {
+	GObject	object;
+
+	ArvSharedPublisherPrivate *priv;
+};
+
+struct _ArvSharedPublisherClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvSharedPublisher, arv_shared_publisher, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvSharedPublisher))
+
+#if ARAVIS_HAS_SHARED_MEMORY
+
+/* Returns the slot of a buffer, -1 if it was not allocated by the publisher */
+
+static gint
+_get_slot_id (ArvSharedPublisherPrivate *priv, ArvBuffer *buffer)
+{
+	guint i;
+
+	for (i = 0; i < priv->n_slots; i++)
+		if (priv->buffers[i] == buffer)
+			return i;
+
+	return -1;
+}
+
+/* Drops the slots held by the readers which died without releasing them. Called with the ring lock held. */
+
+static void
+_check_readers (ArvSharedPublisherPrivate *priv, ArvSharedRingHeader *header)
+{
+	gint64 time_us = g_get_monotonic_time ();
+	guint i, j;
+
+	if (time_us - priv->last_reader_check < ARV_SHARED_PUBLISHER_READER_CHECK_PERIOD_US)
+		return;
+
+	priv->last_reader_check = time_us;
+
+	for (i = 0; i < ARV_SHARED_RING_MAX_READERS; i++) {
+		if (header->reader_pids[i] == 0 ||
+		    kill (header->reader_pids[i], 0) == 0 || errno != ESRCH)
+			continue;
+
+		arv_info_stream ("[SharedPublisher::check_readers] Reader %d is gone", (int) header->reader_pids[i]);
+
+		for (j = 0; j < priv->n_slots; j++)
+			header->slots[j].reader_mask &= ~(1U << i);
+		header->reader_pids[i] = 0;
+	}
+}
+
+static void *
+_thread (void *data)
+{
+	ArvSharedPublisherPrivate *priv = data;
+	ArvSharedRingHeader *header = priv->map->header;
+	ArvBuffer **reclaimed;
+
+	reclaimed = g_new (ArvBuffer *, priv->n_slots);
+
+	while (!g_atomic_int_get (&priv->cancel)) {
+		ArvBuffer *buffer;
+		guint n_reclaimed = 0;
+		gint slot_id = -1;
+		guint i;
+
+		buffer = arv_stream_timeout_pop_buffer (priv->stream, ARV_SHARED_PUBLISHER_POP_TIMEOUT_US);
+		if (buffer != NULL) {
+			slot_id = _get_slot_id (priv, buffer);
+			if (slot_id < 0 || arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS) {
+				/* Failed frames, and foreign buffers, go back to the stream */
+				if (slot_id >= 0) {
+					g_mutex_lock (&priv->mutex);
+					priv->n_failed_buffers++;
+					g_mutex_unlock (&priv->mutex);
+				}
+				arv_stream_push_buffer (priv->stream, buffer);
+				buffer = NULL;
+			}
+		}
+
+		arv_shared_ring_lock (header);
+
+		if (buffer != NULL) {
+			ArvSharedRingSlot *slot = &header->slots[slot_id];
+
+			arv_shared_ring_store_buffer (slot, buffer);
+			slot->sequence = ++header->n_published;
+			slot->is_published = TRUE;
+			priv->is_in_stream[slot_id] = FALSE;
+
+			pthread_cond_broadcast (&header->frame_cond);
+		}
+
+		_check_readers (priv, header);
+
+		/* The slots out of the history and released by all the readers go back to the stream */
+		for (i = 0; i < priv->n_slots; i++) {
+			ArvSharedRingSlot *slot = &header->slots[i];
+
+			if (priv->is_in_stream[i])
+				continue;
+
+			if (slot->is_published && slot->sequence + header->history_depth <= header->n_published)
+				slot->is_published = FALSE;
+
+			if (!slot->is_published && slot->reader_mask == 0) {
+				priv->is_in_stream[i] = TRUE;
+				reclaimed[n_reclaimed++] = priv->buffers[i];
+			}
+		}
+
+		arv_shared_ring_unlock (header);
+
+		if (buffer != NULL) {
+			/* The publisher keeps its own reference on the slot buffers */
+			g_object_unref (buffer);
+
+			g_mutex_lock (&priv->mutex);
+			priv->n_published_buffers++;
+			g_mutex_unlock (&priv->mutex);
+		}
+
+		for (i = 0; i < n_reclaimed; i++)
+			arv_stream_push_buffer (priv->stream, g_object_ref (reclaimed[i]));
+	}
+
+	g_free (reclaimed);
+
+	return NULL;
+}
+
+static gboolean
+_init_segment (ArvSharedRingHeader *header, guint n_slots, size_t slot_size, size_t segment_size)
+{
+	pthread_mutexattr_t mutex_attr;
+	pthread_condattr_t cond_attr;
+	size_t stride = (slot_size + ARV_SHARED_RING_ALIGNMENT - 1) / ARV_SHARED_RING_ALIGNMENT *
+		ARV_SHARED_RING_ALIGNMENT;
+	size_t data_offset = arv_shared_ring_get_header_size (n_slots);
+	gboolean success;
+	guint i;
+
+	header->n_slots = n_slots;
+	header->history_depth = MAX (1, n_slots / 2);
+	header->slot_size = slot_size;
+	header->segment_size = segment_size;
+
+	for (i = 0; i < n_slots; i++)
+		header->slots[i].data_offset = data_offset + i * stride;
+
+	pthread_mutexattr_init (&mutex_attr);
+	pthread_mutexattr_setpshared (&mutex_attr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust (&mutex_attr, PTHREAD_MUTEX_ROBUST);
+	success = pthread_mutex_init (&header->mutex, &mutex_attr) == 0;
+	pthread_mutexattr_destroy (&mutex_attr);
+
+	/* The readers compute their deadlines using the monotonic clock */
+	pthread_condattr_init (&cond_attr);
+	pthread_condattr_setpshared (&cond_attr, PTHREAD_PROCESS_SHARED);
+	pthread_condattr_setclock (&cond_attr, CLOCK_MONOTONIC);
+	success = success && pthread_cond_init (&header->frame_cond, &cond_attr) == 0;
+	pthread_condattr_destroy (&cond_attr);
+
+	header->is_publisher_alive = TRUE;
+	header->version = ARV_SHARED_RING_VERSION;
+
+	/* Set last, readers check it before any other field */
+	header->magic = ARV_SHARED_RING_MAGIC;
+
+	return success;
+}
+
+#endif
+
+/**
+ * arv_shared_publisher_new:
+ * @stream: a #ArvStream
+ * @name: name of the shared stream, used by the readers in [ctor@SharedStream.new]
+ * @n_slots: number of slots of the ring, between 2 and 1024
+ * @slot_size: size of the slots, which must be at least the stream payload size
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a shared memory ring of @n_slots buffers of @slot_size bytes, pushes them to the input queue of @stream,
+ * and starts publishing the completed buffers. An existing ring of the same name, left by a dead publisher, is
+ * replaced.
+ *
+ * Returns: (transfer full): a new #ArvSharedPublisher, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvSharedPublisher *
+arv_shared_publisher_new (ArvStream *stream, const char *name, guint n_slots, size_t slot_size, GError **error)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	ArvSharedPublisher *publisher;
+	ArvSharedRingMap *map;
+	char *shm_name;
+	size_t stride;
+	size_t segment_size;
+	guint i;
+	int fd;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+	g_return_val_if_fail (name != NULL, NULL);
+	g_return_val_if_fail (n_slots >= 2 && n_slots <= 1024, NULL);
+	g_return_val_if_fail (slot_size > 0, NULL);
+
+	if (name[0] == '\0' || strchr (name, '/') != NULL) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_INVALID_NAME,
+			     "Invalid shared stream name '%s'", name);
+		return NULL;
+	}
+
+	stride = (slot_size + ARV_SHARED_RING_ALIGNMENT - 1) / ARV_SHARED_RING_ALIGNMENT * ARV_SHARED_RING_ALIGNMENT;
+	if (stride > (G_MAXSIZE - arv_shared_ring_get_header_size (n_slots)) / n_slots) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_ALLOCATION_FAILURE,
+			     "Invalid shared ring size (%u x %" G_GSIZE_FORMAT " bytes)", n_slots, slot_size);
+		return NULL;
+	}
+	segment_size = arv_shared_ring_get_header_size (n_slots) + n_slots * stride;
+
+	shm_name = arv_shared_ring_get_shm_name (name);
+
+	fd = shm_open (shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0 && errno == EEXIST) {
+		arv_info_stream ("[SharedPublisher::new] Replace existing shared memory '%s'", shm_name);
+		shm_unlink (shm_name);
+		fd = shm_open (shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	}
+	if (fd < 0) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_ALLOCATION_FAILURE,
+			     "Failed to create shared memory '%s': %s", shm_name, strerror (errno));
+		g_free (shm_name);
+		return NULL;
+	}
+
+	map = NULL;
+	if (ftruncate (fd, segment_size) == 0)
+		map = arv_shared_ring_map_new (fd, segment_size);
+	if (map == NULL || !_init_segment (map->header, n_slots, slot_size, segment_size)) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_ALLOCATION_FAILURE,
+			     "Failed to allocate %" G_GSIZE_FORMAT " bytes of shared memory for '%s': %s",
+			     segment_size, shm_name, strerror (errno));
+		arv_shared_ring_map_unref (map);
+		close (fd);
+		shm_unlink (shm_name);
+		g_free (shm_name);
+		return NULL;
+	}
+	close (fd);
+
+	publisher = g_object_new (ARV_TYPE_SHARED_PUBLISHER, NULL);
+	publisher->priv->stream = g_object_ref (stream);
+	publisher->priv->shm_name = shm_name;
+	publisher->priv->n_slots = n_slots;
+	publisher->priv->slot_size = slot_size;
+	publisher->priv->map = map;
+	publisher->priv->buffers = g_new (ArvBuffer *, n_slots);
+	publisher->priv->is_in_stream = g_new (gboolean, n_slots);
+
+	for (i = 0; i < n_slots; i++) {
+		publisher->priv->buffers[i] =
+			arv_buffer_new_take_data (slot_size,
+						  (char *) map->header + map->header->slots[i].data_offset,
+						  arv_shared_ring_map_ref (map), arv_shared_ring_map_unref);
+		publisher->priv->is_in_stream[i] = TRUE;
+		arv_stream_push_buffer (stream, g_object_ref (publisher->priv->buffers[i]));
+	}
+
+	arv_info_stream ("[SharedPublisher::new] Publish '%s' (%u slots of %" G_GSIZE_FORMAT " bytes)",
+			 shm_name, n_slots, slot_size);
+
+	publisher->priv->thread = g_thread_new ("arv_shared_publisher", _thread, publisher->priv);
+
+	return publisher;
+#else
+	g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_NOT_SUPPORTED,
+		     "Shared memory streams are not supported on this platform");
+	return NULL;
+#endif
+}
+
+/**
+ * arv_shared_publisher_stop:
+ * @publisher: a #ArvSharedPublisher
+ *
+ * Stops the publication, and removes the ring name. The readers still connected are notified, and can't retrieve
+ * any new buffer. The buffers they hold stay valid until they are released.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_shared_publisher_stop (ArvSharedPublisher *publisher)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	ArvSharedRingHeader *header;
+	guint i;
+#endif
+
+	g_return_if_fail (ARV_IS_SHARED_PUBLISHER (publisher));
+
+	if (publisher->priv->thread == NULL)
+		return;
+
+	g_atomic_int_set (&publisher->priv->cancel, TRUE);
+	g_thread_join (publisher->priv->thread);
+	publisher->priv->thread = NULL;
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	header = publisher->priv->map->header;
+
+	arv_shared_ring_lock (header);
+	header->is_publisher_alive = FALSE;
+	for (i = 0; i < publisher->priv->n_slots; i++)
+		header->slots[i].is_published = FALSE;
+	pthread_cond_broadcast (&header->frame_cond);
+	arv_shared_ring_unlock (header);
+
+	shm_unlink (publisher->priv->shm_name);
+
+	arv_info_stream ("[SharedPublisher::stop] Stop publishing '%s'", publisher->priv->shm_name);
+#endif
+}
+
+/**
+ * arv_shared_publisher_get_statistics:
+ * @publisher: a #ArvSharedPublisher
+ * @n_published_buffers: (out) (optional): number of published buffers
+ * @n_failed_buffers: (out) (optional): number of failed buffers, given back to the stream without publication
+ * @n_readers: (out) (optional): number of connected readers
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_shared_publisher_get_statistics (ArvSharedPublisher *publisher,
+				     guint64 *n_published_buffers, guint64 *n_failed_buffers, guint *n_readers)
+{
+	g_return_if_fail (ARV_IS_SHARED_PUBLISHER (publisher));
+
+	g_mutex_lock (&publisher->priv->mutex);
+	if (n_published_buffers != NULL)
+		*n_published_buffers = publisher->priv->n_published_buffers;
+	if (n_failed_buffers != NULL)
+		*n_failed_buffers = publisher->priv->n_failed_buffers;
+	g_mutex_unlock (&publisher->priv->mutex);
+
+	if (n_readers != NULL) {
+		*n_readers = 0;
+#if ARAVIS_HAS_SHARED_MEMORY
+		if (publisher->priv->map != NULL) {
+			ArvSharedRingHeader *header = publisher->priv->map->header;
+			guint i;
+
+			arv_shared_ring_lock (header);
+			for (i = 0; i < ARV_SHARED_RING_MAX_READERS; i++)
+				if (header->reader_pids[i] != 0)
+					(*n_readers)++;
+			arv_shared_ring_unlock (header);
+		}
+#endif
+	}
+}
+
+static void
+arv_shared_publisher_init (ArvSharedPublisher *publisher)
+{
+	publisher->priv = arv_shared_publisher_get_instance_private (publisher);
+
+	g_mutex_init (&publisher->priv->mutex);
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvSharedPublisher *publisher = ARV_SHARED_PUBLISHER (object);
+
+	arv_shared_publisher_stop (publisher);
+
+	g_clear_object (&publisher->priv->stream);
+
+	G_OBJECT_CLASS (arv_shared_publisher_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvSharedPublisher *publisher = ARV_SHARED_PUBLISHER (object);
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	guint i;
+
+	/* The buffers still in the stream queues keep the segment mapped */
+	if (publisher->priv->buffers != NULL)
+		for (i = 0; i < publisher->priv->n_slots; i++)
+			g_object_unref (publisher->priv->buffers[i]);
+
+	g_free (publisher->priv->buffers);
+	g_free (publisher->priv->is_in_stream);
+	arv_shared_ring_map_unref (publisher->priv->map);
+#endif
+
+	g_free (publisher->priv->shm_name);
+	g_mutex_clear (&publisher->priv->mutex);
+
+	G_OBJECT_CLASS (arv_shared_publisher_parent_class)->finalize (object);
+}
+
+static void
+arv_shared_publisher_class_init (ArvSharedPublisherClass *publisher_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (publisher_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,189 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Layout helpers of the shared memory rings used by ArvSharedPublisher and ArvSharedStream.
+ */
+
+#include <arvsharedringprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+
+#if ARAVIS_HAS_SHARED_MEMORY
+
+#include <errno.h>
+#include <sys/mman.h>
+
+/* Maps a segment, returns NULL on error with errno set. */
+
+ArvSharedRingMap *
+arv_shared_ring_map_new (int fd, size_t size)
+{
+	ArvSharedRingMap *map;
+	void *memory;
+
+	memory = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (memory == MAP_FAILED)
+		return NULL;
+
+	map = g_new0 (ArvSharedRingMap, 1);
+	map->ref_count = 1;
+	map->header = memory;
+	map->size = size;
+
+	return map;
+}
+
+ArvSharedRingMap *
+arv_shared_ring_map_ref (ArvSharedRingMap *map)
+{
+	g_atomic_int_inc (&map->ref_count);
+
+	return map;
+}
+
+void
+arv_shared_ring_map_unref (void *data)
+{
+	ArvSharedRingMap *map = data;
+
+	if (map == NULL || !g_atomic_int_dec_and_test (&map->ref_count))
+		return;
+
+	munmap (map->header, map->size);
+	g_free (map);
+}
+
+/* Returns the POSIX shared memory object name of a ring */
+
+char *
+arv_shared_ring_get_shm_name (const char *name)
+{
+	return g_strdup_printf ("/aravis-%s", name);
+}
+
+/* Returns the size of the segment header, the slot data starting right after */
+
+size_t
+arv_shared_ring_get_header_size (guint n_slots)
+{
+	size_t size = sizeof (ArvSharedRingHeader) + n_slots * sizeof (ArvSharedRingSlot);
+
+	return (size + ARV_SHARED_RING_ALIGNMENT - 1) / ARV_SHARED_RING_ALIGNMENT * ARV_SHARED_RING_ALIGNMENT;
+}
+
+/* The mutex is robust, a process dying with the lock held doesn't block the others. The protected state stays
+ * consistent, as the reader and publisher updates are only made of single field stores. */
+
+void
+arv_shared_ring_lock (ArvSharedRingHeader *header)
+{
+	if (pthread_mutex_lock (&header->mutex) == EOWNERDEAD) {
+		arv_warning_stream ("[SharedRing::lock] Previous owner died with the lock held");
+		pthread_mutex_consistent (&header->mutex);
+	}
+}
+
+void
+arv_shared_ring_unlock (ArvSharedRingHeader *header)
+{
+	pthread_mutex_unlock (&header->mutex);
+}
+
+/* Copies the buffer description to the slot descriptor, the data being already in the slot */
+
+void
+arv_shared_ring_store_buffer (ArvSharedRingSlot *slot, ArvBuffer *buffer)
+{
+	ArvBufferPrivate *priv = buffer->priv;
+	guint i;
+
+	slot->received_size = priv->received_size;
+	slot->frame_id = priv->frame_id;
+	slot->timestamp_ns = priv->timestamp_ns;
+	slot->system_timestamp_ns = priv->system_timestamp_ns;
+	slot->status = priv->status;
+	slot->payload_type = priv->payload_type;
+	slot->pixel_format = priv->pixel_format;
+	slot->x_offset = priv->x_offset;
+	slot->y_offset = priv->y_offset;
+	slot->width = priv->width;
+	slot->height = priv->height;
+	slot->x_padding = priv->x_padding;
+	slot->chunk_endianness = priv->chunk_endianness;
+
+	slot->n_parts = MIN (priv->n_parts, ARV_SHARED_RING_MAX_PARTS);
+	for (i = 0; i < slot->n_parts; i++) {
+		slot->parts[i].data_offset = priv->parts[i].data_offset;
+		slot->parts[i].size = priv->parts[i].size;
+		slot->parts[i].component_id = priv->parts[i].component_id;
+		slot->parts[i].data_type = priv->parts[i].data_type;
+		slot->parts[i].pixel_format = priv->parts[i].pixel_format;
+		slot->parts[i].width = priv->parts[i].width;
+		slot->parts[i].height = priv->parts[i].height;
+		slot->parts[i].x_offset = priv->parts[i].x_offset;
+		slot->parts[i].y_offset = priv->parts[i].y_offset;
+		slot->parts[i].x_padding = priv->parts[i].x_padding;
+		slot->parts[i].y_padding = priv->parts[i].y_padding;
+	}
+}
+
+/* Sets the buffer description from the slot descriptor, the buffer data pointing to the slot data */
+
+void
+arv_shared_ring_load_buffer (ArvSharedRingSlot *slot, ArvBuffer *buffer)
+{
+	ArvBufferPrivate *priv = buffer->priv;
+	guint i;
+
+	priv->received_size = MIN (slot->received_size, priv->allocated_size);
+	priv->frame_id = slot->frame_id;
+	priv->timestamp_ns = slot->timestamp_ns;
+	priv->system_timestamp_ns = slot->system_timestamp_ns;
+	priv->status = slot->status;
+	priv->payload_type = slot->payload_type;
+	priv->pixel_format = slot->pixel_format;
+	priv->x_offset = slot->x_offset;
+	priv->y_offset = slot->y_offset;
+	priv->width = slot->width;
+	priv->height = slot->height;
+	priv->x_padding = slot->x_padding;
+	priv->chunk_endianness = slot->chunk_endianness;
+	priv->has_chunk_index = FALSE;
+
+	arv_buffer_set_n_parts (buffer, MIN (slot->n_parts, ARV_SHARED_RING_MAX_PARTS));
+	for (i = 0; i < priv->n_parts; i++) {
+		priv->parts[i].data_offset = slot->parts[i].data_offset;
+		priv->parts[i].size = slot->parts[i].size;
+		priv->parts[i].component_id = slot->parts[i].component_id;
+		priv->parts[i].data_type = slot->parts[i].data_type;
+		priv->parts[i].pixel_format = slot->parts[i].pixel_format;
+		priv->parts[i].width = slot->parts[i].width;
+		priv->parts[i].height = slot->parts[i].height;
+		priv->parts[i].x_offset = slot->parts[i].x_offset;
+		priv->parts[i].y_offset = slot->parts[i].y_offset;
+		priv->parts[i].x_padding = slot->parts[i].x_padding;
+		priv->parts[i].y_padding = slot->parts[i].y_padding;
+	}
+}
+
+#endif
@@ -0,0 +1,129 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_SHARED_RING_PRIVATE_H
+#define ARV_SHARED_RING_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvbuffer.h>
+#include <arvrecorder.h>
+#include <arvfeatures.h>
+
+#if ARAVIS_HAS_SHARED_MEMORY
+#include <pthread.h>
+#include <sys/types.h>
+#endif
+
+G_BEGIN_DECLS
+
+#define ARV_SHARED_RING_MAGIC		0x53565241
+#define ARV_SHARED_RING_VERSION		1
+#define ARV_SHARED_RING_MAX_READERS	32
+#define ARV_SHARED_RING_MAX_PARTS	8
+#define ARV_SHARED_RING_ALIGNMENT	4096
+
+#if ARAVIS_HAS_SHARED_MEMORY
+
+/* Frame slot of a shared ring. The slot data is only written by the stream thread of the publisher, while the slot is
+ * neither published nor held by a reader. */
+
+typedef struct {
+	/* Publication number of the frame in the slot, starting at 1 */
+	guint64 sequence;
+	/* Set while the slot is in the publication history, readers can only take published slots */
+	guint32 is_published;
+	/* One bit per reader holding the slot */
+	guint32 reader_mask;
+
+	guint64 data_offset;
+
+	guint64 received_size;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint32 status;
+	guint32 payload_type;
+	guint32 pixel_format;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 width;
+	guint32 height;
+	guint32 x_padding;
+	guint32 chunk_endianness;
+	guint32 n_parts;
+	ArvRecorderPartHeader parts[ARV_SHARED_RING_MAX_PARTS];
+} ArvSharedRingSlot;
+
+/* Header at the start of the shared memory segment, followed by the slot descriptors. The slot data start at
+ * ARV_SHARED_RING_ALIGNMENT boundaries. All the fields, except the constant ones, are protected by the mutex. */
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	guint32 n_slots;
+	guint32 history_depth;
+	guint64 slot_size;
+	guint64 segment_size;
+
+	pthread_mutex_t mutex;
+	/* Broadcast on each publication, and when the publisher stops */
+	pthread_cond_t frame_cond;
+
+	guint64 n_published;
+	guint32 is_publisher_alive;
+	guint32 reserved;
+
+	/* Process id of the connected readers, 0 for a free reader entry */
+	pid_t reader_pids[ARV_SHARED_RING_MAX_READERS];
+
+	ArvSharedRingSlot slots[];
+} ArvSharedRingHeader;
+
+/* Mapping of a segment, released when its owner and all the buffers pointing to its slots are released */
+
+typedef struct {
+	gint ref_count;
+	ArvSharedRingHeader *header;
+	size_t size;
+} ArvSharedRingMap;
+
+ArvSharedRingMap *	arv_shared_ring_map_new		(int fd, size_t size);
+ArvSharedRingMap *	arv_shared_ring_map_ref		(ArvSharedRingMap *map);
+void			arv_shared_ring_map_unref	(void *map);
+
+char *		arv_shared_ring_get_shm_name	(const char *name);
+size_t		arv_shared_ring_get_header_size	(guint n_slots);
+
+void		arv_shared_ring_lock		(ArvSharedRingHeader *header);
+void		arv_shared_ring_unlock		(ArvSharedRingHeader *header);
+
+void		arv_shared_ring_store_buffer	(ArvSharedRingSlot *slot, ArvBuffer *buffer);
+void		arv_shared_ring_load_buffer	(ArvSharedRingSlot *slot, ArvBuffer *buffer);
+
+#endif
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,483 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvSharedStream:
+ *
+ * [class@ArvSharedStream] receives the buffers published in a shared memory ring by an [class@ArvSharedPublisher],
+ * usually running in another process.
+ *
+ * The buffers are ordinary [class@ArvBuffer] objects, whose data point to the ring slots. A popped buffer is held by
+ * the reader until it is given back using [method@ArvSharedStream.push_buffer], the publisher not reusing its slot
+ * in the meantime. The buffers are retrieved in publication order. The frames which left the publication history
+ * before being popped are missed, and counted in the statistics.
+ */
+
+#include <arvsharedstream.h>
+#include <arvsharedringprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#if ARAVIS_HAS_SHARED_MEMORY
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+GQuark
+arv_shared_stream_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-shared-stream-error-quark");
+}
+
+typedef struct {
+#if ARAVIS_HAS_SHARED_MEMORY
+	ArvSharedRingMap *map;
+#endif
+	ArvBuffer **buffers;
+	guint n_slots;
+	guint reader_id;
+
+	/* Protected by the ring lock */
+	guint64 last_sequence;
+	guint64 n_received_buffers;
+	guint64 n_missed_buffers;
+} ArvSharedStreamPrivate;
+
+struct _ArvSharedStream {
+	GObject	object;
+
+	ArvSharedStreamPrivate *priv;
+};
+
+struct _ArvSharedStreamClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvSharedStream, arv_shared_stream, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvSharedStream))
+
+#if ARAVIS_HAS_SHARED_MEMORY
+
+static gboolean
+_check_segment (ArvSharedRingHeader *header, size_t size)
+{
+	guint i;
+
+	if (size < sizeof (ArvSharedRingHeader) ||
+	    header->magic != ARV_SHARED_RING_MAGIC ||
+	    header->version != ARV_SHARED_RING_VERSION ||
+	    header->segment_size != size ||
+	    header->n_slots < 1 ||
+	    arv_shared_ring_get_header_size (header->n_slots) > size)
+		return FALSE;
+
+	for (i = 0; i < header->n_slots; i++)
+		if (header->slots[i].data_offset < arv_shared_ring_get_header_size (header->n_slots) ||
+		    header->slots[i].data_offset > size ||
+		    size - header->slots[i].data_offset < header->slot_size)
+			return FALSE;
+
+	return TRUE;
+}
+
+/* Takes the oldest published slot newer than the last popped one, waiting until @deadline_us, in monotonic time, if
+ * none is available. A negative deadline means no timeout. */
+
+static ArvBuffer *
+_pop_buffer (ArvSharedStream *stream, gint64 deadline_us)
+{
+	ArvSharedStreamPrivate *priv = stream->priv;
+	ArvSharedRingHeader *header = priv->map->header;
+	ArvBuffer *buffer = NULL;
+	struct timespec deadline;
+	gint slot_id = -1;
+
+	if (deadline_us >= 0) {
+		deadline.tv_sec = deadline_us / G_USEC_PER_SEC;
+		deadline.tv_nsec = (deadline_us % G_USEC_PER_SEC) * 1000;
+	}
+
+	arv_shared_ring_lock (header);
+
+	do {
+		guint64 sequence = G_MAXUINT64;
+		guint i;
+
+		for (i = 0; i < priv->n_slots; i++) {
+			ArvSharedRingSlot *slot = &header->slots[i];
+
+			if (slot->is_published && slot->sequence > priv->last_sequence && slot->sequence < sequence) {
+				sequence = slot->sequence;
+				slot_id = i;
+			}
+		}
+
+		if (slot_id >= 0) {
+			ArvSharedRingSlot *slot = &header->slots[slot_id];
+
+			slot->reader_mask |= 1U << priv->reader_id;
+
+			priv->n_missed_buffers += slot->sequence - priv->last_sequence - 1;
+			priv->n_received_buffers++;
+			priv->last_sequence = slot->sequence;
+
+			buffer = g_object_ref (priv->buffers[slot_id]);
+			arv_shared_ring_load_buffer (slot, buffer);
+			break;
+		}
+
+		if (!header->is_publisher_alive || deadline_us == 0)
+			break;
+
+		if (deadline_us < 0) {
+			if (pthread_cond_wait (&header->frame_cond, &header->mutex) == EOWNERDEAD)
+				pthread_mutex_consistent (&header->mutex);
+		} else {
+			int result = pthread_cond_timedwait (&header->frame_cond, &header->mutex, &deadline);
+
+			if (result == EOWNERDEAD)
+				pthread_mutex_consistent (&header->mutex);
+			else if (result == ETIMEDOUT)
+				break;
+		}
+	} while (TRUE);
+
+	arv_shared_ring_unlock (header);
+
+	return buffer;
+}
+
+static gint64
+_get_monotonic_time_us (void)
+{
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+
+	return (gint64) now.tv_sec * G_USEC_PER_SEC + now.tv_nsec / 1000;
+}
+
+#endif
+
+/**
+ * arv_shared_stream_new:
+ * @name: name of the shared stream, as given to [ctor@SharedPublisher.new]
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Connects to a shared stream published on the same host. Only the frames published after the connection are
+ * received.
+ *
+ * Returns: (transfer full): a new #ArvSharedStream, %NULL on error.
+ *
+ * Since: 0.8.24
+ */
+
+ArvSharedStream *
+arv_shared_stream_new (const char *name, GError **error)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	ArvSharedStream *stream;
+	ArvSharedRingHeader *header;
+	ArvSharedRingMap *map;
+	struct stat st;
+	char *shm_name;
+	gint reader_id = -1;
+	guint i;
+	int fd;
+
+	g_return_val_if_fail (name != NULL, NULL);
+
+	if (name[0] == '\0' || strchr (name, '/') != NULL) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_INVALID_NAME,
+			     "Invalid shared stream name '%s'", name);
+		return NULL;
+	}
+
+	shm_name = arv_shared_ring_get_shm_name (name);
+
+	fd = shm_open (shm_name, O_RDWR, 0);
+	if (fd < 0) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_NOT_FOUND,
+			     "Failed to open shared memory '%s': %s", shm_name, strerror (errno));
+		g_free (shm_name);
+		return NULL;
+	}
+
+	map = NULL;
+	if (fstat (fd, &st) == 0 && st.st_size > 0)
+		map = arv_shared_ring_map_new (fd, st.st_size);
+	close (fd);
+
+	if (map == NULL || !_check_segment (map->header, map->size)) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_INVALID_SEGMENT,
+			     "Invalid shared memory '%s'", shm_name);
+		arv_shared_ring_map_unref (map);
+		g_free (shm_name);
+		return NULL;
+	}
+
+	header = map->header;
+
+	stream = g_object_new (ARV_TYPE_SHARED_STREAM, NULL);
+	stream->priv->map = map;
+	stream->priv->n_slots = header->n_slots;
+
+	arv_shared_ring_lock (header);
+	for (i = 0; i < ARV_SHARED_RING_MAX_READERS && reader_id < 0; i++) {
+		if (header->reader_pids[i] == 0) {
+			header->reader_pids[i] = getpid ();
+			reader_id = i;
+		}
+	}
+	stream->priv->last_sequence = header->n_published;
+	arv_shared_ring_unlock (header);
+
+	if (reader_id < 0) {
+		g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_TOO_MANY_READERS,
+			     "Too many readers of '%s'", shm_name);
+		g_object_unref (stream);
+		g_free (shm_name);
+		return NULL;
+	}
+	stream->priv->reader_id = reader_id;
+
+	stream->priv->buffers = g_new (ArvBuffer *, header->n_slots);
+	for (i = 0; i < header->n_slots; i++)
+		stream->priv->buffers[i] =
+			arv_buffer_new_take_data (header->slot_size, (char *) header + header->slots[i].data_offset,
+						  arv_shared_ring_map_ref (map), arv_shared_ring_map_unref);
+
+	arv_info_stream ("[SharedStream::new] Connected to '%s' as reader %d (%u slots of %" G_GUINT64_FORMAT
+			 " bytes)", shm_name, reader_id, header->n_slots, header->slot_size);
+
+	g_free (shm_name);
+
+	return stream;
+#else
+	g_set_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_NOT_SUPPORTED,
+		     "Shared memory streams are not supported on this platform");
+	return NULL;
+#endif
+}
+
+/**
+ * arv_shared_stream_pop_buffer:
+ * @stream: a #ArvSharedStream
+ *
+ * Pops a buffer from the shared stream, waiting for a new frame if none is available.
+ *
+ * Returns: (transfer full): a #ArvBuffer, %NULL if the publisher stopped.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_shared_stream_pop_buffer (ArvSharedStream *stream)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	g_return_val_if_fail (ARV_IS_SHARED_STREAM (stream), NULL);
+
+	return _pop_buffer (stream, -1);
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * arv_shared_stream_try_pop_buffer:
+ * @stream: a #ArvSharedStream
+ *
+ * Pops a buffer from the shared stream, without waiting.
+ *
+ * Returns: (transfer full): a #ArvBuffer, %NULL if no new frame is available.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_shared_stream_try_pop_buffer (ArvSharedStream *stream)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	g_return_val_if_fail (ARV_IS_SHARED_STREAM (stream), NULL);
+
+	return _pop_buffer (stream, 0);
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * arv_shared_stream_timeout_pop_buffer:
+ * @stream: a #ArvSharedStream
+ * @timeout: timeout, in µs
+ *
+ * Pops a buffer from the shared stream, waiting for a new frame at most @timeout µs.
+ *
+ * Returns: (transfer full): a #ArvBuffer, %NULL if no new frame was published before the timeout.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_shared_stream_timeout_pop_buffer (ArvSharedStream *stream, guint64 timeout)
+{
+#if ARAVIS_HAS_SHARED_MEMORY
+	g_return_val_if_fail (ARV_IS_SHARED_STREAM (stream), NULL);
+
+	return _pop_buffer (stream, _get_monotonic_time_us () + MIN (timeout, G_MAXINT64 / 2));
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * arv_shared_stream_push_buffer:
+ * @stream: a #ArvSharedStream
+ * @buffer: (transfer full): a buffer popped from @stream
+ *
+ * Gives back a buffer to the shared stream, its slot being reusable by the publisher once released by all the
+ * readers.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_shared_stream_push_buffer (ArvSharedStream *stream, ArvBuffer *buffer)
+{
+	guint i;
+
+	g_return_if_fail (ARV_IS_SHARED_STREAM (stream));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	for (i = 0; i < stream->priv->n_slots; i++)
+		if (stream->priv->buffers[i] == buffer)
+			break;
+
+	g_return_if_fail (i < stream->priv->n_slots);
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	arv_shared_ring_lock (stream->priv->map->header);
+	stream->priv->map->header->slots[i].reader_mask &= ~(1U << stream->priv->reader_id);
+	arv_shared_ring_unlock (stream->priv->map->header);
+#endif
+
+	g_object_unref (buffer);
+}
+
+/**
+ * arv_shared_stream_is_publisher_alive:
+ * @stream: a #ArvSharedStream
+ *
+ * Returns: %TRUE until the publisher stops.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_shared_stream_is_publisher_alive (ArvSharedStream *stream)
+{
+	gboolean is_alive = FALSE;
+
+	g_return_val_if_fail (ARV_IS_SHARED_STREAM (stream), FALSE);
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	arv_shared_ring_lock (stream->priv->map->header);
+	is_alive = stream->priv->map->header->is_publisher_alive;
+	arv_shared_ring_unlock (stream->priv->map->header);
+#endif
+
+	return is_alive;
+}
+
+/**
+ * arv_shared_stream_get_statistics:
+ * @stream: a #ArvSharedStream
+ * @n_received_buffers: (out) (optional): number of popped buffers
+ * @n_missed_buffers: (out) (optional): number of published buffers which left the history before being popped
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_shared_stream_get_statistics (ArvSharedStream *stream, guint64 *n_received_buffers, guint64 *n_missed_buffers)
+{
+	g_return_if_fail (ARV_IS_SHARED_STREAM (stream));
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	arv_shared_ring_lock (stream->priv->map->header);
+#endif
+	if (n_received_buffers != NULL)
+		*n_received_buffers = stream->priv->n_received_buffers;
+	if (n_missed_buffers != NULL)
+		*n_missed_buffers = stream->priv->n_missed_buffers;
+#if ARAVIS_HAS_SHARED_MEMORY
+	arv_shared_ring_unlock (stream->priv->map->header);
+#endif
+}
+
+static void
+arv_shared_stream_init (ArvSharedStream *stream)
+{
+	stream->priv = arv_shared_stream_get_instance_private (stream);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvSharedStream *stream = ARV_SHARED_STREAM (object);
+	guint i;
+
+#if ARAVIS_HAS_SHARED_MEMORY
+	if (stream->priv->buffers != NULL) {
+		ArvSharedRingHeader *header = stream->priv->map->header;
+
+		/* Releases the slots still held. The buffers not given back keep the segment mapped, but their slot
+		 * may be reused by the publisher. */
+		arv_shared_ring_lock (header);
+		for (i = 0; i < stream->priv->n_slots; i++)
+			header->slots[i].reader_mask &= ~(1U << stream->priv->reader_id);
+		header->reader_pids[stream->priv->reader_id] = 0;
+		arv_shared_ring_unlock (header);
+	}
+
+	arv_shared_ring_map_unref (stream->priv->map);
+#endif
+
+	if (stream->priv->buffers != NULL)
+		for (i = 0; i < stream->priv->n_slots; i++)
+			g_object_unref (stream->priv->buffers[i]);
+	g_free (stream->priv->buffers);
+
+	G_OBJECT_CLASS (arv_shared_stream_parent_class)->finalize (object);
+}
+
+static void
+arv_shared_stream_class_init (ArvSharedStreamClass *stream_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (stream_class);
+
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,77 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_SHARED_STREAM_H
+#define ARV_SHARED_STREAM_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+#define ARV_SHARED_STREAM_ERROR arv_shared_stream_error_quark()
+
+ARV_API GQuark		arv_shared_stream_error_quark		(void);
+
+/**
+ * ArvSharedStreamError:
+ * @ARV_SHARED_STREAM_ERROR_NOT_SUPPORTED: shared memory streams are not supported on this platform
+ * @ARV_SHARED_STREAM_ERROR_INVALID_NAME: the shared stream name is not valid
+ * @ARV_SHARED_STREAM_ERROR_NOT_FOUND: no shared stream of this name is published
+ * @ARV_SHARED_STREAM_ERROR_INVALID_SEGMENT: the shared memory segment has an unexpected format
+ * @ARV_SHARED_STREAM_ERROR_TOO_MANY_READERS: the maximum number of readers is reached
+ * @ARV_SHARED_STREAM_ERROR_ALLOCATION_FAILURE: the shared memory segment can not be allocated
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_SHARED_STREAM_ERROR_NOT_SUPPORTED,
+	ARV_SHARED_STREAM_ERROR_INVALID_NAME,
+	ARV_SHARED_STREAM_ERROR_NOT_FOUND,
+	ARV_SHARED_STREAM_ERROR_INVALID_SEGMENT,
+	ARV_SHARED_STREAM_ERROR_TOO_MANY_READERS,
+	ARV_SHARED_STREAM_ERROR_ALLOCATION_FAILURE
+} ArvSharedStreamError;
+
+#define ARV_TYPE_SHARED_STREAM             (arv_shared_stream_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvSharedStream, arv_shared_stream, ARV, SHARED_STREAM, GObject)
+
+ARV_API ArvSharedStream *	arv_shared_stream_new			(const char *name, GError **error);
+
+ARV_API ArvBuffer *		arv_shared_stream_pop_buffer		(ArvSharedStream *stream);
+ARV_API ArvBuffer *		arv_shared_stream_try_pop_buffer	(ArvSharedStream *stream);
+ARV_API ArvBuffer *		arv_shared_stream_timeout_pop_buffer	(ArvSharedStream *stream, guint64 timeout);
+ARV_API void			arv_shared_stream_push_buffer		(ArvSharedStream *stream, ArvBuffer *buffer);
+
+ARV_API gboolean		arv_shared_stream_is_publisher_alive	(ArvSharedStream *stream);
+ARV_API void			arv_shared_stream_get_statistics	(ArvSharedStream *stream, guint64 *n_received_buffers,
+									 guint64 *n_missed_buffers);
+
+G_END_DECLS
+
+#endif
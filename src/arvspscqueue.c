@@ -0,0 +1,296 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * ArvSpscQueue is a bounded single producer, single consumer queue. Push and pop operations don't take any lock, the
+ * mutex and condition being only used when the consumer has to wait for data, in which case the producer signals it.
+ * Pushes must be serialized, as well as pops, but may be done from different threads.
+ */
+
+#include <arvspscqueueprivate.h>
+
+#define ARV_SPSC_QUEUE_CACHE_LINE_SIZE	64
+
+struct _ArvSpscQueue {
+	gpointer *slots;
+	guint mask;
+
+	/* Written by the consumer */
+	char padding_0[ARV_SPSC_QUEUE_CACHE_LINE_SIZE];
+	guint head;
+
+	/* Written by the producer */
+	char padding_1[ARV_SPSC_QUEUE_CACHE_LINE_SIZE - sizeof (guint)];
+	guint tail;
+
+	char padding_2[ARV_SPSC_QUEUE_CACHE_LINE_SIZE - sizeof (guint)];
+	gint n_waiting_consumers;
+	GMutex mutex;
+	GCond cond;
+};
+
+/**
+ * arv_spsc_queue_new:
+ * @capacity: maximum number of elements, rounded up to a power of 2
+ *
+ * Returns: a new #ArvSpscQueue
+ */
+
+ArvSpscQueue *
+arv_spsc_queue_new (guint capacity)
+{
+	ArvSpscQueue *queue;
+	guint size = 1;
+
+	g_return_val_if_fail (capacity > 0 && capacity <= G_MAXINT / 2, NULL);
+
+	while (size < capacity)
+		size <<= 1;
+
+	queue = g_new0 (ArvSpscQueue, 1);
+	queue->slots = g_new0 (gpointer, size);
+	queue->mask = size - 1;
+
+	g_mutex_init (&queue->mutex);
+	g_cond_init (&queue->cond);
+
+	return queue;
+}
+
+void
+arv_spsc_queue_free (ArvSpscQueue *queue)
+{
+	if (queue == NULL)
+		return;
+
+	g_mutex_clear (&queue->mutex);
+	g_cond_clear (&queue->cond);
+	g_free (queue->slots);
+	g_free (queue);
+}
+
+guint
+arv_spsc_queue_get_capacity (ArvSpscQueue *queue)
+{
+	g_return_val_if_fail (queue != NULL, 0);
+
+	return queue->mask + 1;
+}
+
+guint
+arv_spsc_queue_length (ArvSpscQueue *queue)
+{
+	g_return_val_if_fail (queue != NULL, 0);
+
+	return (guint) g_atomic_int_get (&queue->tail) - (guint) g_atomic_int_get (&queue->head);
+}
+
+static void
+_signal_consumer (ArvSpscQueue *queue)
+{
+	/* The tail update and the read of n_waiting_consumers are ordered, as are the increment of n_waiting_consumers
+	 * and the empty queue check on the consumer side, which guarantees a waiting consumer is always signaled */
+	if (g_atomic_int_get (&queue->n_waiting_consumers) > 0) {
+		g_mutex_lock (&queue->mutex);
+		g_cond_signal (&queue->cond);
+		g_mutex_unlock (&queue->mutex);
+	}
+}
+
+/**
+ * arv_spsc_queue_push:
+ * @queue: a #ArvSpscQueue
+ * @data: a non %NULL pointer
+ *
+ * Returns: %TRUE on success, %FALSE if @queue is full.
+ */
+
+gboolean
+arv_spsc_queue_push (ArvSpscQueue *queue, gpointer data)
+{
+	guint tail;
+
+	g_return_val_if_fail (queue != NULL, FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+
+	tail = g_atomic_int_get (&queue->tail);
+	if (tail - (guint) g_atomic_int_get (&queue->head) > queue->mask)
+		return FALSE;
+
+	queue->slots[tail & queue->mask] = data;
+	g_atomic_int_set (&queue->tail, tail + 1);
+
+	_signal_consumer (queue);
+
+	return TRUE;
+}
+
+/**
+ * arv_spsc_queue_push_many:
+ * @queue: a #ArvSpscQueue
+ * @data: an array of non %NULL pointers
+ * @n_elements: number of elements of @data
+ *
+ * Pushes the elements of @data in order, with a single update of the queue tail.
+ *
+ * Returns: the number of pushed elements, which is less than @n_elements if @queue is full.
+ */
+
+guint
+arv_spsc_queue_push_many (ArvSpscQueue *queue, gpointer *data, guint n_elements)
+{
+	guint tail;
+	guint n_free;
+	guint i;
+
+	g_return_val_if_fail (queue != NULL, 0);
+	g_return_val_if_fail (data != NULL || n_elements == 0, 0);
+
+	tail = g_atomic_int_get (&queue->tail);
+	n_free = queue->mask + 1 - (tail - (guint) g_atomic_int_get (&queue->head));
+	n_elements = MIN (n_elements, n_free);
+	if (n_elements == 0)
+		return 0;
+
+	for (i = 0; i < n_elements; i++)
+		queue->slots[(tail + i) & queue->mask] = data[i];
+	g_atomic_int_set (&queue->tail, tail + n_elements);
+
+	_signal_consumer (queue);
+
+	return n_elements;
+}
+
+/**
+ * arv_spsc_queue_try_pop_many:
+ * @queue: a #ArvSpscQueue
+ * @data: an array of at least @max_elements pointers
+ * @max_elements: maximum number of elements to pop
+ *
+ * Pops the oldest elements of @queue, up to @max_elements, with a single update of the queue head.
+ *
+ * Returns: the number of elements stored in @data, 0 if @queue is empty.
+ */
+
+guint
+arv_spsc_queue_try_pop_many (ArvSpscQueue *queue, gpointer *data, guint max_elements)
+{
+	guint head;
+	guint n_elements;
+	guint i;
+
+	g_return_val_if_fail (queue != NULL, 0);
+	g_return_val_if_fail (data != NULL || max_elements == 0, 0);
+
+	head = g_atomic_int_get (&queue->head);
+	n_elements = MIN ((guint) g_atomic_int_get (&queue->tail) - head, max_elements);
+
+	for (i = 0; i < n_elements; i++)
+		data[i] = queue->slots[(head + i) & queue->mask];
+	if (n_elements > 0)
+		g_atomic_int_set (&queue->head, head + n_elements);
+
+	return n_elements;
+}
+
+/**
+ * arv_spsc_queue_try_pop:
+ * @queue: a #ArvSpscQueue
+ *
+ * Returns: the oldest element of @queue, %NULL if @queue is empty.
+ */
+
+gpointer
+arv_spsc_queue_try_pop (ArvSpscQueue *queue)
+{
+	gpointer data;
+	guint head;
+
+	g_return_val_if_fail (queue != NULL, NULL);
+
+	head = g_atomic_int_get (&queue->head);
+	if (head == (guint) g_atomic_int_get (&queue->tail))
+		return NULL;
+
+	data = queue->slots[head & queue->mask];
+	g_atomic_int_set (&queue->head, head + 1);
+
+	return data;
+}
+
+static gpointer
+_wait_pop (ArvSpscQueue *queue, gboolean wait_forever, gint64 end_time)
+{
+	gpointer data;
+
+	data = arv_spsc_queue_try_pop (queue);
+	if (data != NULL)
+		return data;
+
+	g_mutex_lock (&queue->mutex);
+	g_atomic_int_inc (&queue->n_waiting_consumers);
+
+	while ((data = arv_spsc_queue_try_pop (queue)) == NULL) {
+		if (wait_forever)
+			g_cond_wait (&queue->cond, &queue->mutex);
+		else if (!g_cond_wait_until (&queue->cond, &queue->mutex, end_time)) {
+			data = arv_spsc_queue_try_pop (queue);
+			break;
+		}
+	}
+
+	g_atomic_int_add (&queue->n_waiting_consumers, -1);
+	g_mutex_unlock (&queue->mutex);
+
+	return data;
+}
+
+/**
+ * arv_spsc_queue_timeout_pop:
+ * @queue: a #ArvSpscQueue
+ * @timeout_us: timeout, in µs
+ *
+ * Returns: the oldest element of @queue, waiting no more than @timeout_us for it, or %NULL if the timeout occurs.
+ */
+
+gpointer
+arv_spsc_queue_timeout_pop (ArvSpscQueue *queue, guint64 timeout_us)
+{
+	g_return_val_if_fail (queue != NULL, NULL);
+
+	return _wait_pop (queue, FALSE, g_get_monotonic_time () + MIN (timeout_us, G_MAXINT64 / 2));
+}
+
+/**
+ * arv_spsc_queue_pop:
+ * @queue: a #ArvSpscQueue
+ *
+ * Returns: the oldest element of @queue, waiting for it if @queue is empty.
+ */
+
+gpointer
+arv_spsc_queue_pop (ArvSpscQueue *queue)
+{
+	g_return_val_if_fail (queue != NULL, NULL);
+
+	return _wait_pop (queue, TRUE, 0);
+}
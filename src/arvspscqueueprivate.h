@@ -0,0 +1,50 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_SPSC_QUEUE_PRIVATE_H
+#define ARV_SPSC_QUEUE_PRIVATE_H
+
+#include <arvapi.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvSpscQueue ArvSpscQueue;
+
+/* private, but used by tests */
+ARV_API ArvSpscQueue *	arv_spsc_queue_new		(guint capacity);
+ARV_API void		arv_spsc_queue_free		(ArvSpscQueue *queue);
+
+ARV_API guint		arv_spsc_queue_get_capacity	(ArvSpscQueue *queue);
+ARV_API guint		arv_spsc_queue_length		(ArvSpscQueue *queue);
+
+ARV_API gboolean	arv_spsc_queue_push		(ArvSpscQueue *queue, gpointer data);
+ARV_API gpointer	arv_spsc_queue_try_pop		(ArvSpscQueue *queue);
+ARV_API gpointer	arv_spsc_queue_timeout_pop	(ArvSpscQueue *queue, guint64 timeout_us);
+ARV_API gpointer	arv_spsc_queue_pop		(ArvSpscQueue *queue);
+
+ARV_API guint		arv_spsc_queue_push_many	(ArvSpscQueue *queue, gpointer *data, guint n_elements);
+ARV_API guint		arv_spsc_queue_try_pop_many	(ArvSpscQueue *queue, gpointer *data, guint max_elements);
+
+G_END_DECLS
+
+#endif
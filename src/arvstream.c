@@ -28,21 +28,107 @@
  * stream reception threads. The interface between the reception thread and the
  * main thread is done using asynchronous queues, containing #ArvBuffer
  * objects.
+ *
+ * Bounded lock-free queues can be used instead of the default ones, using the
+ * #ArvStream:lock-free-queue-size property. Unlike the asynchronous queues, they don't allocate a list node per
+ * buffer, and with them the GigE Vision and USB3 Vision stream threads don't allocate memory once the first frames are
+ * received, packet resend requests included, as long as no stage worker is used.
+ *
+ * Along with the transport specific counters, the stream informations provide approximate percentiles of the
+ * latency of the successfully received buffers, in µs: "latency_transfer_*" from the first to the last packet of a
+ * frame, "latency_completion_*" from the last packet to the push in the output queue, "latency_delivery_*" from the
+ * output queue to the application, and "latency_total_*" from the first packet to the application. Each stage is
+ * available as "_p50_us", "_p99_us" and "_max_us" values, of %G_TYPE_DOUBLE type.
+ *
+ * The "frame_rate_*", "failure_rate_*" and "byte_rate_*" informations are the rates of the successfully received
+ * buffers, of the failed ones and of their payload bytes, per second, over sliding windows of the last second, 10
+ * seconds and minute, available as "_1s", "_10s" and "_60s" values of %G_TYPE_DOUBLE type. Unlike the cumulative
+ * counters, they don't hide the short bursts of failures in the averages since the stream creation.
  */
 
 #include <arvstreamprivate.h>
-#include <arvbuffer.h>
-#include <arvdevice.h>
+#include <arvbufferprivate.h>
+#include <arvbufferpool.h>
+#include <arvdeviceprivate.h>
 #include <arvdebugprivate.h>
+#include <arvmiscprivate.h>
+#include <arvenumtypes.h>
+#include <arvspscqueueprivate.h>
+#include <arvwakeupprivate.h>
+#include <arvtraceprivate.h>
+#include <arvrealtime.h>
 #include <gio/gio.h>
+#include <math.h>
 
 typedef struct {
         char *name;
         char *description;
         GType type;
         gpointer data;
+
+	/* Computed on read from a histogram variable, for the informations declared by
+	 * arv_stream_declare_histogram_infos() */
+	ArvHdrHistogram *histogram;
+	guint histogram_id;
+	double percentile;
+
+	/* Computed on read from a rate window, for the informations declared by arv_stream_declare_rate_infos() */
+	ArvRateWindow *rate_window;
+	guint rate_window_id;
+	guint rate_duration_s;
 } ArvStreamInfo;
 
+static const struct {
+	const char *suffix;
+	double percentile;
+} arv_stream_histogram_infos[] = {
+	{"p50_us",	50.0},
+	{"p99_us",	99.0},
+	{"p999_us",	99.9},
+	{"p9999_us",	99.99},
+	{"max_us",	100.0}
+};
+
+/* Durations of the sliding windows of the rate informations, in s */
+static const guint arv_stream_rate_durations_s[] = {1, 10, 60};
+
+/* Latency distributions are accumulated in logarithmic bins, with a quarter octave resolution. Bin counts are halved
+ * every ARV_STREAM_LATENCY_DECAY_PERIOD samples, in order to follow the recent frames. */
+
+#define ARV_STREAM_LATENCY_N_BINS		128
+#define ARV_STREAM_LATENCY_BINS_PER_OCTAVE	4
+#define ARV_STREAM_LATENCY_DECAY_PERIOD		2048
+
+/* Automatic buffer count: input queue length considered as a pressure, period without pressure before a shrink, and
+ * interval between two shrinks */
+#define ARV_STREAM_AUTO_BUFFERS_LOW_WATERMARK		1
+#define ARV_STREAM_AUTO_BUFFERS_STABLE_PERIOD_US	10000000
+#define ARV_STREAM_AUTO_BUFFERS_SHRINK_INTERVAL_US	1000000
+
+typedef enum {
+	ARV_STREAM_LATENCY_STAGE_TRANSFER,
+	ARV_STREAM_LATENCY_STAGE_COMPLETION,
+	ARV_STREAM_LATENCY_STAGE_DELIVERY,
+	ARV_STREAM_LATENCY_STAGE_TOTAL,
+	ARV_STREAM_LATENCY_N_STAGES
+} ArvStreamLatencyStage;
+
+static const char *arv_stream_latency_stage_names[ARV_STREAM_LATENCY_N_STAGES] = {
+	"transfer",
+	"completion",
+	"delivery",
+	"total"
+};
+
+typedef struct {
+	guint32 bins[ARV_STREAM_LATENCY_N_BINS];
+	guint32 n_samples;
+
+	double p50_us;
+	double p99_us;
+	double max_us;
+} ArvStreamLatency;
+
 enum {
 	ARV_STREAM_SIGNAL_NEW_BUFFER,
 	ARV_STREAM_SIGNAL_LAST
@@ -56,23 +142,131 @@ enum {
 	ARV_STREAM_PROPERTY_DEVICE,
 	ARV_STREAM_PROPERTY_CALLBACK,
 	ARV_STREAM_PROPERTY_CALLBACK_DATA,
-	ARV_STREAM_PROPERTY_DESTROY_NOTIFY
+	ARV_STREAM_PROPERTY_DESTROY_NOTIFY,
+	ARV_STREAM_PROPERTY_LOCK_FREE_QUEUE_SIZE,
+	ARV_STREAM_PROPERTY_CPU_AFFINITY,
+	ARV_STREAM_PROPERTY_NUMA_NODE,
+	ARV_STREAM_PROPERTY_BUFFER_PROGRESS,
+	ARV_STREAM_PROPERTY_UNPACK_PIXELS,
+	ARV_STREAM_PROPERTY_COMPUTE_STATISTICS,
+	ARV_STREAM_PROPERTY_STATISTICS_GRID_SIZE,
+	ARV_STREAM_PROPERTY_OUTPUT_POLICY,
+	ARV_STREAM_PROPERTY_N_OUTPUT_BUFFERS,
+	ARV_STREAM_PROPERTY_N_STAGE_WORKERS,
+	ARV_STREAM_PROPERTY_SIGNAL_BATCHING,
+	ARV_STREAM_PROPERTY_N_BATCH_FRAMES,
+	ARV_STREAM_PROPERTY_BATCH_TIMEOUT,
+	ARV_STREAM_PROPERTY_LOCK_MEMORY
 } ArvStreamProperties;
 
 typedef struct {
 	GAsyncQueue *input_queue;
 	GAsyncQueue *output_queue;
+
+	/* Lock-free queues, used instead of the asynchronous queues when not NULL */
+	ArvSpscQueue *input_spsc_queue;
+	ArvSpscQueue *output_spsc_queue;
+	/* Number of buffers owned by the stream in lock-free mode */
+	gint n_spsc_buffers;
+
 	GRecMutex mutex;
 	gboolean emit_signals;
+	/* Read by the stream threads without lock */
+	gint signal_batching;
+	gint buffer_progress;
+	gint unpack_pixels;
+	gint compute_statistics;
+	gint statistics_grid_size;
+	gint output_policy;
+	gint n_output_buffers;
+
+	/* Output buffers given back to the input queue by the output policy, updated with the output queue locked */
+	guint64 n_recycled_buffers;
 
 	ArvDevice *device;
 	ArvStreamCallback callback;
 	void *callback_data;
 	GDestroyNotify destroy_notify;
 
+	/* Stream thread placement */
+	char *cpu_affinity;
+	gint numa_node;
+
+	/* Lock the buffers and the stream thread memory, read without lock */
+	gint lock_memory;
+
 	GError *init_error;
 
         GPtrArray *infos;
+
+	GMutex latency_mutex;
+	ArvStreamLatency latencies[ARV_STREAM_LATENCY_N_STAGES];
+
+	/* Processing stages, the list being replaced on each addition */
+	GMutex stage_mutex;
+	GCond stage_cond;
+	GPtrArray *stages;
+	GThreadPool *stage_pool;
+	guint n_stage_workers;
+	/* Buffers in frame order, processed by the workers or waiting for the previous ones */
+	GQueue stage_jobs;
+	gboolean is_delivering_stage_jobs;
+
+	/* Frame batching, the batch being filled and its start time being protected by batch_mutex */
+	gint n_batch_frames;
+	guint64 batch_timeout_us;
+	GAsyncQueue *batch_queue;
+	GMutex batch_mutex;
+	ArvBuffer *batch;
+	guint64 batch_start_us;
+
+	/* Automatic buffer count. The pressure flag is set by the stream thread, the buffers are allocated or released
+	 * by the threads pushing the buffers, under auto_buffers_mutex. */
+	gint auto_buffers;
+	gint auto_buffers_pressure;
+	GMutex auto_buffers_mutex;
+	size_t auto_buffer_size;
+	guint auto_min_buffers;
+	guint auto_max_buffers;
+	gint64 auto_buffers_stable_since_us;
+	guint64 n_auto_buffers;
+	guint64 n_auto_buffer_grows;
+	guint64 n_auto_buffer_shrinks;
+
+	/* Signaled by the stream thread on each output buffer, created on the first readiness fd request */
+	ArvWakeup *ready_wakeup;
+
+	/* Decimated preview, the pool and the latest preview being protected by preview_mutex */
+	guint preview_factor;
+	gboolean preview_debayer;
+	gint64 preview_interval_us;
+	GMutex preview_mutex;
+	GCond preview_cond;
+	gint64 preview_time_us;
+	ArvBufferPool *preview_pool;
+	ArvBuffer *preview_buffer;
+	guint64 n_previews;
+	guint64 n_preview_drops;
+
+	/* Region table of the multiple region payloads, attached to the output buffers. The pointer is read without
+	 * lock by the stream thread, and only dereferenced under regions_mutex. */
+	GMutex regions_mutex;
+	GArray *regions;
+
+	/* Minimum buffer size after a payload size change, stored as a pointer for the lock free reads */
+	gpointer min_buffer_size;
+
+	/* Output counters sampled by the rate window, only updated by the stream thread */
+	ArvRateWindow *rate_window;
+	guint64 n_output_frames;
+	guint64 n_output_failures;
+	guint64 n_output_bytes;
+
+	/* Geometry of the last successful image, only used by the stream thread */
+	gboolean has_output_geometry;
+	guint32 output_width;
+	guint32 output_height;
+	ArvPixelFormat output_pixel_format;
 } ArvStreamPrivate;
 
 static void arv_stream_initable_iface_init (GInitableIface *iface);
@@ -89,11 +283,130 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvStream, arv_stream, G_TYPE_OBJECT,
  * Pushes a #ArvBuffer to the @stream thread. The @stream takes ownership of @buffer,
  * and will free all the buffers still in its queues when destroyed.
  *
- * This method is thread safe.
+ * This method is thread safe, unless lock-free queues are used. In this case, it must not be called concurrently from
+ * different threads, and @buffer is dropped if the stream already owns #ArvStream:lock-free-queue-size buffers.
  *
  * Since: 0.2.0
  */
 
+/* In locked memory mode, the buffer pages are faulted in and locked on their first push */
+
+static void
+_lock_buffer (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (g_atomic_int_get (&priv->lock_memory) == 0 ||
+	    buffer->priv->is_memory_prepared ||
+	    buffer->priv->memory_type != ARV_BUFFER_MEMORY_TYPE_SYSTEM)
+		return;
+
+	buffer->priv->is_memory_locked = arv_memory_lock (buffer->priv->data, buffer->priv->allocated_size);
+	buffer->priv->is_memory_prepared = TRUE;
+}
+
+/* Reallocates the buffers smaller than the size set by arv_stream_grow_buffers(), from the thread owning them */
+
+static void
+_grow_buffer (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	size_t min_buffer_size = GPOINTER_TO_SIZE (g_atomic_pointer_get (&priv->min_buffer_size));
+
+	if (G_LIKELY (buffer->priv->allocated_size >= min_buffer_size))
+		return;
+
+	if (arv_buffer_grow (buffer, min_buffer_size))
+		arv_debug_stream ("[Stream::grow_buffer] Buffer reallocated to %zu bytes", min_buffer_size);
+	else
+		arv_debug_stream ("[Stream::grow_buffer] Buffer of %zu bytes can't be reallocated to %zu bytes",
+				  buffer->priv->allocated_size, min_buffer_size);
+}
+
+/* Prepares a buffer popped by the stream thread for a new frame */
+
+static void
+_reset_input_buffer (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	arv_buffer_statistics_clear (buffer);
+	arv_buffer_compression_clear (buffer);
+	arv_buffer_clear_metadata (buffer);
+	buffer->priv->has_tensor = FALSE;
+	buffer->priv->has_new_geometry = FALSE;
+
+	_grow_buffer (priv, buffer);
+	_lock_buffer (priv, buffer);
+}
+
+/* Grows the buffer set after an input queue pressure observed by the stream thread, or releases @buffer after a
+ * stable period. Returns %TRUE if @buffer was released. */
+
+static gboolean
+_adjust_auto_buffers (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gint64 now_us = g_get_monotonic_time ();
+	gboolean is_released = FALSE;
+	guint n_new_buffers = 0;
+	size_t buffer_size;
+	guint i;
+
+	g_mutex_lock (&priv->auto_buffers_mutex);
+
+	buffer_size = priv->auto_buffer_size;
+
+	if (g_atomic_int_compare_and_exchange (&priv->auto_buffers_pressure, TRUE, FALSE)) {
+		priv->auto_buffers_stable_since_us = now_us;
+		if (priv->n_auto_buffers < priv->auto_max_buffers) {
+			n_new_buffers = MIN (MAX (priv->n_auto_buffers / 2, 1),
+					     priv->auto_max_buffers - priv->n_auto_buffers);
+			priv->n_auto_buffers += n_new_buffers;
+			priv->n_auto_buffer_grows++;
+			arv_info_stream ("[Stream::auto_buffers] Input queue pressure, grow to %" G_GUINT64_FORMAT
+					 " buffers", priv->n_auto_buffers);
+		}
+	} else if (now_us - priv->auto_buffers_stable_since_us > ARV_STREAM_AUTO_BUFFERS_STABLE_PERIOD_US &&
+		   priv->n_auto_buffers > priv->auto_min_buffers &&
+		   buffer->priv->allocated_size >= buffer_size) {
+		/* One buffer per shrink interval, as long as the queue stays above its low watermark */
+		priv->auto_buffers_stable_since_us = now_us - ARV_STREAM_AUTO_BUFFERS_STABLE_PERIOD_US +
+			ARV_STREAM_AUTO_BUFFERS_SHRINK_INTERVAL_US;
+		priv->n_auto_buffers--;
+		priv->n_auto_buffer_shrinks++;
+		is_released = TRUE;
+		arv_info_stream ("[Stream::auto_buffers] Stable input queue, shrink to %" G_GUINT64_FORMAT " buffers",
+				 priv->n_auto_buffers);
+	}
+
+	g_mutex_unlock (&priv->auto_buffers_mutex);
+
+	if (is_released)
+		g_object_unref (buffer);
+
+	for (i = 0; i < n_new_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (buffer_size, NULL));
+
+	return is_released;
+}
+
+/* Called by the stream thread on each input buffer pop */
+
+static void
+_check_auto_buffers_pressure (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	gint n_input_buffers;
+
+	if (!g_atomic_int_get (&priv->auto_buffers))
+		return;
+
+	if (buffer != NULL) {
+		n_input_buffers = priv->input_spsc_queue != NULL ?
+			(gint) arv_spsc_queue_length (priv->input_spsc_queue) :
+			g_async_queue_length (priv->input_queue);
+		if (n_input_buffers > ARV_STREAM_AUTO_BUFFERS_LOW_WATERMARK)
+			return;
+	}
+
+	g_atomic_int_set (&priv->auto_buffers_pressure, TRUE);
+}
+
 void
 arv_stream_push_buffer (ArvStream *stream, ArvBuffer *buffer)
 {
@@ -102,9 +415,209 @@ arv_stream_push_buffer (ArvStream *stream, ArvBuffer *buffer)
 	g_return_if_fail (ARV_IS_STREAM (stream));
 	g_return_if_fail (ARV_IS_BUFFER (buffer));
 
+	ARV_TRACEPOINT (stream_push_buffer, buffer);
+
+	_grow_buffer (priv, buffer);
+	_lock_buffer (priv, buffer);
+
+	if (buffer->priv->batch_frames != NULL) {
+		g_async_queue_push (priv->batch_queue, buffer);
+		return;
+	}
+
+	if (g_atomic_int_get (&priv->auto_buffers) && _adjust_auto_buffers (stream, buffer))
+		return;
+
+	if (priv->input_spsc_queue != NULL) {
+		/* Ensure the output queue can't overflow */
+		if (g_atomic_int_add (&priv->n_spsc_buffers, 1) >=
+		    (gint) arv_spsc_queue_get_capacity (priv->input_spsc_queue) ||
+		    !arv_spsc_queue_push (priv->input_spsc_queue, buffer)) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -1);
+			arv_warning_stream ("[Stream::push_buffer] Lock-free queue is full, drop buffer");
+			g_object_unref (buffer);
+		}
+		return;
+	}
+
 	g_async_queue_push (priv->input_queue, buffer);
 }
 
+/**
+ * arv_stream_push_buffers:
+ * @stream: a #ArvStream
+ * @buffers: (array length=n_buffers) (transfer full): buffers to push
+ * @n_buffers: number of buffers
+ *
+ * Pushes several buffers to the @stream thread, in a single operation on the input queue. This is the batched version
+ * of arv_stream_push_buffer(), with the same thread safety and ownership rules.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_push_buffers (ArvStream *stream, ArvBuffer **buffers, guint n_buffers)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean has_batch_buffers = FALSE;
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (buffers != NULL || n_buffers == 0);
+
+	for (i = 0; i < n_buffers; i++) {
+		g_return_if_fail (ARV_IS_BUFFER (buffers[i]));
+		has_batch_buffers = has_batch_buffers || buffers[i]->priv->batch_frames != NULL;
+	}
+
+	/* The batch buffers go to their own queue, and each push may adjust the automatic buffer count */
+	if (has_batch_buffers || g_atomic_int_get (&priv->auto_buffers)) {
+		for (i = 0; i < n_buffers; i++)
+			arv_stream_push_buffer (stream, buffers[i]);
+		return;
+	}
+
+	for (i = 0; i < n_buffers; i++) {
+		ARV_TRACEPOINT (stream_push_buffer, buffers[i]);
+		_grow_buffer (priv, buffers[i]);
+		_lock_buffer (priv, buffers[i]);
+	}
+
+	if (n_buffers == 0)
+		return;
+
+	if (priv->input_spsc_queue != NULL) {
+		gint capacity = arv_spsc_queue_get_capacity (priv->input_spsc_queue);
+		gint n_owned;
+		guint n_pushed;
+
+		/* Ensure the output queue can't overflow */
+		n_owned = g_atomic_int_add (&priv->n_spsc_buffers, n_buffers);
+		n_pushed = arv_spsc_queue_push_many (priv->input_spsc_queue, (gpointer *) buffers,
+						     CLAMP (capacity - n_owned, 0, (gint) n_buffers));
+		if (n_pushed < n_buffers) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -(gint) (n_buffers - n_pushed));
+			arv_warning_stream ("[Stream::push_buffers] Lock-free queue is full, drop %u buffers",
+					    n_buffers - n_pushed);
+			for (i = n_pushed; i < n_buffers; i++)
+				g_object_unref (buffers[i]);
+		}
+		return;
+	}
+
+	g_async_queue_lock (priv->input_queue);
+	for (i = 0; i < n_buffers; i++)
+		g_async_queue_push_unlocked (priv->input_queue, buffers[i]);
+	g_async_queue_unlock (priv->input_queue);
+}
+
+static double
+_latency_bin_value (guint bin)
+{
+	/* Geometric center of the bin */
+	return bin == 0 ? 0.0 : exp2 (((double) bin - 0.5) / ARV_STREAM_LATENCY_BINS_PER_OCTAVE);
+}
+
+static void
+_latency_add_sample (ArvStreamLatency *latency, guint64 value_us)
+{
+	guint64 count;
+	guint64 p50_count;
+	guint64 p99_count;
+	guint bin;
+	guint i;
+
+	bin = value_us < 1 ? 0 : 1 + (guint) (ARV_STREAM_LATENCY_BINS_PER_OCTAVE * log2 ((double) value_us));
+	if (bin >= ARV_STREAM_LATENCY_N_BINS)
+		bin = ARV_STREAM_LATENCY_N_BINS - 1;
+
+	latency->bins[bin]++;
+	latency->n_samples++;
+
+	if (latency->n_samples >= ARV_STREAM_LATENCY_DECAY_PERIOD) {
+		latency->n_samples = 0;
+		for (i = 0; i < ARV_STREAM_LATENCY_N_BINS; i++) {
+			latency->bins[i] /= 2;
+			latency->n_samples += latency->bins[i];
+		}
+	}
+
+	if (value_us > latency->max_us)
+		latency->max_us = value_us;
+
+	p50_count = (latency->n_samples + 1) / 2;
+	p99_count = latency->n_samples - latency->n_samples / 100;
+
+	for (i = 0, count = 0; i < ARV_STREAM_LATENCY_N_BINS; i++) {
+		if (count < p50_count && count + latency->bins[i] >= p50_count)
+			latency->p50_us = _latency_bin_value (i);
+		count += latency->bins[i];
+		if (count >= p99_count) {
+			latency->p99_us = _latency_bin_value (i);
+			break;
+		}
+	}
+}
+
+/* Must be called with latency_mutex held */
+
+static void
+_update_latencies_unlocked (ArvStreamPrivate *priv, ArvBuffer *buffer, guint64 pop_time_us)
+{
+	guint64 first_packet_time_us;
+	guint64 last_packet_time_us;
+	guint64 output_time_us;
+
+	if (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS ||
+	    buffer->priv->output_time_us == 0)
+		return;
+
+	first_packet_time_us = buffer->priv->first_packet_time_us;
+	last_packet_time_us = buffer->priv->last_packet_time_us;
+	output_time_us = buffer->priv->output_time_us;
+
+	if (first_packet_time_us != 0 && last_packet_time_us >= first_packet_time_us)
+		_latency_add_sample (&priv->latencies[ARV_STREAM_LATENCY_STAGE_TRANSFER],
+				     last_packet_time_us - first_packet_time_us);
+	if (last_packet_time_us != 0 && output_time_us >= last_packet_time_us)
+		_latency_add_sample (&priv->latencies[ARV_STREAM_LATENCY_STAGE_COMPLETION],
+				     output_time_us - last_packet_time_us);
+	if (pop_time_us >= output_time_us)
+		_latency_add_sample (&priv->latencies[ARV_STREAM_LATENCY_STAGE_DELIVERY],
+				     pop_time_us - output_time_us);
+	if (first_packet_time_us != 0 && pop_time_us >= first_packet_time_us)
+		_latency_add_sample (&priv->latencies[ARV_STREAM_LATENCY_STAGE_TOTAL],
+				     pop_time_us - first_packet_time_us);
+}
+
+static void
+_update_latencies (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	g_mutex_lock (&priv->latency_mutex);
+	_update_latencies_unlocked (priv, buffer, g_get_monotonic_time ());
+	g_mutex_unlock (&priv->latency_mutex);
+}
+
+static ArvBuffer *
+_pop_output_buffer (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (buffer != NULL) {
+		ARV_TRACEPOINT (stream_pop_buffer, buffer, buffer->priv->frame_id, buffer->priv->status);
+		_update_latencies (priv, buffer);
+	}
+
+	return buffer;
+}
+
+static ArvBuffer *
+_pop_output_spsc_queue (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (buffer != NULL)
+		g_atomic_int_add (&priv->n_spsc_buffers, -1);
+
+	return _pop_output_buffer (priv, buffer);
+}
+
 /**
  * arv_stream_pop_buffer:
  * @stream: a #ArvStream
@@ -127,7 +640,10 @@ arv_stream_pop_buffer (ArvStream *stream)
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_pop (priv->output_queue);
+	if (priv->output_spsc_queue != NULL)
+		return _pop_output_spsc_queue (priv, arv_spsc_queue_pop (priv->output_spsc_queue));
+
+	return _pop_output_buffer (priv, g_async_queue_pop (priv->output_queue));
 }
 
 /**
@@ -152,7 +668,10 @@ arv_stream_try_pop_buffer (ArvStream *stream)
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_try_pop (priv->output_queue);
+	if (priv->output_spsc_queue != NULL)
+		return _pop_output_spsc_queue (priv, arv_spsc_queue_try_pop (priv->output_spsc_queue));
+
+	return _pop_output_buffer (priv, g_async_queue_try_pop (priv->output_queue));
 }
 
 /**
@@ -177,242 +696,1869 @@ arv_stream_timeout_pop_buffer (ArvStream *stream, guint64 timeout)
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_timeout_pop (priv->output_queue, timeout);
+	if (priv->output_spsc_queue != NULL)
+		return _pop_output_spsc_queue (priv, arv_spsc_queue_timeout_pop (priv->output_spsc_queue, timeout));
+
+	return _pop_output_buffer (priv, g_async_queue_timeout_pop (priv->output_queue, timeout));
 }
 
 /**
- * arv_stream_pop_input_buffer: (skip)
- * @stream: (transfer full): a #ArvStream
+ * arv_stream_pop_buffers: (skip)
+ * @stream: a #ArvStream
+ * @buffers: an array of at least @max_buffers buffer pointers
+ * @max_buffers: maximum number of buffers to pop
+ * @timeout: timeout, in µs, 0 for no wait
  *
- * Pops a buffer from the input queue of @stream.
+ * Pops up to @max_buffers buffers from the output queue of @stream, in a single operation on the queue. The call waits
+ * no more than @timeout for the first buffer, and then only retrieves the buffers already available. As with
+ * arv_stream_pop_buffer(), the retrieved buffers may contain invalid images.
  *
- * Since: 0.2.0
+ * This method is thread safe, unless lock-free queues are used.
+ *
+ * Returns: the number of buffers stored in @buffers, whose ownership is transferred to the caller.
+ *
+ * Since: 0.8.24
  */
 
-ArvBuffer *
-arv_stream_pop_input_buffer (ArvStream *stream)
+guint
+arv_stream_pop_buffers (ArvStream *stream, ArvBuffer **buffers, guint max_buffers, guint64 timeout)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint64 pop_time_us;
+	guint n_buffers = 0;
+	guint i;
 
-	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+	g_return_val_if_fail (buffers != NULL || max_buffers == 0, 0);
+
+	if (max_buffers == 0)
+		return 0;
+
+	if (priv->output_spsc_queue != NULL) {
+		n_buffers = arv_spsc_queue_try_pop_many (priv->output_spsc_queue, (gpointer *) buffers, max_buffers);
+		if (n_buffers == 0 && timeout > 0 &&
+		    (buffers[0] = arv_spsc_queue_timeout_pop (priv->output_spsc_queue, timeout)) != NULL)
+			n_buffers = 1 + arv_spsc_queue_try_pop_many (priv->output_spsc_queue, (gpointer *) buffers + 1,
+								     max_buffers - 1);
+		g_atomic_int_add (&priv->n_spsc_buffers, -(gint) n_buffers);
+	} else {
+		ArvBuffer *buffer;
+
+		g_async_queue_lock (priv->output_queue);
+		buffer = timeout > 0 ?
+			g_async_queue_timeout_pop_unlocked (priv->output_queue, timeout) :
+			g_async_queue_try_pop_unlocked (priv->output_queue);
+		while (buffer != NULL) {
+			buffers[n_buffers++] = buffer;
+			buffer = n_buffers < max_buffers ? g_async_queue_try_pop_unlocked (priv->output_queue) : NULL;
+		}
+		g_async_queue_unlock (priv->output_queue);
+	}
+
+	if (n_buffers == 0)
+		return 0;
+
+	pop_time_us = g_get_monotonic_time ();
+
+	g_mutex_lock (&priv->latency_mutex);
+	for (i = 0; i < n_buffers; i++) {
+		ARV_TRACEPOINT (stream_pop_buffer, buffers[i], buffers[i]->priv->frame_id, buffers[i]->priv->status);
+		_update_latencies_unlocked (priv, buffers[i], pop_time_us);
+	}
+	g_mutex_unlock (&priv->latency_mutex);
 
-	return g_async_queue_try_pop (priv->input_queue);
+	return n_buffers;
 }
 
-void
-arv_stream_push_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+/**
+ * arv_stream_get_ready_fd:
+ * @stream: a #ArvStream
+ *
+ * Returns a file descriptor becoming readable when output buffers are available, for the integration of @stream in an
+ * event loop, like the asyncio loop of Python. Once it polls as readable, the buffers are retrieved using
+ * arv_stream_pop_ready_buffers(), which also acknowledges the readiness. Unlike the #ArvStream::new-buffer signal, no
+ * application code is run in the stream thread, and the buffers are retrieved in batches.
+ *
+ * The file descriptor is owned by @stream, and must not be closed.
+ *
+ * Returns: a file descriptor, or -1 on Windows.
+ *
+ * Since: 0.8.24
+ */
+
+int
+arv_stream_get_ready_fd (ArvStream *stream)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GPollFD poll_fd;
 
-	g_return_if_fail (ARV_IS_STREAM (stream));
-	g_return_if_fail (ARV_IS_BUFFER (buffer));
-
-	g_async_queue_push (priv->output_queue, buffer);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), -1);
 
+#ifdef G_OS_WIN32
+	return -1;
+#else
 	g_rec_mutex_lock (&priv->mutex);
 
-	if (priv->emit_signals)
-		g_signal_emit (stream, arv_stream_signals[ARV_STREAM_SIGNAL_NEW_BUFFER], 0);
+	if (priv->ready_wakeup == NULL) {
+		ArvWakeup *wakeup = arv_wakeup_new ();
+		gint n_output_buffers;
+
+		g_atomic_pointer_set (&priv->ready_wakeup, wakeup);
+
+		/* The buffers queued before the creation are signaled too */
+		arv_stream_get_n_buffers (stream, NULL, &n_output_buffers);
+		if (n_output_buffers > 0)
+			arv_wakeup_signal (wakeup);
+	}
+
+	arv_wakeup_get_pollfd (priv->ready_wakeup, &poll_fd);
 
 	g_rec_mutex_unlock (&priv->mutex);
+
+	return poll_fd.fd;
+#endif
 }
 
 /**
- * arv_stream_get_n_buffers:
+ * arv_stream_pop_ready_buffers:
  * @stream: a #ArvStream
- * @n_input_buffers: (out) (allow-none): input queue length
- * @n_output_buffers: (out) (allow-none): output queue length
+ * @max_buffers: maximum number of buffers to pop
  *
- * An accessor to the stream buffer queue lengths.
+ * Acknowledges the readiness of the file descriptor returned by arv_stream_get_ready_fd(), and pops up to @max_buffers
+ * buffers from the output queue of @stream, without waiting. The file descriptor stays readable if more buffers are
+ * available. This is the binding friendly version of arv_stream_pop_buffers(), with a single call per batch.
  *
- * Since: 0.2.0
+ * Returns: (transfer full) (element-type ArvBuffer): an array of the retrieved buffers, possibly empty.
+ *
+ * Since: 0.8.24
  */
 
-void
-arv_stream_get_n_buffers (ArvStream *stream, gint *n_input_buffers, gint *n_output_buffers)
+GPtrArray *
+arv_stream_pop_ready_buffers (ArvStream *stream, guint max_buffers)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvWakeup *wakeup;
+	GPtrArray *buffers;
+	guint n_buffers;
 
-	if (!ARV_IS_STREAM (stream)) {
-		if (n_input_buffers != NULL)
-			*n_input_buffers = 0;
-		if (n_output_buffers != NULL)
-			*n_output_buffers = 0;
-		return;
-	}
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	if (n_input_buffers != NULL)
-		*n_input_buffers = g_async_queue_length (priv->input_queue);
-	if (n_output_buffers != NULL)
-		*n_output_buffers = g_async_queue_length (priv->output_queue);
+	wakeup = g_atomic_pointer_get (&priv->ready_wakeup);
+
+	/* Acknowledged before the pop, the buffers queued meanwhile signaling again */
+	if (wakeup != NULL)
+		arv_wakeup_acknowledge (wakeup);
+
+	buffers = g_ptr_array_sized_new (max_buffers);
+	g_ptr_array_set_size (buffers, max_buffers);
+	n_buffers = arv_stream_pop_buffers (stream, (ArvBuffer **) buffers->pdata, max_buffers, 0);
+	g_ptr_array_set_size (buffers, n_buffers);
+
+	if (wakeup != NULL && n_buffers == max_buffers && max_buffers > 0)
+		arv_wakeup_signal (wakeup);
+
+	return buffers;
 }
 
 /**
- * arv_stream_start_thread:
- * @stream: a #ArvStream
+ * arv_stream_pop_input_buffer: (skip)
+ * @stream: (transfer full): a #ArvStream
  *
- * Start the stream receiving thread. The thread is automatically started when
- * the #ArvStream object is instantiated, so this function is only useful if
- * the thread was stopped using @arv_stream_stop_thread.
+ * Pops a buffer from the input queue of @stream.
  *
- * Since: 0.6.2
+ * Since: 0.2.0
  */
 
-void
-arv_stream_start_thread (ArvStream *stream)
+ArvBuffer *
+arv_stream_pop_input_buffer (ArvStream *stream)
 {
-	ArvStreamClass *stream_class;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 
-	g_return_if_fail (ARV_IS_STREAM (stream));
+	ArvBuffer *buffer;
 
-	stream_class = ARV_STREAM_GET_CLASS (stream);
-	g_return_if_fail (stream_class->start_thread != NULL);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	stream_class->start_thread (stream);
+	if (priv->input_spsc_queue != NULL)
+		buffer = arv_spsc_queue_try_pop (priv->input_spsc_queue);
+	else
+		buffer = g_async_queue_try_pop (priv->input_queue);
+
+	_check_auto_buffers_pressure (priv, buffer);
+
+	if (buffer != NULL)
+		_reset_input_buffer (priv, buffer);
+
+	return buffer;
 }
 
 /**
- * arv_stream_stop_thread:
+ * arv_stream_timeout_pop_input_buffer: (skip)
  * @stream: a #ArvStream
- * @delete_buffers: enable buffer deletion
+ * @timeout: timeout, in µs
  *
- * Stop the stream receiving thread, and optionally delete all the #ArvBuffer
- * stored in the stream object queues. Main use of this function is to be able
- * to quickly change an acquisition parameter that changes the payload size,
- * without deleting/recreating the stream object.
+ * Pops a buffer from the input queue of @stream, waiting no more than @timeout.
  *
- * Returns: the number of deleted buffers if @delete_buffers == %TRUE, 0 otherwise.
+ * Returns: (transfer full): a #ArvBuffer, NULL if no buffer was pushed before the timeout occurs.
  *
- * Since: 0.6.2
+ * Since: 0.8.24
  */
 
-unsigned int
-arv_stream_stop_thread (ArvStream *stream, gboolean delete_buffers)
+ArvBuffer *
+arv_stream_timeout_pop_input_buffer (ArvStream *stream, guint64 timeout)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
-	ArvStreamClass *stream_class;
+
 	ArvBuffer *buffer;
-	unsigned int n_deleted = 0;
 
-	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	stream_class = ARV_STREAM_GET_CLASS (stream);
-	g_return_val_if_fail (stream_class->stop_thread != NULL, 0);
+	if (priv->input_spsc_queue != NULL)
+		buffer = arv_spsc_queue_timeout_pop (priv->input_spsc_queue, timeout);
+	else
+		buffer = g_async_queue_timeout_pop (priv->input_queue, timeout);
 
-	stream_class->stop_thread (stream);
+	_check_auto_buffers_pressure (priv, buffer);
 
-	if (!delete_buffers)
-		return 0;
+	if (buffer != NULL)
+		_reset_input_buffer (priv, buffer);
 
-	g_async_queue_lock (priv->input_queue);
-	do {
-		buffer = g_async_queue_try_pop_unlocked (priv->input_queue);
-		if (buffer != NULL) {
+	return buffer;
+}
+
+/**
+ * arv_stream_steal_output_buffer: (skip)
+ * @stream: a #ArvStream
+ *
+ * Takes back the oldest buffer of the output queue, which the application did not retrieve yet. This is not
+ * possible when the lock-free queues are used, as the application is the only allowed consumer of the output queue.
+ *
+ * Returns: (transfer full): a #ArvBuffer, NULL if the output queue is empty or can't be stolen from.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_stream_steal_output_buffer (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	if (priv->output_spsc_queue != NULL)
+		return NULL;
+
+	return g_async_queue_try_pop (priv->output_queue);
+}
+
+/* Processing stages */
+
+typedef struct {
+	ArvStreamStageFunc func;
+	void *user_data;
+	GDestroyNotify destroy;
+	ArvStreamStageMode mode;
+} ArvStreamStage;
+
+typedef struct {
+	ArvBuffer *buffer;
+	/* Stages still to be run, by a worker */
+	GPtrArray *stages;
+	guint first_stage;
+	gboolean is_done;
+} ArvStreamStageJob;
+
+static void
+_stage_free (gpointer data)
+{
+	ArvStreamStage *stage = data;
+
+	if (stage->destroy != NULL)
+		stage->destroy (stage->user_data);
+	g_free (stage);
+}
+
+static void
+_queue_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvWakeup *wakeup;
+	gint n_queued_buffers = 1;
+
+	buffer->priv->output_time_us = g_get_monotonic_time ();
+
+	ARV_TRACEPOINT (stream_push_output_buffer, buffer, buffer->priv->frame_id, buffer->priv->status);
+
+	if (priv->output_spsc_queue != NULL) {
+		if (!arv_spsc_queue_push (priv->output_spsc_queue, buffer)) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -1);
+			arv_warning_stream ("[Stream::push_output_buffer] Lock-free queue is full, drop buffer");
 			g_object_unref (buffer);
-			n_deleted++;
+			return;
 		}
-	} while (buffer != NULL);
-	g_async_queue_unlock (priv->input_queue);
+		n_queued_buffers = arv_spsc_queue_length (priv->output_spsc_queue);
+	} else if (g_atomic_int_get (&priv->output_policy) == ARV_STREAM_OUTPUT_POLICY_FIFO) {
+		g_async_queue_lock (priv->output_queue);
+		g_async_queue_push_unlocked (priv->output_queue, buffer);
+		n_queued_buffers = g_async_queue_length_unlocked (priv->output_queue);
+		g_async_queue_unlock (priv->output_queue);
+	} else {
+		gint n_output_buffers = g_atomic_int_get (&priv->n_output_buffers);
+		ArvBuffer *oldest;
+
+		/* The oldest buffers are recycled, instead of the stream running out of input buffers and dropping
+		 * the newest frames */
+		g_async_queue_lock (priv->output_queue);
+		g_async_queue_push_unlocked (priv->output_queue, buffer);
+		while (g_async_queue_length_unlocked (priv->output_queue) > n_output_buffers &&
+		       (oldest = g_async_queue_try_pop_unlocked (priv->output_queue)) != NULL) {
+			arv_debug_stream ("[Stream::push_output_buffer] Recycle frame %" G_GUINT64_FORMAT,
+					  oldest->priv->frame_id);
+			g_async_queue_push (oldest->priv->batch_frames != NULL ?
+					    priv->batch_queue : priv->input_queue, oldest);
+			priv->n_recycled_buffers++;
+		}
+		n_queued_buffers = g_async_queue_length_unlocked (priv->output_queue);
+		g_async_queue_unlock (priv->output_queue);
+	}
 
-	g_async_queue_lock (priv->output_queue);
-	do {
-		buffer = g_async_queue_try_pop_unlocked (priv->output_queue);
-		if (buffer != NULL) {
-			g_object_unref (buffer);
-			n_deleted++;
+	wakeup = g_atomic_pointer_get (&priv->ready_wakeup);
+	if (wakeup != NULL)
+		arv_wakeup_signal (wakeup);
+
+	/* In batching mode, the signal is only emitted when the output queue was empty, the previous buffers being
+	 * retrieved by the handler of the signal emitted for the first one */
+	if (g_atomic_int_get (&priv->signal_batching) != 0 && n_queued_buffers != 1)
+		return;
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	if (priv->emit_signals)
+		g_signal_emit (stream, arv_stream_signals[ARV_STREAM_SIGNAL_NEW_BUFFER], 0);
+
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
+/* Takes the batch being filled, if any. Must be called with batch_mutex held. */
+
+static ArvBuffer *
+_steal_batch (ArvStreamPrivate *priv)
+{
+	ArvBuffer *batch = priv->batch;
+
+	priv->batch = NULL;
+
+	return batch;
+}
+
+static void
+_deliver_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *full_batch = NULL;
+	ArvBuffer *batch = NULL;
+	gint n_batch_frames;
+	guint64 time_us;
+	gboolean is_packed = FALSE;
+
+	n_batch_frames = g_atomic_int_get (&priv->n_batch_frames);
+	if (n_batch_frames < 2 || priv->output_spsc_queue != NULL) {
+		_queue_output_buffer (stream, buffer);
+		return;
+	}
+
+	time_us = g_get_monotonic_time ();
+
+	g_mutex_lock (&priv->batch_mutex);
+
+	if (priv->batch != NULL && !arv_buffer_batch_append (priv->batch, buffer))
+		full_batch = _steal_batch (priv);
+
+	if (priv->batch == NULL) {
+		priv->batch = g_async_queue_try_pop (priv->batch_queue);
+		if (priv->batch != NULL) {
+			arv_buffer_batch_reset (priv->batch);
+			priv->batch_start_us = time_us;
+			is_packed = arv_buffer_batch_append (priv->batch, buffer);
 		}
-	} while (buffer != NULL);
-	g_async_queue_unlock (priv->output_queue);
+	} else
+		is_packed = full_batch == NULL;
+
+	if (priv->batch != NULL && arv_buffer_get_n_batch_frames (priv->batch) > 0 &&
+	    (arv_buffer_get_n_batch_frames (priv->batch) >= (guint) n_batch_frames ||
+	     time_us - priv->batch_start_us >= priv->batch_timeout_us))
+		batch = _steal_batch (priv);
+
+	g_mutex_unlock (&priv->batch_mutex);
+
+	if (full_batch != NULL)
+		_queue_output_buffer (stream, full_batch);
+
+	/* Without a free batch buffer, or if it is too small, the frame is output alone */
+	if (is_packed)
+		g_async_queue_push (priv->input_queue, buffer);
+	else {
+		arv_debug_stream ("[Stream::deliver_output_buffer] No batch buffer for frame %" G_GUINT64_FORMAT,
+				  buffer->priv->frame_id);
+		_queue_output_buffer (stream, buffer);
+	}
+
+	if (batch != NULL)
+		_queue_output_buffer (stream, batch);
+}
+
+/* Outputs the partially filled batch */
+
+static void
+_flush_batch (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *batch;
+
+	g_mutex_lock (&priv->batch_mutex);
+	batch = _steal_batch (priv);
+	g_mutex_unlock (&priv->batch_mutex);
+
+	if (batch == NULL)
+		return;
+
+	if (arv_buffer_get_n_batch_frames (batch) > 0)
+		_queue_output_buffer (stream, batch);
+	else
+		g_async_queue_push (priv->batch_queue, batch);
+}
+
+/* Delivers the completed jobs at the head of the pending queue, in frame order. Only one thread delivers at a time,
+ * the others leaving their completed jobs to it. Must be called with stage_mutex held. */
+
+static void
+_deliver_stage_jobs (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStageJob *job;
+
+	if (priv->is_delivering_stage_jobs)
+		return;
+
+	priv->is_delivering_stage_jobs = TRUE;
+
+	while ((job = g_queue_peek_head (&priv->stage_jobs)) != NULL && job->is_done) {
+		g_queue_pop_head (&priv->stage_jobs);
+		g_mutex_unlock (&priv->stage_mutex);
+
+		_deliver_output_buffer (stream, job->buffer);
+		g_clear_pointer (&job->stages, g_ptr_array_unref);
+		g_free (job);
+
+		g_mutex_lock (&priv->stage_mutex);
+	}
+
+	priv->is_delivering_stage_jobs = FALSE;
+
+	if (g_queue_is_empty (&priv->stage_jobs))
+		g_cond_broadcast (&priv->stage_cond);
+}
+
+static void
+_stage_worker_func (gpointer data, gpointer user_data)
+{
+	ArvStream *stream = user_data;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStageJob *job = data;
+	guint i;
+
+	for (i = job->first_stage; i < job->stages->len; i++) {
+		ArvStreamStage *stage = g_ptr_array_index (job->stages, i);
+
+		stage->func (job->buffer, stage->user_data);
+	}
+
+	g_mutex_lock (&priv->stage_mutex);
+	job->is_done = TRUE;
+	_deliver_stage_jobs (stream);
+	g_mutex_unlock (&priv->stage_mutex);
+}
+
+static void
+_wait_stage_jobs (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_mutex_lock (&priv->stage_mutex);
+	while (!g_queue_is_empty (&priv->stage_jobs) || priv->is_delivering_stage_jobs)
+		g_cond_wait (&priv->stage_cond, &priv->stage_mutex);
+	g_mutex_unlock (&priv->stage_mutex);
+}
+
+/**
+ * arv_stream_add_stage:
+ * @stream: a #ArvStream
+ * @func: (scope notified): processing function
+ * @user_data: (closure): user data for @func
+ * @destroy: (allow-none): a #GDestroyNotify for @user_data, called on @stream finalization
+ * @mode: where @func is run
+ *
+ * Adds a processing stage to the completed buffers of @stream, run before they are queued for the application, in
+ * the order of addition. Only the successfully completed buffers are processed, their data being still in the CPU
+ * cache. With %ARV_STREAM_STAGE_MODE_INLINE, @func runs in the stream thread, delaying the reception of the next
+ * frame data, and should be cheap. With %ARV_STREAM_STAGE_MODE_WORKER, @func and all the following stages run in a
+ * pool of #ArvStream:n-stage-workers threads, the buffers still being output in the frame order.
+ *
+ * Stages can't be removed, and are kept until the stream finalization.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_add_stage (ArvStream *stream, ArvStreamStageFunc func, void *user_data, GDestroyNotify destroy,
+		      ArvStreamStageMode mode)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStage *stage;
+	GPtrArray *stages;
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (func != NULL);
+
+	stage = g_new0 (ArvStreamStage, 1);
+	stage->func = func;
+	stage->user_data = user_data;
+	stage->destroy = destroy;
+	stage->mode = mode;
+
+	g_mutex_lock (&priv->stage_mutex);
+
+	if (mode == ARV_STREAM_STAGE_MODE_WORKER && priv->stage_pool == NULL)
+		priv->stage_pool = g_thread_pool_new (_stage_worker_func, stream, priv->n_stage_workers, FALSE, NULL);
+
+	/* The stage list is replaced, as the stream threads use it without lock */
+	stages = g_ptr_array_new ();
+	for (i = 0; priv->stages != NULL && i < priv->stages->len; i++)
+		g_ptr_array_add (stages, g_ptr_array_index (priv->stages, i));
+	g_ptr_array_add (stages, stage);
+
+	if (priv->stages != NULL)
+		g_ptr_array_unref (priv->stages);
+	g_atomic_pointer_set (&priv->stages, stages);
+
+	g_mutex_unlock (&priv->stage_mutex);
+}
+
+static void
+_compression_stage (ArvBuffer *buffer, void *user_data)
+{
+	GError *error = NULL;
+
+	if (!arv_buffer_compress (buffer, GPOINTER_TO_INT (user_data), &error)) {
+		arv_debug_stream ("[Stream::compression_stage] Frame %" G_GUINT64_FORMAT " not compressed: %s",
+				  arv_buffer_get_frame_id (buffer), error->message);
+		g_clear_error (&error);
+	}
+}
+
+/**
+ * arv_stream_add_compression_stage:
+ * @stream: a #ArvStream
+ * @compression: the compression algorithm
+ *
+ * Adds a worker stage compressing the completed buffers using arv_buffer_compress(), for a [class@ArvRecorder]
+ * writing the compressed data instead of the raw data. The buffers which can't be compressed are recorded
+ * uncompressed. The compression of each frame is itself split between the processor cores.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_add_compression_stage (ArvStream *stream, ArvBufferCompression compression)
+{
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	if (compression == ARV_BUFFER_COMPRESSION_NONE)
+		return;
+
+	arv_stream_add_stage (stream, _compression_stage, GINT_TO_POINTER (compression), NULL,
+			      ARV_STREAM_STAGE_MODE_WORKER);
+}
+
+static void
+_tensor_stage (ArvBuffer *buffer, void *user_data)
+{
+	const ArvBufferTensorFormat *format = user_data;
+	size_t size = sizeof (float) * format->n_channels * format->width * format->height;
+	GError *error = NULL;
+
+	if (buffer->priv->tensor_data == NULL) {
+		buffer->priv->tensor_data = g_malloc (size);
+		buffer->priv->tensor_size = size;
+		buffer->priv->tensor_is_owned = TRUE;
+	}
+
+	if (buffer->priv->tensor_size < size) {
+		arv_debug_stream ("[Stream::tensor_stage] Tensor memory of frame %" G_GUINT64_FORMAT
+				  " too small (%zu bytes instead of %zu)",
+				  arv_buffer_get_frame_id (buffer), buffer->priv->tensor_size, size);
+		return;
+	}
+
+	if (!arv_buffer_convert_tensor (buffer, format, buffer->priv->tensor_data, &error)) {
+		arv_debug_stream ("[Stream::tensor_stage] Frame %" G_GUINT64_FORMAT " not converted: %s",
+				  arv_buffer_get_frame_id (buffer), error->message);
+		g_clear_error (&error);
+		return;
+	}
+
+	buffer->priv->has_tensor = TRUE;
+}
+
+/**
+ * arv_stream_add_tensor_stage:
+ * @stream: a #ArvStream
+ * @format: tensor format
+ *
+ * Adds a worker stage converting the completed buffers to planar float tensors using arv_buffer_convert_tensor(),
+ * the tensors being ready when the buffers are popped, and retrieved using arv_buffer_get_tensor_data(). The tensor
+ * is written to the memory set by arv_buffer_set_tensor_data(), or to memory allocated with the buffer if none was
+ * set. The frames are converted in parallel by the #ArvStream:n-stage-workers threads.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_add_tensor_stage (ArvStream *stream, const ArvBufferTensorFormat *format)
+{
+	ArvBufferTensorFormat *stage_format;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (format != NULL);
+
+	stage_format = g_new (ArvBufferTensorFormat, 1);
+	*stage_format = *format;
+
+	arv_stream_add_stage (stream, _tensor_stage, stage_format, g_free, ARV_STREAM_STAGE_MODE_WORKER);
+}
+
+static void
+_pixel_correction_stage (ArvBuffer *buffer, void *user_data)
+{
+	GError *error = NULL;
+
+	if (!arv_pixel_correction_apply (user_data, buffer, &error)) {
+		arv_debug_stream ("[Stream::pixel_correction_stage] Frame %" G_GUINT64_FORMAT " not corrected: %s",
+				  arv_buffer_get_frame_id (buffer), error->message);
+		g_clear_error (&error);
+	}
+}
+
+/**
+ * arv_stream_add_pixel_correction_stage:
+ * @stream: a #ArvStream
+ * @correction: a #ArvPixelCorrection
+ * @mode: where the correction is run
+ *
+ * Adds a stage applying @correction to the completed buffers, using arv_pixel_correction_apply(). With
+ * %ARV_STREAM_STAGE_MODE_INLINE, the buffers are corrected by the stream thread, right after their reception. A
+ * reference to @correction is kept until the stream finalization.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_add_pixel_correction_stage (ArvStream *stream, ArvPixelCorrection *correction, ArvStreamStageMode mode)
+{
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (ARV_IS_PIXEL_CORRECTION (correction));
+
+	arv_stream_add_stage (stream, _pixel_correction_stage, g_object_ref (correction), g_object_unref, mode);
+}
+
+/* The latest preview, the one held by the consumer and the one being written */
+#define ARV_STREAM_N_PREVIEW_BUFFERS	3
+
+static void
+_preview_stage (ArvBuffer *buffer, void *user_data)
+{
+	ArvStream *stream = user_data;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *preview;
+	GError *error = NULL;
+	gint64 time_us;
+	size_t size;
+
+	if (arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS)
+		return;
+
+	time_us = g_get_monotonic_time ();
+
+	g_mutex_lock (&priv->preview_mutex);
+
+	if (priv->preview_time_us != 0 && time_us - priv->preview_time_us < priv->preview_interval_us) {
+		g_mutex_unlock (&priv->preview_mutex);
+		return;
+	}
+
+	size = arv_buffer_get_decimated_size (buffer, priv->preview_factor, priv->preview_debayer);
+	if (size == 0) {
+		g_mutex_unlock (&priv->preview_mutex);
+		arv_debug_stream ("[Stream::preview_stage] Decimation of frame %" G_GUINT64_FORMAT " not supported",
+				  arv_buffer_get_frame_id (buffer));
+		return;
+	}
+
+	/* The pool is sized on the first frame, and replaced when the image grows */
+	if (priv->preview_pool == NULL || arv_buffer_pool_get_buffer_size (priv->preview_pool) < size) {
+		g_clear_object (&priv->preview_pool);
+		priv->preview_pool = arv_buffer_pool_new (ARV_STREAM_N_PREVIEW_BUFFERS, size, &error);
+		if (priv->preview_pool == NULL) {
+			g_mutex_unlock (&priv->preview_mutex);
+			arv_warning_stream ("[Stream::preview_stage] Can't allocate the preview buffers: %s",
+					    error->message);
+			g_clear_error (&error);
+			return;
+		}
+	}
+
+	preview = arv_buffer_pool_pop_buffer (priv->preview_pool);
+	if (preview == NULL) {
+		priv->n_preview_drops++;
+		g_mutex_unlock (&priv->preview_mutex);
+		return;
+	}
+	priv->preview_time_us = time_us;
+
+	g_mutex_unlock (&priv->preview_mutex);
+
+	if (!arv_buffer_decimate (buffer, preview, priv->preview_factor, priv->preview_debayer, &error)) {
+		arv_debug_stream ("[Stream::preview_stage] Frame %" G_GUINT64_FORMAT " not decimated: %s",
+				  arv_buffer_get_frame_id (buffer), error->message);
+		g_clear_error (&error);
+		g_object_unref (preview);
+		return;
+	}
+
+	g_mutex_lock (&priv->preview_mutex);
+	buffer = priv->preview_buffer;
+	priv->preview_buffer = preview;
+	priv->n_previews++;
+	g_cond_broadcast (&priv->preview_cond);
+	g_mutex_unlock (&priv->preview_mutex);
+
+	/* An unretrieved preview goes back to its pool */
+	if (buffer != NULL)
+		g_object_unref (buffer);
+}
+
+/**
+ * arv_stream_add_preview_stage:
+ * @stream: a #ArvStream
+ * @factor: decimation factor
+ * @debayer: whether the Bayer images are debayered
+ * @max_frame_rate: maximum preview frame rate, 0 for no limit
+ *
+ * Adds a worker stage producing a secondary output of decimated images, using arv_buffer_decimate(), for the
+ * display of a preview while the full resolution buffers are consumed as usual. The previews are written to a
+ * small pool of buffers allocated by the stream, at most @max_frame_rate times per second. Only the latest preview is
+ * kept, and retrieved using arv_stream_timeout_pop_preview_buffer(). A stream has at most one preview stage.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_add_preview_stage (ArvStream *stream, guint factor, gboolean debayer, double max_frame_rate)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (factor > 0);
+	g_return_if_fail (priv->preview_factor == 0);
+
+	priv->preview_factor = factor;
+	priv->preview_debayer = debayer;
+	priv->preview_interval_us = max_frame_rate > 0.0 ? 1e6 / max_frame_rate : 0;
+
+	arv_stream_add_stage (stream, _preview_stage, stream, NULL, ARV_STREAM_STAGE_MODE_WORKER);
+}
+
+/**
+ * arv_stream_timeout_pop_preview_buffer:
+ * @stream: a #ArvStream
+ * @timeout: timeout, in µs, 0 for no wait
+ *
+ * Retrieves the latest preview of the stage added by arv_stream_add_preview_stage(), waiting no more than @timeout
+ * for a new one. The preview goes back to the stream pool when it is unreferenced, and must not be pushed to the
+ * stream input queue.
+ *
+ * Returns: (transfer full) (nullable): a decimated image, %NULL if no new preview is available until the timeout.
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_stream_timeout_pop_preview_buffer (ArvStream *stream, guint64 timeout)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *buffer;
+	gint64 end_time;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	end_time = g_get_monotonic_time () + timeout;
+
+	g_mutex_lock (&priv->preview_mutex);
+	while (priv->preview_buffer == NULL)
+		if (!g_cond_wait_until (&priv->preview_cond, &priv->preview_mutex, end_time))
+			break;
+	buffer = priv->preview_buffer;
+	priv->preview_buffer = NULL;
+	g_mutex_unlock (&priv->preview_mutex);
+
+	return buffer;
+}
+
+/**
+ * arv_stream_apply_thread_affinity: (skip)
+ * @stream: a #ArvStream
+ *
+ * Applies the #ArvStream:numa-node and #ArvStream:cpu-affinity settings to the calling thread, and prefaults its stack
+ * if #ArvStream:lock-memory is set. Stream implementations call this function from their threads, before entering the
+ * receive loop.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_apply_thread_affinity (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	char *cpu_affinity;
+	gint numa_node;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_rec_mutex_lock (&priv->mutex);
+	cpu_affinity = g_strdup (priv->cpu_affinity);
+	numa_node = priv->numa_node;
+	g_rec_mutex_unlock (&priv->mutex);
+
+	/* An explicit CPU list overrides the NUMA node CPUs, the memory policy is kept */
+	if (numa_node >= 0)
+		arv_set_thread_numa_node (numa_node);
+	if (cpu_affinity != NULL && cpu_affinity[0] != '\0')
+		arv_set_thread_cpu_affinity (cpu_affinity);
+
+	g_free (cpu_affinity);
+
+	if (g_atomic_int_get (&priv->lock_memory) != 0)
+		arv_memory_prefault_stack ();
+}
+
+/**
+ * arv_stream_lock_memory: (skip)
+ * @stream: a #ArvStream
+ * @data: memory used by the stream thread
+ * @size: size of @data
+ *
+ * Locks @data in memory if #ArvStream:lock-memory is set, for the stream implementations and their packet buffers.
+ *
+ * Returns: %TRUE if @data was locked, and must be unlocked using arv_memory_unlock() before being released.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_lock_memory (ArvStream *stream, void *data, size_t size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	if (g_atomic_int_get (&priv->lock_memory) == 0)
+		return FALSE;
+
+	return arv_memory_lock (data, size);
+}
+
+/**
+ * arv_stream_has_inline_stages: (skip)
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if the first processing stage runs in the stream thread, reading the buffer data right after its
+ * reception.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_has_inline_stages (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean has_inline_stages = FALSE;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	if (g_atomic_pointer_get (&priv->stages) == NULL)
+		return FALSE;
+
+	g_mutex_lock (&priv->stage_mutex);
+	if (priv->stages->len > 0) {
+		ArvStreamStage *stage = g_ptr_array_index (priv->stages, 0);
+
+		has_inline_stages = stage->mode == ARV_STREAM_STAGE_MODE_INLINE;
+	}
+	g_mutex_unlock (&priv->stage_mutex);
+
+	return has_inline_stages;
+}
+
+/* Tags the first image of a new geometry */
+
+static void
+_check_geometry (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (priv->has_output_geometry &&
+	    (buffer->priv->width != priv->output_width ||
+	     buffer->priv->height != priv->output_height ||
+	     buffer->priv->pixel_format != priv->output_pixel_format)) {
+		buffer->priv->has_new_geometry = TRUE;
+		arv_info_stream ("[Stream::push_output_buffer] New geometry %ux%u, pixel format 0x%08x, at frame %"
+				 G_GUINT64_FORMAT, buffer->priv->width, buffer->priv->height,
+				 buffer->priv->pixel_format, buffer->priv->frame_id);
+	}
+
+	priv->has_output_geometry = TRUE;
+	priv->output_width = buffer->priv->width;
+	priv->output_height = buffer->priv->height;
+	priv->output_pixel_format = buffer->priv->pixel_format;
+}
+
+/* Sets the region table attached to the next output buffers, %NULL for the single region images */
+
+void
+arv_stream_set_regions (ArvStream *stream, GArray *regions)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GArray *old_regions;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_mutex_lock (&priv->regions_mutex);
+	old_regions = priv->regions;
+	g_atomic_pointer_set (&priv->regions, regions != NULL ? g_array_ref (regions) : NULL);
+	g_mutex_unlock (&priv->regions_mutex);
+
+	if (old_regions != NULL)
+		g_array_unref (old_regions);
+}
+
+void
+arv_stream_push_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStageJob *job;
+	GPtrArray *stages;
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+	    g_atomic_int_get (&priv->compute_statistics) != 0)
+		arv_buffer_statistics_finish (buffer, g_atomic_int_get (&priv->statistics_grid_size));
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+	    arv_buffer_payload_type_has_aoi (buffer->priv->payload_type))
+		_check_geometry (priv, buffer);
+
+	if (g_atomic_pointer_get (&priv->regions) != NULL) {
+		g_mutex_lock (&priv->regions_mutex);
+		arv_buffer_set_regions (buffer, priv->regions);
+		g_mutex_unlock (&priv->regions_mutex);
+	}
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS) {
+		priv->n_output_frames++;
+		priv->n_output_bytes += buffer->priv->received_size;
+	} else if (buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
+		priv->n_output_failures++;
+	arv_rate_window_update (priv->rate_window, g_get_monotonic_time ());
+
+	if (g_atomic_pointer_get (&priv->stages) == NULL) {
+		_deliver_output_buffer (stream, buffer);
+		return;
+	}
+
+	g_mutex_lock (&priv->stage_mutex);
+	stages = g_ptr_array_ref (priv->stages);
+	g_mutex_unlock (&priv->stage_mutex);
+
+	i = 0;
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS) {
+		for (; i < stages->len; i++) {
+			ArvStreamStage *stage = g_ptr_array_index (stages, i);
+
+			if (stage->mode == ARV_STREAM_STAGE_MODE_WORKER)
+				break;
+			stage->func (buffer, stage->user_data);
+		}
+	}
+
+	job = g_new0 (ArvStreamStageJob, 1);
+	job->buffer = buffer;
+	job->stages = stages;
+	job->first_stage = i;
+	job->is_done = buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS || i >= stages->len;
+
+	g_mutex_lock (&priv->stage_mutex);
+
+	/* Frames are queued behind the ones still processed by the workers */
+	if (job->is_done && g_queue_is_empty (&priv->stage_jobs) && !priv->is_delivering_stage_jobs) {
+		g_mutex_unlock (&priv->stage_mutex);
+		g_ptr_array_unref (stages);
+		g_free (job);
+		_deliver_output_buffer (stream, buffer);
+		return;
+	}
+
+	g_queue_push_tail (&priv->stage_jobs, job);
+	if (job->is_done)
+		_deliver_stage_jobs (stream);
+	else
+		g_thread_pool_push (priv->stage_pool, job, NULL);
+
+	g_mutex_unlock (&priv->stage_mutex);
+}
+
+/**
+ * arv_stream_get_n_buffers:
+ * @stream: a #ArvStream
+ * @n_input_buffers: (out) (allow-none): input queue length
+ * @n_output_buffers: (out) (allow-none): output queue length
+ *
+ * An accessor to the stream buffer queue lengths.
+ *
+ * Since: 0.2.0
+ */
+
+void
+arv_stream_get_n_buffers (ArvStream *stream, gint *n_input_buffers, gint *n_output_buffers)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	if (!ARV_IS_STREAM (stream)) {
+		if (n_input_buffers != NULL)
+			*n_input_buffers = 0;
+		if (n_output_buffers != NULL)
+			*n_output_buffers = 0;
+		return;
+	}
+
+	if (priv->input_spsc_queue != NULL) {
+		if (n_input_buffers != NULL)
+			*n_input_buffers = arv_spsc_queue_length (priv->input_spsc_queue);
+		if (n_output_buffers != NULL)
+			*n_output_buffers = arv_spsc_queue_length (priv->output_spsc_queue);
+		return;
+	}
+
+	if (n_input_buffers != NULL)
+		*n_input_buffers = g_async_queue_length (priv->input_queue);
+	if (n_output_buffers != NULL)
+		*n_output_buffers = g_async_queue_length (priv->output_queue);
+}
+
+/**
+ * arv_stream_start_thread:
+ * @stream: a #ArvStream
+ *
+ * Start the stream receiving thread. The thread is automatically started when
+ * the #ArvStream object is instantiated, so this function is only useful if
+ * the thread was stopped using @arv_stream_stop_thread.
+ *
+ * Since: 0.6.2
+ */
+
+void
+arv_stream_start_thread (ArvStream *stream)
+{
+	ArvStreamClass *stream_class;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	g_return_if_fail (stream_class->start_thread != NULL);
+
+	stream_class->start_thread (stream);
+}
+
+/**
+ * arv_stream_stop_thread:
+ * @stream: a #ArvStream
+ * @delete_buffers: enable buffer deletion
+ *
+ * Stop the stream receiving thread, and optionally delete all the #ArvBuffer
+ * stored in the stream object queues. Main use of this function is to be able
+ * to quickly change an acquisition parameter that changes the payload size,
+ * without deleting/recreating the stream object.
+ *
+ * Returns: the number of deleted buffers if @delete_buffers == %TRUE, 0 otherwise.
+ *
+ * Since: 0.6.2
+ */
+
+unsigned int
+arv_stream_stop_thread (ArvStream *stream, gboolean delete_buffers)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamClass *stream_class;
+	ArvBuffer *buffer;
+	unsigned int n_deleted = 0;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	g_return_val_if_fail (stream_class->stop_thread != NULL, 0);
+
+	stream_class->stop_thread (stream);
+
+	_wait_stage_jobs (stream);
+	_flush_batch (stream);
+
+	if (!delete_buffers)
+		return 0;
+
+	while ((buffer = g_async_queue_try_pop (priv->batch_queue)) != NULL) {
+		g_object_unref (buffer);
+		n_deleted++;
+	}
+
+	if (priv->input_spsc_queue != NULL) {
+		while ((buffer = arv_spsc_queue_try_pop (priv->input_spsc_queue)) != NULL ||
+		       (buffer = arv_spsc_queue_try_pop (priv->output_spsc_queue)) != NULL) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -1);
+			g_object_unref (buffer);
+			n_deleted++;
+		}
+	}
+
+	g_async_queue_lock (priv->input_queue);
+	do {
+		buffer = g_async_queue_try_pop_unlocked (priv->input_queue);
+		if (buffer != NULL) {
+			g_object_unref (buffer);
+			n_deleted++;
+		}
+	} while (buffer != NULL);
+	g_async_queue_unlock (priv->input_queue);
+
+	g_async_queue_lock (priv->output_queue);
+	do {
+		buffer = g_async_queue_try_pop_unlocked (priv->output_queue);
+		if (buffer != NULL) {
+			g_object_unref (buffer);
+			n_deleted++;
+		}
+	} while (buffer != NULL);
+	g_async_queue_unlock (priv->output_queue);
+
+	arv_info_stream ("[Stream::reset] Deleted %u buffers\n", n_deleted);
+
+	return n_deleted;
+}
+
+/**
+ * arv_stream_ensure_buffers:
+ * @stream: a #ArvStream
+ * @n_buffers: number of buffers
+ * @buffer_size: minimum buffer size, typically the value returned by arv_camera_get_payload()
+ *
+ * Ensures the @stream queues hold @n_buffers buffers of at least @buffer_size bytes, for a payload size change
+ * without recreating the whole buffer set. The buffers already large enough are kept, the smaller ones are replaced
+ * by new buffers, and the missing ones are allocated. The stream thread must be stopped, using
+ * arv_stream_stop_thread() with @delete_buffers set to %FALSE, for all the buffers to be back in the stream queues.
+ * The buffers taken by the application are not accounted for.
+ *
+ * Returns: the number of allocated buffers, 0 if the existing buffers were all reused.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_stream_ensure_buffers (ArvStream *stream, guint n_buffers, size_t buffer_size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GPtrArray *buffers;
+	ArvBuffer *buffer;
+	guint n_allocated = 0;
+	guint n_kept = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	buffers = g_ptr_array_new ();
+
+	if (priv->input_spsc_queue != NULL) {
+		while ((buffer = arv_spsc_queue_try_pop (priv->input_spsc_queue)) != NULL ||
+		       (buffer = arv_spsc_queue_try_pop (priv->output_spsc_queue)) != NULL) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -1);
+			g_ptr_array_add (buffers, buffer);
+		}
+	}
+
+	while ((buffer = g_async_queue_try_pop (priv->input_queue)) != NULL)
+		g_ptr_array_add (buffers, buffer);
+	while ((buffer = g_async_queue_try_pop (priv->output_queue)) != NULL)
+		g_ptr_array_add (buffers, buffer);
+
+	for (i = 0; i < buffers->len; i++) {
+		buffer = g_ptr_array_index (buffers, i);
+
+		if (n_kept < n_buffers && buffer->priv->allocated_size >= buffer_size) {
+			arv_stream_push_buffer (stream, buffer);
+			n_kept++;
+		} else
+			g_object_unref (buffer);
+	}
+
+	for (; n_kept + n_allocated < n_buffers; n_allocated++)
+		arv_stream_push_buffer (stream, arv_buffer_new (buffer_size, NULL));
+
+	arv_info_stream ("[Stream::ensure_buffers] %u buffers of %zu bytes: %u kept, %u allocated",
+			 n_buffers, buffer_size, n_kept, n_allocated);
+
+	g_ptr_array_unref (buffers);
+
+	return n_allocated;
+}
+
+/**
+ * arv_stream_grow_buffers:
+ * @stream: a #ArvStream
+ * @buffer_size: minimum buffer size, typically the new value returned by arv_camera_get_payload()
+ *
+ * Sets the minimum size of the @stream buffers after a payload size change, without stopping the stream thread. The
+ * buffers large enough are reused as is. The smaller ones are reallocated on their next push, or on their next pop
+ * by the stream thread for those already in the input queue, as long as their memory is owned by the buffer. The
+ * buffers of a #ArvBufferPool, the buffers using preallocated or imported memory and the chunk only buffers keep
+ * their size. The automatic buffers created afterwards, see arv_stream_set_auto_buffers(), use the new size.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_grow_buffers (ArvStream *stream, size_t buffer_size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_pointer_set (&priv->min_buffer_size, GSIZE_TO_POINTER (buffer_size));
+
+	g_mutex_lock (&priv->auto_buffers_mutex);
+	priv->auto_buffer_size = MAX (priv->auto_buffer_size, buffer_size);
+	g_mutex_unlock (&priv->auto_buffers_mutex);
+
+	arv_info_stream ("[Stream::grow_buffers] Minimum buffer size set to %zu bytes", buffer_size);
+}
+
+/* Writes one byte per page, for the page faults of the first frame to happen before the acquisition start */
+
+static void
+_prefault_buffer (ArvBuffer *buffer)
+{
+	if (!buffer->priv->is_memory_prepared)
+		arv_memory_prefault (buffer->priv->data, buffer->priv->allocated_size);
+}
+
+static void
+_disarm (ArvStream *stream)
+{
+	ArvStreamClass *stream_class = ARV_STREAM_GET_CLASS (stream);
+
+	if (stream_class->disarm != NULL)
+		stream_class->disarm (stream);
+
+	_wait_stage_jobs (stream);
+	_flush_batch (stream);
+}
+
+/**
+ * arv_stream_arm:
+ * @stream: a #ArvStream
+ *
+ * Prepares @stream for a fast acquisition start, once its buffers are pushed. The stream thread is restarted, with
+ * its per frame state allocated for the largest queued buffer, and the memory of the queued buffers is touched, which
+ * moves the allocations and the page faults of the first frame out of the acquisition start. The frames in progress
+ * are returned as aborted, and the frame id tracking is reset, for the devices restarting their frame count at each
+ * acquisition.
+ *
+ * The stream stays armed across the acquisition start and stop cycles, arv_camera_start_acquisition() only changing
+ * the device state. It should be armed again after a buffer size change.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_arm (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamClass *stream_class;
+	GQueue input_buffers = G_QUEUE_INIT;
+	ArvBuffer *buffer;
+	size_t buffer_size = 0;
+	gint64 start_time_us;
+	guint n_buffers;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	start_time_us = g_get_monotonic_time ();
+
+	/* The stream thread is the consumer of the lock-free input queue, it must be stopped before the buffers are
+	 * taken from it */
+	_disarm (stream);
+
+	if (priv->input_spsc_queue != NULL) {
+		while ((buffer = arv_spsc_queue_try_pop (priv->input_spsc_queue)) != NULL) {
+			g_atomic_int_add (&priv->n_spsc_buffers, -1);
+			g_queue_push_tail (&input_buffers, buffer);
+		}
+	}
+	while ((buffer = g_async_queue_try_pop (priv->input_queue)) != NULL)
+		g_queue_push_tail (&input_buffers, buffer);
+
+	n_buffers = g_queue_get_length (&input_buffers);
+
+	while ((buffer = g_queue_pop_head (&input_buffers)) != NULL) {
+		_prefault_buffer (buffer);
+		buffer_size = MAX (buffer_size, buffer->priv->allocated_size);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	if (stream_class->arm != NULL)
+		stream_class->arm (stream, buffer_size);
+
+	arv_info_stream ("[Stream::arm] Armed with %u buffers of up to %zu bytes in %" G_GINT64_FORMAT " µs",
+			 n_buffers, buffer_size, g_get_monotonic_time () - start_time_us);
+}
+
+/**
+ * arv_stream_disarm:
+ * @stream: a #ArvStream
+ *
+ * Stops the stream thread started by arv_stream_arm(), keeping the buffers in the stream queues. The frames in
+ * progress are returned as aborted. The stream can be armed again, or restarted using arv_stream_start_thread().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_disarm (ArvStream *stream)
+{
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	_disarm (stream);
+}
+
+/**
+ * arv_stream_get_statistics:
+ * @stream: a #ArvStream
+ * @n_completed_buffers: (out) (allow-none): number of complete received buffers
+ * @n_failures: (out) (allow-none): number of reception failures
+ * @n_underruns: (out) (allow-none): number of input buffer underruns
+ *
+ * An accessor to the stream statistics.
+ *
+ * Since: 0.2.0
+ */
+
+void
+arv_stream_get_statistics (ArvStream *stream,
+			   guint64 *n_completed_buffers,
+			   guint64 *n_failures,
+			   guint64 *n_underruns)
+{
+	guint64 dummy;
+
+	if (n_completed_buffers == NULL)
+		n_completed_buffers = &dummy;
+	if (n_failures == NULL)
+		n_failures = &dummy;
+	if (n_underruns == NULL)
+		n_underruns = &dummy;
+
+	*n_completed_buffers = arv_stream_get_info_uint64_by_name (stream, "n_completed_buffers");
+	*n_failures = arv_stream_get_info_uint64_by_name (stream, "n_failures");
+	*n_underruns = arv_stream_get_info_uint64_by_name (stream, "n_underruns");
+}
+
+/**
+ * arv_stream_set_emit_signals:
+ * @stream: a #ArvStream
+ * @emit_signals: the new state
+ *
+ * Make @stream emit signals. This option is
+ * by default disabled because signal emission is expensive and unneeded when
+ * the application prefers to operate in pull mode.
+ *
+ * Since: 0.2.0
+ */
+
+void
+arv_stream_set_emit_signals (ArvStream *stream, gboolean emit_signals)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	priv->emit_signals = emit_signals;
+
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * arv_stream_get_emit_signals:
+ * @stream: a #ArvStream
+ *
+ * Check if stream will emit its signals.
+ *
+ * Returns: %TRUE if @stream is emiting its signals.
+ *
+ * Since: 0.2.0
+ */
+
+gboolean
+arv_stream_get_emit_signals (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean ret;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	ret = priv->emit_signals;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return ret;
+}
+
+/**
+ * arv_stream_set_frame_batching:
+ * @stream: a #ArvStream
+ * @n_frames: maximum number of frames per batch, 0 or 1 to disable frame batching
+ * @timeout_us: maximum time between the output of the first frame of a batch and the batch output, in µs
+ *
+ * Make @stream pack consecutive frames into large batch buffers, which lowers the per-frame overhead of the
+ * application for small images at high frame rates. The batch buffers are created by the application, large enough
+ * for several frames, and given to the stream with arv_stream_push_batch_buffer(). Each completed frame is then
+ * copied at the end of the current batch buffer, and its own buffer goes straight back to the input queue. A batch
+ * buffer is output when it holds @n_frames frames, when the next frame doesn't fit, or when its first frame is older
+ * than @timeout_us. The timeout is checked at each frame, and on arv_stream_stop_thread(), which outputs the
+ * partially filled batch.
+ *
+ * The packed frames are described by arv_buffer_get_n_batch_frames() and arv_buffer_get_batch_frame(), the batch
+ * buffer having a %ARV_BUFFER_PAYLOAD_TYPE_RAWDATA payload, with the frame id and the timestamps of its first frame.
+ * When no batch buffer is available, the frames are output alone. The popped batch buffers are given back with
+ * arv_stream_push_buffer() or arv_stream_push_batch_buffer().
+ *
+ * The processing stages run on the individual frames, before their packing. Frame batching is not available with
+ * the lock-free queues.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_frame_batching (ArvStream *stream, guint n_frames, guint64 timeout_us)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	if (n_frames > 1 && priv->output_spsc_queue != NULL)
+		arv_warning_stream ("[Stream::set_frame_batching] Frame batching ignored by the lock-free queues");
+
+	g_mutex_lock (&priv->batch_mutex);
+	priv->batch_timeout_us = timeout_us;
+	g_mutex_unlock (&priv->batch_mutex);
+
+	g_atomic_int_set (&priv->n_batch_frames, MIN (n_frames, G_MAXINT));
+
+	if (n_frames < 2)
+		_flush_batch (stream);
+}
+
+/**
+ * arv_stream_get_frame_batching:
+ * @stream: a #ArvStream
+ * @timeout_us: (out) (optional): batch timeout placeholder, in µs
+ *
+ * Returns: the maximum number of frames per batch, 0 or 1 if frame batching is disabled, see
+ * arv_stream_set_frame_batching().
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_stream_get_frame_batching (ArvStream *stream, guint64 *timeout_us)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	if (timeout_us != NULL) {
+		g_mutex_lock (&priv->batch_mutex);
+		*timeout_us = priv->batch_timeout_us;
+		g_mutex_unlock (&priv->batch_mutex);
+	}
+
+	return g_atomic_int_get (&priv->n_batch_frames);
+}
+
+/**
+ * arv_stream_set_auto_buffers:
+ * @stream: a #ArvStream
+ * @buffer_size: buffer size, typically the value returned by arv_camera_get_payload()
+ * @n_min_buffers: initial and minimum number of buffers
+ * @max_memory: maximum memory used by the buffers, in bytes
+ *
+ * Lets @stream manage its buffer count, which avoids guessing a number of buffers large enough for the jitter of
+ * the application, without wasting memory. @n_min_buffers buffers of @buffer_size bytes are allocated and pushed to
+ * the input queue. When the stream thread finds the input queue empty, or almost empty, the buffer set grows by half
+ * at the next buffer push, up to @max_memory. After a stable period of 10 seconds, one buffer per second is released
+ * on push, down to @n_min_buffers. The decisions are available as the `n_auto_buffers`, `n_auto_buffer_grows` and
+ * `n_auto_buffer_shrinks` stream infos.
+ *
+ * The buffers are allocated and released by the threads calling arv_stream_push_buffer(), never by the stream
+ * thread. Setting @n_min_buffers to 0 stops the tuning, the buffers in use being kept.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_auto_buffers (ArvStream *stream, size_t buffer_size, guint n_min_buffers, size_t max_memory)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint n_new_buffers = 0;
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (buffer_size > 0 || n_min_buffers == 0);
+
+	g_mutex_lock (&priv->auto_buffers_mutex);
+	if (n_min_buffers > 0) {
+		priv->auto_buffer_size = buffer_size;
+		priv->auto_min_buffers = n_min_buffers;
+		priv->auto_max_buffers = MAX (MIN (max_memory / buffer_size, G_MAXUINT), n_min_buffers);
+		priv->auto_buffers_stable_since_us = g_get_monotonic_time ();
+		if (priv->n_auto_buffers < n_min_buffers) {
+			n_new_buffers = n_min_buffers - priv->n_auto_buffers;
+			priv->n_auto_buffers = n_min_buffers;
+		}
+		arv_info_stream ("[Stream::set_auto_buffers] %u to %u buffers of %zu bytes",
+				 priv->auto_min_buffers, priv->auto_max_buffers, buffer_size);
+	}
+	g_atomic_int_set (&priv->auto_buffers_pressure, FALSE);
+	g_atomic_int_set (&priv->auto_buffers, n_min_buffers > 0);
+	g_mutex_unlock (&priv->auto_buffers_mutex);
+
+	for (i = 0; i < n_new_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (buffer_size, NULL));
+}
+
+/**
+ * arv_stream_push_batch_buffer:
+ * @stream: a #ArvStream
+ * @buffer: (transfer full): a buffer, large enough for several frames
+ *
+ * Gives a batch buffer to @stream, for the packing of the frames in frame batching mode, see
+ * arv_stream_set_frame_batching(). @buffer is a batch buffer from then on, and goes back to the batch buffers of the
+ * stream when pushed with arv_stream_push_buffer().
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_push_batch_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	arv_buffer_batch_reset (buffer);
+	arv_stream_push_buffer (stream, buffer);
+}
+
+/**
+ * arv_stream_set_signal_batching:
+ * @stream: a #ArvStream
+ * @signal_batching: the new state
+ *
+ * Make @stream emit the #ArvStream::new-buffer signal only for the buffers pushed to an empty output queue, instead of
+ * once per buffer. The signal handler is then expected to retrieve all the available buffers, for example using
+ * arv_stream_pop_buffers() until it returns 0, which lowers the signal overhead at high frame rates. This option is
+ * disabled by default.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_signal_batching (ArvStream *stream, gboolean signal_batching)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->signal_batching, signal_batching ? 1 : 0);
+}
+
+/**
+ * arv_stream_get_signal_batching:
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if @stream only emits the #ArvStream::new-buffer signal for the buffers pushed to an empty output
+ * queue.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_get_signal_batching (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return g_atomic_int_get (&priv->signal_batching) != 0;
+}
+
+/**
+ * arv_stream_set_buffer_progress:
+ * @stream: a #ArvStream
+ * @buffer_progress: the new state
+ *
+ * Make @stream call its callback with %ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS each time the data received
+ * contiguously from the start of the open buffer grows. This option is disabled by default. For a USB3Vision stream,
+ * the progress is only reported by the synchronous stream thread.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_buffer_progress (ArvStream *stream, gboolean buffer_progress)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->buffer_progress, buffer_progress ? 1 : 0);
+}
+
+/**
+ * arv_stream_get_buffer_progress:
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if @stream reports the progress of the open buffer filling.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_get_buffer_progress (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return g_atomic_int_get (&priv->buffer_progress) != 0;
+}
+
+/**
+ * arv_stream_set_unpack_pixels:
+ * @stream: a #ArvStream
+ * @unpack_pixels: the new state
+ *
+ * Make @stream unpack the images of the 10 and 12 bit packed monochrome and Bayer pixel formats to their 16 bit
+ * representation during the reception, while the received data is still in the processor cache. The buffer pixel format
+ * is then the unpacked one, for example %ARV_PIXEL_FORMAT_MONO_12 for an %ARV_PIXEL_FORMAT_MONO_12_PACKED image. The
+ * buffers must be large enough for the unpacked image, otherwise the images are left packed. This option is disabled
+ * by default.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_unpack_pixels (ArvStream *stream, gboolean unpack_pixels)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->unpack_pixels, unpack_pixels ? 1 : 0);
+}
+
+/**
+ * arv_stream_get_unpack_pixels:
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if @stream unpacks the packed pixel formats during the reception.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_get_unpack_pixels (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return g_atomic_int_get (&priv->unpack_pixels) != 0;
+}
+
+/**
+ * arv_stream_set_compute_statistics:
+ * @stream: a #ArvStream
+ * @compute_statistics: the new state
+ *
+ * Make @stream compute the histogram, the mean, the range and the number of saturated pixels of each channel of the
+ * received images, see arv_buffer_has_statistics(). The statistics are accumulated as the data blocks are stored in
+ * the buffers, which saves the control loops, like auto exposure, another pass over the images. They are computed in
+ * one pass on completion when the blocks can't be accumulated one by one, for example when the images are unpacked.
+ * This option is disabled by default.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_set_compute_statistics (ArvStream *stream, gboolean compute_statistics)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->compute_statistics, compute_statistics ? 1 : 0);
+}
+
+/**
+ * arv_stream_get_compute_statistics:
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if @stream computes the statistics of the received images.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_stream_get_compute_statistics (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return g_atomic_int_get (&priv->compute_statistics) != 0;
+}
+
+/**
+ * arv_stream_set_statistics_grid_size:
+ * @stream: a #ArvStream
+ * @grid_size: number of rows and columns of the grid, 0 to disable
+ *
+ * Sets the size of the grid dividing the images in regions, whose mean pixel values are added to the image statistics
+ * computed when arv_stream_set_compute_statistics() is enabled, see arv_buffer_get_statistics_grid_means(). The grid
+ * size is limited to 16. The grid is disabled by default.
+ *
+ * Since: 0.8.24
+ */
 
-	arv_info_stream ("[Stream::reset] Deleted %u buffers\n", n_deleted);
+void
+arv_stream_set_statistics_grid_size (ArvStream *stream, guint grid_size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 
-	return n_deleted;
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->statistics_grid_size, MIN (grid_size, 16));
 }
 
 /**
- * arv_stream_get_statistics:
+ * arv_stream_get_statistics_grid_size:
  * @stream: a #ArvStream
- * @n_completed_buffers: (out) (allow-none): number of complete received buffers
- * @n_failures: (out) (allow-none): number of reception failures
- * @n_underruns: (out) (allow-none): number of input buffer underruns
  *
- * An accessor to the stream statistics.
+ * Returns: the size of the grid of region means of the image statistics, 0 if disabled.
  *
- * Since: 0.2.0
+ * Since: 0.8.24
  */
 
-void
-arv_stream_get_statistics (ArvStream *stream,
-			   guint64 *n_completed_buffers,
-			   guint64 *n_failures,
-			   guint64 *n_underruns)
+guint
+arv_stream_get_statistics_grid_size (ArvStream *stream)
 {
-	guint64 dummy;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 
-	if (n_completed_buffers == NULL)
-		n_completed_buffers = &dummy;
-	if (n_failures == NULL)
-		n_failures = &dummy;
-	if (n_underruns == NULL)
-		n_underruns = &dummy;
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
 
-	*n_completed_buffers = arv_stream_get_info_uint64_by_name (stream, "n_completed_buffers");
-	*n_failures = arv_stream_get_info_uint64_by_name (stream, "n_failures");
-	*n_underruns = arv_stream_get_info_uint64_by_name (stream, "n_underruns");
+	return g_atomic_int_get (&priv->statistics_grid_size);
 }
 
 /**
- * arv_stream_set_emit_signals:
+ * arv_stream_set_output_policy:
  * @stream: a #ArvStream
- * @emit_signals: the new state
+ * @policy: the output queue policy
+ * @n_output_buffers: maximum number of queued output buffers for %ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST
  *
- * Make @stream emit signals. This option is
- * by default disabled because signal emission is expensive and unneeded when
- * the application prefers to operate in pull mode.
+ * Sets what happens to the output queue when the application doesn't pop the buffers fast enough. With the default
+ * %ARV_STREAM_OUTPUT_POLICY_FIFO policy, the output queue grows until the stream thread runs out of input buffers, and
+ * then drops the newest frames. With %ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST, only the @n_output_buffers latest buffers
+ * are kept in the output queue, the oldest ones being pushed back to the input queue, which bounds the latency of a
+ * live display or of a control loop. %ARV_STREAM_OUTPUT_POLICY_MAILBOX keeps only the latest buffer.
  *
- * Since: 0.2.0
+ * As a buffer may be recycled between the #ArvStream::new-buffer signal emission and its handler, the handlers
+ * should use arv_stream_try_pop_buffer() with these policies. The policy is not applied to the lock-free queues.
+ *
+ * Since: 0.8.24
  */
 
 void
-arv_stream_set_emit_signals (ArvStream *stream, gboolean emit_signals)
+arv_stream_set_output_policy (ArvStream *stream, ArvStreamOutputPolicy policy, guint n_output_buffers)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 
 	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (policy <= ARV_STREAM_OUTPUT_POLICY_MAILBOX);
 
-	g_rec_mutex_lock (&priv->mutex);
+	if (policy == ARV_STREAM_OUTPUT_POLICY_MAILBOX)
+		n_output_buffers = 1;
+	else if (policy == ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST)
+		n_output_buffers = MAX (n_output_buffers, 1);
 
-	priv->emit_signals = emit_signals;
+	if (policy != ARV_STREAM_OUTPUT_POLICY_FIFO && priv->output_spsc_queue != NULL)
+		arv_warning_stream ("[Stream::set_output_policy] Output policy ignored by the lock-free queues");
 
-	g_rec_mutex_unlock (&priv->mutex);
+	g_atomic_int_set (&priv->n_output_buffers, MIN (n_output_buffers, G_MAXINT));
+	g_atomic_int_set (&priv->output_policy, policy);
 }
 
 /**
- * arv_stream_get_emit_signals:
+ * arv_stream_get_output_policy:
  * @stream: a #ArvStream
+ * @n_output_buffers: (out) (optional): maximum number of queued output buffers
  *
- * Check if stream will emit its signals.
- *
- * Returns: %TRUE if @stream is emiting its signals.
+ * Returns: the output queue policy of @stream, see arv_stream_set_output_policy().
  *
- * Since: 0.2.0
+ * Since: 0.8.24
  */
 
-gboolean
-arv_stream_get_emit_signals (ArvStream *stream)
+ArvStreamOutputPolicy
+arv_stream_get_output_policy (ArvStream *stream, guint *n_output_buffers)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
-	gboolean ret;
-
-	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
-
-	g_rec_mutex_lock (&priv->mutex);
 
-	ret = priv->emit_signals;
+	g_return_val_if_fail (ARV_IS_STREAM (stream), ARV_STREAM_OUTPUT_POLICY_FIFO);
 
-	g_rec_mutex_unlock (&priv->mutex);
+	if (n_output_buffers != NULL)
+		*n_output_buffers = g_atomic_int_get (&priv->n_output_buffers);
 
-	return ret;
+	return g_atomic_int_get (&priv->output_policy);
 }
 
 static void arv_stream_info_free (ArvStreamInfo *info)
@@ -421,6 +2567,10 @@ static void arv_stream_info_free (ArvStreamInfo *info)
                 return;
 
         g_free (info->name);
+	if (info->histogram != NULL)
+		arv_hdr_histogram_unref (info->histogram);
+	if (info->rate_window != NULL)
+		arv_rate_window_unref (info->rate_window);
         g_free (info);
 }
 
@@ -443,6 +2593,98 @@ arv_stream_declare_info (ArvStream *stream, const char *name, GType type, gpoint
         g_ptr_array_add (priv->infos, info);
 }
 
+/*
+ * Declares the "<name>_n_samples" information, and the "<name>_p50_us", "<name>_p99_us", "<name>_p999_us",
+ * "<name>_p9999_us" and "<name>_max_us" percentiles of the @id variable of @histogram, whose values are in µs. They
+ * are computed when read, without stopping the writers.
+ */
+
+void
+arv_stream_declare_histogram_infos (ArvStream *stream, ArvHdrHistogram *histogram, guint id)
+{
+        ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamInfo *info;
+	const char *name;
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (histogram != NULL);
+
+	name = arv_hdr_histogram_get_variable_name (histogram, id);
+	g_return_if_fail (name != NULL);
+
+	info = g_new0 (ArvStreamInfo, 1);
+	info->name = g_strdup_printf ("%s_n_samples", name);
+	info->type = G_TYPE_UINT64;
+	info->histogram = arv_hdr_histogram_ref (histogram);
+	info->histogram_id = id;
+	g_ptr_array_add (priv->infos, info);
+
+	for (i = 0; i < G_N_ELEMENTS (arv_stream_histogram_infos); i++) {
+		info = g_new0 (ArvStreamInfo, 1);
+		info->name = g_strdup_printf ("%s_%s", name, arv_stream_histogram_infos[i].suffix);
+		info->type = G_TYPE_DOUBLE;
+		info->histogram = arv_hdr_histogram_ref (histogram);
+		info->histogram_id = id;
+		info->percentile = arv_stream_histogram_infos[i].percentile;
+		g_ptr_array_add (priv->infos, info);
+	}
+}
+
+/*
+ * Declares the "<name>_rate_1s", "<name>_rate_10s" and "<name>_rate_60s" informations for each counter of @window,
+ * the per second rates of the counter over sliding windows, computed when read.
+ */
+
+void
+arv_stream_declare_rate_infos (ArvStream *stream, ArvRateWindow *window)
+{
+        ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamInfo *info;
+	guint i, j;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (window != NULL);
+
+	for (i = 0; i < arv_rate_window_get_n_counters (window); i++) {
+		for (j = 0; j < G_N_ELEMENTS (arv_stream_rate_durations_s); j++) {
+			info = g_new0 (ArvStreamInfo, 1);
+			info->name = g_strdup_printf ("%s_rate_%us", arv_rate_window_get_counter_name (window, i),
+						      arv_stream_rate_durations_s[j]);
+			info->type = G_TYPE_DOUBLE;
+			info->rate_window = arv_rate_window_ref (window);
+			info->rate_window_id = i;
+			info->rate_duration_s = arv_stream_rate_durations_s[j];
+			g_ptr_array_add (priv->infos, info);
+		}
+	}
+}
+
+static guint64
+_get_info_uint64 (const ArvStreamInfo *info)
+{
+	if (info->histogram != NULL)
+		return arv_hdr_histogram_get_n_samples (info->histogram, info->histogram_id);
+
+	return *((guint64 *) (info->data));
+}
+
+static double
+_get_info_double (const ArvStreamInfo *info)
+{
+	if (info->histogram != NULL) {
+		if (info->percentile >= 100.0)
+			return arv_hdr_histogram_get_maximum (info->histogram, info->histogram_id);
+		return arv_hdr_histogram_get_percentile (info->histogram, info->histogram_id, info->percentile);
+	}
+
+	if (info->rate_window != NULL)
+		return arv_rate_window_get_rate (info->rate_window, info->rate_window_id, info->rate_duration_s,
+						 g_get_monotonic_time ());
+
+	return *((double *) (info->data));
+}
+
 /**
  * arv_stream_get_n_infos:
  * @stream: a #ArvStream
@@ -539,7 +2781,7 @@ arv_stream_get_info_uint64 (ArvStream *stream, guint id)
         g_return_val_if_fail (info->type == G_TYPE_UINT64, 0);
 
         if (info != NULL)
-                return *((guint64 *) (info->data));
+                return _get_info_uint64 (info);
 
         return 0;
 }
@@ -568,7 +2810,7 @@ arv_stream_get_info_double (ArvStream *stream, guint id)
         g_return_val_if_fail (info->type == G_TYPE_DOUBLE, 0);
 
         if (info != NULL)
-                return *((double *) (info->data));
+                return _get_info_double (info);
 
         return 0;
 }
@@ -612,7 +2854,7 @@ arv_stream_get_info_uint64_by_name (ArvStream *stream, const char *name)
         g_return_val_if_fail (info != NULL, 0);
         g_return_val_if_fail (info->type == G_TYPE_UINT64, 0);
 
-        return *((guint64 *) (info->data));
+        return _get_info_uint64 (info);
 }
 
 /**
@@ -638,7 +2880,56 @@ arv_stream_get_info_double_by_name (ArvStream *stream, const char *name)
         g_return_val_if_fail (info != NULL, 0);
         g_return_val_if_fail (info->type == G_TYPE_DOUBLE, 0);
 
-        return *((double *) (info->data));
+        return _get_info_double (info);
+}
+
+/* Switch between asynchronous and lock-free queues, moving the queued buffers to the new queues. The stream thread
+ * must not be running. */
+
+static void
+_set_lock_free_queue_size (ArvStream *stream, guint size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GQueue input_buffers = G_QUEUE_INIT;
+	GQueue output_buffers = G_QUEUE_INIT;
+	ArvBuffer *buffer;
+
+	if (priv->input_spsc_queue != NULL) {
+		while ((buffer = arv_spsc_queue_try_pop (priv->input_spsc_queue)) != NULL)
+			g_queue_push_tail (&input_buffers, buffer);
+		while ((buffer = arv_spsc_queue_try_pop (priv->output_spsc_queue)) != NULL)
+			g_queue_push_tail (&output_buffers, buffer);
+	}
+	while ((buffer = g_async_queue_try_pop (priv->input_queue)) != NULL)
+		g_queue_push_tail (&input_buffers, buffer);
+	while ((buffer = g_async_queue_try_pop (priv->output_queue)) != NULL)
+		g_queue_push_tail (&output_buffers, buffer);
+
+	g_clear_pointer (&priv->input_spsc_queue, arv_spsc_queue_free);
+	g_clear_pointer (&priv->output_spsc_queue, arv_spsc_queue_free);
+	priv->n_spsc_buffers = 0;
+
+	if (size > 0) {
+		priv->input_spsc_queue = arv_spsc_queue_new (size);
+		priv->output_spsc_queue = arv_spsc_queue_new (size);
+
+		arv_info_stream ("[Stream::set_lock_free_queue_size] Use lock-free queues of %u buffers",
+				 arv_spsc_queue_get_capacity (priv->input_spsc_queue));
+	}
+
+	/* Output buffers first, in order to not make them dropped by arv_stream_push_buffer */
+	while ((buffer = g_queue_pop_head (&output_buffers)) != NULL) {
+		if (priv->output_spsc_queue == NULL) {
+			g_async_queue_push (priv->output_queue, buffer);
+		} else if (arv_spsc_queue_push (priv->output_spsc_queue, buffer)) {
+			priv->n_spsc_buffers++;
+		} else {
+			arv_warning_stream ("[Stream::set_lock_free_queue_size] Lock-free queue is full, drop buffer");
+			g_object_unref (buffer);
+		}
+	}
+	while ((buffer = g_queue_pop_head (&input_buffers)) != NULL)
+		arv_stream_push_buffer (stream, buffer);
 }
 
 static void
@@ -655,6 +2946,8 @@ arv_stream_set_property (GObject * object, guint prop_id,
 		case ARV_STREAM_PROPERTY_DEVICE:
 			g_clear_object (&priv->device);
 			priv->device = g_value_dup_object (value);
+			if (priv->device != NULL)
+				arv_device_add_stream (priv->device, stream);
 			break;
 		case ARV_STREAM_PROPERTY_CALLBACK:
 			priv->callback = g_value_get_pointer (value);
@@ -665,6 +2958,65 @@ arv_stream_set_property (GObject * object, guint prop_id,
 		case ARV_STREAM_PROPERTY_DESTROY_NOTIFY:
 			priv->destroy_notify = g_value_get_pointer (value);
 			break;
+		case ARV_STREAM_PROPERTY_LOCK_FREE_QUEUE_SIZE:
+			_set_lock_free_queue_size (stream, g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_CPU_AFFINITY:
+			g_rec_mutex_lock (&priv->mutex);
+			g_free (priv->cpu_affinity);
+			priv->cpu_affinity = g_value_dup_string (value);
+			g_rec_mutex_unlock (&priv->mutex);
+			break;
+		case ARV_STREAM_PROPERTY_NUMA_NODE:
+			g_rec_mutex_lock (&priv->mutex);
+			priv->numa_node = g_value_get_int (value);
+			g_rec_mutex_unlock (&priv->mutex);
+			break;
+		case ARV_STREAM_PROPERTY_BUFFER_PROGRESS:
+			arv_stream_set_buffer_progress (stream, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_UNPACK_PIXELS:
+			arv_stream_set_unpack_pixels (stream, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_COMPUTE_STATISTICS:
+			arv_stream_set_compute_statistics (stream, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_STATISTICS_GRID_SIZE:
+			arv_stream_set_statistics_grid_size (stream, g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_OUTPUT_POLICY:
+			arv_stream_set_output_policy (stream, g_value_get_enum (value),
+						      g_atomic_int_get (&priv->n_output_buffers));
+			break;
+		case ARV_STREAM_PROPERTY_N_OUTPUT_BUFFERS:
+			arv_stream_set_output_policy (stream, g_atomic_int_get (&priv->output_policy),
+						      g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_N_STAGE_WORKERS:
+			g_mutex_lock (&priv->stage_mutex);
+			priv->n_stage_workers = g_value_get_uint (value);
+			if (priv->stage_pool != NULL)
+				g_thread_pool_set_max_threads (priv->stage_pool, priv->n_stage_workers, NULL);
+			g_mutex_unlock (&priv->stage_mutex);
+			break;
+		case ARV_STREAM_PROPERTY_SIGNAL_BATCHING:
+			arv_stream_set_signal_batching (stream, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_N_BATCH_FRAMES:
+			{
+				guint64 timeout_us;
+
+				arv_stream_get_frame_batching (stream, &timeout_us);
+				arv_stream_set_frame_batching (stream, g_value_get_uint (value), timeout_us);
+			}
+			break;
+		case ARV_STREAM_PROPERTY_BATCH_TIMEOUT:
+			arv_stream_set_frame_batching (stream, g_atomic_int_get (&priv->n_batch_frames),
+						       g_value_get_uint64 (value));
+			break;
+		case ARV_STREAM_PROPERTY_LOCK_MEMORY:
+			g_atomic_int_set (&priv->lock_memory, g_value_get_boolean (value) ? 1 : 0);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -691,6 +3043,55 @@ arv_stream_get_property (GObject * object, guint prop_id,
 		case ARV_STREAM_PROPERTY_CALLBACK_DATA:
 			g_value_set_pointer (value, priv->callback_data);
 			break;
+		case ARV_STREAM_PROPERTY_LOCK_FREE_QUEUE_SIZE:
+			g_value_set_uint (value, priv->input_spsc_queue != NULL ?
+					  arv_spsc_queue_get_capacity (priv->input_spsc_queue) : 0);
+			break;
+		case ARV_STREAM_PROPERTY_CPU_AFFINITY:
+			g_rec_mutex_lock (&priv->mutex);
+			g_value_set_string (value, priv->cpu_affinity);
+			g_rec_mutex_unlock (&priv->mutex);
+			break;
+		case ARV_STREAM_PROPERTY_NUMA_NODE:
+			g_value_set_int (value, priv->numa_node);
+			break;
+		case ARV_STREAM_PROPERTY_BUFFER_PROGRESS:
+			g_value_set_boolean (value, arv_stream_get_buffer_progress (stream));
+			break;
+		case ARV_STREAM_PROPERTY_UNPACK_PIXELS:
+			g_value_set_boolean (value, arv_stream_get_unpack_pixels (stream));
+			break;
+		case ARV_STREAM_PROPERTY_COMPUTE_STATISTICS:
+			g_value_set_boolean (value, arv_stream_get_compute_statistics (stream));
+			break;
+		case ARV_STREAM_PROPERTY_STATISTICS_GRID_SIZE:
+			g_value_set_uint (value, arv_stream_get_statistics_grid_size (stream));
+			break;
+		case ARV_STREAM_PROPERTY_OUTPUT_POLICY:
+			g_value_set_enum (value, arv_stream_get_output_policy (stream, NULL));
+			break;
+		case ARV_STREAM_PROPERTY_N_OUTPUT_BUFFERS:
+			g_value_set_uint (value, g_atomic_int_get (&priv->n_output_buffers));
+			break;
+		case ARV_STREAM_PROPERTY_N_STAGE_WORKERS:
+			g_mutex_lock (&priv->stage_mutex);
+			g_value_set_uint (value, priv->n_stage_workers);
+			g_mutex_unlock (&priv->stage_mutex);
+			break;
+		case ARV_STREAM_PROPERTY_SIGNAL_BATCHING:
+			g_value_set_boolean (value, arv_stream_get_signal_batching (stream));
+			break;
+		case ARV_STREAM_PROPERTY_N_BATCH_FRAMES:
+			g_value_set_uint (value, g_atomic_int_get (&priv->n_batch_frames));
+			break;
+		case ARV_STREAM_PROPERTY_BATCH_TIMEOUT:
+			g_mutex_lock (&priv->batch_mutex);
+			g_value_set_uint64 (value, priv->batch_timeout_us);
+			g_mutex_unlock (&priv->batch_mutex);
+			break;
+		case ARV_STREAM_PROPERTY_LOCK_MEMORY:
+			g_value_set_boolean (value, g_atomic_int_get (&priv->lock_memory) != 0);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -718,9 +3119,36 @@ arv_stream_init (ArvStream *stream)
 
 	priv->emit_signals = FALSE;
 
+	priv->numa_node = -1;
+
+	priv->output_policy = ARV_STREAM_OUTPUT_POLICY_FIFO;
+	priv->n_output_buffers = 1;
+
         priv->infos = g_ptr_array_new ();
 
 	g_rec_mutex_init (&priv->mutex);
+	g_mutex_init (&priv->latency_mutex);
+
+	priv->n_stage_workers = 2;
+	g_mutex_init (&priv->stage_mutex);
+	g_cond_init (&priv->stage_cond);
+	g_queue_init (&priv->stage_jobs);
+
+	priv->batch_queue = g_async_queue_new ();
+	priv->batch_timeout_us = 10000;
+	g_mutex_init (&priv->batch_mutex);
+
+	g_mutex_init (&priv->auto_buffers_mutex);
+
+	g_mutex_init (&priv->preview_mutex);
+	g_cond_init (&priv->preview_cond);
+
+	g_mutex_init (&priv->regions_mutex);
+
+	priv->rate_window = arv_rate_window_new (3);
+	arv_rate_window_set_counter (priv->rate_window, 0, "frame", &priv->n_output_frames);
+	arv_rate_window_set_counter (priv->rate_window, 1, "failure", &priv->n_output_failures);
+	arv_rate_window_set_counter (priv->rate_window, 2, "byte", &priv->n_output_bytes);
 }
 
 static void
@@ -730,6 +3158,21 @@ arv_stream_finalize (GObject *object)
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 	ArvBuffer *buffer;
 
+	/* The stream thread is stopped, let the workers output the last frames */
+	_wait_stage_jobs (stream);
+	if (priv->stage_pool != NULL)
+		g_thread_pool_free (priv->stage_pool, FALSE, TRUE);
+	if (priv->stages != NULL) {
+		g_ptr_array_foreach (priv->stages, (GFunc) _stage_free, NULL);
+		g_clear_pointer (&priv->stages, g_ptr_array_unref);
+	}
+	g_mutex_clear (&priv->stage_mutex);
+	g_cond_clear (&priv->stage_cond);
+
+	/* Move back all the buffers to the asynchronous queues */
+	if (priv->input_spsc_queue != NULL)
+		_set_lock_free_queue_size (stream, 0);
+
 	arv_info_stream ("[Stream::finalize] Flush %d buffer[s] in input queue",
 			  g_async_queue_length (priv->input_queue));
 	arv_info_stream ("[Stream::finalize] Flush %d buffer[s] in output queue",
@@ -752,13 +3195,35 @@ arv_stream_finalize (GObject *object)
 			g_object_unref (buffer);
 	} while (buffer != NULL);
 
+	g_clear_object (&priv->batch);
+	while ((buffer = g_async_queue_try_pop (priv->batch_queue)) != NULL)
+		g_object_unref (buffer);
+
 	g_async_queue_unref (priv->input_queue);
 	g_async_queue_unref (priv->output_queue);
+	g_async_queue_unref (priv->batch_queue);
+	g_mutex_clear (&priv->batch_mutex);
+	g_mutex_clear (&priv->auto_buffers_mutex);
+
+	g_clear_object (&priv->preview_buffer);
+	g_clear_object (&priv->preview_pool);
+	g_mutex_clear (&priv->preview_mutex);
+	g_cond_clear (&priv->preview_cond);
+
+	g_clear_pointer (&priv->rate_window, arv_rate_window_unref);
+
+	g_clear_pointer (&priv->regions, g_array_unref);
+	g_mutex_clear (&priv->regions_mutex);
 
 	g_rec_mutex_clear (&priv->mutex);
+	g_mutex_clear (&priv->latency_mutex);
+
+	g_clear_pointer (&priv->ready_wakeup, arv_wakeup_free);
 
 	g_clear_object (&priv->device);
 
+	g_clear_pointer (&priv->cpu_affinity, g_free);
+
 	g_clear_error (&priv->init_error);
 
         g_ptr_array_foreach (priv->infos, (GFunc) arv_stream_info_free, NULL);
@@ -789,7 +3254,9 @@ arv_stream_class_init (ArvStreamClass *node_class)
 	 * This signal is emited from the stream receive thread and only when the
 	 * "emit-signals" property is %TRUE.
 	 *
-	 * The new buffer can be retrieved with arv_stream_pop_buffer().
+	 * The new buffer can be retrieved with arv_stream_pop_buffer(). When #ArvStream:signal-batching is set, the
+	 * signal is only emitted for the first buffer of the output queue, and all the available buffers should be
+	 * retrieved, for example with arv_stream_pop_buffers().
 	 *
 	 * Note that this signal is only emited when the "emit-signals" property is
 	 * set to %TRUE, which it is not by default for performance reasons.
@@ -840,6 +3307,250 @@ arv_stream_class_init (ArvStreamClass *node_class)
 				       "Destroy notify",
 				       "Optional destroy notify",
 				       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+	/**
+	 * ArvStream:lock-free-queue-size:
+	 *
+	 * Capacity of the bounded lock-free buffer queues used instead of the default asynchronous queues, 0 to
+	 * disable them. Lock-free queues avoid a mutex lock and a condition signal for each buffer exchange between
+	 * the stream thread and the application, the consumer being only signaled when it is waiting for a buffer.
+	 * In this mode, the stream can't own more than this number of buffers, and buffers must not be pushed or
+	 * popped concurrently from different threads. The stream thread must be stopped while this property is
+	 * changed.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_LOCK_FREE_QUEUE_SIZE,
+		 g_param_spec_uint ("lock-free-queue-size",
+				    "Lock-free queue size",
+				    "Capacity of the lock-free buffer queues, 0 to disable them",
+				    0, 1 << 20, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:cpu-affinity:
+	 *
+	 * List of the CPUs the stream threads are allowed to run on, as comma separated CPU indices or ranges, like
+	 * "2-3,6". %NULL leaves the thread affinity unchanged. This setting is applied by the stream threads before
+	 * their receive loop, a change is taken into account at the next stream thread start.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_CPU_AFFINITY,
+		 g_param_spec_string ("cpu-affinity",
+				      "CPU affinity",
+				      "CPU list of the stream threads",
+				      NULL,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:numa-node:
+	 *
+	 * NUMA node the stream threads run on, and from which the memory they allocate comes preferably, -1 for
+	 * no placement. The CPUs of the node are overridden by #ArvStream:cpu-affinity if it is set. The stream
+	 * buffers are allocated by the application, see [ctor@ArvBufferPool.new_full] for their placement. A
+	 * change is taken into account at the next stream thread start.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_NUMA_NODE,
+		 g_param_spec_int ("numa-node",
+				   "NUMA node",
+				   "NUMA node of the stream threads, -1 for none",
+				   -1, G_MAXINT, -1,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:buffer-progress:
+	 *
+	 * Report the filling progress of the open buffer to the stream callback, see
+	 * arv_stream_set_buffer_progress().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_BUFFER_PROGRESS,
+		 g_param_spec_boolean ("buffer-progress",
+				       "Buffer progress",
+				       "Report the filling progress of the open buffer",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:unpack-pixels:
+	 *
+	 * Unpack the packed pixel formats during the reception, see arv_stream_set_unpack_pixels().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_UNPACK_PIXELS,
+		 g_param_spec_boolean ("unpack-pixels",
+				       "Unpack pixels",
+				       "Unpack the packed pixel formats during the reception",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:compute-statistics:
+	 *
+	 * Compute the statistics of the received images, see arv_stream_set_compute_statistics().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_COMPUTE_STATISTICS,
+		 g_param_spec_boolean ("compute-statistics",
+				       "Compute statistics",
+				       "Compute the statistics of the received images",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:statistics-grid-size:
+	 *
+	 * Size of the grid of region means of the image statistics, see arv_stream_set_statistics_grid_size().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_STATISTICS_GRID_SIZE,
+		 g_param_spec_uint ("statistics-grid-size",
+				    "Statistics grid size",
+				    "Number of rows and columns of the grid of region means",
+				    0, 16, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:output-policy:
+	 *
+	 * Output queue policy, see arv_stream_set_output_policy().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_OUTPUT_POLICY,
+		 g_param_spec_enum ("output-policy",
+				    "Output policy",
+				    "Output queue policy",
+				    ARV_TYPE_STREAM_OUTPUT_POLICY,
+				    ARV_STREAM_OUTPUT_POLICY_FIFO,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:n-output-buffers:
+	 *
+	 * Maximum number of queued output buffers of the %ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST policy.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_N_OUTPUT_BUFFERS,
+		 g_param_spec_uint ("n-output-buffers",
+				    "Number of output buffers",
+				    "Maximum number of queued output buffers of the keep latest policy",
+				    1, G_MAXINT, 1,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:n-stage-workers:
+	 *
+	 * Number of threads running the %ARV_STREAM_STAGE_MODE_WORKER processing stages, see
+	 * arv_stream_add_stage().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_N_STAGE_WORKERS,
+		 g_param_spec_uint ("n-stage-workers",
+				    "Number of stage workers",
+				    "Number of threads of the processing stage worker pool",
+				    1, G_MAXINT, 2,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:signal-batching:
+	 *
+	 * Only emit the #ArvStream::new-buffer signal for the buffers pushed to an empty output queue, see
+	 * arv_stream_set_signal_batching().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_SIGNAL_BATCHING,
+		 g_param_spec_boolean ("signal-batching",
+				       "Signal batching",
+				       "Only emit the new-buffer signal for the first buffer of the output queue",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:n-batch-frames:
+	 *
+	 * Maximum number of frames packed in a batch buffer, 0 or 1 if frame batching is disabled, see
+	 * arv_stream_set_frame_batching().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_N_BATCH_FRAMES,
+		 g_param_spec_uint ("n-batch-frames",
+				    "Number of batch frames",
+				    "Maximum number of frames packed in a batch buffer",
+				    0, G_MAXINT, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:batch-timeout:
+	 *
+	 * Maximum time spent by a frame in a batch buffer before its output, in µs, see
+	 * arv_stream_set_frame_batching().
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_BATCH_TIMEOUT,
+		 g_param_spec_uint64 ("batch-timeout",
+				      "Batch timeout",
+				      "Maximum time spent by a frame in a batch buffer, in µs",
+				      0, G_MAXUINT64, 10000,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:lock-memory:
+	 *
+	 * Lock the memory of the buffers in RAM on their first push, and prefault the stream thread stack and packet
+	 * buffers, for the real-time acquisitions, where a page fault in the stream thread can delay the packet
+	 * reception enough to trigger resend requests. It should be set before the buffers are pushed and the stream
+	 * thread is started, by arv_stream_arm() for example. The locked size is limited by RLIMIT_MEMLOCK, a warning
+	 * being emitted once if the limit is reached, the pages being only prefaulted in this case.
+	 *
+	 * Since: 0.8.24
+	 */
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_LOCK_MEMORY,
+		 g_param_spec_boolean ("lock-memory",
+				       "Lock memory",
+				       "Lock the buffers and the stream thread memory in RAM",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static gboolean
@@ -848,6 +3559,7 @@ arv_stream_initable_init (GInitable     *initable,
 			  GError       **error)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (ARV_STREAM (initable));
+	guint i;
 
 	g_return_val_if_fail (ARV_IS_STREAM (initable), FALSE);
 
@@ -864,6 +3576,31 @@ arv_stream_initable_init (GInitable     *initable,
 		return FALSE;
 	}
 
+	/* Declared after the stream specific informations */
+	for (i = 0; i < ARV_STREAM_LATENCY_N_STAGES; i++) {
+		char *name;
+
+		name = g_strdup_printf ("latency_%s_p50_us", arv_stream_latency_stage_names[i]);
+		arv_stream_declare_info (ARV_STREAM (initable), name, G_TYPE_DOUBLE, &priv->latencies[i].p50_us);
+		g_free (name);
+		name = g_strdup_printf ("latency_%s_p99_us", arv_stream_latency_stage_names[i]);
+		arv_stream_declare_info (ARV_STREAM (initable), name, G_TYPE_DOUBLE, &priv->latencies[i].p99_us);
+		g_free (name);
+		name = g_strdup_printf ("latency_%s_max_us", arv_stream_latency_stage_names[i]);
+		arv_stream_declare_info (ARV_STREAM (initable), name, G_TYPE_DOUBLE, &priv->latencies[i].max_us);
+		g_free (name);
+	}
+
+	arv_stream_declare_info (ARV_STREAM (initable), "n_recycled_buffers", G_TYPE_UINT64, &priv->n_recycled_buffers);
+	arv_stream_declare_info (ARV_STREAM (initable), "n_auto_buffers", G_TYPE_UINT64, &priv->n_auto_buffers);
+	arv_stream_declare_info (ARV_STREAM (initable), "n_auto_buffer_grows", G_TYPE_UINT64,
+				 &priv->n_auto_buffer_grows);
+	arv_stream_declare_info (ARV_STREAM (initable), "n_auto_buffer_shrinks", G_TYPE_UINT64,
+				 &priv->n_auto_buffer_shrinks);
+	arv_stream_declare_info (ARV_STREAM (initable), "n_previews", G_TYPE_UINT64, &priv->n_previews);
+	arv_stream_declare_info (ARV_STREAM (initable), "n_preview_drops", G_TYPE_UINT64, &priv->n_preview_drops);
+	arv_stream_declare_rate_infos (ARV_STREAM (initable), priv->rate_window);
+
 	return TRUE;
 }
 
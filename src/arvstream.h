@@ -29,6 +29,7 @@
 
 #include <arvapi.h>
 #include <arvbuffer.h>
+#include <arvpixelcorrection.h>
 
 G_BEGIN_DECLS
 
@@ -38,6 +39,8 @@ G_BEGIN_DECLS
  * @ARV_STREAM_CALLBACK_TYPE_EXIT: thread end, happens once
  * @ARV_STREAM_CALLBACK_TYPE_START_BUFFER: buffer filling start, happens at each frame
  * @ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE: buffer filled, happens at each frame
+ * @ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS: more data received contiguously from the start of the open buffer, only
+ * happens when #ArvStream:buffer-progress is set (Since: 0.8.24)
  *
  * Describes when the reason the stream callback is called. You are probably more interested in
  * @ARV_STREAM_CALLBACK_TYPE_INIT and @ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE.
@@ -47,9 +50,39 @@ typedef enum {
 	ARV_STREAM_CALLBACK_TYPE_INIT,
 	ARV_STREAM_CALLBACK_TYPE_EXIT,
 	ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
-	ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE
+	ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+	ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS
 } ArvStreamCallbackType;
 
+/**
+ * ArvStreamOutputPolicy:
+ * @ARV_STREAM_OUTPUT_POLICY_FIFO: the output buffers are queued until popped
+ * @ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST: only the latest output buffers are kept, the oldest ones going back to the
+ * input queue
+ * @ARV_STREAM_OUTPUT_POLICY_MAILBOX: only the latest output buffer is kept
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_STREAM_OUTPUT_POLICY_FIFO,
+	ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST,
+	ARV_STREAM_OUTPUT_POLICY_MAILBOX
+} ArvStreamOutputPolicy;
+
+/**
+ * ArvStreamStageMode:
+ * @ARV_STREAM_STAGE_MODE_INLINE: the stage runs in the stream thread
+ * @ARV_STREAM_STAGE_MODE_WORKER: the stage runs in the stage worker pool, the frame order being preserved
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_STREAM_STAGE_MODE_INLINE,
+	ARV_STREAM_STAGE_MODE_WORKER
+} ArvStreamStageMode;
+
 #define ARV_TYPE_STREAM             (arv_stream_get_type ())
 ARV_API G_DECLARE_DERIVABLE_TYPE (ArvStream, arv_stream, ARV, STREAM, GObject)
 
@@ -61,6 +94,11 @@ struct _ArvStreamClass {
 
 	/* signals */
 	void        	(*new_buffer)   	(ArvStream *stream);
+
+	/* Appended after the existing members, for the ABI compatibility of the subclasses */
+
+	void		(*arm)			(ArvStream *stream, size_t buffer_size);
+	void		(*disarm)		(ArvStream *stream);
 };
 
 /**
@@ -73,8 +111,10 @@ struct _ArvStreamClass {
  * receiving thread initialization and finalization, and on every received buffer, once when the buffer is pulled from
  * the buffer queue, and one more when the buffer is done (successfully or not).
  *
- * @buffer is assured to be a valid #ArvBuffer object only when type is @ARV_STREAM_CALLBACK_TYPE_START_BUFFER or
- * @ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE.
+ * @buffer is assured to be a valid #ArvBuffer object only when type is @ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
+ * @ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE or @ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS. In the latter case, the size
+ * returned by arv_buffer_get_data() is the size of the data already received contiguously from the start of the
+ * buffer, which allows to process the first lines of an image before the end of its transmission.
  *
  * The callback is awaken from the stream receiving thread, which means it is forbidden to access to the camera
  * instance, except if you take care to protect the instance access from concurrent access. It also means all the time
@@ -84,15 +124,39 @@ struct _ArvStreamClass {
 
 typedef void (*ArvStreamCallback)	(void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer);
 
+/**
+ * ArvStreamStageFunc:
+ * @buffer: a successfully completed [class@ArvBuffer]
+ * @user_data: a pointer to user data associated to this stage
+ *
+ * A processing stage of the completed buffers, see arv_stream_add_stage(). The buffer can be modified in place, but
+ * is not yet available to the application.
+ *
+ * Since: 0.8.24
+ */
+
+typedef void (*ArvStreamStageFunc)	(ArvBuffer *buffer, void *user_data);
+
 ARV_API void		arv_stream_push_buffer			(ArvStream *stream, ArvBuffer *buffer);
 ARV_API ArvBuffer *	arv_stream_pop_buffer			(ArvStream *stream);
 ARV_API ArvBuffer *	arv_stream_try_pop_buffer		(ArvStream *stream);
 ARV_API ArvBuffer *	arv_stream_timeout_pop_buffer		(ArvStream *stream, guint64 timeout);
+ARV_API void		arv_stream_push_buffers			(ArvStream *stream, ArvBuffer **buffers, guint n_buffers);
+ARV_API guint		arv_stream_pop_buffers			(ArvStream *stream, ArvBuffer **buffers, guint max_buffers,
+								 guint64 timeout);
+ARV_API int		arv_stream_get_ready_fd			(ArvStream *stream);
+ARV_API GPtrArray *	arv_stream_pop_ready_buffers		(ArvStream *stream, guint max_buffers);
 ARV_API void		arv_stream_get_n_buffers		(ArvStream *stream,
 								 gint *n_input_buffers,
 								 gint *n_output_buffers);
 ARV_API void		arv_stream_start_thread			(ArvStream *stream);
 ARV_API unsigned int	arv_stream_stop_thread			(ArvStream *stream, gboolean delete_buffers);
+ARV_API guint		arv_stream_ensure_buffers		(ArvStream *stream, guint n_buffers, size_t buffer_size);
+ARV_API void		arv_stream_grow_buffers			(ArvStream *stream, size_t buffer_size);
+ARV_API void		arv_stream_set_auto_buffers		(ArvStream *stream, size_t buffer_size,
+								 guint n_min_buffers, size_t max_memory);
+ARV_API void		arv_stream_arm				(ArvStream *stream);
+ARV_API void		arv_stream_disarm			(ArvStream *stream);
 
 ARV_API void		arv_stream_get_statistics		(ArvStream *stream,
 								 guint64 *n_completed_buffers,
@@ -109,6 +173,41 @@ ARV_API double		arv_stream_get_info_double_by_name	(ArvStream *stream, const cha
 
 ARV_API void		arv_stream_set_emit_signals		(ArvStream *stream, gboolean emit_signals);
 ARV_API gboolean	arv_stream_get_emit_signals		(ArvStream *stream);
+ARV_API void		arv_stream_set_frame_batching		(ArvStream *stream, guint n_frames, guint64 timeout_us);
+ARV_API guint		arv_stream_get_frame_batching		(ArvStream *stream, guint64 *timeout_us);
+ARV_API void		arv_stream_push_batch_buffer		(ArvStream *stream, ArvBuffer *buffer);
+
+ARV_API void		arv_stream_set_signal_batching		(ArvStream *stream, gboolean signal_batching);
+ARV_API gboolean	arv_stream_get_signal_batching		(ArvStream *stream);
+
+ARV_API void		arv_stream_set_buffer_progress		(ArvStream *stream, gboolean buffer_progress);
+ARV_API gboolean	arv_stream_get_buffer_progress		(ArvStream *stream);
+
+ARV_API void		arv_stream_set_unpack_pixels		(ArvStream *stream, gboolean unpack_pixels);
+ARV_API gboolean	arv_stream_get_unpack_pixels		(ArvStream *stream);
+
+ARV_API void		arv_stream_set_compute_statistics	(ArvStream *stream, gboolean compute_statistics);
+ARV_API gboolean	arv_stream_get_compute_statistics	(ArvStream *stream);
+ARV_API void		arv_stream_set_statistics_grid_size	(ArvStream *stream, guint grid_size);
+ARV_API guint		arv_stream_get_statistics_grid_size	(ArvStream *stream);
+
+ARV_API void			arv_stream_set_output_policy	(ArvStream *stream, ArvStreamOutputPolicy policy,
+								 guint n_output_buffers);
+ARV_API ArvStreamOutputPolicy	arv_stream_get_output_policy	(ArvStream *stream, guint *n_output_buffers);
+
+ARV_API void			arv_stream_add_stage		(ArvStream *stream, ArvStreamStageFunc func,
+								 void *user_data, GDestroyNotify destroy,
+								 ArvStreamStageMode mode);
+ARV_API void			arv_stream_add_compression_stage	(ArvStream *stream,
+									 ArvBufferCompression compression);
+ARV_API void			arv_stream_add_tensor_stage		(ArvStream *stream,
+									 const ArvBufferTensorFormat *format);
+ARV_API void			arv_stream_add_pixel_correction_stage	(ArvStream *stream,
+									 ArvPixelCorrection *correction,
+									 ArvStreamStageMode mode);
+ARV_API void			arv_stream_add_preview_stage		(ArvStream *stream, guint factor,
+									 gboolean debayer, double max_frame_rate);
+ARV_API ArvBuffer *		arv_stream_timeout_pop_preview_buffer	(ArvStream *stream, guint64 timeout);
 
 G_END_DECLS
 
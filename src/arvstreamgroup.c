@@ -0,0 +1,570 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvStreamGroup:
+ *
+ * [class@ArvStreamGroup] assembles the buffers of several [class@ArvStream] in frame sets, for stereo or multi-view
+ * setups.
+ *
+ * The buffers are matched by frame id, for hardware triggered cameras, or by timestamp within a tolerance. The
+ * grouping is done from the stream threads, in the [signal@ArvStream::new-buffer] handler, and the sets are
+ * retrieved from a single output queue as [struct@GLib.PtrArray], the buffer of the stream of index i being at the
+ * index i of the set. The buffers are not copied, and return to their streams when the set is given back using
+ * [method@ArvStreamGroup.push_set].
+ *
+ * Each stream is expected to deliver its buffers in order. A set still waiting for the buffer of a stream is
+ * incomplete once that stream delivered a newer buffer, or once another newer set is complete. The incomplete sets
+ * are dropped or delivered depending on the [enum@ArvStreamGroupIncompletePolicy]. The failed buffers are given
+ * back to their stream right away.
+ *
+ * The application must not pop the buffers from the streams of a group itself.
+ */
+
+#include <arvstreamgroup.h>
+#include <arvdebugprivate.h>
+
+/* Pending sets beyond this number are the oldest ones, resolved as incomplete */
+#define ARV_STREAM_GROUP_MAX_PENDING_SETS	8
+
+typedef struct {
+	guint64 key;
+	guint n_buffers;
+	GPtrArray *buffers;
+} ArvStreamGroupPendingSet;
+
+typedef struct {
+	ArvStreamGroupMatch match;
+
+	GMutex mutex;
+
+	ArvStreamGroupIncompletePolicy incomplete_policy;
+	guint64 tolerance;
+
+	GPtrArray *streams;
+	GArray *last_keys;
+	GArray *has_last_key;
+	GQueue pending_sets;
+
+	GAsyncQueue *output_queue;
+
+	guint64 n_complete_sets;
+	guint64 n_incomplete_sets;
+	guint64 n_dropped_sets;
+} ArvStreamGroupPrivate;
+
+struct _ArvStreamGroup {
+	GObject	object;
+
+	ArvStreamGroupPrivate *priv;
+};
+
+struct _ArvStreamGroupClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvStreamGroup, arv_stream_group, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvStreamGroup))
+
+static guint64
+_get_key (ArvStreamGroupPrivate *priv, ArvBuffer *buffer)
+{
+	switch (priv->match) {
+		case ARV_STREAM_GROUP_MATCH_TIMESTAMP:
+			return arv_buffer_get_timestamp (buffer);
+		case ARV_STREAM_GROUP_MATCH_SYSTEM_TIMESTAMP:
+			return arv_buffer_get_system_timestamp (buffer);
+		default:
+			return arv_buffer_get_frame_id (buffer);
+	}
+}
+
+static gboolean
+_is_matching (ArvStreamGroupPrivate *priv, guint64 set_key, guint64 key)
+{
+	return (key > set_key ? key - set_key : set_key - key) <= priv->tolerance;
+}
+
+/* TRUE if @key is newer than @set_key, and is not matching it */
+
+static gboolean
+_is_newer (ArvStreamGroupPrivate *priv, guint64 set_key, guint64 key)
+{
+	return key > set_key && key - set_key > priv->tolerance;
+}
+
+static gint
+_compare_pending_sets (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	guint64 key_a = ((const ArvStreamGroupPendingSet *) a)->key;
+	guint64 key_b = ((const ArvStreamGroupPendingSet *) b)->key;
+
+	return key_a < key_b ? -1 : (key_a > key_b ? 1 : 0);
+}
+
+/* Gives back the buffers of a set to their streams, and releases the set */
+
+static void
+_recycle_set (ArvStreamGroupPrivate *priv, GPtrArray *set)
+{
+	guint i;
+
+	for (i = 0; i < set->len; i++)
+		if (g_ptr_array_index (set, i) != NULL)
+			arv_stream_push_buffer (g_ptr_array_index (priv->streams, i), g_ptr_array_index (set, i));
+
+	g_ptr_array_unref (set);
+}
+
+/* Delivers or drops a pending set, which is removed from the pending list. Called with the mutex held. */
+
+static void
+_resolve_set (ArvStreamGroupPrivate *priv, ArvStreamGroupPendingSet *pending_set)
+{
+	g_queue_remove (&priv->pending_sets, pending_set);
+
+	if (pending_set->n_buffers == priv->streams->len) {
+		priv->n_complete_sets++;
+		g_async_queue_push (priv->output_queue, pending_set->buffers);
+	} else if (priv->incomplete_policy == ARV_STREAM_GROUP_INCOMPLETE_POLICY_DELIVER) {
+		priv->n_incomplete_sets++;
+		g_async_queue_push (priv->output_queue, pending_set->buffers);
+	} else {
+		arv_debug_stream ("[StreamGroup::resolve_set] Drop set %" G_GUINT64_FORMAT " (%u/%u buffers)",
+				  pending_set->key, pending_set->n_buffers, priv->streams->len);
+		priv->n_dropped_sets++;
+		_recycle_set (priv, pending_set->buffers);
+	}
+
+	g_free (pending_set);
+}
+
+/* TRUE if all the streams missing in the set already delivered a newer buffer */
+
+static gboolean
+_is_set_outdated (ArvStreamGroupPrivate *priv, ArvStreamGroupPendingSet *pending_set)
+{
+	guint i;
+
+	for (i = 0; i < priv->streams->len; i++)
+		if (g_ptr_array_index (pending_set->buffers, i) == NULL &&
+		    (!g_array_index (priv->has_last_key, gboolean, i) ||
+		     !_is_newer (priv, pending_set->key, g_array_index (priv->last_keys, guint64, i))))
+			return FALSE;
+
+	return TRUE;
+}
+
+static void
+_add_buffer (ArvStreamGroupPrivate *priv, guint stream_id, ArvBuffer *buffer)
+{
+	ArvStreamGroupPendingSet *pending_set = NULL;
+	GList *iter;
+	guint64 key;
+
+	key = _get_key (priv, buffer);
+
+	g_array_index (priv->last_keys, guint64, stream_id) = key;
+	g_array_index (priv->has_last_key, gboolean, stream_id) = TRUE;
+
+	for (iter = priv->pending_sets.head; iter != NULL; iter = iter->next) {
+		ArvStreamGroupPendingSet *candidate = iter->data;
+
+		if (g_ptr_array_index (candidate->buffers, stream_id) == NULL &&
+		    _is_matching (priv, candidate->key, key)) {
+			pending_set = candidate;
+			break;
+		}
+	}
+
+	if (pending_set == NULL) {
+		if (priv->pending_sets.length >= ARV_STREAM_GROUP_MAX_PENDING_SETS)
+			_resolve_set (priv, g_queue_peek_head (&priv->pending_sets));
+
+		pending_set = g_new0 (ArvStreamGroupPendingSet, 1);
+		pending_set->key = key;
+		pending_set->buffers = g_ptr_array_sized_new (priv->streams->len);
+		g_ptr_array_set_size (pending_set->buffers, priv->streams->len);
+		g_queue_insert_sorted (&priv->pending_sets, pending_set, _compare_pending_sets, NULL);
+	}
+
+	g_ptr_array_index (pending_set->buffers, stream_id) = buffer;
+	pending_set->n_buffers++;
+
+	if (pending_set->n_buffers == priv->streams->len) {
+		/* All the streams are past the older sets */
+		while (g_queue_peek_head (&priv->pending_sets) != pending_set)
+			_resolve_set (priv, g_queue_peek_head (&priv->pending_sets));
+		_resolve_set (priv, pending_set);
+		return;
+	}
+
+	iter = priv->pending_sets.head;
+	while (iter != NULL) {
+		ArvStreamGroupPendingSet *candidate = iter->data;
+
+		iter = iter->next;
+		if (_is_set_outdated (priv, candidate))
+			_resolve_set (priv, candidate);
+	}
+}
+
+/* Returns the index of a stream, -1 if not in the group. Called with the mutex held. */
+
+static gint
+_find_stream (ArvStreamGroupPrivate *priv, ArvStream *stream)
+{
+	guint i;
+
+	for (i = 0; i < priv->streams->len; i++)
+		if (g_ptr_array_index (priv->streams, i) == stream)
+			return i;
+
+	return -1;
+}
+
+static void
+_new_buffer_cb (ArvStream *stream, ArvStreamGroup *group)
+{
+	ArvStreamGroupPrivate *priv = group->priv;
+	ArvBuffer *buffer;
+	gint stream_id;
+
+	while ((buffer = arv_stream_try_pop_buffer (stream)) != NULL) {
+		if (arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS) {
+			arv_stream_push_buffer (stream, buffer);
+			continue;
+		}
+
+		g_mutex_lock (&priv->mutex);
+		stream_id = _find_stream (priv, stream);
+		if (stream_id >= 0)
+			_add_buffer (priv, stream_id, buffer);
+		g_mutex_unlock (&priv->mutex);
+
+		if (stream_id < 0)
+			arv_stream_push_buffer (stream, buffer);
+	}
+}
+
+/**
+ * arv_stream_group_new:
+ * @match: the buffer matching method
+ *
+ * Creates a new stream group, with a zero tolerance and the %ARV_STREAM_GROUP_INCOMPLETE_POLICY_DROP policy.
+ *
+ * Returns: (transfer full): a new #ArvStreamGroup
+ *
+ * Since: 0.8.24
+ */
+
+ArvStreamGroup *
+arv_stream_group_new (ArvStreamGroupMatch match)
+{
+	ArvStreamGroup *group;
+
+	group = g_object_new (ARV_TYPE_STREAM_GROUP, NULL);
+	group->priv->match = match;
+
+	return group;
+}
+
+/**
+ * arv_stream_group_set_tolerance:
+ * @group: a #ArvStreamGroup
+ * @tolerance_ns: maximum difference between the timestamps of the buffers of a set, in nanoseconds
+ *
+ * Sets the timestamp tolerance, which should be less than half the frame period. It is not used when matching by
+ * frame id.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_group_set_tolerance (ArvStreamGroup *group, guint64 tolerance_ns)
+{
+	g_return_if_fail (ARV_IS_STREAM_GROUP (group));
+
+	g_mutex_lock (&group->priv->mutex);
+	if (group->priv->match != ARV_STREAM_GROUP_MATCH_FRAME_ID)
+		group->priv->tolerance = tolerance_ns;
+	g_mutex_unlock (&group->priv->mutex);
+}
+
+/**
+ * arv_stream_group_set_incomplete_policy:
+ * @group: a #ArvStreamGroup
+ * @policy: the policy for the incomplete sets
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_group_set_incomplete_policy (ArvStreamGroup *group, ArvStreamGroupIncompletePolicy policy)
+{
+	g_return_if_fail (ARV_IS_STREAM_GROUP (group));
+
+	g_mutex_lock (&group->priv->mutex);
+	group->priv->incomplete_policy = policy;
+	g_mutex_unlock (&group->priv->mutex);
+}
+
+/**
+ * arv_stream_group_add_stream:
+ * @group: a #ArvStreamGroup
+ * @stream: a #ArvStream
+ *
+ * Adds a stream to the group, and enables its [signal@ArvStream::new-buffer] signal. The streams must be added
+ * before the start of the acquisitions.
+ *
+ * Returns: the index of the stream buffers in the frame sets.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_stream_group_add_stream (ArvStreamGroup *group, ArvStream *stream)
+{
+	guint64 last_key = 0;
+	gboolean has_last_key = FALSE;
+	gint stream_id;
+
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	g_mutex_lock (&group->priv->mutex);
+
+	stream_id = _find_stream (group->priv, stream);
+	if (stream_id < 0) {
+		if (!g_queue_is_empty (&group->priv->pending_sets))
+			g_warning ("Stream added to a stream group already receiving buffers");
+
+		stream_id = group->priv->streams->len;
+		g_ptr_array_add (group->priv->streams, g_object_ref (stream));
+		g_array_append_val (group->priv->last_keys, last_key);
+		g_array_append_val (group->priv->has_last_key, has_last_key);
+
+		g_signal_connect (stream, "new-buffer", G_CALLBACK (_new_buffer_cb), group);
+		arv_stream_set_emit_signals (stream, TRUE);
+	}
+
+	g_mutex_unlock (&group->priv->mutex);
+
+	return stream_id;
+}
+
+/**
+ * arv_stream_group_get_n_streams:
+ * @group: a #ArvStreamGroup
+ *
+ * Returns: the number of streams of @group, which is the size of the frame sets.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_stream_group_get_n_streams (ArvStreamGroup *group)
+{
+	guint n_streams;
+
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+
+	g_mutex_lock (&group->priv->mutex);
+	n_streams = group->priv->streams->len;
+	g_mutex_unlock (&group->priv->mutex);
+
+	return n_streams;
+}
+
+/**
+ * arv_stream_group_pop_set:
+ * @group: a #ArvStreamGroup
+ *
+ * Pops a frame set from the output queue, waiting for one if the queue is empty.
+ *
+ * Returns: (transfer full) (element-type ArvBuffer): a frame set, whose buffer of index i comes from the stream of
+ * index i, and is %NULL if missing in an incomplete set.
+ *
+ * Since: 0.8.24
+ */
+
+GPtrArray *
+arv_stream_group_pop_set (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), NULL);
+
+	return g_async_queue_pop (group->priv->output_queue);
+}
+
+/**
+ * arv_stream_group_try_pop_set:
+ * @group: a #ArvStreamGroup
+ *
+ * Pops a frame set from the output queue, without waiting.
+ *
+ * Returns: (transfer full) (element-type ArvBuffer) (nullable): a frame set, %NULL if none is available.
+ *
+ * Since: 0.8.24
+ */
+
+GPtrArray *
+arv_stream_group_try_pop_set (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), NULL);
+
+	return g_async_queue_try_pop (group->priv->output_queue);
+}
+
+/**
+ * arv_stream_group_timeout_pop_set:
+ * @group: a #ArvStreamGroup
+ * @timeout: timeout, in µs
+ *
+ * Pops a frame set from the output queue, waiting at most @timeout µs for one.
+ *
+ * Returns: (transfer full) (element-type ArvBuffer) (nullable): a frame set, %NULL on timeout.
+ *
+ * Since: 0.8.24
+ */
+
+GPtrArray *
+arv_stream_group_timeout_pop_set (ArvStreamGroup *group, guint64 timeout)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), NULL);
+
+	return g_async_queue_timeout_pop (group->priv->output_queue, timeout);
+}
+
+/**
+ * arv_stream_group_push_set:
+ * @group: a #ArvStreamGroup
+ * @set: (transfer full): a frame set popped from @group
+ *
+ * Gives back the buffers of a frame set to their streams.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_group_push_set (ArvStreamGroup *group, GPtrArray *set)
+{
+	g_return_if_fail (ARV_IS_STREAM_GROUP (group));
+	g_return_if_fail (set != NULL);
+
+	g_mutex_lock (&group->priv->mutex);
+	if (set->len <= group->priv->streams->len)
+		_recycle_set (group->priv, set);
+	else
+		g_critical ("Frame set not popped from this stream group");
+	g_mutex_unlock (&group->priv->mutex);
+}
+
+/**
+ * arv_stream_group_get_statistics:
+ * @group: a #ArvStreamGroup
+ * @n_complete_sets: (out) (optional): number of complete sets
+ * @n_incomplete_sets: (out) (optional): number of delivered incomplete sets
+ * @n_dropped_sets: (out) (optional): number of dropped incomplete sets
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_stream_group_get_statistics (ArvStreamGroup *group,
+				 guint64 *n_complete_sets, guint64 *n_incomplete_sets, guint64 *n_dropped_sets)
+{
+	g_return_if_fail (ARV_IS_STREAM_GROUP (group));
+
+	g_mutex_lock (&group->priv->mutex);
+	if (n_complete_sets != NULL)
+		*n_complete_sets = group->priv->n_complete_sets;
+	if (n_incomplete_sets != NULL)
+		*n_incomplete_sets = group->priv->n_incomplete_sets;
+	if (n_dropped_sets != NULL)
+		*n_dropped_sets = group->priv->n_dropped_sets;
+	g_mutex_unlock (&group->priv->mutex);
+}
+
+static void
+arv_stream_group_init (ArvStreamGroup *group)
+{
+	group->priv = arv_stream_group_get_instance_private (group);
+
+	g_mutex_init (&group->priv->mutex);
+	group->priv->streams = g_ptr_array_new_with_free_func (g_object_unref);
+	group->priv->last_keys = g_array_new (FALSE, TRUE, sizeof (guint64));
+	group->priv->has_last_key = g_array_new (FALSE, TRUE, sizeof (gboolean));
+	g_queue_init (&group->priv->pending_sets);
+	group->priv->output_queue = g_async_queue_new ();
+	group->priv->incomplete_policy = ARV_STREAM_GROUP_INCOMPLETE_POLICY_DROP;
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvStreamGroup *group = ARV_STREAM_GROUP (object);
+	ArvStreamGroupPendingSet *pending_set;
+	GPtrArray *set;
+	guint i;
+
+	/* Disabling the signal emission waits for the end of a running handler */
+	for (i = 0; i < group->priv->streams->len; i++) {
+		ArvStream *stream = g_ptr_array_index (group->priv->streams, i);
+
+		arv_stream_set_emit_signals (stream, FALSE);
+		g_signal_handlers_disconnect_by_func (stream, _new_buffer_cb, group);
+	}
+
+	while ((pending_set = g_queue_pop_head (&group->priv->pending_sets)) != NULL) {
+		_recycle_set (group->priv, pending_set->buffers);
+		g_free (pending_set);
+	}
+
+	while ((set = g_async_queue_try_pop (group->priv->output_queue)) != NULL)
+		_recycle_set (group->priv, set);
+
+	g_ptr_array_set_size (group->priv->streams, 0);
+
+	G_OBJECT_CLASS (arv_stream_group_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvStreamGroup *group = ARV_STREAM_GROUP (object);
+
+	g_ptr_array_unref (group->priv->streams);
+	g_array_unref (group->priv->last_keys);
+	g_array_unref (group->priv->has_last_key);
+	g_async_queue_unref (group->priv->output_queue);
+	g_mutex_clear (&group->priv->mutex);
+
+	G_OBJECT_CLASS (arv_stream_group_parent_class)->finalize (object);
+}
+
+static void
+arv_stream_group_class_init (ArvStreamGroupClass *group_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (group_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
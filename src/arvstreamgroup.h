@@ -0,0 +1,89 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_STREAM_GROUP_H
+#define ARV_STREAM_GROUP_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+/**
+ * ArvStreamGroupMatch:
+ * @ARV_STREAM_GROUP_MATCH_FRAME_ID: buffers with the same frame id, for hardware triggered cameras
+ * @ARV_STREAM_GROUP_MATCH_TIMESTAMP: buffers whose device timestamps are within the tolerance, for cameras with
+ * synchronized clocks
+ * @ARV_STREAM_GROUP_MATCH_SYSTEM_TIMESTAMP: buffers whose host reception times are within the tolerance
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_STREAM_GROUP_MATCH_FRAME_ID,
+	ARV_STREAM_GROUP_MATCH_TIMESTAMP,
+	ARV_STREAM_GROUP_MATCH_SYSTEM_TIMESTAMP
+} ArvStreamGroupMatch;
+
+/**
+ * ArvStreamGroupIncompletePolicy:
+ * @ARV_STREAM_GROUP_INCOMPLETE_POLICY_DROP: the incomplete sets are dropped, their buffers going back to their streams
+ * @ARV_STREAM_GROUP_INCOMPLETE_POLICY_DELIVER: the incomplete sets are delivered, with %NULL for the missing buffers
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_STREAM_GROUP_INCOMPLETE_POLICY_DROP,
+	ARV_STREAM_GROUP_INCOMPLETE_POLICY_DELIVER
+} ArvStreamGroupIncompletePolicy;
+
+#define ARV_TYPE_STREAM_GROUP             (arv_stream_group_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvStreamGroup, arv_stream_group, ARV, STREAM_GROUP, GObject)
+
+ARV_API ArvStreamGroup *	arv_stream_group_new			(ArvStreamGroupMatch match);
+
+ARV_API void			arv_stream_group_set_tolerance		(ArvStreamGroup *group, guint64 tolerance_ns);
+ARV_API void			arv_stream_group_set_incomplete_policy	(ArvStreamGroup *group,
+									 ArvStreamGroupIncompletePolicy policy);
+
+ARV_API guint			arv_stream_group_add_stream		(ArvStreamGroup *group, ArvStream *stream);
+ARV_API guint			arv_stream_group_get_n_streams		(ArvStreamGroup *group);
+
+ARV_API GPtrArray *		arv_stream_group_pop_set		(ArvStreamGroup *group);
+ARV_API GPtrArray *		arv_stream_group_try_pop_set		(ArvStreamGroup *group);
+ARV_API GPtrArray *		arv_stream_group_timeout_pop_set	(ArvStreamGroup *group, guint64 timeout);
+ARV_API void			arv_stream_group_push_set		(ArvStreamGroup *group, GPtrArray *set);
+
+ARV_API void			arv_stream_group_get_statistics		(ArvStreamGroup *group,
+									 guint64 *n_complete_sets,
+									 guint64 *n_incomplete_sets,
+									 guint64 *n_dropped_sets);
+
+G_END_DECLS
+
+#endif
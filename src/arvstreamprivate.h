@@ -28,14 +28,24 @@
 #endif
 
 #include <arvstream.h>
+#include <arvhdrhistogramprivate.h>
+#include <arvratewindowprivate.h>
 
 G_BEGIN_DECLS
 
 ArvBuffer *	arv_stream_pop_input_buffer		(ArvStream *stream);
+ArvBuffer *	arv_stream_timeout_pop_input_buffer	(ArvStream *stream, guint64 timeout);
+ArvBuffer *	arv_stream_steal_output_buffer		(ArvStream *stream);
 void		arv_stream_push_output_buffer		(ArvStream *stream, ArvBuffer *buffer);
 void		arv_stream_take_init_error		(ArvStream *device, GError *error);
+void		arv_stream_apply_thread_affinity	(ArvStream *stream);
+gboolean	arv_stream_lock_memory			(ArvStream *stream, void *data, size_t size);
+gboolean	arv_stream_has_inline_stages		(ArvStream *stream);
+void		arv_stream_set_regions			(ArvStream *stream, GArray *regions);
 
 void            arv_stream_declare_info                 (ArvStream *stream, const char *name, GType type, gpointer data);
+void		arv_stream_declare_histogram_infos	(ArvStream *stream, ArvHdrHistogram *histogram, guint id);
+void		arv_stream_declare_rate_infos		(ArvStream *stream, ArvRateWindow *window);
 
 G_END_DECLS
 
@@ -32,6 +32,8 @@
 #include <string.h>
 #include <arvmisc.h>
 #include <arvdomimplementation.h>
+#include <arvgcprivate.h>
+#include <arvnetworkprivate.h>
 
 static GMutex arv_system_mutex;
 
@@ -403,6 +405,9 @@ arv_get_device_protocol	(unsigned int index)
  * Open a device corresponding to the given identifier. A %NULL string makes
  * this function return the first available device.
  *
+ * This function can be called concurrently from several threads, the devices being opened in parallel. The
+ * Genicam data of identical devices are only parsed once, see arv_gc_new().
+ *
  * Return value: (transfer full): A new #ArvDevice instance.
  *
  * Since: 0.8.0
@@ -411,29 +416,35 @@ arv_get_device_protocol	(unsigned int index)
 ArvDevice *
 arv_open_device (const char *device_id, GError **error)
 {
+	ArvInterface *available_interfaces[G_N_ELEMENTS (interfaces)];
+	unsigned int n_interfaces = 0;
 	unsigned int i;
 
+	/* Only the interface list is protected by the system lock, as the device instantiation may take a while */
+
 	g_mutex_lock (&arv_system_mutex);
 
-	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
-		ArvInterface *interface;
-		ArvDevice *device;
+	for (i = 0; i < G_N_ELEMENTS (interfaces); i++)
+		if (interfaces[i].is_available)
+			available_interfaces[n_interfaces++] = g_object_ref (interfaces[i].get_interface_instance ());
 
-		if (interfaces[i].is_available) {
-			GError *local_error = NULL;
+	g_mutex_unlock (&arv_system_mutex);
 
-			interface = interfaces[i].get_interface_instance ();
-			device = arv_interface_open_device (interface, device_id, &local_error);
-			if (ARV_IS_DEVICE (device) || local_error != NULL) {
-				if (local_error != NULL)
-					g_propagate_error (error, local_error);
-				g_mutex_unlock (&arv_system_mutex);
-				return device;
-			}
+	for (i = 0; i < n_interfaces; i++) {
+		GError *local_error = NULL;
+		ArvDevice *device;
+
+		device = arv_interface_open_device (available_interfaces[i], device_id, &local_error);
+		if (ARV_IS_DEVICE (device) || local_error != NULL) {
+			if (local_error != NULL)
+				g_propagate_error (error, local_error);
+			for (; i < n_interfaces; i++)
+				g_object_unref (available_interfaces[i]);
+			return device;
 		}
-	}
 
-	g_mutex_unlock (&arv_system_mutex);
+		g_object_unref (available_interfaces[i]);
+	}
 
 	if (device_id != NULL)
 		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND,
@@ -464,6 +475,8 @@ arv_shutdown (void)
 		interfaces[i].destroy_interface_instance ();
 
 	arv_dom_implementation_cleanup ();
+	arv_gc_template_cache_cleanup ();
+	arv_network_cleanup ();
 
 	g_mutex_unlock (&arv_system_mutex);
 }
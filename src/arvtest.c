@@ -35,6 +35,11 @@
 #include <unistd.h>
 #endif
 
+#ifdef G_OS_UNIX
+#include <time.h>
+#include <pthread.h>
+#endif
+
 typedef enum {
         ARV_TEST_STATUS_SUCCESS,
         ARV_TEST_STATUS_FAILURE,
@@ -90,6 +95,7 @@ typedef struct {
         char *vendor_model;
         GSList *results;
         gboolean cache_check;
+        gint64 open_time_us;
 } ArvTestCamera;
 
 #define ARV_TYPE_TEST_CAMERA (arv_test_camera_get_type())
@@ -99,7 +105,11 @@ static ArvTestCamera *
 arv_test_camera_new (const char *camera_id, gboolean cache_check)
 {
         ArvTestCamera *test_camera;
-        ArvCamera *camera = arv_camera_new (camera_id, NULL);
+        ArvCamera *camera;
+        gint64 start_time;
+
+        start_time = g_get_monotonic_time ();
+        camera = arv_camera_new (camera_id, NULL);
 
         if (!ARV_IS_CAMERA (camera))
                 return NULL;
@@ -107,6 +117,7 @@ arv_test_camera_new (const char *camera_id, gboolean cache_check)
         test_camera = g_new0 (ArvTestCamera, 1);
         test_camera->id = g_strdup (camera_id);
         test_camera->camera = camera;
+        test_camera->open_time_us = g_get_monotonic_time () - start_time;
         test_camera->vendor_model = g_strdup_printf ("%s:%s",
                                                      arv_camera_get_vendor_name (test_camera->camera, NULL),
                                                      arv_camera_get_model_name (test_camera->camera, NULL));
@@ -756,6 +767,211 @@ arv_test_software_trigger (ArvTest *test, const char *test_name, ArvTestCamera *
         g_clear_pointer (&message, g_free);
 }
 
+/* Reports a measurement, checked against the optional threshold of @key */
+
+static void
+_add_measurement_result (ArvTestCamera *test_camera, ArvTest *test, const char *test_name, const char *step_name,
+                         const char *key, gboolean is_upper_bound, double value, const char *unit)
+{
+        ArvTestStatus status;
+        char *comment;
+        double threshold;
+
+        threshold = arv_test_camera_get_key_file_double (test_camera, test, key, NAN);
+
+        if (isnan (threshold)) {
+                status = ARV_TEST_STATUS_IGNORED;
+                comment = g_strdup_printf ("%.3f %s", value, unit);
+        } else {
+                gboolean success = is_upper_bound ? value <= threshold : value >= threshold;
+
+                status = success ? ARV_TEST_STATUS_SUCCESS : ARV_TEST_STATUS_FAILURE;
+                comment = g_strdup_printf ("%.3f %s (%s: %.3f %s)", value, unit,
+                                           is_upper_bound ? "max" : "min", threshold, unit);
+        }
+
+        arv_test_camera_add_result (test_camera, test_name, step_name, status, comment);
+
+        g_free (comment);
+}
+
+typedef struct {
+        gint has_stream_clock;
+#ifdef G_OS_UNIX
+        clockid_t stream_clock;
+#endif
+} ArvTestStreamClock;
+
+static void
+_performance_stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+#ifdef G_OS_UNIX
+        ArvTestStreamClock *clock = user_data;
+
+        if (type == ARV_STREAM_CALLBACK_TYPE_INIT &&
+            pthread_getcpuclockid (pthread_self (), &clock->stream_clock) == 0)
+                g_atomic_int_set (&clock->has_stream_clock, TRUE);
+        else if (type == ARV_STREAM_CALLBACK_TYPE_EXIT)
+                g_atomic_int_set (&clock->has_stream_clock, FALSE);
+#endif
+}
+
+static double
+_get_stream_cpu_time (ArvTestStreamClock *clock)
+{
+#ifdef G_OS_UNIX
+        struct timespec time;
+
+        if (g_atomic_int_get (&clock->has_stream_clock) &&
+            clock_gettime (clock->stream_clock, &time) == 0)
+                return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+        return NAN;
+}
+
+static void
+arv_test_performance (ArvTest *test, const char *test_name, ArvTestCamera *test_camera)
+{
+        GError *error = NULL;
+        ArvTestStreamClock clock = {0};
+        ArvStream *stream = NULL;
+        ArvDevice *device;
+        ArvGc *genicam;
+        const char *xml;
+        size_t size;
+        size_t payload_size = 0;
+        gint64 start_time;
+        gint64 first_frame_time = -1;
+        gint64 first_timestamp = -1;
+        gint64 last_timestamp = -1;
+        gint64 packet_delay;
+        gint64 previous_packet_delay = -1;
+        double min_frame_rate, max_frame_rate;
+        double reported_frame_rate = 0.0;
+        double start_cpu_time = NAN;
+        double end_cpu_time = NAN;
+        guint n_expected_buffers;
+        guint n_completed_buffers = 0;
+        unsigned int i;
+
+        g_return_if_fail (ARV_IS_TEST (test));
+
+        _add_measurement_result (test_camera, test, test_name, "OpenTime", "MaxOpenTime", TRUE,
+                                 test_camera->open_time_us / 1000.0, "ms");
+
+        device = arv_camera_get_device (test_camera->camera);
+        xml = arv_device_get_genicam_xml (device, &size);
+        if (xml != NULL) {
+                start_time = g_get_monotonic_time ();
+                genicam = arv_gc_new (device, xml, size);
+                _add_measurement_result (test_camera, test, test_name, "XmlParseTime", "MaxXmlParseTime", TRUE,
+                                         (g_get_monotonic_time () - start_time) / 1000.0, "ms");
+                g_clear_object (&genicam);
+        }
+
+        n_expected_buffers = arv_test_camera_get_key_file_int64 (test_camera, test, "PerformanceFrameCount", 100);
+        packet_delay = arv_test_camera_get_key_file_int64 (test_camera, test, "PerformancePacketDelay", -1);
+
+        arv_camera_set_acquisition_mode (test_camera->camera, ARV_ACQUISITION_MODE_CONTINUOUS, &error);
+        if (error == NULL)
+                arv_camera_get_frame_rate_bounds (test_camera->camera, &min_frame_rate, &max_frame_rate, &error);
+        if (error == NULL)
+                arv_camera_set_frame_rate (test_camera->camera, max_frame_rate, &error);
+        if (error == NULL)
+                reported_frame_rate = arv_camera_get_frame_rate (test_camera->camera, &error);
+        if (error == NULL && packet_delay >= 0 && arv_camera_is_gv_device (test_camera->camera)) {
+                previous_packet_delay = arv_camera_gv_get_packet_delay (test_camera->camera, &error);
+                if (error == NULL)
+                        arv_camera_gv_set_packet_delay (test_camera->camera, packet_delay, &error);
+        }
+
+        if (error == NULL)
+                stream = arv_camera_create_stream (test_camera->camera, _performance_stream_cb, &clock, &error);
+        if (error == NULL)
+                payload_size = arv_camera_get_payload (test_camera->camera, &error);
+        if (error == NULL) {
+                for (i = 0 ; i < 10; i++)
+                        arv_stream_push_buffer (stream, arv_buffer_new (payload_size, FALSE));
+        }
+
+        start_time = g_get_monotonic_time ();
+        if (error == NULL)
+                arv_camera_start_acquisition (test_camera->camera, &error);
+        for (i = 0; i < n_expected_buffers && error == NULL; i++) {
+                ArvBuffer *buffer;
+
+                buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+                if (buffer == NULL)
+                        break;
+
+                if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+                        if (first_frame_time < 0) {
+                                first_frame_time = g_get_monotonic_time ();
+                                first_timestamp = arv_buffer_get_system_timestamp (buffer);
+                                start_cpu_time = _get_stream_cpu_time (&clock);
+                        } else {
+                                n_completed_buffers++;
+                                last_timestamp = arv_buffer_get_system_timestamp (buffer);
+                        }
+                }
+                arv_stream_push_buffer (stream, buffer);
+        }
+        end_cpu_time = _get_stream_cpu_time (&clock);
+
+        if (stream != NULL) {
+                GError *local_error = NULL;
+
+                arv_camera_stop_acquisition (test_camera->camera, &local_error);
+                g_clear_error (&local_error);
+        }
+
+        if (error != NULL) {
+                arv_test_camera_add_result (test_camera, test_name, "Acquisition",
+                                            ARV_TEST_STATUS_FAILURE, error->message);
+        } else if (first_frame_time < 0) {
+                arv_test_camera_add_result (test_camera, test_name, "Acquisition",
+                                            ARV_TEST_STATUS_FAILURE, "No frame received");
+        } else {
+                _add_measurement_result (test_camera, test, test_name, "TimeToFirstFrame", "MaxTimeToFirstFrame",
+                                         TRUE, (first_frame_time - start_time) / 1000.0, "ms");
+
+                if (n_completed_buffers > 0 && last_timestamp > first_timestamp && reported_frame_rate > 0.0) {
+                        double frame_rate = n_completed_buffers * 1e9 / (last_timestamp - first_timestamp);
+
+                        _add_measurement_result (test_camera, test, test_name, "FrameRateRatio",
+                                                 "MinFrameRateRatio", FALSE, frame_rate / reported_frame_rate,
+                                                 "of max");
+
+                        if (!isnan (start_cpu_time) && !isnan (end_cpu_time))
+                                _add_measurement_result (test_camera, test, test_name, "StreamCpuTimePerFrame",
+                                                         "MaxStreamCpuTimePerFrame", TRUE,
+                                                         1e6 * (end_cpu_time - start_cpu_time) /
+                                                         n_completed_buffers, "µs");
+                }
+
+                if (arv_camera_is_gv_device (test_camera->camera)) {
+                        guint64 n_received_packets;
+                        guint64 n_resent_packets;
+
+                        n_received_packets = arv_stream_get_info_uint64_by_name (stream, "n_received_packets");
+                        n_resent_packets = arv_stream_get_info_uint64_by_name (stream, "n_resent_packets");
+
+                        if (n_received_packets > 0)
+                                _add_measurement_result (test_camera, test, test_name, "ResendRatio",
+                                                         "MaxResendRatio", TRUE,
+                                                         (double) n_resent_packets / n_received_packets,
+                                                         "of packets");
+                }
+        }
+
+        g_clear_object (&stream);
+
+        if (previous_packet_delay >= 0)
+                arv_camera_gv_set_packet_delay (test_camera->camera, previous_packet_delay, NULL);
+
+        g_clear_error (&error);
+}
+
 static void
 arv_test_gige_vision (ArvTest *test, const char *test_name, ArvTestCamera *test_camera)
 {
@@ -811,7 +1027,8 @@ const struct {
         {"SingleAcquisition",           arv_test_single_acquisition,    FALSE},
         {"Chunks",                      arv_test_chunks,                FALSE},
         {"GigEVision",                  arv_test_gige_vision,           FALSE},
-        {"USB3Vision",                  arv_test_usb3_vision,           FALSE}
+        {"USB3Vision",                  arv_test_usb3_vision,           FALSE},
+        {"Performance",                 arv_test_performance,           TRUE}
 };
 
 static gboolean
@@ -22,10 +22,13 @@
 
 #include <arvdebugprivate.h>
 #include <arvmiscprivate.h>
+#include <arvnetworkprivate.h>
 #include <arv.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
 
 static char *arv_option_device_selection = NULL;
 static char *arv_option_device_address = NULL;
@@ -33,8 +36,15 @@ static char *arv_option_debug_domains = NULL;
 static char *arv_option_register_cache = NULL;
 static char *arv_option_range_check = NULL;
 static char *arv_option_access_check = NULL;
+static char *arv_option_uncached = NULL;
+static gboolean arv_option_show_cache_statistics = FALSE;
+static gboolean arv_option_show_profile = FALSE;
 static gboolean arv_option_show_time = FALSE;
 static gboolean arv_option_show_version = FALSE;
+static int arv_option_n_jobs = 8;
+
+/* Set by the commands detecting a problem, for the use in scripts */
+static int arv_tool_exit_status = EXIT_SUCCESS;
 
 static const GOptionEntry arv_option_entries[] =
 {
@@ -51,7 +61,22 @@ static const GOptionEntry arv_option_entries[] =
 	{
 		"register-cache",		'\0', 0, G_OPTION_ARG_STRING,
 		&arv_option_register_cache, 	"Register cache policy",
-		"{disable|enable|debug}"
+		"{disable|enable|debug|static}"
+	},
+	{
+		"uncached",			'\0', 0, G_OPTION_ARG_STRING,
+		&arv_option_uncached,		"Features or categories read without register cache",
+		"<feature>[,...]"
+	},
+	{
+		"cache-statistics",		'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_show_cache_statistics, "Show the register cache statistics of each feature",
+		NULL
+	},
+	{
+		"profile",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_show_profile,	"Show the device accesses and time spent by each feature access",
+		NULL
 	},
 	{
 		"range-check",			'\0', 0, G_OPTION_ARG_STRING,
@@ -68,6 +93,11 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_show_time, 		"Show execution time",
 		NULL
 	},
+	{
+		"jobs",				'j', 0, G_OPTION_ARG_INT,
+		&arv_option_n_jobs,		"Number of devices configured in parallel by the batch command",
+		"<n_jobs>"
+	},
 	{
 		"debug", 			'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 	NULL,
@@ -91,10 +121,21 @@ description_content[] =
 "  description [<feature>] ...:      show the full feature description\n"
 "  control <feature>[=<value>] ...:  read/write device features\n"
 "  network <setting>[=<value>]:      read/write network settings\n"
+"  network check:                    check the host network configuration against the camera stream\n"
+"                                    needs, and print recommendations. The exit status is non zero\n"
+"                                    if a problem is found\n"
+"  stats [<duration>]:               print the device statistics in OpenMetrics format, and the stream\n"
+"                                    statistics of an acquisition of <duration> seconds, if given\n"
+"  batch <script>|<feature>[=<value>] ...:\n"
+"                                    write features on all the matching devices in parallel, and print\n"
+"                                    the per device results in JSON format\n"
 "\n"
 "If no command is given, this utility will list all the available devices.\n"
 "For the control command, direct access to device registers is provided using a R[address] syntax"
 " in place of a feature name.\n"
+"The batch command takes either a list of feature assignments or command names, or a script file\n"
+"with the same syntax, where the text after a '#' is ignored. Only the features whose value\n"
+"differs are written, using a transaction on each device, on at most --jobs devices at once.\n"
 "\n"
 "Examples:\n"
 "\n"
@@ -103,6 +144,12 @@ description_content[] =
 "arv-tool-" ARAVIS_API_VERSION " description Width Height\n"
 "arv-tool-" ARAVIS_API_VERSION " network mode=PersistentIP\n"
 "arv-tool-" ARAVIS_API_VERSION " network ip=192.168.0.1 mask=255.255.255.0 gateway=192.168.0.254\n"
+"arv-tool-" ARAVIS_API_VERSION " network check\n"
+"arv-tool-" ARAVIS_API_VERSION " stats 10\n"
+"arv-tool-" ARAVIS_API_VERSION " -n 'Basler-*' -j 16 batch line-setup.txt\n"
+"arv-tool-" ARAVIS_API_VERSION " -n 'Basler-*' batch ExposureTime=5000 Gain=2\n"
+"arv-tool-" ARAVIS_API_VERSION " --register-cache=debug --uncached=DeviceTemperature --cache-statistics values\n"
+"arv-tool-" ARAVIS_API_VERSION " --profile control AcquisitionFrameRate ExposureTime\n"
 "arv-tool-" ARAVIS_API_VERSION " -n Basler-210ab4 genicam";
 
 
@@ -225,31 +272,45 @@ arv_tool_show_feature (ArvGcFeatureNode *node, ArvToolListMode list_mode, int le
 }
 
 static void
-arv_tool_list_features (ArvGc *genicam, const char *feature, ArvToolListMode list_mode, GRegex *regex, int level)
+arv_tool_list_features (ArvGc *genicam, const char *feature, ArvToolListMode list_mode, GRegex *regex)
 {
-	ArvGcNode *node;
+	GArray *index;
+	guint skip_level = G_MAXUINT;
+	guint match_level = G_MAXUINT;
+	guint i;
 
-	node = arv_gc_get_node (genicam, feature);
-	if (ARV_IS_GC_FEATURE_NODE (node) &&
-	    arv_gc_feature_node_is_implemented (ARV_GC_FEATURE_NODE (node), NULL)) {
-                gboolean match;
+	index = arv_gc_dup_feature_index (genicam, feature, NULL);
+	if (index == NULL)
+		return;
 
-                match = regex == NULL || g_regex_match (regex,
-                                                        arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (node)),
-                                                        0, NULL);
-                if (match)
-                        arv_tool_show_feature (ARV_GC_FEATURE_NODE (node), list_mode, level);
+	for (i = 0; i < index->len; i++) {
+		ArvGcFeatureIndexEntry *entry = &g_array_index (index, ArvGcFeatureIndexEntry, i);
 
-		if (ARV_IS_GC_CATEGORY (node)) {
-			const GSList *features;
-			const GSList *iter;
+		/* Content of a non implemented category */
+		if (entry->level > skip_level)
+			continue;
+		skip_level = G_MAXUINT;
 
-			features = arv_gc_category_get_features (ARV_GC_CATEGORY (node));
+		if (entry->level <= match_level)
+			match_level = G_MAXUINT;
 
-			for (iter = features; iter != NULL; iter = iter->next)
-				arv_tool_list_features (genicam, iter->data, list_mode, match ? NULL : regex, level + 1);
-                }
+		if (!entry->is_implemented) {
+			skip_level = entry->level;
+			continue;
+		}
+
+		/* A matching category is listed with its whole content */
+		if (match_level == G_MAXUINT &&
+		    regex != NULL && !g_regex_match (regex, entry->name, 0, NULL))
+			continue;
+
+		if (match_level == G_MAXUINT && entry->is_category)
+			match_level = entry->level;
+
+		arv_tool_show_feature (entry->node, list_mode, entry->level);
 	}
+
+	g_array_unref (index);
 }
 
 static void
@@ -499,6 +560,224 @@ arv_tool_show_persistent_ip (ArvGvDevice* gv_device, gboolean show_ip, gboolean
 }
 
 
+#define ARV_TOOL_NETWORK_MAX_LINK_USAGE		0.9
+#define ARV_TOOL_NETWORK_JUMBO_MTU		9000
+/* Duration of a line rate packet burst the receive ring must absorb */
+#define ARV_TOOL_NETWORK_RX_BURST_US		2000
+
+typedef struct {
+	guint64 bandwidth;
+	guint n_cameras;
+} ArvToolInterfaceLoad;
+
+/* Stream bandwidth of the cameras already checked, by interface name */
+static GHashTable *arv_tool_interface_loads = NULL;
+
+static void G_GNUC_PRINTF (2, 3)
+arv_tool_network_report (gboolean is_problem, const char *format, ...)
+{
+	va_list args;
+
+	va_start (args, format);
+	printf ("  [%s] ", is_problem ? "FAIL" : " OK ");
+	vprintf (format, args);
+	printf ("\n");
+	va_end (args);
+
+	if (is_problem)
+		arv_tool_exit_status = EXIT_FAILURE;
+}
+
+static void G_GNUC_PRINTF (1, 2)
+arv_tool_network_recommend (const char *format, ...)
+{
+	va_list args;
+
+	va_start (args, format);
+	printf ("         -> ");
+	vprintf (format, args);
+	printf ("\n");
+	va_end (args);
+}
+
+/* Checks the configuration of the host interface receiving the stream of a camera: link bandwidth, MTU, receive ring
+ * size, interrupt coalescing, reverse path filtering, maximum socket buffer size and NUMA placement */
+
+static void
+arv_tool_network_check (ArvGvDevice *gv_device)
+{
+	ArvDevice *device = ARV_DEVICE (gv_device);
+	ArvNetworkInterface *network_interface;
+	ArvToolInterfaceLoad *load;
+	GInetAddress *interface_address;
+	const char *name;
+	char *address_string;
+	gint64 payload;
+	gint64 packet_size;
+	gint64 rmem_max;
+	double frame_rate = 0.0;
+	double packet_rate = 0.0;
+	guint64 bandwidth = 0;
+	guint link_speed;
+	guint mtu;
+	guint ring_size = 0, ring_max_size;
+	guint coalesce_usecs, coalesce_frames;
+	gboolean adaptive_coalescing;
+	gboolean has_ring_size;
+	gint rp_filter;
+	gint numa_node;
+
+	interface_address = g_inet_socket_address_get_address
+		(G_INET_SOCKET_ADDRESS (arv_gv_device_get_interface_address (gv_device)));
+	address_string = g_inet_address_to_string (interface_address);
+	network_interface = arv_network_get_interface_by_address (address_string);
+	if (network_interface == NULL) {
+		arv_tool_network_report (TRUE, "No network interface found for address %s", address_string);
+		g_free (address_string);
+		return;
+	}
+
+	name = arv_network_interface_get_name (network_interface);
+	link_speed = arv_network_interface_get_link_speed (network_interface);
+	mtu = arv_network_interface_get_mtu (network_interface);
+
+	payload = arv_device_get_integer_feature_value (device, "PayloadSize", NULL);
+	packet_size = arv_device_get_integer_feature_value (device, "GevSCPSPacketSize", NULL);
+	if (arv_device_is_feature_available (device, "AcquisitionFrameRate", NULL))
+		frame_rate = arv_device_get_float_feature_value (device, "AcquisitionFrameRate", NULL);
+	else if (arv_device_is_feature_available (device, "AcquisitionFrameRateAbs", NULL))
+		frame_rate = arv_device_get_float_feature_value (device, "AcquisitionFrameRateAbs", NULL);
+	if (payload > 0 && frame_rate > 0.0)
+		bandwidth = payload * 8 * frame_rate;
+
+	/* Packet rate of a burst at the link speed */
+	if (link_speed > 0)
+		packet_rate = link_speed * 1e6 / 8.0 / MAX (packet_size > 0 ? packet_size : 1500, 576);
+
+	printf ("Interface %s (%s), link %u Mbit/s, MTU %u\n", name, address_string, link_speed, mtu);
+	printf ("Stream of %" G_GINT64_FORMAT " bytes at %.3g Hz, %.1f Mbit/s, packet size %" G_GINT64_FORMAT "\n",
+		payload, frame_rate, bandwidth / 1e6, packet_size);
+
+	/* Link bandwidth, shared with the cameras checked before on the same interface */
+	if (arv_tool_interface_loads == NULL)
+		arv_tool_interface_loads = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	load = g_hash_table_lookup (arv_tool_interface_loads, name);
+	if (load == NULL) {
+		load = g_new0 (ArvToolInterfaceLoad, 1);
+		g_hash_table_insert (arv_tool_interface_loads, g_strdup (name), load);
+	}
+	load->bandwidth += bandwidth;
+	load->n_cameras++;
+
+	if (link_speed > 0 && load->bandwidth > 0) {
+		double usage = load->bandwidth / (link_speed * 1e6);
+
+		if (usage > ARV_TOOL_NETWORK_MAX_LINK_USAGE) {
+			arv_tool_network_report (TRUE, "%u camera(s) need %.0f%% of the link bandwidth",
+						 load->n_cameras, 100.0 * usage);
+			arv_tool_network_recommend ("Reduce the frame rate or the region of interest, or use a faster "
+						    "link. Several cameras on a switch can share the link using "
+						    "ArvBandwidthPlanner");
+		} else
+			arv_tool_network_report (FALSE, "%u camera(s) need %.0f%% of the link bandwidth",
+						 load->n_cameras, 100.0 * usage);
+	}
+
+	/* MTU and packet size */
+	if (mtu > 0) {
+		if (packet_size > mtu) {
+			arv_tool_network_report (TRUE, "Packet size %" G_GINT64_FORMAT " larger than the MTU %u",
+						 packet_size, mtu);
+			arv_tool_network_recommend ("Set GevSCPSPacketSize to at most %u", mtu);
+		} else if (mtu < ARV_TOOL_NETWORK_JUMBO_MTU && (link_speed == 0 || link_speed >= 1000)) {
+			arv_tool_network_report (TRUE, "MTU %u, jumbo frames are disabled", mtu);
+			arv_tool_network_recommend ("ip link set dev %s mtu %d, and set GevSCPSPacketSize accordingly",
+						    name, ARV_TOOL_NETWORK_JUMBO_MTU);
+		} else if (packet_size > 0 && packet_size < mtu / 2) {
+			arv_tool_network_report (TRUE, "Packet size %" G_GINT64_FORMAT " much smaller than the MTU %u",
+						 packet_size, mtu);
+			arv_tool_network_recommend ("Set GevSCPSPacketSize close to %u, or use "
+						    "arv_camera_gv_auto_packet_size()", mtu);
+		} else
+			arv_tool_network_report (FALSE, "MTU %u, packet size %" G_GINT64_FORMAT, mtu, packet_size);
+	}
+
+	/* Receive ring */
+	has_ring_size = arv_network_interface_get_rx_ring_size (network_interface, &ring_size, &ring_max_size);
+	if (has_ring_size && packet_rate > 0.0) {
+		guint n_needed = MIN (ceil (packet_rate * ARV_TOOL_NETWORK_RX_BURST_US / 1e6), ring_max_size);
+
+		if (ring_size < n_needed) {
+			guint n_recommended = 1;
+
+			while (n_recommended < n_needed)
+				n_recommended *= 2;
+
+			arv_tool_network_report (TRUE, "RX ring of %u descriptors, %u needed for a %d µs burst at "
+						 "line rate", ring_size, n_needed, ARV_TOOL_NETWORK_RX_BURST_US);
+			arv_tool_network_recommend ("ethtool -G %s rx %u", name, MIN (n_recommended, ring_max_size));
+		} else
+			arv_tool_network_report (FALSE, "RX ring of %u descriptors (maximum %u)",
+						 ring_size, ring_max_size);
+	} else if (!has_ring_size)
+		printf ("  [ ?? ] RX ring size unknown\n");
+
+	/* Interrupt coalescing, the packets received before the interrupt must fit in the ring */
+	if (arv_network_interface_get_rx_coalescing (network_interface, &coalesce_usecs, &coalesce_frames,
+						     &adaptive_coalescing)) {
+		double n_coalesced = packet_rate * coalesce_usecs / 1e6;
+
+		if (has_ring_size && ring_size > 0 &&
+		    (n_coalesced > ring_size / 2 || coalesce_frames > ring_size / 2)) {
+			arv_tool_network_report (TRUE, "RX interrupt coalescing of %u µs / %u frames fills more "
+						 "than half of the RX ring", coalesce_usecs, coalesce_frames);
+			arv_tool_network_recommend ("ethtool -C %s rx-usecs %u rx-frames %u", name,
+						    packet_rate > 0.0 ?
+						    (guint) (ring_size / 4 / packet_rate * 1e6) : coalesce_usecs,
+						    ring_size / 4);
+		} else if (adaptive_coalescing) {
+			arv_tool_network_report (FALSE, "Adaptive RX interrupt coalescing");
+			arv_tool_network_recommend ("Adaptive coalescing may delay the first packets of a frame "
+						    "burst, ethtool -C %s adaptive-rx off disables it", name);
+		} else
+			arv_tool_network_report (FALSE, "RX interrupt coalescing of %u µs / %u frames",
+						 coalesce_usecs, coalesce_frames);
+	}
+
+	/* Reverse path filtering, which drops the packets of the cameras not routed back through the interface */
+	rp_filter = arv_network_interface_get_rp_filter (network_interface);
+	if (rp_filter == 1) {
+		arv_tool_network_report (TRUE, "Strict reverse path filtering");
+		arv_tool_network_recommend ("sysctl -w net.ipv4.conf.all.rp_filter=2 net.ipv4.conf.%s.rp_filter=2",
+					    name);
+	} else if (rp_filter >= 0)
+		arv_tool_network_report (FALSE, "Reverse path filtering mode %d", rp_filter);
+
+	/* In auto mode, the socket buffer is sized for a frame, and grown on kernel drops, within rmem_max */
+	rmem_max = arv_network_get_rmem_max ();
+	if (rmem_max >= 0 && payload > 0) {
+		if (rmem_max < payload) {
+			gint64 recommended = (2 * payload + 1024 * 1024 - 1) / (1024 * 1024) * 1024 * 1024;
+
+			arv_tool_network_report (TRUE, "net.core.rmem_max of %" G_GINT64_FORMAT
+						 " bytes, smaller than the payload", rmem_max);
+			arv_tool_network_recommend ("sysctl -w net.core.rmem_max=%" G_GINT64_FORMAT, recommended);
+		} else
+			arv_tool_network_report (FALSE, "net.core.rmem_max of %" G_GINT64_FORMAT " bytes", rmem_max);
+	}
+
+	/* The stream thread is best run on the node of the network adapter */
+	numa_node = arv_network_interface_get_numa_node (network_interface);
+	if (numa_node >= 0 && g_file_test ("/sys/devices/system/node/node1", G_FILE_TEST_EXISTS)) {
+		arv_tool_network_report (FALSE, "Network adapter on NUMA node %d", numa_node);
+		arv_tool_network_recommend ("Run the stream thread on node %d, using the numa-node property of the "
+					    "stream", numa_node);
+	}
+
+	arv_network_interface_free (network_interface);
+	g_free (address_string);
+}
+
 static void
 arv_tool_network (int argc, char **argv, ArvDevice *device)
 {
@@ -510,7 +789,9 @@ arv_tool_network (int argc, char **argv, ArvDevice *device)
         }
 
         gv_device = ARV_GV_DEVICE (device);
-        if (argv[2] == NULL) {
+        if (g_strcmp0 (argv[2], "check") == 0) {
+                arv_tool_network_check (gv_device);
+        } else if (argv[2] == NULL) {
                 GError *error = NULL;
 
                 arv_tool_show_network_mode (gv_device, &error);
@@ -579,6 +860,288 @@ arv_tool_network (int argc, char **argv, ArvDevice *device)
         }
 }
 
+static void
+arv_tool_stats (int argc, char **argv, ArvDevice *device)
+{
+	ArvStream *stream = NULL;
+	GError *error = NULL;
+	const char *camera_id;
+	char *serial_number;
+	char *metrics;
+	double duration = 0.0;
+
+	if (argc > 3) {
+		printf ("stats command takes at most one duration parameter\n");
+		return;
+	}
+
+	if (argc == 3) {
+		char *end;
+
+		duration = g_ascii_strtod (argv[2], &end);
+		if (*end != '\0' || duration < 0.0) {
+			printf ("Invalid duration '%s'\n", argv[2]);
+			return;
+		}
+	}
+
+	serial_number = g_strdup (arv_device_get_string_feature_value (device, "DeviceSerialNumber", NULL));
+	camera_id = serial_number != NULL ? serial_number : "";
+
+	if (duration > 0.0) {
+		gint64 payload;
+		int i;
+
+		stream = arv_device_create_stream (device, NULL, NULL, &error);
+		payload = arv_device_get_integer_feature_value (device, "PayloadSize", NULL);
+
+		if (ARV_IS_STREAM (stream) && payload > 0) {
+			for (i = 0; i < 50; i++)
+				arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+			arv_device_execute_command (device, "AcquisitionStart", &error);
+			if (error == NULL) {
+				g_usleep (duration * 1000000.0);
+				arv_device_execute_command (device, "AcquisitionStop", &error);
+			}
+		}
+
+		if (error != NULL) {
+			printf ("Acquisition error: %s\n", error->message);
+			g_clear_error (&error);
+		}
+	}
+
+	metrics = arv_dup_openmetrics (1, &camera_id, &device, stream != NULL ? &stream : NULL);
+	printf ("%s", metrics);
+	g_free (metrics);
+
+	g_clear_object (&stream);
+	g_free (serial_number);
+}
+
+typedef struct {
+	const char *name;
+	guint64 n_hits;
+	guint64 n_misses;
+	guint64 n_errors;
+} ArvToolCacheStatistics;
+
+static void
+arv_tool_collect_cache_statistics (ArvGc *genicam, const char *feature, GHashTable *visited, GArray *statistics)
+{
+	ArvGcNode *node;
+
+	node = arv_gc_get_node (genicam, feature);
+	if (!ARV_IS_GC_FEATURE_NODE (node) || !g_hash_table_add (visited, node))
+		return;
+
+	if (ARV_IS_GC_CATEGORY (node)) {
+		const GSList *iter;
+
+		for (iter = arv_gc_category_get_features (ARV_GC_CATEGORY (node)); iter != NULL; iter = iter->next)
+			arv_tool_collect_cache_statistics (genicam, iter->data, visited, statistics);
+	} else {
+		ArvToolCacheStatistics entry = { .name = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (node)) };
+
+		if (arv_gc_get_cache_statistics (genicam, feature, &entry.n_hits, &entry.n_misses, &entry.n_errors) &&
+		    entry.n_hits + entry.n_misses > 0)
+			g_array_append_val (statistics, entry);
+	}
+}
+
+static int
+arv_tool_compare_cache_statistics (gconstpointer a, gconstpointer b)
+{
+	const ArvToolCacheStatistics *sa = a;
+	const ArvToolCacheStatistics *sb = b;
+
+	if (sa->n_misses != sb->n_misses)
+		return sa->n_misses < sb->n_misses ? 1 : -1;
+
+	return g_strcmp0 (sa->name, sb->name);
+}
+
+/* Lists the features with register accesses, the ones causing the most device reads first */
+
+static void
+arv_tool_show_cache_statistics (ArvGc *genicam)
+{
+	GHashTable *visited;
+	GArray *statistics;
+	guint64 n_hits, n_misses, n_errors;
+	guint i;
+
+	visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+	statistics = g_array_new (FALSE, FALSE, sizeof (ArvToolCacheStatistics));
+
+	arv_tool_collect_cache_statistics (genicam, "Root", visited, statistics);
+	g_array_sort (statistics, arv_tool_compare_cache_statistics);
+
+	printf ("%-40s %10s %10s %10s\n", "Feature", "Misses", "Hits", "Errors");
+	for (i = 0; i < statistics->len; i++) {
+		ArvToolCacheStatistics *entry = &g_array_index (statistics, ArvToolCacheStatistics, i);
+
+		printf ("%-40s %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT "\n",
+			entry->name, entry->n_misses, entry->n_hits, entry->n_errors);
+	}
+
+	arv_gc_get_cache_statistics (genicam, NULL, &n_hits, &n_misses, &n_errors);
+	printf ("%-40s %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT "\n",
+		"Total", n_misses, n_hits, n_errors);
+
+	g_array_unref (statistics);
+	g_hash_table_unref (visited);
+}
+
+typedef struct {
+	char *script;
+	ArvRegisterCachePolicy register_cache_policy;
+	ArvRangeCheckPolicy range_check_policy;
+	ArvAccessCheckPolicy access_check_policy;
+} ArvToolBatch;
+
+typedef struct {
+	const ArvToolBatch *batch;
+	const char *device_id;
+	double open_time_s;
+	double write_time_s;
+	char *error_message;
+} ArvToolBatchJob;
+
+/* Feature assignments of the batch command, from a script file or from the command line */
+
+static char *
+arv_tool_batch_load_script (int argc, char **argv, GError **error)
+{
+	GString *script;
+	char *contents;
+	char **lines;
+	int i;
+
+	if (argc != 3 || !g_file_test (argv[2], G_FILE_TEST_IS_REGULAR))
+		return g_strjoinv (" ", &argv[2]);
+
+	if (!g_file_get_contents (argv[2], &contents, NULL, error))
+		return NULL;
+
+	script = g_string_new ("");
+	lines = g_strsplit (contents, "\n", -1);
+	for (i = 0; lines[i] != NULL; i++) {
+		char *comment = strchr (lines[i], '#');
+
+		if (comment != NULL)
+			*comment = '\0';
+		g_string_append_printf (script, "%s ", g_strstrip (lines[i]));
+	}
+	g_strfreev (lines);
+	g_free (contents);
+
+	return g_string_free (script, FALSE);
+}
+
+static void
+arv_tool_batch_job (gpointer data, gpointer user_data)
+{
+	ArvToolBatchJob *job = data;
+	ArvDevice *device;
+	GError *error = NULL;
+	gint64 start;
+
+	start = g_get_monotonic_time ();
+	device = arv_open_device (job->device_id, &error);
+	job->open_time_s = (g_get_monotonic_time () - start) / 1000000.0;
+
+	if (ARV_IS_DEVICE (device)) {
+		arv_device_set_register_cache_policy (device, job->batch->register_cache_policy);
+		arv_device_set_range_check_policy (device, job->batch->range_check_policy);
+		arv_device_set_access_check_policy (device, job->batch->access_check_policy);
+
+		start = g_get_monotonic_time ();
+		arv_device_set_features_from_string_full (device, job->batch->script,
+							  ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY |
+							  ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION,
+							  &error);
+		job->write_time_s = (g_get_monotonic_time () - start) / 1000000.0;
+
+		g_object_unref (device);
+	}
+
+	if (error != NULL) {
+		job->error_message = g_strdup (error->message);
+		g_clear_error (&error);
+	} else if (device == NULL)
+		job->error_message = g_strdup ("Device not found");
+}
+
+/* Writes the features of the script on all the devices, at most arv_option_n_jobs at once, and prints the results in
+ * JSON format, in the device order */
+
+static void
+arv_tool_batch (int argc, char **argv, GPtrArray *device_ids,
+		ArvRegisterCachePolicy register_cache_policy,
+		ArvRangeCheckPolicy range_check_policy,
+		ArvAccessCheckPolicy access_check_policy)
+{
+	ArvToolBatch batch;
+	ArvToolBatchJob *jobs;
+	GThreadPool *pool;
+	GError *error = NULL;
+	gint64 start;
+	guint i;
+
+	batch.script = arv_tool_batch_load_script (argc, argv, &error);
+	if (batch.script == NULL) {
+		printf ("Failed to load batch script: %s\n", error->message);
+		g_clear_error (&error);
+		return;
+	}
+	batch.register_cache_policy = register_cache_policy;
+	batch.range_check_policy = range_check_policy;
+	batch.access_check_policy = access_check_policy;
+
+	jobs = g_new0 (ArvToolBatchJob, device_ids->len);
+
+	start = g_get_monotonic_time ();
+
+	pool = g_thread_pool_new (arv_tool_batch_job, NULL, MAX (arv_option_n_jobs, 1), TRUE, NULL);
+	for (i = 0; i < device_ids->len; i++) {
+		jobs[i].batch = &batch;
+		jobs[i].device_id = g_ptr_array_index (device_ids, i);
+		g_thread_pool_push (pool, &jobs[i], NULL);
+	}
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	printf ("[\n");
+	for (i = 0; i < device_ids->len; i++) {
+		char *device_id = g_strescape (jobs[i].device_id, NULL);
+
+		printf ("  {\"device\": \"%s\", ", device_id);
+		g_free (device_id);
+
+		if (jobs[i].error_message != NULL) {
+			char *message = g_strescape (jobs[i].error_message, NULL);
+
+			printf ("\"error\": \"%s\", ", message);
+			g_free (message);
+		}
+
+		printf ("\"success\": %s, \"open_time_s\": %.6f, \"write_time_s\": %.6f}%s\n",
+			jobs[i].error_message == NULL ? "true" : "false",
+			jobs[i].open_time_s, jobs[i].write_time_s,
+			i + 1 < device_ids->len ? "," : "");
+
+		g_free (jobs[i].error_message);
+	}
+	printf ("]\n");
+
+	if (arv_option_show_time)
+		printf ("Executed in %g s\n", (g_get_monotonic_time () - start) / 1000000.0);
+
+	g_free (jobs);
+	g_free (batch.script);
+}
+
 static void
 arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 			  ArvRegisterCachePolicy register_cache_policy,
@@ -598,6 +1161,26 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 
 	genicam = arv_device_get_genicam (device);
 
+	if (arv_option_uncached != NULL) {
+		char **features = g_strsplit (arv_option_uncached, ",", -1);
+		int i;
+
+		for (i = 0; features[i] != NULL; i++) {
+			GError *error = NULL;
+
+			if (!arv_gc_set_feature_register_cache_policy (genicam, g_strstrip (features[i]),
+								       ARV_REGISTER_CACHE_POLICY_DISABLE, &error)) {
+				printf ("%s\n", error->message);
+				g_clear_error (&error);
+			}
+		}
+
+		g_strfreev (features);
+	}
+
+	if (arv_option_show_profile)
+		arv_gc_set_profiling_enable (genicam, TRUE);
+
 	start = g_get_monotonic_time ();
 
 	if (g_strcmp0 (command, "genicam") == 0) {
@@ -614,7 +1197,7 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
                         GRegex *regex;
 
                         regex = arv_regex_new_from_glob_pattern (argc == 3 ? argv[2] : "*", TRUE);
-                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_FEATURES,  regex, 0);
+                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_FEATURES,  regex);
                         g_regex_unref (regex);
                 }
 	} else if (g_strcmp0 (command, "values") == 0) {
@@ -623,8 +1206,15 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
                 else {
                         GRegex *regex;
 
+                        /* Values are only read once, the register cache can safely be used for a bulk read */
+                        if (arv_option_register_cache == NULL)
+                                arv_device_set_register_cache_policy (device, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+                        /* Read errors are reported for each feature by the listing */
+                        arv_gc_read_all (genicam, argc == 3 ? argv[2] : NULL, NULL);
+
                         regex = arv_regex_new_from_glob_pattern (argc == 3 ? argv[2] : "*", TRUE);
-                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_VALUES, regex, 0);
+                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_VALUES, regex);
                         g_regex_unref (regex);
                 }
         } else if (g_strcmp0 (command, "description") == 0) {
@@ -634,19 +1224,33 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
                         GRegex *regex;
 
                         regex = arv_regex_new_from_glob_pattern (argc == 3 ? argv[2] : "*", TRUE);
-                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_DESCRIPTIONS, regex, 0);
+                        arv_tool_list_features (genicam, "Root", ARV_TOOL_LIST_MODE_DESCRIPTIONS, regex);
                         g_regex_unref (regex);
                 }
 	} else if (g_strcmp0 (command, "control") == 0) {
                 arv_tool_control (argc, argv, device);
         } else if (g_strcmp0 (command, "network") == 0) {
                 arv_tool_network (argc, argv, device);
+	} else if (g_strcmp0 (command, "stats") == 0) {
+		arv_tool_stats (argc, argv, device);
 	} else {
 		printf ("Unknown command\n");
 	}
 
 	if (arv_option_show_time)
 		printf ("Executed in %g s\n", (g_get_monotonic_time () - start) / 1000000.0);
+
+	if (arv_option_show_cache_statistics)
+		arv_tool_show_cache_statistics (genicam);
+
+	if (arv_option_show_profile) {
+		char *report;
+
+		arv_gc_set_profiling_enable (genicam, FALSE);
+		report = arv_gc_dup_profile_report (genicam);
+		printf ("%s", report);
+		g_free (report);
+	}
 }
 
 int
@@ -664,6 +1268,8 @@ main (int argc, char **argv)
         unsigned int n_found_devices = 0;
 	unsigned int i;
         gboolean is_glob_pattern = FALSE;
+        gboolean is_batch;
+        GPtrArray *batch_device_ids;
 
 	context = g_option_context_new (" command <parameters>");
 	g_option_context_set_summary (context, "Small utility for basic control of a Genicam device.");
@@ -695,6 +1301,8 @@ main (int argc, char **argv)
 		register_cache_policy = ARV_REGISTER_CACHE_POLICY_ENABLE;
 	else if (g_strcmp0 (arv_option_register_cache, "debug") == 0)
 		register_cache_policy = ARV_REGISTER_CACHE_POLICY_DEBUG;
+	else if (g_strcmp0 (arv_option_register_cache, "static") == 0)
+		register_cache_policy = ARV_REGISTER_CACHE_POLICY_STATIC;
 	else {
 		printf ("Invalid register cache policy\n");
 		return EXIT_FAILURE;
@@ -732,6 +1340,13 @@ main (int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
+        is_batch = argc >= 2 && g_strcmp0 (argv[1], "batch") == 0;
+        if (is_batch && argc < 3) {
+                printf ("batch command needs a script or a list of features\n");
+                return EXIT_FAILURE;
+        }
+        batch_device_ids = g_ptr_array_new_with_free_func (g_free);
+
         for (i = 0; arv_option_device_selection != NULL && arv_option_device_selection[i] != '\0'; i++)
                 if (arv_option_device_selection[i] == '*' ||
                     arv_option_device_selection[i] == '?' ||
@@ -741,6 +1356,17 @@ main (int argc, char **argv)
 	device_id = arv_option_device_address != NULL ?
                 arv_option_device_address :
                 (is_glob_pattern ? NULL : arv_option_device_selection);
+	if (device_id != NULL && is_batch) {
+                g_ptr_array_add (batch_device_ids, g_strdup (device_id));
+                arv_tool_batch (argc, argv, batch_device_ids,
+                                register_cache_policy, range_check_policy, access_check_policy);
+                g_ptr_array_unref (batch_device_ids);
+
+                arv_shutdown ();
+
+                return EXIT_SUCCESS;
+        }
+
 	if (device_id != NULL) {
 		GError *error = NULL;
 
@@ -764,9 +1390,12 @@ main (int argc, char **argv)
                         }
                 }
 
+                g_ptr_array_unref (batch_device_ids);
+                g_clear_pointer (&arv_tool_interface_loads, g_hash_table_unref);
+
                 arv_shutdown ();
 
-                return EXIT_SUCCESS;
+                return arv_tool_exit_status;
         }
 
         arv_update_device_list ();
@@ -784,6 +1413,12 @@ main (int argc, char **argv)
                         if (g_regex_match (regex, device_id, 0, NULL)) {
                                 n_found_devices++;
 
+                                /* The batch results are printed once all the devices are configured */
+                                if (is_batch) {
+                                        g_ptr_array_add (batch_device_ids, g_strdup (device_id));
+                                        continue;
+                                }
+
                                 printf ("%s (%s)\n", device_id, arv_get_device_address (i));
 
                                 if (argc >= 2) {
@@ -814,9 +1449,15 @@ main (int argc, char **argv)
                         fprintf (stderr, "No device found\n");
         }
 
+        if (batch_device_ids->len > 0)
+                arv_tool_batch (argc, argv, batch_device_ids,
+                                register_cache_policy, range_check_policy, access_check_policy);
+
+        g_ptr_array_unref (batch_device_ids);
         g_regex_unref (regex);
+        g_clear_pointer (&arv_tool_interface_loads, g_hash_table_unref);
 
 	arv_shutdown ();
 
-	return EXIT_SUCCESS;
+	return arv_tool_exit_status;
 }
@@ -0,0 +1,58 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+
+#ifndef ARV_TRACE_PRIVATE_H
+#define ARV_TRACE_PRIVATE_H
+
+#include <arvfeatures.h>
+
+/*
+ * Static tracepoints of the acquisition pipeline, in the "aravis" provider, SystemTap SDT compatible. When aravis is built
+ * with USDT support, they compile to a single nop, and can be enabled at runtime by perf, bpftrace or SystemTap, e.g.:
+ *
+ *	bpftrace -e 'usdt:/usr/lib64/libaravis-0.8.so:aravis:gv_frame_done { @[arg1] = count (); }'
+ *
+ * Time arguments are monotonic times in µs (g_get_monotonic_time()), which are CLOCK_MONOTONIC based, as the kernel
+ * trace timestamps.
+ *
+ * gv_frame_start (frame_id, time_us)
+ * gv_frame_done (frame_id, status, first_packet_time_us, time_us)
+ * gv_packet_resend_request (frame_id, first_packet_id, last_packet_id, time_us)
+ * gv_resent_packet (frame_id, packet_id)
+ * gvcp_command (command, packet_id, time_us)
+ * gvcp_ack (command, packet_id, packet_type, time_us)
+ * uv_transfer_submit (transfer, length)
+ * uv_transfer_complete (transfer, status, actual_length)
+ * stream_push_buffer (buffer)
+ * stream_push_output_buffer (buffer, frame_id, status)
+ * stream_pop_buffer (buffer, frame_id, status)
+ */
+
+#if ARAVIS_HAS_USDT
+#include <sys/sdt.h>
+#define ARV_TRACEPOINT(...)	STAP_PROBEV (aravis, __VA_ARGS__)
+#else
+#define ARV_TRACEPOINT(...)	G_STMT_START { } G_STMT_END
+#endif
+
+#endif
@@ -0,0 +1,560 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/**
+ * ArvUvBandwidthPlanner:
+ *
+ * [class@ArvUvBandwidthPlanner] shares the bandwidth of the USB host controllers and hubs between a set of USB3
+ * Vision cameras.
+ *
+ * The cameras are grouped by USB topology: all the cameras on a bus share the bandwidth of the root hub of the
+ * host controller, and the cameras connected behind the same hub share the bandwidth of the hub upstream link. For
+ * each camera, the planner reads the payload size and the frame rate, and computes the bandwidth needed by its
+ * stream. The budget of each link is then shared between the cameras using it, in proportion of their needs, and the
+ * throughput limit of each camera (the DeviceLinkThroughputLimit feature) is set to the smallest of its shares. The
+ * cameras then can't send their frames in bursts starving the other cameras on the same controller.
+ *
+ * The bandwidth of a link is estimated from the negotiated speed of the fastest camera using it.
+ *
+ * Once [method@ArvUvBandwidthPlanner.apply] was called, the plan is computed and applied again each time the
+ * payload size or the frame rate of one of the cameras is changed through aravis, see
+ * [signal@ArvGc::feature-changed].
+ *
+ * Since: 0.8.24
+ */
+
+#include <arvuvbandwidthplanner.h>
+#include <arvuvdeviceprivate.h>
+#include <arvdebugprivate.h>
+#include <arvgc.h>
+
+#define ARV_UV_BANDWIDTH_PLANNER_MAX_LINK_USAGE_DEFAULT	0.9
+
+/* Features triggering a new plan when they change */
+static const char *arv_uv_bandwidth_planner_watched_features[] = {
+	"PayloadSize",
+	"AcquisitionFrameRate",
+	"AcquisitionFrameRateAbs"
+};
+
+#define ARV_UV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES G_N_ELEMENTS (arv_uv_bandwidth_planner_watched_features)
+
+typedef struct {
+	ArvCamera *camera;
+	ArvGc *genicam;
+	gulong changed_handler;
+	gboolean is_watched[ARV_UV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES];
+
+	/* Links used by the camera stream, from the root hub to the camera port */
+	char *link_names[ARV_UV_DEVICE_MAX_PORT_DEPTH + 1];
+	guint n_links;
+	guint64 link_bandwidth;
+
+	guint64 required_bandwidth;
+	guint64 bandwidth;
+} ArvUvBandwidthPlannerCamera;
+
+typedef struct {
+	const char *name;
+	guint64 bandwidth;
+	guint64 required_bandwidth;
+	guint n_cameras;
+	gboolean is_oversubscribed;
+} ArvUvBandwidthPlannerLink;
+
+typedef struct {
+	GPtrArray *cameras;
+
+	double max_link_usage;
+
+	gboolean is_applied;
+	gboolean is_applying;
+} ArvUvBandwidthPlannerPrivate;
+
+struct _ArvUvBandwidthPlanner {
+	GObject	object;
+
+	ArvUvBandwidthPlannerPrivate *priv;
+};
+
+struct _ArvUvBandwidthPlannerClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvUvBandwidthPlanner, arv_uv_bandwidth_planner, G_TYPE_OBJECT,
+			 G_ADD_PRIVATE (ArvUvBandwidthPlanner))
+
+static void
+_camera_free (gpointer data)
+{
+	ArvUvBandwidthPlannerCamera *entry = data;
+	guint i;
+
+	g_signal_handler_disconnect (entry->genicam, entry->changed_handler);
+	for (i = 0; i < ARV_UV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES; i++)
+		if (entry->is_watched[i])
+			arv_gc_unwatch_feature (entry->genicam, arv_uv_bandwidth_planner_watched_features[i], NULL);
+
+	for (i = 0; i < entry->n_links; i++)
+		g_free (entry->link_names[i]);
+
+	g_object_unref (entry->camera);
+	g_free (entry);
+}
+
+static ArvUvBandwidthPlannerCamera *
+_find_camera (ArvUvBandwidthPlanner *planner, ArvCamera *camera, guint *index)
+{
+	guint i;
+
+	for (i = 0; i < planner->priv->cameras->len; i++) {
+		ArvUvBandwidthPlannerCamera *entry = g_ptr_array_index (planner->priv->cameras, i);
+
+		if (entry->camera == camera) {
+			if (index != NULL)
+				*index = i;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Approximative usable bandwidth of a link, in bits per second */
+
+static guint64
+_get_link_bandwidth (int speed)
+{
+	switch (speed) {
+		case LIBUSB_SPEED_HIGH:
+			return 320 * 1000 * 1000ULL;
+		case LIBUSB_SPEED_SUPER:
+			return 3200 * 1000 * 1000ULL;
+#if LIBUSB_API_VERSION >= 0x01000106
+		case LIBUSB_SPEED_SUPER_PLUS:
+			return 8000 * 1000 * 1000ULL;
+#endif
+		default:
+			return 0;
+	}
+}
+
+static void
+_feature_changed_cb (ArvGc *genicam, const char *feature, ArvUvBandwidthPlanner *planner)
+{
+	GError *error = NULL;
+
+	if (!planner->priv->is_applied || planner->priv->is_applying)
+		return;
+
+	arv_info_device ("[UvBandwidthPlanner::feature_changed] %s changed, update the plan", feature);
+
+	if (!arv_uv_bandwidth_planner_apply (planner, &error)) {
+		arv_warning_device ("[UvBandwidthPlanner::feature_changed] Failed to update the plan: %s",
+				    error->message);
+		g_clear_error (&error);
+	}
+}
+
+/**
+ * arv_uv_bandwidth_planner_new:
+ *
+ * Creates a planner for a set of USB3 Vision cameras. By default, at most 90% of the bandwidth of each link is used
+ * by the streams.
+ *
+ * Returns: (transfer full): a new #ArvUvBandwidthPlanner
+ *
+ * Since: 0.8.24
+ */
+
+ArvUvBandwidthPlanner *
+arv_uv_bandwidth_planner_new (void)
+{
+	return g_object_new (ARV_TYPE_UV_BANDWIDTH_PLANNER, NULL);
+}
+
+/**
+ * arv_uv_bandwidth_planner_set_max_link_usage:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @max_link_usage: maximum fraction of the link bandwidth used by the streams, in the ]0,1] range
+ *
+ * Sets the part of the bandwidth of each link the streams are allowed to use. The remaining part is left for the
+ * control traffic and the other devices.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_uv_bandwidth_planner_set_max_link_usage (ArvUvBandwidthPlanner *planner, double max_link_usage)
+{
+	g_return_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner));
+	g_return_if_fail (max_link_usage > 0.0 && max_link_usage <= 1.0);
+
+	planner->priv->max_link_usage = max_link_usage;
+}
+
+/**
+ * arv_uv_bandwidth_planner_add_camera:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @camera: an opened USB3 Vision #ArvCamera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Adds @camera to the set of planned cameras. Its position in the USB topology is read immediately, but the plan is
+ * not applied before the next call to arv_uv_bandwidth_planner_apply().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_uv_bandwidth_planner_add_camera (ArvUvBandwidthPlanner *planner, ArvCamera *camera, GError **error)
+{
+	ArvUvBandwidthPlannerCamera *entry;
+	ArvUvDevice *uv_device;
+	GString *name;
+	guint8 port_numbers[ARV_UV_DEVICE_MAX_PORT_DEPTH];
+	guint8 bus_number = 0;
+	guint64 link_bandwidth;
+	int n_ports;
+	int i;
+
+	g_return_val_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner), FALSE);
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+
+	if (!arv_camera_is_uv_device (camera)) {
+		g_set_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED,
+			     "USB bandwidth planning is only available for USB3 Vision cameras");
+		return FALSE;
+	}
+
+	if (_find_camera (planner, camera, NULL) != NULL)
+		return TRUE;
+
+	uv_device = ARV_UV_DEVICE (arv_camera_get_device (camera));
+
+	link_bandwidth = _get_link_bandwidth (arv_uv_device_get_speed (uv_device));
+	n_ports = arv_uv_device_get_topology (uv_device, &bus_number, port_numbers, ARV_UV_DEVICE_MAX_PORT_DEPTH);
+	if (link_bandwidth == 0 || n_ports < 1) {
+		g_set_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED,
+			     "Unknown USB link speed or topology");
+		return FALSE;
+	}
+
+	entry = g_new0 (ArvUvBandwidthPlannerCamera, 1);
+	entry->camera = g_object_ref (camera);
+	entry->link_bandwidth = link_bandwidth;
+
+	/* Link names follow the sysfs device naming, for example usb2, 2-1, 2-1.3 */
+	entry->link_names[0] = g_strdup_printf ("usb%u", bus_number);
+	name = g_string_new (NULL);
+	g_string_printf (name, "%u-%u", bus_number, port_numbers[0]);
+	entry->link_names[1] = g_strdup (name->str);
+	for (i = 1; i < n_ports; i++) {
+		g_string_append_printf (name, ".%u", port_numbers[i]);
+		entry->link_names[i + 1] = g_strdup (name->str);
+	}
+	g_string_free (name, TRUE);
+	entry->n_links = n_ports + 1;
+
+	arv_info_device ("[UvBandwidthPlanner::add_camera] %s on %s, %" G_GUINT64_FORMAT " bit/s link",
+			 arv_camera_get_device_id (camera, NULL), entry->link_names[entry->n_links - 1],
+			 link_bandwidth);
+
+	entry->genicam = arv_device_get_genicam (ARV_DEVICE (uv_device));
+	entry->changed_handler = g_signal_connect (entry->genicam, "feature-changed",
+						   G_CALLBACK (_feature_changed_cb), planner);
+
+	for (i = 0; i < (int) ARV_UV_BANDWIDTH_PLANNER_N_WATCHED_FEATURES; i++)
+		entry->is_watched[i] = arv_gc_watch_feature (entry->genicam,
+							     arv_uv_bandwidth_planner_watched_features[i], NULL);
+
+	g_ptr_array_add (planner->priv->cameras, entry);
+
+	return TRUE;
+}
+
+/**
+ * arv_uv_bandwidth_planner_remove_camera:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @camera: a #ArvCamera
+ *
+ * Removes @camera from the set of planned cameras. Its throughput limit is left unchanged.
+ *
+ * Since: 0.8.24
+ */
+
+void
+arv_uv_bandwidth_planner_remove_camera (ArvUvBandwidthPlanner *planner, ArvCamera *camera)
+{
+	guint index;
+
+	g_return_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner));
+
+	if (_find_camera (planner, camera, &index) != NULL)
+		g_ptr_array_remove_index (planner->priv->cameras, index);
+}
+
+/* Bandwidth needed by the stream of a camera, in bits per second */
+
+static gboolean
+_measure_camera (ArvUvBandwidthPlannerCamera *entry, GError **error)
+{
+	GError *local_error = NULL;
+	guint64 payload;
+	double frame_rate = 0.0;
+
+	payload = arv_camera_get_payload (entry->camera, &local_error);
+	if (local_error == NULL)
+		frame_rate = arv_camera_get_frame_rate (entry->camera, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	entry->required_bandwidth = (guint64) (payload * 8 * MAX (frame_rate, 0.0));
+
+	return TRUE;
+}
+
+/**
+ * arv_uv_bandwidth_planner_apply:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Computes the share of the bandwidth of each camera, and sets their throughput limit accordingly. The cameras
+ * without throughput limit control are taken into account, but not configured. If the cameras sharing a host
+ * controller or a hub need more than its budget, a warning is emitted for each oversubscribed link, no setting is
+ * changed and an #ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED error is returned.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.24
+ */
+
+gboolean
+arv_uv_bandwidth_planner_apply (ArvUvBandwidthPlanner *planner, GError **error)
+{
+	ArvUvBandwidthPlannerPrivate *priv;
+	ArvUvBandwidthPlannerLink *oversubscribed = NULL;
+	GHashTable *links;
+	GError *local_error = NULL;
+	guint i, j;
+
+	g_return_val_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner), FALSE);
+
+	priv = planner->priv;
+
+	links = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+	for (i = 0; i < priv->cameras->len; i++) {
+		ArvUvBandwidthPlannerCamera *entry = g_ptr_array_index (priv->cameras, i);
+
+		if (!_measure_camera (entry, error)) {
+			g_hash_table_unref (links);
+			return FALSE;
+		}
+
+		for (j = 0; j < entry->n_links; j++) {
+			ArvUvBandwidthPlannerLink *link = g_hash_table_lookup (links, entry->link_names[j]);
+
+			if (link == NULL) {
+				link = g_new0 (ArvUvBandwidthPlannerLink, 1);
+				link->name = entry->link_names[j];
+				g_hash_table_insert (links, (char *) link->name, link);
+			}
+
+			link->bandwidth = MAX (link->bandwidth, entry->link_bandwidth);
+			link->required_bandwidth += entry->required_bandwidth;
+			link->n_cameras++;
+		}
+	}
+
+	priv->is_applied = TRUE;
+
+	/* Walk the links in the camera order, for a stable report */
+	for (i = 0; i < priv->cameras->len; i++) {
+		ArvUvBandwidthPlannerCamera *entry = g_ptr_array_index (priv->cameras, i);
+
+		for (j = 0; j < entry->n_links; j++) {
+			ArvUvBandwidthPlannerLink *link = g_hash_table_lookup (links, entry->link_names[j]);
+			double budget = (double) link->bandwidth * priv->max_link_usage;
+
+			if (link->is_oversubscribed || link->required_bandwidth <= budget)
+				continue;
+
+			arv_warning_device ("[UvBandwidthPlanner::apply] %s is oversubscribed: %u camera(s) need %"
+					    G_GUINT64_FORMAT " bit/s, for a budget of %.0f bit/s",
+					    link->name, link->n_cameras, link->required_bandwidth, budget);
+
+			link->is_oversubscribed = TRUE;
+			if (oversubscribed == NULL)
+				oversubscribed = link;
+		}
+	}
+
+	if (oversubscribed != NULL) {
+		g_set_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED,
+			     "The %u camera(s) on %s need %" G_GUINT64_FORMAT " bit/s, for a budget of %.0f bit/s",
+			     oversubscribed->n_cameras, oversubscribed->name, oversubscribed->required_bandwidth,
+			     (double) oversubscribed->bandwidth * priv->max_link_usage);
+		g_hash_table_unref (links);
+		return FALSE;
+	}
+
+	priv->is_applying = TRUE;
+
+	for (i = 0; i < priv->cameras->len; i++) {
+		ArvUvBandwidthPlannerCamera *entry = g_ptr_array_index (priv->cameras, i);
+		double share = G_MAXDOUBLE;
+		guint min, max;
+		guint bandwidth;
+
+		if (entry->required_bandwidth == 0) {
+			entry->bandwidth = 0;
+			continue;
+		}
+
+		/* Each share is at least the need, as no link is oversubscribed */
+		for (j = 0; j < entry->n_links; j++) {
+			ArvUvBandwidthPlannerLink *link = g_hash_table_lookup (links, entry->link_names[j]);
+
+			share = MIN (share, (double) link->bandwidth * priv->max_link_usage *
+				     entry->required_bandwidth / link->required_bandwidth);
+		}
+		entry->bandwidth = share;
+
+		arv_info_device ("[UvBandwidthPlanner::apply] %s: %" G_GUINT64_FORMAT " bit/s needed, limit %"
+				 G_GUINT64_FORMAT " bit/s", arv_camera_get_device_id (entry->camera, NULL),
+				 entry->required_bandwidth, entry->bandwidth);
+
+		if (!arv_camera_uv_is_bandwidth_control_available (entry->camera, NULL)) {
+			arv_info_device ("[UvBandwidthPlanner::apply] No throughput limit control");
+			continue;
+		}
+
+		/* arv_camera_uv_set_bandwidth() takes megabits per second */
+		bandwidth = MIN (entry->bandwidth / 1000000, G_MAXUINT);
+		arv_camera_uv_get_bandwidth_bounds (entry->camera, &min, &max, NULL);
+		if (max > min)
+			bandwidth = CLAMP (bandwidth, min, max);
+
+		arv_camera_uv_set_bandwidth (entry->camera, MAX (bandwidth, 1), &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			priv->is_applying = FALSE;
+			g_hash_table_unref (links);
+			return FALSE;
+		}
+	}
+
+	priv->is_applying = FALSE;
+
+	g_hash_table_unref (links);
+
+	return TRUE;
+}
+
+/**
+ * arv_uv_bandwidth_planner_get_required_bandwidth:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @camera: a #ArvCamera
+ *
+ * Returns: the bandwidth needed by the stream of @camera at the last arv_uv_bandwidth_planner_apply() call, in
+ * bits per second, 0 if @camera is not planned by @planner.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_uv_bandwidth_planner_get_required_bandwidth (ArvUvBandwidthPlanner *planner, ArvCamera *camera)
+{
+	ArvUvBandwidthPlannerCamera *entry;
+
+	g_return_val_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner), 0);
+
+	entry = _find_camera (planner, camera, NULL);
+
+	return entry != NULL ? entry->required_bandwidth : 0;
+}
+
+/**
+ * arv_uv_bandwidth_planner_get_bandwidth:
+ * @planner: a #ArvUvBandwidthPlanner
+ * @camera: a #ArvCamera
+ *
+ * Returns: the throughput limit planned for @camera by the last successful arv_uv_bandwidth_planner_apply() call,
+ * in bits per second, 0 if @camera is not planned by @planner.
+ *
+ * Since: 0.8.24
+ */
+
+guint64
+arv_uv_bandwidth_planner_get_bandwidth (ArvUvBandwidthPlanner *planner, ArvCamera *camera)
+{
+	ArvUvBandwidthPlannerCamera *entry;
+
+	g_return_val_if_fail (ARV_IS_UV_BANDWIDTH_PLANNER (planner), 0);
+
+	entry = _find_camera (planner, camera, NULL);
+
+	return entry != NULL ? entry->bandwidth : 0;
+}
+
+static void
+arv_uv_bandwidth_planner_init (ArvUvBandwidthPlanner *planner)
+{
+	planner->priv = arv_uv_bandwidth_planner_get_instance_private (planner);
+
+	planner->priv->cameras = g_ptr_array_new_with_free_func (_camera_free);
+	planner->priv->max_link_usage = ARV_UV_BANDWIDTH_PLANNER_MAX_LINK_USAGE_DEFAULT;
+}
+
+static void
+_dispose (GObject *object)
+{
+	ArvUvBandwidthPlanner *planner = ARV_UV_BANDWIDTH_PLANNER (object);
+
+	if (planner->priv->cameras != NULL)
+		g_ptr_array_set_size (planner->priv->cameras, 0);
+
+	G_OBJECT_CLASS (arv_uv_bandwidth_planner_parent_class)->dispose (object);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvUvBandwidthPlanner *planner = ARV_UV_BANDWIDTH_PLANNER (object);
+
+	g_clear_pointer (&planner->priv->cameras, g_ptr_array_unref);
+
+	G_OBJECT_CLASS (arv_uv_bandwidth_planner_parent_class)->finalize (object);
+}
+
+static void
+arv_uv_bandwidth_planner_class_init (ArvUvBandwidthPlannerClass *planner_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (planner_class);
+
+	object_class->dispose = _dispose;
+	object_class->finalize = _finalize;
+}
@@ -0,0 +1,60 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_UV_BANDWIDTH_PLANNER_H
+#define ARV_UV_BANDWIDTH_PLANNER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvapi.h>
+#include <arvtypes.h>
+#include <arvcamera.h>
+#include <arvbandwidthplanner.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_UV_BANDWIDTH_PLANNER             (arv_uv_bandwidth_planner_get_type ())
+ARV_API G_DECLARE_FINAL_TYPE (ArvUvBandwidthPlanner, arv_uv_bandwidth_planner, ARV, UV_BANDWIDTH_PLANNER, GObject)
+
+ARV_API ArvUvBandwidthPlanner *	arv_uv_bandwidth_planner_new			(void);
+
+ARV_API void			arv_uv_bandwidth_planner_set_max_link_usage	(ArvUvBandwidthPlanner *planner,
+										 double max_link_usage);
+
+ARV_API gboolean		arv_uv_bandwidth_planner_add_camera		(ArvUvBandwidthPlanner *planner,
+										 ArvCamera *camera, GError **error);
+ARV_API void			arv_uv_bandwidth_planner_remove_camera		(ArvUvBandwidthPlanner *planner,
+										 ArvCamera *camera);
+
+ARV_API gboolean		arv_uv_bandwidth_planner_apply			(ArvUvBandwidthPlanner *planner,
+										 GError **error);
+
+ARV_API guint64			arv_uv_bandwidth_planner_get_required_bandwidth	(ArvUvBandwidthPlanner *planner,
+										 ArvCamera *camera);
+ARV_API guint64			arv_uv_bandwidth_planner_get_bandwidth		(ArvUvBandwidthPlanner *planner,
+										 ArvCamera *camera);
+
+G_END_DECLS
+
+#endif
@@ -33,9 +33,13 @@
 G_BEGIN_DECLS
 
 #define ARV_UVCP_MAGIC	0x43563355
+#define ARV_UVCP_EVENT_MAGIC	0x45563355
 
 #define ARV_UVCP_DEFAULT_RESPONSE_TIME_MS		5
 
+/* The size of the command specific data is a 16 bit field of the packet header */
+#define ARV_UVCP_SCD_SIZE_MAX				0xffff
+
 #define ARV_ABRM_GENCP_VERSION			0x0000
 #define ARV_ABRM_MANUFACTURER_NAME		0x0004
 #define ARV_ABRM_MODEL_NAME			0x0044
@@ -89,6 +93,12 @@ G_BEGIN_DECLS
 
 #define ARV_SIRM_CONTROL_STREAM_ENABLE		0x00000001
 
+#define ARV_EIRM_CONTROL			0x0000
+#define ARV_EIRM_MAX_EVENT_TRANSFER_LENGTH	0x0004
+#define ARV_EIRM_EVENT_TEST_CONTROL		0x0008
+
+#define ARV_EIRM_CONTROL_EVENT_ENABLE		0x00000001
+
 /**
  * ArvUvcpStatus:
  * @ARV_UCVP_STATUS_SUCCESS: success
@@ -153,6 +163,7 @@ typedef enum {
  * @ARV_UVCP_COMMAND_WRITE_MEMORY_ACK: write memory acknowledge
  * @ARV_UVCP_COMMAND_PENDING_ACK: pending command acknowledge
  * @ARV_UVCP_COMMAND_EVENT_CMD: event command
+ * @ARV_UVCP_COMMAND_EVENT_ACK: event acknowledge
  */
 
 typedef enum {
@@ -244,11 +255,8 @@ typedef struct {
 	guint32 schema;
 	guint64 address;
 	guint64 size;
-	guint64 unknown3;
-	guint64 unknown4;
-	guint64 unknown5;
-	guint64 unknown6;
-	guint64 unknown7;
+	guint8 sha1_hash[20];
+	guint8 reserved[20];
 } ArvUvcpManifestEntry;
 
 #pragma pack(pop)
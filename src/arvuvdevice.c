@@ -30,6 +30,7 @@
 #include <arvuvinterfaceprivate.h>
 #include <arvuvcpprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvdebug.h>
 #include <arvenumtypes.h>
 #include <libusb.h>
@@ -37,6 +38,7 @@
 #include <arvstr.h>
 #include <arvzip.h>
 #include <arvmisc.h>
+#include <arvgenicamcacheprivate.h>
 
 enum
 {
@@ -49,6 +51,11 @@ enum
 
 #define ARV_UV_DEVICE_N_TRIES_MAX	5
 
+#define ARV_UV_DEVICE_N_STREAM_CHANNELS_MAX	8
+
+#define ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_DEFAULT	1024
+#define ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_MAX		65536
+
 typedef struct {
 	char *vendor;
 	char *product;
@@ -71,11 +78,32 @@ typedef struct {
 	guint cmd_packet_size_max;
 	guint ack_packet_size_max;
 	guint control_interface;
-	guint data_interface;
+	guint event_interface;
         guint8 control_endpoint;
-        guint8 data_endpoint;
+        guint8 event_endpoint;
+	/* One streaming interface per stream channel, in the interface order */
+	guint data_interfaces[ARV_UV_DEVICE_N_STREAM_CHANNELS_MAX];
+        guint8 data_endpoints[ARV_UV_DEVICE_N_STREAM_CHANNELS_MAX];
+	guint n_data_interfaces;
+	guint n_stream_channels;
+	/* SIRM of the first stream channel, the next ones being contiguous */
+	guint64 sirm_offset;
+	guint32 sirm_length;
+	gboolean has_event_interface;
 	gboolean disconnected;
 
+	guint64 eirm_offset;
+
+	struct libusb_transfer *cmd_transfer;
+	struct libusb_transfer *ack_transfer;
+	void *ack_buffer;
+
+	GMutex event_mutex;
+	GCond event_cond;
+	struct libusb_transfer *event_transfer;
+	gboolean is_event_transfer_pending;
+	gboolean is_event_channel_running;
+
 	ArvUvUsbMode usb_mode;
 
 	int event_thread_run;
@@ -106,24 +134,137 @@ arv_uv_device_is_connected (ArvUvDevice *uv_device)
         return !priv->disconnected;
 }
 
+/**
+ * arv_uv_device_get_speed: (skip)
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the negotiated link speed, as a libusb_speed value.
+ */
+
+int
+arv_uv_device_get_speed (ArvUvDevice *uv_device)
+{
+        ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+        if (priv->usb_device == NULL || priv->disconnected)
+                return LIBUSB_SPEED_UNKNOWN;
+
+        return libusb_get_device_speed (libusb_get_device (priv->usb_device));
+}
+
+/**
+ * arv_uv_device_get_topology: (skip)
+ * @uv_device: a #ArvUvDevice
+ * @bus_number: (out): the number of the bus the device is connected to
+ * @port_numbers: (out): the port numbers, from the root hub to the device
+ * @max_depth: the size of @port_numbers
+ *
+ * Returns: the number of port numbers written in @port_numbers, 0 on error.
+ */
+
+int
+arv_uv_device_get_topology (ArvUvDevice *uv_device, guint8 *bus_number, guint8 *port_numbers, int max_depth)
+{
+        ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+        libusb_device *device;
+        int n_ports;
+
+        if (priv->usb_device == NULL || priv->disconnected)
+                return 0;
+
+        device = libusb_get_device (priv->usb_device);
+        n_ports = libusb_get_port_numbers (device, port_numbers, max_depth);
+        if (n_ports < 0) {
+                arv_warning_device ("[UvDevice::get_topology] Failed to get port numbers: %s",
+                                    libusb_error_name (n_ports));
+                return 0;
+        }
+
+        if (bus_number != NULL)
+                *bus_number = libusb_get_bus_number (device);
+
+        return n_ports;
+}
+
+/**
+ * arv_uv_device_dev_mem_alloc: (skip)
+ * @uv_device: a #ArvUvDevice
+ * @size: allocation size
+ *
+ * Allocates memory suitable for zero-copy transfers, using libusb_dev_mem_alloc.
+ *
+ * Returns: a memory block to be freed using arv_uv_device_dev_mem_free(), %NULL if zero-copy memory is not
+ * available.
+ */
+
+void *
+arv_uv_device_dev_mem_alloc (ArvUvDevice *uv_device, size_t size)
+{
+#if LIBUSB_API_VERSION >= 0x01000105
+        ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+        if (priv->usb_device == NULL || priv->disconnected || size == 0)
+                return NULL;
+
+        return libusb_dev_mem_alloc (priv->usb_device, size);
+#else
+        return NULL;
+#endif
+}
+
+void
+arv_uv_device_dev_mem_free (ArvUvDevice *uv_device, void *data, size_t size)
+{
+#if LIBUSB_API_VERSION >= 0x01000105
+        ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+        g_return_if_fail (priv->usb_device != NULL);
+
+        libusb_dev_mem_free (priv->usb_device, data, size);
+#else
+        g_return_if_reached ();
+#endif
+}
+
+static guint8
+_get_endpoint (ArvUvDevicePrivate *priv, ArvUvEndpointType endpoint_type, guint stream_channel)
+{
+	if (endpoint_type == ARV_UV_ENDPOINT_CONTROL)
+		return priv->control_endpoint;
+
+	return priv->data_endpoints[MIN (stream_channel, ARV_UV_DEVICE_N_STREAM_CHANNELS_MAX - 1)];
+}
+
 void
 arv_uv_device_fill_bulk_transfer (struct libusb_transfer* transfer, ArvUvDevice *uv_device,
-                                  ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
-                                  void *data, size_t size,
+                                  ArvUvEndpointType endpoint_type, guint stream_channel,
+                                  unsigned char endpoint_flags, void *data, size_t size,
                                   libusb_transfer_cb_fn callback, void* callback_data,
                                   unsigned int timeout)
 {
         ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
         guint8 endpoint;
 
-	endpoint = (endpoint_type == ARV_UV_ENDPOINT_CONTROL) ? priv->control_endpoint : priv->data_endpoint;
+	endpoint = _get_endpoint (priv, endpoint_type, stream_channel);
 
         libusb_fill_bulk_transfer (transfer, priv->usb_device, endpoint | endpoint_flags, data, size,
                                    callback, callback_data, timeout );
 }
 
+static void
+_set_disconnected (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	if (!priv->disconnected) {
+		priv->disconnected = TRUE;
+		arv_device_emit_control_lost_signal (ARV_DEVICE (uv_device));
+	}
+}
+
 gboolean
-arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_type, unsigned char endpoint_flags, void *data,
+arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_type, guint stream_channel,
+			     unsigned char endpoint_flags, void *data,
 			     size_t size, size_t *transferred_size, guint32 timeout_ms, GError **error)
 {
 	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
@@ -142,8 +283,7 @@ arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_
 		return FALSE;
 	}
 
-
-	endpoint = (endpoint_type == ARV_UV_ENDPOINT_CONTROL) ? priv->control_endpoint : priv->data_endpoint;
+	endpoint = _get_endpoint (priv, endpoint_type, stream_channel);
 	result = libusb_bulk_transfer (priv->usb_device, endpoint | endpoint_flags, data, size, &transferred,
 				       timeout_ms > 0 ? timeout_ms : priv->timeout_ms);
 
@@ -156,21 +296,152 @@ arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_
 	if (transferred_size != NULL)
 		*transferred_size = transferred;
 
-	if (result == LIBUSB_ERROR_NO_DEVICE) {
-                if (!priv->disconnected) {
-                        priv->disconnected = TRUE;
-                        arv_device_emit_control_lost_signal (ARV_DEVICE (uv_device));
-                }
-        }
+	if (result == LIBUSB_ERROR_NO_DEVICE)
+		_set_disconnected (uv_device);
 
 	return success;
 }
 
+/**
+ * arv_uv_device_get_n_stream_channels:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the number of stream channels of the device, each one having its own streaming interface.
+ *
+ * Since: 0.8.24
+ */
+
+guint
+arv_uv_device_get_n_stream_channels (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), 0);
+
+	return priv->n_stream_channels;
+}
+
+/**
+ * arv_uv_device_get_sirm_offset: (skip)
+ * @uv_device: a #ArvUvDevice
+ * @stream_channel: stream channel index
+ *
+ * Returns: the address of the streaming interface register map of @stream_channel.
+ */
+
+guint64
+arv_uv_device_get_sirm_offset (ArvUvDevice *uv_device, guint stream_channel)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	return priv->sirm_offset + (guint64) stream_channel * priv->sirm_length;
+}
+
+/**
+ * arv_uv_device_create_stream_for_channel:
+ * @uv_device: a #ArvUvDevice
+ * @stream_channel: stream channel index
+ * @callback: (scope notified) (allow-none): a frame processing callback
+ * @user_data: (closure) (allow-none): user data for @callback
+ * @destroy: a #GDestroyNotify placeholder, %NULL to ignore
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new [class@ArvStream] receiving the data of the streaming interface of @stream_channel, for the devices
+ * with several stream channels, like the multi-head cameras. The streams of different channels can run concurrently.
+ * arv_device_create_stream() uses the first channel.
+ *
+ * Returns: (transfer full): a new [class@ArvStream], to be freed after use with [method@GObject.Object.unref].
+ *
+ * Since: 0.8.24
+ */
+
+ArvStream *
+arv_uv_device_create_stream_for_channel (ArvUvDevice *uv_device, guint stream_channel, ArvStreamCallback callback,
+					 void *user_data, GDestroyNotify destroy, GError **error)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), NULL);
+
+	if (stream_channel >= priv->n_stream_channels) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
+			     "Stream channel %u not found (%u channels)", stream_channel, priv->n_stream_channels);
+		return NULL;
+	}
+
+	return arv_uv_stream_new (uv_device, stream_channel, callback, user_data, destroy, priv->usb_mode, error);
+}
+
 static ArvStream *
 arv_uv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GDestroyNotify destroy, GError **error)
 {
-	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (ARV_UV_DEVICE (device));
-	return arv_uv_stream_new (ARV_UV_DEVICE (device), callback, user_data, destroy, priv->usb_mode, error);
+	return arv_uv_device_create_stream_for_channel (ARV_UV_DEVICE (device), 0, callback, user_data, destroy, error);
+}
+
+/* The control channel transfers are asynchronous, their completion being waited for in the calling thread. The libusb
+ * event handling is shared with the event thread. */
+
+static void LIBUSB_CALL
+_control_transfer_cb (struct libusb_transfer *transfer)
+{
+	int *completed = transfer->user_data;
+
+	*completed = 1;
+}
+
+static void
+_control_transfer_wait (ArvUvDevicePrivate *priv, int *completed)
+{
+	while (!*completed)
+		libusb_handle_events_completed (priv->usb, completed);
+}
+
+static gboolean
+_control_transfer_submit (ArvUvDevice *uv_device, struct libusb_transfer *transfer, unsigned char endpoint_flags,
+			  void *data, size_t size, guint32 timeout_ms, int *completed, GError **error)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	int result;
+
+	if (priv->disconnected) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED, "Not connected");
+		return FALSE;
+	}
+
+	*completed = 0;
+	libusb_fill_bulk_transfer (transfer, priv->usb_device, priv->control_endpoint | endpoint_flags, data, size,
+				   _control_transfer_cb, completed, timeout_ms);
+
+	result = libusb_submit_transfer (transfer);
+	if (result != 0) {
+		if (result == LIBUSB_ERROR_NO_DEVICE)
+			_set_disconnected (uv_device);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TRANSFER_ERROR,
+			     "%s", libusb_error_name (result));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+_control_transfer_check (ArvUvDevice *uv_device, struct libusb_transfer *transfer, GError **error)
+{
+	switch (transfer->status) {
+		case LIBUSB_TRANSFER_COMPLETED:
+			return TRUE;
+		case LIBUSB_TRANSFER_TIMED_OUT:
+			g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT, "Timeout");
+			return FALSE;
+		case LIBUSB_TRANSFER_NO_DEVICE:
+			_set_disconnected (uv_device);
+			g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED, "Not connected");
+			return FALSE;
+		default:
+			g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TRANSFER_ERROR,
+				     "Transfer status %d", transfer->status);
+			return FALSE;
+	}
 }
 
 static gboolean
@@ -206,6 +477,8 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 	if (ack_size > priv->ack_packet_size_max) {
 		arv_info_device ("Invalid uv %s acknowledge packet size (%" G_GSIZE_FORMAT " / max: %d)",
 				  operation, ack_size, priv->ack_packet_size_max);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "USB3Vision %s acknowledge too large", operation);
 		return FALSE;
 	}
 
@@ -221,8 +494,10 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 	}
 
 	if (packet_size > priv->cmd_packet_size_max) {
-		arv_info_device ("Invalid us %s command packet size (%" G_GSIZE_FORMAT " / max: %d)",
+		arv_info_device ("Invalid uv %s command packet size (%" G_GSIZE_FORMAT " / max: %d)",
 				  operation, packet_size, priv->cmd_packet_size_max);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "USB3Vision %s command too large", operation);
 		arv_uvcp_packet_free (packet);
 		return FALSE;
 	}
@@ -238,25 +513,39 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 			g_assert_not_reached ();
 	}
 
-	ack_packet = g_malloc (ack_size);
+	ack_packet = priv->ack_buffer;
 
 	g_mutex_lock (&priv->transfer_mutex);
 
 	do {
 		GError *local_error = NULL;
-		size_t transferred;
+		int ack_completed;
+		int cmd_completed;
 
 		priv->packet_id = arv_uvcp_next_packet_id (priv->packet_id);
 		arv_uvcp_packet_set_packet_id (packet, priv->packet_id);
 
 		arv_uvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
 
-		success = TRUE;
-		success = success && arv_uv_device_bulk_transfer (uv_device,
-								  ARV_UV_ENDPOINT_CONTROL,
-								  LIBUSB_ENDPOINT_OUT,
-								  packet, packet_size,
-								  NULL, 0, &local_error);
+		/* The acknowledge reception is armed before the command is sent, the device answer being received
+		 * without waiting for the completion of the command transfer. */
+		success = _control_transfer_submit (uv_device, priv->ack_transfer, LIBUSB_ENDPOINT_IN,
+						    ack_packet, ack_size, priv->timeout_ms, &ack_completed,
+						    &local_error);
+		if (success) {
+			success = _control_transfer_submit (uv_device, priv->cmd_transfer, LIBUSB_ENDPOINT_OUT,
+							    packet, packet_size, priv->timeout_ms, &cmd_completed,
+							    &local_error);
+			if (success) {
+				_control_transfer_wait (priv, &cmd_completed);
+				success = _control_transfer_check (uv_device, priv->cmd_transfer, &local_error);
+			}
+			if (!success) {
+				libusb_cancel_transfer (priv->ack_transfer);
+				_control_transfer_wait (priv, &ack_completed);
+			}
+		}
+
 		if (success) {
 			gint timeout_ms;
                         gint64 timeout_stop_ms;
@@ -269,17 +558,8 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 			do {
 				pending_ack = FALSE;
 
-				timeout_ms = timeout_stop_ms - g_get_monotonic_time () / 1000;
-                                if (timeout_ms < 0)
-                                        timeout_ms = 0;
-
-				success = TRUE;
-				success = success && arv_uv_device_bulk_transfer (uv_device,
-										  ARV_UV_ENDPOINT_CONTROL,
-										  LIBUSB_ENDPOINT_IN,
-										  ack_packet, ack_size,
-										  &transferred, timeout_ms,
-										  &local_error);
+				_control_transfer_wait (priv, &ack_completed);
+				success = _control_transfer_check (uv_device, priv->ack_transfer, &local_error);
 
 				if (success) {
 					ArvUvcpCommand ack_command;
@@ -302,7 +582,7 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 
 						arv_debug_device ("[UvDevice::%s] Pending ack timeout = %" G_GINT64_FORMAT,
 								operation, pending_ack_timeout_ms);
-					} if (status != ARV_UVCP_STATUS_SUCCESS) {
+					} else if (status != ARV_UVCP_STATUS_SUCCESS) {
 						expected_answer = ack_command == expected_ack_command &&
 							packet_id == priv->packet_id;
 						if (!expected_answer) {
@@ -325,7 +605,23 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 					g_clear_error (&local_error);
 				}
 
-			} while (pending_ack || (!expected_answer && timeout_ms));
+				timeout_ms = timeout_stop_ms - g_get_monotonic_time () / 1000;
+                                if (timeout_ms < 0)
+                                        timeout_ms = 0;
+
+				/* A zero timeout means no timeout for libusb */
+				if ((pending_ack || (!expected_answer && success)) && timeout_ms > 0) {
+					if (!_control_transfer_submit (uv_device, priv->ack_transfer, LIBUSB_ENDPOINT_IN,
+								       ack_packet, ack_size, timeout_ms, &ack_completed,
+								       &local_error)) {
+						arv_warning_device ("[UvDevice::%s] Ack reception error: %s",
+								    operation, local_error->message);
+						g_clear_error (&local_error);
+						break;
+					}
+				} else
+					break;
+			} while (TRUE);
 
 			success = success && expected_answer;
 
@@ -352,7 +648,6 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 
 	g_mutex_unlock (&priv->transfer_mutex);
 
-	g_free (ack_packet);
 	arv_uvcp_packet_free (packet);
 
 	success = success && status == ARV_UVCP_STATUS_SUCCESS;
@@ -381,7 +676,8 @@ arv_uv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, voi
 	gint32 block_size;
 	guint data_size_max;
 
-	data_size_max = priv->ack_packet_size_max - sizeof (ArvUvcpHeader);
+	/* Limited by the device maximum acknowledge transfer length */
+	data_size_max = MIN (priv->ack_packet_size_max - sizeof (ArvUvcpHeader), ARV_UVCP_SCD_SIZE_MAX) & ~0x3;
 
 	for (i = 0; i < (size + data_size_max - 1) / data_size_max; i++) {
 		block_size = MIN (data_size_max, size - i * data_size_max);
@@ -403,7 +699,9 @@ arv_uv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, vo
 	gint32 block_size;
 	guint data_size_max;
 
-	data_size_max = priv->ack_packet_size_max - sizeof (ArvUvcpHeader);
+	/* Limited by the device maximum command transfer length */
+	data_size_max = MIN (priv->cmd_packet_size_max - sizeof (ArvUvcpWriteMemoryCmd),
+			     ARV_UVCP_SCD_SIZE_MAX - sizeof (ArvUvcpWriteMemoryCmdInfos)) & ~0x3;
 
 	for (i = 0; i < (size + data_size_max - 1) / data_size_max; i++) {
 		block_size = MIN (data_size_max, size - i * data_size_max);
@@ -428,6 +726,52 @@ arv_uv_device_write_register (ArvDevice *device, guint64 address, guint32 value,
 	return arv_uv_device_write_memory (device, address, sizeof (guint32), &value, error);
 }
 
+/* U3V has no multiple register command. Consecutive registers at contiguous addresses are accessed using a single
+ * memory transaction. */
+
+static guint
+_get_n_contiguous_registers (guint n_registers, const guint64 *addresses)
+{
+	guint n;
+
+	for (n = 1; n < n_registers; n++)
+		if (addresses[n] != addresses[0] + n * sizeof (guint32))
+			break;
+
+	return n;
+}
+
+static gboolean
+arv_uv_device_read_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, guint32 *values,
+			      GError **error)
+{
+	guint i, n;
+
+	for (i = 0; i < n_registers; i += n) {
+		n = _get_n_contiguous_registers (n_registers - i, &addresses[i]);
+		if (!arv_uv_device_read_memory (device, addresses[i], n * sizeof (guint32), &values[i], error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+arv_uv_device_write_registers (ArvDevice *device, guint n_registers, const guint64 *addresses,
+			       const guint32 *values, GError **error)
+{
+	guint i, n;
+
+	for (i = 0; i < n_registers; i += n) {
+		n = _get_n_contiguous_registers (n_registers - i, &addresses[i]);
+		if (!arv_uv_device_write_memory (device, addresses[i], n * sizeof (guint32), (void *) &values[i],
+						 error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
 static gboolean
 _bootstrap (ArvUvDevice *uv_device)
 {
@@ -440,6 +784,7 @@ _bootstrap (ArvUvDevice *uv_device)
 	guint32 max_cmd_transfer;
 	guint32 max_ack_transfer;
 	guint32 u3vcp_capability;
+	guint32 n_stream_channels;
 	guint64 sirm_offset;
 	guint32 si_info;
 	guint32 si_control;
@@ -458,6 +803,12 @@ _bootstrap (ArvUvDevice *uv_device)
 	GString *string;
 	void *data;
 	char manufacturer[64];
+	char model[64];
+	char version[64];
+	char *cache_key;
+	char *url;
+	GString *sha1_string;
+	unsigned int i;
 	gboolean success = TRUE;
 
 	arv_info_device ("Get genicam");
@@ -470,6 +821,17 @@ _bootstrap (ArvUvDevice *uv_device)
 	manufacturer[63] = 0;
 	arv_info_device ("MANUFACTURER_NAME =        '%s'", manufacturer);
 
+	success = success && arv_device_read_memory (device, ARV_ABRM_MODEL_NAME, 64, &model, NULL);
+	success = success && arv_device_read_memory (device, ARV_ABRM_DEVICE_VERSION, 64, &version, NULL);
+	if (!success) {
+		arv_warning_device ("[UvDevice::_bootstrap] Error during memory read");
+		return FALSE;
+	}
+	model[63] = 0;
+	version[63] = 0;
+	arv_info_device ("MODEL_NAME =               '%s'", model);
+	arv_info_device ("DEVICE_VERSION =           '%s'", version);
+
 	success = success && arv_device_read_memory (device, ARV_ABRM_SBRM_ADDRESS, sizeof (guint64), &offset, NULL);
 	success = success && arv_device_read_memory (device, ARV_ABRM_MAX_DEVICE_RESPONSE_TIME, sizeof (guint32), &response_time, NULL);
 	success = success && arv_device_read_memory (device, ARV_ABRM_DEVICE_CAPABILITY, sizeof (guint64), &device_capability, NULL);
@@ -489,7 +851,10 @@ _bootstrap (ArvUvDevice *uv_device)
 	success = success && arv_device_read_memory (device, offset + ARV_SBRM_U3VCP_CAPABILITY, sizeof (guint32), &u3vcp_capability, NULL);
 	success = success && arv_device_read_memory (device, offset + ARV_SBRM_MAX_CMD_TRANSFER, sizeof (guint32), &max_cmd_transfer, NULL);
 	success = success && arv_device_read_memory (device, offset + ARV_SBRM_MAX_ACK_TRANSFER, sizeof (guint32), &max_ack_transfer, NULL);
+	success = success && arv_device_read_memory (device, offset + ARV_SBRM_NUM_STREAM_CHANNELS, sizeof (guint32), &n_stream_channels, NULL);
 	success = success && arv_device_read_memory (device, offset + ARV_SBRM_SIRM_ADDRESS, sizeof (guint64), &sirm_offset, NULL);
+	success = success && arv_device_read_memory (device, offset + ARV_SBRM_SIRM_LENGTH, sizeof (guint32), &priv->sirm_length, NULL);
+	success = success && arv_device_read_memory (device, offset + ARV_SBRM_EIRM_ADDRESS, sizeof (guint64), &priv->eirm_offset, NULL);
 	if (!success) {
 		arv_warning_device ("[UvDevice::_bootstrap] Error during memory read");
 		return FALSE;
@@ -498,11 +863,21 @@ _bootstrap (ArvUvDevice *uv_device)
 	arv_info_device ("U3VCP_CAPABILITY =         0x%08x", u3vcp_capability);
 	arv_info_device ("MAX_CMD_TRANSFER =         0x%08x", max_cmd_transfer);
 	arv_info_device ("MAX_ACK_TRANSFER =         0x%08x", max_ack_transfer);
+	arv_info_device ("NUM_STREAM_CHANNELS =      %u", n_stream_channels);
 	arv_info_device ("SIRM_OFFSET =              0x%016" G_GINT64_MODIFIER "x", sirm_offset);
+	arv_info_device ("SIRM_LENGTH =              0x%08x", priv->sirm_length);
+	arv_info_device ("EIRM_OFFSET =              0x%016" G_GINT64_MODIFIER "x", priv->eirm_offset);
 
 	priv->cmd_packet_size_max = MIN (priv->cmd_packet_size_max, max_cmd_transfer);
 	priv->ack_packet_size_max = MIN (priv->ack_packet_size_max, max_ack_transfer);
 
+	/* Some single stream devices report no stream channel, while having a streaming interface */
+	priv->sirm_offset = sirm_offset;
+	priv->n_stream_channels = n_stream_channels > 0 ?
+		MIN (n_stream_channels, priv->n_data_interfaces) : MIN (priv->n_data_interfaces, 1);
+	if (priv->sirm_length == 0)
+		priv->n_stream_channels = MIN (priv->n_stream_channels, 1);
+
 	success = success && arv_device_read_memory (device, sirm_offset + ARV_SIRM_INFO, sizeof (si_info), &si_info, NULL);
 	success = success && arv_device_read_memory (device, sirm_offset + ARV_SIRM_CONTROL, sizeof (si_control), &si_control, NULL);
 	success = success && arv_device_read_memory (device, sirm_offset + ARV_SIRM_REQ_PAYLOAD_SIZE, sizeof (si_req_payload_size), &si_req_payload_size, NULL);
@@ -548,11 +923,39 @@ _bootstrap (ArvUvDevice *uv_device)
 	arv_info_device ("genicam address =          0x%016" G_GINT64_MODIFIER "x", entry.address);
 	arv_info_device ("genicam size    =          0x%016" G_GINT64_MODIFIER "x", entry.size);
 
+	/* The manifest entry SHA1 hash, when provided by the device, changes with the genicam data content. */
+	sha1_string = g_string_new ("");
+	for (i = 0; i < G_N_ELEMENTS (entry.sha1_hash); i++)
+		g_string_append_printf (sha1_string, "%02x", entry.sha1_hash[i]);
+	url = g_strdup_printf ("u3v:%u.%u.%u:0x%" G_GINT64_MODIFIER "x:0x%" G_GINT64_MODIFIER "x:%s",
+			       entry.file_version_major, entry.file_version_minor, entry.file_version_subminor,
+			       entry.address, entry.size, sha1_string->str);
+	cache_key = arv_genicam_cache_get_key (manufacturer, model, version, url);
+	g_string_free (sha1_string, TRUE);
+	g_free (url);
+
+	priv->genicam_xml = arv_genicam_cache_load (cache_key, &priv->genicam_xml_size);
+	if (priv->genicam_xml != NULL) {
+		arv_info_device ("[UvDevice::_bootstrap] Use cached genicam data");
+		if (arv_get_genicam_trusted_loading ())
+			priv->genicam = arv_gc_new_trusted (ARV_DEVICE (uv_device),
+							    priv->genicam_xml,
+							    priv->genicam_xml_size,
+							    cache_key);
+		else
+			priv->genicam = arv_gc_new (ARV_DEVICE (uv_device),
+						    priv->genicam_xml,
+						    priv->genicam_xml_size);
+		g_free (cache_key);
+		return TRUE;
+	}
+
 	data = g_malloc0 (entry.size);
 	success = success && arv_device_read_memory (device, entry.address, entry.size, data, NULL);
 	if (!success){
 		arv_warning_device ("[UvDevice::_bootstrap] Error during memory read");
 		g_free(data);
+		g_free (cache_key);
 		return FALSE;
 	}
 
@@ -614,6 +1017,10 @@ _bootstrap (ArvUvDevice *uv_device)
 			arv_warning_device ("Unknown USB3Vision manifest schema type (%d)", schema_type);
 	}
 
+	if (priv->genicam_xml != NULL)
+		arv_genicam_cache_store (cache_key, priv->genicam_xml, priv->genicam_xml_size);
+	g_free (cache_key);
+
 #if 0
 	arv_info_device("GENICAM\n:%s", priv->genicam_xml);
 #endif
@@ -777,10 +1184,22 @@ _open_usb_device (ArvUvDevice *uv_device, GError **error)
 								priv->control_endpoint = endpoint.bEndpointAddress & 0x0f;
 								priv->control_interface = interdesc->bInterfaceNumber;
 							}
-							if (interdesc->bInterfaceProtocol == ARV_UV_INTERFACE_DATA_PROTOCOL) {
+							if (interdesc->bInterfaceProtocol == ARV_UV_INTERFACE_DATA_PROTOCOL &&
+							    k == 0 &&
+							    priv->n_data_interfaces < ARV_UV_DEVICE_N_STREAM_CHANNELS_MAX) {
 								endpoint = interdesc->endpoint[0];
-								priv->data_endpoint = endpoint.bEndpointAddress & 0x0f;
-								priv->data_interface = interdesc->bInterfaceNumber;
+								priv->data_endpoints[priv->n_data_interfaces] =
+									endpoint.bEndpointAddress & 0x0f;
+								priv->data_interfaces[priv->n_data_interfaces] =
+									interdesc->bInterfaceNumber;
+								priv->n_data_interfaces++;
+							}
+							if (interdesc->bInterfaceProtocol == ARV_UV_INTERFACE_EVENT_PROTOCOL &&
+							    interdesc->bNumEndpoints > 0) {
+								endpoint = interdesc->endpoint[0];
+								priv->event_endpoint = endpoint.bEndpointAddress & 0x0f;
+								priv->event_interface = interdesc->bInterfaceNumber;
+								priv->has_event_interface = TRUE;
 							}
 						}
 					}
@@ -822,6 +1241,279 @@ event_thread_func(void *p)
         return NULL;
 }
 
+/* Event endpoint. The transfer completions run in the libusb event thread, where the event signals are emitted right
+ * after the decoding. */
+
+static void
+_process_event_packet (ArvUvDevice *uv_device, const unsigned char *packet, size_t size)
+{
+	const ArvUvcpHeader *header = (const ArvUvcpHeader *) packet;
+	size_t offset;
+	size_t end;
+
+	if (size < sizeof (ArvUvcpHeader) ||
+	    GUINT32_FROM_LE (header->magic) != ARV_UVCP_EVENT_MAGIC ||
+	    GUINT16_FROM_LE (header->command) != ARV_UVCP_COMMAND_EVENT_CMD) {
+		arv_debug_device ("[UvDevice::event] Unexpected event endpoint packet");
+		return;
+	}
+
+	offset = sizeof (ArvUvcpHeader);
+	end = MIN (size, sizeof (ArvUvcpHeader) + GUINT16_FROM_LE (header->size));
+
+	/* Each event is made of a 16 bit size, including this 12 bytes header, a 16 bit id and a 64 bit timestamp,
+	 * followed by the event data */
+	while (offset + 12 <= end) {
+		const unsigned char *item = packet + offset;
+		guint16 item_size;
+		guint16 event_id;
+		guint64 timestamp;
+
+		memcpy (&item_size, item, sizeof (item_size));
+		memcpy (&event_id, item + 2, sizeof (event_id));
+		memcpy (&timestamp, item + 4, sizeof (timestamp));
+		item_size = GUINT16_FROM_LE (item_size);
+		event_id = GUINT16_FROM_LE (event_id);
+		timestamp = GUINT64_FROM_LE (timestamp);
+
+		if (item_size < 12 || offset + item_size > end)
+			item_size = end - offset;
+
+		arv_debug_device ("[UvDevice::event] Event 0x%04x, timestamp %" G_GUINT64_FORMAT,
+				  event_id, timestamp);
+		arv_device_emit_event_signal (ARV_DEVICE (uv_device), event_id, timestamp,
+					      item, item_size, item + 12, item_size - 12);
+
+		offset += item_size;
+	}
+}
+
+static void LIBUSB_CALL
+_event_transfer_cb (struct libusb_transfer *transfer)
+{
+	ArvUvDevice *uv_device = transfer->user_data;
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	gboolean resubmitted = FALSE;
+
+	if (transfer->status == LIBUSB_TRANSFER_COMPLETED)
+		_process_event_packet (uv_device, transfer->buffer, transfer->actual_length);
+
+	g_mutex_lock (&priv->event_mutex);
+	if (priv->is_event_channel_running &&
+	    (transfer->status == LIBUSB_TRANSFER_COMPLETED || transfer->status == LIBUSB_TRANSFER_TIMED_OUT))
+		resubmitted = libusb_submit_transfer (transfer) == LIBUSB_SUCCESS;
+	if (!resubmitted) {
+		if (priv->is_event_channel_running)
+			arv_warning_device ("[UvDevice::event] Event transfer stopped (status %d)",
+					    transfer->status);
+		priv->is_event_transfer_pending = FALSE;
+		g_cond_signal (&priv->event_cond);
+	}
+	g_mutex_unlock (&priv->event_mutex);
+}
+
+static void
+_free_event_transfer (ArvUvDevicePrivate *priv)
+{
+	g_free (priv->event_transfer->buffer);
+	libusb_free_transfer (priv->event_transfer);
+	priv->event_transfer = NULL;
+
+	libusb_release_interface (priv->usb_device, priv->event_interface);
+}
+
+static gboolean
+arv_uv_device_start_event_channel (ArvDevice *device, GError **error)
+{
+	ArvUvDevice *uv_device = ARV_UV_DEVICE (device);
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	guint32 transfer_size = 0;
+	guint32 control = ARV_EIRM_CONTROL_EVENT_ENABLE;
+	int result;
+
+	if (priv->event_transfer != NULL)
+		return TRUE;
+
+	if (!priv->has_event_interface || priv->eirm_offset == 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Event interface not supported by the device");
+		return FALSE;
+	}
+
+	result = libusb_claim_interface (priv->usb_device, priv->event_interface);
+	if (result != 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Failed to claim the USB event interface: %s", libusb_error_name (result));
+		return FALSE;
+	}
+
+	arv_device_read_memory (device, priv->eirm_offset + ARV_EIRM_MAX_EVENT_TRANSFER_LENGTH,
+				sizeof (transfer_size), &transfer_size, NULL);
+	if (transfer_size == 0)
+		transfer_size = ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_DEFAULT;
+	transfer_size = MIN (transfer_size, ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_MAX);
+
+	priv->event_transfer = libusb_alloc_transfer (0);
+	libusb_fill_bulk_transfer (priv->event_transfer, priv->usb_device,
+				   priv->event_endpoint | LIBUSB_ENDPOINT_IN,
+				   g_malloc (transfer_size), transfer_size,
+				   _event_transfer_cb, uv_device, 0);
+
+	g_mutex_lock (&priv->event_mutex);
+	priv->is_event_channel_running = TRUE;
+	result = libusb_submit_transfer (priv->event_transfer);
+	priv->is_event_transfer_pending = result == LIBUSB_SUCCESS;
+	g_mutex_unlock (&priv->event_mutex);
+
+	if (result != LIBUSB_SUCCESS) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TRANSFER_ERROR,
+			     "Failed to submit the event transfer: %s", libusb_error_name (result));
+		priv->is_event_channel_running = FALSE;
+		_free_event_transfer (priv);
+		return FALSE;
+	}
+
+	if (!arv_device_write_memory (device, priv->eirm_offset + ARV_EIRM_CONTROL, sizeof (control), &control,
+				      error)) {
+		arv_device_stop_event_channel (device);
+		return FALSE;
+	}
+
+	arv_info_device ("[UvDevice::start_event_channel] Using event endpoint %d, interface %d, transfer size %u",
+			 priv->event_endpoint, priv->event_interface, transfer_size);
+
+	return TRUE;
+}
+
+static void
+arv_uv_device_stop_event_channel (ArvDevice *device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (ARV_UV_DEVICE (device));
+	guint32 control = 0;
+
+	if (priv->event_transfer == NULL)
+		return;
+
+	if (!priv->disconnected)
+		arv_device_write_memory (device, priv->eirm_offset + ARV_EIRM_CONTROL, sizeof (control), &control,
+					 NULL);
+
+	/* The transfer completion is processed by the libusb event thread */
+	g_mutex_lock (&priv->event_mutex);
+	priv->is_event_channel_running = FALSE;
+	if (priv->is_event_transfer_pending)
+		libusb_cancel_transfer (priv->event_transfer);
+	while (priv->is_event_transfer_pending)
+		g_cond_wait (&priv->event_cond, &priv->event_mutex);
+	g_mutex_unlock (&priv->event_mutex);
+
+	_free_event_transfer (priv);
+}
+
+/* Closes the USB device handle, and opens it again, typically after a disconnection. The device is looked up using
+ * its vendor, product and serial number or its GUID, which also checks its identity. */
+
+static gboolean
+_reopen_usb_device (ArvUvDevice *uv_device, GError **error)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	int result;
+	guint i;
+
+	if (priv->usb_device != NULL) {
+		libusb_release_interface (priv->usb_device, priv->control_interface);
+		for (i = 0; i < priv->n_data_interfaces; i++)
+			libusb_release_interface (priv->usb_device, priv->data_interfaces[i]);
+		libusb_close (priv->usb_device);
+		priv->usb_device = NULL;
+	}
+
+	priv->n_data_interfaces = 0;
+	priv->has_event_interface = FALSE;
+
+	if (!_open_usb_device (uv_device, error))
+		return FALSE;
+
+	result = libusb_claim_interface (priv->usb_device, priv->control_interface);
+	for (i = 0; i < priv->n_data_interfaces && result == 0; i++)
+		result = libusb_claim_interface (priv->usb_device, priv->data_interfaces[i]);
+	if (result != 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Failed to claim USB interface to '%s-%s-%s-%s': %s",
+			     priv->vendor, priv->product, priv->serial_number, priv->guid,
+			     libusb_error_name (result));
+		return FALSE;
+	}
+
+	for (i = 0; i < priv->n_data_interfaces; i++)
+		reset_endpoint (priv->usb_device, priv->data_endpoints[i], LIBUSB_ENDPOINT_IN);
+
+	return TRUE;
+}
+
+/* Reopens the device after a disconnection, keeping the Genicam data, and restarts the streams and the event
+ * channel */
+
+static gboolean
+arv_uv_device_reconnect (ArvDevice *device, GError **error)
+{
+	ArvUvDevice *uv_device = ARV_UV_DEVICE (device);
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	GPtrArray *streams;
+	GError *local_error = NULL;
+	gboolean restart_event_channel;
+	gboolean success;
+	gint64 start_time_us;
+	guint i;
+
+	if (priv->usb == NULL || !ARV_IS_GC (priv->genicam)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED,
+			     "Device not initialized");
+		return FALSE;
+	}
+
+	start_time_us = g_get_monotonic_time ();
+
+	streams = arv_device_dup_streams (device);
+	for (i = 0; i < streams->len; i++)
+		if (ARV_IS_UV_STREAM (g_ptr_array_index (streams, i)))
+			arv_uv_stream_suspend (g_ptr_array_index (streams, i));
+
+	restart_event_channel = priv->event_transfer != NULL;
+	arv_uv_device_stop_event_channel (device);
+
+	g_mutex_lock (&priv->transfer_mutex);
+	success = _reopen_usb_device (uv_device, &local_error);
+	priv->disconnected = !success;
+	g_mutex_unlock (&priv->transfer_mutex);
+
+	if (!success) {
+		g_propagate_prefixed_error (error, local_error, "[UvDevice::reconnect] ");
+		g_ptr_array_unref (streams);
+		return FALSE;
+	}
+
+	/* The device may have been power cycled */
+	arv_gc_invalidate_register_caches (priv->genicam);
+
+	for (i = 0; i < streams->len; i++)
+		if (ARV_IS_UV_STREAM (g_ptr_array_index (streams, i)))
+			arv_uv_stream_resume (g_ptr_array_index (streams, i));
+
+	g_ptr_array_unref (streams);
+
+	if (restart_event_channel && !arv_uv_device_start_event_channel (device, &local_error)) {
+		arv_warning_device ("[UvDevice::reconnect] Failed to restart the event channel: %s",
+				    local_error->message);
+		g_clear_error (&local_error);
+	}
+
+	arv_info_device ("[UvDevice::reconnect] Reconnected in %" G_GINT64_FORMAT " µs",
+			 g_get_monotonic_time () - start_time_us);
+
+	return TRUE;
+}
+
 /**
  * arv_uv_device_set_usb_mode:
  * @uv_device: a #ArvUvDevice
@@ -909,10 +1601,13 @@ arv_uv_device_constructed (GObject *object)
 	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
 	GError *error = NULL;
         int result;
+	guint i;
 
         G_OBJECT_CLASS (arv_uv_device_parent_class)->constructed (object);
 
         g_mutex_init (&priv->transfer_mutex);
+	g_mutex_init (&priv->event_mutex);
+	g_cond_init (&priv->event_cond);
 
 	result = libusb_init (&priv->usb);
         if (result != 0) {
@@ -942,20 +1637,19 @@ arv_uv_device_constructed (GObject *object)
 
 	arv_info_device("[UvDevice::new] Using control endpoint %d, interface %d",
 			 priv->control_endpoint, priv->control_interface);
-	arv_info_device("[UvDevice::new] Using data endpoint %d, interface %d",
-			 priv->data_endpoint, priv->data_interface);
+	for (i = 0; i < priv->n_data_interfaces; i++)
+		arv_info_device("[UvDevice::new] Using data endpoint %d, interface %d",
+				 priv->data_endpoints[i], priv->data_interfaces[i]);
 
-        result = libusb_claim_interface (priv->usb_device, priv->control_interface);
-        if (result != 0) {
-                arv_device_take_init_error (ARV_DEVICE (uv_device),
+	if (priv->n_data_interfaces == 0) {
+		arv_device_take_init_error (ARV_DEVICE (uv_device),
                                             g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
-                                                         "Failed to claim USB interface to '%s-%s-%s-%s': %s",
-                                                         priv->vendor, priv->product, priv->serial_number, priv->guid,
-                                                         libusb_error_name (result)));
+                                                         "No streaming interface found for '%s-%s-%s-%s'",
+                                                         priv->vendor, priv->product, priv->serial_number, priv->guid));
                 return;
-        }
+	}
 
-        result = libusb_claim_interface (priv->usb_device, priv->data_interface);
+        result = libusb_claim_interface (priv->usb_device, priv->control_interface);
         if (result != 0) {
                 arv_device_take_init_error (ARV_DEVICE (uv_device),
                                             g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
@@ -965,6 +1659,18 @@ arv_uv_device_constructed (GObject *object)
                 return;
         }
 
+	for (i = 0; i < priv->n_data_interfaces; i++) {
+		result = libusb_claim_interface (priv->usb_device, priv->data_interfaces[i]);
+		if (result != 0) {
+			arv_device_take_init_error (ARV_DEVICE (uv_device),
+						    g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+								 "Failed to claim USB interface to '%s-%s-%s-%s': %s",
+								 priv->vendor, priv->product, priv->serial_number,
+								 priv->guid, libusb_error_name (result)));
+			return;
+		}
+	}
+
 	if ( !_bootstrap (uv_device)){
 		arv_device_take_init_error (ARV_DEVICE (uv_device),
                                             g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
@@ -981,7 +1687,8 @@ arv_uv_device_constructed (GObject *object)
                 return;
         }
 
-        reset_endpoint (priv->usb_device, priv->data_endpoint, LIBUSB_ENDPOINT_IN);
+	for (i = 0; i < priv->n_data_interfaces; i++)
+		reset_endpoint (priv->usb_device, priv->data_endpoints[i], LIBUSB_ENDPOINT_IN);
 
         libusb_hotplug_register_callback (priv->usb, LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT, 0,
                                           LIBUSB_HOTPLUG_MATCH_ANY,
@@ -1005,6 +1712,19 @@ arv_uv_device_init (ArvUvDevice *uv_device)
 	priv->cmd_packet_size_max = 65536 + sizeof (ArvUvcpHeader);
 	priv->ack_packet_size_max = 65536 + sizeof (ArvUvcpHeader);
 	priv->disconnected = FALSE;
+
+	priv->cmd_transfer = libusb_alloc_transfer (0);
+	priv->ack_transfer = libusb_alloc_transfer (0);
+	priv->ack_buffer = g_malloc (priv->ack_packet_size_max);
+}
+
+static void
+arv_uv_device_dispose (GObject *object)
+{
+	/* The event signals can't be emitted during the finalization */
+	arv_uv_device_stop_event_channel (ARV_DEVICE (object));
+
+	G_OBJECT_CLASS (arv_uv_device_parent_class)->dispose (object);
 }
 
 static void
@@ -1013,6 +1733,7 @@ arv_uv_device_finalize (GObject *object)
 	ArvUvDevice *uv_device = ARV_UV_DEVICE (object);
 
 	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	guint i;
 
         libusb_hotplug_deregister_callback (priv->usb, priv->hotplug_cb_handle);
 
@@ -1028,12 +1749,18 @@ arv_uv_device_finalize (GObject *object)
 	g_clear_pointer (&priv->genicam_xml, g_free);
 	if (priv->usb_device != NULL) {
 		libusb_release_interface (priv->usb_device, priv->control_interface);
-		libusb_release_interface (priv->usb_device, priv->data_interface);
+		for (i = 0; i < priv->n_data_interfaces; i++)
+			libusb_release_interface (priv->usb_device, priv->data_interfaces[i]);
 		libusb_close (priv->usb_device);
 	}
         if (priv->usb != NULL)
                 libusb_exit (priv->usb);
+	libusb_free_transfer (priv->cmd_transfer);
+	libusb_free_transfer (priv->ack_transfer);
+	g_clear_pointer (&priv->ack_buffer, g_free);
         g_mutex_clear (&priv->transfer_mutex);
+	g_mutex_clear (&priv->event_mutex);
+	g_cond_clear (&priv->event_cond);
 
 	G_OBJECT_CLASS (arv_uv_device_parent_class)->finalize (object);
 }
@@ -1073,6 +1800,7 @@ arv_uv_device_class_init (ArvUvDeviceClass *uv_device_class)
 	GObjectClass *object_class = G_OBJECT_CLASS (uv_device_class);
 	ArvDeviceClass *device_class = ARV_DEVICE_CLASS (uv_device_class);
 
+	object_class->dispose = arv_uv_device_dispose;
 	object_class->finalize = arv_uv_device_finalize;
 	object_class->constructed = arv_uv_device_constructed;
 	object_class->set_property = arv_uv_device_set_property;
@@ -1084,6 +1812,11 @@ arv_uv_device_class_init (ArvUvDeviceClass *uv_device_class)
 	device_class->write_memory = arv_uv_device_write_memory;
 	device_class->read_register = arv_uv_device_read_register;
 	device_class->write_register = arv_uv_device_write_register;
+	device_class->read_registers = arv_uv_device_read_registers;
+	device_class->write_registers = arv_uv_device_write_registers;
+	device_class->start_event_channel = arv_uv_device_start_event_channel;
+	device_class->stop_event_channel = arv_uv_device_stop_event_channel;
+	device_class->reconnect = arv_uv_device_reconnect;
 
 	g_object_class_install_property
 		(object_class,
@@ -42,6 +42,11 @@ ARV_API ArvDevice * 	arv_uv_device_new_from_guid	(const char *guid, GError **err
 
 ARV_API void 		arv_uv_device_set_usb_mode	(ArvUvDevice *uv_device, ArvUvUsbMode usb_mode);
 
+ARV_API guint		arv_uv_device_get_n_stream_channels	(ArvUvDevice *uv_device);
+ARV_API ArvStream *	arv_uv_device_create_stream_for_channel	(ArvUvDevice *uv_device, guint stream_channel,
+								 ArvStreamCallback callback, void *user_data,
+								 GDestroyNotify destroy, GError **error);
+
 G_END_DECLS
 
 #endif
@@ -33,23 +33,34 @@
 
 G_BEGIN_DECLS
 
+/* USB 3 allows up to 5 hub tiers, USB 2 up to 7 */
+#define ARV_UV_DEVICE_MAX_PORT_DEPTH	7
+
 typedef enum {
 	ARV_UV_ENDPOINT_CONTROL,
 	ARV_UV_ENDPOINT_DATA
 } ArvUvEndpointType;
 
 gboolean        arv_uv_device_bulk_transfer             (ArvUvDevice *uv_device,
-							 ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
+							 ArvUvEndpointType endpoint_type, guint stream_channel,
+							 unsigned char endpoint_flags,
 							 void *data, size_t size, size_t *transferred_size,
 							 guint32 timeout_ms, GError **error);
 
 void            arv_uv_device_fill_bulk_transfer        (struct libusb_transfer* transfer, ArvUvDevice *uv_device,
-                                                         ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
-                                                         void *data, size_t size,
+                                                         ArvUvEndpointType endpoint_type, guint stream_channel,
+                                                         unsigned char endpoint_flags, void *data, size_t size,
                                                          libusb_transfer_cb_fn callback, void* callback_data,
                                                          unsigned int timeout);
 
 gboolean        arv_uv_device_is_connected              (ArvUvDevice *uv_device);
+int             arv_uv_device_get_speed                 (ArvUvDevice *uv_device);
+int             arv_uv_device_get_topology              (ArvUvDevice *uv_device, guint8 *bus_number,
+                                                         guint8 *port_numbers, int max_depth);
+guint64         arv_uv_device_get_sirm_offset           (ArvUvDevice *uv_device, guint stream_channel);
+
+void *          arv_uv_device_dev_mem_alloc             (ArvUvDevice *uv_device, size_t size);
+void            arv_uv_device_dev_mem_free              (ArvUvDevice *uv_device, void *data, size_t size);
 
 G_END_DECLS
 
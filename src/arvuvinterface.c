@@ -109,7 +109,17 @@ arv_uv_interface_device_infos_unref (ArvUvInterfaceDeviceInfos *infos)
 
 typedef struct {
 	GHashTable *devices;
+	GMutex devices_mutex;	/* protects devices, which is only locked for lookups when opening a device */
 	libusb_context *usb;
+
+	GHashTable *usb_devices;	/* libusb_device -> cached ArvUvInterfaceDeviceInfos, NULL for other devices */
+	GMutex registry_mutex;		/* serializes the usb_devices updates */
+
+	libusb_hotplug_callback_handle hotplug_handle;
+	GQueue hotplug_events;
+	GMutex hotplug_mutex;		/* protects hotplug_events */
+	GThread *hotplug_thread;
+	gint hotplug_thread_run;
 } ArvUvInterfacePrivate;
 
 struct _ArvUvInterface {
@@ -161,10 +171,12 @@ printdev (libusb_device *device)
 }
 #endif
 
-static ArvInterfaceDeviceIds *
-_usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
+/* Reads the descriptors and the strings of a USB device, returns NULL if it is not a USB3Vision device */
+
+static ArvUvInterfaceDeviceInfos *
+_usb_device_to_device_infos (libusb_device *device)
 {
-	ArvInterfaceDeviceIds *device_ids = NULL;
+	ArvUvInterfaceDeviceInfos *device_infos = NULL;
 	libusb_device_handle *device_handle;
 	struct libusb_device_descriptor desc;
 	struct libusb_config_descriptor *config;
@@ -215,15 +227,12 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 
         result = libusb_open (device, &device_handle);
 	if (result == LIBUSB_SUCCESS) {
-		ArvUvInterfaceDeviceInfos *device_infos;
 		unsigned char *manufacturer;
 		unsigned char *product;
 		unsigned char *serial_nbr;
 		unsigned char *guid;
 		int index;
 
-		device_ids = g_new0 (ArvInterfaceDeviceIds, 1);
-
 		manufacturer = g_malloc0 (256);
 		product = g_malloc0 (256);
 		serial_nbr = g_malloc0 (256);
@@ -244,23 +253,6 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 
 		device_infos = arv_uv_interface_device_infos_new ((char *) manufacturer, (char *) product,
                                                                   (char *) serial_nbr, (char *) guid);
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->id,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->name,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->full_name,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->guid,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		arv_uv_interface_device_infos_unref (device_infos);
-
-		device_ids->device = g_strdup (device_infos->id);
-		device_ids->physical = g_strdup (device_infos->guid);
-		device_ids->address = g_strdup ("USB3");	/* FIXME */
-		device_ids->vendor = g_strdup (device_infos->manufacturer);
-                device_ids->manufacturer_info = g_strdup ("none");
-		device_ids->model = g_strdup (device_infos->product);
-		device_ids->serial_nbr = g_strdup (device_infos->serial_nbr);
 
 		g_free (manufacturer);
 		g_free (product);
@@ -272,65 +264,305 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 		arv_warning_interface ("Failed to open USB device: %s",
 				       libusb_error_name (result));
 
+	return device_infos;
+}
+
+static ArvInterfaceDeviceIds *
+_device_infos_to_device_ids (ArvUvInterfaceDeviceInfos *device_infos)
+{
+	ArvInterfaceDeviceIds *device_ids;
+
+	device_ids = g_new0 (ArvInterfaceDeviceIds, 1);
+
+	device_ids->device = g_strdup (device_infos->id);
+	device_ids->physical = g_strdup (device_infos->guid);
+	device_ids->address = g_strdup ("USB3");	/* FIXME */
+	device_ids->vendor = g_strdup (device_infos->manufacturer);
+	device_ids->manufacturer_info = g_strdup ("none");
+	device_ids->model = g_strdup (device_infos->product);
+	device_ids->serial_nbr = g_strdup (device_infos->serial_nbr);
+
 	return device_ids;
 }
 
 static void
-_discover (ArvUvInterface *uv_interface,  GArray *device_ids)
+_usb_device_infos_free (ArvUvInterfaceDeviceInfos *device_infos)
+{
+	/* Non USB3Vision devices are cached with NULL infos */
+	if (device_infos != NULL)
+		arv_uv_interface_device_infos_unref (device_infos);
+}
+
+/* Adds a USB device to the cache, with its strings if it is a USB3Vision device. The descriptors of an already
+ * known device are not read again. Must be called with registry_mutex locked. Returns the id of a new USB3Vision
+ * device, NULL otherwise. */
+
+static char *
+_usb_device_added (ArvUvInterface *uv_interface, libusb_device *device)
+{
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
+	ArvUvInterfaceDeviceInfos *device_infos;
+
+	if (g_hash_table_contains (priv->usb_devices, device))
+		return NULL;
+
+	device_infos = _usb_device_to_device_infos (device);
+	g_hash_table_insert (priv->usb_devices, libusb_ref_device (device), device_infos);
+
+	if (device_infos == NULL)
+		return NULL;
+
+	g_mutex_lock (&priv->devices_mutex);
+	g_hash_table_replace (priv->devices, device_infos->id, arv_uv_interface_device_infos_ref (device_infos));
+	g_hash_table_replace (priv->devices, device_infos->name, arv_uv_interface_device_infos_ref (device_infos));
+	g_hash_table_replace (priv->devices, device_infos->full_name, arv_uv_interface_device_infos_ref (device_infos));
+	g_hash_table_replace (priv->devices, device_infos->guid, arv_uv_interface_device_infos_ref (device_infos));
+	g_mutex_unlock (&priv->devices_mutex);
+
+	return g_strdup (device_infos->id);
+}
+
+/* Must be called with registry_mutex locked. Returns the id of the removed USB3Vision device, NULL otherwise. */
+
+static char *
+_usb_device_removed (ArvUvInterface *uv_interface, libusb_device *device)
+{
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
+	ArvUvInterfaceDeviceInfos *device_infos = NULL;
+	char *device_id = NULL;
+
+	if (!g_hash_table_lookup_extended (priv->usb_devices, device, NULL, (gpointer *) &device_infos))
+		return NULL;
+
+	if (device_infos != NULL) {
+		GHashTableIter iter;
+		gpointer value;
+
+		device_id = g_strdup (device_infos->id);
+
+		g_mutex_lock (&priv->devices_mutex);
+		g_hash_table_iter_init (&iter, priv->devices);
+		while (g_hash_table_iter_next (&iter, NULL, &value))
+			if (value == device_infos)
+				g_hash_table_iter_remove (&iter);
+		g_mutex_unlock (&priv->devices_mutex);
+	}
+
+	g_hash_table_remove (priv->usb_devices, device);
+
+	return device_id;
+}
+
+static void
+_emit_device_signals (ArvUvInterface *uv_interface, GPtrArray *added, GPtrArray *removed)
 {
+	guint i;
+
+	for (i = 0; i < removed->len; i++) {
+		arv_info_interface ("[UvInterface::discover] Device '%s' removed", (char *) removed->pdata[i]);
+		arv_interface_emit_device_removed_signal (ARV_INTERFACE (uv_interface), removed->pdata[i]);
+	}
+	for (i = 0; i < added->len; i++) {
+		arv_info_interface ("[UvInterface::discover] Device '%s' added", (char *) added->pdata[i]);
+		arv_interface_emit_device_added_signal (ARV_INTERFACE (uv_interface), added->pdata[i]);
+	}
+}
+
+/* Full bus scan, used when hotplug notifications are not available. Only the new USB devices are opened for the
+ * string descriptor retrieval. */
+
+static void
+_discover (ArvUvInterface *uv_interface)
+{
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
 	libusb_device **devices;
-	unsigned uv_count = 0;
+	GHashTable *present;
+	GHashTableIter iter;
+	GPtrArray *added;
+	GPtrArray *removed;
+	GPtrArray *stale;
+	gpointer key;
 	ssize_t result;
+	unsigned uv_count = 0;
 	unsigned i;
 
-        if (uv_interface->priv->usb == NULL)
+        if (priv->usb == NULL)
                 return;
 
-	result = libusb_get_device_list(uv_interface->priv->usb, &devices);
+	result = libusb_get_device_list(priv->usb, &devices);
 	if (result < 0) {
 		arv_warning_interface ("Failed to get USB device list: %s",
 				       libusb_error_name (result));
 		return;
 	}
 
-	g_hash_table_remove_all (uv_interface->priv->devices);
+	added = g_ptr_array_new_with_free_func (g_free);
+	removed = g_ptr_array_new_with_free_func (g_free);
+	stale = g_ptr_array_new ();
+	present = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	g_mutex_lock (&priv->registry_mutex);
 
 	for (i = 0; i < result; i++) {
-		ArvInterfaceDeviceIds *ids;
-
-		ids = _usb_device_to_device_ids (uv_interface, devices[i]);
-		if (ids != NULL) {
-		    uv_count++;
-		    if (device_ids != NULL)
-			    g_array_append_val (device_ids, ids);
-		    else {
-			    g_free (ids->device);
-			    g_free (ids->physical);
-			    g_free (ids->address);
-			    g_free (ids->vendor);
-                            g_free (ids->manufacturer_info);
-			    g_free (ids->model);
-			    g_free (ids->serial_nbr);
-			    g_free (ids);
-		    }
-		}
+		char *device_id;
+
+		g_hash_table_add (present, devices[i]);
+
+		device_id = _usb_device_added (uv_interface, devices[i]);
+		if (device_id != NULL)
+			g_ptr_array_add (added, device_id);
+
+		if (g_hash_table_lookup (priv->usb_devices, devices[i]) != NULL)
+			uv_count++;
+	}
+
+	g_hash_table_iter_init (&iter, priv->usb_devices);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+		if (!g_hash_table_contains (present, key))
+			g_ptr_array_add (stale, key);
+
+	for (i = 0; i < stale->len; i++) {
+		char *device_id;
+
+		device_id = _usb_device_removed (uv_interface, stale->pdata[i]);
+		if (device_id != NULL)
+			g_ptr_array_add (removed, device_id);
 	}
 
 	arv_info_interface ("Found %d USB3Vision device%s (among %" G_GSSIZE_FORMAT " USB device%s)",
 			     uv_count , uv_count > 1 ? "s" : "",
 			     result, result > 1 ? "s" : "");
 
+	g_mutex_unlock (&priv->registry_mutex);
+
+	_emit_device_signals (uv_interface, added, removed);
+
+	g_hash_table_unref (present);
+	g_ptr_array_unref (stale);
+	g_ptr_array_unref (added);
+	g_ptr_array_unref (removed);
+
 	libusb_free_device_list (devices, 1);
 }
 
+typedef struct {
+	libusb_device *device;
+	libusb_hotplug_event event;
+} ArvUvInterfaceHotplugEvent;
+
+/* Called from libusb event handling, which forbids synchronous transfers. The events are only queued here, the
+ * string descriptors are read by _process_hotplug_events. */
+
+static int
+_hotplug_event (libusb_context *ctx, libusb_device *device, libusb_hotplug_event event, void *user_data)
+{
+	ArvUvInterfacePrivate *priv = ARV_UV_INTERFACE (user_data)->priv;
+	ArvUvInterfaceHotplugEvent *hotplug_event;
+
+	hotplug_event = g_new (ArvUvInterfaceHotplugEvent, 1);
+	hotplug_event->device = libusb_ref_device (device);
+	hotplug_event->event = event;
+
+	g_mutex_lock (&priv->hotplug_mutex);
+	g_queue_push_tail (&priv->hotplug_events, hotplug_event);
+	g_mutex_unlock (&priv->hotplug_mutex);
+
+	return 0;
+}
+
+static void
+_process_hotplug_events (ArvUvInterface *uv_interface)
+{
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
+	ArvUvInterfaceHotplugEvent *hotplug_event;
+	GPtrArray *added;
+	GPtrArray *removed;
+
+	added = g_ptr_array_new_with_free_func (g_free);
+	removed = g_ptr_array_new_with_free_func (g_free);
+
+	g_mutex_lock (&priv->registry_mutex);
+
+	do {
+		g_mutex_lock (&priv->hotplug_mutex);
+		hotplug_event = g_queue_pop_head (&priv->hotplug_events);
+		g_mutex_unlock (&priv->hotplug_mutex);
+
+		if (hotplug_event != NULL) {
+			char *device_id;
+
+			if (hotplug_event->event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+				device_id = _usb_device_added (uv_interface, hotplug_event->device);
+				if (device_id != NULL)
+					g_ptr_array_add (added, device_id);
+			} else {
+				device_id = _usb_device_removed (uv_interface, hotplug_event->device);
+				if (device_id != NULL)
+					g_ptr_array_add (removed, device_id);
+			}
+
+			libusb_unref_device (hotplug_event->device);
+			g_free (hotplug_event);
+		}
+	} while (hotplug_event != NULL);
+
+	g_mutex_unlock (&priv->registry_mutex);
+
+	_emit_device_signals (uv_interface, added, removed);
+
+	g_ptr_array_unref (added);
+	g_ptr_array_unref (removed);
+}
+
+static void *
+_hotplug_thread (void *data)
+{
+	ArvUvInterface *uv_interface = data;
+	struct timeval tv = { 0, 100000 };
+
+	while (g_atomic_int_get (&uv_interface->priv->hotplug_thread_run)) {
+		libusb_handle_events_timeout (uv_interface->priv->usb, &tv);
+		_process_hotplug_events (uv_interface);
+	}
+
+	return NULL;
+}
+
+static void
+_update_registry (ArvUvInterface *uv_interface)
+{
+	if (uv_interface->priv->hotplug_thread != NULL)
+		_process_hotplug_events (uv_interface);
+	else
+		_discover (uv_interface);
+}
+
 static void
 arv_uv_interface_update_device_list (ArvInterface *interface, GArray *device_ids)
 {
 	ArvUvInterface *uv_interface = ARV_UV_INTERFACE (interface);
+	GHashTableIter iter;
+	gpointer key, value;
 
 	g_assert (device_ids->len == 0);
 
-	_discover (uv_interface, device_ids);
+	_update_registry (uv_interface);
+
+	g_mutex_lock (&uv_interface->priv->devices_mutex);
+
+	g_hash_table_iter_init (&iter, uv_interface->priv->devices);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		ArvUvInterfaceDeviceInfos *infos = value;
+
+		if (g_strcmp0 (key, infos->id) == 0) {
+			ArvInterfaceDeviceIds *ids;
+
+			ids = _device_infos_to_device_ids (infos);
+			g_array_append_val (device_ids, ids);
+		}
+	}
+
+	g_mutex_unlock (&uv_interface->priv->devices_mutex);
 }
 
 static ArvDevice *
@@ -338,9 +570,15 @@ _open_device (ArvInterface *interface, const char *device_id, GError **error)
 {
 	ArvUvInterface *uv_interface;
 	ArvUvInterfaceDeviceInfos *device_infos;
+	ArvDevice *device;
+	char *guid = NULL;
 
 	uv_interface = ARV_UV_INTERFACE (interface);
 
+	/* The device instantiation is done outside of the lock, allowing the concurrent opening of several devices */
+
+	g_mutex_lock (&uv_interface->priv->devices_mutex);
+
 	if (device_id == NULL) {
 		GList *device_list;
 
@@ -350,10 +588,19 @@ _open_device (ArvInterface *interface, const char *device_id, GError **error)
 	} else
 		device_infos = g_hash_table_lookup (uv_interface->priv->devices, device_id);
 
-	if (device_infos == NULL)
+	if (device_infos != NULL)
+		guid = g_strdup (device_infos->guid);
+
+	g_mutex_unlock (&uv_interface->priv->devices_mutex);
+
+	if (guid == NULL)
 		return NULL;
 
-	return arv_uv_device_new_from_guid (device_infos->guid, error);
+	device = arv_uv_device_new_from_guid (guid, error);
+
+	g_free (guid);
+
+	return device;
 }
 
 static ArvDevice *
@@ -369,7 +616,7 @@ arv_uv_interface_open_device (ArvInterface *interface, const char *device_id, GE
 		return device;
 	}
 
-	_discover (ARV_UV_INTERFACE (interface), NULL);
+	_update_registry (ARV_UV_INTERFACE (interface));
 
 	return _open_device (interface, device_id, error);
 }
@@ -424,14 +671,74 @@ arv_uv_interface_init (ArvUvInterface *uv_interface)
 
 	uv_interface->priv->devices = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
 							     (GDestroyNotify) arv_uv_interface_device_infos_unref);
+	g_mutex_init (&uv_interface->priv->devices_mutex);
+
+	uv_interface->priv->usb_devices = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+								 (GDestroyNotify) libusb_unref_device,
+								 (GDestroyNotify) _usb_device_infos_free);
+	g_mutex_init (&uv_interface->priv->registry_mutex);
+	g_queue_init (&uv_interface->priv->hotplug_events);
+	g_mutex_init (&uv_interface->priv->hotplug_mutex);
+
+	/* With hotplug notifications, the device list is kept up to date by the libusb events, and the string
+	 * descriptors are only read on device arrival. The already connected devices are enumerated by the
+	 * registration. */
+
+	if (uv_interface->priv->usb != NULL &&
+	    libusb_has_capability (LIBUSB_CAP_HAS_HOTPLUG)) {
+		result = libusb_hotplug_register_callback (uv_interface->priv->usb,
+							   LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+							   LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+							   LIBUSB_HOTPLUG_ENUMERATE,
+							   LIBUSB_HOTPLUG_MATCH_ANY,
+							   LIBUSB_HOTPLUG_MATCH_ANY,
+							   ARV_UV_INTERFACE_DEVICE_CLASS,
+							   _hotplug_event,
+							   uv_interface,
+							   &uv_interface->priv->hotplug_handle);
+		if (result == LIBUSB_SUCCESS) {
+			uv_interface->priv->hotplug_thread_run = 1;
+			uv_interface->priv->hotplug_thread = g_thread_new ("arv_uv_hotplug", _hotplug_thread,
+									   uv_interface);
+		} else
+			arv_warning_interface ("Failed to register USB hotplug callback: %s",
+					       libusb_error_name (result));
+	}
+}
+
+static void
+arv_uv_interface_dispose (GObject *object)
+{
+	ArvUvInterface *uv_interface = ARV_UV_INTERFACE (object);
+
+	if (uv_interface->priv->hotplug_thread != NULL) {
+		libusb_hotplug_deregister_callback (uv_interface->priv->usb, uv_interface->priv->hotplug_handle);
+
+		g_atomic_int_set (&uv_interface->priv->hotplug_thread_run, 0);
+		g_thread_join (uv_interface->priv->hotplug_thread);
+		uv_interface->priv->hotplug_thread = NULL;
+	}
+
+	G_OBJECT_CLASS (arv_uv_interface_parent_class)->dispose (object);
 }
 
 static void
 arv_uv_interface_finalize (GObject *object)
 {
 	ArvUvInterface *uv_interface = ARV_UV_INTERFACE (object);
+	ArvUvInterfaceHotplugEvent *hotplug_event;
+
+	while ((hotplug_event = g_queue_pop_head (&uv_interface->priv->hotplug_events)) != NULL) {
+		libusb_unref_device (hotplug_event->device);
+		g_free (hotplug_event);
+	}
+	g_mutex_clear (&uv_interface->priv->hotplug_mutex);
+
+	g_hash_table_unref (uv_interface->priv->usb_devices);
+	g_mutex_clear (&uv_interface->priv->registry_mutex);
 
 	g_hash_table_unref (uv_interface->priv->devices);
+	g_mutex_clear (&uv_interface->priv->devices_mutex);
 
 	G_OBJECT_CLASS (arv_uv_interface_parent_class)->finalize (object);
 
@@ -445,6 +752,7 @@ arv_uv_interface_class_init (ArvUvInterfaceClass *uv_interface_class)
 	GObjectClass *object_class = G_OBJECT_CLASS (uv_interface_class);
 	ArvInterfaceClass *interface_class = ARV_INTERFACE_CLASS (uv_interface_class);
 
+	object_class->dispose = arv_uv_interface_dispose;
 	object_class->finalize = arv_uv_interface_finalize;
 
 	interface_class->update_device_list = arv_uv_interface_update_device_list;
@@ -31,6 +31,7 @@
 #include <arvbufferprivate.h>
 #include <arvuvspprivate.h>
 #include <arvuvcpprivate.h>
+#include <arvtraceprivate.h>
 #include <arvdebug.h>
 #include <arvmisc.h>
 #include <libusb.h>
@@ -39,9 +40,31 @@
 #define ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE	(1024*1024*1)
 #define ARV_UV_STREAM_MAXIMUM_SUBMIT_TOTAL	(8*1024*1024)
 
+/* Limits of the transfer size and submit total automatic modes */
+#define ARV_UV_STREAM_AUTO_TRANSFER_SIZE_HIGH_SPEED		(256*1024)
+#define ARV_UV_STREAM_AUTO_TRANSFER_SIZE_SUPER_SPEED_PLUS	(4*1024*1024)
+#define ARV_UV_STREAM_AUTO_SUBMIT_TOTAL_MAXIMUM			(64*1024*1024)
+/* In flight data for automatic submit total, in link transfer time */
+#define ARV_UV_STREAM_AUTO_SUBMIT_TOTAL_DURATION_MS		40
+
+/* Buffer contexts allocated at stream start, and alignment of their leader and trailer packets in the slabs */
+#define ARV_UV_STREAM_MINIMUM_CONTEXTS		4
+#define ARV_UV_STREAM_SLAB_ALIGNMENT		64
+
+/* Maximum wait duration on buffer underrun, before checking again for thread cancellation */
+#define ARV_UV_STREAM_UNDERRUN_TIMEOUT_US	100000
+
+/* Transfers kept in flight in sync mode */
+#define ARV_UV_STREAM_SYNC_N_TRANSFERS		4
+
 enum {
        ARV_UV_STREAM_PROPERTY_0,
-       ARV_UV_STREAM_PROPERTY_USB_MODE
+       ARV_UV_STREAM_PROPERTY_USB_MODE,
+       ARV_UV_STREAM_PROPERTY_UNDERRUN_POLICY,
+       ARV_UV_STREAM_PROPERTY_TRANSFER_SIZE,
+       ARV_UV_STREAM_PROPERTY_TRANSFERS_PER_BUFFER,
+       ARV_UV_STREAM_PROPERTY_SUBMIT_TOTAL,
+       ARV_UV_STREAM_PROPERTY_CHANNEL
 } ArvUvStreamProperties;
 
 /* Acquisition thread */
@@ -51,6 +74,7 @@ typedef struct {
         guint64 n_failures;
         guint64 n_underruns;
         guint64 n_aborted;
+        guint64 n_recycled_buffers;
 
         guint64 n_transferred_bytes;
         guint64 n_ignored_bytes;
@@ -60,6 +84,7 @@ typedef struct {
 	ArvStream *stream;
 
 	ArvUvDevice *uv_device;
+	guint stream_channel;
 	ArvStreamCallback callback;
 	void *callback_data;
 
@@ -70,8 +95,14 @@ typedef struct {
         size_t transfer1_size;
 	size_t trailer_size;
 
+        size_t maximum_transfer_size;
+        guint maximum_transfers_per_buffer;
+        gint maximum_submit_total;
+
 	gboolean cancel;
 
+	ArvUvStreamUnderrunPolicy underrun_policy;
+
 	/* Notification for completed transfers and cancellation */
 	GMutex stream_mtx;
 	GCond stream_event;
@@ -79,12 +110,29 @@ typedef struct {
 	/* Statistics */
 	ArvStreamStatistics statistics;
 
+	/* Ring of ArvUvStreamBufferContext, kept from one stream start to the next, and the slabs of their
+	 * leader and trailer packets */
+	GPtrArray *contexts;
+	GPtrArray *context_slabs;
+	guint next_context;
+	size_t contexts_leader_size;
+	size_t contexts_payload_size;
+	size_t contexts_trailer_size;
+
+	gint total_submitted_bytes;
 } ArvUvStreamThreadData;
 
 typedef struct {
 	GThread *thread;
 	ArvUvStreamThreadData *thread_data;
 	ArvUvUsbMode usb_mode;
+	ArvUvStreamUnderrunPolicy underrun_policy;
+	guint transfer_size;
+	guint transfers_per_buffer;
+	guint submit_total;
+	guint channel;
+	/* Stream thread stopped by arv_uv_stream_suspend(), until arv_uv_stream_resume() */
+	gboolean is_suspended;
 } ArvUvStreamPrivate;
 
 struct _ArvUvStream {
@@ -105,9 +153,8 @@ typedef struct {
 	size_t total_payload_transferred;
         size_t expected_size;
 
-	guint8 *leader_buffer, *trailer_buffer;
-
 	int num_payload_transfers;
+	int num_allocated_payload_transfers;
 	struct libusb_transfer *leader_transfer, *trailer_transfer, **payload_transfers;
 
 	guint num_submitted;
@@ -115,12 +162,86 @@ typedef struct {
 	gint *total_submitted_bytes;
 
         gboolean is_aborting;
+        gboolean is_discarding;
 
 	ArvStreamStatistics *statistics;
 } ArvUvStreamBufferContext;
 
 G_DEFINE_TYPE_WITH_CODE (ArvUvStream, arv_uv_stream, ARV_TYPE_STREAM, G_ADD_PRIVATE (ArvUvStream))
 
+static guint32
+align (guint32 val, guint32 alignment)
+{
+	/* Alignment must be a power of two, otherwise the used alignment algorithm does not work. */
+	g_assert (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	return (val + (alignment - 1)) & ~(alignment - 1);
+}
+
+/* Zero-copy buffers */
+
+typedef struct {
+	ArvUvDevice *uv_device;
+	void *data;
+	size_t size;
+} ArvUvStreamDevMem;
+
+static void
+_dev_mem_free (void *data)
+{
+	ArvUvStreamDevMem *dev_mem = data;
+
+	arv_uv_device_dev_mem_free (dev_mem->uv_device, dev_mem->data, dev_mem->size);
+	g_object_unref (dev_mem->uv_device);
+	g_free (dev_mem);
+}
+
+static ArvBuffer *
+_new_buffer (ArvUvDevice *uv_device, size_t size)
+{
+	ArvUvStreamDevMem *dev_mem;
+	void *data;
+
+	data = arv_uv_device_dev_mem_alloc (uv_device, size);
+	if (data == NULL) {
+		arv_debug_stream ("Zero-copy memory not available for a %" G_GSIZE_FORMAT " bytes buffer", size);
+		return arv_buffer_new_allocate (size);
+	}
+
+	dev_mem = g_new (ArvUvStreamDevMem, 1);
+	dev_mem->uv_device = g_object_ref (uv_device);
+	dev_mem->data = data;
+	dev_mem->size = size;
+
+	return arv_buffer_new_take_data (size, data, dev_mem, _dev_mem_free);
+}
+
+/**
+ * arv_uv_stream_new_buffer:
+ * @uv_stream: a #ArvUvStream
+ * @size: buffer size, in bytes
+ *
+ * Creates a new buffer suitable for the stream of @uv_stream. When supported by the platform, the buffer memory is
+ * allocated using libusb_dev_mem_alloc(), which avoids a copy between kernel and user space for each transfer. This
+ * memory counts against the usbfs memory limit of the system, a regular buffer is returned when the allocation
+ * fails.
+ *
+ * Returns: (transfer full): a new #ArvBuffer
+ *
+ * Since: 0.8.24
+ */
+
+ArvBuffer *
+arv_uv_stream_new_buffer (ArvUvStream *uv_stream, size_t size)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+
+	g_return_val_if_fail (ARV_IS_UV_STREAM (uv_stream), NULL);
+	g_return_val_if_fail (priv->thread_data != NULL, NULL);
+
+	return _new_buffer (priv->thread_data->uv_device, size);
+}
+
 static void
 arv_uv_stream_buffer_context_wait_transfer_completed (ArvUvStreamBufferContext* ctx)
 {
@@ -129,6 +250,18 @@ arv_uv_stream_buffer_context_wait_transfer_completed (ArvUvStreamBufferContext*
 	g_mutex_unlock( ctx->transfer_completed_mtx );
 }
 
+static void
+arv_uv_stream_buffer_context_wait_idle (ArvUvStreamBufferContext* ctx, gboolean *cancel)
+{
+	gint64 end_time = g_get_monotonic_time () + ARV_UV_STREAM_UNDERRUN_TIMEOUT_US;
+
+	g_mutex_lock (ctx->transfer_completed_mtx);
+	while (g_atomic_int_get (&ctx->num_submitted) > 0 && !g_atomic_int_get (cancel))
+		if (!g_cond_wait_until (ctx->transfer_completed_event, ctx->transfer_completed_mtx, end_time))
+			break;
+	g_mutex_unlock (ctx->transfer_completed_mtx);
+}
+
 static void
 arv_uv_stream_buffer_context_notify_transfer_completed (ArvUvStreamBufferContext* ctx)
 {
@@ -143,6 +276,8 @@ void arv_uv_stream_leader_cb (struct libusb_transfer *transfer)
 	ArvUvStreamBufferContext *ctx = transfer->user_data;
 	ArvUvspPacket *packet = (ArvUvspPacket*)transfer->buffer;
 
+	ARV_TRACEPOINT (uv_transfer_complete, transfer, transfer->status, transfer->actual_length);
+
         if (ctx->buffer != NULL) {
                 if (ctx->is_aborting) {
                         ctx->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
@@ -158,6 +293,8 @@ void arv_uv_stream_leader_cb (struct libusb_transfer *transfer)
                                 }
 
                                 ctx->buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
+                                ctx->buffer->priv->first_packet_time_us = g_get_monotonic_time ();
+                                ctx->buffer->priv->last_packet_time_us = 0;
                                 ctx->buffer->priv->payload_type = arv_uvsp_packet_get_buffer_payload_type (packet);
                                 ctx->buffer->priv->chunk_endianness = G_LITTLE_ENDIAN;
                                 if (ctx->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
@@ -167,6 +304,10 @@ void arv_uv_stream_leader_cb (struct libusb_transfer *transfer)
                                                                     &ctx->buffer->priv->x_offset, &ctx->buffer->priv->y_offset);
                                         ctx->buffer->priv->pixel_format = arv_uvsp_packet_get_pixel_format (packet);
                                 }
+                                if (ctx->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE &&
+                                    arv_stream_get_compute_statistics (ctx->stream))
+                                        arv_buffer_statistics_start (ctx->buffer,
+                                                                     arv_stream_get_statistics_grid_size (ctx->stream));
                                 ctx->buffer->priv->frame_id = arv_uvsp_packet_get_frame_id (packet);
                                 ctx->buffer->priv->timestamp_ns = arv_uvsp_packet_get_timestamp (packet);
                                 break;
@@ -179,9 +320,10 @@ void arv_uv_stream_leader_cb (struct libusb_transfer *transfer)
                 }
         }
 
-	g_atomic_int_dec_and_test (&ctx->num_submitted);
 	g_atomic_int_add (ctx->total_submitted_bytes, -transfer->length);
 	ctx->statistics->n_transferred_bytes += transfer->length;
+	/* Last, the context may be reused as soon as it is idle */
+	g_atomic_int_dec_and_test (&ctx->num_submitted);
 	arv_uv_stream_buffer_context_notify_transfer_completed (ctx);
 }
 
@@ -190,12 +332,18 @@ void arv_uv_stream_payload_cb (struct libusb_transfer *transfer)
 {
 	ArvUvStreamBufferContext *ctx = transfer->user_data;
 
+	ARV_TRACEPOINT (uv_transfer_complete, transfer, transfer->status, transfer->actual_length);
+
         if (ctx->buffer != NULL) {
                 if (ctx->is_aborting) {
                         ctx->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
                 } else {
                         switch (transfer->status) {
                                 case LIBUSB_TRANSFER_COMPLETED:
+                                        /* The payload transfers of a buffer complete in order */
+                                        arv_buffer_statistics_add_block (ctx->buffer,
+                                                                         transfer->buffer - ctx->buffer->priv->data,
+                                                                         transfer->actual_length);
                                         ctx->total_payload_transferred += transfer->actual_length;
                                         break;
                                 default:
@@ -207,9 +355,9 @@ void arv_uv_stream_payload_cb (struct libusb_transfer *transfer)
                 }
         }
 
-	g_atomic_int_dec_and_test( &ctx->num_submitted );
 	g_atomic_int_add (ctx->total_submitted_bytes, -transfer->length);
 	ctx->statistics->n_transferred_bytes += transfer->length;
+	g_atomic_int_dec_and_test (&ctx->num_submitted);
 	arv_uv_stream_buffer_context_notify_transfer_completed (ctx);
 }
 
@@ -219,7 +367,13 @@ void arv_uv_stream_trailer_cb (struct libusb_transfer *transfer)
 	ArvUvStreamBufferContext *ctx = transfer->user_data;
 	ArvUvspPacket *packet = (ArvUvspPacket*)transfer->buffer;
 
-        if (ctx->buffer != NULL) {
+	ARV_TRACEPOINT (uv_transfer_complete, transfer, transfer->status, transfer->actual_length);
+
+        if (ctx->buffer != NULL && ctx->is_discarding) {
+                /* Stream owned buffer, used on underrun for keeping the transfers running */
+                ctx->statistics->n_ignored_bytes += ctx->total_payload_transferred;
+                ctx->buffer = NULL;
+        } else if (ctx->buffer != NULL) {
                 if (ctx->is_aborting) {
                         ctx->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
                         ctx->statistics->n_aborted += 1;
@@ -255,6 +409,10 @@ void arv_uv_stream_trailer_cb (struct libusb_transfer *transfer)
                                 case ARV_BUFFER_STATUS_FILLING:
                                         ctx->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
                                         ctx->buffer->priv->received_size = ctx->total_payload_transferred;
+                                        ctx->buffer->priv->last_packet_time_us = g_get_monotonic_time ();
+                                        if (arv_stream_get_unpack_pixels (ctx->stream))
+                                                arv_buffer_unpack_pixels (ctx->buffer);
+                                        arv_buffer_update_chunk_index (ctx->buffer);
                                         ctx->statistics->n_completed_buffers += 1;
                                         break;
                                 default:
@@ -263,46 +421,42 @@ void arv_uv_stream_trailer_cb (struct libusb_transfer *transfer)
                         }
                 }
 
-                arv_stream_push_output_buffer (ctx->stream, ctx->buffer);
+                ArvBuffer *buffer = ctx->buffer;
+
+                /* Release the context before the buffer can be popped again by the stream thread */
                 ctx->buffer = NULL;
+                arv_stream_push_output_buffer (ctx->stream, buffer);
         }
 
-	g_atomic_int_dec_and_test( &ctx->num_submitted );
 	g_atomic_int_add (ctx->total_submitted_bytes, -transfer->length);
 	ctx->statistics->n_transferred_bytes += transfer->length;
+	g_atomic_int_dec_and_test (&ctx->num_submitted);
 	arv_uv_stream_buffer_context_notify_transfer_completed (ctx);
 }
 
-static ArvUvStreamBufferContext*
-arv_uv_stream_buffer_context_new (ArvBuffer *buffer, ArvUvStreamThreadData *thread_data, gint *total_submitted_bytes)
+static void
+arv_uv_stream_buffer_context_bind (ArvUvStreamBufferContext* ctx, ArvBuffer *buffer,
+                                   ArvUvStreamThreadData *thread_data)
 {
-	ArvUvStreamBufferContext* ctx = g_malloc0 (sizeof(ArvUvStreamBufferContext));
-	int i;
 	size_t offset = 0;
+	int n_transfers;
+	int i;
 
-	ctx->buffer = NULL;
-	ctx->stream = thread_data->stream;
-	ctx->transfer_completed_mtx = &thread_data->stream_mtx;
-	ctx->transfer_completed_event = &thread_data->stream_event;
-
-	ctx->leader_buffer = g_malloc (thread_data->leader_size);
-	ctx->leader_transfer = libusb_alloc_transfer (0);
-	arv_uv_device_fill_bulk_transfer (ctx->leader_transfer, thread_data->uv_device,
-		ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
-		ctx->leader_buffer, thread_data->leader_size,
-		arv_uv_stream_leader_cb, ctx,
-		0);
+	n_transfers = (buffer->priv->allocated_size - 1) / thread_data->payload_size + 1;
 
-	ctx->num_payload_transfers = (buffer->priv->allocated_size - 1) / thread_data->payload_size + 1;
-	ctx->payload_transfers = g_malloc (ctx->num_payload_transfers * sizeof(struct libusb_transfer*));
+	/* The transfers are kept from one buffer to the next, only their data pointer changes */
+	if (n_transfers > ctx->num_allocated_payload_transfers) {
+		ctx->payload_transfers = g_renew (struct libusb_transfer *, ctx->payload_transfers, n_transfers);
+		for (i = ctx->num_allocated_payload_transfers; i < n_transfers; i++)
+			ctx->payload_transfers[i] = libusb_alloc_transfer (0);
+		ctx->num_allocated_payload_transfers = n_transfers;
+	}
 
-	for (i = 0; i < ctx->num_payload_transfers; ++i) {
+	for (i = 0; i < n_transfers; ++i) {
 		size_t size = MIN (thread_data->payload_size, buffer->priv->allocated_size - offset);
 
-		ctx->payload_transfers[i] = libusb_alloc_transfer(0);
-
 		arv_uv_device_fill_bulk_transfer (ctx->payload_transfers[i], thread_data->uv_device,
-			ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
+			ARV_UV_ENDPOINT_DATA, thread_data->stream_channel, LIBUSB_ENDPOINT_IN,
 			buffer->priv->data + offset, size,
 			arv_uv_stream_payload_cb, ctx,
 			0);
@@ -310,16 +464,36 @@ arv_uv_stream_buffer_context_new (ArvBuffer *buffer, ArvUvStreamThreadData *thre
 		offset += size;
 	}
 
-	ctx->trailer_buffer = g_malloc (thread_data->trailer_size);
+	ctx->num_payload_transfers = n_transfers;
+}
+
+static ArvUvStreamBufferContext*
+arv_uv_stream_buffer_context_new (ArvUvStreamThreadData *thread_data, unsigned char *leader_data,
+                                  unsigned char *trailer_data)
+{
+	ArvUvStreamBufferContext* ctx = g_malloc0 (sizeof(ArvUvStreamBufferContext));
+
+	ctx->buffer = NULL;
+	ctx->stream = thread_data->stream;
+	ctx->transfer_completed_mtx = &thread_data->stream_mtx;
+	ctx->transfer_completed_event = &thread_data->stream_event;
+
+	ctx->leader_transfer = libusb_alloc_transfer (0);
+	arv_uv_device_fill_bulk_transfer (ctx->leader_transfer, thread_data->uv_device,
+		ARV_UV_ENDPOINT_DATA, thread_data->stream_channel, LIBUSB_ENDPOINT_IN,
+		leader_data, thread_data->leader_size,
+		arv_uv_stream_leader_cb, ctx,
+		0);
+
 	ctx->trailer_transfer = libusb_alloc_transfer (0);
 	arv_uv_device_fill_bulk_transfer (ctx->trailer_transfer, thread_data->uv_device,
-		ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
-		ctx->trailer_buffer, thread_data->trailer_size,
+		ARV_UV_ENDPOINT_DATA, thread_data->stream_channel, LIBUSB_ENDPOINT_IN,
+		trailer_data, thread_data->trailer_size,
 		arv_uv_stream_trailer_cb, ctx,
 		0);
 
 	ctx->num_submitted = 0;
-	ctx->total_submitted_bytes = total_submitted_bytes;
+	ctx->total_submitted_bytes = &thread_data->total_submitted_bytes;
 	ctx->statistics = &thread_data->statistics;
 
 	return ctx;
@@ -332,31 +506,137 @@ arv_uv_stream_buffer_context_free (gpointer data)
 	int i;
 
 	g_return_if_fail (ctx->num_submitted == 0);
+	g_return_if_fail (ctx->buffer == NULL);
 
 	libusb_free_transfer (ctx->leader_transfer);
-	for (i = 0; i < ctx->num_payload_transfers; ++i) {
+	for (i = 0; i < ctx->num_allocated_payload_transfers; ++i) {
 		libusb_free_transfer (ctx->payload_transfers[i]);
 	}
 	libusb_free_transfer (ctx->trailer_transfer );
 
-	g_free (ctx->leader_buffer);
         g_free (ctx->payload_transfers);
-	g_free (ctx->trailer_buffer);
 
+	g_free (ctx);
+}
+
+static void
+arv_uv_stream_buffer_context_release (ArvUvStreamBufferContext* ctx)
+{
         if (ctx->buffer != NULL) {
                 ctx->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
-                arv_stream_push_output_buffer (ctx->stream, ctx->buffer);
+                if (!ctx->is_discarding)
+                        arv_stream_push_output_buffer (ctx->stream, ctx->buffer);
                 ctx->buffer = NULL;
         }
+}
 
-	g_free (ctx);
+/* Inserts @n_contexts new contexts in the context ring at @position, with their leader and trailer packets in a
+ * single slab buffer */
+
+static void
+_add_buffer_contexts (ArvUvStreamThreadData *thread_data, guint n_contexts, guint position)
+{
+	ArvBuffer *slab;
+	size_t leader_stride;
+	size_t trailer_stride;
+	guint i;
+
+	leader_stride = align (thread_data->leader_size, ARV_UV_STREAM_SLAB_ALIGNMENT);
+	trailer_stride = align (thread_data->trailer_size, ARV_UV_STREAM_SLAB_ALIGNMENT);
+
+	slab = _new_buffer (thread_data->uv_device, n_contexts * (leader_stride + trailer_stride));
+	g_ptr_array_add (thread_data->context_slabs, slab);
+
+	for (i = 0; i < n_contexts; i++) {
+		ArvUvStreamBufferContext *ctx;
+
+		ctx = arv_uv_stream_buffer_context_new (thread_data,
+							slab->priv->data + i * leader_stride,
+							slab->priv->data + n_contexts * leader_stride +
+							i * trailer_stride);
+		g_ptr_array_insert (thread_data->contexts, position + i, ctx);
+	}
+
+	arv_debug_stream ("%u buffer contexts allocated (%u total)", n_contexts, thread_data->contexts->len);
+}
+
+static void
+_clear_buffer_contexts (ArvUvStreamThreadData *thread_data)
+{
+	g_clear_pointer (&thread_data->contexts, g_ptr_array_unref);
+	g_clear_pointer (&thread_data->context_slabs, g_ptr_array_unref);
+}
+
+/* Preallocates the buffer contexts at stream start, keeping the ones of the previous start if the transfer geometry
+ * didn't change */
+
+static void
+_prepare_buffer_contexts (ArvUvStreamThreadData *thread_data, guint n_buffers)
+{
+	if (thread_data->contexts != NULL &&
+	    (thread_data->contexts_leader_size != thread_data->leader_size ||
+	     thread_data->contexts_payload_size != thread_data->payload_size ||
+	     thread_data->contexts_trailer_size != thread_data->trailer_size))
+		_clear_buffer_contexts (thread_data);
+
+	if (thread_data->contexts == NULL) {
+		thread_data->contexts = g_ptr_array_new_with_free_func (arv_uv_stream_buffer_context_free);
+		thread_data->context_slabs = g_ptr_array_new_with_free_func (g_object_unref);
+		thread_data->contexts_leader_size = thread_data->leader_size;
+		thread_data->contexts_payload_size = thread_data->payload_size;
+		thread_data->contexts_trailer_size = thread_data->trailer_size;
+	}
+
+	n_buffers = MAX (n_buffers, ARV_UV_STREAM_MINIMUM_CONTEXTS);
+	if (thread_data->contexts->len < n_buffers)
+		_add_buffer_contexts (thread_data, n_buffers - thread_data->contexts->len, thread_data->contexts->len);
+
+	thread_data->next_context = 0;
+}
+
+/* The contexts are used in a ring, in submission order. The next context is the oldest one, and if it is still in
+ * flight, all the others are too, and the ring is grown. */
+
+static ArvUvStreamBufferContext *
+_get_next_buffer_context (ArvUvStreamThreadData *thread_data)
+{
+	ArvUvStreamBufferContext *ctx;
+
+	ctx = g_ptr_array_index (thread_data->contexts, thread_data->next_context);
+	if (g_atomic_int_get (&ctx->num_submitted) > 0) {
+		_add_buffer_contexts (thread_data, thread_data->contexts->len, thread_data->next_context);
+		ctx = g_ptr_array_index (thread_data->contexts, thread_data->next_context);
+	}
+
+	thread_data->next_context = (thread_data->next_context + 1) % thread_data->contexts->len;
+
+	return ctx;
+}
+
+static gboolean
+_is_submit_allowed (ArvUvStreamBufferContext* ctx, struct libusb_transfer* transfer,
+                    ArvUvStreamThreadData *thread_data)
+{
+        gint total_submitted_bytes = g_atomic_int_get (ctx->total_submitted_bytes);
+
+        /* Always allow at least one transfer in flight */
+        if (total_submitted_bytes == 0)
+                return TRUE;
+
+        if (total_submitted_bytes + transfer->length > thread_data->maximum_submit_total)
+                return FALSE;
+
+        return thread_data->maximum_transfers_per_buffer == 0 ||
+                g_atomic_int_get (&ctx->num_submitted) < thread_data->maximum_transfers_per_buffer;
 }
 
 static void
-_submit_transfer (ArvUvStreamBufferContext* ctx, struct libusb_transfer* transfer, gboolean* cancel)
+_submit_transfer (ArvUvStreamBufferContext* ctx, struct libusb_transfer* transfer, ArvUvStreamThreadData *thread_data)
 {
+        gboolean *cancel = &thread_data->cancel;
+
 	while (!g_atomic_int_get (cancel) &&
-               ((g_atomic_int_get(ctx->total_submitted_bytes) + transfer->length) > ARV_UV_STREAM_MAXIMUM_SUBMIT_TOTAL)) {
+               !_is_submit_allowed (ctx, transfer, thread_data)) {
 		arv_uv_stream_buffer_context_wait_transfer_completed (ctx);
 	}
 
@@ -366,6 +646,7 @@ _submit_transfer (ArvUvStreamBufferContext* ctx, struct libusb_transfer* transfe
 		switch (status)
 		{
 		case LIBUSB_SUCCESS:
+			ARV_TRACEPOINT (uv_transfer_submit, transfer, transfer->length);
 			g_atomic_int_inc (&ctx->num_submitted);
 			g_atomic_int_add (ctx->total_submitted_bytes, transfer->length);
 			return;
@@ -394,25 +675,28 @@ arv_uv_stream_buffer_context_submit (ArvUvStreamBufferContext* ctx, ArvBuffer *b
 {
 	int i;
 
+        arv_uv_stream_buffer_context_bind (ctx, buffer, thread_data);
+
         ctx->buffer = buffer;
+        ctx->is_aborting = FALSE;
         ctx->total_payload_transferred = 0;
         buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+        buffer->priv->has_chunk_index = FALSE;
 
         ctx->expected_size = thread_data->expected_size;
 
-        _submit_transfer (ctx, ctx->leader_transfer, &thread_data->cancel);
+        _submit_transfer (ctx, ctx->leader_transfer, thread_data);
 
         for (i = 0; i < ctx->num_payload_transfers; ++i) {
-                _submit_transfer (ctx, ctx->payload_transfers[i], &thread_data->cancel);
+                _submit_transfer (ctx, ctx->payload_transfers[i], thread_data);
         }
 
-        _submit_transfer (ctx, ctx->trailer_transfer, &thread_data->cancel);
+        _submit_transfer (ctx, ctx->trailer_transfer, thread_data);
 }
 
 static void
-arv_uv_stream_buffer_context_cancel (gpointer key, gpointer value, gpointer user_data)
+arv_uv_stream_buffer_context_cancel (ArvUvStreamBufferContext* ctx)
 {
-	ArvUvStreamBufferContext* ctx = value;
 	int i;
 
         ctx->is_aborting = TRUE;
@@ -436,18 +720,21 @@ arv_uv_stream_thread_async (void *data)
 {
 	ArvUvStreamThreadData *thread_data = data;
 	ArvBuffer *buffer = NULL;
-	GHashTable *ctx_lookup;
-	gint total_submitted_bytes = 0;
+	ArvBuffer *discard_buffer = NULL;
+	ArvUvStreamBufferContext *discard_ctx = NULL;
+	guint i;
 
 	arv_debug_stream_thread ("Start async USB3Vision stream thread");
 	arv_debug_stream_thread ("leader_size = %zu", thread_data->leader_size );
 	arv_debug_stream_thread ("payload_size = %zu", thread_data->payload_size );
 	arv_debug_stream_thread ("trailer_size = %zu", thread_data->trailer_size );
 
+	arv_stream_apply_thread_affinity (thread_data->stream);
+
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
 
-	ctx_lookup = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, arv_uv_stream_buffer_context_free );
+	thread_data->total_submitted_bytes = 0;
 
 	while (!g_atomic_int_get (&thread_data->cancel) &&
                arv_uv_device_is_connected (thread_data->uv_device)) {
@@ -455,28 +742,61 @@ arv_uv_stream_thread_async (void *data)
 
                 buffer = arv_stream_pop_input_buffer (thread_data->stream);
 
-		if( buffer == NULL ) {
-			thread_data->statistics.n_underruns += 1;
-                        /* NOTE: n_ignored_bytes is not accumulated because it doesn't submit next USB transfer if
-                         * buffer is shortage. It means back pressure might be hanlded by USB slave side. */
-			continue;
-		}
-
-		ctx = g_hash_table_lookup( ctx_lookup, buffer );
-		if (!ctx) {
-			arv_debug_stream_thread ("Stream buffer context not found for buffer %p, creating...", buffer);
+		if (buffer == NULL) {
+			switch (g_atomic_int_get (&thread_data->underrun_policy)) {
+				case ARV_UV_STREAM_UNDERRUN_POLICY_DROP_OLDEST:
+					buffer = arv_stream_steal_output_buffer (thread_data->stream);
+					if (buffer != NULL)
+						thread_data->statistics.n_recycled_buffers += 1;
+					break;
+				case ARV_UV_STREAM_UNDERRUN_POLICY_REUSE:
+					if (discard_buffer == NULL)
+						discard_buffer = _new_buffer (thread_data->uv_device,
+									      thread_data->expected_size);
+					if (discard_ctx != NULL && discard_ctx->is_discarding &&
+					    g_atomic_int_get (&discard_ctx->num_submitted) > 0) {
+						/* The discard buffer is still in use, any buffer pushed meanwhile will
+						 * be submitted right after it */
+						arv_uv_stream_buffer_context_wait_idle (discard_ctx, &thread_data->cancel);
+						continue;
+					}
+					buffer = discard_buffer;
+					break;
+				default:
+					break;
+			}
 
-			ctx = arv_uv_stream_buffer_context_new (buffer, thread_data, &total_submitted_bytes);
+			thread_data->statistics.n_underruns += 1;
 
-			g_hash_table_insert (ctx_lookup, buffer, ctx);
+                        /* Without any buffer, the next USB transfer is not submitted, and the back pressure is
+                         * handled by the device. Block until the application pushes a new buffer, with a timeout
+                         * for thread cancellation and device disconnection checks. */
+			while (buffer == NULL &&
+			       !g_atomic_int_get (&thread_data->cancel) &&
+			       arv_uv_device_is_connected (thread_data->uv_device))
+				buffer = arv_stream_timeout_pop_input_buffer (thread_data->stream,
+									      ARV_UV_STREAM_UNDERRUN_TIMEOUT_US);
+
+			if (buffer == NULL)
+				continue;
 		}
 
+		/* A stolen buffer may come from a context whose trailer callback is not over yet, but it is never
+		 * submitted again with the same context before its completion */
+		ctx = _get_next_buffer_context (thread_data);
+		ctx->is_discarding = buffer == discard_buffer;
+		if (ctx->is_discarding)
+			discard_ctx = ctx;
+
                 arv_uv_stream_buffer_context_submit (ctx, buffer, thread_data);
 	}
 
-	g_hash_table_foreach (ctx_lookup, arv_uv_stream_buffer_context_cancel, NULL);
+	for (i = 0; i < thread_data->contexts->len; i++)
+		arv_uv_stream_buffer_context_cancel (g_ptr_array_index (thread_data->contexts, i));
+	for (i = 0; i < thread_data->contexts->len; i++)
+		arv_uv_stream_buffer_context_release (g_ptr_array_index (thread_data->contexts, i));
 
-	g_hash_table_destroy (ctx_lookup);
+	g_clear_object (&discard_buffer);
 
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
@@ -486,175 +806,499 @@ arv_uv_stream_thread_async (void *data)
 	return NULL;
 }
 
+/* Sync mode, using a short ring of bulk transfers kept in flight, and completed in submission order. The transfers
+ * follow the leader, payload and trailer sequence of the stream interface registers, the image data going directly
+ * to the stream buffers, the leaders and trailers to small per-transfer memory. After an unexpected packet, the ring
+ * is cancelled, and transfers are submitted one at a time until the next leader. */
+
+typedef enum {
+	ARV_UV_STREAM_SYNC_TARGET_PROBE,
+	ARV_UV_STREAM_SYNC_TARGET_LEADER,
+	ARV_UV_STREAM_SYNC_TARGET_DATA,
+	ARV_UV_STREAM_SYNC_TARGET_TRAILER
+} ArvUvStreamSyncTarget;
+
+typedef struct {
+	ArvUvStreamThreadData *thread_data;
+	struct libusb_transfer *transfer;
+	ArvUvStreamSyncTarget target;
+	/* Frame buffer of a leader, data or trailer transfer, NULL if the frame is discarded */
+	ArvBuffer *buffer;
+	guint64 offset;
+	/* The data are received in the scratch memory, and copied to the frame buffer */
+	gboolean is_copied;
+	void *packet_data;
+	void *scratch_data;
+	/* Protected by stream_mtx */
+	gboolean is_completed;
+} ArvUvStreamSyncTransfer;
+
+typedef struct {
+	ArvUvStreamThreadData *thread_data;
+	ArvUvStreamSyncTransfer transfers[ARV_UV_STREAM_SYNC_N_TRANSFERS];
+	guint first_transfer;
+	guint n_submitted;
+	gboolean is_synchronized;
+
+	/* Planning of the next submissions */
+	ArvUvStreamSyncTarget next_target;
+	ArvBuffer *next_buffer;
+	guint next_data_index;
+	guint64 next_offset;
+
+	/* Buffers popped for frames whose leader was not received, used for the next frames */
+	GQueue spare_buffers;
+
+	/* Buffer being filled */
+	ArvBuffer *buffer;
+	guint64 offset;
+} ArvUvStreamSync;
+
+static void
+_sync_transfer_cb (struct libusb_transfer *transfer)
+{
+	ArvUvStreamSyncTransfer *sync_transfer = transfer->user_data;
+	ArvUvStreamThreadData *thread_data = sync_transfer->thread_data;
+
+	ARV_TRACEPOINT (uv_transfer_complete, transfer, transfer->status, transfer->actual_length);
+
+	g_mutex_lock (&thread_data->stream_mtx);
+	sync_transfer->is_completed = TRUE;
+	g_cond_broadcast (&thread_data->stream_event);
+	g_mutex_unlock (&thread_data->stream_mtx);
+}
+
+static guint
+_sync_get_n_data_transfers (ArvUvStreamThreadData *thread_data)
+{
+	return thread_data->payload_count + (thread_data->transfer1_size > 0 ? 1 : 0);
+}
+
+static void *
+_sync_get_scratch_data (ArvUvStreamSyncTransfer *sync_transfer)
+{
+	if (sync_transfer->scratch_data == NULL)
+		sync_transfer->scratch_data = g_malloc (sync_transfer->thread_data->maximum_transfer_size);
+
+	return sync_transfer->scratch_data;
+}
+
+static void
+_sync_push_buffer (ArvUvStreamThreadData *thread_data, ArvBuffer *buffer, ArvBufferStatus status)
+{
+	buffer->priv->status = status;
+	arv_stream_push_output_buffer (thread_data->stream, buffer);
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE, buffer);
+}
+
+/* Cancels the transfers in flight, and waits for their completion */
+
+static void
+_sync_cancel (ArvUvStreamSync *sync)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	guint i;
+
+	for (i = 0; i < sync->n_submitted; i++)
+		libusb_cancel_transfer (sync->transfers[(sync->first_transfer + i) %
+							ARV_UV_STREAM_SYNC_N_TRANSFERS].transfer);
+
+	g_mutex_lock (&thread_data->stream_mtx);
+	for (i = 0; i < sync->n_submitted; i++) {
+		ArvUvStreamSyncTransfer *sync_transfer;
+
+		sync_transfer = &sync->transfers[(sync->first_transfer + i) % ARV_UV_STREAM_SYNC_N_TRANSFERS];
+		while (!sync_transfer->is_completed)
+			g_cond_wait (&thread_data->stream_event, &thread_data->stream_mtx);
+
+		/* The buffer of a frame whose leader was not processed yet is used for the next frame */
+		if (sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_LEADER && sync_transfer->buffer != NULL)
+			g_queue_push_tail (&sync->spare_buffers, sync_transfer->buffer);
+	}
+	g_mutex_unlock (&thread_data->stream_mtx);
+
+	sync->first_transfer = 0;
+	sync->n_submitted = 0;
+	sync->is_synchronized = FALSE;
+	sync->next_target = ARV_UV_STREAM_SYNC_TARGET_LEADER;
+	sync->next_buffer = NULL;
+}
+
+static ArvBuffer *
+_sync_pop_buffer (ArvUvStreamSync *sync)
+{
+	ArvBuffer *buffer;
+
+	buffer = g_queue_pop_head (&sync->spare_buffers);
+	if (buffer == NULL)
+		buffer = arv_stream_pop_input_buffer (sync->thread_data->stream);
+
+	return buffer;
+}
+
+static gboolean
+_sync_submit (ArvUvStreamSync *sync)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	ArvUvStreamSyncTransfer *sync_transfer;
+	void *data;
+	size_t size;
+	int status;
+
+	sync_transfer = &sync->transfers[(sync->first_transfer + sync->n_submitted) % ARV_UV_STREAM_SYNC_N_TRANSFERS];
+	sync_transfer->buffer = NULL;
+	sync_transfer->offset = 0;
+	sync_transfer->is_copied = FALSE;
+
+	if (!sync->is_synchronized) {
+		sync_transfer->target = ARV_UV_STREAM_SYNC_TARGET_PROBE;
+		data = _sync_get_scratch_data (sync_transfer);
+		size = thread_data->maximum_transfer_size;
+	} else {
+		sync_transfer->target = sync->next_target;
+
+		switch (sync->next_target) {
+			case ARV_UV_STREAM_SYNC_TARGET_LEADER:
+				sync->next_buffer = _sync_pop_buffer (sync);
+				sync->next_data_index = 0;
+				sync->next_offset = 0;
+				sync->next_target = _sync_get_n_data_transfers (thread_data) > 0 ?
+					ARV_UV_STREAM_SYNC_TARGET_DATA : ARV_UV_STREAM_SYNC_TARGET_TRAILER;
+				data = sync_transfer->packet_data;
+				size = thread_data->leader_size;
+				break;
+			case ARV_UV_STREAM_SYNC_TARGET_DATA:
+				size = sync->next_data_index < thread_data->payload_count ?
+					thread_data->payload_size : thread_data->transfer1_size;
+				sync_transfer->offset = sync->next_offset;
+				if (sync->next_buffer != NULL &&
+				    sync->next_offset + size <= sync->next_buffer->priv->allocated_size)
+					data = sync->next_buffer->priv->data + sync->next_offset;
+				else {
+					/* The last transfer is aligned, and may not fit at the end of the buffer */
+					data = _sync_get_scratch_data (sync_transfer);
+					sync_transfer->is_copied = sync->next_buffer != NULL;
+				}
+				sync->next_offset += size;
+				sync->next_data_index++;
+				if (sync->next_data_index >= _sync_get_n_data_transfers (thread_data))
+					sync->next_target = ARV_UV_STREAM_SYNC_TARGET_TRAILER;
+				break;
+			default:
+				data = sync_transfer->packet_data;
+				size = thread_data->trailer_size;
+				sync->next_target = ARV_UV_STREAM_SYNC_TARGET_LEADER;
+				break;
+		}
+
+		sync_transfer->buffer = sync->next_buffer;
+	}
+
+	arv_uv_device_fill_bulk_transfer (sync_transfer->transfer, thread_data->uv_device,
+					  ARV_UV_ENDPOINT_DATA, thread_data->stream_channel, LIBUSB_ENDPOINT_IN,
+					  data, size, _sync_transfer_cb, sync_transfer, 0);
+	sync_transfer->is_completed = FALSE;
+
+	arv_debug_sp ("Asking for %" G_GSIZE_FORMAT " bytes", size);
+
+	status = libusb_submit_transfer (sync_transfer->transfer);
+	if (status != LIBUSB_SUCCESS) {
+		arv_warning_stream_thread ("libusb_submit_transfer failed (%d)", status);
+		if (sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_LEADER && sync_transfer->buffer != NULL)
+			g_queue_push_tail (&sync->spare_buffers, sync_transfer->buffer);
+		_sync_cancel (sync);
+		return FALSE;
+	}
+
+	ARV_TRACEPOINT (uv_transfer_submit, sync_transfer->transfer, sync_transfer->transfer->length);
+
+	sync->n_submitted++;
+
+	return TRUE;
+}
+
+/* Returns the oldest transfer, once completed, or NULL after a timeout */
+
+static ArvUvStreamSyncTransfer *
+_sync_wait (ArvUvStreamSync *sync)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	ArvUvStreamSyncTransfer *sync_transfer = &sync->transfers[sync->first_transfer];
+	gint64 end_time = g_get_monotonic_time () + ARV_UV_STREAM_UNDERRUN_TIMEOUT_US;
+	gboolean is_completed;
+
+	g_mutex_lock (&thread_data->stream_mtx);
+	while (!sync_transfer->is_completed && !g_atomic_int_get (&thread_data->cancel))
+		if (!g_cond_wait_until (&thread_data->stream_event, &thread_data->stream_mtx, end_time))
+			break;
+	is_completed = sync_transfer->is_completed;
+	g_mutex_unlock (&thread_data->stream_mtx);
+
+	if (!is_completed)
+		return NULL;
+
+	sync->first_transfer = (sync->first_transfer + 1) % ARV_UV_STREAM_SYNC_N_TRANSFERS;
+	sync->n_submitted--;
+
+	return sync_transfer;
+}
+
+static void
+_sync_process_leader (ArvUvStreamSync *sync, ArvUvStreamSyncTransfer *sync_transfer, ArvUvspPacket *packet,
+		      size_t transferred)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	ArvBuffer *buffer;
+
+	buffer = sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_LEADER ?
+		sync_transfer->buffer : _sync_pop_buffer (sync);
+
+	/* The leader may have been received in the memory of the open buffer, it is decoded before the buffer
+	 * release */
+	if (buffer != NULL) {
+		buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
+		buffer->priv->first_packet_time_us = g_get_monotonic_time ();
+		buffer->priv->last_packet_time_us = 0;
+		buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+		buffer->priv->received_size = 0;
+		buffer->priv->has_chunk_index = FALSE;
+		buffer->priv->payload_type = arv_uvsp_packet_get_buffer_payload_type (packet);
+		buffer->priv->chunk_endianness = G_LITTLE_ENDIAN;
+		if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
+		    buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_EXTENDED_CHUNK_DATA) {
+			arv_uvsp_packet_get_region (packet,
+						    &buffer->priv->width,
+						    &buffer->priv->height,
+						    &buffer->priv->x_offset,
+						    &buffer->priv->y_offset);
+			buffer->priv->pixel_format = arv_uvsp_packet_get_pixel_format (packet);
+		}
+		if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE &&
+		    arv_stream_get_compute_statistics (thread_data->stream))
+			arv_buffer_statistics_start (buffer, arv_stream_get_statistics_grid_size (thread_data->stream));
+		buffer->priv->frame_id = arv_uvsp_packet_get_frame_id (packet);
+		buffer->priv->timestamp_ns = arv_uvsp_packet_get_timestamp (packet);
+	}
+
+	if (sync->buffer != NULL) {
+		arv_info_stream_thread ("New leader received while a buffer is still open");
+		_sync_push_buffer (thread_data, sync->buffer, ARV_BUFFER_STATUS_MISSING_PACKETS);
+		thread_data->statistics.n_failures++;
+	}
+
+	sync->buffer = buffer;
+	sync->offset = 0;
+
+	if (buffer != NULL) {
+		if (thread_data->callback != NULL)
+			thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_START_BUFFER, NULL);
+		thread_data->statistics.n_transferred_bytes += transferred;
+	} else {
+		thread_data->statistics.n_underruns++;
+		thread_data->statistics.n_ignored_bytes += transferred;
+	}
+
+	/* A probed leader starts the planning of the transfers of its frame */
+	if (sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_PROBE) {
+		sync->is_synchronized = TRUE;
+		sync->next_buffer = buffer;
+		sync->next_data_index = 0;
+		sync->next_offset = 0;
+		sync->next_target = _sync_get_n_data_transfers (thread_data) > 0 ?
+			ARV_UV_STREAM_SYNC_TARGET_DATA : ARV_UV_STREAM_SYNC_TARGET_TRAILER;
+	}
+}
+
+static void
+_sync_process_trailer (ArvUvStreamSync *sync, size_t transferred)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	ArvBuffer *buffer = sync->buffer;
+
+	if (buffer == NULL)
+		return;
+
+	arv_debug_stream_thread ("Received %" G_GUINT64_FORMAT " bytes", sync->offset);
+
+	if (sync->offset != thread_data->expected_size) {
+		arv_info_stream_thread ("Incomplete image received, dropping "
+					"(received %" G_GUINT64_FORMAT " / expected %" G_GSIZE_FORMAT ")",
+					sync->offset, thread_data->expected_size);
+		_sync_push_buffer (thread_data, buffer, ARV_BUFFER_STATUS_SIZE_MISMATCH);
+		thread_data->statistics.n_failures++;
+		thread_data->statistics.n_ignored_bytes += transferred;
+	} else {
+		buffer->priv->received_size = sync->offset;
+		buffer->priv->last_packet_time_us = g_get_monotonic_time ();
+		if (arv_stream_get_unpack_pixels (thread_data->stream))
+			arv_buffer_unpack_pixels (buffer);
+		arv_buffer_update_chunk_index (buffer);
+		_sync_push_buffer (thread_data, buffer, ARV_BUFFER_STATUS_SUCCESS);
+		thread_data->statistics.n_completed_buffers++;
+		thread_data->statistics.n_transferred_bytes += transferred;
+	}
+
+	sync->buffer = NULL;
+}
+
+static void
+_sync_process_data (ArvUvStreamSync *sync, ArvUvspPacket *packet, size_t transferred)
+{
+	ArvUvStreamThreadData *thread_data = sync->thread_data;
+	ArvBuffer *buffer = sync->buffer;
+
+	if (buffer == NULL || buffer->priv->status != ARV_BUFFER_STATUS_FILLING) {
+		thread_data->statistics.n_ignored_bytes += transferred;
+		return;
+	}
+
+	if (sync->offset + transferred > buffer->priv->allocated_size) {
+		buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		thread_data->statistics.n_ignored_bytes += transferred;
+		return;
+	}
+
+	/* Copy the data received out of place, after a short transfer or in the scratch memory */
+	if ((void *) packet != buffer->priv->data + sync->offset)
+		memmove (buffer->priv->data + sync->offset, packet, transferred);
+
+	arv_buffer_statistics_add_block (buffer, sync->offset, transferred);
+	sync->offset += transferred;
+	thread_data->statistics.n_transferred_bytes += transferred;
+
+	if (thread_data->callback != NULL &&
+	    arv_stream_get_buffer_progress (thread_data->stream)) {
+		buffer->priv->received_size = sync->offset;
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_BUFFER_PROGRESS, buffer);
+	}
+}
+
+static void
+_sync_process (ArvUvStreamSync *sync, ArvUvStreamSyncTransfer *sync_transfer)
+{
+	struct libusb_transfer *transfer = sync_transfer->transfer;
+	ArvUvspPacket *packet = (ArvUvspPacket *) transfer->buffer;
+	ArvUvspPacketType packet_type;
+	ArvUvspPacketType expected_type;
+	size_t transferred = transfer->actual_length;
+
+	if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+		arv_warning_sp ("USB transfer failed: transfer->status = %d", transfer->status);
+		if (sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_LEADER && sync_transfer->buffer != NULL)
+			g_queue_push_tail (&sync->spare_buffers, sync_transfer->buffer);
+		if (sync->is_synchronized)
+			_sync_cancel (sync);
+		return;
+	}
+
+	arv_debug_sp ("Received %" G_GSIZE_FORMAT " bytes", transferred);
+	arv_uvsp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+
+	packet_type = arv_uvsp_packet_get_packet_type (packet);
+
+	switch (sync_transfer->target) {
+		case ARV_UV_STREAM_SYNC_TARGET_LEADER:
+			expected_type = ARV_UVSP_PACKET_TYPE_LEADER;
+			break;
+		case ARV_UV_STREAM_SYNC_TARGET_DATA:
+			expected_type = ARV_UVSP_PACKET_TYPE_DATA;
+			break;
+		case ARV_UV_STREAM_SYNC_TARGET_TRAILER:
+			expected_type = ARV_UVSP_PACKET_TYPE_TRAILER;
+			break;
+		default:
+			expected_type = packet_type;
+			break;
+	}
+
+	if (packet_type != expected_type) {
+		arv_info_stream_thread ("Unexpected packet type, resynchronize the transfers");
+		if (sync_transfer->target == ARV_UV_STREAM_SYNC_TARGET_LEADER && sync_transfer->buffer != NULL)
+			g_queue_push_tail (&sync->spare_buffers, sync_transfer->buffer);
+		_sync_cancel (sync);
+		sync_transfer->target = ARV_UV_STREAM_SYNC_TARGET_PROBE;
+	}
+
+	switch (packet_type) {
+		case ARV_UVSP_PACKET_TYPE_LEADER:
+			_sync_process_leader (sync, sync_transfer, packet, transferred);
+			break;
+		case ARV_UVSP_PACKET_TYPE_TRAILER:
+			_sync_process_trailer (sync, transferred);
+			break;
+		case ARV_UVSP_PACKET_TYPE_DATA:
+			_sync_process_data (sync, packet, transferred);
+			break;
+		default:
+			arv_info_stream_thread ("Unknown packet type");
+			break;
+	}
+}
+
 static void *
 arv_uv_stream_thread_sync (void *data)
 {
 	ArvUvStreamThreadData *thread_data = data;
-	ArvUvspPacket *packet;
-	ArvBuffer *buffer = NULL;
-	void *incoming_buffer;
-	guint64 offset;
-	size_t transferred;
+	ArvUvStreamSync sync = {0};
+	ArvBuffer *buffer;
+	guint i;
 
 	arv_debug_stream_thread ("Start sync USB3Vision stream thread");
 
-	incoming_buffer = g_malloc (ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE);
+	arv_stream_apply_thread_affinity (thread_data->stream);
+
+	sync.thread_data = thread_data;
+	sync.next_target = ARV_UV_STREAM_SYNC_TARGET_LEADER;
+	g_queue_init (&sync.spare_buffers);
+	for (i = 0; i < ARV_UV_STREAM_SYNC_N_TRANSFERS; i++) {
+		sync.transfers[i].thread_data = thread_data;
+		sync.transfers[i].transfer = libusb_alloc_transfer (0);
+		sync.transfers[i].packet_data = g_malloc (MAX (thread_data->leader_size, thread_data->trailer_size));
+	}
 
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
 
-	offset = 0;
+	while (!g_atomic_int_get (&thread_data->cancel) &&
+	       arv_uv_device_is_connected (thread_data->uv_device)) {
+		ArvUvStreamSyncTransfer *sync_transfer;
 
-	while (!g_atomic_int_get (&thread_data->cancel)) {
-		GError *error = NULL;
-		size_t size;
-		transferred = 0;
+		/* A single transfer in flight until synchronized on a leader */
+		while (sync.n_submitted < (sync.is_synchronized ? ARV_UV_STREAM_SYNC_N_TRANSFERS : 1) &&
+		       _sync_submit (&sync));
 
-		if (buffer == NULL)
-			size = ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE;
-		else {
-			if (offset < buffer->priv->allocated_size)
-				size = MIN (thread_data->payload_size, buffer->priv->allocated_size - offset);
-			else
-				size = thread_data->trailer_size;
+		if (sync.n_submitted == 0) {
+			g_usleep (ARV_UV_STREAM_UNDERRUN_TIMEOUT_US);
+			continue;
 		}
 
-		/* Avoid unnecessary memory copy by transferring data directly to the image buffer */
-		if (buffer != NULL &&
-		    buffer->priv->status == ARV_BUFFER_STATUS_FILLING &&
-		    offset + size <= buffer->priv->allocated_size)
-			packet = (ArvUvspPacket *) (buffer->priv->data + offset);
-		else
-			packet = incoming_buffer;
-
-		arv_debug_sp ("Asking for %" G_GSIZE_FORMAT " bytes", size);
-		arv_uv_device_bulk_transfer (thread_data->uv_device,  ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
-					     packet, size, &transferred, 0, &error);
-
-		if (error != NULL) {
-			arv_warning_sp ("USB transfer error: %s", error->message);
-			g_clear_error (&error);
-		} else {
-			ArvUvspPacketType packet_type;
-
-			arv_debug_sp ("Received %" G_GSIZE_FORMAT " bytes", transferred);
-			arv_uvsp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
-
-			packet_type = arv_uvsp_packet_get_packet_type (packet);
-			switch (packet_type) {
-				case ARV_UVSP_PACKET_TYPE_LEADER:
-					if (buffer != NULL) {
-						arv_info_stream_thread ("New leader received while a buffer is still open");
-						buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
-						arv_stream_push_output_buffer (thread_data->stream, buffer);
-						if (thread_data->callback != NULL)
-							thread_data->callback (thread_data->callback_data,
-									       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-									       buffer);
-						thread_data->statistics.n_failures++;
-						buffer = NULL;
-					}
-					buffer = arv_stream_pop_input_buffer (thread_data->stream);
-					if (buffer != NULL) {
-						buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
-						buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
-                                                buffer->priv->received_size = 0;
-						buffer->priv->payload_type = arv_uvsp_packet_get_buffer_payload_type (packet);
-						buffer->priv->chunk_endianness = G_LITTLE_ENDIAN;
-						if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
-						    buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_EXTENDED_CHUNK_DATA) {
-							arv_uvsp_packet_get_region (packet,
-										    &buffer->priv->width,
-										    &buffer->priv->height,
-										    &buffer->priv->x_offset,
-										    &buffer->priv->y_offset);
-							buffer->priv->pixel_format = arv_uvsp_packet_get_pixel_format (packet);
-						}
-						buffer->priv->frame_id = arv_uvsp_packet_get_frame_id (packet);
-						buffer->priv->timestamp_ns = arv_uvsp_packet_get_timestamp (packet);
-						offset = 0;
-						if (thread_data->callback != NULL)
-							thread_data->callback (thread_data->callback_data,
-									       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
-									       NULL);
-                                                thread_data->statistics.n_transferred_bytes += transferred;
-                                        } else {
-                                                thread_data->statistics.n_underruns++;
-                                                thread_data->statistics.n_ignored_bytes += transferred;
-                                        }
-                                        break;
-				case ARV_UVSP_PACKET_TYPE_TRAILER:
-					if (buffer != NULL) {
-						arv_debug_stream_thread ("Received %" G_GUINT64_FORMAT " bytes",
-								       offset);
-
-                                                if (offset != thread_data->expected_size) {
-                                                        arv_info_stream_thread ("Incomplete image received, dropping "
-                                                                                "(received %" G_GUINT64_FORMAT
-                                                                                " / expected %" G_GSIZE_FORMAT ")",
-                                                                                offset, thread_data->expected_size);
-
-                                                       buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
-                                                       arv_stream_push_output_buffer (thread_data->stream, buffer);
-                                                       if (thread_data->callback != NULL)
-                                                               thread_data->callback (thread_data->callback_data,
-                                                                                      ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-                                                                                      buffer);
-                                                       thread_data->statistics.n_failures++;
-                                                       thread_data->statistics.n_ignored_bytes += transferred;
-                                                       buffer = NULL;
-                                                } else {
-                                                        buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
-                                                        buffer->priv->received_size = offset;
-                                                        arv_stream_push_output_buffer (thread_data->stream, buffer);
-                                                        if (thread_data->callback != NULL)
-                                                                thread_data->callback (thread_data->callback_data,
-                                                                                       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-                                                                                       buffer);
-                                                        thread_data->statistics.n_completed_buffers++;
-                                                        thread_data->statistics.n_transferred_bytes += transferred;
-                                                        buffer = NULL;
-                                                }
-                                        }
-                                        break;
-                                case ARV_UVSP_PACKET_TYPE_DATA:
-                                        if (buffer != NULL && buffer->priv->status == ARV_BUFFER_STATUS_FILLING) {
-                                                if (offset + transferred <= buffer->priv->allocated_size) {
-                                                        if (packet == incoming_buffer)
-                                                                memcpy (((char *) buffer->priv->data) + offset,
-                                                                        packet, transferred);
-                                                        offset += transferred;
-                                                        thread_data->statistics.n_transferred_bytes += transferred;
-                                                } else {
-                                                        buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
-                                                        thread_data->statistics.n_ignored_bytes += transferred;
-                                                }
-                                        } else {
-                                                thread_data->statistics.n_ignored_bytes += transferred;
-                                        }
-                                        break;
-                                default:
-                                        arv_info_stream_thread ("Unknown packet type");
-                                        break;
-                        }
-                }
-        }
+		sync_transfer = _sync_wait (&sync);
+		if (sync_transfer != NULL)
+			_sync_process (&sync, sync_transfer);
+	}
 
-        if (buffer != NULL) {
-		buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
-                thread_data->statistics.n_aborted++;
-		arv_stream_push_output_buffer (thread_data->stream, buffer);
-		if (thread_data->callback != NULL)
-			thread_data->callback (thread_data->callback_data,
-					       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-					       buffer);
+	_sync_cancel (&sync);
+
+	if (sync.buffer != NULL) {
+		thread_data->statistics.n_aborted++;
+		_sync_push_buffer (thread_data, sync.buffer, ARV_BUFFER_STATUS_ABORTED);
+	}
+
+	while ((buffer = g_queue_pop_head (&sync.spare_buffers)) != NULL) {
+		thread_data->statistics.n_aborted++;
+		_sync_push_buffer (thread_data, buffer, ARV_BUFFER_STATUS_ABORTED);
+	}
+
+	for (i = 0; i < ARV_UV_STREAM_SYNC_N_TRANSFERS; i++) {
+		libusb_free_transfer (sync.transfers[i].transfer);
+		g_free (sync.transfers[i].packet_data);
+		g_free (sync.transfers[i].scratch_data);
 	}
 
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
 
-	g_free (incoming_buffer);
-
 	arv_debug_stream_thread ("Stop USB3Vision stream thread");
 
 	return NULL;
@@ -662,13 +1306,63 @@ arv_uv_stream_thread_sync (void *data)
 
 /* ArvUvStream implementation */
 
-static guint32
-align (guint32 val, guint32 alignment)
+static void
+_compute_transfer_geometry (ArvUvStreamPrivate *priv, ArvUvStreamThreadData *thread_data,
+                            guint64 payload_size, guint32 alignment)
 {
-	/* Alignment must be a power of two, otherwise the used alignment algorithm does not work. */
-	g_assert (alignment > 0 && (alignment & (alignment - 1)) == 0);
+        guint64 link_rate;
+        guint64 transfer_size;
+        guint64 submit_total;
+        int speed;
 
-	return (val + (alignment - 1)) & ~(alignment - 1);
+        speed = arv_uv_device_get_speed (thread_data->uv_device);
+
+        /* Approximative usable bandwidth, in bytes per second */
+        switch (speed) {
+                case LIBUSB_SPEED_HIGH:
+                        link_rate = 40 * 1000 * 1000;
+                        break;
+                case LIBUSB_SPEED_SUPER:
+                        link_rate = 400 * 1000 * 1000;
+                        break;
+#if LIBUSB_API_VERSION >= 0x01000106
+                case LIBUSB_SPEED_SUPER_PLUS:
+                        link_rate = 1000 * 1000 * 1000;
+                        break;
+#endif
+                default:
+                        link_rate = 0;
+                        break;
+        }
+
+        if (priv->transfer_size > 0)
+                transfer_size = priv->transfer_size;
+        else if (speed == LIBUSB_SPEED_HIGH)
+                transfer_size = ARV_UV_STREAM_AUTO_TRANSFER_SIZE_HIGH_SPEED;
+        else if (link_rate > 400 * 1000 * 1000)
+                transfer_size = ARV_UV_STREAM_AUTO_TRANSFER_SIZE_SUPER_SPEED_PLUS;
+        else
+                transfer_size = ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE;
+
+        transfer_size = MAX (transfer_size / alignment * alignment, alignment);
+
+        if (priv->submit_total > 0) {
+                submit_total = priv->submit_total;
+        } else {
+                /* Keep enough data in flight for the next frame and a few tens of milliseconds of link transfer */
+                submit_total = MIN (2 * payload_size, link_rate * ARV_UV_STREAM_AUTO_SUBMIT_TOTAL_DURATION_MS / 1000);
+                submit_total = CLAMP (submit_total,
+                                      ARV_UV_STREAM_MAXIMUM_SUBMIT_TOTAL, ARV_UV_STREAM_AUTO_SUBMIT_TOTAL_MAXIMUM);
+        }
+
+        thread_data->maximum_transfer_size = transfer_size;
+        thread_data->maximum_transfers_per_buffer = priv->transfers_per_buffer;
+        thread_data->maximum_submit_total = MIN (submit_total, G_MAXINT);
+
+        arv_info_stream ("Link speed            = %d", speed);
+        arv_info_stream ("Transfer size         = %" G_GSIZE_FORMAT, thread_data->maximum_transfer_size);
+        arv_info_stream ("Transfers per buffer  = %u", thread_data->maximum_transfers_per_buffer);
+        arv_info_stream ("Submit total          = %d", thread_data->maximum_submit_total);
 }
 
 static void
@@ -678,7 +1372,6 @@ arv_uv_stream_start_thread (ArvStream *stream)
 	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
 	ArvUvStreamThreadData *thread_data;
 	ArvDevice *device;
-	guint64 offset;
 	guint64 sirm_offset;
 	guint32 si_info;
 	guint64 si_req_payload_size;
@@ -701,10 +1394,7 @@ arv_uv_stream_start_thread (ArvStream *stream)
 
 	device = ARV_DEVICE (thread_data->uv_device);
 
-	arv_device_read_memory (device, ARV_ABRM_SBRM_ADDRESS,
-                                sizeof (guint64), &offset, NULL);
-	arv_device_read_memory (device, offset + ARV_SBRM_SIRM_ADDRESS,
-                                sizeof (guint64), &sirm_offset, NULL);
+	sirm_offset = arv_uv_device_get_sirm_offset (thread_data->uv_device, thread_data->stream_channel);
 	arv_device_read_memory (device, sirm_offset + ARV_SIRM_INFO,
                                 sizeof (si_info), &si_info, NULL);
 	arv_device_read_memory (device, sirm_offset + ARV_SIRM_REQ_PAYLOAD_SIZE,
@@ -723,7 +1413,9 @@ arv_uv_stream_start_thread (ArvStream *stream)
 
 	arv_info_stream ("Required alignment    = %d", alignment);
 
-	aligned_maximum_transfer_size = ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE / alignment * alignment;
+	_compute_transfer_geometry (priv, thread_data, si_req_payload_size, alignment);
+
+	aligned_maximum_transfer_size = thread_data->maximum_transfer_size;
 
 	if (si_req_leader_size < 1) {
 		arv_warning_stream ("Wrong SI_REQ_LEADER_SIZE value, using %d instead", aligned_maximum_transfer_size);
@@ -775,6 +1467,13 @@ arv_uv_stream_start_thread (ArvStream *stream)
 	thread_data->trailer_size = si_trailer_size;
 	thread_data->cancel = FALSE;
 
+        if (priv->usb_mode == ARV_UV_USB_MODE_ASYNC) {
+                gint n_input_buffers, n_output_buffers;
+
+                arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+                _prepare_buffer_contexts (thread_data, n_input_buffers + n_output_buffers);
+        }
+
         switch (priv->usb_mode) {
                 case ARV_UV_USB_MODE_SYNC:
                         priv->thread = g_thread_new ("arv_uv_stream", arv_uv_stream_thread_sync, priv->thread_data);
@@ -785,6 +1484,8 @@ arv_uv_stream_start_thread (ArvStream *stream)
                 default:
                         g_assert_not_reached ();
         }
+
+	priv->is_suspended = FALSE;
 }
 
 static void
@@ -793,10 +1494,15 @@ arv_uv_stream_stop_thread (ArvStream *stream)
 	ArvUvStream *uv_stream = ARV_UV_STREAM (stream);
 	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
 	ArvUvStreamThreadData *thread_data;
-	guint64 offset;
 	guint64 sirm_offset;
 	guint32 si_control;
 
+	/* Already stopped by a reconnection in progress */
+	if (priv->is_suspended) {
+		priv->is_suspended = FALSE;
+		return;
+	}
+
 	g_return_if_fail (priv->thread != NULL);
 	g_return_if_fail (priv->thread_data != NULL);
 
@@ -809,18 +1515,79 @@ arv_uv_stream_stop_thread (ArvStream *stream)
 	priv->thread = NULL;
 
 	si_control = 0x0;
-	arv_device_read_memory (ARV_DEVICE (thread_data->uv_device),
-				ARV_ABRM_SBRM_ADDRESS, sizeof (guint64), &offset, NULL);
-	arv_device_read_memory (ARV_DEVICE (thread_data->uv_device),
-				offset + ARV_SBRM_SIRM_ADDRESS, sizeof (guint64), &sirm_offset, NULL);
+	sirm_offset = arv_uv_device_get_sirm_offset (thread_data->uv_device, thread_data->stream_channel);
 	arv_device_write_memory (ARV_DEVICE (thread_data->uv_device),
 				 sirm_offset + ARV_SIRM_CONTROL, sizeof (si_control), &si_control, NULL);
 
 }
 
+/* The buffer contexts are allocated for the queued buffers at thread start, along with the streaming interface
+ * configuration */
+
+static void
+arv_uv_stream_arm (ArvStream *stream, size_t buffer_size)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (ARV_UV_STREAM (stream));
+
+	if (priv->thread != NULL)
+		arv_uv_stream_stop_thread (stream);
+
+	arv_uv_stream_start_thread (stream);
+}
+
+static void
+arv_uv_stream_disarm (ArvStream *stream)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (ARV_UV_STREAM (stream));
+
+	if (priv->thread != NULL)
+		arv_uv_stream_stop_thread (stream);
+}
+
+/* Stops the stream thread before the USB device handle is reopened by a reconnection. The queued buffers are kept
+ * for the resumption. */
+
+void
+arv_uv_stream_suspend (ArvUvStream *uv_stream)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+
+	g_return_if_fail (ARV_IS_UV_STREAM (uv_stream));
+
+	if (priv->is_suspended || priv->thread == NULL)
+		return;
+
+	arv_uv_stream_stop_thread (ARV_STREAM (uv_stream));
+	priv->is_suspended = TRUE;
+
+	arv_info_stream ("[UvStream::suspend] Stream channel %u suspended", priv->channel);
+}
+
+/* Restarts the stream thread stopped by arv_uv_stream_suspend(), the streaming interface registers being written
+ * again at thread start. */
+
+void
+arv_uv_stream_resume (ArvUvStream *uv_stream)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+
+	g_return_if_fail (ARV_IS_UV_STREAM (uv_stream));
+
+	if (!priv->is_suspended)
+		return;
+
+	/* The leader and trailer transfers of the buffer contexts were filled with the previous device handle */
+	_clear_buffer_contexts (priv->thread_data);
+
+	arv_uv_stream_start_thread (ARV_STREAM (uv_stream));
+
+	arv_info_stream ("[UvStream::resume] Stream channel %u resumed", priv->channel);
+}
+
 /**
  * arv_uv_stream_new: (skip)
  * @uv_device: a #ArvUvDevice
+ * @stream_channel: stream channel index
  * @callback: (scope call): image processing callback
  * @callback_data: (closure): user data for @callback
  * @error: a #GError placeholder, %NULL to ignore
@@ -829,11 +1596,12 @@ arv_uv_stream_stop_thread (ArvStream *stream)
  */
 
 ArvStream *
-arv_uv_stream_new (ArvUvDevice *uv_device, ArvStreamCallback callback, void *callback_data, GDestroyNotify destroy,
-                   ArvUvUsbMode usb_mode, GError **error)
+arv_uv_stream_new (ArvUvDevice *uv_device, guint stream_channel, ArvStreamCallback callback, void *callback_data,
+                   GDestroyNotify destroy, ArvUvUsbMode usb_mode, GError **error)
 {
 	return g_initable_new (ARV_TYPE_UV_STREAM, NULL, error,
 			       "device", uv_device,
+			       "channel", stream_channel,
 			       "callback", callback,
 			       "callback-data", callback_data,
 						 "destroy-notify", destroy,
@@ -861,6 +1629,7 @@ arv_uv_stream_constructed (GObject *object)
 	thread_data->statistics.n_failures = 0;
 	thread_data->statistics.n_underruns = 0;
         thread_data->statistics.n_aborted = 0;
+        thread_data->statistics.n_recycled_buffers = 0;
 	thread_data->statistics.n_transferred_bytes = 0;
 	thread_data->statistics.n_ignored_bytes = 0;
 
@@ -870,6 +1639,9 @@ arv_uv_stream_constructed (GObject *object)
 		      "callback-data", &thread_data->callback_data,
 		      NULL);
 
+	thread_data->underrun_policy = priv->underrun_policy;
+	thread_data->stream_channel = priv->channel;
+
 	priv->thread_data = thread_data;
 
         arv_stream_declare_info (ARV_STREAM (uv_stream), "n_completed_buffers",
@@ -880,6 +1652,8 @@ arv_uv_stream_constructed (GObject *object)
                                  G_TYPE_UINT64, &thread_data->statistics.n_underruns);
         arv_stream_declare_info (ARV_STREAM (uv_stream), "n_aborted",
                                  G_TYPE_UINT64, &thread_data->statistics.n_aborted);
+        arv_stream_declare_info (ARV_STREAM (uv_stream), "n_recycled_buffers",
+                                 G_TYPE_UINT64, &thread_data->statistics.n_recycled_buffers);
         arv_stream_declare_info (ARV_STREAM (uv_stream), "n_transferred_bytes",
                                  G_TYPE_UINT64, &thread_data->statistics.n_transferred_bytes);
         arv_stream_declare_info (ARV_STREAM (uv_stream), "n_ignored_bytes",
@@ -900,6 +1674,51 @@ arv_uv_stream_set_property (GObject * object, guint prop_id,
                case ARV_UV_STREAM_PROPERTY_USB_MODE:
                        priv->usb_mode = g_value_get_enum(value);
                        break;
+               case ARV_UV_STREAM_PROPERTY_UNDERRUN_POLICY:
+                       priv->underrun_policy = g_value_get_enum (value);
+                       if (priv->thread_data != NULL)
+                               g_atomic_int_set (&priv->thread_data->underrun_policy, priv->underrun_policy);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_TRANSFER_SIZE:
+                       priv->transfer_size = g_value_get_uint (value);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_TRANSFERS_PER_BUFFER:
+                       priv->transfers_per_buffer = g_value_get_uint (value);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_SUBMIT_TOTAL:
+                       priv->submit_total = g_value_get_uint (value);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_CHANNEL:
+                       priv->channel = g_value_get_uint (value);
+                       break;
+               default:
+                       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+                       break;
+       }
+}
+
+static void
+arv_uv_stream_get_property (GObject * object, guint prop_id,
+                            GValue * value, GParamSpec * pspec)
+{
+       ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (ARV_UV_STREAM (object));
+
+       switch (prop_id) {
+               case ARV_UV_STREAM_PROPERTY_UNDERRUN_POLICY:
+                       g_value_set_enum (value, priv->underrun_policy);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_TRANSFER_SIZE:
+                       g_value_set_uint (value, priv->transfer_size);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_TRANSFERS_PER_BUFFER:
+                       g_value_set_uint (value, priv->transfers_per_buffer);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_SUBMIT_TOTAL:
+                       g_value_set_uint (value, priv->submit_total);
+                       break;
+               case ARV_UV_STREAM_PROPERTY_CHANNEL:
+                       g_value_set_uint (value, priv->channel);
+                       break;
                default:
                        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
                        break;
@@ -918,7 +1737,9 @@ arv_uv_stream_finalize (GObject *object)
 	ArvUvStream *uv_stream = ARV_UV_STREAM (object);
 	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
 
-	arv_uv_stream_stop_thread (ARV_STREAM (uv_stream));
+	/* The thread may have been stopped by arv_stream_disarm() */
+	if (priv->thread != NULL)
+		arv_uv_stream_stop_thread (ARV_STREAM (uv_stream));
 
 	if (priv->thread_data != NULL) {
 		ArvUvStreamThreadData *thread_data;
@@ -939,6 +1760,8 @@ arv_uv_stream_finalize (GObject *object)
 		arv_info_stream ("[UvStream::finalize] n_ignored_bytes        = %" G_GUINT64_FORMAT,
 				  thread_data->statistics.n_ignored_bytes);
 
+		_clear_buffer_contexts (thread_data);
+
 		g_mutex_clear (&thread_data->stream_mtx);
 		g_cond_clear (&thread_data->stream_event);
 
@@ -958,9 +1781,12 @@ arv_uv_stream_class_init (ArvUvStreamClass *uv_stream_class)
 	object_class->constructed = arv_uv_stream_constructed;
 	object_class->finalize = arv_uv_stream_finalize;
 	object_class->set_property = arv_uv_stream_set_property;
+	object_class->get_property = arv_uv_stream_get_property;
 
 	stream_class->start_thread = arv_uv_stream_start_thread;
 	stream_class->stop_thread = arv_uv_stream_stop_thread;
+	stream_class->arm = arv_uv_stream_arm;
+	stream_class->disarm = arv_uv_stream_disarm;
 
          /**
           * ArvUvStream:usb-mode:
@@ -976,4 +1802,86 @@ arv_uv_stream_class_init (ArvUvStreamClass *uv_stream_class)
 				   G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS)
 		);
 
+         /**
+          * ArvUvStream:underrun-policy:
+          *
+          * Behaviour of the asynchronous mode stream thread when the input queue is empty.
+          *
+          * Since: 0.8.24
+          */
+        g_object_class_install_property (
+                object_class, ARV_UV_STREAM_PROPERTY_UNDERRUN_POLICY,
+                g_param_spec_enum ("underrun-policy", "Underrun policy",
+                                   "Buffer underrun behaviour",
+                                   ARV_TYPE_UV_STREAM_UNDERRUN_POLICY,
+                                   ARV_UV_STREAM_UNDERRUN_POLICY_WAIT,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+         /**
+          * ArvUvStream:transfer-size:
+          *
+          * Maximum size of the USB payload transfers, in bytes. 0 selects a value depending on the link speed and
+          * the payload size. A change is taken into account at the next stream thread start.
+          *
+          * Since: 0.8.24
+          */
+        g_object_class_install_property (
+                object_class, ARV_UV_STREAM_PROPERTY_TRANSFER_SIZE,
+                g_param_spec_uint ("transfer-size", "Transfer size",
+                                   "Maximum payload transfer size, 0 for auto",
+                                   0, G_MAXINT, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+         /**
+          * ArvUvStream:transfers-per-buffer:
+          *
+          * Maximum number of in flight USB transfers for a given buffer, when using the asynchronous mode. 0 means
+          * the number of transfers is only limited by #ArvUvStream:submit-total. A change is taken into account at
+          * the next stream thread start.
+          *
+          * Since: 0.8.24
+          */
+        g_object_class_install_property (
+                object_class, ARV_UV_STREAM_PROPERTY_TRANSFERS_PER_BUFFER,
+                g_param_spec_uint ("transfers-per-buffer", "Transfers per buffer",
+                                   "Maximum number of in flight transfers per buffer, 0 for no limit",
+                                   0, G_MAXINT, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+         /**
+          * ArvUvStream:submit-total:
+          *
+          * Maximum amount of data of all the in flight USB transfers, in bytes, when using the asynchronous mode. 0
+          * selects a value depending on the link speed and the payload size. A change is taken into account at the
+          * next stream thread start.
+          *
+          * Since: 0.8.24
+          */
+        g_object_class_install_property (
+                object_class, ARV_UV_STREAM_PROPERTY_SUBMIT_TOTAL,
+                g_param_spec_uint ("submit-total", "Submit total",
+                                   "Maximum in flight transfer data, 0 for auto",
+                                   0, G_MAXINT, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+         /**
+          * ArvUvStream:channel:
+          *
+          * Index of the device stream channel received by this stream, each channel having its own streaming
+          * interface and endpoint.
+          *
+          * Since: 0.8.24
+          */
+        g_object_class_install_property (
+                object_class, ARV_UV_STREAM_PROPERTY_CHANNEL,
+                g_param_spec_uint ("channel", "Channel",
+                                   "Stream channel index",
+                                   0, G_MAXUINT, 0,
+				   G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
 }
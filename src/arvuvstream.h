@@ -33,9 +33,29 @@
 
 G_BEGIN_DECLS
 
+/**
+ * ArvUvStreamUnderrunPolicy:
+ * @ARV_UV_STREAM_UNDERRUN_POLICY_WAIT: wait for the application to push a new buffer, letting the device handle the
+ * back pressure
+ * @ARV_UV_STREAM_UNDERRUN_POLICY_DROP_OLDEST: take back the oldest buffer of the output queue not retrieved yet by the
+ * application, and fill it again
+ * @ARV_UV_STREAM_UNDERRUN_POLICY_REUSE: keep the transfers running using a buffer owned by the stream, and discard its
+ * content
+ *
+ * Since: 0.8.24
+ */
+
+typedef enum {
+	ARV_UV_STREAM_UNDERRUN_POLICY_WAIT,
+	ARV_UV_STREAM_UNDERRUN_POLICY_DROP_OLDEST,
+	ARV_UV_STREAM_UNDERRUN_POLICY_REUSE
+} ArvUvStreamUnderrunPolicy;
+
 #define ARV_TYPE_UV_STREAM             (arv_uv_stream_get_type ())
 ARV_API G_DECLARE_FINAL_TYPE (ArvUvStream, arv_uv_stream, ARV, UV_STREAM, ArvStream)
 
+ARV_API ArvBuffer *	arv_uv_stream_new_buffer	(ArvUvStream *uv_stream, size_t size);
+
 G_END_DECLS
 
 #endif
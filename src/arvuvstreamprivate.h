@@ -33,9 +33,12 @@
 
 G_BEGIN_DECLS
 
-ArvStream * 	arv_uv_stream_new	(ArvUvDevice *uv_device, ArvStreamCallback callback, void *user_data, GDestroyNotify destroy,
+ArvStream * 	arv_uv_stream_new	(ArvUvDevice *uv_device, guint stream_channel, ArvStreamCallback callback, void *user_data, GDestroyNotify destroy,
                                          ArvUvUsbMode usb_mode, GError **error);
 
+void		arv_uv_stream_suspend	(ArvUvStream *uv_stream);
+void		arv_uv_stream_resume	(ArvUvStream *uv_stream);
+
 G_END_DECLS
 
 #endif
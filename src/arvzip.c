@@ -30,7 +30,8 @@
  * @short_description: A simple zip extractor
  */
 
-#include <arvzip.h>
+#include <arvzipprivate.h>
+#include <arvmiscprivate.h>
 #include <arvdebugprivate.h>
 #include <string.h>
 #include <zlib.h>
@@ -251,18 +252,14 @@ arv_zip_get_file (ArvZip *zip, const char *name, size_t *size)
 	if (output_buffer == NULL)
 		return NULL;
 
+	/* The uncompressed size is known from the directory, the whole entry is inflated in one call */
         if (zip_file->compressed_size < zip_file->uncompressed_size) {
-                z_stream zs;
-                zs.zalloc = NULL;
-                zs.zfree = NULL;
-                zs.opaque = NULL;
-                zs.next_in = (void *) &zip->buffer[offset];
-                zs.avail_in = zip_file->compressed_size;
-                zs.next_out = output_buffer;
-                zs.avail_out = zip_file->uncompressed_size;
-                inflateInit2 (&zs, -MAX_WBITS);
-                inflate (&zs, Z_FINISH);
-                inflateEnd (&zs);
+		if (arv_inflate (&zip->buffer[offset], zip_file->compressed_size,
+				 output_buffer, zip_file->uncompressed_size, NULL) != ARV_INFLATE_SUCCESS) {
+			arv_warning_misc ("[Zip::get_file] Failed to inflate '%s'", name);
+			g_free (output_buffer);
+			return NULL;
+		}
         } else
 		memcpy (output_buffer, zip->buffer + offset, zip_file->uncompressed_size);
 
@@ -271,3 +268,179 @@ arv_zip_get_file (ArvZip *zip, const char *name, size_t *size)
 
         return output_buffer;
 }
+
+/* Streaming extraction of the first file of a zip archive, from its local file header, without waiting for the
+ * central directory at the end of the archive. */
+
+#define ARV_ZIP_LOCAL_HEADER_SIZE	30
+#define ARV_ZIP_STREAM_CHUNK		16384
+
+struct _ArvZipStream {
+	ArvZipStreamFunc func;
+	void *user_data;
+
+	GByteArray *header;
+	size_t header_size;
+	char *name;
+
+	guint method;
+	size_t n_remaining_bytes;
+	z_stream zs;
+	gboolean is_inflate_initialized;
+
+	gboolean is_done;
+	gboolean is_error;
+};
+
+ArvZipStream *
+arv_zip_stream_new (ArvZipStreamFunc func, void *user_data)
+{
+	ArvZipStream *stream;
+
+	g_return_val_if_fail (func != NULL, NULL);
+
+	stream = g_new0 (ArvZipStream, 1);
+	stream->func = func;
+	stream->user_data = user_data;
+	stream->header = g_byte_array_new ();
+
+	return stream;
+}
+
+static void
+_zip_stream_parse_header (ArvZipStream *stream)
+{
+	const char *ptr = (const char *) stream->header->data;
+	guint flags;
+
+	if (stream->header_size == 0) {
+		if (ARV_GUINT32_FROM_LE_PTR (ptr, 0) != 0x04034b50) {
+			arv_info_misc ("[ZipStream::feed] Magic number for file header not found (0x04034b50)");
+			stream->is_error = TRUE;
+			return;
+		}
+
+		flags = ARV_GUINT16_FROM_LE_PTR (ptr, 6);
+		stream->method = ARV_GUINT16_FROM_LE_PTR (ptr, 8);
+		stream->n_remaining_bytes = ARV_GUINT32_FROM_LE_PTR (ptr, 18);
+		stream->header_size = ARV_ZIP_LOCAL_HEADER_SIZE +
+			ARV_GUINT16_FROM_LE_PTR (ptr, 26) +	/* filename size */
+			ARV_GUINT16_FROM_LE_PTR (ptr, 28);	/* extra field */
+
+		switch (stream->method) {
+			case Z_DEFLATED:
+				if (inflateInit2 (&stream->zs, -MAX_WBITS) != Z_OK)
+					stream->is_error = TRUE;
+				else
+					stream->is_inflate_initialized = TRUE;
+				break;
+			case 0:
+				/* Stored data size is unknown when followed by a data descriptor */
+				if ((flags & (1 << 3)) != 0)
+					stream->is_error = TRUE;
+				break;
+			default:
+				arv_info_misc ("[ZipStream::feed] Unsupported compression method %u", stream->method);
+				stream->is_error = TRUE;
+				break;
+		}
+	}
+
+	if (!stream->is_error && stream->header->len == stream->header_size)
+		stream->name = g_strndup (ptr + ARV_ZIP_LOCAL_HEADER_SIZE,
+					  ARV_GUINT16_FROM_LE_PTR (ptr, 26));
+}
+
+/* Returns FALSE on error. The data following the first file is ignored. */
+
+gboolean
+arv_zip_stream_feed (ArvZipStream *stream, const void *data, size_t size)
+{
+	const guint8 *ptr = data;
+
+	g_return_val_if_fail (stream != NULL, FALSE);
+	g_return_val_if_fail (data != NULL || size == 0, FALSE);
+
+	while (size > 0 && !stream->is_done && !stream->is_error) {
+		size_t n_bytes;
+
+		if (stream->name == NULL) {
+			size_t header_size = stream->header_size > 0 ? stream->header_size : ARV_ZIP_LOCAL_HEADER_SIZE;
+
+			n_bytes = MIN (header_size - stream->header->len, size);
+			g_byte_array_append (stream->header, ptr, n_bytes);
+			ptr += n_bytes;
+			size -= n_bytes;
+
+			if (stream->header->len == header_size)
+				_zip_stream_parse_header (stream);
+		} else if (stream->method == 0) {
+			n_bytes = MIN (stream->n_remaining_bytes, size);
+			stream->func (ptr, n_bytes, stream->user_data);
+			ptr += n_bytes;
+			size -= n_bytes;
+
+			stream->n_remaining_bytes -= n_bytes;
+			stream->is_done = stream->n_remaining_bytes == 0;
+		} else {
+			guint8 output[ARV_ZIP_STREAM_CHUNK];
+
+			stream->zs.next_in = (void *) ptr;
+			stream->zs.avail_in = size;
+
+			do {
+				int result;
+
+				stream->zs.next_out = output;
+				stream->zs.avail_out = sizeof (output);
+
+				result = inflate (&stream->zs, Z_NO_FLUSH);
+				if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+					arv_info_misc ("[ZipStream::feed] Inflate error %d", result);
+					stream->is_error = TRUE;
+					break;
+				}
+
+				if (sizeof (output) > stream->zs.avail_out)
+					stream->func (output, sizeof (output) - stream->zs.avail_out, stream->user_data);
+
+				stream->is_done = result == Z_STREAM_END;
+			} while (!stream->is_done && (stream->zs.avail_in > 0 || stream->zs.avail_out == 0));
+
+			size = 0;
+		}
+	}
+
+	return !stream->is_error;
+}
+
+/**
+ * arv_zip_stream_finish:
+ * @stream: (transfer full): a #ArvZipStream
+ * @name: (out) (optional): placeholder for the name of the extracted file
+ *
+ * Releases @stream.
+ *
+ * Returns: %TRUE if the first file of the archive was entirely extracted.
+ */
+
+gboolean
+arv_zip_stream_finish (ArvZipStream *stream, char **name)
+{
+	gboolean success;
+
+	g_return_val_if_fail (stream != NULL, FALSE);
+
+	success = stream->is_done && !stream->is_error;
+
+	if (name != NULL)
+		*name = success ? g_steal_pointer (&stream->name) : NULL;
+
+	if (stream->is_inflate_initialized)
+		inflateEnd (&stream->zs);
+	g_byte_array_unref (stream->header);
+	g_free (stream->name);
+	g_free (stream);
+
+	return success;
+}
@@ -0,0 +1,51 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2022 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_ZIP_PRIVATE_H
+#define ARV_ZIP_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvzip.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvZipStream ArvZipStream;
+
+/**
+ * ArvZipStreamFunc:
+ * @data: a chunk of inflated data
+ * @size: size of the chunk, in bytes
+ * @user_data: user data
+ */
+
+typedef void (*ArvZipStreamFunc) (const void *data, size_t size, void *user_data);
+
+ArvZipStream *		arv_zip_stream_new		(ArvZipStreamFunc func, void *user_data);
+gboolean		arv_zip_stream_feed		(ArvZipStream *stream, const void *data, size_t size);
+gboolean		arv_zip_stream_finish		(ArvZipStream *stream, char **name);
+
+G_END_DECLS
+
+#endif
@@ -3,6 +3,7 @@
 
 static char **arv_option_expressions = NULL;
 static char *arv_option_debug_domains = NULL;
+static int arv_option_n_iterations = 0;
 
 static const GOptionEntry arv_option_entries[] =
 {
@@ -10,6 +11,8 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_expressions,		NULL, NULL},
 	{ "debug", 		'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 	"Debug mode", NULL },
+	{ "benchmark",		'b', 0, G_OPTION_ARG_INT,
+		&arv_option_n_iterations,	"Evaluate each expression N times, and print the mean evaluation time", "N" },
 	{ NULL }
 };
 
@@ -19,8 +22,9 @@ main (int argc, char **argv)
 	ArvEvaluator *evaluator;
 	GOptionContext *context;
 	GError *error = NULL;
-	int i;
+	int i, j;
 	double value;
+	guint tint_index;
 
 	context = g_option_context_new (NULL);
 	g_option_context_add_main_entries (context, arv_option_entries, NULL);
@@ -40,6 +44,7 @@ main (int argc, char **argv)
 
 	arv_evaluator_set_double_variable (evaluator, "TDBL", 124.2);
 	arv_evaluator_set_int64_variable (evaluator, "TINT", 3200);
+	tint_index = arv_evaluator_get_variable_index (evaluator, "TINT");
 
 	if (arv_option_expressions == NULL) {
 		g_print ("Missing expression.\n");
@@ -57,6 +62,21 @@ main (int argc, char **argv)
 			error = NULL;
 		} else
 			g_print ("%s = %g\n", arv_option_expressions[i], value);
+
+		if (error == NULL && arv_option_n_iterations > 0) {
+			gint64 start;
+			gint64 duration;
+
+			start = g_get_monotonic_time ();
+			for (j = 0; j < arv_option_n_iterations; j++) {
+				arv_evaluator_set_int64_variable_by_index (evaluator, tint_index, 3200 + (j & 0xff));
+				arv_evaluator_evaluate_as_double (evaluator, NULL);
+			}
+			duration = g_get_monotonic_time () - start;
+
+			g_print ("%d evaluations in %" G_GINT64_FORMAT " µs (%.3f µs per evaluation)\n",
+				 arv_option_n_iterations, duration, (double) duration / arv_option_n_iterations);
+		}
 	}
 
 	g_object_unref (evaluator);
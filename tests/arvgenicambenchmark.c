@@ -0,0 +1,357 @@
+#include <arv.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * GenICam layer microbenchmarks: XML parse time and node memory for the given files and for the fake camera XML,
+ * then feature access latencies on a fake device, with and without register cache.
+ */
+
+static char **arv_option_filenames = NULL;
+static int arv_option_n_iterations = 100000;
+static int arv_option_n_parses = 20;
+static gboolean arv_option_json = FALSE;
+static char *arv_option_debug_domains = NULL;
+
+static const GOptionEntry arv_option_entries[] =
+{
+	{ G_OPTION_REMAINING,	' ', 0, G_OPTION_ARG_FILENAME_ARRAY,
+		&arv_option_filenames,		NULL, NULL},
+	{ "iterations",		'n', 0, G_OPTION_ARG_INT,
+		&arv_option_n_iterations,	"Number of iterations of the feature access benchmarks", "n"},
+	{ "parses",		'p', 0, G_OPTION_ARG_INT,
+		&arv_option_n_parses,		"Number of parses of each XML file", "n"},
+	{ "json",		'j', 0, G_OPTION_ARG_NONE,
+		&arv_option_json,		"Output one JSON object per measurement", NULL},
+	{ "debug", 		'd', 0, G_OPTION_ARG_STRING,
+		&arv_option_debug_domains, 	"Debug mode", NULL },
+	{ NULL }
+};
+
+/* Allocation counting, by interposition of the glibc allocator */
+
+static gint64 n_allocations = 0;
+static gint64 n_allocated_bytes = 0;
+static gboolean count_allocations = FALSE;
+
+#if defined (__GLIBC__)
+#define HAS_ALLOCATION_COUNT 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+	if (count_allocations) {
+		n_allocations++;
+		n_allocated_bytes += size;
+	}
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	if (count_allocations) {
+		n_allocations++;
+		n_allocated_bytes += n_members * size;
+	}
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	if (count_allocations) {
+		n_allocations++;
+		n_allocated_bytes += size;
+	}
+	return __libc_realloc (ptr, size);
+}
+#else
+#define HAS_ALLOCATION_COUNT 0
+#endif
+
+static void
+report (const char *source, const char *metric, double value, const char *unit)
+{
+	if (arv_option_json) {
+		char *escaped = g_strescape (source, NULL);
+
+		printf ("{\"source\": \"%s\", \"metric\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}\n",
+			escaped, metric, value, unit);
+		g_free (escaped);
+	} else
+		printf ("%-32s %-40s %14.3f %s\n", source, metric, value, unit);
+}
+
+static int
+_compare_doubles (const void *a, const void *b)
+{
+	double da = *(const double *) a;
+	double db = *(const double *) b;
+
+	return da < db ? -1 : da > db ? 1 : 0;
+}
+
+/* XML parse time, and memory of the node tree, with and without lazy node instantiation */
+
+static void
+benchmark_parse (const char *source, const char *xml, size_t size)
+{
+	gboolean lazy_loading = arv_get_genicam_lazy_loading ();
+	double *times_us;
+	int mode;
+
+	times_us = g_new (double, arv_option_n_parses);
+
+	for (mode = 0; mode < 2; mode++) {
+		ArvGc *genicam;
+		char *metric;
+		int i;
+
+		arv_set_genicam_lazy_loading (mode == 1);
+
+		for (i = 0; i < arv_option_n_parses; i++) {
+			gint64 start_us = g_get_monotonic_time ();
+
+			genicam = arv_gc_new (NULL, xml, size);
+			times_us[i] = g_get_monotonic_time () - start_us;
+			g_object_unref (genicam);
+		}
+
+		qsort (times_us, arv_option_n_parses, sizeof (double), _compare_doubles);
+
+		metric = g_strdup_printf ("parse_time%s_median", mode == 1 ? "_lazy" : "");
+		report (source, metric, times_us[arv_option_n_parses / 2], "us");
+		g_free (metric);
+		metric = g_strdup_printf ("parse_time%s_min", mode == 1 ? "_lazy" : "");
+		report (source, metric, times_us[0], "us");
+		g_free (metric);
+
+		if (HAS_ALLOCATION_COUNT) {
+			n_allocations = 0;
+			n_allocated_bytes = 0;
+			count_allocations = TRUE;
+			genicam = arv_gc_new (NULL, xml, size);
+			count_allocations = FALSE;
+
+			metric = g_strdup_printf ("parse%s_allocations", mode == 1 ? "_lazy" : "");
+			report (source, metric, n_allocations, "allocations");
+			g_free (metric);
+			metric = g_strdup_printf ("parse%s_allocated_bytes", mode == 1 ? "_lazy" : "");
+			report (source, metric, n_allocated_bytes, "bytes");
+			g_free (metric);
+
+			g_object_unref (genicam);
+		}
+	}
+
+	arv_set_genicam_lazy_loading (lazy_loading);
+
+	g_free (times_us);
+}
+
+/* Feature access latency */
+
+typedef struct {
+	ArvGcNode *node;
+	ArvGcNode *other_node;
+	guint count;
+} AccessData;
+
+typedef void (*AccessFunc) (AccessData *data);
+
+static void
+_integer_get (AccessData *data)
+{
+	arv_gc_integer_get_value (ARV_GC_INTEGER (data->node), NULL);
+}
+
+static void
+_integer_set (AccessData *data)
+{
+	arv_gc_integer_set_value (ARV_GC_INTEGER (data->node), (data->count++ & 1) ? 256 : 512, NULL);
+}
+
+static void
+_float_get (AccessData *data)
+{
+	arv_gc_float_get_value (ARV_GC_FLOAT (data->node), NULL);
+}
+
+static void
+_float_set (AccessData *data)
+{
+	arv_gc_float_set_value (ARV_GC_FLOAT (data->node), (data->count++ & 1) ? 1000.0 : 2000.0, NULL);
+}
+
+static void
+_enumeration_get_int (AccessData *data)
+{
+	arv_gc_enumeration_get_int_value (ARV_GC_ENUMERATION (data->node), NULL);
+}
+
+static void
+_enumeration_get_string (AccessData *data)
+{
+	arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (data->node), NULL);
+}
+
+static void
+_enumeration_set_string (AccessData *data)
+{
+	arv_gc_enumeration_set_string_value (ARV_GC_ENUMERATION (data->node),
+					     (data->count++ & 1) ? "Mono8" : "Mono16", NULL);
+}
+
+/* Sets an invalidating feature before reading the dependent one */
+
+static void
+_invalidated_integer_get (AccessData *data)
+{
+	arv_gc_integer_set_value (ARV_GC_INTEGER (data->other_node), (data->count++ & 1) ? 256 : 512, NULL);
+	arv_gc_integer_get_value (ARV_GC_INTEGER (data->node), NULL);
+}
+
+static void
+benchmark_access (ArvGc *genicam, const char *metric, const char *feature, const char *other_feature,
+		  AccessFunc func)
+{
+	AccessData data = {0};
+	gint64 start_us;
+	int i;
+
+	data.node = arv_gc_get_node (genicam, feature);
+	data.other_node = other_feature != NULL ? arv_gc_get_node (genicam, other_feature) : NULL;
+	if (data.node == NULL || (other_feature != NULL && data.other_node == NULL)) {
+		fprintf (stderr, "Feature '%s' not found\n", data.node == NULL ? feature : other_feature);
+		return;
+	}
+
+	/* Warm up, which also instantiates the lazily loaded nodes */
+	for (i = 0; i < 100; i++)
+		func (&data);
+
+	start_us = g_get_monotonic_time ();
+	for (i = 0; i < arv_option_n_iterations; i++)
+		func (&data);
+
+	report (feature, metric, (g_get_monotonic_time () - start_us) * 1000.0 / arv_option_n_iterations, "ns");
+
+	if (HAS_ALLOCATION_COUNT) {
+		char *allocation_metric;
+
+		n_allocations = 0;
+		count_allocations = TRUE;
+		for (i = 0; i < 1000; i++)
+			func (&data);
+		count_allocations = FALSE;
+
+		allocation_metric = g_strdup_printf ("%s_allocations", metric);
+		report (feature, allocation_metric, n_allocations / 1000.0, "allocations");
+		g_free (allocation_metric);
+	}
+}
+
+static void
+benchmark_device (ArvDevice *device)
+{
+	ArvGc *genicam = arv_device_get_genicam (device);
+	int cached;
+
+	for (cached = 1; cached >= 0; cached--) {
+		const char *suffix = cached ? "cached" : "uncached";
+		char *metric;
+
+		arv_gc_set_register_cache_policy (genicam, cached ?
+						  ARV_REGISTER_CACHE_POLICY_ENABLE :
+						  ARV_REGISTER_CACHE_POLICY_DISABLE);
+
+#define ACCESS(name, feature, other_feature, func)					\
+		metric = g_strdup_printf ("%s_%s", name, suffix);			\
+		benchmark_access (genicam, metric, feature, other_feature, func);	\
+		g_free (metric);
+
+		ACCESS ("integer_get", "Width", NULL, _integer_get);
+		ACCESS ("integer_set", "Width", NULL, _integer_set);
+		ACCESS ("float_get", "ExposureTimeAbs", NULL, _float_get);
+		ACCESS ("float_set", "ExposureTimeAbs", NULL, _float_set);
+		ACCESS ("enumeration_get_int", "PixelFormat", NULL, _enumeration_get_int);
+		ACCESS ("enumeration_get_string", "PixelFormat", NULL, _enumeration_get_string);
+		ACCESS ("enumeration_set_string", "PixelFormat", NULL, _enumeration_set_string);
+		ACCESS ("converter_get", "AcquisitionFrameRateConverter", NULL, _float_get);
+		ACCESS ("float_converter_get", "AcquisitionFrameRate", NULL, _float_get);
+		ACCESS ("swissknife_get", "PayloadSize", NULL, _integer_get);
+		ACCESS ("swissknife_get_after_invalidation", "PayloadSize", "Width", _invalidated_integer_get);
+
+#undef ACCESS
+	}
+}
+
+int
+main (int argc, char **argv)
+{
+	ArvDevice *device;
+	GOptionContext *context;
+	GError *error = NULL;
+	const char *xml;
+	size_t size;
+	int i;
+
+	context = g_option_context_new ("[XML files...]");
+	g_option_context_set_summary (context, "GenICam feature access microbenchmarks.");
+	g_option_context_add_main_entries (context, arv_option_entries, NULL);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_option_context_free (context);
+		g_print ("Option parsing failed: %s\n", error->message);
+		g_error_free (error);
+		return EXIT_FAILURE;
+	}
+
+	g_option_context_free (context);
+
+	arv_debug_enable (arv_option_debug_domains);
+
+	if (arv_option_n_iterations <= 0 || arv_option_n_parses <= 0) {
+		g_print ("Invalid iteration count\n");
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; arv_option_filenames != NULL && arv_option_filenames[i] != NULL; i++) {
+		char *contents;
+		char *basename;
+
+		if (!g_file_get_contents (arv_option_filenames[i], &contents, &size, &error)) {
+			fprintf (stderr, "Failed to load '%s': %s\n", arv_option_filenames[i], error->message);
+			g_clear_error (&error);
+			continue;
+		}
+
+		basename = g_path_get_basename (arv_option_filenames[i]);
+		benchmark_parse (basename, contents, size);
+		g_free (basename);
+		g_free (contents);
+	}
+
+	device = arv_fake_device_new ("TEST0", &error);
+	if (!ARV_IS_DEVICE (device)) {
+		fprintf (stderr, "Failed to create the fake device: %s\n", error != NULL ? error->message : "");
+		g_clear_error (&error);
+		return EXIT_FAILURE;
+	}
+
+	xml = arv_device_get_genicam_xml (device, &size);
+	if (xml != NULL)
+		benchmark_parse ("arv-fake-camera.xml", xml, size);
+
+	benchmark_device (device);
+
+	g_object_unref (device);
+
+	return EXIT_SUCCESS;
+}
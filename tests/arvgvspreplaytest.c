@@ -0,0 +1,630 @@
+#include <arv.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/arvgvspprivate.h"
+#include "../src/arvgvcpprivate.h"
+#include "../src/arvgvstreamprivate.h"
+
+/*
+ * Offline benchmark of the GVSP frame reassembly. The packets, either read from a pcap capture or generated with
+ * configurable loss, reordering and duplication, are fed to an offline GV stream in a tight loop, without network.
+ */
+
+static char *arv_option_pcap = NULL;
+static int arv_option_port = 0;
+static int arv_option_width = 1920;
+static int arv_option_height = 1080;
+static int arv_option_packet_size = 1500;
+static int arv_option_n_frames = 500;
+static int arv_option_n_loops = 10;
+static int arv_option_n_buffers = 16;
+static double arv_option_loss = 0.0;
+static double arv_option_reorder = 0.0;
+static double arv_option_duplicate = 0.0;
+static double arv_option_link_speed = 10.0;
+static gboolean arv_option_no_resend = FALSE;
+static gboolean arv_option_no_timing_statistics = FALSE;
+static gboolean arv_option_header = FALSE;
+static int arv_option_seed = 1;
+static char *arv_option_debug_domains = NULL;
+
+static const GOptionEntry arv_option_entries[] =
+{
+	{ "pcap",		'f', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_pcap,		"Replay the GVSP packets of a pcap capture", "filename"},
+	{ "port",		'p', 0, G_OPTION_ARG_INT,
+		&arv_option_port,		"GVSP destination port of the captured packets", "port"},
+	{ "width",		'w', 0, G_OPTION_ARG_INT,
+		&arv_option_width,		"Synthetic image width", "width"},
+	{ "height",		'h', 0, G_OPTION_ARG_INT,
+		&arv_option_height,		"Synthetic image height", "height"},
+	{ "packet-size",	's', 0, G_OPTION_ARG_INT,
+		&arv_option_packet_size,	"Synthetic packet size, including IP and UDP headers", "size"},
+	{ "frames",		'n', 0, G_OPTION_ARG_INT,
+		&arv_option_n_frames,		"Number of synthetic frames", "n_frames"},
+	{ "loops",		'l', 0, G_OPTION_ARG_INT,
+		&arv_option_n_loops,		"Number of replays of the packet list", "n_loops"},
+	{ "buffers",		'b', 0, G_OPTION_ARG_INT,
+		&arv_option_n_buffers,		"Number of stream buffers", "n_buffers"},
+	{ "loss",		'\0', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_loss,		"Synthetic packet loss ratio", "ratio"},
+	{ "reorder",		'\0', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_reorder,		"Synthetic packet reordering ratio", "ratio"},
+	{ "duplicate",		'\0', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_duplicate,		"Synthetic packet duplication ratio", "ratio"},
+	{ "link-speed",		'\0', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_link_speed,		"Simulated link speed of the synthetic packets", "Gbit/s"},
+	{ "no-resend",		'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_no_resend,		"Disable packet resend requests", NULL},
+	{ "no-timing-statistics",	'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_no_timing_statistics, "Disable the packet timing histograms", NULL},
+	{ "header",		'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_header,		"Also benchmark the GVSP header decoding alone", NULL},
+	{ "seed",		'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_seed,		"Random seed of the synthetic traffic", "seed"},
+	{ "debug",		'd', 0, G_OPTION_ARG_STRING,
+		&arv_option_debug_domains,	NULL, "{<category>[:<level>][,...]|help}"},
+	{ NULL }
+};
+
+/* Allocation counting, by interposition of the glibc allocator */
+
+static gint n_allocations = 0;
+static gboolean count_allocations = FALSE;
+
+#if defined (__GLIBC__)
+#define HAS_ALLOCATION_COUNT 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+	if (count_allocations)
+		g_atomic_int_inc (&n_allocations);
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	if (count_allocations)
+		g_atomic_int_inc (&n_allocations);
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	if (count_allocations)
+		g_atomic_int_inc (&n_allocations);
+	return __libc_realloc (ptr, size);
+}
+#else
+#define HAS_ALLOCATION_COUNT 0
+#endif
+
+/* Packet list, stored in a single memory block */
+
+typedef struct {
+	size_t offset;
+	size_t size;
+	guint64 time_us;
+} Packet;
+
+typedef struct {
+	GByteArray *data;
+	GArray *packets;
+	guint packet_size;
+	size_t payload;
+	guint64 duration_us;
+} PacketList;
+
+static void
+packet_list_append (PacketList *list, const void *packet, size_t size, guint64 time_us)
+{
+	Packet p;
+
+	p.offset = list->data->len;
+	p.size = size;
+	p.time_us = time_us;
+
+	g_byte_array_append (list->data, packet, size);
+	g_array_append_val (list->packets, p);
+}
+
+static void
+packet_list_init (PacketList *list)
+{
+	list->data = g_byte_array_new ();
+	list->packets = g_array_new (FALSE, FALSE, sizeof (Packet));
+	list->packet_size = 0;
+	list->payload = 0;
+	list->duration_us = 0;
+}
+
+static void
+packet_list_clear (PacketList *list)
+{
+	g_byte_array_unref (list->data);
+	g_array_unref (list->packets);
+}
+
+/* Synthetic traffic */
+
+static void
+generate_packets (PacketList *list)
+{
+	GRand *rand;
+	GArray *frame_packets;
+	guint8 packet[ARV_GVSP_MAXIMUM_PACKET_SIZE];
+	guint8 *data;
+	size_t block_size;
+	double packet_duration_us;
+	guint64 n_sent = 0;
+	guint n_blocks;
+	int f;
+
+	rand = g_rand_new_with_seed (arv_option_seed);
+	frame_packets = g_array_new (FALSE, FALSE, sizeof (Packet));
+
+	list->payload = (size_t) arv_option_width * arv_option_height;
+	list->packet_size = arv_option_packet_size;
+
+	block_size = arv_option_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+	n_blocks = (list->payload + block_size - 1) / block_size;
+	packet_duration_us = arv_option_packet_size * 8.0 / (arv_option_link_speed * 1000.0);
+
+	data = g_malloc0 (block_size);
+
+	for (f = 0; f < arv_option_n_frames; f++) {
+		guint16 frame_id = (f % 65535) + 1;
+		size_t packet_size;
+		guint i;
+
+		g_array_set_size (frame_packets, 0);
+
+		/* The frame packets are first generated in the packet list, then appended in their arrival order */
+		for (i = 0; i < n_blocks + 2; i++) {
+			Packet p;
+
+			packet_size = sizeof (packet);
+			if (i == 0)
+				arv_gvsp_packet_new_data_leader (frame_id, 0, n_sent, ARV_PIXEL_FORMAT_MONO_8,
+								 arv_option_width, arv_option_height, 0, 0,
+								 packet, &packet_size);
+			else if (i == n_blocks + 1)
+				arv_gvsp_packet_new_data_trailer (frame_id, i, packet, &packet_size);
+			else
+				arv_gvsp_packet_new_data_block (frame_id, i,
+								MIN (block_size, list->payload - (i - 1) * block_size),
+								data, packet, &packet_size);
+
+			p.offset = list->data->len;
+			p.size = packet_size;
+			p.time_us = 0;
+			g_byte_array_append (list->data, packet, packet_size);
+
+			if (g_rand_double (rand) < arv_option_loss)
+				continue;
+
+			g_array_append_val (frame_packets, p);
+			if (g_rand_double (rand) < arv_option_duplicate)
+				g_array_append_val (frame_packets, p);
+		}
+
+		for (i = 0; i + 1 < frame_packets->len; i++) {
+			if (g_rand_double (rand) < arv_option_reorder) {
+				Packet p = g_array_index (frame_packets, Packet, i);
+
+				g_array_index (frame_packets, Packet, i) = g_array_index (frame_packets, Packet, i + 1);
+				g_array_index (frame_packets, Packet, i + 1) = p;
+				i++;
+			}
+		}
+
+		for (i = 0; i < frame_packets->len; i++) {
+			Packet p = g_array_index (frame_packets, Packet, i);
+
+			p.time_us = n_sent * packet_duration_us;
+			g_array_append_val (list->packets, p);
+			n_sent++;
+		}
+	}
+
+	list->duration_us = n_sent * packet_duration_us;
+
+	g_free (data);
+	g_array_unref (frame_packets);
+	g_rand_free (rand);
+}
+
+/* Pcap capture reading */
+
+#define PCAP_MAGIC		0xa1b2c3d4
+#define PCAP_MAGIC_NS		0xa1b23c4d
+
+#define PCAP_LINKTYPE_NULL	0
+#define PCAP_LINKTYPE_ETHERNET	1
+#define PCAP_LINKTYPE_RAW	101
+#define PCAP_LINKTYPE_LINUX_SLL	113
+#define PCAP_LINKTYPE_IPV4	228
+#define PCAP_LINKTYPE_LINUX_SLL2	276
+
+static guint32
+_read_32 (const guint8 *data, gboolean swap)
+{
+	guint32 value;
+
+	memcpy (&value, data, sizeof (value));
+
+	return swap ? GUINT32_SWAP_LE_BE (value) : value;
+}
+
+static guint16
+_read_be_16 (const guint8 *data)
+{
+	return (data[0] << 8) | data[1];
+}
+
+/* Returns the offset of the IPv4 header in a captured frame, -1 if it is not an IPv4 packet */
+
+static gssize
+_get_ip_offset (guint32 link_type, const guint8 *frame, size_t size, gboolean swap)
+{
+	guint16 ether_type;
+	size_t offset;
+
+	switch (link_type) {
+		case PCAP_LINKTYPE_NULL:
+			return size >= 4 && _read_32 (frame, swap) == 2 ? 4 : -1;
+		case PCAP_LINKTYPE_RAW:
+		case PCAP_LINKTYPE_IPV4:
+			return 0;
+		case PCAP_LINKTYPE_LINUX_SLL:
+			return size >= 16 && _read_be_16 (frame + 14) == 0x0800 ? 16 : -1;
+		case PCAP_LINKTYPE_LINUX_SLL2:
+			return size >= 20 && _read_be_16 (frame) == 0x0800 ? 20 : -1;
+		case PCAP_LINKTYPE_ETHERNET:
+			offset = 12;
+			if (size < offset + 2)
+				return -1;
+			ether_type = _read_be_16 (frame + offset);
+			/* VLAN tags */
+			while ((ether_type == 0x8100 || ether_type == 0x88a8) && size >= offset + 6) {
+				offset += 4;
+				ether_type = _read_be_16 (frame + offset);
+			}
+			return ether_type == 0x0800 ? offset + 2 : -1;
+		default:
+			return -1;
+	}
+}
+
+static gboolean
+read_pcap (PacketList *list, const char *filename, GError **error)
+{
+	GHashTable *frame_sizes;
+	GHashTableIter iter;
+	gpointer value;
+	char *contents;
+	size_t length;
+	size_t offset;
+	gboolean swap;
+	gboolean is_ns;
+	guint32 magic;
+	guint32 link_type;
+	guint64 first_time_us = 0;
+	guint64 time_us = 0;
+	guint n_skipped = 0;
+
+	if (!g_file_get_contents (filename, &contents, &length, error))
+		return FALSE;
+
+	if (length < 24) {
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "Truncated pcap header");
+		g_free (contents);
+		return FALSE;
+	}
+
+	memcpy (&magic, contents, sizeof (magic));
+	swap = magic == GUINT32_SWAP_LE_BE (PCAP_MAGIC) || magic == GUINT32_SWAP_LE_BE (PCAP_MAGIC_NS);
+	magic = swap ? GUINT32_SWAP_LE_BE (magic) : magic;
+	if (magic != PCAP_MAGIC && magic != PCAP_MAGIC_NS) {
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "Not a pcap file (pcapng is not supported)");
+		g_free (contents);
+		return FALSE;
+	}
+	is_ns = magic == PCAP_MAGIC_NS;
+	link_type = _read_32 ((guint8 *) contents + 20, swap) & 0xffff;
+
+	/* Data size of each frame, for the buffer size */
+	frame_sizes = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	for (offset = 24; offset + 16 <= length; ) {
+		const guint8 *record = (guint8 *) contents + offset;
+		const guint8 *ip;
+		const guint8 *udp;
+		const ArvGvspPacket *packet;
+		size_t captured_size;
+		size_t ip_header_size;
+		size_t udp_size;
+		gssize ip_offset;
+
+		captured_size = _read_32 (record + 8, swap);
+		if (offset + 16 + captured_size > length)
+			break;
+		offset += 16 + captured_size;
+
+		time_us = (guint64) _read_32 (record, swap) * 1000000 +
+			_read_32 (record + 4, swap) / (is_ns ? 1000 : 1);
+		if (list->packets->len == 0)
+			first_time_us = time_us;
+
+		ip_offset = _get_ip_offset (link_type, record + 16, captured_size, swap);
+		ip = record + 16 + ip_offset;
+		if (ip_offset < 0 || captured_size < ip_offset + 20 ||
+		    (ip[0] >> 4) != 4 || ip[9] != 17 ||
+		    (_read_be_16 (ip + 6) & 0x3fff) != 0) {
+			/* Not an unfragmented IPv4 UDP packet */
+			n_skipped++;
+			continue;
+		}
+
+		ip_header_size = (ip[0] & 0x0f) * 4;
+		udp = ip + ip_header_size;
+		if (captured_size < ip_offset + ip_header_size + 8) {
+			n_skipped++;
+			continue;
+		}
+
+		if ((arv_option_port != 0 && _read_be_16 (udp + 2) != arv_option_port) ||
+		    (arv_option_port == 0 && (_read_be_16 (udp) == ARV_GVCP_PORT ||
+					      _read_be_16 (udp + 2) == ARV_GVCP_PORT))) {
+			n_skipped++;
+			continue;
+		}
+
+		udp_size = MIN (_read_be_16 (udp + 4), captured_size - ip_offset - ip_header_size);
+		if (udp_size < 8 + sizeof (ArvGvspPacket) + sizeof (ArvGvspHeader)) {
+			n_skipped++;
+			continue;
+		}
+
+		packet = (const ArvGvspPacket *) (udp + 8);
+		packet_list_append (list, packet, udp_size - 8, time_us - first_time_us);
+
+		list->packet_size = MAX (list->packet_size, ip_header_size + udp_size);
+
+		if (arv_gvsp_packet_get_content_type (packet) == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK) {
+			gpointer key = GSIZE_TO_POINTER (arv_gvsp_packet_get_frame_id (packet));
+			size_t frame_size = GPOINTER_TO_SIZE (g_hash_table_lookup (frame_sizes, key));
+
+			frame_size += arv_gvsp_packet_get_data_size (packet, udp_size - 8);
+			g_hash_table_insert (frame_sizes, key, GSIZE_TO_POINTER (frame_size));
+		}
+	}
+
+	g_hash_table_iter_init (&iter, frame_sizes);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		list->payload = MAX (list->payload, GPOINTER_TO_SIZE (value));
+
+	list->duration_us = time_us - first_time_us;
+
+	g_hash_table_unref (frame_sizes);
+	g_free (contents);
+
+	if (n_skipped > 0)
+		printf ("Skipped %u non GVSP packets\n", n_skipped);
+
+	if (list->packets->len == 0 || list->payload == 0) {
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "No GVSP data found in '%s'", filename);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Compares the header decoding of the packet list, field by field with the accessors and at once. The checksum keeps
+ * the compiler from discarding the loops. */
+
+static void
+benchmark_header (PacketList *list)
+{
+	guint64 checksum = 0;
+	guint64 start_us;
+	double accessor_s;
+	double parse_s;
+	guint64 n_packets;
+	int loop;
+	guint i;
+
+	n_packets = (guint64) list->packets->len * arv_option_n_loops * 10;
+
+	start_us = g_get_monotonic_time ();
+	for (loop = 0; loop < arv_option_n_loops * 10; loop++) {
+		for (i = 0; i < list->packets->len; i++) {
+			const ArvGvspPacket *packet = (const void *)
+				(list->data->data + g_array_index (list->packets, Packet, i).offset);
+
+			checksum += arv_gvsp_packet_get_packet_type (packet);
+			checksum += arv_gvsp_packet_has_extended_ids (packet);
+			checksum += arv_gvsp_packet_get_frame_id (packet);
+			checksum += arv_gvsp_packet_get_packet_id (packet);
+			checksum += arv_gvsp_packet_get_content_type (packet);
+			checksum += GPOINTER_TO_SIZE (arv_gvsp_packet_get_data (packet));
+		}
+	}
+	accessor_s = (g_get_monotonic_time () - start_us) / 1e6;
+
+	start_us = g_get_monotonic_time ();
+	for (loop = 0; loop < arv_option_n_loops * 10; loop++) {
+		for (i = 0; i < list->packets->len; i++) {
+			const ArvGvspPacket *packet = (const void *)
+				(list->data->data + g_array_index (list->packets, Packet, i).offset);
+			ArvGvspHeaderInfos header;
+
+			arv_gvsp_packet_parse_header (packet, &header);
+
+			checksum -= header.packet_type;
+			checksum -= header.extended_ids;
+			checksum -= header.frame_id;
+			checksum -= header.packet_id;
+			checksum -= header.content_type;
+			checksum -= GPOINTER_TO_SIZE (header.data);
+		}
+	}
+	parse_s = (g_get_monotonic_time () - start_us) / 1e6;
+
+	printf ("Header:      %.2f ns/packet with accessors, %.2f ns/packet parsed at once%s\n",
+		accessor_s * 1e9 / n_packets, parse_s * 1e9 / n_packets,
+		checksum == 0 ? "" : " (mismatch)");
+}
+
+int
+main (int argc, char **argv)
+{
+	PacketList list;
+	GOptionContext *context;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 n_processed_packets = 0;
+	guint64 n_processed_bytes = 0;
+	guint64 n_completed_frames = 0;
+	guint64 n_failed_frames = 0;
+	guint64 start_us;
+	guint64 time_us = 0;
+	double elapsed_s;
+	int loop;
+	guint i;
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "Offline benchmark of the GVSP frame reassembly.");
+	g_option_context_add_main_entries (context, arv_option_entries, NULL);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_option_context_free (context);
+		g_print ("Option parsing failed: %s\n", error->message);
+		g_error_free (error);
+		return EXIT_FAILURE;
+	}
+
+	g_option_context_free (context);
+
+	if (!arv_debug_enable (arv_option_debug_domains)) {
+		if (g_strcmp0 (arv_option_debug_domains, "help") != 0)
+			printf ("Invalid debug selection\n");
+		else
+			arv_debug_print_infos ();
+		return EXIT_FAILURE;
+	}
+
+	if (arv_option_packet_size <= (int) ARV_GVSP_PACKET_PROTOCOL_OVERHEAD ||
+	    arv_option_packet_size > ARV_GVSP_MAXIMUM_PACKET_SIZE ||
+	    arv_option_width <= 0 || arv_option_height <= 0 ||
+	    arv_option_n_buffers <= 0 || arv_option_link_speed <= 0.0) {
+		printf ("Invalid parameters\n");
+		return EXIT_FAILURE;
+	}
+
+	packet_list_init (&list);
+
+	if (arv_option_pcap != NULL) {
+		if (!read_pcap (&list, arv_option_pcap, &error)) {
+			printf ("Failed to read '%s': %s\n", arv_option_pcap, error->message);
+			g_clear_error (&error);
+			packet_list_clear (&list);
+			return EXIT_FAILURE;
+		}
+	} else
+		generate_packets (&list);
+
+	printf ("Packets:     %u per loop, %u bytes maximum\n", list.packets->len, list.packet_size);
+	printf ("Frame size:  %" G_GSIZE_FORMAT " bytes\n", list.payload);
+
+	if (arv_option_header)
+		benchmark_header (&list);
+
+	stream = arv_gv_stream_new_offline (list.packet_size, &error);
+	if (stream == NULL) {
+		printf ("Failed to create the stream: %s\n", error->message);
+		g_clear_error (&error);
+		packet_list_clear (&list);
+		return EXIT_FAILURE;
+	}
+
+	g_object_set (stream, "packet-resend", arv_option_no_resend ?
+		      ARV_GV_STREAM_PACKET_RESEND_NEVER : ARV_GV_STREAM_PACKET_RESEND_ALWAYS,
+		      "timing-statistics", !arv_option_no_timing_statistics, NULL);
+
+	for (i = 0; i < (guint) arv_option_n_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new_allocate (list.payload));
+
+	count_allocations = TRUE;
+	start_us = g_get_monotonic_time ();
+
+	for (loop = 0; loop < arv_option_n_loops; loop++) {
+		/* Each loop is a new acquisition, later in time */
+		guint64 loop_time_us = (guint64) loop * (list.duration_us + 1000000);
+
+		for (i = 0; i < list.packets->len; i++) {
+			Packet *p = &g_array_index (list.packets, Packet, i);
+
+			time_us = loop_time_us + p->time_us;
+			arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), list.data->data + p->offset,
+							      p->size, time_us);
+			n_processed_packets++;
+			n_processed_bytes += p->size;
+
+			while ((buffer = arv_stream_try_pop_buffer (stream)) != NULL) {
+				if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+					n_completed_frames++;
+				else
+					n_failed_frames++;
+				arv_stream_push_buffer (stream, buffer);
+			}
+		}
+
+		/* Let the incomplete frames time out */
+		arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), NULL, 0, time_us + 1000000);
+		arv_gv_stream_offline_flush (ARV_GV_STREAM (stream), time_us + 1000000);
+		while ((buffer = arv_stream_try_pop_buffer (stream)) != NULL) {
+			if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+				n_completed_frames++;
+			else
+				n_failed_frames++;
+			arv_stream_push_buffer (stream, buffer);
+		}
+	}
+
+	elapsed_s = (g_get_monotonic_time () - start_us) / 1e6;
+	count_allocations = FALSE;
+
+	printf ("Elapsed:     %.3f s\n", elapsed_s);
+	printf ("Packets:     %" G_GUINT64_FORMAT " (%.0f packets/s)\n",
+		n_processed_packets, n_processed_packets / elapsed_s);
+	printf ("Frames:      %" G_GUINT64_FORMAT " completed, %" G_GUINT64_FORMAT " failed (%.0f frames/s)\n",
+		n_completed_frames, n_failed_frames, (n_completed_frames + n_failed_frames) / elapsed_s);
+	printf ("Throughput:  %.2f Gbit/s\n", n_processed_bytes * 8.0 / elapsed_s / 1e9);
+	printf ("Resend:      %" G_GUINT64_FORMAT " packet requests, %" G_GUINT64_FORMAT " ratio reached, %"
+		G_GUINT64_FORMAT " duplicated packets\n",
+		arv_stream_get_info_uint64_by_name (stream, "n_resend_requests"),
+		arv_stream_get_info_uint64_by_name (stream, "n_resend_ratio_reached"),
+		arv_stream_get_info_uint64_by_name (stream, "n_duplicated_packets"));
+	printf ("Missing:     %" G_GUINT64_FORMAT " packets, %" G_GUINT64_FORMAT " frames\n",
+		arv_stream_get_info_uint64_by_name (stream, "n_missing_packets"),
+		arv_stream_get_info_uint64_by_name (stream, "n_missing_frames"));
+	if (HAS_ALLOCATION_COUNT)
+		printf ("Allocations: %d (%.2f per frame)\n", n_allocations,
+			n_completed_frames + n_failed_frames > 0 ?
+			(double) n_allocations / (n_completed_frames + n_failed_frames) : 0.0);
+
+	g_object_unref (stream);
+	packet_list_clear (&list);
+
+	return EXIT_SUCCESS;
+}
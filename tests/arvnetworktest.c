@@ -38,6 +38,9 @@ main (int argc, char **argv){
 				   &((struct sockaddr_in*)arv_network_interface_get_broadaddr(ani))->sin_addr,
 				   &broadaddr[0], _ALEN);
 			printf (_LINEFMT, "IPv4", addr, netmask, broadaddr, arv_network_interface_get_name(ani));
+			printf ("      mtu %u, speed %u Mb/s, numa node %d, %u rx queues\r\n",
+				arv_network_interface_get_mtu (ani), arv_network_interface_get_link_speed (ani),
+				arv_network_interface_get_numa_node (ani), arv_network_interface_get_n_rx_queues (ani));
 		}
 		else if (fam==AF_INET6){
 			fprintf (stderr,"%s: IPv6 not yet reported correctly", arv_network_interface_get_name(ani));
@@ -1,5 +1,10 @@
 #include <glib.h>
 #include <arv.h>
+#include <string.h>
+#include <arvbufferprivate.h>
+#if ARAVIS_HAS_JPEG
+#include <turbojpeg.h>
+#endif
 
 static void
 simple_buffer_test (void)
@@ -113,6 +118,863 @@ allocate (void)
 	g_object_unref (buffer);
 }
 
+static void
+buffer_pool_test (void)
+{
+	ArvBufferPool *pool;
+	ArvBuffer *buffers[4];
+	GError *error = NULL;
+	const guint8 *data[4];
+	int i;
+
+	pool = arv_buffer_pool_new_full (4, 1000, 256, ARV_BUFFER_POOL_FLAGS_NONE, -1, &error);
+	g_assert (ARV_IS_BUFFER_POOL (pool));
+	g_assert_no_error (error);
+
+	g_assert_cmpint (arv_buffer_pool_get_n_buffers (pool), ==, 4);
+	g_assert_cmpint (arv_buffer_pool_get_buffer_size (pool), ==, 1000);
+	g_assert_cmpint (arv_buffer_pool_get_n_free_buffers (pool), ==, 4);
+
+	for (i = 0; i < 4; i++) {
+		buffers[i] = arv_buffer_pool_pop_buffer (pool);
+		g_assert (ARV_IS_BUFFER (buffers[i]));
+		data[i] = arv_buffer_get_data (buffers[i], NULL);
+		g_assert_cmpint (GPOINTER_TO_SIZE (data[i]) % 256, ==, 0);
+	}
+
+	g_assert (arv_buffer_pool_pop_buffer (pool) == NULL);
+
+	/* Buffers are contiguous in the pool memory */
+	for (i = 1; i < 4; i++)
+		g_assert (data[i] == data[0] + 1024 * i);
+
+	/* Dropping the last reference gives the buffer back to the pool */
+	g_object_unref (buffers[1]);
+	g_assert_cmpint (arv_buffer_pool_get_n_free_buffers (pool), ==, 1);
+	buffers[1] = arv_buffer_pool_pop_buffer (pool);
+	g_assert (arv_buffer_get_data (buffers[1], NULL) == data[1]);
+
+	g_object_unref (buffers[0]);
+	g_object_unref (buffers[1]);
+
+	/* Buffers still in use outlive the pool */
+	g_object_unref (pool);
+
+	memset ((void *) data[2], 0x55, 1000);
+	g_object_unref (buffers[2]);
+	g_object_unref (buffers[3]);
+}
+
+static void
+multipart_buffer_test (void)
+{
+	ArvBuffer *buffer;
+	const char *data;
+	const char *part_data;
+	size_t size;
+	gint width, height;
+
+	buffer = arv_buffer_new (1024, NULL);
+	data = arv_buffer_get_data (buffer, NULL);
+
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 0);
+
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->received_size = 100;
+	buffer->priv->width = 10;
+	buffer->priv->height = 10;
+	buffer->priv->pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 1);
+	g_assert (arv_buffer_get_part_data (buffer, 0, &size) == data);
+	g_assert_cmpint (size, ==, 100);
+	g_assert_cmpint (arv_buffer_get_part_pixel_format (buffer, 0), ==, ARV_PIXEL_FORMAT_MONO_8);
+
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
+	arv_buffer_set_n_parts (buffer, 2);
+	buffer->priv->parts[0].size = 200;
+	buffer->priv->parts[0].data_type = ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE;
+	buffer->priv->parts[0].pixel_format = ARV_PIXEL_FORMAT_MONO_16;
+	buffer->priv->parts[0].width = 10;
+	buffer->priv->parts[0].height = 10;
+	buffer->priv->parts[1].data_offset = 200;
+	buffer->priv->parts[1].size = 100;
+	buffer->priv->parts[1].component_id = 2;
+	buffer->priv->parts[1].data_type = ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP;
+
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 2);
+
+	part_data = arv_buffer_get_part_data (buffer, 0, &size);
+	g_assert (part_data == data);
+	g_assert_cmpint (size, ==, 200);
+	g_assert_cmpint (arv_buffer_get_part_data_type (buffer, 0), ==, ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE);
+	arv_buffer_get_part_region (buffer, 0, NULL, NULL, &width, &height);
+	g_assert_cmpint (width, ==, 10);
+	g_assert_cmpint (height, ==, 10);
+
+	part_data = arv_buffer_get_part_data (buffer, 1, &size);
+	g_assert (part_data == data + 200);
+	g_assert_cmpint (size, ==, 100);
+	g_assert_cmpint (arv_buffer_get_part_component_id (buffer, 1), ==, 2);
+	g_assert_cmpint (arv_buffer_get_part_data_type (buffer, 1), ==, ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP);
+
+	g_object_unref (buffer);
+}
+
+static void
+_set_image (ArvBuffer *buffer, ArvPixelFormat pixel_format, gint width, gint height, size_t size)
+{
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->pixel_format = pixel_format;
+	buffer->priv->width = width;
+	buffer->priv->height = height;
+	buffer->priv->received_size = size;
+}
+
+static void
+convert_test (void)
+{
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint8 *data;
+	guint16 pixels[20], unpacked[2 * 20];
+	guint8 rgb[4 * 4 * 3];
+	gboolean success;
+	int i;
+
+	buffer = arv_buffer_new (1024, NULL);
+	data = (guint8 *) arv_buffer_get_data (buffer, NULL);
+
+	for (i = 0; i < 20; i++)
+		pixels[i] = (i * 0x123 + 0x45) & 0xfff;
+
+	/* 12 bit packed, 2 rows of 20 pixels, long enough for the vectorized path */
+
+	for (i = 0; i < 2 * 10; i++) {
+		guint16 p0 = pixels[(2 * i) % 20];
+		guint16 p1 = pixels[(2 * i + 1) % 20];
+
+		data[3 * i] = p0 & 0xff;
+		data[3 * i + 1] = (p0 >> 8) | ((p1 & 0x0f) << 4);
+		data[3 * i + 2] = p1 >> 4;
+	}
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12P, 20, 2, 60);
+
+	success = arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_12, unpacked, 0, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+	for (i = 0; i < 40; i++)
+		g_assert_cmpint (unpacked[i], ==, pixels[i % 20]);
+
+	for (i = 0; i < 2 * 10; i++) {
+		guint16 p0 = pixels[(2 * i) % 20];
+		guint16 p1 = pixels[(2 * i + 1) % 20];
+
+		data[3 * i] = p0 >> 4;
+		data[3 * i + 1] = (p0 & 0x0f) | ((p1 & 0x0f) << 4);
+		data[3 * i + 2] = p1 >> 4;
+	}
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12_PACKED, 20, 2, 60);
+
+	success = arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_16, unpacked, 0, &error);
+	g_assert (success);
+	for (i = 0; i < 40; i++)
+		g_assert_cmpint (unpacked[i], ==, pixels[i % 20] << 4);
+
+	/* PFNC 10 bit packed, 4 pixels in 5 bytes */
+
+	for (i = 0; i < 2; i++) {
+		guint16 p0 = pixels[4 * i] & 0x3ff, p1 = pixels[4 * i + 1] & 0x3ff;
+		guint16 p2 = pixels[4 * i + 2] & 0x3ff, p3 = pixels[4 * i + 3] & 0x3ff;
+
+		data[5 * i] = p0 & 0xff;
+		data[5 * i + 1] = (p0 >> 8) | ((p1 & 0x3f) << 2);
+		data[5 * i + 2] = (p1 >> 6) | ((p2 & 0x0f) << 4);
+		data[5 * i + 3] = (p2 >> 4) | ((p3 & 0x03) << 6);
+		data[5 * i + 4] = p3 >> 2;
+	}
+	memcpy (data + 10, data, 10);
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_10P, 8, 2, 20);
+
+	success = arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_10, unpacked, 0, &error);
+	g_assert (success);
+	for (i = 0; i < 16; i++)
+		g_assert_cmpint (unpacked[i], ==, pixels[i % 8] & 0x3ff);
+
+	/* Demosaic of a uniform image */
+
+	memset (data, 100, 16);
+	_set_image (buffer, ARV_PIXEL_FORMAT_BAYER_RG_8, 4, 4, 16);
+
+	success = arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_RGB_8_PACKED, rgb, 0, &error);
+	g_assert (success);
+	for (i = 0; i < 4 * 4 * 3; i++)
+		g_assert_cmpint (rgb[i], ==, 100);
+
+	/* Row range conversion, YUV 4:2:2 black and white pixels */
+
+	memset (rgb, 0x55, sizeof (rgb));
+	for (i = 0; i < 4; i++) {
+		data[8 * i] = 128;
+		data[8 * i + 1] = 235;
+		data[8 * i + 2] = 128;
+		data[8 * i + 3] = 235;
+		data[8 * i + 4] = 128;
+		data[8 * i + 5] = 16;
+		data[8 * i + 6] = 128;
+		data[8 * i + 7] = 16;
+	}
+	_set_image (buffer, ARV_PIXEL_FORMAT_YUV_422_PACKED, 4, 4, 32);
+
+	success = arv_buffer_convert_part_rows (buffer, 0, ARV_PIXEL_FORMAT_BGR_8_PACKED, rgb, 0, 2, 2, &error);
+	g_assert (success);
+	for (i = 0; i < 2 * 4 * 3; i++)
+		g_assert_cmpint (rgb[i], ==, 0x55);
+	for (i = 2 * 4 * 3; i < 4 * 4 * 3; i++)
+		g_assert_cmpint (rgb[i], ==, (i % 12) < 6 ? 255 : 0);
+
+	g_assert (!arv_pixel_format_can_convert (ARV_PIXEL_FORMAT_RGB_8_PACKED, ARV_PIXEL_FORMAT_MONO_8));
+	success = arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_8, rgb, 0, &error);
+	g_assert (!success);
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION);
+	g_clear_error (&error);
+
+	g_object_unref (buffer);
+}
+
+static void
+unpack_pixels_test (void)
+{
+	ArvBuffer *buffer;
+	guint8 *data;
+	const guint16 *unpacked;
+	size_t size;
+	int i;
+
+	buffer = arv_buffer_new (4 * 100, NULL);
+	data = (guint8 *) arv_buffer_get_data (buffer, NULL);
+
+	for (i = 0; i < 100; i++) {
+		data[3 * i] = i;
+		data[3 * i + 1] = 0x21;
+		data[3 * i + 2] = 0x43;
+	}
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12P, 20, 10, 300);
+
+	g_assert (arv_buffer_unpack_pixels (buffer));
+	g_assert_cmpint (arv_buffer_get_image_pixel_format (buffer), ==, ARV_PIXEL_FORMAT_MONO_12);
+
+	unpacked = arv_buffer_get_data (buffer, &size);
+	g_assert_cmpint (size, ==, 400);
+	for (i = 0; i < 100; i++) {
+		g_assert_cmpint (unpacked[2 * i], ==, 0x100 | i);
+		g_assert_cmpint (unpacked[2 * i + 1], ==, 0x432);
+	}
+
+	/* Already unpacked */
+	g_assert (!arv_buffer_unpack_pixels (buffer));
+
+	/* Buffer too small for the unpacked image */
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12_PACKED, 20, 20, 400);
+	g_assert (!arv_buffer_unpack_pixels (buffer));
+
+	g_object_unref (buffer);
+}
+
+static void
+valid_ranges_test (void)
+{
+	ArvBuffer *buffer;
+	const ArvBufferRange *ranges;
+	guint n_ranges;
+
+	buffer = arv_buffer_new_allocate (64);
+
+	ranges = arv_buffer_get_valid_ranges (buffer, &n_ranges);
+	g_assert (ranges == NULL);
+	g_assert_cmpuint (n_ranges, ==, 0);
+
+	/* Contiguous ranges are merged */
+	arv_buffer_add_valid_range (buffer, 0, 10);
+	arv_buffer_add_valid_range (buffer, 10, 5);
+	arv_buffer_add_valid_range (buffer, 20, 4);
+	arv_buffer_add_valid_range (buffer, 30, 0);
+
+	ranges = arv_buffer_get_valid_ranges (buffer, &n_ranges);
+	g_assert (ranges != NULL);
+	g_assert_cmpuint (n_ranges, ==, 2);
+	g_assert_cmpuint (ranges[0].offset, ==, 0);
+	g_assert_cmpuint (ranges[0].size, ==, 15);
+	g_assert_cmpuint (ranges[1].offset, ==, 20);
+	g_assert_cmpuint (ranges[1].size, ==, 4);
+	g_assert_cmpuint (arv_buffer_get_valid_size (buffer), ==, 19);
+
+	g_object_unref (buffer);
+}
+
+static void
+statistics_test (void)
+{
+	ArvBuffer *buffer;
+	guint8 *data;
+	guint16 *values;
+	const guint32 *histogram;
+	const double *grid_means;
+	guint n_bins, grid_size;
+	guint minimum, maximum;
+	int i;
+
+	buffer = arv_buffer_new (200, NULL);
+	data = (guint8 *) arv_buffer_get_data (buffer, NULL);
+	for (i = 0; i < 200; i++)
+		data[i] = i;
+	data[199] = 255;
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 20, 10, 200);
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+
+	g_assert (!arv_buffer_has_statistics (buffer));
+
+	/* Accumulated block by block */
+	arv_buffer_statistics_start (buffer, 2);
+	arv_buffer_statistics_add_block (buffer, 64, 64);
+	arv_buffer_statistics_add_block (buffer, 0, 64);
+	arv_buffer_statistics_add_block (buffer, 128, 72);
+	g_assert (arv_buffer_statistics_finish (buffer, 2));
+
+	g_assert (arv_buffer_has_statistics (buffer));
+	g_assert_cmpint (arv_buffer_get_statistics_n_channels (buffer), ==, 1);
+	histogram = arv_buffer_get_statistics_histogram (buffer, 0, &n_bins);
+	g_assert_nonnull (histogram);
+	g_assert_cmpint (n_bins, ==, 256);
+	g_assert_cmpint (histogram[5], ==, 1);
+	g_assert_cmpint (histogram[199], ==, 0);
+	g_assert_cmpint (histogram[255], ==, 1);
+	g_assert (arv_buffer_get_statistics_range (buffer, 0, &minimum, &maximum));
+	g_assert_cmpint (minimum, ==, 0);
+	g_assert_cmpint (maximum, ==, 255);
+	g_assert_cmpint (arv_buffer_get_statistics_n_saturated (buffer, 0), ==, 1);
+	g_assert_cmpfloat_with_epsilon (arv_buffer_get_statistics_mean (buffer, 0), 99.78, 1e-9);
+	grid_means = arv_buffer_get_statistics_grid_means (buffer, &grid_size);
+	g_assert_nonnull (grid_means);
+	g_assert_cmpint (grid_size, ==, 2);
+	g_assert_cmpfloat_with_epsilon (grid_means[0], 44.5, 1e-9);
+	g_assert_cmpfloat_with_epsilon (grid_means[1], 54.5, 1e-9);
+	g_assert_null (arv_buffer_get_statistics_histogram (buffer, 1, NULL));
+
+	/* Statistics of the previous image */
+	buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+	g_assert (!arv_buffer_has_statistics (buffer));
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	arv_buffer_statistics_clear (buffer);
+	g_assert (!arv_buffer_has_statistics (buffer));
+
+	/* Bayer 12 bit image with row padding, the unaligned block forcing a full pass on completion */
+	values = (guint16 *) data;
+	for (i = 0; i < 2; i++) {
+		values[2 * i] = 4095;
+		values[2 * i + 1] = 100;
+		values[5 + 2 * i] = 200;
+		values[5 + 2 * i + 1] = 16;
+	}
+	_set_image (buffer, ARV_PIXEL_FORMAT_BAYER_RG_12, 4, 2, 18);
+	buffer->priv->x_padding = 2;
+
+	arv_buffer_statistics_start (buffer, 0);
+	arv_buffer_statistics_add_block (buffer, 0, 3);
+	g_assert (arv_buffer_statistics_finish (buffer, 0));
+
+	g_assert_cmpint (arv_buffer_get_statistics_n_channels (buffer), ==, 3);
+	g_assert_cmpfloat_with_epsilon (arv_buffer_get_statistics_mean (buffer, 0), 4095.0, 1e-9);
+	g_assert_cmpint (arv_buffer_get_statistics_n_saturated (buffer, 0), ==, 2);
+	g_assert_cmpfloat_with_epsilon (arv_buffer_get_statistics_mean (buffer, 1), 150.0, 1e-9);
+	g_assert (arv_buffer_get_statistics_range (buffer, 1, &minimum, &maximum));
+	g_assert_cmpint (minimum, ==, 100);
+	g_assert_cmpint (maximum, ==, 200);
+	g_assert_cmpint (arv_buffer_get_statistics_n_saturated (buffer, 1), ==, 0);
+	histogram = arv_buffer_get_statistics_histogram (buffer, 2, NULL);
+	g_assert_cmpint (histogram[1], ==, 2);
+	g_assert_null (arv_buffer_get_statistics_grid_means (buffer, NULL));
+
+	/* Unsupported pixel format */
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12_PACKED, 4, 2, 12);
+	buffer->priv->x_padding = 0;
+	g_assert (!arv_buffer_statistics_finish (buffer, 0));
+	g_assert (!arv_buffer_has_statistics (buffer));
+
+	g_object_unref (buffer);
+}
+
+static void
+view_test (void)
+{
+	ArvBuffer *buffer;
+	ArvBuffer *view;
+	ArvBuffer *sub_view;
+	ArvBufferRegion region;
+	const guint8 *data;
+	const guint8 *view_data;
+	guint8 rgb[3 * 3 * 2];
+	size_t size;
+	gint x, y, width, height;
+	int i;
+
+	buffer = arv_buffer_new (200, NULL);
+	data = arv_buffer_get_data (buffer, NULL);
+	for (i = 0; i < 200; i++)
+		((guint8 *) data)[i] = i;
+
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 20, 10, 200);
+	buffer->priv->x_offset = 100;
+	buffer->priv->y_offset = 50;
+	buffer->priv->frame_id = 42;
+
+	g_assert_cmpint (arv_buffer_get_image_stride (buffer), ==, 20);
+
+	view = arv_buffer_new_view (buffer, 4, 2, 8, 5);
+	g_assert (ARV_IS_BUFFER (view));
+
+	/* The view keeps its parent alive */
+	g_object_unref (buffer);
+
+	view_data = arv_buffer_get_data (view, &size);
+	g_assert (view_data == data + 2 * 20 + 4);
+	g_assert_cmpint (size, ==, 4 * 20 + 8);
+	g_assert_cmpint (arv_buffer_get_image_stride (view), ==, 20);
+	g_assert_cmpint (arv_buffer_get_frame_id (view), ==, 42);
+
+	arv_buffer_get_image_region (view, &x, &y, &width, &height);
+	g_assert_cmpint (x, ==, 104);
+	g_assert_cmpint (y, ==, 52);
+	g_assert_cmpint (width, ==, 8);
+	g_assert_cmpint (height, ==, 5);
+
+	sub_view = arv_buffer_new_view (view, 1, 1, 3, 2);
+
+	g_assert (arv_buffer_get_region (view, 1, 1, 3, 2, &region));
+	g_assert (region.data == arv_buffer_get_data (sub_view, NULL));
+	g_assert_cmpint (region.size, ==, 20 + 3);
+	g_assert_cmpint (region.stride, ==, 20);
+	g_assert_cmpint (region.x, ==, 105);
+	g_assert_cmpint (region.y, ==, 53);
+	g_assert_cmpint (region.frame_id, ==, 42);
+
+	g_object_unref (view);
+
+	g_assert (arv_buffer_get_data (sub_view, NULL) == data + 3 * 20 + 5);
+	g_assert_cmpint (arv_buffer_get_image_x (sub_view), ==, 105);
+
+	g_assert (arv_buffer_convert (sub_view, ARV_PIXEL_FORMAT_RGB_8_PACKED, rgb, 0, NULL));
+	for (i = 0; i < 3; i++) {
+		g_assert_cmpint (rgb[3 * i], ==, 3 * 20 + 5 + i);
+		g_assert_cmpint (rgb[9 + 3 * i], ==, 4 * 20 + 5 + i);
+	}
+
+	g_object_unref (sub_view);
+}
+
+static void
+region_views_test (void)
+{
+	ArvBuffer *buffer;
+	ArvBuffer *views[2];
+	ArvBufferRegion region;
+	ArvBufferRegionInfos infos[2] = {
+		{ .offset = 0, .x_offset = 10, .y_offset = 20, .width = 8, .height = 4 },
+		{ .offset = 32, .x_offset = 100, .y_offset = 200, .width = 6, .height = 5 }
+	};
+	GArray *regions;
+	const guint8 *data;
+	size_t size;
+	int i;
+
+	buffer = arv_buffer_new (62, NULL);
+	data = arv_buffer_get_data (buffer, NULL);
+	for (i = 0; i < 62; i++)
+		((guint8 *) data)[i] = i;
+
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 62, 1, 62);
+	buffer->priv->frame_id = 7;
+
+	g_assert_cmpint (arv_buffer_get_n_regions (buffer), ==, 0);
+	g_assert (!arv_buffer_get_region_by_index (buffer, 0, &region));
+
+	regions = g_array_new (FALSE, TRUE, sizeof (ArvBufferRegionInfos));
+	g_array_append_vals (regions, infos, 2);
+	arv_buffer_set_regions (buffer, regions);
+	g_array_unref (regions);
+
+	g_assert_cmpint (arv_buffer_get_n_regions (buffer), ==, 2);
+
+	g_assert (arv_buffer_get_region_by_index (buffer, 1, &region));
+	g_assert (region.data == data + 32);
+	g_assert_cmpint (region.size, ==, 30);
+	g_assert_cmpint (region.stride, ==, 6);
+	g_assert_cmpint (region.x, ==, 100);
+	g_assert_cmpint (region.y, ==, 200);
+	g_assert_cmpint (region.frame_id, ==, 7);
+	g_assert (!arv_buffer_get_region_by_index (buffer, 2, &region));
+
+	for (i = 0; i < 2; i++)
+		views[i] = arv_buffer_new_region_view (buffer, i);
+	g_assert_null (arv_buffer_new_region_view (buffer, 2));
+
+	/* The views keep their parent alive */
+	g_object_unref (buffer);
+
+	g_assert (arv_buffer_get_data (views[0], &size) == data);
+	g_assert_cmpint (size, ==, 32);
+	g_assert_cmpint (arv_buffer_get_image_stride (views[0]), ==, 8);
+	g_assert_cmpint (arv_buffer_get_image_x (views[0]), ==, 10);
+	g_assert_cmpint (arv_buffer_get_image_height (views[0]), ==, 4);
+
+	g_assert (arv_buffer_get_data (views[1], &size) == data + 32);
+	g_assert_cmpint (size, ==, 30);
+	g_assert_cmpint (arv_buffer_get_image_stride (views[1]), ==, 6);
+	g_assert_cmpint (arv_buffer_get_image_width (views[1]), ==, 6);
+	g_assert_cmpint (arv_buffer_get_frame_id (views[1]), ==, 7);
+
+	/* A truncated payload only gives access to the complete regions */
+	buffer = arv_buffer_new (62, NULL);
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 62, 1, 40);
+	regions = g_array_new (FALSE, TRUE, sizeof (ArvBufferRegionInfos));
+	g_array_append_vals (regions, infos, 2);
+	arv_buffer_set_regions (buffer, regions);
+	g_array_unref (regions);
+
+	g_assert (arv_buffer_get_region_by_index (buffer, 0, &region));
+	g_assert (!arv_buffer_get_region_by_index (buffer, 1, &region));
+
+	g_object_unref (buffer);
+	g_object_unref (views[0]);
+	g_object_unref (views[1]);
+}
+
+static void
+import_test (void)
+{
+	ArvBuffer *buffer;
+	char data[100];
+
+	buffer = arv_buffer_new (100, NULL);
+	g_assert_cmpint (arv_buffer_get_memory_type (buffer), ==, ARV_BUFFER_MEMORY_TYPE_SYSTEM);
+	g_assert_cmpint (arv_buffer_get_memory_handle (buffer), ==, 0);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_import (100, data, ARV_BUFFER_MEMORY_TYPE_PINNED, 0x1234, NULL, NULL);
+	g_assert (arv_buffer_get_data (buffer, NULL) == data);
+	g_assert_cmpint (arv_buffer_get_memory_type (buffer), ==, ARV_BUFFER_MEMORY_TYPE_PINNED);
+	g_assert_cmpint (arv_buffer_get_memory_handle (buffer), ==, 0x1234);
+	g_assert_cmpint (arv_buffer_get_dmabuf_fd (buffer), ==, -1);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_import (100, data, ARV_BUFFER_MEMORY_TYPE_DMABUF, 12, NULL, NULL);
+	g_assert_cmpint (arv_buffer_get_dmabuf_fd (buffer), ==, 12);
+	g_object_unref (buffer);
+}
+
+static void
+decimate_test (void)
+{
+	ArvBuffer *buffer;
+	ArvBuffer *output;
+	GError *error = NULL;
+	const guint8 *data;
+	guint8 bayer[2][2] = {{200, 100}, {100, 50}};
+	int x, y;
+
+	buffer = arv_buffer_new (8 * 8, NULL);
+	output = arv_buffer_new (4 * 4 * 3, NULL);
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->frame_id = 42;
+
+	/* Uniform 2x2 blocks */
+	for (y = 0; y < 4; y++)
+		for (x = 0; x < 8; x++)
+			buffer->priv->data[y * 8 + x] = (x / 2) * 10 + (y / 2) * 50;
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 8, 4, 8 * 4);
+
+	g_assert_cmpint (arv_buffer_get_decimated_size (buffer, 2, FALSE), ==, 4 * 2);
+	g_assert_true (arv_buffer_decimate (buffer, output, 2, FALSE, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (arv_buffer_get_image_pixel_format (output), ==, ARV_PIXEL_FORMAT_MONO_8);
+	g_assert_cmpint (arv_buffer_get_image_width (output), ==, 4);
+	g_assert_cmpint (arv_buffer_get_image_height (output), ==, 2);
+	g_assert_cmpint (arv_buffer_get_frame_id (output), ==, 42);
+	data = arv_buffer_get_data (output, NULL);
+	for (y = 0; y < 2; y++)
+		for (x = 0; x < 4; x++)
+			g_assert_cmpint (data[y * 4 + x], ==, x * 10 + y * 50);
+
+	/* Bayer binning keeps the color filter pattern, debayering gives the block colors */
+	for (y = 0; y < 8; y++)
+		for (x = 0; x < 8; x++)
+			buffer->priv->data[y * 8 + x] = bayer[y & 1][x & 1];
+	_set_image (buffer, ARV_PIXEL_FORMAT_BAYER_RG_8, 8, 8, 8 * 8);
+
+	g_assert_true (arv_buffer_decimate (buffer, output, 2, FALSE, &error));
+	g_assert_cmpint (arv_buffer_get_image_pixel_format (output), ==, ARV_PIXEL_FORMAT_BAYER_RG_8);
+	g_assert_cmpint (arv_buffer_get_image_width (output), ==, 4);
+	data = arv_buffer_get_data (output, NULL);
+	for (y = 0; y < 4; y++)
+		for (x = 0; x < 4; x++)
+			g_assert_cmpint (data[y * 4 + x], ==, bayer[y & 1][x & 1]);
+
+	g_assert_true (arv_buffer_decimate (buffer, output, 2, TRUE, &error));
+	g_assert_cmpint (arv_buffer_get_image_pixel_format (output), ==, ARV_PIXEL_FORMAT_RGB_8_PACKED);
+	data = arv_buffer_get_data (output, NULL);
+	for (x = 0; x < 4 * 4; x++) {
+		g_assert_cmpint (data[3 * x], ==, 200);
+		g_assert_cmpint (data[3 * x + 1], ==, 100);
+		g_assert_cmpint (data[3 * x + 2], ==, 50);
+	}
+
+	g_assert_false (arv_buffer_decimate (buffer, output, 3, TRUE, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION);
+	g_clear_error (&error);
+
+	g_object_unref (buffer);
+	g_object_unref (output);
+}
+
+static void
+decode_test (void)
+{
+	ArvBuffer *buffer;
+	ArvBuffer *output;
+	GError *error = NULL;
+
+	buffer = arv_buffer_new (1024, NULL);
+	output = arv_buffer_new (16 * 16 * 3, NULL);
+
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 16, 16, 16);
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	g_assert_false (arv_buffer_decode (buffer, output, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD);
+	g_clear_error (&error);
+
+#if ARAVIS_HAS_JPEG
+	{
+		guint8 pixels[16 * 16];
+		unsigned char *jpeg = NULL;
+		unsigned long jpeg_size = 0;
+		const guint8 *data;
+		tjhandle handle;
+		int i;
+
+		for (i = 0; i < 16 * 16; i++)
+			pixels[i] = (i % 16) < 8 ? 0x20 : 0xe0;
+
+		handle = tjInitCompress ();
+		g_assert_cmpint (tjCompress2 (handle, pixels, 16, 16, 16, TJPF_GRAY, &jpeg, &jpeg_size,
+					      TJSAMP_GRAY, 100, 0), ==, 0);
+		g_assert_cmpint (jpeg_size, <=, 1024);
+
+		memcpy (buffer->priv->data, jpeg, jpeg_size);
+		buffer->priv->received_size = jpeg_size;
+		buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_JPEG;
+		buffer->priv->frame_id = 42;
+		tjFree (jpeg);
+		tjDestroy (handle);
+
+		g_assert_true (arv_buffer_decode (buffer, output, &error));
+		g_assert_no_error (error);
+		g_assert_cmpint (arv_buffer_get_payload_type (output), ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		g_assert_cmpint (arv_buffer_get_image_pixel_format (output), ==, ARV_PIXEL_FORMAT_MONO_8);
+		g_assert_cmpint (arv_buffer_get_image_width (output), ==, 16);
+		g_assert_cmpint (arv_buffer_get_image_height (output), ==, 16);
+		g_assert_cmpint (arv_buffer_get_frame_id (output), ==, 42);
+
+		data = arv_buffer_get_data (output, NULL);
+		g_assert_cmpint (data[0], <, 0x40);
+		g_assert_cmpint (data[15], >, 0xc0);
+	}
+#endif
+
+	g_object_unref (buffer);
+	g_object_unref (output);
+}
+
+static void
+tensor_test (void)
+{
+	ArvBuffer *buffer;
+	ArvBufferTensorFormat format = {2, 2, 1, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}};
+	GError *error = NULL;
+	guint8 *data;
+	float tensor[3 * 2 * 2];
+	guint i;
+
+	buffer = arv_buffer_new_allocate (4 * 4);
+	data = buffer->priv->data;
+	for (i = 0; i < 4 * 4; i++)
+		data[i] = (i % 4) * 16 + (i / 4) * 64;
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_8, 4, 4, 4 * 4);
+
+	g_assert_true (arv_buffer_convert_tensor (buffer, &format, tensor, &error));
+	g_assert_no_error (error);
+	g_assert_cmpfloat_with_epsilon (tensor[0], 40.0 / 255.0, 1e-6);
+	g_assert_cmpfloat_with_epsilon (tensor[1], 72.0 / 255.0, 1e-6);
+	g_assert_cmpfloat_with_epsilon (tensor[2], 168.0 / 255.0, 1e-6);
+	g_assert_cmpfloat_with_epsilon (tensor[3], 200.0 / 255.0, 1e-6);
+
+	format.n_channels = 3;
+	g_assert_true (arv_buffer_convert_tensor (buffer, &format, tensor, &error));
+	g_assert_no_error (error);
+	g_assert_cmpfloat_with_epsilon (tensor[4 + 3], 200.0 / 255.0, 1e-6);
+	g_assert_cmpfloat_with_epsilon (tensor[8 + 3], 200.0 / 255.0, 1e-6);
+
+	memset (data, 128, 4 * 4);
+	_set_image (buffer, ARV_PIXEL_FORMAT_BAYER_RG_8, 4, 4, 4 * 4);
+	for (i = 0; i < 3; i++) {
+		format.mean[i] = 0.5;
+		format.std[i] = 0.25;
+	}
+
+	g_assert_true (arv_buffer_convert_tensor (buffer, &format, tensor, &error));
+	g_assert_no_error (error);
+	for (i = 0; i < 3 * 2 * 2; i++)
+		g_assert_cmpfloat_with_epsilon (tensor[i], (128.0 / 255.0 - 0.5) / 0.25, 1e-5);
+
+	format.n_channels = 1;
+	g_assert_false (arv_buffer_convert_tensor (buffer, &format, tensor, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION);
+	g_clear_error (&error);
+
+	g_assert_null (arv_buffer_get_tensor_data (buffer, NULL));
+
+	g_object_unref (buffer);
+}
+
+static void
+pixel_correction_test (void)
+{
+	ArvPixelCorrection *correction;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	float gain[20 * 3];
+	float offset[20 * 3];
+	guint16 *pixels;
+	guint8 *data;
+	guint i;
+
+	correction = arv_pixel_correction_new (20, 3);
+	for (i = 0; i < 20 * 3; i++) {
+		gain[i] = 2.0;
+		offset[i] = 100.0;
+	}
+	g_assert_false (arv_pixel_correction_set_gain_map (correction, gain, 20 * 2, &error));
+	g_assert_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_INVALID_MAP);
+	g_clear_error (&error);
+	g_assert_true (arv_pixel_correction_set_gain_map (correction, gain, 20 * 3, NULL));
+	g_assert_true (arv_pixel_correction_set_offset_map (correction, offset, 20 * 3, NULL));
+	arv_pixel_correction_add_defect (correction, 6, 1);
+	arv_pixel_correction_add_defect (correction, 6, 1);
+	g_assert_cmpint (arv_pixel_correction_get_n_defects (correction), ==, 1);
+
+	/* 19 pixel wide region, for both the vector and the scalar paths */
+	buffer = arv_buffer_new_allocate (19 * 3 * 2);
+	pixels = buffer->priv->data;
+	for (i = 0; i < 19 * 3; i++)
+		pixels[i] = 1000;
+	pixels[0] = 4000;
+	pixels[1] = 50;
+	pixels[19 + 5] = 4095;
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_12, 19, 3, 19 * 3 * 2);
+	buffer->priv->x_offset = 1;
+
+	g_assert_true (arv_pixel_correction_apply (correction, buffer, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (pixels[0], ==, 4095);
+	g_assert_cmpint (pixels[1], ==, 0);
+	g_assert_cmpint (pixels[18], ==, 1800);
+	g_assert_cmpint (pixels[19 + 5], ==, 1800);
+	g_assert_cmpint (pixels[2 * 19 + 18], ==, 1800);
+
+	buffer->priv->x_offset = 2;
+	g_assert_false (arv_pixel_correction_apply (correction, buffer, &error));
+	g_assert_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_INVALID_REGION);
+	g_clear_error (&error);
+
+	data = buffer->priv->data;
+	memset (data, 200, 20 * 3);
+	data[20 + 6] = 0;
+	_set_image (buffer, ARV_PIXEL_FORMAT_BAYER_RG_8, 20, 3, 20 * 3);
+	buffer->priv->x_offset = 0;
+
+	g_assert_true (arv_pixel_correction_apply (correction, buffer, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (data[0], ==, 200);
+	g_assert_cmpint (data[20 + 19], ==, 200);
+	g_assert_cmpint (data[20 + 6], ==, 200);
+
+	_set_image (buffer, ARV_PIXEL_FORMAT_RGB_8_PACKED, 20, 1, 20 * 3);
+	g_assert_false (arv_pixel_correction_apply (correction, buffer, &error));
+	g_assert_error (error, ARV_PIXEL_CORRECTION_ERROR, ARV_PIXEL_CORRECTION_ERROR_UNSUPPORTED_FORMAT);
+	g_clear_error (&error);
+
+	g_object_unref (buffer);
+	g_object_unref (correction);
+}
+
+static void
+compress_test (void)
+{
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	ArvBufferCompression compression;
+	size_t size;
+
+	buffer = arv_buffer_new_allocate (512 * 1024 * 2);
+	_set_image (buffer, ARV_PIXEL_FORMAT_MONO_16, 512, 1024, 512 * 1024 * 2);
+
+	g_assert_false (arv_buffer_compress (buffer, ARV_BUFFER_COMPRESSION_ZSTD, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE);
+	g_clear_error (&error);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+
+#if ARAVIS_HAS_ZSTD
+	{
+		guint16 *pixels = buffer->priv->data;
+		guint8 *output;
+		const void *data;
+		guint i;
+
+		for (i = 0; i < 512 * 1024; i++)
+			pixels[i] = (i % 512) * 16 + (i / 512);
+
+		g_assert_true (arv_buffer_compress (buffer, ARV_BUFFER_COMPRESSION_ZSTD, &error));
+		g_assert_no_error (error);
+
+		data = arv_buffer_get_compressed_data (buffer, &compression, &size);
+		g_assert_nonnull (data);
+		g_assert_cmpint (compression, ==, ARV_BUFFER_COMPRESSION_ZSTD);
+		g_assert_cmpint (size, <, 512 * 1024 * 2 / 10);
+		g_assert_cmpint (buffer->priv->compressed->filter, ==, ARV_BUFFER_COMPRESSION_FILTER_DELTA);
+
+		output = g_malloc (512 * 1024 * 2);
+		g_assert_true (arv_buffer_decompress (buffer->priv->compressed, data, size, output, &error));
+		g_assert_no_error (error);
+		g_assert_true (memcmp (output, pixels, 512 * 1024 * 2) == 0);
+
+		g_assert_false (arv_buffer_decompress (buffer->priv->compressed, data, size / 2, output, &error));
+		g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_IMAGE);
+		g_clear_error (&error);
+		g_free (output);
+
+		arv_buffer_compression_clear (buffer);
+		g_assert_null (arv_buffer_get_compressed_data (buffer, &compression, &size));
+		g_assert_cmpint (compression, ==, ARV_BUFFER_COMPRESSION_NONE);
+	}
+#else
+	g_assert_false (arv_buffer_compress (buffer, ARV_BUFFER_COMPRESSION_ZSTD, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_PAYLOAD);
+	g_clear_error (&error);
+#endif
+
+	g_object_unref (buffer);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -125,6 +987,20 @@ main (int argc, char *argv[])
 	g_test_add_func ("/buffer/full-buffer", full_buffer_test);
 	g_test_add_func ("/buffer/timestamp", timestamp);
 	g_test_add_func ("/buffer/allocate", allocate);
+	g_test_add_func ("/buffer/buffer-pool", buffer_pool_test);
+	g_test_add_func ("/buffer/multipart", multipart_buffer_test);
+	g_test_add_func ("/buffer/convert", convert_test);
+	g_test_add_func ("/buffer/decimate", decimate_test);
+	g_test_add_func ("/buffer/decode", decode_test);
+	g_test_add_func ("/buffer/tensor", tensor_test);
+	g_test_add_func ("/buffer/compress", compress_test);
+	g_test_add_func ("/buffer/pixel-correction", pixel_correction_test);
+	g_test_add_func ("/buffer/unpack-pixels", unpack_pixels_test);
+	g_test_add_func ("/buffer/statistics", statistics_test);
+	g_test_add_func ("/buffer/valid-ranges", valid_ranges_test);
+	g_test_add_func ("/buffer/view", view_test);
+	g_test_add_func ("/buffer/region-views", region_views_test);
+	g_test_add_func ("/buffer/import", import_test);
 
 	result = g_test_run();
 
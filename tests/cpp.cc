@@ -1,9 +1,72 @@
 #include <arv.h>
 
-/* Dumb test program, just to make sure aravis headers are c++ compatible */
+/* Make sure aravis headers are c++ compatible, and exercise the C++ layer on the fake camera */
+
+#if __cplusplus >= 201703L || (defined (_MSVC_LANG) && _MSVC_LANG >= 201703L)
+
+#include <arv.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+int
+main (int argc, char **argv)
+{
+	unsigned n_frames = argc > 1 ? atoi (argv[1]) : 50;
+	unsigned n_completed = 0;
+	std::uint64_t n_bytes = 0;
+	gint64 start_us;
+
+	arv_enable_interface ("Fake");
+
+	try {
+		arv::Camera camera = arv::Camera::open ("Fake_1");
+		arv::Stream stream = camera.create_stream ();
+		arv::IntegerFeature width = camera.integer_feature ("Width");
+		arv::FloatFeature frame_rate = camera.float_feature ("AcquisitionFrameRate");
+
+		width.set (512);
+		frame_rate.set (1000.0);
+
+		stream.allocate_buffers (10, camera.payload ());
+
+		start_us = g_get_monotonic_time ();
+		camera.start_acquisition ();
+
+		for (unsigned i = 0; i < n_frames; i++) {
+			arv::BufferLease lease = stream.pop (1000000);
+
+			if (lease && lease.is_complete ()) {
+				arv::ImageView image = lease.image ();
+
+				n_completed++;
+				n_bytes += static_cast<std::uint64_t> (image.stride ()) * image.height ();
+			}
+		}
+
+		camera.stop_acquisition ();
+
+		printf ("%u/%u frames, %.3f frames/s, %.3f MB/s, width %" G_GINT64_FORMAT "\n",
+			n_completed, n_frames,
+			n_completed * 1e6 / (g_get_monotonic_time () - start_us),
+			n_bytes / (double) (g_get_monotonic_time () - start_us),
+			width.get ());
+	} catch (const arv::Error &error) {
+		printf ("Error: %s\n", error.what ());
+		arv_shutdown ();
+		return EXIT_FAILURE;
+	}
+
+	arv_shutdown ();
+
+	return n_completed == n_frames ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
 
 int
 main (int argc, char **argv)
 {
 	return 0;
 }
+
+#endif
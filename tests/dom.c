@@ -1,4 +1,5 @@
 #include <arv.h>
+#include "../src/arvdomparserprivate.h"
 
 static void
 child_list_test (void)
@@ -32,6 +33,147 @@ child_list_test (void)
         g_object_unref (device);
 }
 
+static void
+compiled_document_test (void)
+{
+	ArvDomDocument *document;
+	ArvDomDocument *compiled_document;
+	GBytes *compiled;
+	GBytes *truncated;
+	GError *error = NULL;
+	const char *compiled_data;
+	const char *name;
+	gsize compiled_size;
+	char *xml;
+	gsize size;
+	gboolean success;
+
+	success = g_file_get_contents (GENICAM_FILENAME, &xml, &size, NULL);
+	g_assert (success);
+
+	document = arv_dom_document_new_from_memory_full (xml, size, &compiled, &error);
+	g_assert (ARV_IS_GC (document));
+	g_assert (error == NULL);
+	g_assert (compiled != NULL);
+
+	compiled_document = arv_dom_document_new_from_compiled (compiled, &error);
+	g_assert (ARV_IS_GC (compiled_document));
+	g_assert (error == NULL);
+
+	g_assert (ARV_IS_GC_NODE (arv_gc_get_node (ARV_GC (compiled_document), "Root")));
+	g_assert_cmpstr (arv_gc_feature_node_get_description
+			 (ARV_GC_FEATURE_NODE (arv_gc_get_node (ARV_GC (compiled_document), "Root"))),
+			 ==, "description");
+
+	/* The strings of a document replayed from compiled data point into the compiled string table */
+	compiled_data = g_bytes_get_data (compiled, &compiled_size);
+	name = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (arv_gc_get_node (ARV_GC (compiled_document),
+										   "Root")));
+	g_assert_cmpstr (name, ==, "Root");
+	g_assert (name >= compiled_data && name < compiled_data + compiled_size);
+
+	truncated = g_bytes_new_from_bytes (compiled, 0, g_bytes_get_size (compiled) - 1);
+	g_assert (arv_dom_document_new_from_compiled (truncated, &error) == NULL);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	g_bytes_unref (truncated);
+	g_bytes_unref (compiled);
+	g_object_unref (compiled_document);
+	g_object_unref (document);
+	g_free (xml);
+}
+
+static void
+push_parser_test (void)
+{
+	ArvDomPushParser *parser;
+	ArvDomDocument *document;
+	GBytes *compiled = NULL;
+	GError *error = NULL;
+	char *xml;
+	gsize size;
+	gsize offset;
+	gboolean success;
+
+	success = g_file_get_contents (GENICAM_FILENAME, &xml, &size, NULL);
+	g_assert (success);
+
+	parser = arv_dom_push_parser_new (TRUE);
+	for (offset = 0; offset < size; offset += 100)
+		g_assert (arv_dom_push_parser_feed (parser, xml + offset, MIN (100, size - offset)));
+	document = arv_dom_push_parser_finish (parser, &compiled, &error);
+
+	g_assert (ARV_IS_GC (document));
+	g_assert (error == NULL);
+	g_assert (compiled != NULL);
+	g_assert_cmpstr (arv_gc_feature_node_get_description
+			 (ARV_GC_FEATURE_NODE (arv_gc_get_node (ARV_GC (document), "Root"))),
+			 ==, "description");
+
+	g_bytes_unref (compiled);
+	g_object_unref (document);
+
+	parser = arv_dom_push_parser_new (FALSE);
+	arv_dom_push_parser_feed (parser, xml, size / 2);
+	g_assert (arv_dom_push_parser_finish (parser, NULL, &error) == NULL);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	parser = arv_dom_push_parser_new (FALSE);
+	arv_dom_push_parser_feed (parser, xml, size / 2);
+	arv_dom_push_parser_free (parser);
+
+	g_free (xml);
+}
+
+static void
+interned_strings_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	ArvGcNode *node;
+	ArvDomNode *iter;
+	const char *name;
+	gboolean found = FALSE;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	name = arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, "RWFloat")));
+	g_assert_cmpstr (name, ==, "RWFloat");
+
+	node = arv_gc_get_node (genicam, "Root");
+	g_assert (ARV_IS_GC_NODE (node));
+
+	/* The feature references share the feature name storage */
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		ArvDomNode *text = arv_dom_node_get_first_child (iter);
+
+		if (ARV_IS_GC_PROPERTY_NODE (iter) && ARV_IS_DOM_TEXT (text) &&
+		    g_strcmp0 (arv_dom_node_get_node_value (text), name) == 0) {
+			g_assert (arv_dom_node_get_node_value (text) == name);
+
+			/* Modified values are copied */
+			arv_dom_node_set_node_value (text, "RWBoolean");
+			g_assert_cmpstr (arv_dom_node_get_node_value (text), ==, "RWBoolean");
+			g_assert_cmpstr (name, ==, "RWFloat");
+
+			found = TRUE;
+		}
+	}
+	g_assert (found);
+
+	g_object_unref (device);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -42,6 +184,9 @@ main (int argc, char *argv[])
 	arv_set_fake_camera_genicam_filename (GENICAM_FILENAME);
 
 	g_test_add_func ("/dom/child-list", child_list_test);
+	g_test_add_func ("/dom/compiled-document", compiled_document_test);
+	g_test_add_func ("/dom/push-parser", push_parser_test);
+	g_test_add_func ("/dom/interned-strings", interned_strings_test);
 
 	result = g_test_run();
 
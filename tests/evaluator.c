@@ -196,6 +196,44 @@ set_int64_variable_test (void)
 	g_object_unref (evaluator);
 }
 
+static void
+variable_index_test (void)
+{
+	ArvEvaluator *evaluator;
+	GError *error = NULL;
+	guint index_a;
+	guint index_b;
+
+	evaluator = arv_evaluator_new ("A*B");
+
+	index_a = arv_evaluator_get_variable_index (evaluator, "A");
+	index_b = arv_evaluator_get_variable_index (evaluator, "B");
+	g_assert_cmpuint (index_a, !=, index_b);
+	g_assert_cmpuint (index_a, ==, arv_evaluator_get_variable_index (evaluator, "A"));
+
+	arv_evaluator_set_int64_variable_by_index (evaluator, index_a, 3);
+	arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	arv_evaluator_set_int64_variable_by_index (evaluator, index_b, 7);
+	g_assert_cmpint (arv_evaluator_evaluate_as_int64 (evaluator, &error), ==, 21);
+	g_assert (error == NULL);
+
+	arv_evaluator_set_double_variable (evaluator, "B", 0.5);
+	g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, &error), ==, 1.5);
+	g_assert (error == NULL);
+
+	/* Indexes survive an expression change */
+	arv_evaluator_set_expression (evaluator, "B+A+C");
+	arv_evaluator_set_double_variable (evaluator, "C", 1.0);
+	arv_evaluator_set_double_variable_by_index (evaluator, index_a, 2.0);
+	g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, &error), ==, 3.5);
+	g_assert (error == NULL);
+
+	g_object_unref (evaluator);
+}
+
 static void
 sub_expression_test (void)
 {
@@ -328,6 +366,54 @@ error_test (void)
 	g_object_unref (evaluator);
 }
 
+static void
+shared_program_test (void)
+{
+	ArvEvaluator *evaluator_a;
+	ArvEvaluator *evaluator_b;
+	ArvEvaluator *evaluator_c;
+	GError *error = NULL;
+	gint64 v_int64;
+
+	evaluator_a = arv_evaluator_new ("X * SCALE + Y");
+	evaluator_b = arv_evaluator_new ("X * SCALE + Y");
+	evaluator_c = arv_evaluator_new ("X * SCALE + Y");
+
+	arv_evaluator_set_constant (evaluator_a, "SCALE", "10");
+	arv_evaluator_set_constant (evaluator_b, "SCALE", "10");
+	arv_evaluator_set_constant (evaluator_c, "SCALE", "100");
+
+	/* Bind the variables in a different order, the program slots differ from the evaluator indexes */
+	arv_evaluator_set_int64_variable (evaluator_a, "X", 2);
+	arv_evaluator_set_int64_variable (evaluator_a, "Y", 3);
+	arv_evaluator_set_int64_variable (evaluator_b, "Y", 5);
+	arv_evaluator_set_int64_variable (evaluator_b, "X", 4);
+	arv_evaluator_set_int64_variable (evaluator_c, "X", 2);
+	arv_evaluator_set_int64_variable (evaluator_c, "Y", 3);
+
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator_a, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (v_int64, ==, 23);
+
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator_b, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (v_int64, ==, 45);
+
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator_c, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (v_int64, ==, 203);
+
+	g_object_unref (evaluator_a);
+
+	arv_evaluator_set_int64_variable (evaluator_b, "X", 1);
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator_b, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (v_int64, ==, 15);
+
+	g_object_unref (evaluator_b);
+	g_object_unref (evaluator_c);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -344,10 +430,12 @@ main (int argc, char *argv[])
 	g_test_add_func ("/evaluator/set-get-expression", set_get_expression_test);
 	g_test_add_func ("/evaluator/double-variable", set_double_variable_test);
 	g_test_add_func ("/evaluator/int64-variable", set_int64_variable_test);
+	g_test_add_func ("/evaluator/variable-index", variable_index_test);
 	g_test_add_func ("/evaluator/sub-expression", sub_expression_test);
 	g_test_add_func ("/evaluator/constant", constant_test);
 	g_test_add_func ("/evaluator/empty", empty_test);
 	g_test_add_func ("/evaluator/error", error_test);
+	g_test_add_func ("/evaluator/shared-program", shared_program_test);
 
 	result = g_test_run();
 
@@ -1,5 +1,10 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <arv.h>
+#include <string.h>
+
+#include "../src/arvgvspprivate.h"
+#include "../src/arvgvstreamprivate.h"
 
 static void
 discovery_test (void)
@@ -191,6 +196,7 @@ fake_device_test (void)
 	gint64 *values;
 	const char **string_values;
 	const char *string_value;
+	char *dup_string_value;
 	guint n_values;
 	double float_minimum, float_maximum;
 	const char *genicam;
@@ -277,6 +283,58 @@ fake_device_test (void)
 	string_value = arv_device_get_string_feature_value (device, "TestStringReg", NULL);
 	g_assert_cmpstr (string_value, ==, "String");
 
+	dup_string_value = arv_device_dup_string_feature_value (device, "TestStringReg", NULL);
+	g_assert_cmpstr (dup_string_value, ==, "String");
+	g_free (dup_string_value);
+
+	g_object_unref (device);
+}
+
+#define CONCURRENT_STRING_N_THREADS	4
+#define CONCURRENT_STRING_N_READS	1000
+
+static gpointer
+_concurrent_string_read_thread (gpointer data)
+{
+	ArvDevice *device = data;
+	ArvGcNode *width = arv_device_get_feature (device, "Width");
+	unsigned int i;
+
+	for (i = 0; i < CONCURRENT_STRING_N_READS; i++) {
+		char *value;
+
+		value = arv_device_dup_string_feature_value (device, "TestStringReg", NULL);
+		g_assert_cmpstr (value, ==, "String");
+		g_free (value);
+
+		value = arv_gc_feature_node_dup_value_as_string (ARV_GC_FEATURE_NODE (width), NULL);
+		g_assert_nonnull (value);
+		g_free (value);
+	}
+
+	return NULL;
+}
+
+static void
+concurrent_string_read_test (void)
+{
+	GThread *threads[CONCURRENT_STRING_N_THREADS];
+	ArvDevice *device;
+	GError *error = NULL;
+	unsigned int i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert_no_error (error);
+
+	arv_device_set_string_feature_value (device, "TestStringReg", "String", &error);
+	g_assert_no_error (error);
+
+	for (i = 0; i < CONCURRENT_STRING_N_THREADS; i++)
+		threads[i] = g_thread_new ("string-read", _concurrent_string_read_thread, device);
+	for (i = 0; i < CONCURRENT_STRING_N_THREADS; i++)
+		g_thread_join (threads[i]);
+
 	g_object_unref (device);
 }
 
@@ -315,6 +373,144 @@ fill_pattern_cb (ArvBuffer *buffer, void *fill_pattern_data, guint32 exposure_ti
 	(*counter)++;
 }
 
+static void
+frame_bank_test (void)
+{
+	ArvFakeCamera *fake_camera;
+	ArvBuffer *buffers[5];
+	const guint8 *data[5];
+	size_t size[5];
+	guint32 width, height, gain;
+	double scale;
+	gint counter = 0;
+	guint i;
+
+	fake_camera = arv_fake_camera_new ("TEST0");
+	g_assert (ARV_IS_FAKE_CAMERA (fake_camera));
+
+	arv_fake_camera_write_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT, ARV_PIXEL_FORMAT_MONO_8);
+	arv_fake_camera_write_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_EXPOSURE_TIME_US, 10000);
+	arv_fake_camera_read_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_WIDTH, &width);
+	arv_fake_camera_read_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_HEIGHT, &height);
+	arv_fake_camera_read_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_GAIN_RAW, &gain);
+	scale = 1.0 + gain;
+
+	/* Diagonal ramp */
+	buffers[0] = arv_buffer_new (arv_fake_camera_get_payload (fake_camera), NULL);
+	arv_fake_camera_fill_buffer (fake_camera, buffers[0], NULL);
+	g_assert_cmpint (arv_buffer_get_status (buffers[0]), ==, ARV_BUFFER_STATUS_SUCCESS);
+	data[0] = arv_buffer_get_data (buffers[0], &size[0]);
+	g_assert_cmpint (size[0], ==, width * height);
+	for (i = 0; i < 3; i++) {
+		guint x = 7 * i, y = 5 * i;
+
+		g_assert_cmpint (data[0][y * width + x], ==,
+				 (guint8) CLAMP (((x + y + arv_buffer_get_frame_id (buffers[0])) % 255) * scale, 0, 255));
+	}
+	g_clear_object (&buffers[0]);
+
+	/* Only the first two frames are rendered */
+	arv_fake_camera_set_fill_pattern (fake_camera, fill_pattern_cb, &counter);
+	arv_fake_camera_set_frame_bank_size (fake_camera, 2);
+
+	for (i = 0; i < 5; i++) {
+		buffers[i] = arv_buffer_new (arv_fake_camera_get_payload (fake_camera), NULL);
+		arv_fake_camera_fill_buffer (fake_camera, buffers[i], NULL);
+		g_assert_cmpint (arv_buffer_get_status (buffers[i]), ==, ARV_BUFFER_STATUS_SUCCESS);
+		data[i] = arv_buffer_get_data (buffers[i], &size[i]);
+		if (i > 0)
+			g_assert_cmpint (arv_buffer_get_frame_id (buffers[i]), ==,
+					 arv_buffer_get_frame_id (buffers[i - 1]) % 65535 + 1);
+	}
+
+	g_assert_cmpint (counter, ==, 2);
+	g_assert_cmpint (size[0], ==, size[2]);
+	g_assert (memcmp (data[0], data[2], size[0]) == 0);
+	g_assert (memcmp (data[1], data[3], size[1]) == 0);
+
+	for (i = 0; i < 5; i++)
+		g_clear_object (&buffers[i]);
+
+	/* A gain change triggers a new rendering */
+	arv_fake_camera_write_register (fake_camera, ARV_FAKE_CAMERA_REGISTER_GAIN_RAW, gain + 1);
+	buffers[0] = arv_buffer_new (arv_fake_camera_get_payload (fake_camera), NULL);
+	arv_fake_camera_fill_buffer (fake_camera, buffers[0], NULL);
+	g_assert_cmpint (counter, ==, 3);
+	g_clear_object (&buffers[0]);
+
+	arv_fake_camera_set_frame_bank_size (fake_camera, 0);
+	buffers[0] = arv_buffer_new (arv_fake_camera_get_payload (fake_camera), NULL);
+	arv_fake_camera_fill_buffer (fake_camera, buffers[0], NULL);
+	g_assert_cmpint (counter, ==, 4);
+	g_clear_object (&buffers[0]);
+
+	g_object_unref (fake_camera);
+}
+
+static void
+stream_group_test (void)
+{
+	ArvCamera *cameras[2];
+	ArvStream *streams[2];
+	ArvStreamGroup *group;
+	GPtrArray *set;
+	GError *error = NULL;
+	guint64 n_complete_sets = 0;
+	gint payload;
+	guint i, j;
+
+	group = arv_stream_group_new (ARV_STREAM_GROUP_MATCH_FRAME_ID);
+	g_assert (ARV_IS_STREAM_GROUP (group));
+
+	for (i = 0; i < G_N_ELEMENTS (cameras); i++) {
+		cameras[i] = arv_camera_new ("Fake_1", &error);
+		g_assert (ARV_IS_CAMERA (cameras[i]));
+		g_assert (error == NULL);
+
+		streams[i] = arv_camera_create_stream (cameras[i], NULL, NULL, &error);
+		g_assert (ARV_IS_STREAM (streams[i]));
+		g_assert (error == NULL);
+
+		payload = arv_camera_get_payload (cameras[i], NULL);
+		for (j = 0; j < 4; j++)
+			arv_stream_push_buffer (streams[i], arv_buffer_new (payload, NULL));
+
+		g_assert_cmpint (arv_stream_group_add_stream (group, streams[i]), ==, i);
+		arv_camera_set_frame_rate (cameras[i], 50.0, NULL);
+		arv_camera_set_acquisition_mode (cameras[i], ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	}
+
+	g_assert_cmpint (arv_stream_group_get_n_streams (group), ==, 2);
+
+	for (i = 0; i < G_N_ELEMENTS (cameras); i++)
+		arv_camera_start_acquisition (cameras[i], NULL);
+
+	for (i = 0; i < 5; i++) {
+		set = arv_stream_group_timeout_pop_set (group, 2000000);
+		g_assert (set != NULL);
+		g_assert_cmpint (set->len, ==, 2);
+		g_assert (ARV_IS_BUFFER (g_ptr_array_index (set, 0)));
+		g_assert (ARV_IS_BUFFER (g_ptr_array_index (set, 1)));
+		g_assert_cmpint (arv_buffer_get_frame_id (g_ptr_array_index (set, 0)), ==,
+				 arv_buffer_get_frame_id (g_ptr_array_index (set, 1)));
+		arv_stream_group_push_set (group, set);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (cameras); i++)
+		arv_camera_stop_acquisition (cameras[i], NULL);
+
+	arv_stream_group_get_statistics (group, &n_complete_sets, NULL, NULL);
+	g_assert_cmpint (n_complete_sets, >=, 5);
+
+	/* The group gives back the pending buffers to the streams */
+	g_clear_object (&group);
+
+	for (i = 0; i < G_N_ELEMENTS (cameras); i++) {
+		g_clear_object (&streams[i]);
+		g_clear_object (&cameras[i]);
+	}
+}
+
 static void
 fake_stream_test (void)
 {
@@ -374,7 +570,7 @@ fake_stream_test (void)
 	g_assert_cmpint (n_output_buffers, ==, 0);
 
         n_infos = arv_stream_get_n_infos (stream);
-        g_assert_cmpint (n_infos, ==, 5);
+        g_assert_cmpint (n_infos, ==, 19);
 
         info_name = arv_stream_get_info_name (stream, 0);
         g_assert_cmpstr (info_name, ==, "n_completed_buffers");
@@ -403,330 +599,2130 @@ fake_stream_test (void)
         g_assert_cmpint (n_underruns, ==, arv_stream_get_info_uint64_by_name (stream, "n_underruns"));
         g_assert_cmpint (n_underruns, ==, arv_stream_get_info_uint64 (stream, 2));
 
+        info_type = arv_stream_get_info_type (stream, 6);
+        g_assert_cmpint (info_type, ==, G_TYPE_DOUBLE);
+        info_name = arv_stream_get_info_name (stream, 6);
+        g_assert_cmpstr (info_name, ==, "latency_transfer_p50_us");
+
+        /* The fake stream has no packet timestamps, only the delivery latency is known */
+        g_assert_cmpfloat (arv_stream_get_info_double_by_name (stream, "latency_transfer_max_us"), ==, 0.0);
+        g_assert_cmpfloat (arv_stream_get_info_double_by_name (stream, "latency_delivery_max_us"), >=,
+                           arv_stream_get_info_double_by_name (stream, "latency_delivery_p50_us"));
+
 	g_clear_object (&buffer);
 	g_clear_object (&stream);
 	g_clear_object (&camera);
 }
 
 static void
-camera_api_test (void)
+fake_stream_benchmark_test (void)
 {
 	ArvCamera *camera;
-	ArvPixelFormat pixel_format;
+	ArvStream *stream;
+	ArvBuffer *buffer;
 	GError *error = NULL;
-	int x, y, w, h;
-	const char *string;
-	void *ptr;
-	unsigned int n;
-	gboolean b;
-	double d;
+	gint payload;
+	unsigned i;
 
 	camera = arv_camera_new ("Fake_1", &error);
 	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	string = arv_camera_get_vendor_name (camera, &error);
-	g_assert (error == NULL);
-	g_assert (string != NULL);
+	/* Well below the benchmark rate */
+	arv_camera_set_frame_rate (camera, 1.0, NULL);
 
-	string = arv_camera_get_model_name (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert (string != NULL);
 
-	string = arv_camera_get_device_id (camera, &error);
-	g_assert (error == NULL);
-	g_assert (string != NULL);
+	arv_fake_stream_set_benchmark_mode (ARV_FAKE_STREAM (stream),
+					    ARV_FAKE_STREAM_BENCHMARK_MODE_MAX_RATE_METADATA_ONLY);
 
-	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 0);
-	g_assert_cmpint (y, ==, 0);
-	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
-	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_HEIGHT_DEFAULT);
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
 
-	arv_camera_get_sensor_size (camera, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_SENSOR_WIDTH);
-	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_SENSOR_HEIGHT);
+	arv_camera_start_acquisition (camera, NULL);
+	for (i = 0; i < 100; i++) {
+		/* The first pattern frame may still be paced */
+		buffer = arv_stream_timeout_pop_buffer (stream, 2000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+	arv_camera_stop_acquisition (camera, NULL);
 
-	arv_camera_set_region (camera, 10, 20, 30, 40, &error);
-	g_assert (error == NULL);
-	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 10);
-	g_assert_cmpint (y, ==, 20);
-	g_assert_cmpint (w, ==, 30);
-	g_assert_cmpint (h, ==, 40);
+	g_assert_cmpfloat (arv_stream_get_info_double_by_name (stream, "benchmark_frame_rate"), >, 1.0);
 
-	arv_camera_get_binning (camera, &x, &y, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, ARV_FAKE_CAMERA_BINNING_HORIZONTAL_DEFAULT);
-	g_assert_cmpint (y, ==, ARV_FAKE_CAMERA_BINNING_VERTICAL_DEFAULT);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	arv_camera_set_binning (camera, 2, 4, &error);
-	g_assert (error == NULL);
-	arv_camera_get_binning (camera, &x, &y, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 2);
-	g_assert_cmpint (y, ==, 4);
+static void
+output_policy_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	GError *error = NULL;
+	gint n_input_buffers;
+	gint n_output_buffers;
+	guint n_kept_buffers;
+	gint payload;
+	int i;
 
-	b = arv_camera_is_binning_available (camera, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert (b);
 
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_RGB_8_PACKED, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_RGB_8_PACKED);
+	g_assert_cmpint (arv_stream_get_output_policy (stream, NULL), ==, ARV_STREAM_OUTPUT_POLICY_FIFO);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "RGB8");
+	arv_stream_set_output_policy (stream, ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST, 2);
+	g_assert_cmpint (arv_stream_get_output_policy (stream, &n_kept_buffers), ==,
+			 ARV_STREAM_OUTPUT_POLICY_KEEP_LATEST);
+	g_assert_cmpint (n_kept_buffers, ==, 2);
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_BG_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_BG_8);
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerBG8");
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	g_usleep (200000);
+	arv_camera_stop_acquisition (camera, NULL);
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GB_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GB_8);
+	/* The output queue is bounded, and the stream never runs out of input buffers */
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_output_buffers, <=, 2);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_recycled_buffers"), >, 0);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerGB8");
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GR_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GR_8);
+static void
+auto_buffers_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffers[8];
+	GError *error = NULL;
+	gint payload;
+	guint n_buffers = 0;
+	guint i;
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerGR8");
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_RG_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_RG_8);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerRG8");
+	payload = arv_camera_get_payload (camera, NULL);
+	arv_stream_set_auto_buffers (stream, payload, 2, 16 * payload);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_auto_buffers"), ==, 2);
 
-	arv_camera_set_pixel_format_from_string (camera, "Mono8", &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
 
-	ptr = arv_camera_dup_available_pixel_formats (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	/* Holding the buffers starves the stream thread, the set grows on the next pushes */
+	for (i = 0; i < 20; i++) {
+		ArvBuffer *buffer;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 200000);
+		if (buffer != NULL)
+			buffers[n_buffers++] = buffer;
+		if (n_buffers == G_N_ELEMENTS (buffers) || buffer == NULL) {
+			g_usleep (50000);
+			arv_stream_push_buffers (stream, buffers, n_buffers);
+			n_buffers = 0;
+		}
+	}
+	arv_stream_push_buffers (stream, buffers, n_buffers);
 
-	ptr = arv_camera_dup_available_pixel_formats_as_strings (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	arv_camera_stop_acquisition (camera, NULL);
 
-	ptr = arv_camera_dup_available_pixel_formats_as_display_names (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_auto_buffer_grows"), >, 0);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_auto_buffers"), >, 2);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_auto_buffers"), <=, 16);
 
-	b = arv_camera_is_frame_rate_available (camera, &error);
-	g_assert (error == NULL);
-	g_assert (b);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	d = arv_camera_get_frame_rate (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpfloat (d, ==, ARV_FAKE_CAMERA_ACQUISITION_FRAME_RATE_DEFAULT);
+static void
+ready_fd_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	GPtrArray *buffers;
+	GPollFD poll_fd;
+	GError *error = NULL;
+	gint payload;
+	guint n_buffers = 0;
+	guint i;
 
-	arv_camera_set_frame_rate (camera, 10.0, &error);
-	g_assert (error == NULL);
-	d = arv_camera_get_frame_rate (camera, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert_cmpfloat (d, ==, 10.0);
 
-	b = arv_camera_is_exposure_auto_available (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert (!b);
 
-	b = arv_camera_is_exposure_time_available (camera, &error);
-	g_assert (error == NULL);
-	g_assert (b);
+	poll_fd.fd = arv_stream_get_ready_fd (stream);
+	poll_fd.events = G_IO_IN;
+	g_assert_cmpint (poll_fd.fd, >=, 0);
+	g_assert_cmpint (arv_stream_get_ready_fd (stream), ==, poll_fd.fd);
+	g_assert_cmpint (g_poll (&poll_fd, 1, 0), ==, 0);
 
-	arv_camera_set_gain (camera, 1.0, &error);
-	g_assert (error == NULL);
-	d = arv_camera_get_gain (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpfloat (d, ==, 1.0);
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 8; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
 
-	arv_camera_set_integer (camera, "Unknown", 0, &error);
-	g_assert (error != NULL);
-	g_clear_error (&error);
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
 
-	g_object_unref (camera);
+	while (n_buffers < 10) {
+		g_assert_cmpint (g_poll (&poll_fd, 1, 1000), ==, 1);
+
+		buffers = arv_stream_pop_ready_buffers (stream, 4);
+		g_assert_cmpuint (buffers->len, <=, 4);
+		for (i = 0; i < buffers->len; i++)
+			arv_stream_push_buffer (stream, g_ptr_array_index (buffers, i));
+		n_buffers += buffers->len;
+		g_ptr_array_unref (buffers);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_stream_stop_thread (stream, FALSE);
+
+	/* The readiness is acknowledged once the output queue is drained */
+	do {
+		buffers = arv_stream_pop_ready_buffers (stream, 4);
+		n_buffers = buffers->len;
+		for (i = 0; i < buffers->len; i++)
+			arv_stream_push_buffer (stream, g_ptr_array_index (buffers, i));
+		g_ptr_array_unref (buffers);
+	} while (n_buffers == 4);
+	g_assert_cmpint (g_poll (&poll_fd, 1, 0), ==, 0);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
 }
 
 static void
-set_flag (gpointer user_data, GObject *object)
+_batched_new_buffer_cb (ArvStream *stream, gint *n_signals)
 {
-	gboolean *flag = user_data;
-
-	*flag = TRUE;
+	g_atomic_int_inc (n_signals);
 }
 
 static void
-camera_device_test (void)
+batched_buffers_test (void)
 {
-	ArvDevice *device;
-	ArvDevice *camera_device;
 	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffers[8];
 	GError *error = NULL;
-	gboolean device_released = FALSE;
-
-	device = arv_fake_device_new ("TEST0", &error);
-	g_assert (ARV_IS_FAKE_DEVICE (device));
-	g_assert (error == NULL);
-
-	g_object_weak_ref (G_OBJECT (device), set_flag, &device_released);
+	gint n_input_buffers;
+	gint n_output_buffers;
+	gint n_signals = 0;
+	guint n_buffers;
+	gint payload;
+	guint i;
 
-	camera = arv_camera_new_with_device (device, &error);
+	camera = arv_camera_new ("Fake_1", &error);
 	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	camera_device = arv_camera_get_device (camera);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_assert_cmpuint (arv_stream_pop_buffers (stream, buffers, G_N_ELEMENTS (buffers), 0), ==, 0);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		buffers[i] = arv_buffer_new (payload, NULL);
+	arv_stream_push_buffers (stream, buffers, G_N_ELEMENTS (buffers));
+
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_input_buffers, ==, G_N_ELEMENTS (buffers));
+	g_assert_cmpint (n_output_buffers, ==, 0);
+
+	arv_stream_set_signal_batching (stream, TRUE);
+	g_assert (arv_stream_get_signal_batching (stream));
+	g_signal_connect (stream, "new-buffer", G_CALLBACK (_batched_new_buffer_cb), &n_signals);
+	arv_stream_set_emit_signals (stream, TRUE);
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	g_assert_cmpuint (arv_stream_pop_buffers (stream, buffers, 1, 1000000), ==, 1);
+	arv_stream_push_buffers (stream, buffers, 1);
+	g_usleep (100000);
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_stream_stop_thread (stream, FALSE);
+
+	arv_stream_set_emit_signals (stream, FALSE);
+
+	/* The signal is emitted for the first buffer, and once more after the output queue was emptied */
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_output_buffers, >, 1);
+	g_assert_cmpint (g_atomic_int_get (&n_signals), <=, 2);
+
+	n_buffers = arv_stream_pop_buffers (stream, buffers, G_N_ELEMENTS (buffers), 0);
+	g_assert_cmpuint (n_buffers, ==, n_output_buffers);
+	for (i = 1; i < n_buffers; i++)
+		g_assert_cmpuint (arv_buffer_get_frame_id (buffers[i]), >, arv_buffer_get_frame_id (buffers[i - 1]));
+
+	arv_stream_push_buffers (stream, buffers, n_buffers);
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_input_buffers, ==, G_N_ELEMENTS (buffers));
+	g_assert_cmpint (n_output_buffers, ==, 0);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+frame_batching_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 timeout_us;
+	gint payload;
+	guint i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_assert_cmpuint (arv_stream_get_frame_batching (stream, NULL), ==, 0);
+	arv_stream_set_frame_batching (stream, 4, 10000000);
+	g_assert_cmpuint (arv_stream_get_frame_batching (stream, &timeout_us), ==, 4);
+	g_assert_cmpuint (timeout_us, ==, 10000000);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+	for (i = 0; i < 2; i++)
+		arv_stream_push_batch_buffer (stream, arv_buffer_new (4 * (payload + 64), NULL));
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 3; i++) {
+		const ArvBufferBatchFrame *frame;
+		const void *data;
+		size_t size;
+		guint j;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 2000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpuint (arv_buffer_get_n_batch_frames (buffer), ==, 4);
+
+		frame = arv_buffer_get_batch_frame (buffer, 0);
+		g_assert (frame != NULL);
+		g_assert_cmpuint (frame->frame_id, ==, arv_buffer_get_frame_id (buffer));
+
+		for (j = 0; j < 4; j++) {
+			frame = arv_buffer_get_batch_frame (buffer, j);
+			g_assert_cmpint (frame->status, ==, ARV_BUFFER_STATUS_SUCCESS);
+			g_assert_cmpuint (frame->offset % 64, ==, 0);
+			if (j > 0)
+				g_assert_cmpuint (frame->frame_id, >, arv_buffer_get_batch_frame (buffer, j - 1)->frame_id);
+
+			data = arv_buffer_get_batch_frame_data (buffer, j, &size);
+			g_assert (data != NULL);
+			g_assert_cmpuint (size, >, 0);
+			g_assert_cmpuint (size, <=, payload);
+		}
+		g_assert (arv_buffer_get_batch_frame (buffer, 4) == NULL);
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_stream_stop_thread (stream, FALSE);
+
+	/* The frame buffers never leave the stream */
+	buffer = arv_buffer_new (payload, NULL);
+	g_assert_cmpuint (arv_buffer_get_n_batch_frames (buffer), ==, 0);
+	g_clear_object (&buffer);
+
+	while ((buffer = arv_stream_try_pop_buffer (stream)) != NULL) {
+		g_assert_cmpuint (arv_buffer_get_n_batch_frames (buffer), >, 0);
+		g_clear_object (&buffer);
+	}
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+_inline_stage (ArvBuffer *buffer, void *user_data)
+{
+	gint *n_processed = user_data;
+
+	g_atomic_int_inc (n_processed);
+}
+
+static void
+_worker_stage (ArvBuffer *buffer, void *user_data)
+{
+	gint *n_processed = user_data;
+
+	/* Out of order completion of the workers */
+	g_usleep ((arv_buffer_get_frame_id (buffer) % 3) * 2000);
+	g_atomic_int_inc (n_processed);
+}
+
+static void
+stream_stages_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 last_frame_id = 0;
+	gint n_inline = 0;
+	gint n_worker = 0;
+	gint n_popped = 0;
+	gint payload;
+	int i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "n-stage-workers", 3, NULL);
+	arv_stream_add_stage (stream, _inline_stage, &n_inline, NULL, ARV_STREAM_STAGE_MODE_INLINE);
+	arv_stream_add_stage (stream, _worker_stage, &n_worker, NULL, ARV_STREAM_STAGE_MODE_WORKER);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 8; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 200.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	/* The processed buffers are output in frame order */
+	for (i = 0; i < 20; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			if (n_popped > 0)
+				g_assert_cmpuint (arv_buffer_get_frame_id (buffer), >, last_frame_id);
+			last_frame_id = arv_buffer_get_frame_id (buffer);
+			n_popped++;
+			g_assert_cmpint (g_atomic_int_get (&n_worker), >=, n_popped);
+		}
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert_cmpint (n_popped, >, 0);
+	g_assert_cmpint (g_atomic_int_get (&n_inline), >=, n_popped);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+host_auto_exposure_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	double exposure_time_us;
+	gint payload;
+	int i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	exposure_time_us = arv_camera_get_exposure_time (camera, NULL);
+
+	/* The fake images are brighter than the target */
+	arv_camera_set_host_auto_exposure_target (camera, 0.2, 0.02, 1.0);
+	arv_camera_set_host_auto_exposure_controller (camera, 1.0, 1);
+	g_assert (arv_camera_start_host_auto_exposure (camera, stream, &error));
+	g_assert (error == NULL);
+	g_assert (arv_camera_is_host_auto_exposure_running (camera));
+	g_assert (arv_stream_get_compute_statistics (stream));
+
+	arv_camera_set_frame_rate (camera, 200.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 20; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			g_assert (arv_buffer_has_statistics (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_camera_stop_host_auto_exposure (camera);
+	g_assert (!arv_camera_is_host_auto_exposure_running (camera));
+
+	g_assert_cmpfloat (arv_camera_get_exposure_time (camera, NULL), <, exposure_time_us);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+ensure_buffers_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	GError *error = NULL;
+	gint n_input_buffers;
+	guint payload;
+	gint width;
+	int i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	arv_camera_set_register_cache_policy (camera, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	arv_camera_get_region (camera, NULL, NULL, &width, NULL, NULL);
+	arv_camera_set_region (camera, -1, -1, width / 2, -1, NULL);
+	payload = arv_camera_get_payload (camera, NULL);
+	g_assert_cmpint (payload, >, 0);
+	g_assert_cmpint (arv_camera_get_payload (camera, NULL), ==, payload);
+
+	for (i = 0; i < 2; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_stream_stop_thread (stream, FALSE);
+
+	/* Smaller payload, the buffers are reused */
+	arv_camera_set_region (camera, -1, -1, width / 4, -1, NULL);
+	g_assert_cmpint (arv_camera_get_payload (camera, NULL), <, payload);
+	g_assert_cmpint (arv_stream_ensure_buffers (stream, 2,
+						    arv_camera_get_payload (camera, NULL)), ==, 0);
+
+	/* Larger payload, the buffers are replaced */
+	arv_camera_set_region (camera, -1, -1, width, -1, NULL);
+	g_assert_cmpint (arv_camera_get_payload (camera, NULL), >, payload);
+	g_assert_cmpint (arv_stream_ensure_buffers (stream, 3,
+						    arv_camera_get_payload (camera, NULL)), ==, 3);
+	arv_stream_get_n_buffers (stream, &n_input_buffers, NULL);
+	g_assert_cmpint (n_input_buffers, ==, 3);
+
+	g_assert_cmpint (arv_stream_ensure_buffers (stream, 1, payload), ==, 0);
+	arv_stream_get_n_buffers (stream, &n_input_buffers, NULL);
+	g_assert_cmpint (n_input_buffers, ==, 1);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+lock_memory_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gboolean lock_memory;
+	guint payload;
+	int i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	/* The locking may be refused by RLIMIT_MEMLOCK, the pages being only prefaulted */
+	g_object_set (stream, "lock-memory", TRUE, NULL);
+	g_object_get (stream, "lock-memory", &lock_memory, NULL);
+	g_assert (lock_memory);
+
+	arv_stream_stop_thread (stream, FALSE);
+	arv_stream_start_thread (stream);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 2; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 3; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+openmetrics_test (void)
+{
+	ArvCamera *camera;
+	ArvDevice *device;
+	ArvStream *stream;
+	GError *error = NULL;
+	const char *camera_ids[] = {"Fake \"1\""};
+	guint64 n_misses;
+	char *metrics;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	device = arv_camera_get_device (camera);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+
+	arv_camera_set_register_cache_policy (camera, ARV_REGISTER_CACHE_POLICY_ENABLE);
+	arv_camera_get_integer (camera, "Width", NULL);
+	n_misses = arv_device_get_info_uint64_by_name (device, "n_register_cache_misses");
+	arv_camera_get_integer (camera, "Width", NULL);
+	g_assert_cmpint (arv_device_get_info_uint64_by_name (device, "n_register_cache_misses"), ==, n_misses);
+	g_assert_cmpint (arv_device_get_info_uint64_by_name (device, "n_register_cache_hits"), >, 0);
+	g_assert_cmpint (arv_device_get_info_type (device, 0), ==, G_TYPE_UINT64);
+
+	metrics = arv_dup_openmetrics (1, camera_ids, &device, &stream);
+	g_assert (metrics != NULL);
+	g_assert (g_str_has_suffix (metrics, "# EOF\n"));
+	g_assert (strstr (metrics, "# TYPE aravis_device_n_register_cache_hits counter\n") != NULL);
+	g_assert (strstr (metrics, "aravis_stream_n_completed_buffers_total{camera=\"Fake \\\"1\\\"\"} 0\n") != NULL);
+	g_assert (strstr (metrics, "# TYPE aravis_stream_latency_delivery_p50_us gauge\n") != NULL);
+	g_free (metrics);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+#ifdef G_OS_UNIX
+
+static void
+recorder_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBufferPool *pool;
+	ArvRecorder *recorder;
+	ArvRecorderFileHeader *file_header;
+	ArvRecorderRecordHeader *record_header;
+	ArvRecording *recording;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	char *filename;
+	char *contents;
+	const char *data;
+	gsize length;
+	size_t size;
+	guint64 n_records = 0;
+	guint64 offset;
+	guint64 i;
+	gint payload;
+	gint64 start_time;
+	int fd;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	/* Block aligned buffers, written without copy */
+	pool = arv_buffer_pool_new_full (3, payload, ARV_RECORDER_BLOCK_SIZE, ARV_BUFFER_POOL_FLAGS_NONE, -1, &error);
+	g_assert (ARV_IS_BUFFER_POOL (pool));
+	arv_buffer_pool_attach_stream (pool, stream);
+
+	/* Unaligned buffer, copied to the staging memory */
+	arv_stream_push_buffer (stream, arv_buffer_new_full (payload, NULL, NULL, NULL));
+
+	fd = g_file_open_tmp ("arv-recorder-XXXXXX.rec", &filename, &error);
+	g_assert (fd >= 0);
+	g_close (fd, NULL);
+
+	recorder = arv_recorder_new (stream, filename, 64 * 1024 * 1024, &error);
+	g_assert (ARV_IS_RECORDER (recorder));
+	g_assert (error == NULL);
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	start_time = g_get_monotonic_time ();
+	while (n_records < 8 && g_get_monotonic_time () - start_time < 5000000) {
+		g_usleep (10000);
+		arv_recorder_get_statistics (recorder, &n_records, NULL, NULL);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_recorder_stop (recorder);
+	arv_recorder_get_statistics (recorder, &n_records, NULL, NULL);
+	g_assert_cmpint (n_records, >=, 8);
+
+	g_assert (g_file_get_contents (filename, &contents, &length, &error));
+
+	file_header = (ArvRecorderFileHeader *) contents;
+	g_assert (memcmp (file_header->magic, ARV_RECORDER_FILE_MAGIC, sizeof (file_header->magic)) == 0);
+	g_assert_cmpint (file_header->block_size, ==, ARV_RECORDER_BLOCK_SIZE);
+	g_assert_cmpint (file_header->n_records, ==, n_records);
+	g_assert_cmpint (file_header->index_offset, ==, file_header->data_size);
+	g_assert_cmpint (file_header->index_offset, <, length);
+	g_assert_cmpint (file_header->genicam_size, >, 0);
+	g_assert_cmpint (file_header->features_size, >, 0);
+
+	offset = file_header->records_offset;
+	for (i = 0; i < n_records; i++) {
+		g_assert_cmpint (offset + sizeof (ArvRecorderRecordHeader), <=, length);
+
+		record_header = (ArvRecorderRecordHeader *) (contents + offset);
+		g_assert_cmpint (record_header->magic, ==, ARV_RECORDER_RECORD_MAGIC);
+		g_assert_cmpint (record_header->data_size, ==, payload);
+		g_assert_cmpint (record_header->status, ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (record_header->payload_type, ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		g_assert_cmpint (record_header->record_size % ARV_RECORDER_BLOCK_SIZE, ==, 0);
+		g_assert_cmpint (record_header->width * record_header->height, ==, payload);
+
+		offset += record_header->record_size;
+	}
+	g_assert_cmpint (offset, ==, file_header->data_size);
+
+	recording = arv_recording_new (filename, &error);
+	g_assert (ARV_IS_RECORDING (recording));
+	g_assert (error == NULL);
+
+	g_assert_cmpint (arv_recording_get_n_frames (recording), ==, n_records);
+	g_assert (arv_recording_get_genicam_xml (recording, &size) != NULL);
+	g_assert_cmpint (size, ==, file_header->genicam_size);
+	g_assert (strstr (arv_recording_get_features (recording), "Width=") != NULL);
+
+	buffer = arv_recording_get_buffer (recording, 2);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_recording_find_frame_id (recording, arv_buffer_get_frame_id (buffer)), ==, 2);
+	g_assert_cmpint (arv_recording_find_timestamp (recording, arv_buffer_get_timestamp (buffer)), <=, 2);
+	g_assert_cmpint (arv_recording_find_timestamp (recording, G_MAXUINT64), ==, -1);
+	g_assert_cmpint (arv_buffer_get_image_width (buffer) * arv_buffer_get_image_height (buffer), ==, payload);
+
+	/* The buffer keeps the file mapped */
+	g_clear_object (&recording);
+
+	record_header = (ArvRecorderRecordHeader *) (contents + file_header->records_offset);
+	data = arv_buffer_get_data (buffer, &size);
+	g_assert_cmpint (size, ==, payload);
+	g_assert (memcmp (data, contents + file_header->records_offset + 2 * record_header->record_size +
+			  record_header->header_size, payload) == 0);
+	g_clear_object (&buffer);
+
+	/* Interrupted recording, without frame table */
+	g_assert (g_file_set_contents (filename, contents, file_header->data_size, &error));
+
+	recording = arv_recording_new (filename, &error);
+	g_assert (ARV_IS_RECORDING (recording));
+	g_assert_cmpint (arv_recording_get_n_frames (recording), ==, n_records);
+	g_clear_object (&recording);
+
+	g_clear_object (&recorder);
+	g_clear_object (&stream);
+	g_clear_object (&pool);
+
+	/* Replay through a new fake stream */
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (arv_fake_stream_set_replay (ARV_FAKE_STREAM (stream), filename,
+					      ARV_FAKE_STREAM_REPLAY_MODE_MAX_RATE, &error));
+	g_assert (error == NULL);
+
+	arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+	arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	/* Skip a pattern frame possibly filled while the replay was set */
+	record_header = (ArvRecorderRecordHeader *) (contents + file_header->records_offset);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	if (arv_buffer_get_frame_id (buffer) != record_header->frame_id) {
+		arv_stream_push_buffer (stream, buffer);
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+	}
+
+	/* The replay loops back to the first frame */
+	for (i = 0; i <= n_records; i++) {
+		record_header = (ArvRecorderRecordHeader *) (contents + file_header->records_offset +
+							     (i % n_records) * record_header->record_size);
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (arv_buffer_get_frame_id (buffer), ==, record_header->frame_id);
+		g_assert_cmpint (arv_buffer_get_timestamp (buffer), ==, record_header->timestamp_ns);
+
+		arv_stream_push_buffer (stream, buffer);
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+	}
+	g_clear_object (&buffer);
+
+	g_free (contents);
+	g_unlink (filename);
+	g_free (filename);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+#endif
+
+#if ARAVIS_HAS_SHARED_MEMORY
+
+static void
+shared_stream_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvSharedPublisher *publisher;
+	ArvSharedStream *reader;
+	ArvBuffer *buffers[3];
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 n_published = 0;
+	guint64 n_received = 0;
+	guint64 frame_id = 0;
+	guint n_readers = 0;
+	size_t size;
+	gint payload;
+	guint i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	reader = arv_shared_stream_new ("arv-test-shared", &error);
+	g_assert (reader == NULL);
+	g_assert_error (error, ARV_SHARED_STREAM_ERROR, ARV_SHARED_STREAM_ERROR_NOT_FOUND);
+	g_clear_error (&error);
+
+	publisher = arv_shared_publisher_new (stream, "arv-test-shared", 8, payload, &error);
+	g_assert (ARV_IS_SHARED_PUBLISHER (publisher));
+	g_assert (error == NULL);
+
+	reader = arv_shared_stream_new ("arv-test-shared", &error);
+	g_assert (ARV_IS_SHARED_STREAM (reader));
+	g_assert (error == NULL);
+	g_assert (arv_shared_stream_is_publisher_alive (reader));
+
+	arv_shared_publisher_get_statistics (publisher, NULL, NULL, &n_readers);
+	g_assert_cmpint (n_readers, ==, 1);
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	/* Held buffers keep their slot, and their data */
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++) {
+		buffers[i] = arv_shared_stream_timeout_pop_buffer (reader, 1000000);
+		g_assert (ARV_IS_BUFFER (buffers[i]));
+		g_assert_cmpint (arv_buffer_get_status (buffers[i]), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (arv_buffer_get_payload_type (buffers[i]), ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		g_assert_cmpint (arv_buffer_get_image_width (buffers[i]) *
+				 arv_buffer_get_image_height (buffers[i]), ==, payload);
+		g_assert (arv_buffer_get_data (buffers[i], &size) != NULL);
+		g_assert_cmpint (size, ==, payload);
+		if (i > 0)
+			g_assert_cmpint (arv_buffer_get_frame_id (buffers[i]), >, frame_id);
+		frame_id = arv_buffer_get_frame_id (buffers[i]);
+	}
+
+	for (i = 0; i < 16; i++) {
+		buffer = arv_shared_stream_timeout_pop_buffer (reader, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_shared_stream_push_buffer (reader, buffer);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		arv_shared_stream_push_buffer (reader, buffers[i]);
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	arv_shared_stream_get_statistics (reader, &n_received, NULL);
+	g_assert_cmpint (n_received, ==, G_N_ELEMENTS (buffers) + 16);
+	arv_shared_publisher_get_statistics (publisher, &n_published, NULL, NULL);
+	g_assert_cmpint (n_published, >=, n_received);
+
+	arv_shared_publisher_stop (publisher);
+	g_assert (!arv_shared_stream_is_publisher_alive (reader));
+
+	while ((buffer = arv_shared_stream_try_pop_buffer (reader)) != NULL)
+		arv_shared_stream_push_buffer (reader, buffer);
+	g_assert (arv_shared_stream_pop_buffer (reader) == NULL);
+
+	g_clear_object (&reader);
+	g_clear_object (&publisher);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+#endif
+
+static void
+camera_api_test (void)
+{
+	ArvCamera *camera;
+	ArvPixelFormat pixel_format;
+	GError *error = NULL;
+	int x, y, w, h;
+	const char *string;
+	void *ptr;
+	unsigned int n;
+	gboolean b;
+	double d;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	string = arv_camera_get_vendor_name (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	string = arv_camera_get_model_name (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	string = arv_camera_get_device_id (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 0);
+	g_assert_cmpint (y, ==, 0);
+	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
+	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_HEIGHT_DEFAULT);
+
+	arv_camera_get_sensor_size (camera, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_SENSOR_WIDTH);
+	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_SENSOR_HEIGHT);
+
+	arv_camera_set_region (camera, 10, 20, 30, 40, &error);
+	g_assert (error == NULL);
+	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 10);
+	g_assert_cmpint (y, ==, 20);
+	g_assert_cmpint (w, ==, 30);
+	g_assert_cmpint (h, ==, 40);
+
+	arv_camera_get_binning (camera, &x, &y, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, ARV_FAKE_CAMERA_BINNING_HORIZONTAL_DEFAULT);
+	g_assert_cmpint (y, ==, ARV_FAKE_CAMERA_BINNING_VERTICAL_DEFAULT);
+
+	arv_camera_set_binning (camera, 2, 4, &error);
+	g_assert (error == NULL);
+	arv_camera_get_binning (camera, &x, &y, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 2);
+	g_assert_cmpint (y, ==, 4);
+
+	b = arv_camera_is_binning_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_RGB_8_PACKED, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_RGB_8_PACKED);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "RGB8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_BG_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_BG_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerBG8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GB_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GB_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerGB8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GR_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GR_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerGR8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_RG_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_RG_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerRG8");
+
+	arv_camera_set_pixel_format_from_string (camera, "Mono8", &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+
+	ptr = arv_camera_dup_available_pixel_formats (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 7);
+	g_clear_pointer (&ptr, g_free);
+
+	ptr = arv_camera_dup_available_pixel_formats_as_strings (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 7);
+	g_clear_pointer (&ptr, g_free);
+
+	ptr = arv_camera_dup_available_pixel_formats_as_display_names (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 7);
+	g_clear_pointer (&ptr, g_free);
+
+	b = arv_camera_is_frame_rate_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	d = arv_camera_get_frame_rate (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, ARV_FAKE_CAMERA_ACQUISITION_FRAME_RATE_DEFAULT);
+
+	arv_camera_set_frame_rate (camera, 10.0, &error);
+	g_assert (error == NULL);
+	d = arv_camera_get_frame_rate (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, 10.0);
+
+	b = arv_camera_is_exposure_auto_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (!b);
+
+	b = arv_camera_is_exposure_time_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	arv_camera_set_gain (camera, 1.0, &error);
+	g_assert (error == NULL);
+	d = arv_camera_get_gain (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, 1.0);
+
+	arv_camera_set_integer (camera, "Unknown", 0, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	g_object_unref (camera);
+}
+
+static void
+set_flag (gpointer user_data, GObject *object)
+{
+	gboolean *flag = user_data;
+
+	*flag = TRUE;
+}
+
+static void
+camera_device_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *camera_device;
+	ArvCamera *camera;
+	GError *error = NULL;
+	gboolean device_released = FALSE;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	g_object_weak_ref (G_OBJECT (device), set_flag, &device_released);
+
+	camera = arv_camera_new_with_device (device, &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	camera_device = arv_camera_get_device (camera);
 	g_assert (ARV_IS_FAKE_DEVICE (camera_device));
 	g_assert (device == camera_device);
 
-	g_assert (!device_released);
+	g_assert (!device_released);
+
+	g_object_unref (device);
+	g_assert (!device_released);
+
+	g_object_unref (camera);
+	g_assert (device_released);
+
+	g_test_expect_message (G_LOG_DOMAIN,
+			       G_LOG_LEVEL_CRITICAL,
+			       "*assertion*");
+	arv_camera_new_with_device (NULL, NULL);
+	g_test_assert_expected_messages ();
+
+}
+
+static void
+camera_trigger_selector_test (void)
+{
+	ArvCamera *camera;
+	GError *error = NULL;
+	const char *string;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	/* Enable TriggerMode on FrameStart */
+	arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &error);
+	g_assert (error == NULL);
+	arv_camera_set_string (camera, "TriggerMode", "On", &error);
+	g_assert (error == NULL);
+	string = arv_camera_get_string(camera, "TriggerMode", &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "On");
+
+	/* Disable TriggerMode on AcquisitionStart */
+	arv_camera_set_string (camera, "TriggerSelector", "AcquisitionStart", &error);
+	g_assert (error == NULL);
+	arv_camera_set_string (camera, "TriggerMode", "Off", &error);
+	g_assert (error == NULL);
+	string = arv_camera_get_string(camera, "TriggerMode", &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "Off");
+
+	/* Re-check TriggerMode value on FrameStart */
+	arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &error);
+	g_assert (error == NULL);
+	string = arv_camera_get_string(camera, "TriggerMode", &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "On");
+
+	g_object_unref (camera);
+}
+
+static void
+set_features_from_string_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	gboolean success;
+	gint64 int_value;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8 Height=1048 AcquisitionStart", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	int_value = arv_device_get_integer_feature_value (device, "Height", NULL);
+	g_assert_cmpint (int_value, ==, 1048);
+
+	success = arv_device_set_features_from_string (device, "NotAFeature=NotAValue", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "NotAFeature", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=NotAValidEntry", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "StartAcquitision=Value", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8    AcquisitionStart", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	success = arv_device_set_features_from_string (device, NULL, NULL);
+	g_assert (success);
+
+	g_object_unref (device);
+}
+
+static void
+feature_snapshot_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	gboolean success;
+	char *snapshot;
+	char *filename = NULL;
+	int fd;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	success = arv_device_set_features_from_string_full (device, "Height=1048 PixelFormat=RGB8",
+							    ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY |
+							    ARV_DEVICE_SET_FEATURES_FLAGS_TRANSACTION, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Height", NULL), ==, 1048);
+
+	/* Nothing to write the second time */
+	success = arv_device_set_features_from_string_full (device, "Height=1048 PixelFormat=RGB8",
+							    ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	snapshot = arv_device_dup_feature_snapshot (device);
+	g_assert (snapshot != NULL);
+	g_assert (strstr (snapshot, "Height='1048'") != NULL);
+	g_free (snapshot);
+
+	fd = g_file_open_tmp ("arv-snapshot-XXXXXX.txt", &filename, &error);
+	g_assert (fd >= 0);
+	g_close (fd, NULL);
+
+	success = arv_device_save_feature_snapshot (device, filename, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	arv_device_set_integer_feature_value (device, "Height", 256, &error);
+	g_assert (error == NULL);
+
+	success = arv_device_load_feature_snapshot (device, filename,
+						    ARV_DEVICE_SET_FEATURES_FLAGS_CHANGED_ONLY, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Height", NULL), ==, 1048);
+
+	g_unlink (filename);
+	g_free (filename);
+
+	g_object_unref (device);
+}
+
+static void
+read_all_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	gboolean success;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+
+	/* Nothing to do without register cache */
+	success = arv_gc_read_all (genicam, NULL, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	arv_device_set_register_cache_policy (device, ARV_REGISTER_CACHE_POLICY_DEBUG);
+
+	success = arv_gc_read_all (genicam, "ImageFormatControl", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	success = arv_gc_read_all (genicam, NULL, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Width", NULL), ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Height", NULL), ==, ARV_FAKE_CAMERA_HEIGHT_DEFAULT);
+	g_assert_cmpstr (arv_device_get_string_feature_value (device, "DeviceVendorName", NULL), ==, "Aravis");
+
+	g_object_unref (device);
+}
+
+static void
+feature_cache_policy_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint64 n_hits, n_misses, n_errors;
+	guint64 n_width_hits, n_width_misses;
+	gboolean success;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	success = arv_gc_get_cache_statistics (genicam, "Width", &n_hits, &n_misses, NULL);
+	g_assert (success);
+
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+
+	arv_gc_get_cache_statistics (genicam, "Width", &n_width_hits, &n_width_misses, &n_errors);
+	g_assert_cmpint (n_width_misses, ==, n_misses + 1);
+	g_assert_cmpint (n_width_hits, >, n_hits);
+	g_assert_cmpint (n_errors, ==, 0);
+
+	success = arv_gc_get_cache_statistics (genicam, NULL, &n_hits, &n_misses, NULL);
+	g_assert (success);
+	g_assert_cmpint (n_hits, >=, n_width_hits);
+	g_assert_cmpint (n_misses, >=, n_width_misses);
+
+	/* An uncached feature reads the device each time */
+	success = arv_gc_set_feature_register_cache_policy (genicam, "ImageFormatControl",
+							    ARV_REGISTER_CACHE_POLICY_DISABLE, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+
+	arv_gc_get_cache_statistics (genicam, "Width", &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_hits, ==, n_width_hits);
+	g_assert_cmpint (n_misses, ==, n_width_misses + 2);
+
+	success = arv_gc_reset_feature_register_cache_policy (genicam, "Width", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+
+	arv_gc_get_cache_statistics (genicam, "Width", &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_hits, >, n_width_hits);
+	g_assert_cmpint (n_misses, ==, n_width_misses + 3);
+
+	success = arv_gc_set_feature_register_cache_policy (genicam, "Unknown",
+							    ARV_REGISTER_CACHE_POLICY_DISABLE, &error);
+	g_assert (!success);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND);
+	g_clear_error (&error);
+
+	g_assert (!arv_gc_get_cache_statistics (genicam, "Unknown", NULL, NULL, NULL));
+
+	g_object_unref (device);
+}
+
+#if ARAVIS_HAS_USB
+static void
+uv_bandwidth_planner_test (void)
+{
+	ArvUvBandwidthPlanner *planner;
+	ArvCamera *camera;
+	GError *error = NULL;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	planner = arv_uv_bandwidth_planner_new ();
+	g_assert (ARV_IS_UV_BANDWIDTH_PLANNER (planner));
+
+	/* Only USB3 Vision cameras have a place in the USB topology */
+	g_assert (!arv_uv_bandwidth_planner_add_camera (planner, camera, &error));
+	g_assert_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_NOT_SUPPORTED);
+	g_clear_error (&error);
+
+	g_assert (arv_uv_bandwidth_planner_apply (planner, &error));
+	g_assert (error == NULL);
+	g_assert_cmpuint (arv_uv_bandwidth_planner_get_bandwidth (planner, camera), ==, 0);
+	g_assert_cmpuint (arv_uv_bandwidth_planner_get_required_bandwidth (planner, camera), ==, 0);
+
+	g_object_unref (planner);
+	g_object_unref (camera);
+}
+#endif
+
+static void
+feature_profile_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcFeatureProfile profile;
+	GError *error = NULL;
+	char **features;
+	char *report;
+	guint n_features;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_range_check_policy (genicam, ARV_RANGE_CHECK_POLICY_ENABLE);
+
+	g_assert (!arv_gc_get_profiling_enable (genicam));
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	g_assert (!arv_gc_get_feature_profile (genicam, "Width", &profile));
+	g_assert_cmpint (profile.n_accesses, ==, 0);
+
+	arv_gc_set_profiling_enable (genicam, TRUE);
+	g_assert (arv_gc_get_profiling_enable (genicam));
+
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+
+	g_assert (arv_gc_get_feature_profile (genicam, "Width", &profile));
+	g_assert_cmpint (profile.n_accesses, ==, 2);
+	g_assert_cmpint (profile.n_reads, ==, 2);
+	g_assert_cmpint (profile.n_read_bytes, ==, 8);
+	g_assert_cmpint (profile.n_writes, ==, 0);
+	g_assert_cmpint (profile.max_time_us, <=, profile.total_time_us);
+
+	/* The range check reads of SensorWidth are accounted to Width */
+	arv_device_set_integer_feature_value (device, "Width", 512, &error);
+	g_assert (error == NULL);
+
+	g_assert (arv_gc_get_feature_profile (genicam, "Width", &profile));
+	g_assert_cmpint (profile.n_accesses, ==, 3);
+	g_assert_cmpint (profile.n_reads, >=, 3);
+	g_assert_cmpint (profile.n_writes, ==, 1);
+	g_assert_cmpint (profile.n_written_bytes, ==, 4);
+
+	g_assert (!arv_gc_get_feature_profile (genicam, "SensorWidth", &profile));
+	g_assert (!arv_gc_get_feature_profile (genicam, "WidthRegister", &profile));
+
+	arv_device_get_integer_feature_value (device, "Height", NULL);
+
+	features = arv_gc_dup_profiled_features (genicam, &n_features);
+	g_assert_cmpint (n_features, ==, 2);
+	g_assert (g_strv_contains ((const char * const *) features, "Width"));
+	g_assert (g_strv_contains ((const char * const *) features, "Height"));
+	g_strfreev (features);
+
+	report = arv_gc_dup_profile_report (genicam);
+	g_assert (strstr (report, "Width") != NULL);
+	g_assert (strstr (report, "Total") != NULL);
+	g_free (report);
+
+	arv_gc_reset_profile (genicam);
+	g_assert (!arv_gc_get_feature_profile (genicam, "Width", &profile));
+
+	arv_gc_set_profiling_enable (genicam, FALSE);
+	arv_device_get_integer_feature_value (device, "Width", NULL);
+	g_assert (!arv_gc_get_feature_profile (genicam, "Width", &profile));
+
+	g_object_unref (device);
+}
+
+static void
+struct_entry_coalescing_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint64 n_hits, n_misses;
+	guint64 n_base_hits, n_base_misses;
+	const char *entries[] = {"StructEntry_16_31", "StructEntry_0_15", "StructEntry_15", "StructEntry_0_31"};
+	gint64 value;
+	guint i;
 
-	g_object_unref (device);
-	g_assert (!device_released);
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
 
-	g_object_unref (camera);
-	g_assert (device_released);
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DISABLE);
+	arv_gc_set_struct_entry_snapshot_lifetime (genicam, 10 * G_TIME_SPAN_SECOND);
+	g_assert_cmpint (arv_gc_get_struct_entry_snapshot_lifetime (genicam), ==, 10 * G_TIME_SPAN_SECOND);
 
-	g_test_expect_message (G_LOG_DOMAIN,
-			       G_LOG_LEVEL_CRITICAL,
-			       "*assertion*");
-	arv_camera_new_with_device (NULL, NULL);
-	g_test_assert_expected_messages ();
+	arv_device_set_integer_feature_value (device, "StructEntry_0_31", 0x12345678, &error);
+	g_assert (error == NULL);
+
+	g_assert (arv_gc_get_cache_statistics (genicam, "StructEntry_0_15", &n_base_hits, &n_base_misses, NULL));
+
+	/* One register read for all the entries */
+	for (i = 0; i < G_N_ELEMENTS (entries); i++)
+		arv_device_get_integer_feature_value (device, entries[i], NULL);
+
+	arv_gc_get_cache_statistics (genicam, "StructEntry_0_15", &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_misses, ==, n_base_misses + 1);
+	g_assert_cmpint (n_hits, ==, n_base_hits + 3);
+
+	/* A second read of the same entry starts a new polling cycle */
+	value = arv_device_get_integer_feature_value (device, "StructEntry_0_15", NULL);
+	g_assert_cmpint (value, ==, 0x1234);
+	arv_gc_get_cache_statistics (genicam, "StructEntry_0_15", &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_misses, ==, n_base_misses + 2);
+
+	/* A write drops the snapshot */
+	arv_device_set_integer_feature_value (device, "StructEntry_0_31", 0xabcd0000, &error);
+	g_assert (error == NULL);
+	value = arv_device_get_integer_feature_value (device, "StructEntry_16_31", NULL);
+	g_assert_cmpint (value, ==, 0);
+	value = arv_device_get_integer_feature_value (device, "StructEntry_0_15", NULL);
+	g_assert_cmpint (value, ==, 0xabcd);
+
+	arv_gc_set_struct_entry_snapshot_lifetime (genicam, 0);
+	arv_gc_get_cache_statistics (genicam, "StructEntry_0_15", &n_base_hits, &n_base_misses, NULL);
+
+	for (i = 0; i < G_N_ELEMENTS (entries); i++)
+		arv_device_get_integer_feature_value (device, entries[i], NULL);
 
+	arv_gc_get_cache_statistics (genicam, "StructEntry_0_15", &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_misses, ==, n_base_misses + G_N_ELEMENTS (entries));
+	g_assert_cmpint (n_hits, ==, n_base_hits);
+
+	g_object_unref (device);
 }
 
 static void
-camera_trigger_selector_test (void)
+shadow_memory_test (void)
 {
-	ArvCamera *camera;
+	ArvDevice *device;
+	ArvGc *genicam;
 	GError *error = NULL;
-	const char *string;
+	gint64 width;
+	gint64 value;
+	guint32 height;
+	gboolean success;
 
-	camera = arv_camera_new ("Fake_1", &error);
-	g_assert (ARV_IS_CAMERA (camera));
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
 	g_assert (error == NULL);
 
-	/* Enable TriggerMode on FrameStart */
-	arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &error);
-	g_assert (error == NULL);
-	arv_camera_set_string (camera, "TriggerMode", "On", &error);
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+	arv_gc_set_shadow_memory_enable (genicam, TRUE);
+	g_assert (arv_gc_get_shadow_memory_enable (genicam));
+
+	width = arv_device_get_integer_feature_value (device, "WidthRegister", &error);
 	g_assert (error == NULL);
-	string = arv_camera_get_string(camera, "TriggerMode", &error);
+
+	/* Changes behind the register cache are only seen after a prefetch */
+	arv_device_write_register (device, ARV_FAKE_CAMERA_REGISTER_WIDTH, width + 16, &error);
 	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "On");
+	value = arv_device_get_integer_feature_value (device, "WidthRegister", &error);
+	g_assert_cmpint (value, ==, width);
 
-	/* Disable TriggerMode on AcquisitionStart */
-	arv_camera_set_string (camera, "TriggerSelector", "AcquisitionStart", &error);
+	success = arv_gc_prefetch_memory (genicam, ARV_FAKE_CAMERA_REGISTER_WIDTH, 8, &error);
+	g_assert (success);
 	g_assert (error == NULL);
-	arv_camera_set_string (camera, "TriggerMode", "Off", &error);
+
+	/* Served from the shadow memory, without device read */
+	arv_device_write_register (device, ARV_FAKE_CAMERA_REGISTER_WIDTH, width + 32, &error);
 	g_assert (error == NULL);
-	string = arv_camera_get_string(camera, "TriggerMode", &error);
+	value = arv_device_get_integer_feature_value (device, "WidthRegister", &error);
+	g_assert_cmpint (value, ==, width + 16);
+
+	arv_device_read_register (device, ARV_FAKE_CAMERA_REGISTER_HEIGHT, &height, &error);
 	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "Off");
+	value = arv_device_get_integer_feature_value (device, "HeightRegister", &error);
+	g_assert_cmpint (value, ==, height);
 
-	/* Re-check TriggerMode value on FrameStart */
-	arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &error);
+	/* Write-through */
+	arv_device_set_integer_feature_value (device, "WidthRegister", width, &error);
 	g_assert (error == NULL);
-	string = arv_camera_get_string(camera, "TriggerMode", &error);
+	value = arv_device_get_integer_feature_value (device, "WidthRegister", &error);
+	g_assert_cmpint (value, ==, width);
+
+	/* Disabling drops the cached values */
+	arv_device_write_register (device, ARV_FAKE_CAMERA_REGISTER_WIDTH, width + 8, &error);
 	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "On");
+	arv_gc_set_shadow_memory_enable (genicam, FALSE);
+	value = arv_device_get_integer_feature_value (device, "WidthRegister", &error);
+	g_assert_cmpint (value, ==, width + 8);
 
-	g_object_unref (camera);
+	g_object_unref (device);
+}
+
+static gboolean
+lut_progress_cb (guint64 n_bytes, guint64 n_total_bytes, void *user_data)
+{
+	guint64 *last_n_bytes = user_data;
+
+	g_assert_cmpint (n_bytes, >, *last_n_bytes);
+	g_assert_cmpint (n_bytes, <=, n_total_bytes);
+	*last_n_bytes = n_bytes;
+
+	return TRUE;
+}
+
+static gboolean
+lut_cancel_cb (guint64 n_bytes, guint64 n_total_bytes, void *user_data)
+{
+	return FALSE;
 }
 
 static void
-set_features_from_string_test (void)
+lut_test (void)
 {
-	ArvDevice *device;
+	ArvCamera *camera;
 	GError *error = NULL;
+	gint64 values[ARV_FAKE_CAMERA_LUT_SIZE];
+	guint64 n_bytes = 0;
+	gint64 value;
 	gboolean success;
-	gint64 int_value;
+	guint i;
 
-	device = arv_fake_device_new ("TEST0", &error);
-	g_assert (ARV_IS_FAKE_DEVICE (device));
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8 Height=1048 AcquisitionStart", &error);
+	for (i = 0; i < G_N_ELEMENTS (values); i++)
+		values[i] = (i * 16) % 4096;
+
+	arv_camera_set_integer (camera, "LUTIndex", 10, &error);
+	g_assert (error == NULL);
+	value = arv_camera_get_integer (camera, "LUTValue", &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (value, ==, 0);
+
+	success = arv_camera_set_lut (camera, NULL, values, G_N_ELEMENTS (values), lut_progress_cb, &n_bytes, &error);
 	g_assert (success);
 	g_assert (error == NULL);
+	g_assert_cmpint (n_bytes, ==, G_N_ELEMENTS (values) * 4);
 
-	int_value = arv_device_get_integer_feature_value (device, "Height", NULL);
-	g_assert_cmpint (int_value, ==, 1048);
+	/* Index restored */
+	g_assert_cmpint (arv_camera_get_integer (camera, "LUTIndex", NULL), ==, 10);
+	g_assert_cmpint (arv_camera_get_integer (camera, "LUTValue", NULL), ==, values[10]);
 
-	success = arv_device_set_features_from_string (device, "NotAFeature=NotAValue", &error);
+	for (i = 0; i < G_N_ELEMENTS (values); i += 51) {
+		arv_camera_set_integer (camera, "LUTIndex", i, NULL);
+		g_assert_cmpint (arv_camera_get_integer (camera, "LUTValue", NULL), ==, values[i]);
+	}
+
+	success = arv_camera_set_lut (camera, NULL, values, G_N_ELEMENTS (values) + 1, NULL, NULL, &error);
 	g_assert (!success);
-	g_assert (error != NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "NotAFeature", &error);
+	success = arv_camera_set_lut (camera, NULL, values, G_N_ELEMENTS (values), lut_cancel_cb, NULL, &error);
 	g_assert (!success);
-	g_assert (error != NULL);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat", &error);
+	/* No FileAccess support */
+	success = arv_camera_write_file (camera, "UserSet1", values, sizeof (values), NULL, NULL, &error);
 	g_assert (!success);
-	g_assert (error != NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=NotAValidEntry", &error);
-	g_assert (!success);
-	g_assert (error != NULL);
+	g_object_unref (camera);
+}
+
+static void
+swiss_knife_memoization_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint64 n_hits, n_misses;
+	guint64 n_base_hits, n_base_misses;
+	gint64 payload_size;
+	gint64 width;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	width = arv_device_get_integer_feature_value (device, "Width", NULL);
+	payload_size = arv_device_get_integer_feature_value (device, "PayloadSize", NULL);
+	g_assert_cmpint (payload_size, >, 0);
+
+	/* Unchanged inputs, the value is not recomputed */
+	arv_gc_get_cache_statistics (genicam, NULL, &n_base_hits, &n_base_misses, NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "PayloadSize", NULL), ==, payload_size);
+	arv_gc_get_cache_statistics (genicam, NULL, &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_hits, ==, n_base_hits);
+	g_assert_cmpint (n_misses, ==, n_base_misses);
+
+	arv_device_set_integer_feature_value (device, "Width", width / 2, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "PayloadSize", NULL), ==,
+			 payload_size / width * (width / 2));
+
+	/* Uncached registers may change behind our back */
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DISABLE);
+	arv_gc_get_cache_statistics (genicam, NULL, &n_base_hits, &n_base_misses, NULL);
+	arv_device_get_integer_feature_value (device, "PayloadSize", NULL);
+	arv_gc_get_cache_statistics (genicam, NULL, &n_hits, &n_misses, NULL);
+	g_assert_cmpint (n_misses, >, n_base_misses);
+
+	g_object_unref (device);
+}
+
+static void
+feature_index_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GArray *index;
+	GError *error = NULL;
+	gboolean has_width = FALSE;
+	guint i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	index = arv_gc_dup_feature_index (genicam, NULL, &error);
+	g_assert (index != NULL);
+	g_assert (error == NULL);
+	g_assert_cmpint (index->len, >, 1);
+
+	g_assert_cmpstr (g_array_index (index, ArvGcFeatureIndexEntry, 0).name, ==, "Root");
+	g_assert_cmpint (g_array_index (index, ArvGcFeatureIndexEntry, 0).parent, ==, -1);
+	g_assert_cmpint (g_array_index (index, ArvGcFeatureIndexEntry, 0).level, ==, 0);
+
+	for (i = 1; i < index->len; i++) {
+		ArvGcFeatureIndexEntry *entry = &g_array_index (index, ArvGcFeatureIndexEntry, i);
+		ArvGcFeatureIndexEntry *parent;
+
+		g_assert_cmpint (entry->parent, >=, 0);
+		g_assert_cmpint (entry->parent, <, i);
+		parent = &g_array_index (index, ArvGcFeatureIndexEntry, entry->parent);
+		g_assert (parent->is_category);
+		g_assert_cmpint (entry->level, ==, parent->level + 1);
+
+		if (g_strcmp0 (entry->name, "Width") == 0) {
+			g_assert (entry->node == ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, "Width")));
+			g_assert_cmpstr (parent->name, ==, "ImageFormatControl");
+			g_assert (entry->is_implemented);
+			g_assert (entry->is_available);
+			g_assert_cmpint (entry->access_mode, !=, ARV_GC_ACCESS_MODE_UNDEFINED);
+			has_width = TRUE;
+		}
+	}
+	g_assert (has_width);
+
+	g_array_unref (index);
+
+	index = arv_gc_dup_feature_index (genicam, "ImageFormatControl", &error);
+	g_assert (index != NULL);
+	g_assert_cmpstr (g_array_index (index, ArvGcFeatureIndexEntry, 0).name, ==, "ImageFormatControl");
+	g_array_unref (index);
+
+	index = arv_gc_dup_feature_index (genicam, "NotAFeature", &error);
+	g_assert (index == NULL);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "StartAcquitision=Value", &error);
-	g_assert (!success);
-	g_assert (error != NULL);
+	g_object_unref (device);
+}
+
+static void
+_feature_changed_cb (ArvGc *genicam, const char *feature, guint *n_changes)
+{
+	(*n_changes)++;
+}
+
+static void
+feature_changed_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint n_payload_size_changes = 0;
+	guint n_changes = 0;
+	gint64 width;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+
+	g_signal_connect (genicam, "feature-changed", G_CALLBACK (_feature_changed_cb), &n_changes);
+	g_signal_connect (genicam, "feature-changed::PayloadSize", G_CALLBACK (_feature_changed_cb),
+			  &n_payload_size_changes);
+
+	g_assert (arv_gc_watch_feature (genicam, "PayloadSize", NULL));
+	g_assert (!arv_gc_watch_feature (genicam, "NotAFeature", &error));
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8    AcquisitionStart", &error);
-	g_assert (success);
+	width = arv_device_get_integer_feature_value (device, "Width", NULL);
+
+	/* Coalesced until the next main context iteration */
+	arv_device_set_integer_feature_value (device, "Width", width / 2, NULL);
+	arv_device_set_integer_feature_value (device, "Height", 100, NULL);
+	g_assert_cmpint (n_payload_size_changes, ==, 0);
+	while (g_main_context_iteration (NULL, FALSE));
+	g_assert_cmpint (n_payload_size_changes, ==, 1);
+	g_assert_cmpint (n_changes, ==, 1);
+
+	/* Until the end of the transaction */
+	arv_gc_begin_transaction (genicam);
+	arv_device_set_integer_feature_value (device, "Width", width, NULL);
+	while (g_main_context_iteration (NULL, FALSE));
+	g_assert_cmpint (n_payload_size_changes, ==, 1);
+	g_assert (arv_gc_commit_transaction (genicam, NULL));
+	while (g_main_context_iteration (NULL, FALSE));
+	g_assert_cmpint (n_payload_size_changes, ==, 2);
+
+	g_assert (arv_gc_unwatch_feature (genicam, "PayloadSize", NULL));
+	arv_device_set_integer_feature_value (device, "Width", width / 2, NULL);
+	while (g_main_context_iteration (NULL, FALSE));
+	g_assert_cmpint (n_payload_size_changes, ==, 2);
+
+	g_object_unref (device);
+}
+
+static void
+feature_handle_test (void)
+{
+	ArvCamera *camera;
+	ArvFeatureHandle *handle;
+	GError *error = NULL;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	success = arv_device_set_features_from_string (device, NULL, NULL);
-	g_assert (success);
+	handle = arv_camera_get_feature_handle (camera, "Width", &error);
+	g_assert (handle != NULL);
+	g_assert (error == NULL);
+	g_assert_cmpstr (arv_feature_handle_get_name (handle), ==, "Width");
+	g_assert (arv_feature_handle_is_available (handle, NULL));
+
+	arv_feature_handle_set_integer (handle, 256, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_feature_handle_get_integer (handle, NULL), ==, 256);
+	g_assert_cmpint (arv_camera_get_integer (camera, "Width", NULL), ==, 256);
+
+	arv_feature_handle_get_float (handle, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_WRONG_FEATURE);
+	g_clear_error (&error);
+
+	handle = arv_camera_get_feature_handle (camera, "Unknown", &error);
+	g_assert (handle == NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND);
+	g_clear_error (&error);
+
+	/* The convenience API uses the handles resolved at construction */
+	arv_camera_set_exposure_time (camera, 2000.0, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (arv_camera_get_exposure_time (camera, NULL), ==, 2000.0);
+
+	arv_camera_set_gain (camera, 2.0, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (arv_camera_get_gain (camera, NULL), ==, 2.0);
+
+	g_object_unref (camera);
+}
+
+#define CONCURRENT_OPEN_N_THREADS	4
+
+static gpointer
+_concurrent_open_thread (gpointer data)
+{
+	return arv_open_device ("Fake_1", NULL);
+}
+
+/* Parses another Genicam file for the opened device, concurrently with the parsing of the fake camera data */
+
+static gpointer
+_concurrent_open_other_thread (gpointer data)
+{
+	GBytes *other_xml = data;
+	ArvDevice *device;
+	ArvGc *genicam;
+	const void *xml;
+	size_t size;
+
+	device = arv_open_device ("Fake_1", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	xml = g_bytes_get_data (other_xml, &size);
+	genicam = arv_gc_new (device, xml, size);
+	g_assert (ARV_IS_GC (genicam));
+	g_assert (ARV_IS_GC_NODE (arv_gc_get_node (genicam, "RWFloat")));
+	g_assert_null (arv_gc_get_node (genicam, "SensorWidth"));
+	g_object_unref (genicam);
+
+	return device;
+}
+
+static void
+concurrent_open_test (void)
+{
+	GThread *threads[CONCURRENT_OPEN_N_THREADS];
+	ArvDevice *devices[CONCURRENT_OPEN_N_THREADS];
+	GBytes *other_xml;
+	GError *error = NULL;
+	char *xml;
+	size_t size;
+	unsigned int i;
+
+	g_assert (g_file_get_contents (OTHER_GENICAM_FILENAME, &xml, &size, NULL));
+	other_xml = g_bytes_new_take (xml, size);
+
+	/* Half of the threads parse a different Genicam file at the same time */
+	for (i = 0; i < CONCURRENT_OPEN_N_THREADS; i++)
+		threads[i] = g_thread_new ("open", i % 2 == 0 ? _concurrent_open_thread :
+					   _concurrent_open_other_thread, other_xml);
+
+	for (i = 0; i < CONCURRENT_OPEN_N_THREADS; i++) {
+		devices[i] = g_thread_join (threads[i]);
+		g_assert (ARV_IS_FAKE_DEVICE (devices[i]));
+	}
+
+	/* The devices share the parsed genicam data, not the feature state */
+	for (i = 1; i < CONCURRENT_OPEN_N_THREADS; i++) {
+		g_assert (arv_device_get_genicam (devices[i]) != arv_device_get_genicam (devices[0]));
+		arv_device_set_integer_feature_value (devices[i], "Width", 128 + i * 16, &error);
+		g_assert (error == NULL);
+	}
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (devices[0], "Width", NULL), ==,
+			 ARV_FAKE_CAMERA_WIDTH_DEFAULT);
+	for (i = 1; i < CONCURRENT_OPEN_N_THREADS; i++)
+		g_assert_cmpint (arv_device_get_integer_feature_value (devices[i], "Width", NULL), ==, 128 + i * 16);
+
+	for (i = 0; i < CONCURRENT_OPEN_N_THREADS; i++)
+		g_object_unref (devices[i]);
+
+	g_bytes_unref (other_xml);
+}
+
+static void
+_feature_async_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+	GMainLoop *loop = user_data;
+	GError *error = NULL;
+
+	g_assert_true (arv_device_feature_finish (ARV_DEVICE (object), result, &error));
+	g_assert (error == NULL);
+
+	g_main_loop_quit (loop);
+}
+
+static void
+_read_memory_async_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+	GMainLoop *loop = user_data;
+	GError *error = NULL;
+	GBytes *bytes;
+
+	bytes = arv_device_read_memory_finish (ARV_DEVICE (object), result, &error);
+	g_assert (error == NULL);
+	g_assert_nonnull (bytes);
+	g_assert_cmpint (g_bytes_get_size (bytes), ==, 4);
+	g_bytes_unref (bytes);
 
+	g_main_loop_quit (loop);
+}
+
+static void
+async_test (void)
+{
+	ArvDevice *device;
+	GMainLoop *loop;
+
+	device = arv_open_device ("Fake_1", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	loop = g_main_loop_new (NULL, FALSE);
+
+	arv_device_set_integer_feature_value_async (device, "Width", 512, NULL, _feature_async_cb, loop);
+	g_main_loop_run (loop);
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Width", NULL), ==, 512);
+
+	arv_device_read_memory_async (device, ARV_FAKE_CAMERA_REGISTER_WIDTH, 4, NULL, _read_memory_async_cb, loop);
+	g_main_loop_run (loop);
+
+	g_main_loop_unref (loop);
 	g_object_unref (device);
 }
 
+/* Builds an extended id GVSP packet in @buffer, and returns its data area */
+
+static void *
+_set_extended_gvsp_header (void *buffer, ArvGvspContentType content_type, guint64 frame_id, guint32 packet_id)
+{
+	ArvGvspPacket *packet = buffer;
+	ArvGvspExtendedHeader *header = (void *) &packet->header;
+
+	packet->packet_type = 0;
+	header->flags = 0;
+	header->packet_infos = g_htonl (((guint32) ARV_GVSP_PACKET_EXTENDED_ID_MODE_MASK << 24) |
+					((content_type << ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_POS) &
+					 ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_MASK));
+	header->frame_id = GUINT64_TO_BE (frame_id);
+	header->packet_id = g_htonl (packet_id);
+
+	return header->data;
+}
+
+#define GVSP_MULTIPART_TEST_PART_SIZE	512
+#define GVSP_MULTIPART_TEST_BLOCK_SIZE	16
+
+/* Sends a one part frame, with a data block at @offset in the part, and returns the status of the buffer */
+
+static ArvBufferStatus
+_send_multipart_frame (ArvStream *stream, guint64 frame_id, guint64 offset, guint64 time_us)
+{
+	guint8 buffer[256] = {0};
+	ArvGvspMultipartLeader *leader;
+	ArvGvspMultipart *block;
+	ArvGvspDataTrailer *trailer;
+	ArvBuffer *arv_buffer;
+	ArvBufferStatus status;
+	size_t header_size = sizeof (ArvGvspPacket) + sizeof (ArvGvspExtendedHeader);
+
+	leader = _set_extended_gvsp_header (buffer, ARV_GVSP_CONTENT_TYPE_DATA_LEADER, frame_id, 0);
+	leader->payload_type = g_htons (ARV_GVSP_PAYLOAD_TYPE_MULTIPART);
+	leader->parts[0].data_type = g_htons (ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE);
+	leader->parts[0].part_length_low = g_htonl (GVSP_MULTIPART_TEST_PART_SIZE);
+	leader->parts[0].pixel_format = g_htonl (ARV_PIXEL_FORMAT_MONO_8);
+	leader->parts[0].width = g_htonl (32);
+	leader->parts[0].height = g_htonl (GVSP_MULTIPART_TEST_PART_SIZE / 32);
+	arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), buffer,
+					      header_size + sizeof (ArvGvspMultipartLeader) + sizeof (ArvGvspPartInfos),
+					      time_us);
+
+	memset (buffer, 0, sizeof (buffer));
+	block = _set_extended_gvsp_header (buffer, ARV_GVSP_CONTENT_TYPE_DATA_BLOCK, frame_id, 1);
+	block->part_id = 0;
+	block->offset_high = g_htons (offset >> 32);
+	block->offset_low = g_htonl (offset & 0xffffffff);
+	memset (block->data, 0xaa, GVSP_MULTIPART_TEST_BLOCK_SIZE);
+	arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), buffer,
+					      header_size + sizeof (ArvGvspMultipart) + GVSP_MULTIPART_TEST_BLOCK_SIZE,
+					      time_us + 10);
+
+	memset (buffer, 0, sizeof (buffer));
+	trailer = _set_extended_gvsp_header (buffer, ARV_GVSP_CONTENT_TYPE_DATA_TRAILER, frame_id, 2);
+	trailer->payload_type = g_htonl (ARV_GVSP_PAYLOAD_TYPE_MULTIPART);
+	arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), buffer,
+					      header_size + sizeof (ArvGvspDataTrailer), time_us + 20);
+
+	/* Closes the frame if it is still waiting for packets */
+	arv_gv_stream_offline_process_packet (ARV_GV_STREAM (stream), NULL, 0, time_us + 1000000);
+
+	arv_buffer = arv_stream_try_pop_buffer (stream);
+	g_assert (ARV_IS_BUFFER (arv_buffer));
+	status = arv_buffer_get_status (arv_buffer);
+	arv_stream_push_buffer (stream, arv_buffer);
+
+	return status;
+}
+
+static void
+gvsp_multipart_offset_test (void)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+
+	stream = arv_gv_stream_new_offline (1500, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_GV_STREAM (stream));
+
+	arv_stream_push_buffer (stream, arv_buffer_new (GVSP_MULTIPART_TEST_PART_SIZE, NULL));
+
+	/* Offset far past the part and the buffer */
+	g_assert_cmpint (_send_multipart_frame (stream, 1, G_GUINT64_CONSTANT (0x10000000000), 0), ==,
+			 ARV_BUFFER_STATUS_SIZE_MISMATCH);
+
+	/* Block crossing the end of the part */
+	g_assert_cmpint (_send_multipart_frame (stream, 2, GVSP_MULTIPART_TEST_PART_SIZE - GVSP_MULTIPART_TEST_BLOCK_SIZE / 2,
+						2000000), ==, ARV_BUFFER_STATUS_SIZE_MISMATCH);
+
+	g_object_unref (stream);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -746,10 +2742,47 @@ main (int argc, char *argv[])
 	g_test_add_func ("/fake/fake-device", fake_device_test);
 	g_test_add_func ("/fake/fake-device-error", fake_device_error_test);
 	g_test_add_func ("/fake/fake-stream", fake_stream_test);
+	g_test_add_func ("/fake/fake-stream-benchmark", fake_stream_benchmark_test);
+	g_test_add_func ("/fake/output-policy", output_policy_test);
+	g_test_add_func ("/fake/auto-buffers", auto_buffers_test);
+	g_test_add_func ("/fake/ready-fd", ready_fd_test);
+	g_test_add_func ("/fake/ensure-buffers", ensure_buffers_test);
+	g_test_add_func ("/fake/lock-memory", lock_memory_test);
+	g_test_add_func ("/fake/batched-buffers", batched_buffers_test);
+	g_test_add_func ("/fake/frame-batching", frame_batching_test);
+	g_test_add_func ("/fake/stream-stages", stream_stages_test);
+	g_test_add_func ("/fake/host-auto-exposure", host_auto_exposure_test);
+	g_test_add_func ("/fake/openmetrics", openmetrics_test);
+	g_test_add_func ("/fake/frame-bank", frame_bank_test);
+	g_test_add_func ("/fake/stream-group", stream_group_test);
+#ifdef G_OS_UNIX
+	g_test_add_func ("/fake/recorder", recorder_test);
+#endif
+#if ARAVIS_HAS_SHARED_MEMORY
+	g_test_add_func ("/fake/shared-stream", shared_stream_test);
+#endif
 	g_test_add_func ("/fake/camera-api", camera_api_test);
 	g_test_add_func ("/fake/camera-device", camera_device_test);
 	g_test_add_func ("/fake/camera-trigger-selector", camera_trigger_selector_test);
 	g_test_add_func ("/fake/set-features-from-string", set_features_from_string_test);
+	g_test_add_func ("/fake/feature-snapshot", feature_snapshot_test);
+	g_test_add_func ("/fake/read-all", read_all_test);
+	g_test_add_func ("/fake/feature-cache-policy", feature_cache_policy_test);
+	g_test_add_func ("/fake/feature-profile", feature_profile_test);
+#if ARAVIS_HAS_USB
+	g_test_add_func ("/fake/uv-bandwidth-planner", uv_bandwidth_planner_test);
+#endif
+	g_test_add_func ("/fake/struct-entry-coalescing", struct_entry_coalescing_test);
+	g_test_add_func ("/fake/shadow-memory", shadow_memory_test);
+	g_test_add_func ("/fake/lut", lut_test);
+	g_test_add_func ("/fake/swiss-knife-memoization", swiss_knife_memoization_test);
+	g_test_add_func ("/fake/feature-index", feature_index_test);
+	g_test_add_func ("/fake/feature-changed", feature_changed_test);
+	g_test_add_func ("/fake/feature-handle", feature_handle_test);
+	g_test_add_func ("/fake/concurrent-open", concurrent_open_test);
+	g_test_add_func ("/fake/concurrent-string-read", concurrent_string_read_test);
+	g_test_add_func ("/fake/async", async_test);
+	g_test_add_func ("/fake/gvsp-multipart-offset", gvsp_multipart_offset_test);
 
 	result = g_test_run();
 
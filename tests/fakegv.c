@@ -1,7 +1,10 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <arv.h>
+#include <string.h>
 
 static ArvCamera *camera = NULL;
+static ArvGvFakeCamera *simulator = NULL;
 
 static void
 discovery_test (void)
@@ -24,6 +27,52 @@ discovery_test (void)
         g_assert_not_reached ();
 }
 
+static void
+_device_event_cb (ArvGvInterface *gv_interface, const char *device_id, gint *n_events)
+{
+	g_atomic_int_inc (n_events);
+}
+
+static void
+background_discovery_test (void)
+{
+	ArvGvInterface *gv_interface;
+	gint n_added = 0;
+	gint n_removed = 0;
+	gboolean found = FALSE;
+	int n_devices;
+	int i;
+
+	gv_interface = ARV_GV_INTERFACE (arv_gv_interface_get_instance ());
+
+	g_signal_connect (gv_interface, "device-added", G_CALLBACK (_device_event_cb), &n_added);
+	g_signal_connect (gv_interface, "device-removed", G_CALLBACK (_device_event_cb), &n_removed);
+
+	arv_gv_interface_start_discovery (gv_interface, 0);
+	arv_gv_interface_trigger_discovery (gv_interface);
+
+	/* Let the discovery thread time out at least once */
+	g_usleep (1500000);
+
+	arv_update_device_list ();
+
+	n_devices = arv_get_n_devices ();
+	for (i = 0; i < n_devices; i++)
+		if (g_strcmp0 (arv_get_device_id (i), "Aravis-Fake-GVTest") == 0)
+			found = TRUE;
+
+	arv_gv_interface_stop_discovery (gv_interface);
+
+	g_signal_handlers_disconnect_by_func (gv_interface, _device_event_cb, &n_added);
+	g_signal_handlers_disconnect_by_func (gv_interface, _device_event_cb, &n_removed);
+
+	g_assert_true (found);
+
+	/* The simulator was already registered by the initial device list update */
+	g_assert_cmpint (g_atomic_int_get (&n_added), ==, 0);
+	g_assert_cmpint (g_atomic_int_get (&n_removed), ==, 0);
+}
+
 static void
 register_test (void)
 {
@@ -82,6 +131,205 @@ register_test (void)
 	g_assert_cmpint (boolean_value, ==, TRUE);
 	int_value = arv_device_get_integer_feature_value (device, "TestRegister", NULL);
 	g_assert_cmpint (int_value, ==, 321);
+
+	/* The acknowledge timeouts are derived from the measured round trip time */
+	g_assert_cmpuint (arv_device_get_info_uint64_by_name (device, "gvcp_srtt_us"), >, 0);
+}
+
+static void
+registers_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	guint64 addresses[] = {ARV_FAKE_CAMERA_REGISTER_WIDTH, ARV_FAKE_CAMERA_REGISTER_HEIGHT,
+		ARV_FAKE_CAMERA_REGISTER_X_OFFSET, ARV_FAKE_CAMERA_REGISTER_Y_OFFSET};
+	guint32 values[G_N_ELEMENTS (addresses)];
+	guint32 new_values[G_N_ELEMENTS (addresses)] = {512, 256, 8, 16};
+	guint32 value;
+	gboolean success;
+	guint i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	success = arv_device_read_registers (device, G_N_ELEMENTS (addresses), addresses, values, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+
+	for (i = 0; i < G_N_ELEMENTS (addresses); i++) {
+		success = arv_device_read_register (device, addresses[i], &value, &error);
+		g_assert (success);
+		g_assert_no_error (error);
+		g_assert_cmpuint (value, ==, values[i]);
+	}
+
+	success = arv_device_write_registers (device, G_N_ELEMENTS (addresses), addresses, new_values, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+
+	for (i = 0; i < G_N_ELEMENTS (addresses); i++) {
+		success = arv_device_read_register (device, addresses[i], &value, &error);
+		g_assert (success);
+		g_assert_no_error (error);
+		g_assert_cmpuint (value, ==, new_values[i]);
+	}
+
+	success = arv_device_write_registers (device, G_N_ELEMENTS (addresses), addresses, values, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+}
+
+static void
+pipelined_memory_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	char *reference;
+	char *data;
+	size_t size = 4096;
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	reference = g_malloc (size);
+	data = g_malloc0 (size);
+
+	success = arv_device_read_memory (device, 0, size, reference, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+
+	g_object_set (device, "gvcp-window-size", 4, NULL);
+
+	success = arv_device_read_memory (device, 0, size, data, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+	g_assert (memcmp (reference, data, size) == 0);
+
+	g_object_set (device, "gvcp-window-size", 1, NULL);
+
+	g_free (reference);
+	g_free (data);
+}
+
+static void
+monitor_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *monitor;
+	GInetAddress *interface_address;
+	GInetAddress *device_address;
+	GError *error = NULL;
+	guint64 addresses[] = {ARV_FAKE_CAMERA_REGISTER_WIDTH, ARV_FAKE_CAMERA_REGISTER_HEIGHT};
+	guint32 values[G_N_ELEMENTS (addresses)];
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+	g_assert (arv_gv_device_is_controller (ARV_GV_DEVICE (device)));
+
+	interface_address = g_inet_socket_address_get_address
+		(G_INET_SOCKET_ADDRESS (arv_gv_device_get_interface_address (ARV_GV_DEVICE (device))));
+	device_address = g_inet_socket_address_get_address
+		(G_INET_SOCKET_ADDRESS (arv_gv_device_get_device_address (ARV_GV_DEVICE (device))));
+
+	monitor = arv_gv_device_new_monitor (interface_address, device_address, &error);
+	g_assert (ARV_IS_GV_DEVICE (monitor));
+	g_assert_no_error (error);
+
+	g_assert (!arv_gv_device_is_controller (ARV_GV_DEVICE (monitor)));
+	g_assert_cmpint (arv_gc_get_register_cache_policy (arv_device_get_genicam (monitor)), ==,
+			 ARV_REGISTER_CACHE_POLICY_STATIC);
+
+	success = arv_gv_device_take_control (ARV_GV_DEVICE (monitor), &error);
+	g_assert (!success);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONTROLLER);
+	g_clear_error (&error);
+
+	success = arv_device_read_registers (monitor, G_N_ELEMENTS (addresses), addresses, values, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+	g_assert_cmpint (values[0], ==, arv_device_get_integer_feature_value (device, "Width", NULL));
+	g_assert_cmpint (values[1], ==, arv_device_get_integer_feature_value (device, "Height", NULL));
+
+	/* Writable features are not cached, their changes by the controller are seen by the monitor */
+	arv_device_set_integer_feature_value (device, "Width", 256, NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (monitor, "Width", NULL), ==, 256);
+	arv_device_set_integer_feature_value (device, "Width", 512, NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (monitor, "Width", NULL), ==, 512);
+
+	g_object_unref (monitor);
+
+	g_assert (arv_gv_device_is_controller (ARV_GV_DEVICE (device)));
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Width", NULL), ==, 512);
+}
+
+static void
+trusted_loading_test (void)
+{
+	ArvDevice *device;
+	GInetAddress *interface_address;
+	GInetAddress *device_address;
+	GError *error = NULL;
+	const char *name;
+	char *directory;
+	GDir *dir;
+	guint n_xml = 0;
+	guint n_compiled = 0;
+	int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	interface_address = g_inet_socket_address_get_address
+		(G_INET_SOCKET_ADDRESS (arv_gv_device_get_interface_address (ARV_GV_DEVICE (device))));
+	device_address = g_inet_socket_address_get_address
+		(G_INET_SOCKET_ADDRESS (arv_gv_device_get_device_address (ARV_GV_DEVICE (device))));
+
+	directory = g_dir_make_tmp ("arv-trusted-loading-XXXXXX", NULL);
+	g_assert (directory != NULL);
+
+	arv_set_genicam_cache_directory (directory);
+	arv_set_genicam_trusted_loading (TRUE);
+	g_assert (arv_get_genicam_trusted_loading ());
+
+	/* Download, then trusted load of the cached data, then reuse of the trusted compiled document */
+	for (i = 0; i < 3; i++) {
+		ArvDevice *monitor;
+
+		monitor = arv_gv_device_new_monitor (interface_address, device_address, &error);
+		g_assert (ARV_IS_GV_DEVICE (monitor));
+		g_assert_no_error (error);
+
+		g_assert_cmpint (arv_device_get_integer_feature_value (monitor, "Width", NULL), ==,
+				 arv_device_get_integer_feature_value (device, "Width", NULL));
+
+		g_object_unref (monitor);
+	}
+
+	arv_set_genicam_trusted_loading (FALSE);
+	arv_set_genicam_cache_directory (NULL);
+
+	dir = g_dir_open (directory, 0, NULL);
+	g_assert (dir != NULL);
+	while ((name = g_dir_read_name (dir)) != NULL) {
+		char *filename = g_build_filename (directory, name, NULL);
+
+		if (g_str_has_suffix (name, ".xml"))
+			n_xml++;
+		else if (g_str_has_suffix (name, ".arvc"))
+			n_compiled++;
+
+		g_remove (filename);
+		g_free (filename);
+	}
+	g_dir_close (dir);
+	g_rmdir (directory);
+	g_free (directory);
+
+	/* The compiled document is stored under the data checksum, and then under the cache key of the trusted data */
+	g_assert_cmpint (n_xml, ==, 1);
+	g_assert_cmpint (n_compiled, ==, 2);
 }
 
 static void
@@ -112,6 +360,591 @@ acquisition_test (void)
 	g_clear_object (&buffer);
 }
 
+static void
+metadata_test (void)
+{
+	GError *error = NULL;
+	ArvBuffer *buffer;
+	const ArvBufferMetadata *metadata;
+
+	buffer = arv_camera_acquisition (camera, 0, &error);
+	g_assert (error == NULL);
+	g_assert (ARV_IS_BUFFER (buffer));
+
+	metadata = arv_buffer_get_metadata (buffer);
+	g_assert (metadata != NULL);
+	g_assert_cmpuint (metadata->size, ==, sizeof (ArvBufferMetadata));
+	g_assert_cmpint (metadata->status, ==, arv_buffer_get_status (buffer));
+	g_assert_cmpuint (metadata->frame_id, ==, arv_buffer_get_frame_id (buffer));
+	g_assert_cmpuint (metadata->timestamp_ns, ==, arv_buffer_get_timestamp (buffer));
+	g_assert_cmpuint (metadata->system_timestamp_ns, ==, arv_buffer_get_system_timestamp (buffer));
+	g_assert_cmpuint (metadata->n_missing_packets, ==, 0);
+
+	g_assert_cmpuint (metadata->first_packet_time_us, >, 0);
+	g_assert_cmpuint (metadata->last_packet_time_us, >=, metadata->first_packet_time_us);
+	g_assert_cmpuint (metadata->output_time_us, >=, metadata->last_packet_time_us);
+
+	g_clear_object (&buffer);
+}
+
+/* Allocation counting in the stream thread, by interposition of the glibc allocator */
+
+#if defined (__GLIBC__)
+#define HAS_ALLOCATION_COUNT 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static __thread gboolean is_stream_thread = FALSE;
+static gboolean count_allocations = FALSE;
+static gint n_stream_allocations = 0;
+
+void *
+malloc (size_t size)
+{
+	if (is_stream_thread && g_atomic_int_get (&count_allocations))
+		g_atomic_int_inc (&n_stream_allocations);
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	if (is_stream_thread && g_atomic_int_get (&count_allocations))
+		g_atomic_int_inc (&n_stream_allocations);
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	if (is_stream_thread && g_atomic_int_get (&count_allocations))
+		g_atomic_int_inc (&n_stream_allocations);
+	return __libc_realloc (ptr, size);
+}
+
+static void
+allocation_stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+	if (type == ARV_STREAM_CALLBACK_TYPE_INIT)
+		is_stream_thread = TRUE;
+}
+#else
+#define HAS_ALLOCATION_COUNT 0
+#endif
+
+static void
+allocation_test (void)
+{
+#if HAS_ALLOCATION_COUNT
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	guint64 n_resend_requests;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, allocation_stream_cb, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "lock-free-queue-size", 16, NULL);
+	g_object_set (simulator, "gvsp-lost-ratio", 0.01, NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 10; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	/* Warm up, the statistics and the frame bitmaps are allocated with the first frames */
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	n_resend_requests = arv_stream_get_info_uint64_by_name (stream, "n_resend_requests");
+
+	g_atomic_int_set (&n_stream_allocations, 0);
+	g_atomic_int_set (&count_allocations, TRUE);
+
+	for (i = 0; i < 30; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_atomic_int_set (&count_allocations, FALSE);
+
+	/* The lossy link must have triggered some resend requests */
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_resend_requests"), >, n_resend_requests);
+	g_assert_cmpint (g_atomic_int_get (&n_stream_allocations), ==, 0);
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_object_set (simulator, "gvsp-lost-ratio", 0.0, NULL);
+
+	g_clear_object (&stream);
+#else
+	g_test_skip ("Allocation counting not supported");
+#endif
+}
+
+static void
+oversized_buffer_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	/* The packet tracking is sized from the payload, the trailer marking the frame end */
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (4 * payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpuint (arv_buffer_get_image_width (buffer) * arv_buffer_get_image_height (buffer), >, 0);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+chunk_only_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	size_t size;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	/* Only the end of the payloads is kept, the frames being complete */
+	payload = arv_camera_get_payload (camera, NULL);
+	g_assert_cmpuint (payload, >, 4096);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new_chunk_only (payload, 4096));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_buffer_get_data (buffer, &size);
+		g_assert_cmpuint (size, ==, 4096);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+_stalled_cb (ArvGvStream *gv_stream, guint64 last_packet_time_us, guint64 n_kernel_dropped_packets,
+	     gboolean is_controller, gint *n_stalls)
+{
+	g_assert_cmpuint (last_packet_time_us, >, 0);
+	g_assert_true (is_controller);
+
+	g_atomic_int_inc (n_stalls);
+}
+
+static void
+stall_watchdog_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	gint n_stalls = 0;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_GV_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "stall-watchdog", ARV_GV_STREAM_STALL_WATCHDOG_NOTIFY, "stall-frames", 2, NULL);
+	g_signal_connect (stream, "stalled", G_CALLBACK (_stalled_cb), &n_stalls);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 5; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+	g_assert_cmpint (g_atomic_int_get (&n_stalls), ==, 0);
+
+	/* The stream stopped by the device is reported once */
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 100 && g_atomic_int_get (&n_stalls) == 0; i++)
+		g_usleep (20000);
+	g_usleep (200000);
+
+	g_assert_cmpint (g_atomic_int_get (&n_stalls), ==, 1);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_stalls"), ==, 1);
+
+	g_clear_object (&stream);
+}
+
+static void
+armed_stream_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	gint n_input_buffers, n_output_buffers;
+	unsigned i, j;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_stream_arm (stream);
+
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_input_buffers, ==, 5);
+	g_assert_cmpint (n_output_buffers, ==, 0);
+
+	/* The stream stays armed across the acquisition cycles */
+	for (i = 0; i < 3; i++) {
+		arv_camera_start_acquisition (camera, &error);
+		g_assert (error == NULL);
+
+		for (j = 0; j < 2; j++) {
+			buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+			g_assert (ARV_IS_BUFFER (buffer));
+			g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+			arv_stream_push_buffer (stream, buffer);
+		}
+
+		arv_camera_stop_acquisition (camera, &error);
+		g_assert (error == NULL);
+	}
+
+	arv_stream_disarm (stream);
+
+	g_clear_object (&stream);
+}
+
+static void
+reconnect_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gboolean success;
+	size_t payload;
+	unsigned n_completed = 0;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	arv_stream_push_buffer (stream, buffer);
+
+	success = arv_device_reconnect (arv_camera_get_device (camera), &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	/* The frame in progress at the reconnection may be aborted */
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			n_completed++;
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_assert_cmpuint (n_completed, >=, 5);
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+resend_budget_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	guint budget;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "resend-budget", 1, NULL);
+	g_object_get (stream, "resend-budget", &budget, NULL);
+	g_assert_cmpuint (budget, ==, 1);
+
+	g_object_set (simulator, "gvsp-lost-ratio", 0.05, NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	/* One packet per second can't cover the losses */
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_resend_budget_exceeded"), >, 0);
+
+	g_object_set (simulator, "gvsp-lost-ratio", 0.0, NULL);
+	g_object_set (stream, "resend-budget", 0, NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+impairment_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	gint64 start;
+	unsigned i;
+
+	g_object_set (simulator,
+		      "impairment-seed", 1,
+		      "gvcp-latency", 2000,
+		      "gvsp-jitter", 200,
+		      "gvsp-reorder-ratio", 0.01,
+		      "gvsp-duplicate-ratio", 0.01,
+		      NULL);
+
+	start = g_get_monotonic_time ();
+	arv_camera_get_width (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (g_get_monotonic_time () - start, >=, 2000);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_object_set (simulator,
+		      "gvcp-latency", 0,
+		      "gvsp-jitter", 0,
+		      "gvsp-reorder-ratio", 0.0,
+		      "gvsp-duplicate-ratio", 0.0,
+		      NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+valid_ranges_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	const ArvBufferRange *ranges;
+	size_t payload;
+	size_t size;
+	guint n_ranges;
+	guint n_incomplete = 0;
+	unsigned i, j;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
+	g_object_set (simulator, "gvsp-lost-ratio", 0.05, NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		ranges = arv_buffer_get_valid_ranges (buffer, &n_ranges);
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_MISSING_PACKETS && ranges != NULL) {
+			n_incomplete++;
+
+			/* Sorted, disjoint and within the received data */
+			for (j = 0; j < n_ranges; j++) {
+				g_assert_cmpuint (ranges[j].size, >, 0);
+				if (j > 0)
+					g_assert_cmpuint (ranges[j].offset, >, ranges[j - 1].offset + ranges[j - 1].size);
+			}
+			arv_buffer_get_data (buffer, &size);
+			g_assert_cmpuint (ranges[n_ranges - 1].offset + ranges[n_ranges - 1].size, ==, size);
+			g_assert_cmpuint (arv_buffer_get_valid_size (buffer), <, payload);
+		} else if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			g_assert (ranges != NULL);
+			g_assert_cmpuint (n_ranges, ==, 1);
+			g_assert_cmpuint (arv_buffer_get_valid_size (buffer), <=, payload);
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_assert_cmpuint (n_incomplete, >, 0);
+
+	g_object_set (simulator, "gvsp-lost-ratio", 0.0, NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+bandwidth_planner_test (void)
+{
+	ArvBandwidthPlanner *planner;
+	GError *error = NULL;
+	guint64 required_bandwidth;
+
+	planner = arv_bandwidth_planner_new (1000000000);
+	g_assert (ARV_IS_BANDWIDTH_PLANNER (planner));
+
+	g_assert (arv_bandwidth_planner_add_camera (planner, camera, &error));
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_bandwidth_planner_get_packet_delay (planner, camera), ==, 0);
+
+	/* 90% of a link as fast as the camera one, the packets are spread */
+	g_assert (arv_bandwidth_planner_apply (planner, &error));
+	g_assert (error == NULL);
+	required_bandwidth = arv_bandwidth_planner_get_required_bandwidth (planner);
+	g_assert_cmpuint (required_bandwidth, >, 8 * arv_camera_get_payload (camera, NULL));
+	g_assert_cmpint (arv_bandwidth_planner_get_packet_delay (planner, camera), >, 0);
+
+	g_clear_object (&planner);
+
+	planner = arv_bandwidth_planner_new (required_bandwidth / 2);
+	g_assert (arv_bandwidth_planner_add_camera (planner, camera, NULL));
+	g_assert (!arv_bandwidth_planner_apply (planner, &error));
+	g_assert_error (error, ARV_BANDWIDTH_PLANNER_ERROR, ARV_BANDWIDTH_PLANNER_ERROR_OVERSUBSCRIBED);
+	g_clear_error (&error);
+
+	arv_bandwidth_planner_remove_camera (planner, camera);
+	g_assert_cmpint (arv_bandwidth_planner_get_packet_delay (planner, camera), ==, -1);
+
+	g_clear_object (&planner);
+}
+
+static void
+snap_test (void)
+{
+	GError *error = NULL;
+	ArvBuffer *buffer;
+	guint64 time_to_frame_us;
+	guint64 last_frame_id = 0;
+	gboolean success;
+	int i;
+
+	success = arv_camera_start_snap (camera, 3, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	g_assert_cmpstr (arv_camera_get_string (camera, "TriggerMode", NULL), ==, "On");
+
+	for (i = 0; i < 5; i++) {
+		buffer = arv_camera_snap (camera, 1000000, &time_to_frame_us, &error);
+		g_assert (error == NULL);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (arv_buffer_get_image_width (buffer), ==, 1024);
+		g_assert_cmpint (time_to_frame_us, >, 0);
+
+		if (i > 0)
+			g_assert_cmpint (arv_buffer_get_frame_id (buffer), !=, last_frame_id);
+		last_frame_id = arv_buffer_get_frame_id (buffer);
+	}
+
+	arv_camera_stop_snap (camera, &error);
+	g_assert (error == NULL);
+
+	g_assert_cmpstr (arv_camera_get_string (camera, "TriggerMode", NULL), ==, "Off");
+}
+
 static void
 new_buffer_cb (ArvStream *stream, unsigned *buffer_count)
 {
@@ -174,6 +1007,83 @@ stream_test (void)
 	g_usleep (2000000);
 }
 
+static void
+camera_group_test (void)
+{
+	ArvCameraGroup *group;
+	ArvStream *stream;
+	GError *error = NULL;
+	guint64 n_completed_buffers;
+	size_t payload;
+	unsigned i;
+
+	group = arv_camera_group_new (2);
+	g_assert (ARV_IS_CAMERA_GROUP (group));
+
+	g_assert_cmpuint (arv_camera_group_add_camera (group, camera), ==, 0);
+	g_assert_cmpuint (arv_camera_group_add_camera (group, camera), ==, 0);
+	g_assert_cmpuint (arv_camera_group_get_n_cameras (group), ==, 1);
+	g_assert_cmpuint (arv_camera_group_get_n_receive_threads (group), ==, 0);
+
+	stream = arv_camera_group_create_stream (group, 0, NULL, NULL, &error);
+	g_assert (ARV_IS_GV_STREAM (stream));
+	g_assert (error == NULL);
+	g_assert_cmpuint (arv_camera_group_get_n_receive_threads (group), ==, 1);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	g_assert (arv_camera_group_start_acquisition (group, &error));
+	g_assert (error == NULL);
+
+	for (i = 0; i < 5; i++) {
+		ArvBuffer *buffer;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_assert (arv_camera_group_stop_acquisition (group, &error));
+	g_assert (error == NULL);
+
+	arv_camera_group_get_statistics (group, &n_completed_buffers, NULL, NULL);
+	g_assert_cmpuint (n_completed_buffers, >=, 5);
+
+	/* The stream goes back to its own thread */
+	g_clear_object (&group);
+	g_clear_object (&stream);
+}
+
+static void
+stream_channel_test (void)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+	guint channel = G_MAXUINT;
+	gint n_channels;
+
+	n_channels = arv_camera_gv_get_n_stream_channels (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (n_channels, >=, 1);
+
+	stream = arv_camera_gv_create_stream_for_channel (camera, 0, NULL, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_get (stream, "channel", &channel, NULL);
+	g_assert_cmpuint (channel, ==, 0);
+
+	g_clear_object (&stream);
+
+	stream = arv_camera_gv_create_stream_for_channel (camera, n_channels, NULL, NULL, NULL, &error);
+	g_assert (stream == NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL);
+	g_clear_error (&error);
+}
+
 #define N_BUFFERS	5
 
 static struct {
@@ -239,10 +1149,77 @@ dynamic_roi_test (void)
 	g_clear_object (&stream);
 }
 
+static void
+reconfiguration_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	gboolean has_new_geometry = FALSE;
+	unsigned i;
+
+	arv_camera_set_region (camera, 0, 0, 100, 100, &error);
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 3; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert (!arv_buffer_has_new_geometry (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	/* Larger region, the stream thread keeps running */
+	arv_camera_begin_reconfiguration (camera, &error);
+	g_assert (error == NULL);
+	arv_camera_set_region (camera, 0, 0, 300, 200, &error);
+	g_assert (error == NULL);
+	g_assert (arv_camera_end_reconfiguration (camera, stream, &error));
+	g_assert (error == NULL);
+
+	g_assert_cmpuint (arv_camera_get_payload (camera, NULL), >, payload);
+
+	for (i = 0; i < 50 && !has_new_geometry; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS &&
+		    arv_buffer_get_image_width (buffer) == 300) {
+			g_assert_cmpint (arv_buffer_get_image_height (buffer), ==, 200);
+			has_new_geometry = arv_buffer_has_new_geometry (buffer);
+			g_assert (has_new_geometry);
+		}
+		arv_stream_push_buffer (stream, buffer);
+	}
+	g_assert (has_new_geometry);
+
+	/* Only the first image of the new geometry is tagged */
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	g_assert_cmpint (arv_buffer_get_image_width (buffer), ==, 300);
+	g_assert (!arv_buffer_has_new_geometry (buffer));
+	arv_stream_push_buffer (stream, buffer);
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	g_clear_object (&stream);
+}
+
 int
 main (int argc, char *argv[])
 {
-	ArvGvFakeCamera *simulator;
 	int result;
 
 	g_test_init (&argc, &argv, NULL);
@@ -258,10 +1235,30 @@ main (int argc, char *argv[])
 	arv_update_device_list ();
 
 	g_test_add_func ("/fakegv/discovery", discovery_test);
+	g_test_add_func ("/fakegv/background-discovery", background_discovery_test);
 	g_test_add_func ("/fakegv/device_registers", register_test);
+	g_test_add_func ("/fakegv/registers", registers_test);
+	g_test_add_func ("/fakegv/pipelined_memory", pipelined_memory_test);
+	g_test_add_func ("/fakegv/monitor", monitor_test);
+	g_test_add_func ("/fakegv/trusted-loading", trusted_loading_test);
 	g_test_add_func ("/fakegv/acquisition", acquisition_test);
+	g_test_add_func ("/fakegv/metadata", metadata_test);
+	g_test_add_func ("/fakegv/allocation", allocation_test);
+	g_test_add_func ("/fakegv/oversized-buffer", oversized_buffer_test);
+	g_test_add_func ("/fakegv/chunk-only", chunk_only_test);
+	g_test_add_func ("/fakegv/stall-watchdog", stall_watchdog_test);
+	g_test_add_func ("/fakegv/armed-stream", armed_stream_test);
+	g_test_add_func ("/fakegv/reconnect", reconnect_test);
+	g_test_add_func ("/fakegv/resend-budget", resend_budget_test);
+	g_test_add_func ("/fakegv/impairment", impairment_test);
+	g_test_add_func ("/fakegv/valid-ranges", valid_ranges_test);
+	g_test_add_func ("/fakegv/bandwidth-planner", bandwidth_planner_test);
+	g_test_add_func ("/fakegv/snap", snap_test);
 	g_test_add_func ("/fakegv/stream", stream_test);
+	g_test_add_func ("/fakegv/camera-group", camera_group_test);
+	g_test_add_func ("/fakegv/stream-channel", stream_channel_test);
 	g_test_add_func ("/fakegv/dynamic_roi", dynamic_roi_test);
+	g_test_add_func ("/fakegv/reconfiguration", reconfiguration_test);
 
 	result = g_test_run();
 
@@ -267,6 +267,14 @@ indexed_test (void)
 	g_assert (error == NULL);
 	g_assert_cmpint (v_int64, ==, 35128);
 
+	/* The memoized address must follow the index changes */
+	selector = arv_gc_get_node (genicam, "IndexedRegisterIndex1");
+	arv_gc_integer_set_value (ARV_GC_INTEGER (selector), 6, NULL);
+
+	v_int64 = arv_gc_register_get_address (ARV_GC_REGISTER (node), &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (v_int64, ==, 36128);
+
 	g_object_unref (device);
 }
 
@@ -450,6 +458,32 @@ enumeration_test (void)
 	v_int64 = arv_gc_string_get_max_length (ARV_GC_STRING (node), NULL);
 	g_assert_cmpint (v_int64, ==, strlen ("EntryNotImplemented"));
 
+	/* Cached entry availability, dropped on a change of the availability nodes */
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	g_assert_false (arv_gc_enumeration_set_string_value (ARV_GC_ENUMERATION (node), "EntryNotAvailable", &error));
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE);
+	g_clear_error (&error);
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "NotAvailable")), 1, NULL);
+
+	g_assert_true (arv_gc_enumeration_set_string_value (ARV_GC_ENUMERATION (node), "EntryNotAvailable", &error));
+	g_assert_no_error (error);
+	v_string = arv_gc_string_get_value (ARV_GC_STRING (node), NULL);
+	g_assert_cmpstr (v_string, ==, "EntryNotAvailable");
+
+	values = arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), &n_values, NULL);
+	g_assert_cmpint (n_values, ==, 4);
+	g_free (values);
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "NotAvailable")), 0, NULL);
+
+	values = arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), &n_values, NULL);
+	g_assert_cmpint (n_values, ==, 2);
+	g_assert_cmpint (values[0], ==, 0);
+	g_assert_cmpint (values[1], ==, 1);
+	g_free (values);
+
 	g_object_unref (device);
 }
 
@@ -1090,6 +1124,8 @@ chunk_data_test (void)
 	const char *string_value;
 	size_t size;
 	size_t chunk_data_size;
+	ArvChunkValue values[3];
+	gint accessors[3];
 
 	device = arv_fake_device_new ("TEST0", &error);
 	g_assert (ARV_IS_FAKE_DEVICE (device));
@@ -1125,6 +1161,22 @@ chunk_data_test (void)
 	g_assert (chunk_data == NULL);
 	g_assert_cmpint (chunk_data_size, ==, 0);
 
+	arv_buffer_update_chunk_index (buffer);
+
+	chunk_data = arv_buffer_get_chunk_data (buffer, 0x12345678, &chunk_data_size);
+	g_assert (chunk_data != NULL);
+	g_assert_cmpint (chunk_data_size, ==, 8);
+	g_assert_cmpint (chunk_data - data, ==, 1 + 64 + 64 + 8 + 4 * sizeof (ArvChunkInfos));
+
+	chunk_data = arv_buffer_get_chunk_data (buffer, 0x87654321, &chunk_data_size);
+	g_assert (chunk_data != NULL);
+	g_assert_cmpint (chunk_data_size, ==, 64);
+	g_assert_cmpint (chunk_data - data, ==, 1 + 64 + 8 + 3 * sizeof (ArvChunkInfos));
+
+	chunk_data = arv_buffer_get_chunk_data (buffer, 0x01020304, &chunk_data_size);
+	g_assert (chunk_data == NULL);
+	g_assert_cmpint (chunk_data_size, ==, 0);
+
 	int_value = arv_chunk_parser_get_integer_value (parser, buffer, "ChunkInt", &error);
 	g_assert_cmpint (int_value, ==, 0x11223344);
 	g_assert (error == NULL);
@@ -1141,6 +1193,42 @@ chunk_data_test (void)
 	g_assert (boolean_value);
 	g_assert (error == NULL);
 
+	accessors[0] = arv_chunk_parser_get_accessor (parser, "ChunkInt", &error);
+	g_assert_cmpint (accessors[0], >=, 0);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_chunk_parser_get_accessor (parser, "ChunkInt", NULL), ==, accessors[0]);
+
+	accessors[1] = arv_chunk_parser_get_accessor (parser, "ChunkFloat", &error);
+	g_assert_cmpint (accessors[1], >=, 0);
+	g_assert (error == NULL);
+
+	accessors[2] = arv_chunk_parser_get_accessor (parser, "ChunkBoolean", &error);
+	g_assert_cmpint (accessors[2], >=, 0);
+	g_assert (error == NULL);
+
+	g_assert_cmpint (arv_chunk_parser_get_accessor (parser, "ChunkString", &error), ==, -1);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	int_value = arv_chunk_parser_get_integer_value_by_accessor (parser, buffer, accessors[0], &error);
+	g_assert_cmpint (int_value, ==, 0x11223344);
+	g_assert (error == NULL);
+
+	float_value = arv_chunk_parser_get_float_value_by_accessor (parser, buffer, accessors[1], &error);
+	g_assert_cmpfloat (float_value, ==, 1.1);
+	g_assert (error == NULL);
+
+	g_assert (arv_chunk_parser_parse_buffer (parser, buffer, accessors, G_N_ELEMENTS (accessors), values, &error));
+	g_assert (error == NULL);
+	g_assert (values[0].is_valid && values[1].is_valid && values[2].is_valid);
+	g_assert_cmpint (values[0].int_value, ==, 0x11223344);
+	g_assert_cmpfloat (values[1].float_value, ==, 1.1);
+	g_assert_cmpint (values[2].int_value, ==, 1);
+
+	arv_chunk_parser_get_integer_value_by_accessor (parser, buffer, 1000, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
 	arv_chunk_parser_get_integer_value (parser, buffer, "Dummy", &error);
 	g_assert (error != NULL);
 	g_clear_error (&error);
@@ -1341,6 +1429,216 @@ access_mode_test (void)
 	g_object_unref (device);
 }
 
+static void
+lazy_loading_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GError *error = NULL;
+	gint64 *values;
+	guint n_values;
+
+	arv_set_genicam_lazy_loading (TRUE);
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	node = arv_gc_get_node (genicam, "RWInteger");
+	g_assert (ARV_IS_GC_INTEGER_NODE (node));
+	g_assert (arv_gc_get_node (genicam, "RWInteger") == node);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL), ==, 1);
+
+	node = arv_gc_get_node (genicam, "Enumeration");
+	g_assert (ARV_IS_GC_ENUMERATION (node));
+	values = arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), &n_values, NULL);
+	g_assert_cmpint (n_values, ==, 2);
+	g_free (values);
+
+	g_assert (arv_gc_get_node (genicam, "NotAFeature") == NULL);
+
+	g_object_unref (device);
+
+	arv_set_genicam_lazy_loading (FALSE);
+}
+
+#define CONCURRENT_N_THREADS	4
+#define CONCURRENT_N_READS	1000
+
+static gpointer
+_concurrent_read_thread (gpointer data)
+{
+	ArvGc *genicam = data;
+	ArvGcNode *node;
+	int i;
+
+	node = arv_gc_get_node (genicam, "InvalidatedRegister");
+	g_assert (ARV_IS_GC_INTEGER (node));
+
+	for (i = 0; i < CONCURRENT_N_READS; i++) {
+		GError *error = NULL;
+		gint64 value;
+
+		value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &error);
+		g_assert_no_error (error);
+		g_assert_cmpint (value, >=, 0);
+		g_assert_cmpint (value, <, 256);
+	}
+
+	return NULL;
+}
+
+static void
+concurrent_access_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GThread *threads[CONCURRENT_N_THREADS];
+	GError *error = NULL;
+	gint64 value;
+	int i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node = arv_gc_get_node (genicam, "RWRegister");
+	g_assert (ARV_IS_GC_INTEGER (node));
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (node), 0, &error);
+	g_assert_no_error (error);
+
+	for (i = 0; i < CONCURRENT_N_THREADS; i++)
+		threads[i] = g_thread_new ("reader", _concurrent_read_thread, genicam);
+
+	for (i = 0; i < 256; i++) {
+		arv_gc_integer_set_value (ARV_GC_INTEGER (node), i, &error);
+		g_assert_no_error (error);
+	}
+
+	for (i = 0; i < CONCURRENT_N_THREADS; i++)
+		g_thread_join (threads[i]);
+
+	/* The writes to RWRegister must have invalidated the cache of InvalidatedRegister */
+	value = arv_device_get_integer_feature_value (device, "InvalidatedRegister", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 255);
+
+	g_object_unref (device);
+}
+
+static void
+transaction_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	guint32 value;
+	gboolean success;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	arv_device_set_integer_feature_value (device, "RWRegister", 0, &error);
+	g_assert_no_error (error);
+
+	arv_device_begin_transaction (device);
+
+	arv_device_set_integer_feature_value (device, "RWRegister", 0x12, &error);
+	g_assert_no_error (error);
+	arv_device_set_integer_feature_value (device, "RWRegister", 0x34, &error);
+	g_assert_no_error (error);
+
+	/* Not written to the device yet, but visible through the features */
+	success = arv_device_read_memory (device, 0x1100, sizeof (value), &value, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 0);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "RORegister", &error), ==, 0x34);
+	g_assert_no_error (error);
+
+	success = arv_device_commit (device, &error);
+	g_assert (success);
+	g_assert_no_error (error);
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "RORegister", &error), ==, 0x34);
+	g_assert_no_error (error);
+	success = arv_device_read_memory (device, 0x1100, sizeof (value), &value, &error);
+	g_assert (success);
+	g_assert_cmpint (value, !=, 0);
+
+	g_object_unref (device);
+}
+
+static void
+_polled_feature_changed_cb (ArvGc *genicam, const char *feature, guint *n_changes)
+{
+	(*n_changes)++;
+}
+
+static void
+_wait_for_changes (guint *n_changes)
+{
+	gint64 deadline = g_get_monotonic_time () + G_USEC_PER_SEC;
+
+	while (*n_changes == 0 && g_get_monotonic_time () < deadline) {
+		while (g_main_context_iteration (NULL, FALSE));
+		g_usleep (1000);
+	}
+}
+
+static void
+polling_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint n_changes = 0;
+	guint64 value;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC_REGISTER (arv_gc_get_node (genicam, "IntRegisterC")));
+
+	g_signal_connect (genicam, "feature-changed::IntRegisterC", G_CALLBACK (_polled_feature_changed_cb),
+			  &n_changes);
+	g_assert (arv_gc_watch_feature (genicam, "IntRegisterC", NULL));
+
+	g_assert (arv_gc_start_polling (genicam, &error));
+	g_assert_no_error (error);
+
+	/* The first poll has no previous value */
+	_wait_for_changes (&n_changes);
+	g_assert_cmpint (n_changes, >, 0);
+
+	/* Change the register behind the back of the genicam document */
+	while (g_main_context_iteration (NULL, FALSE));
+	n_changes = 0;
+	value = GUINT64_TO_BE (0x1234);
+	g_assert (arv_device_write_memory (device, 0x1000, sizeof (value), &value, NULL));
+	_wait_for_changes (&n_changes);
+	g_assert_cmpint (n_changes, ==, 1);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "IntRegisterC", NULL), ==, 0x1234);
+
+	arv_gc_stop_polling (genicam);
+	arv_gc_stop_polling (genicam);
+
+	g_object_unref (device);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1367,6 +1665,10 @@ main (int argc, char *argv[])
 	g_test_add_func ("/genicam/category", category_test);
 	g_test_add_func ("/genicam/lock", lock_test);
 	g_test_add_func ("/genicam/access-mode", access_mode_test);
+	g_test_add_func ("/genicam/lazy-loading", lazy_loading_test);
+	g_test_add_func ("/genicam/concurrent-access", concurrent_access_test);
+	g_test_add_func ("/genicam/transaction", transaction_test);
+	g_test_add_func ("/genicam/polling", polling_test);
 
 	result = g_test_run();
 
@@ -1,8 +1,20 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <arv.h>
 #include <arvstr.h>
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
 #include "../src/arvmiscprivate.h"
+#include "../src/arvspscqueueprivate.h"
+#include "../src/arvhdrhistogramprivate.h"
+#include "../src/arvratewindowprivate.h"
+#include "../src/arvshadowmemoryprivate.h"
+#include "../src/arvclockmodelprivate.h"
+#include "../src/arvrealtimeprivate.h"
+#include "../src/arvgenicamcacheprivate.h"
+#include "../src/arvgvspprivate.h"
+#include "../src/arvhttpprivate.h"
 
 #if !ARAVIS_CHECK_VERSION (ARAVIS_MAJOR_VERSION, ARAVIS_MINOR_VERSION, ARAVIS_MICRO_VERSION)
 #error
@@ -40,6 +52,56 @@ unaligned_from_le_ptr_test (void)
 	g_assert_cmpuint (v_uint16, ==, 0x5544);
 }
 
+/* Byte by byte reference, from the least significant byte */
+
+static void
+_reference_copy_with_endianness (guint8 *to, size_t to_size, guint to_endianness,
+				 const guint8 *from, size_t from_size, guint from_endianness)
+{
+	size_t i;
+
+	for (i = 0; i < to_size; i++) {
+		guint8 value = 0;
+
+		if (i < from_size)
+			value = from_endianness == G_BIG_ENDIAN ? from[from_size - 1 - i] : from[i];
+
+		if (to_endianness == G_BIG_ENDIAN)
+			to[to_size - 1 - i] = value;
+		else
+			to[i] = value;
+	}
+}
+
+static void
+copy_memory_with_endianness_test (void)
+{
+	guint endiannesses[] = {G_LITTLE_ENDIAN, G_BIG_ENDIAN};
+	guint8 from[40];
+	guint8 to[40];
+	guint8 expected[40];
+	size_t to_size, from_size;
+	int i, j;
+
+	for (i = 0; i < sizeof (from); i++)
+		from[i] = 0x11 * (i + 1);
+
+	for (to_size = 1; to_size < sizeof (to); to_size++)
+		for (from_size = 1; from_size < sizeof (from); from_size++)
+			for (i = 0; i < 2; i++)
+				for (j = 0; j < 2; j++) {
+					memset (to, 0xff, sizeof (to));
+					memset (expected, 0xff, sizeof (expected));
+
+					arv_copy_memory_with_endianness (to, to_size, endiannesses[i],
+									 from, from_size, endiannesses[j]);
+					_reference_copy_with_endianness (expected, to_size, endiannesses[i],
+									 from, from_size, endiannesses[j]);
+
+					g_assert_cmpmem (to, sizeof (to), expected, sizeof (expected));
+				}
+}
+
 #define ILLEGAL_CHARACTERS 	"\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f" \
 				"\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f" \
 				" _-"
@@ -269,6 +331,537 @@ match_test (void)
 	}
 }
 
+#define SPSC_QUEUE_N_ITEMS	100000
+
+static gpointer
+spsc_queue_producer (gpointer data)
+{
+	ArvSpscQueue *queue = data;
+	guintptr i;
+
+	for (i = 1; i <= SPSC_QUEUE_N_ITEMS; i++)
+		while (!arv_spsc_queue_push (queue, GSIZE_TO_POINTER (i)))
+			g_thread_yield ();
+
+	return NULL;
+}
+
+static void
+spsc_queue_test (void)
+{
+	ArvSpscQueue *queue;
+	GThread *thread;
+	gpointer items[6];
+	gpointer popped[6];
+	guintptr i;
+
+	queue = arv_spsc_queue_new (3);
+	g_assert (queue != NULL);
+	g_assert_cmpuint (arv_spsc_queue_get_capacity (queue), ==, 4);
+
+	g_assert (arv_spsc_queue_try_pop (queue) == NULL);
+	g_assert (arv_spsc_queue_timeout_pop (queue, 1000) == NULL);
+
+	for (i = 1; i <= 4; i++)
+		g_assert (arv_spsc_queue_push (queue, GSIZE_TO_POINTER (i)));
+	g_assert (!arv_spsc_queue_push (queue, GSIZE_TO_POINTER (5)));
+	g_assert_cmpuint (arv_spsc_queue_length (queue), ==, 4);
+
+	for (i = 1; i <= 4; i++)
+		g_assert (arv_spsc_queue_try_pop (queue) == GSIZE_TO_POINTER (i));
+	g_assert_cmpuint (arv_spsc_queue_length (queue), ==, 0);
+
+	thread = g_thread_new ("spsc-producer", spsc_queue_producer, queue);
+
+	for (i = 1; i <= SPSC_QUEUE_N_ITEMS; i++)
+		g_assert (arv_spsc_queue_pop (queue) == GSIZE_TO_POINTER (i));
+
+	g_thread_join (thread);
+
+	g_assert (arv_spsc_queue_try_pop (queue) == NULL);
+
+	arv_spsc_queue_free (queue);
+
+	queue = arv_spsc_queue_new (4);
+
+	for (i = 0; i < 6; i++)
+		items[i] = GSIZE_TO_POINTER (i + 1);
+	g_assert_cmpuint (arv_spsc_queue_push_many (queue, items, 6), ==, 4);
+	g_assert_cmpuint (arv_spsc_queue_push_many (queue, items, 1), ==, 0);
+
+	g_assert_cmpuint (arv_spsc_queue_try_pop_many (queue, popped, 3), ==, 3);
+	for (i = 0; i < 3; i++)
+		g_assert (popped[i] == items[i]);
+	g_assert_cmpuint (arv_spsc_queue_push_many (queue, &items[4], 2), ==, 2);
+	g_assert_cmpuint (arv_spsc_queue_try_pop_many (queue, popped, 6), ==, 3);
+	for (i = 0; i < 3; i++)
+		g_assert (popped[i] == items[i + 3]);
+	g_assert_cmpuint (arv_spsc_queue_try_pop_many (queue, popped, 6), ==, 0);
+
+	arv_spsc_queue_free (queue);
+}
+
+static void
+hdr_histogram_test (void)
+{
+	ArvHdrHistogram *histogram;
+	ArvHdrHistogram *snapshot;
+	char *string;
+	guint64 i;
+
+	histogram = arv_hdr_histogram_new (2, 2);
+	g_assert (histogram != NULL);
+
+	g_assert_cmpuint (arv_hdr_histogram_get_n_samples (histogram, 0), ==, 0);
+	g_assert_cmpfloat (arv_hdr_histogram_get_percentile (histogram, 0, 50.0), ==, 0.0);
+
+	arv_hdr_histogram_set_variable_name (histogram, 0, "ramp");
+	g_assert_cmpstr (arv_hdr_histogram_get_variable_name (histogram, 0), ==, "ramp");
+	g_assert_cmpstr (arv_hdr_histogram_get_variable_name (histogram, 1), ==, "var1");
+
+	/* Two writers, merged on read */
+	for (i = 1; i <= 100000; i++)
+		arv_hdr_histogram_fill (histogram, i % 2, 0, i);
+	arv_hdr_histogram_fill (histogram, 0, 1, 12);
+
+	g_assert_cmpuint (arv_hdr_histogram_get_n_samples (histogram, 0), ==, 100000);
+	g_assert_cmpuint (arv_hdr_histogram_get_minimum (histogram, 0), ==, 1);
+	g_assert_cmpuint (arv_hdr_histogram_get_maximum (histogram, 0), ==, 100000);
+	g_assert_cmpfloat_with_epsilon (arv_hdr_histogram_get_mean (histogram, 0), 50000.5, 1e-6);
+	g_assert_cmpfloat_with_epsilon (arv_hdr_histogram_get_percentile (histogram, 0, 50.0), 50000, 50000 * 0.04);
+	g_assert_cmpfloat_with_epsilon (arv_hdr_histogram_get_percentile (histogram, 0, 99.9), 99900, 99900 * 0.04);
+	g_assert_cmpfloat (arv_hdr_histogram_get_percentile (histogram, 0, 100.0), <=, 100000);
+
+	/* Small values are exact */
+	g_assert_cmpfloat (arv_hdr_histogram_get_percentile (histogram, 1, 99.0), ==, 12.0);
+
+	snapshot = arv_hdr_histogram_dup_snapshot (histogram);
+	g_assert_cmpuint (arv_hdr_histogram_get_n_samples (snapshot, 0), ==, 100000);
+	g_assert_cmpfloat (arv_hdr_histogram_get_percentile (snapshot, 0, 99.9), ==,
+			   arv_hdr_histogram_get_percentile (histogram, 0, 99.9));
+	g_assert_cmpstr (arv_hdr_histogram_get_variable_name (snapshot, 0), ==, "ramp");
+
+	string = arv_hdr_histogram_to_string (snapshot);
+	g_assert (string != NULL);
+	g_free (string);
+	arv_hdr_histogram_unref (snapshot);
+
+	arv_hdr_histogram_reset (histogram);
+	g_assert_cmpuint (arv_hdr_histogram_get_n_samples (histogram, 0), ==, 0);
+	g_assert_cmpuint (arv_hdr_histogram_get_maximum (histogram, 0), ==, 0);
+
+	/* Out of range values end in the last bucket */
+	arv_hdr_histogram_fill (histogram, 0, 0, G_MAXUINT64);
+	g_assert_cmpuint (arv_hdr_histogram_get_n_samples (histogram, 0), ==, 1);
+
+	arv_hdr_histogram_unref (histogram);
+}
+
+static void
+rate_window_test (void)
+{
+	ArvRateWindow *window;
+	guint64 counter = 0;
+	guint64 time_us;
+
+	window = arv_rate_window_new (1);
+	g_assert (window != NULL);
+	arv_rate_window_set_counter (window, 0, "frame", &counter);
+	g_assert_cmpstr (arv_rate_window_get_counter_name (window, 0), ==, "frame");
+
+	g_assert_cmpfloat (arv_rate_window_get_rate (window, 0, 1, 0), ==, 0.0);
+
+	/* Steady 10 counts per second, updated more often than sampled */
+	for (time_us = 1000000; time_us <= 121000000; time_us += 100000) {
+		if (time_us % 1000000 == 0 && time_us > 1000000)
+			counter += 10;
+		arv_rate_window_update (window, time_us);
+	}
+
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 1, 121000000), 10.0, 1e-9);
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 10, 121000000), 10.0, 1e-9);
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 60, 121000000), 10.0, 1e-9);
+
+	/* A burst only dominates the short window */
+	counter += 100;
+	arv_rate_window_update (window, 122000000);
+
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 1, 122000000), 100.0, 1e-9);
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 10, 122000000), 19.0, 1e-9);
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 60, 122000000), 11.5, 1e-9);
+
+	/* Without updates, the rates decrease */
+	g_assert_cmpfloat (arv_rate_window_get_rate (window, 0, 1, 130000000), ==, 0.0);
+	g_assert_cmpfloat_with_epsilon (arv_rate_window_get_rate (window, 0, 10, 130000000), 11.0, 1e-9);
+
+	arv_rate_window_unref (window);
+}
+
+static void
+shadow_memory_test (void)
+{
+	ArvShadowMemory *shadow;
+	guint8 data[ARV_SHADOW_MEMORY_PAGE_SIZE + 16];
+	guint8 read[ARV_SHADOW_MEMORY_PAGE_SIZE + 16];
+	guint i;
+
+	for (i = 0; i < sizeof (data); i++)
+		data[i] = i % 251;
+
+	shadow = arv_shadow_memory_new ();
+	g_assert (shadow != NULL);
+
+	g_assert_false (arv_shadow_memory_read (shadow, 0x100, 4, read));
+
+	/* Range crossing a page boundary */
+	arv_shadow_memory_write (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 8, sizeof (data), data);
+	g_assert_cmpuint (arv_shadow_memory_get_n_pages (shadow), ==, 3);
+
+	g_assert_true (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 8, sizeof (read), read));
+	g_assert (memcmp (data, read, sizeof (data)) == 0);
+
+	/* Overlapping sub range */
+	g_assert_true (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 2, 4, read));
+	g_assert (memcmp (data + 6, read, 4) == 0);
+
+	/* Partially valid range */
+	g_assert_false (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 12, 8, read));
+
+	arv_shadow_memory_invalidate (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE, 1);
+	g_assert_false (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 2, 4, read));
+	g_assert_true (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE + 1, 64, read));
+	g_assert (memcmp (data + 9, read, 64) == 0);
+
+	arv_shadow_memory_write (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE, 1, data);
+	g_assert_true (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE - 2, 4, read));
+	g_assert_cmpuint (read[2], ==, data[0]);
+
+	arv_shadow_memory_clear (shadow);
+	g_assert_cmpuint (arv_shadow_memory_get_n_pages (shadow), ==, 0);
+	g_assert_false (arv_shadow_memory_read (shadow, ARV_SHADOW_MEMORY_PAGE_SIZE, 4, read));
+
+	arv_shadow_memory_free (shadow);
+}
+
+#define CLOCK_MODEL_OFFSET_NS	1700000000000000000LL
+#define CLOCK_MODEL_DRIFT_PPM	100
+
+static void
+clock_model_test (void)
+{
+	ArvClockModel *model;
+	guint64 device_ns;
+	gint64 host_ns;
+	guint i;
+
+	model = arv_clock_model_new ();
+	g_assert (model != NULL);
+	g_assert_cmpuint (arv_clock_model_get_n_samples (model), ==, 0);
+	g_assert_cmpuint (arv_clock_model_to_host (model, 1000), ==, 0);
+
+	/* One sample per second, the host clock running 100 ppm faster than the device clock, with a +-10 µs jitter */
+	for (i = 0; i < 20; i++) {
+		device_ns = 5000000000ULL + i * 1000000000ULL;
+		host_ns = CLOCK_MODEL_OFFSET_NS + device_ns + device_ns / 1000000 * CLOCK_MODEL_DRIFT_PPM +
+			((i % 2) == 0 ? 10000 : -10000);
+		g_assert (arv_clock_model_add_sample (model, device_ns, host_ns, 100000));
+	}
+
+	g_assert_cmpuint (arv_clock_model_get_n_samples (model), ==, 16);
+	g_assert_cmpfloat (fabs (arv_clock_model_get_drift (model) - CLOCK_MODEL_DRIFT_PPM), <, 1.0);
+
+	device_ns = 30000000000ULL;
+	host_ns = CLOCK_MODEL_OFFSET_NS + device_ns + device_ns / 1000000 * CLOCK_MODEL_DRIFT_PPM;
+	g_assert_cmpint (llabs ((gint64) arv_clock_model_to_host (model, device_ns) - host_ns), <, 50000);
+
+	/* Samples with a long round trip are not reliable */
+	g_assert (!arv_clock_model_add_sample (model, device_ns, host_ns + 10000000, 1000000));
+
+	/* Device timestamp reset */
+	g_assert (arv_clock_model_add_sample (model, 1000, CLOCK_MODEL_OFFSET_NS, 100000));
+	g_assert_cmpuint (arv_clock_model_get_n_samples (model), ==, 1);
+	g_assert_cmpint (arv_clock_model_to_host (model, 2000), ==, CLOCK_MODEL_OFFSET_NS + 1000);
+
+	arv_clock_model_free (model);
+}
+
+static void
+cpu_list_test (void)
+{
+	GArray *cpus;
+	guint expected[] = {0, 1, 2, 3, 8};
+	guint i;
+
+	cpus = arv_parse_cpu_list ("0-3,8");
+	g_assert (cpus != NULL);
+	g_assert_cmpuint (cpus->len, ==, G_N_ELEMENTS (expected));
+	for (i = 0; i < G_N_ELEMENTS (expected); i++)
+		g_assert_cmpuint (g_array_index (cpus, guint, i), ==, expected[i]);
+	g_array_unref (cpus);
+
+	cpus = arv_parse_cpu_list (" 5 , ,7-7");
+	g_assert (cpus != NULL);
+	g_assert_cmpuint (cpus->len, ==, 2);
+	g_assert_cmpuint (g_array_index (cpus, guint, 0), ==, 5);
+	g_assert_cmpuint (g_array_index (cpus, guint, 1), ==, 7);
+	g_array_unref (cpus);
+
+	g_assert (arv_parse_cpu_list ("3-1") == NULL);
+	g_assert (arv_parse_cpu_list ("a") == NULL);
+	g_assert (arv_parse_cpu_list ("1-") == NULL);
+	g_assert (arv_parse_cpu_list ("100000") == NULL);
+}
+
+static void
+deadline_parameters_test (void)
+{
+	guint64 runtime_ns, deadline_ns, period_ns;
+
+	g_assert (arv_compute_deadline_parameters (100.0, 2000, &runtime_ns, &deadline_ns, &period_ns));
+	g_assert_cmpuint (runtime_ns, ==, 2000000);
+	g_assert_cmpuint (deadline_ns, ==, 10000000);
+	g_assert_cmpuint (period_ns, ==, 10000000);
+
+	/* Minimum runtime of the kernel */
+	g_assert (arv_compute_deadline_parameters (100.0, 0, &runtime_ns, NULL, NULL));
+	g_assert_cmpuint (runtime_ns, ==, 1024);
+
+	/* Budget larger than the frame period */
+	g_assert (!arv_compute_deadline_parameters (1000.0, 2000, NULL, NULL, NULL));
+	g_assert (!arv_compute_deadline_parameters (0.0, 1000, NULL, NULL, NULL));
+}
+
+static void
+memory_copy_test (void)
+{
+	guint8 *from;
+	guint8 *to;
+	size_t offsets[] = {0, 1, 7, 15, 33};
+	size_t sizes[] = {0, 15, 255, 256, 4099, 8164};
+	unsigned int i, j, k;
+	ArvMemoryCopyMode modes[] = {ARV_MEMORY_COPY_MODE_TEMPORAL, ARV_MEMORY_COPY_MODE_NON_TEMPORAL};
+
+	from = g_malloc (16384);
+	to = g_malloc (16384);
+	for (i = 0; i < 16384; i++)
+		from[i] = i * 7 + 3;
+
+	for (i = 0; i < G_N_ELEMENTS (modes); i++)
+		for (j = 0; j < G_N_ELEMENTS (offsets); j++)
+			for (k = 0; k < G_N_ELEMENTS (sizes); k++) {
+				const guint8 *source = from + offsets[(j + k) % G_N_ELEMENTS (offsets)];
+
+				memset (to, 0, 16384);
+				arv_memory_copy (to + offsets[j], source, sizes[k], modes[i]);
+				g_assert (memcmp (to + offsets[j], source, sizes[k]) == 0);
+				g_assert_cmpint (to[offsets[j] + sizes[k]], ==, 0);
+				if (offsets[j] > 0)
+					g_assert_cmpint (to[offsets[j] - 1], ==, 0);
+			}
+
+	g_free (from);
+	g_free (to);
+
+	g_assert (arv_memory_get_last_level_cache_size () > 0);
+	g_assert_cmpint (arv_memory_select_copy_mode (1024, FALSE), ==, ARV_MEMORY_COPY_MODE_TEMPORAL);
+	g_assert_cmpint (arv_memory_select_copy_mode (2 * arv_memory_get_last_level_cache_size (), FALSE), ==,
+			 ARV_MEMORY_COPY_MODE_NON_TEMPORAL);
+	g_assert_cmpint (arv_memory_select_copy_mode (2 * arv_memory_get_last_level_cache_size (), TRUE), ==,
+			 ARV_MEMORY_COPY_MODE_TEMPORAL);
+
+	/* 8164 bytes packets have a 8128 bytes payload, a multiple of 64 */
+	g_assert_cmpuint (arv_gvsp_align_packet_size (8164, 576, 1, 36, 64), ==, 8164);
+	g_assert_cmpuint (arv_gvsp_align_packet_size (9000, 576, 1, 36, 64), ==, 8996);
+	g_assert_cmpuint (arv_gvsp_align_packet_size (9000, 576, 4, 36, 64), ==, 8996);
+	g_assert_cmpuint (arv_gvsp_align_packet_size (1500, 576, 1, 36, 0), ==, 1500);
+	/* No aligned size above the minimum */
+	g_assert_cmpuint (arv_gvsp_align_packet_size (600, 590, 1, 36, 64), ==, 600);
+}
+
+static void
+genicam_cache_test (void)
+{
+	const char *url = "local:camera.xml;10000;200";
+	char *directory;
+	char *filename;
+	char *key;
+	char *other_key;
+	char *xml;
+	char *etag;
+	char *last_modified;
+	gint64 expiration_s;
+	size_t size;
+
+	key = arv_genicam_cache_get_key ("Vendor", "Model", "1.0", url);
+	other_key = arv_genicam_cache_get_key ("Vendor", "Model", "1.0", url);
+	g_assert_cmpstr (key, ==, other_key);
+	g_free (other_key);
+	other_key = arv_genicam_cache_get_key ("Vendor", "Model", "1.1", url);
+	g_assert_cmpstr (key, !=, other_key);
+	g_free (other_key);
+	other_key = arv_genicam_cache_get_key ("VendorM", "odel", "1.0", url);
+	g_assert_cmpstr (key, !=, other_key);
+	g_free (other_key);
+
+	directory = g_dir_make_tmp ("arv-genicam-cache-XXXXXX", NULL);
+	g_assert (directory != NULL);
+
+	arv_set_genicam_cache_directory (directory);
+
+	g_assert (arv_genicam_cache_load (key, &size) == NULL);
+	arv_genicam_cache_store (key, "<RegisterDescription/>", 22);
+	xml = arv_genicam_cache_load (key, &size);
+	g_assert_cmpstr (xml, ==, "<RegisterDescription/>");
+	g_assert_cmpuint (size, ==, 22);
+	g_free (xml);
+
+	g_assert_false (arv_genicam_cache_load_http_validators (key, &etag, &last_modified, &expiration_s));
+	arv_genicam_cache_store_http_validators (key, "\"v1\"", NULL, 1000);
+	g_assert_true (arv_genicam_cache_load_http_validators (key, &etag, &last_modified, &expiration_s));
+	g_assert_cmpstr (etag, ==, "\"v1\"");
+	g_assert_null (last_modified);
+	g_assert_cmpint (expiration_s, ==, 1000);
+	g_free (etag);
+
+	arv_set_genicam_cache_directory (NULL);
+	g_assert (arv_genicam_cache_load (key, &size) == NULL);
+
+	filename = g_strdup_printf ("%s/%s.xml", directory, key);
+	g_remove (filename);
+	g_free (filename);
+	filename = g_strdup_printf ("%s/%s.http", directory, key);
+	g_remove (filename);
+	g_rmdir (directory);
+
+	g_free (filename);
+	g_free (key);
+	g_free (directory);
+}
+
+/* Serves three requests: a relative redirection to genicam/camera.xml, a chunked 200 response, then a 304 if the
+ * entity tag is sent back */
+
+static void *
+http_server_thread (void *data)
+{
+	GSocketListener *listener = data;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		GSocketConnection *connection;
+		GDataInputStream *input;
+		GOutputStream *output;
+		gboolean is_revalidation = FALSE;
+		gboolean is_redirected = FALSE;
+		const char *reply;
+		char *line;
+
+		connection = g_socket_listener_accept (listener, NULL, NULL, NULL);
+		g_assert (connection != NULL);
+
+		input = g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM (connection)));
+		output = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+
+		while ((line = g_data_input_stream_read_line (input, NULL, NULL, NULL)) != NULL) {
+			gboolean is_end = g_strchomp (line)[0] == '\0';
+
+			if (g_str_has_prefix (line, "If-None-Match: \"v1\""))
+				is_revalidation = TRUE;
+			if (g_str_has_prefix (line, "GET /camera.xml "))
+				is_redirected = TRUE;
+			g_free (line);
+			if (is_end)
+				break;
+		}
+
+		if (is_revalidation)
+			reply = "HTTP/1.1 304 Not Modified\r\n"
+				"Cache-Control: max-age=120\r\n"
+				"\r\n";
+		else if (is_redirected)
+			reply = "HTTP/1.1 302 Found\r\n"
+				"Location: genicam/camera.xml\r\n"
+				"\r\n";
+		else
+			reply = "HTTP/1.1 200 OK\r\n"
+				"ETag: \"v1\"\r\n"
+				"Cache-Control: max-age=60\r\n"
+				"Transfer-Encoding: chunked\r\n"
+				"\r\n"
+				"d\r\n<RegisterDesc\r\n"
+				"8;ext=1\r\nription/\r\n"
+				"2\r\n>\n\r\n"
+				"0\r\n"
+				"\r\n";
+
+		g_output_stream_write_all (output, reply, strlen (reply), NULL, NULL, NULL);
+
+		g_object_unref (input);
+		g_object_unref (connection);
+	}
+
+	return NULL;
+}
+
+static void
+http_test (void)
+{
+	GSocketListener *listener;
+	GThread *thread;
+	ArvHttpResponse response;
+	GError *error = NULL;
+	char *url;
+	guint16 port;
+	gboolean success;
+
+	listener = g_socket_listener_new ();
+	port = g_socket_listener_add_any_inet_port (listener, NULL, &error);
+	g_assert_no_error (error);
+
+	url = g_strdup_printf ("http://127.0.0.1:%u/camera.xml", port);
+
+	thread = g_thread_new ("http-server", http_server_thread, listener);
+
+	success = arv_http_get (url, NULL, NULL, 1000, NULL, &response, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	g_assert_cmpuint (response.status, ==, ARV_HTTP_STATUS_OK);
+	g_assert_cmpstr (response.etag, ==, "\"v1\"");
+	g_assert_cmpint (response.max_age_s, ==, 60);
+	g_assert_nonnull (response.body);
+	g_assert_cmpuint (g_bytes_get_size (response.body), ==, 23);
+	g_assert (memcmp (g_bytes_get_data (response.body, NULL), "<RegisterDescription/>", 22) == 0);
+	arv_http_response_clear (&response);
+
+	g_free (url);
+	url = g_strdup_printf ("http://127.0.0.1:%u/genicam/camera.xml", port);
+
+	success = arv_http_get (url, "\"v1\"", NULL, 1000, NULL, &response, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	g_assert_cmpuint (response.status, ==, ARV_HTTP_STATUS_NOT_MODIFIED);
+	g_assert_cmpint (response.max_age_s, ==, 120);
+	g_assert_null (response.body);
+	arv_http_response_clear (&response);
+
+	g_thread_join (thread);
+
+	success = arv_http_get ("local:camera.xml;10000;200", NULL, NULL, 1000, NULL, &response, &error);
+	g_assert_false (success);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
+	g_clear_error (&error);
+
+	success = arv_http_get ("http://127.0.0.1:1/camera.xml", "\"v1\"\r\nHost: other", NULL, 1000, NULL,
+				&response, &error);
+	g_assert_false (success);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
+	g_clear_error (&error);
+
+	g_socket_listener_close (listener);
+	g_object_unref (listener);
+	g_free (url);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -277,6 +870,7 @@ main (int argc, char *argv[])
 	g_test_init (&argc, &argv, NULL);
 
 	g_test_add_func ("/buffer/unaligned-from-le", unaligned_from_le_ptr_test);
+	g_test_add_func ("/misc/copy-memory-with-endianness", copy_memory_with_endianness_test);
 	g_test_add_func ("/str/arv-str-strip", arv_str_strip_test);
 	g_test_add_func ("/str/arv-str-uri", arv_str_uri_test);
 	g_test_add_func ("/str/arv-str-parse-double", arv_str_parse_double_test);
@@ -285,6 +879,16 @@ main (int argc, char *argv[])
 	g_test_add_func ("/gstreamer/caps-string", caps_string_test);
 	g_test_add_func ("/misc/globs", glob_test);
 	g_test_add_func ("/misc/matches", match_test);
+	g_test_add_func ("/misc/spsc-queue", spsc_queue_test);
+	g_test_add_func ("/misc/hdr-histogram", hdr_histogram_test);
+	g_test_add_func ("/misc/rate-window", rate_window_test);
+	g_test_add_func ("/misc/shadow-memory", shadow_memory_test);
+	g_test_add_func ("/misc/clock-model", clock_model_test);
+	g_test_add_func ("/misc/cpu-list", cpu_list_test);
+	g_test_add_func ("/misc/deadline-parameters", deadline_parameters_test);
+	g_test_add_func ("/misc/memory-copy", memory_copy_test);
+	g_test_add_func ("/misc/genicam-cache", genicam_cache_test);
+	g_test_add_func ("/misc/http", http_test);
 
 
 	result = g_test_run();
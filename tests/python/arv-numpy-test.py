@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+
+#  If you have installed aravis in a non standard location, you may need
+#   to make GI_TYPELIB_PATH point to the correct location. For example:
+#
+#   export GI_TYPELIB_PATH=$GI_TYPELIB_PATH:/opt/bin/lib/girepositry-1.0/
+#
+#  You may also have to give the path to libaravis.so, using LD_PRELOAD or
+#  LD_LIBRARY_PATH.
+
+import sys
+import gi
+
+gi.require_version ('Aravis', '0.8')
+
+from gi.repository import Aravis
+
+import arv_numpy
+
+Aravis.enable_interface ("Fake")
+
+try:
+    if len(sys.argv) > 1:
+            camera = Aravis.Camera.new (sys.argv[1])
+    else:
+            camera = Aravis.Camera.new (None)
+except TypeError:
+	print ("No camera found")
+	exit ()
+
+payload = camera.get_payload ()
+
+stream = camera.create_stream (None, None)
+
+for i in range (0, 10):
+	stream.push_buffer (Aravis.Buffer.new_allocate (payload))
+
+camera.start_acquisition ()
+
+for i in range (0, 20):
+	buffer = stream.pop_buffer ()
+	if buffer.get_status () == Aravis.BufferStatus.SUCCESS:
+		image = arv_numpy.buffer_to_array (buffer)
+		print ("Frame %d: %s %s, mean %.2f" % (buffer.get_frame_id (), image.shape, image.dtype, image.mean ()))
+		# The array memory is the buffer memory
+		del image
+	stream.push_buffer (buffer)
+
+camera.stop_acquisition ()
@@ -0,0 +1,45 @@
+#!/usr/bin/env python
+
+#  If you have installed aravis in a non standard location, you may need
+#   to make GI_TYPELIB_PATH point to the correct location. For example:
+#
+#   export GI_TYPELIB_PATH=$GI_TYPELIB_PATH:/opt/bin/lib/girepositry-1.0/
+#
+#  You may also have to give the path to libaravis.so, using LD_PRELOAD or
+#  LD_LIBRARY_PATH.
+
+import asyncio
+
+import gi
+# autopep8: off
+gi.require_version('Aravis', '0.8')
+from gi.repository import Aravis  # noqa: E402
+# autopep8: on
+
+import arv_asyncio  # noqa: E402
+
+Aravis.enable_interface('Fake')
+
+
+async def consume(stream, n_frames):
+    n_received = 0
+    async for buffers in arv_asyncio.buffer_batches(stream, 8):
+        for buffer in buffers:
+            print(f'Frame {buffer.get_frame_id()} {buffer.get_status().value_name}')
+            # Re-enqueue the buffer, its memory was not copied
+            stream.push_buffer(buffer)
+        n_received += len(buffers)
+        if n_received >= n_frames:
+            break
+
+
+cam = Aravis.Camera.new('Fake_1')
+stream = cam.create_stream(None, None)
+
+payload = cam.get_payload()
+for i in range(0, 10):
+    stream.push_buffer(Aravis.Buffer.new_allocate(payload))
+
+cam.start_acquisition()
+asyncio.run(consume(stream, 50))
+cam.stop_acquisition()
@@ -0,0 +1,41 @@
+#  Asyncio consumption of Aravis streams.
+#
+#  The stream thread only signals the readiness file descriptor of the
+#  stream, no Python code is run on the acquisition path. The buffers are
+#  retrieved in batches, the interpreter being involved once per batch
+#  instead of once per frame. The buffers are not copied, and must be pushed
+#  back to the stream once processed.
+#
+#  If you have installed aravis in a non standard location, you may need
+#   to make GI_TYPELIB_PATH point to the correct location. For example:
+#
+#   export GI_TYPELIB_PATH=$GI_TYPELIB_PATH:/opt/bin/lib/girepositry-1.0/
+#
+#  You may also have to give the path to libaravis.so, using LD_PRELOAD or
+#  LD_LIBRARY_PATH.
+
+import asyncio
+
+async def buffer_batches (stream, max_buffers = 16):
+	"""Asynchronously iterates over the output buffers of an Aravis.Stream.
+
+	Each iteration yields a non empty list of at most max_buffers
+	Aravis.Buffer, in frame order."""
+
+	loop = asyncio.get_running_loop ()
+	ready = asyncio.Event ()
+	fd = stream.get_ready_fd ()
+
+	if fd < 0:
+		raise RuntimeError ("Stream readiness file descriptor not available")
+
+	loop.add_reader (fd, ready.set)
+	try:
+		while True:
+			await ready.wait ()
+			ready.clear ()
+			buffers = stream.pop_ready_buffers (max_buffers)
+			if len (buffers) > 0:
+				yield buffers
+	finally:
+		loop.remove_reader (fd)
@@ -0,0 +1,78 @@
+#  Zero-copy numpy views of Aravis buffers.
+#
+#  The array memory is the buffer memory: the array keeps a reference to the
+#  buffer, which must not be pushed back to the stream while the array, or any
+#  view of it, is in use. Use numpy.copy () to keep the image longer.
+#
+#  If you have installed aravis in a non standard location, you may need
+#   to make GI_TYPELIB_PATH point to the correct location. For example:
+#
+#   export GI_TYPELIB_PATH=$GI_TYPELIB_PATH:/opt/bin/lib/girepositry-1.0/
+#
+#  You may also have to give the path to libaravis.so, using LD_PRELOAD or
+#  LD_LIBRARY_PATH.
+
+import gi
+
+gi.require_version ('Aravis', '0.8')
+
+from gi.repository import Aravis
+
+import numpy
+
+_PIXEL_FORMAT_MONO = 0x01000000
+_PIXEL_FORMAT_COLOR = 0x02000000
+
+class _BufferMemory:
+	def __init__ (self, buffer, address, shape, typestr, strides):
+		# Keeps the buffer alive as long as the array
+		self.buffer = buffer
+		self.__array_interface__ = {
+			'version': 3,
+			'data': (address, True),
+			'shape': shape,
+			'typestr': typestr,
+			'strides': strides
+		}
+
+def _layout (pixel_format):
+	bits_per_pixel = (pixel_format >> 16) & 0xff
+	color = (pixel_format & 0xff000000) == _PIXEL_FORMAT_COLOR
+
+	if bits_per_pixel % 8 != 0:
+		raise ValueError ("Packed pixel format 0x%08x has no numpy layout" % pixel_format)
+
+	if not color:
+		if bits_per_pixel in (8, 16, 32):
+			return (), numpy.dtype ('<u%d' % (bits_per_pixel // 8))
+	elif bits_per_pixel in (16, 24, 32):
+		# 8 bit channels, YUV 4:2:2 gives two bytes per pixel
+		return (bits_per_pixel // 8,), numpy.dtype ('u1')
+	elif bits_per_pixel == 48:
+		return (3,), numpy.dtype ('<u2')
+
+	raise ValueError ("Unsupported pixel format 0x%08x" % pixel_format)
+
+def buffer_to_array (buffer):
+	"""Returns a numpy array over the image of an Aravis.Buffer, without copy.
+
+	Monochrome images are (height, width) arrays, color images
+	(height, width, channels) arrays. The line stride of the buffer is
+	preserved, the array may not be contiguous."""
+
+	if buffer.get_status () != Aravis.BufferStatus.SUCCESS:
+		raise ValueError ("Incomplete buffer")
+
+	address, size = buffer.get_data_address ()
+	[x, y, width, height] = buffer.get_image_region ()
+	stride = buffer.get_image_stride ()
+	channels, dtype = _layout (buffer.get_image_pixel_format ())
+
+	pixel_size = dtype.itemsize * (channels[0] if channels else 1)
+	if height > 0 and (height - 1) * stride + width * pixel_size > size:
+		raise ValueError ("Buffer too small for a %dx%d image" % (width, height))
+
+	shape = (height, width) + channels
+	strides = (stride, pixel_size) + ((dtype.itemsize,) if channels else ())
+
+	return numpy.asarray (_BufferMemory (buffer, address, shape, dtype.str, strides))
@@ -28,6 +28,8 @@
 #include <arv.h>
 #include <arvdebugprivate.h>
 #include <arvviewer.h>
+#include <arvviewergl.h>
+#include <arvviewergrid.h>
 #include <math.h>
 #include <memory.h>
 #ifdef GDK_WINDOWING_X11
@@ -220,6 +222,10 @@ struct  _ArvViewer {
 	ArvRegisterCachePolicy register_cache_policy;
 	ArvRangeCheckPolicy range_check_policy;
         ArvUvUsbMode usb_mode;
+	gboolean gl_rendering;
+
+	char **grid_camera_ids;
+	ArvViewerGrid *grid;
 
 	gulong video_window_xid;
 };
@@ -230,7 +236,8 @@ G_DEFINE_TYPE (ArvViewer, arv_viewer, GTK_TYPE_APPLICATION)
 
 typedef enum {
 	ARV_VIEWER_MODE_CAMERA_LIST,
-	ARV_VIEWER_MODE_VIDEO
+	ARV_VIEWER_MODE_VIDEO,
+	ARV_VIEWER_MODE_GRID
 } ArvViewerMode;
 
 static void 	select_mode 	(ArvViewer *viewer, ArvViewerMode mode);
@@ -244,7 +251,8 @@ arv_viewer_set_options (ArvViewer *viewer,
 			guint frame_retention,
 			ArvRegisterCachePolicy register_cache_policy,
 			ArvRangeCheckPolicy range_check_policy,
-                        ArvUvUsbMode usb_mode)
+                        ArvUvUsbMode usb_mode,
+			gboolean gl_rendering)
 {
 	g_return_if_fail (viewer != NULL);
 
@@ -256,6 +264,24 @@ arv_viewer_set_options (ArvViewer *viewer,
 	viewer->register_cache_policy = register_cache_policy;
 	viewer->range_check_policy = range_check_policy;
         viewer->usb_mode = usb_mode;
+	viewer->gl_rendering = gl_rendering;
+}
+
+void
+arv_viewer_set_grid (ArvViewer *viewer, const char * const *camera_ids)
+{
+	g_return_if_fail (viewer != NULL);
+
+	g_strfreev (viewer->grid_camera_ids);
+	viewer->grid_camera_ids = g_strdupv ((char **) camera_ids);
+}
+
+static gboolean
+_use_gl_rendering (ArvViewer *viewer, ArvPixelFormat pixel_format)
+{
+	return viewer->gl_rendering &&
+		arv_viewer_gl_is_available () &&
+		arv_viewer_gl_is_pixel_format_supported (pixel_format);
 }
 
 static double
@@ -1206,6 +1232,27 @@ bus_sync_handler (GstBus *bus, GstMessage *message, gpointer user_data)
 	return GST_BUS_DROP;
 }
 
+static void
+setup_stream (ArvViewer *viewer, ArvStream *stream)
+{
+	if (ARV_IS_GV_STREAM (stream)) {
+		if (viewer->auto_socket_buffer)
+			g_object_set (stream,
+				      "socket-buffer", ARV_GV_STREAM_SOCKET_BUFFER_AUTO,
+				      "socket-buffer-size", 0,
+				      NULL);
+		if (!viewer->packet_resend)
+			g_object_set (stream,
+				      "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER,
+				      NULL);
+		g_object_set (stream,
+			      "initial-packet-timeout", (unsigned) viewer->initial_packet_timeout * 1000,
+			      "packet-timeout", (unsigned) viewer->packet_timeout * 1000,
+			      "frame-retention", (unsigned) viewer->frame_retention * 1000,
+			      NULL);
+	}
+}
+
 static gboolean
 start_video (ArvViewer *viewer)
 {
@@ -1216,6 +1263,7 @@ start_video (ArvViewer *viewer)
 	unsigned i;
 	gint width, height;
 	const char *caps_string;
+	gboolean use_gl;
 
 	if (!ARV_IS_CAMERA (viewer->camera))
 		return FALSE;
@@ -1230,22 +1278,7 @@ start_video (ArvViewer *viewer)
 		return FALSE;
 	}
 
-	if (ARV_IS_GV_STREAM (viewer->stream)) {
-		if (viewer->auto_socket_buffer)
-			g_object_set (viewer->stream,
-				      "socket-buffer", ARV_GV_STREAM_SOCKET_BUFFER_AUTO,
-				      "socket-buffer-size", 0,
-				      NULL);
-		if (!viewer->packet_resend)
-			g_object_set (viewer->stream,
-				      "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER,
-				      NULL);
-		g_object_set (viewer->stream,
-			      "initial-packet-timeout", (unsigned) viewer->initial_packet_timeout * 1000,
-			      "packet-timeout", (unsigned) viewer->packet_timeout * 1000,
-			      "frame-retention", (unsigned) viewer->frame_retention * 1000,
-			      NULL);
-	}
+	setup_stream (viewer, viewer->stream);
 
 	arv_stream_set_emit_signals (viewer->stream, TRUE);
 	payload = arv_camera_get_payload (viewer->camera, NULL);
@@ -1256,7 +1289,10 @@ start_video (ArvViewer *viewer)
 	pixel_format = arv_camera_get_pixel_format (viewer->camera, NULL);
 
 	caps_string = arv_pixel_format_to_gst_caps_string (pixel_format);
-	if (caps_string == NULL) {
+	use_gl = _use_gl_rendering (viewer, pixel_format);
+	if (use_gl) {
+		arv_info_viewer ("OpenGL rendering");
+	} else if (caps_string == NULL) {
 		g_message ("GStreamer cannot understand this camera pixel format: 0x%x!", (int) pixel_format);
 		stop_video (viewer);
 		return FALSE;
@@ -1272,6 +1308,30 @@ start_video (ArvViewer *viewer)
 	viewer->pipeline = gst_pipeline_new ("pipeline");
 
 	viewer->appsrc = gst_element_factory_make ("appsrc", NULL);
+
+	arv_camera_get_region (viewer->camera, NULL, NULL, &width, &height, NULL);
+
+	if (use_gl) {
+		GstElement *gl_bin;
+		GtkWidget *video_widget;
+
+		/* Upload of the raw frames, the conversions being done in shaders, and rendering at display rate */
+		gl_bin = arv_viewer_gl_create_bin (pixel_format, width, height, &viewer->transform);
+		viewer->videosink = gst_element_factory_make ("gtkglsink", NULL);
+		gst_bin_add_many (GST_BIN (viewer->pipeline), viewer->appsrc, gl_bin, viewer->videosink, NULL);
+		gst_element_link_many (viewer->appsrc, gl_bin, viewer->videosink, NULL);
+
+		g_object_get (viewer->videosink, "widget", &video_widget, NULL);
+		gtk_container_add (GTK_CONTAINER (viewer->video_frame), video_widget);
+		gtk_widget_show (video_widget);
+		g_object_set(G_OBJECT (video_widget), "force-aspect-ratio", TRUE, NULL);
+		gtk_widget_set_size_request (video_widget, 640, 480);
+		g_object_unref (video_widget);
+
+		caps = arv_viewer_gl_create_source_caps (pixel_format, width, height);
+		goto pipeline_ready;
+	}
+
 	videoconvert = gst_element_factory_make ("videoconvert", NULL);
 	viewer->transform = gst_element_factory_make ("videoflip", NULL);
 
@@ -1325,21 +1385,22 @@ start_video (ArvViewer *viewer)
 		gst_element_link_many (viewer->transform, viewer->videosink, NULL);
 	}
 
-	g_object_set(G_OBJECT (viewer->videosink), "sync", FALSE, NULL);
-
 	caps = gst_caps_from_string (caps_string);
-	arv_camera_get_region (viewer->camera, NULL, NULL, &width, &height, NULL);
 	gst_caps_set_simple (caps,
 			     "width", G_TYPE_INT, width,
 			     "height", G_TYPE_INT, height,
 			     "framerate", GST_TYPE_FRACTION, 0, 1,
 			     NULL);
+
+pipeline_ready:
+	g_object_set(G_OBJECT (viewer->videosink), "sync", FALSE, NULL);
+
 	gst_app_src_set_caps (GST_APP_SRC (viewer->appsrc), caps);
 	gst_caps_unref (caps);
 
 	g_object_set(G_OBJECT (viewer->appsrc), "format", GST_FORMAT_TIME, "is-live", TRUE, "do-timestamp", TRUE, NULL);
 
-	if (!has_gtkglsink && !has_gtksink) {
+	if (!use_gl && !has_gtkglsink && !has_gtksink) {
 		GstBus *bus;
 
 		bus = gst_pipeline_get_bus (GST_PIPELINE (viewer->pipeline));
@@ -1400,6 +1461,18 @@ set_sensitive (GtkCellLayout *cell_layout,
         g_object_set(cell, "sensitive", valid, NULL);
 }
 
+static void
+setup_camera (ArvViewer *viewer, ArvCamera *camera)
+{
+	arv_device_set_register_cache_policy (arv_camera_get_device (camera),
+					      viewer->register_cache_policy);
+	arv_device_set_range_check_policy (arv_camera_get_device (camera),
+					   viewer->range_check_policy);
+
+        if (arv_camera_is_uv_device (camera))
+                arv_camera_uv_set_usb_mode (camera, viewer->usb_mode);
+}
+
 static gboolean
 start_camera (ArvViewer *viewer, const char *camera_id)
 {
@@ -1421,13 +1494,7 @@ start_camera (ArvViewer *viewer, const char *camera_id)
 	if (!ARV_IS_CAMERA (viewer->camera))
 		return FALSE;
 
-	arv_device_set_register_cache_policy (arv_camera_get_device (viewer->camera),
-					      viewer->register_cache_policy);
-	arv_device_set_range_check_policy (arv_camera_get_device (viewer->camera),
-					   viewer->range_check_policy);
-
-        if (arv_camera_is_uv_device (viewer->camera))
-                arv_camera_uv_set_usb_mode (viewer->camera, viewer->usb_mode);
+	setup_camera (viewer, viewer->camera);
 
 	viewer->camera_name = g_strdup (camera_id);
 
@@ -1452,7 +1519,13 @@ start_camera (ArvViewer *viewer, const char *camera_id)
 
                 gtk_list_store_append (list_store, &iter);
 
-                if (caps_string != NULL && g_str_has_prefix (caps_string, "video/x-bayer") && !has_bayer2rgb) {
+                if (_use_gl_rendering (viewer, pixel_formats[i])) {
+			if (current_format < 0 ||
+                            g_strcmp0 (pixel_format_strings[i], pixel_format_string) == 0)
+                                current_format = i;
+			n_valid_formats++;
+                        valid = TRUE;
+                } else if (caps_string != NULL && g_str_has_prefix (caps_string, "video/x-bayer") && !has_bayer2rgb) {
                         bayer_tooltip = TRUE;
                 } else if (caps_string != NULL) {
 			if (current_format < 0 ||
@@ -1510,6 +1583,86 @@ camera_selection_changed_cb (GtkTreeSelection *selection, ArvViewer *viewer)
 		stop_camera (viewer);
 }
 
+static void
+stop_grid (ArvViewer *viewer)
+{
+	if (viewer->grid == NULL)
+		return;
+
+	gtk_container_remove (GTK_CONTAINER (viewer->main_stack), arv_viewer_grid_get_widget (viewer->grid));
+	g_clear_pointer (&viewer->grid, arv_viewer_grid_free);
+}
+
+static gboolean
+start_grid (ArvViewer *viewer)
+{
+	g_auto (GStrv) camera_ids = NULL;
+	GtkWidget *widget;
+	guint i, n_cameras;
+
+	stop_grid (viewer);
+
+	if (viewer->grid_camera_ids == NULL)
+		return FALSE;
+
+	if (!arv_viewer_grid_is_available ()) {
+		g_message ("Grid view requires the GStreamer OpenGL plugins");
+		return FALSE;
+	}
+
+	if (g_strv_length (viewer->grid_camera_ids) == 1 &&
+	    g_strcmp0 (viewer->grid_camera_ids[0], "all") == 0) {
+		arv_update_device_list ();
+		n_cameras = arv_get_n_devices ();
+		camera_ids = g_new0 (char *, n_cameras + 1);
+		for (i = 0; i < n_cameras; i++)
+			camera_ids[i] = g_strdup (arv_get_device_id (i));
+	} else {
+		camera_ids = g_strdupv (viewer->grid_camera_ids);
+		n_cameras = g_strv_length (camera_ids);
+	}
+
+	if (n_cameras == 0)
+		return FALSE;
+
+	viewer->grid = arv_viewer_grid_new (n_cameras);
+
+	for (i = 0; i < n_cameras; i++) {
+		g_autoptr (ArvCamera) camera = NULL;
+		g_autoptr (ArvStream) stream = NULL;
+		g_autoptr (GError) error = NULL;
+
+		camera = arv_camera_new (camera_ids[i], &error);
+		if (ARV_IS_CAMERA (camera)) {
+			setup_camera (viewer, camera);
+			arv_camera_set_chunk_mode (camera, FALSE, NULL);
+			stream = arv_camera_create_stream (camera, stream_cb, NULL, &error);
+		}
+		if (!ARV_IS_STREAM (stream)) {
+			arv_warning_viewer ("Can't open '%s' in grid view: %s", camera_ids[i],
+					    error != NULL ? error->message : "unknown error");
+			continue;
+		}
+
+		setup_stream (viewer, stream);
+		arv_viewer_grid_add_camera (viewer->grid, camera_ids[i], camera, stream);
+	}
+
+	if (arv_viewer_grid_get_n_cameras (viewer->grid) == 0) {
+		g_clear_pointer (&viewer->grid, arv_viewer_grid_free);
+		return FALSE;
+	}
+
+	widget = arv_viewer_grid_get_widget (viewer->grid);
+	gtk_stack_add_named (GTK_STACK (viewer->main_stack), widget, "grid");
+	gtk_widget_show (widget);
+	gtk_stack_set_visible_child (GTK_STACK (viewer->main_stack), widget);
+
+	arv_viewer_grid_start (viewer->grid);
+
+	return TRUE;
+}
+
 static void
 select_mode (ArvViewer *viewer, ArvViewerMode mode)
 {
@@ -1517,9 +1670,15 @@ select_mode (ArvViewer *viewer, ArvViewerMode mode)
 	char *subtitle;
 	gint width, height, x, y;
 
-	if (!ARV_IS_CAMERA (viewer->camera))
+	if (mode == ARV_VIEWER_MODE_VIDEO && !ARV_IS_CAMERA (viewer->camera))
 		mode = ARV_VIEWER_MODE_CAMERA_LIST;
 
+	if (mode == ARV_VIEWER_MODE_GRID) {
+		stop_camera (viewer);
+		if (!start_grid (viewer))
+			mode = ARV_VIEWER_MODE_CAMERA_LIST;
+	}
+
 	switch (mode) {
 		case ARV_VIEWER_MODE_CAMERA_LIST:
 			video_visibility = FALSE;
@@ -1527,6 +1686,14 @@ select_mode (ArvViewer *viewer, ArvViewerMode mode)
 			gtk_header_bar_set_title (GTK_HEADER_BAR (viewer->main_headerbar), "Aravis Viewer");
 			gtk_header_bar_set_subtitle (GTK_HEADER_BAR (viewer->main_headerbar), NULL);
 			stop_video (viewer);
+			stop_grid (viewer);
+			break;
+		case ARV_VIEWER_MODE_GRID:
+			video_visibility = FALSE;
+			subtitle = g_strdup_printf ("%u cameras", arv_viewer_grid_get_n_cameras (viewer->grid));
+			gtk_header_bar_set_title (GTK_HEADER_BAR (viewer->main_headerbar), "Aravis Viewer");
+			gtk_header_bar_set_subtitle (GTK_HEADER_BAR (viewer->main_headerbar), subtitle);
+			g_free (subtitle);
 			break;
 		case ARV_VIEWER_MODE_VIDEO:
 			video_visibility = TRUE;
@@ -1547,7 +1714,7 @@ select_mode (ArvViewer *viewer, ArvViewerMode mode)
 			break;
 	}
 
-	gtk_widget_set_visible (viewer->back_button, video_visibility);
+	gtk_widget_set_visible (viewer->back_button, video_visibility || mode == ARV_VIEWER_MODE_GRID);
 	gtk_widget_set_visible (viewer->rotate_cw_button, video_visibility);
 	gtk_widget_set_visible (viewer->flip_vertical_toggle, video_visibility);
 	gtk_widget_set_visible (viewer->flip_horizontal_toggle, video_visibility);
@@ -1571,6 +1738,7 @@ switch_to_video_mode_cb (GtkToolButton *button, ArvViewer *viewer)
 static void
 arv_viewer_quit_cb (GtkApplicationWindow *window, ArvViewer *viewer)
 {
+	stop_grid (viewer);
 	stop_camera (viewer);
 	g_application_quit (G_APPLICATION (viewer));
 }
@@ -1708,6 +1876,9 @@ activate (GApplication *application)
 	gtk_widget_set_sensitive (viewer->camera_parameters, FALSE);
 	select_mode (viewer, ARV_VIEWER_MODE_CAMERA_LIST);
 	update_device_list_cb (GTK_TOOL_BUTTON (viewer->refresh_button), viewer);
+
+	if (viewer->grid_camera_ids != NULL)
+		select_mode (viewer, ARV_VIEWER_MODE_GRID);
 }
 
 static void
@@ -1729,6 +1900,10 @@ viewer_shutdown (GApplication *application)
 static void
 finalize (GObject *object)
 {
+	ArvViewer *viewer = (ArvViewer *) object;
+
+	g_strfreev (viewer->grid_camera_ids);
+
 	G_OBJECT_CLASS (arv_viewer_parent_class)->finalize (object);
 }
 
@@ -39,6 +39,8 @@ void			arv_viewer_set_options		(ArvViewer *viewer,
 							 guint frame_retention,
 							 ArvRegisterCachePolicy register_cache_policy,
 							 ArvRangeCheckPolicy range_check_policy,
-                                                         ArvUvUsbMode usb_mode);
+                                                         ArvUvUsbMode usb_mode,
+							 gboolean gl_rendering);
+void			arv_viewer_set_grid		(ArvViewer *viewer, const char * const *camera_ids);
 
 G_END_DECLS
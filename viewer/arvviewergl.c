@@ -0,0 +1,321 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * OpenGL rendering path of the viewer.
+ *
+ * The raw mono and bayer frames are uploaded untouched, declared as RGBA textures of a quarter of the row stride, and
+ * a fragment shader does the pixel unpacking, the bit depth scaling and the demosaicing. The other formats are
+ * uploaded with their own caps, and converted by glcolorconvert, which also uses shaders. A leaky queue in front of
+ * the upload keeps only the latest frame, the sink drawing it at the display rate.
+ */
+
+#include <arvviewergl.h>
+#include <arvdebugprivate.h>
+
+typedef struct {
+	ArvPixelFormat pixel_format;
+	guint bytes_per_pixel;
+	guint depth;
+	gboolean is_bayer;
+	guint red_x;
+	guint red_y;
+} ArvViewerGlFormat;
+
+static const ArvViewerGlFormat gl_formats[] = {
+	{ ARV_PIXEL_FORMAT_MONO_8,	1,	8,	FALSE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_MONO_10,	2,	10,	FALSE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_MONO_12,	2,	12,	FALSE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_MONO_14,	2,	14,	FALSE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_MONO_16,	2,	16,	FALSE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_RG_8,	1,	8,	TRUE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GR_8,	1,	8,	TRUE,	1, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GB_8,	1,	8,	TRUE,	0, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_BG_8,	1,	8,	TRUE,	1, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_RG_10,	2,	10,	TRUE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GR_10,	2,	10,	TRUE,	1, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GB_10,	2,	10,	TRUE,	0, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_BG_10,	2,	10,	TRUE,	1, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_RG_12,	2,	12,	TRUE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GR_12,	2,	12,	TRUE,	1, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GB_12,	2,	12,	TRUE,	0, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_BG_12,	2,	12,	TRUE,	1, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_RG_16,	2,	16,	TRUE,	0, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GR_16,	2,	16,	TRUE,	1, 0 },
+	{ ARV_PIXEL_FORMAT_BAYER_GB_16,	2,	16,	TRUE,	0, 1 },
+	{ ARV_PIXEL_FORMAT_BAYER_BG_16,	2,	16,	TRUE,	1, 1 }
+};
+
+/* Each texel holds 4 bytes of a row, that is 4 8 bit pixels, or 2 little endian 16 bit pixels. The bilinear
+ * demosaicing expects the red pixel at (red_x, red_y) modulo 2. */
+
+static const char *fragment_shader =
+	"#version 100\n"
+	"#ifdef GL_ES\n"
+	"#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+	"precision highp float;\n"
+	"#else\n"
+	"precision mediump float;\n"
+	"#endif\n"
+	"#endif\n"
+	"varying vec2 v_texcoord;\n"
+	"uniform sampler2D tex;\n"
+	"uniform float image_width;\n"
+	"uniform float image_height;\n"
+	"uniform float texture_width;\n"
+	"uniform float bytes_per_pixel;\n"
+	"uniform float scale;\n"
+	"uniform float is_bayer;\n"
+	"uniform float red_x;\n"
+	"uniform float red_y;\n"
+	"\n"
+	"float fetch (vec2 p)\n"
+	"{\n"
+	"	vec2 q = clamp (p, vec2 (0.0), vec2 (image_width - 1.0, image_height - 1.0));\n"
+	"	float pixels_per_texel = 4.0 / bytes_per_pixel;\n"
+	"	float texel = floor (q.x / pixels_per_texel);\n"
+	"	float index = q.x - texel * pixels_per_texel;\n"
+	"	vec4 t = texture2D (tex, vec2 ((texel + 0.5) / texture_width, (q.y + 0.5) / image_height));\n"
+	"	if (bytes_per_pixel < 1.5)\n"
+	"		return dot (t, vec4 (equal (vec4 (index), vec4 (0.0, 1.0, 2.0, 3.0)))) * scale;\n"
+	"	vec2 bytes = index < 0.5 ? t.rg : t.ba;\n"
+	"	return (bytes.x * 255.0 + bytes.y * 65280.0) / 65535.0 * scale;\n"
+	"}\n"
+	"\n"
+	"void main ()\n"
+	"{\n"
+	"	vec2 p = floor (v_texcoord * vec2 (image_width, image_height));\n"
+	"	float c = fetch (p);\n"
+	"	if (is_bayer < 0.5) {\n"
+	"		gl_FragColor = vec4 (vec3 (clamp (c, 0.0, 1.0)), 1.0);\n"
+	"		return;\n"
+	"	}\n"
+	"	float left = fetch (p + vec2 (-1.0, 0.0));\n"
+	"	float right = fetch (p + vec2 (1.0, 0.0));\n"
+	"	float up = fetch (p + vec2 (0.0, -1.0));\n"
+	"	float down = fetch (p + vec2 (0.0, 1.0));\n"
+	"	float diagonal = 0.25 * (fetch (p + vec2 (-1.0, -1.0)) + fetch (p + vec2 (1.0, -1.0)) +\n"
+	"				 fetch (p + vec2 (-1.0, 1.0)) + fetch (p + vec2 (1.0, 1.0)));\n"
+	"	float orthogonal = 0.25 * (left + right + up + down);\n"
+	"	vec2 parity = mod (p + vec2 (red_x, red_y), 2.0);\n"
+	"	vec3 rgb;\n"
+	"	if (parity.x < 0.5 && parity.y < 0.5)\n"
+	"		rgb = vec3 (c, orthogonal, diagonal);\n"
+	"	else if (parity.x > 0.5 && parity.y > 0.5)\n"
+	"		rgb = vec3 (diagonal, orthogonal, c);\n"
+	"	else if (parity.y < 0.5)\n"
+	"		rgb = vec3 (0.5 * (left + right), c, 0.5 * (up + down));\n"
+	"	else\n"
+	"		rgb = vec3 (0.5 * (up + down), c, 0.5 * (left + right));\n"
+	"	gl_FragColor = vec4 (clamp (rgb, 0.0, 1.0), 1.0);\n"
+	"}\n";
+
+static const ArvViewerGlFormat *
+_find_format (ArvPixelFormat pixel_format)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (gl_formats); i++)
+		if (gl_formats[i].pixel_format == pixel_format)
+			return &gl_formats[i];
+
+	return NULL;
+}
+
+/* Same padding as the one applied to the buffers pushed in the pipeline */
+
+static gint
+_get_texture_width (const ArvViewerGlFormat *format, gint width)
+{
+	gint row_stride = width * format->bytes_per_pixel;
+
+	if ((row_stride & 0x3) != 0)
+		row_stride = (row_stride & ~(0x3)) + 4;
+
+	return row_stride / 4;
+}
+
+gboolean
+arv_viewer_gl_is_available (void)
+{
+	static gsize check_done = 0;
+	static gboolean is_available = FALSE;
+
+	if (g_once_init_enter (&check_done)) {
+		static const char *elements[] = {
+			"glupload",
+			"glcolorconvert",
+			"glshader",
+			"glvideoflip",
+			"gtkglsink"
+		};
+		GstRegistry *registry = gst_registry_get ();
+		gboolean success = TRUE;
+		unsigned int i;
+
+		for (i = 0; i < G_N_ELEMENTS (elements); i++) {
+			GstPluginFeature *feature;
+
+			feature = gst_registry_lookup_feature (registry, elements[i]);
+			if (GST_IS_PLUGIN_FEATURE (feature))
+				g_object_unref (feature);
+			else {
+				arv_info_viewer ("[Viewer::gl] GStreamer element '%s' is missing", elements[i]);
+				success = FALSE;
+			}
+		}
+
+		is_available = success;
+
+		g_once_init_leave (&check_done, 1);
+	}
+
+	return is_available;
+}
+
+gboolean
+arv_viewer_gl_is_pixel_format_supported (ArvPixelFormat pixel_format)
+{
+	return _find_format (pixel_format) != NULL ||
+		arv_pixel_format_to_gst_caps_string (pixel_format) != NULL;
+}
+
+GstCaps *
+arv_viewer_gl_create_source_caps (ArvPixelFormat pixel_format, gint width, gint height)
+{
+	const ArvViewerGlFormat *format;
+	GstCaps *caps;
+
+	format = _find_format (pixel_format);
+	if (format != NULL) {
+		caps = gst_caps_new_simple ("video/x-raw",
+					    "format", G_TYPE_STRING, "RGBA",
+					    "width", G_TYPE_INT, _get_texture_width (format, width),
+					    "height", G_TYPE_INT, height,
+					    "framerate", GST_TYPE_FRACTION, 0, 1,
+					    NULL);
+	} else {
+		const char *caps_string;
+
+		caps_string = arv_pixel_format_to_gst_caps_string (pixel_format);
+		if (caps_string == NULL || g_str_has_prefix (caps_string, "video/x-bayer"))
+			return NULL;
+
+		caps = gst_caps_from_string (caps_string);
+		gst_caps_set_simple (caps,
+				     "width", G_TYPE_INT, width,
+				     "height", G_TYPE_INT, height,
+				     "framerate", GST_TYPE_FRACTION, 0, 1,
+				     NULL);
+	}
+
+	return caps;
+}
+
+/* Returns a bin with a sink and a source pad, going from the caps returned by arv_viewer_gl_create_source_caps to
+ * RGBA textures of the image size. */
+
+GstElement *
+arv_viewer_gl_create_bin (ArvPixelFormat pixel_format, gint width, gint height, GstElement **transform)
+{
+	const ArvViewerGlFormat *format;
+	GstElement *bin;
+	GstElement *queue;
+	GstElement *glupload;
+	GstElement *glvideoflip;
+	GstPad *pad;
+
+	g_return_val_if_fail (arv_viewer_gl_is_available (), NULL);
+
+	format = _find_format (pixel_format);
+
+	bin = gst_bin_new (NULL);
+
+	queue = gst_element_factory_make ("queue", NULL);
+	g_object_set (queue,
+		      "leaky", 2 /* downstream */,
+		      "max-size-buffers", 1,
+		      "max-size-bytes", 0,
+		      "max-size-time", (guint64) 0,
+		      NULL);
+	glupload = gst_element_factory_make ("glupload", NULL);
+	glvideoflip = gst_element_factory_make ("glvideoflip", NULL);
+
+	gst_bin_add_many (GST_BIN (bin), queue, glupload, glvideoflip, NULL);
+
+	if (format != NULL) {
+		GstElement *glshader;
+		GstElement *capsfilter;
+		GstStructure *uniforms;
+		GstCaps *caps;
+
+		uniforms = gst_structure_new ("uniforms",
+					      "image_width", G_TYPE_FLOAT, (float) width,
+					      "image_height", G_TYPE_FLOAT, (float) height,
+					      "texture_width", G_TYPE_FLOAT, (float) _get_texture_width (format, width),
+					      "bytes_per_pixel", G_TYPE_FLOAT, (float) format->bytes_per_pixel,
+					      "scale", G_TYPE_FLOAT,
+					      (float) ((1 << (8 * format->bytes_per_pixel)) - 1) /
+					      (float) ((1 << format->depth) - 1),
+					      "is_bayer", G_TYPE_FLOAT, format->is_bayer ? 1.0f : 0.0f,
+					      "red_x", G_TYPE_FLOAT, (float) format->red_x,
+					      "red_y", G_TYPE_FLOAT, (float) format->red_y,
+					      NULL);
+
+		glshader = gst_element_factory_make ("glshader", NULL);
+		g_object_set (glshader, "fragment", fragment_shader, "uniforms", uniforms, NULL);
+		gst_structure_free (uniforms);
+
+		/* The shader output has the size of the image, not the one of the packed texture */
+		capsfilter = gst_element_factory_make ("capsfilter", NULL);
+		caps = gst_caps_from_string ("video/x-raw(memory:GLMemory), format=(string)RGBA");
+		gst_caps_set_simple (caps, "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, NULL);
+		g_object_set (capsfilter, "caps", caps, NULL);
+		gst_caps_unref (caps);
+
+		gst_bin_add_many (GST_BIN (bin), glshader, capsfilter, NULL);
+		gst_element_link_many (queue, glupload, glshader, capsfilter, glvideoflip, NULL);
+
+		arv_info_viewer ("[Viewer::gl] Shader rendering of %s",
+				 arv_pixel_format_to_gst_caps_string (pixel_format) != NULL ?
+				 arv_pixel_format_to_gst_caps_string (pixel_format) : "raw data");
+	} else {
+		GstElement *glcolorconvert;
+
+		glcolorconvert = gst_element_factory_make ("glcolorconvert", NULL);
+		gst_bin_add (GST_BIN (bin), glcolorconvert);
+		gst_element_link_many (queue, glupload, glcolorconvert, glvideoflip, NULL);
+	}
+
+	pad = gst_element_get_static_pad (queue, "sink");
+	gst_element_add_pad (bin, gst_ghost_pad_new ("sink", pad));
+	gst_object_unref (pad);
+
+	pad = gst_element_get_static_pad (glvideoflip, "src");
+	gst_element_add_pad (bin, gst_ghost_pad_new ("src", pad));
+	gst_object_unref (pad);
+
+	if (transform != NULL)
+		*transform = glvideoflip;
+
+	return bin;
+}
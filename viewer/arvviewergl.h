@@ -0,0 +1,39 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_VIEWER_GL_H
+#define ARV_VIEWER_GL_H
+
+#include <gst/gst.h>
+#include <arv.h>
+
+G_BEGIN_DECLS
+
+gboolean	arv_viewer_gl_is_available		(void);
+gboolean	arv_viewer_gl_is_pixel_format_supported	(ArvPixelFormat pixel_format);
+GstCaps *	arv_viewer_gl_create_source_caps	(ArvPixelFormat pixel_format, gint width, gint height);
+GstElement *	arv_viewer_gl_create_bin		(ArvPixelFormat pixel_format, gint width, gint height,
+							 GstElement **transform);
+
+G_END_DECLS
+
+#endif
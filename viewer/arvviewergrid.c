@@ -0,0 +1,610 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+/*
+ * Multi-camera grid view.
+ *
+ * Each camera stream has a preview stage, decimating the frames to the tile size. All the tiles go through the
+ * OpenGL upload and shader bins of arvviewergl.c, and are composed by a single glvideomixer in front of a gtkglsink,
+ * so that every conversion and the composition happen in the GL context of the sink. The previews are pulled from a
+ * tick callback of the sink widget, that is at the display rate, and never queued. A click on a tile switches it to the
+ * full resolution buffers, filling the whole view, and a second click goes back to the grid.
+ */
+
+#include <arvviewergrid.h>
+#include <arvviewergl.h>
+#include <arvdebugprivate.h>
+#include <gst/app/gstappsrc.h>
+#include <memory.h>
+#include <math.h>
+
+#define ARV_VIEWER_GRID_N_BUFFERS	10
+
+typedef struct {
+	ArvViewerGrid *grid;
+	char *name;
+	ArvCamera *camera;
+	ArvStream *stream;
+
+	/* Tile branch, rebuilt on image format changes */
+	GstElement *appsrc;
+	GstElement *bin;
+	GstPad *mixer_pad;
+	ArvPixelFormat pixel_format;
+	gint width;
+	gint height;
+
+	/* Latest full resolution buffer, only kept when the tile is selected */
+	GMutex mutex;
+	ArvBuffer *full_buffer;
+	gint is_full_resolution;
+} ArvViewerGridTile;
+
+struct _ArvViewerGrid {
+	GPtrArray *tiles;
+
+	guint n_columns;
+	guint n_rows;
+	gint output_width;
+	gint output_height;
+	gint selected;
+
+	GstElement *pipeline;
+	GstElement *mixer;
+	GstElement *videosink;
+	GtkWidget *widget;
+	guint tick_id;
+};
+
+gboolean
+arv_viewer_grid_is_available (void)
+{
+	GstPluginFeature *feature;
+
+	if (!arv_viewer_gl_is_available ())
+		return FALSE;
+
+	feature = gst_registry_lookup_feature (gst_registry_get (), "glvideomixer");
+	if (!GST_IS_PLUGIN_FEATURE (feature)) {
+		arv_info_viewer ("[Viewer::grid] GStreamer element 'glvideomixer' is missing");
+		return FALSE;
+	}
+	g_object_unref (feature);
+
+	return TRUE;
+}
+
+typedef struct {
+	GWeakRef stream;
+	ArvBuffer *arv_buffer;
+	void *data;
+} ArvViewerGridReleaseData;
+
+/* Preview buffers go back to their pool on their last unref, full resolution ones to their stream */
+
+static void
+_release_buffer_cb (void *user_data)
+{
+	ArvViewerGridReleaseData *release_data = user_data;
+	ArvStream *stream;
+
+	g_free (release_data->data);
+
+	stream = g_weak_ref_get (&release_data->stream);
+	if (stream != NULL) {
+		arv_stream_push_buffer (stream, release_data->arv_buffer);
+		g_object_unref (stream);
+	} else
+		g_object_unref (release_data->arv_buffer);
+
+	g_weak_ref_clear (&release_data->stream);
+	g_free (release_data);
+}
+
+static GstBuffer *
+_wrap_buffer (ArvBuffer *arv_buffer, ArvStream *stream)
+{
+	ArvViewerGridReleaseData *release_data;
+	const char *buffer_data;
+	size_t buffer_size;
+	size_t size;
+	size_t arv_row_stride;
+	gint width, height;
+	void *data;
+
+	buffer_data = arv_buffer_get_data (arv_buffer, &buffer_size);
+	arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
+	arv_row_stride = (size_t) width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
+
+	release_data = g_new0 (ArvViewerGridReleaseData, 1);
+	g_weak_ref_init (&release_data->stream, stream);
+	release_data->arv_buffer = arv_buffer;
+
+	/* Same row padding as the single camera view, decimated widths being often odd */
+	if ((arv_row_stride & 0x3) != 0) {
+		size_t gst_row_stride = (arv_row_stride & ~(0x3)) + 4;
+		gint i;
+
+		size = height * gst_row_stride;
+		data = g_malloc (size);
+		for (i = 0; i < height; i++)
+			memcpy (((char *) data) + i * gst_row_stride, buffer_data + i * arv_row_stride, arv_row_stride);
+
+		release_data->data = data;
+	} else {
+		/* The pool buffers of the previews may be larger than the image */
+		data = (void *) buffer_data;
+		size = MIN (buffer_size, height * arv_row_stride);
+	}
+
+	return gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, data, size, 0, size,
+					    release_data, _release_buffer_cb);
+}
+
+static void
+_fit (gint width, gint height, gint x, gint y, gint cell_width, gint cell_height,
+      gint *fit_x, gint *fit_y, gint *fit_width, gint *fit_height)
+{
+	if (width < 1 || height < 1) {
+		*fit_x = x;
+		*fit_y = y;
+		*fit_width = cell_width;
+		*fit_height = cell_height;
+		return;
+	}
+
+	if ((gint64) cell_width * height > (gint64) cell_height * width) {
+		*fit_height = cell_height;
+		*fit_width = (gint64) cell_height * width / height;
+	} else {
+		*fit_width = cell_width;
+		*fit_height = (gint64) cell_width * height / width;
+	}
+
+	*fit_x = x + (cell_width - *fit_width) / 2;
+	*fit_y = y + (cell_height - *fit_height) / 2;
+}
+
+static void
+_update_layout (ArvViewerGrid *grid)
+{
+	guint i;
+
+	for (i = 0; i < grid->tiles->len; i++) {
+		ArvViewerGridTile *tile = g_ptr_array_index (grid->tiles, i);
+		gint x, y, width, height;
+
+		if (tile->mixer_pad == NULL)
+			continue;
+
+		if (grid->selected >= 0) {
+			_fit (tile->width, tile->height, 0, 0, grid->output_width, grid->output_height,
+			      &x, &y, &width, &height);
+		} else {
+			_fit (tile->width, tile->height,
+			      (i % grid->n_columns) * ARV_VIEWER_GRID_TILE_WIDTH,
+			      (i / grid->n_columns) * ARV_VIEWER_GRID_TILE_HEIGHT,
+			      ARV_VIEWER_GRID_TILE_WIDTH, ARV_VIEWER_GRID_TILE_HEIGHT,
+			      &x, &y, &width, &height);
+		}
+
+		g_object_set (tile->mixer_pad,
+			      "xpos", x, "ypos", y,
+			      "width", width, "height", height,
+			      "alpha", grid->selected < 0 || grid->selected == (gint) i ? 1.0 : 0.0,
+			      NULL);
+	}
+}
+
+static void
+_tile_remove_branch (ArvViewerGridTile *tile)
+{
+	ArvViewerGrid *grid = tile->grid;
+
+	if (tile->bin == NULL)
+		return;
+
+	gst_element_set_state (tile->appsrc, GST_STATE_NULL);
+	gst_element_set_state (tile->bin, GST_STATE_NULL);
+	gst_element_unlink (tile->bin, grid->mixer);
+	gst_bin_remove_many (GST_BIN (grid->pipeline), tile->appsrc, tile->bin, NULL);
+
+	gst_element_release_request_pad (grid->mixer, tile->mixer_pad);
+	gst_object_unref (tile->mixer_pad);
+
+	tile->appsrc = NULL;
+	tile->bin = NULL;
+	tile->mixer_pad = NULL;
+}
+
+/* Called from the widget tick, when the first buffer of a tile is received, or when its format changed after the
+ * switch between preview and full resolution. */
+
+static gboolean
+_tile_build_branch (ArvViewerGridTile *tile, ArvPixelFormat pixel_format, gint width, gint height)
+{
+	ArvViewerGrid *grid = tile->grid;
+	GstPadTemplate *template;
+	GstPad *pad;
+	GstCaps *caps;
+
+	_tile_remove_branch (tile);
+
+	tile->pixel_format = pixel_format;
+	tile->width = width;
+	tile->height = height;
+
+	caps = arv_viewer_gl_create_source_caps (pixel_format, width, height);
+	if (caps == NULL) {
+		arv_warning_viewer ("[Viewer::grid] Unsupported pixel format 0x%08x for '%s'",
+				    pixel_format, tile->name);
+		return FALSE;
+	}
+
+	tile->appsrc = gst_element_factory_make ("appsrc", NULL);
+	gst_app_src_set_caps (GST_APP_SRC (tile->appsrc), caps);
+	gst_caps_unref (caps);
+	g_object_set (tile->appsrc, "format", GST_FORMAT_TIME, "is-live", TRUE, "do-timestamp", TRUE, NULL);
+
+	tile->bin = arv_viewer_gl_create_bin (pixel_format, width, height, NULL);
+
+	template = gst_element_get_pad_template (grid->mixer, "sink_%u");
+	tile->mixer_pad = gst_element_request_pad (grid->mixer, template, NULL, NULL);
+
+	gst_bin_add_many (GST_BIN (grid->pipeline), tile->appsrc, tile->bin, NULL);
+	gst_element_link (tile->appsrc, tile->bin);
+	pad = gst_element_get_static_pad (tile->bin, "src");
+	gst_pad_link (pad, tile->mixer_pad);
+	gst_object_unref (pad);
+
+	gst_element_sync_state_with_parent (tile->bin);
+	gst_element_sync_state_with_parent (tile->appsrc);
+
+	_update_layout (grid);
+
+	arv_info_viewer ("[Viewer::grid] '%s' tile: %dx%d %s", tile->name, width, height,
+			 arv_pixel_format_to_gst_caps_string (pixel_format) != NULL ?
+			 arv_pixel_format_to_gst_caps_string (pixel_format) : "raw data");
+
+	return TRUE;
+}
+
+static void
+_tile_push_buffer (ArvViewerGridTile *tile, ArvBuffer *buffer, ArvStream *stream)
+{
+	ArvPixelFormat pixel_format;
+	gint width, height;
+
+	pixel_format = arv_buffer_get_image_pixel_format (buffer);
+	arv_buffer_get_image_region (buffer, NULL, NULL, &width, &height);
+
+	if ((tile->bin == NULL ||
+	     pixel_format != tile->pixel_format ||
+	     width != tile->width ||
+	     height != tile->height) &&
+	    !_tile_build_branch (tile, pixel_format, width, height)) {
+		if (stream != NULL)
+			arv_stream_push_buffer (stream, buffer);
+		else
+			g_object_unref (buffer);
+		return;
+	}
+
+	gst_app_src_push_buffer (GST_APP_SRC (tile->appsrc), _wrap_buffer (buffer, stream));
+}
+
+static gboolean
+_tick_cb (GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+	ArvViewerGrid *grid = user_data;
+	guint i;
+
+	for (i = 0; i < grid->tiles->len; i++) {
+		ArvViewerGridTile *tile = g_ptr_array_index (grid->tiles, i);
+		ArvBuffer *buffer;
+
+		if (g_atomic_int_get (&tile->is_full_resolution)) {
+			g_mutex_lock (&tile->mutex);
+			buffer = tile->full_buffer;
+			tile->full_buffer = NULL;
+			g_mutex_unlock (&tile->mutex);
+
+			if (buffer != NULL)
+				_tile_push_buffer (tile, buffer, tile->stream);
+		} else {
+			buffer = arv_stream_timeout_pop_preview_buffer (tile->stream, 0);
+			if (buffer != NULL)
+				_tile_push_buffer (tile, buffer, NULL);
+		}
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+/* Stream thread. The full resolution buffers are returned right away, unless the tile is selected, in which case only
+ * the latest one is kept for the next display tick. */
+
+static void
+_new_buffer_cb (ArvStream *stream, ArvViewerGridTile *tile)
+{
+	ArvBuffer *buffer;
+
+	buffer = arv_stream_try_pop_buffer (stream);
+	if (buffer == NULL)
+		return;
+
+	if (!g_atomic_int_get (&tile->is_full_resolution) ||
+	    arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS) {
+		arv_stream_push_buffer (stream, buffer);
+		return;
+	}
+
+	g_mutex_lock (&tile->mutex);
+	g_swap_pointers ((gpointer *) &tile->full_buffer, (gpointer *) &buffer);
+	g_mutex_unlock (&tile->mutex);
+
+	if (buffer != NULL)
+		arv_stream_push_buffer (stream, buffer);
+}
+
+static void
+_tile_set_full_resolution (ArvViewerGridTile *tile, gboolean full_resolution)
+{
+	ArvBuffer *buffer;
+
+	g_atomic_int_set (&tile->is_full_resolution, full_resolution);
+
+	if (full_resolution)
+		return;
+
+	g_mutex_lock (&tile->mutex);
+	buffer = tile->full_buffer;
+	tile->full_buffer = NULL;
+	g_mutex_unlock (&tile->mutex);
+
+	if (buffer != NULL)
+		arv_stream_push_buffer (tile->stream, buffer);
+}
+
+static gboolean
+_button_press_cb (GtkWidget *widget, GdkEventButton *event, ArvViewerGrid *grid)
+{
+	ArvViewerGridTile *tile;
+	gint x, y, width, height;
+	gint column, row;
+	guint index;
+
+	if (event->type != GDK_BUTTON_PRESS || event->button != 1)
+		return FALSE;
+
+	if (grid->selected >= 0) {
+		tile = g_ptr_array_index (grid->tiles, grid->selected);
+		arv_info_viewer ("[Viewer::grid] '%s' back to preview", tile->name);
+		_tile_set_full_resolution (tile, FALSE);
+		grid->selected = -1;
+		_update_layout (grid);
+		return TRUE;
+	}
+
+	/* The sink keeps the aspect ratio of the composition */
+	_fit (grid->output_width, grid->output_height,
+	      0, 0, gtk_widget_get_allocated_width (widget), gtk_widget_get_allocated_height (widget),
+	      &x, &y, &width, &height);
+	if (width < 1 || height < 1 ||
+	    event->x < x || event->x >= x + width ||
+	    event->y < y || event->y >= y + height)
+		return FALSE;
+
+	column = (event->x - x) * grid->n_columns / width;
+	row = (event->y - y) * grid->n_rows / height;
+	index = row * grid->n_columns + column;
+	if (index >= grid->tiles->len)
+		return FALSE;
+
+	tile = g_ptr_array_index (grid->tiles, index);
+	arv_info_viewer ("[Viewer::grid] '%s' at full resolution", tile->name);
+	grid->selected = index;
+	_tile_set_full_resolution (tile, TRUE);
+	_update_layout (grid);
+
+	return TRUE;
+}
+
+static void
+_tile_free (ArvViewerGridTile *tile)
+{
+	if (ARV_IS_STREAM (tile->stream)) {
+		arv_stream_set_emit_signals (tile->stream, FALSE);
+		g_signal_handlers_disconnect_by_data (tile->stream, tile);
+	}
+
+	if (ARV_IS_CAMERA (tile->camera))
+		arv_camera_stop_acquisition (tile->camera, NULL);
+
+	g_clear_object (&tile->full_buffer);
+	g_clear_object (&tile->stream);
+	g_clear_object (&tile->camera);
+	g_mutex_clear (&tile->mutex);
+	g_free (tile->name);
+	g_free (tile);
+}
+
+ArvViewerGrid *
+arv_viewer_grid_new (guint n_cameras)
+{
+	ArvViewerGrid *grid;
+	GstElement *capsfilter;
+	GstCaps *caps;
+
+	g_return_val_if_fail (n_cameras > 0, NULL);
+
+	if (!arv_viewer_grid_is_available ())
+		return NULL;
+
+	grid = g_new0 (ArvViewerGrid, 1);
+	grid->tiles = g_ptr_array_new_with_free_func ((GDestroyNotify) _tile_free);
+	grid->selected = -1;
+
+	grid->n_columns = ceil (sqrt (n_cameras));
+	grid->n_rows = (n_cameras + grid->n_columns - 1) / grid->n_columns;
+	grid->output_width = grid->n_columns * ARV_VIEWER_GRID_TILE_WIDTH;
+	grid->output_height = grid->n_rows * ARV_VIEWER_GRID_TILE_HEIGHT;
+
+	grid->pipeline = gst_pipeline_new ("grid");
+	grid->mixer = gst_element_factory_make ("glvideomixer", NULL);
+	g_object_set (grid->mixer, "background", 1 /* black */, NULL);
+	capsfilter = gst_element_factory_make ("capsfilter", NULL);
+	caps = gst_caps_from_string ("video/x-raw(memory:GLMemory), format=(string)RGBA");
+	gst_caps_set_simple (caps,
+			     "width", G_TYPE_INT, grid->output_width,
+			     "height", G_TYPE_INT, grid->output_height,
+			     NULL);
+	g_object_set (capsfilter, "caps", caps, NULL);
+	gst_caps_unref (caps);
+	grid->videosink = gst_element_factory_make ("gtkglsink", NULL);
+	g_object_set (grid->videosink, "sync", FALSE, NULL);
+
+	gst_bin_add_many (GST_BIN (grid->pipeline), grid->mixer, capsfilter, grid->videosink, NULL);
+	gst_element_link_many (grid->mixer, capsfilter, grid->videosink, NULL);
+
+	g_object_get (grid->videosink, "widget", &grid->widget, NULL);
+	g_object_set (grid->widget, "force-aspect-ratio", TRUE, NULL);
+	gtk_widget_set_size_request (grid->widget, 640, 480);
+	gtk_widget_add_events (grid->widget, GDK_BUTTON_PRESS_MASK);
+	g_signal_connect (grid->widget, "button-press-event", G_CALLBACK (_button_press_cb), grid);
+
+	return grid;
+}
+
+/* Takes a reference on @camera and @stream. The stream is expected to be configured, without buffers. */
+
+gboolean
+arv_viewer_grid_add_camera (ArvViewerGrid *grid, const char *name, ArvCamera *camera, ArvStream *stream)
+{
+	ArvViewerGridTile *tile;
+	ArvPixelFormat pixel_format;
+	GError *error = NULL;
+	gint width, height;
+	guint factor;
+	size_t payload = 0;
+	unsigned int i;
+
+	g_return_val_if_fail (grid != NULL, FALSE);
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	if (grid->tiles->len >= grid->n_columns * grid->n_rows)
+		return FALSE;
+
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	if (error == NULL)
+		arv_camera_get_region (camera, NULL, NULL, &width, &height, &error);
+	if (error == NULL)
+		payload = arv_camera_get_payload (camera, &error);
+	if (error != NULL) {
+		arv_warning_viewer ("[Viewer::grid] Can't setup '%s': %s", name, error->message);
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	/* Smallest decimation fitting the tile, the bayer images staying raw for the demosaicing shader */
+	factor = MAX (1, MAX ((width + ARV_VIEWER_GRID_TILE_WIDTH - 1) / ARV_VIEWER_GRID_TILE_WIDTH,
+			      (height + ARV_VIEWER_GRID_TILE_HEIGHT - 1) / ARV_VIEWER_GRID_TILE_HEIGHT));
+	if (!arv_viewer_gl_is_pixel_format_supported (pixel_format)) {
+		arv_warning_viewer ("[Viewer::grid] Unsupported pixel format 0x%08x for '%s'", pixel_format, name);
+		return FALSE;
+	}
+
+	tile = g_new0 (ArvViewerGridTile, 1);
+	tile->grid = grid;
+	tile->name = g_strdup (name);
+	tile->camera = g_object_ref (camera);
+	tile->stream = g_object_ref (stream);
+	g_mutex_init (&tile->mutex);
+
+	arv_stream_add_preview_stage (stream, factor, FALSE, ARV_VIEWER_GRID_PREVIEW_FRAME_RATE);
+	for (i = 0; i < ARV_VIEWER_GRID_N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+	g_signal_connect (stream, "new-buffer", G_CALLBACK (_new_buffer_cb), tile);
+	arv_stream_set_emit_signals (stream, TRUE);
+
+	g_ptr_array_add (grid->tiles, tile);
+
+	arv_info_viewer ("[Viewer::grid] '%s' %dx%d, preview decimation by %u", name, width, height, factor);
+
+	return TRUE;
+}
+
+void
+arv_viewer_grid_start (ArvViewerGrid *grid)
+{
+	guint i;
+
+	g_return_if_fail (grid != NULL);
+
+	for (i = 0; i < grid->tiles->len; i++) {
+		ArvViewerGridTile *tile = g_ptr_array_index (grid->tiles, i);
+
+		arv_camera_set_acquisition_mode (tile->camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+		arv_camera_start_acquisition (tile->camera, NULL);
+	}
+
+	gst_element_set_state (grid->pipeline, GST_STATE_PLAYING);
+
+	if (grid->tick_id == 0)
+		grid->tick_id = gtk_widget_add_tick_callback (grid->widget, _tick_cb, grid, NULL);
+}
+
+GtkWidget *
+arv_viewer_grid_get_widget (ArvViewerGrid *grid)
+{
+	g_return_val_if_fail (grid != NULL, NULL);
+
+	return grid->widget;
+}
+
+guint
+arv_viewer_grid_get_n_cameras (ArvViewerGrid *grid)
+{
+	g_return_val_if_fail (grid != NULL, 0);
+
+	return grid->tiles->len;
+}
+
+void
+arv_viewer_grid_free (ArvViewerGrid *grid)
+{
+	if (grid == NULL)
+		return;
+
+	if (grid->tick_id > 0)
+		gtk_widget_remove_tick_callback (grid->widget, grid->tick_id);
+	g_signal_handlers_disconnect_by_data (grid->widget, grid);
+
+	gst_element_set_state (grid->pipeline, GST_STATE_NULL);
+
+	g_ptr_array_unref (grid->tiles);
+	g_clear_object (&grid->widget);
+	gst_object_unref (grid->pipeline);
+
+	g_free (grid);
+}
@@ -0,0 +1,51 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel.pacaud@free.fr>
+ */
+
+#ifndef ARV_VIEWER_GRID_H
+#define ARV_VIEWER_GRID_H
+
+#include <gtk/gtk.h>
+#include <arv.h>
+
+G_BEGIN_DECLS
+
+#define ARV_VIEWER_GRID_TILE_WIDTH		480
+#define ARV_VIEWER_GRID_TILE_HEIGHT		360
+#define ARV_VIEWER_GRID_PREVIEW_FRAME_RATE	30.0
+
+typedef struct _ArvViewerGrid ArvViewerGrid;
+
+gboolean	arv_viewer_grid_is_available	(void);
+
+ArvViewerGrid *	arv_viewer_grid_new		(guint n_cameras);
+gboolean	arv_viewer_grid_add_camera	(ArvViewerGrid *grid, const char *name,
+						 ArvCamera *camera, ArvStream *stream);
+void		arv_viewer_grid_start		(ArvViewerGrid *grid);
+GtkWidget *	arv_viewer_grid_get_widget	(ArvViewerGrid *grid);
+guint		arv_viewer_grid_get_n_cameras	(ArvViewerGrid *grid);
+void		arv_viewer_grid_free		(ArvViewerGrid *grid);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (ArvViewerGrid, arv_viewer_grid_free)
+
+G_END_DECLS
+
+#endif
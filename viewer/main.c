@@ -42,6 +42,8 @@ static unsigned int arv_viewer_option_initial_packet_timeout = ARV_GV_STREAM_INI
 static unsigned int arv_viewer_option_packet_timeout = ARV_GV_STREAM_PACKET_TIMEOUT_US_DEFAULT / 1000;
 static unsigned int arv_viewer_option_frame_retention = ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT / 1000;
 static char *arv_option_uv_usb_mode = NULL;
+static gboolean arv_viewer_option_gl = FALSE;
+static char **arv_viewer_option_grid = NULL;
 
 static const GOptionEntry arv_viewer_option_entries[] =
 {
@@ -80,6 +82,16 @@ static const GOptionEntry arv_viewer_option_entries[] =
 		&arv_option_uv_usb_mode,		"USB device I/O mode",
 		"{sync|async}"
 	},
+	{
+		"gl",					'\0', 0, G_OPTION_ARG_NONE,
+		&arv_viewer_option_gl,			"OpenGL rendering, with demosaicing and conversions in shaders",
+		NULL
+	},
+	{
+		"grid",					'\0', 0, G_OPTION_ARG_STRING_ARRAY,
+		&arv_viewer_option_grid,		"Grid view of decimated previews, click on a tile for full resolution",
+		"{<camera_id>|all}"
+	},
 	{
 		"debug", 				'd', 0, G_OPTION_ARG_STRING,
 		&arv_viewer_option_debug_domains, 	NULL,
@@ -184,11 +196,14 @@ main (int argc, char **argv)
 				arv_viewer_option_frame_retention,
 				register_cache_policy,
 				range_check_policy,
-                                usb_mode);
+                                usb_mode,
+				arv_viewer_option_gl);
+	arv_viewer_set_grid (viewer, (const char * const *) arv_viewer_option_grid);
 
 	status = g_application_run (G_APPLICATION (viewer), argc, argv);
 
 	g_object_unref (viewer);
+	g_strfreev (arv_viewer_option_grid);
 
 	return status;
 }